@@ -20,6 +20,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <string>
 
 #ifdef __GNUC__
@@ -28,6 +31,16 @@
 #define TB_NOINLINE
 #endif
 
+// if requested, append the result as a CSV row so that runs can be compared
+inline void appendBenchmarkResult(const std::string& message, const double value)
+{
+  if (const auto* resultsPath = std::getenv("TB_BENCHMARK_RESULTS"))
+  {
+    auto stream = std::ofstream{resultsPath, std::ios::app};
+    stream << "\"" << message << "\"," << value << "\n";
+  }
+}
+
 // the noinline is so you can see the timeLambda when profiling
 template <class L>
 TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message)
@@ -36,8 +49,7 @@ TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message)
   lambda();
   const auto end = std::chrono::high_resolution_clock::now();
 
-  printf(
-    "Time elapsed for '%s': %fms\n",
-    message.c_str(),
-    std::chrono::duration<double>(end - start).count() * 1000.0);
+  const auto msecs = std::chrono::duration<double>(end - start).count() * 1000.0;
+  printf("Time elapsed for '%s': %fms\n", message.c_str(), msecs);
+  appendBenchmarkResult(message, msecs);
 }
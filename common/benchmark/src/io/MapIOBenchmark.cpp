@@ -0,0 +1,248 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "FileLocation.h"
+#include "io/ExportOptions.h"
+#include "io/NodeWriter.h"
+#include "io/ObjSerializer.h"
+#include "io/StandardMapParser.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+constexpr size_t NumMaterials = 256;
+
+/**
+ * Parses a map without creating any nodes, so that parsing can be timed separately from
+ * node creation.
+ */
+class ParseOnlyMapParser : public StandardMapParser
+{
+public:
+  using StandardMapParser::StandardMapParser;
+
+  Result<void> parse(ParserStatus& status) { return parseEntities(status); }
+
+private:
+  void onBeginEntity(
+    const FileLocation&, std::vector<mdl::EntityProperty>, ParserStatus&) override
+  {
+  }
+  void onEndEntity(const FileLocation&, ParserStatus&) override {}
+  void onBeginBrush(const FileLocation&, ParserStatus&) override {}
+  void onEndBrush(const FileLocation&, ParserStatus&) override {}
+  void onStandardBrushFace(
+    const FileLocation&,
+    mdl::MapFormat,
+    const vm::vec3d&,
+    const vm::vec3d&,
+    const vm::vec3d&,
+    const mdl::BrushFaceAttributes&,
+    ParserStatus&) override
+  {
+  }
+  void onValveBrushFace(
+    const FileLocation&,
+    mdl::MapFormat,
+    const vm::vec3d&,
+    const vm::vec3d&,
+    const vm::vec3d&,
+    const mdl::BrushFaceAttributes&,
+    const vm::vec3d&,
+    const vm::vec3d&,
+    ParserStatus&) override
+  {
+  }
+  void onPatch(
+    const FileLocation&,
+    const FileLocation&,
+    mdl::MapFormat,
+    size_t,
+    size_t,
+    std::vector<vm::vec<double, 5>>,
+    std::string,
+    ParserStatus&) override
+  {
+  }
+};
+
+/**
+ * Creates a world with the given number of cuboids arranged in a grid.
+ */
+std::unique_ptr<mdl::WorldNode> makeWorld(
+  const mdl::MapFormat mapFormat, const size_t brushCount)
+{
+  auto world = std::make_unique<mdl::WorldNode>(
+    mdl::EntityPropertyConfig{},
+    std::initializer_list<mdl::EntityProperty>{},
+    mapFormat);
+
+  const auto builder = mdl::BrushBuilder{mapFormat, WorldBounds};
+  const auto gridSize = size_t(std::ceil(std::cbrt(double(brushCount))));
+  const auto spacing = 64.0;
+  const auto origin = -double(gridSize) * spacing / 2.0;
+
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto x = double(i % gridSize);
+    const auto y = double((i / gridSize) % gridSize);
+    const auto z = double(i / (gridSize * gridSize));
+    const auto min = vm::vec3d{x, y, z} * spacing + vm::vec3d::fill(origin);
+    const auto max = min + vm::vec3d{32.0, 32.0, 16.0 + double(i % 4) * 8.0};
+
+    auto brush =
+      builder.createCuboid(vm::bbox3d{min, max}, fmt::format("material{}", i % NumMaterials))
+      | kdl::value();
+    world->defaultLayer()->addChild(new mdl::BrushNode{std::move(brush)});
+  }
+
+  return world;
+}
+
+std::string writeMap(const mdl::WorldNode& world, kdl::task_manager& taskManager)
+{
+  auto stream = std::ostringstream{};
+  auto writer = NodeWriter{world, stream};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+std::string readFixture(const std::filesystem::path& path)
+{
+  auto stream = std::ifstream{path, std::ios::in | std::ios::binary};
+  auto buffer = std::stringstream{};
+  buffer << stream.rdbuf();
+  return buffer.str();
+}
+
+void benchmarkMap(
+  const std::string& name,
+  const std::string& mapString,
+  const mdl::MapFormat mapFormat,
+  kdl::task_manager& taskManager)
+{
+  timeLambda(
+    [&]() {
+      auto status = TestParserStatus{};
+      auto parser = ParseOnlyMapParser{mapString, mapFormat, mapFormat};
+      REQUIRE(parser.parse(status).is_success());
+    },
+    fmt::format("parse {}", name));
+
+  auto world = std::unique_ptr<mdl::WorldNode>{};
+  timeLambda(
+    [&]() {
+      auto status = TestParserStatus{};
+      auto reader = WorldReader{mapString, mapFormat, {}};
+      world = reader.read(WorldBounds, status, taskManager) | kdl::value();
+    },
+    fmt::format("parse and create nodes {}", name));
+
+  timeLambda(
+    [&]() { writeMap(*world, taskManager); }, fmt::format("serialize {}", name));
+
+  timeLambda(
+    [&]() {
+      auto objStream = std::ostringstream{};
+      auto mtlStream = std::ostringstream{};
+      const auto options =
+        ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+      auto writer = NodeWriter{
+        *world,
+        std::make_unique<ObjSerializer>(objStream, mtlStream, "export.mtl", options)};
+      writer.writeMap(taskManager);
+    },
+    fmt::format("export OBJ {}", name));
+}
+
+void benchmarkSyntheticMap(const mdl::MapFormat mapFormat, const size_t brushCount)
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto world = makeWorld(mapFormat, brushCount);
+  const auto mapString = writeMap(*world, taskManager);
+
+  benchmarkMap(
+    fmt::format("{} brushes ({})", brushCount, fmt::streamed(mapFormat)),
+    mapString,
+    mapFormat,
+    taskManager);
+}
+
+} // namespace
+
+TEST_CASE("MapIOBenchmark.syntheticMap")
+{
+  const auto mapFormat =
+    GENERATE(mdl::MapFormat::Standard, mdl::MapFormat::Valve, mdl::MapFormat::Quake3);
+  const auto brushCount = GENERATE(size_t(10'000), size_t(100'000));
+
+  benchmarkSyntheticMap(mapFormat, brushCount);
+}
+
+// hidden by default because it takes a while, run with "[large]"
+TEST_CASE("MapIOBenchmark.largeSyntheticMap", "[.][large]")
+{
+  const auto mapFormat =
+    GENERATE(mdl::MapFormat::Standard, mdl::MapFormat::Valve, mdl::MapFormat::Quake3);
+
+  benchmarkSyntheticMap(mapFormat, 500'000);
+}
+
+TEST_CASE("MapIOBenchmark.fixtureMap")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto mapPath =
+    std::filesystem::current_path() / "fixture/benchmark/AABBTree/ne_ruins.map";
+  const auto mapString = readFixture(mapPath);
+  REQUIRE(!mapString.empty());
+
+  benchmarkMap("ne_ruins.map", mapString, mdl::MapFormat::Standard, taskManager);
+}
+
+} // namespace tb::io
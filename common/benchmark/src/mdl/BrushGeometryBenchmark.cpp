@@ -0,0 +1,299 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/MapFormat.h"
+#include "mdl/Polyhedron3.h"
+
+#include "kdl/result.h"
+
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+constexpr size_t NumRepetitions = 1'000;
+
+/**
+ * Returns a brush whose complexity grows with the given number of icosphere subdivision
+ * iterations. Zero iterations yield a cube.
+ */
+Brush makeBrush(const size_t complexity, const vm::bbox3d& bounds)
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, WorldBounds};
+  return (complexity == 0 ? builder.createCuboid(bounds, "material")
+                          : builder.createIcoSphere(bounds, complexity, "material"))
+         | kdl::value();
+}
+
+std::string describe(const Brush& brush)
+{
+  return fmt::format(
+    "{} vertices, {} faces", brush.vertices().size(), brush.faces().size());
+}
+
+std::vector<vm::vec3d> vertexPositions(const Brush& brush)
+{
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(brush.vertexCount());
+  for (const auto* vertex : brush.vertices())
+  {
+    result.push_back(vertex->position());
+  }
+  return result;
+}
+
+/**
+ * Returns the given number of random points on the surface of a sphere with the given
+ * radius. Uses a fixed seed so that runs are comparable.
+ */
+std::vector<vm::vec3d> makePointsOnSphere(const size_t count, const double radius)
+{
+  auto generator = std::mt19937{0};
+  auto distribution = std::normal_distribution<double>{};
+
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(count);
+  while (result.size() < count)
+  {
+    const auto x = distribution(generator);
+    const auto y = distribution(generator);
+    const auto z = distribution(generator);
+    const auto direction = vm::vec3d{x, y, z};
+    if (!vm::is_zero(direction, vm::Cd::almost_zero()))
+    {
+      result.push_back(vm::normalize(direction) * radius);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("BrushGeometryBenchmark.subtract")
+{
+  const auto complexity = GENERATE(size_t(0), size_t(1), size_t(2), size_t(3));
+
+  const auto minuend = makeBrush(complexity, vm::bbox3d{128.0});
+
+  // a grid of small cubes that cut into the minuend's boundary
+  auto subtrahends = std::vector<Brush>{};
+  for (const auto x : {-128.0, 0.0, 128.0})
+  {
+    for (const auto y : {-128.0, 0.0, 128.0})
+    {
+      const auto center = vm::vec3d{x, y, 96.0};
+      const auto bounds =
+        vm::bbox3d{center - vm::vec3d::fill(48.0), center + vm::vec3d::fill(48.0)};
+      subtrahends.push_back(makeBrush(0, bounds));
+    }
+  }
+  const auto subtrahendPtrs = [&]() {
+    auto result = std::vector<const Brush*>{};
+    std::ranges::transform(
+      subtrahends, std::back_inserter(result), [](const auto& b) { return &b; });
+    return result;
+  }();
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumRepetitions / 10; ++i)
+      {
+        const auto fragments = minuend.subtract(
+          MapFormat::Standard, WorldBounds, "material", subtrahendPtrs);
+        REQUIRE(!fragments.empty());
+      }
+    },
+    fmt::format(
+      "subtract {} brushes from brush with {} {} times",
+      subtrahends.size(),
+      describe(minuend),
+      NumRepetitions / 10));
+}
+
+TEST_CASE("BrushGeometryBenchmark.intersect")
+{
+  const auto complexity = GENERATE(size_t(0), size_t(1), size_t(2), size_t(3));
+
+  const auto lhs = makeBrush(complexity, vm::bbox3d{128.0});
+  const auto rhs =
+    makeBrush(complexity, vm::bbox3d{vm::vec3d::fill(-64.0), vm::vec3d::fill(192.0)});
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumRepetitions; ++i)
+      {
+        auto brush = lhs;
+        REQUIRE(brush.intersect(WorldBounds, rhs).is_success());
+      }
+    },
+    fmt::format(
+      "intersect two brushes with {} {} times", describe(lhs), NumRepetitions));
+}
+
+TEST_CASE("BrushGeometryBenchmark.convexMerge")
+{
+  // mirrors the geometric part of csgConvexMerge: gather the vertices of the selected
+  // brushes, compute their convex hull and build a new brush from it
+  const auto complexity = GENERATE(size_t(0), size_t(1), size_t(2), size_t(3));
+  const auto brushCount = GENERATE(size_t(2), size_t(16));
+
+  auto brushes = std::vector<Brush>{};
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto center = vm::vec3d{double(i) * 96.0, double(i % 2) * 32.0, 0.0};
+    const auto bounds =
+      vm::bbox3d{center - vm::vec3d::fill(64.0), center + vm::vec3d::fill(64.0)};
+    brushes.push_back(makeBrush(complexity, bounds));
+  }
+
+  const auto builder = BrushBuilder{MapFormat::Standard, WorldBounds};
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumRepetitions / 10; ++i)
+      {
+        auto points = std::vector<vm::vec3d>{};
+        for (const auto& brush : brushes)
+        {
+          for (const auto* vertex : brush.vertices())
+          {
+            points.push_back(vertex->position());
+          }
+        }
+
+        const auto polyhedron = Polyhedron3{std::move(points)};
+        REQUIRE(polyhedron.closed());
+        REQUIRE(builder.createBrush(polyhedron, "material").is_success());
+      }
+    },
+    fmt::format(
+      "convex merge {} brushes with {} {} times",
+      brushCount,
+      describe(brushes.front()),
+      NumRepetitions / 10));
+}
+
+TEST_CASE("BrushGeometryBenchmark.convexHull")
+{
+  const auto pointCount = GENERATE(size_t(100), size_t(1'000), size_t(10'000));
+
+  const auto points = makePointsOnSphere(pointCount, 1024.0);
+
+  timeLambda(
+    [&]() {
+      auto polyhedron = Polyhedron3{points};
+      REQUIRE(polyhedron.closed());
+    },
+    fmt::format("build convex hull of {} points", pointCount));
+
+  timeLambda(
+    [&]() {
+      auto polyhedron = Polyhedron3{};
+      for (const auto& point : points)
+      {
+        polyhedron.addPoint(point, vm::Cd::point_status_epsilon());
+      }
+      REQUIRE(polyhedron.closed());
+    },
+    fmt::format("add {} points to convex hull one by one", pointCount));
+}
+
+TEST_CASE("BrushGeometryBenchmark.clip")
+{
+  const auto complexity = GENERATE(size_t(0), size_t(1), size_t(2), size_t(3));
+
+  const auto brush = makeBrush(complexity, vm::bbox3d{128.0});
+  const auto polyhedron = Polyhedron3{vertexPositions(brush)};
+
+  const auto planes = std::vector<vm::plane3d>{
+    {vm::vec3d{0, 0, 32}, vm::vec3d{0, 0, 1}},
+    {vm::vec3d{16, 0, 0}, vm::normalize(vm::vec3d{1, 1, 0})},
+    {vm::vec3d{0, -24, 8}, vm::normalize(vm::vec3d{1, 2, 3})},
+    {vm::vec3d{-48, 0, 0}, vm::normalize(vm::vec3d{-3, 1, -1})},
+  };
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumRepetitions; ++i)
+      {
+        auto clipped = polyhedron;
+        for (const auto& plane : planes)
+        {
+          REQUIRE(clipped.clip(plane).success());
+        }
+      }
+    },
+    fmt::format(
+      "clip polyhedron with {} by {} planes {} times",
+      describe(brush),
+      planes.size(),
+      NumRepetitions));
+}
+
+TEST_CASE("BrushGeometryBenchmark.transformVertices")
+{
+  const auto complexity = GENERATE(size_t(0), size_t(1), size_t(2), size_t(3));
+
+  const auto brush = makeBrush(complexity, vm::bbox3d{128.0});
+
+  // move the topmost vertices up, which keeps the brush convex
+  const auto positions = vertexPositions(brush);
+  const auto maxZ =
+    std::ranges::max(positions, {}, [](const auto& p) { return p.z(); }).z();
+  auto topPositions = std::vector<vm::vec3d>{};
+  std::ranges::copy_if(positions, std::back_inserter(topPositions), [&](const auto& p) {
+    return p.z() == maxZ;
+  });
+  const auto transform = vm::translation_matrix(vm::vec3d{0, 0, 16});
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumRepetitions; ++i)
+      {
+        auto moved = brush;
+        REQUIRE(
+          moved.transformVertices(WorldBounds, topPositions, transform).is_success());
+      }
+    },
+    fmt::format(
+      "move {} vertices of brush with {} {} times",
+      topPositions.size(),
+      describe(brush),
+      NumRepetitions));
+}
+
+} // namespace tb::mdl
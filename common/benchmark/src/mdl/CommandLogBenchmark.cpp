@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BenchmarkUtils.h"
+#include "MapFixture.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/ChangeBrushFaceAttributesRequest.h"
+#include "mdl/CommandLog.h"
+#include "mdl/CommandProfiler.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Brushes.h"
+#include "mdl/Map_Geometry.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::string readFile(const std::filesystem::path& path)
+{
+  auto stream = std::ifstream{path, std::ios::in | std::ios::binary};
+  auto buffer = std::stringstream{};
+  buffer << stream.rdbuf();
+  return buffer.str();
+}
+
+/**
+ * Loads the snapshot of the given log into a new map and replays the log, printing the
+ * time it took to replay every step.
+ */
+void benchmarkReplay(const std::filesystem::path& logPath)
+{
+  const auto log = readFile(logPath);
+  const auto snapshotFilename = readCommandLogSnapshotFilename(log) | kdl::value();
+
+  auto fixture = MapFixture{};
+  fixture.load(logPath.parent_path() / snapshotFilename);
+
+  auto profiles = std::vector<CommandProfile>{};
+  timeLambda(
+    [&]() { profiles = replayCommandLog(fixture.map(), log) | kdl::value(); },
+    fmt::format("replay {}", logPath.filename().string()));
+
+  std::cout << toReport(std::deque<CommandProfile>{profiles.begin(), profiles.end()});
+}
+
+void addBrushes(Map& map, const size_t brushCount)
+{
+  const auto builder = BrushBuilder{map.world()->mapFormat(), map.worldBounds()};
+
+  auto nodes = std::vector<Node*>{};
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto min = vm::vec3d{double(i % 64), double(i / 64), 0.0} * 64.0;
+    nodes.push_back(new BrushNode{
+      builder.createCuboid(vm::bbox3d{min, min + vm::vec3d{32.0, 32.0, 32.0}}, "material")
+      | kdl::value()});
+  }
+
+  addNodes(map, {{parentForNodes(map), nodes}});
+}
+
+/**
+ * Records a session of moving, texturing, duplicating and deleting brushes.
+ */
+void recordSession(Map& map, const std::filesystem::path& logPath)
+{
+  const auto snapshotPath = logPath.parent_path() / "session.map";
+  map.saveTo(snapshotPath);
+
+  auto recorder = CommandLogRecorder{map};
+  recorder.start();
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    selectAllNodes(map);
+    translateSelection(map, vm::vec3d{16.0, 0.0, 0.0});
+
+    auto request = ChangeBrushFaceAttributesRequest{};
+    request.setMaterialName(fmt::format("material{}", i));
+    setBrushFaceAttributes(map, request);
+
+    duplicateSelectedNodes(map);
+    removeSelectedNodes(map);
+    map.undoCommand();
+    deselectAll(map);
+  }
+
+  auto stream = std::ofstream{logPath, std::ios::out | std::ios::binary};
+  stream << makeCommandLogHeader(snapshotPath.filename()) << recorder.steps();
+}
+
+} // namespace
+
+TEST_CASE("CommandLogBenchmark.recordedSession")
+{
+  const auto logPath = std::filesystem::temp_directory_path() / "session.log";
+
+  {
+    auto fixture = MapFixture{};
+    fixture.create();
+    addBrushes(fixture.map(), 4096);
+    recordSession(fixture.map(), logPath);
+  }
+
+  benchmarkReplay(logPath);
+}
+
+// hidden by default, run with "[replay]" and the path of a recorded command log in the
+// TB_COMMAND_LOG environment variable
+TEST_CASE("CommandLogBenchmark.replay", "[.][replay]")
+{
+  const auto* logPath = std::getenv("TB_COMMAND_LOG");
+  REQUIRE(logPath != nullptr);
+
+  benchmarkReplay(logPath);
+}
+
+} // namespace tb::mdl
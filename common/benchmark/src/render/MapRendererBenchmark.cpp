@@ -0,0 +1,344 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BenchmarkUtils.h"
+#include "MapFixture.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/WorldNode.h"
+#include "render/Camera.h"
+#include "render/GL.h"
+#include "render/MapRenderer.h"
+#include "render/OcclusionCuller.h"
+#include "render/OrthographicCamera.h"
+#include "render/PerspectiveCamera.h"
+#include "render/RenderBatch.h"
+#include "render/RenderContext.h"
+#include "render/RenderProfiler.h"
+#include "render/VboManager.h"
+#include "ui/GLContextManager.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/constants.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+// see RenderView.cpp for why this warning is silenced
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcpp"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcpp"
+#endif
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto ViewportWidth = 1920;
+constexpr auto ViewportHeight = 1080;
+constexpr auto FrameCount = size_t(240);
+
+struct FrameStats
+{
+  double msecs;
+  StateChangeCounts counts;
+};
+
+/**
+ * Returns the value below which the given percentage of the given sorted values fall,
+ * using the nearest rank method.
+ */
+double percentile(const std::vector<double>& sortedValues, const double percentage)
+{
+  const auto rank = size_t(std::ceil(percentage / 100.0 * double(sortedValues.size())));
+  return sortedValues[std::max(rank, size_t(1)) - 1];
+}
+
+void reportFrames(const std::string& name, const std::vector<FrameStats>& frames)
+{
+  // the first frame uploads the map, so it is reported separately
+  const auto& firstFrame = frames.front();
+  const auto otherFrames =
+    std::vector<FrameStats>{std::next(frames.begin()), frames.end()};
+
+  const auto msecs = kdl::vec_sort(
+    kdl::vec_transform(otherFrames, [](const auto& frame) { return frame.msecs; }));
+
+  auto drawCalls = size_t(0);
+  auto uploadedBytes = size_t(0);
+  for (const auto& frame : otherFrames)
+  {
+    drawCalls += frame.counts.drawCalls;
+    uploadedBytes += frame.counts.uploadedBytes;
+  }
+
+  const auto results = std::vector<std::tuple<std::string, double>>{
+    {"first frame (ms)", firstFrame.msecs},
+    {"first frame uploaded bytes", double(firstFrame.counts.uploadedBytes)},
+    {"p50 (ms)", percentile(msecs, 50.0)},
+    {"p90 (ms)", percentile(msecs, 90.0)},
+    {"p99 (ms)", percentile(msecs, 99.0)},
+    {"max (ms)", msecs.back()},
+    {"draw calls per frame", double(drawCalls) / double(otherFrames.size())},
+    {"uploaded bytes per frame", double(uploadedBytes) / double(otherFrames.size())},
+  };
+
+  for (const auto& [label, value] : results)
+  {
+    const auto message = fmt::format("{} {}", name, label);
+    printf("%s: %.3f\n", message.c_str(), value);
+    appendBenchmarkResult(message, value);
+  }
+}
+
+class OffscreenRenderer
+{
+private:
+  QOffscreenSurface m_surface;
+  QOpenGLContext m_context;
+  std::unique_ptr<QOpenGLFramebufferObject> m_framebuffer;
+  std::unique_ptr<ui::GLContextManager> m_contextManager;
+
+public:
+  /**
+   * Returns false if no OpenGL context is available, e.g. on a headless machine.
+   */
+  bool initialize()
+  {
+    m_surface.create();
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface))
+    {
+      return false;
+    }
+
+    m_framebuffer = std::make_unique<QOpenGLFramebufferObject>(
+      ViewportWidth, ViewportHeight, QOpenGLFramebufferObject::Depth);
+    m_framebuffer->bind();
+
+    m_contextManager = std::make_unique<ui::GLContextManager>();
+    m_contextManager->initialize();
+    return true;
+  }
+
+  ~OffscreenRenderer()
+  {
+    if (m_contextManager)
+    {
+      m_context.makeCurrent(&m_surface);
+      m_contextManager.reset();
+      m_framebuffer.reset();
+      m_context.doneCurrent();
+    }
+  }
+
+  /**
+   * Renders one frame of the given map with the given camera and waits until the GPU has
+   * finished it.
+   */
+  FrameStats renderFrame(
+    MapRenderer& mapRenderer,
+    const RenderMode renderMode,
+    const Camera& camera,
+    OcclusionCuller* occlusionCuller)
+  {
+    currentStateChangeCounts() = StateChangeCounts{};
+    const auto start = std::chrono::steady_clock::now();
+
+    glAssert(glViewport(0, 0, ViewportWidth, ViewportHeight));
+    glAssert(glEnable(GL_BLEND));
+    glAssert(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    glAssert(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    glAssert(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    auto& fontManager = m_contextManager->fontManager();
+    auto& shaderManager = m_contextManager->shaderManager();
+    auto& vboManager = m_contextManager->vboManager();
+
+    // text requires the application's fonts and is not what this benchmark is about
+    auto renderContext = RenderContext{renderMode, camera, fontManager, shaderManager};
+    renderContext.setShowEntityClassnames(false);
+    renderContext.setShowGrid(false);
+
+    if (occlusionCuller)
+    {
+      occlusionCuller->beginFrame(camera);
+      renderContext.setOcclusionCuller(occlusionCuller);
+    }
+
+    auto renderBatch = RenderBatch{vboManager};
+    mapRenderer.render(renderContext, renderBatch);
+    renderBatch.render(renderContext);
+    vboManager.finishFrame();
+
+    if (occlusionCuller)
+    {
+      occlusionCuller->endFrame();
+    }
+
+    glAssert(glFinish());
+
+    const auto msecs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return FrameStats{msecs, currentStateChangeCounts()};
+  }
+};
+
+vm::bbox3f mapBounds(const mdl::Map& map)
+{
+  const auto layers = map.world()->allLayers();
+  return vm::bbox3f{mdl::computeLogicalBounds(
+    kdl::vec_static_cast<mdl::Node*>(std::vector<mdl::LayerNode*>{layers}))};
+}
+
+/**
+ * Flies a perspective camera around the map once, looking at its center from above.
+ */
+std::vector<FrameStats> flyPerspectivePath(
+  OffscreenRenderer& renderer, MapRenderer& mapRenderer, const vm::bbox3f& bounds)
+{
+  const auto center = bounds.center();
+  const auto radius = vm::get_max_component(bounds.size()) * 0.75f;
+
+  auto camera = PerspectiveCamera{};
+  camera.setViewport(Camera::Viewport{0, 0, ViewportWidth, ViewportHeight});
+  camera.setFarPlane(radius * 4.0f);
+
+  auto occlusionCuller = OcclusionCuller{};
+
+  auto result = std::vector<FrameStats>{};
+  result.reserve(FrameCount);
+
+  for (size_t i = 0; i < FrameCount; ++i)
+  {
+    const auto angle = 2.0f * vm::Cf::pi() * float(i) / float(FrameCount);
+    const auto offset =
+      vm::vec3f{std::cos(angle) * radius, std::sin(angle) * radius, radius / 3.0f};
+    camera.moveTo(center + offset);
+    camera.lookAt(center, vm::vec3f{0, 0, 1});
+
+    result.push_back(renderer.renderFrame(
+      mapRenderer, RenderMode::Render3D, camera, &occlusionCuller));
+  }
+
+  return result;
+}
+
+/**
+ * Pans an orthographic top view across the map, zoomed in so that the view shows about a
+ * quarter of the map at a time.
+ */
+std::vector<FrameStats> flyOrthographicPath(
+  OffscreenRenderer& renderer, MapRenderer& mapRenderer, const vm::bbox3f& bounds)
+{
+  const auto size = bounds.size();
+
+  auto camera = OrthographicCamera{};
+  camera.setViewport(Camera::Viewport{0, 0, ViewportWidth, ViewportHeight});
+  camera.setNearPlane(1.0f);
+  camera.setFarPlane(size.z() + 2.0f);
+  camera.setDirection(vm::vec3f{0, 0, -1}, vm::vec3f{0, 1, 0});
+  camera.setZoom(2.0f * float(ViewportWidth) / vm::max(size.x(), size.y(), 1.0f));
+
+  auto result = std::vector<FrameStats>{};
+  result.reserve(FrameCount);
+
+  for (size_t i = 0; i < FrameCount; ++i)
+  {
+    const auto t = float(i) / float(FrameCount - 1);
+    camera.moveTo(vm::vec3f{
+      bounds.min.x() + t * size.x(),
+      bounds.min.y() + t * size.y(),
+      bounds.max.z() + 1.0f});
+
+    result.push_back(
+      renderer.renderFrame(mapRenderer, RenderMode::Render2D, camera, nullptr));
+  }
+
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("MapRendererBenchmark.cameraPaths")
+{
+  auto renderer = OffscreenRenderer{};
+  if (!renderer.initialize())
+  {
+    SKIP("No OpenGL context available");
+  }
+
+  printf(
+    "%s %s %s\n",
+    ui::GLContextManager::GLVendor.c_str(),
+    ui::GLContextManager::GLRenderer.c_str(),
+    ui::GLContextManager::GLVersion.c_str());
+
+  auto fixture = mdl::MapFixture{};
+  auto& map = fixture.map();
+
+  // the renderer picks up the map's nodes when the map is loaded
+  auto mapRenderer = MapRenderer{map};
+  fixture.load(
+    std::filesystem::current_path() / "fixture/benchmark/AABBTree/ne_ruins.map",
+    {.mapFormat = mdl::MapFormat::Standard});
+  const auto bounds = mapBounds(map);
+
+  SECTION("Perspective camera")
+  {
+    reportFrames("perspective orbit", flyPerspectivePath(renderer, mapRenderer, bounds));
+  }
+
+  SECTION("Orthographic camera")
+  {
+    reportFrames("orthographic pan", flyOrthographicPath(renderer, mapRenderer, bounds));
+  }
+}
+
+} // namespace tb::render
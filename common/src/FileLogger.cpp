@@ -46,6 +46,13 @@ FileLogger::FileLogger(const std::filesystem::path& filePath)
   : m_stream{openLogFile(filePath)}
 {
   ensure(m_stream, "log file could not be opened");
+  m_writerThread = std::thread{[this]() { writeMessages(); }};
+}
+
+FileLogger::~FileLogger()
+{
+  m_queue.close();
+  m_writerThread.join();
 }
 
 FileLogger& FileLogger::instance()
@@ -54,12 +61,29 @@ FileLogger& FileLogger::instance()
   return Instance;
 }
 
-void FileLogger::doLog(const LogLevel /* level */, const std::string_view message)
+void FileLogger::doLog(const LogLevel level, const std::string_view message)
+{
+  m_queue.push(level, message);
+}
+
+void FileLogger::writeMessages()
+{
+  while (m_queue.waitForMessages())
+  {
+    writeMessages(m_queue.takeMessages());
+  }
+}
+
+void FileLogger::writeMessages(const std::vector<LogQueue::Message>& messages)
 {
   assert(m_stream);
   if (m_stream)
   {
-    m_stream << message << std::endl;
+    for (const auto& message : messages)
+    {
+      m_stream << message.str << '\n';
+    }
+    m_stream.flush();
   }
 }
 
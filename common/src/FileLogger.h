@@ -19,29 +19,45 @@
 
 #pragma once
 
+#include "LogQueue.h"
 #include "Logger.h"
 #include "Macros.h"
 
 #include <filesystem>
 #include <fstream>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace tb
 {
 
+/**
+ * Writes log messages to a file.
+ *
+ * The messages are queued and written by a background thread, so that logging never
+ * blocks on disk I/O. The file is flushed after every batch of messages that the thread
+ * takes from the queue. The destructor writes the remaining messages before it returns.
+ */
 class FileLogger : public Logger
 {
 private:
   std::ofstream m_stream;
+  LogQueue m_queue;
+  std::thread m_writerThread;
 
 public:
   explicit FileLogger(const std::filesystem::path& filePath);
+  ~FileLogger() override;
 
   static FileLogger& instance();
 
 private:
   void doLog(LogLevel level, std::string_view message) override;
 
+  void writeMessages();
+  void writeMessages(const std::vector<LogQueue::Message>& messages);
+
   deleteCopyAndMove(FileLogger);
 };
 
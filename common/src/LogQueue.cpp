@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogQueue.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+namespace tb
+{
+
+LogQueue::LogQueue() = default;
+
+LogQueue::~LogQueue()
+{
+  takeMessages();
+}
+
+void LogQueue::push(const LogLevel level, const std::string_view message)
+{
+  auto* node = new Node{Message{level, std::string{message}}};
+
+  // the node must not be accessed once it is linked since the consumer may delete it
+  auto* next = m_head.load(std::memory_order_relaxed);
+  do
+  {
+    node->next = next;
+  } while (!m_head.compare_exchange_weak(
+    next, node, std::memory_order_release, std::memory_order_relaxed));
+
+  if (next == nullptr)
+  {
+    // the queue was empty, so the consumer may be waiting
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+  }
+}
+
+std::vector<LogQueue::Message> LogQueue::takeMessages()
+{
+  auto* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+  auto result = std::vector<Message>{};
+  while (node)
+  {
+    auto* next = node->next;
+    result.push_back(std::move(node->message));
+    delete node;
+    node = next;
+  }
+
+  std::ranges::reverse(result);
+  return result;
+}
+
+bool LogQueue::empty() const
+{
+  return m_head.load(std::memory_order_acquire) == nullptr;
+}
+
+bool LogQueue::waitForMessages() const
+{
+  while (true)
+  {
+    const auto signal = m_signal.load(std::memory_order_acquire);
+    if (!empty())
+    {
+      return true;
+    }
+    if (m_closed.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    // returns immediately if a message was pushed after loading the signal
+    m_signal.wait(signal, std::memory_order_acquire);
+  }
+}
+
+void LogQueue::close()
+{
+  m_closed.store(true, std::memory_order_release);
+  m_signal.fetch_add(1, std::memory_order_release);
+  m_signal.notify_all();
+}
+
+} // namespace tb
@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb
+{
+enum class LogLevel;
+
+/**
+ * A lock free queue of log messages that can be filled by any number of threads and is
+ * drained by a single consumer.
+ *
+ * Pushing a message only allocates a node and links it into a list with a compare and
+ * swap, so logging threads never block each other or wait for the consumer.
+ */
+class LogQueue
+{
+public:
+  struct Message
+  {
+    LogLevel level;
+    std::string str;
+  };
+
+private:
+  struct Node
+  {
+    Message message;
+    Node* next = nullptr;
+  };
+
+  /**
+   * The most recently pushed message. The messages are linked in reverse order.
+   */
+  std::atomic<Node*> m_head = nullptr;
+
+  /**
+   * Changes whenever a message is pushed into an empty queue or the queue is closed, so
+   * that a waiting consumer can be woken up.
+   */
+  std::atomic<std::uint32_t> m_signal = 0;
+  std::atomic<bool> m_closed = false;
+
+public:
+  LogQueue();
+  ~LogQueue();
+
+  void push(LogLevel level, std::string_view message);
+
+  /**
+   * Removes all messages and returns them in the order in which they were pushed.
+   */
+  std::vector<Message> takeMessages();
+
+  bool empty() const;
+
+  /**
+   * Blocks until the queue is not empty or has been closed.
+   *
+   * Returns false if the queue was closed and is empty.
+   */
+  bool waitForMessages() const;
+
+  /**
+   * Wakes up a consumer that waits for messages. Messages can still be pushed and taken
+   * after the queue was closed.
+   */
+  void close();
+
+  deleteCopyAndMove(LogQueue);
+};
+
+} // namespace tb
@@ -93,4 +93,18 @@ void NullLogger::doLog(const LogLevel /* level */, const std::string_view /* mes
 {
 }
 
+void BufferedLogger::flush(Logger& target)
+{
+  for (const auto& [level, message] : m_messages)
+  {
+    target.log(level, message);
+  }
+  m_messages.clear();
+}
+
+void BufferedLogger::doLog(const LogLevel level, const std::string_view message)
+{
+  m_messages.emplace_back(level, std::string{message});
+}
+
 } // namespace tb
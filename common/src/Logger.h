@@ -20,7 +20,10 @@
 #pragma once
 
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
 namespace tb
 {
@@ -83,4 +86,24 @@ private:
   void doLog(LogLevel level, std::string_view message) override;
 };
 
+/**
+ * Collects log messages so that they can be forwarded to another logger later, e.g.
+ * after a background task has finished. Not thread safe.
+ */
+class BufferedLogger : public Logger
+{
+private:
+  std::vector<std::tuple<LogLevel, std::string>> m_messages;
+
+public:
+  /**
+   * Forwards all collected messages to the given logger in the order in which they were
+   * logged and clears them.
+   */
+  void flush(Logger& target);
+
+private:
+  void doLog(LogLevel level, std::string_view message) override;
+};
+
 } // namespace tb
@@ -19,12 +19,69 @@
 
 #include "LoggerCache.h"
 
+#include "Logger.h"
+
+#include <fmt/format.h>
+
 namespace tb::ui
 {
 
+LoggerCache::LoggerCache(const size_t maxMessages)
+  : m_maxMessages{maxMessages}
+{
+}
+
 void LoggerCache::cacheMessage(const LogLevel level, const std::string_view message)
 {
-  m_cachedMessages.push_back(Message{level, std::string{message}});
+  if (
+    !m_cachedMessages.empty() && m_cachedMessages.back().level == level
+    && m_cachedMessages.back().str == message)
+  {
+    ++m_cachedMessages.back().count;
+    return;
+  }
+
+  if (m_cachedMessages.size() == m_maxMessages)
+  {
+    m_discardedMessages += m_cachedMessages.front().count;
+    m_cachedMessages.pop_front();
+  }
+
+  if (m_maxMessages > 0)
+  {
+    m_cachedMessages.push_back(CachedMessage{level, std::string{message}});
+  }
+  else
+  {
+    ++m_discardedMessages;
+  }
+}
+
+std::vector<LoggerCache::Message> LoggerCache::takeCachedMessages()
+{
+  auto result = std::vector<Message>{};
+  result.reserve(m_cachedMessages.size() + 1);
+
+  if (m_discardedMessages > 0)
+  {
+    result.push_back(Message{
+      LogLevel::Warn,
+      fmt::format("{} earlier log messages were discarded", m_discardedMessages)});
+  }
+
+  for (auto& message : m_cachedMessages)
+  {
+    result.push_back(
+      message.count == 1
+        ? Message{message.level, std::move(message.str)}
+        : Message{
+            message.level,
+            fmt::format("{} (repeated {} times)", message.str, message.count)});
+  }
+
+  m_cachedMessages.clear();
+  m_discardedMessages = 0;
+  return result;
 }
 
 } // namespace tb::ui
@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <deque>
+#include <limits>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -31,28 +34,51 @@ enum class LogLevel;
 namespace tb::ui
 {
 
+/**
+ * Caches log messages until they can be delivered.
+ *
+ * Consecutive identical messages are collapsed into a single message that records how
+ * often it was repeated. If more than the given maximum number of messages are cached,
+ * the oldest messages are discarded and a warning is delivered in their place.
+ */
 class LoggerCache
 {
-private:
+public:
   struct Message
   {
     LogLevel level;
     std::string str;
   };
 
-  std::vector<Message> m_cachedMessages;
+private:
+  struct CachedMessage
+  {
+    LogLevel level;
+    std::string str;
+    size_t count = 1;
+  };
+
+  size_t m_maxMessages;
+  std::deque<CachedMessage> m_cachedMessages;
+  size_t m_discardedMessages = 0;
 
 public:
+  explicit LoggerCache(size_t maxMessages = std::numeric_limits<size_t>::max());
+
   void cacheMessage(LogLevel level, std::string_view message);
 
+  /**
+   * Removes all cached messages and returns them in the order in which they were cached.
+   */
+  std::vector<Message> takeCachedMessages();
+
   template <typename F>
   void getCachedMessages(const F& f)
   {
-    for (const auto& message : m_cachedMessages)
+    for (const auto& message : takeCachedMessages())
     {
       f(message.level, message.str);
     }
-    m_cachedMessages.clear();
   }
 };
 
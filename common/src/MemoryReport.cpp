@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MemoryReport.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace tb
+{
+namespace
+{
+
+std::string formatBytes(const size_t bytes)
+{
+  if (bytes >= 1024 * 1024)
+  {
+    return fmt::format("{:.1f} MiB", double(bytes) / (1024.0 * 1024.0));
+  }
+  if (bytes >= 1024)
+  {
+    return fmt::format("{:.1f} KiB", double(bytes) / 1024.0);
+  }
+  return fmt::format("{} B", bytes);
+}
+
+std::string escapeJson(const std::string_view str)
+{
+  auto result = std::string{};
+  result.reserve(str.size());
+  for (const auto c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    default:
+      result += c;
+      break;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+void MemoryReport::add(
+  const std::string_view name, const size_t bytes, const size_t count)
+{
+  if (const auto iEntry = std::ranges::find(m_entries, name, &MemoryReportEntry::name);
+      iEntry != m_entries.end())
+  {
+    iEntry->bytes += bytes;
+    iEntry->count += count;
+  }
+  else
+  {
+    m_entries.push_back(MemoryReportEntry{std::string{name}, bytes, count});
+  }
+}
+
+const std::vector<MemoryReportEntry>& MemoryReport::entries() const
+{
+  return m_entries;
+}
+
+std::string toString(const MemoryReport& report)
+{
+  auto nameWidth = size_t(0);
+  for (const auto& entry : report.entries())
+  {
+    nameWidth = std::max(nameWidth, entry.name.size());
+  }
+
+  auto str = std::stringstream{};
+  for (const auto& entry : report.entries())
+  {
+    str << fmt::format(
+      "{:<{}}  {:>10}  {:>8}\n",
+      entry.name,
+      nameWidth,
+      formatBytes(entry.bytes),
+      entry.count);
+  }
+  return str.str();
+}
+
+std::string toJson(const MemoryReport& report)
+{
+  auto str = std::stringstream{};
+  str << "[";
+  for (size_t i = 0; i < report.entries().size(); ++i)
+  {
+    const auto& entry = report.entries()[i];
+    str << (i > 0 ? ",\n  " : "\n  ")
+        << fmt::format(
+             R"({{"name": "{}", "bytes": {}, "count": {}}})",
+             escapeJson(entry.name),
+             entry.bytes,
+             entry.count);
+  }
+  str << (report.entries().empty() ? "]\n" : "\n]\n");
+  return str.str();
+}
+
+} // namespace tb
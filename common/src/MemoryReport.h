@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * The estimated memory usage of a part of the application.
+ */
+struct MemoryReportEntry
+{
+  std::string name;
+  size_t bytes = 0;
+
+  /**
+   * The number of objects that were counted, e.g. nodes, textures or buffers.
+   */
+  size_t count = 0;
+
+  bool operator==(const MemoryReportEntry& other) const = default;
+};
+
+/**
+ * Collects estimates of the memory used by the subsystems of the application. The
+ * estimates ignore allocator overhead and are meant for finding out where memory goes,
+ * not for exact accounting. Entries may overlap, e.g. the buffers of a renderer are
+ * also counted by the VBO manager that allocated them.
+ */
+class MemoryReport
+{
+private:
+  std::vector<MemoryReportEntry> m_entries;
+
+public:
+  /**
+   * Adds the given number of bytes and objects to the entry with the given name. The
+   * entry is created if it doesn't exist yet. Entries are kept in the order in which they
+   * were first added.
+   */
+  void add(std::string_view name, size_t bytes, size_t count);
+
+  const std::vector<MemoryReportEntry>& entries() const;
+};
+
+/**
+ * Formats the given report as a table with one row per entry.
+ */
+std::string toString(const MemoryReport& report);
+
+/**
+ * Formats the given report as a JSON array with one object per entry.
+ */
+std::string toJson(const MemoryReport& report);
+
+} // namespace tb
@@ -50,6 +50,7 @@ namespace tb
 
 std::unique_ptr<PreferenceManager> PreferenceManager::m_instance;
 bool PreferenceManager::m_initialized = false;
+size_t PreferenceManager::m_generation = 0;
 
 PreferenceManager& PreferenceManager::instance()
 {
@@ -308,6 +309,8 @@ void AppPreferenceManager::loadCacheFromDisk()
 
 void AppPreferenceManager::invalidatePreferences()
 {
+  ++m_generation;
+
   // Force all currently known Preference<T> objects to deserialize from m_cache next
   // time they are accessed Note, because new Preference<T> objects can be created at
   // runtime, we need this sort of lazy loading system.
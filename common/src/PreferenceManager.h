@@ -40,6 +40,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class QTextStream;
@@ -57,6 +58,12 @@ private:
   static bool m_initialized;
 
 protected:
+  /**
+   * Incremented whenever the value of any preference may have changed. It is never reset,
+   * not even when the instance is replaced.
+   */
+  static size_t m_generation;
+
   std::map<std::filesystem::path, std::unique_ptr<PreferenceBase>> m_dynamicPreferences;
 
 public:
@@ -74,14 +81,22 @@ public:
   {
     m_instance = std::make_unique<T>();
     m_initialized = false;
+    ++m_generation;
   }
 
   static void destroyInstance()
   {
     m_instance.reset();
     m_initialized = false;
+    ++m_generation;
   }
 
+  /**
+   * Returns the current preference generation. If it is unchanged, then so are the
+   * values of all preferences, see CachedPref.
+   */
+  static size_t generation() { return m_generation; }
+
   template <typename T>
   Preference<T>& dynamicPreference(const std::filesystem::path& path, T&& defaultValue)
   {
@@ -128,6 +143,7 @@ public:
 
     preference.setValue(value);
     preference.setValid(true);
+    ++m_generation;
 
     savePreference(preference);
     if (saveInstantly())
@@ -217,6 +233,39 @@ const T& pref(Preference<T>& preference)
   return prefs.get(preference);
 }
 
+/**
+ * Caches the value of a preference for code that reads it very often, e.g. on every
+ * frame. Reading the value only compares the preference generation unless a preference
+ * has changed since the last read.
+ *
+ * Like pref, this must only be used on the main thread.
+ */
+template <typename T>
+class CachedPref
+{
+private:
+  Preference<T>& m_preference;
+  size_t m_generation = 0;
+  std::optional<T> m_value;
+
+public:
+  explicit CachedPref(Preference<T>& preference)
+    : m_preference{preference}
+  {
+  }
+
+  const T& operator()()
+  {
+    const auto generation = PreferenceManager::generation();
+    if (!m_value || m_generation != generation)
+    {
+      m_value = pref(m_preference);
+      m_generation = generation;
+    }
+    return *m_value;
+  }
+};
+
 /**
  * Sets a preference, and saves the change immediately.
  */
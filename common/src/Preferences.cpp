@@ -61,6 +61,7 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   "render/Colors/Portal file fill", Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS("render/Show FPS", false);
+Preference<bool> ProfileRendering("render/Profile rendering", false);
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -186,10 +187,25 @@ Preference<Color> GridColor2D("Rendere/Grid/Color2D", Color(0.8f, 0.8f, 0.8f, 0.
 Preference<int> TextureMinFilter("render/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("render/Texture mode mag filter", 0x2600);
 Preference<bool> EnableMSAA("render/Enable multisampling", true);
+Preference<bool> ReverseDepth("render/Reverse depth", false);
+Preference<bool> CompressTextures("render/Compress textures", false);
+Preference<bool> LazyMaterialLoading("render/Lazy material loading", true);
+Preference<float> EntityModelReducedDetailDistance(
+  "render/Entity model reduced detail distance", 1024.0f);
+Preference<float> EntityModelMinimalDetailDistance(
+  "render/Entity model minimal detail distance", 4096.0f);
+Preference<int> MotionFrameTimeTarget("render/Motion frame time target", 33);
 
 Preference<bool> AlignmentLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
 
+Preference<int> UndoMemoryBudget("Editor/Undo memory budget", 0);
+Preference<int> SlowCommandThreshold("Editor/Slow command threshold", 500);
+Preference<bool> UseMapCache("Editor/Use map cache", false);
+Preference<bool> LoadHiddenLayers("Editor/Load hidden layers", true);
+Preference<bool> CompressAutosaves("Editor/Compress autosaves", false);
+Preference<int> AutosaveJournalEntries("Editor/Autosave journal entries", 0);
+
 Preference<std::filesystem::path>& RendererFontPath()
 {
   static Preference<std::filesystem::path> fontPath(
@@ -291,6 +307,7 @@ Preference<bool> ShowFog("Map view/Show fog", false);
 Preference<bool> ShowEdges("Map view/Show edges", true);
 
 Preference<bool> ShowSoftMapBounds("Map view/Show soft map bounds", true);
+Preference<bool> CullWithPortalFile("Map view/Cull with portal file", false);
 
 Preference<bool> ShowPointEntities("Map view/Show point entities", true);
 Preference<bool> ShowBrushes("Map view/Show brushes", true);
@@ -328,6 +345,7 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+    &ProfileRendering,
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
@@ -381,8 +399,19 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &GridColor2D,
     &TextureMinFilter,
     &TextureMagFilter,
+    &CompressTextures,
+    &LazyMaterialLoading,
+    &EntityModelReducedDetailDistance,
+    &EntityModelMinimalDetailDistance,
+    &MotionFrameTimeTarget,
     &AlignmentLock,
     &UVLock,
+    &UndoMemoryBudget,
+    &SlowCommandThreshold,
+    &UseMapCache,
+    &LoadHiddenLayers,
+    &CompressAutosaves,
+    &AutosaveJournalEntries,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
@@ -424,6 +453,7 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &ShowFog,
     &ShowEdges,
     &ShowSoftMapBounds,
+    &CullWithPortalFile,
     &ShowPointEntities,
     &ShowBrushes,
     &EntityLinkMode};
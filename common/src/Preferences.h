@@ -56,6 +56,7 @@ extern Preference<Color> PointFileColor;
 extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
+extern Preference<bool> ProfileRendering;
 
 Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -130,10 +131,57 @@ extern Preference<Color> GridColor2D;
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
 extern Preference<bool> EnableMSAA;
+extern Preference<bool> ReverseDepth;
+extern Preference<bool> CompressTextures;
+extern Preference<bool> LazyMaterialLoading;
+extern Preference<float> EntityModelReducedDetailDistance;
+extern Preference<float> EntityModelMinimalDetailDistance;
+
+/**
+ * While the camera of the 3D view moves and frames take longer than this many
+ * milliseconds, optional passes such as decals, link lines, occluded edges and entity
+ * labels are skipped. 0 always renders at full quality.
+ */
+extern Preference<int> MotionFrameTimeTarget;
 
 extern Preference<bool> AlignmentLock;
 extern Preference<bool> UVLock;
 
+/**
+ * The memory budget of the undo history in megabytes. If the budget is exceeded, the
+ * oldest undo steps are dropped. 0 means that the undo history is not limited.
+ */
+extern Preference<int> UndoMemoryBudget;
+
+/**
+ * Executing, undoing or redoing a command that takes longer than this many milliseconds
+ * is logged as slow. 0 disables logging slow commands.
+ */
+extern Preference<int> SlowCommandThreshold;
+
+/**
+ * Whether a binary cache of the parsed map is kept next to the map file to speed up
+ * loading the map again.
+ */
+extern Preference<bool> UseMapCache;
+
+/**
+ * Whether the objects of hidden custom layers are loaded when a map is opened. If not,
+ * they are loaded on demand from the layer editor.
+ */
+extern Preference<bool> LoadHiddenLayers;
+
+/**
+ * Whether autosave backups are written as compressed map files.
+ */
+extern Preference<bool> CompressAutosaves;
+
+/**
+ * The number of autosave journal entries that are written between two autosave backups.
+ * If this is 0, no journal is kept and every autosave creates a new backup.
+ */
+extern Preference<int> AutosaveJournalEntries;
+
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
 
@@ -191,6 +239,7 @@ extern Preference<bool> ShowFog;
 extern Preference<bool> ShowEdges;
 
 extern Preference<bool> ShowSoftMapBounds;
+extern Preference<bool> CullWithPortalFile;
 
 // Editor context
 extern Preference<bool> ShowPointEntities;
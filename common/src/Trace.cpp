@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <sstream>
+
+namespace tb
+{
+namespace
+{
+
+uint64_t currentThreadId()
+{
+  static auto nextThreadId = std::atomic<uint64_t>{1};
+  thread_local const auto threadId = nextThreadId++;
+  return threadId;
+}
+
+int64_t toMicros(const Tracer::Clock::duration duration)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+std::string escapeJson(const std::string& str)
+{
+  auto result = std::string{};
+  result.reserve(str.size());
+  for (const auto c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        result += fmt::format("\\u{:04x}", int(c));
+      }
+      else
+      {
+        result += c;
+      }
+      break;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+Tracer::Tracer(const size_t maxEventCount)
+  : m_maxEventCount{maxEventCount}
+  , m_startTime{Clock::now()}
+{
+}
+
+Tracer& Tracer::instance()
+{
+  static auto instance = Tracer{};
+  return instance;
+}
+
+void Tracer::record(
+  std::string name, const Clock::time_point start, const Clock::time_point end)
+{
+  const auto threadId = currentThreadId();
+
+  auto lock = std::lock_guard{m_mutex};
+  if (m_events.size() < m_maxEventCount)
+  {
+    m_events.push_back(TraceEvent{
+      std::move(name), threadId, toMicros(start - m_startTime), toMicros(end - start)});
+  }
+}
+
+std::vector<TraceEvent> Tracer::events() const
+{
+  auto lock = std::lock_guard{m_mutex};
+  return m_events;
+}
+
+void Tracer::clear()
+{
+  auto lock = std::lock_guard{m_mutex};
+  m_events.clear();
+}
+
+std::string toChromeTraceJson(const std::vector<TraceEvent>& events)
+{
+  auto str = std::stringstream{};
+  str << "{\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    const auto& event = events[i];
+    if (i > 0)
+    {
+      str << ",";
+    }
+    str << "\n"
+        << fmt::format(
+             R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{},"dur":{}}})",
+             escapeJson(event.name),
+             event.threadId,
+             event.startMicros,
+             event.durationMicros);
+  }
+  str << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return str.str();
+}
+
+TraceScope::TraceScope(const char* name, Tracer& tracer)
+  : m_tracer{tracer}
+  , m_name{name}
+  , m_start{Tracer::Clock::now()}
+{
+}
+
+TraceScope::~TraceScope()
+{
+  m_tracer.record(m_name, m_start, Tracer::Clock::now());
+}
+
+} // namespace tb
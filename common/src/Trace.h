@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tb
+{
+
+struct TraceEvent
+{
+  std::string name;
+  uint64_t threadId;
+  int64_t startMicros;
+  int64_t durationMicros;
+
+  auto operator<=>(const TraceEvent& other) const = default;
+};
+
+/**
+ * Collects the trace events recorded by TraceScope. Recording is thread safe. Once the
+ * maximum number of events is reached, further events are dropped.
+ */
+class Tracer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
+  size_t m_maxEventCount;
+  Clock::time_point m_startTime;
+
+  mutable std::mutex m_mutex;
+  std::vector<TraceEvent> m_events;
+
+public:
+  explicit Tracer(size_t maxEventCount = 1000000);
+
+  static Tracer& instance();
+
+  void record(std::string name, Clock::time_point start, Clock::time_point end);
+
+  std::vector<TraceEvent> events() const;
+  void clear();
+
+  deleteCopyAndMove(Tracer);
+};
+
+/**
+ * Formats the given events in the Chrome trace event format, which can be loaded into
+ * chrome://tracing, Perfetto or Speedscope.
+ */
+std::string toChromeTraceJson(const std::vector<TraceEvent>& events);
+
+/**
+ * Records the time between its construction and destruction as a trace event.
+ */
+class TraceScope
+{
+private:
+  Tracer& m_tracer;
+  const char* m_name;
+  Tracer::Clock::time_point m_start;
+
+public:
+  explicit TraceScope(const char* name, Tracer& tracer = Tracer::instance());
+  ~TraceScope();
+
+  deleteCopyAndMove(TraceScope);
+};
+
+} // namespace tb
+
+#define TB_TRACE_CONCAT_IMPL(a, b) a##b
+#define TB_TRACE_CONCAT(a, b) TB_TRACE_CONCAT_IMPL(a, b)
+
+// Traces the enclosing scope. Tracing is compiled out unless TB_ENABLE_TRACING is set.
+#ifdef TB_ENABLE_TRACING
+#define TB_TRACE_SCOPE(name)                                                             \
+  const ::tb::TraceScope TB_TRACE_CONCAT(traceScope_, __LINE__)                          \
+  {                                                                                      \
+    name                                                                                 \
+  }
+#else
+#define TB_TRACE_SCOPE(name)                                                             \
+  do                                                                                     \
+  {                                                                                      \
+  } while (0)
+#endif
@@ -23,6 +23,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Result.h"
+#include "Trace.h"
 #include "TrenchBroomStackWalker.h"
 #include "io/DiskIO.h"
 #include "io/MapHeader.h"
@@ -256,6 +257,16 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
 
 TrenchBroomApp::~TrenchBroomApp()
 {
+#ifdef TB_ENABLE_TRACING
+  const auto tracePath = io::SystemPaths::userDataDirectory() / "trace.json";
+  io::Disk::withOutputStream(tracePath, [](auto& stream) {
+    stream << toChromeTraceJson(Tracer::instance().events());
+  }) | kdl::transform_error([&](const auto& e) {
+    qWarning() << "Could not write trace to" << io::pathAsQString(tracePath) << ": "
+               << QString::fromStdString(e.msg);
+  });
+#endif
+
   PreferenceManager::destroyInstance();
 }
 
@@ -0,0 +1,397 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * An immutable bounding volume hierarchy over values with bounding boxes.
+ *
+ * The hierarchy is built at once using the surface area heuristic with binned split
+ * candidates, and its nodes and values are stored in two flat arrays. Unlike an octree,
+ * it does not depend on the spatial distribution of the values, so it remains shallow for
+ * large meshes with very unevenly sized triangles.
+ *
+ * @tparam T the floating point type of the bounding boxes
+ * @tparam U the type of the values
+ */
+template <typename T, typename U>
+class bvh
+{
+public:
+  using box_type = vm::bbox<T, 3>;
+  using ray_type = vm::ray<T, 3>;
+
+private:
+  static constexpr size_t bin_count = 16;
+  static constexpr size_t max_leaf_size = 8;
+
+  /**
+   * For an inner node, offset is the index of its first child and the second child
+   * follows immediately. For a leaf, offset is the index of its first value.
+   */
+  struct node
+  {
+    box_type bounds;
+    uint32_t offset;
+    uint32_t count;
+
+    bool is_leaf() const { return count > 0; }
+  };
+
+  std::vector<node> m_nodes;
+  std::vector<U> m_values;
+
+public:
+  bvh() = default;
+
+  /**
+   * Builds a hierarchy over the given values and their bounding boxes.
+   */
+  explicit bvh(std::vector<std::pair<box_type, U>> values) { build(std::move(values)); }
+
+  bool empty() const { return m_values.empty(); }
+
+  size_t size() const { return m_values.size(); }
+
+  /**
+   * Returns the distance to the closest intersection of the given ray with a value.
+   *
+   * The given function is called with every value whose bounding box is hit by the ray
+   * no farther away than the closest intersection found so far, and it must return the
+   * distance to the intersection of the ray with that value, if any.
+   */
+  template <typename F>
+  std::optional<T> find_closest(const ray_type& ray, const F& intersect_value) const
+  {
+    if (m_nodes.empty())
+    {
+      return std::nullopt;
+    }
+
+    const auto inverse_direction = vm::vec<T, 3>{
+      T(1) / ray.direction.x(), T(1) / ray.direction.y(), T(1) / ray.direction.z()};
+
+    auto closest = std::optional<T>{};
+    const auto is_closer = [&](const T distance) {
+      return !closest || distance < *closest;
+    };
+
+    auto stack = std::vector<std::pair<uint32_t, T>>{};
+    if (const auto distance =
+          entry_distance(m_nodes.front().bounds, ray, inverse_direction))
+    {
+      stack.emplace_back(0u, *distance);
+    }
+
+    while (!stack.empty())
+    {
+      const auto [node_index, node_distance] = stack.back();
+      stack.pop_back();
+
+      if (!is_closer(node_distance))
+      {
+        continue;
+      }
+
+      const auto& current = m_nodes[node_index];
+      if (current.is_leaf())
+      {
+        for (auto i = current.offset; i < current.offset + current.count; ++i)
+        {
+          const auto distance = intersect_value(m_values[i]);
+          if (distance && is_closer(*distance))
+          {
+            closest = distance;
+          }
+        }
+      }
+      else
+      {
+        const auto first = current.offset;
+        const auto second = current.offset + 1u;
+        const auto first_distance =
+          entry_distance(m_nodes[first].bounds, ray, inverse_direction);
+        const auto second_distance =
+          entry_distance(m_nodes[second].bounds, ray, inverse_direction);
+
+        // push the farther child first so that the nearer child is visited first
+        if (first_distance && second_distance)
+        {
+          if (*first_distance < *second_distance)
+          {
+            stack.emplace_back(second, *second_distance);
+            stack.emplace_back(first, *first_distance);
+          }
+          else
+          {
+            stack.emplace_back(first, *first_distance);
+            stack.emplace_back(second, *second_distance);
+          }
+        }
+        else if (first_distance)
+        {
+          stack.emplace_back(first, *first_distance);
+        }
+        else if (second_distance)
+        {
+          stack.emplace_back(second, *second_distance);
+        }
+      }
+    }
+
+    return closest;
+  }
+
+private:
+  /**
+   * Returns the distance at which the given ray enters the given box, or 0 if the ray
+   * starts inside of the box.
+   */
+  static std::optional<T> entry_distance(
+    const box_type& bounds,
+    const ray_type& ray,
+    const vm::vec<T, 3>& inverse_direction)
+  {
+    auto t_min = T(0);
+    auto t_max = std::numeric_limits<T>::max();
+    for (size_t i = 0; i < 3; ++i)
+    {
+      auto t1 = (bounds.min[i] - ray.origin[i]) * inverse_direction[i];
+      auto t2 = (bounds.max[i] - ray.origin[i]) * inverse_direction[i];
+      if (t1 > t2)
+      {
+        std::swap(t1, t2);
+      }
+
+      // a NaN results if the ray runs inside of a slab plane and is ignored here
+      t_min = std::max(t_min, t1);
+      t_max = std::min(t_max, t2);
+      if (t_min > t_max)
+      {
+        return std::nullopt;
+      }
+    }
+    return t_min;
+  }
+
+  static T half_area(const box_type& bounds)
+  {
+    const auto size = bounds.size();
+    return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+  }
+
+  void build(std::vector<std::pair<box_type, U>> values)
+  {
+    assert(values.size() < std::numeric_limits<uint32_t>::max());
+
+    if (values.empty())
+    {
+      return;
+    }
+
+    auto centers = std::vector<vm::vec<T, 3>>{};
+    centers.reserve(values.size());
+    for (const auto& entry : values)
+    {
+      centers.push_back(entry.first.center());
+    }
+
+    auto indices = std::vector<size_t>(values.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      indices[i] = i;
+    }
+
+    struct task
+    {
+      size_t node_index;
+      size_t begin;
+      size_t end;
+    };
+
+    // the hierarchy is built without recursion because unbalanced splits can make it
+    // very deep
+    m_nodes.reserve(2 * values.size() / max_leaf_size + 1);
+    m_nodes.push_back(node{});
+    auto tasks = std::vector<task>{{0, 0, values.size()}};
+
+    while (!tasks.empty())
+    {
+      const auto [node_index, begin, end] = tasks.back();
+      tasks.pop_back();
+
+      auto bounds = typename box_type::builder{};
+      auto center_bounds = typename box_type::builder{};
+      for (auto i = begin; i < end; ++i)
+      {
+        bounds.add(values[indices[i]].first);
+        center_bounds.add(centers[indices[i]]);
+      }
+
+      m_nodes[node_index].bounds = bounds.bounds();
+
+      const auto split = find_split(
+        values, centers, indices, begin, end, bounds.bounds(), center_bounds.bounds());
+      if (!split)
+      {
+        m_nodes[node_index].offset = uint32_t(begin);
+        m_nodes[node_index].count = uint32_t(end - begin);
+        continue;
+      }
+
+      const auto first_child = m_nodes.size();
+      m_nodes[node_index].offset = uint32_t(first_child);
+      m_nodes[node_index].count = 0;
+      m_nodes.push_back(node{});
+      m_nodes.push_back(node{});
+
+      tasks.push_back({first_child, begin, *split});
+      tasks.push_back({first_child + 1, *split, end});
+    }
+
+    m_values.reserve(values.size());
+    for (const auto index : indices)
+    {
+      m_values.push_back(std::move(values[index].second));
+    }
+  }
+
+  /**
+   * Partitions the given range of indices and returns the index at which the second
+   * partition begins, or nullopt if the range should become a leaf.
+   */
+  static std::optional<size_t> find_split(
+    const std::vector<std::pair<box_type, U>>& values,
+    const std::vector<vm::vec<T, 3>>& centers,
+    std::vector<size_t>& indices,
+    const size_t begin,
+    const size_t end,
+    const box_type& bounds,
+    const box_type& center_bounds)
+  {
+    const auto count = end - begin;
+    if (count <= 1)
+    {
+      return std::nullopt;
+    }
+
+    const auto extent = center_bounds.size();
+    const auto axis = extent.x() >= extent.y() && extent.x() >= extent.z() ? size_t(0)
+                      : extent.y() >= extent.z()                          ? size_t(1)
+                                                                           : size_t(2);
+
+    if (extent[axis] <= T(0))
+    {
+      // all centers coincide, so the values can only be split by count
+      if (count <= max_leaf_size)
+      {
+        return std::nullopt;
+      }
+      return begin + count / 2;
+    }
+
+    const auto scale = T(bin_count) / extent[axis];
+    const auto bin_of = [&](const size_t index) {
+      const auto bin = size_t((centers[index][axis] - center_bounds.min[axis]) * scale);
+      return std::min(bin, bin_count - 1);
+    };
+
+    auto bin_bounds = std::array<typename box_type::builder, bin_count>{};
+    auto bin_counts = std::array<size_t, bin_count>{};
+    for (auto i = begin; i < end; ++i)
+    {
+      const auto bin = bin_of(indices[i]);
+      bin_bounds[bin].add(values[indices[i]].first);
+      ++bin_counts[bin];
+    }
+
+    // the cost of a split after each bin is the number of values on each side weighted
+    // by the surface area of their bounds
+    auto right_costs = std::array<T, bin_count>{};
+    auto right_bounds = typename box_type::builder{};
+    auto right_count = size_t(0);
+    for (auto bin = bin_count - 1; bin > 0; --bin)
+    {
+      if (bin_bounds[bin].initialized())
+      {
+        right_bounds.add(bin_bounds[bin].bounds());
+      }
+      right_count += bin_counts[bin];
+      right_costs[bin - 1] =
+        right_count > 0 ? T(right_count) * half_area(right_bounds.bounds()) : T(0);
+    }
+
+    auto best_bin = std::optional<size_t>{};
+    auto best_cost = std::numeric_limits<T>::max();
+    auto left_bounds = typename box_type::builder{};
+    auto left_count = size_t(0);
+    for (size_t bin = 0; bin < bin_count - 1; ++bin)
+    {
+      if (bin_bounds[bin].initialized())
+      {
+        left_bounds.add(bin_bounds[bin].bounds());
+      }
+      left_count += bin_counts[bin];
+      if (left_count > 0 && left_count < count)
+      {
+        const auto cost =
+          T(left_count) * half_area(left_bounds.bounds()) + right_costs[bin];
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_bin = bin;
+        }
+      }
+    }
+
+    // a leaf costs one intersection per value, a split costs one traversal step and the
+    // intersections of each side weighted by the probability of hitting that side
+    const auto area = half_area(bounds);
+    const auto leaf_cost = T(count);
+    const auto split_cost = area > T(0) ? T(1) + best_cost / area : leaf_cost;
+    if (!best_bin || (count <= max_leaf_size && leaf_cost <= split_cost))
+    {
+      return count <= max_leaf_size ? std::nullopt : std::optional{begin + count / 2};
+    }
+
+    const auto it = std::partition(
+      indices.begin() + std::ptrdiff_t(begin),
+      indices.begin() + std::ptrdiff_t(end),
+      [&](const size_t index) { return bin_of(index) <= *best_bin; });
+    return size_t(std::distance(indices.begin(), it));
+  }
+};
+
+} // namespace tb
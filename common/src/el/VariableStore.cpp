@@ -71,26 +71,29 @@ bool operator!=(const VariableStore& lhs, const VariableStore& rhs)
   return !(lhs == rhs);
 }
 
-VariableTable::VariableTable() = default;
+VariableTable::VariableTable()
+  : VariableTable{Table{}}
+{
+}
 
 VariableTable::VariableTable(Table variables)
-  : m_variables{std::move(variables)}
+  : m_variables{std::make_shared<Table>(std::move(variables))}
 {
 }
 
 VariableStore* VariableTable::clone() const
 {
-  return new VariableTable(m_variables);
+  return new VariableTable{*this};
 }
 
 size_t VariableTable::size() const
 {
-  return m_variables.size();
+  return m_variables->size();
 }
 
 Value VariableTable::value(const std::string& name) const
 {
-  if (const auto it = m_variables.find(name); it != std::end(m_variables))
+  if (const auto it = m_variables->find(name); it != std::end(*m_variables))
   {
     return it->second;
   }
@@ -99,12 +102,16 @@ Value VariableTable::value(const std::string& name) const
 
 std::vector<std::string> VariableTable::names() const
 {
-  return kdl::map_keys(m_variables);
+  return kdl::map_keys(*m_variables);
 }
 
 void VariableTable::set(std::string name, Value value)
 {
-  m_variables[std::move(name)] = std::move(value);
+  if (m_variables.use_count() > 1)
+  {
+    m_variables = std::make_shared<Table>(*m_variables);
+  }
+  (*m_variables)[std::move(name)] = std::move(value);
 }
 
 NullVariableStore::NullVariableStore() = default;
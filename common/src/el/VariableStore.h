@@ -23,6 +23,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -52,11 +53,18 @@ std::ostream& operator<<(std::ostream& lhs, const VariableStore& rhs);
 bool operator==(const VariableStore& lhs, const VariableStore& rhs);
 bool operator!=(const VariableStore& lhs, const VariableStore& rhs);
 
+/**
+ * A variable store backed by a map of variable names to values.
+ *
+ * Copies and clones share the underlying table, which is only copied when a shared table
+ * is modified. Since values are immutable and shared as well, creating an evaluation
+ * context for a large table such as a game configuration does not copy the table.
+ */
 class VariableTable : public VariableStore
 {
 private:
   using Table = std::map<std::string, Value>;
-  Table m_variables;
+  std::shared_ptr<Table> m_variables;
 
 public:
   VariableTable();
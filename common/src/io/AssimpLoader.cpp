@@ -23,6 +23,7 @@
 
 #include "Logger.h"
 #include "ReaderException.h"
+#include "io/AssimpModelCache.h"
 #include "io/File.h"
 #include "io/FileSystem.h"
 #include "io/MaterialUtils.h"
@@ -37,6 +38,7 @@
 #include "render/IndexRangeMapBuilder.h"
 #include "render/PrimType.h"
 
+#include "kdl/overload.h"
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -51,6 +53,7 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
 #include <optional>
 #include <ranges>
 #include <string_view>
@@ -132,6 +135,7 @@ class AssimpIOSystem : public Assimp::IOSystem
 {
 private:
   const FileSystem& m_fs;
+  std::vector<AssimpModelSource> m_sources;
 
 public:
   explicit AssimpIOSystem(const FileSystem& fs)
@@ -151,6 +155,11 @@ public:
 
   void Close(Assimp::IOStream* file) override { delete file; }
 
+  /**
+   * Returns the files that were opened by Assimp so far.
+   */
+  const std::vector<AssimpModelSource>& sources() const { return m_sources; }
+
   Assimp::IOStream* Open(const char* path, const char* mode) override
   {
     if (mode[0] != 'r')
@@ -158,12 +167,24 @@ public:
       throw ParserException{"Assimp attempted to open a file not for reading."};
     }
 
-    return (m_fs.openFile(path) | kdl::transform([](auto file) {
+    return (m_fs.openFile(path) | kdl::transform([&](auto file) {
+              addSource(path, *file);
               return std::make_unique<AssimpIOStream>(std::move(file));
             })
             | kdl::if_error([](auto e) { throw ParserException{e.msg}; }) | kdl::value())
       .release();
   }
+
+private:
+  void addSource(const std::filesystem::path& path, const File& file)
+  {
+    if (!std::ranges::any_of(
+          m_sources, [&](const auto& source) { return source.path == path; }))
+    {
+      const auto reader = file.reader().buffer();
+      m_sources.push_back(makeAssimpModelSource(path, reader.begin(), reader.end()));
+    }
+  }
 };
 
 std::optional<mdl::Texture> loadFallbackTexture(const FileSystem& fs)
@@ -205,10 +226,10 @@ mdl::Texture loadTextureFromFileSystem(
 }
 
 mdl::Texture loadUncompressedEmbeddedTexture(
-  const aiTexel& data, const size_t width, const size_t height)
+  const std::vector<char>& data, const size_t width, const size_t height)
 {
   auto buffer = mdl::TextureBuffer{width * height * sizeof(aiTexel)};
-  std::memcpy(buffer.data(), &data, width * height * sizeof(aiTexel));
+  std::memcpy(buffer.data(), data.data(), std::min(data.size(), buffer.size()));
 
   const auto averageColor = getAverageColor(buffer, GL_BGRA);
   return {
@@ -222,45 +243,64 @@ mdl::Texture loadUncompressedEmbeddedTexture(
 }
 
 mdl::Texture loadCompressedEmbeddedTexture(
-  const aiTexel& data, const size_t size, const FileSystem& fs, Logger& logger)
+  const std::vector<char>& data, const FileSystem& fs, Logger& logger)
 {
-  return readFreeImageTextureFromMemory(reinterpret_cast<const uint8_t*>(&data), size)
+  return readFreeImageTextureFromMemory(
+           reinterpret_cast<const uint8_t*>(data.data()), data.size())
          | kdl::or_else(makeReadTextureErrorHandler(fs, logger)) | kdl::value();
 }
 
 mdl::Texture loadTexture(
+  const AssimpTextureSource& textureSource, const FileSystem& fs, Logger& logger)
+{
+  return std::visit(
+    kdl::overload(
+      [&](const AssimpTextureFile& textureFile) {
+        return loadTextureFromFileSystem(textureFile.path, fs, logger);
+      },
+      [&](const AssimpEmbeddedTexture& embeddedTexture) {
+        if (embeddedTexture.height != 0)
+        {
+          // The texture is uncompressed, load it directly.
+          return loadUncompressedEmbeddedTexture(
+            embeddedTexture.data, embeddedTexture.width, embeddedTexture.height);
+        }
+
+        // The texture is embedded, but compressed. Let FreeImage load it from memory.
+        return loadCompressedEmbeddedTexture(embeddedTexture.data, fs, logger);
+      },
+      [&](const AssimpFallbackTexture&) {
+        return loadFallbackOrDefaultTexture(fs, logger);
+      }),
+    textureSource);
+}
+
+AssimpTextureSource getTextureSource(
   const aiTexture* texture,
   const std::filesystem::path& texturePath,
-  const std::filesystem::path& modelPath,
-  const FileSystem& fs,
-  Logger& logger)
+  const std::filesystem::path& modelPath)
 {
   if (!texture)
   {
-    // The texture is not embedded. Load it using the file system.
-    const auto filePath = modelPath.parent_path() / texturePath;
-    return loadTextureFromFileSystem(filePath, fs, logger);
+    // The texture is not embedded. It is loaded using the file system.
+    return AssimpTextureFile{modelPath.parent_path() / texturePath};
   }
 
-  if (texture->mHeight != 0)
-  {
-    // The texture is uncompressed, load it directly.
-    return loadUncompressedEmbeddedTexture(
-      *texture->pcData, texture->mWidth, texture->mHeight);
-  }
-
-  // The texture is embedded, but compressed. Let FreeImage load it from memory.
-  return loadCompressedEmbeddedTexture(*texture->pcData, texture->mWidth, fs, logger);
+  const auto* data = reinterpret_cast<const char*>(texture->pcData);
+  const auto size = texture->mHeight != 0
+                      ? size_t(texture->mWidth) * texture->mHeight * sizeof(aiTexel)
+                      : size_t(texture->mWidth);
+  return AssimpEmbeddedTexture{
+    texture->mWidth, texture->mHeight, std::vector<char>(data, data + size)};
 }
 
-std::vector<mdl::Texture> loadTexturesForMaterial(
+std::vector<AssimpTextureSource> getTextureSourcesForMaterial(
   const aiScene& scene,
   const size_t materialIndex,
   const std::filesystem::path& modelPath,
-  const FileSystem& fs,
   Logger& logger)
 {
-  auto textures = std::vector<mdl::Texture>{};
+  auto textureSources = std::vector<AssimpTextureSource>{};
 
   // Is there even a single diffuse texture? If not, fail and load fallback texture.
   const auto textureCount =
@@ -275,7 +315,7 @@ std::vector<mdl::Texture> loadTexturesForMaterial(
 
       const auto texturePath = std::filesystem::path{path.C_Str()};
       const auto* texture = scene.GetEmbeddedTexture(path.C_Str());
-      textures.push_back(loadTexture(texture, texturePath, modelPath, fs, logger));
+      textureSources.push_back(getTextureSource(texture, texturePath, modelPath));
     }
   }
   else
@@ -285,19 +325,12 @@ std::vector<mdl::Texture> loadTexturesForMaterial(
       materialIndex,
       modelPath));
 
-    textures.push_back(loadFallbackOrDefaultTexture(fs, logger));
+    textureSources.push_back(AssimpFallbackTexture{});
   }
 
-  return textures;
+  return textureSources;
 }
 
-struct AssimpComputedMeshData
-{
-  size_t m_meshIndex;
-  std::vector<mdl::EntityModelVertex> m_vertices;
-  render::IndexRangeMap m_indices;
-};
-
 struct AssimpBoneInformation
 {
   size_t m_boneIndex;
@@ -618,7 +651,7 @@ Result<std::vector<mdl::EntityModelVertex>> computeMeshVertices(
   return vertices;
 }
 
-AssimpComputedMeshData computeMeshData(
+AssimpMeshInfo computeMeshData(
   const AssimpMeshWithTransforms& mesh,
   const size_t meshIndex,
   const std::vector<mdl::EntityModelVertex>& vertices)
@@ -721,11 +754,8 @@ aiMatrix4x4 getAxisTransform(const aiScene& scene)
   // clang-format on
 }
 
-Result<void> loadSceneFrame(
-  const aiScene& scene,
-  const size_t frameIndex,
-  mdl::EntityModelData& model,
-  const std::string& name)
+Result<AssimpFrameInfo> importFrame(
+  const aiScene& scene, const size_t frameIndex, const std::string& name)
 {
   // load the animation information for the current "frame" (animation)
   const auto boneTransforms =
@@ -769,31 +799,82 @@ Result<void> loadSceneFrame(
                         return computeMeshData(mesh, meshIndex, vertices);
                       });
            })
-         | kdl::fold | kdl::and_then([&](const auto& meshData) -> Result<void> {
+         | kdl::fold
+         | kdl::and_then([&](auto meshes) -> Result<AssimpFrameInfo> {
              if (!bounds.initialized())
              {
                // passing empty bounds as bbox crashes the program, don't let it happen
                return Error{"Model has no vertices. (So no valid bounding box.)"};
              }
 
-             const auto frameBounds = bounds.bounds();
-             auto& frame = model.addFrame(name, frameBounds);
+             return AssimpFrameInfo{name, bounds.bounds(), std::move(meshes)};
+           });
+}
 
-             for (const auto& data : meshData)
-             {
-               auto& surface = model.surface(data.m_meshIndex);
-               surface.addMesh(frame, data.m_vertices, data.m_indices);
-             }
+Result<AssimpModelInfo> importModel(
+  const aiScene& scene, const std::filesystem::path& modelPath, Logger& logger)
+{
+  // create a surface for each mesh in the scene
+  // an assimp mesh will only ever have one material, but a material can have multiple
+  // alternatives (this is how assimp handles skins)
+  auto surfaces = std::vector<AssimpSurfaceInfo>{};
+  surfaces.reserve(scene.mNumMeshes);
+  for (size_t i = 0; i < scene.mNumMeshes; ++i)
+  {
+    const auto& mesh = *scene.mMeshes[i];
+    surfaces.push_back(AssimpSurfaceInfo{
+      mesh.mName.data,
+      getTextureSourcesForMaterial(scene, mesh.mMaterialIndex, modelPath, logger)});
+  }
 
-             return Result<void>{};
+  // create a frame for each animation in the scene
+  // if we have no animations, always load 1 frame for the reference model
+  const auto numSequences = std::max(scene.mNumAnimations, 1u);
+  const auto name = modelPath.string();
+
+  return std::views::iota(0u, numSequences)
+         | std::views::transform(
+           [&](const auto i) { return importFrame(scene, i, name); })
+         | kdl::fold | kdl::transform([&](auto frames) {
+             return AssimpModelInfo{std::move(surfaces), std::move(frames)};
            });
 }
 
+mdl::EntityModelData createModelData(
+  const AssimpModelInfo& modelInfo, const FileSystem& fs, Logger& logger)
+{
+  auto data = mdl::EntityModelData{mdl::PitchType::Normal, mdl::Orientation::Oriented};
+
+  for (const auto& surfaceInfo : modelInfo.surfaces)
+  {
+    auto& surface = data.addSurface(surfaceInfo.name, modelInfo.frames.size());
+    surface.setSkins(kdl::vec_transform(surfaceInfo.textures, [&](const auto& source) {
+      auto textureResource = createTextureResource(loadTexture(source, fs, logger));
+      return mdl::Material{"", std::move(textureResource)};
+    }));
+  }
+
+  for (const auto& frameInfo : modelInfo.frames)
+  {
+    auto& frame = data.addFrame(frameInfo.name, frameInfo.bounds);
+    for (const auto& mesh : frameInfo.meshes)
+    {
+      data.surface(mesh.surfaceIndex).addMesh(frame, mesh.vertices, mesh.indices);
+    }
+  }
+
+  return data;
+}
+
 } // namespace
 
-AssimpLoader::AssimpLoader(std::filesystem::path path, const FileSystem& fs)
+AssimpLoader::AssimpLoader(
+  std::filesystem::path path,
+  const FileSystem& fs,
+  std::shared_ptr<const AssimpModelCache> cache)
   : m_path{std::move(path)}
   , m_fs{fs}
+  , m_cache{std::move(cache)}
 {
 }
 
@@ -822,60 +903,51 @@ Result<mdl::EntityModelData> AssimpLoader::load(tb::Logger& logger)
 {
   try
   {
-    constexpr auto assimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
-                                 | aiProcess_FlipWindingOrder | aiProcess_SortByPType
-                                 | aiProcess_FlipUVs;
-
-    const auto modelPath = m_path.string();
-
-    // Import the file as an Assimp scene and populate our vectors.
-    auto importer = Assimp::Importer{};
-    importer.SetIOHandler(new AssimpIOSystem{m_fs});
+    return importModelOrLoadCache(logger) | kdl::transform([&](auto modelInfo) {
+             return createModelData(modelInfo, m_fs, logger);
+           });
+  }
+  catch (const ParserException& e)
+  {
+    return Error{e.what()};
+  }
+}
 
-    const auto* scene = importer.ReadFile(modelPath, assimpFlags);
-    if (!scene)
+Result<AssimpModelInfo> AssimpLoader::importModelOrLoadCache(Logger& logger) const
+{
+  if (m_cache)
+  {
+    if (auto modelInfo = m_cache->load(m_path, m_fs))
     {
-      return Error{fmt::format(
-        "Assimp couldn't import model from '{}': {}", m_path, importer.GetErrorString())};
+      return std::move(*modelInfo);
     }
+  }
 
-    // Create model data.
-    auto data = mdl::EntityModelData{mdl::PitchType::Normal, mdl::Orientation::Oriented};
-
-    // create a frame for each animation in the scene
-    // if we have no animations, always load 1 frame for the reference model
-    const auto numSequences = std::max(scene->mNumAnimations, 1u);
-
-    // create a surface for each mesh in the scene and assign the skins/materials to it
-    const auto numMeshes = scene->mNumMeshes;
-    for (size_t i = 0; i < numMeshes; ++i)
-    {
-      const auto& mesh = scene->mMeshes[i];
-
-      auto& surface = data.addSurface(scene->mMeshes[i]->mName.data, numSequences);
-
-      // an assimp mesh will only ever have one material, but a material can have
-      // multiple alternatives (this is how assimp handles skins)
+  constexpr auto assimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
+                               | aiProcess_FlipWindingOrder | aiProcess_SortByPType
+                               | aiProcess_FlipUVs;
 
-      // load skins for this surface
-      auto textures =
-        loadTexturesForMaterial(*scene, mesh->mMaterialIndex, m_path, m_fs, logger);
-      auto materials = kdl::vec_transform(std::move(textures), [](auto texture) {
-        auto textureResource = createTextureResource(std::move(texture));
-        return mdl::Material{"", std::move(textureResource)};
-      });
-      surface.setSkins(std::move(materials));
-    }
+  // Import the file as an Assimp scene. The importer takes ownership of the IO system.
+  auto importer = Assimp::Importer{};
+  auto* ioSystem = new AssimpIOSystem{m_fs};
+  importer.SetIOHandler(ioSystem);
 
-    return std::views::iota(0u, numSequences) | std::views::transform([&](const auto i) {
-             return loadSceneFrame(*scene, i, data, modelPath);
-           })
-           | kdl::fold | kdl::transform([&]() { return std::move(data); });
-  }
-  catch (const ParserException& e)
+  const auto* scene = importer.ReadFile(m_path.string(), assimpFlags);
+  if (!scene)
   {
-    return Error{e.what()};
+    return Error{fmt::format(
+      "Assimp couldn't import model from '{}': {}", m_path, importer.GetErrorString())};
   }
+
+  return importModel(*scene, m_path, logger) | kdl::transform([&](auto modelInfo) {
+           if (m_cache)
+           {
+             m_cache->store(m_path, ioSystem->sources(), modelInfo)
+               | kdl::transform_error(
+                 [&](const auto& e) { logger.debug() << e.msg; });
+           }
+           return modelInfo;
+         });
 }
 
 } // namespace tb::io
@@ -26,6 +26,7 @@
 #include <assimp/matrix4x4.h>
 
 #include <filesystem>
+#include <memory>
 
 struct aiNode;
 struct aiScene;
@@ -38,7 +39,9 @@ class Material;
 
 namespace tb::io
 {
+class AssimpModelCache;
 class FileSystem;
+struct AssimpModelInfo;
 
 struct AssimpMeshWithTransforms
 {
@@ -52,13 +55,25 @@ class AssimpLoader : public EntityModelLoader
 private:
   std::filesystem::path m_path;
   const FileSystem& m_fs;
+  std::shared_ptr<const AssimpModelCache> m_cache;
 
 public:
-  AssimpLoader(std::filesystem::path path, const FileSystem& fs);
+  /**
+   * Creates a loader for the model at the given path. If a cache is given, the model is
+   * loaded from the cache if possible, and it is stored in the cache after it was
+   * imported otherwise.
+   */
+  AssimpLoader(
+    std::filesystem::path path,
+    const FileSystem& fs,
+    std::shared_ptr<const AssimpModelCache> cache = nullptr);
 
   static bool canParse(const std::filesystem::path& path);
 
   Result<mdl::EntityModelData> load(Logger& logger) override;
+
+private:
+  Result<AssimpModelInfo> importModelOrLoadCache(Logger& logger) const;
 };
 
 } // namespace tb::io
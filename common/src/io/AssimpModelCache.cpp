@@ -0,0 +1,434 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AssimpModelCache.h"
+
+#include "io/CacheUtils.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/FileSystem.h"
+#include "io/PathInfo.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "render/PrimType.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace tb::io
+{
+namespace
+{
+namespace AssimpModelCacheLayout
+{
+constexpr auto Magic = std::string_view{"TBAM"};
+
+/**
+ * Must be incremented whenever the layout of the cache or the way that models are
+ * imported changes.
+ */
+constexpr uint32_t Version = 1;
+
+constexpr uint8_t TextureFile = 0;
+constexpr uint8_t EmbeddedTexture = 1;
+constexpr uint8_t FallbackTexture = 2;
+} // namespace AssimpModelCacheLayout
+
+// vertices are written and read as raw memory
+static_assert(std::is_trivially_copyable_v<mdl::EntityModelVertex>);
+
+// writing
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& stream, const std::string_view str)
+{
+  write(stream, uint32_t(str.size()));
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+void writeSource(std::ostream& stream, const AssimpModelSource& source)
+{
+  writeString(stream, source.path.generic_string());
+  write(stream, source.size);
+  write(stream, source.hash);
+}
+
+void writeTextureSource(std::ostream& stream, const AssimpTextureSource& textureSource)
+{
+  std::visit(
+    kdl::overload(
+      [&](const AssimpTextureFile& textureFile) {
+        write(stream, AssimpModelCacheLayout::TextureFile);
+        writeString(stream, textureFile.path.generic_string());
+      },
+      [&](const AssimpEmbeddedTexture& embeddedTexture) {
+        write(stream, AssimpModelCacheLayout::EmbeddedTexture);
+        write(stream, uint32_t(embeddedTexture.width));
+        write(stream, uint32_t(embeddedTexture.height));
+        write(stream, uint64_t(embeddedTexture.data.size()));
+        stream.write(
+          embeddedTexture.data.data(), std::streamsize(embeddedTexture.data.size()));
+      },
+      [&](const AssimpFallbackTexture&) {
+        write(stream, AssimpModelCacheLayout::FallbackTexture);
+      }),
+    textureSource);
+}
+
+void writeSurface(std::ostream& stream, const AssimpSurfaceInfo& surface)
+{
+  writeString(stream, surface.name);
+  write(stream, uint32_t(surface.textures.size()));
+  for (const auto& textureSource : surface.textures)
+  {
+    writeTextureSource(stream, textureSource);
+  }
+}
+
+void writeMesh(std::ostream& stream, const AssimpMeshInfo& mesh)
+{
+  write(stream, uint32_t(mesh.surfaceIndex));
+
+  write(stream, uint64_t(mesh.vertices.size()));
+  stream.write(
+    reinterpret_cast<const char*>(mesh.vertices.data()),
+    std::streamsize(mesh.vertices.size() * sizeof(mdl::EntityModelVertex)));
+
+  auto primitives = std::vector<std::tuple<render::PrimType, size_t, size_t>>{};
+  mesh.indices.forEachPrimitive(
+    [&](const auto primType, const auto index, const auto count) {
+      primitives.emplace_back(primType, index, count);
+    });
+
+  write(stream, uint32_t(primitives.size()));
+  for (const auto& [primType, index, count] : primitives)
+  {
+    write(stream, uint32_t(primType));
+    write(stream, uint64_t(index));
+    write(stream, uint64_t(count));
+  }
+}
+
+void writeFrame(std::ostream& stream, const AssimpFrameInfo& frame)
+{
+  writeString(stream, frame.name);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    write(stream, frame.bounds.min[i]);
+  }
+  for (size_t i = 0; i < 3; ++i)
+  {
+    write(stream, frame.bounds.max[i]);
+  }
+
+  write(stream, uint32_t(frame.meshes.size()));
+  for (const auto& mesh : frame.meshes)
+  {
+    writeMesh(stream, mesh);
+  }
+}
+
+// reading
+
+std::string readString(Reader& reader)
+{
+  const auto length = reader.readSize<uint32_t>();
+  return reader.readString(length);
+}
+
+/**
+ * Reads a count of elements that take up at least the given number of bytes each, and
+ * checks that the reader has enough data left for them.
+ */
+size_t readCount(Reader& reader, const size_t minElementSize)
+{
+  const auto count = reader.readSize<uint32_t>();
+  if (!reader.canRead(count * minElementSize))
+  {
+    throw ReaderException{fmt::format("Invalid element count {}", count)};
+  }
+  return count;
+}
+
+bool isSourceUnchanged(const AssimpModelSource& source, const FileSystem& fs)
+{
+  return fs.openFile(source.path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           const auto currentSource =
+             makeAssimpModelSource(source.path, reader.begin(), reader.end());
+           return currentSource.size == source.size && currentSource.hash == source.hash;
+         })
+         | kdl::value_or(false);
+}
+
+AssimpTextureSource readTextureSource(Reader& reader)
+{
+  switch (reader.readUnsignedChar<uint8_t>())
+  {
+  case AssimpModelCacheLayout::TextureFile:
+    return AssimpTextureFile{readString(reader)};
+  case AssimpModelCacheLayout::EmbeddedTexture: {
+    const auto width = reader.readSize<uint32_t>();
+    const auto height = reader.readSize<uint32_t>();
+    const auto size = reader.readSize<uint64_t>();
+    if (!reader.canRead(size))
+    {
+      throw ReaderException{"Invalid embedded texture size"};
+    }
+
+    auto data = std::vector<char>(size);
+    reader.read(data.data(), size);
+    return AssimpEmbeddedTexture{width, height, std::move(data)};
+  }
+  case AssimpModelCacheLayout::FallbackTexture:
+    return AssimpFallbackTexture{};
+  default:
+    throw ReaderException{"Invalid texture source type"};
+  }
+}
+
+AssimpSurfaceInfo readSurface(Reader& reader)
+{
+  auto name = readString(reader);
+
+  const auto textureCount = readCount(reader, 1);
+  auto textures = std::vector<AssimpTextureSource>{};
+  textures.reserve(textureCount);
+  for (size_t i = 0; i < textureCount; ++i)
+  {
+    textures.push_back(readTextureSource(reader));
+  }
+
+  return {std::move(name), std::move(textures)};
+}
+
+AssimpMeshInfo readMesh(Reader& reader, const size_t surfaceCount)
+{
+  const auto surfaceIndex = reader.readSize<uint32_t>();
+  if (surfaceIndex >= surfaceCount)
+  {
+    throw ReaderException{fmt::format("Invalid surface index {}", surfaceIndex)};
+  }
+
+  const auto vertexCount = reader.readSize<uint64_t>();
+  if (!reader.canRead(vertexCount * sizeof(mdl::EntityModelVertex)))
+  {
+    throw ReaderException{fmt::format("Invalid vertex count {}", vertexCount)};
+  }
+
+  auto vertices = std::vector<mdl::EntityModelVertex>(vertexCount);
+  reader.read(
+    reinterpret_cast<char*>(vertices.data()),
+    vertexCount * sizeof(mdl::EntityModelVertex));
+
+  auto indices = render::IndexRangeMap{};
+  const auto primitiveCount = readCount(reader, 2 * sizeof(uint64_t));
+  for (size_t i = 0; i < primitiveCount; ++i)
+  {
+    const auto primType = reader.readSize<uint32_t>();
+    const auto index = reader.readSize<uint64_t>();
+    const auto count = reader.readSize<uint64_t>();
+    if (primType >= render::PrimTypeCount || index + count > vertexCount)
+    {
+      throw ReaderException{"Invalid primitive"};
+    }
+    indices.add(render::PrimTypeValues[primType], index, count);
+  }
+
+  return {surfaceIndex, std::move(vertices), std::move(indices)};
+}
+
+AssimpFrameInfo readFrame(Reader& reader, const size_t surfaceCount)
+{
+  auto name = readString(reader);
+  const auto min = reader.readVec<float, 3>();
+  const auto max = reader.readVec<float, 3>();
+
+  const auto meshCount = readCount(reader, sizeof(uint32_t));
+  auto meshes = std::vector<AssimpMeshInfo>{};
+  meshes.reserve(meshCount);
+  for (size_t i = 0; i < meshCount; ++i)
+  {
+    meshes.push_back(readMesh(reader, surfaceCount));
+  }
+
+  return {std::move(name), vm::bbox3f{min, max}, std::move(meshes)};
+}
+
+} // namespace
+
+AssimpModelSource makeAssimpModelSource(
+  const std::filesystem::path& path, const char* begin, const char* end)
+{
+  return {path, uint64_t(end - begin), fnv1a(begin, end)};
+}
+
+void writeAssimpModelCache(
+  std::ostream& stream,
+  const std::vector<AssimpModelSource>& sources,
+  const AssimpModelInfo& modelInfo)
+{
+  const auto& magic = AssimpModelCacheLayout::Magic;
+  stream.write(magic.data(), std::streamsize(magic.size()));
+  write(stream, AssimpModelCacheLayout::Version);
+
+  write(stream, uint32_t(sources.size()));
+  for (const auto& source : sources)
+  {
+    writeSource(stream, source);
+  }
+
+  write(stream, uint32_t(modelInfo.surfaces.size()));
+  for (const auto& surface : modelInfo.surfaces)
+  {
+    writeSurface(stream, surface);
+  }
+
+  write(stream, uint32_t(modelInfo.frames.size()));
+  for (const auto& frame : modelInfo.frames)
+  {
+    writeFrame(stream, frame);
+  }
+
+  // marks the end so that a truncated entry is detected
+  stream.write(magic.data(), std::streamsize(magic.size()));
+}
+
+Result<AssimpModelInfo> readAssimpModelCache(Reader reader, const FileSystem& fs)
+{
+  try
+  {
+    const auto& magic = AssimpModelCacheLayout::Magic;
+    if (reader.readString(magic.size()) != magic)
+    {
+      return Error{"Not a model cache"};
+    }
+
+    if (const auto version = reader.readUnsignedInt<uint32_t>();
+        version != AssimpModelCacheLayout::Version)
+    {
+      return Error{fmt::format("Unsupported model cache version {}", version)};
+    }
+
+    const auto sourceCount = readCount(reader, sizeof(uint32_t));
+    for (size_t i = 0; i < sourceCount; ++i)
+    {
+      auto path = std::filesystem::path{readString(reader)};
+      const auto size = reader.read<uint64_t, uint64_t>();
+      const auto hash = reader.read<uint64_t, uint64_t>();
+      if (!isSourceUnchanged({std::move(path), size, hash}, fs))
+      {
+        return Error{"Model cache is out of date"};
+      }
+    }
+
+    auto modelInfo = AssimpModelInfo{};
+
+    const auto surfaceCount = readCount(reader, sizeof(uint32_t));
+    modelInfo.surfaces.reserve(surfaceCount);
+    for (size_t i = 0; i < surfaceCount; ++i)
+    {
+      modelInfo.surfaces.push_back(readSurface(reader));
+    }
+
+    const auto frameCount = readCount(reader, sizeof(uint32_t));
+    modelInfo.frames.reserve(frameCount);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+      modelInfo.frames.push_back(readFrame(reader, surfaceCount));
+    }
+
+    if (reader.readString(magic.size()) != magic)
+    {
+      return Error{"Model cache is truncated"};
+    }
+
+    return modelInfo;
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{fmt::format("Invalid model cache: {}", e.what())};
+  }
+}
+
+AssimpModelCache::AssimpModelCache(std::filesystem::path directory)
+  : m_directory{std::move(directory)}
+{
+}
+
+const std::filesystem::path& AssimpModelCache::directory() const
+{
+  return m_directory;
+}
+
+std::optional<AssimpModelInfo> AssimpModelCache::load(
+  const std::filesystem::path& modelPath, const FileSystem& fs) const
+{
+  const auto path = entryPath(modelPath);
+  if (Disk::pathInfo(path) != PathInfo::File)
+  {
+    return std::nullopt;
+  }
+
+  return Disk::mapFile(path) | kdl::and_then([&](auto file) {
+           return readAssimpModelCache(file->reader(), fs);
+         })
+         | kdl::transform([](auto modelInfo) {
+             return std::optional<AssimpModelInfo>{std::move(modelInfo)};
+           })
+         | kdl::value_or(std::optional<AssimpModelInfo>{});
+}
+
+Result<void> AssimpModelCache::store(
+  const std::filesystem::path& modelPath,
+  const std::vector<AssimpModelSource>& sources,
+  const AssimpModelInfo& modelInfo) const
+{
+  const auto path = entryPath(modelPath);
+
+  return writeCacheEntry(
+           path,
+           [&](auto& stream) { writeAssimpModelCache(stream, sources, modelInfo); })
+         | kdl::transform_error([&](auto e) {
+             return Error{fmt::format("Could not cache {}: {}", modelPath, e.msg)};
+           });
+}
+
+std::filesystem::path AssimpModelCache::entryPath(
+  const std::filesystem::path& modelPath) const
+{
+  const auto pathStr = modelPath.generic_string();
+  const auto hash = fnv1a(pathStr.data(), pathStr.data() + pathStr.size());
+  return m_directory / fmt::format("{:016x}.tbam", hash);
+}
+
+} // namespace tb::io
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "mdl/EntityModel_Forward.h"
+#include "render/IndexRangeMap.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace tb::io
+{
+class FileSystem;
+class Reader;
+
+/**
+ * Identifies the contents of a file that Assimp read when it imported a model. A model
+ * can consist of several files, e.g. an OBJ file and its material library, or a glTF
+ * file and its binary buffers.
+ */
+struct AssimpModelSource
+{
+  std::filesystem::path path;
+  uint64_t size = 0;
+  uint64_t hash = 0;
+};
+
+AssimpModelSource makeAssimpModelSource(
+  const std::filesystem::path& path, const char* begin, const char* end);
+
+/**
+ * A skin texture that is loaded from the file system.
+ */
+struct AssimpTextureFile
+{
+  std::filesystem::path path;
+};
+
+/**
+ * A skin texture that is embedded in the model. If the height is 0, the data contains a
+ * compressed image file of the given width in bytes. Otherwise, it contains the BGRA
+ * pixels of the texture.
+ */
+struct AssimpEmbeddedTexture
+{
+  size_t width = 0;
+  size_t height = 0;
+  std::vector<char> data;
+};
+
+/**
+ * Indicates that a material has no diffuse texture and that the fallback texture is used
+ * as its skin.
+ */
+struct AssimpFallbackTexture
+{
+};
+
+using AssimpTextureSource =
+  std::variant<AssimpTextureFile, AssimpEmbeddedTexture, AssimpFallbackTexture>;
+
+struct AssimpSurfaceInfo
+{
+  std::string name;
+  std::vector<AssimpTextureSource> textures;
+};
+
+struct AssimpMeshInfo
+{
+  size_t surfaceIndex = 0;
+  std::vector<mdl::EntityModelVertex> vertices;
+  render::IndexRangeMap indices;
+};
+
+struct AssimpFrameInfo
+{
+  std::string name;
+  vm::bbox3f bounds;
+  std::vector<AssimpMeshInfo> meshes;
+};
+
+/**
+ * The result of importing and post-processing a model with Assimp, before any textures
+ * are loaded.
+ */
+struct AssimpModelInfo
+{
+  std::vector<AssimpSurfaceInfo> surfaces;
+  std::vector<AssimpFrameInfo> frames;
+};
+
+/**
+ * Stores imported models in a directory on disk so that Assimp doesn't have to import
+ * and post-process them again when they are loaded the next time.
+ *
+ * A cache entry records the size and hash of every file that was read when the model was
+ * imported, and it is rejected if any of these files has changed. Textures are not
+ * stored in the cache unless they are embedded in the model, so changes to texture files
+ * are picked up without invalidating the cache.
+ *
+ * Entries are written to a temporary file first and then moved into place, so it is safe
+ * to load and store entries from multiple threads concurrently.
+ */
+class AssimpModelCache
+{
+private:
+  std::filesystem::path m_directory;
+
+public:
+  explicit AssimpModelCache(std::filesystem::path directory);
+
+  const std::filesystem::path& directory() const;
+
+  /**
+   * Loads the cached model for the model file at the given path. Returns std::nullopt if
+   * there is no cache entry for the model, if the cache entry cannot be read or if any of
+   * the files that the model was imported from has changed in the given file system.
+   */
+  std::optional<AssimpModelInfo> load(
+    const std::filesystem::path& modelPath, const FileSystem& fs) const;
+
+  /**
+   * Stores the given model, which was imported from the given sources, for the model file
+   * at the given path.
+   */
+  Result<void> store(
+    const std::filesystem::path& modelPath,
+    const std::vector<AssimpModelSource>& sources,
+    const AssimpModelInfo& modelInfo) const;
+
+private:
+  std::filesystem::path entryPath(const std::filesystem::path& modelPath) const;
+};
+
+/**
+ * Writes a cache entry for the given model, which was imported from the given sources, to
+ * the given stream.
+ */
+void writeAssimpModelCache(
+  std::ostream& stream,
+  const std::vector<AssimpModelSource>& sources,
+  const AssimpModelInfo& modelInfo);
+
+/**
+ * Reads a model from the given cache entry.
+ *
+ * Returns an error if the entry is malformed, if it was written by a different version
+ * of the cache format, or if any of the sources recorded in the entry has changed in the
+ * given file system.
+ */
+Result<AssimpModelInfo> readAssimpModelCache(Reader reader, const FileSystem& fs);
+
+} // namespace tb::io
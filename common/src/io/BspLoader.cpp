@@ -38,6 +38,7 @@
 
 #include <fmt/format.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -195,6 +196,53 @@ std::vector<int> parseFaceEdges(Reader reader, const size_t faceEdgeCount)
   return result;
 }
 
+/**
+ * The geometry of all models of a BSP file. It is shared by the deferred meshes of the
+ * frames, which only refer to a range of its faces.
+ */
+struct BspGeometry
+{
+  std::vector<MaterialInfo> materialInfos;
+  std::vector<vm::vec3f> vertices;
+  std::vector<EdgeInfo> edgeInfos;
+  std::vector<FaceInfo> faceInfos;
+  std::vector<int> faceEdges;
+
+  /**
+   * The skins of the model's surface, indexed by material index.
+   */
+  std::vector<const mdl::Material*> skins;
+
+  const mdl::Material* skin(const FaceInfo& faceInfo) const
+  {
+    const auto materialIndex = materialInfos[faceInfo.materialInfoIndex].materialIndex;
+    return materialIndex < skins.size() ? skins[materialIndex] : nullptr;
+  }
+
+  const vm::vec3f& vertex(const FaceInfo& faceInfo, const size_t i) const
+  {
+    const auto faceEdgeIndex = faceEdges[faceInfo.edgeIndex + i];
+    const auto vertexIndex = faceEdgeIndex < 0
+                               ? edgeInfos[size_t(-faceEdgeIndex)].vertexIndex2
+                               : edgeInfos[size_t(faceEdgeIndex)].vertexIndex1;
+    return vertices[vertexIndex];
+  }
+};
+
+struct ModelInfo
+{
+  size_t faceIndex;
+  size_t faceCount;
+};
+
+ModelInfo parseModelInfo(Reader reader)
+{
+  reader.seekForward(BspLayout::ModelFaceIndex);
+  const auto faceIndex = reader.readSize<int32_t>();
+  const auto faceCount = reader.readSize<int32_t>();
+  return {faceIndex, faceCount};
+}
+
 vm::vec2f uvCoords(
   const vm::vec3f& vertex,
   const MaterialInfo& materialInfo,
@@ -212,31 +260,37 @@ vm::vec2f uvCoords(
   return vm::vec2f{0, 0};
 }
 
-void parseFrame(
-  Reader reader,
-  const size_t frameIndex,
-  mdl::EntityModelData& modelData,
-  const std::vector<MaterialInfo>& materialInfos,
-  const std::vector<vm::vec3f>& vertices,
-  const std::vector<EdgeInfo>& edgeInfos,
-  const std::vector<FaceInfo>& faceInfos,
-  const std::vector<int>& faceEdges)
+vm::bbox3f computeBounds(const ModelInfo& modelInfo, const BspGeometry& geometry)
 {
-  using Vertex = mdl::EntityModelVertex;
+  auto bounds = vm::bbox3f::builder{};
+  for (size_t i = 0; i < modelInfo.faceCount; ++i)
+  {
+    const auto& faceInfo = geometry.faceInfos[modelInfo.faceIndex + i];
+    if (geometry.skin(faceInfo))
+    {
+      for (size_t k = 0; k < faceInfo.edgeCount; ++k)
+      {
+        bounds.add(geometry.vertex(faceInfo, k));
+      }
+    }
+  }
+  return bounds.bounds();
+}
 
-  auto& surface = modelData.surface(0);
+std::vector<mdl::EntityModelVertex> buildMesh(
+  const ModelInfo& modelInfo,
+  const BspGeometry& geometry,
+  render::MaterialIndexRangeMap& indices)
+{
+  using Vertex = mdl::EntityModelVertex;
 
-  reader.seekForward(BspLayout::ModelFaceIndex);
-  const auto modelFaceIndex = reader.readSize<int32_t>();
-  const auto modelFaceCount = reader.readSize<int32_t>();
   auto totalVertexCount = size_t(0);
   auto size = render::MaterialIndexRangeMap::Size{};
 
-  for (size_t i = 0; i < modelFaceCount; ++i)
+  for (size_t i = 0; i < modelInfo.faceCount; ++i)
   {
-    const auto& faceInfo = faceInfos[modelFaceIndex + i];
-    const auto& materialInfo = materialInfos[faceInfo.materialInfoIndex];
-    if (const auto* skin = surface.skin(materialInfo.materialIndex))
+    const auto& faceInfo = geometry.faceInfos[modelInfo.faceIndex + i];
+    if (const auto* skin = geometry.skin(faceInfo))
     {
       const auto faceVertexCount = faceInfo.edgeCount;
       size.inc(skin, render::PrimType::Polygon, faceVertexCount);
@@ -244,15 +298,13 @@ void parseFrame(
     }
   }
 
-  auto bounds = vm::bbox3f::builder{};
-
   auto builder =
     render::MaterialIndexRangeMapBuilder<Vertex::Type>{totalVertexCount, size};
-  for (size_t i = 0; i < modelFaceCount; ++i)
+  for (size_t i = 0; i < modelInfo.faceCount; ++i)
   {
-    const auto& faceInfo = faceInfos[modelFaceIndex + i];
-    const auto& materialInfo = materialInfos[faceInfo.materialInfoIndex];
-    if (const auto* skin = surface.skin(materialInfo.materialIndex))
+    const auto& faceInfo = geometry.faceInfos[modelInfo.faceIndex + i];
+    const auto& materialInfo = geometry.materialInfos[faceInfo.materialInfoIndex];
+    if (const auto* skin = geometry.skin(faceInfo))
     {
       const auto faceVertexCount = faceInfo.edgeCount;
 
@@ -261,26 +313,16 @@ void parseFrame(
 
       for (size_t k = 0; k < faceVertexCount; ++k)
       {
-        const auto faceEdgeIndex = faceEdges[faceInfo.edgeIndex + k];
-        const auto vertexIndex = faceEdgeIndex < 0
-                                   ? edgeInfos[size_t(-faceEdgeIndex)].vertexIndex2
-                                   : edgeInfos[size_t(faceEdgeIndex)].vertexIndex1;
-
-        const auto& position = vertices[vertexIndex];
-        const auto uvCoordss = uvCoords(position, materialInfo, skin);
-
-        bounds.add(position);
-
-        faceVertices.emplace_back(position, uvCoordss);
+        const auto& position = geometry.vertex(faceInfo, k);
+        faceVertices.emplace_back(position, uvCoords(position, materialInfo, skin));
       }
 
       builder.addPolygon(skin, faceVertices);
     }
   }
 
-  auto frameName = fmt::format("frame_{}", frameIndex);
-  auto& frame = modelData.addFrame(std::move(frameName), bounds.bounds());
-  surface.addMesh(frame, std::move(builder.vertices()), std::move(builder.indices()));
+  indices = std::move(builder.indices());
+  return std::move(builder.vertices());
 }
 
 } // namespace
@@ -357,30 +399,35 @@ Result<mdl::EntityModelData> BspLoader::load(Logger& logger)
     auto& surface = data.addSurface(m_name, frameCount);
     surface.setSkins(std::move(materials));
 
-    const auto materialInfos = parseMaterialInfos(
+    auto geometry = std::make_shared<BspGeometry>();
+    geometry->materialInfos = parseMaterialInfos(
       reader.subReaderFromBegin(materialInfoOffset), materialInfoCount);
-    const auto vertices =
+    geometry->vertices =
       parseVertices(reader.subReaderFromBegin(vertexOffset), vertexCount);
-    const auto edgeInfos =
+    geometry->edgeInfos =
       parseEdgeInfos(reader.subReaderFromBegin(edgeInfoOffset), edgeInfoCount);
-    const auto faceInfos =
+    geometry->faceInfos =
       parseFaceInfos(reader.subReaderFromBegin(faceInfoOffset), faceInfoCount);
-    const auto faceEdges =
+    geometry->faceEdges =
       parseFaceEdges(reader.subReaderFromBegin(faceEdgesOffset), faceEdgesCount);
+    for (size_t i = 0; i < surface.skinCount(); ++i)
+    {
+      geometry->skins.push_back(surface.skin(i));
+    }
 
-
+    // The meshes of the models are only built once they are rendered, since most
+    // entities only use the first model of a BSP file.
     for (size_t i = 0; i < frameCount; ++i)
     {
-      parseFrame(
-        reader.subReaderFromBegin(
-          modelsOffset + i * BspLayout::ModelSize, BspLayout::ModelSize),
-        i,
-        data,
-        materialInfos,
-        vertices,
-        edgeInfos,
-        faceInfos,
-        faceEdges);
+      const auto modelInfo = parseModelInfo(reader.subReaderFromBegin(
+        modelsOffset + i * BspLayout::ModelSize, BspLayout::ModelSize));
+
+      auto& frame = data.addFrame(
+        fmt::format("frame_{}", i), computeBounds(modelInfo, *geometry));
+      surface.addDeferredMaterialMesh(
+        frame, [modelInfo, geometry](render::MaterialIndexRangeMap& indices) {
+          return buildMesh(modelInfo, *geometry, indices);
+        });
     }
 
     return data;
@@ -0,0 +1,58 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/ParserStatus.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * Records all messages instead of logging them, so that they can be forwarded to another
+ * parser status later. This allows parsing parts of a file in parallel while still
+ * reporting the messages in the order in which they appear in the file.
+ *
+ * The messages are formatted using the prefix of the target parser status.
+ */
+class BufferedParserStatus : public ParserStatus
+{
+private:
+  ParserStatus& m_target;
+  std::vector<std::tuple<LogLevel, std::string>> m_messages;
+
+public:
+  explicit BufferedParserStatus(ParserStatus& target);
+
+  /**
+   * Forwards the recorded messages to the target parser status and clears them. Must not
+   * be called concurrently with any other function that logs to the target.
+   */
+  void flush();
+
+private:
+  void doProgress(double progress) override;
+  void doLog(LogLevel level, const std::string& str) override;
+};
+
+} // namespace tb::io
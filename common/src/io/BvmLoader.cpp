@@ -37,6 +37,7 @@
 
 #include <fmt/format.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -107,7 +108,7 @@ auto makeFrameTriangles(
   const std::vector<vm::vec2f>& uvs)
 {
   auto frameTriangles = std::vector<mdl::EntityModelVertex>{};
-  frameTriangles.reserve(triangles.size());
+  frameTriangles.reserve(3 * triangles.size());
 
   for (size_t i = 0; i < triangles.size(); i++)
   {
@@ -130,6 +131,58 @@ auto makeFrameTriangles(
   return frameTriangles;
 }
 
+/**
+ * The parts of a surface that are shared by all frames.
+ */
+struct BvmSurfaceData
+{
+  std::vector<BvmTriangle> triangles;
+  std::vector<vm::vec2f> uvs;
+};
+
+auto buildFrameMesh(
+  const BvmSurfaceData& surfaceData,
+  const std::vector<vm::vec3f>& positions,
+  render::IndexRangeMap& indices)
+{
+  const auto& triangles = surfaceData.triangles;
+  indices = render::IndexRangeMap{render::PrimType::Triangles, 0, 3 * triangles.size()};
+  return makeFrameTriangles(triangles, positions, surfaceData.uvs);
+}
+
+/**
+ * Adds the per frame meshes of the given surface. Most entities only display the first
+ * frame, so the meshes of the other frames are only decoded when they are needed.
+ */
+void addFrameMeshes(
+  mdl::EntityModelData& model,
+  mdl::EntityModelSurface& surface,
+  std::vector<BvmTriangle> triangles,
+  std::vector<vm::vec2f> uvs,
+  std::vector<std::vector<vm::vec3f>> perFramePos)
+{
+  auto surfaceData = std::make_shared<const BvmSurfaceData>(
+    BvmSurfaceData{std::move(triangles), std::move(uvs)});
+
+  for (size_t fi = 0; fi < perFramePos.size(); ++fi)
+  {
+    auto& frame = model.frames()[fi];
+    if (fi == 0)
+    {
+      auto indices = render::IndexRangeMap{};
+      auto vertices = buildFrameMesh(*surfaceData, perFramePos[fi], indices);
+      surface.addMesh(frame, std::move(vertices), std::move(indices));
+    }
+    else
+    {
+      surface.addDeferredMesh(
+        frame,
+        [surfaceData, positions = std::move(perFramePos[fi])](auto& indices) {
+          return buildFrameMesh(*surfaceData, positions, indices);
+        });
+    }
+  }
+}
 
 } // namespace
 
@@ -450,38 +503,22 @@ tb::Result<tb::mdl::EntityModelData> BvmLoader::loadV2(Reader& reader, Logger& l
   }
 
   // add frames, and each surface per-frame mesh
-  auto frames = std::vector<mdl::EntityModelFrame*>{};
-  frames.reserve(Ftotal);
   for (size_t i = 0; i < Ftotal; ++i)
   {
-    frames.push_back(&model.addFrame(flatFrames[i].name, frameBounds[i].bounds()));
+    model.addFrame(flatFrames[i].name, frameBounds[i].bounds());
   }
 
-  using Vertex = mdl::EntityModelVertex;
-  for (auto& surf : surfaces)
+  for (size_t si = 0; si < surfaces.size(); ++si)
   {
-    render::IndexRangeMap rangeMap{
-      render::PrimType::Triangles, 0, 3 * surf.triangles.size()};
-    for (size_t fi = 0; fi < Ftotal; ++fi)
-    {
-      const auto& pos = surf.perFramePos[fi];
-      std::vector<Vertex> frameVerts;
-      frameVerts.reserve(3 * surf.triangles.size());
-      for (const auto& tri : surf.triangles)
-      {
-        const auto i0 = tri.vertices[0];
-        const auto i1 = tri.vertices[1];
-        const auto i2 = tri.vertices[2];
-        frameVerts.emplace_back(pos[i0], surf.uvs[i0]);
-        frameVerts.emplace_back(pos[i1], surf.uvs[i1]);
-        frameVerts.emplace_back(pos[i2], surf.uvs[i2]);
-      }
-      surf.surface->addMesh(
-        *frames[fi], std::move(frameVerts), render::IndexRangeMap{rangeMap});
-    }
+    auto& surf = surfaces[si];
+    addFrameMeshes(
+      model,
+      model.surface(si),
+      std::move(surf.triangles),
+      std::move(surf.uvs),
+      std::move(surf.perFramePos));
   }
 
-
   return model;
 }
 
@@ -677,38 +714,22 @@ tb::Result<tb::mdl::EntityModelData> BvmLoader::loadCurrent(
   }
 
   // add frames, and each surface per-frame mesh
-  auto frames = std::vector<mdl::EntityModelFrame*>{};
-  frames.reserve(Ftotal);
   for (size_t i = 0; i < Ftotal; ++i)
   {
-    frames.push_back(&model.addFrame(flatFrames[i].name, frameBounds[i].bounds()));
+    model.addFrame(flatFrames[i].name, frameBounds[i].bounds());
   }
 
-  using Vertex = mdl::EntityModelVertex;
-  for (auto& surf : surfaces)
+  for (size_t si = 0; si < surfaces.size(); ++si)
   {
-    render::IndexRangeMap rangeMap{
-      render::PrimType::Triangles, 0, 3 * surf.triangles.size()};
-    for (size_t fi = 0; fi < Ftotal; ++fi)
-    {
-      const auto& pos = surf.perFramePos[fi];
-      std::vector<Vertex> frameVerts;
-      frameVerts.reserve(3 * surf.triangles.size());
-      for (const auto& tri : surf.triangles)
-      {
-        const auto i0 = tri.vertices[0];
-        const auto i1 = tri.vertices[1];
-        const auto i2 = tri.vertices[2];
-        frameVerts.emplace_back(pos[i0], surf.uvs[i0]);
-        frameVerts.emplace_back(pos[i1], surf.uvs[i1]);
-        frameVerts.emplace_back(pos[i2], surf.uvs[i2]);
-      }
-      surf.surface->addMesh(
-        *frames[fi], std::move(frameVerts), render::IndexRangeMap{rangeMap});
-    }
+    auto& surf = surfaces[si];
+    addFrameMeshes(
+      model,
+      model.surface(si),
+      std::move(surf.triangles),
+      std::move(surf.uvs),
+      std::move(surf.perFramePos));
   }
 
-
   return model;
 }
 
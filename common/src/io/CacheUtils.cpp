@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CacheUtils.h"
+
+#include "io/DiskIO.h"
+
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+
+#include <ostream>
+#include <thread>
+
+namespace tb::io
+{
+
+std::uint64_t fnv1a(const char* begin, const char* end, std::uint64_t hash)
+{
+  for (const auto* c = begin; c != end; ++c)
+  {
+    hash ^= std::uint64_t(static_cast<unsigned char>(*c));
+    hash *= FnvPrime;
+  }
+  return hash;
+}
+
+Result<void> writeCacheEntry(
+  const std::filesystem::path& path, const std::function<void(std::ostream&)>& write)
+{
+  const auto threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  const auto tempPath = kdl::path_add_extension(path, fmt::format(".{}.tmp", threadId));
+
+  return Disk::createDirectory(path.parent_path()) | kdl::and_then([&](auto) {
+           return Disk::withOutputStream(
+             tempPath, std::ios::out | std::ios::binary, [&](auto& stream) {
+               write(stream);
+               return stream.good() ? Result<void>{}
+                                    : Result<void>{Error{"Failed to write cache entry"}};
+             });
+         })
+         | kdl::and_then([&]() { return Disk::moveFile(tempPath, path); })
+         | kdl::or_else([&](auto e) -> Result<void> {
+             // the temporary file may not exist, so failing to remove it is not an error
+             auto error = std::error_code{};
+             std::filesystem::remove(tempPath, error);
+             return e;
+           });
+}
+
+} // namespace tb::io
@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+
+namespace tb::io
+{
+
+constexpr auto FnvOffsetBasis = std::uint64_t(0xcbf29ce484222325ull);
+constexpr auto FnvPrime = std::uint64_t(0x100000001b3ull);
+
+/**
+ * Computes the FNV-1a hash of the given bytes, continuing from the given hash.
+ *
+ * FNV-1a is used instead of std::hash for the keys of the disk caches because they are
+ * persisted and must therefore be stable across program runs.
+ */
+std::uint64_t fnv1a(
+  const char* begin, const char* end, std::uint64_t hash = FnvOffsetBasis);
+
+/**
+ * Continues the given hash with the object representation of the given value.
+ */
+template <typename T>
+std::uint64_t fnv1a(const T& value, const std::uint64_t hash)
+{
+  const auto* begin = reinterpret_cast<const char*>(&value);
+  return fnv1a(begin, begin + sizeof(T), hash);
+}
+
+/**
+ * Writes a cache entry to the given path by passing a binary output stream to the given
+ * function. The entry is written to a temporary file first, which is then moved to the
+ * given path, so that readers never see a partially written entry. The temporary file
+ * name is unique to the calling thread, so concurrent stores of the same entry do not
+ * interfere with each other.
+ *
+ * The parent directory of the given path is created if necessary. Returns an error if
+ * the entry could not be written, in which case the temporary file is removed.
+ */
+Result<void> writeCacheEntry(
+  const std::filesystem::path& path, const std::function<void(std::ostream&)>& write);
+
+} // namespace tb::io
@@ -30,6 +30,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <ranges>
 #include <string>
 
@@ -38,6 +39,13 @@ namespace tb::io
 namespace
 {
 
+bool parseConcurrent(const el::EvaluationContext& context, const el::Value& value)
+{
+  return value.contains(context, "concurrent")
+           ? value.at(context, "concurrent").booleanValue(context)
+           : false;
+}
+
 mdl::CompilationExportMap parseExportTask(
   const el::EvaluationContext& context, const el::Value& value)
 {
@@ -47,6 +55,10 @@ mdl::CompilationExportMap parseExportTask(
   return {
     enabled,
     value.at(context, "target").stringValue(context),
+    parseConcurrent(context, value),
+    value.contains(context, "selectionOnly")
+      ? value.at(context, "selectionOnly").booleanValue(context)
+      : false,
   };
 }
 
@@ -60,6 +72,7 @@ mdl::CompilationCopyFiles parseCopyTask(
     enabled,
     value.at(context, "source").stringValue(context),
     value.at(context, "target").stringValue(context),
+    parseConcurrent(context, value),
   };
 }
 
@@ -73,6 +86,7 @@ mdl::CompilationRenameFile parseRenameTask(
     enabled,
     value.at(context, "source").stringValue(context),
     value.at(context, "target").stringValue(context),
+    parseConcurrent(context, value),
   };
 }
 
@@ -85,6 +99,7 @@ mdl::CompilationDeleteFiles parseDeleteTask(
   return {
     enabled,
     value.at(context, "target").stringValue(context),
+    parseConcurrent(context, value),
   };
 }
 
@@ -98,12 +113,17 @@ mdl::CompilationRunTool parseToolTask(
     value.contains(context, "treatNonZeroResultCodeAsError")
       ? value.at(context, "treatNonZeroResultCodeAsError").booleanValue(context)
       : false;
+  const auto cpuBudget = value.contains(context, "cpuBudget")
+                           ? value.at(context, "cpuBudget").integerValue(context)
+                           : 0;
 
   return {
     enabled,
     value.at(context, "tool").stringValue(context),
     value.at(context, "parameters").stringValue(context),
     treatNonZeroResultCodeAsError,
+    parseConcurrent(context, value),
+    size_t(std::max(cpuBudget, el::IntegerType(0))),
   };
 }
 
@@ -81,6 +81,14 @@ el::Value CompilationConfigWriter::writeTasks(
           }
           map["type"] = el::Value{"export"};
           map["target"] = el::Value{exportMap.targetSpec};
+          if (exportMap.concurrent)
+          {
+            map["concurrent"] = el::Value{true};
+          }
+          if (exportMap.selectionOnly)
+          {
+            map["selectionOnly"] = el::Value{true};
+          }
           return el::Value{std::move(map)};
         },
         [](const mdl::CompilationCopyFiles& copyFiles) {
@@ -92,6 +100,10 @@ el::Value CompilationConfigWriter::writeTasks(
           map["type"] = el::Value{"copy"};
           map["source"] = el::Value{copyFiles.sourceSpec};
           map["target"] = el::Value{copyFiles.targetSpec};
+          if (copyFiles.concurrent)
+          {
+            map["concurrent"] = el::Value{true};
+          }
           return el::Value{std::move(map)};
         },
         [](const mdl::CompilationRenameFile& renameFile) {
@@ -103,6 +115,10 @@ el::Value CompilationConfigWriter::writeTasks(
           map["type"] = el::Value{"rename"};
           map["source"] = el::Value{renameFile.sourceSpec};
           map["target"] = el::Value{renameFile.targetSpec};
+          if (renameFile.concurrent)
+          {
+            map["concurrent"] = el::Value{true};
+          }
           return el::Value{std::move(map)};
         },
         [](const mdl::CompilationDeleteFiles& deleteFiles) {
@@ -113,6 +129,10 @@ el::Value CompilationConfigWriter::writeTasks(
           }
           map["type"] = el::Value{"delete"};
           map["target"] = el::Value{deleteFiles.targetSpec};
+          if (deleteFiles.concurrent)
+          {
+            map["concurrent"] = el::Value{true};
+          }
           return el::Value{std::move(map)};
         },
         [](const mdl::CompilationRunTool& runTool) {
@@ -128,6 +148,14 @@ el::Value CompilationConfigWriter::writeTasks(
           map["type"] = el::Value{"tool"};
           map["tool"] = el::Value{runTool.toolSpec};
           map["parameters"] = el::Value{runTool.parameterSpec};
+          if (runTool.concurrent)
+          {
+            map["concurrent"] = el::Value{true};
+          }
+          if (runTool.cpuBudget > 0)
+          {
+            map["cpuBudget"] = el::Value{runTool.cpuBudget};
+          }
           return el::Value{std::move(map)};
         }),
       task);
@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompressedMapFile.h"
+
+#include <miniz/miniz.h>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto Magic = std::array<char, 4>{'T', 'B', 'M', 'Z'};
+constexpr auto HeaderSize = Magic.size() + sizeof(std::uint64_t);
+
+} // namespace
+
+bool isCompressedMapFile(const std::string_view contents)
+{
+  return contents.size() >= Magic.size()
+         && std::memcmp(contents.data(), Magic.data(), Magic.size()) == 0;
+}
+
+Result<std::string> compressMapFile(const std::string_view contents)
+{
+  const auto uncompressedSize = std::uint64_t(contents.size());
+
+  auto compressedSize = mz_compressBound(mz_ulong(contents.size()));
+  auto result = std::string(HeaderSize + compressedSize, '\0');
+  std::memcpy(result.data(), Magic.data(), Magic.size());
+  std::memcpy(result.data() + Magic.size(), &uncompressedSize, sizeof(uncompressedSize));
+
+  const auto status = mz_compress2(
+    reinterpret_cast<unsigned char*>(result.data() + HeaderSize),
+    &compressedSize,
+    reinterpret_cast<const unsigned char*>(contents.data()),
+    mz_ulong(contents.size()),
+    MZ_DEFAULT_COMPRESSION);
+  if (status != MZ_OK)
+  {
+    return Error{fmt::format("Failed to compress map file: {}", mz_error(status))};
+  }
+
+  result.resize(HeaderSize + compressedSize);
+  return result;
+}
+
+Result<std::string> decompressMapFile(const std::string_view contents)
+{
+  if (!isCompressedMapFile(contents) || contents.size() < HeaderSize)
+  {
+    return Error{"Failed to decompress map file: Invalid header"};
+  }
+
+  auto uncompressedSize = std::uint64_t(0);
+  std::memcpy(
+    &uncompressedSize, contents.data() + Magic.size(), sizeof(uncompressedSize));
+
+  auto result = std::string(uncompressedSize, '\0');
+  auto resultSize = mz_ulong(uncompressedSize);
+
+  const auto status = mz_uncompress(
+    reinterpret_cast<unsigned char*>(result.data()),
+    &resultSize,
+    reinterpret_cast<const unsigned char*>(contents.data() + HeaderSize),
+    mz_ulong(contents.size() - HeaderSize));
+  if (status != MZ_OK || resultSize != uncompressedSize)
+  {
+    return Error{fmt::format(
+      "Failed to decompress map file: {}",
+      status != MZ_OK ? mz_error(status) : "Unexpected size")};
+  }
+
+  return result;
+}
+
+} // namespace tb::io
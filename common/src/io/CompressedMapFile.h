@@ -0,0 +1,57 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <string>
+#include <string_view>
+
+namespace tb::io
+{
+
+/**
+ * A compressed map file stores the contents of a map file compressed with deflate. It
+ * starts with a magic number and the size of the uncompressed contents, followed by the
+ * compressed data.
+ *
+ * Compressed map files are written by the autosaver and can be read wherever a map file
+ * is read.
+ */
+
+/**
+ * Indicates whether the given file contents start with the magic number of a compressed
+ * map file.
+ */
+bool isCompressedMapFile(std::string_view contents);
+
+/**
+ * Compresses the given map file contents.
+ */
+Result<std::string> compressMapFile(std::string_view contents);
+
+/**
+ * Returns the uncompressed contents of the given compressed map file.
+ *
+ * Returns an error if the given contents are not a valid compressed map file.
+ */
+Result<std::string> decompressMapFile(std::string_view contents);
+
+} // namespace tb::io
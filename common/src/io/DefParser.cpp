@@ -233,7 +233,7 @@ std::optional<EntityDefinitionClassInfo> DefParser::parseClassInfo(ParserStatus&
       classInfo.size = parseBounds();
       classInfo.type = EntityDefinitionClassType::PointClass;
     }
-    else if (token.data() == "?")
+    else if (token.view() == "?")
     {
       m_tokenizer.nextToken();
     }
@@ -297,7 +297,7 @@ bool DefParser::parseProperty(ParserStatus& status, EntityDefinitionClassInfo& c
   }
 
   const auto location = token.location();
-  const auto typeName = token.data();
+  const auto typeName = token.view();
   if (typeName == "default")
   {
     // ignore these properties
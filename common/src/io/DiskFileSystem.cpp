@@ -87,6 +87,8 @@ Result<std::vector<std::filesystem::path>> DiskFileSystem::doFind(
 Result<std::shared_ptr<File>> DiskFileSystem::doOpenFile(
   const std::filesystem::path& path) const
 {
+  // the files may be kept open for a long time, e.g. by the file systems of packages, so
+  // they are not mapped
   return makeAbsolute(path) | kdl::and_then(Disk::openFile)
          | kdl::transform(
            [](auto cFile) { return std::static_pointer_cast<File>(cFile); });
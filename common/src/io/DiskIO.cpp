@@ -168,6 +168,17 @@ Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path)
   return createCFile(fixedPath);
 }
 
+Result<std::shared_ptr<MappedFile>> mapFile(const std::filesystem::path& path)
+{
+  const auto fixedPath = fixPath(path);
+  if (pathInfoForFixedPath(fixedPath) != PathInfo::File)
+  {
+    return Error{fmt::format("Failed to map {}: path does not denote a file", path)};
+  }
+
+  return createMappedFile(fixedPath);
+}
+
 Result<bool> createDirectory(const std::filesystem::path& path)
 {
   const auto fixedPath = fixPath(path);
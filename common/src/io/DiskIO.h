@@ -51,6 +51,7 @@ Result<std::vector<std::filesystem::path>> find(
   const PathMatcher& pathMatcher = matchAnyPath);
 
 Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path);
+Result<std::shared_ptr<MappedFile>> mapFile(const std::filesystem::path& path);
 
 template <typename Stream, typename F>
 auto withStream(
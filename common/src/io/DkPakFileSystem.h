@@ -24,9 +24,9 @@
 
 namespace tb::io
 {
-class CFile;
+class File;
 
-class DkPakFileSystem : public ImageFileSystem<CFile>
+class DkPakFileSystem : public ImageFileSystem<File>
 {
 public:
   using ImageFileSystem::ImageFileSystem;
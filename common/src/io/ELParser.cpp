@@ -476,7 +476,7 @@ el::ExpressionNode ELParser::parseLiteral()
   {
     m_tokenizer.nextToken();
     // Escaping happens in el::Value::appendToStream
-    auto value = kdl::str_unescape(token.data(), "\\\"");
+    auto value = kdl::str_unescape(token.view(), "\\\"");
     return el::ExpressionNode{
       el::LiteralExpression{el::Value{std::move(value)}}, token.location()};
   }
@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include <atomic>
+#include <functional>
+#include <string_view>
+
+namespace tb::io
+{
+
+EntityDefinitionFileKey makeEntityDefinitionFileKey(
+  const std::filesystem::path& path, const std::string_view contents)
+{
+  return {path, contents.size(), std::hash<std::string_view>{}(contents)};
+}
+
+std::shared_ptr<const FgdFileContents> EntityDefinitionCache::fgdFileContents(
+  const EntityDefinitionFileKey& key) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  if (const auto it = m_fgdFiles.find(key.path);
+      it != m_fgdFiles.end() && it->second.key == key)
+  {
+    return it->second.contents;
+  }
+  return nullptr;
+}
+
+void EntityDefinitionCache::storeFgdFileContents(
+  EntityDefinitionFileKey key, std::shared_ptr<const FgdFileContents> contents)
+{
+  const auto lock = std::lock_guard{m_mutex};
+  auto path = key.path;
+  m_fgdFiles.insert_or_assign(
+    std::move(path), CachedFgdFile{std::move(key), std::move(contents)});
+}
+
+std::optional<std::vector<mdl::EntityDefinition>> EntityDefinitionCache::definitions(
+  const std::vector<EntityDefinitionFileKey>& keys) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  if (!m_definitions || m_definitions->keys != keys)
+  {
+    return std::nullopt;
+  }
+
+  auto result = m_definitions->definitions;
+  for (auto& definition : result)
+  {
+    // copies share their usage count with the original
+    definition.m_usageCount = std::make_shared<std::atomic<size_t>>(0);
+  }
+  return result;
+}
+
+void EntityDefinitionCache::storeDefinitions(
+  std::vector<EntityDefinitionFileKey> keys,
+  std::vector<mdl::EntityDefinition> definitions)
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_definitions = CachedDefinitions{std::move(keys), std::move(definitions)};
+}
+
+} // namespace tb::io
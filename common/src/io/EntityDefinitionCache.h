@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FileLocation.h"
+#include "io/EntityDefinitionClassInfo.h"
+#include "mdl/EntityDefinition.h"
+
+#include "kdl/path_hash.h"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * Identifies the contents of an entity definition file by its path, size and a hash of
+ * its contents.
+ */
+struct EntityDefinitionFileKey
+{
+  std::filesystem::path path;
+  size_t size = 0;
+  size_t hash = 0;
+
+  bool operator==(const EntityDefinitionFileKey&) const = default;
+};
+
+EntityDefinitionFileKey makeEntityDefinitionFileKey(
+  const std::filesystem::path& path, std::string_view contents);
+
+/**
+ * An include directive in an FGD file.
+ */
+struct FgdInclude
+{
+  std::filesystem::path path;
+  FileLocation location;
+};
+
+/**
+ * The classes and include directives of a single FGD file in the order in which they
+ * appear in the file. The contents of included files are not part of this.
+ */
+using FgdFileContents = std::vector<std::variant<EntityDefinitionClassInfo, FgdInclude>>;
+
+/**
+ * Keeps the parsed contents of entity definition files, so that files which did not
+ * change need not be parsed again when the entity definitions are reloaded. In addition,
+ * the definitions created from the most recently loaded files are kept, so that class
+ * inheritance need not be resolved again if none of the files changed.
+ *
+ * All functions are thread safe.
+ */
+class EntityDefinitionCache
+{
+private:
+  struct CachedFgdFile
+  {
+    EntityDefinitionFileKey key;
+    std::shared_ptr<const FgdFileContents> contents;
+  };
+
+  struct CachedDefinitions
+  {
+    std::vector<EntityDefinitionFileKey> keys;
+    std::vector<mdl::EntityDefinition> definitions;
+  };
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<std::filesystem::path, CachedFgdFile, kdl::path_hash> m_fgdFiles;
+  std::optional<CachedDefinitions> m_definitions;
+
+public:
+  /**
+   * Returns the parsed contents of the FGD file with the given key, or null if the file
+   * was not parsed before or has changed since.
+   */
+  std::shared_ptr<const FgdFileContents> fgdFileContents(
+    const EntityDefinitionFileKey& key) const;
+
+  void storeFgdFileContents(
+    EntityDefinitionFileKey key, std::shared_ptr<const FgdFileContents> contents);
+
+  /**
+   * Returns the definitions that were created from the files with the given keys if
+   * these are the files that were loaded most recently. The returned definitions are
+   * unused.
+   */
+  std::optional<std::vector<mdl::EntityDefinition>> definitions(
+    const std::vector<EntityDefinitionFileKey>& keys) const;
+
+  void storeDefinitions(
+    std::vector<EntityDefinitionFileKey> keys,
+    std::vector<mdl::EntityDefinition> definitions);
+};
+
+} // namespace tb::io
@@ -24,6 +24,11 @@
 #include <filesystem>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+} // namespace kdl
+
 namespace tb::mdl
 {
 struct EntityDefinition;
@@ -39,6 +44,8 @@ public:
   virtual ~EntityDefinitionLoader();
 
   virtual Result<std::vector<mdl::EntityDefinition>> loadEntityDefinitions(
-    ParserStatus& status, const std::filesystem::path& path) const = 0;
+    ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager) const = 0;
 };
 } // namespace tb::io
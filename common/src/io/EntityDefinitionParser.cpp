@@ -471,12 +471,19 @@ std::vector<EntityDefinitionClassInfo> resolveInheritance(
   ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos)
 {
   const auto filteredClassInfos = filterRedundantClasses(status, classInfos);
+
+  auto classInfosByName =
+    std::unordered_map<std::string, std::vector<const EntityDefinitionClassInfo*>>{};
+  for (const auto& classInfo : filteredClassInfos)
+  {
+    classInfosByName[classInfo.name].push_back(&classInfo);
+  }
+
   const auto findClassInfos =
     [&](const auto& name) -> std::vector<const EntityDefinitionClassInfo*> {
-    return filteredClassInfos
-           | std::views::filter([&](const auto& c) { return c.name == name; })
-           | std::views::transform([](const auto& c) { return &c; })
-           | kdl::ranges::to<std::vector>();
+    const auto it = classInfosByName.find(name);
+    return it != classInfosByName.end() ? it->second
+                                        : std::vector<const EntityDefinitionClassInfo*>{};
   };
 
   return filteredClassInfos | std::views::filter([](const auto& c) {
@@ -499,8 +506,7 @@ Result<std::vector<mdl::EntityDefinition>> EntityDefinitionParser::parseDefiniti
 {
   try
   {
-    const auto classInfos = parseClassInfos(status);
-    return createDefinitions(status, classInfos, m_defaultEntityColor);
+    return doParseDefinitions(status);
   }
   catch (const Exception& e)
   {
@@ -508,4 +514,16 @@ Result<std::vector<mdl::EntityDefinition>> EntityDefinitionParser::parseDefiniti
   }
 }
 
+std::vector<mdl::EntityDefinition> EntityDefinitionParser::resolveDefinitions(
+  ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const
+{
+  return createDefinitions(status, classInfos, m_defaultEntityColor);
+}
+
+std::vector<mdl::EntityDefinition> EntityDefinitionParser::doParseDefinitions(
+  ParserStatus& status)
+{
+  return resolveDefinitions(status, parseClassInfos(status));
+}
+
 } // namespace tb::io
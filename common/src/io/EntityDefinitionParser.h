@@ -50,7 +50,16 @@ public:
 
   Result<std::vector<mdl::EntityDefinition>> parseDefinitions(ParserStatus& status);
 
+protected:
+  /**
+   * Resolves the inheritance of the given classes and creates a definition for every
+   * class that is not a base class.
+   */
+  std::vector<mdl::EntityDefinition> resolveDefinitions(
+    ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const;
+
 private:
+  virtual std::vector<mdl::EntityDefinition> doParseDefinitions(ParserStatus& status);
   virtual std::vector<EntityDefinitionClassInfo> parseClassInfos(
     ParserStatus& status) = 0;
 };
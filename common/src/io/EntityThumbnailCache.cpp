@@ -0,0 +1,268 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "EntityThumbnailCache.h"
+
+#include "io/CacheUtils.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/PathInfo.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "mdl/EntityModel.h"
+
+#include "kdl/hash_utils.h"
+#include "kdl/reflection_impl.h"
+#include "kdl/result.h"
+
+#include "vm/vec_io.h" // IWYU pragma: keep
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <functional>
+#include <ostream>
+#include <string_view>
+
+namespace tb::io
+{
+namespace
+{
+namespace EntityThumbnailCacheLayout
+{
+constexpr auto Magic = std::string_view{"TBET"};
+
+/**
+ * Must be incremented whenever the layout of the cache or the way that thumbnails are
+ * rendered changes.
+ */
+constexpr uint32_t Version = 1;
+} // namespace EntityThumbnailCacheLayout
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& stream, const std::string& str)
+{
+  write(stream, uint32_t(str.size()));
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+void writeVec(std::ostream& stream, const vm::vec3f& vec)
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    write(stream, vec[i]);
+  }
+}
+
+void writeKey(std::ostream& stream, const EntityThumbnailCacheKey& key)
+{
+  writeString(stream, key.modelSpecification.path.generic_string());
+  write(stream, uint32_t(key.modelSpecification.skinIndex));
+  write(stream, uint32_t(key.modelSpecification.frameIndex));
+  writeVec(stream, key.modelScale);
+  write(stream, key.size);
+  write(stream, key.hash);
+}
+
+bool readKey(Reader& reader, const EntityThumbnailCacheKey& key)
+{
+  const auto pathLength = reader.readSize<uint32_t>();
+  return reader.readString(pathLength) == key.modelSpecification.path.generic_string()
+         && reader.readSize<uint32_t>() == key.modelSpecification.skinIndex
+         && reader.readSize<uint32_t>() == key.modelSpecification.frameIndex
+         && reader.readVec<float, 3>() == key.modelScale
+         && reader.read<uint64_t, uint64_t>() == key.size
+         && reader.read<uint64_t, uint64_t>() == key.hash;
+}
+
+mdl::Orientation readOrientation(Reader& reader)
+{
+  const auto orientation = reader.readUnsignedChar<uint8_t>();
+  if (orientation > uint8_t(mdl::Orientation::ViewPlaneParallelOriented))
+  {
+    throw ReaderException{fmt::format("Invalid orientation {}", orientation)};
+  }
+  return mdl::Orientation(orientation);
+}
+
+} // namespace
+
+kdl_reflect_impl(EntityThumbnailCacheKey);
+
+EntityThumbnailCacheKey makeEntityThumbnailCacheKey(
+  mdl::ModelSpecification modelSpecification,
+  const vm::vec3f& modelScale,
+  const char* begin,
+  const char* end)
+{
+  return {
+    std::move(modelSpecification), modelScale, uint64_t(end - begin), fnv1a(begin, end)};
+}
+
+void writeEntityThumbnailCache(
+  std::ostream& stream,
+  const EntityThumbnailCacheKey& key,
+  const EntityThumbnail& thumbnail)
+{
+  assert(thumbnail.pixels.size() == thumbnail.width * thumbnail.height * 4);
+
+  const auto& magic = EntityThumbnailCacheLayout::Magic;
+  stream.write(magic.data(), std::streamsize(magic.size()));
+  write(stream, EntityThumbnailCacheLayout::Version);
+  writeKey(stream, key);
+
+  writeVec(stream, thumbnail.bounds.min);
+  writeVec(stream, thumbnail.bounds.max);
+  write(stream, uint8_t(thumbnail.orientation));
+
+  write(stream, uint32_t(thumbnail.width));
+  write(stream, uint32_t(thumbnail.height));
+  stream.write(
+    reinterpret_cast<const char*>(thumbnail.pixels.data()),
+    std::streamsize(thumbnail.pixels.size()));
+
+  // marks the end so that a truncated entry is detected
+  stream.write(magic.data(), std::streamsize(magic.size()));
+}
+
+Result<EntityThumbnail> readEntityThumbnailCache(
+  Reader reader, const EntityThumbnailCacheKey& key)
+{
+  try
+  {
+    const auto& magic = EntityThumbnailCacheLayout::Magic;
+    if (reader.readString(magic.size()) != magic)
+    {
+      return Error{"Not a thumbnail cache"};
+    }
+
+    if (const auto version = reader.readUnsignedInt<uint32_t>();
+        version != EntityThumbnailCacheLayout::Version)
+    {
+      return Error{fmt::format("Unsupported thumbnail cache version {}", version)};
+    }
+
+    if (!readKey(reader, key))
+    {
+      return Error{"Thumbnail cache is out of date"};
+    }
+
+    const auto min = reader.readVec<float, 3>();
+    const auto max = reader.readVec<float, 3>();
+    const auto orientation = readOrientation(reader);
+
+    const auto width = reader.readSize<uint32_t>();
+    const auto height = reader.readSize<uint32_t>();
+    const auto pixelCount = width * height * 4;
+    if (!reader.canRead(pixelCount))
+    {
+      throw ReaderException{fmt::format("Invalid thumbnail size {}x{}", width, height)};
+    }
+
+    auto pixels = std::vector<unsigned char>(pixelCount);
+    reader.read(reinterpret_cast<char*>(pixels.data()), pixelCount);
+
+    if (reader.readString(magic.size()) != magic)
+    {
+      return Error{"Thumbnail cache is truncated"};
+    }
+
+    return EntityThumbnail{
+      vm::bbox3f{min, max}, orientation, width, height, std::move(pixels)};
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{fmt::format("Invalid thumbnail cache: {}", e.what())};
+  }
+}
+
+EntityThumbnailCache::EntityThumbnailCache(std::filesystem::path directory)
+  : m_directory{std::move(directory)}
+{
+}
+
+const std::filesystem::path& EntityThumbnailCache::directory() const
+{
+  return m_directory;
+}
+
+std::optional<EntityThumbnail> EntityThumbnailCache::load(
+  const EntityThumbnailCacheKey& key) const
+{
+  const auto path = entryPath(key);
+  if (Disk::pathInfo(path) != PathInfo::File)
+  {
+    return std::nullopt;
+  }
+
+  return Disk::mapFile(path) | kdl::and_then([&](auto file) {
+           return readEntityThumbnailCache(file->reader(), key);
+         })
+         | kdl::transform([](auto thumbnail) {
+             return std::optional<EntityThumbnail>{std::move(thumbnail)};
+           })
+         | kdl::value_or(std::optional<EntityThumbnail>{});
+}
+
+Result<void> EntityThumbnailCache::store(
+  const EntityThumbnailCacheKey& key, const EntityThumbnail& thumbnail) const
+{
+  const auto path = entryPath(key);
+
+  return writeCacheEntry(
+           path,
+           [&](auto& stream) { writeEntityThumbnailCache(stream, key, thumbnail); })
+         | kdl::transform_error([&](auto e) {
+             return Error{fmt::format(
+               "Could not cache thumbnail for {}: {}",
+               key.modelSpecification.path,
+               e.msg)};
+           });
+}
+
+std::filesystem::path EntityThumbnailCache::entryPath(
+  const EntityThumbnailCacheKey& key) const
+{
+  const auto modelPath = key.modelSpecification.path.generic_string();
+  auto hash = fnv1a(modelPath.data(), modelPath.data() + modelPath.size());
+  hash = fnv1a(uint64_t(key.modelSpecification.skinIndex), hash);
+  hash = fnv1a(uint64_t(key.modelSpecification.frameIndex), hash);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    hash = fnv1a(key.modelScale[i], hash);
+  }
+  hash = fnv1a(key.size, hash);
+  hash = fnv1a(key.hash, hash);
+  return m_directory / fmt::format("{:016x}.tbet", hash);
+}
+
+} // namespace tb::io
+
+std::size_t std::hash<tb::io::EntityThumbnailCacheKey>::operator()(
+  const tb::io::EntityThumbnailCacheKey& key) const noexcept
+{
+  return kdl::combine_hash(
+    std::hash<tb::mdl::ModelSpecification>{}(key.modelSpecification),
+    kdl::hash(
+      key.modelScale.x(), key.modelScale.y(), key.modelScale.z(), key.size, key.hash));
+}
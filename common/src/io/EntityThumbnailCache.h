@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Result.h"
+#include "mdl/ModelSpecification.h"
+
+#include "kdl/reflection_decl.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace tb::mdl
+{
+enum class Orientation;
+}
+
+namespace tb::io
+{
+class Reader;
+
+/**
+ * Identifies a rendered entity thumbnail. A thumbnail depends on the model specification,
+ * the model scale and the contents of the model file. Like the material cache, the model
+ * file is identified by its size and a hash of its contents because virtual file systems
+ * don't provide modification times.
+ */
+struct EntityThumbnailCacheKey
+{
+  mdl::ModelSpecification modelSpecification;
+  vm::vec3f modelScale = vm::vec3f{1, 1, 1};
+  uint64_t size = 0;
+  uint64_t hash = 0;
+
+  kdl_reflect_decl(EntityThumbnailCacheKey, modelSpecification, modelScale, size, hash);
+};
+
+EntityThumbnailCacheKey makeEntityThumbnailCacheKey(
+  mdl::ModelSpecification modelSpecification,
+  const vm::vec3f& modelScale,
+  const char* begin,
+  const char* end);
+
+/**
+ * A rendered image of an entity model together with the model properties that the entity
+ * browser needs to lay out the entity without loading its model.
+ *
+ * The pixels are stored as RGBA bytes, starting with the bottom row.
+ */
+struct EntityThumbnail
+{
+  vm::bbox3f bounds;
+  mdl::Orientation orientation;
+  size_t width = 0;
+  size_t height = 0;
+  std::vector<unsigned char> pixels;
+};
+
+/**
+ * Stores rendered entity thumbnails in a directory on disk so that the entity browser
+ * can display them without loading and rendering the models again.
+ *
+ * Each cache entry is stored in a separate file. Entries are written to a temporary
+ * file first and then moved into place, so it is safe to load and store entries from
+ * multiple threads or processes concurrently.
+ */
+class EntityThumbnailCache
+{
+private:
+  std::filesystem::path m_directory;
+
+public:
+  explicit EntityThumbnailCache(std::filesystem::path directory);
+
+  const std::filesystem::path& directory() const;
+
+  /**
+   * Loads the cached thumbnail for the given key. Returns std::nullopt if there is no
+   * cache entry for the given key or if the cache entry cannot be read.
+   */
+  std::optional<EntityThumbnail> load(const EntityThumbnailCacheKey& key) const;
+
+  /**
+   * Stores the given thumbnail under the given key.
+   */
+  Result<void> store(
+    const EntityThumbnailCacheKey& key, const EntityThumbnail& thumbnail) const;
+
+private:
+  std::filesystem::path entryPath(const EntityThumbnailCacheKey& key) const;
+};
+
+/**
+ * Writes a cache entry for the given thumbnail to the given stream.
+ */
+void writeEntityThumbnailCache(
+  std::ostream& stream,
+  const EntityThumbnailCacheKey& key,
+  const EntityThumbnail& thumbnail);
+
+/**
+ * Reads a thumbnail from the given cache entry.
+ *
+ * Returns an error if the entry is malformed, if it was written by a different version
+ * of the cache format or if it was written for a different key.
+ */
+Result<EntityThumbnail> readEntityThumbnailCache(
+  Reader reader, const EntityThumbnailCacheKey& key);
+
+} // namespace tb::io
+
+template <>
+struct std::hash<tb::io::EntityThumbnailCacheKey>
+{
+  std::size_t operator()(const tb::io::EntityThumbnailCacheKey& key) const noexcept;
+};
@@ -20,7 +20,9 @@
 #include "FgdParser.h"
 
 #include "el/Expression.h"
-#include "io/DiskFileSystem.h"
+#include "io/BufferedParserStatus.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
 #include "io/EntityDefinitionClassInfo.h"
 #include "io/LegacyModelDefinitionParser.h"
 #include "io/ParseModelDefinition.h"
@@ -28,19 +30,22 @@
 #include "io/ParserStatus.h"
 #include "mdl/PropertyDefinition.h"
 
-#include "kdl/invoke.h"
+#include "kdl/overload.h"
 #include "kdl/result.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 #include <fmt/std.h>
 
 #include <algorithm>
+#include <exception>
 #include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace tb::io
@@ -179,18 +184,38 @@ FgdTokenizer::Token FgdTokenizer::emitToken()
   return Token{FgdToken::Eof, nullptr, nullptr, length(), line(), column()};
 }
 
+struct FgdParser::ParsedFile
+{
+  EntityDefinitionFileKey key;
+  std::shared_ptr<const FgdFileContents> contents;
+
+  /**
+   * The messages produced while parsing the file, null if the file was parsed directly
+   * into the caller's parser status or taken from the cache.
+   */
+  std::unique_ptr<BufferedParserStatus> status;
+
+  /**
+   * Set if the file could not be opened.
+   */
+  std::optional<std::string> error;
+
+  /**
+   * Set if the file could not be parsed.
+   */
+  std::exception_ptr exception;
+};
+
 FgdParser::FgdParser(
   const std::string_view str,
   const Color& defaultEntityColor,
   const std::filesystem::path& path)
   : EntityDefinitionParser{defaultEntityColor}
+  , m_str{str}
+  , m_path{!path.empty() && path.is_absolute() ? path.lexically_normal()
+                                                : std::filesystem::path{}}
   , m_tokenizer{FgdTokenizer{str}}
 {
-  if (!path.empty() && path.is_absolute())
-  {
-    m_fs = std::make_unique<DiskFileSystem>(path.parent_path());
-    pushIncludePath(path.filename());
-  }
 }
 
 FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
@@ -198,89 +223,279 @@ FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
 {
 }
 
+FgdParser::FgdParser(
+  const std::string_view str,
+  const Color& defaultEntityColor,
+  const std::filesystem::path& path,
+  kdl::task_manager& taskManager,
+  EntityDefinitionCache& cache)
+  : FgdParser{str, defaultEntityColor, path}
+{
+  m_taskManager = &taskManager;
+  if (!m_path.empty())
+  {
+    m_cache = &cache;
+  }
+}
+
 FgdParser::~FgdParser() = default;
 
-class FgdParser::PushIncludePath
+std::vector<mdl::EntityDefinition> FgdParser::doParseDefinitions(ParserStatus& status)
 {
-private:
-  FgdParser& m_parser;
+  auto fileKeys = std::vector<EntityDefinitionFileKey>{};
+  const auto classInfos = loadClassInfos(status, fileKeys);
 
-public:
-  PushIncludePath(FgdParser& parser, const std::filesystem::path& path)
-    : m_parser{parser}
+  if (m_cache)
   {
-    m_parser.pushIncludePath(path);
+    if (auto definitions = m_cache->definitions(fileKeys))
+    {
+      return std::move(*definitions);
+    }
   }
 
-  ~PushIncludePath() { m_parser.popIncludePath(); }
-};
-
-void FgdParser::pushIncludePath(std::filesystem::path path)
-{
-  assert(!isRecursiveInclude(path));
-  m_paths.push_back(std::move(path));
+  auto definitions = resolveDefinitions(status, classInfos);
+  if (m_cache)
+  {
+    m_cache->storeDefinitions(std::move(fileKeys), definitions);
+  }
+  return definitions;
 }
 
-void FgdParser::popIncludePath()
+std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
 {
-  assert(!m_paths.empty());
-  m_paths.pop_back();
+  auto fileKeys = std::vector<EntityDefinitionFileKey>{};
+  return loadClassInfos(status, fileKeys);
 }
 
-std::filesystem::path FgdParser::currentRoot() const
+std::vector<EntityDefinitionClassInfo> FgdParser::loadClassInfos(
+  ParserStatus& status, std::vector<EntityDefinitionFileKey>& fileKeys)
 {
-  assert(m_paths.empty() || !m_paths.back().empty());
-  return !m_paths.empty() ? m_paths.back().parent_path() : std::filesystem::path{};
+  const auto files = parseFiles(status);
+
+  auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+  auto includeStack = std::vector<std::filesystem::path>{m_path};
+  expandFile(status, files, m_path, includeStack, classInfos, fileKeys);
+  return classInfos;
 }
 
-bool FgdParser::isRecursiveInclude(const std::filesystem::path& path) const
+FgdParser::ParsedFiles FgdParser::parseFiles(ParserStatus& status)
 {
-  return std::any_of(m_paths.begin(), m_paths.end(), [&](const auto& includedPath) {
-    return includedPath == path;
-  });
+  auto files = ParsedFiles{};
+
+  // the host file is parsed on the calling thread so that progress can be reported
+  auto key = makeEntityDefinitionFileKey(m_path, m_str);
+  auto contents = m_cache ? m_cache->fgdFileContents(key) : nullptr;
+  if (!contents)
+  {
+    contents = std::make_shared<const FgdFileContents>(parseFileContents(status));
+    if (m_cache)
+    {
+      m_cache->storeFgdFileContents(key, contents);
+    }
+  }
+  files.emplace(m_path, ParsedFile{std::move(key), std::move(contents), {}, {}, {}});
+
+  if (m_path.empty())
+  {
+    return files;
+  }
+
+  const auto collectIncludedPaths = [&](const auto& path, const auto& file) {
+    auto result = std::vector<std::filesystem::path>{};
+    if (file.contents)
+    {
+      for (const auto& item : *file.contents)
+      {
+        if (const auto* include = std::get_if<FgdInclude>(&item))
+        {
+          auto includedPath = (path.parent_path() / include->path).lexically_normal();
+          if (!files.contains(includedPath))
+          {
+            result.push_back(std::move(includedPath));
+          }
+        }
+      }
+    }
+    return result;
+  };
+
+  // parse the included files level by level, all files of a level concurrently
+  auto paths = collectIncludedPaths(m_path, files.at(m_path));
+  while (!paths.empty())
+  {
+    paths = kdl::vec_sort_and_remove_duplicates(std::move(paths));
+
+    auto parsedFiles = std::vector<ParsedFile>(paths.size());
+    const auto parseFileAt = [&](const size_t i) {
+      parsedFiles[i] = parseFile(status, paths[i]);
+    };
+
+    if (m_taskManager)
+    {
+      m_taskManager->parallel_for(paths.size(), parseFileAt, 1);
+    }
+    else
+    {
+      for (size_t i = 0; i < paths.size(); ++i)
+      {
+        parseFileAt(i);
+      }
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+      files.emplace(paths[i], std::move(parsedFiles[i]));
+    }
+
+    auto nextPaths = std::vector<std::filesystem::path>{};
+    for (const auto& path : paths)
+    {
+      nextPaths = kdl::vec_concat(
+        std::move(nextPaths), collectIncludedPaths(path, files.at(path)));
+    }
+    paths = std::move(nextPaths);
+  }
+
+  return files;
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
+FgdParser::ParsedFile FgdParser::parseFile(
+  ParserStatus& status, const std::filesystem::path& path) const
 {
-  auto classInfos = std::vector<EntityDefinitionClassInfo>{};
-  auto token = m_tokenizer.peekToken();
-  while (!token.hasType(FgdToken::Eof))
+  auto result = ParsedFile{};
+  try
   {
-    parseClassInfoOrInclude(status, classInfos);
-    token = m_tokenizer.peekToken();
+    Disk::openFile(path) | kdl::transform([&](auto file) {
+      auto reader = file->reader().buffer();
+      const auto str = reader.stringView();
+
+      result.key = makeEntityDefinitionFileKey(path, str);
+      result.contents = m_cache ? m_cache->fgdFileContents(result.key) : nullptr;
+      if (!result.contents)
+      {
+        result.status = std::make_unique<BufferedParserStatus>(status);
+
+        auto parser = FgdParser{str, Color{}};
+        auto contents = parser.parseFileContents(*result.status);
+        result.contents = std::make_shared<const FgdFileContents>(std::move(contents));
+        if (m_cache)
+        {
+          m_cache->storeFgdFileContents(result.key, result.contents);
+        }
+      }
+    }) | kdl::transform_error([&](auto e) { result.error = std::move(e.msg); });
   }
-  return classInfos;
+  catch (...)
+  {
+    result.exception = std::current_exception();
+  }
+  return result;
 }
 
-void FgdParser::parseClassInfoOrInclude(
-  ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos)
+void FgdParser::expandFile(
+  ParserStatus& status,
+  const ParsedFiles& files,
+  const std::filesystem::path& path,
+  std::vector<std::filesystem::path>& includeStack,
+  std::vector<EntityDefinitionClassInfo>& classInfos,
+  std::vector<EntityDefinitionFileKey>& fileKeys) const
 {
-  const auto token = m_tokenizer.peekToken(FgdToken::Eof | FgdToken::Word);
-  if (token.hasType(FgdToken::Eof))
+  const auto& file = files.at(path);
+  if (file.status)
   {
-    return;
+    file.status->flush();
+  }
+  if (file.exception)
+  {
+    std::rethrow_exception(file.exception);
   }
 
-  if (kdl::ci::str_is_equal(token.data(), "@include"))
+  fileKeys.push_back(file.key);
+
+  for (const auto& item : *file.contents)
   {
-    auto includedClassInfos = parseInclude(status);
-    classInfos = kdl::vec_concat(classInfos, std::move(includedClassInfos));
+    std::visit(
+      kdl::overload(
+        [&](const EntityDefinitionClassInfo& classInfo) {
+          classInfos.push_back(classInfo);
+        },
+        [&](const FgdInclude& include) {
+          if (m_path.empty())
+          {
+            status.error(
+              include.location,
+              kdl::str_to_string("Cannot include file without host file path"));
+            return;
+          }
+
+          status.debug(
+            include.location,
+            fmt::format("Parsing included file '{}'", include.path));
+
+          const auto includedPath =
+            (path.parent_path() / include.path).lexically_normal();
+          const auto& includedFile = files.at(includedPath);
+          if (includedFile.error)
+          {
+            status.error(
+              include.location,
+              fmt::format("Failed to parse included file: {}", *includedFile.error));
+            return;
+          }
+
+          status.debug(
+            include.location,
+            fmt::format("Resolved '{}' to '{}'", include.path, includedPath));
+
+          if (std::ranges::find(includeStack, includedPath) != includeStack.end())
+          {
+            status.error(
+              include.location,
+              fmt::format(
+                "Skipping recursively included file: {} ({})",
+                include.path,
+                includedPath));
+            return;
+          }
+
+          includeStack.push_back(includedPath);
+          expandFile(status, files, includedPath, includeStack, classInfos, fileKeys);
+          includeStack.pop_back();
+        }),
+      item);
   }
-  else
+}
+
+FgdFileContents FgdParser::parseFileContents(ParserStatus& status)
+{
+  auto contents = FgdFileContents{};
+  auto token = m_tokenizer.peekToken(FgdToken::Eof | FgdToken::Word);
+  while (!token.hasType(FgdToken::Eof))
   {
-    if (auto classInfo = parseClassInfo(status))
+    if (kdl::ci::str_is_equal(token.view(), "@include"))
+    {
+      const auto location = m_tokenizer.nextToken(FgdToken::Word).location();
+      token = m_tokenizer.nextToken(FgdToken::String);
+      contents.emplace_back(FgdInclude{token.data(), location});
+    }
+    else
     {
-      classInfos.push_back(std::move(*classInfo));
+      if (auto classInfo = parseClassInfo(status))
+      {
+        contents.emplace_back(std::move(*classInfo));
+      }
+      status.progress(m_tokenizer.progress());
     }
-    status.progress(m_tokenizer.progress());
+    token = m_tokenizer.peekToken(FgdToken::Eof | FgdToken::Word);
   }
+  return contents;
 }
 
 std::optional<EntityDefinitionClassInfo> FgdParser::parseClassInfo(ParserStatus& status)
 {
   const auto token = m_tokenizer.nextToken(FgdToken::Word);
 
-  const auto classname = token.data();
+  const auto classname = token.view();
   if (kdl::ci::str_is_equal(classname, "@SolidClass"))
   {
     return parseSolidClassInfo(status);
@@ -345,7 +560,7 @@ EntityDefinitionClassInfo FgdParser::parseClassInfo(
 
   while (token.type() == FgdToken::Word)
   {
-    const auto typeName = token.data();
+    const auto typeName = token.view();
     if (kdl::ci::str_is_equal(typeName, "base"))
     {
       if (!classInfo.superClasses.empty())
@@ -780,7 +995,7 @@ mdl::PropertyDefinition FgdParser::parseUnknownPropertyDefinition(
 bool FgdParser::parseReadOnlyFlag(ParserStatus& /* status */)
 {
   auto token = m_tokenizer.peekToken();
-  if (token.hasType(FgdToken::Word) && token.data() == "readonly")
+  if (token.hasType(FgdToken::Word) && token.view() == "readonly")
   {
     m_tokenizer.nextToken();
     return true;
@@ -960,60 +1175,4 @@ std::string FgdParser::parseString()
   }
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseInclude(ParserStatus& status)
-{
-  auto token = m_tokenizer.nextToken(FgdToken::Word);
-  assert(kdl::ci::str_is_equal(token.data(), "@include"));
-
-  token = m_tokenizer.nextToken(FgdToken::String);
-  return handleInclude(status, token.data());
-}
-
-std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
-  ParserStatus& status, const std::filesystem::path& path)
-{
-  if (!m_fs)
-  {
-    status.error(
-      m_tokenizer.location(),
-      kdl::str_to_string("Cannot include file without host file path"));
-    return {};
-  }
-
-  const auto restoreSnapshot =
-    kdl::invoke_later{[&, snapshot = m_tokenizer.snapshotStateAndSource()]() {
-      m_tokenizer.restoreStateAndSource(snapshot);
-    }};
-
-  status.debug(m_tokenizer.location(), fmt::format("Parsing included file '{}'", path));
-
-  const auto filePath = currentRoot() / path;
-  return m_fs->openFile(filePath) | kdl::transform([&](auto file) {
-           status.debug(
-             m_tokenizer.location(),
-             fmt::format("Resolved '{}' to '{}'", path, filePath));
-
-           if (isRecursiveInclude(filePath))
-           {
-             status.error(
-               m_tokenizer.location(),
-               fmt::format(
-                 "Skipping recursively included file: {} ({})", path, filePath));
-             return std::vector<EntityDefinitionClassInfo>{};
-           }
-
-           const auto pushIncludePath = PushIncludePath{*this, filePath};
-           auto reader = file->reader().buffer();
-           m_tokenizer.replaceState(reader.stringView());
-           return parseClassInfos(status);
-         })
-         | kdl::transform_error([&](auto e) {
-             status.error(
-               m_tokenizer.location(),
-               fmt::format("Failed to parse included file: {}", e.msg));
-             return std::vector<EntityDefinitionClassInfo>{};
-           })
-         | kdl::value();
-}
-
 } // namespace tb::io
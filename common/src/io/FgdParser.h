@@ -20,18 +20,28 @@
 #pragma once
 
 #include "Color.h"
+#include "io/EntityDefinitionCache.h"
 #include "io/EntityDefinitionParser.h"
 #include "io/Parser.h"
 #include "io/Tokenizer.h"
 
+#include "kdl/path_hash.h"
+
 #include "vm/bbox.h"
 
 #include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb
 {
 struct FileLocation;
@@ -48,7 +58,6 @@ namespace tb::io
 
 struct EntityDefinitionClassInfo;
 enum class EntityDefinitionClassType;
-class FileSystem;
 class ParserStatus;
 
 namespace FgdToken
@@ -84,8 +93,14 @@ class FgdParser : public EntityDefinitionParser, public Parser<FgdToken::Type>
 private:
   using Token = FgdTokenizer::Token;
 
-  std::vector<std::filesystem::path> m_paths;
-  std::unique_ptr<FileSystem> m_fs;
+  struct ParsedFile;
+  using ParsedFiles =
+    std::unordered_map<std::filesystem::path, ParsedFile, kdl::path_hash>;
+
+  std::string_view m_str;
+  std::filesystem::path m_path;
+  kdl::task_manager* m_taskManager = nullptr;
+  EntityDefinitionCache* m_cache = nullptr;
 
   FgdTokenizer m_tokenizer;
 
@@ -96,21 +111,38 @@ public:
     const std::filesystem::path& path);
   FgdParser(std::string_view str, const Color& defaultEntityColor);
 
+  /**
+   * Creates a parser that parses included files concurrently using the given task
+   * manager. Files that did not change since they were parsed the last time are taken
+   * from the given cache, and so are the definitions if none of the files changed.
+   */
+  FgdParser(
+    std::string_view str,
+    const Color& defaultEntityColor,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager,
+    EntityDefinitionCache& cache);
+
   ~FgdParser() override;
 
 private:
-  class PushIncludePath;
-  void pushIncludePath(std::filesystem::path path);
-  void popIncludePath();
+  std::vector<mdl::EntityDefinition> doParseDefinitions(ParserStatus& status) override;
+  std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
 
-  std::filesystem::path currentRoot() const;
-  bool isRecursiveInclude(const std::filesystem::path& path) const;
+  std::vector<EntityDefinitionClassInfo> loadClassInfos(
+    ParserStatus& status, std::vector<EntityDefinitionFileKey>& fileKeys);
 
-private:
-  std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+  ParsedFiles parseFiles(ParserStatus& status);
+  ParsedFile parseFile(ParserStatus& status, const std::filesystem::path& path) const;
+  void expandFile(
+    ParserStatus& status,
+    const ParsedFiles& files,
+    const std::filesystem::path& path,
+    std::vector<std::filesystem::path>& includeStack,
+    std::vector<EntityDefinitionClassInfo>& classInfos,
+    std::vector<EntityDefinitionFileKey>& fileKeys) const;
 
-  void parseClassInfoOrInclude(
-    ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
+  FgdFileContents parseFileContents(ParserStatus& status);
 
   std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
   EntityDefinitionClassInfo parseSolidClassInfo(ParserStatus& status);
@@ -159,10 +191,6 @@ private:
   vm::bbox3d parseSize();
   Color parseColor();
   std::string parseString();
-
-  std::vector<EntityDefinitionClassInfo> parseInclude(ParserStatus& status);
-  std::vector<EntityDefinitionClassInfo> handleInclude(
-    ParserStatus& status, const std::filesystem::path& path);
 };
 
 } // namespace tb::io
@@ -24,8 +24,23 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <system_error>
+#include <tuple>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace tb::io
 {
@@ -143,27 +158,48 @@ std::unique_ptr<OwningBufferFile> CFile::buffer() const
 
 Result<void> CFile::read(char* val, const size_t position, const size_t size) const
 {
-  auto guard = std::lock_guard{m_mutex};
-
-  const auto currentPosition = std::ftell(m_file.get());
-  if (currentPosition < 0)
-  {
-    return makeError("ftell failed");
-  }
-  if (size_t(currentPosition) != position)
-  {
-    if (std::fseek(*m_file, long(position), SEEK_SET) != 0)
-    {
-      return makeError("fseek failed");
-    }
-  }
   if (position + size > m_size)
   {
     return makeError("read past EOF");
   }
-  if (std::fread(val, 1, size, *m_file) != size)
+
+  // Positioned reads don't use or change the file position, so several threads can read
+  // from the file at the same time.
+  auto bytesRead = size_t(0);
+  while (bytesRead < size)
   {
-    return makeError("fread failed");
+    const auto offset = position + bytesRead;
+#ifdef _WIN32
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(*m_file)));
+    auto overlapped = OVERLAPPED{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+    auto count = DWORD(0);
+    const auto toRead = static_cast<DWORD>(std::min(size - bytesRead, size_t(1) << 30));
+    if (!ReadFile(handle, val + bytesRead, toRead, &count, &overlapped))
+    {
+      const auto errorCode =
+        std::error_code{static_cast<int>(GetLastError()), std::system_category()};
+      return Error{fmt::format("ReadFile failed: {}", errorCode.message())};
+    }
+#else
+    const auto count =
+      ::pread(fileno(*m_file), val + bytesRead, size - bytesRead, off_t(offset));
+    if (count < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return Error{fmt::format("pread failed: {}", std::strerror(errno))};
+    }
+#endif
+    if (count == 0)
+    {
+      return Error{"read failed: unexpected end of file"};
+    }
+    bytesRead += static_cast<size_t>(count);
   }
 
   return kdl::void_success;
@@ -199,6 +235,161 @@ Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path)
          });
 }
 
+MappedFile::MappedFile(std::shared_ptr<const char> data, const size_t size)
+  : m_data{std::move(data)}
+  , m_size{size}
+{
+}
+
+Reader MappedFile::reader() const
+{
+  return Reader::from(m_data, begin(), end());
+}
+
+size_t MappedFile::size() const
+{
+  return m_size;
+}
+
+const char* MappedFile::begin() const
+{
+  return m_data.get();
+}
+
+const char* MappedFile::end() const
+{
+  return m_data.get() + m_size;
+}
+
+namespace
+{
+#ifdef _WIN32
+Error makeMappingError(const std::filesystem::path& path, const std::string& msg)
+{
+  const auto errorCode =
+    std::error_code{static_cast<int>(GetLastError()), std::system_category()};
+  return Error{fmt::format("Failed to map '{}': {}: {}", path, msg, errorCode.message())};
+}
+
+Result<std::tuple<std::shared_ptr<const char>, size_t>> mapPath(
+  const std::filesystem::path& path)
+{
+  auto file = kdl::resource{
+    CreateFileW(
+      path.wstring().c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr),
+    [](HANDLE handle) {
+      if (handle != INVALID_HANDLE_VALUE)
+      {
+        CloseHandle(handle);
+      }
+    }};
+  if (*file == INVALID_HANDLE_VALUE)
+  {
+    return makeMappingError(path, "CreateFileW failed");
+  }
+
+  auto fileSize = LARGE_INTEGER{};
+  if (!GetFileSizeEx(*file, &fileSize))
+  {
+    return makeMappingError(path, "GetFileSizeEx failed");
+  }
+
+  const auto size = static_cast<size_t>(fileSize.QuadPart);
+  if (size == 0)
+  {
+    // empty files cannot be mapped
+    return std::tuple{std::shared_ptr<const char>{}, size_t(0)};
+  }
+
+  auto mapping = kdl::resource{
+    CreateFileMappingW(*file, nullptr, PAGE_READONLY, 0, 0, nullptr),
+    [](HANDLE handle) {
+      if (handle)
+      {
+        CloseHandle(handle);
+      }
+    }};
+  if (!*mapping)
+  {
+    return makeMappingError(path, "CreateFileMappingW failed");
+  }
+
+  const auto* data =
+    static_cast<const char*>(MapViewOfFile(*mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!data)
+  {
+    return makeMappingError(path, "MapViewOfFile failed");
+  }
+
+  // the view remains valid after the file and mapping handles are closed
+  return std::tuple{
+    std::shared_ptr<const char>{data, [](const char* d) { UnmapViewOfFile(d); }},
+    size};
+}
+#else
+Error makeMappingError(const std::filesystem::path& path, const std::string& msg)
+{
+  return Error{fmt::format("Failed to map '{}': {}: {}", path, msg, std::strerror(errno))};
+}
+
+Result<std::tuple<std::shared_ptr<const char>, size_t>> mapPath(
+  const std::filesystem::path& path)
+{
+  auto file = kdl::resource{::open(path.c_str(), O_RDONLY), [](const int fd) {
+                              if (fd >= 0)
+                              {
+                                ::close(fd);
+                              }
+                            }};
+  if (*file < 0)
+  {
+    return makeMappingError(path, "open failed");
+  }
+
+  struct stat fileStat;
+  if (::fstat(*file, &fileStat) != 0)
+  {
+    return makeMappingError(path, "fstat failed");
+  }
+
+  const auto size = static_cast<size_t>(fileStat.st_size);
+  if (size == 0)
+  {
+    // empty files cannot be mapped
+    return std::tuple{std::shared_ptr<const char>{}, size_t(0)};
+  }
+
+  auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, *file, 0);
+  if (data == MAP_FAILED)
+  {
+    return makeMappingError(path, "mmap failed");
+  }
+
+  // the mapping remains valid after the file descriptor is closed
+  return std::tuple{
+    std::shared_ptr<const char>{
+      static_cast<const char*>(data),
+      [size](const char* d) { ::munmap(const_cast<char*>(d), size); }},
+    size};
+}
+#endif
+} // namespace
+
+Result<std::shared_ptr<MappedFile>> createMappedFile(const std::filesystem::path& path)
+{
+  return mapPath(path) | kdl::transform([](auto dataAndSize) {
+           auto [data, size] = std::move(dataAndSize);
+           // NOLINTNEXTLINE
+           return std::shared_ptr<MappedFile>{new MappedFile{std::move(data), size}};
+         });
+}
+
 FileView::FileView(std::shared_ptr<File> file, const size_t offset, const size_t length)
   : m_file{std::move(file)}
   , m_offset{offset}
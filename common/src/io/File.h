@@ -27,7 +27,6 @@
 #include <cstdio>
 #include <filesystem>
 #include <memory>
-#include <mutex>
 
 namespace tb::io
 {
@@ -79,6 +78,9 @@ public:
 /**
  * A file that is backed by a physical file on the disk. The file is opened in the
  * constructor and closed in the destructor.
+ *
+ * Readers read from the file at explicit offsets without changing its file position, so
+ * several threads can read from the file at the same time.
  */
 class CFile : public File
 {
@@ -93,7 +95,6 @@ public:
 private:
   kdl::resource<std::FILE*> m_file;
   size_t m_size;
-  mutable std::mutex m_mutex;
 
   /**
    * Creates a new file with the given file ptr and size in bytes.
@@ -124,6 +125,44 @@ private:
 
 Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path);
 
+/**
+ * A file that is backed by a read-only memory mapping of a physical file on the disk.
+ *
+ * Readers for this file and for views into this file access the mapped memory directly,
+ * so their contents are never copied into a separate buffer. The mapping is released when
+ * the file and all readers created from it have been destroyed.
+ */
+class MappedFile : public File
+{
+private:
+  std::shared_ptr<const char> m_data;
+  size_t m_size;
+
+  /**
+   * Creates a new file with the given mapped memory and size in bytes.
+   */
+  MappedFile(std::shared_ptr<const char> data, size_t size);
+
+public:
+  friend Result<std::shared_ptr<MappedFile>> createMappedFile(
+    const std::filesystem::path& path);
+
+  Reader reader() const override;
+  size_t size() const override;
+
+  /**
+   * Returns the beginning of the mapped memory.
+   */
+  const char* begin() const;
+
+  /**
+   * Returns the end of the mapped memory.
+   */
+  const char* end() const;
+};
+
+Result<std::shared_ptr<MappedFile>> createMappedFile(const std::filesystem::path& path);
+
 /**
  * A file that is backed by a portion of a physical file.
  */
@@ -52,9 +52,10 @@ bool isDirectory(const ImageEntry& entry)
     entry);
 }
 
-auto& addEntry(ImageDirectoryEntry& parent, ImageEntry&& entry)
+auto& addEntry(
+  ImageDirectoryEntry& parent, std::filesystem::path nameLC, ImageEntry&& entry)
 {
-  parent.entryMapLC[kdl::path_to_lower(getName(entry))] = parent.entries.size();
+  parent.entryMapLC[std::move(nameLC)] = parent.entries.size();
   parent.entries.push_back(std::move(entry));
   return parent.entries.back();
 }
@@ -145,38 +146,23 @@ const ImageEntry* findEntry(const std::filesystem::path& path, const ImageEntry&
 }
 
 ImageDirectoryEntry& findOrCreateDirectory(
-  const std::filesystem::path& path, ImageDirectoryEntry& parent)
+  const std::filesystem::path& name, ImageDirectoryEntry& parent)
 {
-  if (path.empty())
-  {
-    return parent;
-  }
-
-  auto name = kdl::path_front(path);
   auto nameLC = kdl::path_to_lower(name);
-  auto entryIt = findEntry(parent, nameLC);
-  if (entryIt != parent.entries.end())
+  const auto entryIt = findEntry(parent, nameLC);
+  if (entryIt == parent.entries.end())
   {
-    return std::visit(
-      kdl::overload(
-        [&](ImageDirectoryEntry& directoryEntry) -> ImageDirectoryEntry& {
-          return findOrCreateDirectory(kdl::path_pop_front(path), directoryEntry);
-        },
-        [&](ImageFileEntry&) -> ImageDirectoryEntry& {
-          *entryIt = ImageDirectoryEntry{std::move(name), {}, {}};
-          return findOrCreateDirectory(
-            kdl::path_pop_front(path), std::get<ImageDirectoryEntry>(*entryIt));
-        }),
-      *entryIt);
+    return std::get<ImageDirectoryEntry>(
+      addEntry(parent, std::move(nameLC), ImageDirectoryEntry{name, {}, {}}));
   }
-  else
+
+  if (!isDirectory(*entryIt))
   {
-    return findOrCreateDirectory(
-      kdl::path_pop_front(path),
-      std::get<ImageDirectoryEntry>(
-        addEntry(parent, ImageDirectoryEntry{std::move(name), {}, {}})));
+    *entryIt = ImageDirectoryEntry{name, {}, {}};
   }
+  return std::get<ImageDirectoryEntry>(*entryIt);
 }
+
 } // namespace
 
 ImageFileSystemBase::ImageFileSystemBase()
@@ -206,19 +192,27 @@ void ImageFileSystemBase::setMetadata(
 
 void ImageFileSystemBase::addFile(const std::filesystem::path& path, GetImageFile getFile)
 {
-  auto& directoryEntry =
-    findOrCreateDirectory(path.parent_path(), std::get<ImageDirectoryEntry>(m_root));
+  // walk the path's components directly instead of splitting it up recursively, which
+  // dominates the time it takes to read the directory of a large archive
+  auto* directoryEntry = &std::get<ImageDirectoryEntry>(m_root);
+  for (const auto& directoryName : path.parent_path())
+  {
+    directoryEntry = &findOrCreateDirectory(directoryName, *directoryEntry);
+  }
 
   auto name = path.filename();
   auto nameLC = kdl::path_to_lower(name);
-  if (const auto entryIt = findEntry(directoryEntry, nameLC);
-      entryIt != directoryEntry.entries.end())
+  if (const auto entryIt = findEntry(*directoryEntry, nameLC);
+      entryIt != directoryEntry->entries.end())
   {
     *entryIt = ImageFileEntry{std::move(name), std::move(getFile)};
   }
   else
   {
-    addEntry(directoryEntry, ImageFileEntry{std::move(name), std::move(getFile)});
+    addEntry(
+      *directoryEntry,
+      std::move(nameLC),
+      ImageFileEntry{std::move(name), std::move(getFile)});
   }
 }
 
@@ -59,6 +59,7 @@ Result<mdl::EntityModelData> loadEntityModelData(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache,
   Logger& logger)
 {
   const auto modelName = path.filename().string();
@@ -126,7 +127,7 @@ Result<mdl::EntityModelData> loadEntityModelData(
              }
              if (io::AssimpLoader::canParse(path))
              {
-               auto loader = io::AssimpLoader{path, fs};
+               auto loader = io::AssimpLoader{path, fs, assimpModelCache};
                return loader.load(logger);
              }
              return Error{fmt::format("Unknown model format: {}", path)};
@@ -142,10 +143,12 @@ mdl::ResourceLoader<mdl::EntityModelData> makeEntityModelDataResourceLoader(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache,
   Logger& logger)
 {
-  return [&fs, materialConfig, path, loadMaterial, &logger]() {
-    return loadEntityModelData(fs, materialConfig, path, loadMaterial, logger);
+  return [&fs, materialConfig, path, loadMaterial, assimpModelCache, &logger]() {
+    return loadEntityModelData(
+      fs, materialConfig, path, loadMaterial, assimpModelCache, logger);
   };
 }
 
@@ -156,9 +159,11 @@ Result<mdl::EntityModel> loadEntityModelSync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
-  Logger& logger)
+  Logger& logger,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache)
 {
-  return loadEntityModelData(fs, materialConfig, path, loadMaterial, logger)
+  return loadEntityModelData(
+           fs, materialConfig, path, loadMaterial, assimpModelCache, logger)
          | kdl::transform([&](auto modelData) {
              auto modelName = path.filename().string();
              auto modelResource =
@@ -173,11 +178,12 @@ mdl::EntityModel loadEntityModelAsync(
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
   const mdl::CreateEntityModelDataResource& createResource,
-  Logger& logger)
+  Logger& logger,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache)
 {
   auto name = path.filename().string();
-  auto loader =
-    makeEntityModelDataResourceLoader(fs, materialConfig, path, loadMaterial, logger);
+  auto loader = makeEntityModelDataResourceLoader(
+    fs, materialConfig, path, loadMaterial, assimpModelCache, logger);
   auto resource = createResource(std::move(loader));
   return mdl::EntityModel{std::move(name), std::move(resource)};
 }
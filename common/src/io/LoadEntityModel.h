@@ -24,6 +24,7 @@
 
 #include <filesystem>
 #include <functional>
+#include <memory>
 
 namespace tb
 {
@@ -39,6 +40,7 @@ struct MaterialConfig;
 
 namespace tb::io
 {
+class AssimpModelCache;
 class FileSystem;
 
 using LoadMaterialFunc = std::function<mdl::Material(const std::filesystem::path&)>;
@@ -48,7 +50,8 @@ Result<mdl::EntityModel> loadEntityModelSync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
-  Logger& logger);
+  Logger& logger,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache = nullptr);
 
 mdl::EntityModel loadEntityModelAsync(
   const FileSystem& fs,
@@ -56,6 +59,7 @@ mdl::EntityModel loadEntityModelAsync(
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
   const mdl::CreateEntityModelDataResource& createResource,
-  Logger& logger);
+  Logger& logger,
+  const std::shared_ptr<const AssimpModelCache>& assimpModelCache = nullptr);
 
 } // namespace tb::io
@@ -22,9 +22,11 @@
 #include "Logger.h"
 #include "io/FileSystem.h"
 #include "io/LoadShaders.h"
+#include "io/MaterialCache.h"
 #include "io/MaterialUtils.h"
 #include "io/PathInfo.h"
 #include "io/PathMatcher.h"
+#include "io/Reader.h"
 #include "io/ReadDdsTexture.h"
 #include "io/ReadFreeImageTexture.h"
 #include "io/ReadM8Texture.h"
@@ -34,6 +36,7 @@
 #include "io/TraversalMode.h"
 //Tony; blackened texture format
 #include "io/ReadBtfTexture.h"
+#include "mdl/CompressTexture.h"
 #include "mdl/GameConfig.h"
 #include "mdl/MaterialCollection.h"
 #include "mdl/Palette.h"
@@ -50,19 +53,22 @@
 #include "kdl/result_fold.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <functional>
+#include <mutex>
+#include <ranges>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace tb::io
 {
 
-namespace
-{
-
 std::optional<Result<mdl::Palette>> loadPalette(
   const FileSystem& fs, const mdl::MaterialConfig& materialConfig)
 {
@@ -76,6 +82,44 @@ std::optional<Result<mdl::Palette>> loadPalette(
          });
 }
 
+namespace
+{
+
+/**
+ * Reads a texture using the given function unless the given material cache contains an
+ * entry for the contents of the given reader. Newly read textures are added to the cache
+ * and compressed first if the cache is configured to do so.
+ */
+template <typename F>
+Result<mdl::Texture> readCachedTexture(
+  const MaterialCache* materialCache,
+  const std::filesystem::path& path,
+  BufferedReader& reader,
+  const F& readTexture)
+{
+  if (!materialCache)
+  {
+    return readTexture(reader);
+  }
+
+  const auto key = makeMaterialCacheKey(path, reader.begin(), reader.end());
+  if (auto texture = materialCache->load(key))
+  {
+    return std::move(*texture);
+  }
+
+  return readTexture(reader) | kdl::transform([&](auto texture) {
+           if (materialCache->compressTextures())
+           {
+             texture = mdl::compressTexture(std::move(texture));
+           }
+
+           // a failure to cache the texture is not an error
+           materialCache->store(key, texture) | kdl::transform_error([](auto) {});
+           return texture;
+         });
+}
+
 bool shouldExclude(
   const std::string& materialName, const std::vector<std::string>& patterns)
 {
@@ -190,16 +234,22 @@ Result<mdl::Material> loadShaderMaterial(
   const mdl::Quake3Shader& shader,
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
-  const mdl::CreateTextureResource& createResource)
+  const mdl::CreateTextureResource& createResource,
+  const std::shared_ptr<const MaterialCache>& materialCache)
 {
   return findShaderTexture(shader, fs, materialConfig) | kdl::transform([&](auto path_) {
-           return [&, path = std::move(path_)]() {
+           return [&, path = std::move(path_), materialCache]() {
              return fs.openFile(path) | kdl::and_then([&](auto file) {
                       auto reader = file->reader().buffer();
-                      return readFreeImageTexture(reader).transform([](auto texture) {
-                        texture.setMask(mdl::TextureMask::Off);
-                        return texture;
-                      });
+                      return readCachedTexture(
+                               materialCache.get(),
+                               path,
+                               reader,
+                               [](auto& r) { return readFreeImageTexture(r); })
+                             | kdl::transform([](auto texture) {
+                                 texture.setMask(mdl::TextureMask::Off);
+                                 return texture;
+                               });
                     });
            };
          })
@@ -252,7 +302,8 @@ Result<mdl::Texture> loadTexture(
   const std::string& name,
   const std::vector<std::filesystem::path>& extensions,
   const FileSystem& fs,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const MaterialCache* materialCache)
 {
   return findMaterialFile(fs, path, extensions)
     .and_then([&](const auto& actualPath) -> Result<mdl::Texture> {
@@ -301,7 +352,9 @@ Result<mdl::Texture> loadTexture(
       {
         return fs.openFile(actualPath) | kdl::and_then([&](auto file) {
                  auto reader = file->reader().buffer();
-                 return readM8Texture(reader);
+                 return readCachedTexture(materialCache, actualPath, reader, [](auto& r) {
+                   return readM8Texture(r);
+                 });
                });
       }
       else if (extension == ".dds")
@@ -316,14 +369,18 @@ Result<mdl::Texture> loadTexture(
       {
         return fs.openFile(actualPath) | kdl::and_then([&](auto file) {
                  auto reader = file->reader().buffer();
-                 return readBtfTexture(reader);
+                 return readCachedTexture(materialCache, actualPath, reader, [](auto& r) {
+                   return readBtfTexture(r);
+                 });
                });
       }
       else if (isSupportedFreeImageExtension(extension))
       {
         return fs.openFile(actualPath) | kdl::and_then([&](auto file) {
                  auto reader = file->reader().buffer();
-                 return readFreeImageTexture(reader);
+                 return readCachedTexture(materialCache, actualPath, reader, [](auto& r) {
+                   return readFreeImageTexture(r);
+                 });
                });
       }
 
@@ -336,10 +393,11 @@ mdl::ResourceLoader<mdl::Texture> makeTextureResourceLoader(
   const std::string& name,
   const std::vector<std::filesystem::path>& extensions,
   const FileSystem& fs,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::shared_ptr<const MaterialCache>& materialCache)
 {
-  return [&, path, name, paletteResult]() -> Result<mdl::Texture> {
-    return loadTexture(path, name, extensions, fs, paletteResult)
+  return [&, path, name, paletteResult, materialCache]() -> Result<mdl::Texture> {
+    return loadTexture(path, name, extensions, fs, paletteResult, materialCache.get())
            | kdl::or_else([&](auto e) -> Result<mdl::Texture> {
                return Error{fmt::format("Could not load texture '{}': {}", path, e.msg)};
              });
@@ -351,7 +409,8 @@ Result<mdl::Material> loadTextureMaterial(
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const mdl::CreateTextureResource& createResource,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::shared_ptr<const MaterialCache>& materialCache)
 {
   const auto prefixLength = kdl::path_length(materialConfig.root);
   const auto pathMatcher = !materialConfig.extensions.empty()
@@ -360,7 +419,7 @@ Result<mdl::Material> loadTextureMaterial(
   auto name = getMaterialNameFromPathSuffix(texturePath, prefixLength);
 
   auto textureLoader = makeTextureResourceLoader(
-    texturePath, name, materialConfig.extensions, fs, paletteResult);
+    texturePath, name, materialConfig.extensions, fs, paletteResult, materialCache);
   auto textureResource = createResource(std::move(textureLoader));
   return mdl::Material{std::move(name), std::move(textureResource)};
 }
@@ -429,6 +488,81 @@ std::vector<mdl::MaterialCollection> groupMaterialsIntoCollections(
   });
 }
 
+Result<mdl::Material> loadMaterial(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const std::filesystem::path& materialPath,
+  const mdl::CreateTextureResource& createResource,
+  const mdl::Quake3Shader* shader,
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::shared_ptr<const MaterialCache>& materialCache)
+{
+  return (shader ? loadShaderMaterial(
+                     *shader, fs, materialConfig, createResource, materialCache)
+                 : loadTextureMaterial(
+                     materialPath,
+                     fs,
+                     materialConfig,
+                     createResource,
+                     paletteResult,
+                     materialCache))
+         | kdl::transform([&](auto material) {
+             fs.makeAbsolute(materialPath)
+               | kdl::transform([&](auto absPath) { material.setAbsolutePath(absPath); })
+               | kdl::or_else([](auto) { return kdl::void_success; });
+             material.setRelativePath(materialPath);
+             material.setCollectionName(
+               materialCollectionName(fs, materialConfig, materialPath));
+             return material;
+           });
+}
+
+Result<std::vector<mdl::Material>> loadMaterials(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const std::vector<std::filesystem::path>& materialPaths,
+  const mdl::CreateTextureResource& createResource,
+  const std::vector<mdl::Quake3Shader>& shaders,
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  kdl::task_manager& taskManager,
+  const std::shared_ptr<const MaterialCache>& materialCache)
+{
+  auto shadersByPath = std::unordered_map<
+    std::filesystem::path,
+    const mdl::Quake3Shader*,
+    kdl::path_hash>{};
+  for (const auto& shader : shaders)
+  {
+    shadersByPath.emplace(shader.shaderPath, &shader);
+  }
+
+  // Finding the files of the materials is what takes time here, so the materials are
+  // loaded concurrently. Only the creation of the texture resources is serialized since
+  // the given function may register them with the caller.
+  auto createResourceMutex = std::mutex{};
+  const auto synchronizedCreateResource =
+    mdl::CreateTextureResource{[&](auto resourceLoader) {
+      const auto lock = std::lock_guard{createResourceMutex};
+      return createResource(std::move(resourceLoader));
+    }};
+
+  auto tasks = materialPaths | std::views::transform([&](const auto& materialPath) {
+                 return std::function{[&]() {
+                   const auto iShader =
+                     shadersByPath.find(kdl::path_remove_extension(materialPath));
+                   return loadMaterial(
+                     fs,
+                     materialConfig,
+                     materialPath,
+                     synchronizedCreateResource,
+                     iShader != shadersByPath.end() ? iShader->second : nullptr,
+                     paletteResult,
+                     materialCache);
+                 }};
+               });
+  return taskManager.run_tasks_and_wait(tasks) | kdl::fold;
+}
+
 } // namespace
 
 
@@ -438,7 +572,8 @@ Result<mdl::Material> loadMaterial(
   const std::filesystem::path& materialPath,
   const mdl::CreateTextureResource& createResource,
   const std::vector<mdl::Quake3Shader>& shaders,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::shared_ptr<const MaterialCache>& materialCache)
 {
   const auto materialPathStem = kdl::path_remove_extension(materialPath);
   const auto iShader =
@@ -446,19 +581,14 @@ Result<mdl::Material> loadMaterial(
       return shader.shaderPath == materialPathStem;
     });
 
-  return (iShader != shaders.end()
-            ? loadShaderMaterial(*iShader, fs, materialConfig, createResource)
-            : loadTextureMaterial(
-                materialPath, fs, materialConfig, createResource, paletteResult))
-         | kdl::transform([&](auto material) {
-             fs.makeAbsolute(materialPath)
-               | kdl::transform([&](auto absPath) { material.setAbsolutePath(absPath); })
-               | kdl::or_else([](auto) { return kdl::void_success; });
-             material.setRelativePath(materialPath);
-             material.setCollectionName(
-               materialCollectionName(fs, materialConfig, materialPath));
-             return material;
-           });
+  return loadMaterial(
+    fs,
+    materialConfig,
+    materialPath,
+    createResource,
+    iShader != shaders.end() ? &*iShader : nullptr,
+    paletteResult,
+    materialCache);
 }
 
 Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
@@ -466,8 +596,78 @@ Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
   const mdl::MaterialConfig& materialConfig,
   const mdl::CreateTextureResource& createResource,
   kdl::task_manager& taskManager,
-  Logger& logger)
+  Logger& logger,
+  const std::shared_ptr<const MaterialCache>& materialCache)
+{
+  const auto paletteResult = loadPalette(fs, materialConfig);
+
+  return loadShaders(fs, materialConfig, taskManager, logger)
+         | kdl::transform([&](auto shaders) {
+             return kdl::vec_filter(std::move(shaders), [&](const auto& shader) {
+               return kdl::path_has_prefix(shader.shaderPath, materialConfig.root);
+             });
+           })
+         | kdl::and_then([&](auto shaders) {
+             return findAllMaterialPaths(fs, materialConfig, shaders)
+                    | kdl::and_then([&](const auto& materialPaths) {
+                        return loadMaterials(
+                          fs,
+                          materialConfig,
+                          materialPaths,
+                          createResource,
+                          shaders,
+                          paletteResult,
+                          taskManager,
+                          materialCache);
+                      });
+           })
+         | kdl::transform([&](auto materials) {
+             return groupMaterialsIntoCollections(std::move(materials));
+           });
+}
+
+Result<std::vector<mdl::MaterialCollection>> reloadMaterialCollections(
+  std::vector<mdl::MaterialCollection> collections,
+  const std::vector<std::filesystem::path>& changedPaths,
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const mdl::CreateTextureResource& createResource,
+  kdl::task_manager& taskManager,
+  Logger& logger,
+  const std::shared_ptr<const MaterialCache>& materialCache)
 {
+  const auto toLowerStem = [](const auto& path) {
+    return kdl::path_to_lower(kdl::path_remove_extension(path));
+  };
+
+  auto changedStems = std::unordered_set<std::filesystem::path, kdl::path_hash>{};
+  for (const auto& changedPath : changedPaths)
+  {
+    changedStems.insert(toLowerStem(changedPath));
+  }
+
+  if (
+    !materialConfig.palette.empty()
+    && changedStems.contains(toLowerStem(materialConfig.palette)))
+  {
+    return loadMaterialCollections(
+      fs, materialConfig, createResource, taskManager, logger, materialCache);
+  }
+
+  auto unchangedMaterials =
+    std::unordered_map<std::filesystem::path, mdl::Material, kdl::path_hash>{};
+  for (auto& collection : collections)
+  {
+    for (auto& material : collection.materials())
+    {
+      if (const auto stem = toLowerStem(material.relativePath());
+          !changedStems.contains(stem))
+      {
+        unchangedMaterials.emplace(stem, std::move(material));
+      }
+    }
+  }
+
   const auto paletteResult = loadPalette(fs, materialConfig);
 
   return loadShaders(fs, materialConfig, taskManager, logger)
@@ -477,20 +677,46 @@ Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
              });
            })
          | kdl::and_then([&](auto shaders) {
+             // shaders may refer to any image, so their materials are always reloaded
+             for (const auto& shader : shaders)
+             {
+               unchangedMaterials.erase(toLowerStem(shader.shaderPath));
+             }
+
              return findAllMaterialPaths(fs, materialConfig, shaders)
                     | kdl::and_then([&](const auto& materialPaths) {
-                        return kdl::vec_transform(
-                                 materialPaths,
-                                 [&](const auto& materialPath) {
-                                   return loadMaterial(
-                                     fs,
-                                     materialConfig,
-                                     materialPath,
-                                     createResource,
-                                     shaders,
-                                     paletteResult);
-                                 })
-                               | kdl::fold;
+                        auto reusedMaterials = std::vector<mdl::Material>{};
+                        auto pathsToLoad = std::vector<std::filesystem::path>{};
+                        for (const auto& materialPath : materialPaths)
+                        {
+                          if (const auto it =
+                                unchangedMaterials.find(toLowerStem(materialPath));
+                              it != unchangedMaterials.end()
+                              && it->second.relativePath() == materialPath)
+                          {
+                            reusedMaterials.push_back(std::move(it->second));
+                            unchangedMaterials.erase(it);
+                          }
+                          else
+                          {
+                            pathsToLoad.push_back(materialPath);
+                          }
+                        }
+
+                        return loadMaterials(
+                                 fs,
+                                 materialConfig,
+                                 pathsToLoad,
+                                 createResource,
+                                 shaders,
+                                 paletteResult,
+                                 taskManager,
+                                 materialCache)
+                               | kdl::transform([&](auto loadedMaterials) {
+                                   return kdl::vec_concat(
+                                     std::move(reusedMaterials),
+                                     std::move(loadedMaterials));
+                                 });
                       });
            })
          | kdl::transform([&](auto materials) {
@@ -25,6 +25,7 @@
 #include "mdl/TextureResource.h"
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -48,6 +49,13 @@ struct MaterialConfig;
 namespace tb::io
 {
 class FileSystem;
+class MaterialCache;
+
+/**
+ * Loads the palette configured in the given material config, if any.
+ */
+std::optional<Result<mdl::Palette>> loadPalette(
+  const FileSystem& fs, const mdl::MaterialConfig& materialConfig);
 
 Result<mdl::Material> loadMaterial(
   const FileSystem& fs,
@@ -55,13 +63,32 @@ Result<mdl::Material> loadMaterial(
   const std::filesystem::path& materialPath,
   const mdl::CreateTextureResource& createResource,
   const std::vector<mdl::Quake3Shader>& shaders,
-  const std::optional<Result<mdl::Palette>>& paletteResult);
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::shared_ptr<const MaterialCache>& materialCache = nullptr);
 
 Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const mdl::CreateTextureResource& createResource,
   kdl::task_manager& taskManager,
-  Logger& logger);
+  Logger& logger,
+  const std::shared_ptr<const MaterialCache>& materialCache = nullptr);
+
+/**
+ * Loads the material collections again after the files with the given paths were added
+ * to or removed from the given file system. The materials of the given collections are
+ * reused unless a file with the same path stem changed or they are defined by a shader,
+ * so that their textures need not be loaded again. If the palette changed, all materials
+ * are loaded again.
+ */
+Result<std::vector<mdl::MaterialCollection>> reloadMaterialCollections(
+  std::vector<mdl::MaterialCollection> collections,
+  const std::vector<std::filesystem::path>& changedPaths,
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const mdl::CreateTextureResource& createResource,
+  kdl::task_manager& taskManager,
+  Logger& logger,
+  const std::shared_ptr<const MaterialCache>& materialCache = nullptr);
 
 } // namespace tb::io
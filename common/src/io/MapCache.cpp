@@ -0,0 +1,593 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "FileLocation.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ParallelUVCoordSystem.h"
+#include "mdl/ParaxialUVCoordSystem.h"
+
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto Magic = std::array<char, 4>{'T', 'B', 'M', 'C'};
+
+/**
+ * Must be incremented whenever the layout of the cache changes.
+ */
+constexpr auto Version = std::uint32_t(2);
+
+enum class ObjectType : std::uint8_t
+{
+  Entity,
+  Brush,
+  Patch,
+};
+
+enum class UVCoordSystemType : std::uint8_t
+{
+  Paraxial,
+  Parallel,
+};
+
+/**
+ * A simple 64 bit hash of the given string. It processes eight bytes at a time so that
+ * validating the cache of a large map file takes a small fraction of the time it takes
+ * to parse the file.
+ */
+std::uint64_t hashSource(const std::string_view source)
+{
+  constexpr auto Multiplier = std::uint64_t(0x9e3779b97f4a7c15);
+
+  auto hash = std::uint64_t(source.size());
+  auto i = size_t(0);
+  for (; i + sizeof(std::uint64_t) <= source.size(); i += sizeof(std::uint64_t))
+  {
+    auto word = std::uint64_t(0);
+    std::memcpy(&word, source.data() + i, sizeof(word));
+    hash = (hash ^ word) * Multiplier;
+    hash ^= hash >> 32;
+  }
+  for (; i < source.size(); ++i)
+  {
+    hash = (hash ^ std::uint64_t(static_cast<unsigned char>(source[i]))) * Multiplier;
+  }
+  return hash ^ (hash >> 29);
+}
+
+// writing
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeSize(std::ostream& stream, const size_t size)
+{
+  write(stream, std::uint64_t(size));
+}
+
+void writeString(std::ostream& stream, const std::string_view str)
+{
+  writeSize(stream, str.size());
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+template <typename T, size_t S>
+void writeVec(std::ostream& stream, const vm::vec<T, S>& vec)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    write(stream, vec[i]);
+  }
+}
+
+template <typename T>
+void writeOptional(std::ostream& stream, const std::optional<T>& value)
+{
+  write(stream, std::uint8_t(value.has_value()));
+  if (value)
+  {
+    write(stream, *value);
+  }
+}
+
+void writeLocation(std::ostream& stream, const FileLocation& location)
+{
+  writeSize(stream, location.line);
+  write(stream, std::uint8_t(location.column.has_value()));
+  if (location.column)
+  {
+    writeSize(stream, *location.column);
+  }
+}
+
+void writeOptionalLocation(
+  std::ostream& stream, const std::optional<FileLocation>& location)
+{
+  write(stream, std::uint8_t(location.has_value()));
+  if (location)
+  {
+    writeLocation(stream, *location);
+  }
+}
+
+void writeParentIndex(std::ostream& stream, const std::optional<size_t>& parentIndex)
+{
+  write(stream, std::uint8_t(parentIndex.has_value()));
+  if (parentIndex)
+  {
+    writeSize(stream, *parentIndex);
+  }
+}
+
+void writeAttributes(std::ostream& stream, const mdl::BrushFaceAttributes& attributes)
+{
+  writeString(stream, attributes.materialName());
+  writeVec(stream, attributes.offset());
+  writeVec(stream, attributes.scale());
+  write(stream, attributes.rotation());
+  writeOptional(stream, attributes.surfaceContents());
+  writeOptional(stream, attributes.surfaceFlags());
+  writeOptional(stream, attributes.surfaceValue());
+
+  const auto& color = attributes.color();
+  write(stream, std::uint8_t(color.has_value()));
+  if (color)
+  {
+    writeVec<float, 4>(stream, *color);
+  }
+}
+
+void writeFace(std::ostream& stream, const mdl::BrushFace& face)
+{
+  for (const auto& point : face.points())
+  {
+    writeVec(stream, point);
+  }
+
+  const auto& boundary = face.boundary();
+  writeVec(stream, boundary.normal);
+  write(stream, boundary.distance);
+
+  writeAttributes(stream, face.attributes());
+
+  const auto& uvCoordSystem = face.uvCoordSystem();
+  if (dynamic_cast<const mdl::ParallelUVCoordSystem*>(&uvCoordSystem))
+  {
+    write(stream, UVCoordSystemType::Parallel);
+  }
+  else
+  {
+    write(stream, UVCoordSystemType::Paraxial);
+    writeSize(
+      stream, mdl::ParaxialUVCoordSystem::planeNormalIndex(uvCoordSystem.normal()));
+  }
+  writeVec(stream, uvCoordSystem.uAxis());
+  writeVec(stream, uvCoordSystem.vAxis());
+
+  writeSize(stream, face.lineNumber());
+}
+
+void writeGeometry(
+  std::ostream& stream, const std::optional<MapReader::BrushGeometryInfo>& geometry)
+{
+  write(stream, std::uint8_t(geometry.has_value()));
+  if (geometry)
+  {
+    writeSize(stream, geometry->vertexPositions.size());
+    for (const auto& position : geometry->vertexPositions)
+    {
+      writeVec(stream, position);
+    }
+
+    writeSize(stream, geometry->faceVertexIndices.size());
+    for (const auto& indices : geometry->faceVertexIndices)
+    {
+      writeSize(stream, indices.size());
+      for (const auto index : indices)
+      {
+        write(stream, std::uint32_t(index));
+      }
+    }
+  }
+}
+
+void writeObjectInfo(std::ostream& stream, const MapReader::EntityInfo& entityInfo)
+{
+  write(stream, ObjectType::Entity);
+  writeSize(stream, entityInfo.properties.size());
+  for (const auto& property : entityInfo.properties)
+  {
+    writeString(stream, property.key());
+    writeString(stream, property.value());
+  }
+  writeLocation(stream, entityInfo.startLocation);
+  writeOptionalLocation(stream, entityInfo.endLocation);
+}
+
+void writeObjectInfo(std::ostream& stream, const MapReader::BrushInfo& brushInfo)
+{
+  write(stream, ObjectType::Brush);
+  writeSize(stream, brushInfo.faces.size());
+  for (const auto& face : brushInfo.faces)
+  {
+    writeFace(stream, face);
+  }
+  writeGeometry(stream, brushInfo.geometry);
+  writeLocation(stream, brushInfo.startLocation);
+  writeOptionalLocation(stream, brushInfo.endLocation);
+  writeParentIndex(stream, brushInfo.parentIndex);
+}
+
+void writeObjectInfo(std::ostream& stream, const MapReader::PatchInfo& patchInfo)
+{
+  write(stream, ObjectType::Patch);
+  writeSize(stream, patchInfo.rowCount);
+  writeSize(stream, patchInfo.columnCount);
+  writeSize(stream, patchInfo.controlPoints.size());
+  for (const auto& controlPoint : patchInfo.controlPoints)
+  {
+    writeVec(stream, controlPoint);
+  }
+  writeString(stream, patchInfo.materialName);
+  writeLocation(stream, patchInfo.startLocation);
+  writeOptionalLocation(stream, patchInfo.endLocation);
+  writeParentIndex(stream, patchInfo.parentIndex);
+}
+
+// reading
+
+template <typename T>
+T read(Reader& reader)
+{
+  return reader.read<T, T>();
+}
+
+size_t readSize(Reader& reader)
+{
+  return size_t(read<std::uint64_t>(reader));
+}
+
+/**
+ * Reads a count of items of at least the given size and checks that the reader has
+ * enough data left, so that a corrupt count does not cause a huge allocation.
+ */
+size_t readCount(Reader& reader, const size_t minItemSize)
+{
+  const auto count = readSize(reader);
+  if (!reader.canRead(count * minItemSize))
+  {
+    throw ReaderException{"Invalid item count"};
+  }
+  return count;
+}
+
+std::string readString(Reader& reader)
+{
+  auto result = std::string(readCount(reader, 1), '\0');
+  reader.read(result.data(), result.size());
+  return result;
+}
+
+template <typename T, size_t S>
+vm::vec<T, S> readVec(Reader& reader)
+{
+  return reader.readVec<T, S>();
+}
+
+template <typename T>
+std::optional<T> readOptional(Reader& reader)
+{
+  return read<std::uint8_t>(reader) != 0 ? std::optional{read<T>(reader)} : std::nullopt;
+}
+
+FileLocation readLocation(Reader& reader)
+{
+  const auto line = readSize(reader);
+  const auto column =
+    read<std::uint8_t>(reader) != 0 ? std::optional{readSize(reader)} : std::nullopt;
+  return {line, column};
+}
+
+std::optional<FileLocation> readOptionalLocation(Reader& reader)
+{
+  return read<std::uint8_t>(reader) != 0 ? std::optional{readLocation(reader)}
+                                         : std::nullopt;
+}
+
+std::optional<size_t> readParentIndex(Reader& reader)
+{
+  return read<std::uint8_t>(reader) != 0 ? std::optional{readSize(reader)}
+                                         : std::nullopt;
+}
+
+mdl::BrushFaceAttributes readAttributes(Reader& reader)
+{
+  auto attributes = mdl::BrushFaceAttributes{readString(reader)};
+  attributes.setOffset(readVec<float, 2>(reader));
+  attributes.setScale(readVec<float, 2>(reader));
+  attributes.setRotation(read<float>(reader));
+  attributes.setSurfaceContents(readOptional<int>(reader));
+  attributes.setSurfaceFlags(readOptional<int>(reader));
+  attributes.setSurfaceValue(readOptional<float>(reader));
+  if (read<std::uint8_t>(reader) != 0)
+  {
+    attributes.setColor(Color{readVec<float, 4>(reader)});
+  }
+  return attributes;
+}
+
+mdl::BrushFace readFace(Reader& reader)
+{
+  const auto points = mdl::BrushFace::Points{
+    readVec<double, 3>(reader), readVec<double, 3>(reader), readVec<double, 3>(reader)};
+
+  const auto normal = readVec<double, 3>(reader);
+  const auto distance = read<double>(reader);
+  const auto boundary = vm::plane3d{distance, normal};
+
+  auto attributes = readAttributes(reader);
+
+  const auto uvCoordSystemType = read<UVCoordSystemType>(reader);
+  if (
+    uvCoordSystemType != UVCoordSystemType::Paraxial
+    && uvCoordSystemType != UVCoordSystemType::Parallel)
+  {
+    throw ReaderException{"Invalid UV coordinate system type"};
+  }
+
+  const auto paraxialIndex = uvCoordSystemType == UVCoordSystemType::Paraxial
+                               ? std::optional{readSize(reader)}
+                               : std::nullopt;
+  const auto uAxis = readVec<double, 3>(reader);
+  const auto vAxis = readVec<double, 3>(reader);
+
+  auto uvCoordSystem =
+    paraxialIndex ? std::unique_ptr<mdl::UVCoordSystem>{std::make_unique<
+                      mdl::ParaxialUVCoordSystem>(*paraxialIndex, uAxis, vAxis)}
+                  : std::make_unique<mdl::ParallelUVCoordSystem>(uAxis, vAxis);
+
+  auto face =
+    mdl::BrushFace{points, boundary, std::move(attributes), std::move(uvCoordSystem)};
+
+  const auto lineNumber = readSize(reader);
+  face.setFilePosition(lineNumber, 1);
+
+  return face;
+}
+
+std::optional<MapReader::BrushGeometryInfo> readGeometry(Reader& reader)
+{
+  if (read<std::uint8_t>(reader) == 0)
+  {
+    return std::nullopt;
+  }
+
+  auto vertexPositions = std::vector<vm::vec3d>{};
+  const auto vertexCount = readCount(reader, sizeof(vm::vec3d));
+  vertexPositions.reserve(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    vertexPositions.push_back(readVec<double, 3>(reader));
+  }
+
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  const auto faceCount = readCount(reader, sizeof(std::uint64_t));
+  faceVertexIndices.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    auto& indices = faceVertexIndices.emplace_back();
+    const auto indexCount = readCount(reader, sizeof(std::uint32_t));
+    indices.reserve(indexCount);
+    for (size_t j = 0; j < indexCount; ++j)
+    {
+      indices.push_back(size_t(read<std::uint32_t>(reader)));
+    }
+  }
+
+  return MapReader::BrushGeometryInfo{
+    std::move(vertexPositions), std::move(faceVertexIndices)};
+}
+
+MapReader::EntityInfo readEntityInfo(Reader& reader)
+{
+  auto properties = std::vector<mdl::EntityProperty>{};
+  const auto propertyCount = readCount(reader, 2 * sizeof(std::uint64_t));
+  properties.reserve(propertyCount);
+  for (size_t i = 0; i < propertyCount; ++i)
+  {
+    auto key = readString(reader);
+    auto value = readString(reader);
+    properties.emplace_back(key, value);
+  }
+
+  auto startLocation = readLocation(reader);
+  auto endLocation = readOptionalLocation(reader);
+  return {std::move(properties), std::move(startLocation), std::move(endLocation)};
+}
+
+MapReader::BrushInfo readBrushInfo(Reader& reader)
+{
+  auto faces = std::vector<mdl::BrushFace>{};
+  const auto faceCount = readCount(reader, 1);
+  faces.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    faces.push_back(readFace(reader));
+  }
+
+  auto geometry = readGeometry(reader);
+  auto startLocation = readLocation(reader);
+  auto endLocation = readOptionalLocation(reader);
+  auto parentIndex = readParentIndex(reader);
+  return {
+    std::move(faces),
+    std::move(startLocation),
+    std::move(endLocation),
+    std::move(parentIndex),
+    std::move(geometry)};
+}
+
+MapReader::PatchInfo readPatchInfo(Reader& reader)
+{
+  const auto rowCount = readSize(reader);
+  const auto columnCount = readSize(reader);
+
+  auto controlPoints = std::vector<mdl::BezierPatch::Point>{};
+  const auto controlPointCount = readCount(reader, sizeof(mdl::BezierPatch::Point));
+  controlPoints.reserve(controlPointCount);
+  for (size_t i = 0; i < controlPointCount; ++i)
+  {
+    controlPoints.push_back(readVec<double, 5>(reader));
+  }
+
+  auto materialName = readString(reader);
+  auto startLocation = readLocation(reader);
+  auto endLocation = readOptionalLocation(reader);
+  auto parentIndex = readParentIndex(reader);
+  return {
+    rowCount,
+    columnCount,
+    std::move(controlPoints),
+    std::move(materialName),
+    std::move(startLocation),
+    std::move(endLocation),
+    std::move(parentIndex)};
+}
+
+MapReader::ObjectInfo readObjectInfo(Reader& reader)
+{
+  switch (read<ObjectType>(reader))
+  {
+  case ObjectType::Entity:
+    return readEntityInfo(reader);
+  case ObjectType::Brush:
+    return readBrushInfo(reader);
+  case ObjectType::Patch:
+    return readPatchInfo(reader);
+  }
+  throw ReaderException{"Invalid object type"};
+}
+
+} // namespace
+
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath)
+{
+  auto result = mapPath;
+  result += ".tbcache";
+  return result;
+}
+
+void writeMapCache(
+  std::ostream& stream,
+  const std::string_view source,
+  const mdl::MapFormat mapFormat,
+  const std::vector<MapReader::ObjectInfo>& objectInfos)
+{
+  stream.write(Magic.data(), Magic.size());
+  write(stream, Version);
+  write(stream, std::uint32_t(mapFormat));
+  writeSize(stream, source.size());
+  write(stream, hashSource(source));
+
+  writeSize(stream, objectInfos.size());
+  for (const auto& objectInfo : objectInfos)
+  {
+    std::visit([&](const auto& info) { writeObjectInfo(stream, info); }, objectInfo);
+  }
+
+  // marks the end so that a truncated cache is detected
+  stream.write(Magic.data(), Magic.size());
+}
+
+Result<std::vector<MapReader::ObjectInfo>> readMapCache(
+  Reader reader, const std::string_view source, const mdl::MapFormat mapFormat)
+{
+  try
+  {
+    auto magic = std::array<char, 4>{};
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Not a map cache"};
+    }
+
+    if (const auto version = read<std::uint32_t>(reader); version != Version)
+    {
+      return Error{fmt::format("Unsupported map cache version {}", version)};
+    }
+
+    if (read<std::uint32_t>(reader) != std::uint32_t(mapFormat))
+    {
+      return Error{"Map cache was created for a different map format"};
+    }
+
+    const auto sourceSize = readSize(reader);
+    const auto sourceHash = read<std::uint64_t>(reader);
+    if (sourceSize != source.size() || sourceHash != hashSource(source))
+    {
+      return Error{"Map cache is out of date"};
+    }
+
+    auto objectInfos = std::vector<MapReader::ObjectInfo>{};
+    const auto objectCount = readCount(reader, 1);
+    objectInfos.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i)
+    {
+      objectInfos.push_back(readObjectInfo(reader));
+    }
+
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Map cache is truncated"};
+    }
+
+    return objectInfos;
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{fmt::format("Invalid map cache: {}", e.what())};
+  }
+}
+
+} // namespace tb::io
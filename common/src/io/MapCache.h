@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "io/MapReader.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+namespace tb::mdl
+{
+enum class MapFormat;
+}
+
+namespace tb::io
+{
+class Reader;
+
+/**
+ * A map cache is a binary file that stores the objects parsed from a map file, so that
+ * the map file does not need to be parsed again when it is loaded the next time.
+ *
+ * The cache records the parser output together with the geometry of each brush, so that
+ * the brushes can be created without intersecting their face planes again. Groups,
+ * layers and linked groups are stored as the entity properties that they are read from,
+ * so the cache does not depend on the game configuration.
+ *
+ * A cache is only valid for the map file it was created from. It stores a format
+ * version, the map format, and the size and hash of the map file, and it is rejected if
+ * any of these don't match.
+ */
+
+/**
+ * Returns the path of the cache file for the map file at the given path.
+ */
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath);
+
+/**
+ * Writes a cache for the given object infos, which were parsed from the given source in
+ * the given map format, to the given stream.
+ */
+void writeMapCache(
+  std::ostream& stream,
+  std::string_view source,
+  mdl::MapFormat mapFormat,
+  const std::vector<MapReader::ObjectInfo>& objectInfos);
+
+/**
+ * Reads the object infos from the given cache.
+ *
+ * Returns an error if the cache is malformed, if it was written by a different version
+ * of the cache format, or if it was not created from the given source in the given map
+ * format.
+ */
+Result<std::vector<MapReader::ObjectInfo>> readMapCache(
+  Reader reader, std::string_view source, mdl::MapFormat mapFormat);
+
+} // namespace tb::io
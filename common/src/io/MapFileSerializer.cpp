@@ -38,9 +38,10 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
-#include <sstream>
+#include <string>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -57,20 +58,20 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "\n");
+    writeFacePoints(str, face);
+    writeMaterialInfo(str, face);
+    fmt::format_to(std::back_inserter(str), "\n");
   }
 
 protected:
-  void writeFacePoints(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeFacePoints(std::string& str, const mdl::BrushFace& face) const
   {
     const auto& points = face.points();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream},
+      std::back_inserter(str),
       "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
       points[0].x(),
       points[0].y(),
@@ -94,14 +95,14 @@ protected:
     return fmt::format(R"("{}")", kdl::str_escape(materialName, R"(")"));
   }
 
-  void writeMaterialInfo(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeMaterialInfo(std::string& str, const mdl::BrushFace& face) const
   {
     const auto& materialName = face.attributes().materialName().empty()
                                  ? mdl::BrushFaceAttributes::NoMaterialName
                                  : face.attributes().materialName();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream},
+      std::back_inserter(str),
       " {} {} {} {} {} {}",
       shouldQuoteMaterialName(materialName) ? quoteMaterialName(materialName)
                                             : materialName,
@@ -112,7 +113,7 @@ protected:
       face.attributes().yScale());
   }
 
-  void writeValveMaterialInfo(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeValveMaterialInfo(std::string& str, const mdl::BrushFace& face) const
   {
     const auto& materialName = face.attributes().materialName().empty()
                                  ? mdl::BrushFaceAttributes::NoMaterialName
@@ -121,7 +122,7 @@ protected:
     const auto vAxis = face.vAxis();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream},
+      std::back_inserter(str),
       " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
       shouldQuoteMaterialName(materialName) ? quoteMaterialName(materialName)
                                             : materialName,
@@ -151,24 +152,24 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
+    writeFacePoints(str, face);
+    writeMaterialInfo(str, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(str, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "\n");
+    fmt::format_to(std::back_inserter(str), "\n");
   }
 
 protected:
-  void writeSurfaceAttributes(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeSurfaceAttributes(std::string& str, const mdl::BrushFace& face) const
   {
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream},
+      std::back_inserter(str),
       " {} {} {}",
       face.resolvedSurfaceContents(),
       face.resolvedSurfaceFlags(),
@@ -185,17 +186,17 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveMaterialInfo(stream, face);
+    writeFacePoints(str, face);
+    writeValveMaterialInfo(str, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(str, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "\n");
+    fmt::format_to(std::back_inserter(str), "\n");
   }
 };
 
@@ -212,28 +213,28 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
+    writeFacePoints(str, face);
+    writeMaterialInfo(str, face);
 
     if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(str, face);
     }
     if (face.attributes().hasColor())
     {
-      writeSurfaceColor(stream, face);
+      writeSurfaceColor(str, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "\n");
+    fmt::format_to(std::back_inserter(str), "\n");
   }
 
 protected:
-  void writeSurfaceColor(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeSurfaceColor(std::string& str, const mdl::BrushFace& face) const
   {
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream},
+      std::back_inserter(str),
       " {} {} {}",
       static_cast<int>(face.resolvedColor().r()),
       static_cast<int>(face.resolvedColor().g()),
@@ -250,12 +251,12 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
+    writeFacePoints(str, face);
+    writeMaterialInfo(str, face);
     fmt::format_to(
-      std::ostreambuf_iterator<char>{stream}, " 0\n"); // extra value written here
+      std::back_inserter(str), " 0\n"); // extra value written here
   }
 };
 
@@ -268,11 +269,11 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveMaterialInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "\n");
+    writeFacePoints(str, face);
+    writeValveMaterialInfo(str, face);
+    fmt::format_to(std::back_inserter(str), "\n");
   }
 };
 
@@ -339,26 +340,25 @@ void MapFileSerializer::doBeginFile(
         nodesToSerialize.emplace_back(patchNode);
       }));
 
-  // serialize brushes to strings in parallel
-  using Entry = std::pair<const mdl::Node*, PrecomputedString>;
-  auto tasks = nodesToSerialize | std::views::transform([&](const auto& node) {
-                 return std::function{[&]() {
-                   return std::visit(
-                     kdl::overload(
-                       [&](const mdl::BrushNode* brushNode) {
-                         return Entry{brushNode, writeBrushFaces(brushNode->brush())};
-                       },
-                       [&](const mdl::PatchNode* patchNode) {
-                         return Entry{patchNode, writePatch(patchNode->patch())};
-                       }),
-                     node);
-                 }};
-               });
-
-  // render strings and move them into a map
-  for (auto& entry : taskManager.run_tasks_and_wait(std::move(tasks)))
+  // serialize brushes and patches to separate strings in parallel
+  auto precomputedStrings = std::vector<PrecomputedString>(nodesToSerialize.size());
+  taskManager.parallel_for(nodesToSerialize.size(), [&](const size_t i) {
+    precomputedStrings[i] = std::visit(
+      kdl::overload(
+        [&](const mdl::BrushNode* brushNode) {
+          return writeBrushFaces(brushNode->brush());
+        },
+        [&](const mdl::PatchNode* patchNode) { return writePatch(patchNode->patch()); }),
+      nodesToSerialize[i]);
+  });
+
+  // move the strings into a map, they are written in node order when the nodes are visited
+  m_nodeToPrecomputedString.reserve(nodesToSerialize.size());
+  for (size_t i = 0; i < nodesToSerialize.size(); ++i)
   {
-    m_nodeToPrecomputedString.insert(std::move(entry));
+    const auto* node = std::visit(
+      [](const auto* n) -> const mdl::Node* { return n; }, nodesToSerialize[i]);
+    m_nodeToPrecomputedString.emplace(node, std::move(precomputedStrings[i]));
   }
 }
 
@@ -415,7 +415,9 @@ void MapFileSerializer::doBrush(const mdl::BrushNode* brush)
 void MapFileSerializer::doBrushFace(const mdl::BrushFace& face)
 {
   const size_t lines = 1u;
-  doWriteBrushFace(m_stream, face);
+  auto str = std::string{};
+  doWriteBrushFace(str, face);
+  m_stream << str;
   face.setFilePosition(m_line, lines);
   m_line += lines;
 }
@@ -438,6 +440,20 @@ void MapFileSerializer::doPatch(const mdl::PatchNode* patchNode)
   setFilePosition(patchNode);
 }
 
+void MapFileSerializer::doUnloadedEntity(const std::string_view str)
+{
+  fmt::format_to(
+    std::ostreambuf_iterator<char>{m_stream}, "// entity {}\n{}\n", entityNo(), str);
+  m_line += 2 + size_t(std::ranges::count(str, '\n'));
+}
+
+void MapFileSerializer::doUnloadedBrush(const std::string_view str)
+{
+  fmt::format_to(
+    std::ostreambuf_iterator<char>{m_stream}, "// brush {}\n{}\n", brushNo(), str);
+  m_line += 2 + size_t(std::ranges::count(str, '\n'));
+}
+
 void MapFileSerializer::setFilePosition(const mdl::Node* node)
 {
   const auto start = startLine();
@@ -458,45 +474,45 @@ size_t MapFileSerializer::startLine()
 MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
   const mdl::Brush& brush) const
 {
-  auto stream = std::stringstream{};
+  auto str = std::string{};
   for (const auto& face : brush.faces())
   {
-    doWriteBrushFace(stream, face);
+    doWriteBrushFace(str, face);
   }
-  return {stream.str(), brush.faces().size()};
+  return {std::move(str), brush.faces().size()};
 }
 
 MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   const mdl::BezierPatch& patch) const
 {
   size_t lineCount = 0u;
-  auto stream = std::stringstream{};
+  auto str = std::string{};
 
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "{{\n");
+  fmt::format_to(std::back_inserter(str), "{{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "patchDef2\n");
+  fmt::format_to(std::back_inserter(str), "patchDef2\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "{{\n");
+  fmt::format_to(std::back_inserter(str), "{{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "{}\n", patch.materialName());
+  fmt::format_to(std::back_inserter(str), "{}\n", patch.materialName());
   ++lineCount;
   fmt::format_to(
-    std::ostreambuf_iterator<char>{stream},
+    std::back_inserter(str),
     "( {} {} 0 0 0 )\n",
     patch.pointRowCount(),
     patch.pointColumnCount());
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "(\n");
+  fmt::format_to(std::back_inserter(str), "(\n");
   ++lineCount;
 
   for (size_t row = 0u; row < patch.pointRowCount(); ++row)
   {
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, "( ");
+    fmt::format_to(std::back_inserter(str), "( ");
     for (size_t col = 0u; col < patch.pointColumnCount(); ++col)
     {
       const auto& p = patch.controlPoint(row, col);
       fmt::format_to(
-        std::ostreambuf_iterator<char>{stream},
+        std::back_inserter(str),
         "( {} {} {} {} {} ) ",
         p[0],
         p[1],
@@ -504,18 +520,18 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
         p[3],
         p[4]);
     }
-    fmt::format_to(std::ostreambuf_iterator<char>{stream}, ")\n");
+    fmt::format_to(std::back_inserter(str), ")\n");
     ++lineCount;
   }
 
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, ")\n");
+  fmt::format_to(std::back_inserter(str), ")\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "}}\n");
+  fmt::format_to(std::back_inserter(str), "}}\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>{stream}, "}}\n");
+  fmt::format_to(std::back_inserter(str), "}}\n");
   ++lineCount;
 
-  return {stream.str(), lineCount};
+  return {std::move(str), lineCount};
 }
 
 } // namespace tb::io
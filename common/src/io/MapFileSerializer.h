@@ -24,6 +24,7 @@
 
 #include <iosfwd>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -78,13 +79,15 @@ private:
 
   void doPatch(const mdl::PatchNode* patchNode) override;
 
+  void doUnloadedEntity(std::string_view str) override;
+  void doUnloadedBrush(std::string_view str) override;
+
 private:
   void setFilePosition(const mdl::Node* node);
   size_t startLine();
 
 private: // threadsafe
-  virtual void doWriteBrushFace(
-    std::ostream& stream, const mdl::BrushFace& face) const = 0;
+  virtual void doWriteBrushFace(std::string& str, const mdl::BrushFace& face) const = 0;
   PrecomputedString writeBrushFaces(const mdl::Brush& brush) const;
   PrecomputedString writePatch(const mdl::BezierPatch& patch) const;
 };
@@ -19,9 +19,13 @@
 
 #include "MapHeader.h"
 
+#include "io/CompressedMapFile.h"
+
 #include "kdl/string_compare.h"
 
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 namespace tb::io
 {
@@ -57,9 +61,7 @@ Result<std::optional<std::string>> readInfoComment(
   return std::string{result};
 }
 
-} // namespace
-
-Result<std::pair<std::optional<std::string>, mdl::MapFormat>> readMapHeader(
+Result<std::pair<std::optional<std::string>, mdl::MapFormat>> readUncompressedMapHeader(
   std::istream& stream)
 {
   return readInfoComment(stream, GameHeader).join(readInfoComment(stream, FormatHeader))
@@ -70,6 +72,33 @@ Result<std::pair<std::optional<std::string>, mdl::MapFormat>> readMapHeader(
            });
 }
 
+} // namespace
+
+Result<std::pair<std::optional<std::string>, mdl::MapFormat>> readMapHeader(
+  std::istream& stream)
+{
+  // a compressed map file must be read entirely to be decompressed, so we only do this
+  // if the stream starts like one
+  if (stream.peek() == 'T')
+  {
+    const auto contents = std::string{
+      std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    if (isCompressedMapFile(contents))
+    {
+      return decompressMapFile(contents) | kdl::and_then([](auto decompressedContents) {
+               auto decompressedStream =
+                 std::istringstream{std::move(decompressedContents)};
+               return readUncompressedMapHeader(decompressedStream);
+             });
+    }
+
+    auto contentsStream = std::istringstream{contents};
+    return readUncompressedMapHeader(contentsStream);
+  }
+
+  return readUncompressedMapHeader(stream);
+}
+
 void writeMapHeader(
   std::ostream& stream, const std::string_view gameName, const mdl::MapFormat mapFormat)
 {
@@ -38,6 +38,9 @@ namespace tb::io
  * the game name. If no map format comment is found or the format is unknown,
  * MapFormat::Unknown is returned as the map format.
  *
+ * If the stream contains a compressed map file, see compressMapFile, the header is read
+ * from the decompressed contents.
+ *
  * An error is returned if the stream is in a bad state.
  */
 Result<std::pair<std::optional<std::string>, mdl::MapFormat>> readMapHeader(
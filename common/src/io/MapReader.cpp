@@ -19,9 +19,11 @@
 
 #include "MapReader.h"
 
+#include "Trace.h"
 #include "Error.h" // IWYU pragma: keep
 #include "FileLocation.h"
 #include "Uuid.h"
+#include "io/BufferedParserStatus.h"
 #include "io/ParserStatus.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -37,6 +39,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
 #include "kdl/task_manager.h"
@@ -46,7 +49,10 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -60,6 +66,12 @@ namespace tb::io
 namespace
 {
 
+/**
+ * Maps smaller than this are parsed sequentially. Larger maps are split into chunks of
+ * at least this size, which are then parsed in parallel.
+ */
+constexpr auto MinEntityChunkSize = size_t(512 * 1024);
+
 template <typename T>
 auto getFilePosition(const T& info)
 {
@@ -70,12 +82,54 @@ auto getFilePosition(const T& info)
 
 } // namespace
 
+/**
+ * Parses a chunk of a map file and records the object infos so that they can be merged
+ * into the object infos of the reader for the entire file.
+ */
+class MapReader::EntityChunkReader : public MapReader
+{
+public:
+  EntityChunkReader(
+    const EntityChunk& chunk,
+    const mdl::MapFormat sourceMapFormat,
+    const mdl::MapFormat targetMapFormat,
+    mdl::EntityPropertyConfig entityPropertyConfig)
+    : MapReader{
+        chunk.str,
+        sourceMapFormat,
+        targetMapFormat,
+        std::move(entityPropertyConfig),
+        chunk.startLine,
+        chunk.startColumn}
+  {
+  }
+
+  Result<std::vector<ObjectInfo>> read(ParserStatus& status)
+  {
+    return parseEntities(status)
+           | kdl::transform([&]() { return std::move(m_objectInfos); });
+  }
+
+private: // nodes are created by the reader for the entire file
+  mdl::Node* onWorldNode(std::unique_ptr<mdl::WorldNode>, ParserStatus&) override
+  {
+    return nullptr;
+  }
+
+  void onLayerNode(std::unique_ptr<mdl::Node>, ParserStatus&) override {}
+
+  void onNode(mdl::Node*, std::unique_ptr<mdl::Node>, ParserStatus&) override {}
+};
+
 MapReader::MapReader(
   const std::string_view str,
   const mdl::MapFormat sourceMapFormat,
   const mdl::MapFormat targetMapFormat,
-  mdl::EntityPropertyConfig entityPropertyConfig)
-  : StandardMapParser{str, sourceMapFormat, targetMapFormat}
+  mdl::EntityPropertyConfig entityPropertyConfig,
+  const size_t startLine,
+  const size_t startColumn)
+  : StandardMapParser{str, sourceMapFormat, targetMapFormat, startLine, startColumn}
+  , m_str{str}
   , m_entityPropertyConfig{std::move(entityPropertyConfig)}
 {
 }
@@ -84,8 +138,20 @@ Result<void> MapReader::readEntities(
   const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager)
 {
   m_worldBounds = worldBounds;
-  return parseEntities(status)
-         | kdl::transform([&]() { createNodes(status, taskManager); });
+  return parseEntityChunks(status, taskManager) | kdl::transform([&]() {
+           createNodes(status, taskManager, retainObjectInfos());
+         });
+}
+
+void MapReader::readObjectInfos(
+  std::vector<ObjectInfo> objectInfos,
+  const vm::bbox3d& worldBounds,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  m_worldBounds = worldBounds;
+  m_objectInfos = std::move(objectInfos);
+  createNodes(status, taskManager, false);
 }
 
 Result<void> MapReader::readBrushes(
@@ -93,7 +159,7 @@ Result<void> MapReader::readBrushes(
 {
   m_worldBounds = worldBounds;
   return parseBrushesOrPatches(status)
-         | kdl::transform([&]() { createNodes(status, taskManager); });
+         | kdl::transform([&]() { createNodes(status, taskManager, false); });
 }
 
 Result<void> MapReader::readBrushFaces(
@@ -127,7 +193,8 @@ void MapReader::onEndEntity(const FileLocation& endLocation, ParserStatus& /* st
 
 void MapReader::onBeginBrush(const FileLocation& location, ParserStatus& /* status */)
 {
-  m_objectInfos.emplace_back(BrushInfo{{}, location, std::nullopt, m_currentEntityInfo});
+  m_objectInfos.emplace_back(
+    BrushInfo{{}, location, std::nullopt, m_currentEntityInfo, std::nullopt});
 }
 
 void MapReader::onEndBrush(const FileLocation& endLocation, ParserStatus& /* status */)
@@ -150,6 +217,7 @@ void MapReader::onStandardBrushFace(
   mdl::BrushFace::createFromStandard(point1, point2, point3, attribs, targetMapFormat)
     | kdl::transform([&](auto face) {
         face.setFilePosition(location.line, location.column.value_or(1));
+        face.internAttributes();
         onBrushFace(std::move(face), status);
       })
     | kdl::transform_error(
@@ -171,6 +239,7 @@ void MapReader::onValveBrushFace(
     point1, point2, point3, attribs, uAxis, vAxis, targetMapFormat)
     | kdl::transform([&](mdl::BrushFace&& face) {
         face.setFilePosition(location.line, location.column.value_or(1));
+        face.internAttributes();
         onBrushFace(std::move(face), status);
       })
     | kdl::transform_error(
@@ -199,6 +268,77 @@ void MapReader::onPatch(
 
 // helper methods
 
+namespace
+{
+
+struct ParsedEntityChunk
+{
+  std::vector<MapReader::ObjectInfo> objectInfos;
+  std::unique_ptr<BufferedParserStatus> status;
+};
+
+void offsetParentIndex(MapReader::ObjectInfo& objectInfo, const size_t offset)
+{
+  std::visit(
+    kdl::overload(
+      [](MapReader::EntityInfo&) {},
+      [&](auto& brushOrPatchInfo) {
+        if (brushOrPatchInfo.parentIndex)
+        {
+          *brushOrPatchInfo.parentIndex += offset;
+        }
+      }),
+    objectInfo);
+}
+
+} // namespace
+
+/**
+ * Splits the map into chunks of entities and parses them in parallel. The object infos
+ * and the parser messages of the chunks are merged in file order.
+ *
+ * If the map is too small or if any of the chunks fails to parse, the entire map is
+ * parsed sequentially to keep the reported errors identical to the sequential parser.
+ */
+Result<void> MapReader::parseEntityChunks(
+  ParserStatus& status, kdl::task_manager& taskManager)
+{
+  const auto chunks = splitEntityChunks(m_str, MinEntityChunkSize);
+  if (chunks.size() < 2)
+  {
+    return parseEntities(status);
+  }
+
+  auto tasks = chunks | std::views::transform([&](const auto& chunk) {
+                 return std::function{[&]() {
+                   auto chunkStatus = std::make_unique<BufferedParserStatus>(status);
+                   auto reader = EntityChunkReader{
+                     chunk, m_sourceMapFormat, m_targetMapFormat, m_entityPropertyConfig};
+
+                   return reader.read(*chunkStatus)
+                          | kdl::transform([&](auto objectInfos) {
+                              return ParsedEntityChunk{
+                                std::move(objectInfos), std::move(chunkStatus)};
+                            });
+                 }};
+               });
+
+  return kdl::fold_results(taskManager.run_tasks_and_wait(std::move(tasks)))
+         | kdl::transform([&](auto parsedChunks) {
+             for (auto& parsedChunk : parsedChunks)
+             {
+               const auto offset = m_objectInfos.size();
+               for (auto& objectInfo : parsedChunk.objectInfos)
+               {
+                 offsetParentIndex(objectInfo, offset);
+                 m_objectInfos.push_back(std::move(objectInfo));
+               }
+               parsedChunk.status->flush();
+             }
+           })
+         | kdl::or_else([&](const auto&) { return parseEntities(status); });
+}
+
 namespace
 {
 /** The type of a node's container. */
@@ -580,25 +720,63 @@ CreateNodeResult createNodeFromEntityInfo(
   return createEntityNode(std::move(entityInfo));
 }
 
+/**
+ * Returns the geometry of the given brush in the form in which it is stored in a brush
+ * info.
+ */
+MapReader::BrushGeometryInfo makeBrushGeometryInfo(const mdl::Brush& brush)
+{
+  const auto& geometry = brush.compactGeometry();
+
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  faceVertexIndices.reserve(geometry.faceCount());
+  for (size_t i = 0; i < geometry.faceCount(); ++i)
+  {
+    const auto indices = geometry.faceVertexIndices(i);
+    faceVertexIndices.emplace_back(indices.begin(), indices.end());
+  }
+
+  return {geometry.positions(), std::move(faceVertexIndices)};
+}
+
 /**
  * Creates a brush node from the given brush info. Returns an error if the brush could not
  * be created.
+ *
+ * If the brush info should be retained, its faces are copied, and if the brush was
+ * created successfully, the brush info is updated with the brush's faces and geometry.
  */
 CreateNodeResult createBrushNode(
-  MapReader::BrushInfo brushInfo, const vm::bbox3d& worldBounds)
-{
-  return mdl::Brush::create(worldBounds, std::move(brushInfo.faces))
-         | kdl::transform([&](auto brush) {
-             auto brushNode = std::make_unique<mdl::BrushNode>(std::move(brush));
-             const auto [startLine, lineCount] = getFilePosition(brushInfo);
-             brushNode->setFilePosition(startLine, lineCount);
-
-             auto parentInfo = brushInfo.parentIndex ? ParentInfo{*brushInfo.parentIndex}
-                                                     : std::optional<ParentInfo>{};
-             return NodeInfo{
-               std::move(brushNode), std::move(parentInfo), {} // issues
-             };
-           })
+  MapReader::BrushInfo& brushInfo,
+  const vm::bbox3d& worldBounds,
+  const bool retainBrushInfo)
+{
+  auto faces = retainBrushInfo ? brushInfo.faces : std::move(brushInfo.faces);
+  auto brushResult =
+    brushInfo.geometry ? mdl::Brush::create(
+                           worldBounds,
+                           std::move(faces),
+                           brushInfo.geometry->vertexPositions,
+                           brushInfo.geometry->faceVertexIndices)
+                       : mdl::Brush::create(worldBounds, std::move(faces));
+
+  return std::move(brushResult) | kdl::transform([&](auto brush) {
+           if (retainBrushInfo)
+           {
+             brushInfo.faces = brush.faces();
+             brushInfo.geometry = makeBrushGeometryInfo(brush);
+           }
+
+           auto brushNode = std::make_unique<mdl::BrushNode>(std::move(brush));
+           const auto [startLine, lineCount] = getFilePosition(brushInfo);
+           brushNode->setFilePosition(startLine, lineCount);
+
+           auto parentInfo = brushInfo.parentIndex ? ParentInfo{*brushInfo.parentIndex}
+                                                   : std::optional<ParentInfo>{};
+           return NodeInfo{
+             std::move(brushNode), std::move(parentInfo), {} // issues
+           };
+         })
          | kdl::or_else([&](auto e) {
              return CreateNodeResult{
                NodeError{brushInfo.startLocation, kdl::str_to_string(e)}};
@@ -634,13 +812,14 @@ CreateNodeResult createPatchNode(MapReader::PatchInfo patchInfo)
  */
 std::vector<std::optional<NodeInfo>> createNodesFromObjectInfos(
   const mdl::EntityPropertyConfig& entityPropertyConfig,
-  std::vector<MapReader::ObjectInfo> objectInfos,
+  std::vector<MapReader::ObjectInfo>& objectInfos,
   const vm::bbox3d& worldBounds,
   const mdl::MapFormat mapFormat,
+  const bool retainObjectInfos,
   ParserStatus& status,
   kdl::task_manager& taskManager)
 {
-  // create nodes in parallel, moving data out of objectInfos
+  // create nodes in parallel, moving data out of objectInfos unless they are retained
   // we store optionals in the result vector to make the elements default constructible,
   // which is a requirement for parallel transform
   auto tasks = objectInfos | std::views::transform([&](auto& objectInfo) {
@@ -649,13 +828,17 @@ std::vector<std::optional<NodeInfo>> createNodesFromObjectInfos(
                      kdl::overload(
                        [&](MapReader::EntityInfo& entityInfo) {
                          return createNodeFromEntityInfo(
-                           entityPropertyConfig, std::move(entityInfo), mapFormat);
+                           entityPropertyConfig,
+                           retainObjectInfos ? entityInfo : std::move(entityInfo),
+                           mapFormat);
                        },
                        [&](MapReader::BrushInfo& brushInfo) {
-                         return createBrushNode(std::move(brushInfo), worldBounds);
+                         return createBrushNode(
+                           brushInfo, worldBounds, retainObjectInfos);
                        },
                        [&](MapReader::PatchInfo& patchInfo) {
-                         return createPatchNode(std::move(patchInfo));
+                         return createPatchNode(
+                           retainObjectInfos ? patchInfo : std::move(patchInfo));
                        }),
                      objectInfo);
                  }};
@@ -903,6 +1086,294 @@ std::unordered_map<mdl::Node*, mdl::Node*> buildNodeToParentMap(
   }
   return nodeToParentMap;
 }
+/**
+ * Maps file locations to offsets into the source string. Lines are counted the same way
+ * the tokenizer counts them.
+ */
+class SourceOffsets
+{
+private:
+  std::vector<size_t> m_lineStarts;
+
+public:
+  explicit SourceOffsets(const std::string_view str)
+    : m_lineStarts{0}
+  {
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+      if (
+        str[i] == '\n'
+        || (str[i] == '\r' && (i + 1 == str.size() || str[i + 1] != '\n')))
+      {
+        m_lineStarts.push_back(i + 1);
+      }
+    }
+  }
+
+  std::optional<size_t> offset(const FileLocation& location) const
+  {
+    if (location.line == 0 || location.line > m_lineStarts.size())
+    {
+      return std::nullopt;
+    }
+    return m_lineStarts[location.line - 1] + location.column.value_or(1) - 1;
+  }
+};
+
+/**
+ * Returns the source text of the given entity, brush or patch info, from its opening to
+ * its closing brace.
+ */
+template <typename T>
+std::optional<std::string_view> findSourceText(
+  const T& info, const std::string_view str, const SourceOffsets& offsets)
+{
+  if (info.endLocation)
+  {
+    const auto begin = offsets.offset(info.startLocation);
+    const auto end = offsets.offset(*info.endLocation);
+    if (begin && end && *begin <= *end && *end < str.size())
+    {
+      return str.substr(*begin, *end - *begin + 1);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<mdl::IdType> findPersistentId(
+  const std::vector<mdl::EntityProperty>& properties, const std::string& key)
+{
+  const auto id = kdl::str_to_long(findEntityPropertyOrDefault(properties, key));
+  return id && *id >= 0 ? std::optional{static_cast<mdl::IdType>(*id)} : std::nullopt;
+}
+
+using UnloadedLayerContents = std::unordered_map<mdl::IdType, mdl::UnloadedLayerContent>;
+
+/**
+ * Removes the object infos that belong to custom layers which should not be loaded, and
+ * returns their source text by layer ID. The layer entities themselves are kept so that
+ * the layer nodes are still created.
+ *
+ * An entity or group belongs to the layer at the end of its chain of containers, and a
+ * brush or patch belongs to its entity. The source text of an entity includes its brushes
+ * and patches.
+ *
+ * Linked groups must be loaded together, so a layer is always loaded if it contains a
+ * linked group that is linked to a group in another layer.
+ */
+UnloadedLayerContents extractUnloadedLayers(
+  std::vector<MapReader::ObjectInfo>& objectInfos,
+  const std::string_view str,
+  const std::function<bool(const std::string&, bool)>& shouldLoadLayer,
+  ParserStatus& status)
+{
+  // maps the indices of the unloaded layer entities to their layer IDs
+  auto unloadedLayers = std::unordered_map<size_t, mdl::IdType>{};
+  auto unloadedLayerIds = std::unordered_set<mdl::IdType>{};
+  auto groupIndices = std::unordered_map<mdl::IdType, size_t>{};
+
+  for (size_t i = 0; i < objectInfos.size(); ++i)
+  {
+    if (const auto* entityInfo = std::get_if<MapReader::EntityInfo>(&objectInfos[i]))
+    {
+      const auto& properties = entityInfo->properties;
+      const auto& classname =
+        findEntityPropertyOrDefault(properties, mdl::EntityPropertyKeys::Classname);
+      if (mdl::isLayer(classname, properties))
+      {
+        const auto& name =
+          findEntityPropertyOrDefault(properties, mdl::EntityPropertyKeys::LayerName);
+        const auto hidden =
+          findEntityPropertyOrDefault(properties, mdl::EntityPropertyKeys::LayerHidden)
+          == mdl::EntityPropertyValues::LayerHiddenValue;
+        if (const auto layerId =
+              findPersistentId(properties, mdl::EntityPropertyKeys::LayerId);
+            layerId && !shouldLoadLayer(name, hidden))
+        {
+          unloadedLayers.emplace(i, *layerId);
+          unloadedLayerIds.insert(*layerId);
+        }
+      }
+      else if (mdl::isGroup(classname, properties))
+      {
+        if (const auto groupId =
+              findPersistentId(properties, mdl::EntityPropertyKeys::GroupId))
+        {
+          groupIndices.emplace(*groupId, i);
+        }
+      }
+    }
+  }
+
+  if (unloadedLayers.empty())
+  {
+    return {};
+  }
+
+  // follows the containers of the entity at the given index up to its layer, the depth
+  // is limited in case the groups contain each other, returns nullopt for the default
+  // layer
+  const auto findLayerId = [&](size_t index) -> std::optional<mdl::IdType> {
+    for (size_t depth = 0; depth <= groupIndices.size(); ++depth)
+    {
+      const auto& entityInfo = std::get<MapReader::EntityInfo>(objectInfos[index]);
+      auto nodeIssues = std::vector<NodeIssue>{};
+      const auto containerInfo = extractContainerInfo(entityInfo.properties, nodeIssues);
+      if (!containerInfo)
+      {
+        return std::nullopt;
+      }
+      if (containerInfo->type == ContainerType::Layer)
+      {
+        return containerInfo->id;
+      }
+
+      const auto iGroup = groupIndices.find(containerInfo->id);
+      if (iGroup == groupIndices.end())
+      {
+        return std::nullopt;
+      }
+      index = iGroup->second;
+    }
+    return std::nullopt;
+  };
+
+  // load the layers which share link IDs with other layers
+  auto layersByLinkId =
+    std::unordered_map<std::string, std::vector<std::optional<mdl::IdType>>>{};
+  for (const auto& [groupId, index] : groupIndices)
+  {
+    const auto& entityInfo = std::get<MapReader::EntityInfo>(objectInfos[index]);
+    if (const auto& linkId = findEntityPropertyOrDefault(
+          entityInfo.properties, mdl::EntityPropertyKeys::LinkId);
+        !linkId.empty())
+    {
+      layersByLinkId[linkId].push_back(findLayerId(index));
+    }
+  }
+
+  for (const auto& [linkId, layerIds] : layersByLinkId)
+  {
+    if (std::ranges::adjacent_find(layerIds, std::not_equal_to{}) != layerIds.end())
+    {
+      for (const auto& layerId : layerIds)
+      {
+        if (layerId)
+        {
+          unloadedLayerIds.erase(*layerId);
+        }
+      }
+    }
+  }
+
+  std::erase_if(unloadedLayers, [&](const auto& indexAndLayerId) {
+    if (!unloadedLayerIds.contains(indexAndLayerId.second))
+    {
+      const auto& entityInfo =
+        std::get<MapReader::EntityInfo>(objectInfos[indexAndLayerId.first]);
+      status.info(
+        entityInfo.startLocation,
+        fmt::format(
+          "Loading layer '{}' because it contains groups linked to other layers",
+          findEntityPropertyOrDefault(
+            entityInfo.properties, mdl::EntityPropertyKeys::LayerName)));
+      return true;
+    }
+    return false;
+  });
+
+  if (unloadedLayers.empty())
+  {
+    return {};
+  }
+
+  const auto offsets = SourceOffsets{str};
+  auto result = UnloadedLayerContents{};
+  for (const auto& [index, layerId] : unloadedLayers)
+  {
+    result[layerId] = mdl::UnloadedLayerContent{};
+  }
+
+  auto removed = std::vector<bool>(objectInfos.size(), false);
+  for (size_t i = 0; i < objectInfos.size(); ++i)
+  {
+    std::visit(
+      kdl::overload(
+        [&](const MapReader::EntityInfo& entityInfo) {
+          if (unloadedLayers.contains(i))
+          {
+            return;
+          }
+
+          if (const auto layerId = findLayerId(i);
+              layerId && unloadedLayerIds.contains(*layerId))
+          {
+            if (const auto text = findSourceText(entityInfo, str, offsets))
+            {
+              auto& content = result[*layerId];
+              content.entities.emplace_back(*text);
+              if (const auto groupId = findPersistentId(
+                    entityInfo.properties, mdl::EntityPropertyKeys::GroupId);
+                  groupId && groupIndices.contains(*groupId))
+              {
+                content.maxPersistentId =
+                  std::max(content.maxPersistentId.value_or(0), *groupId);
+              }
+              removed[i] = true;
+            }
+          }
+        },
+        [&](const auto& brushOrPatchInfo) {
+          if (const auto parentIndex = brushOrPatchInfo.parentIndex)
+          {
+            if (removed[*parentIndex])
+            {
+              removed[i] = true;
+            }
+            else if (const auto iLayer = unloadedLayers.find(*parentIndex);
+                     iLayer != unloadedLayers.end())
+            {
+              if (const auto text = findSourceText(brushOrPatchInfo, str, offsets))
+              {
+                result[iLayer->second].brushes.emplace_back(*text);
+                removed[i] = true;
+              }
+            }
+          }
+        }),
+      objectInfos[i]);
+  }
+
+  // compact the object infos and update the parent indices
+  auto newIndices = std::vector<size_t>(objectInfos.size());
+  auto count = size_t(0);
+  for (size_t i = 0; i < objectInfos.size(); ++i)
+  {
+    if (!removed[i])
+    {
+      newIndices[i] = count;
+      auto& objectInfo = objectInfos[count++];
+      if (&objectInfo != &objectInfos[i])
+      {
+        objectInfo = std::move(objectInfos[i]);
+      }
+      std::visit(
+        kdl::overload(
+          [](MapReader::EntityInfo&) {},
+          [&](auto& brushOrPatchInfo) {
+            if (brushOrPatchInfo.parentIndex)
+            {
+              brushOrPatchInfo.parentIndex = newIndices[*brushOrPatchInfo.parentIndex];
+            }
+          }),
+        objectInfo);
+    }
+  }
+  objectInfos.erase(objectInfos.begin() + std::ptrdiff_t(count), objectInfos.end());
+
+  return result;
+}
+
 } // namespace
 
 /**
@@ -922,16 +1393,42 @@ std::unordered_map<mdl::Node*, mdl::Node*> buildNodeToParentMap(
  * Nodes for which the parent node is not known (e.g. when parsing only brushes) are added
  * to a default parent, which is returned from the `onWorldNode` callback.
  */
-void MapReader::createNodes(ParserStatus& status, kdl::task_manager& taskManager)
+void MapReader::createNodes(
+  ParserStatus& status, kdl::task_manager& taskManager, const bool retainObjectInfos)
 {
-  // create nodes from the recorded object infos
-  auto nodeInfos = createNodesFromObjectInfos(
-    m_entityPropertyConfig,
-    std::move(m_objectInfos),
-    m_worldBounds,
-    m_targetMapFormat,
-    status,
-    taskManager);
+  TB_TRACE_SCOPE("MapReader::createNodes");
+
+  // the source text of the layers which are not loaded, retained object infos must be
+  // complete, so all layers are loaded in that case
+  auto unloadedLayerContents = UnloadedLayerContents{};
+
+  // create nodes from the recorded object infos, which are released afterwards
+  auto nodeInfos = [&]() {
+    auto objectInfos = std::move(m_objectInfos);
+    if (!retainObjectInfos)
+    {
+      unloadedLayerContents = extractUnloadedLayers(
+        objectInfos, m_str, [&](const auto& name, const auto hidden) {
+          return shouldLoadLayer(name, hidden);
+        },
+        status);
+    }
+
+    auto result = createNodesFromObjectInfos(
+      m_entityPropertyConfig,
+      objectInfos,
+      m_worldBounds,
+      m_targetMapFormat,
+      retainObjectInfos,
+      status,
+      taskManager);
+
+    if (retainObjectInfos)
+    {
+      onObjectInfos(objectInfos, status);
+    }
+    return result;
+  }();
 
   // call onWorldNode for the first world node, remember the default parent and clear out
   // all other world nodes the brushes belonging to redundant world nodes will be added to
@@ -979,7 +1476,17 @@ void MapReader::createNodes(ParserStatus& status, kdl::task_manager& taskManager
         [&](mdl::WorldNode*) {
           // this should not happen since we already cleared out any world nodes
         },
-        [&](mdl::LayerNode*) { onLayerNode(std::move(node), status); },
+        [&](mdl::LayerNode* layerNode) {
+          const auto layerId = *layerNode->persistentId();
+          if (const auto iContent = unloadedLayerContents.find(layerId);
+              iContent != unloadedLayerContents.end())
+          {
+            auto layer = layerNode->layer();
+            layer.setUnloadedContent(std::move(iContent->second));
+            layerNode->setLayer(std::move(layer));
+          }
+          onLayerNode(std::move(node), status);
+        },
         [&](mdl::GroupNode*) { onNode(parentNode, std::move(node), status); },
         [&](mdl::EntityNode*) { onNode(parentNode, std::move(node), status); },
         [&](mdl::BrushNode*) { onNode(parentNode, std::move(node), status); },
@@ -988,6 +1495,18 @@ void MapReader::createNodes(ParserStatus& status, kdl::task_manager& taskManager
   }
 }
 
+bool MapReader::retainObjectInfos() const
+{
+  return false;
+}
+
+bool MapReader::shouldLoadLayer(const std::string&, bool) const
+{
+  return true;
+}
+
+void MapReader::onObjectInfos(const std::vector<ObjectInfo>&, ParserStatus&) {}
+
 /**
  * Default implementation adds it to the current BrushInfo
  * Overridden in BrushFaceReader (which doesn't use m_brushInfos) to collect the faces
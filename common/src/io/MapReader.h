@@ -30,6 +30,7 @@
 #include "vm/bbox.h"
 
 #include <optional>
+#include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -84,12 +85,23 @@ public: // only public so that helper methods can see these declarations
     std::optional<FileLocation> endLocation;
   };
 
+  struct BrushGeometryInfo
+  {
+    std::vector<vm::vec3d> vertexPositions;
+    std::vector<std::vector<size_t>> faceVertexIndices;
+  };
+
   struct BrushInfo
   {
     std::vector<mdl::BrushFace> faces;
     FileLocation startLocation;
     std::optional<FileLocation> endLocation;
     std::optional<size_t> parentIndex;
+    /**
+     * The precomputed geometry of the brush, e.g. if it was read from a map cache. If
+     * present, the faces are in the order of the geometry's faces.
+     */
+    std::optional<BrushGeometryInfo> geometry;
   };
 
   struct PatchInfo
@@ -106,6 +118,9 @@ public: // only public so that helper methods can see these declarations
   using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
 private:
+  class EntityChunkReader;
+
+  std::string_view m_str;
   mdl::EntityPropertyConfig m_entityPropertyConfig;
   vm::bbox3d m_worldBounds;
 
@@ -123,18 +138,31 @@ protected:
    * @param targetMapFormat the format to convert the created objects to
    * @param entityPropertyConfig the entity property config to use
    * if orphaned
+   * @param startLine the line number of the first character of the given string
+   * @param startColumn the column number of the first character of the given string
    */
   MapReader(
     std::string_view str,
     mdl::MapFormat sourceMapFormat,
     mdl::MapFormat targetMapFormat,
-    mdl::EntityPropertyConfig entityPropertyConfig);
+    mdl::EntityPropertyConfig entityPropertyConfig,
+    size_t startLine = 1,
+    size_t startColumn = 1);
 
   /**
    * Attempts to parse as one or more entities.
    */
   Result<void> readEntities(
     const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager);
+  /**
+   * Creates the nodes from the given object infos instead of parsing them, e.g. if they
+   * were read from a map cache.
+   */
+  void readObjectInfos(
+    std::vector<ObjectInfo> objectInfos,
+    const vm::bbox3d& worldBounds,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
   /**
    * Attempts to parse as one or more brushes without any enclosing entity.
    */
@@ -182,7 +210,33 @@ protected: // implement MapParser interface
     ParserStatus& status) override;
 
 private: // helper methods
-  void createNodes(ParserStatus& status, kdl::task_manager& taskManager);
+  Result<void> parseEntityChunks(ParserStatus& status, kdl::task_manager& taskManager);
+  void createNodes(
+    ParserStatus& status, kdl::task_manager& taskManager, bool retainObjectInfos);
+
+private: // subclassing interface
+  /**
+   * Whether readEntities should retain the parsed object infos and pass them to
+   * onObjectInfos. Retaining the object infos requires copying them when the nodes are
+   * created.
+   */
+  virtual bool retainObjectInfos() const;
+
+  /**
+   * Called by readEntities after the nodes were created if retainObjectInfos returns
+   * true. The infos of the brushes that were created successfully contain the brush
+   * geometry.
+   */
+  virtual void onObjectInfos(
+    const std::vector<ObjectInfo>& objectInfos, ParserStatus& status);
+
+  /**
+   * Whether the objects of the custom layer with the given name and visibility should be
+   * loaded. No nodes are created for the objects of the other layers. Instead, their
+   * source text is stored as the unloaded content of the layer nodes. Ignored if
+   * retainObjectInfos returns true.
+   */
+  virtual bool shouldLoadLayer(const std::string& layerName, bool hidden) const;
 
 private: // subclassing interface - these will be called in the order that nodes should be
          // inserted
@@ -0,0 +1,269 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialCache.h"
+
+#include "io/CacheUtils.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/PathInfo.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <string>
+
+namespace tb::io
+{
+namespace
+{
+namespace MaterialCacheLayout
+{
+constexpr auto Magic = std::string_view{"TBMC"};
+constexpr uint32_t Version = 1;
+constexpr uint8_t NoEmbeddedDefaults = 0;
+constexpr uint8_t Q2EmbeddedDefaults = 1;
+} // namespace MaterialCacheLayout
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& stream, const std::string& str)
+{
+  write(stream, uint32_t(str.size()));
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+void writeHeader(std::ostream& stream, const MaterialCacheKey& key)
+{
+  stream.write(
+    MaterialCacheLayout::Magic.data(), std::streamsize(MaterialCacheLayout::Magic.size()));
+  write(stream, MaterialCacheLayout::Version);
+  writeString(stream, key.sourcePath.generic_string());
+  write(stream, key.size);
+  write(stream, key.hash);
+}
+
+void writeEmbeddedDefaults(
+  std::ostream& stream, const mdl::EmbeddedDefaults& embeddedDefaults)
+{
+  std::visit(
+    kdl::overload(
+      [&](const mdl::NoEmbeddedDefaults&) {
+        write(stream, MaterialCacheLayout::NoEmbeddedDefaults);
+      },
+      [&](const mdl::Q2EmbeddedDefaults& q2Defaults) {
+        write(stream, MaterialCacheLayout::Q2EmbeddedDefaults);
+        write(stream, int32_t(q2Defaults.flags));
+        write(stream, int32_t(q2Defaults.contents));
+        write(stream, int32_t(q2Defaults.value));
+      }),
+    embeddedDefaults);
+}
+
+void writeTexture(std::ostream& stream, const mdl::Texture& texture)
+{
+  const auto& buffers = texture.buffersIfLoaded();
+
+  write(stream, uint32_t(texture.width()));
+  write(stream, uint32_t(texture.height()));
+  for (size_t i = 0; i < 4; ++i)
+  {
+    write(stream, texture.averageColor()[i]);
+  }
+  write(stream, uint32_t(texture.format()));
+  write(stream, uint8_t(texture.mask() == mdl::TextureMask::On ? 1 : 0));
+  writeEmbeddedDefaults(stream, texture.embeddedDefaults());
+
+  write(stream, uint32_t(buffers.size()));
+  for (const auto& buffer : buffers)
+  {
+    write(stream, uint64_t(buffer.size()));
+    stream.write(
+      reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size()));
+  }
+}
+
+bool readHeader(Reader& reader, const MaterialCacheKey& key)
+{
+  if (reader.readString(MaterialCacheLayout::Magic.size()) != MaterialCacheLayout::Magic)
+  {
+    return false;
+  }
+
+  if (reader.readUnsignedInt<uint32_t>() != MaterialCacheLayout::Version)
+  {
+    return false;
+  }
+
+  const auto sourcePathLength = reader.readSize<uint32_t>();
+  return reader.readString(sourcePathLength) == key.sourcePath.generic_string()
+         && reader.read<uint64_t, uint64_t>() == key.size
+         && reader.read<uint64_t, uint64_t>() == key.hash;
+}
+
+std::optional<mdl::EmbeddedDefaults> readEmbeddedDefaults(Reader& reader)
+{
+  switch (reader.readUnsignedChar<uint8_t>())
+  {
+  case MaterialCacheLayout::NoEmbeddedDefaults:
+    return mdl::NoEmbeddedDefaults{};
+  case MaterialCacheLayout::Q2EmbeddedDefaults: {
+    const auto flags = reader.readInt<int32_t>();
+    const auto contents = reader.readInt<int32_t>();
+    const auto value = reader.readInt<int32_t>();
+    return mdl::Q2EmbeddedDefaults{flags, contents, value};
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<mdl::Texture> readTexture(Reader& reader)
+{
+  const auto width = reader.readSize<uint32_t>();
+  const auto height = reader.readSize<uint32_t>();
+  const auto r = reader.readFloat<float>();
+  const auto g = reader.readFloat<float>();
+  const auto b = reader.readFloat<float>();
+  const auto a = reader.readFloat<float>();
+  const auto format = GLenum(reader.readUnsignedInt<uint32_t>());
+  const auto mask =
+    reader.readUnsignedChar<uint8_t>() != 0 ? mdl::TextureMask::On : mdl::TextureMask::Off;
+
+  auto embeddedDefaults = readEmbeddedDefaults(reader);
+  if (!embeddedDefaults)
+  {
+    return std::nullopt;
+  }
+
+  const auto bufferCount = reader.readSize<uint32_t>();
+  auto buffers = mdl::TextureBufferList{};
+  buffers.reserve(bufferCount);
+  for (size_t i = 0; i < bufferCount; ++i)
+  {
+    const auto bufferSize = reader.readSize<uint64_t>();
+    if (bufferSize > reader.size() - reader.position())
+    {
+      return std::nullopt;
+    }
+
+    auto buffer = mdl::TextureBuffer{bufferSize};
+    reader.read(buffer.data(), bufferSize);
+    buffers.push_back(std::move(buffer));
+  }
+
+  if (reader.position() != reader.size())
+  {
+    return std::nullopt;
+  }
+
+  return mdl::Texture{
+    width,
+    height,
+    Color{r, g, b, a},
+    format,
+    mask,
+    std::move(*embeddedDefaults),
+    std::move(buffers)};
+}
+
+} // namespace
+
+MaterialCacheKey makeMaterialCacheKey(
+  const std::filesystem::path& sourcePath, const char* begin, const char* end)
+{
+  return {sourcePath, uint64_t(end - begin), fnv1a(begin, end)};
+}
+
+MaterialCache::MaterialCache(std::filesystem::path directory, const bool compressTextures)
+  : m_directory{std::move(directory)}
+  , m_compressTextures{compressTextures}
+{
+}
+
+const std::filesystem::path& MaterialCache::directory() const
+{
+  return m_directory;
+}
+
+bool MaterialCache::compressTextures() const
+{
+  return m_compressTextures;
+}
+
+std::optional<mdl::Texture> MaterialCache::load(const MaterialCacheKey& key) const
+{
+  const auto path = entryPath(key);
+  if (Disk::pathInfo(path) != PathInfo::File)
+  {
+    return std::nullopt;
+  }
+
+  return Disk::mapFile(path) | kdl::transform([&](auto file) {
+           try
+           {
+             auto reader = file->reader();
+             return readHeader(reader, key) ? readTexture(reader) : std::nullopt;
+           }
+           catch (const ReaderException&)
+           {
+             return std::optional<mdl::Texture>{};
+           }
+         })
+         | kdl::value_or(std::optional<mdl::Texture>{});
+}
+
+Result<void> MaterialCache::store(
+  const MaterialCacheKey& key, const mdl::Texture& texture) const
+{
+  const auto path = entryPath(key);
+
+  return writeCacheEntry(
+           path,
+           [&](auto& stream) {
+             writeHeader(stream, key);
+             writeTexture(stream, texture);
+           })
+         | kdl::transform_error([&](auto e) {
+             return Error{fmt::format("Could not cache {}: {}", key.sourcePath, e.msg)};
+           });
+}
+
+std::filesystem::path MaterialCache::entryPath(const MaterialCacheKey& key) const
+{
+  const auto sourcePath = key.sourcePath.generic_string();
+  auto hash = fnv1a(sourcePath.data(), sourcePath.data() + sourcePath.size());
+  hash = fnv1a(key.size, hash);
+  hash = fnv1a(key.hash, hash);
+  hash = fnv1a(m_compressTextures, hash);
+  return m_directory / fmt::format("{:016x}.tbmc", hash);
+}
+
+} // namespace tb::io
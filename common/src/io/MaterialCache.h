@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace tb::mdl
+{
+class Texture;
+}
+
+namespace tb::io
+{
+
+/**
+ * Identifies the decoded contents of a texture file. Virtual file systems such as WAD
+ * and PK3 archives don't provide modification times for their entries, so a cache entry
+ * is identified by the source path, the file size and a hash of the file contents.
+ */
+struct MaterialCacheKey
+{
+  std::filesystem::path sourcePath;
+  uint64_t size = 0;
+  uint64_t hash = 0;
+};
+
+MaterialCacheKey makeMaterialCacheKey(
+  const std::filesystem::path& sourcePath, const char* begin, const char* end);
+
+/**
+ * Stores decoded textures in a directory on disk so that they don't have to be decoded
+ * again when they are loaded the next time. Optionally, textures are block compressed
+ * before they are stored to reduce the amount of video memory they use.
+ *
+ * Each cache entry is stored in a separate file. Entries are written to a temporary
+ * file first and then moved into place, so it is safe to load and store entries from
+ * multiple threads concurrently.
+ */
+class MaterialCache
+{
+private:
+  std::filesystem::path m_directory;
+  bool m_compressTextures;
+
+public:
+  explicit MaterialCache(std::filesystem::path directory, bool compressTextures = false);
+
+  const std::filesystem::path& directory() const;
+
+  /**
+   * Indicates whether textures should be block compressed before they are stored. Entries
+   * stored with and without compression are kept separately.
+   */
+  bool compressTextures() const;
+
+  /**
+   * Loads the cached texture for the given key. Returns std::nullopt if there is no
+   * cache entry for the given key or if the cache entry cannot be read.
+   */
+  std::optional<mdl::Texture> load(const MaterialCacheKey& key) const;
+
+  /**
+   * Stores the given texture under the given key. The texture must be loaded.
+   */
+  Result<void> store(const MaterialCacheKey& key, const mdl::Texture& texture) const;
+
+private:
+  std::filesystem::path entryPath(const MaterialCacheKey& key) const;
+};
+
+} // namespace tb::io
@@ -34,6 +34,7 @@
 
 #include <fmt/format.h>
 
+#include <memory>
 #include <string>
 
 namespace tb::io
@@ -362,11 +363,10 @@ auto getVertices(const Md2Frame& frame, const std::vector<Md2MeshVertex>& meshVe
   return vertices;
 }
 
-void buildFrame(
-  mdl::EntityModelData& model,
-  mdl::EntityModelSurface& surface,
+auto buildFrameMesh(
   const Md2Frame& frame,
-  const std::vector<Md2Mesh>& meshes)
+  const std::vector<Md2Mesh>& meshes,
+  render::IndexRangeMap& indices)
 {
   size_t vertexCount = 0;
   auto size = render::IndexRangeMap::Size{};
@@ -376,20 +376,13 @@ void buildFrame(
     size.inc(md2Mesh.type);
   }
 
-  auto bounds = vm::bbox3f::builder{};
-
   auto builder =
     render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{vertexCount, size};
   for (const auto& md2Mesh : meshes)
   {
     if (!md2Mesh.vertices.empty())
     {
-      vertexCount += md2Mesh.vertices.size();
       const auto vertices = getVertices(frame, md2Mesh.vertices);
-
-      bounds.add(
-        std::begin(vertices), std::end(vertices), render::GetVertexComponent<0>());
-
       if (md2Mesh.type == render::PrimType::TriangleFan)
       {
         builder.addTriangleFan(vertices);
@@ -401,9 +394,47 @@ void buildFrame(
     }
   }
 
-  auto& modelFrame = model.addFrame(frame.name, bounds.bounds());
-  surface.addMesh(
-    modelFrame, std::move(builder.vertices()), std::move(builder.indices()));
+  indices = std::move(builder.indices());
+  return std::move(builder.vertices());
+}
+
+auto getBounds(const Md2Frame& frame, const std::vector<Md2Mesh>& meshes)
+{
+  auto bounds = vm::bbox3f::builder{};
+  for (const auto& md2Mesh : meshes)
+  {
+    for (const auto& md2MeshVertex : md2Mesh.vertices)
+    {
+      bounds.add(frame.vertex(md2MeshVertex.vertexIndex));
+    }
+  }
+  return bounds.bounds();
+}
+
+void buildFrame(
+  mdl::EntityModelData& model,
+  mdl::EntityModelSurface& surface,
+  Md2Frame frame,
+  std::shared_ptr<const std::vector<Md2Mesh>> meshes)
+{
+  auto& modelFrame = model.addFrame(frame.name, getBounds(frame, *meshes));
+
+  // Most entities only display the first frame, so the meshes of the other frames are
+  // only decoded when they are needed.
+  if (modelFrame.index() == 0)
+  {
+    auto indices = render::IndexRangeMap{};
+    auto vertices = buildFrameMesh(frame, *meshes, indices);
+    surface.addMesh(modelFrame, std::move(vertices), std::move(indices));
+  }
+  else
+  {
+    surface.addDeferredMesh(
+      modelFrame,
+      [frame = std::move(frame), meshes = std::move(meshes)](auto& indices) {
+        return buildFrameMesh(frame, *meshes, indices);
+      });
+  }
 }
 
 } // namespace
@@ -478,17 +509,17 @@ Result<mdl::EntityModelData> Md2Loader::load(Logger& logger)
 
     const auto frameSize =
       6 * sizeof(float) + Md2Layout::FrameNameLength + vertexCount * 4;
-    const auto meshes = parseMeshes(
-      reader.subReaderFromBegin(commandOffset, commandCount * 4), commandCount);
+    const auto meshes = std::make_shared<const std::vector<Md2Mesh>>(parseMeshes(
+      reader.subReaderFromBegin(commandOffset, commandCount * 4), commandCount));
 
     for (size_t i = 0; i < frameCount; ++i)
     {
-      const auto frame = parseFrame(
+      auto frame = parseFrame(
         reader.subReaderFromBegin(frameOffset + i * frameSize, frameSize),
         i,
         vertexCount);
 
-      buildFrame(data, surface, frame, meshes);
+      buildFrame(data, surface, std::move(frame), meshes);
     }
 
     return data;
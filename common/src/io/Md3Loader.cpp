@@ -36,6 +36,7 @@
 
 #include <fmt/core.h>
 
+#include <memory>
 #include <ranges>
 #include <string>
 
@@ -68,6 +69,15 @@ struct Md3Triangle
   size_t i1, i2, i3;
 };
 
+/**
+ * The parts of a surface that are shared by all frames.
+ */
+struct Md3SurfaceData
+{
+  std::vector<Md3Triangle> triangles;
+  std::vector<vm::vec2f> uvCoords;
+};
+
 
 auto parseShaders(Reader reader, const size_t shaderCount)
 {
@@ -213,16 +223,17 @@ auto parseTriangles(Reader reader, const size_t triangleCount)
   return triangles;
 }
 
-void buildFrameSurface(
-  mdl::EntityModelFrame& frame,
-  mdl::EntityModelSurface& surface,
-  const std::vector<Md3Triangle>& triangles,
-  const std::vector<mdl::EntityModelVertex>& vertices)
+auto buildFrameMesh(
+  const Md3SurfaceData& surfaceData,
+  const std::vector<vm::vec3f>& positions,
+  render::IndexRangeMap& indices)
 {
   using Vertex = mdl::EntityModelVertex;
 
-  auto rangeMap =
-    render::IndexRangeMap{render::PrimType::Triangles, 0, 3 * triangles.size()};
+  const auto& triangles = surfaceData.triangles;
+  const auto vertices = buildVertices(positions, surfaceData.uvCoords);
+
+  indices = render::IndexRangeMap{render::PrimType::Triangles, 0, 3 * triangles.size()};
   auto frameVertices = std::vector<Vertex>{};
   frameVertices.reserve(3 * triangles.size());
 
@@ -244,11 +255,39 @@ void buildFrameSurface(
     frameVertices.push_back(v3);
   }
 
-  surface.addMesh(frame, std::move(frameVertices), std::move(rangeMap));
+  return frameVertices;
+}
+
+void buildFrameSurface(
+  mdl::EntityModelFrame& frame,
+  mdl::EntityModelSurface& surface,
+  std::shared_ptr<const Md3SurfaceData> surfaceData,
+  std::vector<vm::vec3f> positions)
+{
+  // Most entities only display the first frame, so the meshes of the other frames are
+  // only decoded when they are needed.
+  if (frame.index() == 0)
+  {
+    auto indices = render::IndexRangeMap{};
+    auto vertices = buildFrameMesh(*surfaceData, positions, indices);
+    surface.addMesh(frame, std::move(vertices), std::move(indices));
+  }
+  else
+  {
+    surface.addDeferredMesh(
+      frame,
+      [surfaceData = std::move(surfaceData),
+       positions = std::move(positions)](auto& indices) {
+        return buildFrameMesh(*surfaceData, positions, indices);
+      });
+  }
 }
 
 Result<void> parseFrameSurfaces(
-  Reader reader, mdl::EntityModelFrame& frame, mdl::EntityModelData& model)
+  Reader reader,
+  mdl::EntityModelFrame& frame,
+  mdl::EntityModelData& model,
+  std::vector<std::shared_ptr<const Md3SurfaceData>>& surfaceData)
 {
   for (size_t i = 0; i < model.surfaceCount(); ++i)
   {
@@ -277,20 +316,25 @@ Result<void> parseFrameSurfaces(
       const auto frameVertexLength = vertexCount * Md3Layout::VertexLength;
       const auto frameVertexOffset = vertexOffset + frame.index() * frameVertexLength;
 
-      const auto vertexPositions = parseVertexPositions(
+      auto vertexPositions = parseVertexPositions(
         reader.subReaderFromBegin(frameVertexOffset, frameVertexLength), vertexCount);
-      const auto uvCoords = parseUV(
-        reader.subReaderFromBegin(uvCoordOffset, vertexCount * Md3Layout::UVLength),
-        vertexCount);
-      const auto vertices = buildVertices(vertexPositions, uvCoords);
 
-      const auto triangles = parseTriangles(
-        reader.subReaderFromBegin(
-          triangleOffset, triangleCount * Md3Layout::TriangleLength),
-        triangleCount);
+      if (!surfaceData[i])
+      {
+        auto uvCoords = parseUV(
+          reader.subReaderFromBegin(uvCoordOffset, vertexCount * Md3Layout::UVLength),
+          vertexCount);
+        auto triangles = parseTriangles(
+          reader.subReaderFromBegin(
+            triangleOffset, triangleCount * Md3Layout::TriangleLength),
+          triangleCount);
+
+        surfaceData[i] = std::make_shared<const Md3SurfaceData>(
+          Md3SurfaceData{std::move(triangles), std::move(uvCoords)});
+      }
 
       auto& surface = model.surface(i);
-      buildFrameSurface(frame, surface, triangles, vertices);
+      buildFrameSurface(frame, surface, surfaceData[i], std::move(vertexPositions));
     }
 
     reader = reader.subReaderFromBegin(endOffset);
@@ -362,6 +406,8 @@ Result<mdl::EntityModelData> Md3Loader::load(Logger&)
              data,
              m_loadMaterial)
            | kdl::and_then([&]() {
+               auto surfaceData =
+                 std::vector<std::shared_ptr<const Md3SurfaceData>>(data.surfaceCount());
                return kdl::vec_transform(
                         std::views::iota(0u, frameCount),
                         [&](const auto i) {
@@ -371,7 +417,10 @@ Result<mdl::EntityModelData> Md3Loader::load(Logger&)
                               Md3Layout::FrameLength),
                             data);
                           return parseFrameSurfaces(
-                            reader.subReaderFromBegin(surfaceOffset), frame, data);
+                            reader.subReaderFromBegin(surfaceOffset),
+                            frame,
+                            data,
+                            surfaceData);
                         })
                       | kdl::fold | kdl::transform([&]() { return std::move(data); });
              });
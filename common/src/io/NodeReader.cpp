@@ -27,8 +27,11 @@
 #include "mdl/LinkedGroupUtils.h"
 #include "mdl/WorldNode.h"
 
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
+#include <fmt/format.h>
+
 #include <string>
 #include <vector>
 
@@ -66,7 +69,7 @@ Result<std::vector<mdl::Node*>> NodeReader::read(
         result.is_success())
     {
       return std::move(result) | kdl::transform([&](auto nodes) {
-               for (const auto& error : mdl::initializeLinkIds(nodes))
+               for (const auto& error : mdl::initializeLinkIds(nodes, taskManager))
                {
                  status.error("Could not restore linked groups: " + error.msg);
                }
@@ -79,6 +82,58 @@ Result<std::vector<mdl::Node*>> NodeReader::read(
   return Error{"Could not parse map data"};
 }
 
+Result<std::vector<mdl::Node*>> NodeReader::readUnloadedLayer(
+  const mdl::UnloadedLayerContent& unloadedContent,
+  const mdl::IdType layerId,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  const auto str = fmt::format(
+    R"({{
+"{}" "{}"
+"{}" "{}"
+"{}" "Unloaded Layer"
+"{}" "{}"
+{}
+}}
+{}
+)",
+    mdl::EntityPropertyKeys::Classname,
+    mdl::EntityPropertyValues::LayerClassname,
+    mdl::EntityPropertyKeys::GroupType,
+    mdl::EntityPropertyValues::GroupTypeLayer,
+    mdl::EntityPropertyKeys::LayerName,
+    mdl::EntityPropertyKeys::LayerId,
+    layerId,
+    kdl::str_join(unloadedContent.brushes, "\n"),
+    kdl::str_join(unloadedContent.entities, "\n"));
+
+  return read(str, mapFormat, worldBounds, entityPropertyConfig, status, taskManager)
+         | kdl::transform([](auto nodes) {
+             // replace the recreated layer by its children
+             auto result = std::vector<mdl::Node*>{};
+             for (auto* node : nodes)
+             {
+               if (auto* layerNode = dynamic_cast<mdl::LayerNode*>(node))
+               {
+                 for (auto& child : layerNode->replaceChildren({}))
+                 {
+                   result.push_back(child.release());
+                 }
+                 delete layerNode;
+               }
+               else
+               {
+                 result.push_back(node);
+               }
+             }
+             return result;
+           });
+}
+
 /**
  * Attempts to parse the string as one or more entities (in the given source format),
  * and if that fails, as one or more brushes.
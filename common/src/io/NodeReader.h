@@ -21,6 +21,7 @@
 
 #include "Result.h"
 #include "io/MapReader.h"
+#include "mdl/IdType.h"
 
 #include <string>
 #include <string_view>
@@ -31,6 +32,11 @@ namespace kdl
 class task_manager;
 }
 
+namespace tb::mdl
+{
+struct UnloadedLayerContent;
+}
+
 namespace tb::io
 {
 class ParserStatus;
@@ -67,6 +73,22 @@ public:
     ParserStatus& status,
     kdl::task_manager& taskManager);
 
+  /**
+   * Reads the objects of a layer that was not loaded when its map was opened. The layer
+   * entity is recreated around the brushes of the layer, so that the entities which refer
+   * to the layer by its ID are added to it.
+   *
+   * @returns the objects of the layer; caller is responsible for freeing them.
+   */
+  static Result<std::vector<mdl::Node*>> readUnloadedLayer(
+    const mdl::UnloadedLayerContent& unloadedContent,
+    mdl::IdType layerId,
+    mdl::MapFormat mapFormat,
+    const vm::bbox3d& worldBounds,
+    const mdl::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
+
 private:
   static Result<std::vector<mdl::Node*>> readAsFormat(
     mdl::MapFormat sourceMapFormat,
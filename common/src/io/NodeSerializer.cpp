@@ -143,7 +143,25 @@ void NodeSerializer::customLayer(const mdl::LayerNode* layer)
 {
   if (!(m_exporting && layer->layer().omitFromExport()))
   {
-    entity(layer, layerProperties(layer), {}, layer);
+    beginEntity(layer, layerProperties(layer), {});
+
+    layer->visitChildren(kdl::overload(
+      [](const mdl::WorldNode*) {},
+      [](const mdl::LayerNode*) {},
+      [](const mdl::GroupNode*) {},
+      [](const mdl::EntityNode*) {},
+      [&](const mdl::BrushNode* b) { brush(b); },
+      [&](const mdl::PatchNode* p) { patch(p); }));
+
+    if (const auto& unloadedContent = layer->layer().unloadedContent())
+    {
+      for (const auto& str : unloadedContent->brushes)
+      {
+        unloadedBrush(str);
+      }
+    }
+
+    endEntity(layer);
   }
 }
 
@@ -183,6 +201,12 @@ void NodeSerializer::entity(
   endEntity(node);
 }
 
+void NodeSerializer::unloadedEntity(const std::string_view str)
+{
+  doUnloadedEntity(str);
+  ++m_entityNo;
+}
+
 void NodeSerializer::beginEntity(
   const mdl::Node* node,
   const std::vector<mdl::EntityProperty>& properties,
@@ -238,6 +262,12 @@ void NodeSerializer::patch(const mdl::PatchNode* patchNode)
   ++m_brushNo;
 }
 
+void NodeSerializer::unloadedBrush(const std::string_view str)
+{
+  doUnloadedBrush(str);
+  ++m_brushNo;
+}
+
 void NodeSerializer::brushFaces(const std::vector<mdl::BrushFace>& faces)
 {
   for (const auto& face : faces)
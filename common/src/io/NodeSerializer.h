@@ -20,6 +20,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace kdl
@@ -112,6 +113,11 @@ public:
     const std::vector<mdl::EntityProperty>& parentProperties,
     const std::vector<mdl::BrushNode*>& entityBrushes);
 
+  /**
+   * Writes the source text of an entity of a layer that was not loaded.
+   */
+  void unloadedEntity(std::string_view str);
+
 private:
   void beginEntity(
     const mdl::Node* node,
@@ -128,6 +134,8 @@ private:
 
   void patch(const mdl::PatchNode* patchNode);
 
+  void unloadedBrush(std::string_view str);
+
 public:
   void brushFaces(const std::vector<mdl::BrushFace>& faces);
 
@@ -157,6 +165,9 @@ private:
   virtual void doBrushFace(const mdl::BrushFace& face) = 0;
 
   virtual void doPatch(const mdl::PatchNode* patchNode) = 0;
+
+  virtual void doUnloadedEntity(std::string_view str) = 0;
+  virtual void doUnloadedBrush(std::string_view str) = 0;
 };
 } // namespace io
 } // namespace tb
@@ -19,6 +19,7 @@
 
 #include "NodeWriter.h"
 
+#include "Trace.h"
 #include "io/MapFileSerializer.h"
 #include "io/NodeSerializer.h"
 #include "mdl/BrushNode.h"
@@ -108,6 +109,8 @@ void NodeWriter::setExporting(const bool exporting)
 
 void NodeWriter::writeMap(kdl::task_manager& taskManager)
 {
+  TB_TRACE_SCOPE("NodeWriter::writeMap");
+
   m_serializer->beginFile({&m_world}, taskManager);
   writeDefaultLayer();
   writeCustomLayers();
@@ -139,6 +142,14 @@ void NodeWriter::writeCustomLayer(const mdl::LayerNode* layerNode)
   {
     m_serializer->customLayer(layerNode);
     doWriteNodes(*m_serializer, layerNode->children(), layerNode);
+
+    if (const auto& unloadedContent = layerNode->layer().unloadedContent())
+    {
+      for (const auto& str : unloadedContent->entities)
+      {
+        m_serializer->unloadedEntity(str);
+      }
+    }
   }
 }
 
@@ -185,7 +196,8 @@ void NodeWriter::writeNodes(
 
 void NodeWriter::writeWorldBrushes(const std::vector<mdl::BrushNode*>& brushes)
 {
-  if (!brushes.empty())
+  // compilers require a worldspawn entity, so always write it when exporting
+  if (!brushes.empty() || m_serializer->exporting())
   {
     m_serializer->entity(&m_world, m_world.entity().properties(), {}, brushes);
   }
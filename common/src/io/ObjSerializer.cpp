@@ -27,107 +27,143 @@
 #include "mdl/PatchNode.h"
 #include "mdl/Polyhedron.h"
 
-#include "kdl/overload.h"
+#include "kdl/task_manager.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <utility>
 
 namespace tb::io
 {
+namespace
+{
+
+/**
+ * The number of objects that are formatted in parallel before they are written to the
+ * OBJ file. Bounds the memory used for formatted output.
+ */
+constexpr auto ObjectChunkSize = size_t(1024);
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex)
+struct Vertex
 {
-  str << " " << (vertex.vertex + 1u) << "/" << (vertex.uvCoords + 1u) << "/"
-      << (vertex.normal + 1u);
-  return str;
-}
+  vm::vec3d position;
+  vm::vec2f uvCoords;
+  vm::vec3d normal;
+};
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object)
+struct Face
 {
-  str << "o entity" << object.entityNo << "_brush" << object.brushNo << "\n";
-  for (const auto& face : object.faces)
+  std::vector<Vertex> vertices;
+  // the material is written before the face if set
+  const std::string* materialName;
+};
+
+struct Mesh
+{
+  std::string name;
+  std::vector<Face> faces;
+};
+
+Mesh makeMesh(
+  const mdl::BrushNode& brushNode, const size_t entityNo, const size_t brushNo)
+{
+  const auto& brush = brushNode.brush();
+
+  auto mesh = Mesh{fmt::format("entity{}_brush{}", entityNo, brushNo), {}};
+  mesh.faces.reserve(brush.faceCount());
+
+  for (const auto& face : brush.faces())
   {
-    str << "usemtl " << face.materialName << "\n";
-    str << "f";
-    for (const auto& vertex : face.verts)
+    const auto& normal = face.boundary().normal;
+
+    auto vertices = std::vector<Vertex>{};
+    vertices.reserve(face.vertexCount());
+    for (const auto* vertex : face.vertices())
     {
-      str << " " << vertex;
+      const auto& position = vertex->position();
+      vertices.push_back(Vertex{position, face.uvCoords(position), normal});
     }
-    str << "\n";
+
+    mesh.faces.push_back(Face{std::move(vertices), &face.attributes().materialName()});
   }
-  return str;
+
+  return mesh;
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object)
+Mesh makeMesh(
+  const mdl::PatchNode& patchNode, const size_t entityNo, const size_t patchNo)
 {
-  str << "o entity" << object.entityNo << "_patch" << object.patchNo << "\n";
-  str << "usemtl " << object.materialName << "\n";
-  for (const auto& quad : object.quads)
+  const auto& patchGrid = patchNode.grid();
+
+  auto mesh = Mesh{fmt::format("entity{}_patch{}", entityNo, patchNo), {}};
+  mesh.faces.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+  const auto makeVertex = [&](const auto& p) {
+    return Vertex{p.position, vm::vec2f{p.uvCoords}, p.normal};
+  };
+
+  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
   {
-    str << "f";
-    for (const auto& vertex : quad.verts)
+    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
     {
-      str << " " << vertex;
+      // counter clockwise order
+      mesh.faces.push_back(Face{
+        {
+          makeVertex(patchGrid.point(row, col)),
+          makeVertex(patchGrid.point(row + 1u, col)),
+          makeVertex(patchGrid.point(row + 1u, col + 1u)),
+          makeVertex(patchGrid.point(row, col + 1u)),
+        },
+        mesh.faces.empty() ? &patchNode.patch().materialName() : nullptr,
+      });
     }
-    str << "\n";
   }
-  return str;
-}
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object)
-{
-  std::visit(
-    kdl::overload(
-      [&](const ObjSerializer::BrushObject& brushObject) { str << brushObject; },
-      [&](const ObjSerializer::PatchObject& patchObject) { str << patchObject; }),
-    object);
-  return str;
-}
-
-ObjSerializer::ObjSerializer(
-  std::ostream& objStream,
-  std::ostream& mtlStream,
-  std::string mtlFilename,
-  io::ObjExportOptions options)
-  : m_objStream{objStream}
-  , m_mtlStream{mtlStream}
-  , m_mtlFilename{std::move(mtlFilename)}
-  , m_options{std::move(options)}
-{
-  ensure(m_objStream.good(), "obj stream is good");
-  ensure(m_mtlStream.good(), "mtl stream is good");
+  return mesh;
 }
 
-void ObjSerializer::doBeginFile(
-  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager&)
+Mesh makeMesh(const ObjSerializer::Object& object)
 {
+  return std::visit(
+    [&](const auto* node) { return makeMesh(*node, object.entityNo, object.objectNo); },
+    object.node);
 }
 
-static void writeMtlFile(
-  std::ostream& str,
+/**
+ * Calls f for every object in the given chunk in parallel and passes the results to
+ * write in the order of the objects.
+ */
+template <typename F, typename W>
+void forEachChunk(
+  kdl::task_manager& taskManager,
   const std::vector<ObjSerializer::Object>& objects,
-  const io::ObjExportOptions& options)
+  const F& f,
+  const W& write)
 {
-  auto usedMaterials = std::map<std::string, const mdl::Material*>{};
+  using Result = std::invoke_result_t<F, size_t>;
 
-  for (const auto& object : objects)
+  for (size_t first = 0; first < objects.size(); first += ObjectChunkSize)
   {
-    std::visit(
-      kdl::overload(
-        [&](const ObjSerializer::BrushObject& brushObject) {
-          for (const auto& face : brushObject.faces)
-          {
-            usedMaterials[face.materialName] = face.material;
-          }
-        },
-        [&](const ObjSerializer::PatchObject& patchObject) {
-          usedMaterials[patchObject.materialName] = patchObject.material;
-        }),
-      object);
+    const auto count = std::min(ObjectChunkSize, objects.size() - first);
+
+    auto results = std::vector<Result>(count);
+    taskManager.parallel_for(count, [&](const size_t i) { results[i] = f(first + i); });
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      write(first + i, std::move(results[i]));
+    }
   }
+}
 
+void writeMtlFile(
+  std::ostream& str,
+  const std::map<std::string, const mdl::Material*>& usedMaterials,
+  const io::ObjExportOptions& options)
+{
   const auto basePath = options.exportPath.parent_path();
   for (const auto& [materialName, material] : usedMaterials)
   {
@@ -153,18 +189,7 @@ static void writeMtlFile(
   }
 }
 
-static void writeVertices(std::ostream& str, const std::vector<vm::vec3d>& vertices)
-{
-  str << "# vertices\n";
-  for (const auto& elem : vertices)
-  {
-    // no idea why I have to switch Y and Z
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
-  }
-}
-
-static void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoords)
+void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoords)
 {
   str << "# texture coordinates\n";
   for (const auto& elem : uvCoords)
@@ -176,7 +201,7 @@ static void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoo
   }
 }
 
-static void writeNormals(std::ostream& str, const std::vector<vm::vec3d>& normals)
+void writeNormals(std::ostream& str, const std::vector<vm::vec3d>& normals)
 {
   str << "# normals\n";
   for (const auto& elem : normals)
@@ -191,40 +216,141 @@ static void writeNormals(std::ostream& str, const std::vector<vm::vec3d>& normal
   }
 }
 
-static void writeObjFile(
-  std::ostream& str,
-  const std::string mtlFilename,
-  const std::vector<vm::vec3d>& vertices,
-  const std::vector<vm::vec2f>& uvCoords,
-  const std::vector<vm::vec3d>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
+} // namespace
+
+ObjSerializer::ObjSerializer(
+  std::ostream& objStream,
+  std::ostream& mtlStream,
+  std::string mtlFilename,
+  io::ObjExportOptions options)
+  : m_objStream{objStream}
+  , m_mtlStream{mtlStream}
+  , m_mtlFilename{std::move(mtlFilename)}
+  , m_options{std::move(options)}
 {
+  ensure(m_objStream.good(), "obj stream is good");
+  ensure(m_mtlStream.good(), "mtl stream is good");
+}
+
+void ObjSerializer::doBeginFile(
+  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager& taskManager)
+{
+  m_taskManager = &taskManager;
+}
 
-  str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
-  str << "\n";
-  writeUVCoords(str, uvCoords);
-  str << "\n";
-  writeNormals(str, normals);
-  str << "\n";
+void ObjSerializer::doEndFile()
+{
+  writeMtlFile(m_mtlStream, m_usedMaterials, m_options);
+
+  m_objStream << "mtllib " << m_mtlFilename << "\n";
+  const auto vertexOffsets = writeVertices();
+  m_objStream << "\n";
+  writeUVCoords(m_objStream, m_uvCoords.list());
+  m_objStream << "\n";
+  writeNormals(m_objStream, m_normals.list());
+  m_objStream << "\n";
+  writeObjects(vertexOffsets);
+}
 
-  for (const auto& object : objects)
+std::vector<size_t> ObjSerializer::writeVertices()
+{
+  struct ObjectVertices
   {
-    str << object;
-    str << "\n";
-  }
+    std::string positions;
+    size_t positionCount = 0;
+    std::vector<vm::vec2f> uvCoords;
+    std::vector<vm::vec3d> normals;
+  };
+
+  auto vertexOffsets = std::vector<size_t>{};
+  vertexOffsets.reserve(m_objects.size());
+  auto vertexCount = size_t(0);
+
+  m_objStream << "# vertices\n";
+  forEachChunk(
+    *m_taskManager,
+    m_objects,
+    [&](const size_t i) {
+      const auto mesh = makeMesh(m_objects[i]);
+
+      // vertex positions are only shared within an object
+      auto positions = IndexMap<vm::vec3d>{};
+      auto result = ObjectVertices{};
+      for (const auto& face : mesh.faces)
+      {
+        for (const auto& vertex : face.vertices)
+        {
+          const auto positionIndex = positions.index(vertex.position);
+          if (positionIndex == result.positionCount)
+          {
+            // no idea why I have to switch Y and Z
+            const auto& p = vertex.position;
+            fmt::format_to(
+              std::back_inserter(result.positions),
+              "v {} {} {}\n",
+              p.x(),
+              p.z(),
+              -p.y());
+            ++result.positionCount;
+          }
+          result.uvCoords.push_back(vertex.uvCoords);
+          result.normals.push_back(vertex.normal);
+        }
+      }
+      return result;
+    },
+    [&](size_t, ObjectVertices objectVertices) {
+      m_objStream << objectVertices.positions;
+
+      vertexOffsets.push_back(vertexCount);
+      vertexCount += objectVertices.positionCount;
+
+      for (const auto& uvCoords : objectVertices.uvCoords)
+      {
+        m_uvCoords.index(uvCoords);
+      }
+      for (const auto& normal : objectVertices.normals)
+      {
+        m_normals.index(normal);
+      }
+    });
+
+  return vertexOffsets;
 }
 
-void ObjSerializer::doEndFile()
+void ObjSerializer::writeObjects(const std::vector<size_t>& vertexOffsets)
 {
-  writeMtlFile(m_mtlStream, m_objects, m_options);
-  writeObjFile(
-    m_objStream,
-    m_mtlFilename,
-    m_vertices.list(),
-    m_uvCoords.list(),
-    m_normals.list(),
-    m_objects);
+  forEachChunk(
+    *m_taskManager,
+    m_objects,
+    [&](const size_t i) {
+      const auto mesh = makeMesh(m_objects[i]);
+      const auto vertexOffset = vertexOffsets[i];
+
+      auto positions = IndexMap<vm::vec3d>{};
+      auto result = fmt::format("o {}\n", mesh.name);
+      for (const auto& face : mesh.faces)
+      {
+        if (face.materialName)
+        {
+          fmt::format_to(std::back_inserter(result), "usemtl {}\n", *face.materialName);
+        }
+        result += "f";
+        for (const auto& vertex : face.vertices)
+        {
+          fmt::format_to(
+            std::back_inserter(result),
+            "  {}/{}/{}",
+            vertexOffset + positions.index(vertex.position) + 1u,
+            m_uvCoords.indexOf(vertex.uvCoords) + 1u,
+            m_normals.indexOf(vertex.normal) + 1u);
+        }
+        result += "\n";
+      }
+      result += "\n";
+      return result;
+    },
+    [&](size_t, const std::string& object) { m_objStream << object; });
 }
 
 void ObjSerializer::doBeginEntity(const mdl::Node*) {}
@@ -233,79 +359,28 @@ void ObjSerializer::doEntityProperty(const mdl::EntityProperty&) {}
 
 void ObjSerializer::doBrush(const mdl::BrushNode* brush)
 {
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
+  m_objects.push_back(Object{brush, entityNo(), brushNo()});
 
   for (const auto& face : brush->brush().faces())
   {
     doBrushFace(face);
   }
-
-  m_objects.emplace_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
 }
 
 void ObjSerializer::doBrushFace(const mdl::BrushFace& face)
 {
-  const auto& normal = face.boundary().normal;
-  const auto normalIndex = m_normals.index(normal);
-
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
-
-  for (const auto* vertex : face.vertices())
-  {
-    const auto& position = vertex->position();
-    const auto uvCoords = face.uvCoords(position);
-
-    const auto vertexIndex = m_vertices.index(position);
-    const auto uvCoordsIndex = m_uvCoords.index(uvCoords);
-
-    indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
-  }
-
-  m_currentBrush->faces.emplace_back(BrushFace{
-    std::move(indexedVertices), face.attributes().materialName(), face.material()});
+  m_usedMaterials[face.attributes().materialName()] = face.material();
 }
 
 void ObjSerializer::doPatch(const mdl::PatchNode* patchNode)
 {
   const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.materialName(), patch.material()};
-
-  const auto& patchGrid = patchNode->grid();
-  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  const auto makeIndexedVertex = [&](const auto& p) {
-    const auto positionIndex = m_vertices.index(p.position);
-    const auto uvCoordsIndex = m_uvCoords.index(vm::vec2f{p.uvCoords});
-    const auto normalIndex = m_normals.index(p.normal);
-
-    return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
-  };
+  m_objects.push_back(Object{patchNode, entityNo(), brushNo()});
+  m_usedMaterials[patch.materialName()] = patch.material();
+}
 
-  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
-  {
-    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
-    {
-      // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
-        makeIndexedVertex(patchGrid.point(row, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-        makeIndexedVertex(patchGrid.point(row, col + 1u)),
-      }});
-    }
-  }
+void ObjSerializer::doUnloadedEntity(const std::string_view) {}
 
-  m_objects.emplace_back(std::move(patchObject));
-}
+void ObjSerializer::doUnloadedBrush(const std::string_view) {}
 
 } // namespace tb::io
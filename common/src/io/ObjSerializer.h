@@ -24,10 +24,8 @@
 
 #include "vm/vec.h"
 
-#include <array>
 #include <iosfwd>
 #include <map>
-#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -39,11 +37,21 @@ class BrushFace;
 class EntityProperty;
 class Material;
 class Node;
+class PatchNode;
 } // namespace tb::mdl
 
 namespace tb::io
 {
 
+/**
+ * Writes brushes and patches to an OBJ file and the materials they use to an MTL file.
+ *
+ * The nodes are only recorded while the map is traversed. When the file ends, the OBJ
+ * file is written in two passes over the recorded nodes: the first pass writes the vertex
+ * positions, the second pass writes the objects. Each pass formats chunks of objects in
+ * parallel and streams them to the OBJ file in order, so that only the texture
+ * coordinates and normals, which are shared by all objects, are kept in memory.
+ */
 class ObjSerializer : public NodeSerializer
 {
 public:
@@ -68,6 +76,11 @@ public:
       return index;
     }
 
+    /**
+     * Returns the index of a value that was inserted before. Can be called concurrently.
+     */
+    size_t indexOf(const V& v) const { return m_map.at(v); }
+
     /**
      * Values inserted after this is called will not reuse indices from before this
      * is called.
@@ -75,62 +88,25 @@ public:
     void clearIndices() { m_map.clear(); }
   };
 
-  struct IndexedVertex
-  {
-    size_t vertex;
-    size_t uvCoords;
-    size_t normal;
-  };
-
-  struct BrushFace
-  {
-    std::vector<IndexedVertex> verts;
-    std::string materialName;
-    const mdl::Material* material;
-  };
-
-  struct BrushObject
+  struct Object
   {
+    std::variant<const mdl::BrushNode*, const mdl::PatchNode*> node;
     size_t entityNo;
-    size_t brushNo;
-    std::vector<BrushFace> faces;
+    size_t objectNo;
   };
 
-  struct PatchQuad
-  {
-    std::array<IndexedVertex, 4u> verts;
-  };
-
-  struct PatchObject
-  {
-    size_t entityNo;
-    size_t patchNo;
-    std::vector<PatchQuad> quads;
-    std::string materialName;
-    const mdl::Material* material;
-  };
-
-  using Object = std::variant<BrushObject, PatchObject>;
-
-  friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
-  friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
-  friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const PatchQuad& quad);
-  friend std::ostream& operator<<(std::ostream& str, const PatchObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const Object& object);
-
 private:
   std::ostream& m_objStream;
   std::ostream& m_mtlStream;
   std::string m_mtlFilename;
   ObjExportOptions m_options;
+  kdl::task_manager* m_taskManager = nullptr;
 
-  IndexMap<vm::vec3d> m_vertices;
   IndexMap<vm::vec2f> m_uvCoords;
   IndexMap<vm::vec3d> m_normals;
 
-  std::optional<BrushObject> m_currentBrush;
   std::vector<Object> m_objects;
+  std::map<std::string, const mdl::Material*> m_usedMaterials;
 
 public:
   ObjSerializer(
@@ -153,6 +129,17 @@ private:
   void doBrushFace(const mdl::BrushFace& face) override;
 
   void doPatch(const mdl::PatchNode* patchNode) override;
+
+  // the objects of unloaded layers are not exported, since they were not parsed
+  void doUnloadedEntity(std::string_view str) override;
+  void doUnloadedBrush(std::string_view str) override;
+
+  /**
+   * Writes the vertex positions of all objects and indexes their texture coordinates and
+   * normals. Returns the index of the first vertex position of each object.
+   */
+  std::vector<size_t> writeVertices();
+  void writeObjects(const std::vector<size_t>& vertexOffsets);
 };
 
 } // namespace tb::io
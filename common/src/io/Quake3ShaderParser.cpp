@@ -207,7 +207,7 @@ void Quake3ShaderParser::parseTexture(
 {
   const auto token =
     m_tokenizer.skipAndNextToken(Quake3ShaderToken::Eol, Quake3ShaderToken::String);
-  const auto pathStr = token.data();
+  const auto pathStr = token.view();
   if (!pathStr.empty() && pathStr[0] == '/')
   {
     // 2633: Q3 accepts absolute shader paths, so we just strip the leading slash
@@ -215,7 +215,7 @@ void Quake3ShaderParser::parseTexture(
   }
   else
   {
-    shader.shaderPath = std::filesystem::path{token.data()};
+    shader.shaderPath = std::filesystem::path{pathStr};
   }
 }
 
@@ -225,7 +225,7 @@ void Quake3ShaderParser::parseBodyEntry(
   auto token =
     m_tokenizer.skipAndNextToken(Quake3ShaderToken::Eol, Quake3ShaderToken::String);
 
-  const auto key = token.data();
+  const auto key = token.view();
   if (kdl::ci::str_is_equal(key, "qer_editorimage"))
   {
     token = m_tokenizer.nextToken(Quake3ShaderToken::String);
@@ -244,7 +244,7 @@ void Quake3ShaderParser::parseBodyEntry(
   else if (kdl::ci::str_is_equal(key, "cull"))
   {
     token = m_tokenizer.nextToken(Quake3ShaderToken::String);
-    const auto value = token.data();
+    const auto value = token.view();
     if (kdl::ci::str_is_equal(value, "front"))
     {
       shader.culling = mdl::Quake3Shader::Culling::Front;
@@ -271,7 +271,7 @@ void Quake3ShaderParser::parseStageEntry(
   auto token =
     m_tokenizer.skipAndNextToken(Quake3ShaderToken::Eol, Quake3ShaderToken::String);
 
-  const auto key = token.data();
+  const auto key = token.view();
   if (kdl::ci::str_is_equal(key, "map"))
   {
     token =
@@ -59,6 +59,10 @@ const std::size_t Ddcaps2Volume = 1 << 21;
 const std::size_t FourccDXT1 = (('1' << 24) + ('T' << 16) + ('X' << 8) + 'D');
 const std::size_t FourccDXT3 = (('3' << 24) + ('T' << 16) + ('X' << 8) + 'D');
 const std::size_t FourccDXT5 = (('5' << 24) + ('T' << 16) + ('X' << 8) + 'D');
+const std::size_t FourccATI1 = (('1' << 24) + ('I' << 16) + ('T' << 8) + 'A');
+const std::size_t FourccATI2 = (('2' << 24) + ('I' << 16) + ('T' << 8) + 'A');
+const std::size_t FourccBC4U = (('U' << 24) + ('4' << 16) + ('C' << 8) + 'B');
+const std::size_t FourccBC5U = (('U' << 24) + ('5' << 16) + ('C' << 8) + 'B');
 
 const std::size_t D3d10ResourceMiscCubemap = 1 << 2;
 const std::size_t D3d10ResourceDimensionTexture2D = 3;
@@ -78,10 +82,17 @@ const std::size_t DxgiFormatBC2UnormSrgb = 75;
 const std::size_t DxgiFormatBC3Typeless = 76;
 const std::size_t DxgiFormatBC3Unorm = 77;
 const std::size_t DxgiFormatBC3UnormSrgb = 78;
+const std::size_t DxgiFormatBC4Typeless = 79;
+const std::size_t DxgiFormatBC4Unorm = 80;
+const std::size_t DxgiFormatBC5Typeless = 82;
+const std::size_t DxgiFormatBC5Unorm = 83;
 const std::size_t DxgiFormatB8G8R8A8Typeless = 90;
 const std::size_t DxgiFormatB8G8R8A8UnormSrgb = 91;
 const std::size_t DxgiFormatB8G8R8X8Typeless = 92;
 const std::size_t DxgiFormatB8G8R8X8UnormSrgb = 93;
+const std::size_t DxgiFormatBC7Typeless = 97;
+const std::size_t DxgiFormatBC7Unorm = 98;
+const std::size_t DxgiFormatBC7UnormSrgb = 99;
 } // namespace DdsLayout
 
 GLenum convertDx10FormatToGLFormat(const size_t dx10Format)
@@ -107,6 +118,17 @@ GLenum convertDx10FormatToGLFormat(const size_t dx10Format)
   case DdsLayout::DxgiFormatBC3Unorm:
   case DdsLayout::DxgiFormatBC3UnormSrgb:
     return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case DdsLayout::DxgiFormatBC4Typeless:
+  case DdsLayout::DxgiFormatBC4Unorm:
+    return GL_COMPRESSED_RED_RGTC1;
+  case DdsLayout::DxgiFormatBC5Typeless:
+  case DdsLayout::DxgiFormatBC5Unorm:
+    return GL_COMPRESSED_RG_RGTC2;
+  case DdsLayout::DxgiFormatBC7Typeless:
+  case DdsLayout::DxgiFormatBC7Unorm:
+    return GL_COMPRESSED_RGBA_BPTC_UNORM;
+  case DdsLayout::DxgiFormatBC7UnormSrgb:
+    return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
   case DdsLayout::DxgiFormatB8G8R8A8Typeless:
   case DdsLayout::DxgiFormatB8G8R8A8UnormSrgb:
   case DdsLayout::DxgiFormatB8G8R8X8Typeless:
@@ -203,6 +225,16 @@ Result<mdl::Texture> readDdsTexture(Reader& reader)
           {
             format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
           }
+          else if (
+            ddpfFourcc == DdsLayout::FourccATI1 || ddpfFourcc == DdsLayout::FourccBC4U)
+          {
+            format = GL_COMPRESSED_RED_RGTC1;
+          }
+          else if (
+            ddpfFourcc == DdsLayout::FourccATI2 || ddpfFourcc == DdsLayout::FourccBC5U)
+          {
+            format = GL_COMPRESSED_RG_RGTC2;
+          }
         }
         else
         {
@@ -152,15 +152,23 @@ public:
 class OwningBufferReaderSource : public BufferReaderSource
 {
 private:
-  CFile::BufferType m_buffer;
+  std::shared_ptr<const void> m_buffer;
 
 public:
-  OwningBufferReaderSource(CFile::BufferType buffer, const char* begin, const char* end)
+  OwningBufferReaderSource(
+    std::shared_ptr<const void> buffer, const char* begin, const char* end)
     : BufferReaderSource{begin, end}
     , m_buffer{std::move(buffer)}
   {
   }
 
+  std::shared_ptr<ReaderSource> subSource(
+    const size_t offset, const size_t length) const override
+  {
+    return std::make_shared<OwningBufferReaderSource>(
+      m_buffer, begin() + offset, begin() + offset + length);
+  }
+
   std::shared_ptr<BufferReaderSource> buffer() const override
   {
     return std::make_shared<OwningBufferReaderSource>(m_buffer, begin(), end());
@@ -238,6 +246,13 @@ Reader Reader::from(const CFile& file, const size_t size)
   return Reader{std::make_shared<FileReaderSource>(file, 0, size)};
 }
 
+Reader Reader::from(
+  std::shared_ptr<const void> owner, const char* begin, const char* end)
+{
+  return Reader{
+    std::make_shared<OwningBufferReaderSource>(std::move(owner), begin, end)};
+}
+
 Reader Reader::from(const char* begin, const char* end)
 {
   return Reader{std::make_shared<BufferReaderSource>(begin, end)};
@@ -75,6 +75,20 @@ public:
    */
   static Reader from(const char* begin, const char* end);
 
+  /**
+   * Creates a new reader that reads from the given memory region and keeps the given
+   * owner alive for as long as the reader or any reader created from it exists.
+   *
+   * @param owner the owner of the memory region
+   * @param begin the beginning of the memory region
+   * @param end the end of the memory region (the position after the last byte)
+   * @return the reader
+   *
+   * @throw ReaderException if the reader cannot be created
+   */
+  static Reader from(
+    std::shared_ptr<const void> owner, const char* begin, const char* end);
+
 public:
   /**
    * Returns the size of the underlying reader source.
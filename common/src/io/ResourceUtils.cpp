@@ -23,6 +23,7 @@
 #include <QColor>
 #include <QDebug>
 #include <QIcon>
+#include <QIconEngine>
 #include <QImage>
 #include <QPainter>
 #include <QPalette>
@@ -44,7 +45,9 @@
 #include "kdl/set_temp.h"
 
 #include <map>
+#include <optional>
 #include <string>
+#include <utility>
 
 namespace tb::io
 {
@@ -269,4 +272,78 @@ QIcon loadSVGIcon(const std::filesystem::path& imagePath)
   return result;
 }
 
+namespace
+{
+
+/**
+ * Loads the icon with loadSVGIcon when it is first painted or its pixmaps are first
+ * requested.
+ */
+class LazySVGIconEngine : public QIconEngine
+{
+private:
+  std::filesystem::path m_imagePath;
+  std::optional<QIcon> m_icon;
+
+public:
+  explicit LazySVGIconEngine(std::filesystem::path imagePath)
+    : m_imagePath{std::move(imagePath)}
+  {
+  }
+
+  void paint(
+    QPainter* painter,
+    const QRect& rect,
+    const QIcon::Mode mode,
+    const QIcon::State state) override
+  {
+    icon().paint(painter, rect, Qt::AlignCenter, mode, state);
+  }
+
+  QPixmap pixmap(
+    const QSize& size, const QIcon::Mode mode, const QIcon::State state) override
+  {
+    return icon().pixmap(size, mode, state);
+  }
+
+  QPixmap scaledPixmap(
+    const QSize& size,
+    const QIcon::Mode mode,
+    const QIcon::State state,
+    const qreal scale) override
+  {
+    return icon().pixmap(size, scale, mode, state);
+  }
+
+  QSize actualSize(
+    const QSize& size, const QIcon::Mode mode, const QIcon::State state) override
+  {
+    return icon().actualSize(size, mode, state);
+  }
+
+  QList<QSize> availableSizes(const QIcon::Mode mode, const QIcon::State state) override
+  {
+    return icon().availableSizes(mode, state);
+  }
+
+  QIconEngine* clone() const override { return new LazySVGIconEngine{*this}; }
+
+private:
+  const QIcon& icon()
+  {
+    if (!m_icon)
+    {
+      m_icon = loadSVGIcon(m_imagePath);
+    }
+    return *m_icon;
+  }
+};
+
+} // namespace
+
+QIcon loadSVGIconLazily(const std::filesystem::path& imagePath)
+{
+  return QIcon{new LazySVGIconEngine{imagePath}};
+}
+
 } // namespace tb::io
@@ -71,4 +71,10 @@ QPixmap loadSVGPixmap(const std::filesystem::path& imagePath);
  */
 QIcon loadSVGIcon(const std::filesystem::path& imagePath);
 
+/**
+ * Returns an icon that loads the given SVG image with loadSVGIcon when it is first
+ * displayed. This avoids rendering the icons of menu items which are never shown.
+ */
+QIcon loadSVGIconLazily(const std::filesystem::path& imagePath);
+
 } // namespace tb::io
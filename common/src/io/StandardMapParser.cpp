@@ -24,6 +24,7 @@
 #include "mdl/BrushFace.h"
 #include "mdl/EntityProperties.h"
 
+#include "vm/from_chars.h"
 #include "vm/vec.h"
 
 #include <string>
@@ -61,8 +62,9 @@ const std::string& QuakeMapTokenizer::NumberDelim()
   return numberDelim;
 }
 
-QuakeMapTokenizer::QuakeMapTokenizer(const std::string_view str)
-  : Tokenizer{tokenNames(), str, "\"", '\\'}
+QuakeMapTokenizer::QuakeMapTokenizer(
+  const std::string_view str, const size_t startLine, const size_t startColumn)
+  : Tokenizer{tokenNames(), str, "\"", '\\', startLine, startColumn}
 {
 }
 
@@ -71,6 +73,33 @@ void QuakeMapTokenizer::setSkipEol(bool skipEol)
   m_skipEol = skipEol;
 }
 
+std::optional<double> QuakeMapTokenizer::readNumber()
+{
+  const auto previousState = m_state;
+  discardWhile(m_skipEol ? Whitespace() : " \t");
+
+  const auto* c = curPos();
+  const auto* n = c != m_end && *c == '-' ? c + 1 : c;
+
+  // exclude special values such as inf or nan, which the tokenizer treats as strings
+  if (n != m_end && (*n == '.' || isDigit(*n)))
+  {
+    auto value = 0.0;
+    const auto [e, ec] = vm::from_chars(c, m_end, value);
+    if (ec == std::errc{} && (e == m_end || isAnyOf(*e, NumberDelim())))
+    {
+      // a number never contains line breaks or escape characters
+      m_state.column += size_t(e - c);
+      m_state.cur = e;
+      m_state.escaped = false;
+      return value;
+    }
+  }
+
+  m_state = previousState;
+  return std::nullopt;
+}
+
 QuakeMapTokenizer::Token QuakeMapTokenizer::emitToken()
 {
   while (!eof())
@@ -168,14 +197,218 @@ QuakeMapTokenizer::Token QuakeMapTokenizer::emitToken()
   return Token{QuakeMapToken::Eof, nullptr, nullptr, length(), line(), column()};
 }
 
+namespace
+{
+
+bool isNumber(const std::string_view str)
+{
+  return !str.empty()
+         && str.find_first_not_of("+-.0123456789eE") == std::string_view::npos;
+}
+
+} // namespace
+
+std::vector<EntityChunk> splitEntityChunks(
+  const std::string_view str, const size_t minChunkSize)
+{
+  auto chunks = std::vector<EntityChunk>{};
+
+  auto pos = size_t(0);
+  auto line = size_t(1);
+  auto column = size_t(1);
+
+  const auto eof = [&]() { return pos >= str.size(); };
+  const auto curChar = [&]() { return !eof() ? str[pos] : '\0'; };
+  const auto lookAhead = [&]() { return pos + 1 < str.size() ? str[pos + 1] : '\0'; };
+  const auto isWhitespace = [](const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  };
+
+  // keep track of line and column numbers in the same way as the tokenizer does
+  const auto advance = [&]() {
+    switch (str[pos])
+    {
+    case '\r':
+      if (lookAhead() == '\n')
+      {
+        ++column;
+        break;
+      }
+      switchFallthrough();
+    case '\n':
+      ++line;
+      column = 1;
+      break;
+    default:
+      ++column;
+      break;
+    }
+    ++pos;
+  };
+
+  const auto discardLine = [&]() {
+    while (!eof() && curChar() != '\n' && curChar() != '\r')
+    {
+      advance();
+    }
+  };
+
+  // see QuakeMapTokenizer::emitToken and Tokenizer::readQuotedString
+  const auto discardQuotedString = [&]() {
+    auto escaped = false;
+    while (!eof())
+    {
+      const auto c = curChar();
+      if (c == '"' && (!escaped || lookAhead() == '\n' || lookAhead() == '}'))
+      {
+        advance();
+        return true;
+      }
+      escaped = c == '\\' && !escaped;
+      advance();
+    }
+    return false;
+  };
+
+  // numbers end at a closing parenthesis, everything else ends at whitespace
+  const auto discardWord = [&]() {
+    const auto start = pos;
+    while (!eof() && !isWhitespace(curChar()))
+    {
+      if (curChar() == ')' && isNumber(str.substr(start, pos - start)))
+      {
+        break;
+      }
+      advance();
+    }
+  };
+
+  auto depth = size_t(0);
+
+  // a material name follows the closing parenthesis of a face point, and it may start
+  // with an opening brace, e.g. {water
+  auto afterCParenthesis = false;
+
+  auto chunkStart = size_t(0);
+  auto chunkStartLine = size_t(1);
+  auto chunkStartColumn = size_t(1);
+
+  while (!eof())
+  {
+    switch (curChar())
+    {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      advance();
+      break;
+    case '/':
+      advance();
+      if (curChar() == '/')
+      {
+        advance();
+        if (curChar() == '/' && lookAhead() == ' ')
+        {
+          advance();
+        }
+        else
+        {
+          discardLine();
+        }
+      }
+      break;
+    case ';':
+      discardLine();
+      break;
+    case '"':
+      advance();
+      if (!discardQuotedString())
+      {
+        return {};
+      }
+      afterCParenthesis = false;
+      break;
+    case '{':
+      if (afterCParenthesis)
+      {
+        discardWord();
+      }
+      else
+      {
+        ++depth;
+        advance();
+      }
+      afterCParenthesis = false;
+      break;
+    case '}':
+      if (depth == 0)
+      {
+        return {};
+      }
+      --depth;
+      advance();
+      afterCParenthesis = false;
+
+      if (depth == 0 && pos - chunkStart >= minChunkSize)
+      {
+        chunks.push_back(EntityChunk{
+          str.substr(chunkStart, pos - chunkStart), chunkStartLine, chunkStartColumn});
+        chunkStart = pos;
+        chunkStartLine = line;
+        chunkStartColumn = column;
+      }
+      break;
+    case ')':
+      if (depth == 0)
+      {
+        return {};
+      }
+      advance();
+      afterCParenthesis = true;
+      break;
+    default:
+      if (depth == 0)
+      {
+        return {};
+      }
+      if (curChar() == '(' || curChar() == '[' || curChar() == ']')
+      {
+        advance();
+      }
+      else
+      {
+        discardWord();
+      }
+      afterCParenthesis = false;
+      break;
+    }
+  }
+
+  if (depth != 0)
+  {
+    return {};
+  }
+
+  if (chunkStart < str.size())
+  {
+    chunks.push_back(
+      EntityChunk{str.substr(chunkStart), chunkStartLine, chunkStartColumn});
+  }
+
+  return chunks;
+}
+
 const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
 const std::string StandardMapParser::PatchId = "patchDef2";
 
 StandardMapParser::StandardMapParser(
   const std::string_view str,
   const mdl::MapFormat sourceMapFormat,
-  const mdl::MapFormat targetMapFormat)
-  : m_tokenizer{str}
+  const mdl::MapFormat targetMapFormat,
+  const size_t startLine,
+  const size_t startColumn)
+  : m_tokenizer{str, startLine, startColumn}
   , m_sourceMapFormat{sourceMapFormat}
   , m_targetMapFormat{targetMapFormat}
 {
@@ -193,6 +426,7 @@ Result<void> StandardMapParser::parseEntities(ParserStatus& status)
              .hasType(QuakeMapToken::OBrace))
     {
       parseEntity(status);
+      status.progress(m_tokenizer.progress());
     }
 
     return kdl::void_success;
@@ -211,6 +445,7 @@ Result<void> StandardMapParser::parseBrushesOrPatches(ParserStatus& status)
              .hasType(QuakeMapToken::OBrace))
     {
       parseObject(status);
+      status.progress(m_tokenizer.progress());
     }
 
     return kdl::void_success;
@@ -288,16 +523,15 @@ void StandardMapParser::parseEntityProperty(
   auto token =
     m_tokenizer.skipAndNextToken(QuakeMapToken::Comment, QuakeMapToken::String);
 
-  const auto name = token.data();
+  const auto name = token.view();
   const auto location = token.location();
 
   token = m_tokenizer.nextToken(QuakeMapToken::String);
-  const auto value = token.data();
+  const auto value = token.view();
 
-  if (keys.count(name) == 0)
+  if (keys.insert(std::string{name}).second)
   {
     properties.emplace_back(name, value);
-    keys.insert(name);
   }
   else
   {
@@ -311,6 +545,7 @@ void StandardMapParser::parseObjects(ParserStatus& status)
   while (token.hasType(QuakeMapToken::OBrace))
   {
     parseObject(status);
+    status.progress(m_tokenizer.progress());
     token = m_tokenizer.skipAndPeekToken(QuakeMapToken::Comment);
   }
 }
@@ -336,7 +571,7 @@ void StandardMapParser::parseObject(ParserStatus& status)
     if (token.hasType(QuakeMapToken::String))
     {
       expect({BrushPrimitiveId, PatchId}, token);
-      if (token.data() == BrushPrimitiveId)
+      if (token.view() == BrushPrimitiveId)
       {
         parseBrushPrimitive(status, startLocation);
       }
@@ -772,7 +1007,9 @@ std::tuple<vm::vec3d, vm::vec3d> StandardMapParser::parsePrimitiveUVAxes(
 
 float StandardMapParser::parseFloat()
 {
-  return m_tokenizer.nextToken(QuakeMapToken::Number).toFloat<float>();
+  const auto value = m_tokenizer.readNumber();
+  return value ? static_cast<float>(*value)
+               : m_tokenizer.nextToken(QuakeMapToken::Number).toFloat<float>();
 }
 
 int StandardMapParser::parseInteger()
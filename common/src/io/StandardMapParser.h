@@ -29,6 +29,7 @@
 
 #include "vm/vec.h"
 
+#include <optional>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -67,14 +68,47 @@ private:
   bool m_skipEol = true;
 
 public:
-  explicit QuakeMapTokenizer(std::string_view str);
+  explicit QuakeMapTokenizer(
+    std::string_view str, size_t startLine = 1, size_t startColumn = 1);
 
   void setSkipEol(bool skipEol);
 
+  /**
+   * Reads the next number directly from the source without creating a token. This is a
+   * fast path for the numbers that make up most of a brush face.
+   *
+   * Returns an empty optional and leaves the tokenizer unchanged if the next token is not
+   * a plain decimal number. In that case, the caller must fall back to nextToken.
+   */
+  std::optional<double> readNumber();
+
 private:
   Token emitToken() override;
 };
 
+/**
+ * A part of a map file that contains zero or more complete top level entity blocks.
+ */
+struct EntityChunk
+{
+  std::string_view str;
+  size_t startLine;
+  size_t startColumn;
+};
+
+/**
+ * Splits the given string at the boundaries of its top level entity blocks into chunks
+ * such that each chunk except for the last one is at least minChunkSize characters long.
+ *
+ * This only performs a quick scan that skips strings and comments and counts braces, so
+ * that the returned chunks can be parsed independently, e.g. in parallel.
+ *
+ * Returns an empty vector if the entity boundaries cannot be determined reliably, e.g.
+ * because the braces are not balanced. In that case, the string must be parsed as a
+ * whole.
+ */
+std::vector<EntityChunk> splitEntityChunks(std::string_view str, size_t minChunkSize);
+
 class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type>
 {
 private:
@@ -98,9 +132,15 @@ public:
    * @param str the string to parse
    * @param sourceMapFormat the expected format of the given string
    * @param targetMapFormat the format to convert the created objects to
+   * @param startLine the line number of the first character of the given string
+   * @param startColumn the column number of the first character of the given string
    */
   StandardMapParser(
-    std::string_view str, mdl::MapFormat sourceMapFormat, mdl::MapFormat targetMapFormat);
+    std::string_view str,
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat,
+    size_t startLine = 1,
+    size_t startColumn = 1);
 
   ~StandardMapParser() override;
 
@@ -151,7 +191,9 @@ private:
     vm::vec<T, S> vec;
     for (size_t i = 0; i < S; i++)
     {
-      vec[i] = m_tokenizer.nextToken(QuakeMapToken::Number).toFloat<T>();
+      const auto value = m_tokenizer.readNumber();
+      vec[i] = value ? static_cast<T>(*value)
+                     : m_tokenizer.nextToken(QuakeMapToken::Number).toFloat<T>();
     }
     m_tokenizer.nextToken(c);
     return vec;
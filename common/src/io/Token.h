@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 
 namespace tb::io
 {
@@ -70,6 +71,12 @@ public:
 
   const std::string data() const { return std::string(m_begin, length()); }
 
+  /**
+   * Returns the token's text without copying it. The returned view refers to the
+   * tokenizer's source buffer and remains valid for as long as that buffer does.
+   */
+  std::string_view view() const { return std::string_view{m_begin, length()}; }
+
   size_t position() const { return m_position; }
 
   size_t length() const { return static_cast<size_t>(m_end - m_begin); }
@@ -83,13 +90,13 @@ public:
   template <typename T>
   T toFloat() const
   {
-    return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+    return static_cast<T>(kdl::str_to_double(view()).value_or(0.0));
   }
 
   template <typename T>
   T toInteger() const
   {
-    return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+    return static_cast<T>(kdl::str_to_long(view()).value_or(0l));
   }
 };
 
@@ -20,7 +20,9 @@
 #include "VirtualFileSystem.h"
 
 #include "io/File.h"
+#include "io/ImageFileSystem.h"
 #include "io/PathInfo.h"
+#include "io/PathMatcher.h"
 #include "io/TraversalMode.h"
 
 #include "kdl/path_utils.h"
@@ -32,6 +34,7 @@
 #include <fmt/std.h>
 
 #include <optional>
+#include <tuple>
 #include <unordered_map>
 
 namespace tb::io
@@ -59,6 +62,36 @@ std::filesystem::path suffix(
   return kdl::path_clip(path, kdl::path_length(mountPoint.path));
 }
 
+/**
+ * Returns the paths of all files and directories in the given mount point, including the
+ * mount point itself, if the mounted file system can be indexed. Otherwise, returns
+ * nothing.
+ */
+std::optional<std::vector<std::tuple<std::filesystem::path, PathInfo>>> indexablePaths(
+  const VirtualMountPoint& mountPoint)
+{
+  const auto& fs = *mountPoint.mountedFileSystem;
+  if (!dynamic_cast<const ImageFileSystemBase*>(&fs))
+  {
+    return std::nullopt;
+  }
+
+  return fs.find("", TraversalMode::Recursive)
+         | kdl::transform([&](const auto& paths) {
+             auto result = std::vector<std::tuple<std::filesystem::path, PathInfo>>{};
+             result.reserve(paths.size() + 1);
+             result.emplace_back(
+               kdl::path_to_lower(mountPoint.path), PathInfo::Directory);
+             for (const auto& path : paths)
+             {
+               result.emplace_back(
+                 kdl::path_to_lower(mountPoint.path / path), fs.pathInfo(path));
+             }
+             return std::optional{std::move(result)};
+           })
+         | kdl::value_or(std::nullopt);
+}
+
 } // namespace
 
 VirtualMountPointId::VirtualMountPointId()
@@ -79,19 +112,13 @@ bool operator!=(const VirtualMountPointId& lhs, const VirtualMountPointId& rhs)
 Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
   const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto resolvedPath = resolve(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
+    const auto& mountPoint = resolvedPath->mountPoint;
+    auto absPath = mountPoint.mountedFileSystem->makeAbsolute(suffix(mountPoint, path));
+    if (absPath.is_success())
     {
-      const auto pathSuffix = suffix(mountPoint, path);
-      const auto absPath = mountPoint.mountedFileSystem->makeAbsolute(pathSuffix);
-      if (
-        absPath.is_success()
-        && mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown)
-      {
-        return absPath;
-      }
+      return absPath;
     }
   }
 
@@ -100,18 +127,9 @@ Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
 
 PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto resolvedPath = resolve(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
-    {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-          pathInfo != PathInfo::Unknown)
-      {
-        return pathInfo;
-      }
-    }
+    return resolvedPath->pathInfo;
   }
 
   return std::any_of(
@@ -128,28 +146,21 @@ PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
 const FileSystemMetadata* VirtualFileSystem::metadata(
   const std::filesystem::path& path, const std::string& key) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto resolvedPath = resolve(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
-    {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-          pathInfo != PathInfo::Unknown)
-      {
-        return mountPoint.mountedFileSystem->metadata(pathSuffix, key);
-      }
-    }
+    const auto& mountPoint = resolvedPath->mountPoint;
+    return mountPoint.mountedFileSystem->metadata(suffix(mountPoint, path), key);
   }
 
   return nullptr;
 }
 
 VirtualMountPointId VirtualFileSystem::mount(
-  const std::filesystem::path& path, std::unique_ptr<FileSystem> fs)
+  const std::filesystem::path& path, std::shared_ptr<FileSystem> fs)
 {
   const auto id = VirtualMountPointId{};
   m_mountPoints.push_back({id, path, std::move(fs)});
+  addToPathIndex(m_mountPoints.back());
   return id;
 }
 
@@ -161,6 +172,7 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId& id)
         [&](const auto& mountPoint) { return mountPoint.id == id; });
       it != m_mountPoints.end())
   {
+    removeFromPathIndex(*it);
     m_mountPoints.erase(it);
     return true;
   }
@@ -170,6 +182,94 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId& id)
 void VirtualFileSystem::unmountAll()
 {
   m_mountPoints.clear();
+  m_pathIndex.clear();
+}
+
+Result<std::vector<std::filesystem::path>> VirtualFileSystem::findMountedFiles(
+  const VirtualMountPointId& id) const
+{
+  if (const auto it = std::find_if(
+        m_mountPoints.begin(),
+        m_mountPoints.end(),
+        [&](const auto& mountPoint) { return mountPoint.id == id; });
+      it != m_mountPoints.end())
+  {
+    return it->mountedFileSystem->find(
+             {}, TraversalMode::Recursive, makePathInfoPathMatcher({PathInfo::File}))
+           | kdl::transform([&](auto paths) {
+               return kdl::vec_transform(
+                 std::move(paths), [&](const auto& path) { return it->path / path; });
+             });
+  }
+  return Error{"Unknown mount point"};
+}
+
+std::optional<VirtualFileSystem::ResolvedPath> VirtualFileSystem::resolve(
+  const std::filesystem::path& path) const
+{
+  const auto indexIt = m_pathIndex.find(kdl::path_to_lower(path));
+  const auto* indexedPath =
+    indexIt != m_pathIndex.end() ? &indexIt->second.back() : nullptr;
+
+  // Only the mount points that take precedence over the indexed mount point containing
+  // the path and which aren't indexed themselves must be asked whether they contain it.
+  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  {
+    const auto& mountPoint = *it;
+    if (mountPoint.indexed)
+    {
+      if (indexedPath && indexedPath->mountPointId == mountPoint.id)
+      {
+        return ResolvedPath{mountPoint, indexedPath->pathInfo};
+      }
+    }
+    else if (matches(mountPoint, path))
+    {
+      if (const auto pathInfo =
+            mountPoint.mountedFileSystem->pathInfo(suffix(mountPoint, path));
+          pathInfo != PathInfo::Unknown)
+      {
+        return ResolvedPath{mountPoint, pathInfo};
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+void VirtualFileSystem::addToPathIndex(VirtualMountPoint& mountPoint)
+{
+  if (auto paths = indexablePaths(mountPoint))
+  {
+    for (auto& [path, pathInfo] : *paths)
+    {
+      m_pathIndex[std::move(path)].push_back({mountPoint.id, pathInfo});
+    }
+    mountPoint.indexed = true;
+  }
+}
+
+void VirtualFileSystem::removeFromPathIndex(const VirtualMountPoint& mountPoint)
+{
+  if (!mountPoint.indexed)
+  {
+    return;
+  }
+
+  const auto paths = indexablePaths(mountPoint);
+  for (const auto& [path, pathInfo] : *paths)
+  {
+    if (const auto it = m_pathIndex.find(path); it != m_pathIndex.end())
+    {
+      std::erase_if(it->second, [&](const auto& indexedPath) {
+        return indexedPath.mountPointId == mountPoint.id;
+      });
+      if (it->second.empty())
+      {
+        m_pathIndex.erase(it);
+      }
+    }
+  }
 }
 
 namespace
@@ -22,8 +22,12 @@
 #include "Result.h"
 #include "io/FileSystem.h"
 
+#include "kdl/path_hash.h"
+
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace tb::io
@@ -47,14 +51,50 @@ struct VirtualMountPoint
 {
   VirtualMountPointId id;
   std::filesystem::path path;
-  std::unique_ptr<FileSystem> mountedFileSystem;
+  std::shared_ptr<FileSystem> mountedFileSystem;
+
+  /**
+   * Whether the contents of the mounted file system are recorded in the path index of the
+   * virtual file system.
+   */
+  bool indexed = false;
 };
 
+/**
+ * Combines several file systems into one by mounting them at paths in a virtual
+ * directory tree. If several mounted file systems contain the same path, the file system
+ * that was mounted last takes precedence.
+ *
+ * The contents of image file systems such as pak, zip and wad files cannot change after
+ * they were opened, so the virtual file system records them in a case insensitive path
+ * index when they are mounted. Paths that are found in the index are resolved without
+ * asking every mounted file system whether it contains them. The contents of other file
+ * systems, e.g. directories on disk, are still looked up when the paths are accessed.
+ */
 class VirtualFileSystem : public FileSystem
 {
 private:
+  struct IndexedPath
+  {
+    VirtualMountPointId mountPointId;
+    PathInfo pathInfo;
+  };
+
+  struct ResolvedPath
+  {
+    const VirtualMountPoint& mountPoint;
+    PathInfo pathInfo;
+  };
+
   std::vector<VirtualMountPoint> m_mountPoints;
 
+  /**
+   * Maps the lower case paths of the files and directories of all indexed mount points to
+   * the mount points that contain them, in the order in which they were mounted.
+   */
+  std::unordered_map<std::filesystem::path, std::vector<IndexedPath>, kdl::path_hash>
+    m_pathIndex;
+
 public:
   Result<std::filesystem::path> makeAbsolute(
     const std::filesystem::path& path) const override;
@@ -62,11 +102,33 @@ public:
   const FileSystemMetadata* metadata(
     const std::filesystem::path& path, const std::string& key) const override;
 
+  /**
+   * Mounts the given file system at the given path. The file system may also be mounted
+   * by other virtual file systems.
+   */
   VirtualMountPointId mount(
-    const std::filesystem::path& path, std::unique_ptr<FileSystem> fs);
+    const std::filesystem::path& path, std::shared_ptr<FileSystem> fs);
   bool unmount(const VirtualMountPointId& id);
   void unmountAll();
 
+  /**
+   * Returns the paths of all files of the file system mounted at the given mount point,
+   * prefixed with the path of the mount point.
+   */
+  Result<std::vector<std::filesystem::path>> findMountedFiles(
+    const VirtualMountPointId& id) const;
+
+private:
+  /**
+   * Returns the mount point that takes precedence for the given path along with the
+   * information about the path in that mount point, or nothing if no mounted file system
+   * contains the given path.
+   */
+  std::optional<ResolvedPath> resolve(const std::filesystem::path& path) const;
+
+  void addToPathIndex(VirtualMountPoint& mountPoint);
+  void removeFromPathIndex(const VirtualMountPoint& mountPoint);
+
 protected:
   Result<std::vector<std::filesystem::path>> doFind(
     const std::filesystem::path& path, const TraversalMode& traversalMode) const override;
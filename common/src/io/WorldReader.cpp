@@ -19,6 +19,9 @@
 
 #include "WorldReader.h"
 
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/MapCache.h"
 #include "io/ParserStatus.h"
 #include "mdl/BrushNode.h"
 #include "mdl/Entity.h"
@@ -29,6 +32,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/vector_set.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
@@ -59,9 +63,20 @@ WorldReader::WorldReader(
   std::string_view str,
   const mdl::MapFormat sourceAndTargetMapFormat,
   const mdl::EntityPropertyConfig& entityPropertyConfig)
-  : MapReader{std::move(str), sourceAndTargetMapFormat, sourceAndTargetMapFormat, entityPropertyConfig}
+  : WorldReader{
+      str, sourceAndTargetMapFormat, sourceAndTargetMapFormat, entityPropertyConfig}
+{
+}
+
+WorldReader::WorldReader(
+  std::string_view str,
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat,
+  const mdl::EntityPropertyConfig& entityPropertyConfig)
+  : MapReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig}
+  , m_str{str}
   , m_worldNode{std::make_unique<mdl::WorldNode>(
-      entityPropertyConfig, mdl::Entity{}, sourceAndTargetMapFormat)}
+      entityPropertyConfig, mdl::Entity{}, targetMapFormat)}
 {
   m_worldNode->disableNodeTreeUpdates();
 }
@@ -72,7 +87,10 @@ Result<std::unique_ptr<mdl::WorldNode>> WorldReader::tryRead(
   const vm::bbox3d& worldBounds,
   const mdl::EntityPropertyConfig& entityPropertyConfig,
   ParserStatus& status,
-  kdl::task_manager& taskManager)
+  kdl::task_manager& taskManager,
+  const std::optional<std::filesystem::path>& cachePath,
+  const std::optional<std::vector<std::string>>& loadedLayerNames,
+  const bool loadHiddenLayers)
 {
   auto parserErrors = std::vector<std::tuple<mdl::MapFormat, std::string>>{};
 
@@ -84,7 +102,14 @@ Result<std::unique_ptr<mdl::WorldNode>> WorldReader::tryRead(
     }
 
     auto reader = WorldReader{str, mapFormat, entityPropertyConfig};
-    if (auto result = reader.read(worldBounds, status, taskManager); result.is_success())
+    if (auto result = reader.read(
+          worldBounds,
+          status,
+          taskManager,
+          cachePath,
+          loadedLayerNames,
+          loadHiddenLayers);
+        result.is_success())
     {
       return result;
     }
@@ -159,9 +184,10 @@ void sanitizeLayerSortIndicies(mdl::WorldNode& worldNode, ParserStatus& /* statu
   }
 }
 
-void setLinkIds(mdl::WorldNode& worldNode, ParserStatus& status)
+void setLinkIds(
+  mdl::WorldNode& worldNode, ParserStatus& status, kdl::task_manager& taskManager)
 {
-  const auto errors = mdl::initializeLinkIds({&worldNode});
+  const auto errors = mdl::initializeLinkIds({&worldNode}, taskManager);
   for (const auto& error : errors)
   {
     status.error("Could not restore linked groups: " + error.msg);
@@ -171,17 +197,70 @@ void setLinkIds(mdl::WorldNode& worldNode, ParserStatus& status)
 } // namespace
 
 Result<std::unique_ptr<mdl::WorldNode>> WorldReader::read(
-  const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager)
+  const vm::bbox3d& worldBounds,
+  ParserStatus& status,
+  kdl::task_manager& taskManager,
+  std::optional<std::filesystem::path> cachePath,
+  std::optional<std::vector<std::string>> loadedLayerNames,
+  const bool loadHiddenLayers)
 {
-  return readEntities(worldBounds, status, taskManager) | kdl::transform([&]() {
+  m_cachePath = std::move(cachePath);
+  m_loadedLayerNames = std::move(loadedLayerNames);
+  m_loadHiddenLayers = loadHiddenLayers;
+  return readEntitiesOrMapCache(worldBounds, status, taskManager) | kdl::transform([&]() {
            sanitizeLayerSortIndicies(*m_worldNode, status);
-           setLinkIds(*m_worldNode, status);
+           setLinkIds(*m_worldNode, status, taskManager);
            m_worldNode->rebuildNodeTree();
            m_worldNode->enableNodeTreeUpdates();
            return std::move(m_worldNode);
          });
 }
 
+Result<void> WorldReader::readEntitiesOrMapCache(
+  const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager)
+{
+  if (!m_cachePath)
+  {
+    return readEntities(worldBounds, status, taskManager);
+  }
+
+  return Disk::mapFile(*m_cachePath) | kdl::and_then([&](const auto& file) {
+           return readMapCache(file->reader(), m_str, m_sourceMapFormat);
+         })
+         | kdl::transform([&](auto objectInfos) {
+             readObjectInfos(std::move(objectInfos), worldBounds, status, taskManager);
+           })
+         | kdl::or_else([&](const auto&) {
+             return readEntities(worldBounds, status, taskManager);
+           });
+}
+
+bool WorldReader::retainObjectInfos() const
+{
+  return m_cachePath && !m_loadedLayerNames && m_loadHiddenLayers;
+}
+
+bool WorldReader::shouldLoadLayer(const std::string& layerName, const bool hidden) const
+{
+  return (m_loadHiddenLayers || !hidden)
+         && (!m_loadedLayerNames || kdl::vec_contains(*m_loadedLayerNames, layerName));
+}
+
+void WorldReader::onObjectInfos(
+  const std::vector<ObjectInfo>& objectInfos, ParserStatus& status)
+{
+  if (m_cachePath)
+  {
+    Disk::withOutputStream(
+      *m_cachePath,
+      std::ios::out | std::ios::binary,
+      [&](auto& stream) { writeMapCache(stream, m_str, m_sourceMapFormat, objectInfos); })
+      | kdl::transform_error([&](const auto& e) {
+          status.warn(fmt::format("Could not write map cache: {}", e.msg));
+        });
+  }
+}
+
 mdl::Node* WorldReader::onWorldNode(
   std::unique_ptr<mdl::WorldNode> worldNode, ParserStatus&)
 {
@@ -22,7 +22,11 @@
 #include "Result.h"
 #include "io/MapReader.h"
 
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace kdl
@@ -45,7 +49,11 @@ class ParserStatus;
  */
 class WorldReader : public MapReader
 {
+  std::string_view m_str;
   std::unique_ptr<mdl::WorldNode> m_worldNode;
+  std::optional<std::filesystem::path> m_cachePath;
+  std::optional<std::vector<std::string>> m_loadedLayerNames;
+  bool m_loadHiddenLayers = true;
 
 public:
   WorldReader(
@@ -53,8 +61,36 @@ public:
     mdl::MapFormat sourceAndTargetMapFormat,
     const mdl::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Creates a reader that parses the given string in the source map format and converts
+   * the brushes to the target map format. The world node is created in the target format.
+   */
+  WorldReader(
+    std::string_view str,
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat,
+    const mdl::EntityPropertyConfig& entityPropertyConfig);
+
+  /**
+   * Reads the world.
+   *
+   * If a cache path is given and the map cache at that path is valid for the source, the
+   * objects are read from the cache instead of parsing the source. Otherwise, the source
+   * is parsed and a new map cache is written to the given path.
+   *
+   * If layer names are given, only the objects of the default layer and of the custom
+   * layers with these names are loaded. If hidden layers should not be loaded, the
+   * objects of hidden custom layers are not loaded either. The other custom layers keep
+   * the source text of their objects as unloaded content. No map cache is written in
+   * that case, since the cache must contain every object.
+   */
   Result<std::unique_ptr<mdl::WorldNode>> read(
-    const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager);
+    const vm::bbox3d& worldBounds,
+    ParserStatus& status,
+    kdl::task_manager& taskManager,
+    std::optional<std::filesystem::path> cachePath = std::nullopt,
+    std::optional<std::vector<std::string>> loadedLayerNames = std::nullopt,
+    bool loadHiddenLayers = true);
 
   /**
    * Try to parse the given string as the given map formats, in order.
@@ -65,6 +101,9 @@ public:
    * @param worldBounds world bounds
    * @param status status
    * @param taskManager the task manager to use for parallel tasks
+   * @param cachePath the path of the map cache to use, if any
+   * @param loadedLayerNames the names of the custom layers to load, or all if not given
+   * @param loadHiddenLayers whether to load the hidden custom layers
    * @return the world node or an error if `str` can't be parsed by any of the given
    * formats
    */
@@ -74,9 +113,20 @@ public:
     const vm::bbox3d& worldBounds,
     const mdl::EntityPropertyConfig& entityPropertyConfig,
     ParserStatus& status,
-    kdl::task_manager& taskManager);
+    kdl::task_manager& taskManager,
+    const std::optional<std::filesystem::path>& cachePath = std::nullopt,
+    const std::optional<std::vector<std::string>>& loadedLayerNames = std::nullopt,
+    bool loadHiddenLayers = true);
+
+private:
+  Result<void> readEntitiesOrMapCache(
+    const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager);
 
 private: // implement MapReader interface
+  bool retainObjectInfos() const override;
+  bool shouldLoadLayer(const std::string& layerName, bool hidden) const override;
+  void onObjectInfos(
+    const std::vector<ObjectInfo>& objectInfos, ParserStatus& status) override;
   mdl::Node* onWorldNode(
     std::unique_ptr<mdl::WorldNode> worldNode, ParserStatus& status) override;
   void onLayerNode(std::unique_ptr<mdl::Node> layerNode, ParserStatus& status) override;
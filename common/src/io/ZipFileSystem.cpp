@@ -20,6 +20,8 @@
 #include "ZipFileSystem.h"
 
 #include "io/File.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
 
 #include "kdl/result.h"
 
@@ -56,6 +58,27 @@ std::string filename(mz_zip_archive& archive, const mz_uint fileIndex)
 
   return result;
 }
+
+/**
+ * Reads from the given file at the given offset. Every call uses its own reader, so this
+ * function can be called from several threads at the same time.
+ */
+size_t readFile(void* opaque, const mz_uint64 offset, void* buffer, const size_t size)
+{
+  const auto& file = *static_cast<const File*>(opaque);
+  try
+  {
+    auto reader = file.reader();
+    reader.seekFromBegin(static_cast<size_t>(offset));
+    reader.read(static_cast<char*>(buffer), size);
+    return size;
+  }
+  catch (const ReaderException&)
+  {
+    return 0;
+  }
+}
+
 } // namespace
 
 ZipFileSystem::~ZipFileSystem()
@@ -66,10 +89,12 @@ ZipFileSystem::~ZipFileSystem()
 Result<void> ZipFileSystem::doReadDirectory()
 {
   mz_zip_zero_struct(&m_archive);
+  m_archive.m_pRead = readFile;
+  m_archive.m_pIO_opaque = m_file.get();
 
-  if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE)
+  if (mz_zip_reader_init(&m_archive, m_file->size(), 0) != MZ_TRUE)
   {
-    return Error{"Error calling mz_zip_reader_init_cfile"};
+    return Error{"Error calling mz_zip_reader_init"};
   }
 
   const auto numFiles = mz_zip_reader_get_num_files(&m_archive);
@@ -79,8 +104,6 @@ Result<void> ZipFileSystem::doReadDirectory()
     {
       const auto path = std::filesystem::path{filename(m_archive, i)};
       addFile(path, [&, i, path]() -> Result<std::shared_ptr<File>> {
-        auto loadFileGoard = std::lock_guard{m_mutex};
-
         auto stat = mz_zip_archive_file_stat{};
         if (!mz_zip_reader_file_stat(&m_archive, i, &stat))
         {
@@ -24,17 +24,21 @@
 
 #include <miniz/miniz.h>
 
-#include <mutex>
-
 namespace tb::io
 {
-class CFile;
-
-class ZipFileSystem : public ImageFileSystem<CFile>
+class File;
+
+/**
+ * A file system backed by a zip archive.
+ *
+ * The archive reads from the underlying file at explicit offsets and its state is not
+ * modified after the central directory has been read, so several threads can extract
+ * files at the same time.
+ */
+class ZipFileSystem : public ImageFileSystem<File>
 {
 private:
   mz_zip_archive m_archive;
-  std::mutex m_mutex;
 
 public:
   using ImageFileSystem::ImageFileSystem;
@@ -23,6 +23,7 @@
 #include "Macros.h"
 #include "mdl/AddRemoveNodesUtils.h"
 #include "mdl/Map.h"
+#include "mdl/MemoryUsage.h"
 #include "mdl/Node.h"
 
 #include "kdl/map_utils.h"
@@ -74,6 +75,25 @@ AddRemoveNodesCommand::AddRemoveNodesCommand(
   }
 }
 
+size_t AddRemoveNodesCommand::memoryUsage() const
+{
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage();
+
+  // the command owns the nodes in m_nodesToAdd
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    for (const auto* child : children)
+    {
+      result += mdl::memoryUsage(*child);
+    }
+  }
+  for (const auto& [parent, children] : m_nodesToRemove)
+  {
+    result += children.capacity() * sizeof(Node*);
+  }
+  return result;
+}
+
 std::string AddRemoveNodesCommand::makeName(const Action action)
 {
   switch (action)
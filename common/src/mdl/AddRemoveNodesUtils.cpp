@@ -23,6 +23,7 @@
 #include "mdl/Map.h"
 #include "mdl/Node.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/map_utils.h"
 #include "kdl/vector_utils.h"
@@ -37,10 +38,13 @@ void addNodesAndNotify(const std::map<Node*, std::vector<Node*>>& nodes, Map& ma
     map.nodesWillChangeNotifier, map.nodesDidChangeNotifier, parents};
 
   auto addedNodes = std::vector<Node*>{};
-  for (const auto& [parent, children] : nodes)
   {
-    parent->addChildren(children);
-    addedNodes = kdl::vec_concat(std::move(addedNodes), children);
+    const auto deferNodeTreeUpdates = DeferNodeTreeUpdates{*map.world()};
+    for (const auto& [parent, children] : nodes)
+    {
+      parent->addChildren(children);
+      addedNodes = kdl::vec_concat(std::move(addedNodes), children);
+    }
   }
 
   map.nodesWereAddedNotifier(addedNodes);
@@ -56,6 +60,7 @@ void removeNodesAndNotify(const std::map<Node*, std::vector<Node*>>& nodes, Map&
   auto notifyChildren = NotifyBeforeAndAfter{
     map.nodesWillBeRemovedNotifier, map.nodesWereRemovedNotifier, allChildren};
 
+  const auto deferNodeTreeUpdates = DeferNodeTreeUpdates{*map.world()};
   for (const auto& [parent, children] : nodes)
   {
     parent->removeChildren(std::begin(children), std::end(children));
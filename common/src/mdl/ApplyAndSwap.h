@@ -36,9 +36,32 @@
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 
+#include "kdl/task_manager.h"
+
+#include <atomic>
+#include <unordered_map>
+
 namespace tb::mdl
 {
 
+namespace detail
+{
+
+inline std::variant<Layer, Group, Entity, Brush, BezierPatch> copyNodeContents(
+  const Node* node)
+{
+  using NodeContent = std::variant<Layer, Group, Entity, Brush, BezierPatch>;
+  return node->accept(kdl::overload(
+    [](const WorldNode* worldNode) -> NodeContent { return worldNode->entity(); },
+    [](const LayerNode* layerNode) -> NodeContent { return layerNode->layer(); },
+    [](const GroupNode* groupNode) -> NodeContent { return groupNode->group(); },
+    [](const EntityNode* entityNode) -> NodeContent { return entityNode->entity(); },
+    [](const BrushNode* brushNode) -> NodeContent { return brushNode->brush(); },
+    [](const PatchNode* patchNode) -> NodeContent { return patchNode->patch(); }));
+}
+
+} // namespace detail
+
 /**
  * Applies the given lambda to a copy of the contents of each of the given nodes and
  * returns a vector of pairs of the original node and the modified contents.
@@ -58,23 +81,12 @@ template <typename N, typename L>
 std::optional<std::vector<std::pair<Node*, NodeContents>>> applyToNodeContents(
   const std::vector<N*>& nodes, L lambda)
 {
-  using NodeContent = std::variant<Layer, Group, Entity, Brush, BezierPatch>;
-  auto getNodeContents = [](const Node* node) -> NodeContent {
-    return node->accept(kdl::overload(
-      [](const WorldNode* worldNode) -> NodeContent { return worldNode->entity(); },
-      [](const LayerNode* layerNode) -> NodeContent { return layerNode->layer(); },
-      [](const GroupNode* groupNode) -> NodeContent { return groupNode->group(); },
-      [](const EntityNode* entityNode) -> NodeContent { return entityNode->entity(); },
-      [](const BrushNode* brushNode) -> NodeContent { return brushNode->brush(); },
-      [](const PatchNode* patchNode) -> NodeContent { return patchNode->patch(); }));
-  };
-
   auto newNodes = std::vector<std::pair<Node*, NodeContents>>{};
   newNodes.reserve(nodes.size());
 
   for (auto* node : nodes)
   {
-    auto nodeContents = getNodeContents(node);
+    auto nodeContents = detail::copyNodeContents(node);
     if (!std::visit(lambda, nodeContents))
     {
       return std::nullopt;
@@ -86,6 +98,48 @@ std::optional<std::vector<std::pair<Node*, NodeContents>>> applyToNodeContents(
   return newNodes;
 }
 
+/**
+ * Same as applyToNodeContents, but the lambda is applied to the node contents in parallel
+ * on the given task manager, so it may be called concurrently for different nodes. Once
+ * the lambda has failed for one node, it is no longer applied to the remaining nodes.
+ */
+template <typename N, typename L>
+std::optional<std::vector<std::pair<Node*, NodeContents>>> applyToNodeContentsInParallel(
+  kdl::task_manager& taskManager, const std::vector<N*>& nodes, L lambda)
+{
+  using NodeContent = std::variant<Layer, Group, Entity, Brush, BezierPatch>;
+
+  auto nodeContents = std::vector<std::optional<NodeContent>>(nodes.size());
+  auto success = std::atomic<bool>{true};
+  taskManager.parallel_for(nodes.size(), [&](const size_t i) {
+    if (success)
+    {
+      auto contents = detail::copyNodeContents(nodes[i]);
+      if (!std::visit(lambda, contents))
+      {
+        success = false;
+        return;
+      }
+      nodeContents[i] = std::move(contents);
+    }
+  });
+
+  if (!success)
+  {
+    return std::nullopt;
+  }
+
+  auto newNodes = std::vector<std::pair<Node*, NodeContents>>{};
+  newNodes.reserve(nodes.size());
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    newNodes.emplace_back(nodes[i], NodeContents{std::move(*nodeContents[i])});
+  }
+
+  return newNodes;
+}
+
 /**
  * Applies the given lambda to a copy of the contents of each of the given nodes and
  * swaps the node contents if the given lambda succeeds for all node contents.
@@ -140,6 +194,9 @@ bool applyAndSwap(
  * The given node contents should be modified in place and the lambda should return true
  * if it was applied successfully and false otherwise.
  *
+ * The brushes are modified in parallel, so the lambda may be called concurrently for
+ * faces of different brushes.
+ *
  * For each linked group in the given list of linked groups, its changes are distributed
  * to the connected members of its link set.
  *
@@ -159,29 +216,50 @@ bool applyAndSwap(
     return true;
   }
 
-  auto brushes = std::unordered_map<BrushNode*, Brush>{};
+  auto brushIndices = std::unordered_map<BrushNode*, size_t>{};
+  auto brushNodes = std::vector<BrushNode*>{};
+  auto faceIndices = std::vector<std::vector<size_t>>{};
   for (const auto& faceHandle : faces)
   {
     auto* brushNode = faceHandle.node();
-    auto it = brushes.find(brushNode);
-    if (it == std::end(brushes))
+    const auto [it, inserted] = brushIndices.try_emplace(brushNode, brushNodes.size());
+    if (inserted)
     {
-      it = brushes.emplace(brushNode, brushNode->brush()).first;
+      brushNodes.push_back(brushNode);
+      faceIndices.emplace_back();
     }
+    faceIndices[it->second].push_back(faceHandle.faceIndex());
+  }
 
-    auto& brush = it->second;
-    if (!lambda(brush.face(faceHandle.faceIndex())))
+  auto brushes = std::vector<Brush>(brushNodes.size());
+  auto success = std::atomic<bool>{true};
+  map.taskManager().parallel_for(brushNodes.size(), [&](const size_t i) {
+    if (success)
     {
-      return false;
+      auto brush = brushNodes[i]->brush();
+      for (const auto faceIndex : faceIndices[i])
+      {
+        if (!lambda(brush.face(faceIndex)))
+        {
+          success = false;
+          return;
+        }
+      }
+      brushes[i] = std::move(brush);
     }
+  });
+
+  if (!success)
+  {
+    return false;
   }
 
   auto newNodes = std::vector<std::pair<Node*, NodeContents>>{};
   newNodes.reserve(brushes.size());
 
-  for (auto& [brushNode, brush] : brushes)
+  for (size_t i = 0; i < brushNodes.size(); ++i)
   {
-    newNodes.emplace_back(brushNode, NodeContents(std::move(brush)));
+    newNodes.emplace_back(brushNodes[i], NodeContents(std::move(brushes[i])));
   }
 
   auto changedLinkedGroups = collectContainingGroups(
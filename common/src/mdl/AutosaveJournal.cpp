@@ -0,0 +1,580 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AutosaveJournal.h"
+
+#include "Error.h"
+#include "io/NodeReader.h"
+#include "io/NodeWriter.h"
+#include "io/SimpleParserStatus.h"
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Node.h"
+#include "mdl/Transaction.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <optional>
+#include <sstream>
+
+namespace tb::mdl
+{
+namespace
+{
+
+/**
+ * The number of lines that writeMapHeader emits before the nodes. The serializer counts
+ * lines from the first node, but the reader counts them from the beginning of the file.
+ */
+constexpr auto SnapshotHeaderLineCount = size_t(2);
+
+const auto JournalSnapshotKeyword = std::string_view{"snapshot"};
+const auto EntryBeginKeyword = std::string_view{"entry"};
+const auto EntryRemoveKeyword = std::string_view{"remove"};
+const auto EntryLayerKeyword = std::string_view{"layer"};
+const auto EntryEndKeyword = std::string_view{"end"};
+const auto DefaultLayerId = std::string_view{"default"};
+
+bool isLayer(const Node* node)
+{
+  return dynamic_cast<const LayerNode*>(node) != nullptr;
+}
+
+bool isLayerOrWorld(const Node* node)
+{
+  return isLayer(node) || dynamic_cast<const WorldNode*>(node) != nullptr;
+}
+
+/**
+ * Returns the ancestor of the given node (or the node itself) that is a direct child of
+ * a layer, or nullptr if there is no such node.
+ */
+const Node* findTopLevelNode(const Node* node)
+{
+  while (node && node->parent() && !isLayer(node->parent()))
+  {
+    node = node->parent();
+  }
+  return node && node->parent() ? node : nullptr;
+}
+
+std::string layerId(const LayerNode& layerNode)
+{
+  if (const auto& persistentId = layerNode.persistentId())
+  {
+    return fmt::format("{}", *persistentId);
+  }
+  return std::string{DefaultLayerId};
+}
+
+struct JournalEntry
+{
+  std::vector<size_t> removedLines;
+  std::vector<std::tuple<std::string, std::string_view>> layerNodes;
+};
+
+class JournalReader
+{
+private:
+  std::string_view m_str;
+
+public:
+  explicit JournalReader(const std::string_view str)
+    : m_str{str}
+  {
+  }
+
+  bool eof() const { return m_str.empty(); }
+
+  std::optional<std::string_view> readLine()
+  {
+    const auto end = m_str.find('\n');
+    if (end == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+
+    const auto line = m_str.substr(0, end);
+    m_str.remove_prefix(end + 1);
+    return line;
+  }
+
+  std::optional<std::string_view> readBytes(const size_t count)
+  {
+    if (m_str.size() < count)
+    {
+      return std::nullopt;
+    }
+
+    const auto bytes = m_str.substr(0, count);
+    m_str.remove_prefix(count);
+    return bytes;
+  }
+
+  /**
+   * Reads the next entry, or returns nullopt if the journal ends before the entry is
+   * complete.
+   */
+  std::optional<JournalEntry> readEntry()
+  {
+    if (readLine() != EntryBeginKeyword)
+    {
+      return std::nullopt;
+    }
+
+    auto entry = JournalEntry{};
+
+    const auto removeLine = readLine();
+    if (!removeLine)
+    {
+      return std::nullopt;
+    }
+
+    const auto removeTokens = kdl::str_split(*removeLine, " ");
+    if (removeTokens.empty() || removeTokens.front() != EntryRemoveKeyword)
+    {
+      return std::nullopt;
+    }
+
+    for (size_t i = 1; i < removeTokens.size(); ++i)
+    {
+      const auto lineNumber = kdl::str_to_size(removeTokens[i]);
+      if (!lineNumber)
+      {
+        return std::nullopt;
+      }
+      entry.removedLines.push_back(*lineNumber);
+    }
+
+    while (const auto line = readLine())
+    {
+      if (*line == EntryEndKeyword)
+      {
+        return entry;
+      }
+
+      const auto layerTokens = kdl::str_split(*line, " ");
+      if (layerTokens.size() != 3 || layerTokens[0] != EntryLayerKeyword)
+      {
+        return std::nullopt;
+      }
+
+      const auto byteCount = kdl::str_to_size(layerTokens[2]);
+      if (!byteCount)
+      {
+        return std::nullopt;
+      }
+
+      const auto nodes = readBytes(*byteCount);
+      if (!nodes)
+      {
+        return std::nullopt;
+      }
+
+      entry.layerNodes.emplace_back(layerTokens[1], *nodes);
+    }
+
+    return std::nullopt;
+  }
+};
+
+Result<std::optional<JournalEntry>> readLastEntry(const std::string_view journal)
+{
+  auto reader = JournalReader{journal};
+  const auto header = reader.readLine();
+  if (!header || !header->starts_with(JournalSnapshotKeyword))
+  {
+    return Error{"Invalid autosave journal: missing snapshot header"};
+  }
+
+  auto lastEntry = std::optional<JournalEntry>{};
+  while (!reader.eof())
+  {
+    auto entry = reader.readEntry();
+    if (!entry)
+    {
+      break;
+    }
+    lastEntry = std::move(entry);
+  }
+
+  return lastEntry;
+}
+
+Result<LayerNode*> findLayer(WorldNode& worldNode, const std::string_view id)
+{
+  if (id == DefaultLayerId)
+  {
+    return worldNode.defaultLayer();
+  }
+
+  const auto persistentId = kdl::str_to_size(id);
+  for (auto* layerNode : worldNode.customLayers())
+  {
+    if (layerNode->persistentId() == persistentId)
+    {
+      return layerNode;
+    }
+  }
+
+  return Error{fmt::format("Autosave journal refers to unknown layer '{}'", id)};
+}
+
+Result<std::vector<Node*>> findRemovedNodes(
+  WorldNode& worldNode, const std::vector<size_t>& removedLines)
+{
+  auto nodesByLine = std::unordered_map<size_t, Node*>{};
+  for (auto* layerNode : worldNode.allLayers())
+  {
+    for (auto* node : layerNode->children())
+    {
+      nodesByLine.emplace(node->lineNumber(), node);
+    }
+  }
+
+  auto result = std::vector<Node*>{};
+  result.reserve(removedLines.size());
+
+  for (const auto lineNumber : removedLines)
+  {
+    const auto it = nodesByLine.find(lineNumber);
+    if (it == nodesByLine.end())
+    {
+      return Error{
+        fmt::format("Autosave journal refers to unknown node at line {}", lineNumber)};
+    }
+    result.push_back(it->second);
+  }
+
+  return result;
+}
+
+/**
+ * The node reader adds world brushes and patches to a layer node that it creates in
+ * place of the world. Replaces such layer nodes with their children.
+ */
+std::vector<Node*> unwrapLayerNodes(std::vector<Node*> nodes)
+{
+  auto result = std::vector<Node*>{};
+  result.reserve(nodes.size());
+
+  for (auto* node : nodes)
+  {
+    if (auto* layerNode = dynamic_cast<LayerNode*>(node))
+    {
+      auto children = layerNode->children();
+      layerNode->removeChildren(children.begin(), children.end());
+      result = kdl::vec_concat(std::move(result), std::move(children));
+      delete layerNode;
+    }
+    else
+    {
+      result.push_back(node);
+    }
+  }
+
+  return result;
+}
+
+Result<std::map<Node*, std::vector<Node*>>> readAddedNodes(
+  Map& map, const JournalEntry& entry)
+{
+  auto parserStatus = io::SimpleParserStatus{map.logger()};
+  auto result = std::map<Node*, std::vector<Node*>>{};
+
+  const auto deleteNodes = [&]() {
+    for (auto& [layerNode, nodes] : result)
+    {
+      kdl::vec_clear_and_delete(nodes);
+    }
+  };
+
+  for (const auto& [id, str] : entry.layerNodes)
+  {
+    auto error = std::optional<Error>{};
+    findLayer(*map.world(), id) | kdl::and_then([&](auto* layerNode) {
+      return io::NodeReader::read(
+               std::string{str},
+               map.world()->mapFormat(),
+               map.worldBounds(),
+               map.world()->entityPropertyConfig(),
+               parserStatus,
+               map.taskManager())
+             | kdl::transform([&](auto nodes) {
+                 result[layerNode] = kdl::vec_concat(
+                   std::move(result[layerNode]), unwrapLayerNodes(std::move(nodes)));
+               });
+    }) | kdl::transform_error([&](auto e) { error = std::move(e); });
+
+    if (error)
+    {
+      deleteNodes();
+      return *error;
+    }
+  }
+
+  return result;
+}
+
+} // namespace
+
+AutosaveJournal::AutosaveJournal(Map& map)
+  : m_map{map}
+{
+  connectObservers();
+}
+
+bool AutosaveJournal::hasSnapshot() const
+{
+  return m_hasSnapshot;
+}
+
+size_t AutosaveJournal::entryCount() const
+{
+  return m_entryCount;
+}
+
+void AutosaveJournal::recordSnapshot()
+{
+  m_snapshotNodes.clear();
+  m_changedNodes.clear();
+  m_worldEntity = m_map.world()->entity();
+  m_layers = currentLayers();
+  m_entryCount = 0;
+
+  for (const auto* layerNode : m_map.world()->allLayers())
+  {
+    for (const auto* node : layerNode->children())
+    {
+      m_snapshotNodes.emplace(
+        node, SnapshotNode{node->lineNumber() + SnapshotHeaderLineCount, layerNode});
+    }
+  }
+
+  m_hasSnapshot = true;
+}
+
+void AutosaveJournal::discardSnapshot()
+{
+  m_hasSnapshot = false;
+  m_snapshotNodes.clear();
+  m_changedNodes.clear();
+  m_layers.clear();
+  m_entryCount = 0;
+}
+
+std::string AutosaveJournal::createEntry()
+{
+  assert(m_hasSnapshot);
+
+  const auto isUnchanged = [&](const Node* node, const LayerNode* layerNode) {
+    if (m_changedNodes.contains(node))
+    {
+      return false;
+    }
+
+    const auto it = m_snapshotNodes.find(node);
+    return it != m_snapshotNodes.end() && it->second.layer == layerNode;
+  };
+
+  auto removedLines = std::vector<size_t>{};
+  auto survivingSnapshotNodes = std::unordered_set<const Node*>{};
+
+  for (const auto* layerNode : m_map.world()->allLayers())
+  {
+    for (const auto* node : layerNode->children())
+    {
+      if (isUnchanged(node, layerNode))
+      {
+        survivingSnapshotNodes.insert(node);
+      }
+    }
+  }
+
+  for (const auto& [node, snapshotNode] : m_snapshotNodes)
+  {
+    if (!survivingSnapshotNodes.contains(node))
+    {
+      removedLines.push_back(snapshotNode.lineNumber);
+    }
+  }
+
+  auto stream = std::stringstream{};
+  stream << EntryBeginKeyword << "\n";
+  stream << EntryRemoveKeyword;
+  for (const auto lineNumber : kdl::vec_sort(std::move(removedLines)))
+  {
+    stream << " " << lineNumber;
+  }
+  stream << "\n";
+
+  for (auto* layerNode : m_map.world()->allLayers())
+  {
+    const auto nodes = kdl::vec_filter(layerNode->children(), [&](const auto* node) {
+      return !survivingSnapshotNodes.contains(node);
+    });
+
+    if (!nodes.empty())
+    {
+      auto nodeStream = std::stringstream{};
+      auto writer = io::NodeWriter{*m_map.world(), nodeStream};
+      writer.writeNodes(nodes, m_map.taskManager());
+
+      const auto nodeStr = nodeStream.str();
+      stream << EntryLayerKeyword << " " << layerId(*layerNode) << " " << nodeStr.size()
+             << "\n"
+             << nodeStr;
+    }
+  }
+
+  stream << EntryEndKeyword << "\n";
+
+  ++m_entryCount;
+  return stream.str();
+}
+
+void AutosaveJournal::connectObservers()
+{
+  m_notifierConnection +=
+    m_map.mapWasCreatedNotifier.connect(this, &AutosaveJournal::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasLoadedNotifier.connect(this, &AutosaveJournal::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasClearedNotifier.connect(this, &AutosaveJournal::mapWasReset);
+
+  m_notifierConnection +=
+    m_map.nodesWereAddedNotifier.connect(this, &AutosaveJournal::nodesDidChange);
+  m_notifierConnection +=
+    m_map.nodesWillBeRemovedNotifier.connect(this, &AutosaveJournal::nodesDidChange);
+  m_notifierConnection +=
+    m_map.nodesDidChangeNotifier.connect(this, &AutosaveJournal::nodesDidChange);
+  m_notifierConnection += m_map.brushFacesDidChangeNotifier.connect(
+    [&](const std::vector<BrushFaceHandle>& handles) {
+      nodesDidChange(kdl::vec_transform(
+        handles, [](const auto& handle) -> Node* { return handle.node(); }));
+    });
+
+  // the lock and visibility states of layers are stored in the map file
+  const auto layerStateDidChange = [&](const std::vector<Node*>& nodes) {
+    if (std::ranges::any_of(nodes, isLayerOrWorld))
+    {
+      discardSnapshot();
+    }
+  };
+  m_notifierConnection += m_map.nodeLockingDidChangeNotifier.connect(layerStateDidChange);
+  m_notifierConnection +=
+    m_map.nodeVisibilityDidChangeNotifier.connect(layerStateDidChange);
+}
+
+void AutosaveJournal::mapWasReset(Map&)
+{
+  discardSnapshot();
+}
+
+void AutosaveJournal::nodesDidChange(const std::vector<Node*>& nodes)
+{
+  if (!m_hasSnapshot)
+  {
+    return;
+  }
+
+  if (std::ranges::any_of(nodes, isLayerOrWorld) && layersOrWorldChanged())
+  {
+    discardSnapshot();
+    return;
+  }
+
+  for (const auto* node : nodes)
+  {
+    if (const auto* topLevelNode = findTopLevelNode(node))
+    {
+      m_changedNodes.insert(topLevelNode);
+    }
+  }
+}
+
+std::vector<std::tuple<const LayerNode*, Layer>> AutosaveJournal::currentLayers() const
+{
+  return kdl::vec_transform(m_map.world()->allLayers(), [](const auto* layerNode) {
+    return std::tuple<const LayerNode*, Layer>{layerNode, layerNode->layer()};
+  });
+}
+
+bool AutosaveJournal::layersOrWorldChanged() const
+{
+  return m_map.world()->entity() != m_worldEntity || currentLayers() != m_layers;
+}
+
+std::string makeAutosaveJournalHeader(const std::filesystem::path& snapshotFilename)
+{
+  return fmt::format("{} {}\n", JournalSnapshotKeyword, snapshotFilename.string());
+}
+
+Result<std::filesystem::path> readAutosaveJournalSnapshotFilename(
+  const std::string_view journal)
+{
+  auto reader = JournalReader{journal};
+  if (const auto header = reader.readLine();
+      header && header->starts_with(fmt::format("{} ", JournalSnapshotKeyword)))
+  {
+    return std::filesystem::path{header->substr(JournalSnapshotKeyword.size() + 1)};
+  }
+  return Error{"Invalid autosave journal: missing snapshot header"};
+}
+
+Result<void> applyAutosaveJournal(Map& map, const std::string_view journal)
+{
+  return readLastEntry(journal) | kdl::and_then([&](const auto& entry) -> Result<void> {
+           if (!entry)
+           {
+             return kdl::void_success;
+           }
+
+           return findRemovedNodes(*map.world(), entry->removedLines)
+                  | kdl::and_then([&](const auto& nodesToRemove) {
+                      return readAddedNodes(map, *entry)
+                             | kdl::transform([&](const auto& nodesToAdd) {
+                                 auto transaction =
+                                   Transaction{map, "Apply Autosave Journal"};
+                                 if (!nodesToRemove.empty())
+                                 {
+                                   removeNodes(map, nodesToRemove);
+                                 }
+                                 if (!nodesToAdd.empty())
+                                 {
+                                   addNodes(map, nodesToAdd);
+                                 }
+                                 transaction.commit();
+                               });
+                    });
+         });
+}
+
+} // namespace tb::mdl
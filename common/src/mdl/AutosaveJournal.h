@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "NotifierConnection.h"
+#include "Result.h"
+#include "mdl/Entity.h"
+#include "mdl/Layer.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class LayerNode;
+class Map;
+class Node;
+
+/**
+ * Tracks the changes made to a map since the last autosave snapshot was written and
+ * creates journal entries that describe the difference between the snapshot and the
+ * current state of the map.
+ *
+ * The journal works on the granularity of top level nodes, which are the direct
+ * children of a layer. If any descendant of a top level node changes, the entire top
+ * level node is written to the next entry. Snapshot nodes are identified by the line
+ * number at which they begin in the snapshot file.
+ *
+ * Every entry is cumulative, so restoring a map only requires applying the last
+ * complete entry of a journal to the corresponding snapshot.
+ *
+ * Changes to the world or to a layer itself cannot be expressed by an entry. After such
+ * a change, the journal has no snapshot until the next one is recorded. Adding or
+ * removing nodes notifies their layer and the world as well, so the journal compares
+ * the world and the layers against their state in the snapshot to detect such changes.
+ */
+class AutosaveJournal
+{
+private:
+  struct SnapshotNode
+  {
+    size_t lineNumber;
+    const LayerNode* layer;
+  };
+
+  Map& m_map;
+  bool m_hasSnapshot = false;
+  std::unordered_map<const Node*, SnapshotNode> m_snapshotNodes;
+  std::unordered_set<const Node*> m_changedNodes;
+  Entity m_worldEntity;
+  std::vector<std::tuple<const LayerNode*, Layer>> m_layers;
+  size_t m_entryCount = 0;
+
+  NotifierConnection m_notifierConnection;
+
+public:
+  explicit AutosaveJournal(Map& map);
+
+  /**
+   * Indicates whether the changes since the last snapshot can be written as an entry.
+   */
+  bool hasSnapshot() const;
+
+  /**
+   * Returns the number of entries created since the last snapshot.
+   */
+  size_t entryCount() const;
+
+  /**
+   * Records the current state of the map as the snapshot against which the following
+   * entries are created.
+   *
+   * Must be called immediately after the map was written to the snapshot file, because
+   * the line numbers of the nodes are taken from the last serialization.
+   */
+  void recordSnapshot();
+
+  /**
+   * Discards the current snapshot, e.g. because it could not be written.
+   */
+  void discardSnapshot();
+
+  /**
+   * Creates an entry that contains every change since the last snapshot.
+   *
+   * Expects that the journal has a snapshot.
+   */
+  std::string createEntry();
+
+private:
+  void connectObservers();
+
+  void mapWasReset(Map& map);
+  void nodesDidChange(const std::vector<Node*>& nodes);
+
+  std::vector<std::tuple<const LayerNode*, Layer>> currentLayers() const;
+  bool layersOrWorldChanged() const;
+};
+
+/**
+ * Returns the first line of a journal that belongs to the given snapshot file.
+ */
+std::string makeAutosaveJournalHeader(const std::filesystem::path& snapshotFilename);
+
+/**
+ * Returns the name of the snapshot file to which the given journal belongs.
+ */
+Result<std::filesystem::path> readAutosaveJournalSnapshotFilename(
+  std::string_view journal);
+
+/**
+ * Applies the last complete entry of the given journal to the given map, which must have
+ * been loaded from the journal's snapshot file.
+ *
+ * Incomplete entries at the end of the journal, e.g. due to a crash while writing them,
+ * are ignored.
+ */
+Result<void> applyAutosaveJournal(Map& map, std::string_view journal);
+
+} // namespace tb::mdl
@@ -20,11 +20,13 @@
 #include "Autosaver.h"
 
 #include "Logger.h"
+#include "io/CompressedMapFile.h"
 #include "io/DiskFileSystem.h"
 #include "io/DiskIO.h"
 #include "io/FileSystem.h"
 #include "io/PathInfo.h"
 #include "io/TraversalMode.h"
+#include "mdl/AutosaveJournal.h"
 #include "mdl/Map.h"
 
 #include "kdl/path_utils.h"
@@ -32,12 +34,16 @@
 #include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
 #include <algorithm>
 #include <cassert>
+#include <future>
+#include <iterator>
+#include <sstream>
 
 namespace tb::mdl
 {
@@ -111,8 +117,102 @@ Result<void> cleanBackups(
          | kdl::fold;
 }
 
+/**
+ * Rotates the existing backups and returns the absolute path of the next backup file.
+ */
+Result<std::filesystem::path> prepareBackup(
+  Logger& logger, const std::filesystem::path& mapPath, const size_t maxBackups)
+{
+  const auto mapBasename = mapPath.stem();
+
+  return createBackupFileSystem(mapPath) | kdl::and_then([&](auto fs) {
+           return collectBackups(fs, mapBasename) | kdl::and_then([&](auto backups) {
+                    return thinBackups(logger, fs, backups, maxBackups);
+                  })
+                  | kdl::and_then([&](auto remainingBackups) {
+                      return cleanBackups(fs, remainingBackups, mapBasename)
+                             | kdl::and_then([&]() {
+                                 assert(remainingBackups.size() < maxBackups);
+                                 const auto backupNo = remainingBackups.size() + 1;
+                                 return fs.makeAbsolute(
+                                   makeBackupName(mapBasename, backupNo));
+                               });
+                    });
+         });
+}
+
+/**
+ * Writes the given map file contents to the given backup file, compressing them if
+ * requested.
+ */
+Result<void> writeBackup(
+  const std::filesystem::path& backupFilePath,
+  const std::string& mapStr,
+  const bool compress)
+{
+  if (compress)
+  {
+    return io::compressMapFile(mapStr) | kdl::and_then([&](const auto& compressedStr) {
+             return io::Disk::withOutputStream(
+               backupFilePath, std::ios::out | std::ios::binary, [&](auto& stream) {
+                 stream << compressedStr;
+               });
+           });
+  }
+
+  return io::Disk::withOutputStream(
+    backupFilePath, [&](auto& stream) { stream << mapStr; });
+}
+
+/**
+ * Starts a new journal for the given backup file, replacing the previous journal.
+ */
+Result<void> resetJournal(
+  const std::filesystem::path& mapPath, const std::filesystem::path& backupFilePath)
+{
+  return io::Disk::withOutputStream(makeAutosaveJournalPath(mapPath), [&](auto& stream) {
+    stream << makeAutosaveJournalHeader(backupFilePath.filename());
+  });
+}
+
+Result<std::filesystem::path> appendToJournal(
+  const std::filesystem::path& mapPath, const std::string& entry)
+{
+  const auto journalPath = makeAutosaveJournalPath(mapPath);
+  return io::Disk::withOutputStream(
+           journalPath,
+           std::ios::out | std::ios::app,
+           [&](auto& stream) { stream << entry; })
+         | kdl::transform([&]() { return journalPath; });
+}
+
+/**
+ * Indicates whether the file at the given path was modified after the file at the other
+ * path.
+ */
+bool isNewerThan(
+  const std::filesystem::path& path, const std::filesystem::path& otherPath)
+{
+  auto error = std::error_code{};
+  const auto modificationTime = std::filesystem::last_write_time(path, error);
+  if (error)
+  {
+    return false;
+  }
+
+  const auto otherModificationTime = std::filesystem::last_write_time(otherPath, error);
+  return error || modificationTime > otherModificationTime;
+}
+
 } // namespace
 
+struct Autosaver::PendingAutosave
+{
+  BufferedLogger logger;
+  bool isJournalEntry = false;
+  std::future<Result<std::filesystem::path>> backupFilePath;
+};
+
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename_)
 {
   return
@@ -129,55 +229,271 @@ io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename_)
     };
 }
 
+std::filesystem::path makeAutosaveJournalPath(const std::filesystem::path& mapPath)
+{
+  return mapPath.parent_path() / "autosave"
+         / kdl::path_add_extension(mapPath.stem(), ".journal");
+}
+
+std::optional<AutosaveRecovery> findAutosaveRecovery(
+  const std::filesystem::path& mapPath)
+{
+  const auto journalPath = makeAutosaveJournalPath(mapPath);
+  if (
+    io::Disk::pathInfo(journalPath) != io::PathInfo::File
+    || !isNewerThan(journalPath, mapPath))
+  {
+    return std::nullopt;
+  }
+
+  return io::Disk::withInputStream(
+           journalPath,
+           [](auto& stream) {
+             return std::string{std::istreambuf_iterator<char>{stream}, {}};
+           })
+         | kdl::and_then([&](auto journal) {
+             return readAutosaveJournalSnapshotFilename(journal)
+                    | kdl::transform([&](const auto& snapshotFilename) {
+                        return AutosaveRecovery{
+                          journalPath.parent_path() / snapshotFilename,
+                          std::move(journal)};
+                      });
+           })
+         | kdl::transform([](auto recovery) {
+             return io::Disk::pathInfo(recovery.snapshotPath) == io::PathInfo::File
+                      ? std::optional{std::move(recovery)}
+                      : std::nullopt;
+           })
+         | kdl::value_or(std::nullopt);
+}
+
+Result<void> deleteAutosaveJournal(const std::filesystem::path& mapPath)
+{
+  return io::Disk::deleteFile(makeAutosaveJournalPath(mapPath))
+         | kdl::transform([](auto) {});
+}
+
 Autosaver::Autosaver(
-  Map& map, const std::chrono::milliseconds saveInterval, const size_t maxBackups)
+  Map& map,
+  const std::chrono::milliseconds saveInterval,
+  const size_t maxBackups,
+  const AutosaveMode mode,
+  const size_t maxJournalEntries,
+  const bool compressBackups)
   : m_map{map}
   , m_saveInterval{saveInterval}
   , m_maxBackups{maxBackups}
   , m_lastSaveTime{Clock::now()}
   , m_lastModificationCount{m_map.modificationCount()}
+  , m_mode{mode}
+  , m_maxJournalEntries{maxJournalEntries}
+  , m_journal{
+      maxJournalEntries > 0 ? std::make_unique<AutosaveJournal>(m_map) : nullptr}
+  , m_compressBackups{compressBackups}
+{
+}
+
+Autosaver::~Autosaver()
 {
+  waitForPendingAutosave();
 }
 
 void Autosaver::triggerAutosave()
 {
+  if (!finishPendingAutosave())
+  {
+    return;
+  }
+
   if (
     m_map.modified() && m_map.modificationCount() != m_lastModificationCount
     && Clock::now() - m_lastSaveTime >= m_saveInterval && m_map.persistent())
   {
-    autosave();
+    if (shouldAppendJournalEntry())
+    {
+      if (m_mode == AutosaveMode::Background)
+      {
+        appendJournalEntryInBackground();
+      }
+      else
+      {
+        appendJournalEntry();
+      }
+    }
+    else if (m_mode == AutosaveMode::Background)
+    {
+      autosaveInBackground();
+    }
+    else
+    {
+      autosave();
+    }
+  }
+}
+
+void Autosaver::waitForPendingAutosave()
+{
+  if (m_pendingAutosave)
+  {
+    m_pendingAutosave->backupFilePath.wait();
+    finishPendingAutosave();
   }
 }
 
+bool Autosaver::finishPendingAutosave()
+{
+  using namespace std::chrono_literals;
+
+  if (m_pendingAutosave)
+  {
+    if (m_pendingAutosave->backupFilePath.wait_for(0s) != std::future_status::ready)
+    {
+      return false;
+    }
+
+    m_pendingAutosave->logger.flush(m_map.logger());
+    m_pendingAutosave->backupFilePath.get()
+      | kdl::transform([&](const auto& backupFilePath) {
+          if (m_pendingAutosave->isJournalEntry)
+          {
+            m_map.logger().info() << "Appended autosave journal entry to "
+                                  << backupFilePath;
+          }
+          else
+          {
+            m_map.logger().info() << "Created autosave backup at " << backupFilePath;
+          }
+        })
+      | kdl::transform_error([&](auto e) {
+          if (m_journal)
+          {
+            // the journal must not refer to a backup that may not have been written
+            m_journal->discardSnapshot();
+          }
+          m_map.logger().error() << "Aborting autosave: " << e.msg;
+        });
+
+    m_pendingAutosave.reset();
+  }
+
+  return true;
+}
+
+bool Autosaver::shouldAppendJournalEntry() const
+{
+  return m_journal && m_journal->hasSnapshot()
+         && m_journal->entryCount() < m_maxJournalEntries;
+}
+
 void Autosaver::autosave()
 {
   const auto& mapPath = m_map.path();
   assert(io::Disk::pathInfo(mapPath) == io::PathInfo::File);
 
-  const auto mapFilename = mapPath.filename();
-  const auto mapBasename = mapPath.stem();
+  prepareBackup(m_map.logger(), mapPath, m_maxBackups)
+    | kdl::and_then([&](const auto& backupFilePath) -> Result<std::filesystem::path> {
+        m_lastSaveTime = Clock::now();
+        m_lastModificationCount = m_map.modificationCount();
+        if (m_compressBackups)
+        {
+          auto stream = std::stringstream{};
+          m_map.saveTo(stream);
 
-  createBackupFileSystem(mapPath) | kdl::and_then([&](auto fs) {
-    return collectBackups(fs, mapBasename) | kdl::and_then([&](auto backups) {
-             return thinBackups(m_map.logger(), fs, backups, m_maxBackups);
-           })
-           | kdl::and_then([&](auto remainingBackups) {
-               return cleanBackups(fs, remainingBackups, mapBasename)
-                      | kdl::and_then([&]() {
-                          assert(remainingBackups.size() < m_maxBackups);
-                          const auto backupNo = remainingBackups.size() + 1;
-                          return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
-                        });
-             });
-  }) | kdl::transform([&](const auto& backupFilePath) {
-    m_lastSaveTime = Clock::now();
-    m_lastModificationCount = m_map.modificationCount();
-    m_map.saveTo(backupFilePath);
-
-    m_map.logger().info() << "Created autosave backup at " << backupFilePath;
-  }) | kdl::transform_error([&](auto e) {
-    m_map.logger().error() << "Aborting autosave: " << e.msg;
-  });
+          return writeBackup(backupFilePath, stream.str(), true)
+                 | kdl::transform([&]() { return backupFilePath; });
+        }
+
+        m_map.saveTo(backupFilePath);
+        return backupFilePath;
+      })
+    | kdl::transform([&](const auto& backupFilePath) {
+        m_map.logger().info() << "Created autosave backup at " << backupFilePath;
+        return backupFilePath;
+      })
+    | kdl::and_then([&](const auto& backupFilePath) -> Result<void> {
+        if (m_journal)
+        {
+          m_journal->recordSnapshot();
+          return resetJournal(mapPath, backupFilePath);
+        }
+        return kdl::void_success;
+      })
+    | kdl::transform_error([&](auto e) {
+        if (m_journal)
+        {
+          m_journal->discardSnapshot();
+        }
+        m_map.logger().error() << "Aborting autosave: " << e.msg;
+      });
+}
+
+void Autosaver::autosaveInBackground()
+{
+  const auto mapPath = m_map.path();
+  assert(io::Disk::pathInfo(mapPath) == io::PathInfo::File);
+
+  // the nodes must not be accessed from another thread, so we serialize them here
+  auto stream = std::stringstream{};
+  m_map.saveTo(stream);
+
+  const auto resetJournalAfterSave = m_journal != nullptr;
+  if (m_journal)
+  {
+    m_journal->recordSnapshot();
+  }
+
+  m_lastSaveTime = Clock::now();
+  m_lastModificationCount = m_map.modificationCount();
+
+  m_pendingAutosave = std::make_unique<PendingAutosave>();
+  m_pendingAutosave->backupFilePath = m_map.taskManager().run_task(std::function{
+    [&logger = m_pendingAutosave->logger,
+     mapPath,
+     maxBackups = m_maxBackups,
+     resetJournalAfterSave,
+     compress = m_compressBackups,
+     mapStr = stream.str()]() {
+      return prepareBackup(logger, mapPath, maxBackups)
+             | kdl::and_then([&](auto backupFilePath) {
+                 return writeBackup(backupFilePath, mapStr, compress)
+                        | kdl::and_then([&]() {
+                            return resetJournalAfterSave
+                                     ? resetJournal(mapPath, backupFilePath)
+                                     : Result<void>{};
+                          })
+                        | kdl::transform([&]() { return backupFilePath; });
+               });
+    }});
+}
+
+void Autosaver::appendJournalEntry()
+{
+  const auto& mapPath = m_map.path();
+
+  m_lastSaveTime = Clock::now();
+  m_lastModificationCount = m_map.modificationCount();
+
+  appendToJournal(mapPath, m_journal->createEntry())
+    | kdl::transform([&](const auto& journalPath) {
+        m_map.logger().info() << "Appended autosave journal entry to " << journalPath;
+      })
+    | kdl::transform_error([&](auto e) {
+        m_journal->discardSnapshot();
+        m_map.logger().error() << "Aborting autosave: " << e.msg;
+      });
+}
+
+void Autosaver::appendJournalEntryInBackground()
+{
+  m_lastSaveTime = Clock::now();
+  m_lastModificationCount = m_map.modificationCount();
+
+  m_pendingAutosave = std::make_unique<PendingAutosave>();
+  m_pendingAutosave->isJournalEntry = true;
+  m_pendingAutosave->backupFilePath = m_map.taskManager().run_task(std::function{
+    [mapPath = m_map.path(), entry = m_journal->createEntry()]() {
+      return appendToJournal(mapPath, entry);
+    }});
 }
 
 } // namespace tb::mdl
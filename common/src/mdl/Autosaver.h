@@ -19,17 +19,70 @@
 
 #pragma once
 
+#include "Result.h"
 #include "io/PathMatcher.h"
 
 #include <chrono>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
 
 namespace tb::mdl
 {
+class AutosaveJournal;
 class Map;
 
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
 
+/**
+ * Returns the path of the autosave journal that belongs to the map at the given path.
+ */
+std::filesystem::path makeAutosaveJournalPath(const std::filesystem::path& mapPath);
+
+/**
+ * The changes to a map that were autosaved, but not saved to the map file.
+ */
+struct AutosaveRecovery
+{
+  /**
+   * The absolute path of the backup that the journal belongs to.
+   */
+  std::filesystem::path snapshotPath;
+  std::string journal;
+};
+
+/**
+ * Returns the autosaved changes to the map at the given path if its autosave journal was
+ * written after the map file was last saved, e.g. because the editor crashed. Pass the
+ * result to Map::recoverAutosave to restore the changes.
+ *
+ * Returns std::nullopt if there is no journal, if the journal is older than the map file,
+ * or if the backup that the journal belongs to does not exist anymore.
+ */
+std::optional<AutosaveRecovery> findAutosaveRecovery(
+  const std::filesystem::path& mapPath);
+
+/**
+ * Deletes the autosave journal of the map at the given path, e.g. after the map was
+ * closed normally or the user chose not to recover its changes. The backups are kept.
+ */
+Result<void> deleteAutosaveJournal(const std::filesystem::path& mapPath);
+
+enum class AutosaveMode
+{
+  /**
+   * The map is serialized and written to the backup file on the calling thread.
+   */
+  Blocking,
+  /**
+   * The map is serialized into memory on the calling thread, and the backups are rotated
+   * and the backup file is written by a task. The outcome is logged by the next call to
+   * triggerAutosave or waitForPendingAutosave.
+   */
+  Background,
+};
+
 class Autosaver
 {
 private:
@@ -58,16 +111,57 @@ private:
    */
   size_t m_lastModificationCount;
 
+  AutosaveMode m_mode;
+
+  /**
+   * The maximum number of journal entries that are appended to the journal of the last
+   * backup before a new backup is created. If this is 0, no journal is kept and every
+   * autosave creates a new backup.
+   */
+  size_t m_maxJournalEntries;
+  std::unique_ptr<AutosaveJournal> m_journal;
+
+  /**
+   * Whether the backups are written as compressed map files, see io::compressMapFile.
+   * In background mode, the compression is done by the task that writes the backup.
+   */
+  bool m_compressBackups;
+
+  struct PendingAutosave;
+  std::unique_ptr<PendingAutosave> m_pendingAutosave;
+
 public:
   explicit Autosaver(
     Map& map,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
-    size_t maxBackups = 50);
+    size_t maxBackups = 50,
+    AutosaveMode mode = AutosaveMode::Blocking,
+    size_t maxJournalEntries = 0,
+    bool compressBackups = false);
+
+  ~Autosaver();
 
   void triggerAutosave();
 
+  /**
+   * Blocks until a pending background autosave has finished and logs its outcome.
+   */
+  void waitForPendingAutosave();
+
 private:
+  /**
+   * Logs the outcome of a pending background autosave if it has finished.
+   *
+   * Returns true if no autosave is pending anymore.
+   */
+  bool finishPendingAutosave();
+
+  bool shouldAppendJournalEntry() const;
+
   void autosave();
+  void autosaveInBackground();
+  void appendJournalEntry();
+  void appendJournalEntryInBackground();
 };
 
 } // namespace tb::mdl
@@ -30,7 +30,9 @@
 #include "vm/mat_ext.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <array>
 #include <cassert>
+#include <optional>
 
 namespace tb::mdl
 {
@@ -329,8 +331,16 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   |    surface row index
   |
   value of v
+
+  The surfaces are evaluated by first evaluating the rows of their control points at u and
+  then evaluating the resulting curve at v. The first step does not depend on v, so it
+  is done once per grid column for each row of surfaces.
   */
 
+  auto curvePoints = std::vector<std::array<BezierPatch::Point, 3>>{};
+  curvePoints.reserve(gridPointColumnCount);
+
+  auto currentSurfaceRow = std::optional<size_t>{};
   for (size_t gridRow = 0u; gridRow < gridPointRowCount; ++gridRow)
   {
     const size_t surfaceRow =
@@ -338,17 +348,30 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
     const double v = static_cast<double>(gridRow - surfaceRow * quadsPerSurfaceSide)
                      / static_cast<double>(quadsPerSurfaceSide);
 
-    for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+    if (surfaceRow != currentSurfaceRow)
+    {
+      curvePoints.clear();
+      for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+      {
+        const size_t surfaceCol =
+          (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
+        const double u = static_cast<double>(gridCol - surfaceCol * quadsPerSurfaceSide)
+                         / static_cast<double>(quadsPerSurfaceSide);
+
+        const auto& surfaceControlPoints =
+          allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
+        curvePoints.push_back({
+          vm::evaluate_quadratic_bezier_curve(surfaceControlPoints[0], u),
+          vm::evaluate_quadratic_bezier_curve(surfaceControlPoints[1], u),
+          vm::evaluate_quadratic_bezier_curve(surfaceControlPoints[2], u),
+        });
+      }
+      currentSurfaceRow = surfaceRow;
+    }
+
+    for (const auto& curve : curvePoints)
     {
-      const size_t surfaceCol =
-        (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
-      const double u = static_cast<double>(gridCol - surfaceCol * quadsPerSurfaceSide)
-                       / static_cast<double>(quadsPerSurfaceSide);
-
-      const auto& surfaceControlPoints =
-        allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
-      auto point = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-      grid.push_back(std::move(point));
+      grid.push_back(vm::evaluate_quadratic_bezier_curve(curve, v));
     }
   }
 
@@ -27,6 +27,7 @@
 #include "mdl/UVCoordSystem.h"
 
 #include "kdl/range_utils.h"
+#include "kdl/ranges/to.h"
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -38,7 +39,9 @@
 #include "vm/segment.h"
 #include "vm/util.h"
 
+#include <algorithm>
 #include <iterator>
+#include <ranges>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -46,10 +49,89 @@
 
 namespace tb::mdl
 {
+namespace
+{
 
-kdl_reflect_impl(Brush);
+bool geometryMatchesFaces(
+  const std::vector<BrushFace>& faces,
+  const std::vector<vm::vec3d>& vertexPositions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices,
+  const double epsilon)
+{
+  if (faces.size() != faceVertexIndices.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    const auto& boundary = faces[i].boundary();
+    const auto& indices = faceVertexIndices[i];
+    if (
+      indices.size() < 3 || !std::ranges::all_of(indices, [&](const auto index) {
+        return index < vertexPositions.size()
+               && boundary.point_status(vertexPositions[index], epsilon)
+                    == vm::plane_status::inside;
+      }))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<vm::plane3d> faceBoundaries(const std::vector<BrushFace>& faces)
+{
+  return faces | std::views::transform([](const auto& face) { return face.boundary(); })
+         | kdl::ranges::to<std::vector>();
+}
+
+/**
+ * Checks whether the given transformation is a translation combined with a rotation by
+ * multiples of 90 degrees about the coordinate axes. Such a transformation maps a brush
+ * onto a congruent brush with the same topology.
+ */
+bool isAxisAlignedRigidTransformation(const vm::mat4x4d& transformation)
+{
+  constexpr auto epsilon = vm::constants<double>::almost_zero();
+
+  if (!vm::is_equal(transformation[3][3], 1.0, epsilon))
+  {
+    return false;
+  }
+
+  for (size_t c = 0; c < 3; ++c)
+  {
+    if (!vm::is_zero(transformation[c][3], epsilon))
+    {
+      return false;
+    }
+
+    size_t unitCount = 0;
+    for (size_t r = 0; r < 3; ++r)
+    {
+      const auto value = vm::abs(transformation[c][r]);
+      if (vm::is_equal(value, 1.0, epsilon))
+      {
+        ++unitCount;
+      }
+      else if (!vm::is_zero(value, epsilon))
+      {
+        return false;
+      }
+    }
+
+    if (unitCount != 1)
+    {
+      return false;
+    }
+  }
 
-class Brush::CopyCallback : public BrushGeometry::CopyCallback
+  return vm::is_orientation_preserving_transform(transformation);
+}
+
+class CopyFacePayloads : public BrushGeometry::CopyCallback
 {
 public:
   void faceWasCopied(
@@ -59,14 +141,16 @@ public:
   }
 };
 
+} // namespace
+
+kdl_reflect_impl(Brush);
+
 Brush::Brush() {}
 
 Brush::Brush(const Brush& other)
   : m_faces{other.m_faces}
-  , m_geometry{
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr}
+  , m_geometry{other.m_geometry}
+  , m_compactGeometry{other.m_compactGeometry}
 {
   if (m_geometry)
   {
@@ -105,6 +189,51 @@ Result<Brush> Brush::create(const vm::bbox3d& worldBounds, std::vector<BrushFace
          | kdl::transform([&]() { return std::move(brush); });
 }
 
+Result<Brush> Brush::create(
+  const vm::bbox3d& worldBounds,
+  std::vector<BrushFace> faces,
+  const std::vector<vm::vec3d>& vertexPositions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices)
+{
+  if (!geometryMatchesFaces(
+        faces, vertexPositions, faceVertexIndices, CloseVertexEpsilon))
+  {
+    return create(worldBounds, std::move(faces));
+  }
+
+  auto facePlanes = std::vector<vm::plane3d>{};
+  facePlanes.reserve(faces.size());
+  for (const auto& face : faces)
+  {
+    facePlanes.push_back(face.boundary());
+  }
+
+  auto geometry =
+    std::make_unique<BrushGeometry>(vertexPositions, faceVertexIndices, facePlanes);
+  if (!geometry->closed() || !worldBounds.contains(geometry->bounds()))
+  {
+    return create(worldBounds, std::move(faces));
+  }
+
+  auto brush = Brush{std::move(faces)};
+
+  auto faceIndex = size_t(0);
+  for (auto* faceGeometry : geometry->faces())
+  {
+    brush.m_faces[faceIndex].setGeometry(faceGeometry);
+    faceGeometry->setPayload(faceIndex);
+    ++faceIndex;
+  }
+
+  brush.m_compactGeometry = std::make_shared<const CompactBrushGeometry>(
+    *geometry, faceBoundaries(brush.m_faces));
+  brush.m_geometry = std::move(geometry);
+
+  assert(brush.checkFaceLinks());
+
+  return brush;
+}
+
 Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
 {
   // First, add all faces to the brush geometry
@@ -153,6 +282,8 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
   }
 
   m_faces = std::move(remainingFaces);
+  m_compactGeometry =
+    std::make_shared<const CompactBrushGeometry>(*geometry, faceBoundaries(m_faces));
   m_geometry = std::move(geometry);
 
   assert(checkFaceLinks());
@@ -160,10 +291,69 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
   return kdl::void_success;
 }
 
+Result<void> Brush::updateGeometryAfterTransform(
+  const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation)
+{
+  if (!m_geometry || !isAxisAlignedRigidTransformation(transformation))
+  {
+    return updateGeometryFromFaces(worldBounds);
+  }
+
+  // The geometry may be shared with copies of this brush, so it must not be modified in
+  // place unless this brush is its only owner.
+  if (m_geometry.use_count() > 1)
+  {
+    m_geometry = std::make_shared<BrushGeometry>(*m_geometry, CopyFacePayloads{});
+  }
+
+  m_geometry->transform(transformation);
+  m_geometry->correctVertexPositions();
+  if (!worldBounds.contains(m_geometry->bounds()))
+  {
+    return updateGeometryFromFaces(worldBounds);
+  }
+
+  for (auto* faceGeometry : m_geometry->faces())
+  {
+    auto& face = m_faces[*faceGeometry->payload()];
+    face.setGeometry(faceGeometry);
+    faceGeometry->setPlane(face.boundary());
+  }
+
+  // keep the faces in the same order as if the geometry had been rebuilt
+  BrushFace::sortFaces(m_faces);
+  auto originalFaceIndices = std::vector<size_t>{};
+  originalFaceIndices.reserve(m_faces.size());
+  for (size_t i = 0; i < m_faces.size(); ++i)
+  {
+    originalFaceIndices.push_back(*m_faces[i].geometry()->payload());
+    m_faces[i].geometry()->setPayload(i);
+  }
+
+  // rotated copies of a brush, e.g. in linked groups, can share the compact geometry's
+  // shape with the original brush
+  m_compactGeometry = std::make_shared<const CompactBrushGeometry>(
+    *m_geometry,
+    faceBoundaries(m_faces),
+    *m_compactGeometry,
+    transformation,
+    originalFaceIndices);
+
+  assert(checkFaceLinks());
+
+  return kdl::void_success;
+}
+
 const vm::bbox3d& Brush::bounds() const
 {
-  ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->bounds();
+  ensure(m_compactGeometry != nullptr, "geometry is null");
+  return m_compactGeometry->bounds();
+}
+
+const CompactBrushGeometry& Brush::compactGeometry() const
+{
+  ensure(m_compactGeometry != nullptr, "geometry is null");
+  return *m_compactGeometry;
 }
 
 std::optional<size_t> Brush::findFace(const std::string& materialName) const
@@ -1147,8 +1337,15 @@ std::vector<Result<Brush>> Brush::subtract(
   {
     auto nextResults = std::vector<BrushGeometry>{};
 
-    for (const BrushGeometry& fragment : result)
+    for (auto& fragment : result)
     {
+      // skip the expensive subtraction if the bounds show that the brushes are disjoint
+      if (!fragment.bounds().intersects(subtrahend->bounds()))
+      {
+        nextResults.push_back(std::move(fragment));
+        continue;
+      }
+
       auto subFragments = fragment.subtract(*subtrahend->m_geometry);
       nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
     }
@@ -1191,6 +1388,33 @@ Result<void> Brush::transform(
     }
   }
 
+  return updateGeometryAfterTransform(worldBounds, transformation);
+}
+
+Result<void> Brush::transform(
+  const vm::bbox3d& worldBounds,
+  const vm::mat4x4d& transformation,
+  const bool lockMaterials,
+  const Brush& expected)
+{
+  for (auto& face : m_faces)
+  {
+    if (!face.transform(transformation, lockMaterials).is_success())
+    {
+      return Error{"Brush has invalid face"};
+    }
+  }
+
+  // the expected brush's faces were sorted when its geometry was built
+  BrushFace::sortFaces(m_faces);
+  if (std::ranges::equal(m_faces, expected.m_faces, [](const auto& lhs, const auto& rhs) {
+        return lhs == rhs && lhs.uvCoordSystem() == rhs.uvCoordSystem();
+      }))
+  {
+    *this = expected;
+    return kdl::void_success;
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
@@ -21,6 +21,7 @@
 
 #include "Result.h"
 #include "mdl/BrushGeometry.h"
+#include "mdl/CompactBrushGeometry.h"
 
 #include "kdl/reflection_decl.h"
 
@@ -46,8 +47,6 @@ enum class MapFormat;
 class Brush
 {
 private:
-  class CopyCallback;
-
   /**
    * Epsilon value to use when finding a vertex after applying a vertex operation
    */
@@ -59,7 +58,11 @@ public:
 
 private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  // The geometry is never modified once it has been built, so copies of a brush share it
+  // until they rebuild their own.
+  std::shared_ptr<BrushGeometry> m_geometry;
+  std::shared_ptr<const CompactBrushGeometry> m_compactGeometry;
 
   kdl_reflect_decl(Brush, m_faces);
 
@@ -77,14 +80,43 @@ public:
   static Result<Brush> create(
     const vm::bbox3d& worldBounds, std::vector<BrushFace> faces);
 
+  /**
+   * Creates a brush from the given faces and precomputed geometry, e.g. geometry that was
+   * read from a map cache. The faces must be in the order of the geometry's faces, and
+   * each face is given by the indices of its vertices in counter clockwise order.
+   *
+   * If the geometry does not match the faces, e.g. because a face boundary has changed,
+   * or if it exceeds the world bounds, then the geometry is computed from the faces.
+   */
+  static Result<Brush> create(
+    const vm::bbox3d& worldBounds,
+    std::vector<BrushFace> faces,
+    const std::vector<vm::vec3d>& vertexPositions,
+    const std::vector<std::vector<size_t>>& faceVertexIndices);
+
 private:
   explicit Brush(std::vector<BrushFace> faces);
 
   Result<void> updateGeometryFromFaces(const vm::bbox3d& worldBounds);
 
+  /**
+   * Updates the geometry after the faces of this brush have been transformed by the
+   * given transformation. If the transformation maps the brush onto a congruent brush,
+   * then the existing geometry is transformed directly. Otherwise, the geometry is
+   * rebuilt from the transformed faces.
+   */
+  Result<void> updateGeometryAfterTransform(
+    const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation);
+
 public:
   const vm::bbox3d& bounds() const;
 
+  /**
+   * Returns a compact copy of this brush's geometry. Copies of a brush share their
+   * compact geometry until their geometry is changed.
+   */
+  const CompactBrushGeometry& compactGeometry() const;
+
 public: // face management:
   std::optional<size_t> findFace(const std::string& materialName) const;
   std::optional<size_t> findFace(const vm::vec3d& normal) const;
@@ -333,6 +365,26 @@ public:
   Result<void> transform(
     const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation, bool lockMaterials);
 
+  /**
+   * Applies the given transformation to this brush like transform(). If the transformed
+   * faces are equal to the faces of the given brush, then this brush becomes a copy of
+   * the given brush and shares its geometry instead of recomputing it.
+   *
+   * This is useful if the result of the transformation is likely known already, e.g. when
+   * updating a linked brush whose source has not changed.
+   *
+   * @param worldBounds the world bounds
+   * @param transformation the transformation to apply
+   * @param lockMaterials whether material alignment should be locked
+   * @param expected the brush that is the likely result of the transformation
+   * @return a void result or an error if the operation fails
+   */
+  Result<void> transform(
+    const vm::bbox3d& worldBounds,
+    const vm::mat4x4d& transformation,
+    bool lockMaterials,
+    const Brush& expected);
+
 public:
   bool contains(const vm::bbox3d& bounds) const;
   bool contains(const Brush& brush) const;
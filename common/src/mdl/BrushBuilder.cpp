@@ -27,6 +27,7 @@
 #include "kdl/ranges/to.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/intersection.h"
@@ -36,6 +37,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <functional>
 #include <ranges>
 #include <string>
 #include <utility>
@@ -459,7 +461,8 @@ Result<std::vector<Brush>> BrushBuilder::createHollowCylinder(
   const double thickness,
   const CircleShape& circleShape,
   const vm::axis::type axis,
-  const std::string& textureName) const
+  const std::string& textureName,
+  kdl::task_manager& taskManager) const
 {
   const auto toXY = vm::rotation_matrix(vm::vec3d::axis(axis), vm::vec3d{0, 0, 1});
   const auto fromXY = vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::vec3d::axis(axis));
@@ -474,19 +477,19 @@ Result<std::vector<Brush>> BrushBuilder::createHollowCylinder(
 
       const auto numFragments = outerCircle.size();
 
-      auto brushes = std::vector<Result<Brush>>{};
-      brushes.reserve(numFragments);
-
-      for (size_t i = 0; i < numFragments; ++i)
-      {
-        const auto fragmentVertices =
-          makeHollowCylinderFragmentVertices(outerCircle, innerCircle, i, boundsXY);
-        const auto rotatedFragmentVertices = fromXY * fragmentVertices;
+      auto tasks =
+        std::views::iota(size_t(0), numFragments)
+        | std::views::transform([&](const size_t i) {
+            return std::function{[&, i]() {
+              const auto fragmentVertices =
+                makeHollowCylinderFragmentVertices(outerCircle, innerCircle, i, boundsXY);
+              const auto rotatedFragmentVertices = fromXY * fragmentVertices;
 
-        brushes.push_back(createBrush(rotatedFragmentVertices, textureName));
-      }
+              return createBrush(rotatedFragmentVertices, textureName);
+            }};
+          });
 
-      return brushes | kdl::fold;
+      return taskManager.run_tasks_and_wait(tasks) | kdl::fold;
     });
 }
 
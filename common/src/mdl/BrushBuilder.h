@@ -30,6 +30,11 @@
 #include <string>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 class Brush;
@@ -88,12 +93,17 @@ public:
     vm::axis::type axis,
     const std::string& textureName) const;
 
+  /**
+   * Creates one brush per segment of the cylinder wall. The brushes are built in parallel
+   * on the given task manager.
+   */
   Result<std::vector<Brush>> createHollowCylinder(
     const vm::bbox3d& bounds,
     double thickness,
     const CircleShape& circleShape,
     vm::axis::type axis,
-    const std::string& textureName) const;
+    const std::string& textureName,
+    kdl::task_manager& taskManager) const;
 
   Result<Brush> createScalableCylinder(
     const vm::bbox3d& bounds,
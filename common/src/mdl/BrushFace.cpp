@@ -36,6 +36,7 @@
 #include "vm/bbox.h"
 #include "vm/intersection.h"
 #include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/plane_io.h" // IWYU pragma: keep
 #include "vm/scalar.h"
 #include "vm/util.h"
@@ -68,6 +69,7 @@ BrushFace::BrushFace(const BrushFace& other)
   , m_lineNumber{other.m_lineNumber}
   , m_lineCount{other.m_lineCount}
   , m_selected{other.m_selected}
+  , m_tagsValid{other.m_tagsValid}
 {
 }
 
@@ -84,6 +86,7 @@ BrushFace::BrushFace(BrushFace&& other) noexcept
   , m_lineNumber{other.m_lineNumber}
   , m_lineCount{other.m_lineCount}
   , m_selected{other.m_selected}
+  , m_tagsValid{other.m_tagsValid}
 // NOLINTEND(bugprone-use-after-move)
 {
 }
@@ -108,6 +111,7 @@ void swap(BrushFace& lhs, BrushFace& rhs) noexcept
   swap(lhs.m_lineNumber, rhs.m_lineNumber);
   swap(lhs.m_lineCount, rhs.m_lineCount);
   swap(lhs.m_selected, rhs.m_selected);
+  swap(lhs.m_tagsValid, rhs.m_tagsValid);
   swap(lhs.m_markedToRenderFace, rhs.m_markedToRenderFace);
 }
 
@@ -409,6 +413,7 @@ void BrushFace::setAttributes(const BrushFaceAttributes& attributes)
 {
   const auto oldRotation = m_attributes.rotation();
   m_attributes = attributes;
+  m_tagsValid = false;
   m_uvCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
 }
 
@@ -424,9 +429,18 @@ bool BrushFace::setAttributes(const BrushFace& other)
   result |= m_attributes.setSurfaceContents(other.attributes().surfaceContents());
   result |= m_attributes.setSurfaceFlags(other.attributes().surfaceFlags());
   result |= m_attributes.setSurfaceValue(other.attributes().surfaceValue());
+  if (result)
+  {
+    m_tagsValid = false;
+  }
   return result;
 }
 
+void BrushFace::internAttributes()
+{
+  m_attributes.intern();
+}
+
 namespace
 {
 
@@ -526,6 +540,7 @@ bool BrushFace::setMaterial(Material* material)
   }
 
   m_materialReference = AssetReference(material);
+  m_tagsValid = false;
   return true;
 }
 
@@ -636,10 +651,7 @@ Result<void> BrushFace::transform(const vm::mat4x4d& transform, const bool lockA
   const auto oldBoundary = m_boundary;
 
   m_boundary = m_boundary.transform(transform);
-  for (size_t i = 0; i < 3; ++i)
-  {
-    m_points[i] = transform * m_points[i];
-  }
+  vm::transform_points(transform, m_points);
 
   if (
     vm::dot(
@@ -849,6 +861,26 @@ bool BrushFace::isMarked() const
   return m_markedToRenderFace;
 }
 
+void BrushFace::updateTags(TagManager& tagManager)
+{
+  if (!m_tagsValid)
+  {
+    Taggable::updateTags(tagManager);
+    m_tagsValid = true;
+  }
+}
+
+void BrushFace::clearTags()
+{
+  Taggable::clearTags();
+  m_tagsValid = false;
+}
+
+void BrushFace::invalidateTags()
+{
+  m_tagsValid = false;
+}
+
 void BrushFace::doAcceptTagVisitor(TagVisitor& visitor)
 {
   visitor.visit(*this);
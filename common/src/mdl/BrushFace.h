@@ -93,6 +93,12 @@ private:
   mutable size_t m_lineCount = 0;
   bool m_selected = false;
 
+  /**
+   * Whether the smart tags were evaluated after the last change to the material or to any
+   * attribute that smart tags match against.
+   */
+  bool m_tagsValid = false;
+
   // brush renderer
   mutable bool m_markedToRenderFace = false;
 
@@ -194,6 +200,11 @@ public:
   void setAttributes(const BrushFaceAttributes& attributes);
   bool setAttributes(const BrushFace& other);
 
+  /**
+   * Shares this face's attributes with other faces that have equal interned attributes.
+   */
+  void internAttributes();
+
   int resolvedSurfaceContents() const;
   int resolvedSurfaceFlags() const;
   float resolvedSurfaceValue() const;
@@ -277,13 +288,27 @@ private:
 public: // brush renderer
   /**
    * This is used to cache results of evaluating the BrushRenderer Filter.
-   * It's only valid within a call to `BrushRenderer::validateBrush`.
+   * It's only valid within a call to `BrushRenderer::validate`.
    *
    * @param marked    whether the face is going to be rendered.
    */
   void setMarked(bool marked) const;
   bool isMarked() const;
 
+public: // smart tags
+  /**
+   * Evaluates the smart tags unless they are still valid, see invalidateTags.
+   */
+  void updateTags(TagManager& tagManager) override;
+  void clearTags() override;
+
+  /**
+   * Forces the next call to updateTags to evaluate the smart tags. This is done
+   * automatically when the material or the attributes change, but the material's default
+   * surface flags or parameters may change, too.
+   */
+  void invalidateTags();
+
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
   void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
@@ -19,55 +19,163 @@
 
 #include "BrushFaceAttributes.h"
 
+#include "kdl/hash_utils.h"
+#include "kdl/intern_pool.h"
 #include "kdl/reflection_impl.h"
 
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <ostream>
 #include <string>
 
 namespace tb::mdl
 {
 
+struct BrushFaceAttributes::Data
+{
+  std::string m_materialName;
+
+  vm::vec2f m_offset = vm::vec2f{0, 0};
+  vm::vec2f m_scale = vm::vec2f{1, 1};
+  float m_rotation = 0.0f;
+
+  std::optional<int> m_surfaceContents = std::nullopt;
+  std::optional<int> m_surfaceFlags = std::nullopt;
+  std::optional<float> m_surfaceValue = std::nullopt;
+
+  std::optional<Color> m_color = std::nullopt;
+
+  // interned records are shared by unrelated attributes and must never be modified
+  bool m_interned = false;
+
+  kdl_reflect_inline(
+    Data,
+    m_materialName,
+    m_offset,
+    m_scale,
+    m_rotation,
+    m_surfaceContents,
+    m_surfaceFlags,
+    m_surfaceValue,
+    m_color);
+
+  size_t hash() const
+  {
+    return kdl::hash(
+      m_materialName,
+      m_offset.x(),
+      m_offset.y(),
+      m_scale.x(),
+      m_scale.y(),
+      m_rotation,
+      m_surfaceContents,
+      m_surfaceFlags,
+      m_surfaceValue);
+  }
+};
+
 const std::string BrushFaceAttributes::NoMaterialName = "__TB_empty";
 
 BrushFaceAttributes::BrushFaceAttributes(std::string_view materialName)
-  : m_materialName{materialName}
+  : m_data{std::make_shared<Data>(Data{.m_materialName = std::string{materialName}})}
 {
 }
 
 BrushFaceAttributes::BrushFaceAttributes(
   std::string_view materialName, const BrushFaceAttributes& other)
-  : m_materialName{materialName}
-  , m_offset{other.m_offset}
-  , m_scale{other.m_scale}
-  , m_rotation{other.m_rotation}
-  , m_surfaceContents{other.m_surfaceContents}
-  , m_surfaceFlags{other.m_surfaceFlags}
-  , m_surfaceValue{other.m_surfaceValue}
-  , m_color{other.m_color}
+  : m_data{other.m_data}
 {
+  setMaterialName(std::string{materialName});
 }
 
-kdl_reflect_impl(BrushFaceAttributes);
+BrushFaceAttributes::BrushFaceAttributes(const BrushFaceAttributes& other) = default;
+
+BrushFaceAttributes& BrushFaceAttributes::operator=(
+  const BrushFaceAttributes& other) = default;
+
+BrushFaceAttributes::~BrushFaceAttributes() = default;
+
+void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs) noexcept
+{
+  using std::swap;
+  swap(lhs.m_data, rhs.m_data);
+}
+
+bool operator==(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs)
+{
+  return lhs.m_data == rhs.m_data || *lhs.m_data == *rhs.m_data;
+}
+
+std::ostream& operator<<(std::ostream& lhs, const BrushFaceAttributes& rhs)
+{
+  kdl::detail::print_reflective<std::tuple_size_v<decltype(rhs.m_data->members())>>(
+    lhs, "BrushFaceAttributes", rhs.m_data->member_names(), rhs.m_data->members());
+  return lhs;
+}
+
+bool BrushFaceAttributes::sharesData(const BrushFaceAttributes& other) const
+{
+  return m_data == other.m_data;
+}
+
+void BrushFaceAttributes::intern()
+{
+  struct DataHash
+  {
+    size_t operator()(const Data& data) const { return data.hash(); }
+  };
+
+  static auto pool = kdl::intern_pool<Data, DataHash>{};
+
+  if (!m_data->m_interned)
+  {
+    m_data = pool.intern(*m_data, [&]() {
+      auto data = *m_data;
+      data.m_interned = true;
+      return data;
+    });
+  }
+}
+
+template <typename F>
+bool BrushFaceAttributes::update(const bool changed, F f)
+{
+  if (changed)
+  {
+    // the record can be modified in place if nothing else refers to it
+    if (m_data.use_count() == 1 && !m_data->m_interned)
+    {
+      f(const_cast<Data&>(*m_data));
+    }
+    else
+    {
+      auto data = std::make_shared<Data>(*m_data);
+      data->m_interned = false;
+      f(*data);
+      m_data = std::move(data);
+    }
+  }
+  return changed;
+}
 
 const std::string& BrushFaceAttributes::materialName() const
 {
-  return m_materialName;
+  return m_data->m_materialName;
 }
 
 const vm::vec2f& BrushFaceAttributes::offset() const
 {
-  return m_offset;
+  return m_data->m_offset;
 }
 
 float BrushFaceAttributes::xOffset() const
 {
-  return m_offset.x();
+  return m_data->m_offset.x();
 }
 
 float BrushFaceAttributes::yOffset() const
 {
-  return m_offset.y();
+  return m_data->m_offset.y();
 }
 
 vm::vec2f BrushFaceAttributes::modOffset(
@@ -78,178 +186,132 @@ vm::vec2f BrushFaceAttributes::modOffset(
 
 const vm::vec2f& BrushFaceAttributes::scale() const
 {
-  return m_scale;
+  return m_data->m_scale;
 }
 
 float BrushFaceAttributes::xScale() const
 {
-  return m_scale.x();
+  return m_data->m_scale.x();
 }
 
 float BrushFaceAttributes::yScale() const
 {
-  return m_scale.y();
+  return m_data->m_scale.y();
 }
 
 float BrushFaceAttributes::rotation() const
 {
-  return m_rotation;
+  return m_data->m_rotation;
 }
 
 bool BrushFaceAttributes::hasSurfaceAttributes() const
 {
-  return m_surfaceContents || m_surfaceFlags || m_surfaceValue;
+  return m_data->m_surfaceContents || m_data->m_surfaceFlags || m_data->m_surfaceValue;
 }
 
 const std::optional<int>& BrushFaceAttributes::surfaceContents() const
 {
-  return m_surfaceContents;
+  return m_data->m_surfaceContents;
 }
 
 const std::optional<int>& BrushFaceAttributes::surfaceFlags() const
 {
-  return m_surfaceFlags;
+  return m_data->m_surfaceFlags;
 }
 
 const std::optional<float>& BrushFaceAttributes::surfaceValue() const
 {
-  return m_surfaceValue;
+  return m_data->m_surfaceValue;
 }
 
 bool BrushFaceAttributes::hasColor() const
 {
-  return m_color.has_value();
+  return m_data->m_color.has_value();
 }
 
 const std::optional<Color>& BrushFaceAttributes::color() const
 {
-  return m_color;
+  return m_data->m_color;
 }
 
 bool BrushFaceAttributes::valid() const
 {
-  return !vm::is_zero(m_scale.x(), vm::Cf::almost_zero())
-         && !vm::is_zero(m_scale.y(), vm::Cf::almost_zero());
+  return !vm::is_zero(m_data->m_scale.x(), vm::Cf::almost_zero())
+         && !vm::is_zero(m_data->m_scale.y(), vm::Cf::almost_zero());
 }
 
 bool BrushFaceAttributes::setMaterialName(const std::string& materialName)
 {
-  if (materialName != m_materialName)
-  {
-    m_materialName = materialName;
-    return true;
-  }
-  return false;
+  return update(materialName != m_data->m_materialName, [&](Data& data) {
+    data.m_materialName = materialName;
+  });
 }
 
 bool BrushFaceAttributes::setOffset(const vm::vec2f& offset)
 {
-  if (offset != m_offset)
-  {
-    m_offset = offset;
-    return true;
-  }
-  return false;
+  return update(
+    offset != m_data->m_offset, [&](Data& data) { data.m_offset = offset; });
 }
 
 bool BrushFaceAttributes::setXOffset(const float xOffset)
 {
-  if (xOffset != m_offset.x())
-  {
-    m_offset[0] = xOffset;
-    return true;
-  }
-  return false;
+  return update(
+    xOffset != m_data->m_offset.x(), [&](Data& data) { data.m_offset[0] = xOffset; });
 }
 
 bool BrushFaceAttributes::setYOffset(const float yOffset)
 {
-  if (yOffset != m_offset.y())
-  {
-    m_offset[1] = yOffset;
-    return true;
-  }
-  return false;
+  return update(
+    yOffset != m_data->m_offset.y(), [&](Data& data) { data.m_offset[1] = yOffset; });
 }
 
 bool BrushFaceAttributes::setScale(const vm::vec2f& scale)
 {
-  if (scale != m_scale)
-  {
-    m_scale = scale;
-    return true;
-  }
-  return false;
+  return update(scale != m_data->m_scale, [&](Data& data) { data.m_scale = scale; });
 }
 
 bool BrushFaceAttributes::setXScale(const float xScale)
 {
-  if (xScale != m_scale.x())
-  {
-    m_scale[0] = xScale;
-    return true;
-  }
-  return false;
+  return update(
+    xScale != m_data->m_scale.x(), [&](Data& data) { data.m_scale[0] = xScale; });
 }
 
 bool BrushFaceAttributes::setYScale(const float yScale)
 {
-  if (yScale != m_scale.y())
-  {
-    m_scale[1] = yScale;
-    return true;
-  }
-  return false;
+  return update(
+    yScale != m_data->m_scale.y(), [&](Data& data) { data.m_scale[1] = yScale; });
 }
 
 bool BrushFaceAttributes::setRotation(const float rotation)
 {
-  if (rotation != m_rotation)
-  {
-    m_rotation = rotation;
-    return true;
-  }
-  return false;
+  return update(
+    rotation != m_data->m_rotation, [&](Data& data) { data.m_rotation = rotation; });
 }
 
 bool BrushFaceAttributes::setSurfaceContents(const std::optional<int>& surfaceContents)
 {
-  if (surfaceContents != m_surfaceContents)
-  {
-    m_surfaceContents = surfaceContents;
-    return true;
-  }
-  return false;
+  return update(surfaceContents != m_data->m_surfaceContents, [&](Data& data) {
+    data.m_surfaceContents = surfaceContents;
+  });
 }
 
 bool BrushFaceAttributes::setSurfaceFlags(const std::optional<int>& surfaceFlags)
 {
-  if (surfaceFlags != m_surfaceFlags)
-  {
-    m_surfaceFlags = surfaceFlags;
-    return true;
-  }
-  return false;
+  return update(surfaceFlags != m_data->m_surfaceFlags, [&](Data& data) {
+    data.m_surfaceFlags = surfaceFlags;
+  });
 }
 
 bool BrushFaceAttributes::setSurfaceValue(const std::optional<float>& surfaceValue)
 {
-  if (surfaceValue != m_surfaceValue)
-  {
-    m_surfaceValue = surfaceValue;
-    return true;
-  }
-  return false;
+  return update(surfaceValue != m_data->m_surfaceValue, [&](Data& data) {
+    data.m_surfaceValue = surfaceValue;
+  });
 }
 
 bool BrushFaceAttributes::setColor(const std::optional<Color>& color)
 {
-  if (color != m_color)
-  {
-    m_color = color;
-    return true;
-  }
-  return false;
+  return update(color != m_data->m_color, [&](Data& data) { data.m_color = color; });
 }
 
 } // namespace tb::mdl
@@ -21,10 +21,10 @@
 
 #include "Color.h"
 
-#include "kdl/reflection_decl.h"
-
 #include "vm/vec.h"
 
+#include <iosfwd>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -33,38 +33,49 @@ namespace tb::mdl
 {
 class Material;
 
+/**
+ * The attributes of a brush face.
+ *
+ * The attribute values are stored in an immutable record that is shared between copies
+ * and replaced when a value changes (copy-on-write). Interned attributes share their
+ * record with all other interned attributes that have equal values. Since most faces of a
+ * map use one of a few distinct attribute sets, this saves a lot of memory, and equal
+ * attributes can often be detected by comparing their records' addresses.
+ */
 class BrushFaceAttributes
 {
 public:
   static const std::string NoMaterialName;
 
 private:
-  std::string m_materialName;
-
-  vm::vec2f m_offset = vm::vec2f{0, 0};
-  vm::vec2f m_scale = vm::vec2f{1, 1};
-  float m_rotation = 0.0f;
-
-  std::optional<int> m_surfaceContents;
-  std::optional<int> m_surfaceFlags;
-  std::optional<float> m_surfaceValue;
-
-  std::optional<Color> m_color;
+  struct Data;
+  std::shared_ptr<const Data> m_data;
 
 public:
   explicit BrushFaceAttributes(std::string_view materialName);
   BrushFaceAttributes(std::string_view materialName, const BrushFaceAttributes& other);
 
-  kdl_reflect_decl(
-    BrushFaceAttributes,
-    m_materialName,
-    m_offset,
-    m_scale,
-    m_rotation,
-    m_surfaceContents,
-    m_surfaceFlags,
-    m_surfaceValue,
-    m_color);
+  // a moved-from instance would have no record, so moving copies the shared record
+  BrushFaceAttributes(const BrushFaceAttributes& other);
+  BrushFaceAttributes& operator=(const BrushFaceAttributes& other);
+  ~BrushFaceAttributes();
+
+  friend void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs) noexcept;
+
+  friend bool operator==(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs);
+  friend std::ostream& operator<<(std::ostream& lhs, const BrushFaceAttributes& rhs);
+
+  /**
+   * Indicates whether these attributes share their record with the given attributes. If
+   * so, the attributes are equal.
+   */
+  bool sharesData(const BrushFaceAttributes& other) const;
+
+  /**
+   * Replaces this instance's record with an equal interned record. This function is
+   * thread safe.
+   */
+  void intern();
 
   const std::string& materialName() const;
 
@@ -101,6 +112,10 @@ public:
   bool setSurfaceFlags(const std::optional<int>& surfaceFlags);
   bool setSurfaceValue(const std::optional<float>& surfaceValue);
   bool setColor(const std::optional<Color>& color);
+
+private:
+  template <typename F>
+  bool update(bool changed, F f);
 };
 
 } // namespace tb::mdl
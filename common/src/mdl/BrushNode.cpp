@@ -51,7 +51,8 @@ namespace tb::mdl
 const HitType::Type BrushNode::BrushHitType = HitType::freeType();
 
 BrushNode::BrushNode(Brush brush)
-  : m_brushRendererBrushCache(std::make_unique<render::BrushRendererBrushCache>())
+  : Node{Kind}
+  , m_brushRendererBrushCache(std::make_unique<render::BrushRendererBrushCache>())
   , m_brush(std::move(brush))
 {
   clearSelectedFaces();
@@ -124,7 +125,9 @@ void BrushNode::deselectFace(const size_t faceIndex)
 
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
-  m_brush.face(faceIndex).updateTags(tagManager);
+  auto& face = m_brush.face(faceIndex);
+  face.invalidateTags();
+  face.updateTags(tagManager);
 }
 
 void BrushNode::setFaceMaterial(const size_t faceIndex, Material* material)
@@ -367,14 +370,7 @@ std::optional<std::tuple<double, size_t>> BrushNode::findFaceHit(
 {
   if (vm::intersect_ray_bbox(ray, logicalBounds()))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
-    {
-      const auto& face = m_brush.face(i);
-      if (const auto distance = face.intersectWithRay(ray))
-      {
-        return std::tuple{*distance, i};
-      }
-    }
+    return m_brush.compactGeometry().intersectWithRay(ray);
   }
   return std::nullopt;
 }
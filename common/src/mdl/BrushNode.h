@@ -50,6 +50,7 @@ class ModelFactory;
 class BrushNode : public Node, public Object
 {
 public:
+  static constexpr auto Kind = NodeKind::Brush;
   static const HitType::Type BrushHitType;
 
 public:
@@ -0,0 +1,802 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CommandLog.h"
+
+#include "Error.h"
+#include "Logger.h"
+#include "io/NodeReader.h"
+#include "io/NodeWriter.h"
+#include "io/SimpleParserStatus.h"
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Node.h"
+#include "mdl/NodeContents.h"
+#include "mdl/PatchNode.h"
+#include "mdl/Transaction.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <tuple>
+
+namespace tb::mdl
+{
+namespace
+{
+
+const auto LogSnapshotKeyword = std::string_view{"snapshot"};
+const auto StepBeginKeyword = std::string_view{"step"};
+const auto StepDoKeyword = std::string_view{"do"};
+const auto StepUndoKeyword = std::string_view{"undo"};
+const auto StepRemoveKeyword = std::string_view{"remove"};
+const auto StepChangeKeyword = std::string_view{"change"};
+const auto StepAddKeyword = std::string_view{"add"};
+const auto StepEndKeyword = std::string_view{"end"};
+const auto DefaultLayerId = std::string_view{"default"};
+
+bool isLayerOrWorld(const Node* node)
+{
+  return dynamic_cast<const LayerNode*>(node) != nullptr
+         || dynamic_cast<const WorldNode*>(node) != nullptr;
+}
+
+/**
+ * Returns the ancestor of the given node (or the node itself) that is a direct child of
+ * a layer, or nullptr if there is no such node.
+ */
+Node* findTopLevelNode(Node* node)
+{
+  while (node && node->parent() && !dynamic_cast<LayerNode*>(node->parent()))
+  {
+    node = node->parent();
+  }
+  return node && node->parent() ? node : nullptr;
+}
+
+bool isTopLevelNode(const Node* node)
+{
+  return dynamic_cast<const LayerNode*>(node->parent()) != nullptr;
+}
+
+/**
+ * Returns the top level nodes of the given world ordered by the line numbers of their
+ * last serialization.
+ */
+std::vector<std::tuple<Node*, LayerNode*>> topLevelNodesInFileOrder(WorldNode& worldNode)
+{
+  auto result = std::vector<std::tuple<Node*, LayerNode*>>{};
+  for (auto* layerNode : worldNode.allLayers())
+  {
+    for (auto* node : layerNode->children())
+    {
+      result.emplace_back(node, layerNode);
+    }
+  }
+
+  std::ranges::sort(result, [](const auto& lhs, const auto& rhs) {
+    return std::get<0>(lhs)->lineNumber() < std::get<0>(rhs)->lineNumber();
+  });
+  return result;
+}
+
+std::string layerId(const LayerNode& layerNode)
+{
+  if (const auto& persistentId = layerNode.persistentId())
+  {
+    return fmt::format("{}", *persistentId);
+  }
+  return std::string{DefaultLayerId};
+}
+
+Result<LayerNode*> findLayer(WorldNode& worldNode, const std::string_view id)
+{
+  if (id == DefaultLayerId)
+  {
+    return worldNode.defaultLayer();
+  }
+
+  const auto persistentId = kdl::str_to_size(id);
+  for (auto* layerNode : worldNode.customLayers())
+  {
+    if (layerNode->persistentId() == persistentId)
+    {
+      return layerNode;
+    }
+  }
+
+  return Error{fmt::format("Command log refers to unknown layer '{}'", id)};
+}
+
+void writeNode(Map& map, Node& node, std::ostream& stream)
+{
+  auto nodeStream = std::stringstream{};
+  auto writer = io::NodeWriter{*map.world(), nodeStream};
+  writer.writeNodes({&node}, map.taskManager());
+
+  const auto nodeStr = nodeStream.str();
+  stream << nodeStr.size() << "\n" << nodeStr;
+}
+
+struct LogStep
+{
+  CommandOperation operation;
+  std::string name;
+  std::vector<size_t> removedIds;
+  std::vector<std::tuple<size_t, std::string_view>> changedNodes;
+  std::vector<std::tuple<std::string_view, std::string_view>> addedNodes;
+};
+
+class LogReader
+{
+private:
+  std::string_view m_str;
+
+public:
+  explicit LogReader(const std::string_view str)
+    : m_str{str}
+  {
+  }
+
+  bool eof() const { return m_str.empty(); }
+
+  /**
+   * Reads the header line and returns the name of the snapshot file it refers to.
+   */
+  Result<std::filesystem::path> readHeader()
+  {
+    if (const auto header = readLine();
+        header && header->starts_with(fmt::format("{} ", LogSnapshotKeyword)))
+    {
+      return std::filesystem::path{header->substr(LogSnapshotKeyword.size() + 1)};
+    }
+    return Error{"Invalid command log: missing snapshot header"};
+  }
+
+  std::optional<std::string_view> readLine()
+  {
+    const auto end = m_str.find('\n');
+    if (end == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+
+    const auto line = m_str.substr(0, end);
+    m_str.remove_prefix(end + 1);
+    return line;
+  }
+
+  std::optional<std::string_view> readBytes(const std::string_view count)
+  {
+    const auto byteCount = kdl::str_to_size(count);
+    if (!byteCount || m_str.size() < *byteCount)
+    {
+      return std::nullopt;
+    }
+
+    const auto bytes = m_str.substr(0, *byteCount);
+    m_str.remove_prefix(*byteCount);
+    return bytes;
+  }
+
+  Result<LogStep> readStep()
+  {
+    const auto stepLine = readLine();
+    const auto stepTokens =
+      stepLine ? kdl::str_split(*stepLine, " ") : std::vector<std::string>{};
+    if (
+      stepTokens.size() < 2 || stepTokens[0] != StepBeginKeyword
+      || (stepTokens[1] != StepDoKeyword && stepTokens[1] != StepUndoKeyword))
+    {
+      return Error{"Invalid command log: expected step"};
+    }
+
+    const auto prefixLength = StepBeginKeyword.size() + stepTokens[1].size() + 2;
+    auto step = LogStep{
+      stepTokens[1] == StepDoKeyword ? CommandOperation::Do : CommandOperation::Undo,
+      prefixLength < stepLine->size() ? std::string{stepLine->substr(prefixLength)}
+                                      : std::string{},
+      {},
+      {},
+      {},
+    };
+
+    while (const auto line = readLine())
+    {
+      if (*line == StepEndKeyword)
+      {
+        return step;
+      }
+
+      const auto tokens = kdl::str_split(*line, " ");
+      if (!tokens.empty() && tokens[0] == StepRemoveKeyword)
+      {
+        for (size_t i = 1; i < tokens.size(); ++i)
+        {
+          const auto id = kdl::str_to_size(tokens[i]);
+          if (!id)
+          {
+            return Error{"Invalid command log: expected node id"};
+          }
+          step.removedIds.push_back(*id);
+        }
+      }
+      else if (tokens.size() == 3 && tokens[0] == StepChangeKeyword)
+      {
+        const auto id = kdl::str_to_size(tokens[1]);
+        const auto nodes = readBytes(tokens[2]);
+        if (!id || !nodes)
+        {
+          return Error{"Invalid command log: truncated change"};
+        }
+        step.changedNodes.emplace_back(*id, *nodes);
+      }
+      else if (tokens.size() == 3 && tokens[0] == StepAddKeyword)
+      {
+        const auto nodes = readBytes(tokens[2]);
+        if (!nodes)
+        {
+          return Error{"Invalid command log: truncated addition"};
+        }
+
+        // refer to the log instead of the token so that the layer id outlives it
+        const auto layerId = line->substr(StepAddKeyword.size() + 1, tokens[1].size());
+        step.addedNodes.emplace_back(layerId, *nodes);
+      }
+      else
+      {
+        return Error{fmt::format("Invalid command log: unexpected line '{}'", *line)};
+      }
+    }
+
+    return Error{"Invalid command log: truncated step"};
+  }
+};
+
+} // namespace
+
+CommandLogRecorder::CommandLogRecorder(Map& map)
+  : m_map{map}
+{
+  connectObservers();
+}
+
+bool CommandLogRecorder::recording() const
+{
+  return m_recording;
+}
+
+size_t CommandLogRecorder::stepCount() const
+{
+  return m_stepCount;
+}
+
+void CommandLogRecorder::start()
+{
+  stop();
+
+  m_nextNodeId = 0;
+  m_steps = std::stringstream{};
+  m_stepCount = 0;
+
+  for (const auto& [node, layerNode] : topLevelNodesInFileOrder(*m_map.world()))
+  {
+    m_recordedNodes.emplace(node, RecordedNode{m_nextNodeId++, layerNode});
+  }
+
+  m_worldEntity = m_map.world()->entity();
+  m_layers = currentLayers();
+  m_recording = true;
+}
+
+void CommandLogRecorder::stop()
+{
+  m_recording = false;
+  m_recordedNodes.clear();
+  m_changedNodes.clear();
+  m_removedIds.clear();
+  m_layers.clear();
+  m_layersOrWorldTouched = false;
+}
+
+std::string CommandLogRecorder::steps() const
+{
+  return m_steps.str();
+}
+
+void CommandLogRecorder::connectObservers()
+{
+  m_notifierConnection +=
+    m_map.mapWasCreatedNotifier.connect(this, &CommandLogRecorder::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasLoadedNotifier.connect(this, &CommandLogRecorder::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasClearedNotifier.connect(this, &CommandLogRecorder::mapWasReset);
+
+  m_notifierConnection +=
+    m_map.nodesWereAddedNotifier.connect(this, &CommandLogRecorder::nodesDidChange);
+  m_notifierConnection += m_map.nodesWillBeRemovedNotifier.connect(
+    this, &CommandLogRecorder::nodesWillBeRemoved);
+  m_notifierConnection +=
+    m_map.nodesDidChangeNotifier.connect(this, &CommandLogRecorder::nodesDidChange);
+  m_notifierConnection += m_map.brushFacesDidChangeNotifier.connect(
+    [&](const std::vector<BrushFaceHandle>& handles) {
+      nodesDidChange(kdl::vec_transform(
+        handles, [](const auto& handle) -> Node* { return handle.node(); }));
+    });
+
+  m_notifierConnection +=
+    m_map.transactionDoneNotifier.connect(this, &CommandLogRecorder::transactionDone);
+  m_notifierConnection += m_map.transactionUndoneNotifier.connect(
+    this, &CommandLogRecorder::transactionUndone);
+}
+
+void CommandLogRecorder::mapWasReset(Map&)
+{
+  stop();
+}
+
+void CommandLogRecorder::nodesDidChange(const std::vector<Node*>& nodes)
+{
+  if (!m_recording)
+  {
+    return;
+  }
+
+  for (auto* node : nodes)
+  {
+    if (isLayerOrWorld(node))
+    {
+      // the parents of added or removed nodes are notified too, so whether the layer or
+      // the world itself changed is only determined at the end of the step
+      m_layersOrWorldTouched = true;
+    }
+    else if (auto* topLevelNode = findTopLevelNode(node))
+    {
+      m_changedNodes.insert(topLevelNode);
+    }
+  }
+}
+
+void CommandLogRecorder::nodesWillBeRemoved(const std::vector<Node*>& nodes)
+{
+  if (!m_recording)
+  {
+    return;
+  }
+
+  // Removed top level nodes may be deleted before the step ends, e.g. if the transaction
+  // that added them is cancelled, so they must not be remembered.
+  auto removedTopLevelNodes = std::unordered_set<const Node*>{};
+  for (auto* node : nodes)
+  {
+    if (isLayerOrWorld(node))
+    {
+      m_layersOrWorldTouched = true;
+    }
+    else if (isTopLevelNode(node))
+    {
+      removedTopLevelNodes.insert(node);
+      m_changedNodes.erase(node);
+      if (const auto it = m_recordedNodes.find(node); it != m_recordedNodes.end())
+      {
+        m_removedIds.push_back(it->second.id);
+        m_recordedNodes.erase(it);
+      }
+    }
+  }
+
+  for (auto* node : nodes)
+  {
+    auto* topLevelNode = !isLayerOrWorld(node) ? findTopLevelNode(node) : nullptr;
+    if (topLevelNode && !removedTopLevelNodes.contains(topLevelNode))
+    {
+      m_changedNodes.insert(topLevelNode);
+    }
+  }
+}
+
+void CommandLogRecorder::transactionDone(const std::string& name)
+{
+  if (m_recording && !m_map.isTransactionRunning())
+  {
+    recordStep(CommandOperation::Do, name);
+  }
+}
+
+void CommandLogRecorder::transactionUndone(const std::string& name)
+{
+  if (m_recording)
+  {
+    recordStep(CommandOperation::Undo, name);
+  }
+}
+
+void CommandLogRecorder::recordStep(
+  const CommandOperation operation, const std::string& name)
+{
+  if (std::exchange(m_layersOrWorldTouched, false) && layersOrWorldChanged())
+  {
+    m_map.logger().warn()
+      << "Stopped recording the command log because a layer or the world changed";
+    stop();
+    return;
+  }
+
+  auto removedIds = std::exchange(m_removedIds, {});
+  auto changedNodes = std::vector<std::tuple<size_t, Node*>>{};
+  auto addedNodes = std::vector<std::tuple<const LayerNode*, Node*>>{};
+
+  for (auto* node : std::exchange(m_changedNodes, {}))
+  {
+    auto* layerNode = dynamic_cast<const LayerNode*>(node->parent());
+    if (const auto it = m_recordedNodes.find(node); it != m_recordedNodes.end())
+    {
+      if (layerNode == it->second.layer)
+      {
+        changedNodes.emplace_back(it->second.id, node);
+        continue;
+      }
+
+      // the node was moved to another layer or into a group
+      removedIds.push_back(it->second.id);
+      m_recordedNodes.erase(it);
+    }
+
+    if (layerNode)
+    {
+      addedNodes.emplace_back(layerNode, node);
+    }
+  }
+
+  if (removedIds.empty() && changedNodes.empty() && addedNodes.empty())
+  {
+    return;
+  }
+
+  m_steps << StepBeginKeyword << " "
+          << (operation == CommandOperation::Undo ? StepUndoKeyword : StepDoKeyword)
+          << " " << name << "\n";
+
+  m_steps << StepRemoveKeyword;
+  for (const auto id : kdl::vec_sort(std::move(removedIds)))
+  {
+    m_steps << " " << id;
+  }
+  m_steps << "\n";
+
+  for (const auto& [id, node] : kdl::vec_sort(std::move(changedNodes)))
+  {
+    m_steps << StepChangeKeyword << " " << id << " ";
+    writeNode(m_map, *node, m_steps);
+  }
+
+  for (const auto& [layerNode, node] : addedNodes)
+  {
+    m_recordedNodes.emplace(node, RecordedNode{m_nextNodeId++, layerNode});
+    m_steps << StepAddKeyword << " " << layerId(*layerNode) << " ";
+    writeNode(m_map, *node, m_steps);
+  }
+
+  m_steps << StepEndKeyword << "\n";
+  ++m_stepCount;
+}
+
+std::vector<std::tuple<const LayerNode*, Layer>> CommandLogRecorder::currentLayers() const
+{
+  return kdl::vec_transform(m_map.world()->allLayers(), [](const auto* layerNode) {
+    return std::tuple<const LayerNode*, Layer>{layerNode, layerNode->layer()};
+  });
+}
+
+bool CommandLogRecorder::layersOrWorldChanged() const
+{
+  return m_map.world()->entity() != m_worldEntity || currentLayers() != m_layers;
+}
+
+std::string makeCommandLogHeader(const std::filesystem::path& snapshotFilename)
+{
+  return fmt::format("{} {}\n", LogSnapshotKeyword, snapshotFilename.string());
+}
+
+Result<std::filesystem::path> readCommandLogSnapshotFilename(const std::string_view log)
+{
+  return LogReader{log}.readHeader();
+}
+
+namespace
+{
+
+/**
+ * Returns the contents to swap into the given node if it can be updated in place.
+ */
+std::optional<NodeContents> contentsToSwap(const Node& oldNode, const Node& newNode)
+{
+  if (oldNode.hasChildren() || newNode.hasChildren())
+  {
+    return std::nullopt;
+  }
+
+  const auto* oldBrushNode = dynamic_cast<const BrushNode*>(&oldNode);
+  const auto* newBrushNode = dynamic_cast<const BrushNode*>(&newNode);
+  if (oldBrushNode && newBrushNode)
+  {
+    return NodeContents{newBrushNode->brush()};
+  }
+
+  const auto* oldPatchNode = dynamic_cast<const PatchNode*>(&oldNode);
+  const auto* newPatchNode = dynamic_cast<const PatchNode*>(&newNode);
+  if (oldPatchNode && newPatchNode)
+  {
+    return NodeContents{newPatchNode->patch()};
+  }
+
+  const auto* oldEntityNode = dynamic_cast<const EntityNode*>(&oldNode);
+  const auto* newEntityNode = dynamic_cast<const EntityNode*>(&newNode);
+  if (oldEntityNode && newEntityNode)
+  {
+    return NodeContents{newEntityNode->entity()};
+  }
+
+  return std::nullopt;
+}
+
+struct ChangedNode
+{
+  size_t id;
+  Node* oldNode;
+  std::unique_ptr<Node> newNode;
+};
+
+struct AddedNode
+{
+  LayerNode* layerNode;
+  std::unique_ptr<Node> newNode;
+};
+
+class LogReplayer
+{
+private:
+  Map& m_map;
+  std::vector<Node*> m_nodes;
+
+public:
+  explicit LogReplayer(Map& map)
+    : m_map{map}
+  {
+    for (const auto& [node, layerNode] : topLevelNodesInFileOrder(*m_map.world()))
+    {
+      m_nodes.push_back(node);
+    }
+  }
+
+  Result<CommandProfile> replayStep(const LogStep& step)
+  {
+    return findNodes(step.removedIds) | kdl::and_then([&](auto removedNodes) {
+             return readChangedNodes(step.changedNodes)
+                    | kdl::and_then([&](auto changedNodes) {
+                        return readAddedNodes(step.addedNodes)
+                               | kdl::and_then([&](auto addedNodes) {
+                                   return executeStep(
+                                     step,
+                                     std::move(removedNodes),
+                                     std::move(changedNodes),
+                                     std::move(addedNodes));
+                                 });
+                      });
+           });
+  }
+
+private:
+  Result<Node*> findNode(const size_t id) const
+  {
+    if (id < m_nodes.size() && m_nodes[id])
+    {
+      return m_nodes[id];
+    }
+    return Error{fmt::format("Command log refers to unknown node {}", id)};
+  }
+
+  Result<std::vector<Node*>> findNodes(const std::vector<size_t>& ids) const
+  {
+    return ids | std::views::transform([&](const auto id) { return findNode(id); })
+           | kdl::fold;
+  }
+
+  Result<std::unique_ptr<Node>> readNode(const std::string_view str)
+  {
+    auto parserStatus = io::SimpleParserStatus{m_map.logger()};
+    return io::NodeReader::read(
+             std::string{str},
+             m_map.world()->mapFormat(),
+             m_map.worldBounds(),
+             m_map.world()->entityPropertyConfig(),
+             parserStatus,
+             m_map.taskManager())
+           | kdl::and_then([](auto nodes) -> Result<std::unique_ptr<Node>> {
+               // the reader wraps world brushes and patches in a layer
+               if (nodes.size() == 1 && nodes.front()->childCount() == 1)
+               {
+                 if (auto* layerNode = dynamic_cast<LayerNode*>(nodes.front()))
+                 {
+                   auto* childNode = layerNode->children().front();
+                   layerNode->removeChild(childNode);
+                   delete layerNode;
+                   nodes = {childNode};
+                 }
+               }
+
+               if (nodes.size() != 1)
+               {
+                 kdl::vec_clear_and_delete(nodes);
+                 return Error{"Command log contains an invalid node"};
+               }
+               return std::unique_ptr<Node>{nodes.front()};
+             });
+  }
+
+  Result<std::vector<ChangedNode>> readChangedNodes(
+    const std::vector<std::tuple<size_t, std::string_view>>& changes)
+  {
+    return changes | std::views::transform([&](const auto& change) {
+             const auto& [id, str] = change;
+             return findNode(id) | kdl::and_then([&](auto* oldNode) {
+                      return readNode(str) | kdl::transform([&](auto newNode) {
+                               return ChangedNode{id, oldNode, std::move(newNode)};
+                             });
+                    });
+           })
+           | kdl::fold;
+  }
+
+  Result<std::vector<AddedNode>> readAddedNodes(
+    const std::vector<std::tuple<std::string_view, std::string_view>>& additions)
+  {
+    return additions | std::views::transform([&](const auto& addition) {
+             const auto& [layerId, str] = addition;
+             return findLayer(*m_map.world(), layerId)
+                    | kdl::and_then([&](auto* layerNode) {
+                        return readNode(str) | kdl::transform([&](auto newNode) {
+                                 return AddedNode{layerNode, std::move(newNode)};
+                               });
+                      });
+           })
+           | kdl::fold;
+  }
+
+  Result<CommandProfile> executeStep(
+    const LogStep& step,
+    std::vector<Node*> nodesToRemove,
+    std::vector<ChangedNode> changedNodes,
+    std::vector<AddedNode> addedNodes)
+  {
+    auto nodesToSwap = std::vector<std::pair<Node*, NodeContents>>{};
+    auto nodesToAdd = std::map<Node*, std::vector<Node*>>{};
+    auto newNodeIds = std::vector<std::tuple<size_t, Node*>>{};
+
+    for (const auto id : step.removedIds)
+    {
+      newNodeIds.emplace_back(id, nullptr);
+    }
+
+    for (auto& [id, oldNode, newNode] : changedNodes)
+    {
+      if (auto contents = contentsToSwap(*oldNode, *newNode))
+      {
+        nodesToSwap.emplace_back(oldNode, std::move(*contents));
+      }
+      else
+      {
+        nodesToRemove.push_back(oldNode);
+        nodesToAdd[oldNode->parent()].push_back(newNode.get());
+        newNodeIds.emplace_back(id, newNode.release());
+      }
+    }
+
+    // added nodes are numbered in the order in which they appear in the log
+    auto nextId = m_nodes.size();
+    for (auto& [layerNode, newNode] : addedNodes)
+    {
+      nodesToAdd[layerNode].push_back(newNode.get());
+      newNodeIds.emplace_back(nextId++, newNode.release());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto transaction = Transaction{m_map, step.name};
+    if (!nodesToRemove.empty())
+    {
+      removeNodes(m_map, nodesToRemove);
+    }
+    if (!nodesToAdd.empty())
+    {
+      addNodes(m_map, nodesToAdd);
+    }
+    if (
+      !nodesToSwap.empty()
+      && !updateNodeContents(m_map, step.name, std::move(nodesToSwap)))
+    {
+      transaction.cancel();
+      return Error{fmt::format("Could not replay step '{}'", step.name)};
+    }
+    if (!transaction.commit())
+    {
+      return Error{fmt::format("Could not replay step '{}'", step.name)};
+    }
+
+    const auto msecs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    m_nodes.resize(nextId, nullptr);
+    for (const auto& [id, node] : newNodeIds)
+    {
+      m_nodes[id] = node;
+    }
+
+    return CommandProfile{
+      step.name,
+      step.operation,
+      msecs,
+      step.removedIds.size() + changedNodes.size() + addedNodes.size()};
+  }
+};
+
+} // namespace
+
+Result<std::vector<CommandProfile>> replayCommandLog(Map& map, const std::string_view log)
+{
+  auto reader = LogReader{log};
+  auto error = std::optional<Error>{};
+  reader.readHeader() | kdl::transform([](const auto&) {})
+    | kdl::transform_error([&](auto e) { error = std::move(e); });
+
+  auto replayer = LogReplayer{map};
+  auto profiles = std::vector<CommandProfile>{};
+  while (!reader.eof() && !error)
+  {
+    reader.readStep()
+      | kdl::and_then([&](const auto& step) { return replayer.replayStep(step); })
+      | kdl::transform([&](auto profile) { profiles.push_back(std::move(profile)); })
+      | kdl::transform_error([&](auto e) { error = std::move(e); });
+  }
+
+  if (error)
+  {
+    return *error;
+  }
+
+  return profiles;
+}
+
+} // namespace tb::mdl
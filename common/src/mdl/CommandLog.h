@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "NotifierConnection.h"
+#include "Result.h"
+#include "mdl/CommandProfiler.h"
+#include "mdl/Entity.h"
+#include "mdl/Layer.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class LayerNode;
+class Map;
+class Node;
+
+/**
+ * Records the changes that every undoable step makes to a map, so that an editing
+ * session can be replayed later, e.g. to benchmark it. A step is a command or
+ * transaction that was executed, undone or redone outside of any other transaction.
+ *
+ * Like the autosave journal, the log works on the granularity of top level nodes, which
+ * are the direct children of a layer. Every step lists the top level nodes it removed,
+ * the new contents of the top level nodes it changed, and the top level nodes it added.
+ * Nodes are identified by a number which is assigned in the order in which they appear
+ * in the snapshot file, or in the order in which they were added to the log.
+ *
+ * Changes to the properties of the world or of a layer cannot be recorded, so they stop
+ * the recording.
+ */
+class CommandLogRecorder
+{
+private:
+  struct RecordedNode
+  {
+    size_t id;
+    const LayerNode* layer;
+  };
+
+  Map& m_map;
+  bool m_recording = false;
+  std::unordered_map<const Node*, RecordedNode> m_recordedNodes;
+  std::unordered_set<Node*> m_changedNodes;
+  std::vector<size_t> m_removedIds;
+  size_t m_nextNodeId = 0;
+
+  Entity m_worldEntity;
+  std::vector<std::tuple<const LayerNode*, Layer>> m_layers;
+  bool m_layersOrWorldTouched = false;
+
+  std::stringstream m_steps;
+  size_t m_stepCount = 0;
+
+  NotifierConnection m_notifierConnection;
+
+public:
+  explicit CommandLogRecorder(Map& map);
+
+  bool recording() const;
+
+  /**
+   * Returns the number of steps recorded since recording was started.
+   */
+  size_t stepCount() const;
+
+  /**
+   * Starts recording against the current state of the map.
+   *
+   * Must be called immediately after the map was written to the snapshot file, because
+   * the nodes are numbered in the order of their line numbers in the last serialization.
+   */
+  void start();
+
+  void stop();
+
+  /**
+   * Returns the steps recorded since recording was started. Prepend the result of
+   * makeCommandLogHeader to obtain a complete log.
+   */
+  std::string steps() const;
+
+private:
+  void connectObservers();
+
+  void mapWasReset(Map& map);
+  void nodesDidChange(const std::vector<Node*>& nodes);
+  void nodesWillBeRemoved(const std::vector<Node*>& nodes);
+  void transactionDone(const std::string& name);
+  void transactionUndone(const std::string& name);
+  void recordStep(CommandOperation operation, const std::string& name);
+
+  std::vector<std::tuple<const LayerNode*, Layer>> currentLayers() const;
+  bool layersOrWorldChanged() const;
+};
+
+/**
+ * Returns the first line of a command log that was recorded against the given snapshot
+ * file.
+ */
+std::string makeCommandLogHeader(const std::filesystem::path& snapshotFilename);
+
+/**
+ * Returns the name of the snapshot file against which the given log was recorded.
+ */
+Result<std::filesystem::path> readCommandLogSnapshotFilename(std::string_view log);
+
+/**
+ * Replays every step of the given log as a transaction on the given map, which must have
+ * been loaded from the log's snapshot file.
+ *
+ * Returns the time it took to execute each step, not including the time spent parsing
+ * the log. Changed brushes, patches and point entities are updated in place, all other
+ * changed nodes are replaced.
+ */
+Result<std::vector<CommandProfile>> replayCommandLog(Map& map, std::string_view log);
+
+} // namespace tb::mdl
@@ -22,8 +22,13 @@
 #include <QDateTime>
 
 #include "Exceptions.h"
+#include "Logger.h"
+#include "Macros.h"
+#include "MemoryReport.h"
 #include "Notifier.h"
+#include "NotifierConnection.h"
 #include "mdl/Command.h"
+#include "mdl/Map.h"
 #include "mdl/TransactionScope.h"
 #include "mdl/UndoableCommand.h"
 
@@ -31,6 +36,7 @@
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace tb::mdl
 {
@@ -46,6 +52,56 @@ void notifyCommandIfNotType(T& notifier, C& command)
   }
 }
 
+/**
+ * Measures the time, the touched nodes and the change in memory usage while a command is
+ * executed, undone or redone. Nodes are counted as touched when the map reports them as
+ * added, removed or changed.
+ */
+class CommandMeasurement
+{
+private:
+  using Clock = std::chrono::steady_clock;
+
+  const UndoableCommand& m_command;
+  CommandOperation m_operation;
+  size_t m_memoryUsage;
+  std::unordered_set<const Node*> m_touchedNodes;
+  NotifierConnection m_notifierConnection;
+  Clock::time_point m_start;
+
+public:
+  CommandMeasurement(
+    Map& map, const UndoableCommand& command, const CommandOperation operation)
+    : m_command{command}
+    , m_operation{operation}
+    , m_memoryUsage{command.memoryUsage()}
+  {
+    const auto addTouchedNodes = [this](const std::vector<Node*>& nodes) {
+      m_touchedNodes.insert(nodes.begin(), nodes.end());
+    };
+
+    m_notifierConnection += map.nodesWereAddedNotifier.connect(addTouchedNodes);
+    m_notifierConnection += map.nodesWillBeRemovedNotifier.connect(addTouchedNodes);
+    m_notifierConnection += map.nodesWillChangeNotifier.connect(addTouchedNodes);
+
+    m_start = Clock::now();
+  }
+
+  CommandProfile profile() const
+  {
+    const auto duration = Clock::now() - m_start;
+    return CommandProfile{
+      m_command.name(),
+      m_operation,
+      std::chrono::duration<double, std::milli>{duration}.count(),
+      m_touchedNodes.size(),
+      std::ptrdiff_t(m_command.memoryUsage()) - std::ptrdiff_t(m_memoryUsage),
+    };
+  }
+
+  deleteCopyAndMove(CommandMeasurement);
+};
+
 class TransactionCommand : public UndoableCommand
 {
 private:
@@ -130,8 +186,57 @@ private:
 
     return false;
   }
+
+public:
+  std::vector<std::unique_ptr<UndoableCommand>> releaseCommands()
+  {
+    return std::move(m_commands);
+  }
+
+  size_t memoryUsage() const override
+  {
+    auto result = UndoableCommand::memoryUsage()
+                  + m_commands.capacity() * sizeof(std::unique_ptr<UndoableCommand>);
+    for (const auto& command : m_commands)
+    {
+      result += command->memoryUsage();
+    }
+    return result;
+  }
 };
 
+void compactCommands(
+  std::vector<std::unique_ptr<UndoableCommand>> commands,
+  std::vector<std::unique_ptr<UndoableCommand>>& result)
+{
+  for (auto& command : commands)
+  {
+    if (auto* transactionCommand = dynamic_cast<TransactionCommand*>(command.get()))
+    {
+      // nested transactions have already been committed and don't emit notifications
+      compactCommands(transactionCommand->releaseCommands(), result);
+    }
+    else if (result.empty() || !result.back()->compactWith(*command))
+    {
+      result.push_back(std::move(command));
+    }
+  }
+}
+
+/**
+ * Flattens nested transactions and merges every command into its predecessor if
+ * possible. Tools like paste or CSG push many small commands in a single transaction, and
+ * merging them keeps only one snapshot of every node that the transaction touched.
+ */
+std::vector<std::unique_ptr<UndoableCommand>> compactCommands(
+  std::vector<std::unique_ptr<UndoableCommand>> commands)
+{
+  auto result = std::vector<std::unique_ptr<UndoableCommand>>{};
+  result.reserve(commands.size());
+  compactCommands(std::move(commands), result);
+  return result;
+}
+
 } // namespace
 
 struct CommandProcessor::TransactionState
@@ -165,6 +270,7 @@ CommandProcessor::CommandProcessor(
   : m_map{map}
   , m_isCollationEnabled{true}
   , m_collationInterval{collationInterval}
+  , m_undoStackMemoryUsage{0}
   , m_lastCommandTimestamp{std::chrono::time_point<std::chrono::system_clock>{}}
 {
 }
@@ -181,6 +287,50 @@ void CommandProcessor::setIsCollationEnabled(const bool isCollationEnabled)
   m_isCollationEnabled = isCollationEnabled;
 }
 
+std::optional<size_t> CommandProcessor::memoryBudget() const
+{
+  return m_memoryBudget;
+}
+
+void CommandProcessor::setMemoryBudget(const std::optional<size_t> memoryBudget)
+{
+  m_memoryBudget = memoryBudget;
+  enforceMemoryBudget();
+}
+
+size_t CommandProcessor::memoryUsage() const
+{
+  return m_undoStackMemoryUsage;
+}
+
+void CommandProcessor::addToMemoryReport(MemoryReport& report) const
+{
+  report.add("Undo stack", m_undoStackMemoryUsage, m_undoStack.size());
+
+  auto redoStackMemoryUsage = size_t(0);
+  for (const auto& command : m_redoStack)
+  {
+    redoStackMemoryUsage += command->memoryUsage();
+  }
+  report.add("Redo stack", redoStackMemoryUsage, m_redoStack.size());
+}
+
+std::optional<std::chrono::milliseconds> CommandProcessor::slowCommandThreshold() const
+{
+  return m_slowCommandThreshold;
+}
+
+void CommandProcessor::setSlowCommandThreshold(
+  const std::optional<std::chrono::milliseconds> slowCommandThreshold)
+{
+  m_slowCommandThreshold = slowCommandThreshold;
+}
+
+const std::deque<CommandProfile>& CommandProcessor::commandProfiles() const
+{
+  return m_profiler.profiles();
+}
+
 bool CommandProcessor::canUndo() const
 {
   return m_transactionStack.empty() && !m_undoStack.empty();
@@ -250,6 +400,11 @@ bool CommandProcessor::isCurrentDocumentStateObservable() const
               == TransactionScope::LongRunning;
 }
 
+bool CommandProcessor::isTransactionRunning() const
+{
+  return !m_transactionStack.empty();
+}
+
 std::unique_ptr<CommandResult> CommandProcessor::execute(std::unique_ptr<Command> command)
 {
   auto result = executeCommand(*command);
@@ -257,6 +412,7 @@ std::unique_ptr<CommandResult> CommandProcessor::execute(std::unique_ptr<Command
   {
     m_undoStack.clear();
     m_redoStack.clear();
+    m_undoStackMemoryUsage = 0;
   }
   return result;
 }
@@ -279,7 +435,9 @@ std::unique_ptr<CommandResult> CommandProcessor::undo()
   }
 
   auto command = popFromUndoStack();
+  const auto measurement = CommandMeasurement{m_map, *command, CommandOperation::Undo};
   auto result = undoCommand(*command);
+  addCommandProfile(measurement.profile());
   if (result->success())
   {
     const auto commandName = command->name();
@@ -301,7 +459,9 @@ std::unique_ptr<CommandResult> CommandProcessor::redo()
   }
 
   auto command = popFromRedoStack();
+  const auto measurement = CommandMeasurement{m_map, *command, CommandOperation::Redo};
   auto result = executeCommand(*command);
+  addCommandProfile(measurement.profile());
   if (result->success())
   {
     assertResult(pushToUndoStack(std::move(command), false));
@@ -315,13 +475,17 @@ void CommandProcessor::clear()
 
   m_undoStack.clear();
   m_redoStack.clear();
+  m_undoStackMemoryUsage = 0;
   m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
 }
 
 CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(
   std::unique_ptr<UndoableCommand> command, const bool collate)
 {
+  const auto measurement = CommandMeasurement{m_map, *command, CommandOperation::Do};
   auto commandResult = executeCommand(*command);
+  addCommandProfile(measurement.profile());
+
   if (!commandResult->success())
   {
     return {std::move(commandResult), false};
@@ -408,7 +572,8 @@ void CommandProcessor::createAndStoreTransaction()
     {
       transaction.name = transaction.commands.front()->name();
     }
-    auto command = createTransaction(transaction.name, std::move(transaction.commands));
+    auto command = createTransaction(
+      transaction.name, compactCommands(std::move(transaction.commands)));
 
     if (m_transactionStack.empty())
     {
@@ -445,13 +610,19 @@ bool CommandProcessor::pushToUndoStack(
   if (collatable(collate, timestamp))
   {
     auto& lastCommand = m_undoStack.back();
+    const auto lastCommandMemoryUsage = lastCommand->memoryUsage();
     if (lastCommand->collateWith(*command))
     {
+      m_undoStackMemoryUsage =
+        m_undoStackMemoryUsage - lastCommandMemoryUsage + lastCommand->memoryUsage();
+      enforceMemoryBudget();
       return false;
     }
   }
 
+  m_undoStackMemoryUsage += command->memoryUsage();
   m_undoStack.push_back(std::move(command));
+  enforceMemoryBudget();
   return true;
 }
 
@@ -460,7 +631,29 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack()
   assert(m_transactionStack.empty());
   assert(!m_undoStack.empty());
 
-  return kdl::vec_pop_back(m_undoStack);
+  auto command = kdl::vec_pop_back(m_undoStack);
+  m_undoStackMemoryUsage -= command->memoryUsage();
+  return command;
+}
+
+void CommandProcessor::enforceMemoryBudget()
+{
+  if (!m_memoryBudget)
+  {
+    return;
+  }
+
+  auto numCommandsToDrop = size_t(0);
+  while (numCommandsToDrop + 1 < m_undoStack.size()
+         && m_undoStackMemoryUsage > *m_memoryBudget)
+  {
+    m_undoStackMemoryUsage -= m_undoStack[numCommandsToDrop]->memoryUsage();
+    ++numCommandsToDrop;
+  }
+
+  m_undoStack.erase(
+    m_undoStack.begin(),
+    m_undoStack.begin() + static_cast<std::ptrdiff_t>(numCommandsToDrop));
 }
 
 bool CommandProcessor::collatable(
@@ -484,4 +677,14 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromRedoStack()
   return kdl::vec_pop_back(m_redoStack);
 }
 
+void CommandProcessor::addCommandProfile(CommandProfile profile)
+{
+  if (
+    m_slowCommandThreshold && profile.msecs >= double(m_slowCommandThreshold->count()))
+  {
+    m_map.logger().warn() << "Slow command: " << profile;
+  }
+  m_profiler.addProfile(std::move(profile));
+}
+
 } // namespace tb::mdl
@@ -20,12 +20,20 @@
 #pragma once
 
 #include "Notifier.h"
+#include "mdl/CommandProfiler.h"
 
 #include <chrono>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+namespace tb
+{
+class MemoryReport;
+}
+
 namespace tb::mdl
 {
 class Command;
@@ -51,6 +59,14 @@ enum class TransactionScope;
  * The command processor supports nested transactions. Each transaction can be committed
  * or rolled back individually. Committing a nested transaction adds it as a command to
  * the containing transaction.
+ *
+ * If a memory budget is set, the oldest commands are dropped from the undo stack
+ * whenever the estimated memory usage of the commands on the undo stack exceeds the
+ * budget.
+ *
+ * Every command that is executed and stored, undone or redone is profiled. The command
+ * processor keeps the profiles of the most recent commands and logs every command that
+ * takes longer than the slow command threshold, if one is set.
  */
 class CommandProcessor
 {
@@ -79,11 +95,31 @@ private:
    */
   std::vector<std::unique_ptr<UndoableCommand>> m_redoStack;
 
+  /**
+   * The maximum estimated memory usage of the commands on the undo stack, if any.
+   */
+  std::optional<size_t> m_memoryBudget;
+
+  /**
+   * The sum of the estimated memory usage of the commands on the undo stack.
+   */
+  size_t m_undoStackMemoryUsage;
+
   /**
    * The time stamp of when the last command was executed.
    */
   std::chrono::system_clock::time_point m_lastCommandTimestamp;
 
+  /**
+   * Records the profiles of the most recently executed, undone or redone commands.
+   */
+  CommandProfiler m_profiler;
+
+  /**
+   * Commands that take longer than this threshold are logged, if it is set.
+   */
+  std::optional<std::chrono::milliseconds> m_slowCommandThreshold;
+
   struct TransactionState;
 
   /**
@@ -155,6 +191,51 @@ public:
    */
   void setIsCollationEnabled(bool isCollationEnabled);
 
+  /**
+   * Returns the memory budget of the undo stack, if any.
+   */
+  std::optional<size_t> memoryBudget() const;
+
+  /**
+   * Sets the memory budget of the undo stack in bytes. If the estimated memory usage of
+   * the commands on the undo stack exceeds the given budget, the oldest commands are
+   * dropped until it fits the budget again. The most recently executed command is never
+   * dropped. Pass `std::nullopt` to disable the budget.
+   *
+   * The redo stack is not limited because it only contains commands that were on the
+   * undo stack before, and it is cleared whenever a new command is executed.
+   */
+  void setMemoryBudget(std::optional<size_t> memoryBudget);
+
+  /**
+   * Returns the estimated memory usage of the commands on the undo stack.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Adds the estimated memory usage of the commands on the undo and redo stacks to the
+   * given report.
+   */
+  void addToMemoryReport(MemoryReport& report) const;
+
+  /**
+   * Returns the threshold above which commands are logged as slow, if any.
+   */
+  std::optional<std::chrono::milliseconds> slowCommandThreshold() const;
+
+  /**
+   * Sets the threshold above which executing, undoing or redoing a command is logged as
+   * slow. Pass `std::nullopt` to disable logging slow commands.
+   */
+  void setSlowCommandThreshold(
+    std::optional<std::chrono::milliseconds> slowCommandThreshold);
+
+  /**
+   * Returns the profiles of the most recently executed, undone or redone commands,
+   * oldest first.
+   */
+  const std::deque<CommandProfile>& commandProfiles() const;
+
   /**
    * Indicates whether there is any command on the undo stack.
    */
@@ -218,6 +299,11 @@ public:
    */
   bool isCurrentDocumentStateObservable() const;
 
+  /**
+   * Indicates whether any transaction is currently executing.
+   */
+  bool isTransactionRunning() const;
+
   /**
    * Executes the given command by calling its `performDo` method without storing it for
    * later undo. If the command is executed successfully, both the undo and the redo
@@ -383,6 +469,12 @@ private:
    */
   std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+  /**
+   * Drops the oldest commands from the undo stack until its estimated memory usage does
+   * not exceed the memory budget anymore, keeping at least the topmost command.
+   */
+  void enforceMemoryBudget();
+
   bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
   /**
@@ -400,6 +492,11 @@ private:
    * @return the topmost command of the redo stack
    */
   std::unique_ptr<UndoableCommand> popFromRedoStack();
+
+  /**
+   * Records the given profile and logs it if the command was slow.
+   */
+  void addCommandProfile(CommandProfile profile);
 };
 
 } // namespace tb::mdl
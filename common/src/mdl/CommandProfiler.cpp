@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CommandProfiler.h"
+
+#include "Macros.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+namespace tb::mdl
+{
+
+std::ostream& operator<<(std::ostream& lhs, const CommandOperation rhs)
+{
+  switch (rhs)
+  {
+  case CommandOperation::Do:
+    lhs << "do";
+    break;
+  case CommandOperation::Undo:
+    lhs << "undo";
+    break;
+  case CommandOperation::Redo:
+    lhs << "redo";
+    break;
+    switchDefault();
+  }
+  return lhs;
+}
+
+std::ostream& operator<<(std::ostream& lhs, const CommandProfile& rhs)
+{
+  lhs << "'" << rhs.commandName << "' (" << rhs.operation << ") took "
+      << fmt::format("{:.2f}", rhs.msecs) << " ms, touched " << rhs.nodesTouched
+      << " nodes, memory delta " << rhs.memoryDelta << " bytes";
+  return lhs;
+}
+
+std::string toReport(const std::deque<CommandProfile>& profiles, const size_t maxSlowest)
+{
+  auto str = std::stringstream{};
+  str << "Profile of the last " << profiles.size() << " commands\n";
+
+  for (const auto operation :
+       {CommandOperation::Do, CommandOperation::Undo, CommandOperation::Redo})
+  {
+    auto count = size_t(0);
+    auto msecs = 0.0;
+    auto nodesTouched = size_t(0);
+    for (const auto& profile : profiles)
+    {
+      if (profile.operation == operation)
+      {
+        ++count;
+        msecs += profile.msecs;
+        nodesTouched += profile.nodesTouched;
+      }
+    }
+
+    str << "  " << operation << ": " << count << " commands, "
+        << fmt::format("{:.2f}", msecs) << " ms, " << nodesTouched << " nodes\n";
+  }
+
+  auto slowest = std::vector<const CommandProfile*>{};
+  slowest.reserve(profiles.size());
+  for (const auto& profile : profiles)
+  {
+    slowest.push_back(&profile);
+  }
+
+  const auto slowestCount = std::min(maxSlowest, slowest.size());
+  std::ranges::partial_sort(
+    slowest,
+    slowest.begin() + std::ptrdiff_t(slowestCount),
+    std::ranges::greater{},
+    &CommandProfile::msecs);
+
+  if (slowestCount > 0)
+  {
+    str << "Slowest commands\n";
+    for (size_t i = 0; i < slowestCount; ++i)
+    {
+      str << "  " << *slowest[i] << "\n";
+    }
+  }
+
+  return str.str();
+}
+
+CommandProfiler::CommandProfiler(const size_t maxProfileCount)
+  : m_maxProfileCount{maxProfileCount}
+{
+  assert(m_maxProfileCount > 0);
+}
+
+void CommandProfiler::addProfile(CommandProfile profile)
+{
+  m_profiles.push_back(std::move(profile));
+  while (m_profiles.size() > m_maxProfileCount)
+  {
+    m_profiles.pop_front();
+  }
+}
+
+const std::deque<CommandProfile>& CommandProfiler::profiles() const
+{
+  return m_profiles;
+}
+
+void CommandProfiler::clear()
+{
+  m_profiles.clear();
+}
+
+} // namespace tb::mdl
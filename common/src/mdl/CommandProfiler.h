@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <string>
+
+namespace tb::mdl
+{
+
+enum class CommandOperation
+{
+  Do,
+  Undo,
+  Redo,
+};
+
+std::ostream& operator<<(std::ostream& lhs, CommandOperation rhs);
+
+/**
+ * The cost of executing, undoing or redoing a single command.
+ */
+struct CommandProfile
+{
+  std::string commandName;
+  CommandOperation operation;
+  double msecs;
+
+  /**
+   * The number of distinct nodes that were added, removed or changed.
+   */
+  size_t nodesTouched = 0;
+
+  /**
+   * The change in the estimated memory usage of the command, i.e. the memory it took to
+   * record the state needed to undo or redo it.
+   */
+  std::ptrdiff_t memoryDelta = 0;
+
+  bool operator==(const CommandProfile& other) const = default;
+};
+
+std::ostream& operator<<(std::ostream& lhs, const CommandProfile& rhs);
+
+/**
+ * Formats a report of the given profiles that summarizes the time spent per operation
+ * and lists the slowest commands.
+ */
+std::string toReport(const std::deque<CommandProfile>& profiles, size_t maxSlowest = 10);
+
+/**
+ * Keeps the profiles of the most recently executed, undone or redone commands.
+ */
+class CommandProfiler
+{
+private:
+  size_t m_maxProfileCount;
+  std::deque<CommandProfile> m_profiles;
+
+public:
+  explicit CommandProfiler(size_t maxProfileCount = 1000);
+
+  void addProfile(CommandProfile profile);
+
+  /**
+   * The most recent profiles, oldest first.
+   */
+  const std::deque<CommandProfile>& profiles() const;
+
+  void clear();
+};
+
+} // namespace tb::mdl
@@ -0,0 +1,493 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/CompactBrushGeometry.h"
+
+#include "Ensure.h"
+
+#include "kdl/hash_utils.h"
+#include "kdl/intern_pool.h"
+
+#include "vm/intersection.h"
+#include "vm/vec_ext.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+namespace tb::mdl
+{
+
+struct CompactBrushGeometry::Shape
+{
+  std::vector<vm::vec3d> positions;
+  std::vector<vm::plane3d> facePlanes;
+  std::vector<uint32_t> faceVertexIndices;
+  std::vector<uint32_t> faceOffsets;
+  std::vector<Edge> edges;
+
+  friend bool operator==(const Shape& lhs, const Shape& rhs) = default;
+
+  // the vertex positions and face vertex indices determine the rest of the shape
+  size_t hash() const
+  {
+    auto result = kdl::hash(positions.size(), faceVertexIndices.size());
+    for (const auto& position : positions)
+    {
+      result = kdl::combine_hash(
+        result, kdl::hash(position.x(), position.y(), position.z()));
+    }
+    for (const auto index : faceVertexIndices)
+    {
+      result = kdl::combine_hash(result, kdl::hash(index));
+    }
+    return result;
+  }
+};
+
+namespace
+{
+
+/**
+ * Returns the offset by which the given positions and planes are stored relative to
+ * their shape. Translating them by the offset and back must restore them exactly, so
+ * the offset is only used if it does not change any of them due to rounding.
+ */
+vm::vec3d shapeOffset(
+  const vm::bbox3d& bounds,
+  const std::vector<vm::vec3d>& positions,
+  const std::vector<vm::plane3d>& facePlanes)
+{
+  const auto offset = vm::floor(bounds.min);
+
+  const auto restoresPositions =
+    std::ranges::all_of(positions, [&](const auto& position) {
+      return (position - offset) + offset == position;
+    });
+  const auto restoresPlanes = std::ranges::all_of(facePlanes, [&](const auto& plane) {
+    const auto delta = vm::dot(plane.normal, offset);
+    return (plane.distance - delta) + delta == plane.distance;
+  });
+
+  return restoresPositions && restoresPlanes ? offset : vm::vec3d{0, 0, 0};
+}
+
+} // namespace
+
+vm::vec3d CompactBrushGeometry::AxisRotation::apply(const vm::vec3d& v) const
+{
+  auto result = vm::vec3d{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    result[i] = negate[i] ? -v[axes[i]] : v[axes[i]];
+  }
+  return result;
+}
+
+vm::vec3d CompactBrushGeometry::AxisRotation::applyInverse(const vm::vec3d& v) const
+{
+  auto result = vm::vec3d{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    result[axes[i]] = negate[i] ? -v[i] : v[i];
+  }
+  return result;
+}
+
+CompactBrushGeometry::AxisRotation CompactBrushGeometry::AxisRotation::after(
+  const AxisRotation& inner) const
+{
+  auto result = AxisRotation{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    result.axes[i] = inner.axes[axes[i]];
+    result.negate[i] = negate[i] != inner.negate[axes[i]];
+  }
+  return result;
+}
+
+CompactBrushGeometry::CompactBrushGeometry(
+  BrushGeometry& geometry, std::vector<vm::plane3d> facePlanes)
+  : m_bounds{geometry.bounds()}
+{
+  ensure(facePlanes.size() == geometry.faceCount(), "a plane is given for every face");
+
+  auto shape = Shape{};
+  shape.facePlanes = std::move(facePlanes);
+
+  // number the vertices in the order in which the faces visit them
+  for (auto* faceGeometry : geometry.faces())
+  {
+    for (auto* halfEdge : faceGeometry->boundary())
+    {
+      halfEdge->origin()->setPayload(BrushVertexPayload::defaultValue());
+    }
+  }
+
+  shape.positions.reserve(geometry.vertexCount());
+  for (auto* faceGeometry : geometry.faces())
+  {
+    for (auto* halfEdge : faceGeometry->boundary())
+    {
+      auto* vertex = halfEdge->origin();
+      if (vertex->payload() == BrushVertexPayload::defaultValue())
+      {
+        vertex->setPayload(static_cast<uint32_t>(shape.positions.size()));
+        shape.positions.push_back(vertex->position());
+      }
+    }
+  }
+
+  const auto faceCount = geometry.faceCount();
+
+  // count the vertices of each face first, the faces are not ordered by their payload
+  shape.faceOffsets.resize(faceCount + 1, 0);
+  for (const auto* faceGeometry : geometry.faces())
+  {
+    const auto faceIndex = faceGeometry->payload();
+    ensure(faceIndex && *faceIndex < faceCount, "face index is valid");
+    shape.faceOffsets[*faceIndex + 1] =
+      static_cast<uint32_t>(faceGeometry->vertexCount());
+  }
+
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    shape.faceOffsets[i + 1] += shape.faceOffsets[i];
+  }
+
+  shape.faceVertexIndices.resize(shape.faceOffsets.back());
+  for (const auto* faceGeometry : geometry.faces())
+  {
+    auto index = shape.faceOffsets[*faceGeometry->payload()];
+    for (const auto* halfEdge : faceGeometry->boundary())
+    {
+      shape.faceVertexIndices[index++] = halfEdge->origin()->payload();
+    }
+  }
+
+  shape.edges.reserve(geometry.edgeCount());
+  for (const auto* edge : geometry.edges())
+  {
+    shape.edges.push_back(Edge{
+      edge->firstVertex()->payload(),
+      edge->secondVertex()->payload(),
+      static_cast<uint32_t>(*edge->firstFace()->payload()),
+      static_cast<uint32_t>(*edge->secondFace()->payload()),
+    });
+  }
+
+  m_offset = shapeOffset(m_bounds, shape.positions, shape.facePlanes);
+  for (auto& position : shape.positions)
+  {
+    position = position - m_offset;
+  }
+  for (auto& plane : shape.facePlanes)
+  {
+    plane.distance = plane.distance - vm::dot(plane.normal, m_offset);
+  }
+
+  struct ShapeHash
+  {
+    size_t operator()(const Shape& shape) const { return shape.hash(); }
+  };
+
+  static auto pool = kdl::intern_pool<Shape, ShapeHash>{};
+  m_shape = pool.intern(shape, [&]() { return std::move(shape); });
+}
+
+CompactBrushGeometry::CompactBrushGeometry(
+  BrushGeometry& geometry,
+  std::vector<vm::plane3d> facePlanes,
+  const CompactBrushGeometry& original,
+  const vm::mat4x4d& transformation,
+  const std::vector<size_t>& originalFaceIndices)
+  : CompactBrushGeometry{geometry, std::move(facePlanes)}
+{
+  // translated copies already share their shape through the pool
+  if (!sharesShape(original))
+  {
+    shareShape(original, transformation, originalFaceIndices);
+  }
+}
+
+CompactBrushGeometry::~CompactBrushGeometry() = default;
+
+const vm::bbox3d& CompactBrushGeometry::bounds() const
+{
+  return m_bounds;
+}
+
+const vm::vec3d& CompactBrushGeometry::offset() const
+{
+  return m_offset;
+}
+
+bool CompactBrushGeometry::sharesShape(const CompactBrushGeometry& other) const
+{
+  return m_shape == other.m_shape;
+}
+
+size_t CompactBrushGeometry::vertexCount() const
+{
+  return m_shape->positions.size();
+}
+
+vm::vec3d CompactBrushGeometry::position(const size_t vertexIndex) const
+{
+  return m_rotation.apply(m_shape->positions[vertexIndex]) + m_offset;
+}
+
+std::vector<vm::vec3d> CompactBrushGeometry::positions() const
+{
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(m_shape->positions.size());
+  for (const auto& position : m_shape->positions)
+  {
+    result.push_back(m_rotation.apply(position) + m_offset);
+  }
+  return result;
+}
+
+size_t CompactBrushGeometry::faceCount() const
+{
+  return m_shape->faceOffsets.size() - 1;
+}
+
+std::span<const uint32_t> CompactBrushGeometry::faceVertexIndices(
+  const size_t faceIndex) const
+{
+  const auto shapeFaceIndex = toShapeFaceIndex(faceIndex);
+  const auto first = m_shape->faceOffsets[shapeFaceIndex];
+  const auto last = m_shape->faceOffsets[shapeFaceIndex + 1];
+  return std::span{m_shape->faceVertexIndices}.subspan(first, last - first);
+}
+
+std::vector<CompactBrushGeometry::Edge> CompactBrushGeometry::edges() const
+{
+  if (m_shapeFaceIndices.empty())
+  {
+    return m_shape->edges;
+  }
+
+  auto faceIndices = std::vector<uint32_t>(m_shapeFaceIndices.size());
+  for (size_t i = 0; i < m_shapeFaceIndices.size(); ++i)
+  {
+    faceIndices[m_shapeFaceIndices[i]] = static_cast<uint32_t>(i);
+  }
+
+  auto result = std::vector<Edge>{};
+  result.reserve(m_shape->edges.size());
+  for (const auto& edge : m_shape->edges)
+  {
+    result.push_back(Edge{
+      edge.vertexIndex1,
+      edge.vertexIndex2,
+      faceIndices[edge.faceIndex1],
+      faceIndices[edge.faceIndex2],
+    });
+  }
+  return result;
+}
+
+std::vector<vm::plane3d> CompactBrushGeometry::facePlanes() const
+{
+  auto result = std::vector<vm::plane3d>{};
+  result.reserve(m_shape->facePlanes.size());
+  for (size_t i = 0; i < m_shape->facePlanes.size(); ++i)
+  {
+    result.push_back(facePlane(i));
+  }
+  return result;
+}
+
+std::optional<std::tuple<double, size_t>> CompactBrushGeometry::intersectWithRay(
+  const vm::ray3d& ray) const
+{
+  // the distance along the ray does not change when the ray is moved into shape space
+  const auto hit = vm::intersect_ray_polygons(
+    vm::ray3d{
+      m_rotation.applyInverse(ray.origin - m_offset),
+      m_rotation.applyInverse(ray.direction)},
+    m_shape->facePlanes,
+    m_shape->positions,
+    m_shape->faceOffsets,
+    m_shape->faceVertexIndices,
+    vm::side::front);
+
+  if (!hit || m_shapeFaceIndices.empty())
+  {
+    return hit;
+  }
+
+  const auto [distance, shapeFaceIndex] = *hit;
+  const auto faceIndex = std::ranges::find(m_shapeFaceIndices, shapeFaceIndex);
+  assert(faceIndex != m_shapeFaceIndices.end());
+  return std::tuple{
+    distance, static_cast<size_t>(std::distance(m_shapeFaceIndices.begin(), faceIndex))};
+}
+
+size_t CompactBrushGeometry::toShapeFaceIndex(const size_t faceIndex) const
+{
+  return m_shapeFaceIndices.empty() ? faceIndex : m_shapeFaceIndices[faceIndex];
+}
+
+vm::plane3d CompactBrushGeometry::facePlane(const size_t faceIndex) const
+{
+  const auto& plane = m_shape->facePlanes[toShapeFaceIndex(faceIndex)];
+  const auto normal = m_rotation.apply(plane.normal);
+  return vm::plane3d{plane.distance + vm::dot(normal, m_offset), normal};
+}
+
+void CompactBrushGeometry::shareShape(
+  const CompactBrushGeometry& original,
+  const vm::mat4x4d& transformation,
+  const std::vector<size_t>& originalFaceIndices)
+{
+  constexpr auto epsilon = vm::constants<double>::almost_zero();
+
+  // Rotation matrices usually contain rounding errors, so the rotation is snapped to the
+  // axes. Whether the result is exact is checked below.
+  auto rotation = AxisRotation{};
+  auto usedAxes = std::array<bool, 3>{false, false, false};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (!vm::is_zero(transformation[i][3], epsilon))
+    {
+      return;
+    }
+
+    auto axisCount = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      // the matrix is stored in column major order
+      const auto value = transformation[j][i];
+      if (vm::is_equal(vm::abs(value), 1.0, epsilon))
+      {
+        rotation.axes[i] = static_cast<uint8_t>(j);
+        rotation.negate[i] = value < 0.0;
+        ++axisCount;
+      }
+      else if (!vm::is_zero(value, epsilon))
+      {
+        return;
+      }
+    }
+
+    if (axisCount != 1 || usedAxes[rotation.axes[i]])
+    {
+      return;
+    }
+    usedAxes[rotation.axes[i]] = true;
+  }
+
+  // a reflection would reverse the order of the face vertices
+  const auto& [a0, a1, a2] = rotation.axes;
+  const auto oddPermutation = (a0 > a1) != (a0 > a2) != (a1 > a2);
+  const auto oddNegation = rotation.negate[0] != rotation.negate[1] != rotation.negate[2];
+  if (!vm::is_equal(transformation[3][3], 1.0, epsilon) || oddPermutation != oddNegation)
+  {
+    return;
+  }
+
+  const auto& shape = *original.m_shape;
+  if (
+    originalFaceIndices.size() != faceCount() || shape.positions.size() != vertexCount()
+    || shape.positions.empty() || shape.edges.size() != m_shape->edges.size())
+  {
+    return;
+  }
+
+  // the translation may contain rounding errors, too, so the offset is derived from the
+  // bounds instead
+  const auto sharedRotation = rotation.after(original.m_rotation);
+  auto rotatedShapeMin = sharedRotation.apply(shape.positions.front());
+  for (const auto& position : shape.positions)
+  {
+    rotatedShapeMin = vm::min(rotatedShapeMin, sharedRotation.apply(position));
+  }
+  const auto sharedOffset = m_bounds.min - rotatedShapeMin;
+  const auto sharedPosition = [&](const size_t vertexIndex) {
+    return sharedRotation.apply(shape.positions[vertexIndex]) + sharedOffset;
+  };
+
+  auto shapeFaceIndices = std::vector<uint32_t>{};
+  shapeFaceIndices.reserve(originalFaceIndices.size());
+  for (const auto originalFaceIndex : originalFaceIndices)
+  {
+    shapeFaceIndices.push_back(
+      static_cast<uint32_t>(original.toShapeFaceIndex(originalFaceIndex)));
+  }
+
+  // the shared shape must reproduce every face exactly, but the face boundaries may
+  // start at different vertices
+  for (size_t i = 0; i < shapeFaceIndices.size(); ++i)
+  {
+    const auto shapeFaceIndex = shapeFaceIndices[i];
+    const auto& shapePlane = shape.facePlanes[shapeFaceIndex];
+    const auto normal = sharedRotation.apply(shapePlane.normal);
+    if (
+      vm::plane3d{shapePlane.distance + vm::dot(normal, sharedOffset), normal}
+      != facePlane(i))
+    {
+      return;
+    }
+
+    const auto vertexIndices = faceVertexIndices(i);
+    const auto first = shape.faceOffsets[shapeFaceIndex];
+    const auto last = shape.faceOffsets[shapeFaceIndex + 1];
+    const auto sharedVertexIndices =
+      std::span{shape.faceVertexIndices}.subspan(first, last - first);
+    if (vertexIndices.empty() || sharedVertexIndices.size() != vertexIndices.size())
+    {
+      return;
+    }
+
+    const auto start = std::ranges::find_if(sharedVertexIndices, [&](const auto index) {
+      return sharedPosition(index) == position(vertexIndices.front());
+    });
+    if (start == sharedVertexIndices.end())
+    {
+      return;
+    }
+
+    const auto startIndex =
+      static_cast<size_t>(std::distance(sharedVertexIndices.begin(), start));
+    for (size_t j = 0; j < vertexIndices.size(); ++j)
+    {
+      const auto sharedIndex =
+        sharedVertexIndices[(startIndex + j) % vertexIndices.size()];
+      if (sharedPosition(sharedIndex) != position(vertexIndices[j]))
+      {
+        return;
+      }
+    }
+  }
+
+  const auto inOrder = std::ranges::equal(
+    shapeFaceIndices, std::views::iota(uint32_t(0), uint32_t(shapeFaceIndices.size())));
+
+  m_offset = sharedOffset;
+  m_rotation = sharedRotation;
+  m_shapeFaceIndices = inOrder ? std::vector<uint32_t>{} : std::move(shapeFaceIndices);
+  m_shape = original.m_shape;
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,189 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/BrushGeometry.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace tb::mdl
+{
+
+/**
+ * An immutable copy of a brush geometry, stored in a few contiguous arrays.
+ *
+ * Stores the vertex positions, the boundary plane of each face, the vertex indices of
+ * each face boundary in counter clockwise order, and the vertex and face indices of each
+ * edge. The faces are ordered by
+ * their payload, so face i belongs to the brush face with index i.
+ *
+ * Rendering and picking read from this instead of traversing the half edge structure of
+ * the brush geometry, which is scattered across memory.
+ *
+ * The data is stored relative to an offset in an immutable shape. Shapes are interned, so
+ * brushes that are translated copies of each other, such as the pillars or stair steps of
+ * a prefab, share one shape and only differ by their offsets.
+ *
+ * Brushes that are rotated copies of each other, such as the brushes of linked group
+ * instances that are rotated by multiples of 90 degrees, can share a shape, too. Such a
+ * geometry additionally stores the rotation of the shape and the order of its faces,
+ * see the constructor that takes an original geometry.
+ */
+class CompactBrushGeometry
+{
+public:
+  struct Edge
+  {
+    uint32_t vertexIndex1;
+    uint32_t vertexIndex2;
+    uint32_t faceIndex1;
+    uint32_t faceIndex2;
+
+    friend bool operator==(const Edge& lhs, const Edge& rhs) = default;
+  };
+
+private:
+  struct Shape;
+
+  /**
+   * A rotation by multiples of 90 degrees about the coordinate axes. Component i of a
+   * rotated vector is component axes[i] of the original vector, negated if negate[i] is
+   * set, so applying it doesn't round.
+   */
+  struct AxisRotation
+  {
+    std::array<uint8_t, 3> axes = {0, 1, 2};
+    std::array<bool, 3> negate = {false, false, false};
+
+    vm::vec3d apply(const vm::vec3d& v) const;
+    vm::vec3d applyInverse(const vm::vec3d& v) const;
+
+    /**
+     * Returns the rotation that applies the given rotation first and then this one.
+     */
+    AxisRotation after(const AxisRotation& inner) const;
+
+    friend bool operator==(const AxisRotation& lhs, const AxisRotation& rhs) = default;
+  };
+
+  vm::bbox3d m_bounds;
+  vm::vec3d m_offset;
+  AxisRotation m_rotation;
+
+  /**
+   * The index of the shape face of each face, or empty if the faces are in the order of
+   * the shape faces.
+   */
+  std::vector<uint32_t> m_shapeFaceIndices;
+
+  std::shared_ptr<const Shape> m_shape;
+
+public:
+  /**
+   * Creates a compact copy of the given geometry. Every face of the given geometry must
+   * have a payload, and the payloads must be the indices 0 to n-1 where n is the number of
+   * faces. The given face planes must contain the boundary plane of each face by index.
+   * The vertex payloads of the given geometry are overwritten.
+   */
+  CompactBrushGeometry(BrushGeometry& geometry, std::vector<vm::plane3d> facePlanes);
+
+  /**
+   * Creates a compact copy of the given geometry, which was created by applying the given
+   * transformation to the given original geometry.
+   *
+   * If the transformation is a rotation by multiples of 90 degrees about the coordinate
+   * axes followed by a translation, and if the rotated and translated shape of the
+   * original geometry reproduces the given geometry exactly, then the shape of the
+   * original geometry is shared. Otherwise, the given geometry is copied like by the
+   * other constructor.
+   *
+   * The original face indices must contain the index in the original geometry of each
+   * face of the given geometry.
+   */
+  CompactBrushGeometry(
+    BrushGeometry& geometry,
+    std::vector<vm::plane3d> facePlanes,
+    const CompactBrushGeometry& original,
+    const vm::mat4x4d& transformation,
+    const std::vector<size_t>& originalFaceIndices);
+
+  ~CompactBrushGeometry();
+
+  const vm::bbox3d& bounds() const;
+
+  /**
+   * The offset by which the shape of this geometry is translated.
+   */
+  const vm::vec3d& offset() const;
+
+  /**
+   * Indicates whether this geometry shares its shape with the given geometry, i.e.
+   * whether the geometries are translated or rotated copies of each other.
+   */
+  bool sharesShape(const CompactBrushGeometry& other) const;
+
+  size_t vertexCount() const;
+  vm::vec3d position(size_t vertexIndex) const;
+  std::vector<vm::vec3d> positions() const;
+
+  size_t faceCount() const;
+
+  /**
+   * Returns the indices of the vertices of the face with the given index in counter
+   * clockwise order.
+   */
+  std::span<const uint32_t> faceVertexIndices(size_t faceIndex) const;
+
+  std::vector<Edge> edges() const;
+
+  std::vector<vm::plane3d> facePlanes() const;
+
+  /**
+   * Intersects the faces with the given ray.
+   *
+   * Returns the distance from the ray origin to the closest point of intersection and the
+   * index of the intersected face, or nullopt if the ray does not hit the front of any
+   * face.
+   */
+  std::optional<std::tuple<double, size_t>> intersectWithRay(const vm::ray3d& ray) const;
+
+private:
+  size_t toShapeFaceIndex(size_t faceIndex) const;
+  vm::plane3d facePlane(size_t faceIndex) const;
+
+  void shareShape(
+    const CompactBrushGeometry& original,
+    const vm::mat4x4d& transformation,
+    const std::vector<size_t>& originalFaceIndices);
+};
+
+} // namespace tb::mdl
@@ -21,18 +21,32 @@
 
 #include "kdl/reflection_decl.h"
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <variant>
 
 namespace tb::mdl
 {
+
+// Every task has a `concurrent` flag. A concurrent task is started as soon as the task
+// before it was started, so it runs alongside that task. All other tasks wait until
+// every task before them has finished.
+
 struct CompilationExportMap
 {
   bool enabled;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationExportMap, enabled, targetSpec);
+  /**
+   * If set, only the worldspawn entity and the brushes and entities that intersect the
+   * bounds of the current selection are exported. This allows compiling a part of a
+   * large map, e.g. to iterate on the lighting of a single room.
+   */
+  bool selectionOnly = false;
+
+  kdl_reflect_decl(CompilationExportMap, enabled, targetSpec, concurrent, selectionOnly);
 };
 
 struct CompilationCopyFiles
@@ -40,8 +54,9 @@ struct CompilationCopyFiles
   bool enabled;
   std::string sourceSpec;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationCopyFiles, enabled, sourceSpec, targetSpec);
+  kdl_reflect_decl(CompilationCopyFiles, enabled, sourceSpec, targetSpec, concurrent);
 };
 
 struct CompilationRenameFile
@@ -49,16 +64,18 @@ struct CompilationRenameFile
   bool enabled;
   std::string sourceSpec;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationRenameFile, enabled, sourceSpec, targetSpec);
+  kdl_reflect_decl(CompilationRenameFile, enabled, sourceSpec, targetSpec, concurrent);
 };
 
 struct CompilationDeleteFiles
 {
   bool enabled;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationDeleteFiles, enabled, targetSpec);
+  kdl_reflect_decl(CompilationDeleteFiles, enabled, targetSpec, concurrent);
 };
 
 struct CompilationRunTool
@@ -67,9 +84,23 @@ struct CompilationRunTool
   std::string toolSpec;
   std::string parameterSpec;
   bool treatNonZeroResultCodeAsError;
+  bool concurrent = false;
+
+  /**
+   * The number of CPUs that the tool may use, or 0 if it may use all of them. If set,
+   * the CPU_COUNT variable evaluates to this number for the tool, and the tool is not
+   * started while other tools would exceed the available CPUs together with it.
+   */
+  size_t cpuBudget = 0;
 
   kdl_reflect_decl(
-    CompilationRunTool, enabled, toolSpec, parameterSpec, treatNonZeroResultCodeAsError);
+    CompilationRunTool,
+    enabled,
+    toolSpec,
+    parameterSpec,
+    treatNonZeroResultCodeAsError,
+    concurrent,
+    cpuBudget);
 };
 
 using CompilationTask = std::variant<
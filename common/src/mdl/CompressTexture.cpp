@@ -0,0 +1,375 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompressTexture.h"
+
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+using Pixel = std::array<uint8_t, 4>;
+using Block = std::array<Pixel, 16>;
+
+/**
+ * An RGBA8 image with tightly packed rows.
+ */
+struct Image
+{
+  size_t width;
+  size_t height;
+  TextureBuffer buffer;
+
+  Pixel pixel(const size_t x, const size_t y) const
+  {
+    const auto* p = buffer.data() + 4 * (y * width + x);
+    return {p[0], p[1], p[2], p[3]};
+  }
+};
+
+Image toRgba(
+  const TextureBuffer& buffer, const size_t width, const size_t height, const GLenum format)
+{
+  const auto bytesPerPixel = bytesPerPixelForFormat(format);
+  const auto swapRedBlue = format == GL_BGR || format == GL_BGRA;
+
+  auto result = Image{width, height, TextureBuffer{4 * width * height}};
+  const auto* src = buffer.data();
+  auto* dst = result.buffer.data();
+  for (size_t i = 0; i < width * height; ++i, src += bytesPerPixel, dst += 4)
+  {
+    dst[0] = swapRedBlue ? src[2] : src[0];
+    dst[1] = src[1];
+    dst[2] = swapRedBlue ? src[0] : src[2];
+    dst[3] = bytesPerPixel == 4 ? src[3] : 0xFF;
+  }
+  return result;
+}
+
+Image downsample(const Image& image)
+{
+  const auto width = std::max(size_t(1), image.width / 2);
+  const auto height = std::max(size_t(1), image.height / 2);
+
+  auto result = Image{width, height, TextureBuffer{4 * width * height}};
+  auto* dst = result.buffer.data();
+  for (size_t y = 0; y < height; ++y)
+  {
+    const auto y0 = std::min(2 * y, image.height - 1);
+    const auto y1 = std::min(2 * y + 1, image.height - 1);
+    for (size_t x = 0; x < width; ++x, dst += 4)
+    {
+      const auto x0 = std::min(2 * x, image.width - 1);
+      const auto x1 = std::min(2 * x + 1, image.width - 1);
+      const auto p00 = image.pixel(x0, y0);
+      const auto p01 = image.pixel(x1, y0);
+      const auto p10 = image.pixel(x0, y1);
+      const auto p11 = image.pixel(x1, y1);
+      for (size_t c = 0; c < 4; ++c)
+      {
+        dst[c] = uint8_t((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+      }
+    }
+  }
+  return result;
+}
+
+Block readBlock(const Image& image, const size_t blockX, const size_t blockY)
+{
+  // pixels of partial blocks are clamped to the image bounds
+  auto block = Block{};
+  for (size_t y = 0; y < 4; ++y)
+  {
+    for (size_t x = 0; x < 4; ++x)
+    {
+      block[y * 4 + x] = image.pixel(
+        std::min(blockX * 4 + x, image.width - 1),
+        std::min(blockY * 4 + y, image.height - 1));
+    }
+  }
+  return block;
+}
+
+uint16_t toRgb565(const Pixel& p)
+{
+  return uint16_t(((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3));
+}
+
+Pixel fromRgb565(const uint16_t c)
+{
+  const auto r = uint8_t((c >> 11) & 0x1F);
+  const auto g = uint8_t((c >> 5) & 0x3F);
+  const auto b = uint8_t(c & 0x1F);
+  return {
+    uint8_t((r << 3) | (r >> 2)),
+    uint8_t((g << 2) | (g >> 4)),
+    uint8_t((b << 3) | (b >> 2)),
+    0xFF};
+}
+
+Pixel lerp(const Pixel& a, const Pixel& b, const int wa, const int wb, const int d)
+{
+  return {
+    uint8_t((wa * a[0] + wb * b[0]) / d),
+    uint8_t((wa * a[1] + wb * b[1]) / d),
+    uint8_t((wa * a[2] + wb * b[2]) / d),
+    0xFF};
+}
+
+int squaredDistance(const Pixel& a, const Pixel& b)
+{
+  auto result = 0;
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const auto d = int(a[c]) - int(b[c]);
+    result += d * d;
+  }
+  return result;
+}
+
+template <typename T>
+void writeLittleEndian(unsigned char*& out, T value)
+{
+  for (size_t i = 0; i < sizeof(T); ++i)
+  {
+    *out++ = uint8_t(value & 0xFF);
+    value = T(value >> 8);
+  }
+}
+
+/**
+ * Encodes the color channels of the given block using the bounding box of the block's
+ * colors as the endpoints. The endpoints are always ordered so that the block is decoded
+ * in four color mode.
+ */
+void encodeColorBlock(const Block& block, unsigned char*& out)
+{
+  auto min = Pixel{0xFF, 0xFF, 0xFF, 0xFF};
+  auto max = Pixel{0, 0, 0, 0};
+  for (const auto& p : block)
+  {
+    for (size_t c = 0; c < 3; ++c)
+    {
+      min[c] = std::min(min[c], p[c]);
+      max[c] = std::max(max[c], p[c]);
+    }
+  }
+
+  // inset the bounding box slightly to reduce the error on the endpoints
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const auto inset = (max[c] - min[c]) / 16;
+    min[c] = uint8_t(min[c] + inset);
+    max[c] = uint8_t(max[c] - inset);
+  }
+
+  auto color0 = toRgb565(max);
+  auto color1 = toRgb565(min);
+  if (color0 < color1)
+  {
+    std::swap(color0, color1);
+  }
+
+  auto indices = uint32_t(0);
+  if (color0 != color1)
+  {
+    const auto c0 = fromRgb565(color0);
+    const auto c1 = fromRgb565(color1);
+    const auto palette = std::array<Pixel, 4>{
+      c0, c1, lerp(c0, c1, 2, 1, 3), lerp(c0, c1, 1, 2, 3)};
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+      auto bestIndex = uint32_t(0);
+      auto bestDistance = squaredDistance(block[i], palette[0]);
+      for (uint32_t j = 1; j < 4; ++j)
+      {
+        if (const auto distance = squaredDistance(block[i], palette[j]);
+            distance < bestDistance)
+        {
+          bestIndex = j;
+          bestDistance = distance;
+        }
+      }
+      indices |= bestIndex << (2 * i);
+    }
+  }
+
+  writeLittleEndian(out, color0);
+  writeLittleEndian(out, color1);
+  writeLittleEndian(out, indices);
+}
+
+/**
+ * Encodes the alpha channel of the given block in eight alpha mode.
+ */
+void encodeAlphaBlock(const Block& block, unsigned char*& out)
+{
+  auto alpha0 = uint8_t(0);
+  auto alpha1 = uint8_t(0xFF);
+  for (const auto& p : block)
+  {
+    alpha0 = std::max(alpha0, p[3]);
+    alpha1 = std::min(alpha1, p[3]);
+  }
+
+  auto indices = uint64_t(0);
+  if (alpha0 != alpha1)
+  {
+    auto palette = std::array<int, 8>{alpha0, alpha1};
+    for (size_t j = 1; j < 7; ++j)
+    {
+      palette[j + 1] = (int(7 - j) * alpha0 + int(j) * alpha1) / 7;
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+      auto bestIndex = uint64_t(0);
+      auto bestDistance = std::abs(int(block[i][3]) - palette[0]);
+      for (uint64_t j = 1; j < 8; ++j)
+      {
+        if (const auto distance = std::abs(int(block[i][3]) - palette[j]);
+            distance < bestDistance)
+        {
+          bestIndex = j;
+          bestDistance = distance;
+        }
+      }
+      indices |= bestIndex << (3 * i);
+    }
+  }
+
+  *out++ = alpha0;
+  *out++ = alpha1;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    *out++ = uint8_t((indices >> (8 * i)) & 0xFF);
+  }
+}
+
+bool isOpaque(const Image& image)
+{
+  const auto* p = image.buffer.data();
+  for (size_t i = 0; i < image.width * image.height; ++i, p += 4)
+  {
+    if (p[3] != 0xFF)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+TextureBuffer compressImage(const Image& image, const GLenum format)
+{
+  const auto blocksX = (image.width + 3) / 4;
+  const auto blocksY = (image.height + 3) / 4;
+
+  auto result = TextureBuffer{blockSizeForFormat(format) * blocksX * blocksY};
+  auto* out = result.data();
+  for (size_t blockY = 0; blockY < blocksY; ++blockY)
+  {
+    for (size_t blockX = 0; blockX < blocksX; ++blockX)
+    {
+      const auto block = readBlock(image, blockX, blockY);
+      if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+      {
+        encodeAlphaBlock(block, out);
+      }
+      encodeColorBlock(block, out);
+    }
+  }
+  return result;
+}
+
+size_t mipLevelCount(size_t width, size_t height)
+{
+  auto result = size_t(1);
+  while (width > 1 || height > 1)
+  {
+    width = std::max(size_t(1), width / 2);
+    height = std::max(size_t(1), height / 2);
+    ++result;
+  }
+  return result;
+}
+
+} // namespace
+
+Texture compressTexture(Texture texture)
+{
+  const auto& buffers = texture.buffersIfLoaded();
+  if (
+    buffers.empty() || isCompressedFormat(texture.format())
+    || texture.mask() == TextureMask::On)
+  {
+    return texture;
+  }
+
+  const auto width = texture.width();
+  const auto height = texture.height();
+
+  const auto mipLevels = mipLevelCount(width, height);
+
+  auto images = std::vector<Image>{};
+  images.reserve(mipLevels);
+  for (size_t level = 0; level < mipLevels; ++level)
+  {
+    if (level < buffers.size())
+    {
+      const auto mipSize = sizeAtMipLevel(width, height, level);
+      images.push_back(toRgba(buffers[level], mipSize.x(), mipSize.y(), texture.format()));
+    }
+    else
+    {
+      images.push_back(downsample(images.back()));
+    }
+  }
+
+  const auto format = GLenum(
+    isOpaque(images.front()) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+                             : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+
+  auto compressedBuffers = TextureBufferList{};
+  compressedBuffers.reserve(images.size());
+  for (const auto& image : images)
+  {
+    compressedBuffers.push_back(compressImage(image, format));
+  }
+
+  return Texture{
+    width,
+    height,
+    texture.averageColor(),
+    format,
+    texture.mask(),
+    texture.embeddedDefaults(),
+    std::move(compressedBuffers)};
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,36 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace tb::mdl
+{
+class Texture;
+
+/**
+ * Compresses the given texture using BC1 (DXT1) if it is fully opaque or BC3 (DXT5)
+ * otherwise. Since mipmaps cannot be generated for compressed textures when they are
+ * uploaded, any missing mip levels are generated before compression.
+ *
+ * Returns the given texture unchanged if it is already compressed, if it is masked, or if
+ * its buffers are not available.
+ */
+Texture compressTexture(Texture texture);
+
+} // namespace tb::mdl
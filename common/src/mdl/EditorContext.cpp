@@ -48,6 +48,39 @@ void EditorContext::reset()
   m_blockSelection = false;
   m_currentGroup = nullptr;
   m_currentLayer = nullptr;
+  m_cache.clear();
+}
+
+void EditorContext::invalidateCache()
+{
+  ++m_generation;
+}
+
+void EditorContext::removeCachedStates(const std::vector<Node*>& nodes)
+{
+  for (const auto* node : nodes)
+  {
+    m_cache.erase(node);
+    removeCachedStates(node->children());
+  }
+}
+
+template <typename T>
+bool EditorContext::cachedVisible(const T& node) const
+{
+  if (const auto it = m_cache.find(&node);
+      it != m_cache.end() && it->second.visibleGeneration == m_generation)
+  {
+    return it->second.visible;
+  }
+
+  // computing the visibility may insert other nodes into the cache
+  const auto result = computeVisible(node);
+
+  auto& state = m_cache[&node];
+  state.visible = result;
+  state.visibleGeneration = m_generation;
+  return result;
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -60,6 +93,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    invalidateCache();
     editorContextDidChangeNotifier();
   }
 }
@@ -81,6 +115,7 @@ void EditorContext::setEntityDefinitionHidden(
   if (entityDefinitionHidden(definition) != hidden)
   {
     m_hiddenEntityDefinitions[definition.index] = hidden;
+    invalidateCache();
     editorContextDidChangeNotifier();
   }
 }
@@ -160,6 +195,31 @@ bool EditorContext::visible(const LayerNode& layerNode) const
 }
 
 bool EditorContext::visible(const GroupNode& groupNode) const
+{
+  return cachedVisible(groupNode);
+}
+
+bool EditorContext::visible(const EntityNode& entityNode) const
+{
+  return cachedVisible(entityNode);
+}
+
+bool EditorContext::visible(const BrushNode& brushNode) const
+{
+  return cachedVisible(brushNode);
+}
+
+bool EditorContext::visible(const BrushNode& brushNode, const BrushFace& face) const
+{
+  return visible(brushNode) && !face.hasTag(m_hiddenTags);
+}
+
+bool EditorContext::visible(const PatchNode& patchNode) const
+{
+  return cachedVisible(patchNode);
+}
+
+bool EditorContext::computeVisible(const GroupNode& groupNode) const
 {
   if (groupNode.selected())
   {
@@ -172,7 +232,7 @@ bool EditorContext::visible(const GroupNode& groupNode) const
   return groupNode.visible();
 }
 
-bool EditorContext::visible(const EntityNode& entityNode) const
+bool EditorContext::computeVisible(const EntityNode& entityNode) const
 {
   if (entityNode.selected())
   {
@@ -202,7 +262,7 @@ bool EditorContext::visible(const EntityNode& entityNode) const
   return true;
 }
 
-bool EditorContext::visible(const BrushNode& brushNode) const
+bool EditorContext::computeVisible(const BrushNode& brushNode) const
 {
   if (brushNode.selected())
   {
@@ -233,12 +293,7 @@ bool EditorContext::visible(const BrushNode& brushNode) const
   return brushNode.visible();
 }
 
-bool EditorContext::visible(const BrushNode& brushNode, const BrushFace& face) const
-{
-  return visible(brushNode) && !face.hasTag(m_hiddenTags);
-}
-
-bool EditorContext::visible(const PatchNode& patchNode) const
+bool EditorContext::computeVisible(const PatchNode& patchNode) const
 {
   if (patchNode.selected())
   {
@@ -262,7 +317,13 @@ bool EditorContext::anyChildVisible(const Node& node) const
 
 bool EditorContext::editable(const Node& node) const
 {
-  return node.editable();
+  auto& state = m_cache[&node];
+  if (state.editableGeneration != m_generation)
+  {
+    state.editable = node.editable();
+    state.editableGeneration = m_generation;
+  }
+  return state.editable;
 }
 
 bool EditorContext::editable(const BrushNode& brushNode, const BrushFace&) const
@@ -24,6 +24,9 @@
 
 #include "kdl/dynamic_bitset.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace tb::mdl
 {
 struct EntityDefinition;
@@ -38,9 +41,27 @@ class Object;
 class PatchNode;
 class WorldNode;
 
+/**
+ * Decides which nodes and faces are visible, editable and selectable.
+ *
+ * Visibility and editability depend on the parents of a node and, for groups and brush
+ * entities, on their children, so they are cached per node. The cache must be invalidated
+ * whenever anything that affects them changes. The editor context invalidates it when its
+ * own state changes, and the map invalidates it when nodes change, see invalidateCache.
+ *
+ * The cache makes the editor context unsafe to use from multiple threads.
+ */
 class EditorContext
 {
 private:
+  struct CachedNodeState
+  {
+    size_t visibleGeneration = 0;
+    bool visible = false;
+    size_t editableGeneration = 0;
+    bool editable = false;
+  };
+
   TagType::Type m_hiddenTags;
   kdl::dynamic_bitset m_hiddenEntityDefinitions;
 
@@ -49,6 +70,12 @@ private:
   LayerNode* m_currentLayer = nullptr;
   GroupNode* m_currentGroup = nullptr;
 
+  /**
+   * Cached states whose generation differs from the current generation are stale.
+   */
+  size_t m_generation = 1;
+  mutable std::unordered_map<const Node*, CachedNodeState> m_cache;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -57,6 +84,17 @@ public:
 
   void reset();
 
+  /**
+   * Discards the cached visibility and editability of all nodes.
+   */
+  void invalidateCache();
+
+  /**
+   * Removes the cached states of the given nodes and their descendants. Must be called
+   * when nodes are removed from the map so that the cache does not keep growing.
+   */
+  void removeCachedStates(const std::vector<Node*>& nodes);
+
   TagType::Type hiddenTags() const;
   void setHiddenTags(TagType::Type hiddenTags);
 
@@ -86,6 +124,14 @@ public:
   bool visible(const PatchNode& patchNode) const;
 
 private:
+  bool computeVisible(const GroupNode& groupNode) const;
+  bool computeVisible(const EntityNode& entityNode) const;
+  bool computeVisible(const BrushNode& brushNode) const;
+  bool computeVisible(const PatchNode& patchNode) const;
+
+  template <typename T>
+  bool cachedVisible(const T& node) const;
+
   bool anyChildVisible(const Node& node) const;
 
 public:
@@ -94,6 +94,7 @@ void Entity::setProperties(std::vector<EntityProperty> properties)
   m_cachedOrigin = std::nullopt;
   m_cachedRotation = std::nullopt;
   m_cachedModelTransformation = std::nullopt;
+  m_cachedModelSpecification = std::nullopt;
 }
 
 const std::vector<std::string>& Entity::protectedProperties() const
@@ -147,6 +148,7 @@ void Entity::setDefinition(const EntityDefinition* definition)
 
   m_cachedRotation = std::nullopt;
   m_cachedModelTransformation = std::nullopt;
+  m_cachedModelSpecification = std::nullopt;
 }
 
 const EntityModel* Entity::model() const
@@ -182,12 +184,20 @@ const EntityModelFrame* Entity::modelFrame() const
 
 Result<ModelSpecification> Entity::modelSpecification() const
 {
-  if (const auto* pointEntityDefinition = getPointEntityDefinition(definition()))
+  if (!m_cachedModelSpecification)
   {
-    const auto variableStore = EntityPropertiesVariableStore{*this};
-    return pointEntityDefinition->modelDefinition.modelSpecification(variableStore);
+    if (const auto* pointEntityDefinition = getPointEntityDefinition(definition()))
+    {
+      const auto variableStore = EntityPropertiesVariableStore{*this};
+      m_cachedModelSpecification =
+        pointEntityDefinition->modelDefinition.modelSpecification(variableStore);
+    }
+    else
+    {
+      m_cachedModelSpecification = ModelSpecification{};
+    }
   }
-  return ModelSpecification{};
+  return *m_cachedModelSpecification;
 }
 
 const vm::mat4x4d& Entity::modelTransformation(
@@ -232,6 +242,7 @@ void Entity::unsetEntityDefinitionAndModel()
   m_model = nullptr;
   m_cachedRotation = std::nullopt;
   m_cachedModelTransformation = std::nullopt;
+  m_cachedModelSpecification = std::nullopt;
 }
 
 void Entity::addOrUpdateProperty(
@@ -256,6 +267,7 @@ void Entity::addOrUpdateProperty(
   m_cachedOrigin = std::nullopt;
   m_cachedRotation = std::nullopt;
   m_cachedModelTransformation = std::nullopt;
+  m_cachedModelSpecification = std::nullopt;
 }
 
 void Entity::renameProperty(const std::string& oldKey, std::string newKey)
@@ -288,6 +300,7 @@ void Entity::renameProperty(const std::string& oldKey, std::string newKey)
     m_cachedOrigin = std::nullopt;
     m_cachedRotation = std::nullopt;
     m_cachedModelTransformation = std::nullopt;
+    m_cachedModelSpecification = std::nullopt;
   }
 }
 
@@ -302,6 +315,7 @@ void Entity::removeProperty(const std::string& key)
     m_cachedOrigin = std::nullopt;
     m_cachedRotation = std::nullopt;
     m_cachedModelTransformation = std::nullopt;
+    m_cachedModelSpecification = std::nullopt;
   }
 }
 
@@ -317,6 +331,7 @@ void Entity::removeNumberedProperty(const std::string& prefix)
     m_cachedOrigin = std::nullopt;
     m_cachedRotation = std::nullopt;
     m_cachedModelTransformation = std::nullopt;
+    m_cachedModelSpecification = std::nullopt;
   }
 }
 
@@ -23,6 +23,7 @@
 #include "el/EL_Forward.h" // IWYU pragma: keep
 #include "mdl/AssetReference.h"
 #include "mdl/EntityProperties.h"
+#include "mdl/ModelSpecification.h"
 
 #include "kdl/reflection_decl.h"
 
@@ -41,7 +42,6 @@ class Entity;
 struct EntityDefinition;
 class EntityModel;
 class EntityModelFrame;
-struct ModelSpecification;
 
 enum class SetDefaultPropertyMode
 {
@@ -107,6 +107,7 @@ private:
   mutable std::optional<vm::vec3d> m_cachedOrigin;
   mutable std::optional<vm::mat4x4d> m_cachedRotation;
   mutable std::optional<vm::mat4x4d> m_cachedModelTransformation;
+  mutable std::optional<Result<ModelSpecification>> m_cachedModelSpecification;
 
 public:
   Entity();
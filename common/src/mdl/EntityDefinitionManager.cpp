@@ -43,9 +43,10 @@ EntityDefinitionManager::~EntityDefinitionManager()
 Result<void> EntityDefinitionManager::loadDefinitions(
   const std::filesystem::path& path,
   const io::EntityDefinitionLoader& loader,
-  io::ParserStatus& status)
+  io::ParserStatus& status,
+  kdl::task_manager& taskManager)
 {
-  return loader.loadEntityDefinitions(status, path)
+  return loader.loadEntityDefinitions(status, path, taskManager)
          | kdl::transform(
            [&](auto entityDefinitions) { setDefinitions(std::move(entityDefinitions)); });
 }
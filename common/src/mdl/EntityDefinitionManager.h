@@ -27,6 +27,10 @@
 #include <string_view>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+} // namespace kdl
 
 namespace tb::io
 {
@@ -52,7 +56,8 @@ public:
   Result<void> loadDefinitions(
     const std::filesystem::path& path,
     const io::EntityDefinitionLoader& loader,
-    io::ParserStatus& status);
+    io::ParserStatus& status,
+    kdl::task_manager& taskManager);
   void setDefinitions(std::vector<EntityDefinition> newDefinitions);
   void clear();
 
@@ -32,11 +32,18 @@
 #include "vm/bbox.h"
 #include "vm/bbox_io.h" // IWYU pragma: keep
 #include "vm/intersection.h"
+#include "vm/vec.h"
 
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 namespace tb::mdl
 {
@@ -78,6 +85,189 @@ std::ostream& operator<<(std::ostream& lhs, const Orientation rhs)
   return lhs;
 }
 
+namespace
+{
+
+/**
+ * Calls the given function with the indices of the vertices of every triangle of the
+ * given primitive. Points and lines are skipped.
+ */
+template <typename F>
+void forEachTriangle(
+  const render::PrimType primType, const size_t index, const size_t count, const F& f)
+{
+  switch (primType)
+  {
+  case render::PrimType::Points:
+  case render::PrimType::Lines:
+  case render::PrimType::LineStrip:
+  case render::PrimType::LineLoop:
+    break;
+  case render::PrimType::Triangles:
+    assert(count % 3 == 0);
+    for (size_t i = 0; i < count; i += 3)
+    {
+      f(index + i + 0, index + i + 1, index + i + 2);
+    }
+    break;
+  case render::PrimType::Polygon:
+  case render::PrimType::TriangleFan:
+    assert(count > 2);
+    for (size_t i = 1; i < count - 1; ++i)
+    {
+      f(index, index + i, index + i + 1);
+    }
+    break;
+  case render::PrimType::Quads:
+  case render::PrimType::QuadStrip:
+  case render::PrimType::TriangleStrip:
+    assert(count > 2);
+    for (size_t i = 0; i < count - 2; ++i)
+    {
+      if (i % 2 == 0)
+      {
+        f(index + i + 0, index + i + 1, index + i + 2);
+      }
+      else
+      {
+        f(index + i + 0, index + i + 2, index + i + 1);
+      }
+    }
+    break;
+    switchDefault();
+  }
+}
+
+/**
+ * A simplified mesh is only used if it has at most this fraction of the triangles of the
+ * original mesh.
+ */
+constexpr auto MaxSimplifiedTriangleRatio = 0.75;
+
+/**
+ * Simplifies the given mesh by merging the vertices in each cell of a grid with the
+ * given cell size. A merged vertex is placed at the average position of the vertices in
+ * its cell and keeps the UV coordinates of the first of them. Triangles that collapse
+ * into a line or a point are removed, as are triangles that are merged into the same
+ * triangle.
+ *
+ * Returns a renderer for the simplified mesh, or null if the mesh cannot be simplified
+ * enough to be worth it.
+ */
+std::unique_ptr<render::MaterialIndexRangeRenderer> simplifyMesh(
+  const std::vector<EntityModelVertex>& vertices,
+  const render::MaterialIndexRangeMap& indices,
+  const float cellSize)
+{
+  struct Cluster
+  {
+    vm::vec3f positionSum;
+    vm::vec2f uv;
+    size_t vertexCount = 0;
+  };
+
+  using Triangle = std::array<size_t, 3>;
+
+  auto clusters = std::vector<Cluster>{};
+  auto clustersByCell = std::unordered_map<uint64_t, size_t>{};
+  auto vertexClusters = std::vector<std::optional<size_t>>(vertices.size());
+
+  const auto findCluster = [&](const size_t vertexIndex) {
+    if (!vertexClusters[vertexIndex])
+    {
+      const auto& vertex = vertices[vertexIndex];
+      const auto& position = render::getVertexComponent<0>(vertex);
+      const auto cell = vm::floor(position / cellSize);
+
+      // 21 bits per axis are enough for any grid that a model can be simplified with
+      const auto key = (uint64_t(int64_t(cell.x())) & 0x1fffff)
+                       | ((uint64_t(int64_t(cell.y())) & 0x1fffff) << 21)
+                       | ((uint64_t(int64_t(cell.z())) & 0x1fffff) << 42);
+
+      const auto [it, inserted] = clustersByCell.try_emplace(key, clusters.size());
+      if (inserted)
+      {
+        clusters.push_back({{}, render::getVertexComponent<1>(vertex), 0});
+      }
+
+      auto& cluster = clusters[it->second];
+      cluster.positionSum = cluster.positionSum + position;
+      ++cluster.vertexCount;
+      vertexClusters[vertexIndex] = it->second;
+    }
+    return *vertexClusters[vertexIndex];
+  };
+
+  auto trianglesByMaterial = std::map<const Material*, std::set<Triangle>>{};
+  auto triangleCount = size_t(0);
+  indices.forEachPrimitive([&](
+                             const Material* material,
+                             const render::PrimType primType,
+                             const size_t index,
+                             const size_t count) {
+    auto& triangles = trianglesByMaterial[material];
+    forEachTriangle(
+      primType, index, count, [&](const size_t i1, const size_t i2, const size_t i3) {
+        ++triangleCount;
+
+        const auto c1 = findCluster(i1);
+        const auto c2 = findCluster(i2);
+        const auto c3 = findCluster(i3);
+        if (c1 != c2 && c1 != c3 && c2 != c3)
+        {
+          // rotate the smallest index to the front so that equal triangles compare equal
+          // while keeping their winding order
+          auto triangle = Triangle{c1, c2, c3};
+          std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+          triangles.insert(triangle);
+        }
+      });
+  });
+
+  auto simplifiedTriangleCount = size_t(0);
+  for (const auto& [material, triangles] : trianglesByMaterial)
+  {
+    simplifiedTriangleCount += triangles.size();
+  }
+
+  if (
+    simplifiedTriangleCount == 0
+    || double(simplifiedTriangleCount)
+         > double(triangleCount) * MaxSimplifiedTriangleRatio)
+  {
+    return nullptr;
+  }
+
+  auto simplifiedVertices = std::vector<EntityModelVertex>{};
+  simplifiedVertices.reserve(simplifiedTriangleCount * 3);
+
+  auto simplifiedIndices = render::MaterialIndexRangeMap{};
+  for (const auto& [material, triangles] : trianglesByMaterial)
+  {
+    if (!triangles.empty())
+    {
+      const auto first = simplifiedVertices.size();
+      for (const auto& triangle : triangles)
+      {
+        for (const auto clusterIndex : triangle)
+        {
+          const auto& cluster = clusters[clusterIndex];
+          simplifiedVertices.emplace_back(
+            cluster.positionSum / float(cluster.vertexCount), cluster.uv);
+        }
+      }
+      simplifiedIndices.add(
+        material,
+        render::IndexRangeMap{
+          render::PrimType::Triangles, first, simplifiedVertices.size() - first});
+    }
+  }
+
+  return std::make_unique<render::MaterialIndexRangeRenderer>(
+    render::VertexArray::move(std::move(simplifiedVertices)), simplifiedIndices);
+}
+
+} // namespace
 
 // EntityModelFrame
 
@@ -88,7 +278,6 @@ EntityModelFrame::EntityModelFrame(
   : m_index{index}
   , m_name{std::move(name)}
   , m_bounds{bounds}
-  , m_spacialTree{16.0f}
 {
 }
 
@@ -119,112 +308,33 @@ const vm::bbox3f& EntityModelFrame::bounds() const
 
 std::optional<float> EntityModelFrame::intersect(const vm::ray3f& ray) const
 {
-  auto closestDistance = std::optional<float>{};
+  buildSpacialTree();
 
-  const auto candidates = m_spacialTree.find_intersectors(ray);
-  for (const auto triNum : candidates)
-  {
+  return m_spacialTree.find_closest(ray, [&](const TriNum triNum) {
     const auto& p1 = m_tris[triNum * 3 + 0];
     const auto& p2 = m_tris[triNum * 3 + 1];
     const auto& p3 = m_tris[triNum * 3 + 2];
-    closestDistance =
-      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
-  }
+    return vm::intersect_ray_triangle(ray, p1, p2, p3);
+  });
+}
 
-  return closestDistance;
+void EntityModelFrame::addMesh(const EntityModelMesh& mesh)
+{
+  m_pendingMeshes.push_back(&mesh);
 }
 
-void EntityModelFrame::addToSpacialTree(
+void EntityModelFrame::addTriangles(
   const std::vector<EntityModelVertex>& vertices,
   const render::PrimType primType,
   const size_t index,
-  const size_t count)
+  const size_t count) const
 {
-  switch (primType)
-  {
-  case render::PrimType::Points:
-  case render::PrimType::Lines:
-  case render::PrimType::LineStrip:
-  case render::PrimType::LineLoop:
-    break;
-  case render::PrimType::Triangles: {
-    assert(count % 3 == 0);
-    m_tris.reserve(m_tris.size() + count);
-    for (size_t i = 0; i < count; i += 3)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-  case render::PrimType::Polygon:
-  case render::PrimType::TriangleFan: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-
-    const auto& p1 = render::getVertexComponent<0>(vertices[index]);
-    for (size_t i = 1; i < count - 1; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-  case render::PrimType::Quads:
-  case render::PrimType::QuadStrip:
-  case render::PrimType::TriangleStrip: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-    for (size_t i = 0; i < count - 2; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      if (i % 2 == 0)
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p2);
-        m_tris.push_back(p3);
-      }
-      else
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p3);
-        m_tris.push_back(p2);
-      }
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-    switchDefault();
-  }
+  forEachTriangle(
+    primType, index, count, [&](const size_t i1, const size_t i2, const size_t i3) {
+      m_tris.push_back(render::getVertexComponent<0>(vertices[i1]));
+      m_tris.push_back(render::getVertexComponent<0>(vertices[i2]));
+      m_tris.push_back(render::getVertexComponent<0>(vertices[i3]));
+    });
 }
 
 // EntityModelData::Mesh
@@ -250,9 +360,26 @@ protected:
   }
 
 public:
+  using PrimitiveVisitor = std::function<void(
+    const std::vector<EntityModelVertex>&, render::PrimType, size_t, size_t)>;
+
   virtual ~EntityModelMesh() = default;
 
 public:
+  /**
+   * Returns the number of bytes used by the vertices of this mesh.
+   */
+  virtual size_t memorySize() const
+  {
+    return m_vertices.size() * sizeof(EntityModelVertex);
+  }
+
+  /**
+   * Calls the given visitor with the vertices, the type, the index of the first vertex
+   * and the vertex count of every primitive of this mesh.
+   */
+  virtual void forEachPrimitive(const PrimitiveVisitor& visitor) const = 0;
+
   /**
    * Returns a renderer that renders this mesh with the given material.
    *
@@ -266,6 +393,20 @@ public:
     return doBuildRenderer(skin, vertexArray);
   }
 
+  /**
+   * Returns a renderer that renders a simplified version of this mesh with the given
+   * material, or null if this mesh cannot be simplified enough.
+   *
+   * @param skin the material to use when rendering the mesh
+   * @param cellSize the size of the grid cells whose vertices are merged
+   * @return the renderer or null
+   */
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildSimplifiedRenderer(
+    const Material* skin, const float cellSize) const
+  {
+    return doBuildSimplifiedRenderer(skin, cellSize);
+  }
+
 private:
   /**
    * Creates and returns the actual mesh renderer
@@ -276,6 +417,9 @@ private:
    */
   virtual std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
     const Material* skin, const render::VertexArray& vertices) const = 0;
+
+  virtual std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildSimplifiedRenderer(
+    const Material* skin, float cellSize) const = 0;
 };
 
 // EntityModelData::IndexedMesh
@@ -297,20 +441,21 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the indices
    */
   EntityModelIndexedMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::IndexRangeMap indices)
+    std::vector<EntityModelVertex> vertices, render::IndexRangeMap indices)
     : EntityModelMesh{std::move(vertices)}
     , m_indices{std::move(indices)}
+  {
+  }
+
+  void forEachPrimitive(const PrimitiveVisitor& visitor) const override
   {
     m_indices.forEachPrimitive(
       [&](const render::PrimType primType, const size_t index, const size_t count) {
-        frame.addToSpacialTree(m_vertices, primType, index, count);
+        visitor(m_vertices, primType, index, count);
       });
   }
 
@@ -321,6 +466,13 @@ private:
     const render::MaterialIndexRangeMap indices(skin, m_indices);
     return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, indices);
   }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildSimplifiedRenderer(
+    const Material* skin, const float cellSize) const override
+  {
+    return simplifyMesh(
+      m_vertices, render::MaterialIndexRangeMap{skin, m_indices}, cellSize);
+  }
 };
 
 // EntityModelMaterialMesh
@@ -340,23 +492,24 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and per material indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the per material indices
    */
   EntityModelMaterialMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::MaterialIndexRangeMap indices)
+    std::vector<EntityModelVertex> vertices, render::MaterialIndexRangeMap indices)
     : EntityModelMesh{std::move(vertices)}
     , m_indices{std::move(indices)}
+  {
+  }
+
+  void forEachPrimitive(const PrimitiveVisitor& visitor) const override
   {
     m_indices.forEachPrimitive([&](
                                  const Material* /* material */,
                                  const render::PrimType primType,
                                  const size_t index,
                                  const size_t count) {
-      frame.addToSpacialTree(m_vertices, primType, index, count);
+      visitor(m_vertices, primType, index, count);
     });
   }
 
@@ -366,10 +519,116 @@ private:
   {
     return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, m_indices);
   }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildSimplifiedRenderer(
+    const Material* /* skin */, const float cellSize) const override
+  {
+    return simplifyMesh(m_vertices, m_indices, cellSize);
+  }
+};
+
+// EntityModelDeferredMesh
+
+/**
+ * A model frame mesh that is decoded when it is first rendered or intersected.
+ *
+ * Mesh is the type of the decoded mesh and Indices is the type of its vertex indices.
+ */
+template <typename Mesh, typename Indices>
+class EntityModelDeferredMesh : public EntityModelMesh
+{
+private:
+  using MeshLoader = std::function<std::vector<EntityModelVertex>(Indices&)>;
+
+  mutable MeshLoader m_loadMesh;
+  mutable std::unique_ptr<Mesh> m_mesh;
+
+  kdl_reflect_inline_empty(EntityModelDeferredMesh);
+
+public:
+  /**
+   * Creates a new frame mesh that is decoded by the given function.
+   *
+   * @param loadMesh the function that decodes the mesh
+   */
+  explicit EntityModelDeferredMesh(MeshLoader loadMesh)
+    : EntityModelMesh{{}}
+    , m_loadMesh{std::move(loadMesh)}
+  {
+  }
+
+  size_t memorySize() const override { return m_mesh ? m_mesh->memorySize() : 0; }
+
+  void forEachPrimitive(const PrimitiveVisitor& visitor) const override
+  {
+    mesh().forEachPrimitive(visitor);
+  }
+
+private:
+  const Mesh& mesh() const
+  {
+    if (!m_mesh)
+    {
+      auto indices = Indices{};
+      auto vertices = m_loadMesh(indices);
+      m_mesh = std::make_unique<Mesh>(std::move(vertices), std::move(indices));
+
+      // release the data captured by the loader
+      m_loadMesh = nullptr;
+    }
+    return *m_mesh;
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
+    const Material* skin, const render::VertexArray& /* vertices */) const override
+  {
+    return mesh().buildRenderer(skin);
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildSimplifiedRenderer(
+    const Material* skin, const float cellSize) const override
+  {
+    return mesh().buildSimplifiedRenderer(skin, cellSize);
+  }
 };
 
 } // namespace
 
+// the meshes must be complete to build the spacial tree of a frame
+void EntityModelFrame::buildSpacialTree() const
+{
+  if (m_pendingMeshes.empty())
+  {
+    return;
+  }
+
+  for (const auto* mesh : m_pendingMeshes)
+  {
+    mesh->forEachPrimitive([&](
+                             const std::vector<EntityModelVertex>& vertices,
+                             const render::PrimType primType,
+                             const size_t index,
+                             const size_t count) {
+      addTriangles(vertices, primType, index, count);
+    });
+  }
+  m_pendingMeshes.clear();
+
+  // the hierarchy cannot be extended, so it is rebuilt over all triangles if a mesh was
+  // added after the frame was first intersected
+  auto triangles = std::vector<std::pair<vm::bbox3f, TriNum>>{};
+  triangles.reserve(m_tris.size() / 3u);
+  for (size_t triNum = 0; triNum < m_tris.size() / 3u; ++triNum)
+  {
+    auto bounds = vm::bbox3f::builder{};
+    bounds.add(m_tris[triNum * 3 + 0]);
+    bounds.add(m_tris[triNum * 3 + 1]);
+    bounds.add(m_tris[triNum * 3 + 2]);
+    triangles.emplace_back(bounds.bounds(), triNum);
+  }
+  m_spacialTree = SpacialTree{std::move(triangles)};
+}
+
 // EntityModelSurface
 
 kdl_reflect_impl(EntityModelSurface);
@@ -416,8 +675,9 @@ void EntityModelSurface::addMesh(
   render::IndexRangeMap indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(
-    frame, std::move(vertices), std::move(indices));
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelIndexedMesh>(std::move(vertices), std::move(indices));
+  frame.addMesh(*m_meshes[frame.index()]);
 }
 
 void EntityModelSurface::addMesh(
@@ -426,8 +686,29 @@ void EntityModelSurface::addMesh(
   render::MaterialIndexRangeMap indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelMaterialMesh>(
-    frame, std::move(vertices), std::move(indices));
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelMaterialMesh>(std::move(vertices), std::move(indices));
+  frame.addMesh(*m_meshes[frame.index()]);
+}
+
+void EntityModelSurface::addDeferredMesh(
+  EntityModelFrame& frame, EntityModelMeshLoader loadMesh)
+{
+  assert(frame.index() < frameCount());
+  m_meshes[frame.index()] = std::make_unique<
+    EntityModelDeferredMesh<EntityModelIndexedMesh, render::IndexRangeMap>>(
+    std::move(loadMesh));
+  frame.addMesh(*m_meshes[frame.index()]);
+}
+
+void EntityModelSurface::addDeferredMaterialMesh(
+  EntityModelFrame& frame, EntityModelMaterialMeshLoader loadMesh)
+{
+  assert(frame.index() < frameCount());
+  m_meshes[frame.index()] = std::make_unique<
+    EntityModelDeferredMesh<EntityModelMaterialMesh, render::MaterialIndexRangeMap>>(
+    std::move(loadMesh));
+  frame.addMesh(*m_meshes[frame.index()]);
 }
 
 void EntityModelSurface::setSkins(std::vector<Material> skins)
@@ -440,6 +721,26 @@ size_t EntityModelSurface::frameCount() const
   return m_meshes.size();
 }
 
+size_t EntityModelSurface::memorySize() const
+{
+  auto result = size_t(0);
+  for (const auto& mesh : m_meshes)
+  {
+    if (mesh)
+    {
+      result += mesh->memorySize();
+    }
+  }
+  for (const auto& material : m_skins->materials())
+  {
+    if (const auto* texture = material.texture())
+    {
+      result += texture->width() * texture->height() * 4;
+    }
+  }
+  return result;
+}
+
 size_t EntityModelSurface::skinCount() const
 {
   return m_skins->materialCount();
@@ -465,6 +766,18 @@ std::unique_ptr<render::MaterialIndexRangeRenderer> EntityModelSurface::buildRen
                               : nullptr;
 }
 
+std::unique_ptr<render::MaterialIndexRangeRenderer> EntityModelSurface::
+  buildSimplifiedRenderer(
+    const size_t skinIndex, const size_t frameIndex, const float cellSize) const
+{
+  assert(frameIndex < frameCount());
+  assert(skinIndex < skinCount());
+
+  return m_meshes[frameIndex]
+           ? m_meshes[frameIndex]->buildSimplifiedRenderer(skin(skinIndex), cellSize)
+           : nullptr;
+}
+
 // EntityModelData
 
 kdl_reflect_impl(EntityModelData);
@@ -487,6 +800,28 @@ Orientation EntityModelData::orientation() const
 
 std::unique_ptr<render::MaterialRenderer> EntityModelData::buildRenderer(
   const size_t skinIndex, const size_t frameIndex) const
+{
+  return doBuildRenderer(skinIndex, frameIndex, std::nullopt);
+}
+
+std::unique_ptr<render::MaterialRenderer> EntityModelData::buildSimplifiedRenderer(
+  const size_t skinIndex, const size_t frameIndex, const size_t resolution) const
+{
+  assert(resolution > 0);
+
+  if (frameIndex >= frameCount())
+  {
+    return nullptr;
+  }
+
+  const auto size = vm::get_abs_max_component(bounds(frameIndex).size());
+  return doBuildRenderer(skinIndex, frameIndex, size / float(resolution));
+}
+
+std::unique_ptr<render::MaterialRenderer> EntityModelData::doBuildRenderer(
+  const size_t skinIndex,
+  const size_t frameIndex,
+  const std::optional<float> simplifyCellSize) const
 {
   auto renderers = std::vector<std::unique_ptr<render::MaterialIndexRangeRenderer>>{};
   if (frameIndex >= frameCount())
@@ -496,16 +831,35 @@ std::unique_ptr<render::MaterialRenderer> EntityModelData::buildRenderer(
 
   const auto& frame = this->frame(frameIndex);
   const auto actualSkinIndex = skinIndex + frame->skinOffset();
+  auto simplified = false;
   for (auto& surface : m_surfaces)
   {
     // If an out of range skin is requested, use the first skin as a fallback
     const auto correctedSkinIndex =
       actualSkinIndex < surface.skinCount() ? actualSkinIndex : 0;
-    if (auto renderer = surface.buildRenderer(correctedSkinIndex, frameIndex))
+
+    // surfaces that cannot be simplified are rendered in full detail
+    auto renderer =
+      simplifyCellSize ? surface.buildSimplifiedRenderer(
+                           correctedSkinIndex, frameIndex, *simplifyCellSize)
+                       : nullptr;
+    simplified = simplified || renderer;
+    if (!renderer)
+    {
+      renderer = surface.buildRenderer(correctedSkinIndex, frameIndex);
+    }
+
+    if (renderer)
     {
       renderers.push_back(std::move(renderer));
     }
   }
+
+  if (simplifyCellSize && !simplified)
+  {
+    return nullptr;
+  }
+
   return !renderers.empty() ? std::make_unique<render::MultiMaterialIndexRangeRenderer>(
                                 std::move(renderers))
                             : nullptr;
@@ -552,6 +906,16 @@ size_t EntityModelData::surfaceCount() const
   return m_surfaces.size();
 }
 
+size_t EntityModelData::memorySize() const
+{
+  auto result = size_t(0);
+  for (const auto& surface : m_surfaces)
+  {
+    result += surface.memorySize();
+  }
+  return result;
+}
+
 const std::vector<EntityModelFrame>& EntityModelData::frames() const
 {
   return m_frames;
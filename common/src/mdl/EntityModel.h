@@ -19,25 +19,20 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "bvh.h"
 #include "mdl/EntityModelDataResource.h"
 #include "mdl/EntityModel_Forward.h"
-#include "octree.h"
 
 #include "kdl/reflection_decl.h"
 
 #include "vm/bbox.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
-namespace tb
-{
-template <typename T, typename U>
-class octree;
-}
-
 namespace tb::render
 {
 enum class PrimType;
@@ -49,6 +44,7 @@ class MaterialRenderer;
 
 namespace tb::mdl
 {
+class EntityModelMesh;
 class Material;
 class MaterialCollection;
 
@@ -94,11 +90,12 @@ private:
   vm::bbox3f m_bounds;
   size_t m_skinOffset = 0;
 
-  // For hit testing
-  std::vector<vm::vec3f> m_tris;
+  // For hit testing, the spacial tree is built when this frame is first intersected
+  mutable std::vector<const EntityModelMesh*> m_pendingMeshes;
+  mutable std::vector<vm::vec3f> m_tris;
   using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  SpacialTree m_spacialTree;
+  using SpacialTree = bvh<float, TriNum>;
+  mutable SpacialTree m_spacialTree;
 
   kdl_reflect_decl(EntityModelFrame, m_index, m_name, m_bounds, m_skinOffset);
 
@@ -151,22 +148,35 @@ public:
   std::optional<float> intersect(const vm::ray3f& ray) const;
 
   /**
-   * Adds the given primitives to the spacial tree for this frame.
+   * Adds the given mesh to this frame. Its primitives are added to the spacial tree for
+   * this frame when the frame is first intersected.
    *
-   * @param vertices the vertices
-   * @param primType the primitive type
-   * @param index the index of the first primitive's first vertex in the given vertex
-   * array
-   * @param count the number of vertices that make up the primitive(s)
+   * @param mesh the mesh, must outlive this frame
    */
-  void addToSpacialTree(
+  void addMesh(const EntityModelMesh& mesh);
+
+private:
+  void buildSpacialTree() const;
+  void addTriangles(
     const std::vector<EntityModelVertex>& vertices,
     render::PrimType primType,
     size_t index,
-    size_t count);
+    size_t count) const;
 };
 
-class EntityModelMesh;
+/**
+ * Decodes the vertices and the vertex indices of a deferred mesh. The indices are
+ * returned in the given index range map.
+ */
+using EntityModelMeshLoader =
+  std::function<std::vector<EntityModelVertex>(render::IndexRangeMap&)>;
+
+/**
+ * Decodes the vertices and the per material vertex indices of a deferred mesh. The
+ * indices are returned in the given material index range map.
+ */
+using EntityModelMaterialMeshLoader =
+  std::function<std::vector<EntityModelVertex>(render::MaterialIndexRangeMap&)>;
 
 /**
  * A model surface represents an individual part of a model. MDL and MD2 models use only
@@ -239,6 +249,26 @@ public:
     std::vector<EntityModelVertex> vertices,
     render::MaterialIndexRangeMap indices);
 
+  /**
+   * Adds a mesh to this surface that is decoded by the given function when it is first
+   * rendered or intersected. Loaders use this for the frames of animated models, most of
+   * which are never displayed.
+   *
+   * @param frame the frame which the mesh belongs to
+   * @param loadMesh the function that decodes the mesh
+   */
+  void addDeferredMesh(EntityModelFrame& frame, EntityModelMeshLoader loadMesh);
+
+  /**
+   * Adds a material mesh to this surface that is decoded by the given function when it
+   * is first rendered or intersected.
+   *
+   * @param frame the frame which the mesh belongs to
+   * @param loadMesh the function that decodes the mesh
+   */
+  void addDeferredMaterialMesh(
+    EntityModelFrame& frame, EntityModelMaterialMeshLoader loadMesh);
+
   /**
    * Sets the given materials as skins to this surface.
    *
@@ -254,6 +284,12 @@ public:
    */
   size_t frameCount() const;
 
+  /**
+   * Returns an estimate of the number of bytes used by the meshes and skins of this
+   * surface.
+   */
+  size_t memorySize() const;
+
   /**
    * Returns the number of skins of this surface.
    *
@@ -279,6 +315,17 @@ public:
 
   std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex) const;
+
+  /**
+   * Creates a renderer for a simplified version of the mesh of the given frame, or
+   * returns null if the mesh cannot be simplified enough.
+   *
+   * @param skinIndex the index of the skin to use
+   * @param frameIndex the index of the frame to render
+   * @param cellSize the size of the grid cells whose vertices are merged
+   */
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildSimplifiedRenderer(
+    size_t skinIndex, size_t frameIndex, float cellSize) const;
 };
 
 /**
@@ -323,6 +370,19 @@ public:
   std::unique_ptr<render::MaterialRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex) const;
 
+  /**
+   * Creates a renderer to render a simplified version of the given frame of the model
+   * using the skin with the given index. The frame is simplified by merging its vertices
+   * on a grid with the given number of cells along the longest side of its bounds.
+   *
+   * @param skinIndex the index of the skin to use
+   * @param frameIndex the index of the frame to render
+   * @param resolution the number of grid cells along the longest side of the frame
+   * @return the renderer, or null if the frame cannot be simplified enough
+   */
+  std::unique_ptr<render::MaterialRenderer> buildSimplifiedRenderer(
+    size_t skinIndex, size_t frameIndex, size_t resolution) const;
+
   /**
    * Returns the bounds of the given frame of this model.
    *
@@ -373,6 +433,11 @@ public:
    */
   size_t surfaceCount() const;
 
+  /**
+   * Returns an estimate of the number of bytes used by the surfaces of this model.
+   */
+  size_t memorySize() const;
+
   /**
    * Returns all frames of this model.
    *
@@ -435,6 +500,10 @@ public:
    * @return the surface with the given name or null if no such surface was found
    */
   const EntityModelSurface* surface(const std::string& name) const;
+
+private:
+  std::unique_ptr<render::MaterialRenderer> doBuildRenderer(
+    size_t skinIndex, size_t frameIndex, std::optional<float> simplifyCellSize) const;
 };
 
 class EntityModel
@@ -22,6 +22,8 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
+#include "MemoryReport.h"
+#include "Trace.h"
 #include "io/LoadEntityModel.h"
 #include "io/LoadMaterialCollections.h"
 #include "io/LoadShaders.h"
@@ -32,15 +34,45 @@
 #include "mdl/Resource.h"
 #include "render/MaterialIndexRangeRenderer.h"
 
+#include "kdl/map_utils.h"
 #include "kdl/ranges/to.h"
 #include "kdl/result.h"
 
+#include <algorithm>
+#include <chrono>
+
 namespace tb::mdl
 {
+namespace
+{
+
+using namespace std::chrono_literals;
+
+/**
+ * The time to spend on uploading entity model renderers per call to prepare.
+ */
+constexpr auto PrepareRenderersTimeout = 4ms;
+
+/**
+ * The default number of bytes that loaded models may use before unused models are
+ * evicted.
+ */
+constexpr auto DefaultMemoryBudget = size_t(256) * 1024 * 1024;
+
+/**
+ * The number of grid cells along the longest side of a model that its vertices are
+ * merged on for each simplified level of detail.
+ */
+constexpr auto ReducedDetailResolution = size_t(16);
+constexpr auto MinimalDetailResolution = size_t(2);
+
+} // namespace
+
 EntityModelManager::EntityModelManager(
   CreateEntityModelDataResource createResource, Logger& logger)
   : m_createResource{std::move(createResource)}
   , m_logger{logger}
+  , m_memoryBudget{DefaultMemoryBudget}
 {
 }
 
@@ -52,11 +84,15 @@ EntityModelManager::~EntityModelManager()
 void EntityModelManager::clear()
 {
   m_renderers.clear();
+  m_simplifiedRenderers.clear();
   m_models.clear();
   m_rendererMismatches.clear();
 
   m_unpreparedRenderers.clear();
 
+  m_recentModels.clear();
+  m_recentModelIndex.clear();
+
   // Remove logging because it might fail when the document is already destroyed.
 }
 
@@ -77,11 +113,19 @@ void EntityModelManager::reloadShaders(kdl::task_manager& taskManager)
 
 void EntityModelManager::setGame(const Game* game, kdl::task_manager& taskManager)
 {
+  TB_TRACE_SCOPE("EntityModelManager::setGame");
+
   clear();
   m_game = game;
   reloadShaders(taskManager);
 }
 
+void EntityModelManager::setAssimpModelCache(
+  std::shared_ptr<const io::AssimpModelCache> assimpModelCache)
+{
+  m_assimpModelCache = std::move(assimpModelCache);
+}
+
 render::MaterialRenderer* EntityModelManager::renderer(
   const ModelSpecification& spec) const
 {
@@ -106,6 +150,22 @@ render::MaterialRenderer* EntityModelManager::renderer(
 
           auto* result = pos->second.get();
           m_unpreparedRenderers.push_back(result);
+
+          auto simplifiedRenderers = SimplifiedRenderers{
+            entityModelData->buildSimplifiedRenderer(
+              spec.skinIndex, spec.frameIndex, ReducedDetailResolution),
+            entityModelData->buildSimplifiedRenderer(
+              spec.skinIndex, spec.frameIndex, MinimalDetailResolution)};
+          for (auto* simplifiedRenderer :
+               {simplifiedRenderers.reduced.get(), simplifiedRenderers.minimal.get()})
+          {
+            if (simplifiedRenderer)
+            {
+              m_unpreparedRenderers.push_back(simplifiedRenderer);
+            }
+          }
+          m_simplifiedRenderers.emplace(spec, std::move(simplifiedRenderers));
+
           m_logger.debug() << "Constructed entity model renderer for " << spec;
           return result;
         }
@@ -120,6 +180,29 @@ render::MaterialRenderer* EntityModelManager::renderer(
   return nullptr;
 }
 
+render::MaterialRenderer* EntityModelManager::renderer(
+  const ModelSpecification& spec, const EntityModelDetail detail) const
+{
+  auto* fullRenderer = renderer(spec);
+  if (!fullRenderer || detail == EntityModelDetail::Full)
+  {
+    return fullRenderer;
+  }
+
+  const auto it = m_simplifiedRenderers.find(spec);
+  if (it == m_simplifiedRenderers.end())
+  {
+    return fullRenderer;
+  }
+
+  const auto& [reduced, minimal] = it->second;
+  if (detail == EntityModelDetail::Minimal && minimal)
+  {
+    return minimal.get();
+  }
+  return reduced ? reduced.get() : fullRenderer;
+}
+
 const EntityModelFrame* EntityModelManager::frame(const ModelSpecification& spec) const
 {
   if (auto* model = this->safeGetModel(spec.path))
@@ -140,6 +223,14 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
     auto it = m_models.find(path);
     if (it != std::end(m_models))
     {
+      const auto& dataResource = it->second.dataResource();
+      if (!dataResource.isLoadRequested())
+      {
+        // the model was evicted
+        dataResource.requestLoading();
+      }
+
+      touchModel(path);
       return &it->second;
     }
 
@@ -148,6 +239,8 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
              assert(success);
              unused(success);
 
+             touchModel(path);
+
              m_logger.debug() << "Loading entity model " << path;
              return &(pos->second);
            })
@@ -161,6 +254,25 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
   return nullptr;
 }
 
+std::vector<std::filesystem::path> EntityModelManager::modelPaths() const
+{
+  return kdl::map_keys(m_models);
+}
+
+void EntityModelManager::removeModels(const std::vector<std::filesystem::path>& paths)
+{
+  for (const auto& path : paths)
+  {
+    m_models.erase(path);
+    if (const auto it = m_recentModelIndex.find(path); it != m_recentModelIndex.end())
+    {
+      m_recentModels.erase(it->second);
+      m_recentModelIndex.erase(it);
+    }
+    removeRenderers(path);
+  }
+}
+
 const std::vector<const EntityModel*> EntityModelManager::
   findEntityModelsByTextureResourceId(const std::vector<ResourceId>& resourceIds) const
 {
@@ -178,6 +290,96 @@ const std::vector<const EntityModel*> EntityModelManager::
          | views::transform(toPointer) | kdl::ranges::to<std::vector>();
 }
 
+void EntityModelManager::setMemoryBudget(const size_t memoryBudget)
+{
+  m_memoryBudget = memoryBudget;
+}
+
+size_t EntityModelManager::memorySize() const
+{
+  auto result = size_t(0);
+  for (const auto& [path, model] : m_models)
+  {
+    if (const auto* data = model.data())
+    {
+      result += data->memorySize();
+    }
+  }
+  return result;
+}
+
+bool EntityModelManager::exceedsMemoryBudget() const
+{
+  return memorySize() > m_memoryBudget;
+}
+
+void EntityModelManager::addToMemoryReport(MemoryReport& report) const
+{
+  auto modelCount = size_t(0);
+  for (const auto& [path, model] : m_models)
+  {
+    if (model.data())
+    {
+      ++modelCount;
+    }
+  }
+  report.add("Entity models", memorySize(), modelCount);
+
+  auto rendererBytes = size_t(0);
+  auto rendererCount = size_t(0);
+  const auto addRenderer = [&](const auto& renderer) {
+    if (renderer)
+    {
+      rendererBytes += renderer->sizeInBytes();
+      ++rendererCount;
+    }
+  };
+
+  for (const auto& [spec, renderer] : m_renderers)
+  {
+    addRenderer(renderer);
+  }
+  for (const auto& [spec, renderers] : m_simplifiedRenderers)
+  {
+    addRenderer(renderers.reduced);
+    addRenderer(renderers.minimal);
+  }
+  report.add("Entity model renderers", rendererBytes, rendererCount);
+}
+
+std::vector<ResourceId> EntityModelManager::evictModels(
+  const std::unordered_set<const EntityModel*>& usedModels)
+{
+  auto result = std::vector<ResourceId>{};
+
+  auto size = memorySize();
+  auto it = m_recentModels.end();
+  while (it != m_recentModels.begin() && size > m_memoryBudget)
+  {
+    --it;
+
+    const auto& path = *it;
+    const auto& model = m_models.at(path);
+    const auto* data = model.data();
+    if (!data || usedModels.contains(&model))
+    {
+      continue;
+    }
+
+    size -= data->memorySize();
+    removeRenderers(path);
+    model.dataResource().requestEviction();
+    result.push_back(model.dataResource().id());
+
+    m_logger.debug() << "Evicting entity model " << path;
+
+    m_recentModelIndex.erase(path);
+    it = m_recentModels.erase(it);
+  }
+
+  return result;
+}
+
 const EntityModel* EntityModelManager::safeGetModel(
   const std::filesystem::path& path) const
 {
@@ -211,22 +413,101 @@ Result<EntityModel> EntityModelManager::loadModel(
     };
 
     return io::loadEntityModelAsync(
-      fs, materialConfig, modelPath, loadMaterial, m_createResource, m_logger);
+      fs,
+      materialConfig,
+      modelPath,
+      loadMaterial,
+      m_createResource,
+      m_logger,
+      m_assimpModelCache);
   }
   return Error{"Game is not set"};
 }
 
+void EntityModelManager::touchModel(const std::filesystem::path& path) const
+{
+  if (const auto it = m_recentModelIndex.find(path); it != m_recentModelIndex.end())
+  {
+    m_recentModels.splice(m_recentModels.begin(), m_recentModels, it->second);
+  }
+  else
+  {
+    m_recentModels.push_front(path);
+    m_recentModelIndex.emplace(path, m_recentModels.begin());
+  }
+}
+
+void EntityModelManager::removeRenderers(const std::filesystem::path& path)
+{
+  const auto isRemoved = [&](const auto& spec) { return spec.path == path; };
+
+  std::erase_if(m_rendererMismatches, isRemoved);
+  for (auto it = m_simplifiedRenderers.begin(); it != m_simplifiedRenderers.end();)
+  {
+    if (isRemoved(it->first))
+    {
+      std::erase(m_unpreparedRenderers, it->second.reduced.get());
+      std::erase(m_unpreparedRenderers, it->second.minimal.get());
+      it = m_simplifiedRenderers.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  for (auto it = m_renderers.begin(); it != m_renderers.end();)
+  {
+    if (isRemoved(it->first))
+    {
+      std::erase(m_unpreparedRenderers, it->second.get());
+      it = m_renderers.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
 void EntityModelManager::prepare(render::VboManager& vboManager)
 {
   prepareRenderers(vboManager);
 }
 
+bool EntityModelManager::hasUnpreparedRenderers() const
+{
+  return !m_unpreparedRenderers.empty();
+}
+
+bool EntityModelManager::isPrepared(const render::MaterialRenderer& renderer) const
+{
+  return std::ranges::find(m_unpreparedRenderers, &renderer)
+         == m_unpreparedRenderers.end();
+}
+
+size_t EntityModelManager::preparedRendererCount() const
+{
+  return m_preparedRendererCount;
+}
+
 void EntityModelManager::prepareRenderers(render::VboManager& vboManager)
 {
-  for (auto* renderer : m_unpreparedRenderers)
+  const auto startTime = std::chrono::steady_clock::now();
+
+  // always prepare at least one renderer so that progress is made on slow machines
+  auto it = m_unpreparedRenderers.begin();
+  while (it != m_unpreparedRenderers.end())
   {
-    renderer->prepare(vboManager);
+    (*it)->prepare(vboManager);
+    ++it;
+
+    if (std::chrono::steady_clock::now() - startTime >= PrepareRenderersTimeout)
+    {
+      break;
+    }
   }
-  m_unpreparedRenderers.clear();
+
+  m_preparedRendererCount += size_t(std::distance(m_unpreparedRenderers.begin(), it));
+  m_unpreparedRenderers.erase(m_unpreparedRenderers.begin(), it);
 }
 } // namespace tb::mdl
@@ -26,6 +26,7 @@
 #include "kdl/path_hash.h"
 
 #include <filesystem>
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -39,6 +40,12 @@ class task_manager;
 namespace tb
 {
 class Logger;
+class MemoryReport;
+} // namespace tb
+
+namespace tb::io
+{
+class AssimpModelCache;
 }
 
 namespace tb::render
@@ -55,6 +62,21 @@ class Game;
 enum class Orientation;
 class Quake3Shader;
 
+/**
+ * The level of detail at which an entity model is rendered.
+ */
+enum class EntityModelDetail
+{
+  Full,
+  /** A simplified mesh for models that are far away. */
+  Reduced,
+  /**
+   * A mesh that only approximates the shape of a model, used as an impostor for models
+   * that are very far away.
+   */
+  Minimal,
+};
+
 class EntityModelManager
 {
 private:
@@ -62,6 +84,7 @@ private:
   Logger& m_logger;
 
   const Game* m_game = nullptr;
+  std::shared_ptr<const io::AssimpModelCache> m_assimpModelCache;
 
   // Cache Quake 3 shaders to use when loading models
   std::vector<Quake3Shader> m_shaders;
@@ -72,7 +95,26 @@ private:
       m_renderers;
   mutable std::unordered_set<ModelSpecification> m_rendererMismatches;
 
+  struct SimplifiedRenderers
+  {
+    std::unique_ptr<render::MaterialRenderer> reduced;
+    std::unique_ptr<render::MaterialRenderer> minimal;
+  };
+  mutable std::unordered_map<ModelSpecification, SimplifiedRenderers>
+    m_simplifiedRenderers;
+
   mutable std::vector<render::MaterialRenderer*> m_unpreparedRenderers;
+  size_t m_preparedRendererCount = 0;
+
+  size_t m_memoryBudget;
+
+  // recently used models, most recent first, used to evict unused models
+  mutable std::list<std::filesystem::path> m_recentModels;
+  mutable std::unordered_map<
+    std::filesystem::path,
+    std::list<std::filesystem::path>::iterator,
+    kdl::path_hash>
+    m_recentModelIndex;
 
 public:
   EntityModelManager(CreateEntityModelDataResource createResource, Logger& logger);
@@ -83,21 +125,94 @@ public:
 
   void setGame(const Game* game, kdl::task_manager& taskManager);
 
+  /**
+   * Sets the cache used to store models imported by Assimp between sessions. Pass
+   * nullptr to disable caching. Takes effect when models are loaded the next time.
+   */
+  void setAssimpModelCache(std::shared_ptr<const io::AssimpModelCache> assimpModelCache);
+
   render::MaterialRenderer* renderer(const ModelSpecification& spec) const;
 
+  /**
+   * Returns the renderer for the given level of detail of the given model. The simplified
+   * renderers are built together with the full renderer. If a model cannot be simplified
+   * enough, the renderer for the next higher level of detail is returned.
+   */
+  render::MaterialRenderer* renderer(
+    const ModelSpecification& spec, EntityModelDetail detail) const;
+
   const EntityModelFrame* frame(const ModelSpecification& spec) const;
   const EntityModel* model(const std::filesystem::path& path) const;
 
+  /**
+   * Returns the paths of the models that are currently loaded.
+   */
+  std::vector<std::filesystem::path> modelPaths() const;
+
+  /**
+   * Removes the models with the given paths and their renderers, so that the models are
+   * loaded again when they are requested the next time.
+   */
+  void removeModels(const std::vector<std::filesystem::path>& paths);
+
   const std::vector<const EntityModel*> findEntityModelsByTextureResourceId(
     const std::vector<ResourceId>& resourceIds) const;
 
+  /**
+   * Sets the number of bytes that the loaded models may use before unused models are
+   * evicted.
+   */
+  void setMemoryBudget(size_t memoryBudget);
+
+  /**
+   * Returns an estimate of the number of bytes used by the loaded models.
+   */
+  size_t memorySize() const;
+
+  bool exceedsMemoryBudget() const;
+
+  /**
+   * Adds the estimated memory usage of the loaded models and of their renderers to the
+   * given report.
+   */
+  void addToMemoryReport(MemoryReport& report) const;
+
+  /**
+   * Evicts the least recently used models that are not contained in the given set until
+   * the loaded models fit into the memory budget again. The data and renderers of an
+   * evicted model are dropped, but the model itself is kept, so that pointers to it
+   * remain valid. Its data is loaded again when the model is accessed the next time.
+   *
+   * Returns the IDs of the data resources of the evicted models.
+   */
+  std::vector<ResourceId> evictModels(
+    const std::unordered_set<const EntityModel*>& usedModels);
+
 private:
   const EntityModel* safeGetModel(const std::filesystem::path& path) const;
   Result<EntityModel> loadModel(const std::filesystem::path& path) const;
+  void touchModel(const std::filesystem::path& path) const;
+  void removeRenderers(const std::filesystem::path& path);
 
 public:
+  /**
+   * Uploads the renderers that were constructed since the last call. If many models
+   * finish loading at once, uploading stops after a few milliseconds so that the frame
+   * can still be rendered in time, and the remaining renderers are uploaded by
+   * subsequent calls.
+   */
   void prepare(render::VboManager& vboManager);
 
+  bool hasUnpreparedRenderers() const;
+  bool isPrepared(const render::MaterialRenderer& renderer) const;
+
+  /**
+   * Returns the number of renderers that were prepared so far. Callers can compare this
+   * to a previously returned value to find out whether any renderers were prepared in
+   * between.
+   */
+  size_t preparedRendererCount() const;
+
 private:
   void prepareRenderers(render::VboManager& vboManager);
 };
@@ -48,7 +48,7 @@ const HitType::Type EntityNode::EntityHitType = HitType::freeType();
 const vm::bbox3d EntityNode::DefaultBounds = vm::bbox3d{8.0};
 
 EntityNode::EntityNode(Entity entity)
-  : EntityNodeBase{std::move(entity)}
+  : EntityNodeBase{Kind, std::move(entity)}
 {
 }
 
@@ -143,12 +143,6 @@ void EntityNode::doNodePhysicalBoundsDidChange()
   invalidateBounds();
 }
 
-void EntityNode::doChildPhysicalBoundsDidChange()
-{
-  invalidateBounds();
-  nodePhysicalBoundsDidChange();
-}
-
 bool EntityNode::doSelectable() const
 {
   return !hasChildren();
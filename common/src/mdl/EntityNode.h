@@ -40,6 +40,7 @@ struct EntityPropertyConfig;
 class EntityNode : public EntityNodeBase, public Object
 {
 public:
+  static constexpr auto Kind = NodeKind::Entity;
   static const HitType::Type EntityHitType;
   static const vm::bbox3d DefaultBounds;
 
@@ -77,7 +78,6 @@ private: // implement Node interface
   void doChildWasRemoved(Node* node) override;
 
   void doNodePhysicalBoundsDidChange() override;
-  void doChildPhysicalBoundsDidChange() override;
 
   bool doSelectable() const override;
 
@@ -88,8 +88,9 @@ std::string selectPropertyValue(
   return value ? *value : "";
 }
 
-EntityNodeBase::EntityNodeBase(Entity entity)
-  : m_entity{std::move(entity)}
+EntityNodeBase::EntityNodeBase(const NodeKind kind, Entity entity)
+  : Node{kind}
+  , m_entity{std::move(entity)}
 {
 }
 
@@ -337,6 +338,7 @@ std::vector<std::string> EntityNodeBase::findMissingKillTargets() const
 void EntityNodeBase::findMissingTargets(
   const std::string& prefix, std::vector<std::string>& result) const
 {
+  auto linkTargets = std::vector<EntityNodeBase*>{};
   for (const auto& property : m_entity.numberedProperties(prefix))
   {
     const auto& targetname = property.value();
@@ -346,7 +348,7 @@ void EntityNodeBase::findMissingTargets(
     }
     else
     {
-      auto linkTargets = std::vector<EntityNodeBase*>{};
+      linkTargets.clear();
       findEntityNodesWithProperty(
         EntityPropertyKeys::Targetname, targetname, linkTargets);
       if (linkTargets.empty())
@@ -490,12 +492,13 @@ void EntityNodeBase::addAllLinkSources(const std::string& targetname)
 
 void EntityNodeBase::addAllLinkTargets()
 {
+  auto linkTargets = std::vector<EntityNodeBase*>{};
   for (const auto& property : m_entity.numberedProperties(EntityPropertyKeys::Target))
   {
     const auto& targetname = property.value();
     if (!targetname.empty())
     {
-      auto linkTargets = std::vector<EntityNodeBase*>{};
+      linkTargets.clear();
       findEntityNodesWithProperty(
         EntityPropertyKeys::Targetname, targetname, linkTargets);
       addLinkTargets(linkTargets);
@@ -516,12 +519,13 @@ void EntityNodeBase::addAllKillSources(const std::string& targetname)
 
 void EntityNodeBase::addAllKillTargets()
 {
+  auto killTargets = std::vector<EntityNodeBase*>{};
   for (const auto& property : m_entity.numberedProperties(EntityPropertyKeys::Killtarget))
   {
     const std::string& targetname = property.value();
     if (!targetname.empty())
     {
-      auto killTargets = std::vector<EntityNodeBase*>{};
+      killTargets.clear();
       findEntityNodesWithProperty(
         EntityPropertyKeys::Targetname, targetname, killTargets);
       addKillTargets(killTargets);
@@ -695,7 +699,10 @@ void EntityNodeBase::removeKillSource(EntityNodeBase* node)
   invalidateIssues();
 }
 
-EntityNodeBase::EntityNodeBase() = default;
+EntityNodeBase::EntityNodeBase(const NodeKind kind)
+  : Node{kind}
+{
+}
 
 const std::string& EntityNodeBase::doGetName() const
 {
@@ -43,7 +43,7 @@ std::string selectPropertyValue(
 class EntityNodeBase : public Node
 {
 protected:
-  explicit EntityNodeBase(Entity entity);
+  EntityNodeBase(NodeKind kind, Entity entity);
 
   Entity m_entity;
 
@@ -159,7 +159,7 @@ private: // link management internals
   void removeKillTarget(EntityNodeBase* node);
 
 protected:
-  EntityNodeBase();
+  explicit EntityNodeBase(NodeKind kind);
 
 private: // implemenation of node interface
   const std::string& doGetName() const override;
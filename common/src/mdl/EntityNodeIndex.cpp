@@ -25,15 +25,34 @@
 #include "mdl/EntityProperties.h"
 
 #include "kdl/compact_trie.h"
-#include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <iterator>
-#include <list>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
 {
+namespace
+{
+
+std::string_view stripNumberedSuffix(const std::string_view key)
+{
+  const auto last = key.find_last_not_of("0123456789");
+  return last == std::string_view::npos ? std::string_view{} : key.substr(0, last + 1);
+}
+
+void sortAndRemoveDuplicates(
+  std::vector<EntityNodeBase*>& nodes, const std::vector<EntityNodeBase*>::size_type first)
+{
+  const auto begin = std::next(nodes.begin(), std::ptrdiff_t(first));
+  std::sort(begin, nodes.end());
+  nodes.erase(std::unique(begin, nodes.end()), nodes.end());
+}
+
+} // namespace
 
 EntityNodeIndexQuery EntityNodeIndexQuery::exact(std::string pattern)
 {
@@ -55,26 +74,14 @@ EntityNodeIndexQuery EntityNodeIndexQuery::any()
   return EntityNodeIndexQuery{Type::Any};
 }
 
-std::set<EntityNodeBase*> EntityNodeIndexQuery::execute(
-  const EntityNodeStringIndex& index) const
+EntityNodeIndexQuery::Type EntityNodeIndexQuery::type() const
 {
-  auto result = std::set<EntityNodeBase*>{};
-  switch (m_type)
-  {
-  case Type::Exact:
-    index.find_matches(m_pattern, std::inserter(result, std::end(result)));
-    break;
-  case Type::Prefix:
-    index.find_matches(m_pattern + "*", std::inserter(result, std::end(result)));
-    break;
-  case Type::Numbered:
-    index.find_matches(m_pattern + "%*", std::inserter(result, std::end(result)));
-    break;
-  case Type::Any:
-    break;
-    switchDefault();
-  }
-  return result;
+  return m_type;
+}
+
+const std::string& EntityNodeIndexQuery::pattern() const
+{
+  return m_pattern;
 }
 
 bool EntityNodeIndexQuery::execute(
@@ -121,6 +128,7 @@ EntityNodeIndexQuery::EntityNodeIndexQuery(const Type type, std::string pattern)
 EntityNodeIndex::EntityNodeIndex()
   : m_keyIndex{std::make_unique<EntityNodeStringIndex>()}
   , m_valueIndex{std::make_unique<EntityNodeStringIndex>()}
+  , m_numberedKeyIndex{std::make_unique<EntityNodeStringIndex>()}
 {
 }
 
@@ -128,10 +136,25 @@ EntityNodeIndex::~EntityNodeIndex() = default;
 
 void EntityNodeIndex::addEntityNode(EntityNodeBase* node)
 {
-  for (const auto& property : node->entity().properties())
+  const auto& properties = node->entity().properties();
+
+  auto keys = std::vector<std::pair<std::string_view, EntityNodeBase*>>{};
+  auto values = std::vector<std::pair<std::string_view, EntityNodeBase*>>{};
+  auto numberedKeys = std::vector<std::pair<std::string_view, EntityNodeBase*>>{};
+  keys.reserve(properties.size());
+  values.reserve(properties.size());
+  numberedKeys.reserve(properties.size());
+
+  for (const auto& property : properties)
   {
-    addProperty(node, property.key(), property.value());
+    keys.emplace_back(property.key(), node);
+    values.emplace_back(property.value(), node);
+    numberedKeys.emplace_back(stripNumberedSuffix(property.key()), node);
   }
+
+  m_keyIndex->insert(std::move(keys));
+  m_valueIndex->insert(std::move(values));
+  m_numberedKeyIndex->insert(std::move(numberedKeys));
 }
 
 void EntityNodeIndex::removeEntityNode(EntityNodeBase* node)
@@ -147,6 +170,7 @@ void EntityNodeIndex::addProperty(
 {
   m_keyIndex->insert(key, node);
   m_valueIndex->insert(value, node);
+  m_numberedKeyIndex->insert(stripNumberedSuffix(key), node);
 }
 
 void EntityNodeIndex::removeProperty(
@@ -154,22 +178,68 @@ void EntityNodeIndex::removeProperty(
 {
   m_keyIndex->remove(key, node);
   m_valueIndex->remove(value, node);
+  m_numberedKeyIndex->remove(stripNumberedSuffix(key), node);
 }
 
 std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
   const EntityNodeIndexQuery& keyQuery, const std::string& value) const
 {
-  // first, find Nodes which have `value` as the value for any key
   auto result = std::vector<EntityNodeBase*>{};
+  findEntityNodes(keyQuery, value, result);
+  return result;
+}
+
+void EntityNodeIndex::findEntityNodes(
+  const EntityNodeIndexQuery& keyQuery,
+  const std::string& value,
+  std::vector<EntityNodeBase*>& result) const
+{
+  // first, find Nodes which have `value` as the value for any key
+  const auto first = result.size();
   m_valueIndex->find_matches(value, std::back_inserter(result));
-  if (result.empty())
+  if (result.size() == first)
   {
-    return {};
+    return;
   }
 
-  result = kdl::vec_sort_and_remove_duplicates(std::move(result));
-  std::erase_if(result, [&](const auto* node) { return !keyQuery.execute(node, value); });
-  return result;
+  sortAndRemoveDuplicates(result, first);
+  result.erase(
+    std::remove_if(
+      std::next(result.begin(), std::ptrdiff_t(first)),
+      result.end(),
+      [&](const auto* node) { return !keyQuery.execute(node, value); }),
+    result.end());
+}
+
+void EntityNodeIndex::findEntityNodesWithKey(
+  const EntityNodeIndexQuery& keyQuery, std::vector<EntityNodeBase*>& result) const
+{
+  const auto first = result.size();
+  const auto& pattern = keyQuery.pattern();
+  switch (keyQuery.type())
+  {
+  case EntityNodeIndexQuery::Type::Exact:
+    m_keyIndex->find_matches(pattern, std::back_inserter(result));
+    break;
+  case EntityNodeIndexQuery::Type::Prefix:
+    m_keyIndex->find_matches(pattern + "*", std::back_inserter(result));
+    break;
+  case EntityNodeIndexQuery::Type::Numbered:
+    if (stripNumberedSuffix(pattern).size() == pattern.size())
+    {
+      m_numberedKeyIndex->find_matches(pattern, std::back_inserter(result));
+    }
+    else
+    {
+      // a pattern that ends with digits also matches keys with a shorter stripped key
+      m_keyIndex->find_matches(pattern + "%*", std::back_inserter(result));
+    }
+    break;
+  case EntityNodeIndexQuery::Type::Any:
+    break;
+    switchDefault();
+  }
+  sortAndRemoveDuplicates(result, first);
 }
 
 std::vector<std::string> EntityNodeIndex::allKeys() const
@@ -184,8 +254,9 @@ std::vector<std::string> EntityNodeIndex::allValuesForKeys(
 {
   auto result = std::vector<std::string>{};
 
-  const auto nameResult = keyQuery.execute(*m_keyIndex);
-  for (const auto node : nameResult)
+  auto nodes = std::vector<EntityNodeBase*>{};
+  findEntityNodesWithKey(keyQuery, nodes);
+  for (const auto* node : nodes)
   {
     const auto matchingProperties = keyQuery.execute(node);
     for (const auto& property : matchingProperties)
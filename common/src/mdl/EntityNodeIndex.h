@@ -22,7 +22,6 @@
 #include "kdl/compact_trie_forward.h"
 
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -54,7 +53,9 @@ public:
   static EntityNodeIndexQuery numbered(std::string pattern);
   static EntityNodeIndexQuery any();
 
-  std::set<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
+  Type type() const;
+  const std::string& pattern() const;
+
   bool execute(const EntityNodeBase* node, const std::string& value) const;
   std::vector<EntityProperty> execute(const EntityNodeBase* node) const;
 
@@ -68,6 +69,12 @@ private:
   std::unique_ptr<EntityNodeStringIndex> m_keyIndex;
   std::unique_ptr<EntityNodeStringIndex> m_valueIndex;
 
+  /**
+   * Indexes every node by its keys with any trailing digits removed, so that numbered
+   * queries can be answered by an exact lookup instead of a prefix scan.
+   */
+  std::unique_ptr<EntityNodeStringIndex> m_numberedKeyIndex;
+
 public:
   EntityNodeIndex();
   ~EntityNodeIndex();
@@ -82,6 +89,25 @@ public:
 
   std::vector<EntityNodeBase*> findEntityNodes(
     const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
+
+  /**
+   * Appends the nodes that have a property matching the given key query with the given
+   * value to the given vector. The appended nodes are sorted and contain no duplicates.
+   *
+   * This allows callers to reuse the vector across queries.
+   */
+  void findEntityNodes(
+    const EntityNodeIndexQuery& keyQuery,
+    const std::string& value,
+    std::vector<EntityNodeBase*>& result) const;
+
+  /**
+   * Appends the nodes that have a key matching the given key query to the given vector.
+   * The appended nodes are sorted and contain no duplicates.
+   */
+  void findEntityNodesWithKey(
+    const EntityNodeIndexQuery& keyQuery, std::vector<EntityNodeBase*>& result) const;
+
   std::vector<std::string> allKeys() const;
   std::vector<std::string> allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const;
 };
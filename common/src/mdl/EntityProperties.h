@@ -21,10 +21,12 @@
 
 #include "el/Expression.h"
 
+#include "kdl/interned_string.h"
 #include "kdl/reflection_decl.h"
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tb::mdl
@@ -94,15 +96,20 @@ struct EntityPropertyConfig
 
 bool isNumberedProperty(std::string_view prefix, std::string_view key);
 
+/**
+ * Keys and values are interned because the same keys and many values, such as class names
+ * or spawnflags, occur in many entities. This saves memory and makes comparing
+ * properties cheap.
+ */
 class EntityProperty
 {
 private:
-  std::string m_key;
-  std::string m_value;
+  kdl::interned_string m_key;
+  kdl::interned_string m_value;
 
 public:
   EntityProperty();
-  EntityProperty(std::string key, std::string value);
+  EntityProperty(std::string_view key, std::string_view value);
 
   kdl_reflect_decl(EntityProperty, m_key, m_value);
 
@@ -117,8 +124,8 @@ public:
   bool hasNumberedPrefix(std::string_view prefix) const;
   bool hasNumberedPrefixAndValue(std::string_view prefix, std::string_view value) const;
 
-  void setKey(std::string key);
-  void setValue(std::string value);
+  void setKey(std::string_view key);
+  void setValue(std::string_view value);
 };
 
 bool isLayer(const std::string& classname, const std::vector<EntityProperty>& properties);
@@ -65,7 +65,11 @@ public: // game configuration
   virtual std::filesystem::path gamePath() const = 0;
   virtual void setGamePath(const std::filesystem::path& gamePath, Logger& logger) = 0;
 
-  virtual void setAdditionalSearchPaths(
+  /**
+   * Sets the additional search paths, e.g. of the enabled mods. Returns the paths of the
+   * files whose contents may now be provided by a different file system.
+   */
+  virtual std::vector<std::filesystem::path> setAdditionalSearchPaths(
     const std::vector<std::filesystem::path>& searchPaths, Logger& logger) = 0;
 
   using PathErrors = std::map<std::filesystem::path, std::string>;
@@ -79,7 +83,11 @@ public: // game configuration
   virtual SoftMapBounds extractSoftMapBounds(const Entity& entity) const = 0;
 
 public: // material collection handling
-  virtual void reloadWads(
+  /**
+   * Mounts the given wad files in place of the currently mounted ones. Returns the paths
+   * of the files whose contents may now be provided by a different file system.
+   */
+  virtual std::vector<std::filesystem::path> reloadWads(
     const std::filesystem::path& documentPath,
     const std::vector<std::filesystem::path>& wadPaths,
     Logger& logger) = 0;
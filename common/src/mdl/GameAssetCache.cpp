@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GameAssetCache.h"
+
+#include "io/FileSystem.h"
+
+#include "kdl/result.h"
+
+#include <system_error>
+
+namespace tb::mdl
+{
+
+io::EntityDefinitionCache& GameAssetCache::entityDefinitionCache()
+{
+  return m_entityDefinitionCache;
+}
+
+Result<std::shared_ptr<io::FileSystem>> GameAssetCache::packageFileSystem(
+  const std::filesystem::path& path,
+  const std::function<Result<std::unique_ptr<io::FileSystem>>()>& createFileSystem)
+{
+  auto timeError = std::error_code{};
+  auto sizeError = std::error_code{};
+  const auto modificationTime = std::filesystem::last_write_time(path, timeError);
+  const auto size = std::filesystem::file_size(path, sizeError);
+  if (timeError || sizeError)
+  {
+    // let the caller report the error
+    return createFileSystem() | kdl::transform([](auto fileSystem) {
+             return std::shared_ptr<io::FileSystem>{std::move(fileSystem)};
+           });
+  }
+
+  const auto lock = std::lock_guard{m_mutex};
+
+  auto& cachedPackage = m_packages[path];
+  if (cachedPackage.modificationTime == modificationTime && cachedPackage.size == size)
+  {
+    if (auto fileSystem = cachedPackage.fileSystem.lock())
+    {
+      return fileSystem;
+    }
+  }
+
+  return createFileSystem() | kdl::transform([&](auto fileSystem) {
+           auto sharedFileSystem = std::shared_ptr<io::FileSystem>{std::move(fileSystem)};
+           cachedPackage = CachedPackage{modificationTime, size, sharedFileSystem};
+           return sharedFileSystem;
+         });
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "io/EntityDefinitionCache.h"
+
+#include "kdl/path_hash.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace tb::io
+{
+class FileSystem;
+}
+
+namespace tb::mdl
+{
+
+/**
+ * Keeps the assets that can be shared by all documents that use the same game, so that
+ * they are not loaded again for every open document. The game factory keeps one cache
+ * per game for as long as any game instance refers to it.
+ *
+ * All functions are thread safe.
+ */
+class GameAssetCache
+{
+private:
+  struct CachedPackage
+  {
+    std::filesystem::file_time_type modificationTime;
+    std::uintmax_t size = 0;
+    std::weak_ptr<io::FileSystem> fileSystem;
+  };
+
+  io::EntityDefinitionCache m_entityDefinitionCache;
+
+  std::mutex m_mutex;
+  std::unordered_map<std::filesystem::path, CachedPackage, kdl::path_hash> m_packages;
+
+public:
+  io::EntityDefinitionCache& entityDefinitionCache();
+
+  /**
+   * Returns the file system of the package file at the given path. If the package is
+   * still mounted by another document and the file has not changed since, its file
+   * system is shared. Otherwise, the given function is called to create it.
+   */
+  Result<std::shared_ptr<io::FileSystem>> packageFileSystem(
+    const std::filesystem::path& path,
+    const std::function<Result<std::unique_ptr<io::FileSystem>>()>& createFileSystem);
+};
+
+} // namespace tb::mdl
@@ -32,6 +32,7 @@
 #include "io/PathInfo.h"
 #include "io/TraversalMode.h"
 #include "mdl/Game.h"
+#include "mdl/GameAssetCache.h"
 #include "mdl/GameConfig.h"
 #include "mdl/GameImpl.h"
 
@@ -86,7 +87,7 @@ Result<std::vector<std::string>> GameFactory::initialize(
   const GamePathConfig& gamePathConfig)
 {
   return initializeFileSystem(gamePathConfig)
-         | kdl::and_then([&]() { return loadGameConfigs(gamePathConfig); });
+         | kdl::and_then([&]() { return loadGameConfigs(); });
 }
 
 void GameFactory::reset()
@@ -96,8 +97,10 @@ void GameFactory::reset()
 
   m_names.clear();
   m_configs.clear();
+  m_gamesWithProfiles.clear();
   m_gamePaths.clear();
   m_defaultEngines.clear();
+  m_assetCaches.clear();
 }
 
 void GameFactory::saveGameEngineConfig(
@@ -126,21 +129,35 @@ size_t GameFactory::gameCount() const
 
 std::unique_ptr<Game> GameFactory::createGame(const std::string& gameName, Logger& logger)
 {
-  return std::make_unique<GameImpl>(gameConfig(gameName), gamePath(gameName), logger);
+  auto assetCache = m_assetCaches[gameName].lock();
+  if (!assetCache)
+  {
+    assetCache = std::make_shared<GameAssetCache>();
+    m_assetCaches[gameName] = assetCache;
+  }
+
+  return std::make_unique<GameImpl>(
+    gameConfig(gameName), gamePath(gameName), logger, std::move(assetCache));
 }
 
 std::vector<std::string> GameFactory::fileFormats(const std::string& gameName) const
 {
   return kdl::vec_transform(
-    gameConfig(gameName).fileFormats, [](const auto& format) { return format.format; });
+    findGameConfig(gameName).fileFormats,
+    [](const auto& format) { return format.format; });
 }
 
 std::filesystem::path GameFactory::iconPath(const std::string& gameName) const
 {
-  const auto& config = gameConfig(gameName);
+  const auto& config = findGameConfig(gameName);
   return config.findConfigFile(config.icon);
 }
 
+bool GameFactory::experimental(const std::string& gameName) const
+{
+  return findGameConfig(gameName).experimental;
+}
+
 std::filesystem::path GameFactory::gamePath(const std::string& gameName) const
 {
   const auto it = m_gamePaths.find(gameName);
@@ -211,22 +228,16 @@ bool GameFactory::setCompilationToolPath(
 
 GameConfig& GameFactory::gameConfig(const std::string& name)
 {
-  const auto cIt = m_configs.find(name);
-  if (cIt == std::end(m_configs))
-  {
-    throw GameException{"Unknown game: " + name};
-  }
-  return cIt->second;
+  auto& config = findGameConfig(name);
+  loadProfiles(config);
+  return config;
 }
 
 const GameConfig& GameFactory::gameConfig(const std::string& name) const
 {
-  const auto cIt = m_configs.find(name);
-  if (cIt == std::end(m_configs))
-  {
-    throw GameException{"Unknown game: " + name};
-  }
-  return cIt->second;
+  auto& config = findGameConfig(name);
+  loadProfiles(config);
+  return config;
 }
 
 const std::filesystem::path& GameFactory::userGameConfigsPath() const
@@ -260,8 +271,7 @@ Result<void> GameFactory::initializeFileSystem(const GamePathConfig& gamePathCon
          });
 }
 
-Result<std::vector<std::string>> GameFactory::loadGameConfigs(
-  const GamePathConfig& gamePathConfig)
+Result<std::vector<std::string>> GameFactory::loadGameConfigs()
 {
   return m_configFs->find(
            {},
@@ -270,7 +280,7 @@ Result<std::vector<std::string>> GameFactory::loadGameConfigs(
          | kdl::transform([&](auto configFiles) {
              auto errors = std::vector<std::string>{};
              kdl::vec_transform(configFiles, [&](const auto& configFilePath) {
-               return loadGameConfig(gamePathConfig, configFilePath)
+               return loadGameConfig(configFilePath)
                       | kdl::transform_error([&](auto e) {
                           errors.push_back(fmt::format(
                             "Failed to load game configuration file {}: {}",
@@ -282,8 +292,7 @@ Result<std::vector<std::string>> GameFactory::loadGameConfigs(
            });
 }
 
-Result<void> GameFactory::loadGameConfig(
-  const GamePathConfig& gamePathConfig, const std::filesystem::path& path)
+Result<void> GameFactory::loadGameConfig(const std::filesystem::path& path)
 {
   return m_configFs->openFile(path).join(m_configFs->makeAbsolute(path))
          | kdl::and_then([&](auto configFile, auto absolutePath) {
@@ -292,14 +301,6 @@ Result<void> GameFactory::loadGameConfig(
              return parser.parse();
            })
          | kdl::transform([&](auto config) {
-             migrateConfigFiles(gamePathConfig.userGameDir, config)
-               | kdl::transform_error([&](auto e) {
-                   std::cerr << "Could not migrate user config files: '" << e.msg << "\n";
-                 });
-
-             loadCompilationConfig(config);
-             loadGameEngineConfig(config);
-
              const auto configName = config.name;
              m_configs.emplace(configName, std::move(config));
              kdl::wrap_set(m_names).insert(configName);
@@ -316,7 +317,32 @@ Result<void> GameFactory::loadGameConfig(
            });
 }
 
-void GameFactory::loadCompilationConfig(GameConfig& gameConfig)
+GameConfig& GameFactory::findGameConfig(const std::string& name) const
+{
+  const auto cIt = m_configs.find(name);
+  if (cIt == std::end(m_configs))
+  {
+    throw GameException{"Unknown game: " + name};
+  }
+  return cIt->second;
+}
+
+void GameFactory::loadProfiles(GameConfig& gameConfig) const
+{
+  if (!m_gamesWithProfiles.insert(gameConfig.name).second)
+  {
+    return;
+  }
+
+  migrateConfigFiles(m_userGameDir, gameConfig) | kdl::transform_error([&](auto e) {
+    std::cerr << "Could not migrate user config files: '" << e.msg << "\n";
+  });
+
+  loadCompilationConfig(gameConfig);
+  loadGameEngineConfig(gameConfig);
+}
+
+void GameFactory::loadCompilationConfig(GameConfig& gameConfig) const
 {
   const auto path = gameConfig.configFileFolder() / "CompilationProfiles.cfg";
   if (m_configFs->pathInfo(path) == io::PathInfo::File)
@@ -336,7 +362,7 @@ void GameFactory::loadCompilationConfig(GameConfig& gameConfig)
   }
 }
 
-void GameFactory::loadGameEngineConfig(GameConfig& gameConfig)
+void GameFactory::loadGameEngineConfig(GameConfig& gameConfig) const
 {
   const auto path = gameConfig.configFileFolder() / "GameEngineProfiles.cfg";
   if (m_configFs->pathInfo(path) == io::PathInfo::File)
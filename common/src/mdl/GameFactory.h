@@ -25,6 +25,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,7 @@ class WritableVirtualFileSystem;
 namespace tb::mdl
 {
 struct CompilationConfig;
+class GameAssetCache;
 struct GameConfig;
 struct GameEngineConfig;
 
@@ -64,10 +66,17 @@ private:
   std::unique_ptr<io::WritableVirtualFileSystem> m_configFs;
 
   std::vector<std::string> m_names;
-  ConfigMap m_configs;
+
+  // the compilation and game engine profiles are loaded when a game config is first
+  // requested, see gameConfig
+  mutable ConfigMap m_configs;
+  mutable std::set<std::string> m_gamesWithProfiles;
   mutable GamePathMap m_gamePaths;
   mutable GamePathMap m_defaultEngines;
 
+  // shared by all game instances of the same game that are alive
+  std::map<std::string, std::weak_ptr<GameAssetCache>> m_assetCaches;
+
 public:
   static GameFactory& instance();
 
@@ -124,6 +133,7 @@ public:
 
   std::vector<std::string> fileFormats(const std::string& gameName) const;
   std::filesystem::path iconPath(const std::string& gameName) const;
+  bool experimental(const std::string& gameName) const;
   std::filesystem::path gamePath(const std::string& gameName) const;
   bool setGamePath(const std::string& gameName, const std::filesystem::path& gamePath);
   bool isGamePathPreference(
@@ -136,6 +146,13 @@ public:
     const std::string& toolName,
     const std::filesystem::path& gamePath);
 
+  /**
+   * Returns the configuration of the game with the given name.
+   *
+   * The compilation and game engine profiles of a game are only loaded (and migrated)
+   * when its configuration is requested for the first time, so that the application
+   * does not have to read them for every game on startup.
+   */
   GameConfig& gameConfig(const std::string& gameName);
   const GameConfig& gameConfig(const std::string& gameName) const;
 
@@ -150,11 +167,12 @@ public:
 private:
   GameFactory();
   Result<void> initializeFileSystem(const GamePathConfig& gamePathConfig);
-  Result<std::vector<std::string>> loadGameConfigs(const GamePathConfig& gamePathConfig);
-  Result<void> loadGameConfig(
-    const GamePathConfig& gamePathConfig, const std::filesystem::path& path);
-  void loadCompilationConfig(GameConfig& gameConfig);
-  void loadGameEngineConfig(GameConfig& gameConfig);
+  Result<std::vector<std::string>> loadGameConfigs();
+  Result<void> loadGameConfig(const std::filesystem::path& path);
+  GameConfig& findGameConfig(const std::string& gameName) const;
+  void loadProfiles(GameConfig& gameConfig) const;
+  void loadCompilationConfig(GameConfig& gameConfig) const;
+  void loadGameEngineConfig(GameConfig& gameConfig) const;
 
   void writeCompilationConfig(
     GameConfig& gameConfig, CompilationConfig compilationConfig, Logger& logger);
@@ -29,17 +29,25 @@
 #include "io/TraversalMode.h"
 #include "io/WadFileSystem.h"
 #include "io/ZipFileSystem.h"
+#include "mdl/GameAssetCache.h"
 #include "mdl/GameConfig.h"
 
 #include "kdl/result_fold.h"
 #include "kdl/string_compare.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 namespace tb::mdl
 {
 
+GameFileSystem::GameFileSystem(std::shared_ptr<GameAssetCache> assetCache)
+  : m_assetCache{std::move(assetCache)}
+{
+}
+
 void GameFileSystem::initialize(
   const GameConfig& config,
   const std::filesystem::path& gamePath,
@@ -47,6 +55,8 @@ void GameFileSystem::initialize(
   Logger& logger)
 {
   unmountAll();
+  m_additionalSearchPaths.clear();
+  m_wads.clear();
 
   addDefaultAssetPaths(config, logger);
 
@@ -56,14 +66,102 @@ void GameFileSystem::initialize(
   }
 }
 
-void GameFileSystem::reloadWads(
+std::vector<std::filesystem::path> GameFileSystem::setAdditionalSearchPaths(
+  const GameConfig& config,
+  const std::filesystem::path& gamePath,
+  const std::vector<std::filesystem::path>& additionalSearchPaths,
+  Logger& logger)
+{
+  if (gamePath.empty() || io::Disk::pathInfo(gamePath) != io::PathInfo::Directory)
+  {
+    return {};
+  }
+
+  const auto [firstChanged, firstNew] = std::ranges::mismatch(
+    m_additionalSearchPaths,
+    additionalSearchPaths,
+    std::equal_to{},
+    &MountedSearchPath::path);
+  if (
+    firstChanged == m_additionalSearchPaths.end()
+    && firstNew == additionalSearchPaths.end())
+  {
+    return {};
+  }
+
+  auto changedPaths = std::vector<std::filesystem::path>{};
+
+  // the wads must take precedence over the search paths, so they are mounted again below
+  unmountWads();
+
+  for (auto it = firstChanged; it != m_additionalSearchPaths.end(); ++it)
+  {
+    for (const auto& id : it->mountPointIds)
+    {
+      unmountAndCollectFiles(id, changedPaths);
+    }
+  }
+  m_additionalSearchPaths.erase(firstChanged, m_additionalSearchPaths.end());
+
+  for (auto it = firstNew; it != additionalSearchPaths.end(); ++it)
+  {
+    auto mountPointIds = addSearchPath(config, gamePath, *it, logger);
+    for (const auto& id : mountPointIds)
+    {
+      collectFiles(id, changedPaths);
+    }
+    m_additionalSearchPaths.push_back({*it, std::move(mountPointIds)});
+  }
+
+  remountWads();
+
+  return kdl::vec_sort_and_remove_duplicates(std::move(changedPaths));
+}
+
+std::vector<std::filesystem::path> GameFileSystem::reloadWads(
   const std::filesystem::path& rootPath,
   const std::vector<std::filesystem::path>& wadSearchPaths,
   const std::vector<std::filesystem::path>& wadPaths,
   Logger& logger)
 {
-  unmountWads();
-  mountWads(rootPath, wadSearchPaths, wadPaths, logger);
+  const auto resolvedWadPaths = kdl::vec_transform(wadPaths, [&](const auto& wadPath) {
+    return io::Disk::resolvePath(wadSearchPaths, wadPath);
+  });
+
+  // keep the wads that were loaded and remain at their position
+  auto keepCount = size_t(0);
+  if (rootPath == m_wadRootPath)
+  {
+    while (keepCount < m_wads.size() && keepCount < resolvedWadPaths.size()
+           && m_wads[keepCount].fileSystem
+           && m_wads[keepCount].resolvedPath == resolvedWadPaths[keepCount])
+    {
+      ++keepCount;
+    }
+  }
+
+  auto changedPaths = std::vector<std::filesystem::path>{};
+  for (auto i = keepCount; i < m_wads.size(); ++i)
+  {
+    if (const auto& id = m_wads[i].mountPointId)
+    {
+      unmountAndCollectFiles(*id, changedPaths);
+    }
+  }
+  m_wads.erase(m_wads.begin() + std::ptrdiff_t(keepCount), m_wads.end());
+
+  m_wadRootPath = rootPath;
+  for (auto i = keepCount; i < wadPaths.size(); ++i)
+  {
+    auto wad = mountWad(wadPaths[i], resolvedWadPaths[i], logger);
+    if (wad.mountPointId)
+    {
+      collectFiles(*wad.mountPointId, changedPaths);
+    }
+    m_wads.push_back(std::move(wad));
+  }
+
+  return kdl::vec_sort_and_remove_duplicates(std::move(changedPaths));
 }
 
 void GameFileSystem::addDefaultAssetPaths(const GameConfig& config, Logger& logger)
@@ -100,25 +198,28 @@ void GameFileSystem::addGameFileSystems(
 
   for (const auto& searchPath : additionalSearchPaths)
   {
-    addSearchPath(config, gamePath, searchPath, logger);
+    m_additionalSearchPaths.push_back(
+      {searchPath, addSearchPath(config, gamePath, searchPath, logger)});
   }
 }
 
-void GameFileSystem::addSearchPath(
+std::vector<io::VirtualMountPointId> GameFileSystem::addSearchPath(
   const GameConfig& config,
   const std::filesystem::path& gamePath,
   const std::filesystem::path& searchPath,
   Logger& logger)
 {
   const auto fixedPath = io::Disk::fixPath(gamePath / searchPath);
-  addFileSystemPath(fixedPath, logger);
-  addFileSystemPackages(config, fixedPath, logger);
+  auto mountPointIds = std::vector{addFileSystemPath(fixedPath, logger)};
+  return kdl::vec_concat(
+    std::move(mountPointIds), addFileSystemPackages(config, fixedPath, logger));
 }
 
-void GameFileSystem::addFileSystemPath(const std::filesystem::path& path, Logger& logger)
+io::VirtualMountPointId GameFileSystem::addFileSystemPath(
+  const std::filesystem::path& path, Logger& logger)
 {
   logger.info() << "Adding file system path " << path;
-  mount("", std::make_unique<io::DiskFileSystem>(path));
+  return mount("", std::make_unique<io::DiskFileSystem>(path));
 }
 
 namespace
@@ -131,6 +232,8 @@ Result<std::unique_ptr<io::FileSystem>> createImageFileSystem(
     return std::unique_ptr<io::FileSystem>{std::move(fs)};
   };
 
+  // Packages are read with positioned reads instead of being mapped for as long as the
+  // file system exists.
   if (kdl::ci::str_is_equal(packageFormat, "idpak"))
   {
     return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
@@ -156,9 +259,11 @@ Result<std::unique_ptr<io::FileSystem>> createImageFileSystem(
 }
 } // namespace
 
-void GameFileSystem::addFileSystemPackages(
+std::vector<io::VirtualMountPointId> GameFileSystem::addFileSystemPackages(
   const GameConfig& config, const std::filesystem::path& searchPath, Logger& logger)
 {
+  auto mountPointIds = std::vector<io::VirtualMountPointId>{};
+
   const auto& fileSystemConfig = config.fileSystemConfig;
   const auto& packageFormatConfig = fileSystemConfig.packageFormat;
 
@@ -179,13 +284,15 @@ void GameFileSystem::addFileSystemPackages(
                    [&](auto packagePath) {
                      return diskFS.makeAbsolute(packagePath)
                             | kdl::and_then([&](const auto& absPackagePath) {
-                                return createImageFileSystem(
-                                  packageFormat, absPackagePath);
+                                return packageFileSystem(absPackagePath, [&]() {
+                                  return createImageFileSystem(
+                                    packageFormat, absPackagePath);
+                                });
                               })
                             | kdl::transform([&](auto fs) {
                                 logger.info()
                                   << "Adding file system package " << packagePath;
-                                mount("", std::move(fs));
+                                mountPointIds.push_back(mount("", std::move(fs)));
                               });
                    })
                  | kdl::fold;
@@ -194,35 +301,91 @@ void GameFileSystem::addFileSystemPackages(
           logger.error() << "Could not add file system packages: " << e.msg;
         });
   }
+
+  return mountPointIds;
 }
 
-void GameFileSystem::mountWads(
-  const std::filesystem::path& rootPath,
-  const std::vector<std::filesystem::path>& wadSearchPaths,
-  const std::vector<std::filesystem::path>& wadPaths,
+GameFileSystem::MountedWad GameFileSystem::mountWad(
+  const std::filesystem::path& wadPath,
+  const std::filesystem::path& resolvedWadPath,
   Logger& logger)
 {
-  for (const auto& wadPath : wadPaths)
+  return packageFileSystem(
+           resolvedWadPath,
+           [&]() {
+             return io::Disk::openFile(resolvedWadPath) | kdl::and_then([](auto file) {
+                      return io::createImageFileSystem<io::WadFileSystem>(
+                        std::move(file));
+                    })
+                    | kdl::transform([&](auto fs) {
+                        fs->setMetadata(io::makeImageFileSystemMetadata(resolvedWadPath));
+                        return std::unique_ptr<io::FileSystem>{std::move(fs)};
+                      });
+           })
+         | kdl::transform([&](auto fs) {
+             const auto id = mount(m_wadRootPath, fs);
+             return MountedWad{resolvedWadPath, std::move(fs), id};
+           })
+         | kdl::transform_error([&](auto e) {
+             logger.error() << "Could not load wad file at '" << wadPath
+                            << "': " << e.msg;
+             return MountedWad{resolvedWadPath, nullptr, std::nullopt};
+           })
+         | kdl::value();
+}
+
+Result<std::shared_ptr<io::FileSystem>> GameFileSystem::packageFileSystem(
+  const std::filesystem::path& path,
+  const std::function<Result<std::unique_ptr<io::FileSystem>>()>& createFileSystem)
+{
+  if (m_assetCache)
   {
-    const auto resolvedWadPath = io::Disk::resolvePath(wadSearchPaths, wadPath);
-    io::Disk::openFile(resolvedWadPath) | kdl::and_then([](auto file) {
-      return io::createImageFileSystem<io::WadFileSystem>(std::move(file));
-    }) | kdl::transform([&](auto fs) {
-      fs->setMetadata(io::makeImageFileSystemMetadata(resolvedWadPath));
-      m_wadMountPoints.push_back(mount(rootPath, std::move(fs)));
-    }) | kdl::transform_error([&](auto e) {
-      logger.error() << "Could not load wad file at '" << wadPath << "': " << e.msg;
-    });
+    return m_assetCache->packageFileSystem(path, createFileSystem);
   }
+
+  return createFileSystem() | kdl::transform([](auto fs) {
+           return std::shared_ptr<io::FileSystem>{std::move(fs)};
+         });
 }
 
 void GameFileSystem::unmountWads()
 {
-  for (const auto& id : m_wadMountPoints)
+  for (auto& wad : m_wads)
+  {
+    if (wad.mountPointId)
+    {
+      unmount(*wad.mountPointId);
+      wad.mountPointId = std::nullopt;
+    }
+  }
+}
+
+void GameFileSystem::remountWads()
+{
+  for (auto& wad : m_wads)
   {
-    unmount(id);
+    if (wad.fileSystem)
+    {
+      wad.mountPointId = mount(m_wadRootPath, wad.fileSystem);
+    }
   }
-  m_wadMountPoints.clear();
+}
+
+void GameFileSystem::unmountAndCollectFiles(
+  const io::VirtualMountPointId& id, std::vector<std::filesystem::path>& paths)
+{
+  collectFiles(id, paths);
+  unmount(id);
+}
+
+void GameFileSystem::collectFiles(
+  const io::VirtualMountPointId& id, std::vector<std::filesystem::path>& paths) const
+{
+  findMountedFiles(id) | kdl::transform([&](auto mountedPaths) {
+    paths = kdl::vec_concat(std::move(paths), std::move(mountedPaths));
+  }) | kdl::transform_error([](auto) {
+    // a file system that cannot be listed provides no files whose resolution can change
+  });
 }
 
 } // namespace tb::mdl
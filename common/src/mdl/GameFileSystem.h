@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include "Result.h"
 #include "io/VirtualFileSystem.h"
 
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace tb
@@ -31,20 +35,66 @@ class Logger;
 
 namespace tb::mdl
 {
+class GameAssetCache;
 struct GameConfig;
 
 class GameFileSystem : public io::VirtualFileSystem
 {
 private:
-  std::vector<io::VirtualMountPointId> m_wadMountPoints;
+  struct MountedSearchPath
+  {
+    std::filesystem::path path;
+    std::vector<io::VirtualMountPointId> mountPointIds;
+  };
+
+  struct MountedWad
+  {
+    std::filesystem::path resolvedPath;
+    // empty if the wad file could not be loaded
+    std::shared_ptr<io::FileSystem> fileSystem;
+    std::optional<io::VirtualMountPointId> mountPointId;
+  };
+
+  std::shared_ptr<GameAssetCache> m_assetCache;
+  std::vector<MountedSearchPath> m_additionalSearchPaths;
+  std::filesystem::path m_wadRootPath;
+  std::vector<MountedWad> m_wads;
 
 public:
+  /**
+   * Creates a game file system that shares the file systems of package files with the
+   * other users of the given asset cache. If no asset cache is given, nothing is shared.
+   */
+  explicit GameFileSystem(std::shared_ptr<GameAssetCache> assetCache = nullptr);
+
   void initialize(
     const GameConfig& config,
     const std::filesystem::path& gamePath,
     const std::vector<std::filesystem::path>& additionalSearchPaths,
     Logger& logger);
-  void reloadWads(
+
+  /**
+   * Replaces the additional search paths passed to initialize, e.g. because the enabled
+   * mods changed. Search paths that remain at their position are not mounted again. The
+   * mounted wad files are kept so that they still take precedence.
+   *
+   * Returns the paths of the files of all unmounted and newly mounted file systems. These
+   * are the only files which may now be provided by a different file system.
+   */
+  std::vector<std::filesystem::path> setAdditionalSearchPaths(
+    const GameConfig& config,
+    const std::filesystem::path& gamePath,
+    const std::vector<std::filesystem::path>& additionalSearchPaths,
+    Logger& logger);
+
+  /**
+   * Mounts the given wad files in place of the currently mounted ones. Wad files that
+   * remain at their position are not mounted again, but wad files that could not be
+   * loaded are retried.
+   *
+   * Returns the paths of the files of all unmounted and newly mounted wad files.
+   */
+  std::vector<std::filesystem::path> reloadWads(
     const std::filesystem::path& rootPath,
     const std::vector<std::filesystem::path>& wadSearchPaths,
     const std::vector<std::filesystem::path>& wadPaths,
@@ -57,20 +107,30 @@ private:
     const std::filesystem::path& gamePath,
     const std::vector<std::filesystem::path>& additionalSearchPaths,
     Logger& logger);
-  void addSearchPath(
+  std::vector<io::VirtualMountPointId> addSearchPath(
     const GameConfig& config,
     const std::filesystem::path& gamePath,
     const std::filesystem::path& searchPath,
     Logger& logger);
-  void addFileSystemPath(const std::filesystem::path& path, Logger& logger);
-  void addFileSystemPackages(
+  io::VirtualMountPointId addFileSystemPath(
+    const std::filesystem::path& path, Logger& logger);
+  std::vector<io::VirtualMountPointId> addFileSystemPackages(
     const GameConfig& config, const std::filesystem::path& searchPath, Logger& logger);
 
-  void mountWads(
-    const std::filesystem::path& rootPath,
-    const std::vector<std::filesystem::path>& wadSearchPaths,
-    const std::vector<std::filesystem::path>& wadPaths,
+  Result<std::shared_ptr<io::FileSystem>> packageFileSystem(
+    const std::filesystem::path& path,
+    const std::function<Result<std::unique_ptr<io::FileSystem>>()>& createFileSystem);
+
+  MountedWad mountWad(
+    const std::filesystem::path& wadPath,
+    const std::filesystem::path& resolvedWadPath,
     Logger& logger);
   void unmountWads();
+  void remountWads();
+
+  void unmountAndCollectFiles(
+    const io::VirtualMountPointId& id, std::vector<std::filesystem::path>& paths);
+  void collectFiles(
+    const io::VirtualMountPointId& id, std::vector<std::filesystem::path>& paths) const;
 };
 } // namespace tb::mdl
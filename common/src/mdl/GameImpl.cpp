@@ -39,6 +39,7 @@
 #include "mdl/EntityDefinitionFileSpec.h"
 #include "mdl/EntityNodeBase.h"
 #include "mdl/EntityProperties.h"
+#include "mdl/GameAssetCache.h"
 #include "mdl/GameConfig.h"
 #include "mdl/MaterialManager.h"
 
@@ -56,30 +57,43 @@
 
 namespace tb::mdl
 {
-GameImpl::GameImpl(GameConfig config, std::filesystem::path gamePath, Logger& logger)
+GameImpl::GameImpl(
+  GameConfig config,
+  std::filesystem::path gamePath,
+  Logger& logger,
+  std::shared_ptr<GameAssetCache> assetCache)
   : m_config{std::move(config)}
+  , m_assetCache{assetCache ? std::move(assetCache) : std::make_shared<GameAssetCache>()}
+  , m_fs{m_assetCache}
   , m_gamePath{std::move(gamePath)}
 {
   initializeFileSystem(logger);
 }
 
 Result<std::vector<EntityDefinition>> GameImpl::loadEntityDefinitions(
-  io::ParserStatus& status, const std::filesystem::path& path) const
+  io::ParserStatus& status,
+  const std::filesystem::path& path,
+  kdl::task_manager& taskManager) const
 {
   const auto extension = kdl::path_to_lower(path.extension());
   const auto& defaultColor = m_config.entityConfig.defaultColor;
 
   if (extension == ".fgd")
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
+    return io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
              auto reader = file->reader().buffer();
-             auto parser = io::FgdParser{reader.stringView(), defaultColor, path};
+             auto parser = io::FgdParser{
+               reader.stringView(),
+               defaultColor,
+               path,
+               taskManager,
+               m_assetCache->entityDefinitionCache()};
              return parser.parseDefinitions(status);
            });
   }
   if (extension == ".def")
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
+    return io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
              auto reader = file->reader().buffer();
              auto parser = io::DefParser{reader.stringView(), defaultColor};
              return parser.parseDefinitions(status);
@@ -87,7 +101,7 @@ Result<std::vector<EntityDefinition>> GameImpl::loadEntityDefinitions(
   }
   if (extension == ".ent")
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
+    return io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
              auto reader = file->reader().buffer();
              auto parser = io::EntParser{reader.stringView(), defaultColor};
              return parser.parseDefinitions(status);
@@ -121,14 +135,16 @@ void GameImpl::setGamePath(const std::filesystem::path& gamePath, Logger& logger
   }
 }
 
-void GameImpl::setAdditionalSearchPaths(
+std::vector<std::filesystem::path> GameImpl::setAdditionalSearchPaths(
   const std::vector<std::filesystem::path>& searchPaths, Logger& logger)
 {
   if (searchPaths != m_additionalSearchPaths)
   {
     m_additionalSearchPaths = searchPaths;
-    initializeFileSystem(logger);
+    return m_fs.setAdditionalSearchPaths(
+      m_config, m_gamePath, m_additionalSearchPaths, logger);
   }
+  return {};
 }
 
 Game::PathErrors GameImpl::checkAdditionalSearchPaths(
@@ -160,7 +176,7 @@ SoftMapBounds GameImpl::extractSoftMapBounds(const Entity& entity) const
   return SoftMapBounds{SoftMapBoundsType::Game, config().softMapBounds};
 }
 
-void GameImpl::reloadWads(
+std::vector<std::filesystem::path> GameImpl::reloadWads(
   const std::filesystem::path& documentPath,
   const std::vector<std::filesystem::path>& wadPaths,
   Logger& logger)
@@ -170,7 +186,7 @@ void GameImpl::reloadWads(
     m_gamePath,                 // Search for assets relative to the location of the game.
     io::SystemPaths::appDirectory(), // Search for assets relative to the application.
   };
-  m_fs.reloadWads(m_config.materialConfig.root, searchPaths, wadPaths, logger);
+  return m_fs.reloadWads(m_config.materialConfig.root, searchPaths, wadPaths, logger);
 }
 
 bool GameImpl::isEntityDefinitionFile(const std::filesystem::path& path) const
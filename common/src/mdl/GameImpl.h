@@ -24,6 +24,7 @@
 #include "mdl/GameFileSystem.h"
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,21 +36,33 @@ class Logger;
 namespace tb::mdl
 {
 struct EntityPropertyConfig;
+class GameAssetCache;
 
 class GameImpl : public Game
 {
 private:
   GameConfig m_config;
+  std::shared_ptr<GameAssetCache> m_assetCache;
   GameFileSystem m_fs;
   std::filesystem::path m_gamePath;
   std::vector<std::filesystem::path> m_additionalSearchPaths;
 
 public:
-  GameImpl(GameConfig config, std::filesystem::path gamePath, Logger& logger);
+  /**
+   * Creates a game that shares its assets with the other users of the given asset cache.
+   * If no asset cache is given, the game uses an asset cache of its own.
+   */
+  GameImpl(
+    GameConfig config,
+    std::filesystem::path gamePath,
+    Logger& logger,
+    std::shared_ptr<GameAssetCache> assetCache = nullptr);
 
 public: // implement EntityDefinitionLoader interface:
   Result<std::vector<EntityDefinition>> loadEntityDefinitions(
-    io::ParserStatus& status, const std::filesystem::path& path) const override;
+    io::ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager) const override;
 
 public: // implement Game interface
   const GameConfig& config() const override;
@@ -58,14 +71,14 @@ public: // implement Game interface
   std::filesystem::path gamePath() const override;
 
   void setGamePath(const std::filesystem::path& gamePath, Logger& logger) override;
-  void setAdditionalSearchPaths(
+  std::vector<std::filesystem::path> setAdditionalSearchPaths(
     const std::vector<std::filesystem::path>& searchPaths, Logger& logger) override;
   PathErrors checkAdditionalSearchPaths(
     const std::vector<std::filesystem::path>& searchPaths) const override;
 
   SoftMapBounds extractSoftMapBounds(const Entity& entity) const override;
 
-  void reloadWads(
+  std::vector<std::filesystem::path> reloadWads(
     const std::filesystem::path& documentPath,
     const std::vector<std::filesystem::path>& wadPaths,
     Logger& logger) override;
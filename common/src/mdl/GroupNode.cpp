@@ -40,7 +40,8 @@ namespace tb::mdl
 {
 
 GroupNode::GroupNode(Group group)
-  : m_group{std::move(group)}
+  : Node{Kind}
+  , m_group{std::move(group)}
 {
 }
 
@@ -235,12 +236,6 @@ void GroupNode::doNodePhysicalBoundsDidChange()
   invalidateBounds();
 }
 
-void GroupNode::doChildPhysicalBoundsDidChange()
-{
-  invalidateBounds();
-  nodePhysicalBoundsDidChange();
-}
-
 bool GroupNode::doSelectable() const
 {
   return true;
@@ -43,6 +43,9 @@ namespace tb::mdl
  */
 class GroupNode : public Node, public Object
 {
+public:
+  static constexpr auto Kind = NodeKind::Group;
+
 private:
   enum class EditState
   {
@@ -111,7 +114,6 @@ private: // implement methods inherited from Node
   void doChildWasRemoved(Node* node) override;
 
   void doNodePhysicalBoundsDidChange() override;
-  void doChildPhysicalBoundsDidChange() override;
 
   bool doSelectable() const override;
 
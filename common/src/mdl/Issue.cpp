@@ -30,6 +30,7 @@
 
 #include "kdl/overload.h"
 
+#include <atomic>
 #include <string>
 
 namespace tb::mdl
@@ -102,9 +103,14 @@ bool Issue::hidden() const
   return m_node.issueHidden(type());
 }
 
+void Issue::renumber()
+{
+  m_seqId = nextSeqId();
+}
+
 size_t Issue::nextSeqId()
 {
-  static size_t seqId = 0;
+  static auto seqId = std::atomic<size_t>{0};
   return seqId++;
 }
 
@@ -54,6 +54,15 @@ public:
 
   bool hidden() const;
 
+  /**
+   * Assigns a new sequence ID to this issue.
+   *
+   * Issues that are created concurrently receive their sequence IDs in no particular
+   * order. Renumbering them in a fixed order afterwards makes their order independent
+   * of the thread scheduling.
+   */
+  void renumber();
+
 protected:
   static size_t nextSeqId();
 
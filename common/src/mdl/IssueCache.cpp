@@ -0,0 +1,259 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IssueCache.h"
+
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNodeBase.h"
+#include "mdl/Issue.h"
+#include "mdl/Map.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+/**
+ * Small batches of nodes are validated on the calling thread.
+ */
+constexpr auto ValidationChunkSize = size_t(256);
+
+template <typename F>
+void visitSubtree(Node& node, const F& f)
+{
+  f(node);
+  for (auto* child : node.children())
+  {
+    visitSubtree(*child, f);
+  }
+}
+
+bool isGeometryNode(const Node& node)
+{
+  return dynamic_cast<const BrushNode*>(&node) || dynamic_cast<const PatchNode*>(&node);
+}
+
+} // namespace
+
+IssueCache::IssueCache(Map& map)
+  : m_map{map}
+{
+  connectObservers();
+}
+
+std::vector<const Issue*> IssueCache::issues()
+{
+  auto* worldNode = m_map.world();
+  if (!worldNode)
+  {
+    return {};
+  }
+
+  const auto validators = worldNode->registeredValidators();
+  if (!m_valid)
+  {
+    revalidateAll(validators);
+  }
+  else
+  {
+    revalidate(
+      std::vector<Node*>{m_invalidNodes.begin(), m_invalidNodes.end()}, validators);
+    m_invalidNodes.clear();
+  }
+
+  auto result = std::vector<const Issue*>{};
+  for (auto* node : m_nodesWithIssues)
+  {
+    result = kdl::vec_concat(std::move(result), node->issues(validators));
+  }
+
+  return kdl::vec_sort(std::move(result), [](const auto* lhs, const auto* rhs) {
+    return lhs->seqId() > rhs->seqId();
+  });
+}
+
+void IssueCache::revalidate(Node& node, const std::vector<const Validator*>& validators)
+{
+  if (node.issues(validators).empty())
+  {
+    m_nodesWithIssues.erase(&node);
+  }
+  else
+  {
+    m_nodesWithIssues.insert(&node);
+  }
+}
+
+void IssueCache::revalidate(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators)
+{
+  // Brushes and patches make up the bulk of a map. Their validators only read the node
+  // itself and state that doesn't change during validation, such as the world bounds, so
+  // they can be validated concurrently.
+  const auto geometryNodes = kdl::vec_filter(nodes, [](const auto* node) {
+    return isGeometryNode(*node) && !node->issuesValid();
+  });
+  m_map.taskManager().parallel_for(
+    geometryNodes.size(),
+    [&](const size_t i) { geometryNodes[i]->issues(validators); },
+    ValidationChunkSize);
+
+  // Validate the remaining nodes and number the new issues in the order of the given
+  // nodes, regardless of the order in which the threads found them.
+  auto geometryNodeIt = geometryNodes.begin();
+  for (auto* node : nodes)
+  {
+    if (geometryNodeIt != geometryNodes.end() && *geometryNodeIt == node)
+    {
+      node->renumberIssues();
+      ++geometryNodeIt;
+    }
+    revalidate(*node, validators);
+  }
+}
+
+void IssueCache::revalidateAll(const std::vector<const Validator*>& validators)
+{
+  m_invalidNodes.clear();
+  m_nodesWithIssues.clear();
+
+  auto nodes = std::vector<Node*>{};
+  visitSubtree(*m_map.world(), [&](Node& node) { nodes.push_back(&node); });
+  revalidate(nodes, validators);
+  m_valid = true;
+}
+
+void IssueCache::invalidate(Node& node)
+{
+  if (auto* worldNode = dynamic_cast<WorldNode*>(&node))
+  {
+    // some validators check the nodes against properties of the world, e.g. the soft map
+    // bounds
+    worldNode->invalidateAllIssues();
+    invalidateAll();
+    return;
+  }
+
+  m_invalidNodes.insert(&node);
+
+  // validators may check the children of a node, e.g. whether a group is empty
+  for (auto* parent = node.parent(); parent && !dynamic_cast<WorldNode*>(parent);
+       parent = parent->parent())
+  {
+    m_invalidNodes.insert(parent);
+  }
+
+  if (const auto* entityNode = dynamic_cast<const EntityNodeBase*>(&node))
+  {
+    for (const auto* linkedNodes :
+         {&entityNode->linkSources(),
+          &entityNode->linkTargets(),
+          &entityNode->killSources(),
+          &entityNode->killTargets()})
+    {
+      m_invalidNodes.insert(linkedNodes->begin(), linkedNodes->end());
+    }
+  }
+}
+
+void IssueCache::invalidateAll()
+{
+  m_valid = false;
+  m_invalidNodes.clear();
+}
+
+void IssueCache::connectObservers()
+{
+  m_notifierConnection +=
+    m_map.mapWasCreatedNotifier.connect(this, &IssueCache::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasLoadedNotifier.connect(this, &IssueCache::mapWasReset);
+  m_notifierConnection +=
+    m_map.mapWasClearedNotifier.connect(this, &IssueCache::mapWasReset);
+
+  // link sources and targets must be collected before and after a change
+  m_notifierConnection +=
+    m_map.nodesWillChangeNotifier.connect(this, &IssueCache::nodesWillOrDidChange);
+  m_notifierConnection +=
+    m_map.nodesDidChangeNotifier.connect(this, &IssueCache::nodesWillOrDidChange);
+  m_notifierConnection += m_map.nodesWereAddedNotifier.connect(
+    this, &IssueCache::nodesWereAddedOrWillBeRemoved);
+  m_notifierConnection += m_map.nodesWillBeRemovedNotifier.connect(
+    this, &IssueCache::nodesWereAddedOrWillBeRemoved);
+  m_notifierConnection +=
+    m_map.nodesWereRemovedNotifier.connect(this, &IssueCache::nodesWereRemoved);
+  m_notifierConnection +=
+    m_map.brushFacesDidChangeNotifier.connect(this, &IssueCache::brushFacesDidChange);
+
+  m_notifierConnection += m_map.entityDefinitionsDidChangeNotifier.connect(
+    [&]() { invalidateAll(); });
+  m_notifierConnection +=
+    m_map.modsDidChangeNotifier.connect([&]() { invalidateAll(); });
+}
+
+void IssueCache::mapWasReset(Map&)
+{
+  // the nodes of the previous map may have been deleted
+  m_nodesWithIssues.clear();
+  invalidateAll();
+}
+
+void IssueCache::nodesWillOrDidChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    invalidate(*node);
+  }
+}
+
+void IssueCache::nodesWereAddedOrWillBeRemoved(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    visitSubtree(*node, [&](Node& descendant) { invalidate(descendant); });
+  }
+}
+
+void IssueCache::nodesWereRemoved(const std::vector<Node*>& nodes)
+{
+  // the removed nodes are owned by the undo stack now and may be deleted at any time
+  for (auto* node : nodes)
+  {
+    visitSubtree(*node, [&](Node& descendant) {
+      m_invalidNodes.erase(&descendant);
+      m_nodesWithIssues.erase(&descendant);
+    });
+  }
+}
+
+void IssueCache::brushFacesDidChange(const std::vector<BrushFaceHandle>& handles)
+{
+  for (const auto& handle : handles)
+  {
+    invalidate(*handle.node());
+  }
+}
+
+} // namespace tb::mdl
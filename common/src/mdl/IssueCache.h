@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "NotifierConnection.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushFaceHandle;
+class Issue;
+class Map;
+class Node;
+class Validator;
+
+/**
+ * Keeps track of the nodes of a map that have issues and updates this information
+ * incrementally as the map changes.
+ *
+ * The cache observes the map and records which nodes were added, changed or removed,
+ * together with the nodes whose issues depend on them: their ancestors, since some
+ * validators check the children of a node, and the nodes linked to them by entity link
+ * properties. Only these nodes are revalidated when the issues are requested, so
+ * observing the map while editing only costs a few set insertions per changed node.
+ *
+ * The issues themselves are owned and cached by the nodes. Brushes and patches are
+ * validated concurrently using the map's task manager.
+ */
+class IssueCache
+{
+private:
+  Map& m_map;
+
+  /**
+   * Whether every node must be revalidated, e.g. because a new map was loaded.
+   */
+  bool m_valid = false;
+
+  std::unordered_set<Node*> m_invalidNodes;
+  std::unordered_set<Node*> m_nodesWithIssues;
+
+  NotifierConnection m_notifierConnection;
+
+public:
+  explicit IssueCache(Map& map);
+
+  /**
+   * Returns the issues of all nodes of the map, with the most recently found issues
+   * first. Revalidates the nodes that changed since the last call.
+   */
+  std::vector<const Issue*> issues();
+
+private:
+  void revalidate(Node& node, const std::vector<const Validator*>& validators);
+  void revalidate(
+    const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators);
+  void revalidateAll(const std::vector<const Validator*>& validators);
+
+  void invalidate(Node& node);
+  void invalidateAll();
+
+  void connectObservers();
+
+  void mapWasReset(Map& map);
+  void nodesWillOrDidChange(const std::vector<Node*>& nodes);
+  void nodesWereAddedOrWillBeRemoved(const std::vector<Node*>& nodes);
+  void nodesWereRemoved(const std::vector<Node*>& nodes);
+  void brushFacesDidChange(const std::vector<BrushFaceHandle>& handles);
+};
+
+} // namespace tb::mdl
@@ -19,19 +19,88 @@
 
 #include "IssueQuickFix.h"
 
+#include "mdl/Entity.h"
+#include "mdl/EntityNodeBase.h"
 #include "mdl/Issue.h"
 #include "mdl/Map.h"
-#include "mdl/Map_Entities.h"
 #include "mdl/Map_Nodes.h"
-#include "mdl/Map_Selection.h"
-#include "mdl/PushSelection.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/NodeContents.h"
+
+#include "kdl/task_manager.h"
 
 #include <cassert>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
 {
+namespace
+{
+
+using EntityPropertyFix = std::function<void(Entity&, const EntityPropertyIssue&)>;
+
+/**
+ * Applies the given fix to every issue of the given type with a single command, so that
+ * the map is only notified and revalidated once. The issues are grouped by their entity
+ * nodes, and the new entities are computed in parallel.
+ */
+void applyEntityPropertyFix(
+  Map& map,
+  const IssueType type,
+  const std::string& commandName,
+  const std::vector<const Issue*>& issues,
+  const EntityPropertyFix& fix)
+{
+  auto nodes = std::vector<Node*>{};
+  auto issuesByNode = std::vector<std::vector<const EntityPropertyIssue*>>{};
+  auto nodeIndices = std::unordered_map<const Node*, size_t>{};
+
+  for (const auto* issue : issues)
+  {
+    if (issue->type() == type)
+    {
+      auto& node = issue->node();
+      const auto [it, inserted] = nodeIndices.try_emplace(&node, nodes.size());
+      if (inserted)
+      {
+        nodes.push_back(&node);
+        issuesByNode.emplace_back();
+      }
+      issuesByNode[it->second].push_back(static_cast<const EntityPropertyIssue*>(issue));
+    }
+  }
+
+  if (nodes.empty())
+  {
+    return;
+  }
+
+  auto entities = std::vector<std::optional<Entity>>(nodes.size());
+  map.taskManager().parallel_for(nodes.size(), [&](const size_t i) {
+    auto entity = static_cast<const EntityNodeBase*>(nodes[i])->entity();
+    for (const auto* issue : issuesByNode[i])
+    {
+      fix(entity, *issue);
+    }
+    entities[i] = std::move(entity);
+  });
+
+  auto nodesToSwap = std::vector<std::pair<Node*, NodeContents>>{};
+  nodesToSwap.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodesToSwap.emplace_back(nodes[i], NodeContents{std::move(*entities[i])});
+  }
+
+  updateNodeContents(
+    map, commandName, std::move(nodesToSwap), collectContainingGroups(nodes));
+}
+
+} // namespace
 
 IssueQuickFix::IssueQuickFix(std::string description, MultiIssueFix fix)
   : m_description{std::move(description)}
@@ -75,19 +144,15 @@ IssueQuickFix makeDeleteNodesQuickFix()
 
 IssueQuickFix makeRemoveEntityPropertiesQuickFix(const IssueType type)
 {
-  return {type, "Delete Property", [](Map& map, const Issue& issue) {
-            const auto pushSelection = PushSelection{map};
-
-            const auto& entityPropertyIssue =
-              static_cast<const EntityPropertyIssue&>(issue);
-
-            // If world node is affected, the selection will fail, but if nothing is
-            // selected, the removeProperty call will correctly affect worldspawn
-            // either way.
-
-            deselectAll(map);
-            selectNodes(map, {&issue.node()});
-            removeEntityProperty(map, entityPropertyIssue.propertyKey());
+  return {"Delete Property", [=](Map& map, const std::vector<const Issue*>& issues) {
+            applyEntityPropertyFix(
+              map,
+              type,
+              "Remove Property",
+              issues,
+              [](Entity& entity, const EntityPropertyIssue& issue) {
+                entity.removeProperty(issue.propertyKey());
+              });
           }};
 }
 
@@ -97,38 +162,33 @@ IssueQuickFix makeTransformEntityPropertiesQuickFix(
   std::function<std::string(const std::string&)> keyTransform,
   std::function<std::string(const std::string&)> valueTransform)
 {
-  return {type, std::move(description), [=](Map& map, const Issue& issue) {
-            const auto pushSelection = PushSelection{map};
-
-            const auto& propIssue = static_cast<const EntityPropertyIssue&>(issue);
-            const auto& oldkey = propIssue.propertyKey();
-            const auto& oldValue = propIssue.propertyValue();
-            const auto newKey = keyTransform(oldkey);
-            const auto newValue = valueTransform(oldValue);
-
-            // If world node is affected, the selection will fail, but if nothing is
-            // selected, the removeProperty call will correctly affect worldspawn
-            // either way.
-
-            deselectAll(map);
-            selectNodes(map, {&issue.node()});
-
-            if (newKey.empty())
-            {
-              removeEntityProperty(map, propIssue.propertyKey());
-            }
-            else
-            {
-              if (newKey != oldkey)
-              {
-                renameEntityProperty(map, oldkey, newKey);
-              }
-              if (newValue != oldValue)
-              {
-                setEntityProperty(map, newKey, newValue);
-              }
-            }
-          }};
+  const auto fix = [=](Entity& entity, const EntityPropertyIssue& issue) {
+    const auto& oldKey = issue.propertyKey();
+    const auto& oldValue = issue.propertyValue();
+    const auto newKey = keyTransform(oldKey);
+    const auto newValue = valueTransform(oldValue);
+
+    if (newKey.empty())
+    {
+      entity.removeProperty(oldKey);
+    }
+    else
+    {
+      if (newKey != oldKey)
+      {
+        entity.renameProperty(oldKey, newKey);
+      }
+      if (newValue != oldValue)
+      {
+        entity.addOrUpdateProperty(newKey, newValue);
+      }
+    }
+  };
+
+  return {
+    std::move(description), [=](Map& map, const std::vector<const Issue*>& issues) {
+      applyEntityPropertyFix(map, type, "Transform Property", issues, fix);
+    }};
 }
 
 } // namespace tb::mdl
@@ -26,6 +26,8 @@
 namespace tb::mdl
 {
 
+kdl_reflect_impl(UnloadedLayerContent);
+
 kdl_reflect_impl(Layer);
 
 Layer::Layer(std::string name, const bool defaultLayer)
@@ -89,6 +91,16 @@ void Layer::setOmitFromExport(const bool omitFromExport)
   m_omitFromExport = omitFromExport;
 }
 
+const std::optional<UnloadedLayerContent>& Layer::unloadedContent() const
+{
+  return m_unloadedContent;
+}
+
+void Layer::setUnloadedContent(std::optional<UnloadedLayerContent> unloadedContent)
+{
+  m_unloadedContent = std::move(unloadedContent);
+}
+
 int Layer::invalidSortIndex()
 {
   return std::numeric_limits<int>::max();
@@ -20,15 +20,43 @@
 #pragma once
 
 #include "Color.h"
+#include "mdl/IdType.h"
 
 #include "kdl/reflection_decl.h"
 
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace tb::mdl
 {
 
+/**
+ * The source text of the objects of a layer that was not loaded when the map was opened.
+ * The objects are written back verbatim when the map is saved, and they can be loaded
+ * later on.
+ */
+struct UnloadedLayerContent
+{
+  /**
+   * The brushes and patches that belong to the layer entity itself.
+   */
+  std::vector<std::string> brushes;
+
+  /**
+   * The entities and groups that belong to the layer, including their brushes.
+   */
+  std::vector<std::string> entities;
+
+  /**
+   * The largest persistent ID of the groups among the entities. It is reserved so that
+   * new groups do not reuse it.
+   */
+  std::optional<IdType> maxPersistentId;
+
+  kdl_reflect_decl(UnloadedLayerContent, brushes, entities, maxPersistentId);
+};
+
 class Layer
 {
 private:
@@ -37,8 +65,16 @@ private:
   std::optional<int> m_sortIndex;
   std::optional<Color> m_color;
   bool m_omitFromExport = false;
+  std::optional<UnloadedLayerContent> m_unloadedContent;
 
-  kdl_reflect_decl(Layer, m_defaultLayer, m_name, m_sortIndex, m_color, m_omitFromExport);
+  kdl_reflect_decl(
+    Layer,
+    m_defaultLayer,
+    m_name,
+    m_sortIndex,
+    m_color,
+    m_omitFromExport,
+    m_unloadedContent);
 
 public:
   explicit Layer(std::string name, bool defaultLayer = false);
@@ -58,6 +94,12 @@ public:
   bool omitFromExport() const;
   void setOmitFromExport(bool omitFromExport);
 
+  /**
+   * Returns the objects of this layer that were not loaded, if any.
+   */
+  const std::optional<UnloadedLayerContent>& unloadedContent() const;
+  void setUnloadedContent(std::optional<UnloadedLayerContent> unloadedContent);
+
   static int invalidSortIndex();
   static int defaultLayerSortIndex();
 };
@@ -38,7 +38,8 @@ namespace tb::mdl
 {
 
 LayerNode::LayerNode(Layer layer)
-  : m_layer{std::move(layer)}
+  : Node{Kind}
+  , m_layer{std::move(layer)}
 {
 }
 
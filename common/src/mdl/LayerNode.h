@@ -35,6 +35,9 @@ namespace tb::mdl
 
 class LayerNode : public Node
 {
+public:
+  static constexpr auto Kind = NodeKind::Layer;
+
 private:
   Layer m_layer;
 
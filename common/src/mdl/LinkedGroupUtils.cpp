@@ -20,6 +20,7 @@
 #include "LinkedGroupUtils.h"
 
 #include "Ensure.h"
+#include "Trace.h"
 #include "Uuid.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
@@ -33,8 +34,12 @@
 #include "kdl/task_manager.h"
 #include "kdl/zip_iterator.h"
 
+#include <algorithm>
+#include <functional>
+#include <ranges>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace tb::mdl
 {
@@ -201,6 +206,40 @@ FaceSelectionResult faceSelectionWithLinkedGroupConstraints(
 
 namespace
 {
+auto makeLinkIdToNodeMap(const std::vector<Node*>& nodes)
+{
+  auto result = std::unordered_map<std::string_view, const Node*>{};
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [](auto&& thisLambda, const WorldNode* worldNode) {
+        worldNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const GroupNode* groupNode) {
+        result[groupNode->linkId()] = groupNode;
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const EntityNode* entityNode) {
+        result[entityNode->linkId()] = entityNode;
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](const BrushNode* brushNode) { result[brushNode->linkId()] = brushNode; },
+      [&](const PatchNode* patchNode) { result[patchNode->linkId()] = patchNode; }));
+  return result;
+}
+
+template <typename N>
+const N* getCorrespondingNode(
+  const std::unordered_map<std::string_view, const Node*>& correspondingNodes,
+  const std::string_view linkId)
+{
+  auto it = correspondingNodes.find(linkId);
+  return it != correspondingNodes.end() ? dynamic_cast<const N*>(it->second) : nullptr;
+}
+
 Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
   const Node* nodeToClone,
   std::unordered_map<const Node*, NodeContents>& origNodeToTransformedContents,
@@ -265,12 +304,18 @@ Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
 /**
  * Given a node, clones its children recursively and applies the given transform.
  *
+ * The given corresponding nodes are the current nodes of the target group by link ID. If
+ * a brush's corresponding brush already matches the transformed brush, i.e. if the brush
+ * was not changed since the target group was last updated, then the clone shares the
+ * corresponding brush's geometry instead of recomputing it.
+ *
  * Returns a vector of the cloned direct children of `node`.
  */
 Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
   const Node& node,
   const vm::bbox3d& worldBounds,
   const vm::mat4x4d& transformation,
+  const std::unordered_map<std::string_view, const Node*>& correspondingNodes,
   kdl::task_manager& taskManager)
 {
   auto nodesToClone = collectDescendants(std::vector{&node});
@@ -303,7 +348,14 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
           },
           [&](const BrushNode* brushNode) -> TransformResult {
             auto brush = brushNode->brush();
-            return brush.transform(worldBounds, transformation, true)
+            const auto* correspondingBrushNode =
+              getCorrespondingNode<BrushNode>(correspondingNodes, brushNode->linkId());
+            auto transformResult =
+              correspondingBrushNode
+                ? brush.transform(
+                    worldBounds, transformation, true, correspondingBrushNode->brush())
+                : brush.transform(worldBounds, transformation, true);
+            return std::move(transformResult)
                    | kdl::and_then([&]() -> TransformResult {
                        return std::make_pair(
                          nodeToTransform, NodeContents{std::move(brush)});
@@ -344,40 +396,6 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
            });
 }
 
-auto makeLinkIdToNodeMap(const std::vector<Node*>& nodes)
-{
-  auto result = std::unordered_map<std::string_view, const Node*>{};
-  Node::visitAll(
-    nodes,
-    kdl::overload(
-      [](auto&& thisLambda, const WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, const GroupNode* groupNode) {
-        result[groupNode->linkId()] = groupNode;
-        groupNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, const EntityNode* entityNode) {
-        result[entityNode->linkId()] = entityNode;
-        entityNode->visitChildren(thisLambda);
-      },
-      [&](const BrushNode* brushNode) { result[brushNode->linkId()] = brushNode; },
-      [&](const PatchNode* patchNode) { result[patchNode->linkId()] = patchNode; }));
-  return result;
-}
-
-template <typename N>
-const N* getCorrespondingNode(
-  const std::unordered_map<std::string_view, const Node*>& correspondingNodes,
-  const std::string_view linkId)
-{
-  auto it = correspondingNodes.find(linkId);
-  return it != correspondingNodes.end() ? dynamic_cast<const N*>(it->second) : nullptr;
-}
-
 template <typename T>
 void preserveGroupNames(
   const std::vector<T>& clonedNodes,
@@ -475,6 +493,8 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const vm::bbox3d& worldBounds,
   kdl::task_manager& taskManager)
 {
+  TB_TRACE_SCOPE("updateLinkedGroups");
+
   const auto& sourceGroup = sourceGroupNode.group();
   const auto invertedSourceTransformation = vm::invert(sourceGroup.transformation());
   if (!invertedSourceTransformation)
@@ -484,23 +504,31 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
 
   const auto targetGroupNodesToUpdate =
     kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
-  return kdl::vec_transform(
-           targetGroupNodesToUpdate,
-           [&](auto* targetGroupNode) {
-             const auto transformation =
-               targetGroupNode->group().transformation() * *invertedSourceTransformation;
-             return cloneAndTransformChildren(
-                      sourceGroupNode, worldBounds, transformation, taskManager)
-                    | kdl::transform([&](auto newChildren) {
-                        const auto linkIdToNodeMap =
-                          makeLinkIdToNodeMap(targetGroupNode->children());
-                        preserveGroupNames(newChildren, linkIdToNodeMap);
-                        preserveEntityProperties(newChildren, linkIdToNodeMap);
-                        return std::pair{
-                          static_cast<Node*>(targetGroupNode), std::move(newChildren)};
-                      });
-           })
-         | kdl::fold;
+
+  // The target groups are updated in parallel, and the children of each target group are
+  // transformed in parallel, too.
+  auto tasks =
+    targetGroupNodesToUpdate | std::views::transform([&](auto* targetGroupNode) {
+      return std::function{[&, targetGroupNode]() {
+        const auto transformation =
+          targetGroupNode->group().transformation() * *invertedSourceTransformation;
+        const auto linkIdToNodeMap = makeLinkIdToNodeMap(targetGroupNode->children());
+        return cloneAndTransformChildren(
+                 sourceGroupNode,
+                 worldBounds,
+                 transformation,
+                 linkIdToNodeMap,
+                 taskManager)
+               | kdl::transform([&](auto newChildren) {
+                   preserveGroupNames(newChildren, linkIdToNodeMap);
+                   preserveEntityProperties(newChildren, linkIdToNodeMap);
+                   return std::pair{
+                     static_cast<Node*>(targetGroupNode), std::move(newChildren)};
+                 });
+      }};
+    });
+
+  return taskManager.run_tasks_and_wait(tasks) | kdl::fold;
 }
 
 namespace
@@ -711,7 +739,8 @@ void resetLinkIds(GroupNode& rootNode)
 
 } // namespace
 
-std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes)
+std::vector<Error> initializeLinkIds(
+  const std::vector<Node*>& nodes, kdl::task_manager& taskManager)
 {
   const auto allGroupNodes =
     kdl::vec_sort(collectGroups(nodes), compareGroupNodesByLinkId);
@@ -719,18 +748,64 @@ std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes)
     allGroupNodes,
     [](const auto* lhs, const auto* rhs) { return lhs->linkId() == rhs->linkId(); });
 
-  auto errors = std::vector<Error>{};
+  // skip any link IDs with only one group
+  auto linkSets = std::vector<std::vector<GroupNode*>>{};
   for (const auto groupNodesWithId : groupNodesByLinkId)
   {
-    // skip any link IDs with only one group
     if (
       groupNodesWithId.begin() != groupNodesWithId.end()
       && std::next(groupNodesWithId.begin()) != groupNodesWithId.end())
     {
-      setLinkIds(
-        copyLinkIds(groupNodesWithId, GroupRecursionMode::Deep),
-        groupNodesWithId,
-        errors);
+      linkSets.emplace_back(groupNodesWithId.begin(), groupNodesWithId.end());
+    }
+  }
+
+  auto linkedGroupNodes = std::unordered_set<const Node*>{};
+  for (const auto& linkSet : linkSets)
+  {
+    linkedGroupNodes.insert(linkSet.begin(), linkSet.end());
+  }
+
+  // Copying the link IDs of a link set reads and writes the link IDs of the nodes
+  // contained in its groups, including the link IDs of nested linked groups. Link sets
+  // are therefore processed by nesting level, starting with the outermost level. The
+  // link IDs of the link sets on the same level are computed in parallel, since they
+  // don't contain each other's groups unless the linked groups are inconsistent.
+  const auto nestingLevel = [&](const GroupNode* groupNode) {
+    auto level = size_t(0);
+    for (const auto* parent = groupNode->parent(); parent; parent = parent->parent())
+    {
+      if (linkedGroupNodes.contains(parent))
+      {
+        ++level;
+      }
+    }
+    return level;
+  };
+
+  auto linkSetsByLevel = std::vector<std::vector<const std::vector<GroupNode*>*>>{};
+  for (const auto& linkSet : linkSets)
+  {
+    const auto level = std::ranges::max(linkSet | std::views::transform(nestingLevel));
+    if (level >= linkSetsByLevel.size())
+    {
+      linkSetsByLevel.resize(level + 1);
+    }
+    linkSetsByLevel[level].push_back(&linkSet);
+  }
+
+  auto errors = std::vector<Error>{};
+  for (const auto& linkSetsOnLevel : linkSetsByLevel)
+  {
+    auto tasks = linkSetsOnLevel | std::views::transform([](const auto* linkSet) {
+                   return std::function{
+                     [=]() { return copyLinkIds(*linkSet, GroupRecursionMode::Deep); }};
+                 });
+    auto linkIdResults = taskManager.run_tasks_and_wait(tasks);
+
+    for (size_t i = 0; i < linkSetsOnLevel.size(); ++i)
+    {
+      setLinkIds(std::move(linkIdResults[i]), *linkSetsOnLevel[i], errors);
     }
   }
   return errors;
@@ -113,7 +113,9 @@ using UpdateLinkedGroupsResult =
  *
  * The children of the source node are cloned (recursively) and transformed into the
  * target nodes by means of the recorded transformations of the source group and the
- * corresponding target groups.
+ * corresponding target groups. The target groups are updated in parallel. If a cloned
+ * brush turns out to be equal to its corresponding brush in a target group, i.e. if it
+ * wasn't changed, then it shares that brush's geometry instead of recomputing it.
  *
  * Depending on the protected property keys of the cloned entities and their corresponding
  * entities in the target groups, some entity property changes may not be propagated from
@@ -141,7 +143,17 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const vm::bbox3d& worldBounds,
   kdl::task_manager& taskManager);
 
-std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
+/**
+ * Makes the link IDs of the nodes in linked groups consistent. For each set of linked
+ * groups among the given nodes and their descendants, the link IDs of the nodes in the
+ * first group are copied to the corresponding nodes in the other groups. Link sets on the
+ * same nesting level are processed in parallel.
+ *
+ * If the groups of a link set don't have the same structure, the groups are unlinked and
+ * an error is returned for that link set.
+ */
+std::vector<Error> initializeLinkIds(
+  const std::vector<Node*>& nodes, kdl::task_manager& taskManager);
 
 /**
  * Reset the link IDs of the given group nodes and all contained nodes except contained
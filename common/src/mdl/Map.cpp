@@ -21,18 +21,21 @@
 
 #include "Ensure.h"
 #include "Logger.h"
+#include "MemoryReport.h"
 #include "PreferenceManager.h"
+#include "Preferences.h"
 #include "io/DiskIO.h"
 #include "io/GameConfigParser.h"
 #include "io/LoadMaterialCollections.h"
+#include "io/MapCache.h"
 #include "io/MapHeader.h"
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
 #include "io/ObjSerializer.h"
 #include "io/PathInfo.h"
 #include "io/SimpleParserStatus.h"
-#include "io/WorldReader.h"
 #include "mdl/AssetUtils.h"
+#include "mdl/AutosaveJournal.h"
 #include "mdl/BrushBuilder.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -53,6 +56,7 @@
 #include "mdl/GroupNode.h"
 #include "mdl/InvalidUVScaleValidator.h"
 #include "mdl/Issue.h"
+#include "mdl/Layer.h"
 #include "mdl/LayerNode.h"
 #include "mdl/LinkSourceValidator.h"
 #include "mdl/LinkedGroupUtils.h"
@@ -60,19 +64,24 @@
 #include "mdl/LongPropertyValueValidator.h"
 #include "mdl/Map.h"
 #include "mdl/MapFormat.h"
+#include "mdl/MapLoader.h"
 #include "mdl/MapTextEncoding.h"
 #include "mdl/Map_Entities.h"
 #include "mdl/Map_Groups.h"
 #include "mdl/Map_Nodes.h"
+#include "mdl/Map_Reload.h"
 #include "mdl/Map_Selection.h"
 #include "mdl/Map_World.h"
+#include "mdl/Material.h"
 #include "mdl/MaterialManager.h"
+#include "mdl/MemoryUsage.h"
 #include "mdl/MissingClassnameValidator.h"
 #include "mdl/MissingDefinitionValidator.h"
 #include "mdl/MissingModValidator.h"
 #include "mdl/MixedBrushContentsValidator.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
+#include "mdl/NodeQueries.h"
 #include "mdl/NonIntegerVerticesValidator.h"
 #include "mdl/PatchNode.h"
 #include "mdl/PointEntityWithBrushesValidator.h"
@@ -81,9 +90,12 @@
 #include "mdl/PushSelection.h"
 #include "mdl/RepeatStack.h"
 #include "mdl/ResourceManager.h"
+#include "mdl/SelectionChange.h"
 #include "mdl/SoftMapBoundsValidator.h"
 #include "mdl/TagManager.h"
+#include "mdl/Texture.h"
 #include "mdl/Transaction.h"
+#include "mdl/TransactionScope.h"
 #include "mdl/UndoableCommand.h"
 #include "mdl/UpdateLinkedGroupsCommand.h"
 #include "mdl/UpdateLinkedGroupsHelper.h"
@@ -92,10 +104,15 @@
 #include "mdl/WorldNode.h"
 #include "mdl/WorldNode.h" // IWYU pragma: keep
 
+#include "kdl/invoke.h"
+#include "kdl/overload.h"
+#include "kdl/path_hash.h"
 #include "kdl/path_utils.h"
 #include "kdl/ranges/to.h"
 #include "kdl/string_utils.h"
 #include "kdl/task_manager.h"
+#include "kdl/vector_set.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 #include <fmt/std.h>
@@ -103,9 +120,16 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 
@@ -122,34 +146,21 @@ Result<std::unique_ptr<WorldNode>> loadMap(
   kdl::task_manager& taskManager,
   Logger& logger)
 {
-  const auto entityPropertyConfig = EntityPropertyConfig{
-    config.entityConfig.scaleExpression, config.entityConfig.setDefaultProperties};
+  const auto cachePath = pref(Preferences::UseMapCache)
+                           ? std::optional{io::mapCachePath(path)}
+                           : std::nullopt;
 
   auto parserStatus = io::SimpleParserStatus{logger};
-  return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
-           auto fileReader = file->reader().buffer();
-           if (mapFormat == MapFormat::Unknown)
-           {
-             // Try all formats listed in the game config
-             const auto possibleFormats =
-               config.fileFormats | std::views::transform([](const auto& formatConfig) {
-                 return formatFromName(formatConfig.format);
-               })
-               | kdl::ranges::to<std::vector>();
-
-             return io::WorldReader::tryRead(
-               fileReader.stringView(),
-               possibleFormats,
-               worldBounds,
-               entityPropertyConfig,
-               parserStatus,
-               taskManager);
-           }
-
-           auto worldReader =
-             io::WorldReader{fileReader.stringView(), mapFormat, entityPropertyConfig};
-           return worldReader.read(worldBounds, parserStatus, taskManager);
-         });
+  return readMapFile(
+    config,
+    mapFormat,
+    worldBounds,
+    path,
+    cachePath,
+    parserStatus,
+    taskManager,
+    std::nullopt,
+    pref(Preferences::LoadHiddenLayers));
 }
 
 Result<std::unique_ptr<WorldNode>> createMap(
@@ -220,27 +231,41 @@ void setWorldDefaultProperties(
   }
 }
 
-auto makeInitializeNodeTagsVisitor(TagManager& tagManager)
+void initializeNodeTags(
+  const std::vector<Node*>& nodes, TagManager& tagManager, kdl::task_manager& taskManager)
 {
-  return kdl::overload(
-    [&](auto&& thisLambda, WorldNode* world) {
-      world->initializeTags(tagManager);
-      world->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, LayerNode* layer) {
-      layer->initializeTags(tagManager);
-      layer->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, GroupNode* group) {
-      group->initializeTags(tagManager);
-      group->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, EntityNode* entity) {
-      entity->initializeTags(tagManager);
-      entity->visitChildren(thisLambda);
-    },
-    [&](BrushNode* brush) { brush->initializeTags(tagManager); },
-    [&](PatchNode* patch) { patch->initializeTags(tagManager); });
+  // brush faces make up the bulk of the work, so brushes and patches are tagged in
+  // parallel
+  auto leafNodes = std::vector<Node*>{};
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [&](auto&& thisLambda, WorldNode* world) {
+        world->initializeTags(tagManager);
+        world->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, LayerNode* layer) {
+        layer->initializeTags(tagManager);
+        layer->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, GroupNode* group) {
+        group->initializeTags(tagManager);
+        group->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, EntityNode* entity) {
+        entity->initializeTags(tagManager);
+        entity->visitChildren(thisLambda);
+      },
+      [&](BrushNode* brush) { leafNodes.push_back(brush); },
+      [&](PatchNode* patch) { leafNodes.push_back(patch); }));
+
+  tagManager.setMaterialTagCacheEnabled(true);
+  const auto disableCache =
+    kdl::invoke_later{[&]() { tagManager.setMaterialTagCacheEnabled(false); }};
+
+  taskManager.parallel_for(leafNodes.size(), [&](const size_t i) {
+    leafNodes[i]->initializeTags(tagManager);
+  });
 }
 
 auto makeClearNodeTagsVisitor()
@@ -266,7 +291,34 @@ auto makeClearNodeTagsVisitor()
     [](PatchNode* patch) { patch->clearTags(); });
 }
 
-auto makeSetMaterialsVisitor(MaterialManager& manager)
+/**
+ * Looks up materials by name, but only once for every distinct name. Most faces that are
+ * visited together share a handful of materials.
+ */
+class MaterialResolver
+{
+private:
+  MaterialManager& m_manager;
+  std::unordered_map<std::string, Material*> m_materials;
+
+public:
+  explicit MaterialResolver(MaterialManager& manager)
+    : m_manager{manager}
+  {
+  }
+
+  Material* operator()(const std::string& name)
+  {
+    auto it = m_materials.find(name);
+    if (it == m_materials.end())
+    {
+      it = m_materials.emplace(name, m_manager.material(name)).first;
+    }
+    return it->second;
+  }
+};
+
+auto makeSetMaterialsVisitor(MaterialResolver& resolveMaterial)
 {
   return kdl::overload(
     [](auto&& thisLambda, WorldNode* worldNode) { worldNode->visitChildren(thisLambda); },
@@ -280,12 +332,12 @@ auto makeSetMaterialsVisitor(MaterialManager& manager)
       for (size_t i = 0u; i < brush.faceCount(); ++i)
       {
         const auto& face = brush.face(i);
-        auto* material = manager.material(face.attributes().materialName());
+        auto* material = resolveMaterial(face.attributes().materialName());
         brushNode->setFaceMaterial(i, material);
       }
     },
     [&](PatchNode* patchNode) {
-      auto* material = manager.material(patchNode->patch().materialName());
+      auto* material = resolveMaterial(patchNode->patch().materialName());
       patchNode->setMaterial(material);
     });
 }
@@ -309,24 +361,32 @@ auto makeUnsetMaterialsVisitor()
     [](PatchNode* patchNode) { patchNode->setMaterial(nullptr); });
 }
 
-auto makeSetEntityDefinitionsVisitor(EntityDefinitionManager& manager)
+std::vector<EntityNodeBase*> collectEntityNodeBases(const std::vector<Node*>& nodes)
 {
-  // this helper lambda must be captured by value
-  const auto setEntityDefinition = [&](auto* node) {
-    const auto* definition = manager.definition(node);
-    node->setDefinition(definition);
-  };
+  auto result = std::vector<EntityNodeBase*>{};
+  visitNodes<WorldNode, EntityNode>(
+    nodes, [&](EntityNodeBase* entityNode) { result.push_back(entityNode); });
+  return result;
+}
 
-  return kdl::overload(
-    [=](auto&& thisLambda, WorldNode* worldNode) {
-      setEntityDefinition(worldNode);
-      worldNode->visitChildren(thisLambda);
-    },
-    [](auto&& thisLambda, LayerNode* layerNode) { layerNode->visitChildren(thisLambda); },
-    [](auto&& thisLambda, GroupNode* groupNode) { groupNode->visitChildren(thisLambda); },
-    [=](EntityNode* entityNode) { setEntityDefinition(entityNode); },
-    [](BrushNode*) {},
-    [](PatchNode*) {});
+void setEntityDefinitions(
+  const std::vector<Node*>& nodes,
+  const EntityDefinitionManager& manager,
+  kdl::task_manager& taskManager)
+{
+  const auto entityNodes = collectEntityNodeBases(nodes);
+
+  // looking up the definitions by classname does not modify anything, but setting them
+  // notifies the nodes' parents and must happen on this thread
+  auto definitions = std::vector<const EntityDefinition*>(entityNodes.size(), nullptr);
+  taskManager.parallel_for(entityNodes.size(), [&](const size_t i) {
+    definitions[i] = manager.definition(entityNodes[i]);
+  });
+
+  for (size_t i = 0; i < entityNodes.size(); ++i)
+  {
+    entityNodes[i]->setDefinition(definitions[i]);
+  }
 }
 
 auto makeUnsetEntityDefinitionsVisitor()
@@ -343,22 +403,38 @@ auto makeUnsetEntityDefinitionsVisitor()
     [](PatchNode*) {});
 }
 
-auto makeSetEntityModelsVisitor(EntityModelManager& manager, Logger& logger)
+void setEntityModels(
+  const std::vector<Node*>& nodes,
+  EntityModelManager& manager,
+  kdl::task_manager& taskManager,
+  Logger& logger)
 {
-  return kdl::overload(
-    [](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
-    [&](EntityNode* entityNode) {
-      const auto modelSpec =
-        safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
-          return entityNode->entity().modelSpecification();
-        });
-      const auto* model = manager.model(modelSpec.path);
-      entityNode->setModel(model);
-    },
-    [](BrushNode*) {},
-    [](PatchNode*) {});
+  auto entityNodes = std::vector<EntityNode*>{};
+  visitNodes<EntityNode>(
+    nodes, [&](EntityNode* entityNode) { entityNodes.push_back(entityNode); });
+
+  // evaluating the model expressions only touches the entity's own cache
+  auto modelSpecs = std::vector<std::optional<Result<ModelSpecification>>>(
+    entityNodes.size());
+  taskManager.parallel_for(entityNodes.size(), [&](const size_t i) {
+    modelSpecs[i] = entityNodes[i]->entity().modelSpecification();
+  });
+
+  // the model manager is not thread safe, so request every distinct model only once
+  auto models = std::map<std::filesystem::path, const EntityModel*>{};
+  for (size_t i = 0; i < entityNodes.size(); ++i)
+  {
+    auto* entityNode = entityNodes[i];
+    const auto modelSpec = safeGetModelSpecification(
+      logger, entityNode->entity().classname(), [&]() { return *modelSpecs[i]; });
+
+    auto it = models.find(modelSpec.path);
+    if (it == models.end())
+    {
+      it = models.emplace(modelSpec.path, manager.model(modelSpec.path)).first;
+    }
+    entityNode->setModel(it->second);
+  }
 }
 
 auto makeUnsetEntityModelsVisitor()
@@ -372,27 +448,30 @@ auto makeUnsetEntityModelsVisitor()
     [](PatchNode*) {});
 }
 
+std::unordered_set<const EntityModel*> collectEntityModels(const Node& node)
+{
+  auto result = std::unordered_set<const EntityModel*>{};
+
+  visitNodes<EntityNode>(node, [&](const EntityNode* entityNode) {
+    if (const auto* model = entityNode->entity().model())
+    {
+      result.insert(model);
+    }
+  });
+
+  return result;
+}
+
 std::vector<GroupNode*> collectGroupsWithPendingChanges(Node& node)
 {
   auto result = std::vector<GroupNode*>{};
 
-  node.accept(kdl::overload(
-    [](auto&& thisLambda, const WorldNode* worldNode) {
-      worldNode->visitChildren(thisLambda);
-    },
-    [](auto&& thisLambda, const LayerNode* layerNode) {
-      layerNode->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, GroupNode* groupNode) {
-      if (groupNode->hasPendingChanges())
-      {
-        result.push_back(groupNode);
-      }
-      groupNode->visitChildren(thisLambda);
-    },
-    [](const EntityNode*) {},
-    [](const BrushNode*) {},
-    [](const PatchNode*) {}));
+  visitNodes<GroupNode>(node, [&](GroupNode* groupNode) {
+    if (groupNode->hasPendingChanges())
+    {
+      result.push_back(groupNode);
+    }
+  });
 
   return result;
 }
@@ -415,6 +494,57 @@ bool updateLinkedGroups(Map& map)
   return true;
 }
 
+std::optional<size_t> undoMemoryBudget()
+{
+  const auto budgetInMegabytes = pref(Preferences::UndoMemoryBudget);
+  return budgetInMegabytes > 0
+           ? std::optional{static_cast<size_t>(budgetInMegabytes) * 1024 * 1024}
+           : std::nullopt;
+}
+
+std::optional<std::chrono::milliseconds> slowCommandThreshold()
+{
+  const auto thresholdInMilliseconds = pref(Preferences::SlowCommandThreshold);
+  return thresholdInMilliseconds > 0
+           ? std::optional{std::chrono::milliseconds{thresholdInMilliseconds}}
+           : std::nullopt;
+}
+
+std::vector<std::filesystem::path> wadPaths(const WorldNode& worldNode)
+{
+  if (const auto* wadStr = worldNode.entity().property(EntityPropertyKeys::Wad))
+  {
+    return kdl::vec_transform(kdl::str_split(*wadStr, ";"), [](const auto& str) {
+      return std::filesystem::path{str};
+    });
+  }
+  return {};
+}
+
+template <typename P>
+std::vector<Node*> findEntityNodesByModelPath(
+  WorldNode& worldNode, Logger& logger, const P& predicate)
+{
+  auto nodes = std::vector<Node*>{};
+  worldNode.accept(kdl::overload(
+    [](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
+    [&](EntityNode* entityNode) {
+      const auto modelSpec =
+        safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
+          return entityNode->entity().modelSpecification();
+        });
+      if (predicate(modelSpec.path))
+      {
+        nodes.push_back(entityNode);
+      }
+    },
+    [](BrushNode*) {},
+    [](PatchNode*) {}));
+  return nodes;
+}
+
 class ThrowExceptionCommand : public UndoableCommand
 {
 public:
@@ -447,13 +577,16 @@ Map::Map(kdl::task_manager& taskManager, Logger& logger)
   , m_entityDefinitionManager{std::make_unique<EntityDefinitionManager>()}
   , m_entityModelManager{std::make_unique<EntityModelManager>(
       [&](auto resourceLoader) {
-        auto resource =
-          std::make_shared<EntityModelDataResource>(std::move(resourceLoader));
+        // lazy resources can be evicted, but they must be loaded right away
+        auto resource = std::make_shared<EntityModelDataResource>(
+          std::move(resourceLoader), ResourceLoadMode::Lazy);
+        resource->requestLoading();
         m_resourceManager->addResource(resource);
         return resource;
       },
       m_logger)}
   , m_materialManager{std::make_unique<MaterialManager>(m_logger)}
+  , m_materialLoadMode{ResourceLoadMode::Eager}
   , m_tagManager{std::make_unique<TagManager>()}
   , m_editorContext{std::make_unique<EditorContext>()}
   , m_grid{std::make_unique<Grid>(4)}
@@ -465,6 +598,8 @@ Map::Map(kdl::task_manager& taskManager, Logger& logger)
   , m_repeatStack{std::make_unique<RepeatStack>()}
   , m_commandProcessor{std::make_unique<CommandProcessor>(*this)}
 {
+  m_commandProcessor->setMemoryBudget(undoMemoryBudget());
+  m_commandProcessor->setSlowCommandThreshold(slowCommandThreshold());
   connectObservers();
 }
 
@@ -513,6 +648,16 @@ const MaterialManager& Map::materialManager() const
   return *m_materialManager;
 }
 
+void Map::setMaterialCache(std::shared_ptr<const io::MaterialCache> materialCache)
+{
+  m_materialCache = std::move(materialCache);
+}
+
+void Map::setMaterialLoadMode(const ResourceLoadMode materialLoadMode)
+{
+  m_materialLoadMode = materialLoadMode;
+}
+
 TagManager& Map::tagManager()
 {
   return *m_tagManager;
@@ -558,6 +703,40 @@ WorldNode* Map::world() const
   return m_world.get();
 }
 
+void Map::addToMemoryReport(MemoryReport& report) const
+{
+  if (m_world)
+  {
+    mdl::addToMemoryReport(*m_world, report);
+  }
+
+  auto textureBytes = size_t(0);
+  auto textureCount = size_t(0);
+  auto videoMemoryBytes = size_t(0);
+  auto videoMemoryCount = size_t(0);
+  for (const auto* material : m_materialManager->materials())
+  {
+    if (const auto* texture = material->texture())
+    {
+      if (const auto bytes = texture->memorySize(); bytes > 0)
+      {
+        textureBytes += bytes;
+        ++textureCount;
+      }
+      if (const auto bytes = texture->videoMemorySize(); bytes > 0)
+      {
+        videoMemoryBytes += bytes;
+        ++videoMemoryCount;
+      }
+    }
+  }
+  report.add("Textures", textureBytes, textureCount);
+  report.add("Textures (video memory)", videoMemoryBytes, videoMemoryCount);
+
+  m_entityModelManager->addToMemoryReport(report);
+  m_commandProcessor->addToMemoryReport(report);
+}
+
 MapTextEncoding Map::encoding() const
 {
   return MapTextEncoding::Quake;
@@ -641,6 +820,18 @@ Result<void> Map::load(
            });
 }
 
+Result<void> Map::load(MapLoader& loader)
+{
+  return loader.get() | kdl::transform([&](auto worldNodeAndGame) {
+           auto [worldNode, game] = std::move(worldNodeAndGame);
+
+           clear();
+           setWorld(
+             loader.worldBounds(), std::move(worldNode), std::move(game), loader.path());
+           mapWasLoadedNotifier(*this);
+         });
+}
+
 Result<void> Map::reload()
 {
   if (!persistent())
@@ -657,6 +848,85 @@ Result<void> Map::reload()
   return load(mapFormat, worldBounds, std::move(game), path);
 }
 
+Result<void> Map::reloadChanges()
+{
+  if (!persistent())
+  {
+    return Result<void>{Error{"Cannot reload transient document"}};
+  }
+
+  // keep the unloaded layers unloaded
+  const auto isUnloaded = [](const auto* layerNode) {
+    return layerNode->layer().unloadedContent().has_value();
+  };
+  const auto customLayers = m_world->customLayers();
+  auto loadedLayerNames = std::optional<std::vector<std::string>>{};
+  if (std::ranges::any_of(customLayers, isUnloaded))
+  {
+    loadedLayerNames = customLayers
+                       | std::views::filter(std::not_fn(isUnloaded))
+                       | std::views::transform(&LayerNode::name)
+                       | kdl::ranges::to<std::vector>();
+  }
+
+  auto parserStatus = io::SimpleParserStatus{m_logger};
+  return readMapFile(
+           m_game->config(),
+           m_world->mapFormat(),
+           m_worldBounds,
+           m_path,
+           std::nullopt,
+           parserStatus,
+           m_taskManager,
+           loadedLayerNames)
+         | kdl::transform([&](auto worldNode) {
+             if (applyChangedNodes(*this, *worldNode))
+             {
+               setLastSaveModificationCount();
+               m_logger.info() << fmt::format("Reloaded changes from {}", m_path);
+             }
+           });
+}
+
+Result<void> Map::recoverAutosave(
+  const std::filesystem::path& snapshotPath, const std::string_view journal)
+{
+  if (!persistent())
+  {
+    return Result<void>{Error{"Cannot recover transient document"}};
+  }
+
+  m_logger.info() << fmt::format("Recovering document from {}", snapshotPath);
+
+  // the journal identifies the snapshot nodes by their line numbers, so the snapshot
+  // must be parsed completely and without using the map cache
+  auto parserStatus = io::SimpleParserStatus{m_logger};
+  return readMapFile(
+           m_game->config(),
+           m_world->mapFormat(),
+           m_worldBounds,
+           snapshotPath,
+           std::nullopt,
+           parserStatus,
+           m_taskManager)
+         | kdl::transform([&](auto worldNode) {
+             const auto worldBounds = m_worldBounds;
+             const auto path = m_path;
+             auto game = std::move(m_game);
+
+             clear();
+             setWorld(worldBounds, std::move(worldNode), std::move(game), path);
+             mapWasLoadedNotifier(*this);
+
+             // the snapshot differs from the map file, too
+             incModificationCount();
+           })
+         | kdl::and_then([&]() { return applyAutosaveJournal(*this, journal); })
+         | kdl::transform([&]() {
+             m_logger.info() << fmt::format("Recovered autosaved changes to {}", m_path);
+           });
+}
+
 void Map::save()
 {
   saveAs(m_path);
@@ -676,21 +946,43 @@ void Map::saveTo(const std::filesystem::path& path)
   ensure(m_world, "world is null");
 
   io::Disk::withOutputStream(path, [&](auto& stream) {
-    io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
-
-    auto writer = io::NodeWriter{*m_world, stream};
-    writer.setExporting(false);
-    writer.writeMap(m_taskManager);
+    saveTo(stream);
   }) | kdl::transform_error([&](const auto& e) {
     m_logger.error() << "Could not save document: " << e.msg;
   });
 }
 
+void Map::saveTo(std::ostream& stream)
+{
+  ensure(m_game.get() != nullptr, "game is null");
+  ensure(m_world, "world is null");
+
+  io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
+
+  auto writer = io::NodeWriter{*m_world, stream};
+  writer.setExporting(false);
+  writer.writeMap(m_taskManager);
+}
+
 Result<void> Map::exportAs(const io::ExportOptions& options) const
 {
   return std::visit(
     kdl::overload(
       [&](const io::ObjExportOptions& objOptions) {
+        // the objects of unloaded layers are only kept as source text, so they cannot be
+        // exported to OBJ
+        for (const auto* layerNode : m_world->customLayers())
+        {
+          if (
+            layerNode->layer().unloadedContent()
+            && !layerNode->layer().omitFromExport())
+          {
+            m_logger.warn() << "Layer '" << layerNode->name()
+                            << "' is not loaded and is not exported, load the layer to "
+                               "export its objects";
+          }
+        }
+
         return io::Disk::withOutputStream(objOptions.exportPath, [&](auto& objStream) {
           const auto mtlPath = kdl::path_replace_extension(objOptions.exportPath, ".mtl");
           return io::Disk::withOutputStream(mtlPath, [&](auto& mtlStream) {
@@ -704,15 +996,57 @@ Result<void> Map::exportAs(const io::ExportOptions& options) const
         });
       },
       [&](const io::MapExportOptions& mapOptions) {
-        return io::Disk::withOutputStream(mapOptions.exportPath, [&](auto& stream) {
-          auto writer = io::NodeWriter{*m_world, stream};
-          writer.setExporting(true);
-          writer.writeMap(m_taskManager);
-        });
+        return io::Disk::withOutputStream(
+          mapOptions.exportPath, [&](auto& stream) { exportTo(stream); });
       }),
     options);
 }
 
+void Map::exportTo(std::ostream& stream) const
+{
+  ensure(m_world, "world is null");
+
+  auto writer = io::NodeWriter{*m_world, stream};
+  writer.setExporting(true);
+  writer.writeMap(m_taskManager);
+}
+
+void Map::exportRegionTo(std::ostream& stream, const vm::bbox3d& bounds) const
+{
+  ensure(m_world, "world is null");
+
+  const auto isExported = [](const Object* object) {
+    const auto* layer = object->containingLayer();
+    return !layer || !layer->layer().omitFromExport();
+  };
+
+  auto nodes = std::vector<Node*>{};
+  for (auto* node : m_world->nodeTree().find_intersectors(bounds))
+  {
+    node->accept(kdl::overload(
+      [](WorldNode*) {},
+      [](LayerNode*) {},
+      [](GroupNode*) {},
+      [&](EntityNode* entityNode) {
+        if (!entityNode->hasChildren() && isExported(entityNode))
+        {
+          nodes.push_back(entityNode);
+        }
+      },
+      [&](BrushNode* brushNode) {
+        if (isExported(brushNode))
+        {
+          nodes.push_back(brushNode);
+        }
+      },
+      [](PatchNode*) {}));
+  }
+
+  auto writer = io::NodeWriter{*m_world, stream};
+  writer.setExporting(true);
+  writer.writeNodes(nodes, m_taskManager);
+}
+
 void Map::clear()
 {
   clearRepeatableCommands();
@@ -724,6 +1058,7 @@ void Map::clear()
 
     m_editorContext->reset();
     m_cachedSelection = std::nullopt;
+    m_batchedChangedNodes.clear();
     clearAssets();
     clearWorld();
     clearModificationCount();
@@ -757,9 +1092,15 @@ size_t Map::modificationCount() const
   return m_modificationCount;
 }
 
+size_t Map::revision() const
+{
+  return m_revision;
+}
+
 void Map::incModificationCount(const size_t delta)
 {
   m_modificationCount += delta;
+  ++m_revision;
   modificationStateDidChangeNotifier();
 }
 
@@ -767,6 +1108,7 @@ void Map::decModificationCount(const size_t delta)
 {
   assert(m_modificationCount >= delta);
   m_modificationCount -= delta;
+  ++m_revision;
   modificationStateDidChangeNotifier();
 }
 
@@ -784,6 +1126,7 @@ void Map::setLastSaveModificationCount()
 void Map::clearModificationCount()
 {
   m_lastSaveModificationCount = m_modificationCount = 0;
+  ++m_revision;
   modificationStateDidChangeNotifier();
 }
 
@@ -796,6 +1139,7 @@ void Map::setWorld(
   m_worldBounds = worldBounds;
   m_world = std::move(worldNode);
   m_game = std::move(game);
+  ++m_revision;
 
   entityModelManager().setGame(m_game.get(), taskManager());
   editorContext().setCurrentLayer(world()->defaultLayer());
@@ -886,12 +1230,12 @@ const SmartTag& Map::smartTag(const size_t index) const
 
 void Map::initializeAllNodeTags()
 {
-  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager));
+  mdl::initializeNodeTags({m_world.get()}, *m_tagManager, m_taskManager);
 }
 
 void Map::initializeNodeTags(const std::vector<Node*>& nodes)
 {
-  Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager));
+  mdl::initializeNodeTags(nodes, *m_tagManager, m_taskManager);
 }
 
 void Map::clearNodeTags(const std::vector<Node*>& nodes)
@@ -997,6 +1341,46 @@ void Map::setIssueHidden(const Issue& issue, const bool hidden)
 }
 
 
+void Map::reloadChangedMaterials(const std::vector<std::filesystem::path>& materialPaths)
+{
+  const auto reloadedMaterials = m_materialManager->reloadTextures(
+    materialPaths,
+    m_game->gameFileSystem(),
+    m_game->config().materialConfig,
+    [&](auto resourceLoader) {
+      auto resource = std::make_shared<TextureResource>(
+        std::move(resourceLoader), m_materialLoadMode);
+      m_resourceManager->addResource(resource);
+      return resource;
+    },
+    m_materialCache);
+
+  if (!reloadedMaterials.empty())
+  {
+    m_logger.info() << fmt::format(
+      "Reloaded {} changed material(s)", reloadedMaterials.size());
+  }
+}
+
+void Map::reloadChangedEntityModels(const std::vector<std::filesystem::path>& modelPaths)
+{
+  const auto nodes =
+    findEntityNodesByModelPath(*m_world, m_logger, [&](const auto& path) {
+      return std::ranges::find(modelPaths, path) != modelPaths.end();
+    });
+
+  // notify even if no entity displays the models, the entity browser may still show them
+  const auto notifyNodes =
+    NotifyBeforeAndAfter{nodesWillChangeNotifier, nodesDidChangeNotifier, nodes};
+
+  unsetEntityModels(nodes);
+  m_entityModelManager->removeModels(modelPaths);
+  setEntityModels(nodes);
+
+  m_logger.info() << fmt::format(
+    "Reloaded {} changed entity model(s)", modelPaths.size());
+}
+
 void Map::loadAssets()
 {
   loadEntityDefinitions();
@@ -1020,7 +1404,7 @@ void Map::loadEntityDefinitions()
   const auto path = game()->findEntityDefinitionFile(spec, externalSearchPaths(*this));
   auto status = io::SimpleParserStatus{m_logger};
 
-  entityDefinitionManager().loadDefinitions(path, *game(), status)
+  entityDefinitionManager().loadDefinitions(path, *game(), status, m_taskManager)
     | kdl::transform([&]() {
         m_logger.info() << fmt::format(
           "Loaded entity definition file {}", path.filename());
@@ -1051,24 +1435,42 @@ void Map::reloadMaterials()
   loadMaterials();
 }
 
-void Map::loadMaterials()
+void Map::reloadMaterials(const std::vector<std::filesystem::path>& changedPaths)
 {
-  if (const auto* wadStr = m_world->entity().property(EntityPropertyKeys::Wad))
+  if (changedPaths.empty())
   {
-    const auto wadPaths = kdl::vec_transform(
-      kdl::str_split(*wadStr, ";"),
-      [](const auto& str) { return std::filesystem::path{str}; });
-    m_game->reloadWads(path(), wadPaths, m_logger);
+    return;
   }
+
+  m_materialManager->reloadChanged(
+    changedPaths,
+    m_game->gameFileSystem(),
+    m_game->config().materialConfig,
+    [&](auto resourceLoader) {
+      auto resource = std::make_shared<TextureResource>(
+        std::move(resourceLoader), m_materialLoadMode);
+      m_resourceManager->addResource(resource);
+      return resource;
+    },
+    m_taskManager,
+    m_materialCache);
+}
+
+void Map::loadMaterials()
+{
+  m_wadPaths = wadPaths(*m_world);
+  m_game->reloadWads(path(), m_wadPaths, m_logger);
   m_materialManager->reload(
     m_game->gameFileSystem(),
     m_game->config().materialConfig,
     [&](auto resourceLoader) {
-      auto resource = std::make_shared<TextureResource>(std::move(resourceLoader));
+      auto resource = std::make_shared<TextureResource>(
+        std::move(resourceLoader), m_materialLoadMode);
       m_resourceManager->addResource(resource);
       return resource;
     },
-    m_taskManager);
+    m_taskManager,
+    m_materialCache);
 }
 
 void Map::clearMaterials()
@@ -1079,23 +1481,26 @@ void Map::clearMaterials()
 
 void Map::setMaterials()
 {
-  m_world->accept(makeSetMaterialsVisitor(*m_materialManager));
+  auto resolveMaterial = MaterialResolver{*m_materialManager};
+  m_world->accept(makeSetMaterialsVisitor(resolveMaterial));
   materialUsageCountsDidChangeNotifier();
 }
 
 void Map::setMaterials(const std::vector<Node*>& nodes)
 {
-  Node::visitAll(nodes, makeSetMaterialsVisitor(*m_materialManager));
+  auto resolveMaterial = MaterialResolver{*m_materialManager};
+  Node::visitAll(nodes, makeSetMaterialsVisitor(resolveMaterial));
   materialUsageCountsDidChangeNotifier();
 }
 
 void Map::setMaterials(const std::vector<BrushFaceHandle>& faceHandles)
 {
+  auto resolveMaterial = MaterialResolver{*m_materialManager};
   for (const auto& faceHandle : faceHandles)
   {
     BrushNode* node = faceHandle.node();
     const BrushFace& face = faceHandle.face();
-    auto* material = m_materialManager->material(face.attributes().materialName());
+    auto* material = resolveMaterial(face.attributes().materialName());
     node->setFaceMaterial(faceHandle.faceIndex(), material);
   }
   materialUsageCountsDidChangeNotifier();
@@ -1115,12 +1520,12 @@ void Map::unsetMaterials(const std::vector<Node*>& nodes)
 
 void Map::setEntityDefinitions()
 {
-  m_world->accept(makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+  mdl::setEntityDefinitions({m_world.get()}, *m_entityDefinitionManager, m_taskManager);
 }
 
 void Map::setEntityDefinitions(const std::vector<Node*>& nodes)
 {
-  Node::visitAll(nodes, makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+  mdl::setEntityDefinitions(nodes, *m_entityDefinitionManager, m_taskManager);
 }
 
 void Map::unsetEntityDefinitions()
@@ -1141,12 +1546,13 @@ void Map::clearEntityModels()
 
 void Map::setEntityModels()
 {
-  m_world->accept(makeSetEntityModelsVisitor(*m_entityModelManager, m_logger));
+  mdl::setEntityModels(
+    {m_world.get()}, *m_entityModelManager, m_taskManager, m_logger);
 }
 
 void Map::setEntityModels(const std::vector<Node*>& nodes)
 {
-  Node::visitAll(nodes, makeSetEntityModelsVisitor(*m_entityModelManager, m_logger));
+  mdl::setEntityModels(nodes, *m_entityModelManager, m_taskManager, m_logger);
 }
 
 void Map::unsetEntityModels()
@@ -1159,9 +1565,29 @@ void Map::unsetEntityModels(const std::vector<Node*>& nodes)
   Node::visitAll(nodes, makeUnsetEntityModelsVisitor());
 }
 
-void Map::updateGameSearchPaths()
+void Map::reloadEntityModels(const std::vector<std::filesystem::path>& changedPaths)
+{
+  auto changedPathSet = std::unordered_set<std::filesystem::path, kdl::path_hash>{};
+  for (const auto& changedPath : changedPaths)
+  {
+    changedPathSet.insert(kdl::path_to_lower(changedPath));
+  }
+
+  const auto isChanged = [&](const auto& path) {
+    return changedPathSet.contains(kdl::path_to_lower(path));
+  };
+
+  const auto nodes = findEntityNodesByModelPath(*m_world, m_logger, isChanged);
+  const auto modelPaths = kdl::vec_filter(m_entityModelManager->modelPaths(), isChanged);
+
+  unsetEntityModels(nodes);
+  m_entityModelManager->removeModels(modelPaths);
+  setEntityModels(nodes);
+}
+
+std::vector<std::filesystem::path> Map::updateGameSearchPaths()
 {
-  m_game->setAdditionalSearchPaths(
+  return m_game->setAdditionalSearchPaths(
     mods(*this) | std::views::transform([](const auto& mod) {
       return std::filesystem::path{mod};
     }) | kdl::ranges::to<std::vector>(),
@@ -1197,10 +1623,28 @@ void Map::processResourcesAsync(const ProcessContext& processContext)
 {
   using namespace std::chrono_literals;
 
-  const auto processedResourceIds = m_resourceManager->process(
+  // This is called from a timer on the main thread, so the uploads must leave time for
+  // rendering. The pending limit bounds the memory used by decoded, but not yet uploaded
+  // resources, e.g. when the materials of a large map are loaded.
+  constexpr auto UploadTimeout = 10ms;
+  constexpr auto MaxPendingResources = size_t(256);
+
+  auto processedResourceIds = m_resourceManager->process(
     [&](auto task) { return m_taskManager.run_task(std::move(task)); },
     processContext,
-    20ms);
+    UploadTimeout,
+    MaxPendingResources);
+
+  // Evicting a model destroys its renderers right away, so the evicted models are
+  // reported along with the processed resources.
+  if (
+    !processedResourceIds.empty() && m_world
+    && m_entityModelManager->exceedsMemoryBudget())
+  {
+    processedResourceIds = kdl::vec_concat(
+      std::move(processedResourceIds),
+      m_entityModelManager->evictModels(collectEntityModels(*m_world)));
+  }
 
   if (!processedResourceIds.empty())
   {
@@ -1263,6 +1707,11 @@ void Map::setIsCommandCollationEnabled(const bool isCommandCollationEnabled)
   m_commandProcessor->setIsCollationEnabled(isCommandCollationEnabled);
 }
 
+const std::deque<CommandProfile>& Map::commandProfiles() const
+{
+  return m_commandProcessor->commandProfiles();
+}
+
 void Map::pushRepeatableCommand(RepeatableCommand command)
 {
   m_repeatStack->push(std::move(command));
@@ -1288,6 +1737,13 @@ void Map::startTransaction(std::string name, const TransactionScope scope)
   logger().debug() << "Starting transaction '" + name + "'";
   m_commandProcessor->startTransaction(std::move(name), scope);
   m_repeatStack->startTransaction();
+
+  const auto batchNotifications = scope == TransactionScope::Oneshot;
+  m_transactionBatchesNotifications.push_back(batchNotifications);
+  if (batchNotifications)
+  {
+    beginNotificationBatch();
+  }
 }
 
 void Map::rollbackTransaction()
@@ -1309,6 +1765,7 @@ bool Map::commitTransaction()
 
   m_commandProcessor->commitTransaction();
   m_repeatStack->commitTransaction();
+  endTransactionNotificationBatch();
   return true;
 }
 
@@ -1319,6 +1776,7 @@ void Map::cancelTransaction()
   m_repeatStack->rollbackTransaction();
   m_commandProcessor->commitTransaction();
   m_repeatStack->commitTransaction();
+  endTransactionNotificationBatch();
 }
 
 bool Map::isCurrentDocumentStateObservable() const
@@ -1326,6 +1784,38 @@ bool Map::isCurrentDocumentStateObservable() const
   return m_commandProcessor->isCurrentDocumentStateObservable();
 }
 
+bool Map::isTransactionRunning() const
+{
+  return m_commandProcessor->isTransactionRunning();
+}
+
+void Map::beginNotificationBatch()
+{
+  ++m_notificationBatchDepth;
+}
+
+void Map::endNotificationBatch()
+{
+  assert(m_notificationBatchDepth > 0);
+  if (--m_notificationBatchDepth == 0 && !m_batchedChangedNodes.empty())
+  {
+    const auto nodes =
+      kdl::vec_sort_and_remove_duplicates(std::exchange(m_batchedChangedNodes, {}));
+    nodesDidChangeBatchedNotifier(nodes);
+  }
+}
+
+void Map::endTransactionNotificationBatch()
+{
+  assert(!m_transactionBatchesNotifications.empty());
+  const auto batchNotifications = m_transactionBatchesNotifications.back();
+  m_transactionBatchesNotifications.pop_back();
+  if (batchNotifications)
+  {
+    endNotificationBatch();
+  }
+}
+
 bool Map::throwExceptionDuringCommand()
 {
   const auto result = executeAndStore(std::make_unique<ThrowExceptionCommand>());
@@ -1389,6 +1879,38 @@ void Map::connectObservers()
   m_notifierConnection += resourcesWereProcessedNotifier.connect(
     this, &Map::updateFaceTagsAfterResourcesWhereProcessed);
 
+  // editor context cache, must be invalidated after the tags were updated
+  const auto invalidateEditorContextCache = [&](auto&&...) {
+    m_editorContext->invalidateCache();
+  };
+  m_notifierConnection += mapWasCreatedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += mapWasLoadedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += mapWasClearedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesWereAddedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesWereRemovedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesWereRemovedNotifier.connect(
+    [&](const auto& nodes) { m_editorContext->removeCachedStates(nodes); });
+  m_notifierConnection += nodesDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    nodeVisibilityDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    nodeLockingDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    selectionDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += groupWasOpenedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += groupWasClosedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    brushFacesDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    resourcesWereProcessedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    entityDefinitionsDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += modsDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += commandDoneNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += commandUndoneNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    prefs.preferenceDidChangeNotifier.connect(invalidateEditorContextCache);
+
   // command processing
   m_notifierConnection +=
     m_commandProcessor->commandDoNotifier.connect(commandDoNotifier);
@@ -1406,6 +1928,10 @@ void Map::connectObservers()
     m_commandProcessor->transactionDoneNotifier.connect(transactionDoneNotifier);
   m_notifierConnection +=
     m_commandProcessor->transactionUndoneNotifier.connect(transactionUndoneNotifier);
+
+  // batched notifications, must be sent after the caches above were updated
+  m_notifierConnection +=
+    nodesDidChangeNotifier.connect(this, &Map::batchNodesDidChange);
 }
 
 void Map::mapWasCreated(Map&)
@@ -1437,6 +1963,15 @@ void Map::nodesWereRemoved(const std::vector<Node*>& nodes)
 
   m_cachedSelection = std::nullopt;
   m_cachedSelectionBounds = std::nullopt;
+
+  if (!m_batchedChangedNodes.empty())
+  {
+    const auto removedNodes =
+      kdl::vector_set<Node*>(collectNodesAndDescendants(nodes));
+    std::erase_if(m_batchedChangedNodes, [&](auto* node) {
+      return removedNodes.count(node) > 0;
+    });
+  }
 }
 
 void Map::nodesDidChange(const std::vector<Node*>& nodes)
@@ -1448,6 +1983,18 @@ void Map::nodesDidChange(const std::vector<Node*>& nodes)
   m_cachedSelectionBounds = std::nullopt;
 }
 
+void Map::batchNodesDidChange(const std::vector<Node*>& nodes)
+{
+  if (m_notificationBatchDepth == 0)
+  {
+    nodesDidChangeBatchedNotifier(nodes);
+  }
+  else
+  {
+    m_batchedChangedNodes.insert(m_batchedChangedNodes.end(), nodes.begin(), nodes.end());
+  }
+}
+
 void Map::selectionWillChange()
 {
   if (const auto currentSelectionBounds = selectionBounds())
@@ -1456,11 +2003,26 @@ void Map::selectionWillChange()
   }
 }
 
-void Map::selectionDidChange(const SelectionChange&)
+void Map::selectionDidChange(const SelectionChange& selectionChange)
 {
   m_repeatStack->clearOnNextPush();
-  m_cachedSelection = std::nullopt;
-  m_cachedSelectionBounds = std::nullopt;
+
+  if (m_cachedSelection && m_world)
+  {
+    m_cachedSelection =
+      updateSelection(std::move(*m_cachedSelection), selectionChange, *m_world);
+  }
+
+  if (!selectionChange.deselectedNodes.empty())
+  {
+    m_cachedSelectionBounds = std::nullopt;
+  }
+  else if (m_cachedSelectionBounds && !selectionChange.selectedNodes.empty())
+  {
+    // selecting nodes can only grow the selection bounds
+    m_cachedSelectionBounds = vm::merge(
+      *m_cachedSelectionBounds, computeLogicalBounds(selectionChange.selectedNodes));
+  }
 }
 
 void Map::materialCollectionsWillChange()
@@ -1470,7 +2032,18 @@ void Map::materialCollectionsWillChange()
 
 void Map::materialCollectionsDidChange()
 {
-  loadMaterials();
+  if (auto newWadPaths = wadPaths(*m_world); newWadPaths != m_wadPaths)
+  {
+    // only the materials provided by the added or removed wad files must be reloaded
+    m_wadPaths = std::move(newWadPaths);
+    reloadMaterials(m_game->reloadWads(path(), m_wadPaths, m_logger));
+  }
+  else
+  {
+    // the collections were reloaded explicitly, so the wad files are read again, too
+    m_game->reloadWads(path(), {}, m_logger);
+    loadMaterials();
+  }
   setMaterials();
   updateAllFaceTags();
 }
@@ -1490,20 +2063,31 @@ void Map::entityDefinitionsDidChange()
 
 void Map::modsWillChange()
 {
-  unsetEntityModels();
-  unsetEntityDefinitions();
-  clearEntityModels();
+  unsetMaterials();
 }
 
 void Map::modsDidChange()
 {
-  updateGameSearchPaths();
-  setEntityDefinitions();
-  setEntityModels();
+  // the entity definitions are not loaded from the game file system, so only the
+  // materials and models provided by the added or removed file systems are reloaded
+  const auto changedPaths = updateGameSearchPaths();
+  reloadMaterials(changedPaths);
+  setMaterials();
+  reloadEntityModels(changedPaths);
 }
 
 void Map::preferenceDidChange(const std::filesystem::path& path)
 {
+  if (path == Preferences::UndoMemoryBudget.path())
+  {
+    m_commandProcessor->setMemoryBudget(undoMemoryBudget());
+  }
+
+  if (path == Preferences::SlowCommandThreshold.path())
+  {
+    m_commandProcessor->setSlowCommandThreshold(slowCommandThreshold());
+  }
+
   if (m_game && m_game->isGamePathPreference(path))
   {
     const auto& gameFactory = GameFactory::instance();
@@ -29,10 +29,13 @@
 
 #include "vm/bbox.h"
 
+#include <deque>
 #include <filesystem>
+#include <iosfwd>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace kdl
@@ -44,13 +47,20 @@ namespace tb
 {
 class Color;
 class Logger;
+class MemoryReport;
 } // namespace tb
 
+namespace tb::io
+{
+class MaterialCache;
+} // namespace tb::io
+
 namespace tb::mdl
 {
 enum class MapFormat;
 enum class MapTextEncoding;
 enum class PasteType;
+enum class ResourceLoadMode;
 enum class TransactionScope;
 enum class WrapStyle;
 
@@ -69,6 +79,7 @@ class Grid;
 class GroupNode;
 class Issue;
 class LayerNode;
+class MapLoader;
 class MaterialManager;
 class Node;
 class PickResult;
@@ -82,6 +93,7 @@ class UVCoordSystemSnapshot;
 class VertexHandleManager;
 class WorldNode;
 
+struct CommandProfile;
 struct ProcessContext;
 struct SelectionChange;
 struct SoftMapBounds;
@@ -101,6 +113,10 @@ private:
   std::unique_ptr<EntityDefinitionManager> m_entityDefinitionManager;
   std::unique_ptr<EntityModelManager> m_entityModelManager;
   std::unique_ptr<MaterialManager> m_materialManager;
+  std::shared_ptr<const io::MaterialCache> m_materialCache;
+  ResourceLoadMode m_materialLoadMode;
+  // the wad files which the loaded materials were loaded from
+  std::vector<std::filesystem::path> m_wadPaths;
   std::unique_ptr<TagManager> m_tagManager;
 
   std::unique_ptr<EditorContext> m_editorContext;
@@ -130,11 +146,16 @@ private:
   std::filesystem::path m_path = DefaultDocumentName;
   size_t m_lastSaveModificationCount = 0;
   size_t m_modificationCount = 0;
+  size_t m_revision = 0;
 
   mutable std::optional<Selection> m_cachedSelection;
   mutable std::optional<vm::bbox3d> m_cachedSelectionBounds;
   std::optional<vm::bbox3d> m_lastSelectionBounds;
 
+  std::vector<bool> m_transactionBatchesNotifications;
+  size_t m_notificationBatchDepth = 0;
+  std::vector<Node*> m_batchedChangedNodes;
+
 public: // notification
   Notifier<Command&> commandDoNotifier;
   Notifier<Command&> commandDoneNotifier;
@@ -165,6 +186,13 @@ public: // notification
   Notifier<const std::vector<Node*>&> nodesWillChangeNotifier;
   Notifier<const std::vector<Node*>&> nodesDidChangeNotifier;
 
+  /**
+   * Like nodesDidChangeNotifier, but while a one-shot transaction is running, the changed
+   * nodes are collected and the observers are notified only once with all of them when
+   * the outermost such transaction ends. Meant for observers that only refresh a view.
+   */
+  Notifier<const std::vector<Node*>&> nodesDidChangeBatchedNotifier;
+
   Notifier<const std::vector<Node*>&> nodeVisibilityDidChangeNotifier;
   Notifier<const std::vector<Node*>&> nodeLockingDidChangeNotifier;
 
@@ -206,6 +234,19 @@ public: // misc
   MaterialManager& materialManager();
   const MaterialManager& materialManager() const;
 
+  /**
+   * Sets the cache used to store decoded textures between sessions. Pass nullptr to
+   * disable caching. Takes effect when materials are loaded the next time.
+   */
+  void setMaterialCache(std::shared_ptr<const io::MaterialCache> materialCache);
+
+  /**
+   * Sets whether the textures of materials are loaded when the materials are loaded or
+   * only once they are used by the map or rendered. Takes effect when materials are
+   * loaded the next time.
+   */
+  void setMaterialLoadMode(ResourceLoadMode materialLoadMode);
+
   TagManager& tagManager();
   const TagManager& tagManager() const;
 
@@ -219,6 +260,12 @@ public: // misc
   const vm::bbox3d& worldBounds() const;
   WorldNode* world() const;
 
+  /**
+   * Adds the estimated memory usage of the nodes, textures, entity models and command
+   * history of this map to the given report.
+   */
+  void addToMemoryReport(MemoryReport& report) const;
+
   MapTextEncoding encoding() const;
 
   VertexHandleManager& vertexHandles();
@@ -241,11 +288,42 @@ public: // persistence
     const vm::bbox3d& worldBounds,
     std::unique_ptr<Game> game,
     const std::filesystem::path& path);
+
+  /**
+   * Waits for the given loader to finish and replaces the current world with the loaded
+   * world. The current world is kept if loading fails or was cancelled.
+   */
+  Result<void> load(MapLoader& loader);
   Result<void> reload();
+
+  /**
+   * Reads the map file again and applies the differences to the current world as one
+   * undoable transaction, see applyChangedNodes. Unlike reload, this keeps the undo
+   * history and the assets, and only the changed nodes are updated.
+   */
+  Result<void> reloadChanges();
+
+  /**
+   * Replaces the current world with the world of the given autosave snapshot and applies
+   * the given journal to it, see findAutosaveRecovery and applyAutosaveJournal. The map
+   * keeps its path and is marked as modified, since the recovered changes have not been
+   * saved to the map file yet. The current world is kept if the snapshot cannot be read,
+   * and the map contains the world of the snapshot if the journal cannot be applied.
+   */
+  Result<void> recoverAutosave(
+    const std::filesystem::path& snapshotPath, std::string_view journal);
   void save();
   void saveAs(const std::filesystem::path& path);
   void saveTo(const std::filesystem::path& path);
+  void saveTo(std::ostream& stream);
   Result<void> exportAs(const io::ExportOptions& options) const;
+  void exportTo(std::ostream& stream) const;
+
+  /**
+   * Exports the worldspawn entity and the brushes and point entities that intersect the
+   * given bounds. Brush entities are exported with their intersecting brushes only.
+   */
+  void exportRegionTo(std::ostream& stream, const vm::bbox3d& bounds) const;
 
   void clear();
 
@@ -256,6 +334,15 @@ public: // persistence
   bool modified() const;
   size_t modificationCount() const;
 
+  /**
+   * Returns a number that changes whenever the map is modified, loaded or cleared.
+   *
+   * Unlike the modification count, which is decremented when a change is undone, the
+   * revision never returns to a previous value, so two calls that return the same
+   * revision guarantee that the map was not changed in between.
+   */
+  size_t revision() const;
+
   void incModificationCount(size_t delta = 1);
   void decModificationCount(size_t delta = 1);
 
@@ -304,6 +391,20 @@ private: // validation
 public:
   void setIssueHidden(const Issue& issue, bool hidden);
 
+public: // asset reloading
+  /**
+   * Reloads the textures of the materials with the given paths in the game file system,
+   * e.g. because the texture files were changed. The new textures are loaded in the
+   * background like any other texture.
+   */
+  void reloadChangedMaterials(const std::vector<std::filesystem::path>& materialPaths);
+
+  /**
+   * Reloads the entity models with the given paths in the game file system, e.g. because
+   * the model files were changed, and updates the entities that display them.
+   */
+  void reloadChangedEntityModels(const std::vector<std::filesystem::path>& modelPaths);
+
 private: // Asset management
   void loadAssets();
   void clearAssets();
@@ -312,6 +413,11 @@ private: // Asset management
   void clearEntityDefinitions();
 
   void reloadMaterials();
+  /**
+   * Reloads only the materials affected by the given changed files, see
+   * MaterialManager::reloadChanged.
+   */
+  void reloadMaterials(const std::vector<std::filesystem::path>& changedPaths);
   void loadMaterials();
   void clearMaterials();
 
@@ -333,7 +439,13 @@ private: // Asset management
   void unsetEntityModels();
   void unsetEntityModels(const std::vector<Node*>& nodes);
 
-  void updateGameSearchPaths();
+  /**
+   * Reloads the loaded entity models and the models of the entities whose model files
+   * are among the given changed files.
+   */
+  void reloadEntityModels(const std::vector<std::filesystem::path>& changedPaths);
+
+  std::vector<std::filesystem::path> updateGameSearchPaths();
 
 public: // resource processing
   void processResourcesSync(const ProcessContext& processContext);
@@ -351,6 +463,8 @@ public: // command processing
   bool isCommandCollationEnabled() const;
   void setIsCommandCollationEnabled(bool isCommandCollationEnabled);
 
+  const std::deque<CommandProfile>& commandProfiles() const;
+
   using RepeatableCommand = std::function<void()>;
   void pushRepeatableCommand(RepeatableCommand command);
   bool canRepeatCommands() const;
@@ -363,6 +477,14 @@ public: // command processing
   void cancelTransaction();
 
   bool isCurrentDocumentStateObservable() const;
+  bool isTransactionRunning() const;
+
+private:
+  void beginNotificationBatch();
+  void endNotificationBatch();
+  void endTransactionNotificationBatch();
+
+public:
 
   bool throwExceptionDuringCommand();
 
@@ -377,6 +499,7 @@ private: // observers
   void nodesWereAdded(const std::vector<Node*>& nodes);
   void nodesWereRemoved(const std::vector<Node*>& nodes);
   void nodesDidChange(const std::vector<Node*>& nodes);
+  void batchNodesDidChange(const std::vector<Node*>& nodes);
   void selectionWillChange();
   void selectionDidChange(const SelectionChange& selectionChange);
   void materialCollectionsWillChange();
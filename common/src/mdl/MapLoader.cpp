@@ -0,0 +1,276 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapLoader.h"
+
+#include "Logger.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "io/CompressedMapFile.h"
+#include "io/DiskIO.h"
+#include "io/MapCache.h"
+#include "io/ParserException.h"
+#include "io/ParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/Game.h"
+#include "mdl/GameConfig.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/ranges/to.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <atomic>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb::mdl
+{
+
+struct MapLoader::State
+{
+  std::atomic<double> progress = 0.0;
+  std::atomic<bool> cancelled = false;
+};
+
+namespace
+{
+
+class MapLoaderParserStatus : public io::ParserStatus
+{
+private:
+  std::shared_ptr<MapLoader::State> m_state;
+
+public:
+  MapLoaderParserStatus(Logger& logger, std::shared_ptr<MapLoader::State> state)
+    : ParserStatus{logger, ""}
+    , m_state{std::move(state)}
+  {
+  }
+
+private:
+  void doProgress(const double progress) override
+  {
+    m_state->progress = progress;
+    if (m_state->cancelled)
+    {
+      // the parsers turn this into an error and stop parsing
+      throw ParserException{"Loading was cancelled"};
+    }
+  }
+};
+
+Result<std::unique_ptr<WorldNode>> readWorld(
+  const std::string_view str,
+  const GameConfig& config,
+  const MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  const std::optional<std::filesystem::path>& cachePath,
+  io::ParserStatus& parserStatus,
+  kdl::task_manager& taskManager,
+  const std::optional<std::vector<std::string>>& loadedLayerNames,
+  const bool loadHiddenLayers)
+{
+  const auto entityPropertyConfig = EntityPropertyConfig{
+    config.entityConfig.scaleExpression, config.entityConfig.setDefaultProperties};
+
+  if (mapFormat == MapFormat::Unknown)
+  {
+    // Try all formats listed in the game config
+    const auto possibleFormats =
+      config.fileFormats | std::views::transform([](const auto& formatConfig) {
+        return formatFromName(formatConfig.format);
+      })
+      | kdl::ranges::to<std::vector>();
+
+    return io::WorldReader::tryRead(
+      str,
+      possibleFormats,
+      worldBounds,
+      entityPropertyConfig,
+      parserStatus,
+      taskManager,
+      cachePath,
+      loadedLayerNames,
+      loadHiddenLayers);
+  }
+
+  auto worldReader = io::WorldReader{str, mapFormat, entityPropertyConfig};
+  return worldReader.read(
+    worldBounds,
+    parserStatus,
+    taskManager,
+    cachePath,
+    loadedLayerNames,
+    loadHiddenLayers);
+}
+
+} // namespace
+
+Result<std::unique_ptr<WorldNode>> readMapFile(
+  const GameConfig& config,
+  const MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  const std::filesystem::path& path,
+  const std::optional<std::filesystem::path>& cachePath,
+  io::ParserStatus& parserStatus,
+  kdl::task_manager& taskManager,
+  const std::optional<std::vector<std::string>>& loadedLayerNames,
+  const bool loadHiddenLayers)
+{
+  return io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
+           auto fileReader = file->reader().buffer();
+           const auto contents = fileReader.stringView();
+           if (io::isCompressedMapFile(contents))
+           {
+             return io::decompressMapFile(contents)
+                    | kdl::and_then([&](const auto& decompressedContents) {
+                        return readWorld(
+                          decompressedContents,
+                          config,
+                          mapFormat,
+                          worldBounds,
+                          cachePath,
+                          parserStatus,
+                          taskManager,
+                          loadedLayerNames,
+                          loadHiddenLayers);
+                      });
+           }
+
+           return readWorld(
+             contents,
+             config,
+             mapFormat,
+             worldBounds,
+             cachePath,
+             parserStatus,
+             taskManager,
+             loadedLayerNames,
+             loadHiddenLayers);
+         });
+}
+
+MapLoader::MapLoader(
+  const MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  std::unique_ptr<Game> game,
+  std::filesystem::path path,
+  kdl::task_manager& taskManager,
+  Logger& logger,
+  std::optional<std::vector<std::string>> loadedLayerNames)
+  : m_mapFormat{mapFormat}
+  , m_worldBounds{worldBounds}
+  , m_game{std::move(game)}
+  , m_path{std::move(path)}
+  , m_state{std::make_shared<State>()}
+{
+  logger.info() << fmt::format("Loading document from {}", m_path);
+
+  // preferences must only be read on the main thread
+  auto cachePath = pref(Preferences::UseMapCache)
+                     ? std::optional{io::mapCachePath(m_path)}
+                     : std::nullopt;
+  const auto loadHiddenLayers = pref(Preferences::LoadHiddenLayers);
+
+  m_result = taskManager.run_task(std::function{
+    [this,
+     &taskManager,
+     &logger,
+     state = m_state,
+     cachePath = std::move(cachePath),
+     loadedLayerNames = std::move(loadedLayerNames),
+     loadHiddenLayers]() {
+      auto parserStatus = MapLoaderParserStatus{logger, state};
+      auto result = readMapFile(
+        m_game->config(),
+        m_mapFormat,
+        m_worldBounds,
+        m_path,
+        cachePath,
+        parserStatus,
+        taskManager,
+        loadedLayerNames,
+        loadHiddenLayers);
+      state->progress = 1.0;
+      return result;
+    }});
+}
+
+MapLoader::~MapLoader()
+{
+  if (m_result.valid())
+  {
+    cancel();
+    m_result.wait();
+  }
+}
+
+const vm::bbox3d& MapLoader::worldBounds() const
+{
+  return m_worldBounds;
+}
+
+const std::filesystem::path& MapLoader::path() const
+{
+  return m_path;
+}
+
+double MapLoader::progress() const
+{
+  return m_state->progress;
+}
+
+bool MapLoader::finished() const
+{
+  using namespace std::chrono_literals;
+  return !m_result.valid() || m_result.wait_for(0s) == std::future_status::ready;
+}
+
+void MapLoader::cancel()
+{
+  m_state->cancelled = true;
+}
+
+bool MapLoader::cancelled() const
+{
+  return m_state->cancelled;
+}
+
+Result<std::tuple<std::unique_ptr<WorldNode>, std::unique_ptr<Game>>> MapLoader::get()
+{
+  assert(m_result.valid());
+
+  auto result = m_result.get();
+  if (cancelled())
+  {
+    return Error{"Loading was cancelled"};
+  }
+
+  return std::move(result) | kdl::transform([&](auto worldNode) {
+           return std::tuple{std::move(worldNode), std::move(m_game)};
+         });
+}
+
+} // namespace tb::mdl
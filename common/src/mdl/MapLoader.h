@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "mdl/MapFormat.h"
+
+#include "vm/bbox.h"
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb
+{
+class Logger;
+
+namespace io
+{
+class ParserStatus;
+}
+} // namespace tb
+
+namespace tb::mdl
+{
+class Game;
+class WorldNode;
+struct GameConfig;
+
+/**
+ * Reads the map file at the given path. If the map format is unknown, all formats listed
+ * in the given game configuration are tried.
+ *
+ * If a cache path is given, the parsed map is read from or written to the map cache.
+ *
+ * If layer names are given, only the objects of the default layer and of the custom
+ * layers with these names are loaded. If hidden layers should not be loaded, the objects
+ * of hidden custom layers are not loaded either, see io::WorldReader::read.
+ *
+ * Compressed map files, see io::compressMapFile, are decompressed before they are read.
+ */
+Result<std::unique_ptr<WorldNode>> readMapFile(
+  const GameConfig& config,
+  MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  const std::filesystem::path& path,
+  const std::optional<std::filesystem::path>& cachePath,
+  io::ParserStatus& parserStatus,
+  kdl::task_manager& taskManager,
+  const std::optional<std::vector<std::string>>& loadedLayerNames = std::nullopt,
+  bool loadHiddenLayers = true);
+
+/**
+ * Reads a map file on the task manager so that the calling thread remains responsive.
+ *
+ * The progress of the parser can be queried while the map is being read, and reading can
+ * be cancelled. Once the loader has finished, pass it to Map::load to replace the world
+ * of a map with the loaded world. Materials and entity models are then loaded in the
+ * background by the map's resource processing as usual.
+ *
+ * If layer names are given, the objects of the other custom layers are not loaded. If
+ * the LoadHiddenLayers preference is off, the objects of hidden custom layers are not
+ * loaded either. They can be loaded later on with loadLayer. Layers containing groups
+ * that are linked to groups in other layers are always loaded.
+ *
+ * The destructor cancels reading and waits for the task to finish.
+ */
+class MapLoader
+{
+public:
+  struct State;
+
+private:
+  MapFormat m_mapFormat;
+  vm::bbox3d m_worldBounds;
+  std::unique_ptr<Game> m_game;
+  std::filesystem::path m_path;
+
+  std::shared_ptr<State> m_state;
+  std::future<Result<std::unique_ptr<WorldNode>>> m_result;
+
+public:
+  MapLoader(
+    MapFormat mapFormat,
+    const vm::bbox3d& worldBounds,
+    std::unique_ptr<Game> game,
+    std::filesystem::path path,
+    kdl::task_manager& taskManager,
+    Logger& logger,
+    std::optional<std::vector<std::string>> loadedLayerNames = std::nullopt);
+  ~MapLoader();
+
+  const vm::bbox3d& worldBounds() const;
+  const std::filesystem::path& path() const;
+
+  /**
+   * Returns the progress of the parser as a value between 0 and 1.
+   */
+  double progress() const;
+
+  bool finished() const;
+
+  void cancel();
+  bool cancelled() const;
+
+  /**
+   * Waits for the loader to finish and returns the loaded world together with the game.
+   * Returns an error if loading was cancelled. Can only be called once.
+   */
+  Result<std::tuple<std::unique_ptr<WorldNode>, std::unique_ptr<Game>>> get();
+};
+
+} // namespace tb::mdl
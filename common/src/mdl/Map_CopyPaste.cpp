@@ -32,6 +32,7 @@
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/LinkedGroupUtils.h"
+#include "mdl/LockState.h"
 #include "mdl/Map.h"
 #include "mdl/Map_Brushes.h"
 #include "mdl/Map_Nodes.h"
@@ -40,11 +41,13 @@
 #include "mdl/PasteType.h"
 #include "mdl/PatchNode.h"
 #include "mdl/Transaction.h"
+#include "mdl/VisibilityState.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/ranges/to.h"
 #include "kdl/vector_utils.h"
 
+#include <map>
 #include <ranges>
 
 namespace tb::mdl
@@ -237,6 +240,68 @@ bool pasteNodes(Map& map, const std::vector<Node*>& nodes)
   return true;
 }
 
+/**
+ * Removes the references to the assets of the map the nodes were copied from and resets
+ * their visibility and lock states, which are not part of the text form either.
+ */
+void resetCopiedNodes(const std::vector<std::unique_ptr<Node>>& nodes)
+{
+  const auto resetStates = [](Node* node) {
+    node->setVisibilityState(VisibilityState::Inherited);
+    node->setLockState(LockState::Inherited);
+  };
+
+  for (const auto& node : nodes)
+  {
+    node->accept(kdl::overload(
+      [](WorldNode*) {},
+      [](LayerNode*) {},
+      [&](auto&& thisLambda, GroupNode* groupNode) {
+        resetStates(groupNode);
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, EntityNode* entityNode) {
+        resetStates(entityNode);
+        entityNode->setDefinition(nullptr);
+        entityNode->setModel(nullptr);
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](BrushNode* brushNode) {
+        resetStates(brushNode);
+        for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i)
+        {
+          brushNode->setFaceMaterial(i, nullptr);
+        }
+      },
+      [&](PatchNode* patchNode) {
+        resetStates(patchNode);
+        patchNode->setMaterial(nullptr);
+      }));
+  }
+}
+
+/**
+ * The text form doesn't contain the link IDs of entities, brushes and patches, so they
+ * get new link IDs whenever it is parsed.
+ */
+void setNewLinkIds(const std::vector<Node*>& nodes)
+{
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [](WorldNode*) {},
+      [](LayerNode*) {},
+      [](auto&& thisLambda, GroupNode* groupNode) {
+        groupNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, EntityNode* entityNode) {
+        entityNode->setLinkId(generateUuid());
+        entityNode->visitChildren(thisLambda);
+      },
+      [](BrushNode* brushNode) { brushNode->setLinkId(generateUuid()); },
+      [](PatchNode* patchNode) { patchNode->setLinkId(generateUuid()); }));
+}
+
 bool pasteBrushFaces(Map& map, const std::vector<BrushFace>& faces)
 {
   assert(!faces.empty());
@@ -265,6 +330,93 @@ std::string serializeSelectedBrushFaces(Map& map)
   return stream.str();
 }
 
+CopiedNodes copySelectedNodes(Map& map)
+{
+  const auto& worldNode = *map.world();
+  const auto& worldBounds = map.worldBounds();
+
+  auto worldspawn = worldNode.entity();
+  worldspawn.setDefinition(nullptr);
+
+  auto result = CopiedNodes{
+    worldNode.mapFormat(),
+    worldBounds,
+    worldNode.entityPropertyConfig(),
+    std::move(worldspawn),
+    {},
+  };
+
+  // Assort the nodes like NodeWriter::writeNodes does so that pasting the copied nodes
+  // yields the same nodes as pasting their text form.
+  auto worldBrushes = std::vector<Node*>{};
+  auto entityBrushes = std::map<const EntityNode*, std::vector<Node*>>{};
+  auto groupsAndEntities = std::vector<Node*>{};
+  auto entities = std::vector<Node*>{};
+
+  for (auto* node : map.selection().nodes)
+  {
+    node->accept(kdl::overload(
+      [](WorldNode*) {},
+      [](LayerNode*) {},
+      [&](GroupNode* groupNode) { groupsAndEntities.push_back(groupNode); },
+      [&](EntityNode* entityNode) { entities.push_back(entityNode); },
+      [&](BrushNode* brushNode) {
+        if (const auto* entityNode = dynamic_cast<const EntityNode*>(brushNode->parent()))
+        {
+          entityBrushes[entityNode].push_back(brushNode);
+        }
+        else
+        {
+          worldBrushes.push_back(brushNode);
+        }
+      },
+      [](PatchNode*) {}));
+  }
+  groupsAndEntities = kdl::vec_concat(std::move(groupsAndEntities), std::move(entities));
+
+  auto& taskManager = map.taskManager();
+  const auto cloneNodes = [&](const auto& nodes) {
+    return Node::cloneRecursively(worldBounds, nodes, taskManager);
+  };
+
+  for (auto* clone : cloneNodes(worldBrushes))
+  {
+    result.nodes.emplace_back(clone);
+  }
+  for (const auto& [entityNode, brushNodes] : entityBrushes)
+  {
+    // the text form of a brush entity's brushes omits its protected properties
+    auto* entityClone = static_cast<EntityNode*>(entityNode->clone(worldBounds));
+    auto entity = entityClone->entity();
+    entity.setProtectedProperties({});
+    entityClone->setEntity(std::move(entity));
+    entityClone->addChildren(cloneNodes(brushNodes));
+    result.nodes.emplace_back(entityClone);
+  }
+  for (auto* clone : cloneNodes(groupsAndEntities))
+  {
+    result.nodes.emplace_back(clone);
+  }
+
+  resetCopiedNodes(result.nodes);
+  return result;
+}
+
+std::string serializeCopiedNodes(
+  const CopiedNodes& copiedNodes, kdl::task_manager& taskManager)
+{
+  const auto worldNode = WorldNode{
+    copiedNodes.entityPropertyConfig, copiedNodes.worldspawn, copiedNodes.mapFormat};
+
+  auto stream = std::stringstream{};
+  auto writer = io::NodeWriter{worldNode, stream};
+  writer.writeNodes(
+    copiedNodes.nodes | std::views::transform([](const auto& node) { return node.get(); })
+      | kdl::ranges::to<std::vector>(),
+    taskManager);
+  return stream.str();
+}
+
 PasteType paste(Map& map, const std::string& str)
 {
   auto parserStatus = io::SimpleParserStatus{map.logger()};
@@ -302,4 +454,23 @@ PasteType paste(Map& map, const std::string& str)
          | kdl::value();
 }
 
+PasteType paste(Map& map, const CopiedNodes& copiedNodes)
+{
+  if (
+    copiedNodes.mapFormat != map.world()->mapFormat()
+    || copiedNodes.worldBounds != map.worldBounds())
+  {
+    // the text form is converted to the map's format and checked against its bounds
+    return paste(map, serializeCopiedNodes(copiedNodes, map.taskManager()));
+  }
+
+  const auto nodes = Node::cloneRecursively(
+    map.worldBounds(),
+    copiedNodes.nodes | std::views::transform([](const auto& node) { return node.get(); })
+      | kdl::ranges::to<std::vector>(),
+    map.taskManager());
+  setNewLinkIds(nodes);
+  return pasteNodes(map, nodes) ? PasteType::Node : PasteType::Failed;
+}
+
 } // namespace tb::mdl
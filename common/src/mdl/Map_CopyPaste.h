@@ -19,18 +19,62 @@
 
 #pragma once
 
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
 
 namespace tb::mdl
 {
 class Map;
+class Node;
 
 enum class PasteType;
 
+/**
+ * A copy of the selected nodes that can be pasted without serializing and parsing them.
+ *
+ * The copied nodes have the same structure as the nodes parsed from the text form of the
+ * selection, and they don't reference any materials, entity definitions or entity models
+ * since the map they were copied from may be closed before they are pasted.
+ */
+struct CopiedNodes
+{
+  MapFormat mapFormat;
+  vm::bbox3d worldBounds;
+  EntityPropertyConfig entityPropertyConfig;
+  Entity worldspawn;
+  std::vector<std::unique_ptr<Node>> nodes;
+};
+
 std::string serializeSelectedNodes(Map& map);
 std::string serializeSelectedBrushFaces(Map& map);
 
+CopiedNodes copySelectedNodes(Map& map);
+
+/**
+ * Returns the text form of the given nodes, which can be pasted into any map.
+ */
+std::string serializeCopiedNodes(
+  const CopiedNodes& copiedNodes, kdl::task_manager& taskManager);
+
 PasteType paste(Map& map, const std::string& str);
 
+/**
+ * Pastes clones of the given nodes. Falls back to pasting their text form if they were
+ * copied from a map with a different format or world bounds.
+ */
+PasteType paste(Map& map, const CopiedNodes& copiedNodes);
+
 
 } // namespace tb::mdl
@@ -50,10 +50,13 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/overload.h"
+#include "kdl/ranges/to.h"
 #include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/task_manager.h"
 
+#include <mutex>
+
 namespace tb::mdl
 {
 
@@ -225,8 +228,14 @@ bool flipSelection(mdl::Map& map, const vm::vec3d& center, const vm::axis::type
 TransformVerticesResult transformVertices(
   Map& map, std::vector<vm::vec3d> vertexPositions, const vm::mat4x4d& transform)
 {
+  const auto uvLock = pref(Preferences::UVLock);
+
+  // the brushes are transformed in parallel, so the results and errors are collected
+  // under a lock; the order of the new positions doesn't matter since they are sorted
+  auto mutex = std::mutex{};
   auto newVertexPositions = std::vector<vm::vec3d>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = applyToNodeContentsInParallel(
+    map.taskManager(),
     map.selection().nodes,
     kdl::overload(
       [](Layer&) { return true; },
@@ -246,14 +255,16 @@ TransformVerticesResult transformVertices(
         }
 
         return brush.transformVertices(
-                 map.worldBounds(), verticesToMove, transform, pref(Preferences::UVLock))
+                 map.worldBounds(), verticesToMove, transform, uvLock)
                | kdl::transform([&]() {
                    auto newPositions =
                      brush.findClosestVertexPositions(transform * verticesToMove);
+                   const auto lock = std::lock_guard{mutex};
                    newVertexPositions = kdl::vec_concat(
                      std::move(newVertexPositions), std::move(newPositions));
                  })
                | kdl::if_error([&](auto e) {
+                   const auto lock = std::lock_guard{mutex};
                    map.logger().error() << "Could not move brush vertices: " << e.msg;
                  })
                | kdl::is_success();
@@ -305,8 +316,12 @@ TransformVerticesResult transformVertices(
 bool transformEdges(
   Map& map, std::vector<vm::segment3d> edgePositions, const vm::mat4x4d& transform)
 {
+  const auto uvLock = pref(Preferences::UVLock);
+
+  auto mutex = std::mutex{};
   auto newEdgePositions = std::vector<vm::segment3d>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = applyToNodeContentsInParallel(
+    map.taskManager(),
     map.selection().nodes,
     kdl::overload(
       [](Layer&) { return true; },
@@ -325,16 +340,17 @@ bool transformEdges(
           return false;
         }
 
-        return brush.transformEdges(
-                 map.worldBounds(), edgesToMove, transform, pref(Preferences::UVLock))
+        return brush.transformEdges(map.worldBounds(), edgesToMove, transform, uvLock)
                | kdl::transform([&]() {
                    auto newPositions = brush.findClosestEdgePositions(kdl::vec_transform(
                      edgesToMove,
                      [&](const auto& edge) { return edge.transform(transform); }));
+                   const auto lock = std::lock_guard{mutex};
                    newEdgePositions = kdl::vec_concat(
                      std::move(newEdgePositions), std::move(newPositions));
                  })
                | kdl::if_error([&](auto e) {
+                   const auto lock = std::lock_guard{mutex};
                    map.logger().error() << "Could not move brush edges: " << e.msg;
                  })
                | kdl::is_success();
@@ -374,8 +390,12 @@ bool transformEdges(
 bool transformFaces(
   Map& map, std::vector<vm::polygon3d> facePositions, const vm::mat4x4d& transform)
 {
+  const auto uvLock = pref(Preferences::UVLock);
+
+  auto mutex = std::mutex{};
   auto newFacePositions = std::vector<vm::polygon3d>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = applyToNodeContentsInParallel(
+    map.taskManager(),
     map.selection().nodes,
     kdl::overload(
       [](Layer&) { return true; },
@@ -394,16 +414,17 @@ bool transformFaces(
           return false;
         }
 
-        return brush.transformFaces(
-                 map.worldBounds(), facesToMove, transform, pref(Preferences::UVLock))
+        return brush.transformFaces(map.worldBounds(), facesToMove, transform, uvLock)
                | kdl::transform([&]() {
                    auto newPositions = brush.findClosestFacePositions(kdl::vec_transform(
                      facesToMove,
                      [&](const auto& face) { return face.transform(transform); }));
+                   const auto lock = std::lock_guard{mutex};
                    newFacePositions = kdl::vec_concat(
                      std::move(newFacePositions), std::move(newPositions));
                  })
                | kdl::if_error([&](auto e) {
+                   const auto lock = std::lock_guard{mutex};
                    map.logger().error() << "Could not move brush faces: " << e.msg;
                  })
                | kdl::is_success();
@@ -547,41 +568,65 @@ bool removeVertices(
 
 bool snapVertices(Map& map, const double snapTo)
 {
-  size_t succeededBrushCount = 0;
-  size_t failedBrushCount = 0;
+  const auto& allSelectedBrushes = map.selection().allBrushes();
+  if (allSelectedBrushes.empty())
+  {
+    return true;
+  }
 
-  const auto allSelectedBrushes = map.selection().allBrushes();
-  const bool applyAndSwapSuccess = applyAndSwap(
-    map,
-    "Snap Brush Vertices",
-    allSelectedBrushes,
-    collectContainingGroups(kdl::vec_static_cast<Node*>(allSelectedBrushes)),
-    kdl::overload(
-      [](Layer&) { return true; },
-      [](Group&) { return true; },
-      [](Entity&) { return true; },
-      [&](Brush& originalBrush) {
-        if (originalBrush.canSnapVertices(map.worldBounds(), snapTo))
-        {
-          originalBrush.snapVertices(map.worldBounds(), snapTo, pref(Preferences::UVLock))
-            | kdl::transform([&]() { succeededBrushCount += 1; })
-            | kdl::transform_error([&](auto e) {
-                map.logger().error() << "Could not snap vertices: " << e.msg;
-                failedBrushCount += 1;
-              });
-        }
-        else
-        {
-          failedBrushCount += 1;
-        }
-        return true;
-      },
-      [](BezierPatch&) { return true; }));
+  const auto& worldBounds = map.worldBounds();
+  const auto uvLock = pref(Preferences::UVLock);
 
-  if (!applyAndSwapSuccess)
+  // The brushes are independent of each other, so they can be snapped in parallel. A
+  // brush whose vertices cannot be snapped is left without a result.
+  auto snapResults =
+    std::vector<std::optional<Result<Brush>>>(allSelectedBrushes.size());
+  map.taskManager().parallel_for(allSelectedBrushes.size(), [&](const size_t i) {
+    const auto& originalBrush = allSelectedBrushes[i]->brush();
+    if (originalBrush.canSnapVertices(worldBounds, snapTo))
+    {
+      auto brush = originalBrush;
+      snapResults[i] = brush.snapVertices(worldBounds, snapTo, uvLock)
+                       | kdl::transform([&]() { return std::move(brush); });
+    }
+  });
+
+  auto nodesToSwap = std::vector<std::pair<Node*, NodeContents>>{};
+  nodesToSwap.reserve(allSelectedBrushes.size());
+
+  size_t failedBrushCount = 0;
+  for (size_t i = 0; i < allSelectedBrushes.size(); ++i)
   {
-    return false;
+    if (auto& snapResult = snapResults[i])
+    {
+      std::move(*snapResult) | kdl::transform([&](auto brush) {
+        nodesToSwap.emplace_back(allSelectedBrushes[i], NodeContents{std::move(brush)});
+      }) | kdl::transform_error([&](auto e) {
+        map.logger().error() << "Could not snap vertices: " << e.msg;
+        failedBrushCount += 1;
+      });
+    }
+    else
+    {
+      failedBrushCount += 1;
+    }
   }
+
+  const auto succeededBrushCount = nodesToSwap.size();
+  if (!nodesToSwap.empty())
+  {
+    auto changedLinkedGroups = collectContainingGroups(
+      kdl::vec_transform(nodesToSwap, [](const auto& p) { return p.first; }));
+    if (!updateNodeContents(
+          map,
+          "Snap Brush Vertices",
+          std::move(nodesToSwap),
+          std::move(changedLinkedGroups)))
+    {
+      return false;
+    }
+  }
+
   if (succeededBrushCount > 0)
   {
     map.logger().info() << fmt::format(
@@ -699,36 +744,47 @@ bool csgSubtract(Map& map)
   const auto subtrahends = kdl::vec_transform(
     subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
 
+  const auto mapFormat = map.world()->mapFormat();
+  const auto& worldBounds = map.worldBounds();
+  const auto materialName = map.currentMaterialName();
+
+  // The minuends are independent of each other, so they can be processed in parallel.
+  // The results are in the order of the minuends, so the resulting nodes are always added
+  // in the same order.
+  auto tasks = minuendNodes | std::views::transform([&](const auto* minuendNode) {
+                 return std::function{[&, minuendNode]() {
+                   return kdl::vec_filter(
+                            minuendNode->brush().subtract(
+                              mapFormat, worldBounds, materialName, subtrahends),
+                            [](const auto& r) { return r | kdl::is_success(); })
+                          | kdl::fold;
+                 }};
+               });
+  auto subtractionResults = map.taskManager().run_tasks_and_wait(tasks);
+
   auto toAdd = std::map<Node*, std::vector<Node*>>{};
   auto toRemove =
     std::vector<Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
 
-  return minuendNodes | std::views::transform([&](auto* minuendNode) {
-           const auto& minuend = minuendNode->brush();
-           auto currentSubtractionResults = minuend.subtract(
-             map.world()->mapFormat(),
-             map.worldBounds(),
-             map.currentMaterialName(),
-             subtrahends);
-
-           return kdl::vec_filter(
-                    std::move(currentSubtractionResults),
-                    [](const auto r) { return r | kdl::is_success(); })
-                  | kdl::fold | kdl::transform([&](auto currentBrushes) {
-                      if (!currentBrushes.empty())
-                      {
-                        auto resultNodes = kdl::vec_transform(
-                          std::move(currentBrushes),
-                          [&](auto b) { return new BrushNode{std::move(b)}; });
-                        auto& toAddForParent = toAdd[minuendNode->parent()];
-                        toAddForParent = kdl::vec_concat(
-                          std::move(toAddForParent), std::move(resultNodes));
-                      }
-
-                      toRemove.push_back(minuendNode);
-                    });
-         })
-         | kdl::fold | kdl::transform([&]() {
+  return std::views::iota(size_t(0), minuendNodes.size())
+         | std::views::transform([&](const auto i) {
+             auto* minuendNode = minuendNodes[i];
+             return std::move(subtractionResults[i])
+                    | kdl::transform([&](auto currentBrushes) {
+                        if (!currentBrushes.empty())
+                        {
+                          auto resultNodes = kdl::vec_transform(
+                            std::move(currentBrushes),
+                            [&](auto b) { return new BrushNode{std::move(b)}; });
+                          auto& toAddForParent = toAdd[minuendNode->parent()];
+                          toAddForParent = kdl::vec_concat(
+                            std::move(toAddForParent), std::move(resultNodes));
+                        }
+
+                        toRemove.push_back(minuendNode);
+                      });
+           })
+         | kdl::ranges::to<std::vector>() | kdl::fold | kdl::transform([&]() {
              deselectAll(map);
              const auto added = addNodes(map, toAdd);
              removeNodes(map, toRemove);
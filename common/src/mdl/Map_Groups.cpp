@@ -315,8 +315,8 @@ GroupNode* createLinkedDuplicate(Map& map)
   }
 
   auto* groupNode = map.selection().groups.front();
-  auto* groupNodeClone =
-    static_cast<GroupNode*>(groupNode->cloneRecursively(map.worldBounds()));
+  auto* groupNodeClone = static_cast<GroupNode*>(
+    Node::cloneRecursively(map.worldBounds(), {groupNode}, map.taskManager()).front());
   auto* suggestedParent = parentForNodes(map, {groupNode});
 
   auto transaction = Transaction{map, "Create Linked Duplicate"};
@@ -20,6 +20,10 @@
 #include "mdl/Map_Layers.h"
 
 #include "Ensure.h"
+#include "Logger.h"
+#include "io/NodeReader.h"
+#include "io/SimpleParserStatus.h"
+#include "mdl/AddRemoveNodesCommand.h"
 #include "mdl/ApplyAndSwap.h"
 #include "mdl/EditorContext.h"
 #include "mdl/Map.h"
@@ -297,4 +301,45 @@ void setOmitLayerFromExport(Map& map, LayerNode* layerNode, const bool omitFromE
   updateNodeContents(map, commandName, {{layerNode, NodeContents(std::move(layer))}}, {});
 }
 
+void loadLayer(Map& map, LayerNode* layerNode)
+{
+  ensure(canLoadLayer(layerNode), "layer is not loaded");
+
+  auto parserStatus = io::SimpleParserStatus{map.logger()};
+  io::NodeReader::readUnloadedLayer(
+    *layerNode->layer().unloadedContent(),
+    *layerNode->persistentId(),
+    map.world()->mapFormat(),
+    map.worldBounds(),
+    map.world()->entityPropertyConfig(),
+    parserStatus,
+    map.taskManager())
+    | kdl::transform([&](auto nodes) {
+        auto transaction = Transaction{map, "Load Layer"};
+
+        // the nodes keep their own visibility and lock states
+        if (!map.executeAndStore(AddRemoveNodesCommand::add(layerNode, nodes))->success())
+        {
+          transaction.cancel();
+          return;
+        }
+
+        auto layer = layerNode->layer();
+        layer.setUnloadedContent(std::nullopt);
+        updateNodeContents(
+          map, "Load Layer", {{layerNode, NodeContents(std::move(layer))}}, {});
+
+        transaction.commit();
+      })
+    | kdl::transform_error([&](const auto& e) {
+        map.logger().error() << "Could not load layer '" << layerNode->name()
+                             << "': " << e.msg;
+      });
+}
+
+bool canLoadLayer(const LayerNode* layerNode)
+{
+  return layerNode->layer().unloadedContent().has_value();
+}
+
 } // namespace tb::mdl
@@ -46,4 +46,10 @@ bool canIsolateLayers(const Map& map, const std::vector<LayerNode*>& layers);
 
 void setOmitLayerFromExport(Map& map, LayerNode* layerNode, bool omitFromExport);
 
+/**
+ * Creates the objects of a layer that was not loaded when the map was opened.
+ */
+void loadLayer(Map& map, LayerNode* layerNode);
+bool canLoadLayer(const LayerNode* layerNode);
+
 } // namespace tb::mdl
@@ -299,10 +299,15 @@ void duplicateSelectedNodes(Map& map)
   auto nodesToSelect = std::vector<Node*>{};
   auto newParentMap = std::map<Node*, Node*>{};
 
-  for (auto* original : map.selection().nodes)
+  const auto& originals = map.selection().nodes;
+  const auto clones =
+    Node::cloneRecursively(map.worldBounds(), originals, map.taskManager());
+
+  for (size_t i = 0; i < originals.size(); ++i)
   {
+    auto* original = originals[i];
+    auto* clone = clones[i];
     auto* suggestedParent = parentForNodes(map, {original});
-    auto* clone = original->cloneRecursively(map.worldBounds());
 
     if (shouldCloneParentWhenCloningNode(original))
     {
@@ -0,0 +1,414 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mdl/Map_Reload.h"
+
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/NodeContents.h"
+#include "mdl/PatchNode.h"
+#include "mdl/Selection.h"
+#include "mdl/Transaction.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/hash_utils.h"
+#include "kdl/overload.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+struct Changes
+{
+  std::vector<std::pair<Node*, NodeContents>> updatedNodes;
+  std::vector<Node*> removedNodes;
+  // the new parents of the added nodes in the map
+  std::map<Node*, std::vector<Node*>> addedNodes;
+};
+
+bool facesEqual(const BrushFace& lhs, const BrushFace& rhs)
+{
+  // the materials are not compared since they are not set on the nodes of the new world
+  return lhs.points() == rhs.points() && lhs.attributes() == rhs.attributes()
+         && lhs.uAxis() == rhs.uAxis() && lhs.vAxis() == rhs.vAxis();
+}
+
+/**
+ * Compares the contents of the given nodes, but not their children.
+ */
+bool contentsEqual(const Node& lhs, const Node& rhs)
+{
+  if (lhs.kind() != rhs.kind())
+  {
+    return false;
+  }
+
+  return lhs.accept(kdl::overload(
+    [&](const WorldNode* worldNode) {
+      return worldNode->entity() == static_cast<const WorldNode&>(rhs).entity();
+    },
+    [&](const LayerNode* layerNode) {
+      return layerNode->layer() == static_cast<const LayerNode&>(rhs).layer();
+    },
+    [&](const GroupNode* groupNode) {
+      return groupNode->group() == static_cast<const GroupNode&>(rhs).group();
+    },
+    [&](const EntityNode* entityNode) {
+      return entityNode->entity() == static_cast<const EntityNode&>(rhs).entity();
+    },
+    [&](const BrushNode* brushNode) {
+      return std::ranges::equal(
+        brushNode->brush().faces(),
+        static_cast<const BrushNode&>(rhs).brush().faces(),
+        facesEqual);
+    },
+    [&](const PatchNode* patchNode) {
+      return patchNode->patch() == static_cast<const PatchNode&>(rhs).patch();
+    }));
+}
+
+bool nodesEqual(const Node& lhs, const Node& rhs)
+{
+  const auto childrenEqual = [](const auto* lhsChild, const auto* rhsChild) {
+    return nodesEqual(*lhsChild, *rhsChild);
+  };
+  return contentsEqual(lhs, rhs)
+         && std::ranges::equal(lhs.children(), rhs.children(), childrenEqual);
+}
+
+size_t combineHash(const size_t seed, const size_t hash)
+{
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+size_t pointHash(const vm::vec3d& point)
+{
+  return kdl::hash(point.x(), point.y(), point.z());
+}
+
+/**
+ * Returns a hash of the given node and its children that is consistent with nodesEqual.
+ */
+size_t nodeHash(const Node& node)
+{
+  auto result = node.accept(kdl::overload(
+    [](const WorldNode*) { return size_t(0); },
+    [](const LayerNode* layerNode) { return kdl::hash(layerNode->layer().name()); },
+    [](const GroupNode* groupNode) { return kdl::hash(groupNode->group().name()); },
+    [](const EntityNode* entityNode) {
+      auto hash = size_t(0);
+      for (const auto& property : entityNode->entity().properties())
+      {
+        hash = combineHash(hash, kdl::hash(property.key(), property.value()));
+      }
+      return hash;
+    },
+    [](const BrushNode* brushNode) {
+      auto hash = size_t(0);
+      for (const auto& face : brushNode->brush().faces())
+      {
+        hash = combineHash(hash, kdl::hash(face.attributes().materialName()));
+        for (const auto& point : face.points())
+        {
+          hash = combineHash(hash, pointHash(point));
+        }
+      }
+      return hash;
+    },
+    [](const PatchNode* patchNode) {
+      const auto& patch = patchNode->patch();
+      auto hash = kdl::hash(patch.materialName());
+      for (const auto& point : patch.controlPoints())
+      {
+        hash = combineHash(hash, pointHash(point.xyz()));
+      }
+      return hash;
+    }));
+
+  result = combineHash(result, size_t(node.kind()));
+  for (const auto* child : node.children())
+  {
+    result = combineHash(result, nodeHash(*child));
+  }
+  return result;
+}
+
+NodeContents contents(const Node& node)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode* worldNode) { return NodeContents{worldNode->entity()}; },
+    [](const LayerNode* layerNode) { return NodeContents{layerNode->layer()}; },
+    [](const GroupNode* groupNode) { return NodeContents{groupNode->group()}; },
+    [](const EntityNode* entityNode) { return NodeContents{entityNode->entity()}; },
+    [](const BrushNode* brushNode) { return NodeContents{brushNode->brush()}; },
+    [](const PatchNode* patchNode) { return NodeContents{patchNode->patch()}; }));
+}
+
+bool isLeaf(const Node& node)
+{
+  return node.kind() == NodeKind::Brush || node.kind() == NodeKind::Patch
+         || (node.kind() == NodeKind::Entity && !node.hasChildren());
+}
+
+void diffChildren(Node& oldParent, Node& newParent, Changes& changes)
+{
+  auto oldChildrenByHash = std::unordered_multimap<size_t, Node*>{};
+  for (auto* oldChild : oldParent.children())
+  {
+    oldChildrenByHash.emplace(nodeHash(*oldChild), oldChild);
+  }
+
+  auto matchedOldChildren = std::unordered_set<Node*>{};
+  auto unmatchedNewChildren = std::vector<Node*>{};
+  for (auto* newChild : newParent.children())
+  {
+    const auto [first, last] = oldChildrenByHash.equal_range(nodeHash(*newChild));
+    const auto match = std::find_if(first, last, [&](const auto& entry) {
+      return nodesEqual(*entry.second, *newChild);
+    });
+
+    if (match != last)
+    {
+      matchedOldChildren.insert(match->second);
+      oldChildrenByHash.erase(match);
+    }
+    else
+    {
+      unmatchedNewChildren.push_back(newChild);
+    }
+  }
+
+  auto unmatchedOldChildren = std::vector<Node*>{};
+  std::ranges::copy_if(
+    oldParent.children(),
+    std::back_inserter(unmatchedOldChildren),
+    [&](auto* oldChild) { return !matchedOldChildren.contains(oldChild); });
+
+  // Pair the remaining children in order. Leaves of the same kind are updated, brush
+  // entities with the same properties are compared brush by brush.
+  const auto takeOldChild = [&](const auto& predicate) -> Node* {
+    const auto i = std::ranges::find_if(unmatchedOldChildren, [&](const auto* oldChild) {
+      return oldChild && predicate(*oldChild);
+    });
+    return i != unmatchedOldChildren.end() ? std::exchange(*i, nullptr) : nullptr;
+  };
+
+  for (auto* newChild : unmatchedNewChildren)
+  {
+    if (isLeaf(*newChild))
+    {
+      if (auto* oldChild = takeOldChild([&](const auto& candidate) {
+            return isLeaf(candidate) && candidate.kind() == newChild->kind();
+          }))
+      {
+        changes.updatedNodes.emplace_back(oldChild, contents(*newChild));
+        continue;
+      }
+    }
+    else if (newChild->kind() == NodeKind::Entity)
+    {
+      if (auto* oldChild = takeOldChild([&](const auto& candidate) {
+            return !isLeaf(candidate) && contentsEqual(candidate, *newChild);
+          }))
+      {
+        diffChildren(*oldChild, *newChild, changes);
+        continue;
+      }
+    }
+
+    changes.addedNodes[&oldParent].push_back(newChild);
+  }
+
+  std::ranges::copy_if(
+    unmatchedOldChildren,
+    std::back_inserter(changes.removedNodes),
+    [](const auto* oldChild) { return oldChild != nullptr; });
+}
+
+void diffLayer(LayerNode& oldLayerNode, LayerNode& newLayerNode, Changes& changes)
+{
+  if (!contentsEqual(oldLayerNode, newLayerNode))
+  {
+    changes.updatedNodes.emplace_back(&oldLayerNode, contents(newLayerNode));
+  }
+  diffChildren(oldLayerNode, newLayerNode, changes);
+}
+
+void diffWorld(WorldNode& oldWorldNode, WorldNode& newWorldNode, Changes& changes)
+{
+  if (!contentsEqual(oldWorldNode, newWorldNode))
+  {
+    changes.updatedNodes.emplace_back(&oldWorldNode, contents(newWorldNode));
+  }
+
+  diffLayer(*oldWorldNode.defaultLayer(), *newWorldNode.defaultLayer(), changes);
+
+  auto oldLayerNodesByName = std::unordered_map<std::string, LayerNode*>{};
+  for (auto* oldLayerNode : oldWorldNode.customLayers())
+  {
+    oldLayerNodesByName.emplace(oldLayerNode->name(), oldLayerNode);
+  }
+
+  for (auto* newLayerNode : newWorldNode.customLayers())
+  {
+    if (const auto i = oldLayerNodesByName.find(newLayerNode->name());
+        i != oldLayerNodesByName.end())
+    {
+      diffLayer(*i->second, *newLayerNode, changes);
+      oldLayerNodesByName.erase(i);
+    }
+    else
+    {
+      changes.addedNodes[&oldWorldNode].push_back(newLayerNode);
+    }
+  }
+
+  for (auto* oldLayerNode : oldWorldNode.customLayers())
+  {
+    if (oldLayerNodesByName.contains(oldLayerNode->name()))
+    {
+      changes.removedNodes.push_back(oldLayerNode);
+    }
+  }
+}
+
+/**
+ * Deselects the nodes that are updated or removed by the given changes, their brush
+ * faces and the descendants of the removed nodes. Since a group or an entity is removed
+ * together with its last child, the containers of removed nodes are deselected, too.
+ */
+void deselectChangedNodes(Map& map, const Changes& changes)
+{
+  auto changedNodes = std::unordered_set<const Node*>{};
+  for (const auto& [node, contents] : changes.updatedNodes)
+  {
+    changedNodes.insert(node);
+  }
+
+  auto removedNodes = std::unordered_set<const Node*>{};
+  for (const auto* node : changes.removedNodes)
+  {
+    removedNodes.insert(node);
+    const auto isContainer = [](const auto* parent) {
+      return parent->kind() == NodeKind::Group || parent->kind() == NodeKind::Entity;
+    };
+    for (const auto* parent = node->parent(); parent && isContainer(parent);
+         parent = parent->parent())
+    {
+      changedNodes.insert(parent);
+    }
+  }
+
+  const auto isChanged = [&](const Node* node) {
+    if (changedNodes.contains(node))
+    {
+      return true;
+    }
+    for (; node; node = node->parent())
+    {
+      if (removedNodes.contains(node))
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  const auto& selection = map.selection();
+  const auto nodesToDeselect = kdl::vec_filter(selection.nodes, isChanged);
+  const auto brushFacesToDeselect = kdl::vec_filter(
+    selection.brushFaces, [&](const auto& handle) { return isChanged(handle.node()); });
+
+  if (!nodesToDeselect.empty())
+  {
+    deselectNodes(map, nodesToDeselect);
+  }
+  if (!brushFacesToDeselect.empty())
+  {
+    deselectBrushFaces(map, brushFacesToDeselect);
+  }
+}
+
+} // namespace
+
+bool applyChangedNodes(Map& map, WorldNode& worldNode)
+{
+  auto changes = Changes{};
+  diffWorld(*map.world(), worldNode, changes);
+
+  if (
+    changes.updatedNodes.empty() && changes.removedNodes.empty()
+    && changes.addedNodes.empty())
+  {
+    return false;
+  }
+
+  // the added nodes are moved from the given world to the map
+  for (const auto& [parent, nodes] : changes.addedNodes)
+  {
+    for (auto* node : nodes)
+    {
+      node->parent()->removeChild(node);
+    }
+  }
+
+  auto transaction = Transaction{map, "Reload Changes"};
+  deselectChangedNodes(map, changes);
+
+  if (
+    !changes.updatedNodes.empty()
+    && !updateNodeContents(map, "Reload Changes", std::move(changes.updatedNodes)))
+  {
+    transaction.cancel();
+    return false;
+  }
+
+  // add before removing, since removing all children of an entity removes the entity
+  if (!changes.addedNodes.empty() && addNodes(map, changes.addedNodes).empty())
+  {
+    transaction.cancel();
+    return false;
+  }
+
+  if (!changes.removedNodes.empty())
+  {
+    removeNodes(map, changes.removedNodes);
+  }
+
+  return transaction.commit();
+}
+
+} // namespace tb::mdl
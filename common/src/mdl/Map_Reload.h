@@ -0,0 +1,40 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+namespace tb::mdl
+{
+class Map;
+class WorldNode;
+
+/**
+ * Replaces the nodes of the given map that differ from the nodes of the given world with
+ * the nodes of the given world as one undoable transaction.
+ *
+ * Layers are matched by name, and the children of each layer are matched by their
+ * content. Matched nodes are kept. Changed brushes, patches and point entities are
+ * updated. Brush entities whose properties didn't change are compared brush by brush.
+ * All other nodes, including changed groups, are removed, and the new nodes are moved
+ * from the given world to the map. The world entity is updated if it differs.
+ *
+ * Returns false if the map was not changed.
+ */
+bool applyChangedNodes(Map& map, WorldNode& worldNode);
+
+} // namespace tb::mdl
@@ -30,6 +30,8 @@
 #include "mdl/Map.h"
 #include "mdl/Map_Groups.h"
 #include "mdl/Map_Nodes.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialIndex.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
 #include "mdl/PatchNode.h"
@@ -39,6 +41,7 @@
 
 #include "kdl/ranges/to.h"
 #include "kdl/result_fold.h"
+#include "kdl/vector_utils.h"
 
 #include <ranges>
 #include <unordered_set>
@@ -46,6 +49,21 @@
 
 namespace tb::mdl
 {
+namespace
+{
+
+std::vector<BrushFaceHandle> findSelectableBrushFacesWithMaterial(
+  Map& map, const Material* material)
+{
+  return map.world()->materialIndex().findBrushFaces(material->name())
+         | std::views::filter([&](const auto& h) {
+             return h.face().material() == material
+                    && map.editorContext().selectable(*h.node(), h.face());
+           })
+         | kdl::ranges::to<std::vector>();
+}
+
+} // namespace
 
 void selectAllNodes(Map& map)
 {
@@ -87,10 +105,11 @@ void selectSiblingNodes(Map& map)
 
 void selectTouchingNodes(Map& map, const bool del)
 {
-  auto nodes = collectTouchingNodes({map.world()}, map.selection().brushes)
-               | std::views::filter(
-                 [&](const auto* node) { return map.editorContext().selectable(*node); })
-               | kdl::ranges::to<std::vector>();
+  auto nodes =
+    collectTouchingNodes(*map.world(), map.selection().brushes, map.taskManager())
+    | std::views::filter(
+      [&](const auto* node) { return map.editorContext().selectable(*node); })
+    | kdl::ranges::to<std::vector>();
 
   auto transaction = Transaction{map, "Select Touching"};
   if (del)
@@ -155,9 +174,10 @@ void selectTouchingNodes(Map& map, const vm::axis::type cameraAxis, const bool d
 
         const auto nodesToSelect =
           collectContainedNodes(
-            {map.world()}, tallBrushes | std::views::transform([](const auto& b) {
-                             return b.get();
-                           }) | kdl::ranges::to<std::vector>())
+            *map.world(),
+            tallBrushes | std::views::transform([](const auto& b) { return b.get(); })
+              | kdl::ranges::to<std::vector>(),
+            map.taskManager())
           | std::views::filter(
             [&](const auto* node) { return map.editorContext().selectable(*node); })
           | kdl::ranges::to<std::vector>();
@@ -172,10 +192,11 @@ void selectTouchingNodes(Map& map, const vm::axis::type cameraAxis, const bool d
 
 void selectContainedNodes(Map& map, const bool del)
 {
-  auto nodes = collectContainedNodes({map.world()}, map.selection().brushes)
-               | std::views::filter(
-                 [&](const auto* node) { return map.editorContext().selectable(*node); })
-               | kdl::ranges::to<std::vector>();
+  auto nodes =
+    collectContainedNodes(*map.world(), map.selection().brushes, map.taskManager())
+    | std::views::filter(
+      [&](const auto* node) { return map.editorContext().selectable(*node); })
+    | kdl::ranges::to<std::vector>();
 
   auto transaction = Transaction{map, "Select Inside"};
   if (del)
@@ -259,14 +280,12 @@ void selectNodesWithFilePosition(Map& map, const std::vector<size_t>& positions)
 
 void selectBrushesWithMaterial(Map& map, const Material* material)
 {
-  const auto brushes =
-    collectSelectableNodes(std::vector<Node*>{map.world()}, map.editorContext())
-    | std::views::filter([&](const auto& node) {
-        return std::ranges::any_of(
-          collectSelectableBrushFaces({node}, map.editorContext()),
-          [&](const auto& h) { return h.face().material() == material; });
-      })
-    | kdl::ranges::to<std::vector>();
+  // brushes in closed groups are selected by selecting the group
+  const auto brushes = kdl::vec_filter(
+    kdl::vec_sort_and_remove_duplicates(kdl::vec_transform(
+      findSelectableBrushFacesWithMaterial(map, material),
+      [](const auto& h) { return findOutermostClosedGroupOrNode(h.node()); })),
+    [&](const auto* node) { return map.editorContext().selectable(*node); });
 
   auto transaction = Transaction{map, "Select Brushes with Material"};
   deselectAll(map);
@@ -374,10 +393,7 @@ void selectBrushFaces(Map& map, const std::vector<BrushFaceHandle>& handles)
 
 void selectBrushFacesWithMaterial(Map& map, const Material* material)
 {
-  const auto faces =
-    collectSelectableBrushFaces(std::vector<Node*>{map.world()}, map.editorContext())
-    | std::views::filter([&](const auto& h) { return h.face().material() == material; })
-    | kdl::ranges::to<std::vector>();
+  const auto faces = findSelectableBrushFacesWithMaterial(map, material);
 
   auto transaction = Transaction{map, "Select Faces with Material"};
   deselectAll(map);
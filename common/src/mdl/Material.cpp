@@ -89,6 +89,66 @@ std::ostream& operator<<(std::ostream& lhs, const MaterialBlendFunc::Enable& rhs
   return lhs;
 }
 
+kdl_reflect_impl(MaterialRenderState);
+
+void applyRenderState(const MaterialRenderState& renderState)
+{
+  switch (renderState.culling)
+  {
+  case MaterialCulling::None:
+    glAssert(glDisable(GL_CULL_FACE));
+    break;
+  case MaterialCulling::Front:
+    glAssert(glCullFace(GL_FRONT));
+    break;
+  case MaterialCulling::Both:
+    glAssert(glCullFace(GL_FRONT_AND_BACK));
+    break;
+  case MaterialCulling::Default:
+  case MaterialCulling::Back:
+    break;
+  }
+
+  const auto& blendFunc = renderState.blendFunc;
+  if (blendFunc.enable != MaterialBlendFunc::Enable::UseDefault)
+  {
+    glAssert(glPushAttrib(GL_COLOR_BUFFER_BIT));
+    if (blendFunc.enable == MaterialBlendFunc::Enable::UseFactors)
+    {
+      glAssert(glBlendFunc(blendFunc.srcFactor, blendFunc.destFactor));
+    }
+    else
+    {
+      assert(blendFunc.enable == MaterialBlendFunc::Enable::DisableBlend);
+      glAssert(glDisable(GL_BLEND));
+    }
+  }
+}
+
+void restoreRenderState(const MaterialRenderState& renderState)
+{
+  if (renderState.blendFunc.enable != MaterialBlendFunc::Enable::UseDefault)
+  {
+    glAssert(glPopAttrib());
+  }
+
+  switch (renderState.culling)
+  {
+  case MaterialCulling::None:
+    glAssert(glEnable(GL_CULL_FACE));
+    break;
+  case MaterialCulling::Front:
+    glAssert(glCullFace(GL_BACK));
+    break;
+  case MaterialCulling::Both:
+    glAssert(glCullFace(GL_BACK));
+    break;
+  case MaterialCulling::Default:
+  case MaterialCulling::Back:
+    break;
+  }
+}
+
 kdl_reflect_impl(Material);
 
 Material::Material(std::string name, std::shared_ptr<TextureResource> textureResource)
@@ -107,8 +167,7 @@ Material::Material(Material&& other)
   , m_textureResource{std::move(other.m_textureResource)}
   , m_usageCount{static_cast<size_t>(other.m_usageCount)}
   , m_surfaceParms{std::move(other.m_surfaceParms)}
-  , m_culling{std::move(other.m_culling)}
-  , m_blendFunc{std::move(other.m_blendFunc)}
+  , m_renderState{std::move(other.m_renderState)}
 {
 }
 
@@ -121,8 +180,7 @@ Material& Material::operator=(Material&& other)
   m_textureResource = std::move(other.m_textureResource);
   m_usageCount = static_cast<size_t>(other.m_usageCount);
   m_surfaceParms = std::move(other.m_surfaceParms);
-  m_culling = std::move(other.m_culling);
-  m_blendFunc = std::move(other.m_blendFunc);
+  m_renderState = std::move(other.m_renderState);
   return *this;
 }
 
@@ -176,6 +234,25 @@ const TextureResource& Material::textureResource() const
   return *m_textureResource;
 }
 
+void Material::replaceTexture(Material other)
+{
+  m_textureResource = std::move(other.m_textureResource);
+  if (m_usageCount > 0)
+  {
+    m_textureResource->requestLoading();
+  }
+}
+
+void Material::requestTexture() const
+{
+  m_textureResource->requestLoading();
+}
+
+void Material::evictTexture() const
+{
+  m_textureResource->requestEviction();
+}
+
 const std::set<std::string>& Material::surfaceParms() const
 {
   return m_surfaceParms;
@@ -188,24 +265,29 @@ void Material::setSurfaceParms(std::set<std::string> surfaceParms)
 
 MaterialCulling Material::culling() const
 {
-  return m_culling;
+  return m_renderState.culling;
 }
 
 void Material::setCulling(const MaterialCulling culling)
 {
-  m_culling = culling;
+  m_renderState.culling = culling;
 }
 
 void Material::setBlendFunc(const GLenum srcFactor, const GLenum destFactor)
 {
-  m_blendFunc.enable = MaterialBlendFunc::Enable::UseFactors;
-  m_blendFunc.srcFactor = srcFactor;
-  m_blendFunc.destFactor = destFactor;
+  m_renderState.blendFunc.enable = MaterialBlendFunc::Enable::UseFactors;
+  m_renderState.blendFunc.srcFactor = srcFactor;
+  m_renderState.blendFunc.destFactor = destFactor;
 }
 
 void Material::disableBlend()
 {
-  m_blendFunc.enable = MaterialBlendFunc::Enable::DisableBlend;
+  m_renderState.blendFunc.enable = MaterialBlendFunc::Enable::DisableBlend;
+}
+
+const MaterialRenderState& Material::renderState() const
+{
+  return m_renderState;
 }
 
 size_t Material::usageCount() const
@@ -216,6 +298,7 @@ size_t Material::usageCount() const
 void Material::incUsageCount() const
 {
   ++m_usageCount;
+  m_textureResource->requestLoading();
 }
 
 void Material::decUsageCount() const
@@ -227,38 +310,9 @@ void Material::decUsageCount() const
 
 void Material::activate(const int minFilter, const int magFilter) const
 {
-  if (const auto* texture = m_textureResource->get();
-      texture && texture->activate(minFilter, magFilter))
+  if (activateTexture(minFilter, magFilter))
   {
-    switch (m_culling)
-    {
-    case MaterialCulling::None:
-      glAssert(glDisable(GL_CULL_FACE));
-      break;
-    case MaterialCulling::Front:
-      glAssert(glCullFace(GL_FRONT));
-      break;
-    case MaterialCulling::Both:
-      glAssert(glCullFace(GL_FRONT_AND_BACK));
-      break;
-    case MaterialCulling::Default:
-    case MaterialCulling::Back:
-      break;
-    }
-
-    if (m_blendFunc.enable != MaterialBlendFunc::Enable::UseDefault)
-    {
-      glAssert(glPushAttrib(GL_COLOR_BUFFER_BIT));
-      if (m_blendFunc.enable == MaterialBlendFunc::Enable::UseFactors)
-      {
-        glAssert(glBlendFunc(m_blendFunc.srcFactor, m_blendFunc.destFactor));
-      }
-      else
-      {
-        assert(m_blendFunc.enable == MaterialBlendFunc::Enable::DisableBlend);
-        glAssert(glDisable(GL_BLEND));
-      }
-    }
+    applyRenderState(m_renderState);
   }
 }
 
@@ -266,27 +320,22 @@ void Material::deactivate() const
 {
   if (const auto* texture = m_textureResource->get(); texture && texture->deactivate())
   {
-    if (m_blendFunc.enable != MaterialBlendFunc::Enable::UseDefault)
-    {
-      glAssert(glPopAttrib());
-    }
+    restoreRenderState(m_renderState);
+    glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+  }
+}
 
-    switch (m_culling)
-    {
-    case MaterialCulling::None:
-      glAssert(glEnable(GL_CULL_FACE));
-      break;
-    case MaterialCulling::Front:
-      glAssert(glCullFace(GL_BACK));
-      break;
-    case MaterialCulling::Both:
-      glAssert(glCullFace(GL_BACK));
-      break;
-    case MaterialCulling::Default:
-    case MaterialCulling::Back:
-      break;
-    }
+bool Material::activateTexture(const int minFilter, const int magFilter) const
+{
+  m_textureResource->requestLoading();
+  const auto* texture = m_textureResource->get();
+  return texture && texture->activate(minFilter, magFilter);
+}
 
+void Material::deactivateTexture() const
+{
+  if (const auto* texture = m_textureResource->get(); texture && texture->deactivate())
+  {
     glAssert(glBindTexture(GL_TEXTURE_2D, 0));
   }
 }
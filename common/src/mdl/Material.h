@@ -82,6 +82,25 @@ struct MaterialBlendFunc
 
 std::ostream& operator<<(std::ostream& lhs, const MaterialBlendFunc::Enable& rhs);
 
+/**
+ * The GL state that a material applies in addition to its texture. It is resolved from
+ * the material's Quake 3 shader when the material is loaded.
+ *
+ * Renderers can keep the state applied for consecutive materials that have equal render
+ * states instead of applying and restoring it for every material.
+ */
+struct MaterialRenderState
+{
+  MaterialCulling culling = MaterialCulling::Default;
+  MaterialBlendFunc blendFunc = {
+    MaterialBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA};
+
+  kdl_reflect_decl(MaterialRenderState, culling, blendFunc);
+};
+
+void applyRenderState(const MaterialRenderState& renderState);
+void restoreRenderState(const MaterialRenderState& renderState);
+
 class Material
 {
 private:
@@ -98,12 +117,8 @@ private:
   // those.
   std::set<std::string> m_surfaceParms;
 
-  // Quake 3 surface culling; move to materials
-  MaterialCulling m_culling = MaterialCulling::Default;
-
-  // Quake 3 blend function, move to materials
-  MaterialBlendFunc m_blendFunc = {
-    MaterialBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA};
+  // Quake 3 surface culling and blend function; move to materials
+  MaterialRenderState m_renderState;
 
   kdl_reflect_decl(
     Material,
@@ -114,8 +129,7 @@ private:
     m_textureResource,
     m_usageCount,
     m_surfaceParms,
-    m_culling,
-    m_blendFunc);
+    m_renderState);
 
 public:
   Material(std::string name, std::shared_ptr<TextureResource> textureResource);
@@ -145,11 +159,33 @@ public:
   const std::filesystem::path& relativePath() const;
   void setRelativePath(std::filesystem::path relativePath);
 
+  /**
+   * Returns the texture if it was loaded. Doesn't request loading a lazy texture, which
+   * happens when the material is in use or activated.
+   */
   const Texture* texture() const;
   Texture* texture();
 
   const TextureResource& textureResource() const;
 
+  /**
+   * Replaces the texture of this material with the texture of the given material, e.g.
+   * after the texture file was changed on disk. The new texture is requested right away
+   * if this material is in use.
+   */
+  void replaceTexture(Material other);
+
+  /**
+   * Requests loading a lazy texture without using the material, e.g. to prefetch it.
+   */
+  void requestTexture() const;
+
+  /**
+   * Requests dropping a loaded lazy texture. It will be loaded again when it is requested
+   * or the material is used.
+   */
+  void evictTexture() const;
+
   const std::set<std::string>& surfaceParms() const;
   void setSurfaceParms(std::set<std::string> surfaceParms);
 
@@ -159,12 +195,21 @@ public:
   void setBlendFunc(GLenum srcFactor, GLenum destFactor);
   void disableBlend();
 
+  const MaterialRenderState& renderState() const;
+
   size_t usageCount() const;
   void incUsageCount() const;
   void decUsageCount() const;
 
   void activate(int minFilter, int magFilter) const;
   void deactivate() const;
+
+  /**
+   * Binds the texture without applying the render state. Returns whether the texture was
+   * bound, in which case the caller is responsible for applying the render state.
+   */
+  bool activateTexture(int minFilter, int magFilter) const;
+  void deactivateTexture() const;
 };
 
 const Texture* getTexture(const Material* material);
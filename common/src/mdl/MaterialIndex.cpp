@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialIndex.h"
+
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+
+#include "kdl/string_compare.h"
+#include "kdl/string_format.h"
+
+namespace tb::mdl
+{
+
+void MaterialIndex::addBrushNode(BrushNode* node)
+{
+  for (const auto& face : node->brush().faces())
+  {
+    ++m_brushNodes[kdl::str_to_lower(face.attributes().materialName())][node];
+  }
+}
+
+void MaterialIndex::removeBrushNode(BrushNode* node)
+{
+  for (const auto& face : node->brush().faces())
+  {
+    const auto it = m_brushNodes.find(kdl::str_to_lower(face.attributes().materialName()));
+    if (it == m_brushNodes.end())
+    {
+      continue;
+    }
+
+    auto& brushNodes = it->second;
+    if (const auto nodeIt = brushNodes.find(node);
+        nodeIt != brushNodes.end() && --nodeIt->second == 0)
+    {
+      brushNodes.erase(nodeIt);
+      if (brushNodes.empty())
+      {
+        m_brushNodes.erase(it);
+      }
+    }
+  }
+}
+
+std::vector<BrushNode*> MaterialIndex::findBrushNodes(
+  const std::string& materialName) const
+{
+  auto result = std::vector<BrushNode*>{};
+  if (const auto it = m_brushNodes.find(kdl::str_to_lower(materialName));
+      it != m_brushNodes.end())
+  {
+    result.reserve(it->second.size());
+    for (const auto& [node, faceCount] : it->second)
+    {
+      result.push_back(node);
+    }
+  }
+  return result;
+}
+
+std::vector<BrushFaceHandle> MaterialIndex::findBrushFaces(
+  const std::string& materialName) const
+{
+  auto result = std::vector<BrushFaceHandle>{};
+  if (const auto it = m_brushNodes.find(kdl::str_to_lower(materialName));
+      it != m_brushNodes.end())
+  {
+    for (const auto& [node, faceCount] : it->second)
+    {
+      const auto& faces = node->brush().faces();
+      for (size_t i = 0; i < faces.size(); ++i)
+      {
+        if (kdl::ci::str_is_equal(faces[i].attributes().materialName(), materialName))
+        {
+          result.emplace_back(node, i);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+size_t MaterialIndex::faceCount(const std::string& materialName) const
+{
+  auto result = size_t(0);
+  if (const auto it = m_brushNodes.find(kdl::str_to_lower(materialName));
+      it != m_brushNodes.end())
+  {
+    for (const auto& [node, faceCount] : it->second)
+    {
+      result += faceCount;
+    }
+  }
+  return result;
+}
+
+} // namespace tb::mdl
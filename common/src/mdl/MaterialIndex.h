@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushFaceHandle;
+class BrushNode;
+
+/**
+ * Maps material names to the brush nodes that have faces with these materials.
+ *
+ * Material names are compared case insensitively, just like the material manager does
+ * when it resolves the material of a face.
+ */
+class MaterialIndex
+{
+private:
+  /**
+   * For every material name, the brush nodes that use it and the number of their faces
+   * that use it.
+   */
+  std::unordered_map<std::string, std::unordered_map<BrushNode*, size_t>> m_brushNodes;
+
+public:
+  void addBrushNode(BrushNode* node);
+  void removeBrushNode(BrushNode* node);
+
+  /**
+   * Returns the brush nodes that have at least one face with the given material, in no
+   * particular order.
+   */
+  std::vector<BrushNode*> findBrushNodes(const std::string& materialName) const;
+
+  /**
+   * Returns the faces with the given material, in no particular order.
+   */
+  std::vector<BrushFaceHandle> findBrushFaces(const std::string& materialName) const;
+
+  /**
+   * Returns the number of faces with the given material.
+   */
+  size_t faceCount(const std::string& materialName) const;
+};
+
+} // namespace tb::mdl
@@ -20,12 +20,15 @@
 #include "MaterialManager.h"
 
 #include "Logger.h"
+#include "Trace.h"
 #include "io/LoadMaterialCollections.h"
 #include "mdl/Material.h"
 #include "mdl/MaterialCollection.h"
 
 #include "kdl/const_overload.h"
 #include "kdl/map_utils.h"
+#include "kdl/path_hash.h"
+#include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
 #include "kdl/vector_utils.h"
@@ -33,6 +36,7 @@
 #include <algorithm>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
@@ -49,10 +53,14 @@ void MaterialManager::reload(
   const io::FileSystem& fs,
   const MaterialConfig& materialConfig,
   const CreateTextureResource& createResource,
-  kdl::task_manager& taskManager)
+  kdl::task_manager& taskManager,
+  const std::shared_ptr<const io::MaterialCache>& materialCache)
 {
+  TB_TRACE_SCOPE("MaterialManager::reload");
+
   clear();
-  io::loadMaterialCollections(fs, materialConfig, createResource, taskManager, m_logger)
+  io::loadMaterialCollections(
+    fs, materialConfig, createResource, taskManager, m_logger, materialCache)
     | kdl::transform([&](auto materialCollections) {
         for (auto& collection : materialCollections)
         {
@@ -65,6 +73,82 @@ void MaterialManager::reload(
       });
 }
 
+void MaterialManager::reloadChanged(
+  const std::vector<std::filesystem::path>& changedPaths,
+  const io::FileSystem& fs,
+  const MaterialConfig& materialConfig,
+  const CreateTextureResource& createResource,
+  kdl::task_manager& taskManager,
+  const std::shared_ptr<const io::MaterialCache>& materialCache)
+{
+  TB_TRACE_SCOPE("MaterialManager::reloadChanged");
+
+  auto collections = std::exchange(m_collections, {});
+  clear();
+  io::reloadMaterialCollections(
+    std::move(collections),
+    changedPaths,
+    fs,
+    materialConfig,
+    createResource,
+    taskManager,
+    m_logger,
+    materialCache)
+    | kdl::transform([&](auto materialCollections) {
+        for (auto& collection : materialCollections)
+        {
+          addMaterialCollection(std::move(collection));
+        }
+        updateMaterials();
+      })
+    | kdl::transform_error([&](auto e) {
+        m_logger.error() << "Could not reload material collections: " + e.msg;
+      });
+}
+
+std::vector<const Material*> MaterialManager::reloadTextures(
+  const std::vector<std::filesystem::path>& paths,
+  const io::FileSystem& fs,
+  const MaterialConfig& materialConfig,
+  const CreateTextureResource& createResource,
+  const std::shared_ptr<const io::MaterialCache>& materialCache)
+{
+  const auto lowerCasePaths = kdl::vec_transform(paths, kdl::path_to_lower);
+  const auto pathSet = std::unordered_set<std::filesystem::path, kdl::path_hash>{
+    lowerCasePaths.begin(), lowerCasePaths.end()};
+
+  const auto palette = io::loadPalette(fs, materialConfig);
+
+  auto result = std::vector<const Material*>{};
+  for (auto& collection : m_collections)
+  {
+    for (auto& material : collection.materials())
+    {
+      if (pathSet.contains(kdl::path_to_lower(material.relativePath())))
+      {
+        io::loadMaterial(
+          fs,
+          materialConfig,
+          material.relativePath(),
+          createResource,
+          {},
+          palette,
+          materialCache)
+          | kdl::transform([&](auto reloadedMaterial) {
+              material.replaceTexture(std::move(reloadedMaterial));
+              result.push_back(&material);
+              m_logger.debug() << "Reloaded material " << material.name();
+            })
+          | kdl::transform_error([&](auto e) {
+              m_logger.error() << "Could not reload material " << material.name() << ": "
+                               << e.msg;
+            });
+      }
+    }
+  }
+  return result;
+}
+
 void MaterialManager::setMaterialCollections(std::vector<MaterialCollection> collections)
 {
   for (auto& collection : collections)
@@ -22,6 +22,8 @@
 #include "mdl/MaterialCollection.h"
 #include "mdl/TextureResource.h"
 
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -38,6 +40,7 @@ class Logger;
 namespace io
 {
 class FileSystem;
+class MaterialCache;
 } // namespace io
 
 namespace mdl
@@ -69,7 +72,36 @@ public:
     const io::FileSystem& fs,
     const MaterialConfig& materialConfig,
     const CreateTextureResource& createResource,
-    kdl::task_manager& taskManager);
+    kdl::task_manager& taskManager,
+    const std::shared_ptr<const io::MaterialCache>& materialCache = nullptr);
+
+  /**
+   * Reloads the material collections after the files with the given paths were added to
+   * or removed from the given file system, e.g. because wad files or mods were mounted or
+   * unmounted. Materials that are not affected are kept along with their textures, but
+   * all materials may be moved, so they must be unset from the faces beforehand.
+   */
+  void reloadChanged(
+    const std::vector<std::filesystem::path>& changedPaths,
+    const io::FileSystem& fs,
+    const MaterialConfig& materialConfig,
+    const CreateTextureResource& createResource,
+    kdl::task_manager& taskManager,
+    const std::shared_ptr<const io::MaterialCache>& materialCache = nullptr);
+
+  /**
+   * Reloads the textures of the materials whose relative paths match one of the given
+   * paths, e.g. because the texture files were changed. The materials themselves remain
+   * in place, so faces using them need not be updated.
+   *
+   * Returns the materials whose textures were reloaded.
+   */
+  std::vector<const Material*> reloadTextures(
+    const std::vector<std::filesystem::path>& paths,
+    const io::FileSystem& fs,
+    const MaterialConfig& materialConfig,
+    const CreateTextureResource& createResource,
+    const std::shared_ptr<const io::MaterialCache>& materialCache = nullptr);
 
   // for testing
   void setMaterialCollections(std::vector<MaterialCollection> collections);
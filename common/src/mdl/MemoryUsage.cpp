@@ -0,0 +1,189 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryUsage.h"
+
+#include "MemoryReport.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushGeometry.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Issue.h"
+#include "mdl/LayerNode.h"
+#include "mdl/NodeContents.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+
+#include <variant>
+
+namespace tb::mdl
+{
+
+size_t memoryUsage(const Entity& entity)
+{
+  auto result = sizeof(Entity);
+  for (const auto& property : entity.properties())
+  {
+    result += sizeof(EntityProperty) + property.key().capacity()
+              + property.value().capacity();
+  }
+  return result;
+}
+
+size_t memoryUsage(const Brush& brush)
+{
+  auto result = sizeof(Brush);
+  for (const auto& face : brush.faces())
+  {
+    result += sizeof(BrushFace) + face.attributes().materialName().capacity();
+  }
+
+  // the geometry may be shared with other copies of the brush, but we cannot know
+  // whether those copies outlive this one, so it is always counted
+  result += geometryMemoryUsage(brush);
+  return result;
+}
+
+size_t geometryMemoryUsage(const Brush& brush)
+{
+  return sizeof(BrushGeometry) + brush.vertexCount() * sizeof(BrushVertex)
+         + brush.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge))
+         + brush.faceCount() * sizeof(BrushFaceGeometry);
+}
+
+size_t memoryUsage(const BezierPatch& patch)
+{
+  return sizeof(BezierPatch) + patch.controlPoints().size() * sizeof(BezierPatch::Point)
+         + patch.materialName().capacity();
+}
+
+size_t memoryUsage(const NodeContents& contents)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer& layer) { return sizeof(Layer) + layer.name().capacity(); },
+      [](const Group& group) { return sizeof(Group) + group.name().capacity(); },
+      [](const auto& object) { return memoryUsage(object); }),
+    contents.get());
+}
+
+size_t memoryUsage(const Issue& issue)
+{
+  return sizeof(Issue) + issue.description().capacity();
+}
+
+size_t memoryUsage(const Node& node)
+{
+  auto result = size_t(0);
+  node.accept(kdl::overload(
+    [&](auto&& thisLambda, const WorldNode* worldNode) {
+      result += sizeof(WorldNode) + memoryUsage(worldNode->entity());
+      worldNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const LayerNode* layerNode) {
+      result += sizeof(LayerNode) + layerNode->layer().name().capacity();
+      layerNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const GroupNode* groupNode) {
+      result += sizeof(GroupNode) + groupNode->group().name().capacity();
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const EntityNode* entityNode) {
+      result += sizeof(EntityNode) + memoryUsage(entityNode->entity());
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](const BrushNode* brushNode) {
+      result += sizeof(BrushNode) + memoryUsage(brushNode->brush());
+    },
+    [&](const PatchNode* patchNode) {
+      result += sizeof(PatchNode) + memoryUsage(patchNode->patch());
+    }));
+  return result;
+}
+
+void addToMemoryReport(const Node& node, MemoryReport& report)
+{
+  auto nodeBytes = size_t(0);
+  auto nodeCount = size_t(0);
+  auto propertyBytes = size_t(0);
+  auto propertyCount = size_t(0);
+  auto geometryBytes = size_t(0);
+  auto geometryCount = size_t(0);
+  auto issueBytes = size_t(0);
+  auto issueCount = size_t(0);
+
+  const auto addNode = [&](const Node& n, const size_t bytes) {
+    nodeBytes += bytes;
+    ++nodeCount;
+
+    for (const auto* issue : n.cachedIssues())
+    {
+      issueBytes += memoryUsage(*issue);
+      ++issueCount;
+    }
+  };
+
+  const auto addEntity = [&](const Entity& entity) {
+    propertyBytes += memoryUsage(entity);
+    propertyCount += entity.properties().size();
+  };
+
+  node.accept(kdl::overload(
+    [&](auto&& thisLambda, const WorldNode* worldNode) {
+      addNode(*worldNode, sizeof(WorldNode));
+      addEntity(worldNode->entity());
+      worldNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const LayerNode* layerNode) {
+      addNode(*layerNode, sizeof(LayerNode) + layerNode->layer().name().capacity());
+      layerNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const GroupNode* groupNode) {
+      addNode(*groupNode, sizeof(GroupNode) + groupNode->group().name().capacity());
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const EntityNode* entityNode) {
+      addNode(*entityNode, sizeof(EntityNode));
+      addEntity(entityNode->entity());
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](const BrushNode* brushNode) {
+      const auto& brush = brushNode->brush();
+      const auto brushGeometryBytes = geometryMemoryUsage(brush);
+      addNode(*brushNode, sizeof(BrushNode) + memoryUsage(brush) - brushGeometryBytes);
+      geometryBytes += brushGeometryBytes;
+      ++geometryCount;
+    },
+    [&](const PatchNode* patchNode) {
+      addNode(*patchNode, sizeof(PatchNode) + memoryUsage(patchNode->patch()));
+    }));
+
+  report.add("Nodes", nodeBytes, nodeCount);
+  report.add("Entity properties", propertyBytes, propertyCount);
+  report.add("Brush geometry", geometryBytes, geometryCount);
+  report.add("Issues", issueBytes, issueCount);
+}
+
+} // namespace tb::mdl
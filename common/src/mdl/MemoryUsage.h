@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace tb
+{
+class MemoryReport;
+}
+
+namespace tb::mdl
+{
+class BezierPatch;
+class Brush;
+class Entity;
+class Issue;
+class Node;
+class NodeContents;
+
+/**
+ * Functions to estimate the number of bytes occupied by the given objects, including the
+ * memory they own on the heap. The estimates ignore allocator overhead and are meant to
+ * be used for enforcing memory budgets, not for exact accounting.
+ */
+
+size_t memoryUsage(const Entity& entity);
+size_t memoryUsage(const Brush& brush);
+size_t memoryUsage(const BezierPatch& patch);
+size_t memoryUsage(const NodeContents& contents);
+size_t memoryUsage(const Issue& issue);
+
+/**
+ * Estimates the memory usage of the vertices, edges and faces of the given brush's
+ * geometry.
+ */
+size_t geometryMemoryUsage(const Brush& brush);
+
+/**
+ * Estimates the memory usage of the given node and all of its descendants.
+ */
+size_t memoryUsage(const Node& node);
+
+/**
+ * Adds the estimated memory usage of the given node and all of its descendants to the
+ * given report. Entity properties, brush geometry and cached issues are reported
+ * separately from the nodes that own them.
+ */
+void addToMemoryReport(const Node& node, MemoryReport& report);
+
+} // namespace tb::mdl
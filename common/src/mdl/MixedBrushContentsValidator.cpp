@@ -48,11 +48,16 @@ void MixedBrushContentsValidator::doValidate(
   auto end = std::end(faces);
   assert(it != end);
 
-  const auto contentFlags = it->resolvedSurfaceContents();
+  const auto& firstFace = *it;
+  const auto contentFlags = firstFace.resolvedSurfaceContents();
   ++it;
   while (it != end)
   {
-    if (it->resolvedSurfaceContents() != contentFlags)
+    // faces with shared attributes and the same material have the same content flags
+    const auto sameContents =
+      it->material() == firstFace.material()
+      && it->attributes().sharesData(firstFace.attributes());
+    if (!sameContents && it->resolvedSurfaceContents() != contentFlags)
     {
       issues.push_back(
         std::make_unique<Issue>(Type, brushNode, "Brush has mixed content flags"));
@@ -28,8 +28,12 @@
 
 #include "kdl/ranges/to.h"
 #include "kdl/stable_remove_duplicates.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -227,29 +231,23 @@ std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>&
 
 /**
  * Recursively collect brushes and entities from the given vector of node trees such that
- * the returned nodes match the given predicate. A matching brush is only returned if it
- * isn't in the given vector brushes. A node matches the given predicate if there is a
- * brush in the given vector of brushes such that the predicate evaluates to true for that
- * pair of node and brush.
+ * the returned nodes are candidates for matching. A brush is only returned if it isn't in
+ * the given vector brushes.
  *
- * The given predicate must be a function that maps a node and a brush to true or false.
+ * The given candidate filter must be a function that maps a node to true or false.
  */
-template <typename P>
-static std::vector<Node*> collectMatchingNodes(
+template <typename C>
+static std::vector<Node*> collectCandidateNodes(
   const std::vector<Node*>& nodes,
   const std::vector<BrushNode*>& brushes,
-  const P& predicate)
+  const C& isCandidate)
 {
   auto result = std::vector<Node*>{};
 
-  const auto collectIfMatching = [&](auto* node) {
-    for (const auto* brush : brushes)
+  const auto collectIfCandidate = [&](auto* node) {
+    if (isCandidate(node))
     {
-      if (predicate(node, brush))
-      {
-        result.push_back(node);
-        return;
-      }
+      result.push_back(node);
     }
   };
 
@@ -265,7 +263,7 @@ static std::vector<Node*> collectMatchingNodes(
         }
         else
         {
-          collectIfMatching(group);
+          collectIfCandidate(group);
         }
       },
       [&](auto&& thisLambda, EntityNode* entity) {
@@ -275,25 +273,105 @@ static std::vector<Node*> collectMatchingNodes(
         }
         else
         {
-          collectIfMatching(entity);
+          collectIfCandidate(entity);
         }
       },
       [&](BrushNode* brush) {
         // if `brush` is one of the search query nodes, don't count it as touching
         if (!kdl::vec_contains(brushes, brush))
         {
-          collectIfMatching(brush);
+          collectIfCandidate(brush);
         }
       },
       [&](PatchNode* patch) {
         // if `patch` is one of the search query nodes, don't count it as touching
-        collectIfMatching(patch);
+        collectIfCandidate(patch);
       }));
   }
 
   return result;
 }
 
+/**
+ * Recursively collect brushes and entities from the given vector of node trees such that
+ * the returned nodes match the given predicate. A matching brush is only returned if it
+ * isn't in the given vector brushes. A node matches the given predicate if there is a
+ * brush in the given vector of brushes such that the predicate evaluates to true for that
+ * pair of node and brush.
+ *
+ * The given predicate must be a function that maps a node and a brush to true or false.
+ */
+template <typename P>
+static std::vector<Node*> collectMatchingNodes(
+  const std::vector<Node*>& nodes,
+  const std::vector<BrushNode*>& brushes,
+  const P& predicate)
+{
+  return collectCandidateNodes(nodes, brushes, [&](const auto* node) {
+    return std::ranges::any_of(
+      brushes, [&](const auto* brush) { return predicate(node, brush); });
+  });
+}
+
+/**
+ * Like collectMatchingNodes, but only the nodes whose bounds intersect with the bounds of
+ * one of the given brushes are tested, and they are tested in parallel.
+ *
+ * The candidates are found by querying the given world's node tree. Since groups are not
+ * stored in the node tree, closed groups are candidates if their bounds intersect with
+ * the bounds of one of the given brushes.
+ *
+ * The given predicate must imply that the bounds of the node and the brush intersect.
+ */
+template <typename P>
+static std::vector<Node*> collectMatchingNodes(
+  WorldNode& world,
+  const std::vector<BrushNode*>& brushes,
+  const P& predicate,
+  kdl::task_manager& taskManager)
+{
+  auto treeCandidates = std::unordered_set<const Node*>{};
+  for (const auto* brush : brushes)
+  {
+    world.nodeTree().find_intersectors(
+      brush->logicalBounds(), std::inserter(treeCandidates, treeCandidates.end()));
+  }
+
+  // this also validates the cached bounds of the candidates, which must not happen
+  // concurrently below
+  const auto intersectsAnyBrush = [&](const Node* node) {
+    return std::ranges::any_of(brushes, [&](const auto* brush) {
+      return brush->logicalBounds().intersects(node->logicalBounds());
+    });
+  };
+
+  const auto candidates = collectCandidateNodes({&world}, brushes, [&](auto* node) {
+    return (node->accept(kdl::overload(
+              [](const GroupNode*) { return true; },
+              [&](const Node* n) { return treeCandidates.contains(n); }))
+            && intersectsAnyBrush(node));
+  });
+
+  auto matches = std::vector<char>(candidates.size(), false);
+  taskManager.parallel_for(candidates.size(), [&](const size_t i) {
+    const auto* node = candidates[i];
+    matches[i] = std::ranges::any_of(brushes, [&](const auto* brush) {
+      return brush->logicalBounds().intersects(node->logicalBounds())
+             && predicate(node, brush);
+    });
+  });
+
+  auto result = std::vector<Node*>{};
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    if (matches[i])
+    {
+      result.push_back(candidates[i]);
+    }
+  }
+  return result;
+}
+
 std::vector<Node*> collectTouchingNodes(
   const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes)
 {
@@ -302,6 +380,18 @@ std::vector<Node*> collectTouchingNodes(
   });
 }
 
+std::vector<Node*> collectTouchingNodes(
+  WorldNode& world,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager)
+{
+  return collectMatchingNodes(
+    world,
+    brushes,
+    [](const auto* node, const auto* brush) { return brush->intersects(node); },
+    taskManager);
+}
+
 std::vector<Node*> collectContainedNodes(
   const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes)
 {
@@ -310,6 +400,18 @@ std::vector<Node*> collectContainedNodes(
   });
 }
 
+std::vector<Node*> collectContainedNodes(
+  WorldNode& world,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager)
+{
+  return collectMatchingNodes(
+    world,
+    brushes,
+    [](const auto* node, const auto* brush) { return brush->contains(node); },
+    taskManager);
+}
+
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes)
 {
   return collectNodesAndDescendants(
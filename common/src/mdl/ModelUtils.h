@@ -27,6 +27,11 @@
 #include <map>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 
@@ -36,6 +41,7 @@ class GroupNode;
 class BrushNode;
 class EntityNode;
 class LayerNode;
+class WorldNode;
 class EditorContext;
 
 HitType::Type nodeHitType();
@@ -84,6 +90,19 @@ std::vector<Node*> collectTouchingNodes(
 std::vector<Node*> collectContainedNodes(
   const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
 
+/**
+ * Returns the same nodes as the overloads above when called with the given world, but
+ * uses the world's node tree to find candidates and tests the candidates in parallel.
+ */
+std::vector<Node*> collectTouchingNodes(
+  WorldNode& world,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager);
+std::vector<Node*> collectContainedNodes(
+  WorldNode& world,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager);
+
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 
 std::vector<Node*> collectSelectableNodes(
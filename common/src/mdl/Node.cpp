@@ -24,14 +24,18 @@
 #include "mdl/EntityProperties.h"
 #include "mdl/Issue.h"
 #include "mdl/Validator.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/const_overload.h"
 #include "kdl/range_utils.h"
 #include "kdl/reflection_impl.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <cassert>
 #include <iterator>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,11 +44,56 @@ namespace tb::mdl
 
 kdl_reflect_impl(NodePath);
 
-Node::Node() = default;
+namespace
+{
+
+class DenseIdPool
+{
+private:
+  std::mutex m_mutex;
+  size_t m_nextId = 0;
+  std::vector<size_t> m_freeIds;
+
+public:
+  size_t acquire()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (m_freeIds.empty())
+    {
+      return m_nextId++;
+    }
+
+    const auto id = m_freeIds.back();
+    m_freeIds.pop_back();
+    return id;
+  }
+
+  void release(const size_t id)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_freeIds.push_back(id);
+  }
+};
+
+// nodes are created on worker threads when loading maps
+DenseIdPool& denseIdPool()
+{
+  static auto pool = DenseIdPool{};
+  return pool;
+}
+
+} // namespace
+
+Node::Node(const NodeKind kind)
+  : m_kind{kind}
+  , m_denseId{denseIdPool().acquire()}
+{
+}
 
 Node::~Node()
 {
   clearChildren();
+  denseIdPool().release(m_denseId);
 }
 
 const std::string& Node::name() const
@@ -52,6 +101,11 @@ const std::string& Node::name() const
   return doGetName();
 }
 
+size_t Node::denseId() const
+{
+  return m_denseId;
+}
+
 NodePath Node::pathFrom(const Node& ancestor) const
 {
   auto result = NodePath{};
@@ -143,6 +197,69 @@ std::vector<Node*> Node::cloneRecursively(
   return clones;
 }
 
+std::vector<Node*> Node::cloneRecursively(
+  const vm::bbox3d& worldBounds,
+  const std::vector<Node*>& nodes,
+  kdl::task_manager& taskManager)
+{
+  struct NodeToClone
+  {
+    const Node* node;
+    std::optional<size_t> parentIndex;
+  };
+
+  // Collect the nodes in pre-order so that every node comes after its parent. Worlds
+  // clone their children into their default layer, so they are cloned as a whole.
+  auto nodesToClone = std::vector<NodeToClone>{};
+  const auto collect =
+    [&](auto&& self, const Node* node, const std::optional<size_t> parentIndex) -> void {
+    const auto index = nodesToClone.size();
+    nodesToClone.push_back({node, parentIndex});
+    if (!dynamic_cast<const WorldNode*>(node))
+    {
+      for (const auto* child : node->children())
+      {
+        self(self, child, index);
+      }
+    }
+  };
+
+  auto rootIndices = std::vector<size_t>{};
+  rootIndices.reserve(nodes.size());
+  for (const auto* node : nodes)
+  {
+    rootIndices.push_back(nodesToClone.size());
+    collect(collect, node, std::nullopt);
+  }
+
+  auto clones = std::vector<Node*>(nodesToClone.size());
+  taskManager.parallel_for(nodesToClone.size(), [&](const size_t i) {
+    const auto* node = nodesToClone[i].node;
+    clones[i] = dynamic_cast<const WorldNode*>(node)
+                  ? node->cloneRecursively(worldBounds)
+                  : node->clone(worldBounds);
+  });
+
+  // Add the clones to their parents bottom up, like cloneRecursively does.
+  auto cloneChildren = std::vector<std::vector<Node*>>(nodesToClone.size());
+  for (size_t i = 0; i < nodesToClone.size(); ++i)
+  {
+    if (const auto parentIndex = nodesToClone[i].parentIndex)
+    {
+      cloneChildren[*parentIndex].push_back(clones[i]);
+    }
+  }
+  for (size_t i = nodesToClone.size(); i > 0; --i)
+  {
+    if (!cloneChildren[i - 1].empty())
+    {
+      clones[i - 1]->addChildren(cloneChildren[i - 1]);
+    }
+  }
+
+  return kdl::vec_transform(rootIndices, [&](const auto i) { return clones[i]; });
+}
+
 size_t Node::depth() const
 {
   return m_parent ? m_parent->depth() + 1 : 0;
@@ -812,6 +929,17 @@ std::vector<const Issue*> Node::issues(const std::vector<const Validator*>& vali
     m_issues, [](const auto& issue) { return const_cast<const Issue*>(issue.get()); });
 }
 
+bool Node::issuesValid() const
+{
+  return m_issuesValid;
+}
+
+std::vector<const Issue*> Node::cachedIssues() const
+{
+  return kdl::vec_transform(
+    m_issues, [](const auto& issue) { return const_cast<const Issue*>(issue.get()); });
+}
+
 bool Node::issueHidden(const IssueType type) const
 {
   return (type & m_hiddenIssues) != 0;
@@ -829,6 +957,14 @@ void Node::setIssueHidden(const IssueType type, const bool hidden)
   }
 }
 
+void Node::renumberIssues()
+{
+  for (auto& issue : m_issues)
+  {
+    issue->renumber();
+  }
+}
+
 void Node::validateIssues(const std::vector<const Validator*>& validators)
 {
   if (!m_issuesValid)
@@ -36,6 +36,11 @@
 #include <string>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 
@@ -56,9 +61,24 @@ struct NodePath
   kdl_reflect_decl(NodePath, indices);
 };
 
+/**
+ * Identifies the concrete type of a node. Allows traversals to dispatch on the node
+ * type without a virtual call, see visitNodes in NodeQueries.h.
+ */
+enum class NodeKind
+{
+  World,
+  Layer,
+  Group,
+  Entity,
+  Brush,
+  Patch,
+};
+
 class Node : public Taggable
 {
 private:
+  NodeKind m_kind;
   Node* m_parent = nullptr;
   std::vector<Node*> m_children;
   size_t m_descendantCount = 0;
@@ -78,8 +98,10 @@ private:
   mutable bool m_issuesValid = false;
   IssueType m_hiddenIssues = 0;
 
+  size_t m_denseId;
+
 protected:
-  Node();
+  explicit Node(NodeKind kind);
 
 private:
   Node(const Node&);
@@ -89,8 +111,17 @@ public:
   ~Node() override;
 
 public: // getters
+  NodeKind kind() const { return m_kind; }
+
   const std::string& name() const;
 
+  /**
+   * Returns an id that is unique among all living nodes. The ids are dense and are
+   * recycled when a node is destroyed, so they can be used to index side tables, see
+   * NodeSlotMap.
+   */
+  size_t denseId() const;
+
   /**
    * Returns a path from the given ancestor to this node.
    *
@@ -132,6 +163,15 @@ public: // cloning and snapshots
   Node* clone(const vm::bbox3d& worldBounds) const;
   Node* cloneRecursively(const vm::bbox3d& worldBounds) const;
 
+  /**
+   * Clones the given nodes and their descendants. The nodes are cloned individually in
+   * parallel, and the clones are assembled into the same trees afterwards.
+   */
+  static std::vector<Node*> cloneRecursively(
+    const vm::bbox3d& worldBounds,
+    const std::vector<Node*>& nodes,
+    kdl::task_manager& taskManager);
+
 protected:
   void cloneAttributes(Node& node) const;
 
@@ -351,9 +391,25 @@ public: // file position
 public: // issue management
   std::vector<const Issue*> issues(const std::vector<const Validator*>& validators);
 
+  /**
+   * Indicates whether the issues of this node are cached, i.e. whether the node was
+   * validated since it last changed.
+   */
+  bool issuesValid() const;
+
+  /**
+   * Returns the cached issues of this node without validating it.
+   */
+  std::vector<const Issue*> cachedIssues() const;
+
   bool issueHidden(IssueType type) const;
   void setIssueHidden(IssueType type, bool hidden);
 
+  /**
+   * Assigns new sequence IDs to the cached issues of this node.
+   */
+  void renumberIssues();
+
 public: // should only be called from this and from the world
   void invalidateIssues() const;
 
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Macros.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushFaceHandle.h"
 #include "mdl/BrushNode.h"
@@ -32,11 +33,110 @@
 #include "kdl/overload.h"
 #include "kdl/vector_utils.h"
 
+#include <type_traits>
 #include <vector>
 
 namespace tb::mdl
 {
 
+namespace detail
+{
+
+constexpr unsigned nodeKindBit(const NodeKind kind)
+{
+  return 1u << static_cast<unsigned>(kind);
+}
+
+/**
+ * Returns a bit set of the kinds of nodes that can occur below a node of the given kind.
+ */
+constexpr unsigned descendantNodeKinds(const NodeKind kind)
+{
+  switch (kind)
+  {
+  case NodeKind::World:
+    return nodeKindBit(NodeKind::Layer) | descendantNodeKinds(NodeKind::Layer);
+  case NodeKind::Layer:
+  case NodeKind::Group:
+    return nodeKindBit(NodeKind::Group) | nodeKindBit(NodeKind::Entity)
+           | descendantNodeKinds(NodeKind::Entity);
+  case NodeKind::Entity:
+    return nodeKindBit(NodeKind::Brush) | nodeKindBit(NodeKind::Patch);
+  case NodeKind::Brush:
+  case NodeKind::Patch:
+    return 0u;
+    switchDefault();
+  }
+}
+
+template <typename N, typename T>
+using NodePointer = std::conditional_t<std::is_const_v<N>, const T*, T*>;
+
+template <typename... Ns, typename N, typename L>
+void visitNodes(N& node, const L& lambda)
+{
+  constexpr auto requestedKinds = (nodeKindBit(Ns::Kind) | ...);
+
+  const auto kind = node.kind();
+  if (requestedKinds & nodeKindBit(kind))
+  {
+    // at most one of the requested types matches, so stop at the first match
+    (void)((kind == Ns::Kind && (lambda(static_cast<NodePointer<N, Ns>>(&node)), true))
+           || ...);
+  }
+
+  if (requestedKinds & descendantNodeKinds(kind))
+  {
+    for (N* child : node.children())
+    {
+      visitNodes<Ns...>(*child, lambda);
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * Visits the given node and its descendants in pre-order and passes every node of one of
+ * the given types to the given lambda, e.g.
+ *
+ * visitNodes<BrushNode, PatchNode>(worldNode, kdl::overload(
+ *   [](BrushNode* brushNode) { ... },
+ *   [](PatchNode* patchNode) { ... }));
+ *
+ * Unlike Node::accept, this dispatches on Node::kind without any virtual calls, and it
+ * skips subtrees that cannot contain any nodes of the requested types. For example,
+ * visiting only groups and entities does not descend into entities.
+ */
+template <typename... Ns, typename L>
+void visitNodes(Node& node, const L& lambda)
+{
+  static_assert(sizeof...(Ns) > 0, "at least one node type must be given");
+  detail::visitNodes<Ns...>(node, lambda);
+}
+
+/**
+ * Like the above, but passes const pointers to the lambda.
+ */
+template <typename... Ns, typename L>
+void visitNodes(const Node& node, const L& lambda)
+{
+  static_assert(sizeof...(Ns) > 0, "at least one node type must be given");
+  detail::visitNodes<Ns...>(node, lambda);
+}
+
+/**
+ * Calls visitNodes for each of the given nodes.
+ */
+template <typename... Ns, typename T, typename L>
+void visitNodes(const std::vector<T*>& nodes, const L& lambda)
+{
+  for (auto* node : nodes)
+  {
+    visitNodes<Ns...>(*node, lambda);
+  }
+}
+
 struct TrueNodePredicate
 {
   bool operator()(WorldNode*) const { return true; }
@@ -412,33 +512,17 @@ std::vector<BrushFaceHandle> collectBrushFaces(
   const std::vector<T*>& nodes, const Predicate& predicate = Predicate{})
 {
   auto result = std::vector<BrushFaceHandle>{};
-  Node::visitAll(
-    nodes,
-    kdl::overload(
-      [&](auto&& thisLambda, const WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, const LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, const GroupNode* groupNode) {
-        groupNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, const EntityNode* entityNode) {
-        entityNode->visitChildren(thisLambda);
-      },
-      [&](BrushNode* brushNode) {
-        const auto& brush = brushNode->brush();
-        for (size_t i = 0; i < brush.faceCount(); ++i)
-        {
-          const auto& face = brush.face(i);
-          if (predicate(*brushNode, face))
-          {
-            result.emplace_back(brushNode, i);
-          }
-        }
-      },
-      [&](const PatchNode*) {}));
+  visitNodes<BrushNode>(nodes, [&](BrushNode* brushNode) {
+    const auto& brush = brushNode->brush();
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      const auto& face = brush.face(i);
+      if (predicate(*brushNode, face))
+      {
+        result.emplace_back(brushNode, i);
+      }
+    }
+  });
   return kdl::vec_sort_and_remove_duplicates(std::move(result));
 }
 
@@ -0,0 +1,252 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace detail
+{
+
+/**
+ * Maps the dense ids of nodes to positions in a contiguous entry array. Lookups index an
+ * array instead of hashing a pointer, and iteration only visits the entries.
+ *
+ * Erasing moves the last entry into the erased position, so it invalidates iterators and
+ * references to the last entry, and the iteration order is unspecified.
+ */
+template <typename NodeT, typename Entry, typename GetNode>
+class NodeSlots
+{
+private:
+  static constexpr auto NoSlot = std::numeric_limits<size_t>::max();
+
+  std::vector<size_t> m_slots;
+  std::vector<Entry> m_entries;
+
+public:
+  using iterator = typename std::vector<Entry>::iterator;
+  using const_iterator = typename std::vector<Entry>::const_iterator;
+
+  size_t size() const { return m_entries.size(); }
+
+  bool empty() const { return m_entries.empty(); }
+
+  iterator begin() { return m_entries.begin(); }
+  iterator end() { return m_entries.end(); }
+  const_iterator begin() const { return m_entries.begin(); }
+  const_iterator end() const { return m_entries.end(); }
+
+  iterator find(const NodeT* node)
+  {
+    const auto slot = findSlot(node);
+    return slot != NoSlot ? std::next(m_entries.begin(), long(slot)) : m_entries.end();
+  }
+
+  const_iterator find(const NodeT* node) const
+  {
+    const auto slot = findSlot(node);
+    return slot != NoSlot ? std::next(m_entries.begin(), long(slot)) : m_entries.end();
+  }
+
+  bool contains(const NodeT* node) const { return findSlot(node) != NoSlot; }
+
+  /**
+   * Inserts the entry created by the given function unless the given node already has an
+   * entry. Returns an iterator to the node's entry and whether it was inserted.
+   */
+  template <typename MakeEntry>
+  std::pair<iterator, bool> emplace(NodeT* node, const MakeEntry& makeEntry)
+  {
+    const auto id = node->denseId();
+    if (id >= m_slots.size())
+    {
+      m_slots.resize(id + 1, NoSlot);
+    }
+
+    if (auto& slot = m_slots[id]; slot != NoSlot)
+    {
+      if (GetNode{}(m_entries[slot]) == node)
+      {
+        return {std::next(m_entries.begin(), long(slot)), false};
+      }
+
+      // the entry belongs to a destroyed node whose id was recycled
+      erase(std::next(m_entries.begin(), long(slot)));
+    }
+
+    m_slots[id] = m_entries.size();
+    m_entries.push_back(makeEntry());
+    return {std::prev(m_entries.end()), true};
+  }
+
+  void erase(const iterator it)
+  {
+    assert(it != m_entries.end());
+
+    const auto id = GetNode{}(*it)->denseId();
+    if (const auto last = std::prev(m_entries.end()); it != last)
+    {
+      m_slots[GetNode{}(*last)->denseId()] = size_t(std::distance(m_entries.begin(), it));
+      *it = std::move(*last);
+    }
+
+    m_slots[id] = NoSlot;
+    m_entries.pop_back();
+  }
+
+  size_t erase(const NodeT* node)
+  {
+    if (const auto it = find(node); it != m_entries.end())
+    {
+      erase(it);
+      return 1u;
+    }
+    return 0u;
+  }
+
+  void clear()
+  {
+    m_slots.clear();
+    m_entries.clear();
+  }
+
+private:
+  size_t findSlot(const NodeT* node) const
+  {
+    const auto id = node->denseId();
+    if (id < m_slots.size())
+    {
+      if (const auto slot = m_slots[id];
+          slot != NoSlot && GetNode{}(m_entries[slot]) == node)
+      {
+        return slot;
+      }
+    }
+    return NoSlot;
+  }
+};
+
+struct GetMapNode
+{
+  template <typename Entry>
+  auto operator()(const Entry& entry) const
+  {
+    return entry.first;
+  }
+};
+
+struct GetSetNode
+{
+  template <typename NodeT>
+  NodeT* operator()(NodeT* node) const
+  {
+    return node;
+  }
+};
+
+} // namespace detail
+
+/**
+ * A replacement for std::unordered_map<NodeT*, T> that indexes its entries by the dense
+ * ids of the nodes, see Node::denseId().
+ *
+ * A node must be erased before it is destroyed; an entry of a destroyed node is replaced
+ * when its id is recycled.
+ */
+template <typename NodeT, typename T>
+class NodeSlotMap
+  : public detail::NodeSlots<NodeT, std::pair<NodeT*, T>, detail::GetMapNode>
+{
+private:
+  using Base = detail::NodeSlots<NodeT, std::pair<NodeT*, T>, detail::GetMapNode>;
+
+public:
+  using value_type = std::pair<NodeT*, T>;
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(NodeT* node, Args&&... args)
+  {
+    return Base::emplace(node, [&]() {
+      return value_type{
+        std::piecewise_construct,
+        std::forward_as_tuple(node),
+        std::forward_as_tuple(std::forward<Args>(args)...)};
+    });
+  }
+
+  std::pair<iterator, bool> insert(value_type value)
+  {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  T& operator[](NodeT* node) { return try_emplace(node).first->second; }
+
+  T& at(const NodeT* node)
+  {
+    const auto it = Base::find(node);
+    if (it == Base::end())
+    {
+      throw std::out_of_range{"node not found"};
+    }
+    return it->second;
+  }
+
+  const T& at(const NodeT* node) const
+  {
+    const auto it = Base::find(node);
+    if (it == Base::end())
+    {
+      throw std::out_of_range{"node not found"};
+    }
+    return it->second;
+  }
+};
+
+/**
+ * A replacement for std::unordered_set<NodeT*> that indexes its nodes by their dense
+ * ids, see Node::denseId().
+ */
+template <typename NodeT>
+class NodeSlotSet : public detail::NodeSlots<NodeT, NodeT*, detail::GetSetNode>
+{
+private:
+  using Base = detail::NodeSlots<NodeT, NodeT*, detail::GetSetNode>;
+
+public:
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+
+  std::pair<iterator, bool> insert(NodeT* node)
+  {
+    return Base::emplace(node, [&]() { return node; });
+  }
+};
+
+} // namespace tb::mdl
@@ -34,9 +34,13 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace tb::mdl
 {
@@ -73,27 +77,45 @@ bool Palette::indexedToRgba(
 {
   ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
 
-  const unsigned char* paletteData = (transparency == PaletteTransparency::Opaque)
-                                       ? m_data->opaqueData.data()
-                                       : m_data->index255TransparentData.data();
+  const auto& paletteData = transparency == PaletteTransparency::Opaque
+                              ? m_data->opaqueData
+                              : m_data->index255TransparentData;
 
-  // Write rgba pixels
+  // Convert the palette to one RGBA value per index, so that every pixel is converted by
+  // a single 32 bit lookup
+  auto colors = std::array<uint32_t, 256>{};
+  std::memcpy(
+    colors.data(), paletteData.data(), std::min(paletteData.size(), sizeof(colors)));
+  const auto* colorBytes = reinterpret_cast<const unsigned char*>(colors.data());
+
+  auto indices = std::vector<unsigned char>(pixelCount);
+  reader.read(indices.data(), pixelCount);
+
+  // Write rgba pixels and count how often each index is used
+  auto indexCounts = std::array<size_t, 256>{};
   auto* const rgbaData = rgbaImage.data();
   for (size_t i = 0; i < pixelCount; ++i)
   {
-    const int index = reader.readInt<unsigned char>();
-
-    std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
+    const auto index = indices[i];
+    std::memcpy(rgbaData + (i * 4), &colors[index], 4);
+    ++indexCounts[index];
   }
 
-  // Check average color
-  uint32_t colorSum[3] = {0, 0, 0};
-  for (size_t i = 0; i < pixelCount; ++i)
+  // The average color and the transparency only depend on which indices are used and how
+  // often, so they are computed per palette entry instead of per pixel
+  uint64_t colorSum[3] = {0, 0, 0};
+  unsigned char andAlpha = 0xFF;
+  for (size_t index = 0; index < indexCounts.size(); ++index)
   {
-    colorSum[0] += uint32_t(rgbaData[(i * 4) + 0]);
-    colorSum[1] += uint32_t(rgbaData[(i * 4) + 1]);
-    colorSum[2] += uint32_t(rgbaData[(i * 4) + 2]);
+    if (const auto count = indexCounts[index]; count > 0)
+    {
+      colorSum[0] += count * colorBytes[(index * 4) + 0];
+      colorSum[1] += count * colorBytes[(index * 4) + 1];
+      colorSum[2] += count * colorBytes[(index * 4) + 2];
+      andAlpha = static_cast<unsigned char>(andAlpha & colorBytes[(index * 4) + 3]);
+    }
   }
+
   averageColor = Color{
     float(colorSum[0]) / (255.0f * float(pixelCount)),
     float(colorSum[1]) / (255.0f * float(pixelCount)),
@@ -101,19 +123,7 @@ bool Palette::indexedToRgba(
     1.0f};
 
   // Check for transparency
-  auto hasTransparency = false;
-  if (transparency == PaletteTransparency::Index255Transparent)
-  {
-    // Take the bitwise AND of the alpha channel of all pixels
-    unsigned char andAlpha = 0xFF;
-    for (size_t i = 0; i < pixelCount; ++i)
-    {
-      andAlpha = static_cast<unsigned char>(andAlpha & rgbaData[4 * i + 3]);
-    }
-    hasTransparency = (andAlpha != 0xFF);
-  }
-
-  return hasTransparency;
+  return transparency == PaletteTransparency::Index255Transparent && andAlpha != 0xFF;
 }
 
 bool operator==(const Palette& lhs, const Palette& rhs)
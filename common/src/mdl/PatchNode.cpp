@@ -40,14 +40,13 @@
 #include "vm/intersection.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
 namespace tb::mdl
 {
 
-constexpr static size_t DefaultSubdivisionsPerSurface = 3u;
-
 kdl_reflect_impl(PatchGrid::Point);
 
 const PatchGrid::Point& PatchGrid::point(const size_t row, const size_t col) const
@@ -292,11 +291,46 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
     gridPointRowCount, gridPointColumnCount, std::move(points), boundsBuilder.bounds()};
 }
 
+double computeGridError(const BezierPatch& patch)
+{
+  auto error = 0.0;
+  for (size_t surfaceRow = 0u; surfaceRow < patch.surfaceRowCount(); ++surfaceRow)
+  {
+    for (size_t surfaceCol = 0u; surfaceCol < patch.surfaceColumnCount(); ++surfaceCol)
+    {
+      const auto position = [&](const size_t row, const size_t col) {
+        return vm::slice<3>(
+          patch.controlPoint(2u * surfaceRow + row, 2u * surfaceCol + col), 0);
+      };
+
+      const auto p00 = position(0u, 0u);
+      const auto p02 = position(0u, 2u);
+      const auto p20 = position(2u, 0u);
+      const auto p22 = position(2u, 2u);
+
+      for (size_t row = 0u; row < 3u; ++row)
+      {
+        for (size_t col = 0u; col < 3u; ++col)
+        {
+          const auto u = double(col) / 2.0;
+          const auto v = double(row) / 2.0;
+          const auto bilinear = (1.0 - v) * ((1.0 - u) * p00 + u * p02)
+                                + v * ((1.0 - u) * p20 + u * p22);
+          error = std::max(error, vm::distance(position(row, col), bilinear));
+        }
+      }
+    }
+  }
+  return error;
+}
+
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
-  : m_patch{std::move(patch)}
+  : Node{Kind}
+  , m_patch{std::move(patch)}
   , m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)}
+  , m_gridError{computeGridError(m_patch)}
 {
 }
 
@@ -338,6 +372,8 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
   m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  m_gridError = computeGridError(m_patch);
+  m_coarserGrids.fill(std::nullopt);
   return previousPatch;
 }
 
@@ -351,6 +387,27 @@ const PatchGrid& PatchNode::grid() const
   return m_grid;
 }
 
+const PatchGrid& PatchNode::grid(const size_t subdivisionsPerSurface) const
+{
+  assert(subdivisionsPerSurface <= DefaultSubdivisionsPerSurface);
+  if (subdivisionsPerSurface >= DefaultSubdivisionsPerSurface)
+  {
+    return m_grid;
+  }
+
+  auto& coarserGrid = m_coarserGrids[subdivisionsPerSurface];
+  if (!coarserGrid)
+  {
+    coarserGrid = makePatchGrid(m_patch, subdivisionsPerSurface);
+  }
+  return *coarserGrid;
+}
+
+double PatchNode::gridError(const size_t subdivisionsPerSurface) const
+{
+  return m_gridError / double(size_t(1) << (2u * subdivisionsPerSurface));
+}
+
 const std::string& PatchNode::doGetName() const
 {
   static const auto name = std::string{"patch"};
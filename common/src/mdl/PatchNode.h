@@ -29,6 +29,9 @@
 #include "vm/bbox.h"
 #include "vm/vec.h"
 
+#include <array>
+#include <optional>
+
 namespace tb::mdl
 {
 class EntityNodeBase;
@@ -67,14 +70,36 @@ std::vector<vm::vec3d> computeGridNormals(
 // public for testing
 PatchGrid makePatchGrid(const BezierPatch& patch, size_t subdivisionsPerSurface);
 
+/**
+ * Estimates how far the surface of the given patch deviates from a bilinear surface, i.e.
+ * the maximum distance between a control point and the bilinear interpolation of the
+ * corners of its surface. Each subdivision of the surfaces reduces this error by a factor
+ * of four.
+ */
+double computeGridError(const BezierPatch& patch);
+
 class PatchNode : public Node, public Object
 {
 public:
+  static constexpr auto Kind = NodeKind::Patch;
   static const HitType::Type PatchHitType;
 
+  /**
+   * The number of subdivisions per surface of the grid returned by grid().
+   */
+  static constexpr size_t DefaultSubdivisionsPerSurface = 3u;
+
 private:
   BezierPatch m_patch;
   PatchGrid m_grid;
+  double m_gridError;
+
+  /**
+   * Coarser grids of this patch, indexed by their number of subdivisions per surface.
+   * They are only used for rendering and are created when they are first requested.
+   */
+  mutable std::array<std::optional<PatchGrid>, DefaultSubdivisionsPerSurface>
+    m_coarserGrids;
 
 public:
   explicit PatchNode(BezierPatch patch);
@@ -89,6 +114,18 @@ public:
 
   const PatchGrid& grid() const;
 
+  /**
+   * Returns the grid of this patch for the given number of subdivisions per surface,
+   * which must not exceed DefaultSubdivisionsPerSurface.
+   */
+  const PatchGrid& grid(size_t subdivisionsPerSurface) const;
+
+  /**
+   * Returns an estimate of the maximum distance between the surface of this patch and its
+   * grid for the given number of subdivisions per surface.
+   */
+  double gridError(size_t subdivisionsPerSurface) const;
+
 private: // implement Node interface
   const std::string& doGetName() const override;
   const vm::bbox3d& doGetLogicalBounds() const override;
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace tb::mdl
 {
@@ -53,11 +54,14 @@ public:
 
 PickResult::PickResult(std::shared_ptr<CompareHits> compare)
   : m_compare{std::move(compare)}
+  , m_filter{HitFilters::any()}
+  , m_maxHits{std::numeric_limits<size_t>::max()}
+  , m_maxDistance{std::numeric_limits<double>::infinity()}
 {
 }
 
 PickResult::PickResult()
-  : m_compare{std::make_shared<CompareHitsByDistance>()}
+  : PickResult{std::make_shared<CompareHitsByDistance>()}
 {
 }
 
@@ -69,6 +73,16 @@ PickResult PickResult::byDistance()
     std::make_unique<CompareHitsByDistance>(), std::make_unique<CompareHitsByType>())};
 }
 
+PickResult PickResult::byDistance(HitFilter filter, const size_t maxHits)
+{
+  assert(maxHits > 0);
+
+  auto result = byDistance();
+  result.m_filter = std::move(filter);
+  result.m_maxHits = maxHits;
+  return result;
+}
+
 PickResult PickResult::bySize(const vm::axis::type axis)
 {
   return PickResult{std::make_shared<CompareHitsBySize>(axis)};
@@ -84,17 +98,41 @@ size_t PickResult::size() const
   return m_hits.size();
 }
 
+bool PickResult::bounded() const
+{
+  return m_maxHits < std::numeric_limits<size_t>::max();
+}
+
+double PickResult::maxDistance() const
+{
+  return m_maxDistance;
+}
+
 void PickResult::addHit(const Hit& hit)
 {
   assert(!vm::is_nan(hit.distance()));
   assert(!vm::is_nan(hit.hitPoint()));
 
-  if (!vm::is_nan(hit.distance()) && !vm::is_nan(hit.hitPoint()))
+  if (
+    !vm::is_nan(hit.distance()) && !vm::is_nan(hit.hitPoint())
+    && hit.distance() <= m_maxDistance && m_filter(hit))
   {
     ensure(m_compare.get() != nullptr, "compare is null");
     auto pos = std::upper_bound(
       std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
     m_hits.insert(pos, hit);
+
+    if (m_hits.size() >= m_maxHits)
+    {
+      // bounded results are ordered by distance, so everything after the last hit that
+      // must be kept is farther away unless it is at the same distance
+      m_maxDistance = m_hits[m_maxHits - 1].distance() + vm::Cd::almost_zero();
+      const auto end = std::find_if(
+        std::next(std::begin(m_hits), std::ptrdiff_t(m_maxHits)),
+        std::end(m_hits),
+        [&](const auto& keptHit) { return keptHit.distance() > m_maxDistance; });
+      m_hits.erase(end, std::end(m_hits));
+    }
   }
 }
 
@@ -158,6 +196,7 @@ std::vector<Hit> PickResult::all(const HitFilter& filter) const
 void PickResult::clear()
 {
   m_hits.clear();
+  m_maxDistance = std::numeric_limits<double>::infinity();
 }
 
 } // namespace tb::mdl
@@ -37,6 +37,9 @@ class PickResult
 private:
   std::vector<Hit> m_hits;
   std::shared_ptr<CompareHits> m_compare;
+  HitFilter m_filter;
+  size_t m_maxHits;
+  double m_maxDistance;
   class CompareWrapper;
 
 public:
@@ -48,11 +51,35 @@ public:
   ~PickResult();
 
   static PickResult byDistance();
+
+  /**
+   * Creates a pick result that orders hits by distance and only keeps the closest hits
+   * that match the given filter.
+   *
+   * Once maxHits hits have been added, hits that are farther away than the farthest of
+   * them are discarded. Hits at the same distance as that hit are kept so that first()
+   * can still choose among them by their error.
+   */
+  static PickResult byDistance(HitFilter filter, size_t maxHits);
+
   static PickResult bySize(vm::axis::type axis);
 
   bool empty() const;
   size_t size() const;
 
+  /**
+   * Indicates whether this pick result only keeps a bounded number of hits.
+   */
+  bool bounded() const;
+
+  /**
+   * Returns the distance beyond which hits are discarded. This is infinite unless this
+   * pick result is bounded and has already collected the maximum number of hits.
+   *
+   * Pickers can use this to skip objects that are entirely farther away.
+   */
+  double maxDistance() const;
+
   void addHit(const Hit& hit);
 
   const std::vector<Hit>& all() const;
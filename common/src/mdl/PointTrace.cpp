@@ -29,7 +29,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <istream>
 
 namespace tb::mdl
 {
@@ -155,10 +154,8 @@ std::vector<vm::vec3f> segmentizePoints(const std::vector<vm::vec3f>& points)
 
 kdl_reflect_impl(PointTrace);
 
-Result<PointTrace> loadPointFile(std::istream& stream)
+Result<PointTrace> loadPointFile(const std::string_view str)
 {
-  const auto str = std::string{std::istreambuf_iterator<char>{stream}, {}};
-
   auto points = std::vector<vm::vec3f>{};
   vm::parse_all<float, 3>(str, std::back_inserter(points));
 
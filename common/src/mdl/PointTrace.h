@@ -25,7 +25,7 @@
 
 #include "vm/vec.h"
 
-#include <iosfwd>
+#include <string_view>
 #include <vector>
 
 namespace tb::mdl
@@ -52,6 +52,6 @@ public:
   kdl_reflect_decl(PointTrace, m_points, m_current);
 };
 
-Result<PointTrace> loadPointFile(std::istream& stream);
+Result<PointTrace> loadPointFile(std::string_view str);
 
 } // namespace tb::mdl
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "kdl/intrusive_circular_list.h"
+#include "kdl/pool_allocator.h"
 
 #include "vm/bbox.h"
 #include "vm/plane.h"
@@ -38,6 +39,27 @@
 
 namespace tb::mdl
 {
+/* ====================== Epsilons ====================== */
+
+/**
+ * The epsilon values used by the polyhedron algorithms. These are the values from
+ * vm::constants, but they are larger for single precision, whose resolution is only about
+ * 0.001 units at the extent of a typical map.
+ */
+template <typename T>
+struct PolyhedronConstants : vm::constants<T>
+{
+};
+
+template <>
+struct PolyhedronConstants<float> : vm::constants<float>
+{
+  constexpr static float almost_zero() { return 0.01f; }
+  constexpr static float point_status_epsilon() { return 0.01f; }
+  constexpr static float correct_epsilon() { return 0.01f; }
+  constexpr static float colinear_epsilon() { return 0.0001f; }
+};
+
 /* ====================== Forward Declarations ====================== */
 
 template <typename T, typename FP, typename VP>
@@ -79,6 +101,7 @@ struct Polyhedron_GetVertexLink
  */
 template <typename T, typename FP, typename VP>
 class Polyhedron_Vertex
+  : public kdl::pool_allocated<Polyhedron_Vertex<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -192,7 +215,7 @@ public:
    * @param epsilon an epsilon value
    */
   void correctPosition(
-    std::size_t decimals = 0, T epsilon = vm::constants<T>::correct_epsilon());
+    std::size_t decimals = 0, T epsilon = PolyhedronConstants<T>::correct_epsilon());
 };
 
 template <typename T, typename FP, typename VP>
@@ -234,6 +257,7 @@ struct Polyhedron_GetEdgeLink
  */
 template <typename T, typename FP, typename VP>
 class Polyhedron_Edge
+  : public kdl::pool_allocated<Polyhedron_Edge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -550,6 +574,7 @@ struct Polyhedron_GetHalfEdgeLink
  */
 template <typename T, typename FP, typename VP>
 class Polyhedron_HalfEdge
+  : public kdl::pool_allocated<Polyhedron_HalfEdge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -775,6 +800,7 @@ struct Polyhedron_GetFaceLink
  */
 template <typename T, typename FP, typename VP>
 class Polyhedron_Face
+  : public kdl::pool_allocated<Polyhedron_Face<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -1240,6 +1266,23 @@ public: // Constructors
    */
   explicit Polyhedron(std::vector<vm::vec<T, 3>> positions);
 
+  /**
+   * Constructs a polyhedron with the given vertices and faces without computing a convex
+   * hull.
+   *
+   * Each face is given by the indices of its vertices in counter clockwise order and by
+   * its plane. The faces are created in the given order. If the given faces do not form a
+   * closed polyhedron, then the resulting polyhedron is not closed.
+   *
+   * @param positions the vertex positions
+   * @param faceVertexIndices the vertex indices of each face
+   * @param facePlanes the plane of each face
+   */
+  Polyhedron(
+    const std::vector<vm::vec<T, 3>>& positions,
+    const std::vector<std::vector<size_t>>& faceVertexIndices,
+    const std::vector<vm::plane<T, 3>>& facePlanes);
+
   /**
    * Copy constructor.
    */
@@ -1581,6 +1624,21 @@ private:
    */
   void updateBounds();
 
+public: // Transformation
+  /**
+   * Transforms the positions of all vertices and the planes of all faces of this
+   * polyhedron by the given transformation. The topology of this polyhedron is kept
+   * unchanged.
+   *
+   * The given transformation must be an affine transformation that preserves
+   * orientation, i.e., the determinant of its linear part must be positive.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param transformation the transformation to apply
+   */
+  void transform(const vm::mat<T, 4, 4>& transformation);
+
 public: // Vertex correction and edge healing
   /**
    * Rounds each component of position of every vertex to the nearest integer if the
@@ -1594,7 +1652,7 @@ public: // Vertex correction and edge healing
    * @param epsilon an epsilon value
    */
   void correctVertexPositions(
-    std::size_t decimals = 0, T epsilon = vm::constants<T>::correct_epsilon());
+    std::size_t decimals = 0, T epsilon = PolyhedronConstants<T>::correct_epsilon());
 
   /**
    * Heals short edges by removing all edges shorter than the given minimum length. If
@@ -1708,16 +1766,19 @@ public:
 
   /* ====================== Implementation in Polyhedron_ConvexHull.h
    * ====================== */
-private: // Convex hull; adding and removing points
+public: // Convex hull; adding and removing points
   /**
    * Adds the given points to this polyhedron. The effect of adding the given points to a
    * polyhedron is that the resulting polyhedron is the convex hull of the union of the
    * polyhedron's vertices and the given points.
    *
    * Duplicates in the given vector are discarded. Furthermore, the remaining points are
-   * sorted in descending order of their distance from the center of their bounding box.
-   * Therefore, the result of calling this method is different from the result of
-   * repeatedly calling addPoint() for every point in the given vector.
+   * reordered so that the first four points span a large initial tetrahedron, and the
+   * other points are sorted in descending order of their distance from the center of
+   * their bounding box. Points which are already contained in the polyhedron are skipped
+   * without computing a horizon. Therefore, the result of calling this method is
+   * different from the result of repeatedly calling addPoint() for every point in the
+   * given vector.
    *
    * @param points the points to add to this polyhedron
    */
@@ -28,4 +28,11 @@ namespace tb::mdl
 using Polyhedron3 =
   Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
 
+/**
+ * A single precision polyhedron for derived geometry such as previews and models. Brush
+ * geometry must always use Polyhedron3.
+ */
+using Polyhedron3f =
+  Polyhedron<float, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
+
 }
@@ -247,7 +247,8 @@ bool Polyhedron<T, FP, VP>::checkConvex() const
     for (const auto* vertex : m_vertices)
     {
       if (
-        face->pointStatus(vertex->position(), vm::constants<T>::point_status_epsilon())
+        face->pointStatus(
+          vertex->position(), PolyhedronConstants<T>::point_status_epsilon())
         == vm::plane_status::above)
       {
         return false;
@@ -302,7 +303,7 @@ bool Polyhedron<T, FP, VP>::checkNoCoplanarFaces() const
     {
       return false;
     }
-    if (firstFace->coplanar(secondFace, vm::constants<T>::point_status_epsilon()))
+    if (firstFace->coplanar(secondFace, PolyhedronConstants<T>::point_status_epsilon()))
     {
       return false;
     }
@@ -152,7 +152,7 @@ std::optional<typename Polyhedron<T, FP, VP>::ClipResult::FailureReason> Polyhed
   for (const Vertex* currentVertex : m_vertices)
   {
     const auto status = plane.point_status(
-      currentVertex->position(), vm::constants<T>::point_status_epsilon());
+      currentVertex->position(), PolyhedronConstants<T>::point_status_epsilon());
     switch (status)
     {
     case vm::plane_status::above:
@@ -276,9 +276,10 @@ typename Polyhedron<T, FP, VP>::HalfEdge* Polyhedron<T, FP, VP>::
   {
     auto* halfEdge = currentEdge->firstEdge();
     const auto originStatus = plane.point_status(
-      halfEdge->origin()->position(), vm::constants<T>::point_status_epsilon());
+      halfEdge->origin()->position(), PolyhedronConstants<T>::point_status_epsilon());
     const auto destinationStatus = plane.point_status(
-      halfEdge->destination()->position(), vm::constants<T>::point_status_epsilon());
+      halfEdge->destination()->position(),
+      PolyhedronConstants<T>::point_status_epsilon());
 
     if (
       (originStatus == vm::plane_status::inside
@@ -307,7 +308,8 @@ typename Polyhedron<T, FP, VP>::HalfEdge* Polyhedron<T, FP, VP>::
       // otherwise we return the half edge.
       auto* nextEdge = halfEdge->next();
       auto successorStatus = plane.point_status(
-        nextEdge->destination()->position(), vm::constants<T>::point_status_epsilon());
+        nextEdge->destination()->position(),
+        PolyhedronConstants<T>::point_status_epsilon());
 
       while (successorStatus == vm::plane_status::inside && nextEdge != halfEdge)
       {
@@ -317,7 +319,8 @@ typename Polyhedron<T, FP, VP>::HalfEdge* Polyhedron<T, FP, VP>::
         // destination is not inside the plane.
         nextEdge = nextEdge->next();
         successorStatus = plane.point_status(
-          nextEdge->destination()->position(), vm::constants<T>::point_status_epsilon());
+          nextEdge->destination()->position(),
+          PolyhedronConstants<T>::point_status_epsilon());
       }
 
       if (successorStatus == vm::plane_status::inside)
@@ -362,10 +365,10 @@ std::tuple<typename Polyhedron<T, FP, VP>::HalfEdge*, bool> Polyhedron<T, FP, VP
   {
     const auto originStatus = plane.point_status(
       currentBoundaryEdge->origin()->position(),
-      vm::constants<T>::point_status_epsilon());
+      PolyhedronConstants<T>::point_status_epsilon());
     const auto destinationStatus = plane.point_status(
       currentBoundaryEdge->destination()->position(),
-      vm::constants<T>::point_status_epsilon());
+      PolyhedronConstants<T>::point_status_epsilon());
 
     if (originStatus == vm::plane_status::inside)
     {
@@ -387,14 +390,15 @@ std::tuple<typename Polyhedron<T, FP, VP>::HalfEdge*, bool> Polyhedron<T, FP, VP
       // We have to split the edge and insert a new vertex, which will become the origin
       // or destination of the new seam edge.
       auto* currentEdge = currentBoundaryEdge->edge();
-      auto* newEdge = currentEdge->split(plane, vm::constants<T>::point_status_epsilon());
+      auto* newEdge =
+        currentEdge->split(plane, PolyhedronConstants<T>::point_status_epsilon());
       m_edges.push_back(newEdge);
 
       currentBoundaryEdge = currentBoundaryEdge->next();
       auto* newVertex = currentBoundaryEdge->origin();
       assert(
         plane.point_status(
-          newVertex->position(), vm::constants<T>::point_status_epsilon())
+          newVertex->position(), PolyhedronConstants<T>::point_status_epsilon())
         == vm::plane_status::inside);
 
       m_vertices.push_back(newVertex);
@@ -428,7 +432,8 @@ std::tuple<typename Polyhedron<T, FP, VP>::HalfEdge*, bool> Polyhedron<T, FP, VP
     // supposed to be above the given plane, so we have to consider whether the
     // destination of the seam origin edge is above or below the plane.
     const auto originStatus = plane.point_status(
-      seamOrigin->destination()->position(), vm::constants<T>::point_status_epsilon());
+      seamOrigin->destination()->position(),
+      PolyhedronConstants<T>::point_status_epsilon());
     assert(originStatus != vm::plane_status::inside);
     if (originStatus == vm::plane_status::below)
     {
@@ -486,9 +491,9 @@ typename Polyhedron<T, FP, VP>::HalfEdge* Polyhedron<T, FP, VP>::findNextInterse
     auto* cd = currentEdge->destination();
     auto* po = currentEdge->previous()->origin();
     const auto cds =
-      plane.point_status(cd->position(), vm::constants<T>::point_status_epsilon());
+      plane.point_status(cd->position(), PolyhedronConstants<T>::point_status_epsilon());
     const auto pos =
-      plane.point_status(po->position(), vm::constants<T>::point_status_epsilon());
+      plane.point_status(po->position(), PolyhedronConstants<T>::point_status_epsilon());
 
     if (
       (cds == vm::plane_status::inside)
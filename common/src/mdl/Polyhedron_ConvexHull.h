@@ -30,6 +30,7 @@
 #include "vm/segment.h"
 #include "vm/util.h"
 
+#include <algorithm>
 #include <list>
 #include <unordered_set>
 #include <vector>
@@ -46,11 +47,70 @@ T computePlaneEpsilon(const std::vector<vm::vec<T, 3>>& points)
   builder.add(points.begin(), points.end());
   const auto size = builder.bounds().size();
 
-  const auto defaultEpsilon = vm::constants<T>::point_status_epsilon();
+  const auto defaultEpsilon = PolyhedronConstants<T>::point_status_epsilon();
   const auto computedEpsilon =
-    vm::get_max_component(size) / T(10) * vm::constants<T>::point_status_epsilon();
+    vm::get_max_component(size) / T(10) * PolyhedronConstants<T>::point_status_epsilon();
   return std::max(computedEpsilon, defaultEpsilon);
 }
+
+/**
+ * Orders the given points for bulk insertion into a convex hull.
+ *
+ * The first four points span a tetrahedron that is as large as possible: the point
+ * farthest from the center of the bounds, the point farthest from it, the point farthest
+ * from the line through both, and the point farthest from the plane through all three.
+ * The remaining points follow in descending order of their distance from the center, so
+ * that most interior points are already enclosed when they are reached.
+ *
+ * If the points do not span a tetrahedron, they are returned unchanged because the
+ * result of adding coplanar points to a polygon depends on their order.
+ */
+template <typename T>
+std::vector<vm::vec<T, 3>> sortPointsForConvexHull(
+  std::vector<vm::vec<T, 3>> points, const T planeEpsilon)
+{
+  if (points.size() < 4)
+  {
+    return points;
+  }
+
+  const auto originalPoints = points;
+
+  auto builder = typename vm::bbox<T, 3>::builder{};
+  builder.add(points.begin(), points.end());
+  const auto center = builder.bounds().center();
+
+  std::ranges::sort(points, [&](const auto& lhs, const auto& rhs) {
+    const auto lhsDistance = vm::squared_distance(lhs, center);
+    const auto rhsDistance = vm::squared_distance(rhs, center);
+    return lhsDistance != rhsDistance ? lhsDistance > rhsDistance : lhs < rhs;
+  });
+
+  const auto moveMaximumTo = [&](const size_t index, const auto& score) {
+    if (index < points.size())
+    {
+      const auto it = std::ranges::max_element(
+        points.begin() + long(index), points.end(), {}, score);
+      std::iter_swap(points.begin() + long(index), it);
+    }
+  };
+
+  const auto& p0 = points[0];
+  moveMaximumTo(1, [&](const auto& p) { return vm::squared_distance(p, p0); });
+
+  const auto& p1 = points[1];
+  moveMaximumTo(
+    2, [&](const auto& p) { return vm::squared_length(vm::cross(p - p0, p1 - p0)); });
+
+  const auto normal = vm::cross(p1 - p0, points[2] - p0);
+  moveMaximumTo(3, [&](const auto& p) { return vm::abs(vm::dot(p - p0, normal)); });
+
+  const auto normalLength = vm::length(normal);
+  return normalLength > T(0)
+             && vm::abs(vm::dot(points[3] - p0, normal)) / normalLength > planeEpsilon
+           ? points
+           : originalPoints;
+}
 } // namespace detail
 
 template <typename T, typename FP, typename VP>
@@ -61,9 +121,16 @@ void Polyhedron<T, FP, VP>::addPoints(std::vector<vm::vec<T, 3>> points)
     points = kdl::vec_sort_and_remove_duplicates(std::move(points));
 
     const auto planeEpsilon = detail::computePlaneEpsilon(points);
+    points = detail::sortPointsForConvexHull(std::move(points), planeEpsilon);
+
     for (const auto& point : points)
     {
-      addPoint(point, planeEpsilon);
+      // points which are already enclosed would not change the hull, so skip the more
+      // expensive horizon computation for them
+      if (!polyhedron() || !contains(point, planeEpsilon))
+      {
+        addPoint(point, planeEpsilon);
+      }
     }
   }
 }
@@ -166,20 +233,20 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addColinearThirdP
   assert(vm::is_colinear(v1->position(), v2->position(), position));
 
   if (vm::segment<T, 3>(v1->position(), v2->position())
-        .contains(position, vm::constants<T>::almost_zero()))
+        .contains(position, PolyhedronConstants<T>::almost_zero()))
   {
     return nullptr;
   }
 
   if (vm::segment<T, 3>(position, v2->position())
-        .contains(v1->position(), vm::constants<T>::almost_zero()))
+        .contains(v1->position(), PolyhedronConstants<T>::almost_zero()))
   {
     v1->setPosition(position);
     return v1;
   }
 
   assert((vm::segment<T, 3>(position, v1->position())
-            .contains(v2->position(), vm::constants<T>::almost_zero())));
+            .contains(v2->position(), PolyhedronConstants<T>::almost_zero())));
   v2->setPosition(position);
   return v2;
 }
@@ -287,7 +354,7 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addPointToPolygon
       curEdge->origin()->position(), curEdge->destination()->position()};
     if (
       curStatus == vm::plane_status::inside
-      && curSegment.contains(position, vm::constants<T>::almost_zero()))
+      && curSegment.contains(position, PolyhedronConstants<T>::almost_zero()))
     {
       return nullptr;
     }
@@ -275,7 +275,7 @@ vm::vec<T, 3> Polyhedron_Face<T, FP, VP>::normal() const
     const auto& p2 = halfEdge->next()->origin()->position();
     const auto& p3 = halfEdge->next()->next()->origin()->position();
     const auto normal = vm::cross(p2 - p1, p3 - p1);
-    if (!vm::is_zero(normal, vm::constants<T>::almost_zero()))
+    if (!vm::is_zero(normal, PolyhedronConstants<T>::almost_zero()))
     {
       return vm::normalize(normal);
     }
@@ -327,7 +327,9 @@ bool Polyhedron_Face<T, FP, VP>::coplanar(const Face* other, const T epsilon) co
   assert(other != nullptr);
 
   // Test if the normals are colinear by checking their enclosed angle.
-  if (T(1) - vm::dot(normal(), other->normal()) >= vm::constants<T>::colinear_epsilon())
+  if (
+    T(1) - vm::dot(normal(), other->normal())
+    >= PolyhedronConstants<T>::colinear_epsilon())
   {
     return false;
   }
@@ -529,7 +531,7 @@ Polyhedron_Face<T, FP, VP>::intersectWithRay(const vm::ray<T, 3>& ray) const
   const auto plane = vm::plane<T, 3>{origin(), normal()};
   const auto cos = vm::dot(plane.normal, ray.direction);
 
-  if (vm::is_zero(cos, vm::constants<T>::almost_zero()))
+  if (vm::is_zero(cos, PolyhedronConstants<T>::almost_zero()))
   {
     return std::nullopt;
   }
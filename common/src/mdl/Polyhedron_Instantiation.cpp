@@ -43,50 +43,83 @@ template struct Polyhedron_GetVertexLink<
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template struct Polyhedron_GetVertexLink<double, BrushFacePayload, BrushVertexPayload>;
+template struct Polyhedron_GetVertexLink<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template class Polyhedron_Vertex<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template class Polyhedron_Vertex<double, BrushFacePayload, BrushVertexPayload>;
+template class Polyhedron_Vertex<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template struct Polyhedron_GetEdgeLink<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template struct Polyhedron_GetEdgeLink<double, BrushFacePayload, BrushVertexPayload>;
+template struct Polyhedron_GetEdgeLink<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template class Polyhedron_Edge<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template class Polyhedron_Edge<double, BrushFacePayload, BrushVertexPayload>;
+template class Polyhedron_Edge<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template struct Polyhedron_GetHalfEdgeLink<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template struct Polyhedron_GetHalfEdgeLink<double, BrushFacePayload, BrushVertexPayload>;
+template struct Polyhedron_GetHalfEdgeLink<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template class Polyhedron_HalfEdge<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template class Polyhedron_HalfEdge<double, BrushFacePayload, BrushVertexPayload>;
+template class Polyhedron_HalfEdge<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template struct Polyhedron_GetFaceLink<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template struct Polyhedron_GetFaceLink<double, BrushFacePayload, BrushVertexPayload>;
+template struct Polyhedron_GetFaceLink<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template class Polyhedron_Face<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 template class Polyhedron_Face<double, BrushFacePayload, BrushVertexPayload>;
+template class Polyhedron_Face<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 template class Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
 template class Polyhedron<double, BrushFacePayload, BrushVertexPayload>;
+template class Polyhedron<float, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
 
 } // namespace tb::mdl
@@ -31,29 +31,49 @@ extern template class Polyhedron_Vertex<
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 extern template class Polyhedron_Vertex<double, BrushFacePayload, BrushVertexPayload>;
+extern template class Polyhedron_Vertex<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 extern template class Polyhedron_Edge<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 extern template class Polyhedron_Edge<double, BrushFacePayload, BrushVertexPayload>;
+extern template class Polyhedron_Edge<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 extern template class Polyhedron_HalfEdge<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 extern template class Polyhedron_HalfEdge<double, BrushFacePayload, BrushVertexPayload>;
+extern template class Polyhedron_HalfEdge<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 extern template class Polyhedron_Face<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 extern template class Polyhedron_Face<double, BrushFacePayload, BrushVertexPayload>;
+extern template class Polyhedron_Face<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 extern template class Polyhedron<
   double,
   DefaultPolyhedronPayload,
   DefaultPolyhedronPayload>;
 extern template class Polyhedron<double, BrushFacePayload, BrushVertexPayload>;
+extern template class Polyhedron<
+  float,
+  DefaultPolyhedronPayload,
+  DefaultPolyhedronPayload>;
 
 } // namespace tb::mdl
@@ -24,6 +24,7 @@
 #include "kdl/range_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/mat_ext.h"
 #include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/scalar.h"
@@ -35,6 +36,8 @@
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace tb::mdl
 {
@@ -86,7 +89,7 @@ Polyhedron<T, FP, VP>::Polyhedron(const vm::bbox<T, 3>& bounds)
 {
   if (m_bounds.min == m_bounds.max)
   {
-    addPoint(m_bounds.min, vm::constants<T>::point_status_epsilon());
+    addPoint(m_bounds.min, PolyhedronConstants<T>::point_status_epsilon());
     return;
   }
 
@@ -174,6 +177,66 @@ Polyhedron<T, FP, VP>::Polyhedron(std::vector<vm::vec<T, 3>> positions)
   addPoints(std::move(positions));
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T, FP, VP>::Polyhedron(
+  const std::vector<vm::vec<T, 3>>& positions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices,
+  const std::vector<vm::plane<T, 3>>& facePlanes)
+{
+  assert(faceVertexIndices.size() == facePlanes.size());
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(positions.size());
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex{position};
+    m_vertices.push_back(vertex);
+    vertices.push_back(vertex);
+  }
+
+  // the half edges leaving each vertex together with the index of their destination
+  auto leavingHalfEdges = std::vector<std::vector<std::pair<size_t, HalfEdge*>>>(
+    positions.size());
+
+  for (size_t i = 0; i < faceVertexIndices.size(); ++i)
+  {
+    const auto& indices = faceVertexIndices[i];
+
+    auto boundary = HalfEdgeList{};
+    for (size_t j = 0; j < indices.size(); ++j)
+    {
+      assert(indices[j] < vertices.size());
+
+      auto* halfEdge = new HalfEdge{vertices[indices[j]]};
+      boundary.push_back(halfEdge);
+      leavingHalfEdges[indices[j]].emplace_back(
+        indices[(j + 1) % indices.size()], halfEdge);
+    }
+    m_faces.push_back(new Face{std::move(boundary), facePlanes[i]});
+  }
+
+  // connect each half edge with its twin, which leaves the half edge's destination and
+  // returns to its origin
+  for (size_t origin = 0; origin < leavingHalfEdges.size(); ++origin)
+  {
+    for (const auto& [destination, halfEdge] : leavingHalfEdges[origin])
+    {
+      if (!halfEdge->edge())
+      {
+        const auto& candidates = leavingHalfEdges[destination];
+        const auto twinIt = std::ranges::find_if(candidates, [&](const auto& candidate) {
+          return candidate.first == origin && !candidate.second->edge();
+        });
+        m_edges.push_back(
+          twinIt != candidates.end() ? new Edge{halfEdge, twinIt->second}
+                                     : new Edge{halfEdge});
+      }
+    }
+  }
+
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
 {
@@ -756,6 +819,22 @@ void Polyhedron<T, FP, VP>::updateBounds()
   }
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::transform(const vm::mat<T, 4, 4>& transformation)
+{
+  assert(vm::is_orientation_preserving_transform(transformation));
+
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(transformation * vertex->position());
+  }
+  for (auto* face : m_faces)
+  {
+    face->setPlane(face->plane().transform(transformation));
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const T epsilon)
 {
@@ -71,7 +71,7 @@ bool Polyhedron<T, FP, VP>::contains(const Polyhedron& other) const
 
   for (const auto* vertex : other.vertices())
   {
-    if (!contains(vertex->position(), vm::constants<T>::point_status_epsilon()))
+    if (!contains(vertex->position(), PolyhedronConstants<T>::point_status_epsilon()))
     {
       return false;
     }
@@ -147,7 +147,7 @@ bool Polyhedron<T, FP, VP>::pointIntersectsEdge(
   const auto& rhsEnd = rhsEdge->secondVertex()->position();
 
   return vm::segment<T, 3>{rhsStart, rhsEnd}.contains(
-    lhsPos, vm::constants<T>::almost_zero());
+    lhsPos, PolyhedronConstants<T>::almost_zero());
 }
 
 template <typename T, typename FP, typename VP>
@@ -174,7 +174,7 @@ bool Polyhedron<T, FP, VP>::pointIntersectsPolyhedron(
   assert(rhs.polyhedron());
 
   const auto& lhsPos = lhs.m_vertices.front()->position();
-  return rhs.contains(lhsPos, vm::constants<T>::point_status_epsilon());
+  return rhs.contains(lhsPos, PolyhedronConstants<T>::point_status_epsilon());
 }
 
 template <typename T, typename FP, typename VP>
@@ -216,15 +216,15 @@ bool Polyhedron<T, FP, VP>::edgeIntersectsEdge(
       const auto rhsEndDist = vm::distance_to_projected_point(lhsRay, rhsEnd);
 
       return (
-        vm::contains(rhsStartDist, 0.0, rayLen) ||   // lhs constains rhs start
-        vm::contains(rhsEndDist, 0.0, rayLen) ||     // lhs contains rhs end
+        vm::contains(rhsStartDist, T(0), rayLen) ||  // lhs constains rhs start
+        vm::contains(rhsEndDist, T(0), rayLen) ||    // lhs contains rhs end
         (rhsStartDist > 0.0) != (rhsEndDist > 0.0)); // rhs contains lhs
     }
     return false;
   }
 
   constexpr auto epsilon2 =
-    vm::constants<T>::almost_zero() * vm::constants<T>::almost_zero();
+    PolyhedronConstants<T>::almost_zero() * PolyhedronConstants<T>::almost_zero();
   return dist.distance < epsilon2 && dist.position1 <= rayLen;
 }
 
@@ -299,11 +299,11 @@ bool Polyhedron<T, FP, VP>::edgeIntersectsFace(const Edge* lhsEdge, const Face*
 
   const auto& edgeDir = lhsRay.direction;
   const auto faceNorm = rhsFace->normal();
-  if (vm::is_zero(vm::dot(faceNorm, edgeDir), vm::constants<T>::almost_zero()))
+  if (vm::is_zero(vm::dot(faceNorm, edgeDir), PolyhedronConstants<T>::almost_zero()))
   {
     // ray and face are parallel, intersect with edges
     constexpr auto MaxDistance =
-      vm::constants<T>::almost_zero() * vm::constants<T>::almost_zero();
+      PolyhedronConstants<T>::almost_zero() * PolyhedronConstants<T>::almost_zero();
 
     for (const auto* rhsEdge : rhsFace->boundary())
     {
@@ -362,7 +362,7 @@ bool Polyhedron<T, FP, VP>::polygonIntersectsPolyhedron(
   }
 
   auto* vertex = lhs.vertices().front();
-  return rhs.contains(vertex->position(), vm::constants<T>::point_status_epsilon());
+  return rhs.contains(vertex->position(), PolyhedronConstants<T>::point_status_epsilon());
 }
 
 template <typename T, typename FP, typename VP>
@@ -442,7 +442,7 @@ bool Polyhedron<T, FP, VP>::polyhedronIntersectsPolyhedron(
       const auto rhsEdgeVec = rhsEdge->vector();
       const auto direction = vm::cross(lhsEdgeVec, rhsEdgeVec);
 
-      if (!vm::is_zero(direction, vm::constants<T>::almost_zero()))
+      if (!vm::is_zero(direction, PolyhedronConstants<T>::almost_zero()))
       {
         const auto plane = vm::plane<T, 3>(lhsEdgeOrigin, direction);
 
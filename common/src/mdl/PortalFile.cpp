@@ -22,16 +22,168 @@
 #include "io/DiskIO.h"
 
 #include "kdl/result.h"
-#include "kdl/string_format.h"
-#include "kdl/string_utils.h"
+#include "kdl/result_fold.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/polygon.h"
 #include "vm/vec.h"
 
+#include <charconv>
+#include <functional>
+#include <optional>
+#include <ranges>
 #include <string>
 
 namespace tb::mdl
 {
+namespace
+{
+
+/**
+ * The portals are split into chunks of this many lines, which are parsed in parallel.
+ */
+constexpr auto PortalsPerChunk = size_t(4096);
+
+constexpr auto Delimiters = std::string_view{"() \t\r"};
+
+struct PortalChunk
+{
+  std::string_view str;
+  size_t portalCount;
+};
+
+/**
+ * Returns the next line without its line break and removes it from the given string.
+ */
+std::string_view nextLine(std::string_view& str)
+{
+  const auto end = str.find('\n');
+  const auto line = str.substr(0, end);
+  str.remove_prefix(end != std::string_view::npos ? end + 1 : str.size());
+  return line;
+}
+
+/**
+ * Returns the next token and removes it from the given line. Parentheses are treated as
+ * whitespace.
+ */
+std::string_view nextToken(std::string_view& line)
+{
+  const auto begin = line.find_first_not_of(Delimiters);
+  if (begin == std::string_view::npos)
+  {
+    line = {};
+    return {};
+  }
+
+  line.remove_prefix(begin);
+  const auto token = line.substr(0, line.find_first_of(Delimiters));
+  line.remove_prefix(token.size());
+  return token;
+}
+
+size_t countTokens(std::string_view line)
+{
+  auto count = size_t(0);
+  while (!nextToken(line).empty())
+  {
+    ++count;
+  }
+  return count;
+}
+
+template <typename T>
+std::optional<T> nextNumber(std::string_view& line)
+{
+  const auto token = nextToken(line);
+  const auto* end = token.data() + token.size();
+
+  auto value = T{};
+  const auto [ptr, ec] = std::from_chars(token.data(), end, value);
+  return ec == std::errc{} && ptr == end ? std::optional{value} : std::nullopt;
+}
+
+std::optional<Portal> parsePortal(std::string_view line, const bool prt1ForQ3)
+{
+  const auto pointCount = nextNumber<size_t>(line);
+  const auto leaf1 = nextNumber<size_t>(line);
+  const auto leaf2 = nextNumber<size_t>(line);
+  if (!pointCount || !leaf1 || !leaf2)
+  {
+    return std::nullopt;
+  }
+
+  if (prt1ForQ3)
+  {
+    nextToken(line); // hint (ignored)
+  }
+
+  auto vertices = std::vector<vm::vec3f>{};
+  for (size_t i = 0; i < *pointCount; ++i)
+  {
+    const auto x = nextNumber<float>(line);
+    const auto y = nextNumber<float>(line);
+    const auto z = nextNumber<float>(line);
+    if (!x || !y || !z)
+    {
+      return std::nullopt;
+    }
+    vertices.emplace_back(*x, *y, *z);
+  }
+
+  return Portal{vm::polygon3f{std::move(vertices)}, *leaf1, *leaf2};
+}
+
+Result<std::vector<Portal>> parsePortals(const PortalChunk& chunk, const bool prt1ForQ3)
+{
+  auto portals = std::vector<Portal>{};
+  portals.reserve(chunk.portalCount);
+
+  auto str = chunk.str;
+  for (size_t i = 0; i < chunk.portalCount; ++i)
+  {
+    auto portal = parsePortal(nextLine(str), prt1ForQ3);
+    if (!portal)
+    {
+      return Error{"Error reading portal"};
+    }
+    portals.push_back(std::move(*portal));
+  }
+
+  return portals;
+}
+
+/**
+ * Splits the first portalCount lines of the given string into chunks. Only the line
+ * breaks are scanned here, so this is cheap compared to parsing the lines.
+ */
+Result<std::vector<PortalChunk>> splitPortalChunks(
+  std::string_view str, size_t portalCount)
+{
+  auto chunks = std::vector<PortalChunk>{};
+  while (portalCount > 0)
+  {
+    const auto chunkPortalCount = std::min(portalCount, PortalsPerChunk);
+
+    auto rest = str;
+    for (size_t i = 0; i < chunkPortalCount; ++i)
+    {
+      if (rest.empty())
+      {
+        return Error{"Error reading portal"};
+      }
+      nextLine(rest);
+    }
+
+    chunks.push_back({str.substr(0, str.size() - rest.size()), chunkPortalCount});
+    str = rest;
+    portalCount -= chunkPortalCount;
+  }
+  return chunks;
+}
+
+} // namespace
 
 bool canLoadPortalFile(const std::filesystem::path& path)
 {
@@ -40,98 +192,67 @@ bool canLoadPortalFile(const std::filesystem::path& path)
          | kdl::transform_error([](const auto&) { return false; }) | kdl::value();
 }
 
-Result<std::vector<vm::polygon3f>> loadPortalFile(std::istream& stream)
+Result<std::vector<Portal>> loadPortalFile(
+  std::string_view str, kdl::task_manager& taskManager)
 {
-  static const auto lineSplitter = "() \n\t\r";
-
-  auto line = std::string{};
-  auto numPortals = 0ul;
+  auto numPortals = std::optional<size_t>{};
   auto prt1ForQ3 = false;
 
   // read header
-  std::getline(stream, line);
-  const auto formatCode = kdl::str_trim(line); // trim off any trailing \r
+  auto line = nextLine(str);
+  const auto formatCode = nextToken(line); // trim off any trailing \r
 
   if (formatCode == "PRT1")
   {
-    std::getline(stream, line); // number of leafs (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
-    const auto mark = stream.tellg();
-    std::getline(stream, line);
-    // If this line contains a single value, it is Q3-style PRT1 (value is
-    // number of solid faces -- will ignore). Otherwise is Q1/Q2 style and we
-    // will rewind the stream to process this line accordingly.
-    const auto componentsCheck = kdl::str_split(line, lineSplitter);
-    if (componentsCheck.size() == 1)
+    nextLine(str); // number of leafs (ignored)
+    line = nextLine(str);
+    numPortals = nextNumber<size_t>(line);
+
+    // If the next line contains a single value, it is Q3-style PRT1 (value is number of
+    // solid faces -- will ignore). Otherwise is Q1/Q2 style and the line is the first
+    // portal.
+    auto rest = str;
+    if (countTokens(nextLine(rest)) == 1)
     {
       prt1ForQ3 = true;
-    }
-    else
-    {
-      stream.seekg(mark);
+      str = rest;
     }
   }
   else if (formatCode == "PRT2")
   {
-    std::getline(stream, line); // number of leafs (ignored)
-    std::getline(stream, line); // number of clusters (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
+    nextLine(str); // number of leafs (ignored)
+    nextLine(str); // number of clusters (ignored)
+    line = nextLine(str);
+    numPortals = nextNumber<size_t>(line);
   }
   else if (formatCode == "PRT1-AM")
   {
-    std::getline(stream, line); // number of clusters (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
-    std::getline(stream, line); // number of leafs (ignored)
+    nextLine(str); // number of clusters (ignored)
+    line = nextLine(str);
+    numPortals = nextNumber<size_t>(line);
+    nextLine(str); // number of leafs (ignored)
   }
   else
   {
-    return Error{"Unknown portal format: " + formatCode};
+    return Error{"Unknown portal format: " + std::string{formatCode}};
   }
 
-  if (!stream.good())
+  if (!numPortals)
   {
     return Error{"Error reading header"};
   }
 
   // read portals
-  auto portals = std::vector<vm::polygon3f>{};
-  portals.reserve(numPortals);
-
-  for (size_t i = 0; i < numPortals; ++i)
-  {
-    std::getline(stream, line);
-    const auto components = kdl::str_split(line, lineSplitter);
-
-    if (!stream.good() || components.size() < 3)
-    {
-      return Error{"Error reading portal"};
-    }
-
-    auto verts = std::vector<vm::vec3f>{};
-    auto ptr = prt1ForQ3 ? 4u : 3u;
-    const int numPoints = std::stoi(components.at(0));
-    for (int j = 0; j < numPoints; ++j)
-    {
-      if (ptr + 2 >= components.size())
-      {
-        return Error{"Error reading portal"};
-      }
-
-      verts.emplace_back(
-        std::stof(components.at(ptr)),
-        std::stof(components.at(ptr + 1)),
-        std::stof(components.at(ptr + 2)));
-      ptr += 3;
-    }
-
-    portals.emplace_back(std::move(verts));
-  }
-
-  return portals;
+  return splitPortalChunks(str, *numPortals) | kdl::and_then([&](const auto& chunks) {
+           auto tasks = chunks | std::views::transform([&](const auto& chunk) {
+                          return std::function{
+                            [&]() { return parsePortals(chunk, prt1ForQ3); }};
+                        });
+           return kdl::fold_results(taskManager.run_tasks_and_wait(std::move(tasks)));
+         })
+         | kdl::transform([](auto chunkPortals) {
+             return kdl::vec_flatten(std::move(chunkPortals));
+           });
 }
 
-
 } // namespace tb::mdl
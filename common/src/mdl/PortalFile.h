@@ -23,14 +23,40 @@
 
 #include "vm/polygon.h"
 
+#include <cstddef>
 #include <filesystem>
-#include <iosfwd>
+#include <string_view>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 
+/**
+ * A portal between two leaves of the BSP tree of a compiled map. Depending on the format
+ * of the portal file, the leaves are clusters of BSP leaves.
+ */
+struct Portal
+{
+  vm::polygon3f polygon;
+  size_t leaf1;
+  size_t leaf2;
+
+  friend bool operator==(const Portal& lhs, const Portal& rhs) = default;
+};
+
 bool canLoadPortalFile(const std::filesystem::path& path);
-Result<std::vector<vm::polygon3f>> loadPortalFile(std::istream& stream);
+
+/**
+ * Parses the portals in the given portal file contents. The portal lines are split into
+ * chunks that are parsed in parallel, so the contents should be mapped from the file
+ * rather than copied.
+ */
+Result<std::vector<Portal>> loadPortalFile(
+  std::string_view str, kdl::task_manager& taskManager);
 
 } // namespace tb::mdl
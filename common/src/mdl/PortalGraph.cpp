@@ -0,0 +1,390 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PortalGraph.h"
+
+#include "mdl/PortalFile.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace tb::mdl
+{
+namespace
+{
+
+/**
+ * Points closer to a portal's plane than this are considered to be on the plane. The
+ * planes of a leaf are moved outward by the same distance, so that the faces bounding
+ * the leaf are contained in its region.
+ */
+constexpr auto PlaneEpsilon = 0.5;
+
+/**
+ * Portals are clipped at this distance in front of the view before they are projected.
+ */
+constexpr auto NearDistance = 0.01;
+
+/**
+ * Projected rectangles are enlarged by this amount to account for rounding errors.
+ */
+constexpr auto RectEpsilon = 0.001;
+
+/**
+ * Every time the visible part of a leaf grows, the leaf must be processed again. If the
+ * leaves are processed more often than this on average, the traversal is given up.
+ */
+constexpr auto MaxVisitsPerLeaf = size_t(8);
+
+constexpr auto Infinity = std::numeric_limits<double>::infinity();
+
+/**
+ * A rectangle on the plane at distance 1 in front of the view, in view coordinates. The
+ * part of a leaf that is visible through a chain of portals is contained in the pyramid
+ * spanned by the view position and such a rectangle.
+ */
+struct ViewRect
+{
+  double minX = -Infinity;
+  double maxX = Infinity;
+  double minY = -Infinity;
+  double maxY = Infinity;
+
+  bool empty() const { return minX > maxX || minY > maxY; }
+
+  bool contains(const ViewRect& other) const
+  {
+    return minX <= other.minX && maxX >= other.maxX && minY <= other.minY
+           && maxY >= other.maxY;
+  }
+};
+
+ViewRect intersect(const ViewRect& lhs, const ViewRect& rhs)
+{
+  return {
+    std::max(lhs.minX, rhs.minX),
+    std::min(lhs.maxX, rhs.maxX),
+    std::max(lhs.minY, rhs.minY),
+    std::min(lhs.maxY, rhs.maxY)};
+}
+
+ViewRect merge(const ViewRect& lhs, const ViewRect& rhs)
+{
+  return {
+    std::min(lhs.minX, rhs.minX),
+    std::max(lhs.maxX, rhs.maxX),
+    std::min(lhs.minY, rhs.minY),
+    std::max(lhs.maxY, rhs.maxY)};
+}
+
+std::optional<vm::plane3d> planeFromVertices(const std::vector<vm::vec3d>& vertices)
+{
+  if (vertices.size() < 3)
+  {
+    return std::nullopt;
+  }
+
+  // Newell's method also works for slightly non-planar polygons
+  auto normal = vm::vec3d{};
+  auto center = vm::vec3d{};
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    normal = normal + vm::cross(vertices[i], vertices[(i + 1) % vertices.size()]);
+    center = center + vertices[i];
+  }
+
+  const auto length = vm::length(normal);
+  if (length < vm::Cd::almost_zero())
+  {
+    return std::nullopt;
+  }
+  return vm::plane3d{center / double(vertices.size()), normal / length};
+}
+
+/**
+ * Returns the rectangle that contains the projection of the part of the given polygon
+ * that is in front of the view, or an empty rectangle if no part of it is.
+ */
+ViewRect projectPolygon(const std::vector<vm::vec3d>& vertices, const PortalView& view)
+{
+  auto rect = ViewRect{Infinity, -Infinity, Infinity, -Infinity};
+  const auto addPoint = [&](const vm::vec3d& point) {
+    const auto x = point.x() / point.z();
+    const auto y = point.y() / point.z();
+    rect = {
+      std::min(rect.minX, x - RectEpsilon),
+      std::max(rect.maxX, x + RectEpsilon),
+      std::min(rect.minY, y - RectEpsilon),
+      std::max(rect.maxY, y + RectEpsilon)};
+  };
+
+  const auto viewVertices = kdl::vec_transform(vertices, [&](const auto& vertex) {
+    const auto offset = vertex - view.position;
+    return vm::vec3d{
+      vm::dot(offset, view.right),
+      vm::dot(offset, view.up),
+      vm::dot(offset, view.direction)};
+  });
+
+  for (size_t i = 0; i < viewVertices.size(); ++i)
+  {
+    const auto& current = viewVertices[i];
+    const auto& next = viewVertices[(i + 1) % viewVertices.size()];
+    const auto currentInFront = current.z() >= NearDistance;
+    const auto nextInFront = next.z() >= NearDistance;
+
+    if (currentInFront)
+    {
+      addPoint(current);
+    }
+    if (currentInFront != nextInFront)
+    {
+      const auto t = (NearDistance - current.z()) / (next.z() - current.z());
+      addPoint(current + (next - current) * t);
+    }
+  }
+
+  return rect;
+}
+
+/**
+ * Returns the planes of the pyramid spanned by the view position and the given rectangle.
+ * The normals point out of the pyramid.
+ */
+std::vector<vm::plane3d> pyramidPlanes(const ViewRect& rect, const PortalView& view)
+{
+  auto result = std::vector<vm::plane3d>{};
+  const auto addPlane = [&](const vm::vec3d& normal) {
+    result.emplace_back(view.position, vm::normalize(normal));
+  };
+
+  if (rect.minX > -Infinity)
+  {
+    addPlane(view.direction * rect.minX - view.right);
+  }
+  if (rect.maxX < Infinity)
+  {
+    addPlane(view.right - view.direction * rect.maxX);
+  }
+  if (rect.minY > -Infinity)
+  {
+    addPlane(view.direction * rect.minY - view.up);
+  }
+  if (rect.maxY < Infinity)
+  {
+    addPlane(view.up - view.direction * rect.maxY);
+  }
+  return result;
+}
+
+} // namespace
+
+PortalGraph::PortalGraph(const std::vector<Portal>& portals)
+{
+  m_portals.reserve(portals.size());
+  for (size_t i = 0; i < portals.size(); ++i)
+  {
+    const auto& portal = portals[i];
+    auto vertices = kdl::vec_transform(
+      portal.polygon.vertices(), [](const auto& vertex) { return vm::vec3d{vertex}; });
+    auto plane = planeFromVertices(vertices);
+    m_portals.push_back({std::move(vertices), plane});
+
+    const auto leafCount = std::max(portal.leaf1, portal.leaf2) + 1;
+    if (m_leaves.size() < leafCount)
+    {
+      m_leaves.resize(leafCount);
+    }
+
+    if (plane && portal.leaf1 != portal.leaf2)
+    {
+      m_leaves[portal.leaf1].portals.push_back({i, portal.leaf2, Side::Unknown});
+      m_leaves[portal.leaf2].portals.push_back({i, portal.leaf1, Side::Unknown});
+    }
+  }
+
+  for (auto& leaf : m_leaves)
+  {
+    for (auto& leafPortal : leaf.portals)
+    {
+      leafPortal.side = findSide(leaf, leafPortal.portal);
+    }
+  }
+
+  // if all other portals of a leaf are on the plane of a portal, e.g. because the leaf
+  // has only one portal, the side of the leaf is the opposite of that of its neighbour
+  for (auto& leaf : m_leaves)
+  {
+    for (auto& leafPortal : leaf.portals)
+    {
+      if (leafPortal.side == Side::Unknown)
+      {
+        for (const auto& neighbourPortal : m_leaves[leafPortal.neighbour].portals)
+        {
+          if (neighbourPortal.portal == leafPortal.portal)
+          {
+            leafPortal.side = neighbourPortal.side == Side::Front  ? Side::Back
+                              : neighbourPortal.side == Side::Back ? Side::Front
+                                                                   : Side::Unknown;
+          }
+        }
+      }
+    }
+  }
+
+  for (auto& leaf : m_leaves)
+  {
+    for (const auto& leafPortal : leaf.portals)
+    {
+      const auto& plane = *m_portals[leafPortal.portal].plane;
+      if (leafPortal.side == Side::Back)
+      {
+        leaf.planes.emplace_back(plane.distance + PlaneEpsilon, plane.normal);
+      }
+      else if (leafPortal.side == Side::Front)
+      {
+        leaf.planes.emplace_back(-plane.distance + PlaneEpsilon, -plane.normal);
+      }
+    }
+  }
+}
+
+std::optional<std::vector<std::vector<vm::plane3d>>> PortalGraph::visibleVolumes(
+  const PortalView& view) const
+{
+  // the regions of the leaves may overlap, so the view may be in several of them
+  auto rects = std::vector<std::optional<ViewRect>>(m_leaves.size());
+  auto queue = std::deque<size_t>{};
+  auto queued = std::vector<bool>(m_leaves.size(), false);
+  for (size_t i = 0; i < m_leaves.size(); ++i)
+  {
+    const auto& leaf = m_leaves[i];
+    if (
+      !leaf.portals.empty() && std::ranges::all_of(leaf.planes, [&](const auto& plane) {
+        return plane.point_distance(view.position) <= 0.0;
+      }))
+    {
+      rects[i] = ViewRect{};
+      queue.push_back(i);
+      queued[i] = true;
+    }
+  }
+
+  if (queue.empty())
+  {
+    return std::nullopt;
+  }
+
+  const auto portalRects = kdl::vec_transform(
+    m_portals, [&](const auto& portal) { return projectPolygon(portal.vertices, view); });
+  const auto viewSides = kdl::vec_transform(m_portals, [&](const auto& portal) {
+    const auto distance =
+      portal.plane ? portal.plane->point_distance(view.position) : 0.0;
+    return distance > PlaneEpsilon    ? Side::Front
+           : distance < -PlaneEpsilon ? Side::Back
+                                      : Side::Unknown;
+  });
+
+  const auto maxVisits = MaxVisitsPerLeaf * m_leaves.size();
+  auto visits = size_t(0);
+  while (!queue.empty())
+  {
+    const auto leafIndex = queue.front();
+    queue.pop_front();
+    queued[leafIndex] = false;
+
+    if (++visits > maxVisits)
+    {
+      return std::nullopt;
+    }
+
+    const auto rect = *rects[leafIndex];
+    for (const auto& leafPortal : m_leaves[leafIndex].portals)
+    {
+      // a line of sight crosses the plane of a portal only once, so the view must be on
+      // the side of the leaf that it looks out of
+      const auto viewSide = viewSides[leafPortal.portal];
+      if (
+        viewSide != Side::Unknown && leafPortal.side != Side::Unknown
+        && viewSide != leafPortal.side)
+      {
+        continue;
+      }
+
+      const auto visibleRect = intersect(rect, portalRects[leafPortal.portal]);
+      if (visibleRect.empty())
+      {
+        continue;
+      }
+
+      auto& neighbourRect = rects[leafPortal.neighbour];
+      if (!neighbourRect || !neighbourRect->contains(visibleRect))
+      {
+        neighbourRect = neighbourRect ? merge(*neighbourRect, visibleRect) : visibleRect;
+        if (!queued[leafPortal.neighbour])
+        {
+          queue.push_back(leafPortal.neighbour);
+          queued[leafPortal.neighbour] = true;
+        }
+      }
+    }
+  }
+
+  auto result = std::vector<std::vector<vm::plane3d>>{};
+  for (size_t i = 0; i < m_leaves.size(); ++i)
+  {
+    if (rects[i])
+    {
+      result.push_back(kdl::vec_concat(
+        m_leaves[i].planes, view.volume, pyramidPlanes(*rects[i], view)));
+    }
+  }
+  return result;
+}
+
+PortalGraph::Side PortalGraph::findSide(const Leaf& leaf, const size_t portalIndex) const
+{
+  const auto& plane = *m_portals[portalIndex].plane;
+
+  auto front = false;
+  auto back = false;
+  for (const auto& leafPortal : leaf.portals)
+  {
+    if (leafPortal.portal != portalIndex)
+    {
+      for (const auto& vertex : m_portals[leafPortal.portal].vertices)
+      {
+        const auto distance = plane.point_distance(vertex);
+        front = front || distance > PlaneEpsilon;
+        back = back || distance < -PlaneEpsilon;
+      }
+    }
+  }
+
+  return front && !back   ? Side::Front
+         : back && !front ? Side::Back
+                          : Side::Unknown;
+}
+
+} // namespace tb::mdl
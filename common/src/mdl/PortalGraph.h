@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <optional>
+#include <vector>
+
+namespace tb::mdl
+{
+struct Portal;
+
+/**
+ * The position and orientation of a view and the planes of its view volume, whose normals
+ * point out of the volume.
+ */
+struct PortalView
+{
+  vm::vec3d position;
+  vm::vec3d direction;
+  vm::vec3d right;
+  vm::vec3d up;
+  std::vector<vm::plane3d> volume;
+};
+
+/**
+ * The leaves of a compiled map and the portals that connect them, used to find the parts
+ * of the map that can be seen from a given position.
+ *
+ * Every leaf is a convex region, but a portal file does not contain the solid faces that
+ * bound it. The region of a leaf is approximated by the intersection of the half spaces
+ * behind its portals, so it contains the leaf, but it can be much larger.
+ *
+ * The graph describes the map as it was compiled. Geometry that was added outside of the
+ * leaves afterwards is not visible.
+ */
+class PortalGraph
+{
+private:
+  struct PortalData
+  {
+    std::vector<vm::vec3d> vertices;
+    std::optional<vm::plane3d> plane;
+  };
+
+  enum class Side
+  {
+    Front,
+    Back,
+    Unknown,
+  };
+
+  struct LeafPortal
+  {
+    size_t portal;
+    size_t neighbour;
+    /** The side of the portal's plane that the leaf is on. */
+    Side side;
+  };
+
+  struct Leaf
+  {
+    std::vector<LeafPortal> portals;
+    /** The normals point out of the leaf. */
+    std::vector<vm::plane3d> planes;
+  };
+
+  std::vector<PortalData> m_portals;
+  std::vector<Leaf> m_leaves;
+
+public:
+  explicit PortalGraph(const std::vector<Portal>& portals);
+
+  /**
+   * Returns convex volumes whose union contains everything that can be seen from the
+   * given view, one for each leaf that is visible through a chain of portals. The normals
+   * of the planes point out of the volumes.
+   *
+   * Returns nullopt if the view's position is not in any leaf, e.g. because it is outside
+   * of the map, or if too many portals must be traversed.
+   */
+  std::optional<std::vector<std::vector<vm::plane3d>>> visibleVolumes(
+    const PortalView& view) const;
+
+private:
+  Side findSide(const Leaf& leaf, size_t portalIndex) const;
+};
+
+} // namespace tb::mdl
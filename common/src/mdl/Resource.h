@@ -27,6 +27,7 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
 
+#include <atomic>
 #include <functional>
 #include <future>
 #include <iostream>
@@ -39,6 +40,19 @@ namespace tb::mdl
 template <typename T>
 using ResourceLoader = std::function<Result<T>()>;
 
+enum class ResourceLoadMode
+{
+  /**
+   * The resource is loaded as soon as it is processed.
+   */
+  Eager,
+  /**
+   * The resource is only loaded once loading it was requested. A loaded lazy resource
+   * can be evicted, returning it to the unloaded state.
+   */
+  Lazy,
+};
+
 using ErrorHandler = std::function<void(const ResourceId&, const std::string&)>;
 
 struct ProcessContext
@@ -218,6 +232,10 @@ ResourceState<T> drop(ResourceDropping<T> state, const bool glContextAvailable)
  * | Dropping       | process          | Dropped         |
  * | Dropped        | -                | -               |
  * | Failed         | -                | -               |
+ *
+ * A lazy resource remains unloaded when it is processed until loading it is requested.
+ * If its eviction was requested, a ready lazy resource is dropped and becomes unloaded
+ * again when it is processed.
  */
 template <typename T>
 class Resource
@@ -226,11 +244,21 @@ private:
   ResourceId m_id;
   ResourceState<T> m_state;
 
+  // Only lazy resources keep their loader so that they can be loaded again when evicted.
+  ResourceLoader<T> m_loader;
+
+  // Loading and eviction may be requested from const accessors, and from any thread.
+  mutable std::atomic<bool> m_loadRequested = true;
+  mutable std::atomic<bool> m_evictionRequested = false;
+
   kdl_reflect_inline(Resource, m_state);
 
 public:
-  explicit Resource(ResourceLoader<T> loader)
-    : m_state(ResourceUnloaded<T>{std::move(loader)})
+  explicit Resource(
+    ResourceLoader<T> loader, const ResourceLoadMode loadMode = ResourceLoadMode::Eager)
+    : m_state(ResourceUnloaded<T>{loader})
+    , m_loader{loadMode == ResourceLoadMode::Lazy ? std::move(loader) : nullptr}
+    , m_loadRequested{loadMode == ResourceLoadMode::Eager}
   {
   }
 
@@ -239,7 +267,26 @@ public:
   {
   }
 
-  moveOnly(Resource);
+  Resource(Resource&& other) noexcept
+    : m_id{std::move(other.m_id)}
+    , m_state{std::move(other.m_state)}
+    , m_loader{std::move(other.m_loader)}
+    , m_loadRequested{other.m_loadRequested.load()}
+    , m_evictionRequested{other.m_evictionRequested.load()}
+  {
+  }
+
+  Resource& operator=(Resource&& other) noexcept
+  {
+    m_id = std::move(other.m_id);
+    m_state = std::move(other.m_state);
+    m_loader = std::move(other.m_loader);
+    m_loadRequested = other.m_loadRequested.load();
+    m_evictionRequested = other.m_evictionRequested.load();
+    return *this;
+  }
+
+  deleteCopy(Resource);
 
   const ResourceId& id() const { return m_id; }
 
@@ -267,10 +314,57 @@ public:
 
   bool isDropped() const { return std::holds_alternative<ResourceDropped>(m_state); }
 
+  bool isUnloaded() const
+  {
+    return std::holds_alternative<ResourceUnloaded<T>>(m_state);
+  }
+
+  bool isLoaded() const { return std::holds_alternative<ResourceLoaded<T>>(m_state); }
+
+  /**
+   * Indicates whether this resource is being loaded or was loaded, but not uploaded yet.
+   */
+  bool isPending() const
+  {
+    return std::holds_alternative<ResourceLoading<T>>(m_state) || isLoaded();
+  }
+
+  bool isLoadRequested() const { return m_loadRequested; }
+
+  /**
+   * Requests that a lazy resource is loaded when it is processed the next time. Has no
+   * effect on eager resources.
+   */
+  void requestLoading() const
+  {
+    m_evictionRequested = false;
+    m_loadRequested = true;
+  }
+
+  bool isEvictionRequested() const { return m_evictionRequested; }
+
+  /**
+   * Requests that a lazy resource is evicted when it is processed the next time. Has no
+   * effect on eager resources. A later request to load the resource cancels the eviction.
+   */
+  void requestEviction() const
+  {
+    if (m_loader)
+    {
+      m_loadRequested = false;
+      m_evictionRequested = true;
+    }
+  }
+
   bool needsProcessing() const
   {
-    return !std::holds_alternative<ResourceReady<T>>(m_state)
-           && !std::holds_alternative<ResourceFailed>(m_state);
+    if (std::holds_alternative<ResourceReady<T>>(m_state))
+    {
+      return isEvictionRequested();
+    }
+
+    return !std::holds_alternative<ResourceFailed>(m_state)
+           && (!isUnloaded() || isLoadRequested());
   }
 
   bool process(TaskRunner taskRunner, const ProcessContext& context)
@@ -279,6 +373,10 @@ public:
     m_state = std::visit(
       kdl::overload(
         [&](ResourceUnloaded<T> state) -> ResourceState<T> {
+          if (!isLoadRequested())
+          {
+            return state;
+          }
           return detail::triggerLoading(std::move(state), taskRunner);
         },
         [&](ResourceLoading<T> state) -> ResourceState<T> {
@@ -287,6 +385,15 @@ public:
         [&](ResourceLoaded<T> state) -> ResourceState<T> {
           return detail::upload(std::move(state), context.glContextAvailable);
         },
+        [&](ResourceReady<T> state) -> ResourceState<T> {
+          if (!isEvictionRequested())
+          {
+            return state;
+          }
+          m_evictionRequested = false;
+          state.resource.drop(context.glContextAvailable);
+          return ResourceUnloaded<T>{m_loader};
+        },
         [&](ResourceDropping<T> state) -> ResourceState<T> {
           return detail::drop(std::move(state), context.glContextAvailable);
         },
@@ -25,6 +25,7 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -42,6 +43,9 @@ public:
   virtual long useCount() const = 0;
 
   virtual bool isDropped() const = 0;
+  virtual bool isUnloaded() const = 0;
+  virtual bool isLoaded() const = 0;
+  virtual bool isPending() const = 0;
   virtual bool needsProcessing() const = 0;
 
   virtual void drop() = 0;
@@ -65,6 +69,9 @@ public:
   const ResourceId& id() const override { return m_resource->id(); }
   long useCount() const override { return m_resource.use_count(); }
   bool isDropped() const override { return m_resource->isDropped(); }
+  bool isUnloaded() const override { return m_resource->isUnloaded(); }
+  bool isLoaded() const override { return m_resource->isLoaded(); }
+  bool isPending() const override { return m_resource->isPending(); }
   bool needsProcessing() const override { return m_resource->needsProcessing(); }
   void drop() override { m_resource->drop(); }
   bool process(TaskRunner taskRunner, const ProcessContext& processContext) override
@@ -108,10 +115,25 @@ public:
       std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource)));
   }
 
+  /**
+   * Advances the state of every resource by one step.
+   *
+   * Uploading is the only step that must happen on the calling thread and that can take
+   * a significant amount of time, so only uploads are subject to the given timeout. The
+   * remaining loaded resources are uploaded in subsequent calls.
+   *
+   * If a maximum number of pending resources is given, loading is only triggered for as
+   * many resources as can be pending at once, a resource being pending while it is
+   * loaded on a worker thread or waiting to be uploaded. This bounds the amount of
+   * memory held by decoded resources.
+   *
+   * Returns the IDs of the resources whose state changed.
+   */
   std::vector<ResourceId> process(
     TaskRunner taskRunner,
     const ProcessContext& processContext,
-    std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+    std::optional<std::chrono::milliseconds> timeout = std::nullopt,
+    std::optional<size_t> maxPendingResources = std::nullopt)
   {
     const auto checkTimeout =
       timeout ? std::function{[timeout_ = *timeout,
@@ -121,8 +143,12 @@ public:
               : std::function{[]() { return true; }};
 
     auto result = std::vector<ResourceId>{};
+    auto pendingResourceCount = size_t(std::count_if(
+      m_resources.begin(), m_resources.end(), [](const auto& resourceWrapper) {
+        return resourceWrapper->isPending();
+      }));
 
-    for (auto it = m_resources.begin(); it != m_resources.end() && checkTimeout();)
+    for (auto it = m_resources.begin(); it != m_resources.end();)
     {
       auto& resourceWrapper = *it;
       if (resourceWrapper->useCount() == 1 && !resourceWrapper->isDropped())
@@ -130,12 +156,26 @@ public:
         resourceWrapper->drop();
       }
 
-      if (resourceWrapper->needsProcessing())
+      const auto deferLoading = resourceWrapper->isUnloaded() && maxPendingResources
+                                && pendingResourceCount >= *maxPendingResources;
+      const auto deferUpload = resourceWrapper->isLoaded() && !checkTimeout();
+
+      if (resourceWrapper->needsProcessing() && !deferLoading && !deferUpload)
       {
+        const auto wasPending = resourceWrapper->isPending();
         if (resourceWrapper->process(taskRunner, processContext))
         {
           result.push_back(resourceWrapper->id());
         }
+
+        if (wasPending && !resourceWrapper->isPending())
+        {
+          --pendingResourceCount;
+        }
+        else if (!wasPending && resourceWrapper->isPending())
+        {
+          ++pendingResourceCount;
+        }
       }
 
       it = resourceWrapper->useCount() == 1 && resourceWrapper->isDropped()
@@ -28,11 +28,13 @@
 #include "mdl/Node.h"
 #include "mdl/NodeQueries.h"
 #include "mdl/PatchNode.h"
+#include "mdl/SelectionChange.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/overload.h"
 #include "kdl/ranges/to.h"
 #include "kdl/reflection_impl.h"
+#include "kdl/vector_set.h"
 
 #include <ranges>
 
@@ -116,6 +118,94 @@ std::vector<BrushFaceHandle> computeAllBrushFaces(
   return faceSelectionWithLinkedGroupConstraints(worldNode, faces).facesToSelect;
 }
 
+void collectSelectedNodes(Selection& selection, WorldNode& rootNode)
+{
+  // skip all subtrees that don't contain any selected nodes
+  const auto visitSelectedChildren = [](auto* node, const auto& visitor) {
+    if (node->descendantSelected())
+    {
+      node->visitChildren(visitor);
+    }
+  };
+
+  rootNode.accept(kdl::overload(
+    [&](auto&& thisLambda, WorldNode* worldNode) {
+      visitSelectedChildren(worldNode, thisLambda);
+    },
+    [&](auto&& thisLambda, LayerNode* layerNode) {
+      visitSelectedChildren(layerNode, thisLambda);
+    },
+    [&](auto&& thisLambda, GroupNode* groupNode) {
+      if (groupNode->selected())
+      {
+        selection.nodes.push_back(groupNode);
+        selection.groups.push_back(groupNode);
+      }
+      visitSelectedChildren(groupNode, thisLambda);
+    },
+    [&](auto&& thisLambda, EntityNode* entityNode) {
+      if (entityNode->selected())
+      {
+        selection.nodes.push_back(entityNode);
+        selection.entities.push_back(entityNode);
+      }
+      visitSelectedChildren(entityNode, thisLambda);
+    },
+    [&](BrushNode* brushNode) {
+      if (brushNode->selected())
+      {
+        selection.nodes.push_back(brushNode);
+        selection.brushes.push_back(brushNode);
+      }
+    },
+    [&](PatchNode* patchNode) {
+      if (patchNode->selected())
+      {
+        selection.nodes.push_back(patchNode);
+        selection.patches.push_back(patchNode);
+      }
+    }));
+}
+
+void collectSelectedBrushFaces(Selection& selection, WorldNode& rootNode)
+{
+  rootNode.accept(kdl::overload(
+    [](auto&& thisLambda, WorldNode* worldNode) { worldNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, LayerNode* layerNode) { layerNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, GroupNode* groupNode) { groupNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, EntityNode* entityNode) {
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](BrushNode* brushNode) {
+      if (brushNode->hasSelectedFaces())
+      {
+        const auto& faces = brushNode->brush().faces();
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+          if (faces[i].selected())
+          {
+            selection.brushFaces.emplace_back(brushNode, i);
+          }
+        }
+      }
+    },
+    [](PatchNode*) {}));
+}
+
+template <typename T, typename S>
+void eraseContained(std::vector<T>& values, const S& valuesToErase)
+{
+  std::erase_if(
+    values, [&](const auto& value) { return valuesToErase.count(value) > 0; });
+}
+
+void updateCachedSelection(Selection& selection, WorldNode& rootNode)
+{
+  selection.cachedAllEntities = computeAllEntities(selection, rootNode);
+  selection.cachedAllBrushes = computeAllBrushes(selection);
+  selection.cachedAllBrushFaces = computeAllBrushFaces(selection, rootNode);
+}
+
 } // namespace
 
 kdl_reflect_impl(Selection);
@@ -198,56 +288,49 @@ const std::vector<BrushFaceHandle>& Selection::allBrushFaces() const
 Selection computeSelection(WorldNode& rootNode)
 {
   auto selection = Selection{};
+  collectSelectedNodes(selection, rootNode);
+  collectSelectedBrushFaces(selection, rootNode);
+  updateCachedSelection(selection, rootNode);
 
-  rootNode.accept(kdl::overload(
-    [&](
-      auto&& thisLambda, WorldNode* worldNode) { worldNode->visitChildren(thisLambda); },
-    [&](
-      auto&& thisLambda, LayerNode* layerNode) { layerNode->visitChildren(thisLambda); },
-    [&](auto&& thisLambda, GroupNode* groupNode) {
-      if (groupNode->selected())
-      {
-        selection.nodes.push_back(groupNode);
-        selection.groups.push_back(groupNode);
-      }
-      groupNode->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, EntityNode* entityNode) {
-      if (entityNode->selected())
-      {
-        selection.nodes.push_back(entityNode);
-        selection.entities.push_back(entityNode);
-      }
-      entityNode->visitChildren(thisLambda);
-    },
-    [&](BrushNode* brushNode) {
-      if (brushNode->selected())
-      {
-        selection.nodes.push_back(brushNode);
-        selection.brushes.push_back(brushNode);
-      }
+  return selection;
+}
 
-      const auto& faces = brushNode->brush().faces();
-      for (size_t i = 0; i < faces.size(); ++i)
-      {
-        if (faces[i].selected())
-        {
-          selection.brushFaces.emplace_back(brushNode, i);
-        }
-      }
-    },
-    [&](PatchNode* patchNode) {
-      if (patchNode->selected())
-      {
-        selection.nodes.push_back(patchNode);
-        selection.patches.push_back(patchNode);
-      }
-    }));
+Selection updateSelection(
+  Selection selection, const SelectionChange& selectionChange, WorldNode& rootNode)
+{
+  if (!selectionChange.selectedNodes.empty())
+  {
+    // newly selected nodes must be inserted in tree order
+    selection.nodes.clear();
+    selection.groups.clear();
+    selection.entities.clear();
+    selection.brushes.clear();
+    selection.patches.clear();
+    collectSelectedNodes(selection, rootNode);
+  }
+  else if (!selectionChange.deselectedNodes.empty())
+  {
+    const auto deselectedNodes = kdl::vector_set<Node*>(selectionChange.deselectedNodes);
+    eraseContained(selection.nodes, deselectedNodes);
+    eraseContained(selection.groups, deselectedNodes);
+    eraseContained(selection.entities, deselectedNodes);
+    eraseContained(selection.brushes, deselectedNodes);
+    eraseContained(selection.patches, deselectedNodes);
+  }
 
-  selection.cachedAllEntities = computeAllEntities(selection, rootNode);
-  selection.cachedAllBrushes = computeAllBrushes(selection);
-  selection.cachedAllBrushFaces = computeAllBrushFaces(selection, rootNode);
+  if (!selectionChange.selectedBrushFaces.empty())
+  {
+    selection.brushFaces.clear();
+    collectSelectedBrushFaces(selection, rootNode);
+  }
+  else if (!selectionChange.deselectedBrushFaces.empty())
+  {
+    const auto deselectedBrushFaces =
+      kdl::vector_set<BrushFaceHandle>(selectionChange.deselectedBrushFaces);
+    eraseContained(selection.brushFaces, deselectedBrushFaces);
+  }
 
+  updateCachedSelection(selection, rootNode);
   return selection;
 }
 
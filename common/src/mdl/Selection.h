@@ -35,6 +35,7 @@ class LayerNode;
 class Node;
 class PatchNode;
 class WorldNode;
+struct SelectionChange;
 
 struct Selection
 {
@@ -92,4 +93,16 @@ struct Selection
 
 Selection computeSelection(WorldNode& rootNode);
 
+/**
+ * Applies the given selection change to the given selection, which must reflect the
+ * selection state before the change.
+ *
+ * Deselected nodes and brush faces are removed without visiting the node tree. If nodes
+ * were selected, only the subtrees containing selected nodes are visited to collect the
+ * selected nodes in tree order. Brush faces are recollected from the entire tree only if
+ * brush faces were selected.
+ */
+Selection updateSelection(
+  Selection selection, const SelectionChange& selectionChange, WorldNode& rootNode);
+
 } // namespace tb::mdl
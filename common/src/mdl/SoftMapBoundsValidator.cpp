@@ -21,6 +21,7 @@
 
 #include "mdl/BrushNode.h"
 #include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
 #include "mdl/Game.h"
 #include "mdl/Issue.h"
 #include "mdl/IssueQuickFix.h"
@@ -35,21 +36,6 @@ namespace tb::mdl
 namespace
 {
 const auto Type = freeIssueType();
-
-void validateInternal(
-  const Game& game,
-  const WorldNode& worldNode,
-  Node& node,
-  std::vector<std::unique_ptr<Issue>>& issues)
-{
-  const auto bounds = game.extractSoftMapBounds(worldNode.entity());
-
-  if (bounds.bounds && !bounds.bounds->contains(node.logicalBounds()))
-  {
-    issues.push_back(
-      std::make_unique<Issue>(Type, node, "Object is out of soft map bounds"));
-  }
-}
 } // namespace
 
 SoftMapBoundsValidator::SoftMapBoundsValidator(const Game& game, const WorldNode& world)
@@ -60,22 +46,53 @@ SoftMapBoundsValidator::SoftMapBoundsValidator(const Game& game, const WorldNode
   addQuickFix(makeDeleteNodesQuickFix());
 }
 
+std::optional<vm::bbox3d> SoftMapBoundsValidator::softMapBounds() const
+{
+  const auto* propertyValue =
+    m_world.entity().property(EntityPropertyKeys::SoftMapBounds);
+
+  const auto lock = std::lock_guard{m_cacheMutex};
+  const auto cacheIsValid =
+    m_cache
+    && (propertyValue ? m_cache->propertyValue == *propertyValue
+                      : !m_cache->propertyValue);
+  if (!cacheIsValid)
+  {
+    m_cache = CachedSoftMapBounds{
+      propertyValue ? std::optional{*propertyValue} : std::nullopt,
+      m_game.extractSoftMapBounds(m_world.entity()),
+    };
+  }
+  return m_cache->softMapBounds.bounds;
+}
+
+void SoftMapBoundsValidator::validateInternal(
+  Node& node, std::vector<std::unique_ptr<Issue>>& issues) const
+{
+  const auto bounds = softMapBounds();
+  if (bounds && !bounds->contains(node.logicalBounds()))
+  {
+    issues.push_back(
+      std::make_unique<Issue>(Type, node, "Object is out of soft map bounds"));
+  }
+}
+
 void SoftMapBoundsValidator::doValidate(
   EntityNode& entityNode, std::vector<std::unique_ptr<Issue>>& issues) const
 {
-  validateInternal(m_game, m_world, entityNode, issues);
+  validateInternal(entityNode, issues);
 }
 
 void SoftMapBoundsValidator::doValidate(
   BrushNode& brushNode, std::vector<std::unique_ptr<Issue>>& issues) const
 {
-  validateInternal(m_game, m_world, brushNode, issues);
+  validateInternal(brushNode, issues);
 }
 
 void SoftMapBoundsValidator::doValidate(
   PatchNode& patchNode, std::vector<std::unique_ptr<Issue>>& issues) const
 {
-  validateInternal(m_game, m_world, patchNode, issues);
+  validateInternal(patchNode, issues);
 }
 
 } // namespace tb::mdl
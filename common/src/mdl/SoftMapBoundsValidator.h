@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include "mdl/SoftMapBounds.h"
 #include "mdl/Validator.h"
 
+#include <mutex>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace tb::mdl
@@ -35,10 +39,27 @@ private:
   const Game& m_game;
   const WorldNode& m_world;
 
+  struct CachedSoftMapBounds
+  {
+    std::optional<std::string> propertyValue;
+    SoftMapBounds softMapBounds;
+  };
+
+  /**
+   * The soft map bounds are parsed from a property of the world entity. They are cached
+   * so that they aren't parsed again for every node. Nodes are validated concurrently, so
+   * the cache is guarded by a mutex.
+   */
+  mutable std::mutex m_cacheMutex;
+  mutable std::optional<CachedSoftMapBounds> m_cache;
+
 public:
   explicit SoftMapBoundsValidator(const Game& game, const WorldNode& world);
 
 private:
+  std::optional<vm::bbox3d> softMapBounds() const;
+  void validateInternal(Node& node, std::vector<std::unique_ptr<Issue>>& issues) const;
+
   void doValidate(
     EntityNode& entityNode, std::vector<std::unique_ptr<Issue>>& issues) const override;
   void doValidate(
@@ -22,13 +22,17 @@
 #include "Notifier.h"
 #include "mdl/Game.h"
 #include "mdl/Map.h"
+#include "mdl/MemoryUsage.h"
 #include "mdl/Node.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/ranges/to.h"
 #include "kdl/vector_utils.h"
 
 #include <ranges>
+#include <typeinfo>
+#include <unordered_set>
 
 namespace tb::mdl
 {
@@ -98,6 +102,7 @@ void doSwapNodeContents(
   auto notifyMods = NotifyBeforeAndAfter{
     notifyModsChange, map.modsWillChangeNotifier, map.modsDidChangeNotifier};
 
+  const auto deferNodeTreeUpdates = DeferNodeTreeUpdates{*map.world()};
   for (auto& pair : nodesToSwap)
   {
     auto* node = pair.first;
@@ -167,4 +172,50 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
   return false;
 }
 
+bool SwapNodeContentsCommand::doCompactWith(UndoableCommand& command)
+{
+  if (
+    typeid(*this) != typeid(SwapNodeContentsCommand)
+    || typeid(command) != typeid(SwapNodeContentsCommand))
+  {
+    return false;
+  }
+
+  auto& other = static_cast<SwapNodeContentsCommand&>(command);
+
+  // The linked group updates of the other command would be lost, and merging them is
+  // only correct if they don't interact with the swapped nodes.
+  if (hasLinkedGroupUpdates() || other.hasLinkedGroupUpdates())
+  {
+    return false;
+  }
+
+  // Both commands have been executed, so their snapshots contain the contents of their
+  // nodes before each command was executed. The snapshots of this command are older.
+  const auto myNodes =
+    m_nodes | std::views::transform([](const auto& pair) { return pair.first; })
+    | kdl::ranges::to<std::unordered_set>();
+  for (auto& pair : other.m_nodes)
+  {
+    if (!myNodes.contains(pair.first))
+    {
+      m_nodes.push_back(std::move(pair));
+    }
+  }
+  other.m_nodes.clear();
+
+  return true;
+}
+
+size_t SwapNodeContentsCommand::memoryUsage() const
+{
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage()
+                + m_nodes.capacity() * sizeof(std::pair<Node*, NodeContents>);
+  for (const auto& [node, contents] : m_nodes)
+  {
+    result += mdl::memoryUsage(contents);
+  }
+  return result;
+}
+
 } // namespace tb::mdl
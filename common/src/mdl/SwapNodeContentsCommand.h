@@ -46,6 +46,16 @@ public:
 
   bool doCollateWith(UndoableCommand& command) override;
 
+  /**
+   * Merges the snapshots of another SwapNodeContentsCommand into this command, keeping
+   * only the oldest snapshot of every node. Subclasses are not compacted because their
+   * observers depend on the individual commands, and neither are commands that updated
+   * linked groups.
+   */
+  bool doCompactWith(UndoableCommand& command) override;
+
+  size_t memoryUsage() const override;
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 
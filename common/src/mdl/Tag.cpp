@@ -244,6 +244,11 @@ bool TagMatcher::canDisable() const
   return false;
 }
 
+bool TagMatcher::dependsOnlyOnMaterial() const
+{
+  return false;
+}
+
 std::ostream& operator<<(std::ostream& str, const TagMatcher& matcher)
 {
   matcher.appendToStream(str);
@@ -312,6 +317,11 @@ bool SmartTag::canDisable() const
   return m_matcher->canDisable();
 }
 
+bool SmartTag::dependsOnlyOnMaterial() const
+{
+  return m_matcher->dependsOnlyOnMaterial();
+}
+
 void SmartTag::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "SmartTag"
@@ -322,6 +322,12 @@ public:
    */
   virtual bool canDisable() const;
 
+  /**
+   * Indicates whether this tag matcher only matches brush faces, and whether the result
+   * only depends on the face's material name and material.
+   */
+  virtual bool dependsOnlyOnMaterial() const;
+
   /**
    * Returns a new copy of this tag matcher.
    */
@@ -406,6 +412,12 @@ public:
    */
   bool canDisable() const;
 
+  /**
+   * Indicates whether this tag only applies to brush faces, and whether its matcher only
+   * depends on the face's material name and material.
+   */
+  bool dependsOnlyOnMaterial() const;
+
   void appendToStream(std::ostream& str) const override;
 };
 } // namespace tb::mdl
@@ -20,14 +20,17 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "mdl/BrushFace.h"
 #include "mdl/Tag.h"
 #include "mdl/TagType.h"
 
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace tb::mdl
 {
@@ -91,6 +94,7 @@ const SmartTag& TagManager::smartTag(const size_t index) const
 void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 {
   m_smartTags = kdl::vector_set<SmartTag, TagCmp>(tags.size());
+  m_materialTagCache.clear();
   for (const auto& tag : tags)
   {
     const size_t nextIndex = freeTagIndex();
@@ -109,16 +113,74 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  m_materialTagCache.clear();
 }
 
 void TagManager::updateTags(Taggable& taggable) const
 {
+  const auto* face = m_materialTagCacheEnabled ? dynamic_cast<BrushFace*>(&taggable)
+                                               : nullptr;
+  if (!face)
+  {
+    for (const auto& tag : m_smartTags)
+    {
+      tag.update(taggable);
+    }
+    return;
+  }
+
+  const auto cachedTags = materialTags(*face);
   for (const auto& tag : m_smartTags)
   {
-    tag.update(taggable);
+    if (!tag.dependsOnlyOnMaterial())
+    {
+      tag.update(taggable);
+    }
+    else if ((cachedTags & tag.type()) != 0)
+    {
+      taggable.addTag(tag);
+    }
+    else
+    {
+      taggable.removeTag(tag);
+    }
   }
 }
 
+void TagManager::setMaterialTagCacheEnabled(const bool enabled)
+{
+  m_materialTagCacheEnabled = enabled;
+  m_materialTagCache.clear();
+}
+
+TagType::Type TagManager::materialTags(const BrushFace& face) const
+{
+  const auto key =
+    std::tuple{std::string_view{face.attributes().materialName()}, face.material()};
+
+  {
+    const auto lock = std::shared_lock{m_materialTagCacheMutex};
+    if (const auto it = m_materialTagCache.find(key); it != m_materialTagCache.end())
+    {
+      return it->second;
+    }
+  }
+
+  auto result = TagType::Type{0};
+  for (const auto& tag : m_smartTags)
+  {
+    if (tag.dependsOnlyOnMaterial() && tag.matches(face))
+    {
+      result |= tag.type();
+    }
+  }
+
+  const auto lock = std::unique_lock{m_materialTagCacheMutex};
+  m_materialTagCache.emplace(
+    MaterialTagKey{face.attributes().materialName(), face.material()}, result);
+  return result;
+}
+
 size_t TagManager::freeTagIndex()
 {
   static const size_t Bits = (sizeof(TagType::Type) * 8);
@@ -20,13 +20,20 @@
 #pragma once
 
 #include "mdl/Tag.h"
+#include "mdl/TagType.h"
 
 #include "kdl/vector_set.h"
 
+#include <functional>
+#include <map>
+#include <shared_mutex>
 #include <string>
+#include <tuple>
 
 namespace tb::mdl
 {
+class BrushFace;
+class Material;
 
 /**
  * Manages the tags used in a document and updates smart tags on taggable objects.
@@ -44,6 +51,12 @@ private:
 
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
 
+  using MaterialTagKey = std::tuple<std::string, const Material*>;
+
+  bool m_materialTagCacheEnabled = false;
+  mutable std::shared_mutex m_materialTagCacheMutex;
+  mutable std::map<MaterialTagKey, TagType::Type, std::less<>> m_materialTagCache;
+
 public:
   /**
    * Returns a vector containing all smart tags registered with this manager.
@@ -113,7 +126,20 @@ public:
    */
   void updateTags(Taggable& taggable) const;
 
+  /**
+   * Enables or disables caching the smart tags that only depend on the material of a
+   * brush face. While the cache is enabled, these tags are evaluated once per material
+   * name and material, and the result is reused for all faces with the same material.
+   *
+   * The cache may be used by several threads calling updateTags at the same time. The
+   * materials must not change while it is enabled. Disabling the cache clears it.
+   *
+   * @param enabled whether the cache should be enabled
+   */
+  void setMaterialTagCacheEnabled(bool enabled);
+
 private:
+  TagType::Type materialTags(const BrushFace& face) const;
   size_t freeTagIndex();
 };
 
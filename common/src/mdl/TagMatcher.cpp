@@ -155,6 +155,11 @@ bool MaterialTagMatcher::canEnable() const
   return true;
 }
 
+bool MaterialTagMatcher::dependsOnlyOnMaterial() const
+{
+  return true;
+}
+
 void MaterialTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "MaterialTagMatcher";
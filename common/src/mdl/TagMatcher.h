@@ -45,6 +45,7 @@ class MaterialTagMatcher : public TagMatcher
 public:
   void enable(TagMatcherCallback& callback, Map& map) const override;
   bool canEnable() const override;
+  bool dependsOnlyOnMaterial() const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
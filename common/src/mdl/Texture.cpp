@@ -20,6 +20,7 @@
 #include "Texture.h"
 
 #include "Macros.h"
+#include "render/RenderProfiler.h"
 
 #include "kdl/overload.h"
 #include "kdl/reflection_impl.h"
@@ -48,8 +49,7 @@ auto makeTextureLoadedState(
   {
     [[maybe_unused]] const auto mipSize = sizeAtMipLevel(width, height, level);
     [[maybe_unused]] const auto numBytes =
-      compressed ? (blockSize * std::max(size_t(1), mipSize.x() / 4)
-                    * std::max(size_t(1), mipSize.y() / 4))
+      compressed ? (blockSize * ((mipSize.x() + 3) / 4) * ((mipSize.y() + 3) / 4))
                  : (bytesPerPixel * mipSize.x() * mipSize.y());
     assert(buffers[level].size() >= numBytes);
   }
@@ -57,6 +57,43 @@ auto makeTextureLoadedState(
   return TextureLoadedState{std::move(buffers)};
 }
 
+bool isFormatSupported(const GLenum format)
+{
+  switch (format)
+  {
+  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    return GLEW_EXT_texture_compression_s3tc;
+  case GL_COMPRESSED_RED_RGTC1:
+  case GL_COMPRESSED_RG_RGTC2:
+    return GLEW_ARB_texture_compression_rgtc;
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:
+  case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    return GLEW_ARB_texture_compression_bptc;
+  default:
+    return true;
+  }
+}
+
+/**
+ * Estimates the number of bytes that a texture uploaded from the given buffers occupies
+ * in video memory. Generated mipmaps add a third of the size of the base level.
+ */
+size_t estimateVideoMemorySize(
+  const GLenum format, const TextureMask mask, const std::vector<TextureBuffer>& buffers)
+{
+  auto result = size_t(0);
+  for (const auto& buffer : buffers)
+  {
+    result += buffer.size();
+  }
+
+  const auto generateMipmaps =
+    mask != TextureMask::On && buffers.size() == 1 && !isCompressedFormat(format);
+  return generateMipmaps ? result + result / 3 : result;
+}
+
 auto uploadTexture(
   const GLenum format,
   const TextureMask mask,
@@ -65,6 +102,19 @@ auto uploadTexture(
   const size_t height)
 {
   const auto compressed = isCompressedFormat(format);
+  if (!isFormatSupported(format))
+  {
+    // the texture will be rendered as if it had no texture
+    return GLuint(0);
+  }
+
+  // generate mipmaps if we don't have any, this isn't supported for compressed formats
+  const auto generateMipmaps =
+    mask != TextureMask::On && buffers.size() == 1 && !compressed;
+
+  // glGenerateMipmap builds the mipmap chain once after uploading, whereas the legacy
+  // GL_GENERATE_MIPMAP parameter makes the driver rebuild it on every upload to level 0
+  const auto hasGenerateMipmap = GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object;
 
   auto textureId = GLuint(0);
   glAssert(glGenTextures(1, &textureId));
@@ -88,10 +138,12 @@ auto uploadTexture(
     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
   }
-  else if (buffers.size() == 1)
+  else if (generateMipmaps)
   {
-    // generate mipmaps if we don't have any
-    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+    if (!hasGenerateMipmap)
+    {
+      glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+    }
   }
   else
   {
@@ -134,6 +186,12 @@ auto uploadTexture(
         GL_UNSIGNED_BYTE,
         data));
     }
+    render::currentStateChangeCounts().uploadedBytes += buffers[j].size();
+  }
+
+  if (generateMipmaps && hasGenerateMipmap)
+  {
+    glAssert(glGenerateMipmap(GL_TEXTURE_2D));
   }
 
   return textureId;
@@ -279,7 +337,8 @@ bool Texture::activate(const int minFilter, const int magFilter) const
       [](const TextureLoadedState&) { return false; },
       [&](const TextureReadyState& readyState) {
         glAssert(glBindTexture(GL_TEXTURE_2D, readyState.textureId));
-        setFilterMode(minFilter, magFilter);
+        ++render::currentStateChangeCounts().textureBinds;
+        setFilterMode(readyState, minFilter, magFilter);
         return true;
       },
       [](const TextureDroppedState&) { return false; }),
@@ -307,7 +366,11 @@ void Texture::upload(const bool glContextAvailable)
             ? uploadTexture(
                 m_format, m_mask, textureLoadedState.buffers, m_width, m_height)
             : 0;
-        return TextureReadyState{textureId};
+        const auto videoMemorySize =
+          textureId != 0
+            ? estimateVideoMemorySize(m_format, m_mask, textureLoadedState.buffers)
+            : 0;
+        return TextureReadyState{textureId, videoMemorySize};
       },
       [](TextureReadyState textureReadyState) -> TextureState {
         return textureReadyState;
@@ -349,19 +412,44 @@ const std::vector<TextureBuffer>& Texture::buffersIfLoaded() const
     m_state);
 }
 
+size_t Texture::memorySize() const
+{
+  auto result = size_t(0);
+  for (const auto& buffer : buffersIfLoaded())
+  {
+    result += buffer.size();
+  }
+  return result;
+}
 
-void Texture::setFilterMode(const int minFilter, const int magFilter) const
+size_t Texture::videoMemorySize() const
+{
+  if (const auto* readyState = std::get_if<TextureReadyState>(&m_state))
+  {
+    return readyState->videoMemorySize;
+  }
+  return 0;
+}
+
+void Texture::setFilterMode(
+  const TextureReadyState& readyState, int minFilter, int magFilter) const
 {
   if (m_mask == TextureMask::On)
   {
     // Force GL_NEAREST filtering for masked textures.
-    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    minFilter = GL_NEAREST;
+    magFilter = GL_NEAREST;
   }
-  else
+
+  if (readyState.minFilter != minFilter)
   {
     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
+    readyState.minFilter = minFilter;
+  }
+  if (readyState.magFilter != magFilter)
+  {
     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
+    readyState.magFilter = magFilter;
   }
 }
 
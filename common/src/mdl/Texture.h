@@ -71,6 +71,13 @@ struct TextureReadyState
 {
   GLuint textureId;
 
+  // the estimated number of bytes occupied by the texture object in video memory
+  size_t videoMemorySize = 0;
+
+  // the filter modes last set on the texture object, used to skip redundant state changes
+  mutable int minFilter = 0;
+  mutable int magFilter = 0;
+
   kdl_reflect_decl(TextureReadyState, textureId);
 };
 
@@ -157,8 +164,21 @@ public:
 
   const std::vector<TextureBuffer>& buffersIfLoaded() const;
 
+  /**
+   * Returns the estimated number of bytes occupied by this texture's buffers in main
+   * memory. The buffers are released once the texture is uploaded.
+   */
+  size_t memorySize() const;
+
+  /**
+   * Returns the estimated number of bytes occupied by this texture in video memory, or 0
+   * if it was not uploaded.
+   */
+  size_t videoMemorySize() const;
+
 private:
-  void setFilterMode(int minFilter, int magFilter) const;
+  void setFilterMode(
+    const TextureReadyState& readyState, int minFilter, int magFilter) const;
 };
 
 } // namespace tb::mdl
@@ -73,8 +73,19 @@ vm::vec2s sizeAtMipLevel(const size_t width, const size_t height, const size_t l
 
 bool isCompressedFormat(const GLenum format)
 {
-  return format >= GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
-         && format <= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  switch (format)
+  {
+  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+  case GL_COMPRESSED_RED_RGTC1:
+  case GL_COMPRESSED_RG_RGTC2:
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:
+  case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    return true;
+  default:
+    return false;
+  }
 }
 
 size_t blockSizeForFormat(const GLenum format)
@@ -82,9 +93,13 @@ size_t blockSizeForFormat(const GLenum format)
   switch (format)
   {
   case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RED_RGTC1:
     return 8U;
   case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
   case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+  case GL_COMPRESSED_RG_RGTC2:
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:
+  case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
     return 16U;
   }
   ensure(false, "unknown compressed format");
@@ -121,8 +136,9 @@ void setMipBufferSize(
   for (size_t level = 0u; level < buffers.size(); ++level)
   {
     const auto mipSize = sizeAtMipLevel(width, height, level);
-    const auto numBytes = compressed ? (blockSize * std::max(size_t(1), mipSize.x() / 4)
-                                        * std::max(size_t(1), mipSize.y() / 4))
+    // compressed formats store blocks of 4*4 pixels, partial blocks are padded
+    const auto numBytes = compressed ? (blockSize * ((mipSize.x() + 3) / 4)
+                                        * ((mipSize.y() + 3) / 4))
                                      : (bytesPerPixel * mipSize.x() * mipSize.y());
     buffers[level] = TextureBuffer{numBytes};
   }
@@ -71,11 +71,32 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+bool UndoableCommand::compactWith(UndoableCommand& command)
+{
+  assert(&command != this);
+  if (doCompactWith(command))
+  {
+    m_modificationCount += command.m_modificationCount;
+    return true;
+  }
+  return false;
+}
+
+size_t UndoableCommand::memoryUsage() const
+{
+  return sizeof(UndoableCommand) + name().capacity();
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
 }
 
+bool UndoableCommand::doCompactWith(UndoableCommand&)
+{
+  return false;
+}
+
 void UndoableCommand::setModificationCount(Map& map) const
 {
   if (m_modificationCount)
@@ -44,10 +44,27 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Merges the given command, which was executed right after this command within the same
+   * transaction, into this command. Unlike collation, compaction only happens when a
+   * transaction is committed and is not limited by the collation interval.
+   *
+   * Returns true if the given command was merged and can be discarded.
+   */
+  bool compactWith(UndoableCommand& command);
+
+  /**
+   * Returns an estimate of the number of bytes occupied by this command, including any
+   * snapshots and nodes that it owns. Used to enforce the memory budget of the command
+   * processor.
+   */
+  virtual size_t memoryUsage() const;
+
 protected:
   virtual std::unique_ptr<CommandResult> doPerformUndo(Map& map) = 0;
 
   virtual bool doCollateWith(UndoableCommand& command);
+  virtual bool doCompactWith(UndoableCommand& command);
 
   void setModificationCount(Map& map) const;
   void resetModificationCount(Map& map) const;
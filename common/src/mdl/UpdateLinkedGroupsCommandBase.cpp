@@ -99,4 +99,14 @@ bool UpdateLinkedGroupsCommandBase::collateWith(UndoableCommand& command)
   return false;
 }
 
+bool UpdateLinkedGroupsCommandBase::hasLinkedGroupUpdates() const
+{
+  return m_updateLinkedGroupsHelper.hasLinkedGroupUpdates();
+}
+
+size_t UpdateLinkedGroupsCommandBase::memoryUsage() const
+{
+  return UndoableCommand::memoryUsage() + m_updateLinkedGroupsHelper.memoryUsage();
+}
+
 } // namespace tb::mdl
@@ -49,6 +49,11 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
+protected:
+  bool hasLinkedGroupUpdates() const;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
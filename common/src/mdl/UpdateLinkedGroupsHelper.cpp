@@ -22,6 +22,7 @@
 #include "mdl/GroupNode.h"
 #include "mdl/LinkedGroupUtils.h"
 #include "mdl/Map.h"
+#include "mdl/MemoryUsage.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/NodeQueries.h"
 
@@ -160,6 +161,33 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   }
 }
 
+bool UpdateLinkedGroupsHelper::hasLinkedGroupUpdates() const
+{
+  return std::visit([](const auto& state) { return !state.empty(); }, m_state);
+}
+
+size_t UpdateLinkedGroupsHelper::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups& changedLinkedGroups) {
+        return changedLinkedGroups.capacity() * sizeof(GroupNode*);
+      },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result =
+          linkedGroupUpdates.capacity() * sizeof(LinkedGroupUpdates::value_type);
+        for (const auto& [groupNode, oldChildren] : linkedGroupUpdates)
+        {
+          for (const auto& oldChild : oldChildren)
+          {
+            result += mdl::memoryUsage(*oldChild);
+          }
+        }
+        return result;
+      }),
+    m_state);
+}
+
 Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(Map& map)
 {
   return std::visit(
@@ -66,6 +66,17 @@ public:
   void undoLinkedGroupUpdates(Map& map);
   void collateWith(UpdateLinkedGroupsHelper& other);
 
+  /**
+   * Indicates whether this helper updates or has updated any linked groups.
+   */
+  bool hasLinkedGroupUpdates() const;
+
+  /**
+   * Returns an estimate of the memory occupied by the replaced linked group children
+   * owned by this helper.
+   */
+  size_t memoryUsage() const;
+
 private:
   Result<void> computeLinkedGroupUpdates(Map& map);
   static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
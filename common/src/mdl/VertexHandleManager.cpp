@@ -35,16 +35,59 @@ namespace tb::mdl
 
 VertexHandleManagerBase::~VertexHandleManagerBase() = default;
 
+std::vector<vm::plane3d> VertexHandleManagerBase::pickVolume(
+  const vm::ray3d& pickRay, const render::Camera& camera, const double handleRadius)
+{
+  // A point handle is hit if its distance to the pick ray is at most twice the handle
+  // radius times the camera's scaling factor at the handle position. The bounds are
+  // doubled again to stay conservative.
+  const auto side = vm::normalize(vm::cross(pickRay.direction, vm::vec3d{camera.up()}));
+  const auto up = vm::cross(side, pickRay.direction);
+
+  if (camera.orthographicProjection())
+  {
+    // the scaling factor is constant, so the volume is a prism around the pick ray
+    const auto scaling =
+      double(camera.perspectiveScalingFactor(vm::vec3f{pickRay.origin}));
+    const auto maxDistance = 4.0 * handleRadius * scaling;
+
+    return {
+      vm::plane3d{pickRay.origin + maxDistance * side, side},
+      vm::plane3d{pickRay.origin - maxDistance * side, -side},
+      vm::plane3d{pickRay.origin + maxDistance * up, up},
+      vm::plane3d{pickRay.origin - maxDistance * up, -up},
+    };
+  }
+
+  // the scaling factor grows linearly with the distance from the camera, so the volume is
+  // a pyramid whose apex is the camera position
+  const auto cameraPosition = vm::vec3d{camera.position()};
+  const auto scaling = double(camera.perspectiveScalingFactor(
+    camera.position() + camera.direction()));
+  const auto slope = 4.0 * handleRadius * scaling;
+  if (slope >= 1.0)
+  {
+    return {};
+  }
+
+  return {
+    vm::plane3d{cameraPosition, vm::normalize(side - slope * pickRay.direction)},
+    vm::plane3d{cameraPosition, vm::normalize(-side - slope * pickRay.direction)},
+    vm::plane3d{cameraPosition, vm::normalize(up - slope * pickRay.direction)},
+    vm::plane3d{cameraPosition, vm::normalize(-up - slope * pickRay.direction)},
+  };
+}
+
 const HitType::Type VertexHandleManager::HandleHitType = HitType::freeType();
 
 void VertexHandleManager::pick(
   const vm::ray3d& pickRay, const render::Camera& camera, PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  for (const auto* handle : findPickCandidates(pickRay, camera, handleRadius))
   {
-    if (
-      const auto distance = camera.pickPointHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+    const auto& position = *handle;
+    if (const auto distance = camera.pickPointHandle(pickRay, position, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
@@ -91,19 +134,21 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  for (const auto* handle : findPickCandidates(pickRay, camera, handleRadius))
   {
+    const auto& position = *handle;
     if (
-      const auto edgeDist = camera.pickLineSegmentHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+      const auto edgeDist =
+        camera.pickLineSegmentHandle(pickRay, position, handleRadius))
     {
       if (
         const auto pointHandle =
           grid.snap(vm::point_at_distance(pickRay, *edgeDist), position))
       {
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, *pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, *pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(
@@ -117,13 +162,14 @@ void EdgeHandleManager::pickGridHandle(
 void EdgeHandleManager::pickCenterHandle(
   const vm::ray3d& pickRay, const render::Camera& camera, PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  for (const auto* handle : findPickCandidates(pickRay, camera, handleRadius))
   {
+    const auto& position = *handle;
     const auto pointHandle = position.center();
 
     if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+      const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(Hit{HandleHitType, *pointDist, hitPoint, position});
@@ -169,8 +215,10 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  for (const auto* handle : findPickCandidates(pickRay, camera, handleRadius))
   {
+    const auto& position = *handle;
     if (
       const auto plane =
         vm::from_points(position.vertices().begin(), position.vertices().end()))
@@ -183,8 +231,8 @@ void FaceHandleManager::pickGridHandle(
           grid.snap(vm::point_at_distance(pickRay, *distance), *plane);
 
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(
@@ -198,13 +246,14 @@ void FaceHandleManager::pickGridHandle(
 void FaceHandleManager::pickCenterHandle(
   const vm::ray3d& pickRay, const render::Camera& camera, PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  for (const auto* handle : findPickCandidates(pickRay, camera, handleRadius))
   {
+    const auto& position = *handle;
     const auto pointHandle = position.center();
 
     if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+      const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(Hit{HandleHitType, *pointDist, hitPoint, position});
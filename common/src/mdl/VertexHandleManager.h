@@ -22,12 +22,18 @@
 #include "mdl/BrushNode.h"
 #include "mdl/HitType.h"
 #include "mdl/PickResult.h"
+#include "octree.h"
 #include "render/Camera.h"
 
 #include "kdl/map_utils.h"
 #include "kdl/ranges/to.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/polygon.h"
+#include "vm/segment.h"
+
 #include <iterator>
 #include <map>
 #include <ranges>
@@ -91,6 +97,20 @@ public:
    * @param brushNode the brush whose handles to remove
    */
   virtual void removeHandles(const BrushNode* brushNode) = 0;
+
+protected:
+  /**
+   * Returns the planes bounding a volume that contains every point which can be hit by
+   * the given pick ray when it is tested against a point handle of the given radius. The
+   * normals of the returned planes point outwards.
+   *
+   * @param pickRay the picking ray
+   * @param camera the camera
+   * @param handleRadius the handle radius
+   * @return the planes bounding the volume, or an empty vector if the volume is unbounded
+   */
+  static std::vector<vm::plane3d> pickVolume(
+    const vm::ray3d& pickRay, const render::Camera& camera, double handleRadius);
 };
 
 template <typename H>
@@ -146,11 +166,21 @@ protected:
    */
   std::map<H, HandleInfo> m_handles;
 
+  /**
+   * Spatial index of the handles, so that picking and selecting handles doesn't need to
+   * test every handle. Stores pointers to the keys of m_handles, which remain valid until
+   * the handle is removed.
+   */
+  octree<double, const H*> m_handleTree{HandleTreeMinSize};
+
   /**
    * The total number of selected handles, not counting duplicates.
    */
   size_t m_selectedHandleCount = 0;
 
+private:
+  static constexpr auto HandleTreeMinSize = 64.0;
+
 public:
   ~VertexHandleManagerBaseT() override = default;
 
@@ -284,8 +314,15 @@ public:
    */
   void add(const Handle& handle)
   {
-    m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo
-                             // means its default constructor is called
+    // unknown value gets value constructed, which for HandleInfo means its default
+    // constructor is called
+    const auto [it, inserted] = m_handles.try_emplace(handle);
+    it->second.inc();
+
+    if (inserted)
+    {
+      m_handleTree.insert(bounds(it->first), &it->first);
+    }
   }
 
   /**
@@ -305,6 +342,7 @@ public:
       if (info.count == 0)
       {
         deselect(info);
+        m_handleTree.remove(&it->first);
         m_handles.erase(it);
       }
       return true;
@@ -318,6 +356,7 @@ public:
    */
   void clear()
   {
+    m_handleTree.clear();
     m_handles.clear();
     m_selectedHandleCount = 0;
   }
@@ -417,15 +456,29 @@ private:
   void forEachCloseHandle(const H& otherHandle, F fun)
   {
     static const auto epsilon = 0.001 * 0.001;
-    for (auto& [handle, info] : m_handles)
+    const auto searchBounds = bounds(otherHandle).expand(0.001);
+    for (const auto* handle : m_handleTree.find_intersectors(searchBounds))
     {
-      if (compare(otherHandle, handle, epsilon) == 0)
+      if (compare(otherHandle, *handle, epsilon) == 0)
       {
-        fun(info);
+        fun(m_handles.at(*handle));
       }
     }
   }
 
+  static vm::bbox3d bounds(const vm::vec3d& handle) { return {handle, handle}; }
+
+  static vm::bbox3d bounds(const vm::segment3d& handle)
+  {
+    return vm::bbox3d{
+      vm::min(handle.start(), handle.end()), vm::max(handle.start(), handle.end())};
+  }
+
+  static vm::bbox3d bounds(const vm::polygon3d& handle)
+  {
+    return vm::bbox3d::merge_all(handle.vertices().begin(), handle.vertices().end());
+  }
+
   void select(HandleInfo& info)
   {
     if (info.select())
@@ -481,6 +534,39 @@ public:
     }
   }
 
+  /**
+   * Returns the handles which may be inside of the convex volume bounded by the given
+   * planes. The result contains every handle which is inside of the volume, but it may
+   * also contain handles which are close to the volume but outside of it.
+   *
+   * @param planes the planes bounding the volume, their normals must point outwards
+   * @return a list of the handles which may be inside of the volume
+   */
+  std::vector<Handle> findHandles(const std::vector<vm::plane3d>& planes) const
+  {
+    return m_handleTree.find_in_convex_volume(planes)
+           | std::views::transform([](const auto* handle) { return *handle; })
+           | kdl::ranges::to<std::vector>();
+  }
+
+protected:
+  /**
+   * Returns the handles which may be hit by the given pick ray when they are tested as
+   * handles of the given radius. Picking tests need only be applied to these handles.
+   *
+   * @param pickRay the picking ray
+   * @param camera the camera
+   * @param handleRadius the handle radius
+   * @return a list of pointers to the candidate handles
+   */
+  std::vector<const Handle*> findPickCandidates(
+    const vm::ray3d& pickRay,
+    const render::Camera& camera,
+    const double handleRadius) const
+  {
+    return m_handleTree.find_in_convex_volume(pickVolume(pickRay, camera, handleRadius));
+  }
+
 public:
   /**
    * Finds and returns all brushes in the given range which are incident to the given
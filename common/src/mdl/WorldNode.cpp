@@ -26,7 +26,10 @@
 #include "mdl/EntityNodeIndex.h"
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
+#include "mdl/MaterialIndex.h"
+#include "mdl/NodeQueries.h"
 #include "mdl/PatchNode.h"
+#include "mdl/PickResult.h"
 #include "mdl/TagVisitor.h"
 #include "mdl/Validator.h"
 #include "mdl/ValidatorRegistry.h"
@@ -35,12 +38,16 @@
 #include "kdl/const_overload.h"
 #include "kdl/k.h"
 #include "kdl/overload.h"
-#include "kdl/vector_utils.h"
 
 #include "vm/bbox_io.h" // IWYU pragma: keep
+#include "vm/intersection.h"
 
+#include <algorithm>
+#include <cassert>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
@@ -48,10 +55,12 @@ namespace tb::mdl
 
 WorldNode::WorldNode(
   EntityPropertyConfig entityPropertyConfig, Entity entity, const MapFormat mapFormat)
-  : m_entityPropertyConfig{std::move(entityPropertyConfig)}
+  : EntityNodeBase{Kind}
+  , m_entityPropertyConfig{std::move(entityPropertyConfig)}
   , m_mapFormat{mapFormat}
   , m_defaultLayer{nullptr}
   , m_entityNodeIndex{std::make_unique<EntityNodeIndex>()}
+  , m_materialIndex{std::make_unique<MaterialIndex>()}
   , m_validatorRegistry{std::make_unique<ValidatorRegistry>()}
   , m_nodeTree{std::make_unique<NodeTree>(256.0)}
   , m_updateNodeTree{true}
@@ -178,6 +187,11 @@ const EntityNodeIndex& WorldNode::entityNodeIndex() const
   return *m_entityNodeIndex;
 }
 
+const MaterialIndex& WorldNode::materialIndex() const
+{
+  return *m_materialIndex;
+}
+
 std::vector<const Validator*> WorldNode::registeredValidators() const
 {
   return m_validatorRegistry->registeredValidators();
@@ -210,41 +224,38 @@ void WorldNode::enableNodeTreeUpdates()
   m_updateNodeTree = true;
 }
 
+void WorldNode::deferNodeTreeUpdates()
+{
+  ++m_deferNodeTreeUpdates;
+}
+
+void WorldNode::applyDeferredNodeTreeUpdates()
+{
+  assert(m_deferNodeTreeUpdates > 0);
+  if (--m_deferNodeTreeUpdates == 0)
+  {
+    const auto nodes = std::exchange(m_deferredNodeTreeUpdates, {});
+    for (auto* node : nodes)
+    {
+      m_nodeTree->update(node->physicalBounds(), node);
+    }
+  }
+}
+
 void WorldNode::rebuildNodeTree()
 {
-  auto nodes = std::vector<Node*>{};
+  auto nodes = std::vector<std::pair<vm::bbox3d, Node*>>{};
   const auto addNode = [&](auto* node) {
     if (node->shouldAddToSpacialIndex())
     {
-      nodes.push_back(node);
+      nodes.emplace_back(node->physicalBounds(), node);
     }
   };
 
-  accept(kdl::overload(
-    [&](auto&& thisLambda, WorldNode* world) {
-      addNode(world);
-      world->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, LayerNode* layer) {
-      addNode(layer);
-      layer->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, GroupNode* group) {
-      addNode(group);
-      group->visitChildren(thisLambda);
-    },
-    [&](auto&& thisLambda, EntityNode* entity) {
-      addNode(entity);
-      entity->visitChildren(thisLambda);
-    },
-    [&](BrushNode* brush) { addNode(brush); },
-    [&](PatchNode* patch) { addNode(patch); }));
+  visitNodes<WorldNode, LayerNode, GroupNode, EntityNode, BrushNode, PatchNode>(
+    *this, addNode);
 
-  m_nodeTree->clear();
-  for (auto* node : nodes)
-  {
-    m_nodeTree->insert(node->physicalBounds(), node);
-  }
+  m_nodeTree->build(std::move(nodes));
 }
 
 void WorldNode::invalidateAllIssues()
@@ -345,16 +356,9 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
   // being connected and add it or any descendants that need to be added.
   if (m_updateNodeTree)
   {
-    node->accept(kdl::overload(
-      [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, EntityNode* entity) {
-        m_nodeTree->insert(entity->physicalBounds(), entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](BrushNode* brush) { m_nodeTree->insert(brush->physicalBounds(), brush); },
-      [&](PatchNode* patch) { m_nodeTree->insert(patch->physicalBounds(), patch); }));
+    visitNodes<EntityNode, BrushNode, PatchNode>(*node, [&](auto* nodeToInsert) {
+      m_nodeTree->insert(nodeToInsert->physicalBounds(), nodeToInsert);
+    });
   }
 
   const auto updatePersistentId = [&](auto* persistentNode) {
@@ -379,13 +383,19 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
       {
         updatePersistentId(layer);
       }
+      if (const auto& unloadedContent = layer->layer().unloadedContent();
+          unloadedContent && unloadedContent->maxPersistentId)
+      {
+        m_nextPersistentId =
+          std::max(m_nextPersistentId, *unloadedContent->maxPersistentId + 1u);
+      }
     },
     [&](auto&& thisLambda, GroupNode* group) {
       group->visitChildren(thisLambda);
       updatePersistentId(group);
     },
-    [&](EntityNode*) {},
-    [&](BrushNode*) {},
+    [&](auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
+    [&](BrushNode* brush) { m_materialIndex->addBrushNode(brush); },
     [&](PatchNode*) {}));
 }
 
@@ -394,6 +404,7 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
   if (m_updateNodeTree)
   {
     const auto doRemove = [&](auto* nodeToRemove) {
+      m_deferredNodeTreeUpdates.erase(nodeToRemove);
       if (!m_nodeTree->remove(nodeToRemove))
       {
         auto str = std::stringstream();
@@ -403,16 +414,26 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
       }
     };
 
-    node->accept(kdl::overload(
-      [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
-      [&](auto&& thisLambda, EntityNode* entity) {
-        doRemove(entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](BrushNode* brush) { doRemove(brush); },
-      [&](PatchNode* patch) { doRemove(patch); }));
+    visitNodes<EntityNode, BrushNode, PatchNode>(*node, doRemove);
+  }
+
+  visitNodes<BrushNode>(
+    *node, [&](BrushNode* brush) { m_materialIndex->removeBrushNode(brush); });
+}
+
+void WorldNode::doDescendantWillChange(Node* node)
+{
+  if (node->kind() == NodeKind::Brush)
+  {
+    m_materialIndex->removeBrushNode(static_cast<BrushNode*>(node));
+  }
+}
+
+void WorldNode::doDescendantDidChange(Node* node)
+{
+  if (node->kind() == NodeKind::Brush)
+  {
+    m_materialIndex->addBrushNode(static_cast<BrushNode*>(node));
   }
 }
 
@@ -420,13 +441,24 @@ void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
 {
   if (m_updateNodeTree)
   {
+    const auto doUpdate = [&](auto* nodeToUpdate) {
+      if (m_deferNodeTreeUpdates > 0)
+      {
+        m_deferredNodeTreeUpdates.insert(nodeToUpdate);
+      }
+      else
+      {
+        m_nodeTree->update(nodeToUpdate->physicalBounds(), nodeToUpdate);
+      }
+    };
+
     node->accept(kdl::overload(
       [](WorldNode*) {},
       [](LayerNode*) {},
       [](GroupNode*) {},
-      [&](EntityNode* entity) { m_nodeTree->update(entity->physicalBounds(), entity); },
-      [&](BrushNode* brush) { m_nodeTree->update(brush->physicalBounds(), brush); },
-      [&](PatchNode* patch) { m_nodeTree->update(patch->physicalBounds(), patch); }));
+      [&](EntityNode* entity) { doUpdate(entity); },
+      [&](BrushNode* brush) { doUpdate(brush); },
+      [&](PatchNode* patch) { doUpdate(patch); }));
   }
 }
 
@@ -438,8 +470,36 @@ bool WorldNode::doSelectable() const
 void WorldNode::doPick(
   const EditorContext& editorContext, const vm::ray3d& ray, PickResult& pickResult)
 {
-  for (auto* node : m_nodeTree->find_intersectors(ray))
+  auto nodes = m_nodeTree->find_intersectors(ray);
+  if (!pickResult.bounded())
   {
+    for (auto* node : nodes)
+    {
+      node->pick(editorContext, ray, pickResult);
+    }
+    return;
+  }
+
+  // pick the nodes front to back and stop at the first node whose bounds are entered
+  // beyond the distance of the hits that the pick result has already collected
+  auto nodesByDistance = std::vector<std::tuple<double, Node*>>{};
+  nodesByDistance.reserve(nodes.size());
+  for (auto* node : nodes)
+  {
+    const auto& bounds = node->physicalBounds();
+    const auto distance = bounds.contains(ray.origin)
+                            ? 0.0
+                            : vm::intersect_ray_bbox(ray, bounds).value_or(0.0);
+    nodesByDistance.emplace_back(distance, node);
+  }
+  std::ranges::sort(nodesByDistance);
+
+  for (const auto& [distance, node] : nodesByDistance)
+  {
+    if (distance > pickResult.maxDistance())
+    {
+      break;
+    }
     node->pick(editorContext, ray, pickResult);
   }
 }
@@ -472,9 +532,7 @@ void WorldNode::doFindEntityNodesWithProperty(
   const std::string& value,
   std::vector<EntityNodeBase*>& result) const
 {
-  result = kdl::vec_concat(
-    std::move(result),
-    m_entityNodeIndex->findEntityNodes(EntityNodeIndexQuery::exact(name), value));
+  m_entityNodeIndex->findEntityNodes(EntityNodeIndexQuery::exact(name), value, result);
 }
 
 void WorldNode::doFindEntityNodesWithNumberedProperty(
@@ -482,9 +540,7 @@ void WorldNode::doFindEntityNodesWithNumberedProperty(
   const std::string& value,
   std::vector<EntityNodeBase*>& result) const
 {
-  result = kdl::vec_concat(
-    std::move(result),
-    m_entityNodeIndex->findEntityNodes(EntityNodeIndexQuery::numbered(prefix), value));
+  m_entityNodeIndex->findEntityNodes(EntityNodeIndexQuery::numbered(prefix), value, result);
 }
 
 void WorldNode::doAddToIndex(
@@ -521,4 +577,15 @@ void WorldNode::doAcceptTagVisitor(ConstTagVisitor& visitor) const
   visitor.visit(*this);
 }
 
+DeferNodeTreeUpdates::DeferNodeTreeUpdates(WorldNode& worldNode)
+  : m_worldNode{worldNode}
+{
+  m_worldNode.deferNodeTreeUpdates();
+}
+
+DeferNodeTreeUpdates::~DeferNodeTreeUpdates()
+{
+  m_worldNode.applyDeferredNodeTreeUpdates();
+}
+
 } // namespace tb::mdl
@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -36,22 +37,29 @@ namespace tb::mdl
 class EntityNodeIndex;
 class IssueQuickFix;
 enum class MapFormat;
+class MaterialIndex;
 class PickResult;
 class Validator;
 class ValidatorRegistry;
 
 class WorldNode : public EntityNodeBase
 {
+public:
+  static constexpr auto Kind = NodeKind::World;
+
 private:
   EntityPropertyConfig m_entityPropertyConfig;
   MapFormat m_mapFormat;
   LayerNode* m_defaultLayer;
   std::unique_ptr<EntityNodeIndex> m_entityNodeIndex;
+  std::unique_ptr<MaterialIndex> m_materialIndex;
   std::unique_ptr<ValidatorRegistry> m_validatorRegistry;
 
   using NodeTree = octree<double, Node*>;
   std::unique_ptr<NodeTree> m_nodeTree;
   bool m_updateNodeTree;
+  size_t m_deferNodeTreeUpdates = 0;
+  std::unordered_set<Node*> m_deferredNodeTreeUpdates;
 
   IdType m_nextPersistentId = 1;
 
@@ -123,20 +131,31 @@ private:
 
 public: // index
   const EntityNodeIndex& entityNodeIndex() const;
+  const MaterialIndex& materialIndex() const;
 
 public: // validator registration
   std::vector<const Validator*> registeredValidators() const;
   std::vector<const IssueQuickFix*> quickFixes(IssueType issueTypes) const;
   void registerValidator(std::unique_ptr<Validator> validator);
   void unregisterAllValidators();
+  void invalidateAllIssues();
 
 public: // node tree bulk updating
   void disableNodeTreeUpdates();
   void enableNodeTreeUpdates();
   void rebuildNodeTree();
 
-private:
-  void invalidateAllIssues();
+  /**
+   * Defers updating the node tree when the bounds of a node change until the matching
+   * call to applyDeferredNodeTreeUpdates. Each node is then updated once with its final
+   * bounds, so the bounds of an entity are only recomputed once no matter how many of
+   * its children changed. Nodes are still inserted into and removed from the node tree
+   * immediately.
+   *
+   * Calls can be nested. The node tree must not be queried while updates are deferred.
+   */
+  void deferNodeTreeUpdates();
+  void applyDeferredNodeTreeUpdates();
 
 private: // implement Node interface
   const vm::bbox3d& doGetLogicalBounds() const override;
@@ -152,6 +171,8 @@ private: // implement Node interface
   void doDescendantWasAdded(Node* node, size_t depth) override;
   void doDescendantWillBeRemoved(Node* node, size_t depth) override;
   void doDescendantPhysicalBoundsDidChange(Node* node) override;
+  void doDescendantWillChange(Node* node) override;
+  void doDescendantDidChange(Node* node) override;
 
   bool doSelectable() const override;
   void doPick(
@@ -188,4 +209,21 @@ private:
   deleteCopyAndMove(WorldNode);
 };
 
+/**
+ * RAII style helper that defers node tree updates of the given world node for as long as
+ * it lives, see WorldNode::deferNodeTreeUpdates. The deferred updates are applied when
+ * this object is destroyed, including when the scope is left by an exception.
+ */
+class DeferNodeTreeUpdates
+{
+private:
+  WorldNode& m_worldNode;
+
+public:
+  explicit DeferNodeTreeUpdates(WorldNode& worldNode);
+  ~DeferNodeTreeUpdates();
+
+  deleteCopyAndMove(DeferNodeTreeUpdates);
+};
+
 } // namespace tb::mdl
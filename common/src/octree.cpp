@@ -36,6 +36,20 @@ namespace
          || (is_valid(x) && is_valid(y) && is_valid(z));
 }
 
+/**
+ * Spreads the lower 16 bits of the given value so that two zero bits separate each pair
+ * of adjacent bits.
+ */
+uint64_t spread_bits(const uint64_t value)
+{
+  auto result = uint64_t(0);
+  for (size_t i = 0; i < 16; ++i)
+  {
+    result |= ((value >> i) & uint64_t(1)) << (3 * i);
+  }
+  return result;
+}
+
 } // namespace
 
 node_address::node_address(
@@ -76,6 +90,18 @@ node_address get_parent(const node_address& a)
     uint16_t(a.size + 1)};
 }
 
+node_address get_ancestor(const node_address& a, const uint16_t size)
+{
+  assert(size >= a.size);
+
+  const auto p_s = 1 << size;
+  return {
+    int16_t(((a.x >= 0 ? a.x : a.x - p_s + 1) / p_s) * p_s),
+    int16_t(((a.y >= 0 ? a.y : a.y - p_s + 1) / p_s) * p_s),
+    int16_t(((a.z >= 0 ? a.z : a.z - p_s + 1) / p_s) * p_s),
+    size};
+}
+
 std::optional<size_t> get_quadrant(const node_address& outer, const node_address& inner)
 {
   assert(outer.contains(inner));
@@ -149,4 +175,14 @@ node_address get_container(const node_address& address1, const node_address& add
   return container;
 }
 
+uint64_t get_morton_code(const node_address& address)
+{
+  // shift the coordinates into the unsigned range, this preserves the alignment of the
+  // addresses
+  const auto x = uint64_t(int(address.x) + 32768);
+  const auto y = uint64_t(int(address.y) + 32768);
+  const auto z = uint64_t(int(address.z) + 32768);
+  return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+}
+
 } // namespace tb::detail
@@ -28,15 +28,21 @@
 
 #include "vm/bbox.h"
 #include "vm/intersection.h"
+#include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/scalar.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -81,6 +87,12 @@ node_address get_address(const vm::vec<T, 3>& point, const T min_size)
 
 node_address get_parent(const node_address& a);
 
+/**
+ * Returns the address of the given size that contains the given address. The given size
+ * must not be less than the size of the given address.
+ */
+node_address get_ancestor(const node_address& a, uint16_t size);
+
 std::optional<size_t> get_quadrant(const node_address& outer, const node_address& inner);
 
 node_address get_child(const node_address& a, size_t quadrant);
@@ -91,6 +103,16 @@ node_address get_root(const node_address& address);
 
 node_address get_container(const node_address& address1, const node_address& address2);
 
+/**
+ * Returns the Morton code of the minimum corner of the given address. Sorting addresses
+ * by their Morton codes groups them by the quadrants they belong to at every level of
+ * the tree, in quadrant order.
+ *
+ * The coordinates are offset by 2^15 before their bits are interleaved, so the most
+ * significant bits of the code are the signs of the coordinates.
+ */
+uint64_t get_morton_code(const node_address& address);
+
 template <typename T>
 node_address get_container(const vm::bbox<T, 3>& bounds, const T min_size)
 {
@@ -261,6 +283,111 @@ private:
     }
   }
 
+  /**
+   * A ray prepared for testing it against many boxes using the slab method.
+   */
+  struct ray_query
+  {
+    vm::vec<T, 3> origin;
+    vm::vec<T, 3> direction;
+    vm::vec<T, 3> inverse_direction;
+
+    explicit ray_query(const vm::ray<T, 3>& ray)
+      : origin{ray.origin}
+      , direction{ray.direction}
+      , inverse_direction{T(1) / ray.direction}
+    {
+    }
+  };
+
+  /**
+   * Tests the given ray against the bounds of the given nodes at once. A node is hit if
+   * its bounds contain the ray origin or if the ray intersects its bounds.
+   *
+   * The bounds are stored per axis so that the tests can be vectorized.
+   *
+   * @return a bit mask where the i-th bit is set if the i-th node is hit
+   */
+  static uint32_t intersect_ray_nodes(
+    const ray_query& query, const std::span<const node> nodes, const T min_size)
+  {
+    static constexpr size_t MaxNodes = 8;
+    assert(nodes.size() <= MaxNodes);
+
+    auto mins = std::array<std::array<T, MaxNodes>, 3>{};
+    auto maxs = std::array<std::array<T, MaxNodes>, 3>{};
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto& address = get_address(nodes[i]);
+      const auto min = address.min();
+      const auto max = address.max();
+      for (size_t axis = 0; axis < 3; ++axis)
+      {
+        mins[axis][i] = T(min[axis]) * min_size;
+        maxs[axis][i] = T(max[axis]) * min_size;
+      }
+    }
+
+    auto t_near = std::array<T, MaxNodes>{};
+    auto t_far = std::array<T, MaxNodes>{};
+    t_far.fill(std::numeric_limits<T>::max());
+
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+      const auto o = query.origin[axis];
+      if (query.direction[axis] == T(0))
+      {
+        // the ray is parallel to the slab, so it misses if its origin is outside
+        for (size_t i = 0; i < MaxNodes; ++i)
+        {
+          t_far[i] = o < mins[axis][i] || o > maxs[axis][i] ? T(-1) : t_far[i];
+        }
+      }
+      else
+      {
+        const auto inv = query.inverse_direction[axis];
+        for (size_t i = 0; i < MaxNodes; ++i)
+        {
+          const auto t1 = (mins[axis][i] - o) * inv;
+          const auto t2 = (maxs[axis][i] - o) * inv;
+          t_near[i] = std::max(t_near[i], std::min(t1, t2));
+          t_far[i] = std::min(t_far[i], std::max(t1, t2));
+        }
+      }
+    }
+
+    auto result = uint32_t(0);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      result |= t_near[i] <= t_far[i] ? (uint32_t(1) << i) : uint32_t(0);
+    }
+    return result;
+  }
+
+  /**
+   * Appends the data of the given node and of its descendants which are hit by the given
+   * ray to the given output iterator. The given node must be hit by the ray.
+   */
+  template <typename O>
+  static void find_ray_intersectors(
+    const node& node_, const ray_query& query, const T min_size, O out)
+  {
+    const auto& data = get_data(node_);
+    std::copy(data.begin(), data.end(), out);
+
+    if (const auto* inner = std::get_if<inner_node>(&node_))
+    {
+      const auto hits = intersect_ray_nodes(query, inner->children, min_size);
+      for (size_t i = 0; i < inner->children.size(); ++i)
+      {
+        if (hits & (uint32_t(1) << i))
+        {
+          find_ray_intersectors(inner->children[i], query, min_size, out);
+        }
+      }
+    }
+  }
+
   static void update_root_address(
     node& root,
     const detail::node_address& address,
@@ -363,6 +490,91 @@ private:
       node);
   }
 
+  struct bulk_item
+  {
+    detail::node_address address;
+    uint64_t morton_code;
+    U data;
+  };
+
+  /**
+   * Builds a node with the given address that contains the given items. The items must
+   * be sorted by their Morton codes.
+   */
+  static node build_node(const detail::node_address& address, std::span<bulk_item> items)
+  {
+    // The quadrant of an item that fits into a child node is given by the bits of its
+    // Morton code that correspond to the size of the child nodes. For the root node,
+    // which is centered around the origin, these are the sign bits.
+    const auto address_is_root = is_root(address);
+    const auto quadrant_shift = address_is_root ? 45 : 3 * (address.size - 1);
+    const auto fits_into_quadrant = [&](const bulk_item& item) {
+      return address_is_root ? !is_root(item.address) : item.address.size < address.size;
+    };
+    const auto get_item_quadrant = [&](const bulk_item& item) {
+      return size_t((item.morton_code >> quadrant_shift) & 7u);
+    };
+
+    // items that don't fit into a quadrant are stored in this node, the others are moved
+    // to the front and remain sorted, so they are grouped by quadrant
+    auto data = std::vector<U>{};
+    auto i_children_end = items.begin();
+    for (auto& item : items)
+    {
+      assert(fits_into_quadrant(item) == get_quadrant(address, item.address).has_value());
+      if (fits_into_quadrant(item))
+      {
+        *i_children_end++ = std::move(item);
+      }
+      else
+      {
+        data.push_back(std::move(item.data));
+      }
+    }
+
+    if (i_children_end == items.begin())
+    {
+      return leaf_node{address, std::move(data)};
+    }
+
+    auto children = std::vector<node>{};
+    children.reserve(8);
+
+    auto i_begin = items.begin();
+    for (size_t quadrant = 0; quadrant < 8; ++quadrant)
+    {
+      const auto i_end = std::find_if(i_begin, i_children_end, [&](const auto& item) {
+        assert(get_item_quadrant(item) == *get_quadrant(address, item.address));
+        return get_item_quadrant(item) != quadrant;
+      });
+
+      if (i_begin == i_end)
+      {
+        children.emplace_back(leaf_node{get_child(address, quadrant), {}});
+      }
+      else
+      {
+        // the smallest node that contains the first and the last item of a range sorted
+        // by Morton code contains every item in between if it is large enough
+        const auto differing_bits =
+          i_begin->morton_code ^ std::prev(i_end)->morton_code;
+        auto container_size = uint16_t((std::bit_width(differing_bits) + 2) / 3);
+        for (auto i = i_begin; i != i_end; ++i)
+        {
+          container_size = std::max(container_size, i->address.size);
+        }
+
+        const auto container_address = get_ancestor(i_begin->address, container_size);
+        children.push_back(build_node(container_address, std::span{i_begin, i_end}));
+      }
+
+      i_begin = i_end;
+    }
+    assert(i_begin == i_children_end);
+
+    return inner_node{address, std::move(data), std::move(children)};
+  }
+
 private:
   std::optional<node> m_root;
   T m_min_size;
@@ -451,6 +663,63 @@ public:
   }
 
 
+  /**
+   * Replaces the contents of this tree with the given data items.
+   *
+   * This is much faster than inserting the items one by one because the tree is built
+   * top down in a single pass over the items after sorting them by the Morton codes of
+   * their addresses.
+   *
+   * @param items the bounds and data of the items to store
+   *
+   * @throws NodeTreeException if any of the given bounds are invalid or if any data item
+   * is given more than once
+   */
+  void build(std::vector<std::pair<vm::bbox<T, 3>, U>> items)
+  {
+    clear();
+    if (items.empty())
+    {
+      return;
+    }
+
+    auto bulk_items = std::vector<bulk_item>{};
+    bulk_items.reserve(items.size());
+
+    auto root_address = std::optional<detail::node_address>{};
+    for (auto& [bounds, data] : items)
+    {
+      check(bounds);
+
+      const auto address = detail::get_container(bounds, m_min_size);
+      const auto item_root_address = is_root(address) ? address : get_root(address);
+      if (!root_address || item_root_address.size > root_address->size)
+      {
+        root_address = item_root_address;
+      }
+
+      bulk_items.push_back({address, detail::get_morton_code(address), std::move(data)});
+    }
+
+    m_node_address_for_data.reserve(bulk_items.size());
+    for (const auto& item : bulk_items)
+    {
+      const auto& address = is_root(item.address) ? *root_address : item.address;
+      if (!m_node_address_for_data.emplace(item.data, address).second)
+      {
+        clear();
+        throw NodeTreeException("Data already in tree");
+      }
+    }
+
+    std::stable_sort(
+      bulk_items.begin(), bulk_items.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.morton_code < rhs.morton_code;
+      });
+
+    m_root = build_node(*root_address, bulk_items);
+  }
+
   /**
    * Removes the node with the given data from this tree.
    *
@@ -538,16 +807,11 @@ public:
   {
     if (m_root)
     {
-      visit_node_if(
-        *m_root,
-        [&](const auto& node) {
-          const auto& data = get_data(node);
-          std::copy(data.begin(), data.end(), out);
-        },
-        [&](const auto& node) {
-          const auto bounds = get_address(node).to_bounds(m_min_size);
-          return bounds.contains(ray.origin) || vm::intersect_ray_bbox(ray, bounds);
-        });
+      const auto query = ray_query{ray};
+      if (intersect_ray_nodes(query, std::span{&*m_root, 1}, m_min_size))
+      {
+        find_ray_intersectors(*m_root, query, m_min_size, out);
+      }
     }
   }
 
@@ -591,6 +855,57 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree that may be inside of the convex volume bounded by
+   * the given planes and returns a list of those items.
+   *
+   * @param planes the planes bounding the volume, their normals must point outwards
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_in_convex_volume(const std::vector<vm::plane<T, 3>>& planes) const
+  {
+    auto result = std::vector<U>{};
+    find_in_convex_volume(planes, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree that may be inside of the convex volume bounded by
+   * the given planes and appends it to the given output iterator.
+   *
+   * A tree node is skipped if its bounds are entirely above one of the planes. This test
+   * is conservative, so items that are stored in a tree node which intersects the volume
+   * are found even if their own bounding box does not.
+   *
+   * @tparam O the output iterator type
+   * @param planes the planes bounding the volume, their normals must point outwards
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_in_convex_volume(const std::vector<vm::plane<T, 3>>& planes, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          const auto bounds = get_address(node).to_bounds(m_min_size);
+          return std::none_of(planes.begin(), planes.end(), [&](const auto& plane) {
+            // the corner of the bounds that is furthest below the plane
+            const auto corner = vm::vec<T, 3>{
+              plane.normal.x() >= T(0) ? bounds.min.x() : bounds.max.x(),
+              plane.normal.y() >= T(0) ? bounds.min.y() : bounds.max.y(),
+              plane.normal.z() >= T(0) ? bounds.min.z() : bounds.max.z()};
+            return plane.point_distance(corner) > T(0);
+          });
+        });
+    }
+  }
+
   /**
    * Finds every data item in this tree whose bounding box contains the given point and
    * returns a list of those items.
@@ -630,6 +945,50 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree whose bounding box may not be contained in the
+   * given bbox and returns a list of those items.
+   *
+   * @param bbox the bbox to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_uncontained(const vm::bbox<T, 3>& bbox) const
+  {
+    auto result = std::vector<U>{};
+    find_uncontained(bbox, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box may not be contained in the
+   * given bbox and appends it to the given output iterator.
+   *
+   * A tree node is skipped together with its subtree if its bounds are contained in the
+   * given bbox, since the items stored in it must then be contained in the bbox, too.
+   * This test is conservative, so items that are stored in a tree node which is not
+   * contained in the bbox are found even if their own bounding box is.
+   *
+   * @tparam O the output iterator type
+   * @param bbox the bbox to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_uncontained(const vm::bbox<T, 3>& bbox, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          return !bbox.contains(get_address(node).to_bounds(m_min_size));
+        });
+    }
+  }
+
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
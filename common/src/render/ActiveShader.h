@@ -21,7 +21,7 @@
 
 #include "render/ShaderProgram.h"
 
-#include <string>
+#include <string_view>
 
 namespace tb::render
 {
@@ -39,7 +39,7 @@ public:
   ~ActiveShader();
 
   template <class T>
-  void set(const std::string& name, const T& value)
+  void set(const std::string_view name, const T& value)
   {
     m_program.set(name, value);
   }
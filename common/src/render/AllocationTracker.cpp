@@ -190,6 +190,8 @@ AllocationTracker::Block* AllocationTracker::allocate(const size_t needed)
   block->nextOfSameSize = nullptr;
   block->prevOfSameSize = nullptr;
 
+  m_allocatedSize += needed;
+
   if (block->size == needed)
   {
     // lucky case: exact size. we're done
@@ -243,6 +245,8 @@ void AllocationTracker::free(Block* block)
   assert(block->prevOfSameSize == nullptr);
   assert(block->nextOfSameSize == nullptr);
 
+  m_allocatedSize -= block->size;
+
   Block* left = block->left;
   Block* right = block->right;
 
@@ -348,6 +352,7 @@ void AllocationTracker::free(Block* block)
 
 AllocationTracker::AllocationTracker(const Index initial_capacity)
   : m_capacity(0)
+  , m_allocatedSize(0)
   , m_leftmostBlock(nullptr)
   , m_rightmostBlock(nullptr)
   , m_recycledBlockList(nullptr)
@@ -361,6 +366,7 @@ AllocationTracker::AllocationTracker(const Index initial_capacity)
 
 AllocationTracker::AllocationTracker()
   : m_capacity(0)
+  , m_allocatedSize(0)
   , m_leftmostBlock(nullptr)
   , m_rightmostBlock(nullptr)
   , m_recycledBlockList(nullptr)
@@ -390,6 +396,11 @@ size_t AllocationTracker::capacity() const
   return static_cast<size_t>(m_capacity);
 }
 
+size_t AllocationTracker::allocatedSize() const
+{
+  return static_cast<size_t>(m_allocatedSize);
+}
+
 void AllocationTracker::expand(const Index newCapacity)
 {
   checkInvariants();
@@ -458,6 +469,76 @@ void AllocationTracker::expand(const Index newCapacity)
   checkInvariants();
 }
 
+std::vector<AllocationTracker::Move> AllocationTracker::compact(const Index newCapacity)
+{
+  checkInvariants();
+  assert(newCapacity >= m_allocatedSize);
+
+  auto moves = std::vector<Move>{};
+
+  // the free blocks are recycled, so the bins will be empty
+  m_freeBlockSizeBins.clear();
+
+  // relink the used blocks without the free blocks between them
+  Block* lastUsedBlock = nullptr;
+  Index pos = 0;
+
+  Block* next;
+  for (Block* block = m_leftmostBlock; block != nullptr; block = next)
+  {
+    next = block->right;
+
+    if (block->free)
+    {
+      block->prevOfSameSize = nullptr;
+      block->nextOfSameSize = nullptr;
+      recycle(block);
+      continue;
+    }
+
+    if (block->pos != pos)
+    {
+      moves.push_back(Move{block->pos, pos, block->size});
+      block->pos = pos;
+    }
+
+    block->left = lastUsedBlock;
+    if (lastUsedBlock == nullptr)
+    {
+      m_leftmostBlock = block;
+    }
+    else
+    {
+      lastUsedBlock->right = block;
+    }
+
+    lastUsedBlock = block;
+    pos += block->size;
+  }
+
+  if (lastUsedBlock == nullptr)
+  {
+    m_leftmostBlock = nullptr;
+    m_rightmostBlock = nullptr;
+  }
+  else
+  {
+    lastUsedBlock->right = nullptr;
+    m_rightmostBlock = lastUsedBlock;
+  }
+
+  assert(pos == m_allocatedSize);
+  m_capacity = pos;
+
+  if (newCapacity > m_capacity)
+  {
+    expand(newCapacity);
+  }
+
+  checkInvariants();
+  return moves;
+}
+
 bool AllocationTracker::hasAllocations() const
 {
   // NOTE: this loop should execute at most 2 iterations, because adjacent free blocks are
@@ -526,10 +607,15 @@ void AllocationTracker::checkInvariants() const
 
   // check the left/right pointers, size, pos
   size_t totalSize = 0;
+  size_t usedSize = 0;
   for (Block* block = m_leftmostBlock; block != nullptr; block = block->right)
   {
     assert(block->size != 0);
     totalSize += block->size;
+    if (!block->free)
+    {
+      usedSize += block->size;
+    }
 
     if (block->right != nullptr)
     {
@@ -550,6 +636,7 @@ void AllocationTracker::checkInvariants() const
     }
   }
   assert(m_capacity == totalSize);
+  assert(m_allocatedSize == usedSize);
 
   // check the size map
   for (const auto& headBlock : m_freeBlockSizeBins)
@@ -66,6 +66,18 @@ public:
     Block* nextRecycledBlock;
   };
 
+  /**
+   * Describes how an allocation was moved by compact().
+   */
+  struct Move
+  {
+    Index oldPos;
+    Index newPos;
+    Index size;
+
+    auto operator<=>(const Move& other) const = default;
+  };
+
 private:
   /**
    * Size of memory managed by this AllocationTracker.
@@ -73,6 +85,11 @@ private:
    */
   Index m_capacity;
 
+  /**
+   * The sum of `size` of all used Blocks.
+   */
+  Index m_allocatedSize;
+
   /**
    * Points to the Block with pos 0. Used to free all of the blocks in the destructor
    */
@@ -125,7 +142,22 @@ public:
   Block* allocate(size_t size);
   void free(Block* block);
   size_t capacity() const;
+  /**
+   * Returns the sum of the sizes of all allocations. Constant time.
+   */
+  size_t allocatedSize() const;
   void expand(Index newCapacity);
+  /**
+   * Moves all allocations to the beginning of the managed range without changing their
+   * order, and sets the capacity to the given value, which must not be less than
+   * allocatedSize().
+   *
+   * The allocated Block objects remain valid, only their `pos` changes. The caller must
+   * apply the returned moves to the memory it manages. The moves are sorted by position
+   * and every allocation is moved to a lower position, so the moves can be applied in
+   * order without overwriting allocations that haven't been moved yet.
+   */
+  std::vector<Move> compact(Index newCapacity);
   /**
    * @return whether there are any allocations. i.e. returns false iff the whole range
    * managed by the allocation tracker is free. Returns false if `capacity() == 0`.
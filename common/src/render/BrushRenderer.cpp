@@ -19,6 +19,7 @@
 
 #include "BrushRenderer.h"
 
+#include "MemoryReport.h"
 #include "PreferenceManager.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
@@ -29,10 +30,24 @@
 #include "mdl/TagAttribute.h"
 #include "render/BrushRendererArrays.h"
 #include "render/BrushRendererBrushCache.h"
+#include "render/Camera.h"
+#include "render/GLVertexType.h"
+#include "render/OcclusionCuller.h"
+#include "render/PrimType.h"
 #include "render/RenderContext.h"
+#include "render/RenderUtils.h"
+#include "render/VertexArray.h"
 
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::render
@@ -41,6 +56,26 @@ namespace tb::render
 namespace
 {
 
+/**
+ * Brushes are staged in chunks of this size, since staging a single brush is cheap.
+ */
+constexpr auto StagingChunkSize = size_t(256);
+
+/**
+ * If validation is limited by a time budget, brushes are validated in batches of this
+ * size, and the time is checked after each batch.
+ */
+constexpr auto ValidationBatchSize = 16 * StagingChunkSize;
+
+/**
+ * A brush is hidden by its vertex flags if it is selected itself or as part of its
+ * containing entity or group, see DefaultFilter::selected.
+ */
+bool isSelected(const mdl::BrushNode& brushNode)
+{
+  return brushNode.selected() || brushNode.parentSelected();
+}
+
 class FilterWrapper : public BrushRenderer::Filter
 {
 private:
@@ -63,8 +98,49 @@ public:
   }
 };
 
+BrushIndexRange toIndexRange(const AllocationTracker::Block& block)
+{
+  return {block.pos, block.size};
+}
+
+bool isAbovePlane(const vm::bbox3d& bounds, const vm::plane3d& plane)
+{
+  // the corner of the bounds that is furthest below the plane
+  const auto corner = vm::vec3d{
+    plane.normal.x() >= 0.0 ? bounds.min.x() : bounds.max.x(),
+    plane.normal.y() >= 0.0 ? bounds.min.y() : bounds.max.y(),
+    plane.normal.z() >= 0.0 ? bounds.min.z() : bounds.max.z()};
+  return plane.point_distance(corner) > 0.0;
+}
+
 } // namespace
 
+/**
+ * The indices of the edges and faces of a brush, relative to the first vertex of the
+ * brush. They are built in parallel and copied into the index arrays of the brush's chunk
+ * afterwards.
+ */
+struct BrushRenderer::StagedBrush
+{
+  struct FaceIndices
+  {
+    const mdl::Material* material;
+    bool transparent;
+    size_t offset;
+    size_t count;
+  };
+
+  const mdl::BrushNode* brushNode;
+  Filter::EdgeRenderPolicy edgePolicy;
+
+  /**
+   * The edge indices come first, followed by the face indices.
+   */
+  std::vector<GLuint> indices = {};
+  size_t edgeIndexCount = 0;
+  std::vector<FaceIndices> faceIndices = {};
+};
+
 // Filter
 
 BrushRenderer::Filter::Filter() = default;
@@ -184,8 +260,7 @@ void BrushRenderer::invalidate()
   m_invalidBrushes = m_allBrushes;
 
   assert(m_brushInfo.empty());
-  assert(m_transparentFaces->empty());
-  assert(m_opaqueFaces->empty());
+  assert(m_chunks.empty());
 }
 
 void BrushRenderer::invalidateMaterials(
@@ -199,7 +274,9 @@ void BrushRenderer::invalidateMaterials(
     {
       if (materialSet.count(face.material()) > 0)
       {
+        // the materials may be deleted, so the brush must not keep referring to them
         brush->brushRendererBrushCache().invalidateVertexCache();
+        removeBrushFromVbo(*brush);
         invalidateBrush(brush);
       }
     }
@@ -215,10 +292,25 @@ void BrushRenderer::invalidateBrush(const mdl::BrushNode* brushNode)
     assert(m_invalidBrushes.find(brushNode) == std::end(m_invalidBrushes));
     return;
   }
-  // if it's not in the invalid set, put it in
-  if (m_invalidBrushes.insert(brushNode).second)
+  // the brush stays in the VBO until it is validated, see commitBrush
+  m_invalidBrushes.insert(brushNode);
+}
+
+void BrushRenderer::updateBrushSelection(const mdl::BrushNode* brushNode)
+{
+  if (!m_hideSelectedBrushes)
   {
-    removeBrushFromVbo(*brushNode);
+    invalidateBrush(brushNode);
+    return;
+  }
+
+  // invalid brushes get their flags when they are committed, and brushes that are not in
+  // the VBO have no flags
+  if (const auto it = m_brushInfo.find(brushNode); it != m_brushInfo.end())
+  {
+    const auto& info = it->second;
+    m_chunks.at(info.chunkKey)
+      .vertexArray->setHidden(info.vertexHolderKey, isSelected(*brushNode));
   }
 }
 
@@ -232,16 +324,8 @@ void BrushRenderer::clear()
   m_brushInfo.clear();
   m_allBrushes.clear();
   m_invalidBrushes.clear();
-
-  m_vertexArray = std::make_shared<BrushVertexArray>();
-  m_edgeIndices = std::make_shared<BrushIndexArray>();
-  m_transparentFaces = std::make_shared<MaterialToBrushIndicesMap>();
-  m_opaqueFaces = std::make_shared<MaterialToBrushIndicesMap>();
-
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  m_chunks.clear();
+  m_visibleIndexRangesValid = false;
 }
 
 void BrushRenderer::setFaceColor(const Color& faceColor)
@@ -311,6 +395,79 @@ void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes)
   }
 }
 
+void BrushRenderer::setHideSelectedBrushes(const bool hideSelectedBrushes)
+{
+  if (hideSelectedBrushes != m_hideSelectedBrushes)
+  {
+    invalidate();
+    m_hideSelectedBrushes = hideSelectedBrushes;
+  }
+}
+
+void BrushRenderer::setVisibleBrushes(
+  std::shared_ptr<const std::vector<const mdl::BrushNode*>> visibleBrushes)
+{
+  if (
+    visibleBrushes != m_visibleBrushes
+    && !(visibleBrushes && m_visibleBrushes && *visibleBrushes == *m_visibleBrushes))
+  {
+    m_visibleBrushes = std::move(visibleBrushes);
+    m_visibleIndexRangesValid = false;
+  }
+}
+
+void BrushRenderer::cullBrushes(const std::vector<vm::plane3d>& viewVolume)
+{
+  auto visibleBrushes = std::vector<const mdl::BrushNode*>{};
+  for (const auto* brushNode : m_allBrushes)
+  {
+    if (std::ranges::none_of(viewVolume, [&](const auto& plane) {
+          return isAbovePlane(brushNode->physicalBounds(), plane);
+        }))
+    {
+      visibleBrushes.push_back(brushNode);
+    }
+  }
+
+  if (!m_visibleBrushes || *m_visibleBrushes != visibleBrushes)
+  {
+    setVisibleBrushes(std::make_shared<const std::vector<const mdl::BrushNode*>>(
+      std::move(visibleBrushes)));
+  }
+}
+
+void BrushRenderer::setViewVolume(
+  std::shared_ptr<const std::vector<vm::plane3d>> viewVolume)
+{
+  m_viewVolume = std::move(viewVolume);
+}
+
+void BrushRenderer::setCoarseChunkSize(const std::optional<double> coarseChunkSize)
+{
+  m_coarseChunkSize = coarseChunkSize;
+}
+
+void BrushRenderer::setChunkSize(const std::optional<double> chunkSize)
+{
+  assert(!chunkSize || *chunkSize > 0.0);
+  if (chunkSize != m_chunkSize)
+  {
+    invalidate();
+    m_chunkSize = chunkSize;
+  }
+}
+
+void BrushRenderer::setTaskManager(kdl::task_manager* taskManager)
+{
+  m_taskManager = taskManager;
+}
+
+void BrushRenderer::setValidationTimeBudget(
+  const std::optional<std::chrono::steady_clock::duration> validationTimeBudget)
+{
+  m_validationTimeBudget = validationTimeBudget;
+}
+
 void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   renderOpaque(renderContext, renderBatch);
@@ -325,14 +482,19 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
     {
       validate();
     }
+    if (m_visibleBrushes && !m_visibleIndexRangesValid)
+    {
+      validateVisibleIndexRanges();
+    }
     if (renderContext.showFaces())
     {
-      renderOpaqueFaces(renderBatch);
+      renderOpaqueFaces(renderContext, renderBatch);
     }
     if (renderContext.showEdges() || m_showEdges)
     {
-      renderEdges(renderBatch);
+      renderEdges(renderContext, renderBatch);
     }
+    renderCoarseChunks(renderContext, renderBatch);
   }
 }
 
@@ -345,72 +507,284 @@ void BrushRenderer::renderTransparent(
     {
       validate();
     }
+    if (m_visibleBrushes && !m_visibleIndexRangesValid)
+    {
+      validateVisibleIndexRanges();
+    }
     if (renderContext.showFaces())
     {
-      renderTransparentFaces(renderBatch);
+      renderTransparentFaces(renderContext, renderBatch);
     }
   }
 }
 
-void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch)
+void BrushRenderer::renderOpaqueFaces(
+  RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  m_opaqueFaceRenderer.setGrayscale(m_grayscale);
-  m_opaqueFaceRenderer.setTint(m_tint);
-  m_opaqueFaceRenderer.setTintColor(m_tintColor);
-  m_opaqueFaceRenderer.render(renderBatch);
+  for (auto& [key, chunk] : m_chunks)
+  {
+    if (
+      isChunkVisible(renderContext, key, chunk) && !isChunkCoarse(renderContext, chunk))
+    {
+      chunk.opaqueFaceRenderer.setGrayscale(m_grayscale);
+      chunk.opaqueFaceRenderer.setTint(m_tint);
+      chunk.opaqueFaceRenderer.setTintColor(m_tintColor);
+      chunk.opaqueFaceRenderer.setIndexRanges(
+        m_visibleBrushes ? chunk.visibleOpaqueFaceRanges : nullptr);
+      chunk.opaqueFaceRenderer.render(renderBatch);
+    }
+  }
 }
 
-void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch)
+void BrushRenderer::renderTransparentFaces(
+  RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  m_transparentFaceRenderer.setGrayscale(m_grayscale);
-  m_transparentFaceRenderer.setTint(m_tint);
-  m_transparentFaceRenderer.setTintColor(m_tintColor);
-  m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
-  m_transparentFaceRenderer.render(renderBatch);
+  for (auto& [key, chunk] : m_chunks)
+  {
+    if (
+      isChunkVisible(renderContext, key, chunk) && !isChunkCoarse(renderContext, chunk))
+    {
+      chunk.transparentFaceRenderer.setGrayscale(m_grayscale);
+      chunk.transparentFaceRenderer.setTint(m_tint);
+      chunk.transparentFaceRenderer.setTintColor(m_tintColor);
+      chunk.transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+      chunk.transparentFaceRenderer.setIndexRanges(
+        m_visibleBrushes ? chunk.visibleTransparentFaceRanges : nullptr);
+      chunk.transparentFaceRenderer.render(renderBatch);
+    }
+  }
 }
 
-void BrushRenderer::renderEdges(RenderBatch& renderBatch)
+void BrushRenderer::renderEdges(
+  RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (m_showOccludedEdges)
+  for (auto& [key, chunk] : m_chunks)
   {
-    m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+    if (
+      isChunkVisible(renderContext, key, chunk) && !isChunkCoarse(renderContext, chunk))
+    {
+      chunk.edgeRenderer.setIndexRanges(
+        m_visibleBrushes ? chunk.visibleEdgeRanges : nullptr);
+      if (m_showOccludedEdges && !renderContext.reducedQuality())
+      {
+        chunk.edgeRenderer.renderWithOccluded(
+          renderBatch, m_edgeColor, m_occludedEdgeColor);
+      }
+      else
+      {
+        chunk.edgeRenderer.render(renderBatch, m_edgeColor);
+      }
+    }
+  }
+}
+
+void BrushRenderer::renderCoarseChunks(
+  RenderContext& renderContext, RenderBatch& renderBatch)
+{
+  auto vertices = std::vector<GLVertexTypes::P3::Vertex>{};
+  for (const auto& [key, chunk] : m_chunks)
+  {
+    if (isChunkVisible(renderContext, key, chunk) && isChunkCoarse(renderContext, chunk))
+    {
+      chunk.bounds.for_each_edge([&](const auto& v1, const auto& v2) {
+        vertices.emplace_back(vm::vec3f{v1});
+        vertices.emplace_back(vm::vec3f{v2});
+      });
+    }
+  }
+
+  if (!vertices.empty())
+  {
+    auto boundsRenderer =
+      DirectEdgeRenderer{VertexArray::move(std::move(vertices)), PrimType::Lines};
+    boundsRenderer.render(renderBatch, m_edgeColor);
   }
-  m_edgeRenderer.render(renderBatch, m_edgeColor);
 }
 
 void BrushRenderer::validate()
 {
   assert(!valid());
 
-  for (auto* brushNode : m_invalidBrushes)
+  if (!m_validationTimeBudget)
   {
-    validateBrush(*brushNode);
+    const auto invalidBrushes = std::vector<const mdl::BrushNode*>{
+      m_invalidBrushes.begin(), m_invalidBrushes.end()};
+    validateBrushes(invalidBrushes);
+    m_invalidBrushes.clear();
   }
-  m_invalidBrushes.clear();
-  assert(valid());
+  else
+  {
+    const auto deadline = std::chrono::steady_clock::now() + *m_validationTimeBudget;
+    do
+    {
+      auto batch = std::vector<const mdl::BrushNode*>{};
+      batch.reserve(std::min(ValidationBatchSize, m_invalidBrushes.size()));
+      for (auto* brushNode : m_invalidBrushes)
+      {
+        if (batch.size() == ValidationBatchSize)
+        {
+          break;
+        }
+        batch.push_back(brushNode);
+      }
 
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+      validateBrushes(batch);
+      for (const auto* brushNode : batch)
+      {
+        m_invalidBrushes.erase(brushNode);
+      }
+    } while (!valid() && std::chrono::steady_clock::now() < deadline);
+  }
+
+  compactChunks();
+
+  for (auto& [key, chunk] : m_chunks)
+  {
+    chunk.opaqueFaceRenderer =
+      FaceRenderer{chunk.vertexArray, chunk.opaqueFaces, m_faceColor};
+    chunk.transparentFaceRenderer =
+      FaceRenderer{chunk.vertexArray, chunk.transparentFaces, m_faceColor};
+    chunk.edgeRenderer = IndexedEdgeRenderer{chunk.vertexArray, chunk.edgeIndices};
+  }
+  m_visibleIndexRangesValid = false;
 }
 
-static size_t triIndicesCountForPolygon(const size_t vertexCount)
+void BrushRenderer::validateBrushes(std::span<const mdl::BrushNode* const> brushNodes)
 {
-  assert(vertexCount >= 3);
-  const size_t indexCount = 3 * (vertexCount - 2);
-  return indexCount;
+  // The filter is evaluated on this thread because it may query the editor context, which
+  // is not thread safe. It marks the faces to render, which are read by stageBrush.
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+
+  auto stagedBrushes = std::vector<StagedBrush>{};
+  stagedBrushes.reserve(brushNodes.size());
+  for (const auto* brushNode : brushNodes)
+  {
+    assert(m_allBrushes.find(brushNode) != std::end(m_allBrushes));
+
+    const auto [facePolicy, edgePolicy] = wrapper.markFaces(*brushNode);
+    if (
+      facePolicy != Filter::FaceRenderPolicy::RenderNone
+      || edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
+    {
+      stagedBrushes.push_back(StagedBrush{brushNode, edgePolicy});
+    }
+    else
+    {
+      removeBrushFromVbo(*brushNode);
+    }
+  }
+
+  // building the vertex caches and the indices of the brushes only touches the brushes
+  // themselves, so it can be done in parallel
+  const auto stage = [&](const size_t i) { stageBrush(stagedBrushes[i]); };
+  if (m_taskManager)
+  {
+    m_taskManager->parallel_for(stagedBrushes.size(), stage, StagingChunkSize);
+  }
+  else
+  {
+    for (size_t i = 0; i < stagedBrushes.size(); ++i)
+    {
+      stage(i);
+    }
+  }
+
+  // the allocation trackers are not thread safe
+  for (const auto& stagedBrush : stagedBrushes)
+  {
+    commitBrush(stagedBrush);
+  }
+}
+
+void BrushRenderer::validateVisibleIndexRanges()
+{
+  assert(m_visibleBrushes);
+
+  for (auto& [key, chunk] : m_chunks)
+  {
+    chunk.visibleOpaqueFaceRanges = std::make_shared<MaterialToBrushIndexRangesMap>();
+    chunk.visibleTransparentFaceRanges =
+      std::make_shared<MaterialToBrushIndexRangesMap>();
+    chunk.visibleEdgeRanges = std::make_shared<std::vector<BrushIndexRange>>();
+  }
+
+  for (const auto* brushNode : *m_visibleBrushes)
+  {
+    if (const auto it = m_brushInfo.find(brushNode); it != m_brushInfo.end())
+    {
+      const auto& info = it->second;
+      auto& chunk = m_chunks.at(info.chunkKey);
+      if (info.edgeIndicesKey)
+      {
+        chunk.visibleEdgeRanges->push_back(toIndexRange(*info.edgeIndicesKey));
+      }
+      for (const auto& [material, key] : info.opaqueFaceIndicesKeys)
+      {
+        (*chunk.visibleOpaqueFaceRanges)[material].push_back(toIndexRange(*key));
+      }
+      for (const auto& [material, key] : info.transparentFaceIndicesKeys)
+      {
+        (*chunk.visibleTransparentFaceRanges)[material].push_back(toIndexRange(*key));
+      }
+    }
+  }
+
+  for (auto& [key, chunk] : m_chunks)
+  {
+    mergeIndexRanges(*chunk.visibleEdgeRanges);
+    for (auto& [material, ranges] : *chunk.visibleOpaqueFaceRanges)
+    {
+      mergeIndexRanges(ranges);
+    }
+    for (auto& [material, ranges] : *chunk.visibleTransparentFaceRanges)
+    {
+      mergeIndexRanges(ranges);
+    }
+  }
+
+  m_visibleIndexRangesValid = true;
+}
+
+bool BrushRenderer::isChunkVisible(
+  const RenderContext& renderContext, const ChunkKey& key, const Chunk& chunk) const
+{
+  if (
+    m_viewVolume && std::ranges::any_of(*m_viewVolume, [&](const auto& plane) {
+      return isAbovePlane(chunk.bounds, plane);
+    }))
+  {
+    return false;
+  }
+
+  auto* occlusionCuller = renderContext.occlusionCuller();
+  return !m_chunkSize || !occlusionCuller || occlusionCuller->testCell(key, chunk.bounds);
+}
+
+bool BrushRenderer::isChunkCoarse(
+  const RenderContext& renderContext, const Chunk& chunk) const
+{
+  return m_chunkSize && m_coarseChunkSize && renderContext.render2D()
+         && projectedSize(chunk.bounds, renderContext.camera()) < *m_coarseChunkSize;
 }
 
 static void addTriIndicesForPolygon(
-  GLuint* dest, const GLuint baseIndex, const size_t vertexCount)
+  std::vector<GLuint>& dest, const GLuint baseIndex, const size_t vertexCount)
 {
   assert(vertexCount >= 3);
   for (size_t i = 0; i < vertexCount - 2; ++i)
   {
-    *(dest++) = baseIndex;
-    *(dest++) = baseIndex + static_cast<GLuint>(i + 1);
-    *(dest++) = baseIndex + static_cast<GLuint>(i + 2);
+    dest.push_back(baseIndex);
+    dest.push_back(baseIndex + static_cast<GLuint>(i + 1));
+    dest.push_back(baseIndex + static_cast<GLuint>(i + 2));
+  }
+}
+
+static void copyIndices(
+  const GLuint* src, const size_t count, const GLuint baseIndex, GLuint* dest)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    dest[i] = baseIndex + src[i];
   }
 }
 
@@ -436,53 +810,6 @@ static inline bool shouldRenderEdge(
   }
 }
 
-static size_t countMarkedEdgeIndices(
-  const mdl::BrushNode& brushNode, const BrushRenderer::Filter::EdgeRenderPolicy policy)
-{
-  using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
-
-  if (policy == EdgeRenderPolicy::RenderNone)
-  {
-    return 0;
-  }
-
-  size_t indexCount = 0;
-  for (const auto& edge : brushNode.brushRendererBrushCache().cachedEdges())
-  {
-    if (shouldRenderEdge(edge, policy))
-    {
-      indexCount += 2;
-    }
-  }
-  return indexCount;
-}
-
-static void getMarkedEdgeIndices(
-  const mdl::BrushNode& brushNode,
-  const BrushRenderer::Filter::EdgeRenderPolicy policy,
-  const GLuint brushVerticesStartIndex,
-  GLuint* dest)
-{
-  using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
-
-  if (policy == EdgeRenderPolicy::RenderNone)
-  {
-    return;
-  }
-
-  size_t i = 0;
-  for (const auto& edge : brushNode.brushRendererBrushCache().cachedEdges())
-  {
-    if (shouldRenderEdge(edge, policy))
-    {
-      dest[i++] =
-        static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex1RelativeToBrush);
-      dest[i++] =
-        static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex2RelativeToBrush);
-    }
-  }
-}
-
 bool BrushRenderer::shouldDrawFaceInTransparentPass(
   const mdl::BrushNode& brushNode, const mdl::BrushFace& face) const
 {
@@ -508,168 +835,355 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(
   return false;
 }
 
-void BrushRenderer::validateBrush(const mdl::BrushNode& brushNode)
+void BrushRenderer::stageBrush(StagedBrush& stagedBrush) const
 {
-  assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
-  assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
-  assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
+  const auto& brushNode = *stagedBrush.brushNode;
 
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+  auto& brushCache = brushNode.brushRendererBrushCache();
+  brushCache.validateVertexCache(brushNode);
+  ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
 
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
-  const auto [facePolicy, edgePolicy] = settings;
+  auto& indices = stagedBrush.indices;
 
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
+  // edge indices
+  if (stagedBrush.edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
   {
-    // NOTE: this skips inserting the brush into m_brushInfo
-    return;
+    for (const auto& edge : brushCache.cachedEdges())
+    {
+      if (shouldRenderEdge(edge, stagedBrush.edgePolicy))
+      {
+        indices.push_back(static_cast<GLuint>(edge.vertexIndex1RelativeToBrush));
+        indices.push_back(static_cast<GLuint>(edge.vertexIndex2RelativeToBrush));
+      }
+    }
+  }
+  stagedBrush.edgeIndexCount = indices.size();
+
+  // face indices
+  const auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
+  const auto facesSortedByMaterialCount = facesSortedByMaterial.size();
+
+  size_t nextI;
+  for (size_t i = 0; i < facesSortedByMaterialCount; i = nextI)
+  {
+    const auto* material = facesSortedByMaterial[i].material;
+
+    // find the i value for the next material
+    for (nextI = i + 1; nextI < facesSortedByMaterialCount
+                        && facesSortedByMaterial[nextI].material == material;
+         ++nextI)
+    {
+    }
+
+    // process all faces with this material (they'll be consecutive)
+    for (const auto transparent : {true, false})
+    {
+      const auto offset = indices.size();
+      for (size_t j = i; j < nextI; ++j)
+      {
+        const auto& cache = facesSortedByMaterial[j];
+        if (
+          cache.face->isMarked()
+          && shouldDrawFaceInTransparentPass(brushNode, *cache.face) == transparent)
+        {
+          addTriIndicesForPolygon(
+            indices,
+            static_cast<GLuint>(cache.indexOfFirstVertexRelativeToBrush),
+            cache.vertexCount);
+        }
+      }
+
+      if (indices.size() > offset)
+      {
+        stagedBrush.faceIndices.push_back(
+          {material, transparent, offset, indices.size() - offset});
+      }
+    }
+  }
+}
+
+void BrushRenderer::commitBrush(const StagedBrush& stagedBrush)
+{
+  const auto& brushNode = *stagedBrush.brushNode;
+  if (const auto it = m_brushInfo.find(&brushNode); it != std::end(m_brushInfo))
+  {
+    if (replaceBrushVertices(it->second, stagedBrush))
+    {
+      return;
+    }
+    removeBrushFromVbo(brushNode);
   }
 
   BrushInfo& info = m_brushInfo[&brushNode];
+  info.chunkKey = chunkKey(brushNode);
 
-  // collect vertices
-  auto& brushCache = brushNode.brushRendererBrushCache();
-  brushCache.validateVertexCache(brushNode);
-  const auto& cachedVertices = brushCache.cachedVertices();
-  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+  auto& chunk = findOrCreateChunk(info.chunkKey);
+  chunk.bounds = chunk.brushCount == 0 ? brushNode.physicalBounds()
+                                       : vm::merge(chunk.bounds, brushNode.physicalBounds());
+  ++chunk.brushCount;
 
-  assert(m_vertexArray != nullptr);
+  // insert vertices into VBO
+  const auto& cachedVertices = brushNode.brushRendererBrushCache().cachedVertices();
   auto [vertBlock, dest] =
-    m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+    chunk.vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
   std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
   info.vertexHolderKey = vertBlock;
 
+  if (m_hideSelectedBrushes && isSelected(brushNode))
+  {
+    chunk.vertexArray->setHidden(vertBlock, true);
+  }
+
   const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+  const auto* indices = stagedBrush.indices.data();
 
   // insert edge indices into VBO
+  if (stagedBrush.edgeIndexCount > 0)
+  {
+    auto [key, insertDest] =
+      chunk.edgeIndices->getPointerToInsertElementsAt(stagedBrush.edgeIndexCount);
+    info.edgeIndicesKey = key;
+    copyIndices(indices, stagedBrush.edgeIndexCount, brushVerticesStartIndex, insertDest);
+  }
+  else
+  {
+    // it's possible to have no edges to render
+    // e.g. select all faces of a brush, and the unselected brush renderer
+    // will hit this branch.
+    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+  }
+
+  // insert face indices into VBO
+  for (const auto& faceIndices : stagedBrush.faceIndices)
   {
-    const auto edgeIndexCount = countMarkedEdgeIndices(brushNode, edgePolicy);
-    if (edgeIndexCount > 0)
+    auto& faceVboMap =
+      faceIndices.transparent ? *chunk.transparentFaces : *chunk.opaqueFaces;
+    auto& holderPtr = faceVboMap[faceIndices.material];
+    if (holderPtr == nullptr)
     {
-      auto [key, insertDest] =
-        m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-      info.edgeIndicesKey = key;
-      getMarkedEdgeIndices(brushNode, edgePolicy, brushVerticesStartIndex, insertDest);
+      // inserts into map!
+      holderPtr = std::make_shared<BrushIndexArray>();
     }
-    else
+
+    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(faceIndices.count);
+    copyIndices(
+      indices + faceIndices.offset,
+      faceIndices.count,
+      brushVerticesStartIndex,
+      insertDest);
+
+    auto& keys = faceIndices.transparent ? info.transparentFaceIndicesKeys
+                                         : info.opaqueFaceIndicesKeys;
+    keys.emplace_back(faceIndices.material, key);
+  }
+}
+
+bool BrushRenderer::replaceBrushVertices(BrushInfo& info, const StagedBrush& stagedBrush)
+{
+  const auto& brushNode = *stagedBrush.brushNode;
+  const auto& cachedVertices = brushNode.brushRendererBrushCache().cachedVertices();
+  if (
+    info.chunkKey != chunkKey(brushNode)
+    || info.vertexHolderKey->size != cachedVertices.size())
+  {
+    return false;
+  }
+
+  auto& chunk = m_chunks.at(info.chunkKey);
+  const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
+  const auto* indices = stagedBrush.indices.data();
+
+  const auto edgeIndicesEqual =
+    info.edgeIndicesKey ? chunk.edgeIndices->elementsWithKeyEqual(
+                            info.edgeIndicesKey,
+                            indices,
+                            stagedBrush.edgeIndexCount,
+                            brushVerticesStartIndex)
+                        : stagedBrush.edgeIndexCount == 0;
+  if (!edgeIndicesEqual)
+  {
+    return false;
+  }
+
+  // the face indices were inserted in the order in which they were staged
+  auto opaqueIt = info.opaqueFaceIndicesKeys.begin();
+  auto transparentIt = info.transparentFaceIndicesKeys.begin();
+  for (const auto& faceIndices : stagedBrush.faceIndices)
+  {
+    auto& keys = faceIndices.transparent ? info.transparentFaceIndicesKeys
+                                         : info.opaqueFaceIndicesKeys;
+    auto& it = faceIndices.transparent ? transparentIt : opaqueIt;
+    if (it == keys.end() || it->first != faceIndices.material)
     {
-      // it's possible to have no edges to render
-      // e.g. select all faces of a brush, and the unselected brush renderer
-      // will hit this branch.
-      ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+      return false;
     }
+
+    const auto& faceVboMap =
+      faceIndices.transparent ? *chunk.transparentFaces : *chunk.opaqueFaces;
+    if (!faceVboMap.at(faceIndices.material)
+           ->elementsWithKeyEqual(
+             it->second,
+             indices + faceIndices.offset,
+             faceIndices.count,
+             brushVerticesStartIndex))
+    {
+      return false;
+    }
+    ++it;
   }
 
-  // insert face indices
+  if (
+    opaqueIt != info.opaqueFaceIndicesKeys.end()
+    || transparentIt != info.transparentFaceIndicesKeys.end())
+  {
+    return false;
+  }
 
-  auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
-  const auto facesSortedByMaterialCount = facesSortedByMaterial.size();
+  // the hidden flags are kept up to date by updateBrushSelection
+  auto* dest =
+    chunk.vertexArray->getPointerToReplaceVerticesWithKey(info.vertexHolderKey);
+  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+  chunk.bounds = vm::merge(chunk.bounds, brushNode.physicalBounds());
 
-  size_t nextI;
-  for (size_t i = 0; i < facesSortedByMaterialCount; i = nextI)
+  return true;
+}
+
+void BrushRenderer::compactChunks()
+{
+  auto chunksWithFragmentedVertices = std::vector<ChunkKey>{};
+  for (const auto& [key, chunk] : m_chunks)
   {
-    const auto* material = facesSortedByMaterial[i].material;
+    if (chunk.vertexArray->fragmented())
+    {
+      chunksWithFragmentedVertices.push_back(key);
+    }
+  }
 
-    size_t opaqueIndexCount = 0;
-    size_t transparentIndexCount = 0;
+  if (!chunksWithFragmentedVertices.empty())
+  {
+    // compacting the vertices of a chunk moves them, so the indices that refer to them
+    // must be rebased
+    auto oldBaseIndices = std::vector<std::tuple<const BrushInfo*, GLuint>>{};
+    for (const auto& [brushNode, info] : m_brushInfo)
+    {
+      if (std::ranges::binary_search(chunksWithFragmentedVertices, info.chunkKey))
+      {
+        oldBaseIndices.emplace_back(
+          &info, static_cast<GLuint>(info.vertexHolderKey->pos));
+      }
+    }
 
-    // find the i value for the next material
-    for (nextI = i + 1; nextI < facesSortedByMaterialCount
-                        && facesSortedByMaterial[nextI].material == material;
-         ++nextI)
+    for (const auto& key : chunksWithFragmentedVertices)
     {
+      m_chunks.at(key).vertexArray->compact();
     }
 
-    // process all faces with this material (they'll be consecutive)
-    for (size_t j = i; j < nextI; ++j)
+    for (const auto& [info, oldBaseIndex] : oldBaseIndices)
     {
-      const auto& cache = facesSortedByMaterial[j];
-      if (cache.face->isMarked())
+      const auto newBaseIndex = static_cast<GLuint>(info->vertexHolderKey->pos);
+      if (newBaseIndex != oldBaseIndex)
       {
-        assert(cache.material == material);
-        if (shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+        auto& chunk = m_chunks.at(info->chunkKey);
+        if (info->edgeIndicesKey)
+        {
+          chunk.edgeIndices->rebaseElementsWithKey(
+            info->edgeIndicesKey, oldBaseIndex, newBaseIndex);
+        }
+        for (const auto& [material, key] : info->opaqueFaceIndicesKeys)
         {
-          transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+          chunk.opaqueFaces->at(material)->rebaseElementsWithKey(
+            key, oldBaseIndex, newBaseIndex);
         }
-        else
+        for (const auto& [material, key] : info->transparentFaceIndicesKeys)
         {
-          opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+          chunk.transparentFaces->at(material)->rebaseElementsWithKey(
+            key, oldBaseIndex, newBaseIndex);
         }
       }
     }
+  }
 
-    if (transparentIndexCount > 0)
+  // the index arrays can be compacted independently of the vertices
+  for (auto& [key, chunk] : m_chunks)
+  {
+    if (chunk.edgeIndices->fragmented())
     {
-      auto& faceVboMap = *m_transparentFaces;
-      auto& holderPtr = faceVboMap[material];
-      if (holderPtr == nullptr)
-      {
-        // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
-      }
-
-      auto [key, insertDest] =
-        holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-      info.transparentFaceIndicesKeys.emplace_back(material, key);
-
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
-      for (size_t j = i; j < nextI; ++j)
+      chunk.edgeIndices->compact();
+    }
+    for (auto* faces : {chunk.opaqueFaces.get(), chunk.transparentFaces.get()})
+    {
+      for (auto& [material, indices] : *faces)
       {
-        const auto& cache = facesSortedByMaterial[j];
-        if (
-          cache.face->isMarked()
-          && shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+        if (indices->fragmented())
         {
-          addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
-            cache.vertexCount);
-
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
+          indices->compact();
         }
       }
-      assert(currentDest == (insertDest + transparentIndexCount));
     }
+  }
+}
+
+void BrushRenderer::addToMemoryReport(MemoryReport& report) const
+{
+  auto vertexArrayCount = size_t(0);
+  auto vertexBytes = size_t(0);
+  auto unusedVertexBytes = size_t(0);
+  auto indexArrayCount = size_t(0);
+  auto indexBytes = size_t(0);
+  auto unusedIndexBytes = size_t(0);
+
+  const auto addIndexArray = [&](const BrushIndexArray& indices) {
+    ++indexArrayCount;
+    indexBytes += indices.capacityInBytes();
+    unusedIndexBytes += indices.capacityInBytes() - indices.allocatedSizeInBytes();
+  };
+
+  for (const auto& [key, chunk] : m_chunks)
+  {
+    ++vertexArrayCount;
+    vertexBytes += chunk.vertexArray->capacityInBytes();
+    unusedVertexBytes +=
+      chunk.vertexArray->capacityInBytes() - chunk.vertexArray->allocatedSizeInBytes();
 
-    if (opaqueIndexCount > 0)
+    addIndexArray(*chunk.edgeIndices);
+    for (const auto* faces : {chunk.opaqueFaces.get(), chunk.transparentFaces.get()})
     {
-      auto& faceVboMap = *m_opaqueFaces;
-      auto& holderPtr = faceVboMap[material];
-      if (holderPtr == nullptr)
+      for (const auto& [material, indices] : *faces)
       {
-        // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
+        addIndexArray(*indices);
       }
+    }
+  }
 
-      auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-      info.opaqueFaceIndicesKeys.emplace_back(material, key);
+  report.add("Brush vertex arrays", vertexBytes, vertexArrayCount);
+  report.add("Brush vertex arrays (unused)", unusedVertexBytes, vertexArrayCount);
+  report.add("Brush index arrays", indexBytes, indexArrayCount);
+  report.add("Brush index arrays (unused)", unusedIndexBytes, indexArrayCount);
+}
 
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
-      for (size_t j = i; j < nextI; ++j)
-      {
-        const auto& cache = facesSortedByMaterial[j];
-        if (
-          cache.face->isMarked()
-          && !shouldDrawFaceInTransparentPass(brushNode, *cache.face))
-        {
-          addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
-            cache.vertexCount);
+BrushRenderer::ChunkKey BrushRenderer::chunkKey(const mdl::BrushNode& brushNode) const
+{
+  if (!m_chunkSize)
+  {
+    return {0, 0, 0};
+  }
 
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
-        }
-      }
-      assert(currentDest == (insertDest + opaqueIndexCount));
-    }
+  const auto cell = vm::floor(brushNode.physicalBounds().center() / *m_chunkSize);
+  return {int(cell.x()), int(cell.y()), int(cell.z())};
+}
+
+BrushRenderer::Chunk& BrushRenderer::findOrCreateChunk(const ChunkKey& key)
+{
+  auto [it, inserted] = m_chunks.try_emplace(key);
+  auto& chunk = it->second;
+  if (inserted)
+  {
+    chunk.vertexArray = std::make_shared<BrushVertexArray>(m_hideSelectedBrushes);
+    chunk.edgeIndices = std::make_shared<BrushIndexArray>();
+    chunk.transparentFaces = std::make_shared<MaterialToBrushIndicesMap>();
+    chunk.opaqueFaces = std::make_shared<MaterialToBrushIndicesMap>();
   }
+  return chunk;
 }
 
 void BrushRenderer::addBrush(const mdl::BrushNode* brushNode)
@@ -687,14 +1201,9 @@ void BrushRenderer::removeBrush(const mdl::BrushNode* brushNode)
 {
   // update m_brushValid
   m_allBrushes.erase(brushNode);
+  m_invalidBrushes.erase(brushNode);
 
-  if (m_invalidBrushes.erase(brushNode) > 0u)
-  {
-    // invalid brushes are not in the VBO, so we can return  now.
-    assert(m_brushInfo.find(brushNode) == std::end(m_brushInfo));
-    return;
-  }
-
+  // invalid brushes may still be in the VBO
   removeBrushFromVbo(*brushNode);
 }
 
@@ -704,46 +1213,56 @@ void BrushRenderer::removeBrushFromVbo(const mdl::BrushNode& brushNode)
 
   if (it == std::end(m_brushInfo))
   {
-    // This means BrushRenderer::validateBrush skipped rendering the brush, so it was
+    // This means BrushRenderer::validate skipped rendering the brush, so it was
     // never uploaded to the VBO's
     return;
   }
 
   const auto& info = it->second;
+  const auto chunkIt = m_chunks.find(info.chunkKey);
+  assert(chunkIt != m_chunks.end());
+  auto& chunk = chunkIt->second;
 
   // update Vbo's
-  m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+  chunk.vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
   if (info.edgeIndicesKey != nullptr)
   {
-    m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+    chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
   }
 
   for (const auto& [material, opaqueKey] : info.opaqueFaceIndicesKeys)
   {
-    auto faceIndexHolder = m_opaqueFaces->at(material);
+    auto faceIndexHolder = chunk.opaqueFaces->at(material);
     faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
     if (!faceIndexHolder->hasValidIndices())
     {
       // There are no indices left to render for this material, so delete the <Material,
       // BrushIndexArray> entry from the map
-      m_opaqueFaces->erase(material);
+      chunk.opaqueFaces->erase(material);
     }
   }
   for (const auto& [material, transparentKey] : info.transparentFaceIndicesKeys)
   {
-    auto faceIndexHolder = m_transparentFaces->at(material);
+    auto faceIndexHolder = chunk.transparentFaces->at(material);
     faceIndexHolder->zeroElementsWithKey(transparentKey);
 
     if (!faceIndexHolder->hasValidIndices())
     {
       // There are no indices left to render for this material, so delete the <Material,
       // BrushIndexArray> entry from the map
-      m_transparentFaces->erase(material);
+      chunk.transparentFaces->erase(material);
     }
   }
 
+  if (--chunk.brushCount == 0)
+  {
+    // the chunk's buffers are released with it
+    m_chunks.erase(chunkIt);
+  }
+
   m_brushInfo.erase(it);
+  m_visibleIndexRangesValid = false;
 }
 
 } // namespace tb::render
@@ -22,16 +22,33 @@
 #include "Color.h"
 #include "Macros.h"
 #include "mdl/BrushGeometry.h"
+#include "mdl/NodeSlotMap.h"
 #include "render/AllocationTracker.h"
 #include "render/EdgeRenderer.h"
 #include "render/FaceRenderer.h"
 
+#include "vm/bbox.h"
+#include "vm/plane.h"
+
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <tuple>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb
+{
+class MemoryReport;
+}
+
 namespace tb::mdl
 {
 class BrushNode;
@@ -41,6 +58,7 @@ class EditorContext;
 
 namespace tb::render
 {
+struct BrushIndexRange;
 
 class BrushRenderer
 {
@@ -119,8 +137,45 @@ public:
 private:
   std::unique_ptr<Filter> m_filter;
 
+  using MaterialToBrushIndicesMap =
+    std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
+  using MaterialToBrushIndexRangesMap =
+    std::unordered_map<const mdl::Material*, std::vector<BrushIndexRange>>;
+
+  /**
+   * A group of brushes that share a vertex array and index arrays. Without chunking, all
+   * brushes are stored in a single chunk. Otherwise, brushes are bucketed into chunks by
+   * the position of their center, so that whole chunks can be culled, and changing a
+   * brush only affects the buffers of its own chunk.
+   */
+  struct Chunk
+  {
+    std::shared_ptr<BrushVertexArray> vertexArray;
+    std::shared_ptr<BrushIndexArray> edgeIndices;
+    std::shared_ptr<MaterialToBrushIndicesMap> transparentFaces;
+    std::shared_ptr<MaterialToBrushIndicesMap> opaqueFaces;
+
+    std::shared_ptr<MaterialToBrushIndexRangesMap> visibleOpaqueFaceRanges;
+    std::shared_ptr<MaterialToBrushIndexRangesMap> visibleTransparentFaceRanges;
+    std::shared_ptr<std::vector<BrushIndexRange>> visibleEdgeRanges;
+
+    FaceRenderer opaqueFaceRenderer;
+    FaceRenderer transparentFaceRenderer;
+    IndexedEdgeRenderer edgeRenderer;
+
+    /**
+     * The union of the bounds of all brushes that were added to this chunk. Since the
+     * bounds are not shrunk when brushes are removed, they may be larger than necessary.
+     */
+    vm::bbox3d bounds;
+    size_t brushCount = 0;
+  };
+
+  using ChunkKey = std::tuple<int, int, int>;
+
   struct BrushInfo
   {
+    ChunkKey chunkKey;
     AllocationTracker::Block* vertexHolderKey;
     AllocationTracker::Block* edgeIndicesKey;
     std::vector<std::pair<const mdl::Material*, AllocationTracker::Block*>>
@@ -132,28 +187,59 @@ private:
    * Tracks all brushes that are stored in the VBO, with the information necessary to
    * remove them from the VBO later.
    */
-  std::unordered_map<const mdl::BrushNode*, BrushInfo> m_brushInfo;
+  mdl::NodeSlotMap<const mdl::BrushNode, BrushInfo> m_brushInfo;
 
   /**
-   * If a brush is in the VBO, it's always valid.
+   * If a brush is invalid, it might still be in the VBO until it is validated, so that
+   * its vertices can be replaced in place if its indices didn't change.
    * If a brush is valid, it might not be in the VBO if it was hidden by the Filter.
    *
    * Do not attempt to use vector_set here, it turns out to be slower.
    */
-  std::unordered_set<const mdl::BrushNode*> m_allBrushes;
-  std::unordered_set<const mdl::BrushNode*> m_invalidBrushes;
+  mdl::NodeSlotSet<const mdl::BrushNode> m_allBrushes;
+  mdl::NodeSlotSet<const mdl::BrushNode> m_invalidBrushes;
 
-  std::shared_ptr<BrushVertexArray> m_vertexArray;
-  std::shared_ptr<BrushIndexArray> m_edgeIndices;
+  /**
+   * Chunks are removed as soon as they contain no brushes.
+   */
+  std::map<ChunkKey, Chunk> m_chunks;
 
-  using MaterialToBrushIndicesMap =
-    std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
-  std::shared_ptr<MaterialToBrushIndicesMap> m_transparentFaces;
-  std::shared_ptr<MaterialToBrushIndicesMap> m_opaqueFaces;
+  /**
+   * The edge length of the cubic cells that brushes are bucketed into. If unset, all
+   * brushes are stored in a single chunk.
+   */
+  std::optional<double> m_chunkSize;
+
+  /**
+   * If set, the vertices and indices of invalid brushes are built in parallel.
+   */
+  kdl::task_manager* m_taskManager = nullptr;
+
+  /**
+   * If set, validate() stops validating brushes once this much time has passed. The
+   * remaining brushes are validated the next time the renderer is rendered, and until
+   * then, those of them that are still in the VBO are rendered as before.
+   */
+  std::optional<std::chrono::steady_clock::duration> m_validationTimeBudget;
+
+  /**
+   * If set, only these brushes are rendered, e.g. because all other brushes are outside
+   * of the view frustum.
+   */
+  std::shared_ptr<const std::vector<const mdl::BrushNode*>> m_visibleBrushes;
+  bool m_visibleIndexRangesValid = false;
 
-  FaceRenderer m_opaqueFaceRenderer;
-  FaceRenderer m_transparentFaceRenderer;
-  IndexedEdgeRenderer m_edgeRenderer;
+  /**
+   * If set, chunks whose bounds are entirely outside of this convex volume are not
+   * rendered.
+   */
+  std::shared_ptr<const std::vector<vm::plane3d>> m_viewVolume;
+
+  /**
+   * If set, chunks whose size on the view plane of a 2D view is less than this are
+   * rendered as their bounds instead of their brushes.
+   */
+  std::optional<double> m_coarseChunkSize;
 
   Color m_faceColor;
   bool m_showEdges = false;
@@ -168,6 +254,12 @@ private:
 
   bool m_showHiddenBrushes = false;
 
+  /**
+   * If set, the vertices of selected brushes remain in the VBO, but they are hidden with
+   * a vertex flag, so that selecting and deselecting brushes only uploads the flags.
+   */
+  bool m_hideSelectedBrushes = false;
+
 public:
   template <typename FilterT>
   explicit BrushRenderer(FilterT filter)
@@ -193,13 +285,18 @@ public:
    * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the
    * Brush object for modification.
    *
-   * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces,
-   * and m_opaqueFaces maps will be empty, so the BrushRenderer will not have any
-   * lingering Material* pointers.
+   * Additionally, calling `invalidate()` guarantees the m_brushInfo and m_chunks maps will
+   * be empty, so the BrushRenderer will not have any lingering Material* pointers.
    */
   void invalidate();
   void invalidateMaterials(const std::vector<const mdl::Material*>& materials);
   void invalidateBrush(const mdl::BrushNode* brush);
+
+  /**
+   * Updates the hidden flags of the given brush after it was selected or deselected. If
+   * selected brushes are not hidden, the brush is invalidated instead.
+   */
+  void updateBrushSelection(const mdl::BrushNode* brush);
   void invalidateMaterial(const mdl::Material& material);
   bool valid() const;
 
@@ -270,15 +367,91 @@ public:
    */
   void setShowHiddenBrushes(bool showHiddenBrushes);
 
+  /**
+   * Sets whether selected brushes are hidden by a vertex flag instead of being removed
+   * from the VBO. The Filter must then include selected brushes as if they weren't
+   * selected.
+   *
+   * Changing this invalidates all brushes.
+   */
+  void setHideSelectedBrushes(bool hideSelectedBrushes);
+
+  /**
+   * Restricts rendering to the given brushes. Only the index ranges of these brushes are
+   * submitted, but the brushes remain in the VBO. If this is null, all brushes are
+   * rendered. The index ranges are only recomputed if the given brushes differ from the
+   * current ones.
+   */
+  void setVisibleBrushes(
+    std::shared_ptr<const std::vector<const mdl::BrushNode*>> visibleBrushes);
+
+  /**
+   * Restricts rendering to those of this renderer's brushes whose bounds intersect the
+   * given convex volume. The normals of the given planes must point out of the volume.
+   */
+  void cullBrushes(const std::vector<vm::plane3d>& viewVolume);
+
+  /**
+   * Restricts rendering to the chunks whose bounds intersect the given convex volume. The
+   * normals of the given planes must point out of the volume. If this is null, all chunks
+   * are rendered.
+   */
+  void setViewVolume(std::shared_ptr<const std::vector<vm::plane3d>> viewVolume);
+
+  /**
+   * In 2D views, chunks whose size on the view plane is less than the given size are
+   * rendered as the edges of their bounds instead of their brushes. If unset, or if
+   * brushes are not chunked, all chunks are rendered with their brushes.
+   */
+  void setCoarseChunkSize(std::optional<double> coarseChunkSize);
+
+  /**
+   * Sets the edge length of the cells that brushes are bucketed into. Each cell is stored
+   * in its own VBO and can be culled as a whole. If unset, all brushes are stored in a
+   * single VBO.
+   *
+   * Changing the chunk size invalidates all brushes.
+   */
+  void setChunkSize(std::optional<double> chunkSize);
+
+  /**
+   * Sets the task manager used to validate brushes in parallel. If null, brushes are
+   * validated on the calling thread.
+   */
+  void setTaskManager(kdl::task_manager* taskManager);
+
+  /**
+   * Limits the time that validating brushes may take per frame, so that a change to many
+   * brushes is spread over several frames instead of blocking the UI. If unset, all
+   * invalid brushes are validated at once.
+   */
+  void setValidationTimeBudget(
+    std::optional<std::chrono::steady_clock::duration> validationTimeBudget);
+
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
 private:
-  void renderOpaqueFaces(RenderBatch& renderBatch);
-  void renderTransparentFaces(RenderBatch& renderBatch);
-  void renderEdges(RenderBatch& renderBatch);
+  void renderOpaqueFaces(RenderContext& renderContext, RenderBatch& renderBatch);
+  void renderTransparentFaces(RenderContext& renderContext, RenderBatch& renderBatch);
+  void renderEdges(RenderContext& renderContext, RenderBatch& renderBatch);
+  void renderCoarseChunks(RenderContext& renderContext, RenderBatch& renderBatch);
+
+  void validateVisibleIndexRanges();
+
+  /**
+   * A chunk is not visible if its bounds are outside of the view volume, or, if brushes
+   * are chunked, if the occlusion culler of the given render context culls it.
+   */
+  bool isChunkVisible(
+    const RenderContext& renderContext, const ChunkKey& key, const Chunk& chunk) const;
+
+  /**
+   * A chunk is coarse if it is rendered as its bounds, see setCoarseChunkSize.
+   */
+  bool isChunkCoarse(const RenderContext& renderContext, const Chunk& chunk) const;
 
 public:
   /**
@@ -286,10 +459,37 @@ public:
    */
   void validate();
 
+  /**
+   * Adds the sizes of the vertex and index arrays of all chunks to the given report,
+   * including how much of them is reserved but not in use.
+   */
+  void addToMemoryReport(MemoryReport& report) const;
+
 private:
+  struct StagedBrush;
+
+  void validateBrushes(std::span<const mdl::BrushNode* const> brushNodes);
+
   bool shouldDrawFaceInTransparentPass(
     const mdl::BrushNode& brushNode, const mdl::BrushFace& face) const;
-  void validateBrush(const mdl::BrushNode& brushNode);
+  void stageBrush(StagedBrush& stagedBrush) const;
+  void commitBrush(const StagedBrush& stagedBrush);
+
+  /**
+   * If the given brush is still in the VBO with the same chunk, vertex count and indices,
+   * e.g. because only its UV coordinates or the positions of its vertices changed, its
+   * vertices are overwritten in place and true is returned. The index arrays are left
+   * untouched then.
+   */
+  bool replaceBrushVertices(BrushInfo& info, const StagedBrush& stagedBrush);
+
+  /**
+   * Compacts the vertex and index arrays of the chunks that have become fragmented, e.g.
+   * after many brushes were removed, to release the unused memory.
+   */
+  void compactChunks();
+  ChunkKey chunkKey(const mdl::BrushNode& brushNode) const;
+  Chunk& findOrCreateChunk(const ChunkKey& key);
 
 public:
   /**
@@ -19,6 +19,8 @@
 
 #include "render/BrushRendererArrays.h"
 
+#include "render/RenderProfiler.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -28,6 +30,53 @@
 
 namespace tb::render
 {
+namespace
+{
+
+/**
+ * Arrays are compacted once less than this fraction of their capacity is in use. Since
+ * arrays double their capacity when they run out of space, a compacted array is not
+ * compacted again right after it grows.
+ */
+constexpr auto MinUsedFraction = 0.25;
+
+/**
+ * Arrays with a smaller capacity are never compacted.
+ */
+constexpr auto MinCompactionCapacity = size_t(4096);
+
+bool isFragmented(const AllocationTracker& allocationTracker)
+{
+  const auto capacity = allocationTracker.capacity();
+  const auto allocatedSize = allocationTracker.allocatedSize();
+  return capacity >= MinCompactionCapacity && allocatedSize > 0
+         && double(allocatedSize) < double(capacity) * MinUsedFraction;
+}
+
+} // namespace
+
+// BrushIndexRange
+
+void mergeIndexRanges(std::vector<BrushIndexRange>& ranges)
+{
+  std::ranges::sort(ranges, {}, &BrushIndexRange::offset);
+
+  auto merged = std::vector<BrushIndexRange>{};
+  merged.reserve(ranges.size());
+  for (const auto& range : ranges)
+  {
+    if (!merged.empty() && merged.back().offset + merged.back().count == range.offset)
+    {
+      merged.back().count += range.count;
+    }
+    else
+    {
+      merged.push_back(range);
+    }
+  }
+
+  ranges = std::move(merged);
+}
 
 // DirtyRangeTracker
 
@@ -93,6 +142,25 @@ void IndexHolder::zeroRange(const size_t offsetWithinBlock, const size_t count)
   std::memset(dest, 0, count * sizeof(Index));
 }
 
+bool IndexHolder::rangeEquals(
+  const size_t offsetWithinBlock,
+  const Index* indices,
+  const size_t count,
+  const Index baseIndex) const
+{
+  assert(offsetWithinBlock + count <= m_snapshot.size());
+
+  const auto* src = m_snapshot.data() + offsetWithinBlock;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (src[i] != baseIndex + indices[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 void IndexHolder::render(const PrimType primType, const size_t offset, size_t count) const
 {
   const auto renderCount = static_cast<GLsizei>(count);
@@ -100,6 +168,7 @@ void IndexHolder::render(const PrimType primType, const size_t offset, size_t co
     reinterpret_cast<GLvoid*>(m_vbo->offset() + sizeof(Index) * offset);
 
   glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
+  ++currentStateChangeCounts().drawCalls;
 }
 
 std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index>& elements)
@@ -151,12 +220,63 @@ void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key)
   m_indexHolder.zeroRange(pos, size);
 }
 
+bool BrushIndexArray::elementsWithKeyEqual(
+  const AllocationTracker::Block* key,
+  const GLuint* indices,
+  const size_t count,
+  const GLuint baseIndex) const
+{
+  return key->size == count
+         && m_indexHolder.rangeEquals(key->pos, indices, count, baseIndex);
+}
+
+void BrushIndexArray::rebaseElementsWithKey(
+  AllocationTracker::Block* key, const GLuint oldBaseIndex, const GLuint newBaseIndex)
+{
+  auto* dest = m_indexHolder.getPointerToWriteElementsTo(key->pos, key->size);
+  for (size_t i = 0; i < key->size; ++i)
+  {
+    dest[i] = dest[i] - oldBaseIndex + newBaseIndex;
+  }
+}
+
+bool BrushIndexArray::fragmented() const
+{
+  return isFragmented(m_allocationTracker);
+}
+
+size_t BrushIndexArray::capacityInBytes() const
+{
+  return m_allocationTracker.capacity() * sizeof(IndexHolder::Index);
+}
+
+size_t BrushIndexArray::allocatedSizeInBytes() const
+{
+  return m_allocationTracker.allocatedSize() * sizeof(IndexHolder::Index);
+}
+
+void BrushIndexArray::compact()
+{
+  const auto newSize = m_allocationTracker.allocatedSize();
+  m_indexHolder.compact(m_allocationTracker.compact(newSize), newSize);
+}
+
 void BrushIndexArray::render(const PrimType primType) const
 {
   assert(m_indexHolder.prepared());
   m_indexHolder.render(primType, 0, m_indexHolder.size());
 }
 
+void BrushIndexArray::render(
+  const PrimType primType, const std::vector<BrushIndexRange>& ranges) const
+{
+  assert(m_indexHolder.prepared());
+  for (const auto& range : ranges)
+  {
+    m_indexHolder.render(primType, range.offset, range.count);
+  }
+}
+
 bool BrushIndexArray::prepared() const
 {
   return m_indexHolder.prepared();
@@ -182,25 +302,35 @@ void BrushIndexArray::cleanupIndices()
 
 BrushVertexArray::BrushVertexArray() = default;
 
+BrushVertexArray::BrushVertexArray(const bool hiddenFlags)
+  : m_hiddenFlagHolder{
+      hiddenFlags ? std::make_unique<VertexHolder<HiddenFlag>>() : nullptr}
+{
+}
+
 std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::
   getPointerToInsertVerticesAt(const size_t vertexCount)
 {
   auto block = m_allocationTracker.allocate(vertexCount);
-  if (block != nullptr)
+  if (block == nullptr)
   {
-    auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-    return {block, dest};
+    // retry
+    const auto newSize = std::max(
+      2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
+    m_allocationTracker.expand(newSize);
+    m_vertexHolder.resize(newSize);
+    if (m_hiddenFlagHolder)
+    {
+      m_hiddenFlagHolder->resize(newSize);
+    }
+
+    // insert again
+    block = m_allocationTracker.allocate(vertexCount);
+    assert(block != nullptr);
   }
 
-  // retry
-  const auto newSize = std::max(
-    2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
-  m_allocationTracker.expand(newSize);
-  m_vertexHolder.resize(newSize);
-
-  // insert again
-  block = m_allocationTracker.allocate(vertexCount);
-  assert(block != nullptr);
+  // the block may have been used by hidden vertices before
+  setHidden(block, false);
 
   auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
   return {block, dest};
@@ -216,25 +346,89 @@ void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key)
   // us to re-use the space later
 }
 
+BrushVertexArray::Vertex* BrushVertexArray::getPointerToReplaceVerticesWithKey(
+  AllocationTracker::Block* key)
+{
+  return m_vertexHolder.getPointerToWriteElementsTo(key->pos, key->size);
+}
+
+void BrushVertexArray::setHidden(AllocationTracker::Block* key, const bool hidden)
+{
+  if (m_hiddenFlagHolder)
+  {
+    auto* dest = m_hiddenFlagHolder->getPointerToWriteElementsTo(key->pos, key->size);
+    std::fill_n(dest, key->size, HiddenFlag{vm::vec1f{hidden ? 1.0f : 0.0f}});
+  }
+}
+
+bool BrushVertexArray::fragmented() const
+{
+  return isFragmented(m_allocationTracker);
+}
+
+size_t BrushVertexArray::capacityInBytes() const
+{
+  return m_allocationTracker.capacity() * vertexSizeInBytes();
+}
+
+size_t BrushVertexArray::allocatedSizeInBytes() const
+{
+  return m_allocationTracker.allocatedSize() * vertexSizeInBytes();
+}
+
+size_t BrushVertexArray::vertexSizeInBytes() const
+{
+  return sizeof(Vertex) + (m_hiddenFlagHolder ? sizeof(HiddenFlag) : 0);
+}
+
+void BrushVertexArray::compact()
+{
+  const auto newSize = m_allocationTracker.allocatedSize();
+  const auto moves = m_allocationTracker.compact(newSize);
+  m_vertexHolder.compact(moves, newSize);
+  if (m_hiddenFlagHolder)
+  {
+    m_hiddenFlagHolder->compact(moves, newSize);
+  }
+}
+
 bool BrushVertexArray::setupVertices()
 {
-  return m_vertexHolder.setupVertices();
+  if (!m_vertexHolder.setupVertices())
+  {
+    return false;
+  }
+  if (m_hiddenFlagHolder)
+  {
+    m_hiddenFlagHolder->setupVertices();
+  }
+  return true;
 }
 
 void BrushVertexArray::cleanupVertices()
 {
+  if (m_hiddenFlagHolder)
+  {
+    m_hiddenFlagHolder->cleanupVertices();
+  }
   m_vertexHolder.cleanupVertices();
 }
 
 bool BrushVertexArray::prepared() const
 {
-  return m_vertexHolder.prepared();
+  return m_vertexHolder.prepared()
+         && (!m_hiddenFlagHolder || m_hiddenFlagHolder->prepared());
 }
 
 void BrushVertexArray::prepare(VboManager& vboManager)
 {
   m_vertexHolder.prepare(vboManager);
   assert(m_vertexHolder.prepared());
+
+  if (m_hiddenFlagHolder)
+  {
+    m_hiddenFlagHolder->prepare(vboManager);
+  }
 }
 
 } // namespace tb::render
@@ -28,8 +28,11 @@
 #include "render/Vbo.h"
 #include "render/VboManager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace tb::render
@@ -155,6 +158,31 @@ public:
     m_dirtyRange.expand(newSize);
   }
 
+  /**
+   * Applies the given moves returned by AllocationTracker::compact and shrinks this
+   * holder to the given size. The entire buffer is uploaded again when it is prepared.
+   */
+  void compact(const std::vector<AllocationTracker::Move>& moves, const size_t newSize)
+  {
+    assert(newSize > 0);
+
+    for (const auto& move : moves)
+    {
+      // every move goes to a lower position, so this never overwrites elements that
+      // still have to be moved
+      std::copy_n(
+        m_snapshot.begin() + static_cast<std::ptrdiff_t>(move.oldPos),
+        move.size,
+        m_snapshot.begin() + static_cast<std::ptrdiff_t>(move.newPos));
+    }
+
+    m_snapshot.resize(newSize);
+    m_snapshot.shrink_to_fit();
+
+    m_dirtyRange = DirtyRangeTracker{newSize};
+    m_dirtyRange.markDirty(0, newSize);
+  }
+
   T* getPointerToWriteElementsTo(
     const size_t offsetWithinBlock, const size_t elementCount)
   {
@@ -208,6 +236,13 @@ public:
       const size_t pos = m_dirtyRange.m_dirtyPos;
       const size_t size = m_dirtyRange.m_dirtySize;
 
+      if (pos == 0 && size == m_snapshot.size())
+      {
+        // the entire buffer is replaced, e.g. when dragging a large selection, so we
+        // orphan it to avoid waiting for draw calls that still use the old contents
+        m_vbo->orphan();
+      }
+
       const size_t bytesFromStart = pos * sizeof(T);
       m_vbo->writeArray(bytesFromStart, m_snapshot.data() + pos, size);
     }
@@ -236,11 +271,33 @@ public:
    */
   explicit IndexHolder(std::vector<Index>& elements);
   void zeroRange(size_t offsetWithinBlock, size_t count);
+
+  /**
+   * Returns true if the given range contains the given indices offset by the given base
+   * index.
+   */
+  bool rangeEquals(
+    size_t offsetWithinBlock, const Index* indices, size_t count, Index baseIndex) const;
+
   void render(PrimType primType, size_t offset, size_t count) const;
 
   static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
 };
 
+/**
+ * A range of indices in a BrushIndexArray.
+ */
+struct BrushIndexRange
+{
+  size_t offset;
+  size_t count;
+};
+
+/**
+ * Sorts the given ranges and merges adjacent ones to reduce the number of draw calls.
+ */
+void mergeIndexRanges(std::vector<BrushIndexRange>& ranges);
+
 /**
  * VboBlock handle that supports dynamically allocating ranges of indices, grows as
  * needed, and also supports freeing allocations and zeroing the corresponding indicies so
@@ -278,7 +335,48 @@ public:
    */
   void zeroElementsWithKey(AllocationTracker::Block* key);
 
+  /**
+   * Returns true if the indices with the given key are the given indices offset by the
+   * given base index.
+   */
+  bool elementsWithKeyEqual(
+    const AllocationTracker::Block* key,
+    const GLuint* indices,
+    size_t count,
+    GLuint baseIndex) const;
+
+  /**
+   * Replaces the base index of the indices with the given key, e.g. after the vertices
+   * they refer to have been moved by BrushVertexArray::compact().
+   */
+  void rebaseElementsWithKey(
+    AllocationTracker::Block* key, GLuint oldBaseIndex, GLuint newBaseIndex);
+
+  /**
+   * Returns true if only a small part of this array is in use, e.g. because many brushes
+   * were removed from it.
+   */
+  bool fragmented() const;
+
+  /**
+   * Returns the number of bytes reserved by this array and the number of bytes in use.
+   */
+  size_t capacityInBytes() const;
+  size_t allocatedSizeInBytes() const;
+
+  /**
+   * Moves all indices to the beginning of this array and shrinks it to fit. The keys
+   * remain valid, but their positions change.
+   */
+  void compact();
+
   void render(PrimType primType) const;
+
+  /**
+   * Renders only the given ranges of this array.
+   */
+  void render(PrimType primType, const std::vector<BrushIndexRange>& ranges) const;
+
   bool prepared() const;
   void prepare(VboManager& vboManager);
 
@@ -347,14 +445,33 @@ public:
 class BrushVertexArray
 {
 private:
-  using Vertex = render::GLVertexTypes::P3NT2::Vertex;
+  // brush vertices make up most of the VRAM used by a map, so the normals are packed
+  using Vertex = render::GLVertexTypes::P3NBT2::Vertex;
+
+  struct HiddenName
+  {
+    static inline const auto name = std::string{"hidden"};
+  };
+
+  // the face and edge shaders don't render vertices whose hidden flag is set
+  using HiddenFlag =
+    GLVertexType<GLVertexAttributeUser<HiddenName, GL_FLOAT, 1, false>>::Vertex;
 
   VertexHolder<Vertex> m_vertexHolder;
   AllocationTracker m_allocationTracker;
 
+  // parallel to m_vertexHolder, only present if hidden flags are enabled
+  std::unique_ptr<VertexHolder<HiddenFlag>> m_hiddenFlagHolder;
+
 public:
   BrushVertexArray();
 
+  /**
+   * If hidden flags are enabled, the vertices of a brush can be hidden and shown again
+   * with setHidden(), which only uploads one flag per vertex instead of the vertices.
+   */
+  explicit BrushVertexArray(bool hiddenFlags);
+
   /**
    * Call this to request writing the given number of vertices.
    *
@@ -369,6 +486,37 @@ public:
 
   void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+  /**
+   * Returns a pointer where the caller should write `key->size` Vertex objects to replace
+   * the vertices with the given key in place.
+   */
+  Vertex* getPointerToReplaceVerticesWithKey(AllocationTracker::Block* key);
+
+  /**
+   * Sets the hidden flag of the vertices with the given key. Newly inserted vertices are
+   * not hidden. Does nothing unless hidden flags are enabled.
+   */
+  void setHidden(AllocationTracker::Block* key, bool hidden);
+
+  /**
+   * Returns true if only a small part of this array is in use, e.g. because many brushes
+   * were removed from it.
+   */
+  bool fragmented() const;
+
+  /**
+   * Returns the number of bytes reserved by this array and the number of bytes in use.
+   */
+  size_t capacityInBytes() const;
+  size_t allocatedSizeInBytes() const;
+
+  /**
+   * Moves all vertices to the beginning of this array and shrinks it to fit. The keys
+   * remain valid, but their positions change, so the caller must rebase the indices that
+   * refer to the moved vertices.
+   */
+  void compact();
+
   // setting up GL attributes
   bool setupVertices();
   void cleanupVertices();
@@ -376,5 +524,8 @@ public:
   // uploading the VBO
   bool prepared() const;
   void prepare(VboManager& vboManager);
+
+private:
+  size_t vertexSizeInBytes() const;
 };
 } // namespace tb::render
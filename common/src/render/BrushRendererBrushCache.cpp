@@ -19,12 +19,13 @@
 
 #include "BrushRendererBrushCache.h"
 
+#include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
-#include "mdl/BrushGeometry.h"
 #include "mdl/BrushNode.h"
-#include "mdl/Polyhedron.h"
+#include "mdl/CompactBrushGeometry.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace tb::render
 {
@@ -51,6 +52,14 @@ void BrushRendererBrushCache::invalidateVertexCache()
   m_cachedFacesSortedByMaterial.clear();
 }
 
+void BrushRendererBrushCache::releaseVertexCache()
+{
+  m_rendererCacheValid = false;
+  m_cachedVertices = {};
+  m_cachedEdges = {};
+  m_cachedFacesSortedByMaterial = {};
+}
+
 void BrushRendererBrushCache::validateVertexCache(const mdl::BrushNode& brushNode)
 {
   if (m_rendererCacheValid)
@@ -60,6 +69,7 @@ void BrushRendererBrushCache::validateVertexCache(const mdl::BrushNode& brushNod
 
   // build vertex cache and face cache
   const auto& brush = brushNode.brush();
+  const auto& geometry = brush.compactGeometry();
 
   m_cachedVertices.clear();
   m_cachedVertices.reserve(brush.vertexCount());
@@ -67,29 +77,26 @@ void BrushRendererBrushCache::validateVertexCache(const mdl::BrushNode& brushNod
   m_cachedFacesSortedByMaterial.clear();
   m_cachedFacesSortedByMaterial.reserve(brush.faceCount());
 
-  for (const auto& face : brush.faces())
+  // Maps each brush vertex to one of its copies in m_cachedVertices. This is used below
+  // when building the edge cache. NOTE: we'll overwrite the index as we visit the same
+  // vertex several times while visiting different faces, this is fine.
+  auto cachedVertexIndices = std::vector<GLuint>(geometry.vertexCount());
+
+  for (size_t faceIndex = 0; faceIndex < brush.faceCount(); ++faceIndex)
   {
+    const auto& face = brush.face(faceIndex);
     const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
+    const auto normal =
+      GLVertexAttributeTypes::NB::pack(vm::vec3f{face.boundary().normal});
 
     // The boundary is in CCW order, but the renderer expects CW order:
-    auto& boundary = face.geometry()->boundary();
-    for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it)
+    const auto vertexIndices = geometry.faceVertexIndices(faceIndex);
+    for (auto it = vertexIndices.rbegin(), end = vertexIndices.rend(); it != end; ++it)
     {
-      auto* currentHalfEdge = *it;
-      auto* vertex = currentHalfEdge->origin();
-
-      // Set the vertex payload to the index, relative to the brush's first vertex being
-      // 0. This is used below when building the edge cache. NOTE: we'll overwrite the
-      // payload as we visit the same vertex several times while visiting different faces,
-      // this is fine.
-      const auto currentIndex = m_cachedVertices.size();
-      vertex->setPayload(static_cast<GLuint>(currentIndex));
+      cachedVertexIndices[*it] = static_cast<GLuint>(m_cachedVertices.size());
 
-      const auto& position = vertex->position();
-      m_cachedVertices.emplace_back(
-        vm::vec3f{position}, vm::vec3f{face.boundary().normal}, face.uvCoords(position));
-
-      currentHalfEdge = currentHalfEdge->previous();
+      const auto position = geometry.position(*it);
+      m_cachedVertices.emplace_back(vm::vec3f{position}, normal, face.uvCoords(position));
     }
 
     // face cache
@@ -107,23 +114,18 @@ void BrushRendererBrushCache::validateVertexCache(const mdl::BrushNode& brushNod
 
   // Build edge index cache
 
+  const auto edges = geometry.edges();
+
   m_cachedEdges.clear();
-  m_cachedEdges.reserve(brush.edgeCount());
+  m_cachedEdges.reserve(edges.size());
 
-  for (const auto* currentEdge : brush.edges())
+  for (const auto& edge : edges)
   {
-    const auto faceIndex1 = currentEdge->firstFace()->payload();
-    const auto faceIndex2 = currentEdge->secondFace()->payload();
-    assert(faceIndex1 && faceIndex2);
-
-    const auto& face1 = brush.face(*faceIndex1);
-    const auto& face2 = brush.face(*faceIndex2);
-
-    const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-    const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
-
     m_cachedEdges.push_back(CachedEdge{
-      &face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush});
+      &brush.face(edge.faceIndex1),
+      &brush.face(edge.faceIndex2),
+      cachedVertexIndices[edge.vertexIndex1],
+      cachedVertexIndices[edge.vertexIndex2]});
   }
 
   m_rendererCacheValid = true;
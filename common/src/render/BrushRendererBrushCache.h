@@ -36,7 +36,7 @@ namespace tb::render
 class BrushRendererBrushCache
 {
 public:
-  using VertexSpec = render::GLVertexTypes::P3NT2;
+  using VertexSpec = render::GLVertexTypes::P3NBT2;
   using Vertex = VertexSpec::Vertex;
 
   struct CachedFace
@@ -70,6 +70,11 @@ public:
    * Only exposed to be called by BrushFace
    */
   void invalidateVertexCache();
+
+  /**
+   * Invalidates the cache and releases its memory, e.g. because the brush is hidden.
+   */
+  void releaseVertexCache();
   /**
    * Call this before cachedVertices()/cachedFacesSortedByMaterial()/cachedEdges()
    *
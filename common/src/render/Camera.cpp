@@ -187,6 +187,20 @@ void Camera::frustumPlanes(
   doComputeFrustumPlanes(top, right, bottom, left);
 }
 
+std::vector<vm::plane3f> Camera::viewVolumePlanes() const
+{
+  auto planes = std::vector<vm::plane3f>(4);
+  frustumPlanes(planes[0], planes[1], planes[2], planes[3]);
+
+  if (perspectiveProjection())
+  {
+    planes.emplace_back(m_position + m_direction * nearPlane(), -m_direction);
+    planes.emplace_back(m_position + m_direction * farPlane(), m_direction);
+  }
+
+  return planes;
+}
+
 vm::ray3f Camera::viewRay() const
 {
   return {m_position, m_direction};
@@ -30,6 +30,7 @@
 #include "vm/vec.h"
 
 #include <optional>
+#include <vector>
 
 namespace tb
 {
@@ -127,6 +128,14 @@ public:
     vm::plane3f& bottomPlane,
     vm::plane3f& leftPlane) const;
 
+  /**
+   * Returns the planes that bound the volume that is visible through this camera. The
+   * plane normals point out of the volume.
+   *
+   * For a perspective camera, the volume is also bounded by the near and far planes.
+   */
+  std::vector<vm::plane3f> viewVolumePlanes() const;
+
   vm::ray3f viewRay() const;
   vm::ray3f pickRay(float x, float y) const;
   vm::ray3f pickRay(const vm::vec3f& point) const;
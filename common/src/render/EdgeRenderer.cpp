@@ -31,6 +31,13 @@
 
 namespace tb::render
 {
+namespace
+{
+
+// the offset of the occluded edges, see EdgeRenderer::renderOnTop
+constexpr auto OccludedEdgeOffset = 0.2;
+
+} // namespace
 
 EdgeRenderer::Params::Params(
   const float i_width, const double i_offset, const bool i_onTop)
@@ -74,18 +81,8 @@ EdgeRenderer::RenderBase::~RenderBase() = default;
 
 void EdgeRenderer::RenderBase::renderEdges(RenderContext& renderContext)
 {
-  if (m_params.offset != 0.0)
-  {
-    glSetEdgeOffset(m_params.offset);
-  }
-
   glAssert(glLineWidth(m_params.width * renderContext.dpiScale()));
 
-  if (m_params.onTop)
-  {
-    glAssert(glDisable(GL_DEPTH_TEST));
-  }
-
   {
     auto shader = ActiveShader{renderContext.shaderManager(), Shaders::EdgeShader};
     shader.set("ShowSoftMapBounds", !renderContext.softMapBounds().is_empty());
@@ -99,21 +96,55 @@ void EdgeRenderer::RenderBase::renderEdges(RenderContext& renderContext)
         pref(Preferences::SoftMapBoundsColor).b(),
         0.33f}); // NOTE: heavier tint than FaceRenderer, since these are lines
     shader.set("UseUniformColor", m_params.useColor);
+
+    doSetupVertices();
+
+    if (m_params.occludedColor)
+    {
+      renderOccludedEdges(shader);
+    }
+
+    if (m_params.offset != 0.0)
+    {
+      glSetEdgeOffset(m_params.offset);
+    }
+
+    if (m_params.onTop)
+    {
+      glAssert(glDisable(GL_DEPTH_TEST));
+    }
+
     shader.set("Color", m_params.color);
-    doRenderVertices(renderContext);
-  }
+    doRenderVertices();
 
-  if (m_params.onTop)
-  {
-    glAssert(glEnable(GL_DEPTH_TEST));
+    if (m_params.onTop)
+    {
+      glAssert(glEnable(GL_DEPTH_TEST));
+    }
+
+    if (m_params.offset != 0.0)
+    {
+      glResetEdgeOffset();
+    }
+
+    doCleanupVertices();
   }
 
   glAssert(glLineWidth(renderContext.dpiScale()));
+}
 
-  if (m_params.offset != 0.0)
-  {
-    glResetEdgeOffset();
-  }
+void EdgeRenderer::RenderBase::renderOccludedEdges(ActiveShader& shader)
+{
+  // the visible parts are rendered over the occluded edges afterwards, so only the
+  // occluded parts keep the occluded color
+  glSetEdgeOffset(OccludedEdgeOffset);
+  glAssert(glDisable(GL_DEPTH_TEST));
+
+  shader.set("Color", *m_params.occludedColor);
+  doRenderVertices();
+
+  glAssert(glEnable(GL_DEPTH_TEST));
+  glResetEdgeOffset();
 }
 
 EdgeRenderer::~EdgeRenderer() = default;
@@ -173,6 +204,29 @@ void EdgeRenderer::render(
   doRender(renderBatch, {width, offset, onTop, useColor, color});
 }
 
+void EdgeRenderer::renderWithOccluded(
+  RenderBatch& renderBatch,
+  const Color& color,
+  const Color& occludedColor,
+  const float width,
+  const double offset)
+{
+  renderWithOccluded(renderBatch, true, color, occludedColor, width, offset);
+}
+
+void EdgeRenderer::renderWithOccluded(
+  RenderBatch& renderBatch,
+  const bool useColor,
+  const Color& color,
+  const Color& occludedColor,
+  const float width,
+  const double offset)
+{
+  auto params = Params{width, offset, false, useColor, color};
+  params.occludedColor = occludedColor;
+  doRender(renderBatch, params);
+}
+
 DirectEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   VertexArray& vertexArray,
@@ -188,6 +242,11 @@ void DirectEdgeRenderer::Render::doPrepareVertices(VboManager& vboManager)
   m_vertexArray.prepare(vboManager);
 }
 
+std::string DirectEdgeRenderer::Render::profileLabel() const
+{
+  return "Edges";
+}
+
 void DirectEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
   if (m_vertexArray.vertexCount() > 0)
@@ -196,11 +255,21 @@ void DirectEdgeRenderer::Render::doRender(RenderContext& renderContext)
   }
 }
 
-void DirectEdgeRenderer::Render::doRenderVertices(RenderContext&)
+void DirectEdgeRenderer::Render::doSetupVertices()
+{
+  m_vertexArray.setup();
+}
+
+void DirectEdgeRenderer::Render::doRenderVertices()
 {
   m_indexRanges.render(m_vertexArray);
 }
 
+void DirectEdgeRenderer::Render::doCleanupVertices()
+{
+  m_vertexArray.cleanup();
+}
+
 DirectEdgeRenderer::DirectEdgeRenderer() {}
 
 DirectEdgeRenderer::DirectEdgeRenderer(VertexArray vertexArray, IndexRangeMap indexRanges)
@@ -226,10 +295,12 @@ void DirectEdgeRenderer::doRender(
 IndexedEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   std::shared_ptr<BrushVertexArray> vertexArray,
-  std::shared_ptr<BrushIndexArray> indexArray)
+  std::shared_ptr<BrushIndexArray> indexArray,
+  std::shared_ptr<const std::vector<BrushIndexRange>> indexArrayRanges)
   : RenderBase{params}
   , m_vertexArray{std::move(vertexArray)}
   , m_indexArray{std::move(indexArray)}
+  , m_indexArrayRanges{std::move(indexArrayRanges)}
 {
 }
 
@@ -239,19 +310,41 @@ void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(VboManager& vboManag
   m_indexArray->prepare(vboManager);
 }
 
+std::string IndexedEdgeRenderer::Render::profileLabel() const
+{
+  return "Edges";
+}
+
 void IndexedEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
-  if (m_indexArray->hasValidIndices())
+  if (
+    m_indexArray->hasValidIndices()
+    && (!m_indexArrayRanges || !m_indexArrayRanges->empty()))
   {
     renderEdges(renderContext);
   }
 }
 
-void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&)
+void IndexedEdgeRenderer::Render::doSetupVertices()
 {
   m_vertexArray->setupVertices();
   m_indexArray->setupIndices();
-  m_indexArray->render(PrimType::Lines);
+}
+
+void IndexedEdgeRenderer::Render::doRenderVertices()
+{
+  if (m_indexArrayRanges)
+  {
+    m_indexArray->render(PrimType::Lines, *m_indexArrayRanges);
+  }
+  else
+  {
+    m_indexArray->render(PrimType::Lines);
+  }
+}
+
+void IndexedEdgeRenderer::Render::doCleanupVertices()
+{
   m_vertexArray->cleanupVertices();
   m_indexArray->cleanupIndices();
 }
@@ -268,10 +361,17 @@ IndexedEdgeRenderer::IndexedEdgeRenderer(
 {
 }
 
+void IndexedEdgeRenderer::setIndexRanges(
+  std::shared_ptr<const std::vector<BrushIndexRange>> indexArrayRanges)
+{
+  m_indexArrayRanges = std::move(indexArrayRanges);
+}
+
 void IndexedEdgeRenderer::doRender(
   RenderBatch& renderBatch, const EdgeRenderer::Params& params)
 {
-  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArray});
+  renderBatch.addOneShot(
+    new Render{params, m_vertexArray, m_indexArray, m_indexArrayRanges});
 }
 
 } // namespace tb::render
@@ -25,10 +25,14 @@
 #include "render/VertexArray.h"
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace tb::render
 {
+class ActiveShader;
 class BrushIndexArray;
+struct BrushIndexRange;
 class BrushVertexArray;
 class RenderBatch;
 
@@ -43,6 +47,12 @@ public:
     bool useColor;
     Color color;
 
+    /**
+     * If set, the occluded parts of the edges are rendered with this color before the
+     * visible parts are rendered.
+     */
+    std::optional<Color> occludedColor;
+
     Params(float i_width, double i_offset, bool i_onTop);
     Params(float i_width, double i_offset, bool i_onTop, const Color& i_color);
     Params(
@@ -66,7 +76,11 @@ public:
     void renderEdges(RenderContext& renderContext);
 
   private:
-    virtual void doRenderVertices(RenderContext& renderContext) = 0;
+    void renderOccludedEdges(ActiveShader& shader);
+
+    virtual void doSetupVertices() = 0;
+    virtual void doRenderVertices() = 0;
+    virtual void doCleanupVertices() = 0;
   };
 
 public:
@@ -104,6 +118,25 @@ public:
     float width,
     double offset);
 
+  /**
+   * Renders the visible parts of the edges with the given color and the occluded parts
+   * with the given occluded color. This replaces a call to renderOnTop followed by a call
+   * to render, but both passes share their vertex and shader setup.
+   */
+  void renderWithOccluded(
+    RenderBatch& renderBatch,
+    const Color& color,
+    const Color& occludedColor,
+    float width = 1.0f,
+    double offset = 0.0);
+  void renderWithOccluded(
+    RenderBatch& renderBatch,
+    bool useColor,
+    const Color& color,
+    const Color& occludedColor,
+    float width = 1.0f,
+    double offset = 0.0);
+
 private:
   virtual void doRender(RenderBatch& renderBatch, const Params& params) = 0;
 };
@@ -120,10 +153,14 @@ private:
   public:
     Render(const Params& params, VertexArray& vertexArray, IndexRangeMap& indexRanges);
 
+    std::string profileLabel() const override;
+
   private:
     void doPrepareVertices(VboManager& vboManager) override;
     void doRender(RenderContext& renderContext) override;
-    void doRenderVertices(RenderContext& renderContext) override;
+    void doSetupVertices() override;
+    void doRenderVertices() override;
+    void doCleanupVertices() override;
   };
 
 private:
@@ -147,22 +184,29 @@ private:
   private:
     std::shared_ptr<BrushVertexArray> m_vertexArray;
     std::shared_ptr<BrushIndexArray> m_indexArray;
+    std::shared_ptr<const std::vector<BrushIndexRange>> m_indexArrayRanges;
 
   public:
     Render(
       const Params& params,
       std::shared_ptr<BrushVertexArray> vertexArray,
-      std::shared_ptr<BrushIndexArray> indexArray);
+      std::shared_ptr<BrushIndexArray> indexArray,
+      std::shared_ptr<const std::vector<BrushIndexRange>> indexArrayRanges);
+
+    std::string profileLabel() const override;
 
   private:
     void prepareVerticesAndIndices(VboManager& vboManager) override;
     void doRender(RenderContext& renderContext) override;
-    void doRenderVertices(RenderContext& renderContext) override;
+    void doSetupVertices() override;
+    void doRenderVertices() override;
+    void doCleanupVertices() override;
   };
 
 private:
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<BrushIndexArray> m_indexArray;
+  std::shared_ptr<const std::vector<BrushIndexRange>> m_indexArrayRanges;
 
 public:
   IndexedEdgeRenderer();
@@ -170,6 +214,12 @@ public:
     std::shared_ptr<BrushVertexArray> vertexArray,
     std::shared_ptr<BrushIndexArray> indexArray);
 
+  /**
+   * Restricts rendering to the given ranges of the index array. If this is null, all
+   * indices are rendered.
+   */
+  void setIndexRanges(std::shared_ptr<const std::vector<BrushIndexRange>> indexArrayRanges);
+
 private:
   void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
 };
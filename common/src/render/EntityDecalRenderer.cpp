@@ -32,12 +32,16 @@
 #include "mdl/Texture.h"
 #include "mdl/UVCoordSystem.h"
 #include "mdl/WorldNode.h"
+#include "render/OcclusionCuller.h"
+#include "render/RenderContext.h"
 
 #include "kdl/overload.h"
 
 #include "vm/intersection.h"
 
+#include <algorithm>
 #include <cstring>
+#include <map>
 
 namespace tb::render
 {
@@ -55,7 +59,7 @@ std::optional<mdl::DecalSpecification> getDecalSpecification(
          | kdl::value_or(std::nullopt);
 }
 
-using Vertex = render::GLVertexTypes::P3NT2::Vertex;
+using Vertex = render::GLVertexTypes::P3NBT2::Vertex;
 std::vector<Vertex> createDecalBrushFace(
   const mdl::EntityNode* entityNode,
   const mdl::BrushNode* brush,
@@ -135,7 +139,7 @@ std::vector<Vertex> createDecalBrushFace(
   }
 
   // convert the geometry into a list of vertices
-  const auto norm = vm::vec3f{plane.normal};
+  const auto norm = GLVertexAttributeTypes::NB::pack(vm::vec3f{plane.normal});
   return kdl::vec_transform(verts, [&](const auto& v) {
     return Vertex{vm::vec3f{v}, norm, uvCoordSystem->uvCoords(v, attrs, textureSize)};
   });
@@ -154,12 +158,14 @@ void EntityDecalRenderer::invalidate()
   for (auto& [ent, data] : m_entities)
   {
     invalidateDecalData(data);
+    data.projections.clear();
   }
 }
 
 void EntityDecalRenderer::clear()
 {
   m_entities.clear();
+  m_brushes.clear();
   m_vertexArray = std::make_shared<BrushVertexArray>();
   m_faces = std::make_shared<MaterialToBrushIndicesMap>();
   m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_faceColor};
@@ -187,6 +193,12 @@ void EntityDecalRenderer::removeNode(mdl::Node* node)
     [](mdl::PatchNode*) {}));
 }
 
+void EntityDecalRenderer::setVisibleEntities(
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities)
+{
+  m_visibleEntities = std::move(visibleEntities);
+}
+
 void EntityDecalRenderer::updateEntity(const mdl::EntityNode* entityNode)
 {
   // if the entity isn't visible, don't create decal geometry for it
@@ -222,33 +234,44 @@ void EntityDecalRenderer::removeEntity(const mdl::EntityNode* entityNode)
   {
     // make sure the entity data is cleaned up
     invalidateDecalData(it->second);
+    updateDecalBrushes(entityNode, it->second, {});
     m_entities.erase(it);
   }
 }
 
 void EntityDecalRenderer::updateBrush(const mdl::BrushNode* brushNode)
 {
-  // invalidate any entities that intersect this brush or are tracking this brush
-  for (auto& [ent, data] : m_entities)
+  // invalidate any entities that are tracking this brush, their projections onto this
+  // brush are outdated now
+  if (const auto it = m_brushes.find(brushNode); it != m_brushes.end())
   {
-    // skip entities that are going to be recomputed anyway
-    if (!data.validated)
+    it->second.version = m_nextBrushVersion++;
+    for (const auto* entityNode : it->second.entities)
     {
-      continue;
+      invalidateDecalData(m_entities.at(entityNode));
     }
+  }
 
-    // if the brush is not visible, then it doesn't (currently) intersect
-    const auto& editorContext = m_map.editorContext();
-    const auto intersects =
-      editorContext.visible(*brushNode) && brushNode->intersects(ent);
-    const auto tracked = std::find(data.brushes.begin(), data.brushes.end(), brushNode)
-                         != data.brushes.end();
+  // if the brush is not visible, then it doesn't (currently) intersect
+  const auto& editorContext = m_map.editorContext();
+  const auto* world = m_map.world();
+  if (!world || !editorContext.visible(*brushNode))
+  {
+    return;
+  }
 
-    // if this brush is tracked by this entity or intersects, we'll need to
-    // recalculate the geometry
-    if (intersects || tracked)
+  // invalidate any entities that intersect this brush
+  const auto intersectors =
+    world->nodeTree().find_intersectors(brushNode->physicalBounds());
+  for (const auto* node : intersectors)
+  {
+    if (const auto* entityNode = dynamic_cast<const mdl::EntityNode*>(node))
     {
-      invalidateDecalData(data);
+      if (const auto it = m_entities.find(entityNode);
+          it != m_entities.end() && brushNode->intersects(entityNode))
+      {
+        invalidateDecalData(it->second);
+      }
     }
   }
 }
@@ -256,21 +279,13 @@ void EntityDecalRenderer::updateBrush(const mdl::BrushNode* brushNode)
 void EntityDecalRenderer::removeBrush(const mdl::BrushNode* brushNode)
 {
   // invalidate any entities that are tracking this brush
-  for (auto& [ent, data] : m_entities)
+  if (const auto it = m_brushes.find(brushNode); it != m_brushes.end())
   {
-    // skip entities that are going to be recomputed anyway
-    if (!data.validated)
+    for (const auto* entityNode : it->second.entities)
     {
-      continue;
-    }
-
-    // if this brush is tracked by this entity, remove it and recalculate
-    const auto tracked = std::find(data.brushes.begin(), data.brushes.end(), brushNode)
-                         != data.brushes.end();
-    if (tracked)
-    {
-      invalidateDecalData(data);
+      invalidateDecalData(m_entities.at(entityNode));
     }
+    m_brushes.erase(it);
   }
 }
 
@@ -308,7 +323,7 @@ void EntityDecalRenderer::invalidateDecalData(EntityDecalData& data) const
 }
 
 void EntityDecalRenderer::validateDecalData(
-  const mdl::EntityNode* entityNode, EntityDecalData& data) const
+  const mdl::EntityNode* entityNode, EntityDecalData& data)
 {
   if (data.validated)
   {
@@ -327,24 +342,34 @@ void EntityDecalRenderer::validateDecalData(
   const auto intersectors = world->nodeTree().find_intersectors(entityBounds);
 
   // track them in the entity
-  data.brushes.clear();
+  auto brushes = std::vector<const mdl::BrushNode*>{};
   for (const auto* node : intersectors)
   {
     const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(node);
     if (brushNode && editorContext.visible(*brushNode))
     {
-      data.brushes.push_back(brushNode);
+      brushes.push_back(brushNode);
     }
   }
+  updateDecalBrushes(entityNode, data, std::move(brushes));
 
   data.material = m_map.materialManager().material(spec->materialName);
   if (!data.material)
   {
     // no decal material was found, don't generate any geometry
+    data.projections.clear();
     data.validated = true;
     return;
   }
 
+  // the projections depend on the decal's position, size and material
+  if (data.projectedBounds != entityBounds || data.projectedMaterial != data.material)
+  {
+    data.projections.clear();
+    data.projectedBounds = entityBounds;
+    data.projectedMaterial = data.material;
+  }
+
   // `bbox` and methods in the veclib library perform inclusive intersection tests - that
   // is, if two polygons share an edge, plane, or vertex, then they are considered to be
   // intersecting. We need the opposite behaviour when placing decals: when the entity's
@@ -353,39 +378,59 @@ void EntityDecalRenderer::validateDecalData(
   // so adjacent faces that don't actually breach the entity's bounding box are excluded.
   const auto shrunkBounds = entityBounds.expand(-vm::Cd::almost_zero());
 
-  // create geometry for the decal
+  // create geometry for the decal, reusing the projections onto unchanged brushes
   auto vertices = std::vector<Vertex>{};
   auto indices = std::vector<size_t>{};
+  auto projections = std::map<BrushFaceKey, DecalProjection>{};
 
-  for (const auto& brush : data.brushes)
+  for (const auto* brush : data.brushes)
   {
-    for (const auto& face : brush->brush().faces())
+    const auto brushVersion = m_brushes.at(brush).version;
+    const auto& faces = brush->brush().faces();
+    for (size_t faceIndex = 0; faceIndex < faces.size(); ++faceIndex)
     {
-      // see if this decal can be projected onto this face
-      const auto facePolygon = face.geometry()->vertexPositions();
-      if (vm::intersect_bbox_polygon(
-            shrunkBounds, facePolygon.begin(), facePolygon.end()))
+      const auto key = BrushFaceKey{brush, faceIndex};
+      auto& projection = projections[key];
+      if (const auto it = data.projections.find(key);
+          it != data.projections.end() && it->second.brushVersion == brushVersion)
       {
-        assert(data.material);
-        const auto decalPolygon =
-          createDecalBrushFace(entityNode, brush, face, *data.material);
-        if (!decalPolygon.empty())
+        projection = std::move(it->second);
+      }
+      else
+      {
+        projection.brushVersion = brushVersion;
+
+        // see if this decal can be projected onto this face
+        const auto& face = faces[faceIndex];
+        const auto facePolygon = face.geometry()->vertexPositions();
+        if (vm::intersect_bbox_polygon(
+              shrunkBounds, facePolygon.begin(), facePolygon.end()))
         {
-          // add the geometry to be uploaded into the VBO
-          const auto vertexOffset = vertices.size();
-
-          vertices.insert(vertices.end(), decalPolygon.begin(), decalPolygon.end());
-          for (size_t i = 0; i < decalPolygon.size() - 2; ++i)
-          {
-            indices.push_back(vertexOffset);
-            indices.push_back(vertexOffset + i + 1);
-            indices.push_back(vertexOffset + i + 2);
-          }
+          projection.vertices =
+            createDecalBrushFace(entityNode, brush, face, *data.material);
+        }
+      }
+
+      const auto& decalPolygon = projection.vertices;
+      if (!decalPolygon.empty())
+      {
+        // add the geometry to be uploaded into the VBO
+        const auto vertexOffset = vertices.size();
+
+        vertices.insert(vertices.end(), decalPolygon.begin(), decalPolygon.end());
+        for (size_t i = 0; i < decalPolygon.size() - 2; ++i)
+        {
+          indices.push_back(vertexOffset);
+          indices.push_back(vertexOffset + i + 1);
+          indices.push_back(vertexOffset + i + 2);
         }
       }
     }
   }
 
+  // drop the projections onto faces that the decal doesn't touch anymore
+  data.projections = std::move(projections);
+
   if (!vertices.empty() && !indices.empty())
   {
     // upload the geometry into the VBO
@@ -417,7 +462,43 @@ void EntityDecalRenderer::validateDecalData(
   data.validated = true;
 }
 
-void EntityDecalRenderer::render(RenderContext&, RenderBatch& renderBatch)
+void EntityDecalRenderer::updateDecalBrushes(
+  const mdl::EntityNode* entityNode,
+  EntityDecalData& data,
+  std::vector<const mdl::BrushNode*> brushes)
+{
+  // stop tracking the brushes that the decal doesn't touch anymore
+  for (const auto* brushNode : data.brushes)
+  {
+    if (std::ranges::find(brushes, brushNode) == brushes.end())
+    {
+      if (const auto it = m_brushes.find(brushNode); it != m_brushes.end())
+      {
+        it->second.entities.erase(entityNode);
+        if (it->second.entities.empty())
+        {
+          m_brushes.erase(it);
+        }
+      }
+    }
+  }
+
+  for (const auto* brushNode : brushes)
+  {
+    auto [it, inserted] = m_brushes.try_emplace(brushNode);
+    if (inserted)
+    {
+      // versions are never reused, so a projection onto a deleted brush can't be
+      // mistaken for a projection onto a new brush at the same address
+      it->second.version = m_nextBrushVersion++;
+    }
+    it->second.entities.insert(entityNode);
+  }
+
+  data.brushes = std::move(brushes);
+}
+
+void EntityDecalRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   // update any invalidated entities if required
   for (auto& [ent, data] : m_entities)
@@ -425,7 +506,35 @@ void EntityDecalRenderer::render(RenderContext&, RenderBatch& renderBatch)
     validateDecalData(ent, data);
   }
 
+  const auto* occlusionCuller = renderContext.occlusionCuller();
+  m_faceRenderer.setIndexRanges(
+    occlusionCuller || m_visibleEntities ? findVisibleFaceRanges(occlusionCuller)
+                                         : nullptr);
   m_faceRenderer.render(renderBatch);
 }
 
+std::shared_ptr<EntityDecalRenderer::MaterialToBrushIndexRangesMap> EntityDecalRenderer::
+  findVisibleFaceRanges(const OcclusionCuller* occlusionCuller) const
+{
+  // the decals are projected onto the faces that intersect the entity's bounds
+  auto ranges = std::make_shared<MaterialToBrushIndexRangesMap>();
+  for (const auto& [entityNode, data] : m_entities)
+  {
+    if (
+      data.faceIndicesKey
+      && (!m_visibleEntities || m_visibleEntities->contains(entityNode))
+      && !(occlusionCuller && occlusionCuller->isOccluded(entityNode->physicalBounds())))
+    {
+      (*ranges)[data.material].push_back(
+        {data.faceIndicesKey->pos, data.faceIndicesKey->size});
+    }
+  }
+
+  for (auto& [material, materialRanges] : *ranges)
+  {
+    mergeIndexRanges(materialRanges);
+  }
+  return ranges;
+}
+
 } // namespace tb::render
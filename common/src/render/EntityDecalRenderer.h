@@ -20,13 +20,20 @@
 #pragma once
 
 #include "Color.h"
+#include "mdl/NodeSlotMap.h"
 #include "render/AllocationTracker.h"
 #include "render/EdgeRenderer.h"
 #include "render/FaceRenderer.h"
 #include "render/GLVertexType.h"
 #include "render/Renderable.h"
 
+#include "vm/bbox.h"
+
+#include <map>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
@@ -42,14 +49,37 @@ struct DecalSpecification;
 
 namespace tb::render
 {
+class OcclusionCuller;
 
 class EntityDecalRenderer
 {
 private:
+  using Vertex = render::GLVertexTypes::P3NBT2::Vertex;
+
+  /**
+   * The decal polygon projected onto a brush face, clipped by the other faces of the
+   * brush. The polygon is empty if the decal doesn't touch the face.
+   */
+  struct DecalProjection
+  {
+    // the version of the brush when the projection was computed
+    size_t brushVersion = 0;
+    std::vector<Vertex> vertices;
+  };
+
+  // identifies a brush face by its brush and its index in the brush
+  using BrushFaceKey = std::pair<const mdl::BrushNode*, size_t>;
+
   struct EntityDecalData
   {
     std::vector<const mdl::BrushNode*> brushes;
 
+    /* the projections of the decal onto the faces of the brushes, they remain valid as
+     * long as the decal bounds and material and the brush versions don't change */
+    std::map<BrushFaceKey, DecalProjection> projections;
+    vm::bbox3d projectedBounds;
+    const mdl::Material* projectedMaterial = nullptr;
+
     /* will only be true if the brushes array has been calculated since the last change
      * and the decal geometry is stored in the VBO */
     bool validated = false;
@@ -61,20 +91,36 @@ private:
   };
 
   using EntityWithDependenciesMap =
-    std::unordered_map<const mdl::EntityNode*, EntityDecalData>;
+    mdl::NodeSlotMap<const mdl::EntityNode, EntityDecalData>;
+
+  struct DecalBrushData
+  {
+    // incremented whenever the brush changes, taken from m_nextBrushVersion
+    size_t version = 0;
+
+    // the decal entities whose decals touch the brush
+    std::unordered_set<const mdl::EntityNode*> entities;
+  };
+
+  using BrushWithDependentsMap = mdl::NodeSlotMap<const mdl::BrushNode, DecalBrushData>;
 
   mdl::Map& m_map;
   EntityWithDependenciesMap m_entities;
+  BrushWithDependentsMap m_brushes;
+  size_t m_nextBrushVersion = 1;
 
-  using Vertex = render::GLVertexTypes::P3NT2::Vertex;
   using MaterialToBrushIndicesMap =
     std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
+  using MaterialToBrushIndexRangesMap =
+    std::unordered_map<const mdl::Material*, std::vector<BrushIndexRange>>;
 
   std::shared_ptr<MaterialToBrushIndicesMap> m_faces;
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   FaceRenderer m_faceRenderer;
   Color m_faceColor;
 
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> m_visibleEntities;
+
 public:
   explicit EntityDecalRenderer(mdl::Map& map);
 
@@ -98,6 +144,13 @@ public:
    */
   void removeNode(mdl::Node* node);
 
+  /**
+   * Restricts rendering to the decals of the given entities. If this is null, the decals
+   * of all entities are rendered.
+   */
+  void setVisibleEntities(
+    std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities);
+
 private:
   void updateEntity(const mdl::EntityNode* entityNode);
   void removeEntity(const mdl::EntityNode* entityNode);
@@ -106,9 +159,20 @@ private:
 
   void invalidateDecalData(EntityDecalData& data) const;
 
-  void validateDecalData(const mdl::EntityNode* entityNode, EntityDecalData& data) const;
+  void validateDecalData(const mdl::EntityNode* entityNode, EntityDecalData& data);
+  void updateDecalBrushes(
+    const mdl::EntityNode* entityNode,
+    EntityDecalData& data,
+    std::vector<const mdl::BrushNode*> brushes);
+
+  std::shared_ptr<MaterialToBrushIndexRangesMap> findVisibleFaceRanges(
+    const OcclusionCuller* occlusionCuller) const;
 
 public: // rendering
+  /**
+   * If the given render context has an occlusion culler, decals of entities that are
+   * hidden are skipped, as are the decals of entities that are not visible.
+   */
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
   deleteCopy(EntityDecalRenderer);
@@ -33,11 +33,13 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/overload.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/vec.h"
 
 #include <cassert>
 #include <unordered_set>
+#include <vector>
 
 namespace tb::render
 {
@@ -241,34 +243,6 @@ auto collectSelectedLinks(const mdl::Selection& selection, Visitor visitor)
   return links;
 }
 
-auto getAllLinks(
-  const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
-{
-  auto links = std::vector<LinkRenderer::LineVertex>{};
-
-  if (map.world())
-  {
-    auto visitor =
-      CollectAllLinksVisitor{map.editorContext(), defaultColor, selectedColor};
-
-    map.world()->accept(kdl::overload(
-      [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
-        groupNode->visitChildren(thisLambda);
-      },
-      [&](const mdl::EntityNode* entityNode) { visitor.visit(*entityNode, links); },
-      [](const mdl::BrushNode*) {},
-      [](const mdl::PatchNode*) {}));
-  }
-
-  return links;
-}
-
 auto getTransitiveSelectedLinks(
   const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
 {
@@ -285,13 +259,10 @@ auto getDirectSelectedLinks(
   return collectSelectedLinks(map.selection(), visitor);
 }
 
-auto getLinks(const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
+auto getSelectedLinks(
+  const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
 {
   const auto entityLinkMode = pref(Preferences::EntityLinkMode);
-  if (entityLinkMode == Preferences::entityLinkModeAll())
-  {
-    return getAllLinks(map, defaultColor, selectedColor);
-  }
   if (entityLinkMode == Preferences::entityLinkModeTransitive())
   {
     return getTransitiveSelectedLinks(map, defaultColor, selectedColor);
@@ -303,11 +274,170 @@ auto getLinks(const mdl::Map& map, const Color& defaultColor, const Color& selec
 
   return std::vector<LinkRenderer::LineVertex>{};
 }
+
 } // namespace
 
-std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks()
+void EntityLinkRenderer::updateNode(mdl::Node* node)
+{
+  node->accept(kdl::overload(
+    [](const mdl::WorldNode*) {},
+    [](const mdl::LayerNode*) {},
+    [](const mdl::GroupNode*) {},
+    [&](const mdl::EntityNode* entityNode) { invalidateNode(entityNode); },
+    [](auto&& thisLambda, const mdl::BrushNode* brushNode) {
+      brushNode->visitParent(thisLambda);
+    },
+    [](auto&& thisLambda, const mdl::PatchNode* patchNode) {
+      patchNode->visitParent(thisLambda);
+    }));
+}
+
+void EntityLinkRenderer::removeNode(mdl::Node* node)
+{
+  node->accept(kdl::overload(
+    [](const mdl::WorldNode*) {},
+    [](const mdl::LayerNode*) {},
+    [](const mdl::GroupNode*) {},
+    [&](const mdl::EntityNode* entityNode) { removeNodeLinks(entityNode); },
+    // the anchors of the containing entity may have changed
+    [&](mdl::BrushNode* brushNode) { updateNode(brushNode); },
+    [&](mdl::PatchNode* patchNode) { updateNode(patchNode); }));
+}
+
+void EntityLinkRenderer::invalidateNode(const mdl::EntityNode* entityNode)
+{
+  if (m_showAllLinks)
+  {
+    m_invalidNodes.insert(entityNode);
+    invalidateLinks();
+  }
+  else
+  {
+    invalidate();
+  }
+}
+
+void EntityLinkRenderer::updateNodeLinks(const mdl::EntityNode* entityNode)
+{
+  removeLinkTargets(entityNode);
+
+  const auto linkTargets =
+    kdl::vec_concat(entityNode->linkTargets(), entityNode->killTargets());
+  for (const auto* targetNode : linkTargets)
+  {
+    m_linkSources[targetNode].push_back(entityNode);
+  }
+  if (!linkTargets.empty())
+  {
+    m_linkTargets[entityNode] = {linkTargets.begin(), linkTargets.end()};
+  }
+
+  auto links = std::vector<LinkRenderer::LineVertex>{};
+  auto visitor =
+    CollectAllLinksVisitor{m_map.editorContext(), m_defaultColor, m_selectedColor};
+  visitor.visit(*entityNode, links);
+  setLinks(entityNode, links);
+}
+
+void EntityLinkRenderer::removeNodeLinks(const mdl::EntityNode* entityNode)
+{
+  if (!m_showAllLinks)
+  {
+    invalidate();
+    return;
+  }
+
+  // the nodes that have links to the removed node must be updated
+  if (const auto it = m_linkSources.find(entityNode); it != m_linkSources.end())
+  {
+    m_invalidNodes.insert(it->second.begin(), it->second.end());
+    m_linkSources.erase(it);
+  }
+  m_invalidNodes.erase(entityNode);
+
+  removeLinkTargets(entityNode);
+  removeLinks(entityNode);
+  invalidateLinks();
+}
+
+void EntityLinkRenderer::removeLinkTargets(const mdl::EntityNode* entityNode)
+{
+  if (const auto it = m_linkTargets.find(entityNode); it != m_linkTargets.end())
+  {
+    for (const auto* targetNode : it->second)
+    {
+      if (const auto sources = m_linkSources.find(targetNode);
+          sources != m_linkSources.end())
+      {
+        std::erase(sources->second, entityNode);
+        if (sources->second.empty())
+        {
+          m_linkSources.erase(sources);
+        }
+      }
+    }
+    m_linkTargets.erase(it);
+  }
+}
+
+void EntityLinkRenderer::rebuildLinks()
 {
-  return render::getLinks(m_map, m_defaultColor, m_selectedColor);
+  m_linkTargets.clear();
+  m_linkSources.clear();
+  m_invalidNodes.clear();
+
+  m_showAllLinks = pref(Preferences::EntityLinkMode) == Preferences::entityLinkModeAll();
+  if (!m_showAllLinks)
+  {
+    setLinks(nullptr, getSelectedLinks(m_map, m_defaultColor, m_selectedColor));
+  }
+  else if (const auto* worldNode = m_map.world())
+  {
+    worldNode->accept(kdl::overload(
+      [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
+        worldNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](const mdl::EntityNode* entityNode) { updateNodeLinks(entityNode); },
+      [](const mdl::BrushNode*) {},
+      [](const mdl::PatchNode*) {}));
+  }
+}
+
+void EntityLinkRenderer::updateLinks()
+{
+  // besides the invalid nodes themselves, the nodes that had links to them and the nodes
+  // that have links to them now must be updated
+  auto nodesToUpdate = std::unordered_set<const mdl::EntityNode*>{};
+  for (const auto* entityNode : m_invalidNodes)
+  {
+    nodesToUpdate.insert(entityNode);
+    if (const auto it = m_linkSources.find(entityNode); it != m_linkSources.end())
+    {
+      nodesToUpdate.insert(it->second.begin(), it->second.end());
+    }
+
+    const auto linkSources =
+      kdl::vec_concat(entityNode->linkSources(), entityNode->killSources());
+    for (const auto* sourceNode : linkSources)
+    {
+      if (const auto* sourceEntityNode = dynamic_cast<const mdl::EntityNode*>(sourceNode))
+      {
+        nodesToUpdate.insert(sourceEntityNode);
+      }
+    }
+  }
+  m_invalidNodes.clear();
+
+  for (const auto* entityNode : nodesToUpdate)
+  {
+    updateNodeLinks(entityNode);
+  }
 }
 
 } // namespace tb::render
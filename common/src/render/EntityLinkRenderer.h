@@ -23,12 +23,17 @@
 #include "Macros.h"
 #include "render/LinkRenderer.h"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
 {
+class EntityNode;
+class EntityNodeBase;
 class Map;
-}
+class Node;
+} // namespace tb::mdl
 
 namespace tb::render
 {
@@ -40,14 +45,41 @@ class EntityLinkRenderer : public LinkRenderer
   Color m_defaultColor = {0.5f, 1.0f, 0.5f, 1.0f};
   Color m_selectedColor = {1.0f, 0.0f, 0.0f, 1.0f};
 
+  /* If all links are shown, the links of every entity node are stored under the node,
+   * and these maps track the targets of each node and the nodes that have links to each
+   * target, so that only the links of changed nodes must be updated. */
+  bool m_showAllLinks = false;
+  std::unordered_map<const mdl::EntityNode*, std::vector<const mdl::EntityNodeBase*>>
+    m_linkTargets;
+  std::unordered_map<const mdl::EntityNodeBase*, std::vector<const mdl::EntityNode*>>
+    m_linkSources;
+  std::unordered_set<const mdl::EntityNode*> m_invalidNodes;
+
 public:
   explicit EntityLinkRenderer(mdl::Map& map);
 
   void setDefaultColor(const Color& color);
   void setSelectedColor(const Color& color);
 
+  /**
+   * Updates the links from and to the given node, or to its containing entity if the
+   * given node is a brush or a patch.
+   */
+  void updateNode(mdl::Node* node);
+
+  /**
+   * Removes the links from the given node and updates the links to it.
+   */
+  void removeNode(mdl::Node* node);
+
 private:
-  std::vector<LinkRenderer::LineVertex> getLinks() override;
+  void invalidateNode(const mdl::EntityNode* entityNode);
+  void updateNodeLinks(const mdl::EntityNode* entityNode);
+  void removeNodeLinks(const mdl::EntityNode* entityNode);
+  void removeLinkTargets(const mdl::EntityNode* entityNode);
+
+  void rebuildLinks() override;
+  void updateLinks() override;
 
   deleteCopy(EntityLinkRenderer);
 };
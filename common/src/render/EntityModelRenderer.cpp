@@ -31,18 +31,99 @@
 #include "render/ActiveShader.h"
 #include "render/Camera.h"
 #include "render/MaterialIndexRangeRenderer.h"
+#include "render/OcclusionCuller.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderUtils.h"
+#include "render/ShaderManager.h"
+#include "render/ShaderProgram.h"
 #include "render/Shaders.h"
 #include "render/Transformation.h"
+#include "render/VboManager.h"
+#include "render/VboRingBuffer.h"
 
 #include "vm/mat.h"
+#include "vm/vec.h"
 
+#include <cassert>
+#include <map>
+#include <optional>
 #include <vector>
 
 namespace tb::render
 {
+namespace
+{
+
+/**
+ * Models with fewer instances than this are rendered with one draw call per instance.
+ */
+constexpr auto MinInstanceCount = size_t(2);
+
+bool instancingSupported()
+{
+  return GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
+}
+
+/**
+ * Binds transformations that were written into the streaming vertex buffer to the
+ * InstanceModelMatrix attribute of the given shader program, advancing once per instance.
+ */
+class InstanceTransformations : public InstanceAttributes
+{
+private:
+  VboRingBuffer& m_buffer;
+  size_t m_offset;
+  GLuint m_location;
+
+public:
+  InstanceTransformations(
+    const ShaderProgram& program, VboRingBuffer& buffer, const size_t offset)
+    : m_buffer{buffer}
+    , m_offset{offset}
+    , m_location{GLuint(program.findAttributeLocation("InstanceModelMatrix"))}
+  {
+  }
+
+  void setup() override
+  {
+    // a mat4 attribute occupies four consecutive locations, one per column
+    m_buffer.bind();
+    for (auto i = GLuint(0); i < 4; ++i)
+    {
+      const auto columnOffset = m_offset + i * sizeof(vm::vec4f);
+      glAssert(glEnableVertexAttribArray(m_location + i));
+      glAssert(glVertexAttribPointer(
+        m_location + i,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        GLsizei(sizeof(vm::mat4x4f)),
+        reinterpret_cast<const GLvoid*>(columnOffset)));
+      glAssert(glVertexAttribDivisorARB(m_location + i, 1));
+    }
+    m_buffer.unbind();
+  }
+
+  void cleanup() override
+  {
+    for (auto i = GLuint(0); i < 4; ++i)
+    {
+#ifndef NDEBUG
+      // if the divisor was set on another vertex array object than the one that was just
+      // drawn, every instance was rendered with the same transformation
+      auto divisor = GLint(0);
+      glAssert(glGetVertexAttribiv(
+        m_location + i, GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ARB, &divisor));
+      assert(divisor == 1);
+#endif
+      glAssert(glVertexAttribDivisorARB(m_location + i, 0));
+      glAssert(glDisableVertexAttribArray(m_location + i));
+    }
+  }
+};
+
+} // namespace
 
 EntityModelRenderer::EntityModelRenderer(
   Logger& logger,
@@ -66,10 +147,10 @@ void EntityModelRenderer::addEntity(const mdl::EntityNode* entityNode)
       return entityNode->entity().modelSpecification();
     });
 
-  auto* renderer = m_entityModelManager.renderer(modelSpec);
-  if (renderer != nullptr)
+  const auto renderers = findRenderers(modelSpec);
+  if (renderers.full != nullptr)
   {
-    m_entities.emplace(entityNode, renderer);
+    m_entities.emplace(entityNode, renderers);
   }
 }
 
@@ -85,28 +166,14 @@ void EntityModelRenderer::updateEntity(const mdl::EntityNode* entityNode)
       return entityNode->entity().modelSpecification();
     });
 
-  auto* renderer = m_entityModelManager.renderer(modelSpec);
-  auto it = m_entities.find(entityNode);
-
-  if (renderer == nullptr && it == std::end(m_entities))
+  const auto renderers = findRenderers(modelSpec);
+  if (renderers.full == nullptr)
   {
-    return;
-  }
-
-  if (it == std::end(m_entities))
-  {
-    m_entities.emplace(entityNode, renderer);
+    m_entities.erase(entityNode);
   }
   else
   {
-    if (renderer == nullptr)
-    {
-      m_entities.erase(it);
-    }
-    else if (it->second != renderer)
-    {
-      it->second = renderer;
-    }
+    m_entities.insert_or_assign(entityNode, renderers);
   }
 }
 
@@ -115,6 +182,12 @@ void EntityModelRenderer::clear()
   m_entities.clear();
 }
 
+bool EntityModelRenderer::hasUnpreparedModel(const mdl::EntityNode* entityNode) const
+{
+  const auto it = m_entities.find(entityNode);
+  return it != m_entities.end() && !m_entityModelManager.isPrepared(*it->second.full);
+}
+
 bool EntityModelRenderer::applyTinting() const
 {
   return m_applyTinting;
@@ -145,14 +218,35 @@ void EntityModelRenderer::setShowHiddenEntities(const bool showHiddenEntities)
   m_showHiddenEntities = showHiddenEntities;
 }
 
+void EntityModelRenderer::setVisibleEntities(
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities)
+{
+  m_visibleEntities = std::move(visibleEntities);
+}
+
 void EntityModelRenderer::render(RenderBatch& renderBatch)
 {
   renderBatch.add(this);
 }
 
+EntityModelRenderer::ModelRenderers EntityModelRenderer::findRenderers(
+  const mdl::ModelSpecification& modelSpec) const
+{
+  return {
+    m_entityModelManager.renderer(modelSpec),
+    m_entityModelManager.renderer(modelSpec, mdl::EntityModelDetail::Reduced),
+    m_entityModelManager.renderer(modelSpec, mdl::EntityModelDetail::Minimal)};
+}
+
 void EntityModelRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_entityModelManager.prepare(vboManager);
+  m_vboManager = &vboManager;
+}
+
+std::string EntityModelRenderer::profileLabel() const
+{
+  return "Entity models";
 }
 
 void EntityModelRenderer::doRender(RenderContext& renderContext)
@@ -190,13 +284,40 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
     const auto& propertyConfig = m_entities.begin()->first->entityPropertyConfig();
     const auto& defaultModelScaleExpression = propertyConfig.defaultModelScaleExpression;
 
-    for (const auto& [entityNode, renderer] : m_entities)
+    struct Instances
+    {
+      mdl::Orientation orientation;
+      std::vector<vm::mat4x4f> transformations;
+    };
+
+    // a renderer represents a model with a particular skin and frame, so all instances
+    // sharing one can be drawn together
+    // distant models are rendered with less detail in the 3D view, a distance of 0
+    // disables a level of detail
+    const auto reducedDetailDistance =
+      renderContext.render3D() ? prefs.get(Preferences::EntityModelReducedDetailDistance)
+                               : 0.0f;
+    const auto minimalDetailDistance =
+      renderContext.render3D() ? prefs.get(Preferences::EntityModelMinimalDetailDistance)
+                               : 0.0f;
+    const auto& cameraPosition = renderContext.camera().position();
+
+    const auto* occlusionCuller = renderContext.occlusionCuller();
+    auto instancesByRenderer = std::unordered_map<MaterialRenderer*, Instances>{};
+    for (const auto& [entityNode, renderers] : m_entities)
     {
       if (!m_showHiddenEntities && !m_editorContext.visible(*entityNode))
       {
         continue;
       }
 
+      if (
+        (m_visibleEntities && !m_visibleEntities->contains(entityNode))
+        || (occlusionCuller && occlusionCuller->isOccluded(entityNode->physicalBounds())))
+      {
+        continue;
+      }
+
       const auto* model = entityNode->entity().model();
       const auto* modelData = model ? model->data() : nullptr;
       if (!modelData)
@@ -204,18 +325,68 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
         continue;
       }
 
-      shader.set("Orientation", static_cast<int>(modelData->orientation()));
+      const auto distance =
+        vm::distance(cameraPosition, vm::vec3f{entityNode->physicalBounds().center()});
+      auto* renderer =
+        minimalDetailDistance > 0.0f && distance >= minimalDetailDistance
+          ? renderers.minimal
+        : reducedDetailDistance > 0.0f && distance >= reducedDetailDistance
+          ? renderers.reduced
+          : renderers.full;
+      if (!m_entityModelManager.isPrepared(*renderer))
+      {
+        renderer = renderers.full;
+      }
 
-      const auto transformation = vm::mat4x4f{
-        entityNode->entity().modelTransformation(defaultModelScaleExpression)};
-      const auto multMatrix =
-        MultiplyModelMatrix{renderContext.transformation(), transformation};
+      auto& instances = instancesByRenderer
+                          .try_emplace(renderer, Instances{modelData->orientation(), {}})
+                          .first->second;
+      instances.transformations.emplace_back(
+        entityNode->entity().modelTransformation(defaultModelScaleExpression));
+    }
 
-      shader.set("ModelMatrix", transformation);
+    const auto useInstancing = m_vboManager && instancingSupported();
+    const auto& program = *renderContext.shaderManager().currentProgram();
+    shader.set("Instanced", false);
 
-      auto renderFunc = DefaultMaterialRenderFunc{
-        renderContext.minFilterMode(), renderContext.magFilterMode()};
-      renderer->render(renderFunc);
+    auto renderFunc =
+      DefaultMaterialRenderFunc{renderContext.minFilterMode(), renderContext.magFilterMode()};
+    for (const auto& [renderer, instances] : instancesByRenderer)
+    {
+      if (!m_entityModelManager.isPrepared(*renderer))
+      {
+        // the entities' bounds are rendered as placeholders instead
+        continue;
+      }
+
+      shader.set("Orientation", static_cast<int>(instances.orientation));
+
+      const auto offset =
+        useInstancing && instances.transformations.size() >= MinInstanceCount
+          ? m_vboManager->streamingVertexBuffer().write(
+              instances.transformations.data(),
+              instances.transformations.size() * sizeof(vm::mat4x4f))
+          : std::nullopt;
+      if (offset)
+      {
+        auto instanceTransformations = InstanceTransformations{
+          program, m_vboManager->streamingVertexBuffer(), *offset};
+        shader.set("Instanced", true);
+        renderer->renderInstanced(
+          renderFunc, instanceTransformations, instances.transformations.size());
+        shader.set("Instanced", false);
+      }
+      else
+      {
+        for (const auto& transformation : instances.transformations)
+        {
+          const auto multMatrix =
+            MultiplyModelMatrix{renderContext.transformation(), transformation};
+
+          shader.set("ModelMatrix", transformation);
+          renderer->render(renderFunc);
+        }
+      }
     }
   }
 }
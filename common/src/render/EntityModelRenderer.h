@@ -22,7 +22,9 @@
 #include "Color.h"
 #include "render/Renderable.h"
 
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace tb
 {
@@ -34,6 +36,7 @@ namespace tb::mdl
 class EditorContext;
 class EntityModelManager;
 class EntityNode;
+struct ModelSpecification;
 } // namespace tb::mdl
 
 namespace tb::render
@@ -41,6 +44,7 @@ namespace tb::render
 class RenderBatch;
 struct ShaderConfig;
 class MaterialRenderer;
+class VboManager;
 
 class EntityModelRenderer : public DirectRenderable
 {
@@ -50,12 +54,30 @@ private:
   mdl::EntityModelManager& m_entityModelManager;
   const mdl::EditorContext& m_editorContext;
 
-  std::unordered_map<const mdl::EntityNode*, MaterialRenderer*> m_entities;
+  /**
+   * The renderers of an entity's model for each level of detail. The reduced and minimal
+   * renderers are the same as the full renderer if the model cannot be simplified.
+   */
+  struct ModelRenderers
+  {
+    MaterialRenderer* full = nullptr;
+    MaterialRenderer* reduced = nullptr;
+    MaterialRenderer* minimal = nullptr;
+  };
+
+  std::unordered_map<const mdl::EntityNode*, ModelRenderers> m_entities;
 
   bool m_applyTinting = false;
   Color m_tintColor;
 
   bool m_showHiddenEntities = false;
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> m_visibleEntities;
+
+  /**
+   * Set when the vertices are prepared, used to upload the per-instance transformations
+   * of models which are rendered with instancing.
+   */
+  VboManager* m_vboManager = nullptr;
 
 public:
   EntityModelRenderer(
@@ -96,6 +118,12 @@ public:
   void updateEntity(const mdl::EntityNode* entityNode);
   void clear();
 
+  /**
+   * Indicates whether the given entity has a model renderer that was not uploaded yet.
+   * Such entities are not rendered until their renderer is uploaded.
+   */
+  bool hasUnpreparedModel(const mdl::EntityNode* entityNode) const;
+
   bool applyTinting() const;
   void setApplyTinting(bool applyTinting);
   const Color& tintColor() const;
@@ -104,9 +132,20 @@ public:
   bool showHiddenEntities() const;
   void setShowHiddenEntities(bool showHiddenEntities);
 
+  /**
+   * Restricts rendering to the models of the given entities. If this is null, the models
+   * of all entities are rendered.
+   */
+  void setVisibleEntities(
+    std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities);
+
   void render(RenderBatch& renderBatch);
 
+  std::string profileLabel() const override;
+
 private:
+  ModelRenderers findRenderers(const mdl::ModelSpecification& modelSpec) const;
+
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
 };
@@ -32,11 +32,16 @@
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
 #include "render/TextAnchor.h"
+#include "render/TextRenderer.h"
 
+#include "vm/bbox.h"
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <vector>
 
 namespace tb::render
@@ -65,6 +70,83 @@ private:
   TextAlignment::Type alignment() const override { return TextAlignment::Bottom; }
 };
 
+/**
+ * Places labels in screen space so that no two placed labels overlap. The viewport is
+ * divided into square bins, and every placed label is recorded in each bin it overlaps,
+ * so that a new label is only tested against the labels that share a bin with it.
+ */
+class LabelPlacement
+{
+private:
+  static constexpr auto BinSize = 64.0f;
+
+  vm::bbox2f m_viewportBounds;
+  size_t m_columns;
+  size_t m_rows;
+  std::vector<std::vector<vm::bbox2f>> m_bins;
+
+public:
+  explicit LabelPlacement(const Camera::Viewport& viewport)
+    : m_viewportBounds{
+        vm::vec2f{0, 0}, vm::vec2f{float(viewport.width), float(viewport.height)}}
+    , m_columns{size_t(std::max(viewport.width, 0)) / size_t(BinSize) + 1}
+    , m_rows{size_t(std::max(viewport.height, 0)) / size_t(BinSize) + 1}
+    , m_bins(m_columns * m_rows)
+  {
+  }
+
+  /**
+   * Places a label with the given screen space bounds unless the label is outside of the
+   * viewport or overlaps a previously placed label.
+   *
+   * @return true if the label was placed and false otherwise
+   */
+  bool place(const vm::bbox2f& bounds)
+  {
+    if (!bounds.intersects(m_viewportBounds))
+    {
+      return false;
+    }
+
+    const auto minColumn = column(bounds.min.x());
+    const auto maxColumn = column(bounds.max.x());
+    const auto minRow = row(bounds.min.y());
+    const auto maxRow = row(bounds.max.y());
+
+    for (auto r = minRow; r <= maxRow; ++r)
+    {
+      for (auto c = minColumn; c <= maxColumn; ++c)
+      {
+        const auto& bin = m_bins[r * m_columns + c];
+        if (std::ranges::any_of(
+              bin, [&](const auto& other) { return other.intersects(bounds); }))
+        {
+          return false;
+        }
+      }
+    }
+
+    for (auto r = minRow; r <= maxRow; ++r)
+    {
+      for (auto c = minColumn; c <= maxColumn; ++c)
+      {
+        m_bins[r * m_columns + c].push_back(bounds);
+      }
+    }
+    return true;
+  }
+
+private:
+  size_t column(const float x) const { return binIndex(x, m_columns); }
+  size_t row(const float y) const { return binIndex(y, m_rows); }
+
+  static size_t binIndex(const float coord, const size_t count)
+  {
+    const auto index = std::floor(coord / BinSize);
+    return size_t(std::clamp(index, 0.0f, float(count - 1)));
+  }
+};
+
 } // namespace
 
 EntityRenderer::EntityRenderer(
@@ -201,6 +283,12 @@ void EntityRenderer::setShowHiddenEntities(const bool showHiddenEntities)
   m_showHiddenEntities = showHiddenEntities;
 }
 
+void EntityRenderer::setVisibleEntities(
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities)
+{
+  m_modelRenderer.setVisibleEntities(std::move(visibleEntities));
+}
+
 void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   if (!m_entities.empty())
@@ -214,6 +302,13 @@ void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBat
 
 void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  if (
+    m_preparedModelRendererCount
+    && *m_preparedModelRendererCount != m_entityModelManager.preparedRendererCount())
+  {
+    invalidateBounds();
+  }
+
   if (!m_boundsValid)
   {
     validateBounds();
@@ -239,24 +334,28 @@ void EntityRenderer::renderPointEntityWireframeBounds(RenderBatch& renderBatch)
 {
   if (m_showOccludedBounds)
   {
-    m_pointEntityWireframeBoundsRenderer.renderOnTop(
-      renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+    m_pointEntityWireframeBoundsRenderer.renderWithOccluded(
+      renderBatch, m_overrideBoundsColor, m_boundsColor, m_occludedBoundsColor);
+  }
+  else
+  {
+    m_pointEntityWireframeBoundsRenderer.render(
+      renderBatch, m_overrideBoundsColor, m_boundsColor);
   }
-
-  m_pointEntityWireframeBoundsRenderer.render(
-    renderBatch, m_overrideBoundsColor, m_boundsColor);
 }
 
 void EntityRenderer::renderBrushEntityWireframeBounds(RenderBatch& renderBatch)
 {
   if (m_showOccludedBounds)
   {
-    m_brushEntityWireframeBoundsRenderer.renderOnTop(
-      renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+    m_brushEntityWireframeBoundsRenderer.renderWithOccluded(
+      renderBatch, m_overrideBoundsColor, m_boundsColor, m_occludedBoundsColor);
+  }
+  else
+  {
+    m_brushEntityWireframeBoundsRenderer.render(
+      renderBatch, m_overrideBoundsColor, m_boundsColor);
   }
-
-  m_brushEntityWireframeBoundsRenderer.render(
-    renderBatch, m_overrideBoundsColor, m_boundsColor);
 }
 
 void EntityRenderer::renderSolidBounds(RenderBatch& renderBatch)
@@ -284,10 +383,24 @@ void EntityRenderer::renderClassnames(
 {
   if (m_showOverlays && renderContext.showEntityClassnames())
   {
-    auto renderService = render::RenderService{renderContext, renderBatch};
-    renderService.setForegroundColor(m_overlayTextColor);
-    renderService.setBackgroundColor(m_overlayBackgroundColor);
+    const auto& camera = renderContext.camera();
+
+    // the text renderer would discard these labels anyway, see TextRenderer::isVisible
+    const auto cullDistantLabels = !m_showOccludedOverlays;
+    if (
+      cullDistantLabels && renderContext.render2D()
+      && camera.zoom() < TextRenderer::DefaultMinZoomFactor)
+    {
+      return;
+    }
+
+    struct Label
+    {
+      const mdl::EntityNode* entityNode;
+      float distance;
+    };
 
+    auto labels = std::vector<Label>{};
     for (const auto* entityNode : m_entities)
     {
       if (m_showHiddenEntities || m_editorContext.visible(*entityNode))
@@ -296,20 +409,50 @@ void EntityRenderer::renderClassnames(
           !entityNode->containingGroup()
           || entityNode->containingGroup() == m_editorContext.currentGroup())
         {
-          if (m_showOccludedOverlays)
-          {
-            renderService.setShowOccludedObjects();
-          }
-          else
+          const auto anchor = EntityClassnameAnchor{entityNode};
+          const auto distance = camera.perpendicularDistanceTo(anchor.position(camera));
+          if (
+            distance > 0.0f
+            && !(
+              cullDistantLabels && renderContext.render3D()
+              && distance > TextRenderer::DefaultMaxViewDistance))
           {
-            renderService.setHideOccludedObjects();
+            labels.push_back({entityNode, distance});
           }
-
-          renderService.renderString(
-            entityString(entityNode), EntityClassnameAnchor{entityNode});
         }
       }
     }
+
+    // closer labels take precedence over labels that they overlap
+    std::ranges::stable_sort(labels, std::less<>{}, &Label::distance);
+
+    auto renderService = render::RenderService{renderContext, renderBatch};
+    renderService.setForegroundColor(m_overlayTextColor);
+    renderService.setBackgroundColor(m_overlayBackgroundColor);
+    if (m_showOccludedOverlays)
+    {
+      renderService.setShowOccludedObjects();
+    }
+    else
+    {
+      renderService.setHideOccludedObjects();
+    }
+
+    auto placement = LabelPlacement{camera.viewport()};
+    for (const auto& label : labels)
+    {
+      const auto anchor = EntityClassnameAnchor{label.entityNode};
+      const auto string = entityString(label.entityNode);
+      const auto size = renderService.measureString(string);
+      const auto offset = vm::vec2f{anchor.offset(camera, size)};
+
+      const auto bounds = vm::bbox2f{
+        offset - TextRenderer::DefaultInset, offset + size + TextRenderer::DefaultInset};
+      if (placement.place(bounds))
+      {
+        renderService.renderString(string, anchor);
+      }
+    }
   }
 }
 
@@ -424,6 +567,17 @@ auto makeColoredSolidBoundsVertexBuilder(
 
 void EntityRenderer::validateBounds()
 {
+  auto hasUnpreparedModels = false;
+  const auto hasModel = [&](const auto* entityNode) {
+    if (m_modelRenderer.hasUnpreparedModel(entityNode))
+    {
+      // render the bounds as a placeholder until the model is uploaded
+      hasUnpreparedModels = true;
+      return false;
+    }
+    return entityNode->entity().model() && entityNode->entity().model()->data();
+  };
+
   auto solidVertices = std::vector<GLVertexTypes::P3NC4::Vertex>{};
   solidVertices.reserve(36 * m_entities.size());
 
@@ -446,9 +600,7 @@ void EntityRenderer::validateBounds()
           entityNode->logicalBounds().for_each_edge(
             makeWireFrameBoundsVertexBuilder(pointEntityWireframeVertices));
 
-          const auto hasModel =
-            entityNode->entity().model() && entityNode->entity().model()->data();
-          if (!hasModel)
+          if (!hasModel(entityNode))
           {
             entityNode->logicalBounds().for_each_face(
               makeColoredSolidBoundsVertexBuilder(solidVertices, m_boundsColor));
@@ -487,9 +639,7 @@ void EntityRenderer::validateBounds()
             makeColoredWireFrameBoundsVertexBuilder(
               pointEntityWireframeVertices, boundsColor(entityNode)));
 
-          const auto hasModel =
-            entityNode->entity().model() && entityNode->entity().model()->data();
-          if (!hasModel)
+          if (!hasModel(entityNode))
           {
             entityNode->logicalBounds().for_each_face(makeColoredSolidBoundsVertexBuilder(
               solidVertices, boundsColor(entityNode)));
@@ -513,6 +663,9 @@ void EntityRenderer::validateBounds()
   m_solidBoundsRenderer =
     TriangleRenderer{VertexArray::move(std::move(solidVertices)), PrimType::Quads};
   m_boundsValid = true;
+  m_preparedModelRendererCount =
+    hasUnpreparedModels ? std::optional{m_entityModelManager.preparedRendererCount()}
+                        : std::nullopt;
 }
 
 AttrString EntityRenderer::entityString(const mdl::EntityNode* entityNode) const
@@ -27,6 +27,9 @@
 
 #include "kdl/vector_set.h"
 
+#include <memory>
+#include <optional>
+#include <unordered_set>
 #include <vector>
 
 namespace tb
@@ -60,6 +63,12 @@ private:
   EntityModelRenderer m_modelRenderer;
   bool m_boundsValid = false;
 
+  /**
+   * Set if the bounds were validated while some models were not uploaded yet, so that
+   * the bounds can be validated again once more models were uploaded.
+   */
+  std::optional<size_t> m_preparedModelRendererCount;
+
   bool m_showOverlays = true;
   Color m_overlayTextColor;
   Color m_overlayBackgroundColor;
@@ -130,6 +139,13 @@ public:
 
   void setShowHiddenEntities(bool showHiddenEntities);
 
+  /**
+   * Restricts rendering of entity models to the given entities. Bounds and overlays are
+   * rendered for all entities. If this is null, all entity models are rendered.
+   */
+  void setVisibleEntities(
+    std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities);
+
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
@@ -32,29 +32,85 @@
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
 
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace tb::render
 {
 
 namespace
 {
 
-class RenderFunc : public MaterialRenderFunc
+/**
+ * Sets the per-material uniforms, skipping the ones whose values didn't change since the
+ * previous material. Many materials share these values, so this saves most of the
+ * uniform uploads when rendering maps with many materials.
+ */
+class MaterialUniforms
 {
 private:
   ActiveShader& m_shader;
+  std::optional<bool> m_applyMaterial;
+  std::optional<Color> m_color;
+  std::optional<vm::vec3f> m_gridColor;
+  std::optional<bool> m_enableMasked;
+
+public:
+  explicit MaterialUniforms(ActiveShader& shader)
+    : m_shader{shader}
+  {
+  }
+
+  void setApplyMaterial(const bool applyMaterial)
+  {
+    set("ApplyMaterial", m_applyMaterial, applyMaterial);
+  }
+
+  void setColor(const Color& color) { set("Color", m_color, color); }
+
+  void setGridColor(const vm::vec3f& gridColor)
+  {
+    set("GridColor", m_gridColor, gridColor);
+  }
+
+  void setEnableMasked(const bool enableMasked)
+  {
+    set("EnableMasked", m_enableMasked, enableMasked);
+  }
+
+private:
+  template <typename T>
+  void set(const std::string_view name, std::optional<T>& currentValue, const T& value)
+  {
+    if (currentValue != value)
+    {
+      m_shader.set(name, value);
+      currentValue = value;
+    }
+  }
+};
+
+class RenderFunc : public MaterialRenderFunc
+{
+private:
+  MaterialUniforms& m_uniforms;
   bool m_applyMaterial;
   Color m_defaultColor;
   int m_minFilter;
   int m_magFilter;
+  std::optional<mdl::MaterialRenderState> m_renderState;
 
 public:
   RenderFunc(
-    ActiveShader& shader,
+    MaterialUniforms& uniforms,
     const bool applyMaterial,
     const Color& defaultColor,
     const int minFilter,
     const int magFilter)
-    : m_shader{shader}
+    : m_uniforms{uniforms}
     , m_applyMaterial{applyMaterial}
     , m_defaultColor{defaultColor}
     , m_minFilter{minFilter}
@@ -66,14 +122,17 @@ public:
   {
     if (const auto* texture = getTexture(material))
     {
-      material->activate(m_minFilter, m_magFilter);
-      m_shader.set("ApplyMaterial", m_applyMaterial);
-      m_shader.set("Color", texture->averageColor());
+      setRenderState(
+        material->activateTexture(m_minFilter, m_magFilter) ? &material->renderState()
+                                                             : nullptr);
+      m_uniforms.setApplyMaterial(m_applyMaterial);
+      m_uniforms.setColor(texture->averageColor());
     }
     else
     {
-      m_shader.set("ApplyMaterial", false);
-      m_shader.set("Color", m_defaultColor);
+      setRenderState(nullptr);
+      m_uniforms.setApplyMaterial(false);
+      m_uniforms.setColor(m_defaultColor);
     }
   }
 
@@ -81,11 +140,55 @@ public:
   {
     if (material)
     {
-      material->deactivate();
+      material->deactivateTexture();
+    }
+  }
+
+  void finish() { setRenderState(nullptr); }
+
+private:
+  /**
+   * Keeps the render state applied while consecutive materials share it.
+   */
+  void setRenderState(const mdl::MaterialRenderState* renderState)
+  {
+    if (m_renderState && (!renderState || *m_renderState != *renderState))
+    {
+      mdl::restoreRenderState(*m_renderState);
+      m_renderState = std::nullopt;
+    }
+    if (renderState && !m_renderState)
+    {
+      mdl::applyRenderState(*renderState);
+      m_renderState = *renderState;
     }
   }
 };
 
+/**
+ * Returns the entries of the given map so that materials with equal render states are
+ * adjacent.
+ */
+template <typename Map>
+auto sortByRenderState(const Map& map)
+{
+  static const auto defaultRenderState = mdl::MaterialRenderState{};
+  const auto renderState = [](const auto* entry) -> const mdl::MaterialRenderState& {
+    return entry->first ? entry->first->renderState() : defaultRenderState;
+  };
+
+  auto result = std::vector<const typename Map::value_type*>{};
+  result.reserve(map.size());
+  for (const auto& entry : map)
+  {
+    result.push_back(&entry);
+  }
+  std::ranges::sort(result, [&](const auto* lhs, const auto* rhs) {
+    return renderState(lhs) < renderState(rhs);
+  });
+  return result;
+}
+
 } // namespace
 
 FaceRenderer::FaceRenderer() = default;
@@ -120,6 +223,12 @@ void FaceRenderer::setAlpha(const float alpha)
   m_alpha = alpha;
 }
 
+void FaceRenderer::setIndexRanges(
+  std::shared_ptr<MaterialToBrushIndexRangesMap> indexRangesMap)
+{
+  m_indexRangesMap = std::move(indexRangesMap);
+}
+
 void FaceRenderer::render(RenderBatch& renderBatch)
 {
   renderBatch.add(this);
@@ -135,12 +244,33 @@ void FaceRenderer::prepareVerticesAndIndices(VboManager& vboManager)
   }
 }
 
+const std::vector<BrushIndexRange>* FaceRenderer::findIndexRanges(
+  const mdl::Material* material) const
+{
+  if (m_indexRangesMap)
+  {
+    if (const auto it = m_indexRangesMap->find(material); it != m_indexRangesMap->end())
+    {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+std::string FaceRenderer::profileLabel() const
+{
+  return "Faces";
+}
+
 void FaceRenderer::doRender(RenderContext& context)
 {
-  if (!m_indexArrayMap->empty() && m_vertexArray->setupVertices())
+  if (!m_indexArrayMap->empty())
   {
     auto& shaderManager = context.shaderManager();
     auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
+
+    // generic vertex attributes are looked up in the active shader
+    m_vertexArray->setupVertices();
     auto& prefs = PreferenceManager::instance();
 
     const auto applyMaterial = context.showMaterials();
@@ -165,7 +295,6 @@ void FaceRenderer::doRender(RenderContext& context)
     shader.set("ShadeFaces", shadeFaces);
     shader.set("ShowFog", showFog);
     shader.set("Alpha", m_alpha);
-    shader.set("EnableMasked", false);
     shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
     shader.set("SoftMapBoundsMin", context.softMapBounds().min);
     shader.set("SoftMapBoundsMax", context.softMapBounds().max);
@@ -173,8 +302,9 @@ void FaceRenderer::doRender(RenderContext& context)
       "SoftMapBoundsColor",
       vm::vec4f{prefs.get(Preferences::SoftMapBoundsColor).xyz(), 0.1f});
 
+    auto uniforms = MaterialUniforms{shader};
     auto func = RenderFunc{
-      shader,
+      uniforms,
       applyMaterial,
       m_faceColor,
       context.minFilterMode(),
@@ -184,24 +314,37 @@ void FaceRenderer::doRender(RenderContext& context)
     {
       glAssert(glDepthMask(GL_FALSE));
     }
-    for (const auto& [material, brushIndexHolderPtr] : *m_indexArrayMap)
+    for (const auto* entry : sortByRenderState(*m_indexArrayMap))
     {
-      if (brushIndexHolderPtr->hasValidIndices())
+      const auto& [material, brushIndexHolderPtr] = *entry;
+      const auto* indexRanges = findIndexRanges(material);
+      if (
+        brushIndexHolderPtr->hasValidIndices()
+        && (!m_indexRangesMap || indexRanges != nullptr))
       {
         const auto* texture = getTexture(material);
         const auto enableMasked = texture && texture->mask() == mdl::TextureMask::On;
 
         // set any per-material uniforms
-        shader.set("GridColor", gridColorForMaterial(material));
-        shader.set("EnableMasked", enableMasked);
+        uniforms.setGridColor(gridColorForMaterial(material));
+        uniforms.setEnableMasked(enableMasked);
 
         func.before(material);
         brushIndexHolderPtr->setupIndices();
-        brushIndexHolderPtr->render(PrimType::Triangles);
+        if (indexRanges)
+        {
+          brushIndexHolderPtr->render(PrimType::Triangles, *indexRanges);
+        }
+        else
+        {
+          brushIndexHolderPtr->render(PrimType::Triangles);
+        }
         brushIndexHolderPtr->cleanupIndices();
         func.after(material);
       }
     }
+    func.finish();
+
     if (m_alpha < 1.0f)
     {
       glAssert(glDepthMask(GL_TRUE));
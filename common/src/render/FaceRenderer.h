@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace tb::mdl
 {
@@ -33,6 +34,7 @@ class Material;
 namespace tb::render
 {
 class BrushIndexArray;
+struct BrushIndexRange;
 class BrushVertexArray;
 class RenderBatch;
 
@@ -41,9 +43,12 @@ class FaceRenderer : public IndexedRenderable
 private:
   using MaterialToBrushIndicesMap =
     const std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
+  using MaterialToBrushIndexRangesMap =
+    const std::unordered_map<const mdl::Material*, std::vector<BrushIndexRange>>;
 
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<MaterialToBrushIndicesMap> m_indexArrayMap;
+  std::shared_ptr<MaterialToBrushIndexRangesMap> m_indexRangesMap;
   Color m_faceColor;
   bool m_grayscale = false;
   bool m_tint = false;
@@ -62,9 +67,20 @@ public:
   void setTintColor(const Color& color);
   void setAlpha(float alpha);
 
+  /**
+   * Restricts rendering to the given index ranges per material. Materials without any
+   * ranges are skipped. If this is null, all indices are rendered.
+   */
+  void setIndexRanges(std::shared_ptr<MaterialToBrushIndexRangesMap> indexRangesMap);
+
   void render(RenderBatch& renderBatch);
 
+  std::string profileLabel() const override;
+
 private:
+  const std::vector<BrushIndexRange>* findIndexRanges(
+    const mdl::Material* material) const;
+
   void prepareVerticesAndIndices(VboManager& vboManager) override;
   void doRender(RenderContext& context) override;
 };
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatDepthFramebuffer.h"
+
+namespace tb::render
+{
+
+FloatDepthFramebuffer::FloatDepthFramebuffer() = default;
+
+FloatDepthFramebuffer::~FloatDepthFramebuffer()
+{
+  destroy();
+}
+
+bool FloatDepthFramebuffer::bind(
+  const GLsizei width, const GLsizei height, const GLsizei samples)
+{
+  if (
+    m_framebufferId == 0 || width != m_width || height != m_height
+    || samples != m_samples)
+  {
+    auto previousFramebufferId = GLint(0);
+    glAssert(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebufferId));
+
+    destroy();
+    if (!create(width, height, samples))
+    {
+      destroy();
+      glAssert(glBindFramebuffer(GL_FRAMEBUFFER, GLuint(previousFramebufferId)));
+      return false;
+    }
+  }
+
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferId));
+  return true;
+}
+
+void FloatDepthFramebuffer::blitTo(const GLuint framebufferId) const
+{
+  glAssert(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferId));
+  glAssert(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebufferId));
+  glAssert(glBlitFramebuffer(
+    0,
+    0,
+    m_width,
+    m_height,
+    0,
+    0,
+    m_width,
+    m_height,
+    GL_COLOR_BUFFER_BIT,
+    GL_NEAREST));
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, framebufferId));
+}
+
+bool FloatDepthFramebuffer::create(
+  const GLsizei width, const GLsizei height, const GLsizei samples)
+{
+  m_width = width;
+  m_height = height;
+  m_samples = samples;
+
+  const auto createRenderbuffer = [&](GLuint& renderbufferId, const GLenum format) {
+    glAssert(glGenRenderbuffers(1, &renderbufferId));
+    glAssert(glBindRenderbuffer(GL_RENDERBUFFER, renderbufferId));
+    glAssert(
+      glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, width, height));
+  };
+
+  createRenderbuffer(m_colorRenderbufferId, GL_RGBA8);
+  createRenderbuffer(m_depthRenderbufferId, GL_DEPTH_COMPONENT32F);
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  glAssert(glGenFramebuffers(1, &m_framebufferId));
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferId));
+  glAssert(glFramebufferRenderbuffer(
+    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbufferId));
+  glAssert(glFramebufferRenderbuffer(
+    GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbufferId));
+
+  auto status = GLenum(0);
+  glAssert(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+  return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void FloatDepthFramebuffer::destroy()
+{
+  if (m_framebufferId != 0)
+  {
+    glAssert(glDeleteFramebuffers(1, &m_framebufferId));
+    m_framebufferId = 0;
+  }
+  if (m_colorRenderbufferId != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_colorRenderbufferId));
+    m_colorRenderbufferId = 0;
+  }
+  if (m_depthRenderbufferId != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_depthRenderbufferId));
+    m_depthRenderbufferId = 0;
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "render/GL.h"
+
+namespace tb::render
+{
+
+/**
+ * An offscreen framebuffer with a floating point depth buffer.
+ *
+ * The default framebuffer of a view only has a fixed point depth buffer, which doesn't
+ * benefit from reverse depth (see glSetReverseDepth). A view that renders with reverse
+ * depth renders into this framebuffer instead and then copies the color buffer into its
+ * default framebuffer.
+ */
+class FloatDepthFramebuffer
+{
+private:
+  GLuint m_framebufferId = 0;
+  GLuint m_colorRenderbufferId = 0;
+  GLuint m_depthRenderbufferId = 0;
+  GLsizei m_width = 0;
+  GLsizei m_height = 0;
+  GLsizei m_samples = 0;
+
+public:
+  FloatDepthFramebuffer();
+  ~FloatDepthFramebuffer();
+
+  /**
+   * Binds this framebuffer for rendering. The buffers are recreated if the given size or
+   * number of samples differs from that of the previous call.
+   *
+   * Returns false if the driver cannot create the framebuffer. The previously bound
+   * framebuffer remains bound in that case.
+   */
+  bool bind(GLsizei width, GLsizei height, GLsizei samples);
+
+  /**
+   * Copies the color buffer of this framebuffer into the given framebuffer and binds the
+   * given framebuffer for rendering.
+   */
+  void blitTo(GLuint framebufferId) const;
+
+private:
+  bool create(GLsizei width, GLsizei height, GLsizei samples);
+  void destroy();
+
+  deleteCopyAndMove(FloatDepthFramebuffer);
+};
+
+} // namespace tb::render
@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FontCache.h"
+
+#include "io/CacheUtils.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cassert>
+#include <ostream>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto Magic = std::array<char, 4>{'T', 'B', 'F', 'C'};
+
+/**
+ * Must be incremented whenever the layout of the cache or the way that glyphs are
+ * rasterized changes.
+ */
+constexpr auto Version = std::uint32_t(1);
+
+constexpr auto NoGlyph = std::uint32_t(0xffffffff);
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read(io::Reader& reader)
+{
+  return reader.read<T, T>();
+}
+
+void writeKey(std::ostream& stream, const FontCacheKey& key)
+{
+  write(stream, key.fontDataSize);
+  write(stream, key.fontDataHash);
+  write(stream, std::uint32_t(key.fontSize));
+  write(stream, std::uint8_t(key.firstChar));
+  write(stream, std::uint8_t(key.charCount));
+}
+
+bool readKey(io::Reader& reader, const FontCacheKey& key)
+{
+  return read<std::uint64_t>(reader) == key.fontDataSize
+         && read<std::uint64_t>(reader) == key.fontDataHash
+         && read<std::uint32_t>(reader) == key.fontSize
+         && read<std::uint8_t>(reader) == key.firstChar
+         && read<std::uint8_t>(reader) == key.charCount;
+}
+
+} // namespace
+
+FontCacheKey makeFontCacheKey(
+  const std::string_view fontData,
+  const size_t fontSize,
+  const unsigned char firstChar,
+  const unsigned char charCount)
+{
+  return {
+    std::uint64_t(fontData.size()),
+    io::fnv1a(fontData.data(), fontData.data() + fontData.size()),
+    fontSize,
+    firstChar,
+    charCount};
+}
+
+std::filesystem::path fontCachePath(
+  const std::filesystem::path& cacheDirectory, const FontCacheKey& key)
+{
+  auto hash = io::fnv1a(key.fontDataSize, io::FnvOffsetBasis);
+  hash = io::fnv1a(key.fontDataHash, hash);
+  hash = io::fnv1a(std::uint64_t(key.fontSize), hash);
+  hash = io::fnv1a(key.firstChar, hash);
+  hash = io::fnv1a(key.charCount, hash);
+  return cacheDirectory / fmt::format("{:016x}.tbfont", hash);
+}
+
+void writeFontCache(
+  std::ostream& stream, const FontCacheKey& key, const FontAtlas& atlas)
+{
+  assert(atlas.advances.size() == key.charCount);
+  assert(atlas.pixels.size() == atlas.textureSize * atlas.textureSize);
+
+  stream.write(Magic.data(), Magic.size());
+  write(stream, Version);
+  writeKey(stream, key);
+
+  write(stream, std::uint32_t(atlas.ascend));
+  write(stream, std::uint32_t(atlas.descend));
+  write(stream, std::uint32_t(atlas.lineHeight));
+  write(stream, std::uint32_t(atlas.cellSize));
+  for (const auto& advance : atlas.advances)
+  {
+    write(stream, advance ? std::uint32_t(*advance) : NoGlyph);
+  }
+
+  write(stream, std::uint32_t(atlas.textureSize));
+  stream.write(atlas.pixels.data(), std::streamsize(atlas.pixels.size()));
+
+  // marks the end so that a truncated cache is detected
+  stream.write(Magic.data(), Magic.size());
+}
+
+Result<FontAtlas> readFontCache(io::Reader reader, const FontCacheKey& key)
+{
+  try
+  {
+    auto magic = std::array<char, 4>{};
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Not a font cache"};
+    }
+
+    if (const auto version = read<std::uint32_t>(reader); version != Version)
+    {
+      return Error{fmt::format("Unsupported font cache version {}", version)};
+    }
+
+    if (!readKey(reader, key))
+    {
+      return Error{"Font cache is out of date"};
+    }
+
+    auto atlas = FontAtlas{};
+    atlas.ascend = read<std::uint32_t>(reader);
+    atlas.descend = read<std::uint32_t>(reader);
+    atlas.lineHeight = read<std::uint32_t>(reader);
+    atlas.cellSize = read<std::uint32_t>(reader);
+
+    atlas.advances.reserve(key.charCount);
+    for (size_t i = 0; i < key.charCount; ++i)
+    {
+      const auto advance = read<std::uint32_t>(reader);
+      atlas.advances.push_back(
+        advance != NoGlyph ? std::optional{size_t(advance)} : std::nullopt);
+    }
+
+    atlas.textureSize = read<std::uint32_t>(reader);
+    const auto pixelCount = atlas.textureSize * atlas.textureSize;
+    if (!reader.canRead(pixelCount))
+    {
+      throw io::ReaderException{
+        fmt::format("Invalid texture size {}", atlas.textureSize)};
+    }
+
+    atlas.pixels.resize(pixelCount);
+    reader.read(atlas.pixels.data(), atlas.pixels.size());
+
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Font cache is truncated"};
+    }
+
+    return atlas;
+  }
+  catch (const io::ReaderException& e)
+  {
+    return Error{fmt::format("Invalid font cache: {}", e.what())};
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace tb::io
+{
+class Reader;
+}
+
+namespace tb::render
+{
+
+/**
+ * A font cache is a binary file that stores the rasterized glyphs of a font, so that the
+ * glyphs don't need to be rasterized again when the font is loaded the next time.
+ *
+ * The font file is identified by its size and a hash of its contents. The cache stores a
+ * format version and the key, and it is rejected if either doesn't match.
+ */
+struct FontCacheKey
+{
+  std::uint64_t fontDataSize = 0;
+  std::uint64_t fontDataHash = 0;
+  size_t fontSize = 0;
+  unsigned char firstChar = 0;
+  unsigned char charCount = 0;
+
+  auto operator<=>(const FontCacheKey& other) const = default;
+};
+
+FontCacheKey makeFontCacheKey(
+  std::string_view fontData,
+  size_t fontSize,
+  unsigned char firstChar,
+  unsigned char charCount);
+
+/**
+ * The rasterized glyphs of a font together with the font metrics.
+ *
+ * The glyphs are stored in cells of the given size which are laid out in the texture in
+ * the order of their characters. A character without a glyph has no advance and no cell.
+ */
+struct FontAtlas
+{
+  size_t ascend = 0;
+  size_t descend = 0;
+  size_t lineHeight = 0;
+  size_t cellSize = 0;
+  std::vector<std::optional<size_t>> advances;
+  size_t textureSize = 0;
+  std::vector<char> pixels;
+
+  auto operator<=>(const FontAtlas& other) const = default;
+};
+
+/**
+ * Returns the path of the cache file for the given key.
+ */
+std::filesystem::path fontCachePath(
+  const std::filesystem::path& cacheDirectory, const FontCacheKey& key);
+
+/**
+ * Writes a cache for the given atlas to the given stream.
+ */
+void writeFontCache(
+  std::ostream& stream, const FontCacheKey& key, const FontAtlas& atlas);
+
+/**
+ * Reads an atlas from the given cache.
+ *
+ * Returns an error if the cache is malformed, if it was written by a different version
+ * of the cache format, or if it was written for a different key.
+ */
+Result<FontAtlas> readFontCache(io::Reader reader, const FontCacheKey& key);
+
+} // namespace tb::render
@@ -23,24 +23,33 @@ namespace tb::render
 {
 
 FontGlyph::FontGlyph(
-  const size_t x, const size_t y, const size_t w, const size_t h, const size_t a)
+  const size_t x,
+  const size_t y,
+  const size_t w,
+  const size_t h,
+  const size_t a,
+  const size_t padding)
   : m_x{static_cast<float>(x)}
   , m_y{static_cast<float>(y)}
   , m_w{static_cast<float>(w)}
   , m_h{static_cast<float>(h)}
+  , m_padding{static_cast<float>(padding)}
   , m_a{static_cast<int>(a)}
 {
 }
 
 void FontGlyph::appendVertices(
   std::vector<vm::vec2f>& vertices,
-  const int xOffset,
-  const int yOffset,
+  const float xOffset,
+  const float yOffset,
   const size_t textureSize,
+  const float scale,
   const bool clockwise) const
 {
-  const auto fxOffset = static_cast<float>(xOffset);
-  const auto fyOffset = static_cast<float>(yOffset);
+  const auto fxOffset = xOffset - m_padding * scale;
+  const auto fyOffset = yOffset - m_padding * scale;
+  const auto w = m_w * scale;
+  const auto h = m_h * scale;
   const auto ftextureSize = static_cast<float>(textureSize);
 
   if (clockwise)
@@ -48,13 +57,13 @@ void FontGlyph::appendVertices(
     vertices.emplace_back(fxOffset, fyOffset);
     vertices.push_back(vm::vec2f{m_x, m_y + m_h} / ftextureSize);
 
-    vertices.emplace_back(fxOffset, fyOffset + m_h);
+    vertices.emplace_back(fxOffset, fyOffset + h);
     vertices.push_back(vm::vec2f{m_x, m_y} / ftextureSize);
 
-    vertices.emplace_back(fxOffset + m_w, fyOffset + m_h);
+    vertices.emplace_back(fxOffset + w, fyOffset + h);
     vertices.push_back(vm::vec2f{m_x + m_w, m_y} / ftextureSize);
 
-    vertices.emplace_back(fxOffset + m_w, fyOffset);
+    vertices.emplace_back(fxOffset + w, fyOffset);
     vertices.push_back(vm::vec2f{m_x + m_w, m_y + m_h} / ftextureSize);
   }
   else
@@ -62,13 +71,13 @@ void FontGlyph::appendVertices(
     vertices.emplace_back(fxOffset, fyOffset);
     vertices.push_back(vm::vec2f{m_x, m_y + m_h} / ftextureSize);
 
-    vertices.emplace_back(fxOffset + m_w, fyOffset);
+    vertices.emplace_back(fxOffset + w, fyOffset);
     vertices.push_back(vm::vec2f{m_x + m_w, m_y + m_h} / ftextureSize);
 
-    vertices.emplace_back(fxOffset + m_w, fyOffset + m_h);
+    vertices.emplace_back(fxOffset + w, fyOffset + h);
     vertices.push_back(vm::vec2f{m_x + m_w, m_y} / ftextureSize);
 
-    vertices.emplace_back(fxOffset, fyOffset + m_h);
+    vertices.emplace_back(fxOffset, fyOffset + h);
     vertices.push_back(vm::vec2f{m_x, m_y} / ftextureSize);
   }
 }
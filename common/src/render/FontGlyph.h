@@ -26,6 +26,11 @@
 namespace tb::render
 {
 
+/**
+ * A glyph in a font texture. The glyph's cell in the texture may be surrounded by a
+ * padding which is drawn outside of the glyph's quad origin, e.g. to make room for the
+ * falloff of a signed distance field.
+ */
 class FontGlyph
 {
 private:
@@ -33,16 +38,22 @@ private:
   float m_y;
   float m_w;
   float m_h;
+  float m_padding;
   int m_a;
 
 public:
-  FontGlyph(size_t x, size_t y, size_t w, size_t h, size_t a);
+  FontGlyph(size_t x, size_t y, size_t w, size_t h, size_t a, size_t padding = 0);
 
+  /**
+   * Appends the vertices of this glyph's quad to the given vertices. The quad is scaled
+   * by the given factor.
+   */
   void appendVertices(
     std::vector<vm::vec2f>& vertices,
-    int xOffset,
-    int yOffset,
+    float xOffset,
+    float yOffset,
     size_t textureSize,
+    float scale,
     bool clockwise) const;
   int advance() const;
 };
@@ -23,8 +23,9 @@
 #include "render/FontGlyph.h"
 #include "render/FontTexture.h"
 
-#include <cassert>
-#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 namespace tb::render
 {
@@ -51,17 +52,30 @@ FontGlyph FontGlyphBuilder::createGlyph(
   const char* glyphBuffer,
   const size_t pitch)
 {
+  nextCell();
+  drawGlyph(left, top, width, height, glyphBuffer, pitch);
+  return addGlyph(advance);
+}
+
+FontGlyph FontGlyphBuilder::addGlyph(const size_t advance)
+{
+  nextCell();
+
+  const auto paddedCellSize = m_cellSize + 2 * Spread;
+  const auto glyph =
+    FontGlyph{m_x, m_y, paddedCellSize, paddedCellSize, advance, Spread};
+  m_x += paddedCellSize + m_margin;
+  return glyph;
+}
 
-  if (m_x + m_cellSize + m_margin > m_textureSize)
+void FontGlyphBuilder::nextCell()
+{
+  const auto paddedCellSize = m_cellSize + 2 * Spread;
+  if (m_x + paddedCellSize + m_margin > m_textureSize)
   {
     m_x = m_margin;
-    m_y += m_cellSize + m_margin;
+    m_y += paddedCellSize + m_margin;
   }
-
-  drawGlyph(left, top, width, height, glyphBuffer, pitch);
-  const auto glyph = FontGlyph{m_x, m_y, m_cellSize, m_cellSize, advance};
-  m_x += m_cellSize + m_margin;
-  return glyph;
 }
 
 void FontGlyphBuilder::drawGlyph(
@@ -72,14 +86,46 @@ void FontGlyphBuilder::drawGlyph(
   const char* glyphBuffer,
   const size_t pitch)
 {
-  const auto x = m_x + left;
-  const auto y = m_y + m_maxAscend - top;
+  // the glyph bitmap's position in the padded cell, left may be negative
+  const auto glyphX = int(Spread) + int(left);
+  const auto glyphY = int(Spread) + int(m_maxAscend) - int(top);
 
-  for (size_t r = 0; r < height; ++r)
+  const auto isInside = [&](const int x, const int y) {
+    const auto bx = x - glyphX;
+    const auto by = y - glyphY;
+    return bx >= 0 && by >= 0 && bx < int(width) && by < int(height)
+           && uint8_t(glyphBuffer[size_t(by) * pitch + size_t(bx)]) >= 128;
+  };
+
+  const auto spread = int(Spread);
+  const auto paddedCellSize = int(m_cellSize + 2 * Spread);
+  for (int y = 0; y < paddedCellSize; ++y)
   {
-    const auto index = (r + y) * m_textureSize + x;
-    assert(index + width < m_textureSize * m_textureSize);
-    std::memcpy(m_textureBuffer + index, glyphBuffer + r * pitch, width);
+    for (int x = 0; x < paddedCellSize; ++x)
+    {
+      // find the closest texel whose state differs from this texel's state
+      const auto inside = isInside(x, y);
+      auto minSquaredDistance = spread * spread;
+      for (int dy = -spread; dy <= spread; ++dy)
+      {
+        for (int dx = -spread; dx <= spread; ++dx)
+        {
+          if (isInside(x + dx, y + dy) != inside)
+          {
+            minSquaredDistance = std::min(minSquaredDistance, dx * dx + dy * dy);
+          }
+        }
+      }
+
+      // the outline runs halfway between the texels
+      const auto distance = std::sqrt(float(minSquaredDistance)) - 0.5f;
+      const auto signedDistance = inside ? distance : -distance;
+      const auto value =
+        std::clamp(0.5f + signedDistance / (2.0f * float(Spread)), 0.0f, 1.0f);
+
+      const auto index = (m_y + size_t(y)) * m_textureSize + m_x + size_t(x);
+      m_textureBuffer[index] = char(uint8_t(std::round(value * 255.0f)));
+    }
   }
 }
 
@@ -26,8 +26,16 @@ namespace tb::render
 class FontGlyph;
 class FontTexture;
 
+/**
+ * Draws glyphs into a font texture as signed distance fields. Every glyph cell is padded
+ * by the spread of the distance field. A texel stores 0.5 on the outline of a glyph and
+ * changes by 0.5 / Spread per texel of distance, increasing towards the inside.
+ */
 class FontGlyphBuilder
 {
+public:
+  static constexpr size_t Spread = 4;
+
 private:
   size_t m_maxAscend;
   size_t m_cellSize;
@@ -51,7 +59,14 @@ public:
     const char* glyphBuffer,
     size_t pitch);
 
+  /**
+   * Returns the glyph in the next cell without drawing it. This is used for a texture
+   * whose glyphs were drawn before, e.g. one that was loaded from a font cache.
+   */
+  FontGlyph addGlyph(size_t advance);
+
 private:
+  void nextCell();
   void drawGlyph(
     size_t left,
     size_t top,
@@ -24,12 +24,20 @@
 #include "render/TextureFont.h"
 
 #include <string>
+#include <utility>
 
 namespace tb::render
 {
+namespace
+{
+
+// The pixel size at which the distance field atlases are rendered.
+constexpr auto AtlasFontSize = size_t(32);
+
+} // namespace
 
-FontManager::FontManager()
-  : m_factory{std::make_unique<FreeTypeFontFactory>()}
+FontManager::FontManager(std::optional<std::filesystem::path> cacheDirectory)
+  : m_factory{std::make_unique<FreeTypeFontFactory>(std::move(cacheDirectory))}
 {
 }
 
@@ -38,6 +46,7 @@ FontManager::~FontManager() = default;
 void FontManager::clearCache()
 {
   m_cache.clear();
+  m_atlasCache.clear();
 }
 
 TextureFont& FontManager::font(const FontDescriptor& fontDescriptor)
@@ -45,7 +54,26 @@ TextureFont& FontManager::font(const FontDescriptor& fontDescriptor)
   auto it = m_cache.lower_bound(fontDescriptor);
   if (it == std::end(m_cache) || it->first != fontDescriptor)
   {
-    it = m_cache.insert(it, {fontDescriptor, m_factory->createFont(fontDescriptor)});
+    const auto scale = float(fontDescriptor.size()) / float(AtlasFontSize);
+    it = m_cache.insert(it, {fontDescriptor, atlas(fontDescriptor).scaled(scale)});
+  }
+
+  return *it->second;
+}
+
+TextureFont& FontManager::atlas(const FontDescriptor& fontDescriptor)
+{
+  const auto atlasDescriptor = FontDescriptor{
+    fontDescriptor.path(),
+    AtlasFontSize,
+    fontDescriptor.minChar(),
+    fontDescriptor.maxChar()};
+
+  auto it = m_atlasCache.lower_bound(atlasDescriptor);
+  if (it == std::end(m_atlasCache) || it->first != atlasDescriptor)
+  {
+    it = m_atlasCache.insert(
+      it, {atlasDescriptor, m_factory->createFont(atlasDescriptor)});
   }
 
   return *it->second;
@@ -21,8 +21,10 @@
 
 #include "Macros.h"
 
+#include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace tb::render
@@ -31,14 +33,25 @@ class FontDescriptor;
 class FontFactory;
 class TextureFont;
 
+/**
+ * Creates and caches fonts. The glyphs of a font are rendered once as a signed distance
+ * field atlas, and fonts of all sizes are scaled from that atlas, so changing the font
+ * size does not create a new font texture.
+ */
 class FontManager
 {
 private:
   std::unique_ptr<FontFactory> m_factory;
+  std::map<FontDescriptor, std::unique_ptr<TextureFont>> m_atlasCache;
   std::map<FontDescriptor, std::unique_ptr<TextureFont>> m_cache;
 
 public:
-  FontManager();
+  /**
+   * If a cache directory is given, the rasterized glyphs of the fonts are stored there so
+   * that they don't need to be rasterized again on the next start.
+   */
+  explicit FontManager(
+    std::optional<std::filesystem::path> cacheDirectory = std::nullopt);
   ~FontManager();
 
   TextureFont& font(const FontDescriptor& fontDescriptor);
@@ -50,6 +63,9 @@ public:
   void clearCache();
 
   deleteCopyAndMove(FontManager);
+
+private:
+  TextureFont& atlas(const FontDescriptor& fontDescriptor);
 };
 
 } // namespace tb::render
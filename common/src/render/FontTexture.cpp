@@ -20,6 +20,7 @@
 #include "FontTexture.h"
 
 #include "Ensure.h"
+#include "render/RenderProfiler.h"
 
 #include <cassert>
 #include <cstring>
@@ -37,6 +38,14 @@ FontTexture::FontTexture(
   std::memset(m_buffer.get(), 0, m_size * m_size);
 }
 
+FontTexture::FontTexture(const size_t size, const std::vector<char>& pixels)
+  : m_size{size}
+  , m_buffer{std::make_unique<char[]>(m_size * m_size)}
+{
+  ensure(pixels.size() == m_size * m_size, "pixels match texture size");
+  std::memcpy(m_buffer.get(), pixels.data(), pixels.size());
+}
+
 FontTexture::FontTexture(const FontTexture& other)
   : m_size{other.m_size}
   , m_buffer{std::make_unique<char[]>(m_size * m_size)}
@@ -71,6 +80,12 @@ size_t FontTexture::size() const
   return m_size;
 }
 
+std::vector<char> FontTexture::pixels() const
+{
+  return m_buffer ? std::vector<char>(m_buffer.get(), m_buffer.get() + m_size * m_size)
+                  : std::vector<char>{};
+}
+
 void FontTexture::activate()
 {
   if (m_textureId == 0)
@@ -92,11 +107,13 @@ void FontTexture::activate()
       GL_LUMINANCE,
       GL_UNSIGNED_BYTE,
       m_buffer.get()));
+    currentStateChangeCounts().uploadedBytes += m_size * m_size;
     m_buffer.release();
   }
 
   assert(m_textureId > 0);
   glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+  ++currentStateChangeCounts().textureBinds;
 }
 
 void FontTexture::deactivate()
@@ -107,7 +124,14 @@ void FontTexture::deactivate()
 size_t FontTexture::computeTextureSize(
   const size_t cellCount, const size_t cellSize, const size_t margin) const
 {
-  const auto minTextureSize = margin + cellCount * (cellSize + margin);
+  // the cells are arranged in a square
+  auto cellsPerRow = size_t(1);
+  while (cellsPerRow * cellsPerRow < cellCount)
+  {
+    ++cellsPerRow;
+  }
+
+  const auto minTextureSize = margin + cellsPerRow * (cellSize + margin);
   size_t textureSize = 1;
   while (textureSize < minTextureSize)
   {
@@ -22,6 +22,7 @@
 #include "render/GL.h"
 
 #include <memory>
+#include <vector>
 
 namespace tb::render
 {
@@ -39,6 +40,12 @@ private:
 public:
   FontTexture();
   FontTexture(size_t cellCount, size_t cellSize, size_t margin);
+
+  /**
+   * Creates a texture of the given width and height from the given pixels, which store
+   * one byte per pixel.
+   */
+  FontTexture(size_t size, const std::vector<char>& pixels);
   FontTexture(const FontTexture& other);
   FontTexture(FontTexture&& other);
   FontTexture& operator=(FontTexture other);
@@ -46,6 +53,12 @@ public:
 
   size_t size() const;
 
+  /**
+   * Returns the pixels of this texture, or an empty vector if the texture was already
+   * uploaded.
+   */
+  std::vector<char> pixels() const;
+
   void activate();
   void deactivate();
 
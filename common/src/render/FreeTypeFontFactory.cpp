@@ -20,10 +20,11 @@
 #include "FreeTypeFontFactory.h"
 
 #include "Exceptions.h"
-#include "Macros.h"
+#include "io/CacheUtils.h"
 #include "io/DiskIO.h"
 #include "io/Reader.h"
 #include "io/SystemPaths.h"
+#include "render/FontCache.h"
 #include "render/FontDescriptor.h"
 #include "render/FontGlyph.h"
 #include "render/FontGlyphBuilder.h"
@@ -31,7 +32,10 @@
 #include "render/TextureFont.h"
 
 #include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace tb::render
 {
@@ -95,64 +99,127 @@ FontFactory::Metrics computeMetrics(FT_Face face)
   return {cellSize, ascend, descend, lineHeight};
 }
 
-std::unique_ptr<TextureFont> buildFont(
+FontAtlas rasterizeFont(
   FT_Face face, const unsigned char firstChar, const unsigned char charCount)
 {
   const auto metrics = computeMetrics(face);
 
-  auto texture =
-    std::make_unique<FontTexture>(charCount, metrics.cellSize, metrics.lineHeight);
-  auto glyphBuilder = FontGlyphBuilder{metrics.ascend, metrics.cellSize, 3, *texture};
+  auto texture = FontTexture{
+    charCount, metrics.cellSize + 2 * FontGlyphBuilder::Spread, metrics.lineHeight};
+  auto glyphBuilder = FontGlyphBuilder{metrics.ascend, metrics.cellSize, 3, texture};
 
   const auto glyph = face->glyph;
-  auto glyphs = std::vector<FontGlyph>{};
+  auto advances = std::vector<std::optional<size_t>>{};
   for (unsigned char c = firstChar; c < firstChar + charCount; ++c)
   {
     if (FT_Load_Char(face, FT_ULong(c), FT_LOAD_RENDER) == 0)
     {
-      glyphs.push_back(glyphBuilder.createGlyph(
+      glyphBuilder.createGlyph(
         size_t(glyph->bitmap_left),
         size_t(glyph->bitmap_top),
         size_t(glyph->bitmap.width),
         size_t(glyph->bitmap.rows),
         size_t(glyph->advance.x >> 6),
         reinterpret_cast<char*>(glyph->bitmap.buffer),
-        size_t(glyph->bitmap.pitch)));
+        size_t(glyph->bitmap.pitch));
+      advances.emplace_back(size_t(glyph->advance.x >> 6));
     }
     else
     {
-      glyphs.emplace_back(0, 0, 0, 0, 0);
+      advances.emplace_back(std::nullopt);
     }
   }
 
+  return FontAtlas{
+    metrics.ascend,
+    metrics.descend,
+    metrics.lineHeight,
+    metrics.cellSize,
+    std::move(advances),
+    texture.size(),
+    texture.pixels()};
+}
+
+std::unique_ptr<TextureFont> buildFont(
+  const FontAtlas& atlas, const unsigned char firstChar, const unsigned char charCount)
+{
+  auto texture = std::make_unique<FontTexture>(atlas.textureSize, atlas.pixels);
+  auto glyphBuilder = FontGlyphBuilder{atlas.ascend, atlas.cellSize, 3, *texture};
+
+  // the glyphs were drawn into the texture in the same order when the atlas was created
+  auto glyphs = std::vector<FontGlyph>{};
+  for (const auto& advance : atlas.advances)
+  {
+    glyphs.push_back(
+      advance ? glyphBuilder.addGlyph(*advance) : FontGlyph{0, 0, 0, 0, 0});
+  }
+
   return std::make_unique<TextureFont>(
     std::move(texture),
     glyphs,
-    int(metrics.ascend),
-    int(metrics.descend),
-    int(metrics.lineHeight),
+    int(atlas.ascend),
+    int(atlas.descend),
+    int(atlas.lineHeight),
     firstChar,
     charCount);
 }
 
+/**
+ * Failing to write the cache is not an error, since the glyphs are just rasterized again
+ * the next time the font is loaded.
+ */
+void writeCache(
+  const std::filesystem::path& cachePath,
+  const FontCacheKey& key,
+  const FontAtlas& atlas)
+{
+  io::writeCacheEntry(cachePath, [&](auto& stream) {
+    writeFontCache(stream, key, atlas);
+  }) | kdl::transform_error([](const auto&) {});
+}
+
 } // namespace
 
-FreeTypeFontFactory::FreeTypeFontFactory()
+FreeTypeFontFactory::FreeTypeFontFactory(
+  std::optional<std::filesystem::path> cacheDirectory)
   : m_library{initializeFreeType()}
+  , m_cacheDirectory{std::move(cacheDirectory)}
 {
 }
 
 std::unique_ptr<TextureFont> FreeTypeFontFactory::doCreateFont(
   const FontDescriptor& fontDescriptor)
 {
+  // NOTE: bufferedReader is returned from loadFont() to keep the buffer from being
+  // deallocated until after we call FT_Done_Face, and its contents identify the font in
+  // the cache
   auto [face, bufferedReader] = loadFont(*m_library, fontDescriptor);
-  auto font = buildFont(*face, fontDescriptor.minChar(), fontDescriptor.charCount());
+  const auto firstChar = fontDescriptor.minChar();
+  const auto charCount = fontDescriptor.charCount();
 
-  // NOTE: bufferedReader is returned from loadFont() just to keep the buffer from
-  // being deallocated until after we call FT_Done_Face
-  unused(bufferedReader);
+  if (!m_cacheDirectory)
+  {
+    return buildFont(rasterizeFont(*face, firstChar, charCount), firstChar, charCount);
+  }
 
-  return font;
+  const auto key = makeFontCacheKey(
+    std::string_view{bufferedReader.begin(), bufferedReader.size()},
+    fontDescriptor.size(),
+    firstChar,
+    charCount);
+  const auto cachePath = fontCachePath(*m_cacheDirectory, key);
+
+  const auto atlas =
+    io::Disk::mapFile(cachePath)
+    | kdl::and_then([&](const auto& file) { return readFontCache(file->reader(), key); })
+    | kdl::or_else([&](const auto&) -> Result<FontAtlas> {
+        auto rasterizedAtlas = rasterizeFont(*face, firstChar, charCount);
+        writeCache(cachePath, key, rasterizedAtlas);
+        return rasterizedAtlas;
+      })
+    | kdl::value();
+
+  return buildFont(atlas, firstChar, charCount);
 }
 
 } // namespace tb::render
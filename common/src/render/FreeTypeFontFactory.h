@@ -26,7 +26,9 @@
 
 #include "kdl/resource.h"
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace tb::render
 {
@@ -38,8 +40,15 @@ class FreeTypeFontFactory : public FontFactory
 private:
   kdl::resource<FT_Library> m_library;
 
+  /**
+   * If set, the rasterized glyphs of a font are stored in this directory and loaded from
+   * it instead of rasterizing them again.
+   */
+  std::optional<std::filesystem::path> m_cacheDirectory;
+
 public:
-  FreeTypeFontFactory();
+  explicit FreeTypeFontFactory(
+    std::optional<std::filesystem::path> cacheDirectory = std::nullopt);
 
 private:
   std::unique_ptr<TextureFont> doCreateFont(
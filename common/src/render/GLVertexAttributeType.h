@@ -26,6 +26,11 @@
 
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
 namespace tb::render
 {
 /**
@@ -72,6 +77,11 @@ public:
 
     const auto attributeIndex = program->findAttributeLocation(A::name);
     glAssert(glDisableVertexAttribArray(static_cast<GLuint>(attributeIndex)));
+
+    // the current value of the attribute is undefined after drawing from the array, but
+    // shaders read it when they are used with vertex arrays that don't provide it
+    glAssert(
+      glVertexAttrib4f(static_cast<GLuint>(attributeIndex), 0.0f, 0.0f, 0.0f, 1.0f));
   }
 
   // Non-instantiable
@@ -153,6 +163,60 @@ public:
   deleteCopyAndMove(GLVertexAttributeNormal);
 };
 
+/**
+ * Compact vertex normal attribute types. The normal is stored as three signed integer
+ * components which OpenGL maps to [-1..1], and a fourth unused component which keeps the
+ * following attributes aligned.
+ *
+ * @tparam D the vertex component type, must be a signed integer type
+ */
+template <GLenum D>
+class GLVertexAttributePackedNormal
+{
+public:
+  using ComponentType = typename GLType<D>::Type;
+  using ElementType = vm::vec<ComponentType, 4>;
+  static const size_t Size = sizeof(ElementType);
+
+  static_assert(std::is_signed_v<ComponentType> && std::is_integral_v<ComponentType>);
+
+  /**
+   * Converts the given unit length normal to its packed representation.
+   */
+  static ElementType pack(const vm::vec3f& normal)
+  {
+    constexpr auto max = float(std::numeric_limits<ComponentType>::max());
+    const auto packComponent = [&](const float c) {
+      return static_cast<ComponentType>(std::round(std::clamp(c, -1.0f, 1.0f) * max));
+    };
+    return {
+      packComponent(normal.x()),
+      packComponent(normal.y()),
+      packComponent(normal.z()),
+      ComponentType(0)};
+  }
+
+  static void setup(
+    ShaderProgram* /* program */,
+    const size_t /* index */,
+    const size_t stride,
+    const size_t offset)
+  {
+    glAssert(glEnableClientState(GL_NORMAL_ARRAY));
+    glAssert(glNormalPointer(
+      D, static_cast<GLsizei>(stride), reinterpret_cast<GLvoid*>(offset)));
+  }
+
+  static void cleanup(ShaderProgram* /* program */, const size_t /* index */)
+  {
+    glAssert(glDisableClientState(GL_NORMAL_ARRAY));
+  }
+
+  // Non-instantiable
+  GLVertexAttributePackedNormal() = delete;
+  deleteCopyAndMove(GLVertexAttributePackedNormal);
+};
+
 /**
  * Vertex color attribute types.
  *
@@ -236,6 +300,7 @@ namespace GLVertexAttributeTypes
 using P2 = GLVertexAttributePosition<GL_FLOAT, 2>;
 using P3 = GLVertexAttributePosition<GL_FLOAT, 3>;
 using N = GLVertexAttributeNormal<GL_FLOAT, 3>;
+using NB = GLVertexAttributePackedNormal<GL_BYTE>;
 using UV02 = GLVertexAttributeUVCoord0<GL_FLOAT, 2>;
 using C4 = GLVertexAttributeColor<GL_FLOAT, 4>;
 } // namespace GLVertexAttributeTypes
@@ -194,6 +194,10 @@ using P3NT2 = GLVertexType<
   GLVertexAttributeTypes::P3,
   GLVertexAttributeTypes::N,
   GLVertexAttributeTypes::UV02>;
+using P3NBT2 = GLVertexType<
+  GLVertexAttributeTypes::P3,
+  GLVertexAttributeTypes::NB,
+  GLVertexAttributeTypes::UV02>;
 } // namespace GLVertexTypes
 
 } // namespace tb::render
@@ -34,42 +34,20 @@ namespace tb::render
 {
 GridRenderer::GridRenderer(
   const OrthographicCamera& camera, const vm::bbox3d& worldBounds)
-  : m_vertexArray(VertexArray::move(vertices(camera, worldBounds)))
+  : m_camera{camera}
+  , m_worldBounds{worldBounds}
+  , m_vertexArray{VertexArray::move(std::vector<Vertex>{
+      Vertex{vm::vec2f{-1.0f, -1.0f}},
+      Vertex{vm::vec2f{-1.0f, +1.0f}},
+      Vertex{vm::vec2f{+1.0f, +1.0f}},
+      Vertex{vm::vec2f{+1.0f, -1.0f}},
+    })}
 {
 }
 
-std::vector<GridRenderer::Vertex> GridRenderer::vertices(
-  const OrthographicCamera& camera, const vm::bbox3d& worldBounds)
+void GridRenderer::setWorldBounds(const vm::bbox3d& worldBounds)
 {
-  const auto& viewport = camera.zoomedViewport();
-  const auto w = float(viewport.width) / 2.0f;
-  const auto h = float(viewport.height) / 2.0f;
-
-  const auto& p = camera.position();
-  switch (vm::find_abs_max_component(camera.direction()))
-  {
-  case vm::axis::x:
-    return {
-      Vertex{vm::vec3f{float(worldBounds.min.x()), p.y() - w, p.z() - h}},
-      Vertex{vm::vec3f{float(worldBounds.min.x()), p.y() - w, p.z() + h}},
-      Vertex{vm::vec3f{float(worldBounds.min.x()), p.y() + w, p.z() + h}},
-      Vertex{vm::vec3f{float(worldBounds.min.x()), p.y() + w, p.z() - h}}};
-  case vm::axis::y:
-    return {
-      Vertex{vm::vec3f{p.x() - w, float(worldBounds.max.y()), p.z() - h}},
-      Vertex{vm::vec3f{p.x() - w, float(worldBounds.max.y()), p.z() + h}},
-      Vertex{vm::vec3f{p.x() + w, float(worldBounds.max.y()), p.z() + h}},
-      Vertex{vm::vec3f{p.x() + w, float(worldBounds.max.y()), p.z() - h}}};
-  case vm::axis::z:
-    return {
-      Vertex{vm::vec3f{p.x() - w, p.y() - h, float(worldBounds.min.z())}},
-      Vertex{vm::vec3f{p.x() - w, p.y() + h, float(worldBounds.min.z())}},
-      Vertex{vm::vec3f{p.x() + w, p.y() + h, float(worldBounds.min.z())}},
-      Vertex{vm::vec3f{p.x() + w, p.y() - h, float(worldBounds.min.z())}}};
-  default:
-    // Should not happen.
-    return {};
-  }
+  m_worldBounds = worldBounds;
 }
 
 void GridRenderer::doPrepareVertices(VboManager& vboManager)
@@ -77,19 +55,56 @@ void GridRenderer::doPrepareVertices(VboManager& vboManager)
   m_vertexArray.prepare(vboManager);
 }
 
+std::string GridRenderer::profileLabel() const
+{
+  return "Grid";
+}
+
 void GridRenderer::doRender(RenderContext& renderContext)
 {
   if (renderContext.showGrid())
   {
-    const auto& camera = renderContext.camera();
+    const auto& viewport = m_camera.zoomedViewport();
+    const auto w = float(viewport.width) / 2.0f;
+    const auto h = float(viewport.height) / 2.0f;
+
+    // the quad spans the viewport on the far side of the world bounds
+    const auto& p = m_camera.position();
+    auto origin = p;
+    auto axisU = vm::vec3f{};
+    auto axisV = vm::vec3f{};
+    switch (vm::find_abs_max_component(m_camera.direction()))
+    {
+    case vm::axis::x:
+      origin[0] = float(m_worldBounds.min.x());
+      axisU = vm::vec3f{0.0f, w, 0.0f};
+      axisV = vm::vec3f{0.0f, 0.0f, h};
+      break;
+    case vm::axis::y:
+      origin[1] = float(m_worldBounds.max.y());
+      axisU = vm::vec3f{w, 0.0f, 0.0f};
+      axisV = vm::vec3f{0.0f, 0.0f, h};
+      break;
+    case vm::axis::z:
+      origin[2] = float(m_worldBounds.min.z());
+      axisU = vm::vec3f{w, 0.0f, 0.0f};
+      axisV = vm::vec3f{0.0f, h, 0.0f};
+      break;
+    default:
+      // Should not happen.
+      return;
+    }
 
     auto shader = ActiveShader{renderContext.shaderManager(), Shaders::Grid2DShader};
-    shader.set("Normal", -camera.direction());
+    shader.set("GridOrigin", origin);
+    shader.set("GridAxisU", axisU);
+    shader.set("GridAxisV", axisV);
+    shader.set("Normal", -m_camera.direction());
     shader.set("RenderGrid", renderContext.showGrid());
     shader.set("GridSize", static_cast<float>(renderContext.gridSize()));
     shader.set("GridAlpha", pref(Preferences::GridAlpha));
     shader.set("GridColor", pref(Preferences::GridColor2D));
-    shader.set("CameraZoom", camera.zoom());
+    shader.set("CameraZoom", m_camera.zoom());
 
     m_vertexArray.render(PrimType::Quads);
   }
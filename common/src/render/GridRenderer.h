@@ -33,18 +33,30 @@ class OrthographicCamera;
 class RenderContext;
 class VboManager;
 
+/**
+ * Renders the grid of a 2D view on a quad that covers the viewport at the far side of the
+ * world bounds. The grid lines are computed in the fragment shader.
+ *
+ * The quad's corners are computed from the camera in the vertex shader, so the vertices
+ * are only uploaded once and the renderer can be reused for every frame.
+ */
 class GridRenderer : public DirectRenderable
 {
 private:
-  using Vertex = GLVertexTypes::P3::Vertex;
+  using Vertex = GLVertexTypes::P2::Vertex;
+
+  const OrthographicCamera& m_camera;
+  vm::bbox3d m_worldBounds;
   VertexArray m_vertexArray;
 
 public:
   GridRenderer(const OrthographicCamera& camera, const vm::bbox3d& worldBounds);
 
+  void setWorldBounds(const vm::bbox3d& worldBounds);
+
+  std::string profileLabel() const override;
+
 private:
-  static std::vector<Vertex> vertices(
-    const OrthographicCamera& camera, const vm::bbox3d& worldBounds);
 
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
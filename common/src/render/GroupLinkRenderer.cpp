@@ -28,6 +28,10 @@
 #include "mdl/Map_Groups.h"
 #include "mdl/ModelUtils.h"
 
+#include "kdl/vector_utils.h"
+
+#include <vector>
+
 namespace tb::render
 {
 
@@ -41,37 +45,85 @@ static vm::vec3f getLinkAnchorPosition(const mdl::GroupNode& groupNode)
   return vm::vec3f(groupNode.logicalBounds().center());
 }
 
-std::vector<LinkRenderer::LineVertex> GroupLinkRenderer::getLinks()
+void GroupLinkRenderer::invalidateLinkedGroups()
 {
-  auto links = std::vector<LineVertex>{};
+  m_linkedGroupNodesValid = false;
+  invalidate();
+}
+
+void GroupLinkRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
+{
+  if (m_linkedGroupNodesValid && m_groupNode)
+  {
+    const auto& linkId = m_groupNode->linkId();
+    for (const auto* node : nodes)
+    {
+      if (const auto* groupNode = dynamic_cast<const mdl::GroupNode*>(node))
+      {
+        const auto isLinked = groupNode->linkId() == linkId;
+        const auto wasLinked = groupNode == m_groupNode
+                               || kdl::vec_contains(m_linkedGroupNodes, groupNode);
+        if (isLinked != wasLinked)
+        {
+          m_linkedGroupNodesValid = false;
+          break;
+        }
+      }
+    }
+  }
 
+  invalidate();
+}
+
+void GroupLinkRenderer::rebuildLinks()
+{
   const auto selectedGroupNodes = m_map.selection().groups;
 
   const auto* groupNode = selectedGroupNodes.size() == 1
                             ? selectedGroupNodes.front()
                             : m_map.editorContext().currentGroup();
 
+  if (groupNode != m_groupNode || !m_linkedGroupNodesValid)
+  {
+    m_groupNode = groupNode;
+    m_linkedGroupNodes.clear();
+
+    if (groupNode)
+    {
+      const auto linkedGroupNodes =
+        mdl::collectGroupsWithLinkId({m_map.world()}, groupNode->linkId());
+      for (const auto* linkedGroupNode : linkedGroupNodes)
+      {
+        if (linkedGroupNode != groupNode)
+        {
+          m_linkedGroupNodes.push_back(linkedGroupNode);
+        }
+      }
+    }
+
+    m_linkedGroupNodesValid = true;
+  }
+
   if (groupNode)
   {
     const auto& editorContext = m_map.editorContext();
 
-    const auto& linkId = groupNode->linkId();
-    const auto linkedGroupNodes = mdl::collectGroupsWithLinkId({m_map.world()}, linkId);
-
     const auto linkColor = pref(Preferences::LinkedGroupColor);
     const auto sourcePosition = getLinkAnchorPosition(*groupNode);
-    for (const auto* linkedGroupNode : linkedGroupNodes)
+
+    auto links = std::vector<LineVertex>{};
+    for (const auto* linkedGroupNode : m_linkedGroupNodes)
     {
-      if (linkedGroupNode != groupNode && editorContext.visible(*linkedGroupNode))
+      if (editorContext.visible(*linkedGroupNode))
       {
         const auto targetPosition = getLinkAnchorPosition(*linkedGroupNode);
         links.emplace_back(sourcePosition, linkColor);
         links.emplace_back(targetPosition, linkColor);
       }
     }
-  }
 
-  return links;
+    setLinks(groupNode, links);
+  }
 }
 
 } // namespace tb::render
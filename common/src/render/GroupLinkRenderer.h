@@ -26,8 +26,10 @@
 
 namespace tb::mdl
 {
+class GroupNode;
 class Map;
-}
+class Node;
+} // namespace tb::mdl
 
 namespace tb::render
 {
@@ -36,11 +38,29 @@ class GroupLinkRenderer : public LinkRenderer
 {
   mdl::Map& m_map;
 
+  /* The groups linked to m_groupNode, they are only collected again if another group is
+   * shown or if the groups or their link IDs change. */
+  const mdl::GroupNode* m_groupNode = nullptr;
+  std::vector<const mdl::GroupNode*> m_linkedGroupNodes;
+  bool m_linkedGroupNodesValid = false;
+
 public:
   explicit GroupLinkRenderer(mdl::Map& map);
 
+  /**
+   * Collects the linked groups again before the links are rebuilt, e.g. because groups
+   * were added or removed.
+   */
+  void invalidateLinkedGroups();
+
+  /**
+   * Rebuilds the links, and collects the linked groups again only if the link ID of any
+   * of the given nodes was changed to or from the link ID of the shown group.
+   */
+  void nodesDidChange(const std::vector<mdl::Node*>& nodes);
+
 private:
-  std::vector<LinkRenderer::LineVertex> getLinks() override;
+  void rebuildLinks() override;
 
   deleteCopy(GroupLinkRenderer);
 };
@@ -64,20 +64,24 @@ GroupRenderer::GroupRenderer(const mdl::EditorContext& editorContext)
 
 void GroupRenderer::invalidate()
 {
+  m_cachedBounds.clear();
   invalidateBounds();
 }
 
 void GroupRenderer::clear()
 {
   m_groups.clear();
+  m_cachedBounds.clear();
+  m_visibleGroups.clear();
   m_boundsRenderer = DirectEdgeRenderer();
+  invalidateBounds();
 }
 
 void GroupRenderer::addGroup(const mdl::GroupNode* group)
 {
   if (m_groups.insert(group).second)
   {
-    invalidate();
+    invalidateBounds();
   }
 }
 
@@ -86,13 +90,15 @@ void GroupRenderer::removeGroup(const mdl::GroupNode* group)
   if (auto it = m_groups.find(group); it != std::end(m_groups))
   {
     m_groups.erase(it);
-    invalidate();
+    m_cachedBounds.erase(group);
+    invalidateBounds();
   }
 }
 
-void GroupRenderer::invalidateGroup(const mdl::GroupNode*)
+void GroupRenderer::invalidateGroup(const mdl::GroupNode* group)
 {
-  invalidate();
+  m_cachedBounds.erase(group);
+  invalidateBounds();
 }
 
 void GroupRenderer::setOverrideColors(const bool overrideColors)
@@ -156,10 +162,13 @@ void GroupRenderer::renderBounds(RenderContext&, RenderBatch& renderBatch)
 
   if (m_showOccludedBounds)
   {
-    m_boundsRenderer.renderOnTop(renderBatch, m_overrideColors, m_occludedBoundsColor);
+    m_boundsRenderer.renderWithOccluded(
+      renderBatch, m_overrideColors, m_boundsColor, m_occludedBoundsColor);
+  }
+  else
+  {
+    m_boundsRenderer.render(renderBatch, m_overrideColors, m_boundsColor);
   }
-
-  m_boundsRenderer.render(renderBatch, m_overrideColors, m_boundsColor);
 }
 
 void GroupRenderer::renderNames(RenderContext& renderContext, RenderBatch& renderBatch)
@@ -174,26 +183,24 @@ void GroupRenderer::renderNames(RenderContext& renderContext, RenderBatch& rende
       renderService.setForegroundColor(m_overlayTextColor);
     }
 
-    for (const auto* group : m_groups)
+    // the visible groups are collected when the bounds are validated
+    for (const auto* group : m_visibleGroups)
     {
-      if (shouldRenderGroup(*group))
+      if (!m_overrideColors)
       {
-        if (!m_overrideColors)
-        {
-          renderService.setForegroundColor(groupColor(*group));
-        }
-
-        const auto anchor = GroupNameAnchor{*group};
-        if (m_showOccludedOverlays)
-        {
-          renderService.setShowOccludedObjects();
-        }
-        else
-        {
-          renderService.setHideOccludedObjects();
-        }
-        renderService.renderString(groupString(*group), anchor);
+        renderService.setForegroundColor(m_cachedBounds.at(group).color);
       }
+
+      const auto anchor = GroupNameAnchor{*group};
+      if (m_showOccludedOverlays)
+      {
+        renderService.setShowOccludedObjects();
+      }
+      else
+      {
+        renderService.setHideOccludedObjects();
+      }
+      renderService.renderString(groupString(*group), anchor);
     }
   }
 }
@@ -203,21 +210,32 @@ void GroupRenderer::invalidateBounds()
   m_boundsValid = false;
 }
 
+/**
+ * Only the groups that were invalidated since the last call have their visibility and
+ * bounds recomputed. The edges of all visible groups are then copied into one vertex
+ * array.
+ */
 void GroupRenderer::validateBounds()
 {
+  m_visibleGroups.clear();
+  for (const auto* group : m_groups)
+  {
+    if (cachedBounds(*group).visible)
+    {
+      m_visibleGroups.push_back(group);
+    }
+  }
+
   if (m_overrideColors)
   {
     auto vertices = std::vector<GLVertexTypes::P3::Vertex>{};
-    vertices.reserve(24 * m_groups.size());
+    vertices.reserve(24 * m_visibleGroups.size());
 
-    for (const auto* group : m_groups)
+    for (const auto* group : m_visibleGroups)
     {
-      if (shouldRenderGroup(*group))
+      for (const auto& position : m_cachedBounds.at(group).edgeVertices)
       {
-        group->logicalBounds().for_each_edge([&](const auto& v1, const auto& v2) {
-          vertices.emplace_back(vm::vec3f{v1});
-          vertices.emplace_back(vm::vec3f{v2});
-        });
+        vertices.emplace_back(position);
       }
     }
 
@@ -227,17 +245,14 @@ void GroupRenderer::validateBounds()
   else
   {
     auto vertices = std::vector<GLVertexTypes::P3C4::Vertex>{};
-    vertices.reserve(24 * m_groups.size());
+    vertices.reserve(24 * m_visibleGroups.size());
 
-    for (const auto* group : m_groups)
+    for (const auto* group : m_visibleGroups)
     {
-      if (shouldRenderGroup(*group))
+      const auto& bounds = m_cachedBounds.at(group);
+      for (const auto& position : bounds.edgeVertices)
       {
-        const auto color = groupColor(*group);
-        group->logicalBounds().for_each_edge([&](const auto& v1, const auto& v2) {
-          vertices.emplace_back(vm::vec3f{v1}, color);
-          vertices.emplace_back(vm::vec3f{v2}, color);
-        });
+        vertices.emplace_back(position, bounds.color);
       }
     }
 
@@ -248,6 +263,28 @@ void GroupRenderer::validateBounds()
   m_boundsValid = true;
 }
 
+const GroupRenderer::CachedBounds& GroupRenderer::cachedBounds(
+  const mdl::GroupNode& group)
+{
+  auto [it, inserted] = m_cachedBounds.try_emplace(&group);
+  if (inserted)
+  {
+    auto& bounds = it->second;
+    bounds.visible = shouldRenderGroup(group);
+    if (bounds.visible)
+    {
+      bounds.color = groupColor(group);
+
+      auto i = size_t(0);
+      group.logicalBounds().for_each_edge([&](const auto& v1, const auto& v2) {
+        bounds.edgeVertices[i++] = vm::vec3f{v1};
+        bounds.edgeVertices[i++] = vm::vec3f{v2};
+      });
+    }
+  }
+  return it->second;
+}
+
 bool GroupRenderer::shouldRenderGroup(const mdl::GroupNode& groupNode) const
 {
   const auto* currentGroup = m_editorContext.currentGroup();
@@ -25,6 +25,12 @@
 
 #include "kdl/vector_set.h"
 
+#include "vm/vec.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
 namespace tb::mdl
 {
 class EditorContext;
@@ -41,9 +47,22 @@ class GroupRenderer
 private:
   class GroupNameAnchor;
 
+  /**
+   * The edges of the bounds of a group, cached until the group is invalidated.
+   */
+  struct CachedBounds
+  {
+    bool visible = false;
+    Color color;
+    std::array<vm::vec3f, 24> edgeVertices;
+  };
+
   const mdl::EditorContext& m_editorContext;
   kdl::vector_set<const mdl::GroupNode*> m_groups;
 
+  std::unordered_map<const mdl::GroupNode*, CachedBounds> m_cachedBounds;
+  std::vector<const mdl::GroupNode*> m_visibleGroups;
+
   DirectEdgeRenderer m_boundsRenderer;
   bool m_boundsValid = false;
 
@@ -104,6 +123,7 @@ private:
 
   void invalidateBounds();
   void validateBounds();
+  const CachedBounds& cachedBounds(const mdl::GroupNode& group);
 
   bool shouldRenderGroup(const mdl::GroupNode& group) const;
 
@@ -103,47 +103,35 @@ void IndexArrayMapBuilder::addQuads(const IndexList& indices)
 void IndexArrayMapBuilder::addQuads(const Index baseIndex, const size_t vertexCount)
 {
   assert(vertexCount % 4 == 0);
-  auto indices = IndexList{};
-  indices.reserve(vertexCount);
-
+  const auto offset = m_ranges.add(PrimType::Quads, vertexCount);
   for (size_t i = 0; i < vertexCount; ++i)
   {
-    indices.push_back(baseIndex + static_cast<Index>(i));
+    m_indices[offset + i] = baseIndex + static_cast<Index>(i);
   }
-
-  add(PrimType::Quads, indices);
 }
 
 void IndexArrayMapBuilder::addPolygon(const IndexList& indices)
 {
+  // triangulate the polygon as a fan, writing the indices directly into the index array
   const auto count = indices.size();
-
-  auto polyIndices = IndexList{};
-  polyIndices.reserve(3 * (count - 2));
-
+  const auto offset = m_ranges.add(PrimType::Triangles, 3 * (count - 2));
   for (size_t i = 0; i < count - 2; ++i)
   {
-    polyIndices.push_back(indices[0]);
-    polyIndices.push_back(indices[i + 1]);
-    polyIndices.push_back(indices[i + 2]);
+    m_indices[offset + 3 * i + 0] = indices[0];
+    m_indices[offset + 3 * i + 1] = indices[i + 1];
+    m_indices[offset + 3 * i + 2] = indices[i + 2];
   }
-
-  add(PrimType::Triangles, polyIndices);
 }
 
 void IndexArrayMapBuilder::addPolygon(const Index baseIndex, const size_t vertexCount)
 {
-  auto polyIndices = IndexList{};
-  polyIndices.reserve(3 * (vertexCount - 2));
-
+  const auto offset = m_ranges.add(PrimType::Triangles, 3 * (vertexCount - 2));
   for (size_t i = 0; i < vertexCount - 2; ++i)
   {
-    polyIndices.push_back(baseIndex);
-    polyIndices.push_back(baseIndex + static_cast<Index>(i + 1));
-    polyIndices.push_back(baseIndex + static_cast<Index>(i + 2));
+    m_indices[offset + 3 * i + 0] = baseIndex;
+    m_indices[offset + 3 * i + 1] = baseIndex + static_cast<Index>(i + 1);
+    m_indices[offset + 3 * i + 2] = baseIndex + static_cast<Index>(i + 2);
   }
-
-  add(PrimType::Triangles, polyIndices);
 }
 
 void IndexArrayMapBuilder::add(const PrimType primType, const IndexList& indices)
@@ -181,6 +181,25 @@ void IndexRangeMap::render(VertexArray& vertexArray) const
   }
 }
 
+void IndexRangeMap::renderInstanced(
+  VertexArray& vertexArray, const size_t instanceCount) const
+{
+  for (const auto& primType : PrimTypeValues)
+  {
+    const auto& indicesAndCounts = m_data->get(primType);
+    if (!indicesAndCounts.empty())
+    {
+      const auto primCount = static_cast<GLsizei>(indicesAndCounts.size());
+      vertexArray.renderInstanced(
+        primType,
+        indicesAndCounts.indices,
+        indicesAndCounts.counts,
+        primCount,
+        static_cast<GLsizei>(instanceCount));
+    }
+  }
+}
+
 void IndexRangeMap::forEachPrimitive(
   std::function<void(PrimType, size_t, size_t)> func) const
 {
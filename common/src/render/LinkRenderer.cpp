@@ -21,76 +21,16 @@
 
 #include "render/ActiveShader.h"
 #include "render/Camera.h"
-#include "render/PrimType.h"
+#include "render/GL.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/Shaders.h"
 
-namespace tb::render
-{
-
-LinkRenderer::LinkRenderer() = default;
-
-void LinkRenderer::render(RenderContext&, RenderBatch& renderBatch)
-{
-  renderBatch.add(this);
-}
-
-void LinkRenderer::invalidate()
-{
-  m_valid = false;
-}
-
-void LinkRenderer::doPrepareVertices(VboManager& vboManager)
-{
-  if (!m_valid)
-  {
-    validate();
+#include <algorithm>
+#include <cassert>
 
-    m_lines.prepare(vboManager);
-    m_arrows.prepare(vboManager);
-  }
-}
-
-void LinkRenderer::doRender(RenderContext& renderContext)
-{
-  assert(m_valid);
-  renderLines(renderContext);
-  renderArrows(renderContext);
-}
-
-void LinkRenderer::renderLines(RenderContext& renderContext)
-{
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkLineShader};
-  shader.set("CameraPosition", renderContext.camera().position());
-  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
-  shader.set("MaxDistance", 6000.0f);
-
-  glAssert(glDisable(GL_DEPTH_TEST));
-  shader.set("Alpha", 0.4f);
-  m_lines.render(PrimType::Lines);
-
-  glAssert(glEnable(GL_DEPTH_TEST));
-  shader.set("Alpha", 1.0f);
-  m_lines.render(PrimType::Lines);
-}
-
-void LinkRenderer::renderArrows(RenderContext& renderContext)
+namespace tb::render
 {
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkArrowShader};
-  shader.set("CameraPosition", renderContext.camera().position());
-  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
-  shader.set("MaxDistance", 6000.0f);
-  shader.set("Zoom", renderContext.camera().zoom());
-
-  glAssert(glDisable(GL_DEPTH_TEST));
-  shader.set("Alpha", 0.4f);
-  m_arrows.render(PrimType::Lines);
-
-  glAssert(glEnable(GL_DEPTH_TEST));
-  shader.set("Alpha", 1.0f);
-  m_arrows.render(PrimType::Lines);
-}
 
 static void addArrow(
   std::vector<LinkRenderer::ArrowVertex>& arrows,
@@ -148,15 +88,163 @@ static std::vector<LinkRenderer::ArrowVertex> getArrows(
   return arrows;
 }
 
+template <typename V>
+AllocationTracker::Block* LinkRenderer::LinkVertexArray<V>::insert(
+  const std::vector<V>& vertices)
+{
+  assert(!vertices.empty());
+
+  auto* block = m_allocationTracker.allocate(vertices.size());
+  if (block == nullptr)
+  {
+    const auto capacity = m_allocationTracker.capacity();
+    const auto newSize = std::max(2 * capacity, capacity + vertices.size());
+    m_allocationTracker.expand(newSize);
+    m_vertexHolder.resize(newSize);
+
+    block = m_allocationTracker.allocate(vertices.size());
+    assert(block != nullptr);
+  }
+
+  auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertices.size());
+  std::copy(vertices.begin(), vertices.end(), dest);
+  return block;
+}
+
+template <typename V>
+void LinkRenderer::LinkVertexArray<V>::remove(AllocationTracker::Block* block)
+{
+  // the whole array is drawn, so the removed vertices must become degenerate lines
+  auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, block->size);
+  std::fill_n(dest, block->size, V{});
+
+  m_allocationTracker.free(block);
+}
+
+template <typename V>
+void LinkRenderer::LinkVertexArray<V>::prepare(VboManager& vboManager)
+{
+  m_vertexHolder.prepare(vboManager);
+}
+
+template <typename V>
+void LinkRenderer::LinkVertexArray<V>::render(const PrimType primType)
+{
+  if (m_allocationTracker.hasAllocations() && m_vertexHolder.setupVertices())
+  {
+    glAssert(glDrawArrays(toGL(primType), 0, GLsizei(m_vertexHolder.size())));
+    m_vertexHolder.cleanupVertices();
+  }
+}
+
+LinkRenderer::LinkRenderer() = default;
+
+LinkRenderer::~LinkRenderer() = default;
+
+void LinkRenderer::render(RenderContext&, RenderBatch& renderBatch)
+{
+  renderBatch.add(this);
+}
+
+void LinkRenderer::invalidate()
+{
+  m_valid = false;
+}
+
+void LinkRenderer::setLinks(const mdl::Node* key, const std::vector<LineVertex>& links)
+{
+  removeLinks(key);
+
+  if (!links.empty())
+  {
+    const auto arrows = getArrows(links);
+    m_links[key] = LinkBlocks{m_lines->insert(links), m_arrows->insert(arrows)};
+  }
+}
+
+void LinkRenderer::removeLinks(const mdl::Node* key)
+{
+  if (const auto it = m_links.find(key); it != m_links.end())
+  {
+    m_lines->remove(it->second.lines);
+    m_arrows->remove(it->second.arrows);
+    m_links.erase(it);
+  }
+}
+
+void LinkRenderer::invalidateLinks()
+{
+  m_linksChanged = true;
+}
+
+void LinkRenderer::doPrepareVertices(VboManager& vboManager)
+{
+  if (!m_valid)
+  {
+    validate();
+  }
+  else if (m_linksChanged)
+  {
+    updateLinks();
+    m_linksChanged = false;
+  }
+
+  m_lines->prepare(vboManager);
+  m_arrows->prepare(vboManager);
+}
+
+void LinkRenderer::doRender(RenderContext& renderContext)
+{
+  assert(m_valid);
+  renderLines(renderContext);
+  renderArrows(renderContext);
+}
+
+void LinkRenderer::renderLines(RenderContext& renderContext)
+{
+  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkLineShader};
+  shader.set("CameraPosition", renderContext.camera().position());
+  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
+  shader.set("MaxDistance", 6000.0f);
+
+  glAssert(glDisable(GL_DEPTH_TEST));
+  shader.set("Alpha", 0.4f);
+  m_lines->render(PrimType::Lines);
+
+  glAssert(glEnable(GL_DEPTH_TEST));
+  shader.set("Alpha", 1.0f);
+  m_lines->render(PrimType::Lines);
+}
+
+void LinkRenderer::renderArrows(RenderContext& renderContext)
+{
+  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkArrowShader};
+  shader.set("CameraPosition", renderContext.camera().position());
+  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
+  shader.set("MaxDistance", 6000.0f);
+  shader.set("Zoom", renderContext.camera().zoom());
+
+  glAssert(glDisable(GL_DEPTH_TEST));
+  shader.set("Alpha", 0.4f);
+  m_arrows->render(PrimType::Lines);
+
+  glAssert(glEnable(GL_DEPTH_TEST));
+  shader.set("Alpha", 1.0f);
+  m_arrows->render(PrimType::Lines);
+}
+
 void LinkRenderer::validate()
 {
-  auto links = getLinks();
-  auto arrows = getArrows(links);
+  m_lines = std::make_unique<LinkVertexArray<LineVertex>>();
+  m_arrows = std::make_unique<LinkVertexArray<ArrowVertex>>();
+  m_links.clear();
 
-  m_lines = VertexArray::move(std::move(links));
-  m_arrows = VertexArray::move(std::move(arrows));
+  rebuildLinks();
 
   m_valid = true;
+  m_linksChanged = false;
 }
 
+void LinkRenderer::updateLinks() {}
+
 } // namespace tb::render
@@ -19,9 +19,21 @@
 
 #pragma once
 
+#include "Macros.h"
+#include "render/AllocationTracker.h"
+#include "render/BrushRendererArrays.h"
 #include "render/GLVertexType.h"
+#include "render/PrimType.h"
 #include "render/Renderable.h"
-#include "render/VertexArray.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+}
 
 namespace tb::render
 {
@@ -51,17 +63,64 @@ public:
     GLVertexAttributeUser<LineDirName, GL_FLOAT, 3, false>>::Vertex; // direction the
                                                                      // arrow is pointing
 private:
-  VertexArray m_lines;
-  VertexArray m_arrows;
+  /**
+   * Stores the vertices of all links in a single VBO that grows as needed. The vertices
+   * of removed links are replaced by degenerate primitives, so that only the modified
+   * range of the VBO must be uploaded again.
+   */
+  template <typename V>
+  class LinkVertexArray
+  {
+  private:
+    VertexHolder<V> m_vertexHolder;
+    AllocationTracker m_allocationTracker;
+
+  public:
+    AllocationTracker::Block* insert(const std::vector<V>& vertices);
+    void remove(AllocationTracker::Block* block);
+
+    void prepare(VboManager& vboManager);
+    void render(PrimType primType);
+  };
+
+  // the blocks in the vertex arrays that contain the links of one key
+  struct LinkBlocks
+  {
+    AllocationTracker::Block* lines = nullptr;
+    AllocationTracker::Block* arrows = nullptr;
+  };
+
+  std::unique_ptr<LinkVertexArray<LineVertex>> m_lines;
+  std::unique_ptr<LinkVertexArray<ArrowVertex>> m_arrows;
+  std::unordered_map<const mdl::Node*, LinkBlocks> m_links;
 
   bool m_valid = false;
+  bool m_linksChanged = false;
 
 public:
   LinkRenderer();
+  ~LinkRenderer() override;
 
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
+
+  /**
+   * Removes all links and rebuilds them by calling rebuildLinks() before the next render.
+   */
   void invalidate();
 
+protected:
+  /**
+   * Replaces the links stored under the given key. The key is usually the node where the
+   * links start, and only the vertices of the given links are uploaded again.
+   */
+  void setLinks(const mdl::Node* key, const std::vector<LineVertex>& links);
+  void removeLinks(const mdl::Node* key);
+
+  /**
+   * Requests a call to updateLinks() before the next render.
+   */
+  void invalidateLinks();
+
 private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
@@ -71,7 +130,16 @@ private:
 
   void validate();
 
-  virtual std::vector<LinkRenderer::LineVertex> getLinks() = 0;
+  /**
+   * Called after all links have been removed. Must add all links using setLinks().
+   */
+  virtual void rebuildLinks() = 0;
+
+  /**
+   * Called if invalidateLinks() was called, but not invalidate(). Should update only the
+   * links that have changed using setLinks() and removeLinks().
+   */
+  virtual void updateLinks();
 
   deleteCopy(LinkRenderer);
 };
@@ -19,8 +19,10 @@
 
 #include "MapRenderer.h"
 
+#include "MemoryReport.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -34,20 +36,33 @@
 #include "mdl/MaterialManager.h"
 #include "mdl/Node.h"
 #include "mdl/PatchNode.h"
+#include "mdl/PortalGraph.h"
 #include "mdl/SelectionChange.h"
 #include "mdl/WorldNode.h"
 #include "render/BrushRenderer.h"
+#include "render/BrushRendererBrushCache.h"
+#include "render/Camera.h"
 #include "render/EntityDecalRenderer.h"
 #include "render/EntityLinkRenderer.h"
 #include "render/GroupLinkRenderer.h"
 #include "render/ObjectRenderer.h"
+#include "render/OcclusionCuller.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderUtils.h"
+#include "render/Renderable.h"
+#include "render/Transformation.h"
 
 #include "kdl/overload.h"
 #include "kdl/path_utils.h"
+#include "kdl/ranges/to.h"
 
+#include "vm/plane.h"
+
+#include <chrono>
+#include <cmath>
+#include <ranges>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::render
@@ -55,6 +70,12 @@ namespace tb::render
 namespace
 {
 
+/**
+ * Hidden nodes keep their render data for this long, so that toggling the visibility of
+ * a layer back and forth doesn't rebuild its nodes every time.
+ */
+constexpr auto HiddenNodeEvictionDelay = std::chrono::seconds{30};
+
 class SelectedBrushRendererFilter : public BrushRenderer::DefaultFilter
 {
 public:
@@ -126,8 +147,10 @@ public:
     const auto brushVisible = visible(brushNode);
     const auto brushEditable = editable(brushNode);
 
+    // selected brushes are included as if they weren't selected, since the renderer
+    // hides them by their selection flags
     const auto renderFaces = (brushVisible && brushEditable);
-    auto renderEdges = (brushVisible && !selected(brushNode));
+    auto renderEdges = brushVisible;
 
     if (!renderFaces && !renderEdges)
     {
@@ -158,31 +181,70 @@ public:
   }
 };
 
+/**
+ * The edge length of the cells that the unselected brushes are bucketed into. These
+ * brushes make up most of the map, so a change to a brush only re-uploads its own cell,
+ * and cells outside of the view volume are skipped entirely.
+ */
+constexpr auto DefaultBrushChunkSize = 1024.0;
+
+/**
+ * Validating the unselected brushes may take this long per frame. A change to many
+ * brushes, e.g. loading a map or changing the filter, is spread over several frames, and
+ * input is handled between them. The selected brushes are always validated at once.
+ */
+constexpr auto DefaultBrushValidationTimeBudget = std::chrono::milliseconds{12};
+
+/**
+ * In the 2D views, chunks of unselected brushes that are smaller than this many pixels
+ * are rendered as their bounds instead of their brushes.
+ */
+constexpr auto CoarseChunkPixels = 16.0;
+
+/**
+ * Returns the size of a pixel of the given 2D camera in world units, rounded down to a
+ * power of two so that the brushes which are smaller than a pixel only change when the
+ * zoom changes substantially.
+ */
+double roundedPixelSize(const Camera& camera)
+{
+  return std::exp2(std::floor(std::log2(1.0 / double(camera.zoom()))));
+}
+
 std::unique_ptr<ObjectRenderer> createDefaultRenderer(mdl::Map& map)
 {
-  return std::make_unique<ObjectRenderer>(
+  auto renderer = std::make_unique<ObjectRenderer>(
     map.logger(),
     map.entityModelManager(),
     map.editorContext(),
     UnselectedBrushRendererFilter{map.editorContext()});
+  renderer->setBrushChunkSize(DefaultBrushChunkSize);
+  renderer->setHideSelectedBrushes(true);
+  renderer->setTaskManager(&map.taskManager());
+  renderer->setBrushValidationTimeBudget(DefaultBrushValidationTimeBudget);
+  return renderer;
 }
 
 std::unique_ptr<ObjectRenderer> createSelectionRenderer(mdl::Map& map)
 {
-  return std::make_unique<ObjectRenderer>(
+  auto renderer = std::make_unique<ObjectRenderer>(
     map.logger(),
     map.entityModelManager(),
     map.editorContext(),
     SelectedBrushRendererFilter{map.editorContext()});
+  renderer->setTaskManager(&map.taskManager());
+  return renderer;
 }
 
 std::unique_ptr<ObjectRenderer> createLockRenderer(mdl::Map& map)
 {
-  return std::make_unique<ObjectRenderer>(
+  auto renderer = std::make_unique<ObjectRenderer>(
     map.logger(),
     map.entityModelManager(),
     map.editorContext(),
     LockedBrushRendererFilter{map.editorContext()});
+  renderer->setTaskManager(&map.taskManager());
+  return renderer;
 }
 
 std::unique_ptr<EntityDecalRenderer> createEntityDecalRenderer(mdl::Map& map)
@@ -190,6 +252,68 @@ std::unique_ptr<EntityDecalRenderer> createEntityDecalRenderer(mdl::Map& map)
   return std::make_unique<EntityDecalRenderer>(map);
 }
 
+std::vector<vm::plane3d> viewVolumePlanes(const Camera& camera)
+{
+  return camera.viewVolumePlanes() | std::views::transform([](const auto& plane) {
+           return vm::plane3d{plane};
+         })
+         | kdl::ranges::to<std::vector>();
+}
+
+struct VisibleNodes
+{
+  std::vector<const mdl::BrushNode*> brushes;
+  std::unordered_set<const mdl::EntityNode*> entities;
+};
+
+/**
+ * Returns the brushes and entities that intersect any of the given convex volumes. Nodes
+ * that intersect several volumes are only returned once.
+ */
+VisibleNodes findVisibleNodes(
+  const mdl::WorldNode& worldNode, const std::vector<std::vector<vm::plane3d>>& volumes)
+{
+  auto result = VisibleNodes{};
+  auto brushes = std::unordered_set<const mdl::BrushNode*>{};
+  for (const auto& volume : volumes)
+  {
+    for (const auto* node : worldNode.nodeTree().find_in_convex_volume(volume))
+    {
+      node->accept(kdl::overload(
+        [](const mdl::WorldNode*) {},
+        [](const mdl::LayerNode*) {},
+        [](const mdl::GroupNode*) {},
+        [&](const mdl::EntityNode* entityNode) { result.entities.insert(entityNode); },
+        [&](const mdl::BrushNode* brushNode) {
+          if (brushes.insert(brushNode).second)
+          {
+            result.brushes.push_back(brushNode);
+          }
+        },
+        [](const mdl::PatchNode*) {}));
+    }
+  }
+  return result;
+}
+
+std::optional<std::vector<std::vector<vm::plane3d>>> findPortalVolumes(
+  const RenderContext& renderContext, const std::vector<vm::plane3d>& viewVolume)
+{
+  const auto* portalGraph = renderContext.portalGraph();
+  if (!portalGraph)
+  {
+    return std::nullopt;
+  }
+
+  const auto& camera = renderContext.camera();
+  return portalGraph->visibleVolumes(mdl::PortalView{
+    vm::vec3d{camera.position()},
+    vm::vec3d{camera.direction()},
+    vm::vec3d{camera.right()},
+    vm::vec3d{camera.up()},
+    viewVolume});
+}
+
 } // namespace
 
 MapRenderer::MapRenderer(mdl::Map& map)
@@ -229,20 +353,40 @@ void MapRenderer::restoreSelectionColors()
 
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  TB_TRACE_SCOPE("MapRenderer::render");
+
+  evictHiddenNodes();
+  cullBrushes(renderContext);
   setupGL(renderBatch);
-  renderEntityDecals(renderContext, renderBatch);
-  renderEntityLinks(renderContext, renderBatch);
-  renderGroupLinks(renderContext, renderBatch);
+  if (!renderContext.reducedQuality())
+  {
+    renderEntityDecals(renderContext, renderBatch);
+    renderEntityLinks(renderContext, renderBatch);
+    renderGroupLinks(renderContext, renderBatch);
+  }
 
   renderDefaultOpaque(renderContext, renderBatch);
   renderLockedOpaque(renderContext, renderBatch);
   renderSelectionOpaque(renderContext, renderBatch);
+  renderOcclusionQueries(renderContext, renderBatch);
 
   renderDefaultTransparent(renderContext, renderBatch);
   renderLockedTransparent(renderContext, renderBatch);
   renderSelectionTransparent(renderContext, renderBatch);
 }
 
+bool MapRenderer::hasPendingUpdates() const
+{
+  return m_defaultRenderer->hasPendingUpdates();
+}
+
+void MapRenderer::addToMemoryReport(MemoryReport& report) const
+{
+  m_defaultRenderer->addToMemoryReport(report);
+  m_selectionRenderer->addToMemoryReport(report);
+  m_lockedRenderer->addToMemoryReport(report);
+}
+
 void MapRenderer::reload()
 {
   clear();
@@ -257,8 +401,11 @@ void MapRenderer::clear()
   m_lockedRenderer->clear();
   m_entityDecalRenderer->clear();
   m_entityLinkRenderer->invalidate();
-  m_groupLinkRenderer->invalidate();
+  m_groupLinkRenderer->invalidateLinkedGroups();
   m_trackedNodes.clear();
+  m_hiddenNodes.clear();
+  m_evictedNodes.clear();
+  m_detailBrushes.clear();
 }
 
 class SetupGL : public Renderable
@@ -269,11 +416,171 @@ private:
     glAssert(glFrontFace(GL_CW));
     glAssert(glEnable(GL_CULL_FACE));
     glAssert(glEnable(GL_DEPTH_TEST));
-    glAssert(glDepthFunc(GL_LEQUAL));
+    glAssert(glDepthFunc(glIsReverseDepth() ? GL_GEQUAL : GL_LEQUAL));
     glResetEdgeOffset();
   }
 };
 
+namespace
+{
+
+class PushModelMatrix : public Renderable
+{
+private:
+  vm::mat4x4f m_modelMatrix;
+
+public:
+  explicit PushModelMatrix(const vm::mat4x4f& modelMatrix)
+    : m_modelMatrix{modelMatrix}
+  {
+  }
+
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().pushModelMatrix(m_modelMatrix);
+  }
+};
+
+class PopModelMatrix : public Renderable
+{
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().popModelMatrix();
+  }
+};
+
+/**
+ * Renders the selection using the given function. If the render context has a selection
+ * transformation, it is applied as a model matrix around the renderables added to the
+ * batch, so that the selection is transformed on the GPU.
+ */
+template <typename F>
+void renderTransformedSelection(
+  RenderContext& renderContext, RenderBatch& renderBatch, const F& render)
+{
+  const auto& transformation = renderContext.selectionTransformation();
+  if (transformation)
+  {
+    renderBatch.addOneShot(new PushModelMatrix{vm::mat4x4f{*transformation}});
+  }
+
+  render();
+
+  if (transformation)
+  {
+    renderBatch.addOneShot(new PopModelMatrix{});
+  }
+}
+
+} // namespace
+
+void MapRenderer::cullBrushes(RenderContext& renderContext)
+{
+  auto viewVolume = std::make_shared<const std::vector<vm::plane3d>>(
+    viewVolumePlanes(renderContext.camera()));
+
+  auto portalBrushes = std::shared_ptr<const std::vector<const mdl::BrushNode*>>{};
+  auto portalEntities =
+    std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>>{};
+  if (const auto* worldNode = m_map.world())
+  {
+    if (const auto portalVolumes = findPortalVolumes(renderContext, *viewVolume))
+    {
+      auto visibleNodes = findVisibleNodes(*worldNode, *portalVolumes);
+      portalBrushes = std::make_shared<const std::vector<const mdl::BrushNode*>>(
+        std::move(visibleNodes.brushes));
+      portalEntities = std::make_shared<const std::unordered_set<const mdl::EntityNode*>>(
+        std::move(visibleNodes.entities));
+    }
+  }
+
+  // the default renderer is chunked, so it culls whole chunks instead of single brushes
+  // unless the portal file culls the brushes within the chunks
+  m_defaultRenderer->setViewVolume(viewVolume);
+  m_defaultRenderer->setVisibleEntities(portalEntities);
+  if (renderContext.render2D())
+  {
+    // zoomed out 2D views skip brushes smaller than a pixel and draw small chunks as
+    // their bounds, the selection is always rendered in full
+    const auto& camera = renderContext.camera();
+    m_defaultRenderer->setVisibleBrushes(
+      findDetailBrushes(camera, roundedPixelSize(camera)));
+    m_defaultRenderer->setBrushCoarseChunkSize(
+      CoarseChunkPixels / double(camera.zoom()));
+  }
+  else
+  {
+    m_defaultRenderer->setVisibleBrushes(portalBrushes);
+    m_defaultRenderer->setBrushCoarseChunkSize(std::nullopt);
+  }
+
+  // the selection and locked renderers only cull their own brushes, which are usually
+  // few, instead of querying the whole world, selected objects are never culled with the
+  // portal file, since they are being edited, and they are not culled at all while a
+  // transformation of them is being previewed
+  if (renderContext.selectionTransformation())
+  {
+    m_selectionRenderer->setVisibleBrushes(nullptr);
+  }
+  else
+  {
+    m_selectionRenderer->cullBrushes(*viewVolume);
+  }
+
+  if (portalBrushes)
+  {
+    m_lockedRenderer->setVisibleBrushes(portalBrushes);
+  }
+  else
+  {
+    m_lockedRenderer->cullBrushes(*viewVolume);
+  }
+  m_lockedRenderer->setVisibleEntities(portalEntities);
+  m_entityDecalRenderer->setVisibleEntities(portalEntities);
+}
+
+std::shared_ptr<const std::vector<const mdl::BrushNode*>> MapRenderer::findDetailBrushes(
+  const Camera& camera, const double pixelSize)
+{
+  const auto key =
+    DetailBrushesKey{vm::find_abs_max_component(camera.direction()), pixelSize};
+  auto it = m_detailBrushes.find(key);
+  if (it == m_detailBrushes.end())
+  {
+    auto detailBrushes = std::vector<const mdl::BrushNode*>{};
+    auto skippedBrushes = false;
+    for (const auto& [node, renderers] : m_trackedNodes)
+    {
+      if (renderers & int(Renderer::Default))
+      {
+        if (const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(node))
+        {
+          if (projectedSize(brushNode->logicalBounds(), camera) >= pixelSize)
+          {
+            detailBrushes.push_back(brushNode);
+          }
+          else
+          {
+            skippedBrushes = true;
+          }
+        }
+      }
+    }
+
+    // if no brush is skipped, the chunks can be rendered without index ranges
+    auto brushes = std::shared_ptr<const std::vector<const mdl::BrushNode*>>{};
+    if (skippedBrushes)
+    {
+      brushes = std::make_shared<const std::vector<const mdl::BrushNode*>>(
+        std::move(detailBrushes));
+    }
+    it = m_detailBrushes.emplace(key, std::move(brushes)).first;
+  }
+  return it->second;
+}
+
 void MapRenderer::setupGL(RenderBatch& renderBatch)
 {
   renderBatch.addOneShot(new SetupGL{});
@@ -298,7 +605,9 @@ void MapRenderer::renderSelectionOpaque(
 {
   if (!renderContext.hideSelection())
   {
-    m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+    renderTransformedSelection(renderContext, renderBatch, [&]() {
+      m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+    });
   }
 }
 
@@ -307,7 +616,9 @@ void MapRenderer::renderSelectionTransparent(
 {
   if (!renderContext.hideSelection())
   {
-    m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+    renderTransformedSelection(renderContext, renderBatch, [&]() {
+      m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+    });
   }
 }
 
@@ -325,6 +636,16 @@ void MapRenderer::renderLockedTransparent(
   m_lockedRenderer->renderTransparent(renderContext, renderBatch);
 }
 
+void MapRenderer::renderOcclusionQueries(
+  RenderContext& renderContext, RenderBatch& renderBatch)
+{
+  // the queries are tested against the depth of all opaque objects
+  if (auto* occlusionCuller = renderContext.occlusionCuller())
+  {
+    occlusionCuller->render(renderBatch);
+  }
+}
+
 void MapRenderer::renderEntityDecals(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
@@ -463,7 +784,9 @@ int MapRenderer::determineDesiredRenderers(mdl::Node* node)
       {
         result = int(Renderer::Selection);
       }
-      if (!brush->selected() && !brush->parentSelected() && !brush->locked())
+      // selected brushes stay in the default renderer, which hides them by their
+      // selection flags
+      if (!brush->locked())
       {
         result |= int(Renderer::Default);
       }
@@ -486,14 +809,35 @@ int MapRenderer::determineDesiredRenderers(mdl::Node* node)
 }
 
 /**
- * - Determine which renderers the given node should be in
+ * - Determine which renderers the given node should be in, none if it is evicted
  * - Remove from any renderers the node shouldn't be in
  * - Add to desired renderers, if not already present
  * - Invalidate, for any renderers it was already present in
  */
 void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
 {
-  const auto desiredRenderers = determineDesiredRenderers(node);
+  updateNode(node, NodeChange::Any);
+}
+
+void MapRenderer::updateAndInvalidateNodeRecursive(mdl::Node* node)
+{
+  updateNodeRecursive(node, NodeChange::Any);
+}
+
+void MapRenderer::updateNodeSelectionRecursive(mdl::Node* node)
+{
+  updateNodeRecursive(node, NodeChange::Selection);
+}
+
+/**
+ * Like updateAndInvalidateNode(), but if only the selection of a node changed and it
+ * stays in the default renderer, then the default renderer only updates its selection
+ * flags instead of invalidating it.
+ */
+void MapRenderer::updateNode(mdl::Node* node, const NodeChange change)
+{
+  const auto evicted = updateEviction(node);
+  const auto desiredRenderers = evicted ? 0 : determineDesiredRenderers(node);
   int currentRenderers = 0;
 
   if (auto it = m_trackedNodes.find(node); it != m_trackedNodes.end())
@@ -515,7 +859,18 @@ void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
     }
     else if (isRCurrent && isRDesired)
     {
-      o->invalidateNode(node);
+      // selected nodes are always visible, so a deselected node that is hidden now must
+      // be invalidated to remove it from the renderer
+      if (
+        r == Renderer::Default && change == NodeChange::Selection
+        && m_map.editorContext().visible(*node))
+      {
+        o->updateNodeSelection(node);
+      }
+      else
+      {
+        o->invalidateNode(node);
+      }
     }
   };
 
@@ -526,24 +881,30 @@ void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
   // Update the metadata to reflect the changes that we made above
   m_trackedNodes[node] = desiredRenderers;
 
+  if ((currentRenderers | desiredRenderers) & int(Renderer::Default))
+  {
+    m_detailBrushes.clear();
+  }
+
   m_entityDecalRenderer->updateNode(node);
+  m_entityLinkRenderer->updateNode(node);
 }
 
-void MapRenderer::updateAndInvalidateNodeRecursive(mdl::Node* node)
+void MapRenderer::updateNodeRecursive(mdl::Node* node, const NodeChange change)
 {
   node->accept(kdl::overload(
     [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [&](auto&& thisLambda, mdl::GroupNode* group) {
-      updateAndInvalidateNode(group);
+      updateNode(group, change);
       group->visitChildren(thisLambda);
     },
     [&](auto&& thisLambda, mdl::EntityNode* entity) {
-      updateAndInvalidateNode(entity);
+      updateNode(entity, change);
       entity->visitChildren(thisLambda);
     },
-    [&](mdl::BrushNode* brush) { updateAndInvalidateNode(brush); },
-    [&](mdl::PatchNode* patchNode) { updateAndInvalidateNode(patchNode); }));
+    [&](mdl::BrushNode* brush) { updateNode(brush, change); },
+    [&](mdl::PatchNode* patchNode) { updateNode(patchNode, change); }));
 
   // Due to the definition of `selected()` above, we also need to update the parent.
   // (not recursively, though, so this has little performance impact.)
@@ -551,12 +912,15 @@ void MapRenderer::updateAndInvalidateNodeRecursive(mdl::Node* node)
   // render as selected.
   if (node->parent())
   {
-    updateAndInvalidateNode(node->parent());
+    updateNode(node->parent(), change);
   }
 }
 
 void MapRenderer::removeNode(mdl::Node* node)
 {
+  m_hiddenNodes.erase(node);
+  m_evictedNodes.erase(node);
+
   if (auto it = m_trackedNodes.find(node); it != m_trackedNodes.end())
   {
     const auto renderers = it->second;
@@ -576,11 +940,17 @@ void MapRenderer::removeNode(mdl::Node* node)
 
     m_trackedNodes.erase(it);
 
+    if (renderers & int(Renderer::Default))
+    {
+      m_detailBrushes.clear();
+    }
+
     // At this point, none of the default/selection/locked renderers,
     // or their underlying node-type specific renderers, have a reference
     // to `node` anymore, and they won't render it.
 
     m_entityDecalRenderer->removeNode(node);
+    m_entityLinkRenderer->removeNode(node);
   }
 }
 
@@ -609,6 +979,65 @@ void MapRenderer::updateAllNodes()
   updateAndInvalidateNodeRecursive(m_map.world());
 }
 
+/**
+ * Records when the given node was found to be hidden, or forgets that it was hidden if it
+ * is visible again. Returns whether the given node is evicted.
+ */
+bool MapRenderer::updateEviction(mdl::Node* node)
+{
+  if (node->visible())
+  {
+    m_hiddenNodes.erase(node);
+    m_evictedNodes.erase(node);
+    return false;
+  }
+
+  if (m_evictedNodes.contains(node))
+  {
+    return true;
+  }
+
+  m_hiddenNodes.try_emplace(node, std::chrono::steady_clock::now());
+  return false;
+}
+
+/**
+ * Removes the nodes that have been hidden for longer than HiddenNodeEvictionDelay from
+ * all renderers and releases their cached vertices. They are added to the renderers
+ * again by updateAndInvalidateNode() once they are shown.
+ */
+void MapRenderer::evictHiddenNodes()
+{
+  if (m_hiddenNodes.empty())
+  {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  const auto nodesToEvict =
+    m_hiddenNodes | std::views::filter([&](const auto& entry) {
+      return now - entry.second >= HiddenNodeEvictionDelay;
+    })
+    | std::views::keys | kdl::ranges::to<std::vector>();
+
+  for (auto* node : nodesToEvict)
+  {
+    m_hiddenNodes.erase(node);
+    m_evictedNodes.insert(node);
+    updateAndInvalidateNode(node);
+
+    node->accept(kdl::overload(
+      [](mdl::WorldNode*) {},
+      [](mdl::LayerNode*) {},
+      [](mdl::GroupNode*) {},
+      [](mdl::EntityNode*) {},
+      [](mdl::BrushNode* brushNode) {
+        brushNode->brushRendererBrushCache().releaseVertexCache();
+      },
+      [](mdl::PatchNode*) {}));
+  }
+}
+
 /**
  * Marks the nodes that are already tracked in the given renderers as invalid, i.e.
  * needing to be re-rendered.
@@ -629,6 +1058,13 @@ void MapRenderer::invalidateRenderers(const Renderer renderers)
   }
 }
 
+void MapRenderer::invalidateGroupBounds()
+{
+  m_defaultRenderer->invalidateGroups();
+  m_selectionRenderer->invalidateGroups();
+  m_lockedRenderer->invalidateGroups();
+}
+
 void MapRenderer::invalidateEntityDecalRenderer()
 {
   m_entityDecalRenderer->invalidate();
@@ -664,7 +1100,7 @@ void MapRenderer::connectObservers()
   m_notifierConnection +=
     m_map.nodesWereRemovedNotifier.connect(this, &MapRenderer::nodesWereRemoved);
   m_notifierConnection +=
-    m_map.nodesDidChangeNotifier.connect(this, &MapRenderer::nodesDidChange);
+    m_map.nodesDidChangeBatchedNotifier.connect(this, &MapRenderer::nodesDidChange);
   m_notifierConnection += m_map.nodeVisibilityDidChangeNotifier.connect(
     this, &MapRenderer::nodeVisibilityDidChange);
   m_notifierConnection +=
@@ -716,8 +1152,7 @@ void MapRenderer::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
     // ourselves.
     updateAndInvalidateNodeRecursive(node);
   }
-  invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  m_groupLinkRenderer->invalidateLinkedGroups();
 }
 
 void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
@@ -728,8 +1163,7 @@ void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
     // ourselves. Otherwise deleting a group doesn't delete the brushes within.
     removeNodeRecursive(node);
   }
-  invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  m_groupLinkRenderer->invalidateLinkedGroups();
 }
 
 void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
@@ -741,8 +1175,7 @@ void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
     // it would cause the entire map to be invalidated on every change.
     updateAndInvalidateNode(node);
   }
-  invalidateEntityLinkRenderer();
-  invalidateGroupLinkRenderer();
+  m_groupLinkRenderer->nodesDidChange(nodes);
 }
 
 void MapRenderer::nodeVisibilityDidChange(const std::vector<mdl::Node*>& nodes)
@@ -751,7 +1184,6 @@ void MapRenderer::nodeVisibilityDidChange(const std::vector<mdl::Node*>& nodes)
   {
     updateAndInvalidateNodeRecursive(node);
   }
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::nodeLockingDidChange(const std::vector<mdl::Node*>& nodes)
@@ -760,17 +1192,19 @@ void MapRenderer::nodeLockingDidChange(const std::vector<mdl::Node*>& nodes)
   {
     updateAndInvalidateNodeRecursive(node);
   }
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::groupWasOpened(mdl::GroupNode&)
 {
+  // the bounds of a group are only shown if it belongs to the current group
+  invalidateGroupBounds();
   invalidateGroupLinkRenderer();
   invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::groupWasClosed(mdl::GroupNode&)
 {
+  invalidateGroupBounds();
   invalidateGroupLinkRenderer();
   invalidateEntityLinkRenderer();
 }
@@ -797,14 +1231,13 @@ void MapRenderer::selectionDidChange(const mdl::SelectionChange& selectionChange
   // selected
   for (auto* node : selectionChange.deselectedNodes)
   {
-    updateAndInvalidateNodeRecursive(node);
+    updateNodeSelectionRecursive(node);
   }
   for (auto* node : selectionChange.selectedNodes)
   {
-    updateAndInvalidateNodeRecursive(node);
+    updateNodeSelectionRecursive(node);
   }
 
-  invalidateEntityLinkRenderer();
   invalidateGroupLinkRenderer();
 }
 
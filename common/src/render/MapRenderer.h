@@ -21,15 +21,20 @@
 
 #include "Macros.h"
 #include "NotifierConnection.h"
+#include "mdl/NodeSlotMap.h"
 
+#include <chrono>
 #include <filesystem>
-#include <unordered_map>
+#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace tb
 {
 class Color;
-}
+class MemoryReport;
+} // namespace tb
 
 namespace tb::mdl
 {
@@ -45,6 +50,7 @@ struct SelectionChange;
 
 namespace tb::render
 {
+class Camera;
 class EntityDecalRenderer;
 class EntityLinkRenderer;
 class GroupLinkRenderer;
@@ -72,7 +78,35 @@ private:
     All = Default | Selection | Locked
   };
 
-  std::unordered_map<mdl::Node*, int> m_trackedNodes;
+  /**
+   * What changed about a node that is updated. Selection changes don't move brushes
+   * between the default renderer and the other renderers, see updateNode().
+   */
+  enum class NodeChange
+  {
+    Any,
+    Selection,
+  };
+
+  mdl::NodeSlotMap<mdl::Node, int> m_trackedNodes;
+
+  /**
+   * The hidden nodes that still have render data, and when they were found to be hidden.
+   * Once a node has been hidden for long enough, its render data is released and it is
+   * moved to m_evictedNodes. Evicted nodes are not added to any renderer until they are
+   * shown again.
+   */
+  mdl::NodeSlotMap<mdl::Node, std::chrono::steady_clock::time_point> m_hiddenNodes;
+  mdl::NodeSlotSet<mdl::Node> m_evictedNodes;
+
+  /**
+   * The unselected brushes that are at least as large as a pixel of a 2D view, by the
+   * view axis and the pixel size of the view, or null if no brush is smaller than a
+   * pixel. Cleared whenever a node is updated.
+   */
+  using DetailBrushesKey = std::pair<size_t, double>;
+  std::map<DetailBrushesKey, std::shared_ptr<const std::vector<const mdl::BrushNode*>>>
+    m_detailBrushes;
 
   NotifierConnection m_notifierConnection;
 
@@ -89,10 +123,26 @@ public: // color config
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Returns true if the last frame didn't apply all changes to the map because they
+   * exceeded the time budget of a frame. The views must then render another frame.
+   */
+  bool hasPendingUpdates() const;
+
+public: // diagnostics
+  /**
+   * Adds the sizes of the vertex and index arrays of the default, selection and locked
+   * renderers to the given report.
+   */
+  void addToMemoryReport(MemoryReport& report) const;
+
 private:
   void reload();
   void clear();
 
+  void cullBrushes(RenderContext& renderContext);
+  std::shared_ptr<const std::vector<const mdl::BrushNode*>> findDetailBrushes(
+    const Camera& camera, double pixelSize);
   void setupGL(RenderBatch& renderBatch);
   void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -100,6 +150,7 @@ private:
   void renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+  void renderOcclusionQueries(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderEntityDecals(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderGroupLinks(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -112,11 +163,17 @@ private:
   static int determineDesiredRenderers(mdl::Node* node);
   void updateAndInvalidateNode(mdl::Node* node);
   void updateAndInvalidateNodeRecursive(mdl::Node* node);
+  void updateNodeSelectionRecursive(mdl::Node* node);
+  void updateNode(mdl::Node* node, NodeChange change);
+  void updateNodeRecursive(mdl::Node* node, NodeChange change);
   void removeNode(mdl::Node* node);
   void removeNodeRecursive(mdl::Node* node);
   void updateAllNodes();
+  bool updateEviction(mdl::Node* node);
+  void evictHiddenNodes();
 
   void invalidateRenderers(Renderer renderers);
+  void invalidateGroupBounds();
   void invalidateEntityDecalRenderer();
   void invalidateEntityLinkRenderer();
   void invalidateGroupLinkRenderer();
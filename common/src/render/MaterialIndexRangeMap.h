@@ -175,6 +175,17 @@ public:
    */
   void render(VertexArray& vertexArray, MaterialRenderFunc& func);
 
+  /**
+   * Renders the given number of instances of the primitives stored in this index range
+   * map. The material callbacks are invoked once per material for all instances.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param func the material callbacks
+   * @param instanceCount the number of instances to render
+   */
+  void renderInstanced(
+    VertexArray& vertexArray, MaterialRenderFunc& func, size_t instanceCount);
+
   /**
    * Invokes the given function for each primitive stored in this map.
    *
@@ -24,6 +24,8 @@
 namespace tb::render
 {
 
+InstanceAttributes::~InstanceAttributes() = default;
+
 MaterialRenderer::~MaterialRenderer() = default;
 
 MaterialIndexRangeRenderer::MaterialIndexRangeRenderer() = default;
@@ -49,6 +51,11 @@ bool MaterialIndexRangeRenderer::empty() const
   return m_vertexArray.empty();
 }
 
+size_t MaterialIndexRangeRenderer::sizeInBytes() const
+{
+  return m_vertexArray.sizeInBytes();
+}
+
 void MaterialIndexRangeRenderer::prepare(VboManager& vboManager)
 {
   m_vertexArray.prepare(vboManager);
@@ -63,6 +70,20 @@ void MaterialIndexRangeRenderer::render(MaterialRenderFunc& func)
   }
 }
 
+void MaterialIndexRangeRenderer::renderInstanced(
+  MaterialRenderFunc& func,
+  InstanceAttributes& instanceAttributes,
+  const size_t instanceCount)
+{
+  if (m_vertexArray.setup())
+  {
+    instanceAttributes.setup();
+    m_indexRange.renderInstanced(m_vertexArray, func, instanceCount);
+    instanceAttributes.cleanup();
+    m_vertexArray.cleanup();
+  }
+}
+
 MultiMaterialIndexRangeRenderer::MultiMaterialIndexRangeRenderer(
   std::vector<std::unique_ptr<MaterialIndexRangeRenderer>> renderers)
   : m_renderers{std::move(renderers)}
@@ -83,6 +104,16 @@ bool MultiMaterialIndexRangeRenderer::empty() const
   return true;
 }
 
+size_t MultiMaterialIndexRangeRenderer::sizeInBytes() const
+{
+  auto result = size_t(0);
+  for (const auto& renderer : m_renderers)
+  {
+    result += renderer->sizeInBytes();
+  }
+  return result;
+}
+
 void MultiMaterialIndexRangeRenderer::prepare(VboManager& vboManager)
 {
   for (auto& renderer : m_renderers)
@@ -99,4 +130,15 @@ void MultiMaterialIndexRangeRenderer::render(MaterialRenderFunc& func)
   }
 }
 
+void MultiMaterialIndexRangeRenderer::renderInstanced(
+  MaterialRenderFunc& func,
+  InstanceAttributes& instanceAttributes,
+  const size_t instanceCount)
+{
+  for (auto& renderer : m_renderers)
+  {
+    renderer->renderInstanced(func, instanceAttributes, instanceCount);
+  }
+}
+
 } // namespace tb::render
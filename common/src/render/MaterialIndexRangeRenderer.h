@@ -35,6 +35,20 @@ namespace tb::render
 class VboManager;
 class MaterialRenderFunc;
 
+/**
+ * Sets up the per-instance vertex attributes for instanced rendering. The attributes are
+ * set up after the renderer's vertex array has been set up and cleaned up before it is
+ * cleaned up, so that they end up in the vertex array object that is bound for drawing.
+ */
+class InstanceAttributes
+{
+public:
+  virtual ~InstanceAttributes();
+
+  virtual void setup() = 0;
+  virtual void cleanup() = 0;
+};
+
 class MaterialRenderer
 {
 public:
@@ -42,8 +56,22 @@ public:
 
   virtual bool empty() const = 0;
 
+  /**
+   * Returns the size of the vertices rendered by this renderer in bytes.
+   */
+  virtual size_t sizeInBytes() const = 0;
+
   virtual void prepare(VboManager& vboManager) = 0;
   virtual void render(MaterialRenderFunc& func) = 0;
+
+  /**
+   * Renders the given number of instances with a single draw call per range, using the
+   * given per-instance attributes.
+   */
+  virtual void renderInstanced(
+    MaterialRenderFunc& func,
+    InstanceAttributes& instanceAttributes,
+    size_t instanceCount) = 0;
 };
 
 class MaterialIndexRangeRenderer : public MaterialRenderer
@@ -60,9 +88,14 @@ public:
   ~MaterialIndexRangeRenderer() override;
 
   bool empty() const override;
+  size_t sizeInBytes() const override;
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstanced(
+    MaterialRenderFunc& func,
+    InstanceAttributes& instanceAttributes,
+    size_t instanceCount) override;
 };
 
 class MultiMaterialIndexRangeRenderer : public MaterialRenderer
@@ -76,9 +109,14 @@ public:
   ~MultiMaterialIndexRangeRenderer() override;
 
   bool empty() const override;
+  size_t sizeInBytes() const override;
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstanced(
+    MaterialRenderFunc& func,
+    InstanceAttributes& instanceAttributes,
+    size_t instanceCount) override;
 };
 
 } // namespace tb::render
@@ -72,6 +72,22 @@ void ObjectRenderer::invalidateNode(mdl::Node* node)
     [&](mdl::PatchNode* patch) { m_patchRenderer.invalidatePatch(patch); }));
 }
 
+void ObjectRenderer::invalidateGroups()
+{
+  m_groupRenderer.invalidate();
+}
+
+void ObjectRenderer::updateNodeSelection(mdl::Node* node)
+{
+  node->accept(kdl::overload(
+    [](mdl::WorldNode*) {},
+    [](mdl::LayerNode*) {},
+    [&](mdl::GroupNode* group) { m_groupRenderer.invalidateGroup(group); },
+    [&](mdl::EntityNode* entity) { m_entityRenderer.invalidateEntity(entity); },
+    [&](mdl::BrushNode* brush) { m_brushRenderer.updateBrushSelection(brush); },
+    [&](mdl::PatchNode* patch) { m_patchRenderer.invalidatePatch(patch); }));
+}
+
 void ObjectRenderer::invalidate()
 {
   m_groupRenderer.invalidate();
@@ -207,6 +223,55 @@ void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects)
   m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
 }
 
+void ObjectRenderer::setVisibleBrushes(
+  std::shared_ptr<const std::vector<const mdl::BrushNode*>> visibleBrushes)
+{
+  m_brushRenderer.setVisibleBrushes(std::move(visibleBrushes));
+}
+
+void ObjectRenderer::cullBrushes(const std::vector<vm::plane3d>& viewVolume)
+{
+  m_brushRenderer.cullBrushes(viewVolume);
+}
+
+void ObjectRenderer::setViewVolume(
+  std::shared_ptr<const std::vector<vm::plane3d>> viewVolume)
+{
+  m_brushRenderer.setViewVolume(std::move(viewVolume));
+}
+
+void ObjectRenderer::setVisibleEntities(
+  std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities)
+{
+  m_entityRenderer.setVisibleEntities(std::move(visibleEntities));
+}
+
+void ObjectRenderer::setBrushChunkSize(const std::optional<double> chunkSize)
+{
+  m_brushRenderer.setChunkSize(chunkSize);
+}
+
+void ObjectRenderer::setHideSelectedBrushes(const bool hideSelectedBrushes)
+{
+  m_brushRenderer.setHideSelectedBrushes(hideSelectedBrushes);
+}
+
+void ObjectRenderer::setBrushCoarseChunkSize(const std::optional<double> coarseChunkSize)
+{
+  m_brushRenderer.setCoarseChunkSize(coarseChunkSize);
+}
+
+void ObjectRenderer::setTaskManager(kdl::task_manager* taskManager)
+{
+  m_brushRenderer.setTaskManager(taskManager);
+}
+
+void ObjectRenderer::setBrushValidationTimeBudget(
+  const std::optional<std::chrono::steady_clock::duration> validationTimeBudget)
+{
+  m_brushRenderer.setValidationTimeBudget(validationTimeBudget);
+}
+
 void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   m_brushRenderer.renderOpaque(renderContext, renderBatch);
@@ -221,4 +286,14 @@ void ObjectRenderer::renderTransparent(
   m_brushRenderer.renderTransparent(renderContext, renderBatch);
 }
 
+bool ObjectRenderer::hasPendingUpdates() const
+{
+  return !m_brushRenderer.valid();
+}
+
+void ObjectRenderer::addToMemoryReport(MemoryReport& report) const
+{
+  m_brushRenderer.addToMemoryReport(report);
+}
+
 } // namespace tb::render
@@ -25,12 +25,19 @@
 #include "render/GroupRenderer.h"
 #include "render/PatchRenderer.h"
 
+#include "vm/plane.h"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <unordered_set>
 #include <vector>
 
 namespace tb
 {
 class Color;
 class Logger;
+class MemoryReport;
 } // namespace tb
 
 namespace tb::mdl
@@ -78,6 +85,17 @@ public: // object management
   void invalidateMaterials(const std::vector<const mdl::Material*>& materials);
   void invalidateEntityModels(const std::vector<const mdl::EntityModel*>& entityModels);
   void invalidateNode(mdl::Node* node);
+
+  /**
+   * Invalidates the bounds of all groups, e.g. because the current group changed.
+   */
+  void invalidateGroups();
+
+  /**
+   * Updates the given node after it was selected or deselected. Brushes only update
+   * their hidden flags if selected brushes are hidden, other nodes are invalidated.
+   */
+  void updateNodeSelection(mdl::Node* node);
   void invalidate();
   void clear();
   void reloadModels();
@@ -111,10 +129,32 @@ public: // configuration
 
   void setShowHiddenObjects(bool showHiddenObjects);
 
+  void setVisibleBrushes(
+    std::shared_ptr<const std::vector<const mdl::BrushNode*>> visibleBrushes);
+  void cullBrushes(const std::vector<vm::plane3d>& viewVolume);
+  void setViewVolume(std::shared_ptr<const std::vector<vm::plane3d>> viewVolume);
+  void setVisibleEntities(
+    std::shared_ptr<const std::unordered_set<const mdl::EntityNode*>> visibleEntities);
+  void setBrushChunkSize(std::optional<double> chunkSize);
+  void setHideSelectedBrushes(bool hideSelectedBrushes);
+  void setBrushCoarseChunkSize(std::optional<double> coarseChunkSize);
+  void setTaskManager(kdl::task_manager* taskManager);
+  void setBrushValidationTimeBudget(
+    std::optional<std::chrono::steady_clock::duration> validationTimeBudget);
+
 public: // rendering
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Returns true if some brushes weren't validated in the last frame because the
+   * validation time budget was exceeded.
+   */
+  bool hasPendingUpdates() const;
+
+public: // diagnostics
+  void addToMemoryReport(MemoryReport& report) const;
+
   deleteCopy(ObjectRenderer);
 };
 
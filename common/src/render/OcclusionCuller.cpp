@@ -0,0 +1,239 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OcclusionCuller.h"
+
+#include "Color.h"
+#include "render/ActiveShader.h"
+#include "render/Camera.h"
+#include "render/PrimType.h"
+#include "render/RenderBatch.h"
+#include "render/RenderContext.h"
+#include "render/Shaders.h"
+
+#include "vm/vec.h"
+
+#include <algorithm>
+
+namespace tb::render
+{
+namespace
+{
+
+/**
+ * The bounding box of a cell must not be clipped by the near plane, otherwise it could be
+ * culled even though it is visible. Cells whose bounds are closer to the camera than this
+ * multiple of the near plane distance are treated as containing the camera.
+ */
+constexpr auto NearPlaneMargin = 4.0;
+
+/**
+ * The number of vertices that a bounding box is rendered with, four per face.
+ */
+constexpr auto VerticesPerCell = size_t(24);
+
+GLuint queryResult(const GLuint query, const GLenum pname)
+{
+  auto result = GLuint(0);
+  glAssert(glGetQueryObjectuiv(query, pname, &result));
+  return result;
+}
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller() = default;
+
+// The query objects are owned by the view's OpenGL context and are released with it.
+OcclusionCuller::~OcclusionCuller() = default;
+
+void OcclusionCuller::beginFrame(const Camera& camera)
+{
+  m_camera = &camera;
+  m_queriedCells.clear();
+
+  for (auto it = m_cells.begin(); it != m_cells.end();)
+  {
+    auto& cell = it->second;
+    if (!cell.tested)
+    {
+      releaseQuery(cell);
+      it = m_cells.erase(it);
+      continue;
+    }
+
+    if (cell.queryPending && queryResult(cell.query, GL_QUERY_RESULT_AVAILABLE))
+    {
+      cell.occluded = queryResult(cell.query, GL_QUERY_RESULT) == 0;
+      cell.queryPending = false;
+    }
+    cell.culledAtBeginFrame = cell.occluded;
+    cell.tested = false;
+    ++it;
+  }
+}
+
+bool OcclusionCuller::testCell(const CellKey& key, const vm::bbox3d& bounds)
+{
+  auto& cell = m_cells[key];
+  cell.bounds = bounds;
+  cell.tested = true;
+  cell.containsCamera =
+    m_camera
+    && bounds.expand(NearPlaneMargin * double(m_camera->nearPlane()))
+         .contains(vm::vec3d{m_camera->position()});
+
+  if (cell.containsCamera)
+  {
+    cell.occluded = false;
+  }
+  return !cell.occluded;
+}
+
+bool OcclusionCuller::isOccluded(const vm::bbox3d& bounds) const
+{
+  return std::ranges::any_of(m_cells, [&](const auto& entry) {
+    const auto& cell = entry.second;
+    return cell.occluded && cell.bounds.contains(bounds);
+  });
+}
+
+void OcclusionCuller::render(RenderBatch& renderBatch)
+{
+  m_queriedCells.clear();
+  for (auto& [key, cell] : m_cells)
+  {
+    if (cell.tested && !cell.containsCamera)
+    {
+      m_queriedCells.push_back(&cell);
+    }
+  }
+
+  if (!m_queriedCells.empty())
+  {
+    renderBatch.add(this);
+  }
+}
+
+bool OcclusionCuller::endFrame()
+{
+  for (auto* cell : m_queriedCells)
+  {
+    if (cell->occluded && cell->queryPending)
+    {
+      cell->occluded = queryResult(cell->query, GL_QUERY_RESULT) == 0;
+      cell->queryPending = false;
+    }
+  }
+  m_queriedCells.clear();
+
+  // Objects may have been culled before the cell was tested in this frame, e.g. decals.
+  // A cell that was not tested is forgotten in the next frame, so it's visible then.
+  return std::ranges::any_of(m_cells, [](const auto& entry) {
+    const auto& cell = entry.second;
+    return cell.culledAtBeginFrame && (!cell.occluded || !cell.tested);
+  });
+}
+
+GLuint OcclusionCuller::acquireQuery()
+{
+  if (!m_unusedQueries.empty())
+  {
+    const auto query = m_unusedQueries.back();
+    m_unusedQueries.pop_back();
+    return query;
+  }
+
+  auto query = GLuint(0);
+  glAssert(glGenQueries(1, &query));
+  return query;
+}
+
+void OcclusionCuller::releaseQuery(Cell& cell)
+{
+  if (cell.query != 0)
+  {
+    m_unusedQueries.push_back(cell.query);
+    cell.query = 0;
+    cell.queryPending = false;
+  }
+}
+
+void OcclusionCuller::doPrepareVertices(VboManager& vboManager)
+{
+  auto vertices = std::vector<Vertex>{};
+  vertices.reserve(m_queriedCells.size() * VerticesPerCell);
+  for (const auto* cell : m_queriedCells)
+  {
+    cell->bounds.for_each_face([&](
+                                 const vm::vec3d& v1,
+                                 const vm::vec3d& v2,
+                                 const vm::vec3d& v3,
+                                 const vm::vec3d& v4,
+                                 const vm::vec3d&) {
+      vertices.emplace_back(vm::vec3f{v1});
+      vertices.emplace_back(vm::vec3f{v2});
+      vertices.emplace_back(vm::vec3f{v3});
+      vertices.emplace_back(vm::vec3f{v4});
+    });
+  }
+
+  m_vertexArray = VertexArray::stream(std::move(vertices));
+  m_vertexArray.prepare(vboManager);
+}
+
+void OcclusionCuller::doRender(RenderContext& renderContext)
+{
+  glAssert(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+  glAssert(glDepthMask(GL_FALSE));
+  glAssert(glDisable(GL_CULL_FACE));
+
+  auto shader =
+    ActiveShader{renderContext.shaderManager(), Shaders::VaryingPUniformCShader};
+  shader.set("Color", Color{1.0f, 1.0f, 1.0f, 1.0f});
+
+  if (m_vertexArray.setup())
+  {
+    for (size_t i = 0; i < m_queriedCells.size(); ++i)
+    {
+      auto& cell = *m_queriedCells[i];
+      if (cell.query == 0)
+      {
+        cell.query = acquireQuery();
+      }
+
+      glAssert(glBeginQuery(GL_SAMPLES_PASSED, cell.query));
+      m_vertexArray.render(
+        PrimType::Quads, GLint(i * VerticesPerCell), GLsizei(VerticesPerCell));
+      glAssert(glEndQuery(GL_SAMPLES_PASSED));
+      cell.queryPending = true;
+    }
+    m_vertexArray.cleanup();
+  }
+
+  glAssert(glEnable(GL_CULL_FACE));
+  glAssert(glDepthMask(GL_TRUE));
+  glAssert(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+}
+
+std::string OcclusionCuller::profileLabel() const
+{
+  return "Occlusion queries";
+}
+
+} // namespace tb::render
@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "render/GL.h"
+#include "render/GLVertexType.h"
+#include "render/Renderable.h"
+#include "render/VertexArray.h"
+
+#include "vm/bbox.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tb::render
+{
+class Camera;
+class RenderBatch;
+
+/**
+ * Culls objects that are hidden behind other geometry using hardware occlusion queries.
+ *
+ * The scene is divided into cells, each of which is identified by a key and covers the
+ * bounds given by the client, e.g. the chunks of a BrushRenderer. After the opaque
+ * geometry of a frame has been rendered, the bounding box of every cell that was tested
+ * in the frame is rendered without writing color or depth, and a query counts the samples
+ * that pass the depth test. A cell is culled if no sample passed in the previous frame.
+ * Since the camera is outside of the bounding box of a culled cell, anything contained in
+ * its bounds is hidden, too.
+ *
+ * The results of visible cells are read in the next frame, and only if they are available
+ * by then, so that reading them never stalls the pipeline. The results of culled cells
+ * are read at the end of the frame, because if a culled cell has become visible, e.g.
+ * because the camera moved, the frame must be rendered again. Objects other than the
+ * cells themselves, such as entity models, are culled using the results of the previous
+ * frame.
+ *
+ * Query objects are not shared between OpenGL contexts, so each view has its own culler.
+ */
+class OcclusionCuller : public DirectRenderable
+{
+public:
+  using CellKey = std::tuple<int, int, int>;
+
+private:
+  using Vertex = GLVertexTypes::P3::Vertex;
+
+  struct Cell
+  {
+    vm::bbox3d bounds;
+    GLuint query = 0;
+    bool queryPending = false;
+    bool occluded = false;
+    bool culledAtBeginFrame = false;
+    bool tested = false;
+    bool containsCamera = false;
+  };
+
+  std::map<CellKey, Cell> m_cells;
+  std::vector<GLuint> m_unusedQueries;
+  const Camera* m_camera = nullptr;
+
+  std::vector<Cell*> m_queriedCells;
+  VertexArray m_vertexArray;
+
+public:
+  OcclusionCuller();
+  ~OcclusionCuller() override;
+
+  /**
+   * Reads the available results of the queries issued in the previous frame. Cells that
+   * were not tested in the previous frame are forgotten.
+   */
+  void beginFrame(const Camera& camera);
+
+  /**
+   * Returns whether the given cell may be visible, and queries it at the end of the
+   * opaque pass. A cell that contains the camera is always visible.
+   */
+  bool testCell(const CellKey& key, const vm::bbox3d& bounds);
+
+  /**
+   * Returns whether the given bounds are entirely contained in a culled cell. This can be
+   * called before the cells are tested in the current frame.
+   */
+  bool isOccluded(const vm::bbox3d& bounds) const;
+
+  /**
+   * Queries the cells that were tested in this frame. Must be added to the render batch
+   * after the opaque geometry.
+   */
+  void render(RenderBatch& renderBatch);
+
+  /**
+   * Waits for the results of the culled cells. Returns true if any cell that was culled
+   * at the beginning of the frame has become visible, in which case the frame must be
+   * rendered again.
+   */
+  bool endFrame();
+
+  std::string profileLabel() const override;
+
+private:
+  GLuint acquireQuery();
+  void releaseQuery(Cell& cell);
+
+  void doPrepareVertices(VboManager& vboManager) override;
+  void doRender(RenderContext& renderContext) override;
+
+  deleteCopyAndMove(OcclusionCuller);
+};
+
+} // namespace tb::render
@@ -36,6 +36,7 @@
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
 #include "render/VertexArray.h"
+#include "render/VertexCacheOptimizer.h"
 
 #include "kdl/vector_utils.h"
 
@@ -134,6 +135,8 @@ void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
     validate();
   }
 
+  m_currentMesh = &updateMesh(renderContext.camera());
+
   if (renderContext.showFaces())
   {
     renderBatch.add(this);
@@ -143,28 +146,73 @@ void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
   {
     if (m_showOccludedEdges)
     {
-      m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+      m_currentMesh->edgeRenderer.renderWithOccluded(
+        renderBatch, m_edgeColor, m_occludedEdgeColor);
+    }
+    else
+    {
+      m_currentMesh->edgeRenderer.render(renderBatch, m_edgeColor);
     }
-    m_edgeRenderer.render(renderBatch, m_edgeColor);
   }
 }
 
-static MaterialIndexArrayRenderer buildMeshRenderer(
+namespace
+{
+
+/**
+ * The maximum distance in pixels between the rendered grid of a patch and its actual
+ * surface. The 2D views only show the outlines of patches, so they can use coarser grids.
+ */
+constexpr auto MaxGridErrorInPixels3D = 1.0;
+constexpr auto MaxGridErrorInPixels2D = 2.0;
+
+size_t selectSubdivisions(const mdl::PatchNode& patchNode, const Camera& camera)
+{
+  // the point of the patch's bounds that is closest to the camera is the one where the
+  // grid error appears largest
+  const auto& bounds = patchNode.grid().bounds;
+  const auto closestPoint =
+    vm::max(bounds.min, vm::min(bounds.max, vm::vec3d{camera.position()}));
+  const auto worldUnitsPerPixel =
+    double(camera.perspectiveScalingFactor(vm::vec3f{closestPoint}));
+  if (worldUnitsPerPixel <= 0.0)
+  {
+    return mdl::PatchNode::DefaultSubdivisionsPerSurface;
+  }
+
+  const auto maxGridError = worldUnitsPerPixel * (camera.orthographicProjection()
+                                                    ? MaxGridErrorInPixels2D
+                                                    : MaxGridErrorInPixels3D);
+  for (size_t subdivisions = 0u;
+       subdivisions < mdl::PatchNode::DefaultSubdivisionsPerSurface;
+       ++subdivisions)
+  {
+    if (patchNode.gridError(subdivisions) <= maxGridError)
+    {
+      return subdivisions;
+    }
+  }
+  return mdl::PatchNode::DefaultSubdivisionsPerSurface;
+}
+
+MaterialIndexArrayRenderer buildMeshRenderer(
   const std::vector<const mdl::PatchNode*>& patchNodes,
+  const std::vector<size_t>& subdivisions,
   const mdl::EditorContext& editorContext)
 {
   size_t vertexCount = 0u;
   auto indexArrayMapSize = MaterialIndexArrayMap::Size{};
 
-  for (const auto* patchNode : patchNodes)
+  for (size_t i = 0u; i < patchNodes.size(); ++i)
   {
+    const auto* patchNode = patchNodes[i];
     if (editorContext.visible(*patchNode))
     {
-      vertexCount += patchNode->grid().pointRowCount * patchNode->grid().pointColumnCount;
+      const auto& grid = patchNode->grid(subdivisions[i]);
+      vertexCount += grid.pointRowCount * grid.pointColumnCount;
 
       const auto* material = patchNode->patch().material();
-      const auto quadCount =
-        patchNode->grid().quadRowCount() * patchNode->grid().quadColumnCount();
+      const auto quadCount = grid.quadRowCount() * grid.quadColumnCount();
       indexArrayMapSize.inc(material, PrimType::Triangles, 6u * quadCount);
     }
   }
@@ -175,14 +223,16 @@ static MaterialIndexArrayRenderer buildMeshRenderer(
 
   auto indexArrayMapBuilder = MaterialIndexArrayMapBuilder{indexArrayMapSize};
   using Index = MaterialIndexArrayMapBuilder::Index;
+  auto patchIndices = std::vector<Index>{};
 
-  for (const auto* patchNode : patchNodes)
+  for (size_t i = 0u; i < patchNodes.size(); ++i)
   {
+    const auto* patchNode = patchNodes[i];
     if (editorContext.visible(*patchNode))
     {
       const auto vertexOffset = vertices.size();
 
-      const auto& grid = patchNode->grid();
+      const auto& grid = patchNode->grid(subdivisions[i]);
       auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) {
         return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.uvCoords}};
       });
@@ -190,6 +240,9 @@ static MaterialIndexArrayRenderer buildMeshRenderer(
 
       const auto* material = patchNode->patch().material();
 
+      // patches are static geometry, so it pays off to order their triangles for the
+      // vertex cache
+      patchIndices.clear();
       const auto pointsPerRow = grid.pointColumnCount;
       for (size_t row = 0u; row < grid.quadRowCount(); ++row)
       {
@@ -200,18 +253,17 @@ static MaterialIndexArrayRenderer buildMeshRenderer(
           const auto i2 = vertexOffset + (row + 1u) * pointsPerRow + col + 1u;
           const auto i3 = vertexOffset + (row + 1u) * pointsPerRow + col;
 
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i0),
-            static_cast<Index>(i1),
-            static_cast<Index>(i2));
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i2),
-            static_cast<Index>(i3),
-            static_cast<Index>(i0));
+          patchIndices.insert(
+            patchIndices.end(),
+            {static_cast<Index>(i0),
+             static_cast<Index>(i1),
+             static_cast<Index>(i2),
+             static_cast<Index>(i2),
+             static_cast<Index>(i3),
+             static_cast<Index>(i0)});
         }
       }
+      indexArrayMapBuilder.addTriangles(material, optimizeVertexCache(patchIndices));
     }
   }
 
@@ -223,19 +275,21 @@ static MaterialIndexArrayRenderer buildMeshRenderer(
     std::move(indexArrayMapBuilder.ranges())};
 }
 
-static DirectEdgeRenderer buildEdgeRenderer(
+DirectEdgeRenderer buildEdgeRenderer(
   const std::vector<const mdl::PatchNode*>& patchNodes,
+  const std::vector<size_t>& subdivisions,
   const mdl::EditorContext& editorContext)
 {
   size_t vertexCount = 0u;
   auto indexRangeMapSize = IndexRangeMap::Size{};
 
-  for (const auto* patchNode : patchNodes)
+  for (size_t i = 0u; i < patchNodes.size(); ++i)
   {
+    const auto* patchNode = patchNodes[i];
     if (editorContext.visible(*patchNode))
     {
-      vertexCount +=
-        (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
+      const auto& grid = patchNode->grid(subdivisions[i]);
+      vertexCount += (grid.pointRowCount + grid.pointColumnCount - 2u) * 2u;
       indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
     }
   }
@@ -243,11 +297,12 @@ static DirectEdgeRenderer buildEdgeRenderer(
   auto indexRangeMapBuilder =
     IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
 
-  for (const auto* patchNode : patchNodes)
+  for (size_t i = 0u; i < patchNodes.size(); ++i)
   {
+    const auto* patchNode = patchNodes[i];
     if (editorContext.visible(*patchNode))
     {
-      const auto& grid = patchNode->grid();
+      const auto& grid = patchNode->grid(subdivisions[i]);
 
       auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
       edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
@@ -296,20 +351,43 @@ static DirectEdgeRenderer buildEdgeRenderer(
   return DirectEdgeRenderer{std::move(vertexArray), std::move(indexRangeMap)};
 }
 
+} // namespace
+
 void PatchRenderer::validate()
 {
   if (!m_valid)
   {
-    m_patchMeshRenderer = buildMeshRenderer(m_patchNodes.get_data(), m_editorContext);
-    m_edgeRenderer = buildEdgeRenderer(m_patchNodes.get_data(), m_editorContext);
+    m_meshes.clear();
+    m_currentMesh = nullptr;
 
     m_valid = true;
   }
 }
 
+PatchRenderer::PatchMesh& PatchRenderer::updateMesh(const Camera& camera)
+{
+  const auto& patchNodes = m_patchNodes.get_data();
+  auto subdivisions = kdl::vec_transform(patchNodes, [&](const auto* patchNode) {
+    return selectSubdivisions(*patchNode, camera);
+  });
+
+  // the meshes are only rebuilt when a patch needs a different number of subdivisions
+  auto& mesh = m_meshes[&camera];
+  if (mesh.subdivisions != subdivisions)
+  {
+    mesh.meshRenderer = buildMeshRenderer(patchNodes, subdivisions, m_editorContext);
+    mesh.edgeRenderer = buildEdgeRenderer(patchNodes, subdivisions, m_editorContext);
+    mesh.subdivisions = std::move(subdivisions);
+  }
+  return mesh;
+}
+
 void PatchRenderer::prepareVerticesAndIndices(VboManager& vboManager)
 {
-  m_patchMeshRenderer.prepare(vboManager);
+  if (m_currentMesh)
+  {
+    m_currentMesh->meshRenderer.prepare(vboManager);
+  }
 }
 
 namespace
@@ -362,6 +440,11 @@ struct RenderFunc : public MaterialRenderFunc
 };
 } // namespace
 
+std::string PatchRenderer::profileLabel() const
+{
+  return "Patches";
+}
+
 void PatchRenderer::doRender(RenderContext& context)
 {
   auto& shaderManager = context.shaderManager();
@@ -415,7 +498,10 @@ void PatchRenderer::doRender(RenderContext& context)
   }
   */
 
-  m_patchMeshRenderer.render(func);
+  if (m_currentMesh)
+  {
+    m_currentMesh->meshRenderer.render(func);
+  }
 
   /*
   if (m_alpha < 1.0f) {
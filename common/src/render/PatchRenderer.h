@@ -26,6 +26,9 @@
 
 #include "kdl/vector_set.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace tb::mdl
 {
 class EditorContext;
@@ -34,6 +37,7 @@ class PatchNode;
 
 namespace tb::render
 {
+class Camera;
 class RenderBatch;
 class RenderContext;
 class VboManager;
@@ -43,11 +47,22 @@ class PatchRenderer : public IndexedRenderable
 private:
   const mdl::EditorContext& m_editorContext;
 
+  /**
+   * The tessellated patches as seen by one camera. Each patch is tessellated with a
+   * number of subdivisions that depends on its distance to the camera.
+   */
+  struct PatchMesh
+  {
+    std::vector<size_t> subdivisions;
+    MaterialIndexArrayRenderer meshRenderer;
+    DirectEdgeRenderer edgeRenderer;
+  };
+
   bool m_valid = true;
   kdl::vector_set<const mdl::PatchNode*> m_patchNodes;
 
-  MaterialIndexArrayRenderer m_patchMeshRenderer;
-  DirectEdgeRenderer m_edgeRenderer;
+  std::unordered_map<const Camera*, PatchMesh> m_meshes;
+  PatchMesh* m_currentMesh = nullptr;
 
   Color m_defaultColor;
   bool m_grayscale = false;
@@ -115,8 +130,11 @@ public:
 
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  std::string profileLabel() const override;
+
 private:
   void validate();
+  PatchMesh& updateMesh(const Camera& camera);
 
 private: // implement IndexedRenderable interface
   void prepareVerticesAndIndices(VboManager& vboManager) override;
@@ -25,106 +25,102 @@
 #include "render/Camera.h"
 #include "render/RenderContext.h"
 #include "render/Shaders.h"
+#include "render/PrimType.h"
 #include "render/VboManager.h"
 
-#include "vm/mat_ext.h"
 #include "vm/vec.h"
 
 namespace tb::render
 {
 
-PointHandleRenderer::PointHandleRenderer()
-  : m_handle{pref(Preferences::HandleRadius), 16, true}
-  , m_highlight{2.0f * pref(Preferences::HandleRadius), 16, false}
-{
-}
+PointHandleRenderer::PointHandleRenderer() = default;
 
 void PointHandleRenderer::addPoint(const Color& color, const vm::vec3f& position)
 {
-  m_pointHandles[color].push_back(position);
+  m_pointHandles.emplace_back(position, color);
 }
 
 void PointHandleRenderer::addHighlight(const Color& color, const vm::vec3f& position)
 {
-  m_highlights[color].push_back(position);
+  m_highlights.emplace_back(position, color);
 }
 
 void PointHandleRenderer::doPrepareVertices(VboManager& vboManager)
 {
-  m_handle.prepare(vboManager);
-  m_highlight.prepare(vboManager);
+  m_pointHandleArray = VertexArray::move(std::move(m_pointHandles));
+  m_highlightArray = VertexArray::move(std::move(m_highlights));
+  m_pointHandleArray.prepare(vboManager);
+  m_highlightArray.prepare(vboManager);
 }
 
 void PointHandleRenderer::doRender(RenderContext& renderContext)
 {
-  const auto& camera = renderContext.camera();
-  const auto& viewport = camera.viewport();
-  const auto projection = vm::ortho_matrix(
-    0.0f,
-    1.0f,
-    static_cast<float>(viewport.x),
-    static_cast<float>(viewport.height),
-    static_cast<float>(viewport.width),
-    static_cast<float>(viewport.y));
-  const auto view = vm::view_matrix(vm::vec3f{0, 0, -1}, vm::vec3f{0, 1, 0});
-  auto ortho = ReplaceTransformation{renderContext.transformation(), projection, view};
+  const auto handleRadius = pref(Preferences::HandleRadius);
+  const auto highlightRadius = 2.0f * handleRadius;
+
+  glAssert(glEnable(GL_VERTEX_PROGRAM_POINT_SIZE));
+  glAssert(glEnable(GL_POINT_SPRITE));
 
   if (renderContext.render3D())
   {
     // Un-occluded handles: use depth test, draw fully opaque
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
+    renderHandles(renderContext, m_pointHandleArray, handleRadius, false, 1.0f);
+    renderHandles(renderContext, m_highlightArray, highlightRadius, true, 1.0f);
 
     // Occluded handles: don't use depth test, but draw translucent
     glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 0.33f);
-    renderHandles(renderContext, m_highlights, m_highlight, 0.33f);
+    renderHandles(renderContext, m_pointHandleArray, handleRadius, false, 0.33f);
+    renderHandles(renderContext, m_highlightArray, highlightRadius, true, 0.33f);
     glAssert(glEnable(GL_DEPTH_TEST));
   }
   else
   {
     // In 2D views, render fully opaque without depth test
     glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
+    renderHandles(renderContext, m_pointHandleArray, handleRadius, false, 1.0f);
+    renderHandles(renderContext, m_highlightArray, highlightRadius, true, 1.0f);
     glAssert(glEnable(GL_DEPTH_TEST));
   }
 
+  glAssert(glDisable(GL_POINT_SPRITE));
+  glAssert(glDisable(GL_VERTEX_PROGRAM_POINT_SIZE));
+
   clear();
 }
 
 void PointHandleRenderer::renderHandles(
-  RenderContext& renderContext, const HandleMap& map, Circle& circle, const float opacity)
+  RenderContext& renderContext,
+  VertexArray& vertexArray,
+  const float radius,
+  const bool outline,
+  const float opacity)
 {
-  const auto& camera = renderContext.camera();
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::HandleShader};
-
-  for (const auto& [color, positions] : map)
+  if (vertexArray.empty())
   {
-    shader.set("Color", mixAlpha(color, opacity));
-
-    for (const auto& position : positions)
-    {
-      // In 3D view, nudge towards camera by the handle radius, to prevent lines (brush
-      // edges, etc.) from clipping into the handle
-      const auto nudgeTowardsCamera =
-        renderContext.render3D()
-          ? vm::normalize(camera.position() - position) * pref(Preferences::HandleRadius)
-          : vm::vec3f{0, 0, 0};
-
-      const auto offset =
-        camera.project(position + nudgeTowardsCamera) * vm::vec3f{1, 1, -1};
-      auto translate = MultiplyModelMatrix{
-        renderContext.transformation(), vm::translation_matrix(offset)};
-      circle.render();
-    }
+    return;
   }
+
+  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::PointHandleShader};
+  shader.set("CameraPosition", renderContext.camera().position());
+
+  // In 3D view, nudge towards camera by the handle radius, to prevent lines (brush
+  // edges, etc.) from clipping into the handle
+  shader.set(
+    "NudgeDistance",
+    renderContext.render3D() ? pref(Preferences::HandleRadius) : 0.0f);
+  shader.set("PointSize", 2.0f * radius);
+  shader.set("Outline", outline);
+  shader.set("Opacity", opacity);
+
+  vertexArray.render(PrimType::Points);
 }
 
 void PointHandleRenderer::clear()
 {
   m_pointHandles.clear();
   m_highlights.clear();
+  m_pointHandleArray = VertexArray{};
+  m_highlightArray = VertexArray{};
 }
 
 } // namespace tb::render
@@ -20,10 +20,11 @@
 #pragma once
 
 #include "Color.h"
-#include "render/Circle.h"
+#include "render/GLVertexType.h"
 #include "render/Renderable.h"
+#include "render/VertexArray.h"
 
-#include <map>
+#include <vector>
 
 namespace tb::render
 {
@@ -31,16 +32,21 @@ class ActiveShader;
 class RenderContext;
 class VboManager;
 
+/**
+ * Renders point handles as point sprites. All handles are uploaded in a single vertex
+ * buffer and drawn with one draw call per pass, and the fragment shader cuts the circles
+ * out of the sprites.
+ */
 class PointHandleRenderer : public DirectRenderable
 {
 private:
-  using HandleMap = std::map<Color, std::vector<vm::vec3f>>;
+  using Vertex = GLVertexTypes::P3C4::Vertex;
 
-  HandleMap m_pointHandles;
-  HandleMap m_highlights;
+  std::vector<Vertex> m_pointHandles;
+  std::vector<Vertex> m_highlights;
 
-  Circle m_handle;
-  Circle m_highlight;
+  VertexArray m_pointHandleArray;
+  VertexArray m_highlightArray;
 
 public:
   PointHandleRenderer();
@@ -52,7 +58,11 @@ private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
   void renderHandles(
-    RenderContext& renderContext, const HandleMap& map, Circle& circle, float opacity);
+    RenderContext& renderContext,
+    VertexArray& vertexArray,
+    float radius,
+    bool outline,
+    float opacity);
 
   void clear();
 };
@@ -0,0 +1,173 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PortalRenderer.h"
+
+#include "mdl/PortalFile.h"
+#include "render/ActiveShader.h"
+#include "render/Camera.h"
+#include "render/GLVertexType.h"
+#include "render/PrimType.h"
+#include "render/RenderContext.h"
+#include "render/Shaders.h"
+
+#include "vm/polygon.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace tb::render
+{
+namespace
+{
+
+using Vertex = GLVertexTypes::P3::Vertex;
+using ChunkKey = std::tuple<int, int, int>;
+
+struct ChunkBuilder
+{
+  vm::bbox3f::builder bounds;
+  std::vector<Vertex> triangles;
+  std::vector<Vertex> edges;
+};
+
+ChunkKey chunkKey(const vm::bbox3f& bounds, const float chunkSize)
+{
+  const auto cell = vm::floor(bounds.center() / chunkSize);
+  return {int(cell.x()), int(cell.y()), int(cell.z())};
+}
+
+bool isAbovePlane(const vm::bbox3f& bounds, const vm::plane3f& plane)
+{
+  // the corner of the bounds that is furthest below the plane
+  const auto corner = vm::vec3f{
+    plane.normal.x() >= 0.0f ? bounds.min.x() : bounds.max.x(),
+    plane.normal.y() >= 0.0f ? bounds.min.y() : bounds.max.y(),
+    plane.normal.z() >= 0.0f ? bounds.min.z() : bounds.max.z()};
+  return plane.point_distance(corner) > 0.0f;
+}
+
+} // namespace
+
+PortalRenderer::PortalRenderer(
+  const std::vector<mdl::Portal>& portals,
+  const float chunkSize,
+  const Color& fillColor,
+  const Color& edgeColor,
+  const float edgeWidth)
+  : m_fillColor{fillColor}
+  , m_edgeColor{edgeColor}
+  , m_edgeWidth{edgeWidth}
+{
+  auto builders = std::map<ChunkKey, ChunkBuilder>{};
+  for (const auto& portal : portals)
+  {
+    const auto& vertices = portal.polygon.vertices();
+    if (vertices.size() < 3)
+    {
+      continue;
+    }
+
+    auto portalBounds = vm::bbox3f::builder{};
+    portalBounds.add(vertices.begin(), vertices.end());
+
+    auto& builder = builders[chunkKey(portalBounds.bounds(), chunkSize)];
+    builder.bounds.add(portalBounds.bounds());
+
+    for (size_t i = 1; i < vertices.size() - 1; ++i)
+    {
+      builder.triangles.emplace_back(vertices[0]);
+      builder.triangles.emplace_back(vertices[i]);
+      builder.triangles.emplace_back(vertices[i + 1]);
+    }
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+      builder.edges.emplace_back(vertices[i]);
+      builder.edges.emplace_back(vertices[(i + 1) % vertices.size()]);
+    }
+  }
+
+  m_chunks.reserve(builders.size());
+  for (auto& [key, builder] : builders)
+  {
+    m_chunks.push_back(Chunk{
+      builder.bounds.bounds(),
+      VertexArray::move(std::move(builder.triangles)),
+      VertexArray::move(std::move(builder.edges))});
+  }
+}
+
+void PortalRenderer::doPrepareVertices(VboManager& vboManager)
+{
+  for (auto& chunk : m_chunks)
+  {
+    chunk.triangles.prepare(vboManager);
+    chunk.edges.prepare(vboManager);
+  }
+}
+
+void PortalRenderer::doRender(RenderContext& renderContext)
+{
+  const auto viewVolume = renderContext.camera().viewVolumePlanes();
+  const auto isVisible = [&](const auto& chunk) {
+    return std::ranges::none_of(
+      viewVolume, [&](const auto& plane) { return isAbovePlane(chunk.bounds, plane); });
+  };
+
+  auto shader =
+    ActiveShader{renderContext.shaderManager(), Shaders::VaryingPUniformCShader};
+
+  glAssert(glLineWidth(m_edgeWidth * renderContext.dpiScale()));
+  shader.set("Color", m_edgeColor);
+  for (auto& chunk : m_chunks)
+  {
+    if (isVisible(chunk))
+    {
+      chunk.edges.render(PrimType::Lines);
+    }
+  }
+  glAssert(glLineWidth(renderContext.dpiScale()));
+
+  glAssert(glPushAttrib(GL_POLYGON_BIT));
+  glAssert(glDisable(GL_CULL_FACE));
+  glAssert(glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
+  if (m_fillColor.a() < 1.0f)
+  {
+    glAssert(glDepthMask(GL_FALSE));
+  }
+
+  shader.set("Color", m_fillColor);
+  for (auto& chunk : m_chunks)
+  {
+    if (isVisible(chunk))
+    {
+      chunk.triangles.render(PrimType::Triangles);
+    }
+  }
+
+  if (m_fillColor.a() < 1.0f)
+  {
+    glAssert(glDepthMask(GL_TRUE));
+  }
+  glAssert(glPopAttrib());
+}
+
+} // namespace tb::render
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Color.h"
+#include "render/Renderable.h"
+#include "render/VertexArray.h"
+
+#include "vm/bbox.h"
+
+#include <vector>
+
+namespace tb::mdl
+{
+struct Portal;
+}
+
+namespace tb::render
+{
+
+/**
+ * Renders the portals of a portal file.
+ *
+ * The portals are bucketed into cubic cells by the centers of their bounds. Each chunk
+ * stores the triangles and the edges of its portals in two static vertex arrays, so a
+ * chunk is drawn with two draw calls. Chunks whose bounds are outside of the view volume
+ * of the camera are skipped.
+ */
+class PortalRenderer : public DirectRenderable
+{
+private:
+  struct Chunk
+  {
+    vm::bbox3f bounds;
+    VertexArray triangles;
+    VertexArray edges;
+  };
+
+  Color m_fillColor;
+  Color m_edgeColor;
+  float m_edgeWidth;
+  std::vector<Chunk> m_chunks;
+
+public:
+  PortalRenderer(
+    const std::vector<mdl::Portal>& portals,
+    float chunkSize,
+    const Color& fillColor,
+    const Color& edgeColor,
+    float edgeWidth);
+
+private:
+  void doPrepareVertices(VboManager& vboManager) override;
+  void doRender(RenderContext& renderContext) override;
+};
+
+} // namespace tb::render
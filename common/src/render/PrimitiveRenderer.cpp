@@ -326,9 +326,10 @@ void PrimitiveRenderer::prepareLines(VboManager& vboManager)
 {
   for (auto& [attributes, mesh] : m_lineMeshes)
   {
-    auto& renderer =
-      m_lineMeshRenderers.emplace(attributes, IndexRangeRenderer{mesh}).first->second;
+    auto renderer = IndexRangeRenderer{
+      VertexArray::stream(std::move(mesh.vertices())), std::move(mesh.indices())};
     renderer.prepare(vboManager);
+    m_lineMeshRenderers.emplace(attributes, std::move(renderer));
   }
 }
 
@@ -336,9 +337,10 @@ void PrimitiveRenderer::prepareTriangles(VboManager& vboManager)
 {
   for (auto& [attributes, mesh] : m_triangleMeshes)
   {
-    auto& renderer =
-      m_triangleMeshRenderers.emplace(attributes, IndexRangeRenderer{mesh}).first->second;
+    auto renderer = IndexRangeRenderer{
+      VertexArray::stream(std::move(mesh.vertices())), std::move(mesh.indices())};
     renderer.prepare(vboManager);
+    m_triangleMeshRenderers.emplace(attributes, std::move(renderer));
   }
 }
 
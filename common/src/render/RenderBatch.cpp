@@ -20,11 +20,16 @@
 #include "RenderBatch.h"
 
 #include "Ensure.h"
+#include "render/RenderContext.h"
+#include "render/RenderProfiler.h"
 #include "render/Renderable.h"
 #include "render/VboManager.h"
 
 #include "kdl/vector_utils.h"
 
+#include <optional>
+#include <string>
+
 namespace tb::render
 {
 namespace
@@ -41,6 +46,8 @@ public:
   {
   }
 
+  std::string profileLabel() const override { return m_wrappee.profileLabel(); }
+
 private:
   void prepareVerticesAndIndices(VboManager& vboManager) override
   {
@@ -131,10 +138,36 @@ void RenderBatch::prepareRenderables()
 
 void RenderBatch::renderRenderables(RenderContext& renderContext)
 {
+  auto* profiler = renderContext.profiler();
+  if (!profiler || !profiler->enabled())
+  {
+    for (auto* renderable : m_batch)
+    {
+      renderable->render(renderContext);
+    }
+    return;
+  }
+
+  auto currentLabel = std::optional<std::string>{};
   for (auto* renderable : m_batch)
   {
+    auto label = renderable->profileLabel();
+    if (label != currentLabel)
+    {
+      if (currentLabel)
+      {
+        profiler->endGpuPass();
+      }
+      profiler->beginGpuPass(label);
+      currentLabel = std::move(label);
+    }
     renderable->render(renderContext);
   }
+
+  if (currentLabel)
+  {
+    profiler->endGpuPass();
+  }
 }
 
 } // namespace tb::render
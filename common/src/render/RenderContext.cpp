@@ -193,6 +193,16 @@ void RenderContext::setShowFog(const bool showFog)
   m_showFog = showFog;
 }
 
+bool RenderContext::reducedQuality() const
+{
+  return m_reducedQuality;
+}
+
+void RenderContext::setReducedQuality(const bool reducedQuality)
+{
+  m_reducedQuality = reducedQuality;
+}
+
 bool RenderContext::showGrid() const
 {
   return m_showGrid;
@@ -253,6 +263,16 @@ void RenderContext::clearTintSelection()
   m_tintSelection = false;
 }
 
+const std::optional<vm::mat4x4d>& RenderContext::selectionTransformation() const
+{
+  return m_selectionTransformation;
+}
+
+void RenderContext::setSelectionTransformation(const vm::mat4x4d& selectionTransformation)
+{
+  m_selectionTransformation = selectionTransformation;
+}
+
 bool RenderContext::showSelectionGuide() const
 {
   return m_showSelectionGuide == ShowSelectionGuide::Show
@@ -279,6 +299,36 @@ void RenderContext::setForceHideSelectionGuide()
   setShowSelectionGuide(ShowSelectionGuide::ForceHide);
 }
 
+RenderProfiler* RenderContext::profiler() const
+{
+  return m_profiler;
+}
+
+void RenderContext::setProfiler(RenderProfiler* profiler)
+{
+  m_profiler = profiler;
+}
+
+OcclusionCuller* RenderContext::occlusionCuller() const
+{
+  return m_occlusionCuller;
+}
+
+void RenderContext::setOcclusionCuller(OcclusionCuller* occlusionCuller)
+{
+  m_occlusionCuller = occlusionCuller;
+}
+
+const mdl::PortalGraph* RenderContext::portalGraph() const
+{
+  return m_portalGraph;
+}
+
+void RenderContext::setPortalGraph(const mdl::PortalGraph* portalGraph)
+{
+  m_portalGraph = portalGraph;
+}
+
 void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide)
 {
   switch (showSelectionGuide)
@@ -24,11 +24,21 @@
 #include "render/Transformation.h"
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
+
+#include <optional>
+
+namespace tb::mdl
+{
+class PortalGraph;
+} // namespace tb::mdl
 
 namespace tb::render
 {
 class Camera;
 class FontManager;
+class OcclusionCuller;
+class RenderProfiler;
 class ShaderManager;
 
 enum class RenderMode
@@ -73,6 +83,7 @@ private:
   bool m_showPointEntityBounds = true;
 
   bool m_showFog = false;
+  bool m_reducedQuality = false;
 
   bool m_showGrid = true;
   double m_gridSize = 4;
@@ -80,10 +91,15 @@ private:
 
   bool m_hideSelection = false;
   bool m_tintSelection = false;
+  std::optional<vm::mat4x4d> m_selectionTransformation;
 
   ShowSelectionGuide m_showSelectionGuide = ShowSelectionGuide::Hide;
   vm::bbox3f m_softMapBounds;
 
+  RenderProfiler* m_profiler = nullptr;
+  OcclusionCuller* m_occlusionCuller = nullptr;
+  const mdl::PortalGraph* m_portalGraph = nullptr;
+
 public:
   RenderContext(
     RenderMode renderMode,
@@ -138,6 +154,13 @@ public:
   bool showFog() const;
   void setShowFog(bool showFog);
 
+  /**
+   * If set, optional passes such as decals, link lines and occluded edges are skipped to
+   * keep the frame rate up while the camera moves.
+   */
+  bool reducedQuality() const;
+  void setReducedQuality(bool reducedQuality);
+
   bool showGrid() const;
   void setShowGrid(bool showGrid);
 
@@ -156,12 +179,37 @@ public:
   bool tintSelection() const;
   void clearTintSelection();
 
+  /**
+   * A transformation that is applied to the selected objects when they are rendered, or
+   * nullopt. Tools set this to preview a transformation of the selection while dragging
+   * and only apply the transformation to the map once the drag ends.
+   */
+  const std::optional<vm::mat4x4d>& selectionTransformation() const;
+  void setSelectionTransformation(const vm::mat4x4d& selectionTransformation);
+
   bool showSelectionGuide() const;
   void setShowSelectionGuide();
   void setHideSelectionGuide();
   void setForceShowSelectionGuide();
   void setForceHideSelectionGuide();
 
+  RenderProfiler* profiler() const;
+  void setProfiler(RenderProfiler* profiler);
+
+  /**
+   * The occlusion culler of the view being rendered, or null if the view does not cull
+   * hidden objects.
+   */
+  OcclusionCuller* occlusionCuller() const;
+  void setOcclusionCuller(OcclusionCuller* occlusionCuller);
+
+  /**
+   * The portal graph to cull objects with, or null if objects should not be culled with
+   * a portal file.
+   */
+  const mdl::PortalGraph* portalGraph() const;
+  void setPortalGraph(const mdl::PortalGraph* portalGraph);
+
 private:
   void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
 };
@@ -0,0 +1,362 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderProfiler.h"
+
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+namespace tb::render
+{
+namespace
+{
+
+void addPassTime(
+  std::vector<RenderPassTime>& passes, const std::string& label, const double msecs)
+{
+  if (const auto iPass = std::ranges::find(passes, label, &RenderPassTime::label);
+      iPass != passes.end())
+  {
+    iPass->msecs += msecs;
+  }
+  else
+  {
+    passes.push_back(RenderPassTime{label, msecs});
+  }
+}
+
+double findPassTime(const std::vector<RenderPassTime>& passes, const std::string& label)
+{
+  const auto iPass = std::ranges::find(passes, label, &RenderPassTime::label);
+  return iPass != passes.end() ? iPass->msecs : 0.0;
+}
+
+std::vector<std::string> collectLabels(
+  const std::deque<FrameProfile>& frames,
+  std::vector<RenderPassTime> FrameProfile::* passes)
+{
+  auto result = std::vector<std::string>{};
+  for (const auto& frame : frames)
+  {
+    for (const auto& pass : frame.*passes)
+    {
+      if (!kdl::vec_contains(result, pass.label))
+      {
+        result.push_back(pass.label);
+      }
+    }
+  }
+  return result;
+}
+
+bool timerQueriesSupported()
+{
+  return GLEW_ARB_timer_query;
+}
+
+} // namespace
+
+StateChangeCounts& currentStateChangeCounts()
+{
+  static auto counts = StateChangeCounts{};
+  return counts;
+}
+
+FrameProfile averageFrameProfile(const std::deque<FrameProfile>& frames)
+{
+  auto result = FrameProfile{};
+  if (frames.empty())
+  {
+    return result;
+  }
+
+  for (const auto& frame : frames)
+  {
+    for (const auto& pass : frame.cpuPasses)
+    {
+      addPassTime(result.cpuPasses, pass.label, pass.msecs);
+    }
+    for (const auto& pass : frame.gpuPasses)
+    {
+      addPassTime(result.gpuPasses, pass.label, pass.msecs);
+    }
+    result.stateChanges.programChanges += frame.stateChanges.programChanges;
+    result.stateChanges.textureBinds += frame.stateChanges.textureBinds;
+    result.stateChanges.bufferBinds += frame.stateChanges.bufferBinds;
+    result.stateChanges.vertexArrayBinds += frame.stateChanges.vertexArrayBinds;
+    result.stateChanges.drawCalls += frame.stateChanges.drawCalls;
+    result.stateChanges.uploadedBytes += frame.stateChanges.uploadedBytes;
+  }
+
+  const auto frameCount = double(frames.size());
+  for (auto& pass : result.cpuPasses)
+  {
+    pass.msecs /= frameCount;
+  }
+  for (auto& pass : result.gpuPasses)
+  {
+    pass.msecs /= frameCount;
+  }
+  result.stateChanges.programChanges /= frames.size();
+  result.stateChanges.textureBinds /= frames.size();
+  result.stateChanges.bufferBinds /= frames.size();
+  result.stateChanges.vertexArrayBinds /= frames.size();
+  result.stateChanges.drawCalls /= frames.size();
+  result.stateChanges.uploadedBytes /= frames.size();
+
+  result.frameIndex = frames.back().frameIndex;
+  return result;
+}
+
+std::string toCsv(const std::deque<FrameProfile>& frames)
+{
+  const auto cpuLabels = collectLabels(frames, &FrameProfile::cpuPasses);
+  const auto gpuLabels = collectLabels(frames, &FrameProfile::gpuPasses);
+
+  auto str = std::stringstream{};
+  str << "Frame";
+  for (const auto& label : cpuLabels)
+  {
+    str << ",CPU " << label << " (ms)";
+  }
+  for (const auto& label : gpuLabels)
+  {
+    str << ",GPU " << label << " (ms)";
+  }
+  str << ",Program changes,Texture binds,Buffer binds,Vertex array binds,Draw calls,"
+         "Uploaded bytes\n";
+
+  for (const auto& frame : frames)
+  {
+    str << frame.frameIndex;
+    for (const auto& label : cpuLabels)
+    {
+      str << "," << fmt::format("{:.3f}", findPassTime(frame.cpuPasses, label));
+    }
+    for (const auto& label : gpuLabels)
+    {
+      str << "," << fmt::format("{:.3f}", findPassTime(frame.gpuPasses, label));
+    }
+    const auto& stateChanges = frame.stateChanges;
+    str << "," << stateChanges.programChanges << "," << stateChanges.textureBinds << ","
+        << stateChanges.bufferBinds << "," << stateChanges.vertexArrayBinds << ","
+        << stateChanges.drawCalls << "," << stateChanges.uploadedBytes << "\n";
+  }
+
+  return str.str();
+}
+
+RenderProfiler::RenderProfiler(const size_t maxFrameCount)
+  : m_maxFrameCount{maxFrameCount}
+{
+  assert(m_maxFrameCount > 0);
+}
+
+RenderProfiler::~RenderProfiler()
+{
+  auto queries = m_freeQueries;
+  for (const auto& pendingFrame : m_pendingFrames)
+  {
+    for (const auto& pass : pendingFrame.gpuPasses)
+    {
+      queries.push_back(pass.query);
+    }
+  }
+  if (m_currentFrame)
+  {
+    for (const auto& pass : m_currentFrame->gpuPasses)
+    {
+      queries.push_back(pass.query);
+    }
+  }
+
+  if (!queries.empty())
+  {
+    glAssert(glDeleteQueries(GLsizei(queries.size()), queries.data()));
+  }
+}
+
+bool RenderProfiler::enabled() const
+{
+  return m_enabled;
+}
+
+void RenderProfiler::setEnabled(const bool enabled)
+{
+  if (enabled != m_enabled)
+  {
+    m_enabled = enabled;
+    if (!m_enabled)
+    {
+      // the results of pending queries are discarded, but the queries can be reused
+      for (const auto& pendingFrame : m_pendingFrames)
+      {
+        for (const auto& pass : pendingFrame.gpuPasses)
+        {
+          m_freeQueries.push_back(pass.query);
+        }
+      }
+      m_pendingFrames.clear();
+      m_currentFrame = std::nullopt;
+      m_currentCpuPass = std::nullopt;
+    }
+  }
+}
+
+void RenderProfiler::beginFrame()
+{
+  if (m_enabled)
+  {
+    collectResults();
+    m_currentFrame = PendingFrame{FrameProfile{m_nextFrameIndex++, {}, {}, {}}, {}};
+    currentStateChangeCounts() = StateChangeCounts{};
+  }
+}
+
+void RenderProfiler::endFrame()
+{
+  if (m_currentFrame)
+  {
+    assert(!m_currentCpuPass);
+    assert(!m_gpuPassActive);
+
+    m_currentFrame->profile.stateChanges = currentStateChangeCounts();
+
+    // keep the frames in order if earlier frames are still waiting for GPU results
+    if (m_currentFrame->gpuPasses.empty() && m_pendingFrames.empty())
+    {
+      addFrame(std::move(m_currentFrame->profile));
+    }
+    else
+    {
+      m_pendingFrames.push_back(std::move(*m_currentFrame));
+    }
+    m_currentFrame = std::nullopt;
+  }
+}
+
+void RenderProfiler::beginCpuPass(std::string label)
+{
+  if (m_currentFrame)
+  {
+    assert(!m_currentCpuPass);
+    m_currentCpuPass = {std::move(label), Clock::now()};
+  }
+}
+
+void RenderProfiler::endCpuPass()
+{
+  if (m_currentFrame && m_currentCpuPass)
+  {
+    const auto elapsed = Clock::now() - m_currentCpuPass->second;
+    const auto msecs = std::chrono::duration<double, std::milli>{elapsed}.count();
+    addPassTime(m_currentFrame->profile.cpuPasses, m_currentCpuPass->first, msecs);
+    m_currentCpuPass = std::nullopt;
+  }
+}
+
+void RenderProfiler::beginGpuPass(std::string label)
+{
+  if (m_currentFrame && timerQueriesSupported())
+  {
+    assert(!m_gpuPassActive);
+
+    auto query = GLuint(0);
+    if (m_freeQueries.empty())
+    {
+      glAssert(glGenQueries(1, &query));
+    }
+    else
+    {
+      query = m_freeQueries.back();
+      m_freeQueries.pop_back();
+    }
+
+    glAssert(glBeginQuery(GL_TIME_ELAPSED, query));
+    m_currentFrame->gpuPasses.push_back(PendingPass{std::move(label), query});
+    m_gpuPassActive = true;
+  }
+}
+
+void RenderProfiler::endGpuPass()
+{
+  if (m_gpuPassActive)
+  {
+    glAssert(glEndQuery(GL_TIME_ELAPSED));
+    m_gpuPassActive = false;
+  }
+}
+
+const std::deque<FrameProfile>& RenderProfiler::frames() const
+{
+  return m_frames;
+}
+
+void RenderProfiler::clear()
+{
+  m_frames.clear();
+}
+
+void RenderProfiler::collectResults()
+{
+  while (!m_pendingFrames.empty())
+  {
+    auto& pendingFrame = m_pendingFrames.front();
+
+    // queries finish in order, so all results are available if the last one is
+    if (!pendingFrame.gpuPasses.empty())
+    {
+      auto available = GLint(0);
+      glAssert(glGetQueryObjectiv(
+        pendingFrame.gpuPasses.back().query, GL_QUERY_RESULT_AVAILABLE, &available));
+      if (!available)
+      {
+        break;
+      }
+    }
+
+    for (const auto& pass : pendingFrame.gpuPasses)
+    {
+      auto nsecs = GLuint64(0);
+      glAssert(glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &nsecs));
+      addPassTime(
+        pendingFrame.profile.gpuPasses, pass.label, double(nsecs) / 1000000.0);
+      m_freeQueries.push_back(pass.query);
+    }
+
+    addFrame(std::move(pendingFrame.profile));
+    m_pendingFrames.pop_front();
+  }
+}
+
+void RenderProfiler::addFrame(FrameProfile frame)
+{
+  m_frames.push_back(std::move(frame));
+  while (m_frames.size() > m_maxFrameCount)
+  {
+    m_frames.pop_front();
+  }
+}
+
+} // namespace tb::render
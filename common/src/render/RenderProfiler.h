@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "render/GL.h"
+
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tb::render
+{
+
+struct RenderPassTime
+{
+  std::string label;
+  double msecs;
+};
+
+/**
+ * The number of GL state changes and draw calls issued while rendering a frame, and the
+ * number of bytes uploaded to buffers and textures.
+ */
+struct StateChangeCounts
+{
+  size_t programChanges = 0;
+  size_t textureBinds = 0;
+  size_t bufferBinds = 0;
+  size_t vertexArrayBinds = 0;
+  size_t drawCalls = 0;
+  size_t uploadedBytes = 0;
+
+  bool operator==(const StateChangeCounts& other) const = default;
+};
+
+struct FrameProfile
+{
+  size_t frameIndex = 0;
+  std::vector<RenderPassTime> cpuPasses;
+  std::vector<RenderPassTime> gpuPasses;
+  StateChangeCounts stateChanges = {};
+};
+
+/**
+ * The state changes issued since the current frame began. The functions that bind GL
+ * objects, issue draw calls or upload data increment these counts, and the profiler
+ * resets them when a frame begins. Must only be accessed from the thread that renders.
+ */
+StateChangeCounts& currentStateChangeCounts();
+
+/**
+ * Returns the average time of every pass and the average state change counts over the
+ * given frames. The passes are ordered by their first appearance.
+ */
+FrameProfile averageFrameProfile(const std::deque<FrameProfile>& frames);
+
+/**
+ * Formats the given frames as CSV with one row per frame and one column per pass and
+ * state change count.
+ */
+std::string toCsv(const std::deque<FrameProfile>& frames);
+
+/**
+ * Measures the time spent in render passes. CPU passes are measured with a clock, GPU
+ * passes with GL timer queries if the driver supports them. GPU results become available
+ * a few frames later, so a frame is added to the history once all of its query results
+ * were read.
+ */
+class RenderProfiler
+{
+private:
+  struct PendingPass
+  {
+    std::string label;
+    GLuint query;
+  };
+
+  struct PendingFrame
+  {
+    FrameProfile profile;
+    std::vector<PendingPass> gpuPasses;
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  size_t m_maxFrameCount;
+  bool m_enabled = false;
+
+  size_t m_nextFrameIndex = 0;
+  std::optional<PendingFrame> m_currentFrame;
+  std::optional<std::pair<std::string, Clock::time_point>> m_currentCpuPass;
+  bool m_gpuPassActive = false;
+
+  std::deque<PendingFrame> m_pendingFrames;
+  std::vector<GLuint> m_freeQueries;
+
+  std::deque<FrameProfile> m_frames;
+
+public:
+  explicit RenderProfiler(size_t maxFrameCount = 300);
+
+  /**
+   * Deletes the timer queries, so the GL context must be current.
+   */
+  ~RenderProfiler();
+
+  bool enabled() const;
+  void setEnabled(bool enabled);
+
+  void beginFrame();
+  void endFrame();
+
+  void beginCpuPass(std::string label);
+  void endCpuPass();
+
+  /**
+   * Starts a GPU timer query. GPU passes cannot be nested. Does nothing if timer queries
+   * are not supported.
+   */
+  void beginGpuPass(std::string label);
+  void endGpuPass();
+
+  /**
+   * The most recent frames whose results are available, oldest first.
+   */
+  const std::deque<FrameProfile>& frames() const;
+
+  void clear();
+
+private:
+  void collectResults();
+  void addFrame(FrameProfile frame);
+};
+
+} // namespace tb::render
@@ -24,6 +24,7 @@
 #include "Preferences.h"
 #include "render/Camera.h"
 #include "render/FontDescriptor.h"
+#include "render/FontManager.h"
 #include "render/PointHandleRenderer.h"
 #include "render/PrimitiveRenderer.h"
 #include "render/RenderBatch.h"
@@ -31,6 +32,7 @@
 #include "render/RenderUtils.h"
 #include "render/TextAnchor.h"
 #include "render/TextRenderer.h"
+#include "render/TextureFont.h"
 
 #include "vm/polygon.h"
 #include "vm/segment.h"
@@ -171,6 +173,11 @@ void RenderService::renderHeadsUp(const std::string& string)
   renderHeadsUp(AttrString{string});
 }
 
+vm::vec2f RenderService::measureString(const AttrString& string) const
+{
+  return m_renderContext.fontManager().font(makeRenderServiceFont()).measure(string);
+}
+
 void RenderService::renderHandles(const std::vector<vm::vec3f>& positions)
 {
   for (const auto& position : positions)
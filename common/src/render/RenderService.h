@@ -86,6 +86,12 @@ public:
   void renderString(const std::string& string, const TextAnchor& position);
   void renderHeadsUp(const std::string& string);
 
+  /**
+   * Returns the size of the given string in screen space, excluding the inset of its
+   * background.
+   */
+  vm::vec2f measureString(const AttrString& string) const;
+
   void renderHandles(const std::vector<vm::vec3f>& positions);
   void renderHandle(const vm::vec3f& position);
   void renderHandleHighlight(const vm::vec3f& position);
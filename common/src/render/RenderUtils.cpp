@@ -21,6 +21,7 @@
 
 #include "mdl/Material.h"
 #include "mdl/Texture.h"
+#include "render/Camera.h"
 #include "render/GL.h"
 
 namespace tb::render
@@ -28,7 +29,10 @@ namespace tb::render
 namespace
 {
 constexpr auto EdgeOffset = 0.0001;
-}
+
+// mirrors the clip control state set by glSetReverseDepth
+auto reverseDepthEnabled = false;
+} // namespace
 
 vm::vec3f gridColorForMaterial(const mdl::Material* material)
 {
@@ -48,12 +52,68 @@ vm::vec3f gridColorForMaterial(const mdl::Material* material)
 
 void glSetEdgeOffset(const double f)
 {
-  glAssert(glDepthRange(0.0, 1.0 - EdgeOffset * f));
+  if (reverseDepthEnabled)
+  {
+    // scale the depth instead of shifting it so that the precision of small depth
+    // values is kept, scaling by 0.5 is exact
+    glAssert(glDepthRange(0.0, 0.5 * (1.0 + EdgeOffset * f)));
+  }
+  else
+  {
+    glAssert(glDepthRange(0.0, 1.0 - EdgeOffset * f));
+  }
 }
 
 void glResetEdgeOffset()
 {
-  glAssert(glDepthRange(EdgeOffset, 1.0));
+  if (reverseDepthEnabled)
+  {
+    glAssert(glDepthRange(0.0, 0.5));
+  }
+  else
+  {
+    glAssert(glDepthRange(EdgeOffset, 1.0));
+  }
+}
+
+bool reverseDepthSupported()
+{
+  return (GLEW_VERSION_4_5 || GLEW_ARB_clip_control) && GLEW_VERSION_3_0;
+}
+
+void glSetReverseDepth(const bool reverseDepth)
+{
+  reverseDepthEnabled = reverseDepth;
+  glAssert(glClipControl(
+    GL_LOWER_LEFT, reverseDepth ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE));
+  glAssert(glClearDepth(reverseDepth ? 0.0 : 1.0));
+  glResetEdgeOffset();
+}
+
+bool glIsReverseDepth()
+{
+  return reverseDepthEnabled;
+}
+
+vm::mat4x4f reverseDepthProjection(const vm::mat4x4f& projection)
+{
+  // z' = (w - z) / 2 maps the clip space depth range [-1, 1] to [1, 0], computed in
+  // double precision because the terms nearly cancel out for perspective projections
+  const auto matrix = vm::mat4x4d{projection};
+  auto result = matrix;
+  for (size_t column = 0; column < 4; ++column)
+  {
+    result[column][2] = 0.5 * (matrix[column][3] - matrix[column][2]);
+  }
+  return vm::mat4x4f{result};
+}
+
+double projectedSize(const vm::bbox3d& bounds, const Camera& camera)
+{
+  const auto size = bounds.size();
+  return vm::max(
+    vm::dot(size, vm::abs(vm::vec3d{camera.right()})),
+    vm::dot(size, vm::abs(vm::vec3d{camera.up()})));
 }
 
 void coordinateSystemVerticesX(const vm::bbox3f& bounds, vm::vec3f& start, vm::vec3f& end)
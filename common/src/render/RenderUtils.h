@@ -20,6 +20,7 @@
 #pragma once
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
 #include "vm/util.h"
 #include "vm/vec.h"
 
@@ -35,12 +36,43 @@ class Material;
 
 namespace tb::render
 {
+class Camera;
 
 vm::vec3f gridColorForMaterial(const mdl::Material* material);
 
 void glSetEdgeOffset(double f);
 void glResetEdgeOffset();
 
+/**
+ * Returns whether the driver supports reverse depth and floating point depth buffers.
+ */
+bool reverseDepthSupported();
+
+/**
+ * Enables or disables reverse depth, where the near plane is mapped to depth 1 and the
+ * far plane is mapped to depth 0. Together with a floating point depth buffer, this
+ * spreads the depth precision evenly over the view distance, which avoids z-fighting in
+ * large maps.
+ *
+ * While reverse depth is enabled, projection matrices loaded by Transformation are
+ * converted with reverseDepthProjection, the depth buffer is cleared to 0, and the depth
+ * test must prefer greater depth values.
+ */
+void glSetReverseDepth(bool reverseDepth);
+bool glIsReverseDepth();
+
+/**
+ * Converts the given projection matrix, which maps the view volume to the clip space
+ * depth range [-1, 1], to a matrix that maps the near plane to 1 and the far plane to 0.
+ */
+vm::mat4x4f reverseDepthProjection(const vm::mat4x4f& projection);
+
+/**
+ * Returns the size of the given bounds on the view plane of the given camera, i.e., the
+ * larger of their extents along the right and up axes of the camera.
+ */
+double projectedSize(const vm::bbox3d& bounds, const Camera& camera);
+
 void coordinateSystemVerticesX(
   const vm::bbox3f& bounds, vm::vec3f& start, vm::vec3f& end);
 void coordinateSystemVerticesY(
@@ -30,6 +30,11 @@ void Renderable::render(RenderContext& renderContext)
   doRender(renderContext);
 }
 
+std::string Renderable::profileLabel() const
+{
+  return "Other";
+}
+
 void DirectRenderable::prepareVertices(VboManager& vboManager)
 {
   doPrepareVertices(vboManager);
@@ -21,6 +21,8 @@
 
 #include "Macros.h"
 
+#include <string>
+
 namespace tb::render
 {
 class RenderContext;
@@ -34,6 +36,13 @@ public:
 
   void render(RenderContext& renderContext);
 
+  /**
+   * The name under which the render time of this renderable is reported when render
+   * profiling is enabled. Consecutive renderables with the same label are measured as one
+   * pass.
+   */
+  virtual std::string profileLabel() const;
+
 private:
   virtual void doRender(RenderContext& renderContext) = 0;
 
@@ -0,0 +1,146 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ShaderCache.h"
+
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "render/ShaderProgram.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto Magic = std::array<char, 4>{'T', 'B', 'S', 'C'};
+
+/**
+ * Must be incremented whenever the layout of the cache changes.
+ */
+constexpr auto Version = std::uint32_t(1);
+
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& stream, const std::string_view str)
+{
+  write(stream, std::uint64_t(str.size()));
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+template <typename T>
+T read(io::Reader& reader)
+{
+  return reader.read<T, T>();
+}
+
+std::string readString(io::Reader& reader)
+{
+  const auto size = size_t(read<std::uint64_t>(reader));
+  if (!reader.canRead(size))
+  {
+    throw io::ReaderException{"Invalid string size"};
+  }
+
+  auto result = std::string(size, '\0');
+  reader.read(result.data(), result.size());
+  return result;
+}
+
+} // namespace
+
+std::filesystem::path shaderCachePath(
+  const std::filesystem::path& cacheDirectory, const std::string_view programName)
+{
+  return cacheDirectory / fmt::format("{}.tbshader", programName);
+}
+
+void writeShaderCache(
+  std::ostream& stream,
+  const std::string_view driver,
+  const std::string_view sources,
+  const ShaderProgramBinary& binary)
+{
+  stream.write(Magic.data(), Magic.size());
+  write(stream, Version);
+  writeString(stream, driver);
+  writeString(stream, sources);
+
+  write(stream, std::uint32_t(binary.format));
+  writeString(stream, std::string_view{binary.data.data(), binary.data.size()});
+
+  // marks the end so that a truncated cache is detected
+  stream.write(Magic.data(), Magic.size());
+}
+
+Result<ShaderProgramBinary> readShaderCache(
+  io::Reader reader, const std::string_view driver, const std::string_view sources)
+{
+  try
+  {
+    auto magic = std::array<char, 4>{};
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Not a shader cache"};
+    }
+
+    if (const auto version = read<std::uint32_t>(reader); version != Version)
+    {
+      return Error{fmt::format("Unsupported shader cache version {}", version)};
+    }
+
+    if (readString(reader) != driver)
+    {
+      return Error{"Shader cache was created by a different driver"};
+    }
+
+    if (readString(reader) != sources)
+    {
+      return Error{"Shader cache is out of date"};
+    }
+
+    const auto format = GLenum(read<std::uint32_t>(reader));
+    const auto data = readString(reader);
+
+    reader.read(magic.data(), magic.size());
+    if (magic != Magic)
+    {
+      return Error{"Shader cache is truncated"};
+    }
+
+    return ShaderProgramBinary{format, std::vector<char>{data.begin(), data.end()}};
+  }
+  catch (const io::ReaderException& e)
+  {
+    return Error{fmt::format("Invalid shader cache: {}", e.what())};
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <string_view>
+
+namespace tb::io
+{
+class Reader;
+}
+
+namespace tb::render
+{
+struct ShaderProgramBinary;
+
+/**
+ * A shader cache is a binary file that stores a linked shader program, so that its
+ * shaders don't need to be compiled and linked again when the program is loaded the next
+ * time.
+ *
+ * A program binary can only be loaded by the driver that created it. The cache stores a
+ * format version, a description of the driver, and the sources of the program's shaders,
+ * and it is rejected if any of these don't match.
+ */
+
+/**
+ * Returns the path of the cache file for the shader program with the given name.
+ */
+std::filesystem::path shaderCachePath(
+  const std::filesystem::path& cacheDirectory, std::string_view programName);
+
+/**
+ * Writes a cache for the given binary, which was created by the given driver from the
+ * given shader sources, to the given stream.
+ */
+void writeShaderCache(
+  std::ostream& stream,
+  std::string_view driver,
+  std::string_view sources,
+  const ShaderProgramBinary& binary);
+
+/**
+ * Reads a program binary from the given cache.
+ *
+ * Returns an error if the cache is malformed, if it was written by a different version
+ * of the cache format, or if it was not created by the given driver from the given
+ * shader sources.
+ */
+Result<ShaderProgramBinary> readShaderCache(
+  io::Reader reader, std::string_view driver, std::string_view sources);
+
+} // namespace tb::render
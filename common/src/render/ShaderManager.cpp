@@ -20,19 +20,96 @@
 #include "ShaderManager.h"
 
 #include "Ensure.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
 #include "io/SystemPaths.h"
+#include "render/ShaderCache.h"
 #include "render/ShaderConfig.h"
 
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
 #include "kdl/vector_utils.h"
 
+#include <fmt/format.h>
+
 #include <cassert>
 #include <filesystem>
+#include <sstream>
 #include <string>
+#include <string_view>
 
 namespace tb::render
 {
+namespace
+{
+
+std::string glString(const GLenum name)
+{
+  const auto* str = reinterpret_cast<const char*>(glGetString(name));
+  return str ? str : "";
+}
+
+/**
+ * Describes the driver that creates the program binaries. Binaries are only loaded by
+ * the driver that created them.
+ */
+std::string driverDescription()
+{
+  return fmt::format(
+    "{}\n{}\n{}", glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION));
+}
+
+/**
+ * Returns the concatenated sources of all shaders of the given program.
+ */
+Result<std::string> loadSources(const ShaderConfig& config)
+{
+  auto paths = kdl::vec_concat(config.vertexShaders, config.fragmentShaders);
+  return kdl::vec_transform(
+           paths,
+           [](const auto& name) {
+             const auto path =
+               io::SystemPaths::findResourceFile(std::filesystem::path{"shader"} / name);
+             return io::Disk::withInputStream(path, [&](auto& stream) {
+               auto str = std::stringstream{};
+               str << name << "\n" << stream.rdbuf() << "\n";
+               return str.str();
+             });
+           })
+         | kdl::fold | kdl::transform([](const auto& sources) {
+             auto result = std::string{};
+             for (const auto& source : sources)
+             {
+               result += source;
+             }
+             return result;
+           });
+}
+
+/**
+ * Failing to write the cache is not an error, since the program is just compiled again
+ * the next time it is loaded.
+ */
+void writeCache(
+  const std::filesystem::path& cachePath,
+  const std::string_view driver,
+  const std::string_view sources,
+  const ShaderProgramBinary& binary)
+{
+  io::Disk::createDirectory(cachePath.parent_path()) | kdl::and_then([&](auto) {
+    return io::Disk::withOutputStream(
+      cachePath, std::ios::out | std::ios::binary, [&](auto& stream) {
+        writeShaderCache(stream, driver, sources, binary);
+      });
+  }) | kdl::transform_error([](const auto&) {});
+}
+
+} // namespace
+
+ShaderManager::ShaderManager(std::optional<std::filesystem::path> cacheDirectory)
+  : m_cacheDirectory{std::move(cacheDirectory)}
+{
+}
 
 Result<void> ShaderManager::loadProgram(const ShaderConfig& config)
 {
@@ -63,6 +140,46 @@ void ShaderManager::setCurrentProgram(ShaderProgram* program)
 }
 
 Result<ShaderProgram> ShaderManager::createProgram(const ShaderConfig& config)
+{
+  return m_cacheDirectory && programBinariesSupported()
+           ? createCachedProgram(config, *m_cacheDirectory)
+           : compileProgram(config);
+}
+
+Result<ShaderProgram> ShaderManager::createCachedProgram(
+  const ShaderConfig& config, const std::filesystem::path& cacheDirectory)
+{
+  const auto sources = loadSources(config);
+  if (sources.is_error())
+  {
+    return compileProgram(config);
+  }
+
+  const auto driver = driverDescription();
+  const auto cachePath = shaderCachePath(cacheDirectory, config.name);
+
+  return io::Disk::mapFile(cachePath) | kdl::and_then([&](const auto& file) {
+           return readShaderCache(file->reader(), driver, sources.value());
+         })
+         | kdl::and_then([&](const auto& binary) {
+             return createShaderProgram(config.name)
+                    | kdl::and_then([&](auto program) {
+                        return program.loadBinary(binary)
+                               | kdl::transform([&]() { return std::move(program); });
+                      });
+           })
+         | kdl::or_else([&](const auto&) {
+             return compileProgram(config) | kdl::transform([&](auto program) {
+                      if (const auto binary = program.binary())
+                      {
+                        writeCache(cachePath, driver, sources.value(), *binary);
+                      }
+                      return program;
+                    });
+           });
+}
+
+Result<ShaderProgram> ShaderManager::compileProgram(const ShaderConfig& config)
 {
   return createShaderProgram(config.name) | kdl::and_then([&](auto program) {
            return kdl::vec_transform(
@@ -24,6 +24,8 @@
 #include "render/Shader.h"
 #include "render/ShaderProgram.h"
 
+#include <filesystem>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -42,7 +44,16 @@ private:
   ShaderProgramCache m_programs;
   ShaderProgram* m_currentProgram{nullptr};
 
+  /**
+   * If set, linked programs are stored in this directory and loaded from it instead of
+   * compiling their shaders again, if the driver supports it.
+   */
+  std::optional<std::filesystem::path> m_cacheDirectory;
+
 public:
+  explicit ShaderManager(
+    std::optional<std::filesystem::path> cacheDirectory = std::nullopt);
+
   Result<void> loadProgram(const ShaderConfig& config);
   ShaderProgram& program(const ShaderConfig& config);
   ShaderProgram* currentProgram();
@@ -50,6 +61,9 @@ public:
 private:
   void setCurrentProgram(ShaderProgram* program);
   Result<ShaderProgram> createProgram(const ShaderConfig& config);
+  Result<ShaderProgram> createCachedProgram(
+    const ShaderConfig& config, const std::filesystem::path& cacheDirectory);
+  Result<ShaderProgram> compileProgram(const ShaderConfig& config);
   Result<std::reference_wrapper<Shader>> loadShader(const std::string& name, GLenum type);
 };
 
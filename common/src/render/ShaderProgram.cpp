@@ -20,6 +20,7 @@
 #include "ShaderProgram.h"
 
 #include "Ensure.h"
+#include "render/RenderProfiler.h"
 #include "render/Shader.h"
 #include "render/ShaderManager.h"
 
@@ -40,6 +41,8 @@ ShaderProgram::ShaderProgram(std::string name, const GLuint programId)
 ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
   : m_name{std::move(other.m_name)}
   , m_programId{std::exchange(other.m_programId, 0)}
+  , m_variableCache{std::move(other.m_variableCache)}
+  , m_attributeCache{std::move(other.m_attributeCache)}
 {
 }
 
@@ -47,6 +50,8 @@ ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept
 {
   m_name = std::move(other.m_name);
   m_programId = std::exchange(other.m_programId, 0);
+  m_variableCache = std::move(other.m_variableCache);
+  m_attributeCache = std::move(other.m_attributeCache);
   return *this;
 }
 
@@ -88,6 +93,12 @@ std::string getInfoLog(const GLuint programId)
 
 Result<void> ShaderProgram::link()
 {
+  if (programBinariesSupported())
+  {
+    glAssert(
+      glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+  }
+
   glAssert(glLinkProgram(m_programId));
 
   auto linkStatus = GLint(0);
@@ -99,15 +110,61 @@ Result<void> ShaderProgram::link()
       "Could not link shader program '" + m_name + "': " + getInfoLog(m_programId)};
   }
 
+  cacheUniformLocations();
   return kdl::void_success;
 }
 
+Result<void> ShaderProgram::loadBinary(const ShaderProgramBinary& binary)
+{
+  assert(programBinariesSupported());
+
+  glAssert(glProgramBinary(
+    m_programId,
+    binary.format,
+    binary.data.data(),
+    static_cast<GLsizei>(binary.data.size())));
+
+  auto linkStatus = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_LINK_STATUS, &linkStatus));
+
+  if (linkStatus == 0)
+  {
+    return Error{"Could not load binary of shader program '" + m_name + "'"};
+  }
+
+  cacheUniformLocations();
+  return kdl::void_success;
+}
+
+std::optional<ShaderProgramBinary> ShaderProgram::binary() const
+{
+  if (!programBinariesSupported())
+  {
+    return std::nullopt;
+  }
+
+  auto length = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_PROGRAM_BINARY_LENGTH, &length));
+  if (length <= 0)
+  {
+    return std::nullopt;
+  }
+
+  auto result = ShaderProgramBinary{0, std::vector<char>(size_t(length))};
+  glAssert(glGetProgramBinary(
+    m_programId, length, &length, &result.format, result.data.data()));
+  result.data.resize(size_t(length));
+
+  return !result.data.empty() ? std::optional{std::move(result)} : std::nullopt;
+}
+
 void ShaderProgram::activate(ShaderManager& shaderManager)
 {
   assert(m_programId != 0);
 
   glAssert(glUseProgram(m_programId));
   assert(checkActive());
+  ++currentStateChangeCounts().programChanges;
 
   shaderManager.setCurrentProgram(this);
 }
@@ -119,69 +176,69 @@ void ShaderProgram::deactivate(ShaderManager& shaderManager)
   shaderManager.setCurrentProgram(nullptr);
 }
 
-void ShaderProgram::set(const std::string& name, const bool value)
+void ShaderProgram::set(const std::string_view name, const bool value)
 {
   return set(name, int(value));
 }
 
-void ShaderProgram::set(const std::string& name, const int value)
+void ShaderProgram::set(const std::string_view name, const int value)
 {
   assert(checkActive());
   glAssert(glUniform1i(findUniformLocation(name), value));
 }
 
-void ShaderProgram::set(const std::string& name, const size_t value)
+void ShaderProgram::set(const std::string_view name, const size_t value)
 {
   assert(checkActive());
   glAssert(glUniform1i(findUniformLocation(name), int(value)));
 }
 
-void ShaderProgram::set(const std::string& name, const float value)
+void ShaderProgram::set(const std::string_view name, const float value)
 {
   assert(checkActive());
   glAssert(glUniform1f(findUniformLocation(name), value));
 }
 
-void ShaderProgram::set(const std::string& name, const double value)
+void ShaderProgram::set(const std::string_view name, const double value)
 {
   assert(checkActive());
   glAssert(glUniform1d(findUniformLocation(name), value));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec2f& value)
+void ShaderProgram::set(const std::string_view name, const vm::vec2f& value)
 {
   assert(checkActive());
   glAssert(glUniform2f(findUniformLocation(name), value.x(), value.y()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec3f& value)
+void ShaderProgram::set(const std::string_view name, const vm::vec3f& value)
 {
   assert(checkActive());
   glAssert(glUniform3f(findUniformLocation(name), value.x(), value.y(), value.z()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec4f& value)
+void ShaderProgram::set(const std::string_view name, const vm::vec4f& value)
 {
   assert(checkActive());
   glAssert(
     glUniform4f(findUniformLocation(name), value.x(), value.y(), value.z(), value.w()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat2x2f& value)
+void ShaderProgram::set(const std::string_view name, const vm::mat2x2f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix2fv(
     findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat3x3f& value)
+void ShaderProgram::set(const std::string_view name, const vm::mat3x3f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix3fv(
     findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat4x4f& value)
+void ShaderProgram::set(const std::string_view name, const vm::mat4x4f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix4fv(
@@ -205,17 +262,56 @@ GLint ShaderProgram::findAttributeLocation(const std::string& name) const
   return it->second;
 }
 
-GLint ShaderProgram::findUniformLocation(const std::string& name) const
+void ShaderProgram::cacheUniformLocations()
+{
+  m_variableCache.clear();
+
+  auto uniformCount = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &uniformCount));
+
+  auto maxNameLength = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength));
+
+  auto nameBuffer = std::string(size_t(maxNameLength), '\0');
+  for (GLint i = 0; i < uniformCount; ++i)
+  {
+    auto nameLength = GLsizei(0);
+    auto size = GLint(0);
+    auto type = GLenum(0);
+    glAssert(glGetActiveUniform(
+      m_programId,
+      GLuint(i),
+      maxNameLength,
+      &nameLength,
+      &size,
+      &type,
+      nameBuffer.data()));
+
+    auto name = nameBuffer.substr(0, size_t(nameLength));
+    auto location = GLint(-1);
+    glAssert(location = glGetUniformLocation(m_programId, name.c_str()));
+
+    // built-in uniforms have no location
+    if (location != -1)
+    {
+      m_variableCache.emplace(std::move(name), location);
+    }
+  }
+}
+
+GLint ShaderProgram::findUniformLocation(const std::string_view name) const
 {
   auto it = m_variableCache.find(name);
   if (it == std::end(m_variableCache))
   {
+    // names that aren't reported as active uniforms, e.g. elements of arrays
+    auto nameStr = std::string{name};
     auto index = GLint(0);
-    glAssert(index = glGetUniformLocation(m_programId, name.c_str()));
+    glAssert(index = glGetUniformLocation(m_programId, nameStr.c_str()));
     ensure(index != -1, "Attribute location found in shader program");
 
     auto inserted = false;
-    std::tie(it, inserted) = m_variableCache.emplace(name, index);
+    std::tie(it, inserted) = m_variableCache.emplace(std::move(nameStr), index);
     assert(inserted);
   }
 
@@ -242,4 +338,17 @@ Result<ShaderProgram> createShaderProgram(std::string name)
   return ShaderProgram{std::move(name), programId};
 }
 
+bool programBinariesSupported()
+{
+  if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+  {
+    return false;
+  }
+
+  // some drivers support the functions, but not a single binary format
+  auto formatCount = GLint(0);
+  glAssert(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+  return formatCount > 0;
+}
+
 } // namespace tb::render
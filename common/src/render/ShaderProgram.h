@@ -26,8 +26,12 @@
 #include "vm/mat.h"
 #include "vm/vec.h"
 
+#include <optional>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace tb::render
 {
@@ -35,10 +39,36 @@ namespace tb::render
 class ShaderManager;
 class Shader;
 
+/**
+ * The driver specific binary representation of a linked shader program.
+ */
+struct ShaderProgramBinary
+{
+  GLenum format;
+  std::vector<char> data;
+
+  auto operator<=>(const ShaderProgramBinary& other) const = default;
+};
+
 class ShaderProgram
 {
 private:
-  using UniformVariableCache = std::unordered_map<std::string, GLint>;
+  struct StringHash
+  {
+    using is_transparent = void;
+
+    size_t operator()(const std::string_view str) const
+    {
+      return std::hash<std::string_view>{}(str);
+    }
+  };
+
+  /**
+   * Filled with the locations of all active uniforms when the program is linked, so that
+   * setting a uniform neither calls into the driver nor allocates a string.
+   */
+  using UniformVariableCache =
+    std::unordered_map<std::string, GLint, StringHash, std::equal_to<>>;
   using AttributeLocationCache = std::unordered_map<std::string, GLint>;
 
   std::string m_name;
@@ -61,28 +91,46 @@ public:
   void attach(Shader& shader) const;
   Result<void> link();
 
+  /**
+   * Loads a binary returned by binary() instead of attaching and linking shaders. Fails
+   * if the driver rejects the binary, e.g. because the driver has been updated.
+   */
+  Result<void> loadBinary(const ShaderProgramBinary& binary);
+
+  /**
+   * Returns the binary of this program, or nullopt if the driver does not provide it. The
+   * program must be linked.
+   */
+  std::optional<ShaderProgramBinary> binary() const;
+
   void activate(ShaderManager& shaderManager);
   void deactivate(ShaderManager& shaderManager);
 
-  void set(const std::string& name, bool value);
-  void set(const std::string& name, int value);
-  void set(const std::string& name, size_t value);
-  void set(const std::string& name, float value);
-  void set(const std::string& name, double value);
-  void set(const std::string& name, const vm::vec2f& value);
-  void set(const std::string& name, const vm::vec3f& value);
-  void set(const std::string& name, const vm::vec4f& value);
-  void set(const std::string& name, const vm::mat2x2f& value);
-  void set(const std::string& name, const vm::mat3x3f& value);
-  void set(const std::string& name, const vm::mat4x4f& value);
+  void set(std::string_view name, bool value);
+  void set(std::string_view name, int value);
+  void set(std::string_view name, size_t value);
+  void set(std::string_view name, float value);
+  void set(std::string_view name, double value);
+  void set(std::string_view name, const vm::vec2f& value);
+  void set(std::string_view name, const vm::vec3f& value);
+  void set(std::string_view name, const vm::vec4f& value);
+  void set(std::string_view name, const vm::mat2x2f& value);
+  void set(std::string_view name, const vm::mat3x3f& value);
+  void set(std::string_view name, const vm::mat4x4f& value);
 
   GLint findAttributeLocation(const std::string& name) const;
 
 private:
-  GLint findUniformLocation(const std::string& name) const;
+  void cacheUniformLocations();
+  GLint findUniformLocation(std::string_view name) const;
   bool checkActive() const;
 };
 
 Result<ShaderProgram> createShaderProgram(std::string name);
 
+/**
+ * Returns whether the driver can store and load the binaries of shader programs.
+ */
+bool programBinariesSupported();
+
 } // namespace tb::render
@@ -112,6 +112,12 @@ const ShaderConfig ColoredHandleShader = ShaderConfig{
   {"Handle.fragsh"},
 };
 
+const ShaderConfig PointHandleShader = ShaderConfig{
+  "Point Handle",
+  {"PointHandle.vertsh"},
+  {"PointHandle.fragsh"},
+};
+
 const ShaderConfig CompassShader = ShaderConfig{
   "Compass",
   {"Compass.vertsh"},
@@ -38,6 +38,7 @@ extern const ShaderConfig MaterialBrowserShader;
 extern const ShaderConfig MaterialBrowserBorderShader;
 extern const ShaderConfig HandleShader;
 extern const ShaderConfig ColoredHandleShader;
+extern const ShaderConfig PointHandleShader;
 extern const ShaderConfig CompassShader;
 extern const ShaderConfig CompassOutlineShader;
 extern const ShaderConfig CompassBackgroundShader;
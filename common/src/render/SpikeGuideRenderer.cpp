@@ -48,12 +48,11 @@ void SpikeGuideRenderer::add(
 {
   using namespace mdl::HitFilters;
 
-  auto pickResult = mdl::PickResult::byDistance();
+  const auto filter = type(mdl::BrushNode::BrushHitType) && minDistance(1.0);
+  auto pickResult = mdl::PickResult::byDistance(filter, 1);
   pick(map, ray, pickResult);
 
-  if (const auto& hit =
-        pickResult.first(type(mdl::BrushNode::BrushHitType) && minDistance(1.0));
-      hit.isMatch())
+  if (const auto& hit = pickResult.first(filter); hit.isMatch())
   {
     if (hit.distance() <= length)
     {
@@ -87,47 +87,36 @@ void TextRenderer::renderString(
 
   const auto& camera = renderContext.camera();
   const auto distance = camera.perpendicularDistanceTo(position.position(camera));
-  if (distance <= 0.0f || !isVisible(renderContext, string, position, distance, onTop))
+  if (distance <= 0.0f)
   {
     return;
   }
 
+  // the glyph layout doesn't depend on the view and is shared by all views
   auto& fontManager = renderContext.fontManager();
   auto& font = fontManager.font(m_fontDescriptor);
+  auto layout = font.layout(string);
 
-  auto vertices = font.quads(string, true);
-  const auto alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-  const auto size = font.measure(string);
-  const auto offset = position.offset(camera, size);
-
-  if (onTop)
-  {
-    addEntry(
-      m_entriesOnTop,
-      Entry{
-        std::move(vertices),
-        size,
-        offset,
-        Color{textColor, alphaFactor * textColor.a()},
-        Color{backgroundColor, alphaFactor * backgroundColor.a()},
-      });
-  }
-  else
+  if (!isVisible(renderContext, vm::round(layout->size), position, distance, onTop))
   {
-    addEntry(
-      m_entries,
-      Entry{
-        std::move(vertices),
-        size,
-        offset,
-        Color{textColor, alphaFactor * textColor.a()},
-        Color{backgroundColor, alphaFactor * backgroundColor.a()}});
+    return;
   }
+
+  const auto alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
+  const auto offset = position.offset(camera, layout->size);
+
+  addEntry(
+    onTop ? m_entriesOnTop : m_entries,
+    Entry{
+      std::move(layout),
+      offset,
+      Color{textColor, alphaFactor * textColor.a()},
+      Color{backgroundColor, alphaFactor * backgroundColor.a()}});
 }
 
 bool TextRenderer::isVisible(
   RenderContext& renderContext,
-  const AttrString& string,
+  const vm::vec2f& stringSize,
   const TextAnchor& position,
   const float distance,
   const bool onTop) const
@@ -147,9 +136,8 @@ bool TextRenderer::isVisible(
   const auto& camera = renderContext.camera();
   const auto& viewport = camera.viewport();
 
-  const auto size = stringSize(renderContext, string);
-  const auto offset = vm::vec2f{position.offset(camera, size)} - m_inset;
-  const auto actualSize = size + 2.0f * m_inset;
+  const auto offset = vm::vec2f{position.offset(camera, stringSize)} - m_inset;
+  const auto actualSize = stringSize + 2.0f * m_inset;
 
   return viewport.contains(offset.x(), offset.y(), actualSize.x(), actualSize.y());
 }
@@ -173,19 +161,11 @@ float TextRenderer::computeAlphaFactor(
   return std::min(d / 0.3f, 1.0f);
 }
 
-void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry)
+void TextRenderer::addEntry(EntryCollection& collection, Entry entry)
 {
-  collection.entries.push_back(entry);
-  collection.textVertexCount += entry.vertices.size();
+  collection.textVertexCount += entry.layout->quads.size();
   collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
-}
-
-vm::vec2f TextRenderer::stringSize(
-  RenderContext& renderContext, const AttrString& string) const
-{
-  auto& fontManager = renderContext.fontManager();
-  auto& font = fontManager.font(m_fontDescriptor);
-  return vm::round(font.measure(string));
+  collection.entries.push_back(std::move(entry));
 }
 
 void TextRenderer::doPrepareVertices(VboManager& vboManager)
@@ -221,8 +201,8 @@ void TextRenderer::addEntry(
   std::vector<TextVertex>& textVertices,
   std::vector<RectVertex>& rectVertices)
 {
-  const auto& stringVertices = entry.vertices;
-  const auto& stringSize = entry.size;
+  const auto& stringVertices = entry.layout->quads;
+  const auto& stringSize = entry.layout->size;
 
   const auto& offset = entry.offset;
 
@@ -247,6 +227,11 @@ void TextRenderer::addEntry(
   }
 }
 
+std::string TextRenderer::profileLabel() const
+{
+  return "Text";
+}
+
 void TextRenderer::doRender(RenderContext& renderContext)
 {
   const auto& viewport = renderContext.camera().viewport();
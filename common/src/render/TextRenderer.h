@@ -27,6 +27,7 @@
 
 #include "vm/vec.h"
 
+#include <memory>
 #include <vector>
 
 namespace tb::render
@@ -34,20 +35,22 @@ namespace tb::render
 class AttrString;
 class RenderContext;
 class TextAnchor;
+struct TextLayout;
 
 class TextRenderer : public DirectRenderable
 {
-private:
+public:
   static const float DefaultMaxViewDistance;
   static const float DefaultMinZoomFactor;
   static const vm::vec2f DefaultInset;
+
+private:
   static const size_t RectCornerSegments;
   static const float RectCornerRadius;
 
   struct Entry
   {
-    std::vector<vm::vec2f> vertices;
-    vm::vec2f size;
+    std::shared_ptr<const TextLayout> layout;
     vm::vec3f offset;
     Color textColor;
     Color backgroundColor;
@@ -81,6 +84,8 @@ public:
     float minZoomFactor = DefaultMinZoomFactor,
     const vm::vec2f& inset = DefaultInset);
 
+  std::string profileLabel() const override;
+
   void renderString(
     RenderContext& renderContext,
     const Color& textColor,
@@ -105,15 +110,13 @@ private:
 
   bool isVisible(
     RenderContext& renderContext,
-    const AttrString& string,
+    const vm::vec2f& stringSize,
     const TextAnchor& position,
     float distance,
     bool onTop) const;
   float computeAlphaFactor(
     const RenderContext& renderContext, float distance, bool onTop) const;
-  void addEntry(EntryCollection& collection, const Entry& entry);
-
-  vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
+  void addEntry(EntryCollection& collection, Entry entry);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
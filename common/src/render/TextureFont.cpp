@@ -31,20 +31,29 @@
 
 namespace tb::render
 {
+namespace
+{
+
+// The maximum number of cached text layouts. The cache is cleared when it's full.
+constexpr auto MaxCachedTextLayouts = size_t(8192);
+
+} // namespace
 
 TextureFont::TextureFont(
-  std::unique_ptr<FontTexture> texture,
+  std::shared_ptr<FontTexture> texture,
   const std::vector<FontGlyph>& glyphs,
   const int ascend,
   const int descend,
   const int lineHeight,
   const unsigned char firstChar,
-  const unsigned char charCount)
+  const unsigned char charCount,
+  const float scale)
   : m_texture{std::move(texture)}
   , m_glyphs{glyphs}
   , m_ascend{ascend}
   , m_descend{descend}
   , m_lineHeight{lineHeight}
+  , m_scale{scale}
   , m_firstChar{firstChar}
   , m_charCount{charCount}
 {
@@ -52,19 +61,32 @@ TextureFont::TextureFont(
 
 TextureFont::~TextureFont() = default;
 
+std::unique_ptr<TextureFont> TextureFont::scaled(const float factor) const
+{
+  return std::make_unique<TextureFont>(
+    m_texture,
+    m_glyphs,
+    m_ascend,
+    m_descend,
+    m_lineHeight,
+    m_firstChar,
+    m_charCount,
+    m_scale * factor);
+}
+
 int TextureFont::ascend() const
 {
-  return m_ascend;
+  return int(vm::round(float(m_ascend) * m_scale));
 }
 
 int TextureFont::descend() const
 {
-  return m_descend;
+  return int(vm::round(float(m_descend) * m_scale));
 }
 
 int TextureFont::lineHeight() const
 {
-  return m_lineHeight;
+  return int(vm::round(float(m_lineHeight) * m_scale));
 }
 
 class MeasureString : public AttrString::LineFunc
@@ -207,15 +229,15 @@ std::vector<vm::vec2f> TextureFont::quads(
   auto result = std::vector<vm::vec2f>{};
   result.reserve(string.length() * 4 * 2);
 
-  auto x = static_cast<int>(vm::round(offset.x()));
-  auto y = static_cast<int>(vm::round(offset.y()));
+  auto x = vm::round(offset.x());
+  auto y = vm::round(offset.y());
   for (size_t i = 0; i < string.length(); i++)
   {
     auto c = string[i];
     if (c == '\n')
     {
-      x = 0;
-      y += m_lineHeight;
+      x = 0.0f;
+      y += float(lineHeight());
       continue;
     }
 
@@ -227,10 +249,10 @@ std::vector<vm::vec2f> TextureFont::quads(
     const auto& glyph = m_glyphs[static_cast<size_t>(c - m_firstChar)];
     if (c != ' ')
     {
-      glyph.appendVertices(result, x, y, m_texture->size(), clockwise);
+      glyph.appendVertices(result, x, y, m_texture->size(), m_scale, clockwise);
     }
 
-    x += glyph.advance();
+    x += float(glyph.advance()) * m_scale;
   }
   return result;
 }
@@ -239,16 +261,16 @@ vm::vec2f TextureFont::measure(const std::string& string) const
 {
   auto result = vm::vec2f{};
 
-  int x = 0;
-  int y = 0;
+  auto x = 0.0f;
+  auto y = 0.0f;
   for (size_t i = 0; i < string.length(); i++)
   {
     auto c = string[i];
     if (c == '\n')
     {
-      result[0] = std::max(result[0], static_cast<float>(x));
-      x = 0;
-      y += m_lineHeight;
+      result[0] = std::max(result[0], x);
+      x = 0.0f;
+      y += float(lineHeight());
       continue;
     }
 
@@ -258,14 +280,32 @@ vm::vec2f TextureFont::measure(const std::string& string) const
     }
 
     const auto& glyph = m_glyphs[static_cast<size_t>(c - m_firstChar)];
-    x += glyph.advance();
+    x += float(glyph.advance()) * m_scale;
   }
 
-  result[0] = std::max(result[0], static_cast<float>(x));
-  result[1] = static_cast<float>(y + m_lineHeight);
+  result[0] = std::max(result[0], x);
+  result[1] = y + float(lineHeight());
   return result;
 }
 
+std::shared_ptr<const TextLayout> TextureFont::layout(const AttrString& string) const
+{
+  if (const auto iLayout = m_layoutCache.find(string); iLayout != m_layoutCache.end())
+  {
+    return iLayout->second;
+  }
+
+  if (m_layoutCache.size() >= MaxCachedTextLayouts)
+  {
+    m_layoutCache.clear();
+  }
+
+  auto layout =
+    std::make_shared<const TextLayout>(TextLayout{quads(string, true), measure(string)});
+  m_layoutCache.emplace(string, layout);
+  return layout;
+}
+
 void TextureFont::activate()
 {
   m_texture->activate();
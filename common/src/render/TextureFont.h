@@ -20,44 +20,68 @@
 #pragma once
 
 #include "Macros.h"
+#include "render/AttrString.h"
 
 #include "vm/vec.h"
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace tb::render
 {
-class AttrString;
 class FontGlyph;
 class FontTexture;
 
+/**
+ * The clockwise glyph quads and the size of a string, see TextureFont::layout.
+ */
+struct TextLayout
+{
+  std::vector<vm::vec2f> quads;
+  vm::vec2f size;
+};
+
+/**
+ * A font whose glyphs are stored in a texture. The glyph quads and metrics can be scaled
+ * by a constant factor, so that fonts of different sizes can share one texture.
+ */
 class TextureFont
 {
 private:
-  std::unique_ptr<FontTexture> m_texture;
+  std::shared_ptr<FontTexture> m_texture;
   std::vector<FontGlyph> m_glyphs;
   int m_ascend;
   int m_descend;
   int m_lineHeight;
+  float m_scale;
 
   unsigned char m_firstChar;
   unsigned char m_charCount;
 
+  mutable std::map<AttrString, std::shared_ptr<const TextLayout>> m_layoutCache;
+
 public:
   TextureFont(
-    std::unique_ptr<FontTexture> texture,
+    std::shared_ptr<FontTexture> texture,
     const std::vector<FontGlyph>& glyphs,
     int ascend,
     int descend,
     int lineHeight,
     unsigned char firstChar,
-    unsigned char charCount);
+    unsigned char charCount,
+    float scale = 1.0f);
   ~TextureFont();
 
   deleteCopyAndMove(TextureFont);
 
+  /**
+   * Returns a font that shares this font's texture and whose glyphs and metrics are
+   * scaled by the given factor relative to this font.
+   */
+  std::unique_ptr<TextureFont> scaled(float factor) const;
+
   int ascend() const;
   int descend() const;
   int lineHeight() const;
@@ -74,6 +98,12 @@ public:
     const vm::vec2f& offset = vm::vec2f{0, 0}) const;
   vm::vec2f measure(const std::string& string) const;
 
+  /**
+   * Returns the glyph quads and the size of the given string. The layout is computed once
+   * and then shared by all views that render the string until the cache is full.
+   */
+  std::shared_ptr<const TextLayout> layout(const AttrString& string) const;
+
   void activate();
   void deactivate();
 };
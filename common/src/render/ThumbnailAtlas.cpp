@@ -0,0 +1,218 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThumbnailAtlas.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tb::render
+{
+
+ThumbnailAtlas::ThumbnailAtlas(const GLsizei slotSize, const GLsizei slotsPerRow)
+  : m_slotSize{slotSize}
+  , m_slotsPerRow{slotsPerRow}
+  , m_slotUsage(size_t(slotsPerRow * slotsPerRow), 0)
+{
+  assert(m_slotSize > 0);
+  assert(m_slotsPerRow > 0);
+}
+
+ThumbnailAtlas::~ThumbnailAtlas()
+{
+  destroyFramebuffer();
+  if (m_textureId != 0)
+  {
+    glAssert(glDeleteTextures(1, &m_textureId));
+    m_textureId = 0;
+  }
+}
+
+GLsizei ThumbnailAtlas::slotSize() const
+{
+  return m_slotSize;
+}
+
+size_t ThumbnailAtlas::slotCount() const
+{
+  return m_slotUsage.size();
+}
+
+size_t ThumbnailAtlas::allocateSlot()
+{
+  // free slots have a usage stamp of 0, so they are found first
+  const auto it = std::ranges::min_element(m_slotUsage);
+  const auto slot = size_t(std::distance(m_slotUsage.begin(), it));
+  useSlot(slot);
+  return slot;
+}
+
+void ThumbnailAtlas::useSlot(const size_t slot)
+{
+  assert(slot < m_slotUsage.size());
+  m_slotUsage[slot] = ++m_currentUsage;
+}
+
+void ThumbnailAtlas::freeSlots()
+{
+  std::ranges::fill(m_slotUsage, 0);
+  m_currentUsage = 0;
+}
+
+bool ThumbnailAtlas::beginRender()
+{
+  glAssert(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebufferId));
+
+  if (m_framebufferId == 0 && !createFramebuffer())
+  {
+    destroyFramebuffer();
+    glAssert(glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_previousFramebufferId)));
+    return false;
+  }
+
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferId));
+  glAssert(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+  glAssert(glClearDepth(1.0));
+  glAssert(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+  return true;
+}
+
+std::vector<unsigned char> ThumbnailAtlas::endRender(
+  const size_t slot, const GLsizei width, const GLsizei height)
+{
+  assert(width <= m_slotSize && height <= m_slotSize);
+
+  auto pixels = std::vector<unsigned char>(size_t(width * height * 4));
+  glAssert(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  glAssert(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_previousFramebufferId)));
+
+  upload(slot, width, height, pixels.data());
+  return pixels;
+}
+
+void ThumbnailAtlas::upload(
+  const size_t slot,
+  const GLsizei width,
+  const GLsizei height,
+  const unsigned char* pixels)
+{
+  assert(slot < m_slotUsage.size());
+  assert(width <= m_slotSize && height <= m_slotSize);
+
+  if (m_textureId == 0)
+  {
+    createTexture();
+  }
+
+  const auto x = GLint(slot) % m_slotsPerRow * m_slotSize;
+  const auto y = GLint(slot) / m_slotsPerRow * m_slotSize;
+
+  glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+  glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  glAssert(glTexSubImage2D(
+    GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+vm::bbox2f ThumbnailAtlas::texCoords(
+  const size_t slot, const float width, const float height) const
+{
+  const auto atlasSize = float(this->atlasSize());
+  const auto x = float(GLint(slot) % m_slotsPerRow * m_slotSize);
+  const auto y = float(GLint(slot) / m_slotsPerRow * m_slotSize);
+  return {
+    vm::vec2f{x / atlasSize, y / atlasSize},
+    vm::vec2f{(x + width) / atlasSize, (y + height) / atlasSize}};
+}
+
+void ThumbnailAtlas::activate() const
+{
+  glAssert(glActiveTexture(GL_TEXTURE0));
+  glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+}
+
+void ThumbnailAtlas::deactivate() const
+{
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+GLsizei ThumbnailAtlas::atlasSize() const
+{
+  return m_slotSize * m_slotsPerRow;
+}
+
+void ThumbnailAtlas::createTexture()
+{
+  const auto size = atlasSize();
+
+  glAssert(glGenTextures(1, &m_textureId));
+  glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+  glAssert(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  glAssert(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  glAssert(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  glAssert(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  glAssert(glTexImage2D(
+    GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+bool ThumbnailAtlas::createFramebuffer()
+{
+  const auto createRenderbuffer = [&](GLuint& renderbufferId, const GLenum format) {
+    glAssert(glGenRenderbuffers(1, &renderbufferId));
+    glAssert(glBindRenderbuffer(GL_RENDERBUFFER, renderbufferId));
+    glAssert(glRenderbufferStorage(GL_RENDERBUFFER, format, m_slotSize, m_slotSize));
+  };
+
+  createRenderbuffer(m_colorRenderbufferId, GL_RGBA8);
+  createRenderbuffer(m_depthRenderbufferId, GL_DEPTH_COMPONENT24);
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  glAssert(glGenFramebuffers(1, &m_framebufferId));
+  glAssert(glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferId));
+  glAssert(glFramebufferRenderbuffer(
+    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbufferId));
+  glAssert(glFramebufferRenderbuffer(
+    GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbufferId));
+
+  auto status = GLenum(0);
+  glAssert(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+  return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void ThumbnailAtlas::destroyFramebuffer()
+{
+  if (m_framebufferId != 0)
+  {
+    glAssert(glDeleteFramebuffers(1, &m_framebufferId));
+    m_framebufferId = 0;
+  }
+  if (m_colorRenderbufferId != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_colorRenderbufferId));
+    m_colorRenderbufferId = 0;
+  }
+  if (m_depthRenderbufferId != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_depthRenderbufferId));
+    m_depthRenderbufferId = 0;
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Macros.h"
+#include "render/GL.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * A texture that stores small images, such as thumbnails, in a grid of square slots of
+ * equal size.
+ *
+ * Images are rendered into an offscreen framebuffer of the size of one slot and then
+ * copied into a slot of the atlas texture, or they are uploaded into a slot directly.
+ * Once all slots are in use, the least recently used slot is reused.
+ *
+ * All GL objects are created lazily, so an atlas can be created without a current
+ * OpenGL context, but it must be destroyed while its context is current.
+ */
+class ThumbnailAtlas
+{
+private:
+  GLsizei m_slotSize;
+  GLsizei m_slotsPerRow;
+
+  GLuint m_textureId = 0;
+  GLuint m_framebufferId = 0;
+  GLuint m_colorRenderbufferId = 0;
+  GLuint m_depthRenderbufferId = 0;
+  GLint m_previousFramebufferId = 0;
+
+  // the usage stamp of each slot, 0 if the slot is free
+  std::vector<uint64_t> m_slotUsage;
+  uint64_t m_currentUsage = 0;
+
+public:
+  ThumbnailAtlas(GLsizei slotSize, GLsizei slotsPerRow);
+  ~ThumbnailAtlas();
+
+  GLsizei slotSize() const;
+  size_t slotCount() const;
+
+  /**
+   * Returns a free slot, or the least recently used slot if every slot is in use. The
+   * returned slot is marked as used.
+   */
+  size_t allocateSlot();
+
+  /**
+   * Marks the given slot as the most recently used one.
+   */
+  void useSlot(size_t slot);
+
+  /**
+   * Marks all slots as free. The contents of the atlas texture are kept.
+   */
+  void freeSlots();
+
+  /**
+   * Binds the offscreen framebuffer and clears it. The caller must set up the viewport
+   * for the framebuffer's size, which is the slot size.
+   *
+   * Returns false if the driver cannot create the framebuffer. The previously bound
+   * framebuffer remains bound in that case.
+   */
+  bool beginRender();
+
+  /**
+   * Copies the given region at the bottom left of the offscreen framebuffer into the
+   * given slot, binds the previously bound framebuffer again and returns the copied RGBA
+   * pixels, starting with the bottom row.
+   */
+  std::vector<unsigned char> endRender(size_t slot, GLsizei width, GLsizei height);
+
+  /**
+   * Copies the given RGBA pixels into the bottom left corner of the given slot.
+   */
+  void upload(size_t slot, GLsizei width, GLsizei height, const unsigned char* pixels);
+
+  /**
+   * Returns the texture coordinates of the region of the given size at the bottom left of
+   * the given slot.
+   */
+  vm::bbox2f texCoords(size_t slot, float width, float height) const;
+
+  void activate() const;
+  void deactivate() const;
+
+private:
+  GLsizei atlasSize() const;
+  void createTexture();
+  bool createFramebuffer();
+  void destroyFramebuffer();
+
+  deleteCopyAndMove(ThumbnailAtlas);
+};
+
+} // namespace tb::render
@@ -20,6 +20,7 @@
 #include "Transformation.h"
 
 #include "render/GL.h"
+#include "render/RenderUtils.h"
 
 #include "vm/mat.h"
 
@@ -115,8 +116,9 @@ void Transformation::popModelMatrix()
 
 void Transformation::loadProjectionMatrix(const vm::mat4x4f& matrix)
 {
+  const auto projection = glIsReverseDepth() ? reverseDepthProjection(matrix) : matrix;
   glAssert(glMatrixMode(GL_PROJECTION));
-  glAssert(glLoadMatrixf(reinterpret_cast<const float*>(matrix.v)));
+  glAssert(glLoadMatrixf(reinterpret_cast<const float*>(projection.v)));
 }
 
 void Transformation::loadModelViewMatrix(const vm::mat4x4f& matrix)
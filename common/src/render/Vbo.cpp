@@ -19,6 +19,8 @@
 
 #include "Vbo.h"
 
+#include "render/RenderProfiler.h"
+
 #include <cassert>
 
 namespace tb::render
@@ -27,6 +29,7 @@ namespace tb::render
 Vbo::Vbo(const GLenum type, const size_t capacity, const GLenum usage)
   : m_type{type}
   , m_capacity{capacity}
+  , m_usage{usage}
 {
   assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
 
@@ -61,6 +64,7 @@ void Vbo::bind() const
 {
   assert(m_bufferId != 0);
   glAssert(glBindBuffer(m_type, m_bufferId));
+  ++currentStateChangeCounts().bufferBinds;
 }
 
 void Vbo::unbind() const
@@ -69,4 +73,12 @@ void Vbo::unbind() const
   glAssert(glBindBuffer(m_type, 0));
 }
 
+void Vbo::orphan()
+{
+  assert(m_bufferId != 0);
+  glAssert(glBindBuffer(m_type, m_bufferId));
+  glAssert(
+    glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, m_usage));
+}
+
 } // namespace tb::render
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "render/GL.h"
+#include "render/RenderProfiler.h"
 #include "render/VboManager.h"
 
 #include <cassert>
@@ -42,6 +43,7 @@ private:
    */
   GLenum m_type;
   size_t m_capacity;
+  GLenum m_usage;
   GLuint m_bufferId;
 
 public:
@@ -68,6 +70,13 @@ public:
   void bind() const;
   void unbind() const;
 
+  /**
+   * Replaces the storage of this buffer with new storage of the same capacity. The
+   * contents are unspecified afterwards, but draw calls that are still pending continue
+   * to use the old storage, so the next write does not have to wait for them.
+   */
+  void orphan();
+
   template <typename T>
   size_t writeElements(const size_t address, const std::vector<T>& elements)
   {
@@ -103,6 +112,7 @@ public:
     const auto sizei = static_cast<GLsizeiptr>(size);
     glAssert(glBindBuffer(m_type, m_bufferId));
     glAssert(glBufferSubData(m_type, offset, sizei, ptr));
+    currentStateChangeCounts().uploadedBytes += size;
 
     return size;
   }
@@ -22,6 +22,7 @@
 #include "GL.h"
 #include "Macros.h"
 #include "Vbo.h"
+#include "VboRingBuffer.h"
 
 #include <algorithm>
 #include <memory>
@@ -29,6 +30,12 @@
 namespace tb::render
 {
 
+/**
+ * The capacity of the streaming vertex buffer. This should hold several frames worth of
+ * tool geometry.
+ */
+static constexpr auto StreamingVertexBufferCapacity = size_t(8 * 1024 * 1024);
+
 /**
  * e.g. GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
  */
@@ -52,6 +59,8 @@ static GLenum usageToOpenGL(const VboUsage usage)
     return GL_STATIC_DRAW;
   case VboUsage::DynamicDraw:
     return GL_DYNAMIC_DRAW;
+  case VboUsage::StreamDraw:
+    return GL_STREAM_DRAW;
     switchDefault();
   }
 }
@@ -63,6 +72,14 @@ VboManager::VboManager(ShaderManager& shaderManager)
 {
 }
 
+VboManager::~VboManager()
+{
+  if (m_streamingVertexBuffer)
+  {
+    m_streamingVertexBuffer->free();
+  }
+}
+
 Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage)
 {
   auto result = std::make_unique<Vbo>(typeToOpenGL(type), capacity, usageToOpenGL(usage));
@@ -83,6 +100,24 @@ void VboManager::destroyVbo(Vbo* vbo)
   delete vbo;
 }
 
+VboRingBuffer& VboManager::streamingVertexBuffer()
+{
+  if (!m_streamingVertexBuffer)
+  {
+    m_streamingVertexBuffer = std::make_unique<VboRingBuffer>(
+      GL_ARRAY_BUFFER, StreamingVertexBufferCapacity, GLEW_ARB_buffer_storage);
+  }
+  return *m_streamingVertexBuffer;
+}
+
+void VboManager::finishFrame()
+{
+  if (m_streamingVertexBuffer)
+  {
+    m_streamingVertexBuffer->fence();
+  }
+}
+
 size_t VboManager::peakVboCount() const
 {
   return m_peakVboCount;
@@ -20,10 +20,12 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 
 namespace tb::render
 {
 class Vbo;
+class VboRingBuffer;
 class ShaderManager;
 
 enum class VboType
@@ -35,7 +37,8 @@ enum class VboType
 enum class VboUsage
 {
   StaticDraw,
-  DynamicDraw
+  DynamicDraw,
+  StreamDraw
 };
 
 class VboManager
@@ -45,9 +48,12 @@ private:
   size_t m_currentVboCount = 0;
   size_t m_currentVboSize = 0;
   ShaderManager& m_shaderManager;
+  std::unique_ptr<VboRingBuffer> m_streamingVertexBuffer;
 
 public:
   explicit VboManager(ShaderManager& shaderManager);
+  ~VboManager();
+
   /**
    * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
    * The contents are initially unspecified. See Vbo class.
@@ -55,6 +61,19 @@ public:
   Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
   void destroyVbo(Vbo* vbo);
 
+  /**
+   * Returns a ring buffer for vertex data that is only rendered in the current frame. The
+   * buffer is created on first use, and it is persistently mapped if the OpenGL
+   * implementation supports GL_ARB_buffer_storage.
+   */
+  VboRingBuffer& streamingVertexBuffer();
+
+  /**
+   * Must be called after all draw calls of a frame have been issued, so that the data
+   * streamed in this frame can be reclaimed once the GPU is done with it.
+   */
+  void finishFrame();
+
   size_t peakVboCount() const;
   size_t currentVboCount() const;
   size_t currentVboSize() const;
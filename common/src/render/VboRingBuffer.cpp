@@ -0,0 +1,272 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VboRingBuffer.h"
+
+#include "render/RenderProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace tb::render
+{
+namespace
+{
+
+/**
+ * The alignment of every write, sufficient for any vertex attribute type.
+ */
+constexpr auto WriteAlignment = size_t(16);
+
+constexpr auto PersistentMapFlags =
+  GLbitfield(GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+constexpr auto FenceTimeout = GLuint64(1000000000); // one second, in nanoseconds
+
+size_t align(const size_t offset)
+{
+  return (offset + WriteAlignment - 1) / WriteAlignment * WriteAlignment;
+}
+
+template <typename R1, typename R2>
+bool overlaps(const R1& lhs, const R2& rhs)
+{
+  return lhs.begin < rhs.end && rhs.begin < lhs.end;
+}
+
+} // namespace
+
+VboRingBuffer::VboRingBuffer(const GLenum type, const size_t capacity, const bool persistent)
+  : m_type{type}
+  , m_capacity{capacity}
+{
+  assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
+
+  const auto sizei = static_cast<GLsizeiptr>(m_capacity);
+
+  if (persistent)
+  {
+    glAssert(glGenBuffers(1, &m_bufferId));
+    glAssert(glBindBuffer(m_type, m_bufferId));
+    glAssert(glBufferStorage(m_type, sizei, nullptr, PersistentMapFlags));
+    m_mappedData = glMapBufferRange(m_type, 0, sizei, PersistentMapFlags);
+
+    if (m_mappedData == nullptr)
+    {
+      // the storage of this buffer is immutable, so we need a new one for orphaning
+      glAssert(glDeleteBuffers(1, &m_bufferId));
+      m_bufferId = 0;
+    }
+  }
+
+  if (m_bufferId == 0)
+  {
+    glAssert(glGenBuffers(1, &m_bufferId));
+    glAssert(glBindBuffer(m_type, m_bufferId));
+    glAssert(glBufferData(m_type, sizei, nullptr, GL_STREAM_DRAW));
+  }
+}
+
+VboRingBuffer::~VboRingBuffer()
+{
+  assert(m_bufferId == 0);
+}
+
+void VboRingBuffer::free()
+{
+  assert(m_bufferId != 0);
+
+  for (const auto& fence : m_fences)
+  {
+    glAssert(glDeleteSync(fence.sync));
+  }
+  m_fences.clear();
+  m_pendingRanges.clear();
+
+  if (m_mappedData != nullptr)
+  {
+    glAssert(glBindBuffer(m_type, m_bufferId));
+    glAssert(glUnmapBuffer(m_type));
+    m_mappedData = nullptr;
+  }
+
+  glAssert(glDeleteBuffers(1, &m_bufferId));
+  m_bufferId = 0;
+}
+
+bool VboRingBuffer::persistent() const
+{
+  return m_mappedData != nullptr;
+}
+
+size_t VboRingBuffer::capacity() const
+{
+  return m_capacity;
+}
+
+std::optional<size_t> VboRingBuffer::write(const void* data, const size_t size)
+{
+  assert(m_bufferId != 0);
+
+  if (size == 0 || size > m_capacity)
+  {
+    return std::nullopt;
+  }
+
+  auto range = Range{align(m_head), align(m_head) + size};
+  const auto wrap = range.end > m_capacity;
+  if (wrap)
+  {
+    range = Range{0, size};
+  }
+
+  // all draw calls of a frame are issued after all of its data was written, so we must
+  // not overwrite or orphan anything that was written in the current frame
+  if (
+    overlapsPendingRanges(range) || (wrap && !persistent() && !m_pendingRanges.empty()))
+  {
+    return std::nullopt;
+  }
+
+  if (persistent())
+  {
+    waitForRange(range);
+    std::memcpy(static_cast<unsigned char*>(m_mappedData) + range.begin, data, size);
+  }
+  else
+  {
+    if (wrap)
+    {
+      orphan();
+    }
+
+    const auto offset = static_cast<GLintptr>(range.begin);
+    const auto sizei = static_cast<GLsizeiptr>(size);
+
+    glAssert(glBindBuffer(m_type, m_bufferId));
+
+    // the range was not used since the buffer was last orphaned, so there is no need to
+    // synchronize with pending draw calls
+    auto* dest = glMapBufferRange(
+      m_type,
+      offset,
+      sizei,
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dest != nullptr)
+    {
+      std::memcpy(dest, data, size);
+      glAssert(glUnmapBuffer(m_type));
+    }
+    else
+    {
+      glAssert(glBufferSubData(m_type, offset, sizei, data));
+    }
+  }
+
+  currentStateChangeCounts().uploadedBytes += size;
+  addPendingRange(range);
+  m_head = range.end;
+
+  return range.begin;
+}
+
+void VboRingBuffer::fence()
+{
+  if (m_pendingRanges.empty())
+  {
+    return;
+  }
+
+  if (persistent())
+  {
+    auto sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_fences.push_back(Fence{std::move(m_pendingRanges), sync});
+  }
+  m_pendingRanges.clear();
+}
+
+void VboRingBuffer::bind() const
+{
+  assert(m_bufferId != 0);
+  glAssert(glBindBuffer(m_type, m_bufferId));
+  ++currentStateChangeCounts().bufferBinds;
+}
+
+void VboRingBuffer::unbind() const
+{
+  assert(m_bufferId != 0);
+  glAssert(glBindBuffer(m_type, 0));
+}
+
+bool VboRingBuffer::overlapsPendingRanges(const Range& range) const
+{
+  return std::ranges::any_of(
+    m_pendingRanges, [&](const auto& pendingRange) { return overlaps(pendingRange, range); });
+}
+
+void VboRingBuffer::waitForRange(const Range& range)
+{
+  // the GPU executes commands in order, so waiting for the most recent fence that guards
+  // the range also waits for all earlier fences
+  const auto it = std::find_if(m_fences.rbegin(), m_fences.rend(), [&](const auto& fence) {
+    return std::ranges::any_of(
+      fence.ranges, [&](const auto& fenceRange) { return overlaps(fenceRange, range); });
+  });
+
+  if (it != m_fences.rend())
+  {
+    const auto sync = it->sync;
+    auto status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+    while (status == GL_TIMEOUT_EXPIRED)
+    {
+      status = glClientWaitSync(sync, 0, FenceTimeout);
+    }
+
+    const auto count = std::distance(it, m_fences.rend());
+    for (auto i = decltype(count){0}; i < count; ++i)
+    {
+      glAssert(glDeleteSync(m_fences.front().sync));
+      m_fences.pop_front();
+    }
+  }
+}
+
+void VboRingBuffer::addPendingRange(const Range& range)
+{
+  if (!m_pendingRanges.empty() && m_pendingRanges.back().end == range.begin)
+  {
+    m_pendingRanges.back().end = range.end;
+  }
+  else
+  {
+    m_pendingRanges.push_back(range);
+  }
+}
+
+void VboRingBuffer::orphan()
+{
+  assert(!persistent());
+
+  glAssert(glBindBuffer(m_type, m_bufferId));
+  glAssert(glBufferData(
+    m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW));
+}
+
+} // namespace tb::render
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "render/GL.h"
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * An OpenGL buffer that is used as a ring buffer to stream data that is only rendered
+ * in a single frame, e.g. the geometry of a tool that changes while the user is
+ * dragging.
+ *
+ * If the buffer is persistent, it is created with glBufferStorage and mapped once, and
+ * the data is copied into the mapping directly. Each frame's writes are guarded by a
+ * fence so that a region is only overwritten once the GPU has finished reading from it.
+ *
+ * Otherwise, the buffer is orphaned whenever the ring wraps around, so that the driver
+ * can hand out new storage instead of waiting for pending draw calls, and the data is
+ * written using unsynchronized mappings.
+ */
+class VboRingBuffer
+{
+private:
+  struct Range
+  {
+    size_t begin;
+    size_t end;
+  };
+
+  struct Fence
+  {
+    std::vector<Range> ranges;
+    GLsync sync;
+  };
+
+  /**
+   * e.g. GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+   */
+  GLenum m_type;
+  size_t m_capacity;
+  GLuint m_bufferId = 0;
+  void* m_mappedData = nullptr;
+
+  size_t m_head = 0;
+
+  /**
+   * The ranges that were written since the last fence was inserted.
+   */
+  std::vector<Range> m_pendingRanges;
+  std::deque<Fence> m_fences;
+
+public:
+  /**
+   * Immediately creates and binds to a buffer of the given type and capacity. If
+   * persistent mapping is requested but fails, the buffer falls back to orphaning.
+   */
+  VboRingBuffer(GLenum type, size_t capacity, bool persistent);
+  ~VboRingBuffer();
+
+  /**
+   * Deletes the underlying OpenGL buffer and all pending fences.
+   * Must be called before the destructor.
+   */
+  void free();
+
+  bool persistent() const;
+  size_t capacity() const;
+
+  /**
+   * Copies the given data into the ring buffer and returns the byte offset at which it
+   * was written.
+   *
+   * Returns an empty optional if the data does not fit into the buffer without
+   * overwriting data that was written in the current frame. In that case, the caller
+   * must upload the data in some other way.
+   */
+  std::optional<size_t> write(const void* data, size_t size);
+
+  /**
+   * Marks the end of a frame. Must be called after all draw calls that use the data
+   * written in the current frame have been issued.
+   */
+  void fence();
+
+  void bind() const;
+  void unbind() const;
+
+private:
+  bool overlapsPendingRanges(const Range& range) const;
+  void waitForRange(const Range& range);
+  void addPendingRange(const Range& range);
+  void orphan();
+};
+
+} // namespace tb::render
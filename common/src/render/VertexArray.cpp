@@ -20,14 +20,86 @@
 #include "VertexArray.h"
 
 #include "render/PrimType.h"
+#include "render/RenderProfiler.h"
+
+// see RenderView.cpp for why the warning about including glew first is silenced
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcpp"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcpp"
+#endif
+
+#include <QOpenGLContext>
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
 
 #include <cassert>
+#include <unordered_map>
 
 namespace tb::render
 {
 
 VertexArray::BaseHolder::~BaseHolder() = default;
 
+bool VertexArray::vertexArrayObjectsSupported()
+{
+  return GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+}
+
+size_t VertexArray::currentContextId()
+{
+  // Contexts are identified by a serial number rather than by their address, which may
+  // be reused by a context created after another one was destroyed.
+  static auto contextIds = std::unordered_map<const QOpenGLContext*, size_t>{};
+  static auto nextContextId = size_t(1);
+
+  const auto* context = QOpenGLContext::currentContext();
+  if (!context)
+  {
+    return 0;
+  }
+
+  const auto [it, inserted] = contextIds.try_emplace(context, nextContextId);
+  if (inserted)
+  {
+    ++nextContextId;
+    QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context]() {
+      contextIds.erase(context);
+    });
+  }
+  return it->second;
+}
+
+GLuint VertexArray::createVertexArrayObject()
+{
+  auto vertexArrayId = GLuint(0);
+  glAssert(glGenVertexArrays(1, &vertexArrayId));
+  return vertexArrayId;
+}
+
+void VertexArray::bindVertexArrayObject(const GLuint vertexArrayId)
+{
+  glAssert(glBindVertexArray(vertexArrayId));
+  if (vertexArrayId != 0)
+  {
+    ++currentStateChangeCounts().vertexArrayBinds;
+  }
+}
+
+void VertexArray::deleteVertexArrayObject(const GLuint vertexArrayId)
+{
+  if (vertexArrayId != 0)
+  {
+    glAssert(glDeleteVertexArrays(1, &vertexArrayId));
+  }
+}
+
 VertexArray::VertexArray() = default;
 
 bool VertexArray::empty() const
@@ -95,12 +167,14 @@ void VertexArray::render(const PrimType primType, const GLint index, const GLsiz
     if (setup())
     {
       glAssert(glDrawArrays(toGL(primType), index, count));
+      ++currentStateChangeCounts().drawCalls;
       cleanup();
     }
   }
   else
   {
     glAssert(glDrawArrays(toGL(primType), index, count));
+    ++currentStateChangeCounts().drawCalls;
   }
 }
 
@@ -118,6 +192,7 @@ void VertexArray::render(
       const auto* indexArray = indices.data();
       const auto* countArray = counts.data();
       glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+      ++currentStateChangeCounts().drawCalls;
       cleanup();
     }
   }
@@ -126,6 +201,7 @@ void VertexArray::render(
     const auto* indexArray = indices.data();
     const auto* countArray = counts.data();
     glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+    ++currentStateChangeCounts().drawCalls;
   }
 }
 
@@ -139,6 +215,7 @@ void VertexArray::render(
     {
       const auto* indexArray = indices.data();
       glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+      ++currentStateChangeCounts().drawCalls;
       cleanup();
     }
   }
@@ -146,6 +223,39 @@ void VertexArray::render(
   {
     const auto* indexArray = indices.data();
     glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+    ++currentStateChangeCounts().drawCalls;
+  }
+}
+
+void VertexArray::renderInstanced(
+  const PrimType primType,
+  const GLIndices& indices,
+  const GLCounts& counts,
+  const GLint primCount,
+  const GLsizei instanceCount)
+{
+  assert(prepared());
+
+  const auto draw = [&]() {
+    for (auto i = size_t(0); i < size_t(primCount); ++i)
+    {
+      glAssert(
+        glDrawArraysInstancedARB(toGL(primType), indices[i], counts[i], instanceCount));
+      ++currentStateChangeCounts().drawCalls;
+    }
+  };
+
+  if (!m_setup)
+  {
+    if (setup())
+    {
+      draw();
+      cleanup();
+    }
+  }
+  else
+  {
+    draw();
   }
 }
 
@@ -25,10 +25,13 @@
 #include "render/ShaderManager.h"
 #include "render/Vbo.h"
 #include "render/VboManager.h"
+#include "render/VboRingBuffer.h"
 
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace tb::render
@@ -60,13 +63,31 @@ private:
     virtual void cleanup() = 0;
   };
 
+  /**
+   * Stores its vertices in a buffer of its own. If vertex array objects are supported,
+   * the attribute pointers are recorded in a vertex array object the first time the
+   * vertices are rendered, so later renders only have to bind that. Since the locations
+   * of generic attributes depend on the shader program, the vertex array object is
+   * recreated when the vertices are rendered with a different program. Vertex array
+   * objects are not shared between OpenGL contexts, so one is kept for each context the
+   * vertices are rendered in.
+   */
   template <typename VertexSpec>
   class Holder : public BaseHolder
   {
   private:
+    struct VertexArrayObject
+    {
+      size_t contextId;
+      GLuint vertexArrayId;
+      const ShaderProgram* program;
+    };
+
     VboManager* m_vboManager = nullptr;
     Vbo* m_vbo = nullptr;
     size_t m_vertexCount = 0;
+    std::vector<VertexArrayObject> m_vertexArrayObjects;
+    bool m_vertexArrayObjectBound = false;
 
   public:
     size_t vertexCount() const override { return m_vertexCount; }
@@ -86,14 +107,63 @@ private:
     void setup() override
     {
       ensure(m_vbo, "block is null");
-      m_vbo->bind();
-      VertexSpec::setup(m_vboManager->shaderManager().currentProgram(), m_vbo->offset());
+      auto* program = m_vboManager->shaderManager().currentProgram();
+      const auto contextId = currentContextId();
+      if (!vertexArrayObjectsSupported() || contextId == 0)
+      {
+        m_vbo->bind();
+        VertexSpec::setup(program, m_vbo->offset());
+        return;
+      }
+
+      auto* vertexArrayObject = findVertexArrayObject(contextId);
+      if (vertexArrayObject && vertexArrayObject->program == program)
+      {
+        bindVertexArrayObject(vertexArrayObject->vertexArrayId);
+      }
+      else
+      {
+        if (vertexArrayObject)
+        {
+          deleteVertexArrayObject(vertexArrayObject->vertexArrayId);
+          vertexArrayObject->vertexArrayId = createVertexArrayObject();
+          vertexArrayObject->program = program;
+        }
+        else
+        {
+          vertexArrayObject = &m_vertexArrayObjects.emplace_back(
+            VertexArrayObject{contextId, createVertexArrayObject(), program});
+        }
+
+        bindVertexArrayObject(vertexArrayObject->vertexArrayId);
+        m_vbo->bind();
+        VertexSpec::setup(program, m_vbo->offset());
+        m_vbo->unbind();
+      }
+      m_vertexArrayObjectBound = true;
     }
 
     void cleanup() override
     {
-      VertexSpec::cleanup(m_vboManager->shaderManager().currentProgram());
-      m_vbo->unbind();
+      if (m_vertexArrayObjectBound)
+      {
+        // the enabled attributes are part of the vertex array object's state
+        bindVertexArrayObject(0);
+        m_vertexArrayObjectBound = false;
+      }
+      else
+      {
+        VertexSpec::cleanup(m_vboManager->shaderManager().currentProgram());
+        m_vbo->unbind();
+      }
+    }
+
+  private:
+    VertexArrayObject* findVertexArrayObject(const size_t contextId)
+    {
+      const auto it = std::ranges::find(
+        m_vertexArrayObjects, contextId, &VertexArrayObject::contextId);
+      return it != m_vertexArrayObjects.end() ? &*it : nullptr;
     }
 
   protected:
@@ -106,6 +176,12 @@ private:
     {
       // TODO: Revisit this revisiting OpenGL resource management. We should not store the
       // VboManager, since it represents a safe time to delete the OpenGL buffer object.
+      // Vertex array objects can only be deleted in the context that created them. The
+      // ones belonging to other contexts are released when those contexts are destroyed.
+      if (const auto* vertexArrayObject = findVertexArrayObject(currentContextId()))
+      {
+        deleteVertexArrayObject(vertexArrayObject->vertexArrayId);
+      }
       if (m_vbo)
       {
         m_vboManager->destroyVbo(m_vbo);
@@ -170,7 +246,97 @@ private:
     const VertexList& doGetVertices() const override { return m_vertices; }
   };
 
+  /**
+   * Writes its vertices into the streaming vertex buffer of the VboManager instead of
+   * allocating a buffer of its own. Falls back to a dedicated buffer if the vertices do
+   * not fit into the streaming buffer.
+   */
+  template <typename VertexSpec>
+  class StreamingHolder : public BaseHolder
+  {
+  private:
+    using VertexList = std::vector<typename VertexSpec::Vertex>;
+
+    VboManager* m_vboManager = nullptr;
+    std::optional<size_t> m_streamOffset;
+    Vbo* m_vbo = nullptr;
+    size_t m_vertexCount = 0;
+    VertexList m_vertices;
+
+  public:
+    explicit StreamingHolder(VertexList&& vertices)
+      : m_vertexCount{vertices.size()}
+      , m_vertices{std::move(vertices)}
+    {
+    }
+
+    ~StreamingHolder() override
+    {
+      if (m_vbo)
+      {
+        m_vboManager->destroyVbo(m_vbo);
+        m_vbo = nullptr;
+      }
+    }
+
+    size_t vertexCount() const override { return m_vertexCount; }
+
+    size_t sizeInBytes() const override { return VertexSpec::Size * m_vertexCount; }
+
+    void prepare(VboManager& vboManager) override
+    {
+      if (m_vertexCount > 0 && !m_streamOffset && m_vbo == nullptr)
+      {
+        m_vboManager = &vboManager;
+        m_streamOffset =
+          vboManager.streamingVertexBuffer().write(m_vertices.data(), sizeInBytes());
+        if (!m_streamOffset)
+        {
+          m_vbo = vboManager.allocateVbo(
+            VboType::ArrayBuffer, sizeInBytes(), VboUsage::StreamDraw);
+          m_vbo->writeBuffer(0, m_vertices);
+        }
+        kdl::vec_clear_to_zero(m_vertices);
+      }
+    }
+
+    void setup() override
+    {
+      auto* program = m_vboManager->shaderManager().currentProgram();
+      if (m_streamOffset)
+      {
+        m_vboManager->streamingVertexBuffer().bind();
+        VertexSpec::setup(program, *m_streamOffset);
+      }
+      else
+      {
+        ensure(m_vbo, "block is null");
+        m_vbo->bind();
+        VertexSpec::setup(program, m_vbo->offset());
+      }
+    }
+
+    void cleanup() override
+    {
+      VertexSpec::cleanup(m_vboManager->shaderManager().currentProgram());
+      if (m_streamOffset)
+      {
+        m_vboManager->streamingVertexBuffer().unbind();
+      }
+      else
+      {
+        m_vbo->unbind();
+      }
+    }
+  };
+
 private:
+  static bool vertexArrayObjectsSupported();
+  static size_t currentContextId();
+  static GLuint createVertexArrayObject();
+  static void bindVertexArrayObject(GLuint vertexArrayId);
+  static void deleteVertexArrayObject(GLuint vertexArrayId);
+
   std::shared_ptr<BaseHolder> m_holder;
   bool m_prepared = false;
   bool m_setup = false;
@@ -210,6 +376,27 @@ public:
       std::move(vertices)));
   }
 
+  /**
+   * Creates a new vertex array by moving the contents of the given vertices. When
+   * prepared, the vertices are written into the streaming vertex buffer, which avoids
+   * allocating and filling a new buffer object.
+   *
+   * The uploaded data is only valid in the frame in which the vertex array was
+   * prepared, so this must only be used for vertex arrays which are recreated every
+   * frame.
+   *
+   * @tparam Attrs the vertex attribute types
+   * @param vertices the vertices to move
+   * @return the vertex array
+   */
+  template <typename... Attrs>
+  static VertexArray stream(std::vector<GLVertex<Attrs...>>&& vertices)
+  {
+    return VertexArray(
+      std::make_shared<StreamingHolder<typename GLVertex<Attrs...>::Type>>(
+        std::move(vertices)));
+  }
+
   /**
    * Creates a new vertex array by referencing the contents of the given vertices. After
    * this operation, the given vector of vertices is left unchanged. Since this vertex
@@ -322,6 +509,24 @@ public:
    * @param count the number of vertices to render
    */
   void render(PrimType primType, const GLIndices& indices, GLsizei count);
+
+  /**
+   * Renders the given number of instances of a number of sub ranges of this vertex
+   * array. Each range is rendered with one instanced draw call. The per-instance
+   * attributes must have been set up by the caller.
+   *
+   * @param primType the primitive type to render
+   * @param indices the start indices of the ranges to render
+   * @param counts the lengths of the ranges to render
+   * @param primCount the number of ranges to render
+   * @param instanceCount the number of instances to render
+   */
+  void renderInstanced(
+    PrimType primType,
+    const GLIndices& indices,
+    const GLCounts& counts,
+    GLint primCount,
+    GLsizei instanceCount);
   void cleanup();
 
 private:
@@ -0,0 +1,221 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VertexCacheOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto CacheSize = size_t(32);
+constexpr auto LastTriangleScore = 0.75f;
+constexpr auto CacheDecayPower = 1.5f;
+constexpr auto ValenceBoostScale = 2.0f;
+constexpr auto ValenceBoostPower = -0.5f;
+
+struct VertexData
+{
+  // the position in the simulated cache, or -1 if the vertex is not in the cache
+  int cachePosition = -1;
+  float score = 0.0f;
+  size_t remainingTriangles = 0;
+  size_t firstTriangle = 0;
+};
+
+float vertexScore(const VertexData& vertex)
+{
+  if (vertex.remainingTriangles == 0)
+  {
+    // no triangles left that use this vertex
+    return -1.0f;
+  }
+
+  auto score = 0.0f;
+  if (vertex.cachePosition >= 0)
+  {
+    if (vertex.cachePosition < 3)
+    {
+      // the vertex was used by the last triangle, don't favor it too much so that the
+      // triangles don't form long thin strips
+      score = LastTriangleScore;
+    }
+    else
+    {
+      const auto scale = 1.0f / float(CacheSize - 3);
+      score = std::pow(
+        1.0f - float(vertex.cachePosition - 3) * scale, CacheDecayPower);
+    }
+  }
+
+  // favor vertices with few remaining triangles so that they can be retired
+  return score
+         + ValenceBoostScale
+             * std::pow(float(vertex.remainingTriangles), ValenceBoostPower);
+}
+
+} // namespace
+
+std::vector<GLuint> optimizeVertexCache(const std::vector<GLuint>& triangleIndices)
+{
+  assert(triangleIndices.size() % 3 == 0);
+
+  const auto triangleCount = triangleIndices.size() / 3;
+  if (triangleCount < 2)
+  {
+    return triangleIndices;
+  }
+
+  // map the vertex indices to a dense range
+  const auto [minIt, maxIt] = std::ranges::minmax_element(triangleIndices);
+  const auto baseIndex = *minIt;
+  const auto vertexCount = size_t(*maxIt - baseIndex) + 1;
+
+  auto vertices = std::vector<VertexData>(vertexCount);
+  for (const auto index : triangleIndices)
+  {
+    ++vertices[index - baseIndex].remainingTriangles;
+  }
+
+  // store the triangles of each vertex in one array
+  auto vertexTriangles = std::vector<size_t>(triangleIndices.size());
+  auto offset = size_t(0);
+  for (auto& vertex : vertices)
+  {
+    vertex.firstTriangle = offset;
+    offset += vertex.remainingTriangles;
+  }
+
+  auto addedTriangles = std::vector<size_t>(vertexCount, 0);
+  for (size_t i = 0; i < triangleIndices.size(); ++i)
+  {
+    const auto v = triangleIndices[i] - baseIndex;
+    vertexTriangles[vertices[v].firstTriangle + addedTriangles[v]++] = i / 3;
+  }
+
+  for (auto& vertex : vertices)
+  {
+    vertex.score = vertexScore(vertex);
+  }
+
+  const auto triangleVertex = [&](const size_t triangle, const size_t corner) {
+    return size_t(triangleIndices[3 * triangle + corner] - baseIndex);
+  };
+
+  auto triangleScores = std::vector<float>(triangleCount);
+  for (size_t t = 0; t < triangleCount; ++t)
+  {
+    triangleScores[t] = vertices[triangleVertex(t, 0)].score
+                        + vertices[triangleVertex(t, 1)].score
+                        + vertices[triangleVertex(t, 2)].score;
+  }
+
+  auto triangleEmitted = std::vector<bool>(triangleCount, false);
+  auto cache = std::vector<size_t>{};
+  auto newCache = std::vector<size_t>{};
+  cache.reserve(CacheSize + 3);
+  newCache.reserve(CacheSize + 3);
+
+  auto result = std::vector<GLuint>{};
+  result.reserve(triangleIndices.size());
+
+  auto nextUnemittedTriangle = size_t(0);
+  auto bestTriangle = size_t(0);
+  for (size_t emitted = 0; emitted < triangleCount; ++emitted)
+  {
+    triangleEmitted[bestTriangle] = true;
+    for (size_t corner = 0; corner < 3; ++corner)
+    {
+      result.push_back(triangleIndices[3 * bestTriangle + corner]);
+
+      // remove the triangle from the vertex's list of remaining triangles
+      auto& vertex = vertices[triangleVertex(bestTriangle, corner)];
+      const auto first = vertexTriangles.begin() + std::ptrdiff_t(vertex.firstTriangle);
+      const auto last = first + std::ptrdiff_t(vertex.remainingTriangles);
+      std::iter_swap(std::find(first, last, bestTriangle), last - 1);
+      --vertex.remainingTriangles;
+    }
+
+    // move the vertices of the emitted triangle to the front of the cache
+    newCache.clear();
+    for (size_t corner = 0; corner < 3; ++corner)
+    {
+      newCache.push_back(triangleVertex(bestTriangle, corner));
+    }
+    for (const auto v : cache)
+    {
+      if (std::ranges::find(newCache, v) == newCache.end())
+      {
+        newCache.push_back(v);
+      }
+    }
+    std::swap(cache, newCache);
+
+    // update the scores of the vertices that were in the cache and of their triangles
+    for (size_t i = 0; i < cache.size(); ++i)
+    {
+      auto& vertex = vertices[cache[i]];
+      vertex.cachePosition = i < CacheSize ? int(i) : -1;
+
+      const auto oldScore = vertex.score;
+      vertex.score = vertexScore(vertex);
+      for (size_t j = 0; j < vertex.remainingTriangles; ++j)
+      {
+        triangleScores[vertexTriangles[vertex.firstTriangle + j]] +=
+          vertex.score - oldScore;
+      }
+    }
+    cache.resize(std::min(cache.size(), CacheSize));
+
+    // find the best triangle that uses a vertex in the cache
+    auto bestScore = -1.0f;
+    for (const auto v : cache)
+    {
+      const auto& vertex = vertices[v];
+      for (size_t j = 0; j < vertex.remainingTriangles; ++j)
+      {
+        const auto t = vertexTriangles[vertex.firstTriangle + j];
+        if (triangleScores[t] > bestScore)
+        {
+          bestScore = triangleScores[t];
+          bestTriangle = t;
+        }
+      }
+    }
+
+    if (bestScore < 0.0f)
+    {
+      // no triangle uses a cached vertex, continue with the next remaining triangle
+      while (nextUnemittedTriangle < triangleCount
+             && triangleEmitted[nextUnemittedTriangle])
+      {
+        ++nextUnemittedTriangle;
+      }
+      bestTriangle = nextUnemittedTriangle;
+    }
+  }
+
+  return result;
+}
+
+} // namespace tb::render
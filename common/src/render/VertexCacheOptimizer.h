@@ -0,0 +1,43 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "render/GL.h"
+
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * Reorders the given triangles so that consecutive triangles share many vertices, which
+ * lets the GPU reuse the results of its vertex shader invocations more often. The
+ * triangles themselves and their winding are not changed.
+ *
+ * The triangles are reordered greedily using Tom Forsyth's linear-speed vertex cache
+ * optimization. This is only worth the effort for static geometry that is rendered many
+ * times after it was built.
+ *
+ * @param triangleIndices the vertex indices of a list of triangles, three per triangle
+ * @return the reordered vertex indices
+ */
+std::vector<GLuint> optimizeVertexCache(const std::vector<GLuint>& triangleIndices);
+
+} // namespace tb::render
@@ -64,7 +64,7 @@ QAction& findOrCreateQtAction(
   qtAction.setCheckable(tbAction.checkable());
   if (const auto& iconPath = tbAction.iconPath())
   {
-    qtAction.setIcon(io::loadSVGIcon(*iconPath));
+    qtAction.setIcon(io::loadSVGIconLazily(*iconPath));
   }
   if (const auto& statusTip = tbAction.statusTip())
   {
@@ -1085,6 +1085,43 @@ void ActionManager::createFileMenu()
     QObject::tr("Exports the current map to a .map file. Layers marked Omit From Export "
                 "will be omitted."),
   }));
+  exportMenu.addItem(addAction(Action{
+    "Menu/File/Export/Render Profile...",
+    QObject::tr("Render Profile..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().exportRenderProfile(); },
+    [](const auto& context) {
+      return context.hasDocument() && pref(Preferences::ProfileRendering);
+    },
+    std::nullopt,
+    QObject::tr("Exports the recorded render pass timings of the current map view to a "
+                ".csv file. Requires render profiling to be enabled."),
+  }));
+  exportMenu.addItem(addAction(Action{
+    "Menu/File/Export/Memory Report...",
+    QObject::tr("Memory Report..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().exportMemoryReport(); },
+    [](const auto& context) { return context.hasDocument(); },
+    std::nullopt,
+    QObject::tr("Prints an estimate of the memory used by the current map, its assets "
+                "and its renderers to the console and exports it to a .json file."),
+  }));
+  exportMenu.addItem(addAction(Action{
+    "Menu/File/Export/Record Command Log...",
+    QObject::tr("Record Command Log..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().toggleRecordCommandLog(); },
+    [](const auto& context) { return context.hasDocument(); },
+    [](const auto& context) {
+      return context.hasDocument() && context.frame().isRecordingCommandLog();
+    },
+    QObject::tr("Records the changes made to the current map to a log that can be "
+                "replayed by the benchmarks. Select again to stop recording."),
+  }));
 
   /* ========== File Menu (Associated Resources) ========== */
   fileMenu.addSeparator();
@@ -1173,6 +1210,18 @@ void ActionManager::createFileMenu()
     std::nullopt,
     QObject::tr("Discards any unsaved changes and reloads the map file."),
   }));
+  fileMenu.addItem(addAction(Action{
+    "Menu/File/Reload Changes",
+    QObject::tr("Reload Changes from Disk"),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().reloadDocumentChanges(); },
+    [](const auto& context) { return context.hasDocument(); },
+    std::nullopt,
+    QObject::tr(
+      "Applies the changes that were made to the map file outside of TrenchBroom as one "
+      "undoable step."),
+  }));
   fileMenu.addItem(addAction(Action{
     "Menu/File/Close",
     QObject::tr("Close Document"),
@@ -2083,6 +2132,14 @@ void ActionManager::createDebugMenu()
     [](auto& context) { context.frame().debugPrintVertices(); },
     [](const auto& context) { return context.hasDocument(); },
   }));
+  debugMenu.addItem(addAction(Action{
+    "Menu/Debug/Print Command Profile",
+    QObject::tr("Print Command Profile to Console"),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().debugPrintCommandProfile(); },
+    [](const auto& context) { return context.hasDocument(); },
+  }));
   debugMenu.addItem(addAction(Action{
     "Menu/Debug/Create Brush...",
     QObject::tr("Create Brush..."),
@@ -45,9 +45,9 @@ const mdl::Polyhedron3& AssembleBrushTool::polyhedron() const
   return *m_polyhedron;
 }
 
-void AssembleBrushTool::update(const mdl::Polyhedron3& polyhedron)
+void AssembleBrushTool::update(mdl::Polyhedron3 polyhedron)
 {
-  *m_polyhedron = polyhedron;
+  *m_polyhedron = std::move(polyhedron);
   if (m_polyhedron->closed())
   {
     const auto game = m_map.game();
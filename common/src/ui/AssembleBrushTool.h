@@ -34,7 +34,7 @@ public:
   explicit AssembleBrushTool(mdl::Map& map);
 
   const mdl::Polyhedron3& polyhedron() const;
-  void update(const mdl::Polyhedron3& polyhedron);
+  void update(mdl::Polyhedron3 polyhedron);
 
 private:
   bool doActivate() override;
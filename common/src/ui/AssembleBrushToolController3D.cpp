@@ -46,6 +46,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <utility>
 
 namespace tb::ui
 {
@@ -135,8 +136,9 @@ private:
       vm::unswizzle(vm::vec3d{bottomLeft2, swizzledPlane.zAt(bottomLeft2)}, axis),
       vm::unswizzle(vm::vec3d{bottomRight2, swizzledPlane.zAt(bottomRight2)}, axis)};
 
-    m_tool.update(
-      mdl::Polyhedron3{kdl::vec_concat(newVertices, m_oldPolyhedron.vertexPositions())});
+    auto polyhedron = m_oldPolyhedron;
+    polyhedron.addPoints(newVertices);
+    m_tool.update(std::move(polyhedron));
   }
 };
 
@@ -225,8 +227,8 @@ public:
     const auto* face = m_oldPolyhedron.faces().front();
     const auto points = face->vertexPositions() + delta;
 
-    m_tool.update(
-      mdl::Polyhedron3{kdl::vec_concat(points, m_oldPolyhedron.vertexPositions())});
+    polyhedron.addPoints(points);
+    m_tool.update(std::move(polyhedron));
 
     return DragStatus::Continue;
   }
@@ -321,8 +323,9 @@ bool AssembleBrushToolController3D::mouseClick(const InputState& inputState)
     const auto& face = faceHandle->face();
     const auto snapped = grid.snap(hit.hitPoint(), face.boundary());
 
-    m_tool.update(mdl::Polyhedron3{kdl::vec_concat(
-      std::vector<vm::vec3d>{snapped}, m_tool.polyhedron().vertexPositions())});
+    auto polyhedron = m_tool.polyhedron();
+    polyhedron.addPoints({snapped});
+    m_tool.update(std::move(polyhedron));
 
     return true;
   }
@@ -346,8 +349,9 @@ bool AssembleBrushToolController3D::mouseDoubleClick(const InputState& inputStat
   {
     const auto& face = faceHandle->face();
 
-    m_tool.update(mdl::Polyhedron3{
-      kdl::vec_concat(face.vertexPositions(), m_tool.polyhedron().vertexPositions())});
+    auto polyhedron = m_tool.polyhedron();
+    polyhedron.addPoints(face.vertexPositions());
+    m_tool.update(std::move(polyhedron));
 
     return true;
   }
@@ -0,0 +1,328 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AssetFileWatcher.h"
+
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+#include "io/FileSystem.h"
+#include "io/FileSystemMetadata.h"
+#include "io/PathMatcher.h"
+#include "io/PathQt.h"
+#include "io/TraversalMode.h"
+#include "mdl/EntityModelManager.h"
+#include "mdl/Game.h"
+#include "mdl/GameConfig.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Assets.h"
+#include "mdl/Map_World.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialManager.h"
+
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <variant>
+
+namespace tb::ui
+{
+namespace
+{
+
+constexpr auto ReloadDelay = std::chrono::milliseconds{250};
+
+std::optional<std::filesystem::path> imageFilePath(
+  const io::FileSystem& fs, const std::filesystem::path& path)
+{
+  if (const auto* metadata = fs.metadata(path, io::FileSystemMetadataKeys::ImageFilePath);
+      metadata && std::holds_alternative<std::filesystem::path>(*metadata))
+  {
+    return std::get<std::filesystem::path>(*metadata);
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+AssetFileWatcher::AssetFileWatcher(mdl::Map& map, QObject* parent)
+  : QObject{parent}
+  , m_map{map}
+  , m_fileSystemWatcher{new QFileSystemWatcher{this}}
+  , m_reloadTimer{new QTimer{this}}
+{
+  m_reloadTimer->setSingleShot(true);
+  m_reloadTimer->setInterval(ReloadDelay);
+
+  connect(
+    m_fileSystemWatcher,
+    &QFileSystemWatcher::fileChanged,
+    this,
+    &AssetFileWatcher::fileChanged);
+  connect(
+    m_reloadTimer, &QTimer::timeout, this, &AssetFileWatcher::reloadChangedAssets);
+
+  connectObservers();
+
+  if (m_map.world())
+  {
+    watchAllAssets();
+  }
+}
+
+AssetFileWatcher::~AssetFileWatcher() = default;
+
+void AssetFileWatcher::clear()
+{
+  if (const auto files = m_fileSystemWatcher->files(); !files.isEmpty())
+  {
+    m_fileSystemWatcher->removePaths(files);
+  }
+  m_watchedFiles.clear();
+  m_changedFiles.clear();
+  m_reloadTimer->stop();
+}
+
+void AssetFileWatcher::watchAllAssets()
+{
+  clear();
+
+  const auto& fs = m_map.game()->gameFileSystem();
+  watchMaterials(fs);
+  watchShaders(fs);
+  watchEntityModels(fs);
+  watchEntityDefinitions();
+}
+
+void AssetFileWatcher::watchMaterials(const io::FileSystem& fs)
+{
+  for (const auto* material : m_map.materialManager().materials())
+  {
+    const auto& path = material->relativePath();
+    if (const auto imagePath = imageFilePath(fs, path))
+    {
+      // a texture in a wad file is reloaded with all other materials
+      if (kdl::path_has_extension(kdl::path_to_lower(*imagePath), ".wad"))
+      {
+        watchFile(*imagePath, {AssetType::MaterialCollections, {}});
+      }
+    }
+    else
+    {
+      watchGameFile(fs, path, AssetType::Material);
+    }
+  }
+}
+
+void AssetFileWatcher::watchShaders(const io::FileSystem& fs)
+{
+  const auto& shaderSearchPath = m_map.game()->config().materialConfig.shaderSearchPath;
+  if (!shaderSearchPath.empty())
+  {
+    const auto shaderMatcher = io::makeExtensionPathMatcher({".shader"});
+    fs.find(shaderSearchPath, io::TraversalMode::Flat, shaderMatcher)
+      | kdl::transform([&](const auto& paths) {
+          for (const auto& path : paths)
+          {
+            watchGameFile(fs, path, AssetType::MaterialCollections);
+          }
+        })
+      | kdl::transform_error([](auto) {});
+  }
+}
+
+void AssetFileWatcher::watchEntityModels(const io::FileSystem& fs)
+{
+  for (const auto& path : m_map.entityModelManager().modelPaths())
+  {
+    watchGameFile(fs, path, AssetType::EntityModel);
+  }
+}
+
+void AssetFileWatcher::watchEntityDefinitions()
+{
+  const auto& game = *m_map.game();
+  const auto path = game.findEntityDefinitionFile(
+    mdl::entityDefinitionFile(m_map), mdl::externalSearchPaths(m_map));
+  if (!path.empty())
+  {
+    watchFile(path, {AssetType::EntityDefinitions, {}});
+  }
+}
+
+void AssetFileWatcher::watchGameFile(
+  const io::FileSystem& fs, const std::filesystem::path& path, const AssetType type)
+{
+  // files in archives cannot be watched individually
+  if (!imageFilePath(fs, path))
+  {
+    fs.makeAbsolute(path)
+      | kdl::transform([&](const auto& absolutePath) {
+          watchFile(absolutePath, {type, path});
+        })
+      | kdl::transform_error([](auto) {});
+  }
+}
+
+void AssetFileWatcher::watchFile(
+  const std::filesystem::path& absolutePath, WatchedFile watchedFile)
+{
+  if (
+    !m_watchedFiles.contains(absolutePath)
+    && QFileInfo{io::pathAsQPath(absolutePath)}.isFile()
+    && m_fileSystemWatcher->addPath(io::pathAsQPath(absolutePath)))
+  {
+    m_watchedFiles.emplace(absolutePath, std::move(watchedFile));
+  }
+}
+
+void AssetFileWatcher::fileChanged(const QString& path)
+{
+  // Editors that save by replacing the file cause the watcher to drop it.
+  if (!m_fileSystemWatcher->files().contains(path) && QFileInfo{path}.isFile())
+  {
+    m_fileSystemWatcher->addPath(path);
+  }
+
+  m_changedFiles.push_back(io::pathFromQString(path));
+  m_reloadTimer->start();
+}
+
+void AssetFileWatcher::reloadChangedAssets()
+{
+  if (!m_map.world())
+  {
+    m_changedFiles.clear();
+    return;
+  }
+
+  auto materialPaths = std::vector<std::filesystem::path>{};
+  auto modelPaths = std::vector<std::filesystem::path>{};
+  auto reloadMaterialCollections = false;
+  auto reloadEntityDefinitions = false;
+
+  for (const auto& changedFile : kdl::vec_sort_and_remove_duplicates(
+         std::exchange(m_changedFiles, std::vector<std::filesystem::path>{})))
+  {
+    if (const auto it = m_watchedFiles.find(changedFile); it != m_watchedFiles.end())
+    {
+      switch (it->second.type)
+      {
+      case AssetType::Material:
+        materialPaths.push_back(it->second.path);
+        break;
+      case AssetType::MaterialCollections:
+        reloadMaterialCollections = true;
+        break;
+      case AssetType::EntityModel:
+        modelPaths.push_back(it->second.path);
+        break;
+      case AssetType::EntityDefinitions:
+        reloadEntityDefinitions = true;
+        break;
+      }
+    }
+  }
+
+  // Reloading the material collections or the entity definitions also reloads the
+  // materials or entity models, respectively.
+  if (reloadMaterialCollections)
+  {
+    mdl::reloadMaterialCollections(m_map);
+  }
+  else if (!materialPaths.empty())
+  {
+    m_map.reloadChangedMaterials(materialPaths);
+  }
+
+  if (reloadEntityDefinitions)
+  {
+    mdl::reloadEntityDefinitions(m_map);
+  }
+  else if (!modelPaths.empty())
+  {
+    m_map.reloadChangedEntityModels(modelPaths);
+  }
+}
+
+void AssetFileWatcher::connectObservers()
+{
+  m_notifierConnection +=
+    m_map.mapWasCreatedNotifier.connect(this, &AssetFileWatcher::mapWasCreated);
+  m_notifierConnection +=
+    m_map.mapWasLoadedNotifier.connect(this, &AssetFileWatcher::mapWasLoaded);
+  m_notifierConnection +=
+    m_map.mapWasClearedNotifier.connect(this, &AssetFileWatcher::mapWasCleared);
+  m_notifierConnection += m_map.nodesWereAddedNotifier.connect(
+    this, &AssetFileWatcher::nodesWereAddedOrChanged);
+  m_notifierConnection += m_map.nodesDidChangeNotifier.connect(
+    this, &AssetFileWatcher::nodesWereAddedOrChanged);
+  m_notifierConnection += m_map.materialCollectionsDidChangeNotifier.connect(
+    this, &AssetFileWatcher::materialCollectionsDidChange);
+  m_notifierConnection += m_map.entityDefinitionsDidChangeNotifier.connect(
+    this, &AssetFileWatcher::entityDefinitionsDidChange);
+  m_notifierConnection +=
+    m_map.modsDidChangeNotifier.connect(this, &AssetFileWatcher::modsDidChange);
+}
+
+void AssetFileWatcher::mapWasCreated(mdl::Map&)
+{
+  watchAllAssets();
+}
+
+void AssetFileWatcher::mapWasLoaded(mdl::Map&)
+{
+  watchAllAssets();
+}
+
+void AssetFileWatcher::mapWasCleared(mdl::Map&)
+{
+  clear();
+}
+
+void AssetFileWatcher::nodesWereAddedOrChanged(const std::vector<mdl::Node*>&)
+{
+  // added or changed entities may have loaded new models
+  if (m_map.world())
+  {
+    watchEntityModels(m_map.game()->gameFileSystem());
+  }
+}
+
+void AssetFileWatcher::materialCollectionsDidChange()
+{
+  watchAllAssets();
+}
+
+void AssetFileWatcher::entityDefinitionsDidChange()
+{
+  watchAllAssets();
+}
+
+void AssetFileWatcher::modsDidChange()
+{
+  watchAllAssets();
+}
+
+} // namespace tb::ui
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+
+#include "NotifierConnection.h"
+
+#include "kdl/path_hash.h"
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace tb::io
+{
+class FileSystem;
+} // namespace tb::io
+
+namespace tb::mdl
+{
+class Map;
+class Node;
+} // namespace tb::mdl
+
+namespace tb::ui
+{
+
+/**
+ * Watches the files that the assets of a map were loaded from and reloads the affected
+ * assets when the files change on disk.
+ *
+ * Changed texture and model files only reload the materials and entity models loaded
+ * from them. Changed shader scripts and wad files reload all material collections, and a
+ * changed entity definition file reloads the entity definitions. Assets loaded from
+ * other archives such as pak files are not watched.
+ *
+ * Changes are collected for a short while before reloading, so that a file that is
+ * written in several steps is only reloaded once.
+ */
+class AssetFileWatcher : public QObject
+{
+  Q_OBJECT
+private:
+  enum class AssetType
+  {
+    Material,
+    MaterialCollections,
+    EntityModel,
+    EntityDefinitions,
+  };
+
+  struct WatchedFile
+  {
+    AssetType type;
+    // the path in the game file system, empty for files outside of it
+    std::filesystem::path path;
+  };
+
+  mdl::Map& m_map;
+  QFileSystemWatcher* m_fileSystemWatcher = nullptr;
+  QTimer* m_reloadTimer = nullptr;
+
+  std::unordered_map<std::filesystem::path, WatchedFile, kdl::path_hash> m_watchedFiles;
+  std::vector<std::filesystem::path> m_changedFiles;
+
+  NotifierConnection m_notifierConnection;
+
+public:
+  explicit AssetFileWatcher(mdl::Map& map, QObject* parent = nullptr);
+  ~AssetFileWatcher() override;
+
+private:
+  void clear();
+  void watchAllAssets();
+  void watchMaterials(const io::FileSystem& fs);
+  void watchShaders(const io::FileSystem& fs);
+  void watchEntityModels(const io::FileSystem& fs);
+  void watchEntityDefinitions();
+  void watchGameFile(
+    const io::FileSystem& fs, const std::filesystem::path& path, AssetType type);
+  void watchFile(const std::filesystem::path& absolutePath, WatchedFile watchedFile);
+
+  void fileChanged(const QString& path);
+  void reloadChangedAssets();
+
+  void connectObservers();
+  void mapWasCreated(mdl::Map& map);
+  void mapWasLoaded(mdl::Map& map);
+  void mapWasCleared(mdl::Map& map);
+  void nodesWereAddedOrChanged(const std::vector<mdl::Node*>& nodes);
+  void materialCollectionsDidChange();
+  void entityDefinitionsDidChange();
+  void modsDidChange();
+};
+
+} // namespace tb::ui
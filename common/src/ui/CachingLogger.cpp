@@ -26,20 +26,24 @@ void CachingLogger::setParentLogger(Logger* parentLogger)
 {
   const auto lock = std::lock_guard{m_cacheMutex};
 
-  m_parentLogger = parentLogger;
-  if (m_parentLogger)
+  if (parentLogger)
   {
-    m_cache.getCachedMessages([this](const auto level, const auto& message) {
-      m_parentLogger->log(level, message);
+    m_cache.getCachedMessages([&](const auto level, const auto& message) {
+      parentLogger->log(level, message);
     });
   }
+  m_parentLogger = parentLogger;
 }
 
 void CachingLogger::doLog(const LogLevel level, const std::string_view message)
 {
-  if (!cacheMessage(level, message))
+  if (auto* parentLogger = m_parentLogger.load())
+  {
+    parentLogger->log(level, message);
+  }
+  else if (!cacheMessage(level, message))
   {
-    m_parentLogger->log(level, message);
+    m_parentLogger.load()->log(level, message);
   }
 }
 
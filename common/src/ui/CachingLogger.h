@@ -22,6 +22,8 @@
 #include "Logger.h"
 #include "LoggerCache.h"
 
+#include <atomic>
+#include <cstddef>
 #include <mutex>
 #include <string_view>
 
@@ -31,10 +33,15 @@ namespace tb::ui
 class CachingLogger : public Logger
 {
 private:
-  LoggerCache m_cache;
+  static constexpr size_t MaxCachedMessages = 10000;
+
+  LoggerCache m_cache{MaxCachedMessages};
   std::mutex m_cacheMutex;
 
-  Logger* m_parentLogger = nullptr;
+  /**
+   * Once the parent logger is set, messages are forwarded without locking the mutex.
+   */
+  std::atomic<Logger*> m_parentLogger = nullptr;
 
 public:
   void setParentLogger(Logger* logger);
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace tb::ui
 {
@@ -93,6 +94,11 @@ const std::any& LayoutCell::item() const
   return m_item;
 }
 
+std::string& LayoutCell::title()
+{
+  return m_title;
+}
+
 const std::string& LayoutCell::title() const
 {
   return m_title;
@@ -330,6 +336,11 @@ void LayoutRow::addItem(
   m_cells.push_back(std::move(cell));
 }
 
+std::vector<LayoutCell> LayoutRow::releaseCells()
+{
+  return std::move(m_cells);
+}
+
 void LayoutRow::readjustItems()
 {
   for (auto& cell : m_cells)
@@ -556,6 +567,34 @@ void LayoutGroup::addItem(
     m_contentBounds.height + (newRowHeight - oldRowHeight)};
 }
 
+std::vector<LayoutCell> LayoutGroup::releaseCells(const size_t fromRowIndex)
+{
+  auto result = std::vector<LayoutCell>{};
+  for (auto i = fromRowIndex; i < m_rows.size(); ++i)
+  {
+    auto cells = m_rows[i].releaseCells();
+    result.insert(
+      result.end(),
+      std::make_move_iterator(cells.begin()),
+      std::make_move_iterator(cells.end()));
+  }
+
+  if (fromRowIndex < m_rows.size())
+  {
+    m_rows.erase(m_rows.begin() + long(fromRowIndex), m_rows.end());
+
+    const auto contentHeight =
+      m_rows.empty() ? 0.0f : m_rows.back().bounds().bottom() - m_contentBounds.top();
+    m_contentBounds = LayoutBounds{
+      m_contentBounds.left(),
+      m_contentBounds.top(),
+      m_contentBounds.width,
+      contentHeight};
+  }
+
+  return result;
+}
+
 CellLayout::CellLayout(const size_t maxCellsPerRow)
   : m_maxCellsPerRow{maxCellsPerRow}
 {
@@ -902,12 +941,95 @@ void CellLayout::addItem(
   m_height += (newGroupHeight - oldGroupHeight);
 }
 
+void CellLayout::removeItems(const std::function<bool(const LayoutCell&)>& predicate)
+{
+  if (!m_valid)
+  {
+    validate();
+  }
+
+  // find the first row that contains a cell to remove
+  auto groupIndex = m_groups.size();
+  auto rowIndex = size_t(0);
+  for (size_t i = 0; i < m_groups.size() && groupIndex == m_groups.size(); ++i)
+  {
+    const auto& rows = m_groups[i].rows();
+    for (size_t j = 0; j < rows.size(); ++j)
+    {
+      if (std::any_of(rows[j].cells().begin(), rows[j].cells().end(), predicate))
+      {
+        groupIndex = i;
+        rowIndex = j;
+        break;
+      }
+    }
+  }
+
+  if (groupIndex == m_groups.size())
+  {
+    return;
+  }
+
+  // remove the groups after the affected group, they must be moved up
+  auto followingGroups = std::vector<LayoutGroup>{};
+  for (auto i = groupIndex + 1; i < m_groups.size(); ++i)
+  {
+    m_height -= m_groupMargin + m_groups[i].bounds().height;
+    followingGroups.push_back(std::move(m_groups[i]));
+  }
+  m_groups.erase(m_groups.begin() + long(groupIndex) + 1, m_groups.end());
+
+  // lay out the affected rows again
+  auto& group = m_groups.back();
+  const auto oldGroupHeight = group.bounds().height;
+  auto cells = group.releaseCells(rowIndex);
+  m_height -= oldGroupHeight - group.bounds().height;
+
+  for (auto& cell : cells)
+  {
+    if (!predicate(cell))
+    {
+      readdCell(std::move(cell));
+    }
+  }
+
+  for (auto& followingGroup : followingGroups)
+  {
+    addGroup(followingGroup.title(), followingGroup.titleBounds().height);
+    for (auto& cell : followingGroup.releaseCells(0))
+    {
+      if (!predicate(cell))
+      {
+        readdCell(std::move(cell));
+      }
+    }
+  }
+}
+
 void CellLayout::clear()
 {
   m_groups.clear();
   invalidate();
 }
 
+void CellLayout::readdCell(LayoutCell cell)
+{
+  const auto& itemBounds = cell.itemBounds();
+  const auto& titleBounds = cell.titleBounds();
+  const auto scale = cell.scale();
+  const auto itemWidth = itemBounds.width / scale;
+  const auto itemHeight = itemBounds.height / scale;
+  const auto titleWidth = titleBounds.width;
+  const auto titleHeight = titleBounds.height;
+  addItem(
+    std::move(cell.item()),
+    std::move(cell.title()),
+    itemWidth,
+    itemHeight,
+    titleWidth,
+    titleHeight);
+}
+
 void CellLayout::validate()
 {
   if (m_width <= 0.0f)
@@ -919,29 +1041,19 @@ void CellLayout::validate()
   m_valid = true;
   if (!m_groups.empty())
   {
-    auto copy = m_groups;
+    auto groups = std::move(m_groups);
     m_groups.clear();
 
-    for (auto& group : copy)
+    for (auto& group : groups)
     {
-      addGroup(group.title(), group.titleBounds().height);
-      for (const auto& row : group.rows())
+      // the untitled group is created again when its first cell is added
+      if (!m_groups.empty() || group.titleBounds().height > 0.0f)
+      {
+        addGroup(group.title(), group.titleBounds().height);
+      }
+      for (auto& cell : group.releaseCells(0))
       {
-        for (const auto& cell : row.cells())
-        {
-          const auto& itemBounds = cell.itemBounds();
-          const auto& titleBounds = cell.titleBounds();
-          const auto scale = cell.scale();
-          const auto itemWidth = itemBounds.width / scale;
-          const auto itemHeight = itemBounds.height / scale;
-          addItem(
-            cell.item(),
-            cell.title(),
-            itemWidth,
-            itemHeight,
-            titleBounds.width,
-            titleBounds.height);
-        }
+        readdCell(std::move(cell));
       }
     }
   }
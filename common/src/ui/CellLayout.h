@@ -20,6 +20,7 @@
 #pragma once
 
 #include <any>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -89,6 +90,7 @@ public:
     throw std::bad_any_cast{};
   }
 
+  std::string& title();
   const std::string& title() const;
 
   float scale() const;
@@ -155,6 +157,8 @@ public:
     float titleWidth,
     float titleHeight);
 
+  std::vector<LayoutCell> releaseCells();
+
 private:
   void readjustItems();
 };
@@ -229,6 +233,12 @@ public:
     float itemHeight,
     float titleWidth,
     float titleHeight);
+
+  /**
+   * Removes the rows starting at the given index and returns their cells. The rows before
+   * the given index are not touched.
+   */
+  std::vector<LayoutCell> releaseCells(size_t fromRowIndex);
 };
 
 class CellLayout
@@ -303,9 +313,17 @@ public:
     float titleWidth,
     float titleHeight);
 
+  /**
+   * Removes the cells matching the given predicate. Only the rows starting at the first
+   * row that contains a removed cell are laid out again, so removing cells from the end of
+   * a large layout, e.g. when narrowing a filter, doesn't recompute the entire layout.
+   */
+  void removeItems(const std::function<bool(const LayoutCell&)>& predicate);
+
   void clear();
 
 private:
+  void readdCell(LayoutCell cell);
   void validate();
 };
 
@@ -111,6 +111,16 @@ void CellView::invalidate()
   m_valid = false;
 }
 
+void CellView::removeCells(const std::function<bool(const Cell&)>& predicate)
+{
+  // an invalid layout is reloaded with the new contents anyway
+  if (m_valid)
+  {
+    m_layout.removeItems(predicate);
+    updateScrollBar();
+  }
+}
+
 void CellView::clear()
 {
   m_layout.clear();
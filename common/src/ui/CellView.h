@@ -60,6 +60,14 @@ private:
 public:
   explicit CellView(GLContextManager& contextManager, QScrollBar* scrollBar = nullptr);
   void invalidate();
+
+  /**
+   * Removes the cells matching the given predicate without reloading the layout. Use this
+   * instead of invalidate if the new contents of the view are a subset of the current
+   * contents.
+   */
+  void removeCells(const std::function<bool(const Cell&)>& predicate);
+
   void clear();
   void resizeEvent(QResizeEvent* event) override;
 
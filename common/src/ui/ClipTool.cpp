@@ -19,10 +19,15 @@
 
 #include "ClipTool.h"
 
+#include <QCoreApplication>
+
 #include "Logger.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Result.h"
+#include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
+#include "mdl/BrushFaceAttributes.h"
 #include "mdl/BrushNode.h"
 #include "mdl/Hit.h"
 #include "mdl/HitFilter.h"
@@ -42,6 +47,7 @@
 #include "kdl/optional_utils.h"
 #include "kdl/overload.h"
 #include "kdl/set_temp.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/ray.h"
@@ -51,7 +57,11 @@
 #include <fmt/ostream.h>
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <optional>
+#include <utility>
 
 namespace tb::ui
 {
@@ -482,8 +492,68 @@ public:
   }
 };
 
+void setFaceAttributes(const std::vector<mdl::BrushFace>& faces, mdl::BrushFace& toSet)
+{
+  ensure(!faces.empty(), "no faces");
+
+  auto faceIt = std::begin(faces);
+  auto faceEnd = std::end(faces);
+  auto bestMatch = faceIt++;
+
+  while (faceIt != faceEnd)
+  {
+    const auto& face = *faceIt;
+
+    const auto bestDiff = bestMatch->boundary().normal - toSet.boundary().normal;
+    const auto curDiff = face.boundary().normal - toSet.boundary().normal;
+    if (vm::squared_length(curDiff) < vm::squared_length(bestDiff))
+    {
+      bestMatch = faceIt;
+    }
+
+    ++faceIt;
+  }
+
+  toSet.setAttributes(*bestMatch);
+}
+
+Result<mdl::Brush> clipBrush(
+  const mdl::Brush& brush,
+  const vm::vec3d& p1,
+  const vm::vec3d& p2,
+  const vm::vec3d& p3,
+  const mdl::BrushFaceAttributes& attributes,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds)
+{
+  return mdl::BrushFace::create(p1, p2, p3, attributes, mapFormat)
+         | kdl::and_then([&](mdl::BrushFace&& clipFace) {
+             setFaceAttributes(brush.faces(), clipFace);
+
+             auto clippedBrush = brush;
+             return clippedBrush.clip(worldBounds, std::move(clipFace))
+                    | kdl::transform([&]() { return std::move(clippedBrush); });
+           });
+}
+
 } // namespace
 
+/**
+ * The result of clipping the selected brushes, which is computed on the task manager.
+ */
+struct ClipTool::ClipPreview
+{
+  // only accessed on the main thread, reset once the preview is applied or cancelled
+  ClipTool* tool = nullptr;
+
+  std::vector<mdl::BrushNode*> brushNodes;
+  std::vector<std::optional<Result<mdl::Brush>>> frontBrushes;
+  std::vector<std::optional<Result<mdl::Brush>>> backBrushes;
+
+  std::atomic<bool> cancelled = false;
+  std::future<void> task;
+};
+
 ClipTool::ClipTool(mdl::Map& map)
   : Tool{false}
   , m_map{map}
@@ -494,6 +564,7 @@ ClipTool::ClipTool(mdl::Map& map)
 
 ClipTool::~ClipTool()
 {
+  cancelPreview();
   kdl::map_clear_and_delete(m_frontBrushes);
   kdl::map_clear_and_delete(m_backBrushes);
 }
@@ -519,7 +590,11 @@ void ClipTool::toggleSide()
       m_clipSide = ClipSide::Front;
       break;
     }
-    update();
+
+    // the clipped brushes don't depend on the side to keep
+    clearRenderers();
+    updateRenderers();
+    refreshViews();
   }
 }
 
@@ -604,6 +679,8 @@ void ClipTool::performClip()
 {
   if (!m_dragging && canClip())
   {
+    applyPreview();
+
     const auto ignoreNotifications = kdl::set_temp{m_ignoreNotifications};
 
     auto& map = m_map;
@@ -786,11 +863,21 @@ void ClipTool::resetStrategy()
 
 void ClipTool::update()
 {
-  clearRenderers();
-  clearBrushes();
+  cancelPreview();
 
-  updateBrushes();
-  updateRenderers();
+  if (canClip())
+  {
+    // the current brushes remain visible until the new preview has been computed
+    startPreview();
+  }
+  else
+  {
+    clearRenderers();
+    clearBrushes();
+
+    updateBrushes();
+    updateRenderers();
+  }
 
   refreshViews();
 }
@@ -805,74 +892,107 @@ void ClipTool::updateBrushes()
 {
   auto& map = m_map;
 
-  const auto& brushNodes = map.selection().brushes;
-  const auto& worldBounds = map.worldBounds();
-
-  const auto clip =
-    [&](auto* node, const auto& p1, const auto& p2, const auto& p3, auto& brushMap) {
-      auto brush = node->brush();
-      mdl::BrushFace::create(
-        p1,
-        p2,
-        p3,
-        mdl::BrushFaceAttributes(map.currentMaterialName()),
-        map.world()->mapFormat())
-        | kdl::and_then([&](mdl::BrushFace&& clipFace) {
-            setFaceAttributes(brush.faces(), clipFace);
-            return brush.clip(worldBounds, std::move(clipFace));
-          })
-        | kdl::transform([&]() {
-            brushMap[node->parent()].push_back(new mdl::BrushNode(std::move(brush)));
-          })
-        | kdl::transform_error(
-          [&](auto e) { map.logger().error() << "Could not clip brush: " << e.msg; });
-    };
-
-  if (canClip())
+  for (auto* brushNode : map.selection().brushes)
   {
-    const auto points = m_strategy->getPoints();
-    ensure(points.size() == 3, "invalid number of points");
-
-    for (auto* brushNode : brushNodes)
-    {
-      clip(brushNode, points[0], points[1], points[2], m_frontBrushes);
-      clip(brushNode, points[0], points[2], points[1], m_backBrushes);
-    }
+    auto* parent = brushNode->parent();
+    m_frontBrushes[parent].push_back(new mdl::BrushNode{brushNode->brush()});
   }
-  else
+}
+
+void ClipTool::startPreview()
+{
+  auto& map = m_map;
+
+  const auto points = m_strategy->getPoints();
+  ensure(points.size() == 3, "invalid number of points");
+
+  auto preview = std::make_shared<ClipPreview>();
+  preview->tool = this;
+  preview->brushNodes = map.selection().brushes;
+  preview->frontBrushes.resize(preview->brushNodes.size());
+  preview->backBrushes.resize(preview->brushNodes.size());
+
+  auto& taskManager = map.taskManager();
+  preview->task = taskManager.run_task(std::function{
+    [&taskManager,
+     points,
+     attributes = mdl::BrushFaceAttributes{map.currentMaterialName()},
+     mapFormat = map.world()->mapFormat(),
+     worldBounds = map.worldBounds(),
+     preview = preview.get(),
+     weakPreview = std::weak_ptr{preview}]() {
+      taskManager.parallel_for(preview->brushNodes.size(), [&](const size_t i) {
+        if (!preview->cancelled)
+        {
+          const auto& brush = preview->brushNodes[i]->brush();
+          preview->frontBrushes[i] = clipBrush(
+            brush, points[0], points[1], points[2], attributes, mapFormat, worldBounds);
+          preview->backBrushes[i] = clipBrush(
+            brush, points[0], points[2], points[1], attributes, mapFormat, worldBounds);
+        }
+      });
+
+      if (!preview->cancelled)
+      {
+        QMetaObject::invokeMethod(
+          qApp,
+          [weakPreview]() {
+            if (const auto preview = weakPreview.lock(); preview && preview->tool)
+            {
+              preview->tool->applyPreview();
+              preview->tool->refreshViews();
+            }
+          },
+          Qt::QueuedConnection);
+      }
+    }});
+
+  m_preview = std::move(preview);
+}
+
+void ClipTool::cancelPreview()
+{
+  if (m_preview)
   {
-    for (auto* brushNode : brushNodes)
-    {
-      auto* parent = brushNode->parent();
-      m_frontBrushes[parent].push_back(new mdl::BrushNode{brushNode->brush()});
-    }
+    // the task reads the selected brushes, so it must stop before they can change
+    m_preview->tool = nullptr;
+    m_preview->cancelled = true;
+    m_preview->task.wait();
+    m_preview.reset();
   }
 }
 
-void ClipTool::setFaceAttributes(
-  const std::vector<mdl::BrushFace>& faces, mdl::BrushFace& toSet) const
+void ClipTool::applyPreview()
 {
-  ensure(!faces.empty(), "no faces");
+  if (!m_preview)
+  {
+    return;
+  }
 
-  auto faceIt = std::begin(faces);
-  auto faceEnd = std::end(faces);
-  auto bestMatch = faceIt++;
+  const auto preview = std::exchange(m_preview, nullptr);
+  preview->tool = nullptr;
+  preview->task.get();
 
-  while (faceIt != faceEnd)
-  {
-    const auto& face = *faceIt;
+  clearRenderers();
+  clearBrushes();
 
-    const auto bestDiff = bestMatch->boundary().normal - toSet.boundary().normal;
-    const auto curDiff = face.boundary().normal - toSet.boundary().normal;
-    if (vm::squared_length(curDiff) < vm::squared_length(bestDiff))
-    {
-      bestMatch = faceIt;
-    }
+  const auto addBrush = [&](auto* brushNode, auto& clippedBrush, auto& brushMap) {
+    std::move(clippedBrush)
+      | kdl::transform([&](mdl::Brush&& brush) {
+          brushMap[brushNode->parent()].push_back(new mdl::BrushNode{std::move(brush)});
+        })
+      | kdl::transform_error(
+        [&](auto e) { m_map.logger().error() << "Could not clip brush: " << e.msg; });
+  };
 
-    ++faceIt;
+  for (size_t i = 0; i < preview->brushNodes.size(); ++i)
+  {
+    auto* brushNode = preview->brushNodes[i];
+    addBrush(brushNode, *preview->frontBrushes[i], m_frontBrushes);
+    addBrush(brushNode, *preview->backBrushes[i], m_backBrushes);
   }
 
-  toSet.setAttributes(*bestMatch);
+  updateRenderers();
 }
 
 void ClipTool::clearRenderers()
@@ -956,6 +1076,7 @@ bool ClipTool::doDeactivate()
 {
   m_notifierConnection.disconnect();
 
+  cancelPreview();
   m_strategy.reset();
   clearRenderers();
   clearBrushes();
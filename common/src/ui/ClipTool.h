@@ -77,6 +77,9 @@ private:
   std::map<mdl::Node*, std::vector<mdl::Node*>> m_frontBrushes;
   std::map<mdl::Node*, std::vector<mdl::Node*>> m_backBrushes;
 
+  struct ClipPreview;
+  std::shared_ptr<ClipPreview> m_preview;
+
   std::unique_ptr<render::BrushRenderer> m_remainingBrushRenderer;
   std::unique_ptr<render::BrushRenderer> m_clippedBrushRenderer;
 
@@ -149,8 +152,9 @@ private:
   void clearBrushes();
   void updateBrushes();
 
-  void setFaceAttributes(
-    const std::vector<mdl::BrushFace>& faces, mdl::BrushFace& toSet) const;
+  void startPreview();
+  void cancelPreview();
+  void applyPreview();
 
   void clearRenderers();
   void updateRenderers();
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ClipboardData.h"
+
+#include "mdl/Node.h"
+#include "ui/QtUtils.h"
+
+#include "kdl/task_manager.h"
+
+#include <utility>
+
+namespace tb::ui
+{
+namespace
+{
+const auto TextMimeType = QStringLiteral("text/plain");
+} // namespace
+
+ClipboardData::ClipboardData(
+  mdl::CopiedNodes copiedNodes, const mdl::MapTextEncoding encoding)
+  : m_copiedNodes{std::move(copiedNodes)}
+  , m_encoding{encoding}
+{
+}
+
+ClipboardData::~ClipboardData() = default;
+
+const mdl::CopiedNodes& ClipboardData::copiedNodes() const
+{
+  return m_copiedNodes;
+}
+
+mdl::MapTextEncoding ClipboardData::encoding() const
+{
+  return m_encoding;
+}
+
+QStringList ClipboardData::formats() const
+{
+  return {TextMimeType};
+}
+
+QVariant ClipboardData::retrieveData(const QString& mimeType, const QMetaType type) const
+{
+  if (mimeType != TextMimeType)
+  {
+    return QMimeData::retrieveData(mimeType, type);
+  }
+
+  if (!m_text)
+  {
+    // the map the nodes were copied from and its task manager may be gone by now
+    auto taskManager = kdl::task_manager{};
+    const auto str = mdl::serializeCopiedNodes(m_copiedNodes, taskManager);
+    m_text = mapStringToUnicode(m_encoding, str);
+  }
+  return *m_text;
+}
+
+} // namespace tb::ui
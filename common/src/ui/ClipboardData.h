@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QMimeData>
+
+#include "mdl/Map_CopyPaste.h"
+#include "mdl/MapTextEncoding.h"
+
+#include <optional>
+
+namespace tb::ui
+{
+
+/**
+ * Clipboard contents for nodes copied from a map.
+ *
+ * Maps in this application paste the copied nodes directly. Other applications get the
+ * text form of the nodes, which is only created when it is requested.
+ */
+class ClipboardData : public QMimeData
+{
+  Q_OBJECT
+private:
+  mdl::CopiedNodes m_copiedNodes;
+  mdl::MapTextEncoding m_encoding;
+  mutable std::optional<QString> m_text;
+
+public:
+  ClipboardData(mdl::CopiedNodes copiedNodes, mdl::MapTextEncoding encoding);
+  ~ClipboardData() override;
+
+  const mdl::CopiedNodes& copiedNodes() const;
+  mdl::MapTextEncoding encoding() const;
+
+  QStringList formats() const override;
+
+protected:
+  QVariant retrieveData(const QString& mimeType, QMetaType type) const override;
+};
+
+} // namespace tb::ui
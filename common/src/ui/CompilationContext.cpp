@@ -22,6 +22,7 @@
 #include "el/EvaluationContext.h"
 #include "el/Interpolate.h"
 #include "el/Types.h"
+#include "ui/CompilationVariables.h"
 
 namespace tb::ui
 {
@@ -30,11 +31,13 @@ CompilationContext::CompilationContext(
   const mdl::Map& map,
   const el::VariableStore& variables,
   TextOutputAdapter output,
-  bool test)
+  bool test,
+  CompilationExportCache* exportCache)
   : m_map{map}
   , m_variables{variables.clone()}
   , m_output{std::move(output)}
   , m_test{test}
+  , m_exportCache{exportCache}
 {
 }
 
@@ -48,11 +51,24 @@ bool CompilationContext::test() const
   return m_test;
 }
 
+CompilationExportCache* CompilationContext::exportCache() const
+{
+  return m_exportCache;
+}
+
 Result<std::string> CompilationContext::interpolate(const std::string& input) const
 {
   return el::interpolate(*m_variables, input);
 }
 
+Result<std::string> CompilationContext::interpolate(
+  const std::string& input, const size_t cpuCount) const
+{
+  auto variables = std::unique_ptr<el::VariableStore>{m_variables->clone()};
+  variables->set(CompilationVariableNames::CPU_COUNT, el::Value{cpuCount});
+  return el::interpolate(*variables, input);
+}
+
 Result<std::string> CompilationContext::variableValue(
   const std::string& variableName) const
 {
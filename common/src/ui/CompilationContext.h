@@ -33,6 +33,7 @@ class Map;
 
 namespace tb::ui
 {
+class CompilationExportCache;
 
 class CompilationContext
 {
@@ -42,18 +43,31 @@ private:
 
   TextOutputAdapter m_output;
   bool m_test;
+  CompilationExportCache* m_exportCache;
 
 public:
   CompilationContext(
     const mdl::Map& map,
     const el::VariableStore& variables,
     TextOutputAdapter output,
-    bool test);
+    bool test,
+    CompilationExportCache* exportCache = nullptr);
 
   const mdl::Map& map() const;
   bool test() const;
 
+  /**
+   * Returns the cache of previous map exports, or nullptr if exports are not cached.
+   */
+  CompilationExportCache* exportCache() const;
+
   Result<std::string> interpolate(const std::string& input) const;
+
+  /**
+   * Interpolates the given input with the CPU_COUNT variable set to the given number of
+   * CPUs.
+   */
+  Result<std::string> interpolate(const std::string& input, size_t cpuCount) const;
   Result<std::string> variableValue(const std::string& variableName) const;
 
   template <typename T>
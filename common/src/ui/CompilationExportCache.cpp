@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompilationExportCache.h"
+
+#include <optional>
+#include <system_error>
+
+namespace tb::ui
+{
+namespace
+{
+
+std::optional<std::filesystem::file_time_type> lastWriteTime(
+  const std::filesystem::path& path)
+{
+  auto error = std::error_code{};
+  const auto result = std::filesystem::last_write_time(path, error);
+  return !error ? std::optional{result} : std::nullopt;
+}
+
+} // namespace
+
+bool CompilationExportCache::isCurrent(
+  const std::filesystem::path& path, const size_t revision) const
+{
+  const auto it = m_exports.find(path);
+  return it != m_exports.end() && it->second.revision == revision
+         && lastWriteTime(path) == it->second.lastWriteTime;
+}
+
+void CompilationExportCache::setExported(
+  const std::filesystem::path& path, const size_t revision)
+{
+  if (const auto writeTime = lastWriteTime(path))
+  {
+    m_exports[path] = Export{revision, *writeTime};
+  }
+  else
+  {
+    invalidate(path);
+  }
+}
+
+void CompilationExportCache::invalidate(const std::filesystem::path& path)
+{
+  m_exports.erase(path);
+}
+
+} // namespace tb::ui
@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+
+namespace tb::ui
+{
+
+/**
+ * Remembers which revision of a map (see mdl::Map::revision) was exported to which file
+ * by previous compilation runs, so that the map does not have to be exported again if it
+ * was not modified since.
+ *
+ * An export is only considered current if the exported file still exists and was not
+ * written since it was exported.
+ */
+class CompilationExportCache
+{
+private:
+  struct Export
+  {
+    size_t revision;
+    std::filesystem::file_time_type lastWriteTime;
+  };
+
+  std::map<std::filesystem::path, Export> m_exports;
+
+public:
+  bool isCurrent(const std::filesystem::path& path, size_t revision) const;
+
+  void setExported(const std::filesystem::path& path, size_t revision);
+  void invalidate(const std::filesystem::path& path);
+};
+
+} // namespace tb::ui
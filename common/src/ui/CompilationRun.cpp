@@ -85,8 +85,8 @@ Result<void> CompilationRun::run(
 
   return buildWorkDir(profile, map) | kdl::transform([&](const auto& workDir) {
            auto variables = CompilationVariables{map, workDir};
-           auto compilationContext =
-             CompilationContext{map, variables, TextOutputAdapter{currentOutput}, test};
+           auto compilationContext = CompilationContext{
+             map, variables, TextOutputAdapter{currentOutput}, test, &m_exportCache};
            m_currentRun =
              new CompilationRunner{std::move(compilationContext), profile, this};
            connect(
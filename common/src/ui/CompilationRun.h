@@ -22,6 +22,7 @@
 #include <QObject>
 
 #include "Result.h"
+#include "ui/CompilationExportCache.h"
 
 #include <memory>
 #include <string>
@@ -50,6 +51,7 @@ class CompilationRun : public QObject
   Q_OBJECT
 private:
   CompilationRunner* m_currentRun{nullptr};
+  CompilationExportCache m_exportCache;
 
 public:
   ~CompilationRun() override;
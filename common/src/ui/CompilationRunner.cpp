@@ -35,6 +35,7 @@
 #include "mdl/CompilationTask.h"
 #include "mdl/Map.h"
 #include "ui/CompilationContext.h"
+#include "ui/CompilationExportCache.h"
 #include "ui/CompilationVariables.h"
 #include "ui/MapDocument.h" // IWYU pragma: keep
 
@@ -49,8 +50,12 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
+#include <future>
 #include <ranges>
+#include <sstream>
 #include <string>
+#include <thread>
 
 namespace tb::ui
 {
@@ -89,11 +94,13 @@ void CompilationTaskRunner::terminate()
   doTerminate();
 }
 
-Result<std::string> CompilationTaskRunner::interpolate(const std::string& spec) const
+Result<std::string> CompilationTaskRunner::interpolate(
+  const std::string& spec, const std::optional<size_t> cpuCount) const
 {
   try
   {
-    return m_context.interpolate(spec);
+    return cpuCount ? m_context.interpolate(spec, *cpuCount)
+                    : m_context.interpolate(spec);
   }
   catch (const Exception& e)
   {
@@ -109,7 +116,10 @@ CompilationExportMapTaskRunner::CompilationExportMapTaskRunner(
 {
 }
 
-CompilationExportMapTaskRunner::~CompilationExportMapTaskRunner() = default;
+CompilationExportMapTaskRunner::~CompilationExportMapTaskRunner()
+{
+  doTerminate();
+}
 
 void CompilationExportMapTaskRunner::doExecute()
 {
@@ -117,25 +127,94 @@ void CompilationExportMapTaskRunner::doExecute()
 
   interpolate(m_task.targetSpec).and_then([&](const auto& interpolated) {
     const auto targetPath = kdl::parse_path(interpolated);
+    const auto revision = m_context.map().revision();
+    const auto selectionBounds = m_context.map().selectionBounds();
+
+    if (m_task.selectionOnly && !selectionBounds)
+    {
+      return Result<void>{Error{"Cannot export selection: nothing is selected"}};
+    }
+
+    // the export cache doesn't know which region was exported
+    auto* exportCache = !m_task.selectionOnly ? m_context.exportCache() : nullptr;
+
+    if (exportCache && exportCache->isCurrent(targetPath, revision))
+    {
+      m_context << "#### Map file '" << io::pathAsQString(targetPath)
+                << "' is up to date, skipping export\n";
+      emit end();
+      return Result<void>{};
+    }
+
     m_context << "#### Exporting map file '" << io::pathAsQString(targetPath) << "'\n";
 
-    if (!m_context.test())
+    if (m_context.test())
     {
-      return io::Disk::createDirectory(targetPath.parent_path())
-             | kdl::and_then([&](auto) {
-                 const auto options = io::MapExportOptions{targetPath};
-                 return m_context.map().exportAs(options);
-               });
+      emit end();
+      return Result<void>{};
     }
-    return Result<void>{};
-  }) | kdl::transform([&]() { emit end(); })
-    | kdl::transform_error([&](auto e) {
-        m_context << "#### Export failed: " << QString::fromStdString(e.msg) << "\n";
-        emit error();
-      });
+
+    if (auto* cache = m_context.exportCache())
+    {
+      cache->invalidate(targetPath);
+    }
+
+    return io::Disk::createDirectory(targetPath.parent_path())
+           | kdl::transform([&](auto) {
+               auto stream = std::ostringstream{};
+               if (m_task.selectionOnly)
+               {
+                 m_context.map().exportRegionTo(stream, *selectionBounds);
+               }
+               else
+               {
+                 m_context.map().exportTo(stream);
+               }
+
+               m_export = std::async(
+                 std::launch::async,
+                 [this, targetPath, revision, content = std::move(stream).str()]() {
+                   auto result = io::Disk::withOutputStream(
+                     targetPath, [&](auto& fileStream) { fileStream << content; });
+
+                   QMetaObject::invokeMethod(
+                     this,
+                     [this, targetPath, revision, result]() {
+                       exportFinished(targetPath, revision, result);
+                     },
+                     Qt::QueuedConnection);
+                   return result;
+                 });
+             });
+  }) | kdl::transform_error([&](auto e) {
+    m_context << "#### Export failed: " << QString::fromStdString(e.msg) << "\n";
+    emit error();
+  });
+}
+
+void CompilationExportMapTaskRunner::doTerminate()
+{
+  if (m_export.valid())
+  {
+    // the background thread accesses this runner when it's done
+    m_export.wait();
+  }
 }
 
-void CompilationExportMapTaskRunner::doTerminate() {}
+void CompilationExportMapTaskRunner::exportFinished(
+  const std::filesystem::path& targetPath, const size_t revision, Result<void> result)
+{
+  std::move(result) | kdl::transform([&]() {
+    if (auto* exportCache = m_context.exportCache(); exportCache && !m_task.selectionOnly)
+    {
+      exportCache->setExported(targetPath, revision);
+    }
+    emit end();
+  }) | kdl::transform_error([&](auto e) {
+    m_context << "#### Export failed: " << QString::fromStdString(e.msg) << "\n";
+    emit error();
+  });
+}
 
 CompilationCopyFilesTaskRunner::CompilationCopyFilesTaskRunner(
   CompilationContext& context, mdl::CompilationCopyFiles task)
@@ -387,16 +466,21 @@ void CompilationRunToolTaskRunner::startProcess()
       });
 }
 
+std::optional<size_t> CompilationRunToolTaskRunner::cpuBudget() const
+{
+  return m_task.cpuBudget > 0 ? std::optional{m_task.cpuBudget} : std::nullopt;
+}
+
 Result<std::string> CompilationRunToolTaskRunner::program() const
 {
-  return interpolate(m_task.toolSpec);
+  return interpolate(m_task.toolSpec, cpuBudget());
 }
 
 Result<std::vector<std::string>> CompilationRunToolTaskRunner::parameters() const
 {
-  return interpolate(m_task.parameterSpec).transform([](const auto& parameters) {
-    return kdl::cmd_parse_args(parameters);
-  });
+  return interpolate(m_task.parameterSpec, cpuBudget())
+    .transform(
+      [](const auto& parameters) { return kdl::cmd_parse_args(parameters); });
 }
 
 void CompilationRunToolTaskRunner::processErrorOccurred(
@@ -454,7 +538,8 @@ CompilationRunner::CompilationRunner(
   : QObject{parent}
   , m_context{std::move(context)}
   , m_taskRunners{createTaskRunners(m_context, profile)}
-  , m_currentTask{std::end(m_taskRunners)}
+  , m_cpuCount{size_t(std::max(std::thread::hardware_concurrency(), 1u))}
+  , m_nextTask{m_taskRunners.size()}
 {
 }
 
@@ -471,36 +556,51 @@ CompilationRunner::TaskRunnerList CompilationRunner::createTaskRunners(
         [&](const mdl::CompilationExportMap& exportMap) {
           if (exportMap.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationExportMapTaskRunner>(context, exportMap));
+            result.push_back({
+              std::make_unique<CompilationExportMapTaskRunner>(context, exportMap),
+              exportMap.concurrent,
+              0,
+            });
           }
         },
         [&](const mdl::CompilationCopyFiles& copyFiles) {
           if (copyFiles.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationCopyFilesTaskRunner>(context, copyFiles));
+            result.push_back({
+              std::make_unique<CompilationCopyFilesTaskRunner>(context, copyFiles),
+              copyFiles.concurrent,
+              0,
+            });
           }
         },
         [&](const mdl::CompilationRenameFile& renameFile) {
           if (renameFile.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationRenameFileTaskRunner>(context, renameFile));
+            result.push_back({
+              std::make_unique<CompilationRenameFileTaskRunner>(context, renameFile),
+              renameFile.concurrent,
+              0,
+            });
           }
         },
         [&](const mdl::CompilationDeleteFiles& deleteFiles) {
           if (deleteFiles.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationDeleteFilesTaskRunner>(context, deleteFiles));
+            result.push_back({
+              std::make_unique<CompilationDeleteFilesTaskRunner>(context, deleteFiles),
+              deleteFiles.concurrent,
+              0,
+            });
           }
         },
         [&](const mdl::CompilationRunTool& runTool) {
           if (runTool.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationRunToolTaskRunner>(context, runTool));
+            result.push_back({
+              std::make_unique<CompilationRunToolTaskRunner>(context, runTool),
+              runTool.concurrent,
+              runTool.cpuBudget,
+            });
           }
         }),
       task);
@@ -512,12 +612,13 @@ void CompilationRunner::execute()
 {
   assert(!running());
 
-  m_currentTask = std::begin(m_taskRunners);
-  if (m_currentTask == std::end(m_taskRunners))
+  if (m_taskRunners.empty())
   {
     return;
   }
-  bindEvents(*m_currentTask->get());
+
+  m_running = true;
+  m_nextTask = 0;
 
   emit compilationStarted();
 
@@ -533,7 +634,7 @@ void CompilationRunner::execute()
         m_context << "#### Error: working directory '" << workDirQStr
                   << "' does not exist\n";
       }
-      m_currentTask->get()->execute();
+      startTasks();
     })
     .transform_error([&](const auto& e) {
       m_context << "#### Error: Could not get determine working directory: "
@@ -544,54 +645,110 @@ void CompilationRunner::execute()
 void CompilationRunner::terminate()
 {
   assert(running());
-  unbindEvents(*m_currentTask->get());
-  m_currentTask->get()->terminate();
-  m_currentTask = std::end(m_taskRunners);
+  stopTasks();
 
   emit compilationEnded();
 }
 
 bool CompilationRunner::running() const
 {
-  return m_currentTask != std::end(m_taskRunners);
+  return m_running;
 }
 
-void CompilationRunner::bindEvents(CompilationTaskRunner& runner) const
+void CompilationRunner::startTasks()
 {
-  connect(&runner, &CompilationTaskRunner::error, this, &CompilationRunner::taskError);
-  connect(&runner, &CompilationTaskRunner::end, this, &CompilationRunner::taskEnd);
+  // Tasks that don't run an external tool finish while they are being started, and
+  // their end event must not start the following tasks out of order.
+  if (m_startingTasks)
+  {
+    return;
+  }
+
+  m_startingTasks = true;
+  while (m_running && m_nextTask < m_taskRunners.size()
+         && canStartTask(m_taskRunners[m_nextTask]))
+  {
+    const auto taskIndex = m_nextTask++;
+    m_runningTasks.push_back(taskIndex);
+    bindEvents(taskIndex);
+    m_taskRunners[taskIndex].runner->execute();
+  }
+  m_startingTasks = false;
+
+  if (m_running && m_runningTasks.empty() && m_nextTask == m_taskRunners.size())
+  {
+    m_running = false;
+    emit compilationEnded();
+  }
 }
 
-void CompilationRunner::unbindEvents(CompilationTaskRunner& runner) const
+bool CompilationRunner::canStartTask(const TaskRunner& taskRunner) const
 {
-  runner.disconnect(this);
+  if (m_runningTasks.empty())
+  {
+    return true;
+  }
+  if (!taskRunner.concurrent)
+  {
+    return false;
+  }
+
+  auto usedCpuCount = size_t(0);
+  for (const auto taskIndex : m_runningTasks)
+  {
+    usedCpuCount += m_taskRunners[taskIndex].cpuBudget;
+  }
+  return taskRunner.cpuBudget == 0 || usedCpuCount + taskRunner.cpuBudget <= m_cpuCount;
 }
 
-void CompilationRunner::taskError()
+void CompilationRunner::stopTasks()
+{
+  for (const auto taskIndex : m_runningTasks)
+  {
+    unbindEvents(taskIndex);
+    m_taskRunners[taskIndex].runner->terminate();
+  }
+
+  m_runningTasks.clear();
+  m_nextTask = m_taskRunners.size();
+  m_running = false;
+}
+
+void CompilationRunner::bindEvents(const size_t taskIndex)
+{
+  auto& runner = *m_taskRunners[taskIndex].runner;
+  connect(&runner, &CompilationTaskRunner::error, this, [this, taskIndex]() {
+    taskError(taskIndex);
+  });
+  connect(&runner, &CompilationTaskRunner::end, this, [this, taskIndex]() {
+    taskEnd(taskIndex);
+  });
+}
+
+void CompilationRunner::unbindEvents(const size_t taskIndex)
+{
+  m_taskRunners[taskIndex].runner->disconnect(this);
+}
+
+void CompilationRunner::taskError(const size_t taskIndex)
 {
   if (running())
   {
-    unbindEvents(*m_currentTask->get());
-    m_currentTask = std::end(m_taskRunners);
+    unbindEvents(taskIndex);
+    std::erase(m_runningTasks, taskIndex);
+    stopTasks();
+
     emit compilationEnded();
   }
 }
 
-void CompilationRunner::taskEnd()
+void CompilationRunner::taskEnd(const size_t taskIndex)
 {
   if (running())
   {
-    unbindEvents(*m_currentTask->get());
-    ++m_currentTask;
-    if (m_currentTask != std::end(m_taskRunners))
-    {
-      bindEvents(*m_currentTask->get());
-      m_currentTask->get()->execute();
-    }
-    else
-    {
-      emit compilationEnded();
-    }
+    unbindEvents(taskIndex);
+    std::erase(m_runningTasks, taskIndex);
+    startTasks();
   }
 }
 
@@ -27,7 +27,10 @@
 #include "mdl/CompilationTask.h"
 #include "ui/CompilationContext.h"
 
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -60,7 +63,12 @@ signals:
   void end();
 
 protected:
-  Result<std::string> interpolate(const std::string& spec) const;
+  /**
+   * Interpolates the given spec. If a CPU count is given, the CPU_COUNT variable
+   * evaluates to it.
+   */
+  Result<std::string> interpolate(
+    const std::string& spec, std::optional<size_t> cpuCount = std::nullopt) const;
 
 private:
   virtual void doExecute() = 0;
@@ -69,11 +77,20 @@ private:
   deleteCopyAndMove(CompilationTaskRunner);
 };
 
+/**
+ * Exports the map to a file. The map is serialized on the main thread, and the file is
+ * written on a background thread; the runner emits end() or error() once the file was
+ * written.
+ *
+ * If the context has an export cache and the map was not modified since it was last
+ * exported to the same file, the export is skipped.
+ */
 class CompilationExportMapTaskRunner : public CompilationTaskRunner
 {
   Q_OBJECT
 private:
   mdl::CompilationExportMap m_task;
+  std::future<Result<void>> m_export;
 
 public:
   CompilationExportMapTaskRunner(
@@ -84,6 +101,9 @@ private:
   void doExecute() override;
   void doTerminate() override;
 
+  void exportFinished(
+    const std::filesystem::path& targetPath, size_t revision, Result<void> result);
+
   deleteCopyAndMove(CompilationExportMapTaskRunner);
 };
 
@@ -159,6 +179,7 @@ private:
 
 private:
   void startProcess();
+  std::optional<size_t> cpuBudget() const;
   Result<std::string> program() const;
   Result<std::vector<std::string>> parameters() const;
 private slots:
@@ -170,15 +191,42 @@ private slots:
   deleteCopyAndMove(CompilationRunToolTaskRunner);
 };
 
+/**
+ * Runs the enabled tasks of a compilation profile in order. A task waits until all tasks
+ * before it have finished unless it is marked as concurrent, in which case it is started
+ * right after the task before it. Tools with a CPU budget are only started if the budgets
+ * of the running tools leave enough CPUs for them.
+ *
+ * If a task fails, all running tasks are terminated and the compilation ends.
+ */
 class CompilationRunner : public QObject
 {
   Q_OBJECT
 private:
-  using TaskRunnerList = std::vector<std::unique_ptr<CompilationTaskRunner>>;
+  struct TaskRunner
+  {
+    std::unique_ptr<CompilationTaskRunner> runner;
+    bool concurrent;
+    size_t cpuBudget;
+  };
+
+  using TaskRunnerList = std::vector<TaskRunner>;
 
   CompilationContext m_context;
   TaskRunnerList m_taskRunners;
-  TaskRunnerList::iterator m_currentTask;
+  size_t m_cpuCount;
+
+  /**
+   * The index of the next task to start.
+   */
+  size_t m_nextTask;
+
+  /**
+   * The indices of the tasks that were started and haven't finished yet.
+   */
+  std::vector<size_t> m_runningTasks;
+  bool m_running = false;
+  bool m_startingTasks = false;
 
 public:
   CompilationRunner(
@@ -197,11 +245,15 @@ public:
   bool running() const;
 
 private:
-  void bindEvents(CompilationTaskRunner& runner) const;
-  void unbindEvents(CompilationTaskRunner& runner) const;
-private slots:
-  void taskError();
-  void taskEnd();
+  void startTasks();
+  bool canStartTask(const TaskRunner& taskRunner) const;
+  void stopTasks();
+
+  void bindEvents(size_t taskIndex);
+  void unbindEvents(size_t taskIndex);
+
+  void taskError(size_t taskIndex);
+  void taskEnd(size_t taskIndex);
 signals:
   void compilationStarted();
   void compilationEnded();
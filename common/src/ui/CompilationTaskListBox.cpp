@@ -27,6 +27,7 @@
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QSpinBox>
 
 #include "el/Interpolate.h"
 #include "mdl/CompilationProfile.h"
@@ -85,6 +86,15 @@ CompilationTaskEditorBase::CompilationTaskEditorBase(
   connect(m_enabledCheckbox, &QCheckBox::clicked, this, [&](const bool checked) {
     std::visit([&](auto& t) { t.enabled = checked; }, m_task);
   });
+
+  m_concurrentCheckbox = new QCheckBox{tr("Run concurrently with the previous task")};
+  m_concurrentCheckbox->setToolTip(
+    tr("Start this task right after the previous task was started instead of waiting "
+       "for all previous tasks to finish"));
+
+  connect(m_concurrentCheckbox, &QCheckBox::clicked, this, [&](const bool checked) {
+    std::visit([&](auto& t) { t.concurrent = checked; }, m_task);
+  });
 }
 
 void CompilationTaskEditorBase::setupCompleter(MultiCompletionLineEdit* lineEdit)
@@ -103,9 +113,19 @@ void CompilationTaskEditorBase::addMainLayout(QLayout* layout)
   m_taskLayout->addLayout(layout, 1);
 }
 
+void CompilationTaskEditorBase::addConcurrentRow(QFormLayout* formLayout)
+{
+  formLayout->addRow("", m_concurrentCheckbox);
+}
+
 void CompilationTaskEditorBase::updateItem()
 {
-  std::visit([&](const auto& t) { m_enabledCheckbox->setChecked(t.enabled); }, m_task);
+  std::visit(
+    [&](const auto& t) {
+      m_enabledCheckbox->setChecked(t.enabled);
+      m_concurrentCheckbox->setChecked(t.concurrent);
+    },
+    m_task);
 }
 
 void CompilationTaskEditorBase::updateCompleter(QCompleter* completer)
@@ -147,11 +167,23 @@ Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("File Path", m_targetEditor);
 
+  m_selectionOnlyCheckbox = new QCheckBox{tr("Only export the selected region")};
+  m_selectionOnlyCheckbox->setToolTip(
+    tr("Only export worldspawn and the brushes and entities that touch the bounds of "
+       "the current selection"));
+  formLayout->addRow("", m_selectionOnlyCheckbox);
+  addConcurrentRow(formLayout);
+
   connect(
     m_targetEditor,
     &QLineEdit::textChanged,
     this,
     &CompilationExportMapTaskEditor::targetSpecChanged);
+  connect(
+    m_selectionOnlyCheckbox,
+    &QCheckBox::checkStateChanged,
+    this,
+    &CompilationExportMapTaskEditor::selectionOnlyChanged);
 }
 
 void CompilationExportMapTaskEditor::updateItem()
@@ -163,6 +195,11 @@ void CompilationExportMapTaskEditor::updateItem()
   {
     m_targetEditor->setText(targetSpec);
   }
+
+  if (m_selectionOnlyCheckbox->isChecked() != task().selectionOnly)
+  {
+    m_selectionOnlyCheckbox->setChecked(task().selectionOnly);
+  }
 }
 
 mdl::CompilationExportMap& CompilationExportMapTaskEditor::task()
@@ -177,6 +214,11 @@ void CompilationExportMapTaskEditor::targetSpecChanged(const QString& text)
   task().targetSpec = text.toStdString();
 }
 
+void CompilationExportMapTaskEditor::selectionOnlyChanged(const int state)
+{
+  task().selectionOnly = (state == Qt::Checked);
+}
+
 CompilationCopyFilesTaskEditor::CompilationCopyFilesTaskEditor(
   MapDocument& document,
   mdl::CompilationProfile& profile,
@@ -214,6 +256,7 @@ Existing files are overwritten without prompt.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("Target Directory Path", m_targetEditor);
+  addConcurrentRow(formLayout);
 
   connect(
     m_sourceEditor,
@@ -299,6 +342,7 @@ Existing files are overwritten without prompt.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("Target File Path", m_targetEditor);
+  addConcurrentRow(formLayout);
 
   connect(
     m_sourceEditor,
@@ -373,6 +417,7 @@ Use wildcards (*,?) in the filename to specify more than one file.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("File Path", m_targetEditor);
+  addConcurrentRow(formLayout);
 
   connect(
     m_targetEditor,
@@ -459,6 +504,16 @@ Variables are allowed.)");
     tr("Stop compilation if the tool returns a nonzero error code"));
   formLayout->addRow("", m_treatNonZeroResultCodeAsError);
 
+  m_cpuBudgetEditor = new QSpinBox{};
+  m_cpuBudgetEditor->setRange(0, 1024);
+  m_cpuBudgetEditor->setSpecialValueText(tr("All"));
+  m_cpuBudgetEditor->setToolTip(
+    tr("The number of CPUs that the tool may use. The CPU_COUNT variable evaluates to "
+       "this number for this tool, and the tool waits until enough CPUs are available "
+       "if it runs concurrently with other tools."));
+  formLayout->addRow("CPU Budget", m_cpuBudgetEditor);
+  addConcurrentRow(formLayout);
+
   connect(
     m_toolEditor,
     &QLineEdit::textChanged,
@@ -479,6 +534,11 @@ Variables are allowed.)");
     &QCheckBox::checkStateChanged,
     this,
     &CompilationRunToolTaskEditor::treatNonZeroResultCodeAsErrorChanged);
+  connect(
+    m_cpuBudgetEditor,
+    QOverload<int>::of(&QSpinBox::valueChanged),
+    this,
+    &CompilationRunToolTaskEditor::cpuBudgetChanged);
 }
 
 void CompilationRunToolTaskEditor::updateItem()
@@ -504,6 +564,12 @@ void CompilationRunToolTaskEditor::updateItem()
       task().treatNonZeroResultCodeAsError ? Qt::CheckState::Checked
                                            : Qt::CheckState::Unchecked);
   }
+
+  const auto cpuBudget = int(task().cpuBudget);
+  if (m_cpuBudgetEditor->value() != cpuBudget)
+  {
+    m_cpuBudgetEditor->setValue(cpuBudget);
+  }
 }
 
 mdl::CompilationRunTool& CompilationRunToolTaskEditor::task()
@@ -542,6 +608,11 @@ void CompilationRunToolTaskEditor::treatNonZeroResultCodeAsErrorChanged(const in
   task().treatNonZeroResultCodeAsError = value;
 }
 
+void CompilationRunToolTaskEditor::cpuBudgetChanged(const int value)
+{
+  task().cpuBudget = size_t(value);
+}
+
 // CompilationTaskListBox
 
 CompilationTaskListBox::CompilationTaskListBox(MapDocument& document, QWidget* parent)
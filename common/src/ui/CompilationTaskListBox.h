@@ -26,9 +26,11 @@
 
 class QCheckBox;
 class QCompleter;
+class QFormLayout;
 class QHBoxLayout;
 class QLayout;
 class QLineEdit;
+class QSpinBox;
 class QWidget;
 
 namespace tb::mdl
@@ -51,6 +53,7 @@ protected:
   mdl::CompilationProfile& m_profile;
   mdl::CompilationTask& m_task;
   QCheckBox* m_enabledCheckbox = nullptr;
+  QCheckBox* m_concurrentCheckbox = nullptr;
   QHBoxLayout* m_taskLayout = nullptr;
 
   std::vector<QCompleter*> m_completers;
@@ -66,6 +69,7 @@ protected:
 protected:
   void setupCompleter(MultiCompletionLineEdit* lineEdit);
   void addMainLayout(QLayout* layout);
+  void addConcurrentRow(QFormLayout* formLayout);
 
 protected:
   void updateItem() override;
@@ -79,6 +83,7 @@ class CompilationExportMapTaskEditor : public CompilationTaskEditorBase
   Q_OBJECT
 private:
   MultiCompletionLineEdit* m_targetEditor = nullptr;
+  QCheckBox* m_selectionOnlyCheckbox = nullptr;
 
 public:
   CompilationExportMapTaskEditor(
@@ -92,6 +97,7 @@ private:
   mdl::CompilationExportMap& task();
 private slots:
   void targetSpecChanged(const QString& text);
+  void selectionOnlyChanged(int state);
 };
 
 class CompilationCopyFilesTaskEditor : public CompilationTaskEditorBase
@@ -165,6 +171,7 @@ private:
   MultiCompletionLineEdit* m_toolEditor = nullptr;
   MultiCompletionLineEdit* m_parametersEditor = nullptr;
   QCheckBox* m_treatNonZeroResultCodeAsError = nullptr;
+  QSpinBox* m_cpuBudgetEditor = nullptr;
 
 public:
   CompilationRunToolTaskEditor(
@@ -181,6 +188,7 @@ private slots:
   void toolSpecChanged(const QString& text);
   void parameterSpecChanged(const QString& text);
   void treatNonZeroResultCodeAsErrorChanged(int state);
+  void cpuBudgetChanged(int value);
 };
 
 class CompilationTaskListBox : public ControlListBox
@@ -20,9 +20,8 @@
 #include "Console.h"
 
 #include <QDebug>
-#include <QMutexLocker>
+#include <QPlainTextEdit>
 #include <QScrollBar>
-#include <QTextEdit>
 #include <QThread>
 #include <QTimer>
 #include <QVBoxLayout>
@@ -64,9 +63,10 @@ Console::Console(QWidget* parent)
   : TabBookPage{parent}
   , m_timer{new QTimer{this}}
 {
-  m_textView = new QTextEdit{};
+  m_textView = new QPlainTextEdit{};
   m_textView->setReadOnly(true);
   m_textView->setWordWrapMode(QTextOption::NoWrap);
+  m_textView->setMaximumBlockCount(MaxLines);
 
   auto* sizer = new QVBoxLayout{};
   sizer->setContentsMargins(0, 0, 0, 0);
@@ -81,8 +81,7 @@ void Console::doLog(const LogLevel level, const std::string_view message)
 {
   if (!message.empty())
   {
-    auto lock = QMutexLocker{&m_cacheMutex};
-    m_cache.cacheMessage(level, message);
+    m_queue.push(level, message);
   }
 }
 
@@ -91,35 +90,60 @@ void Console::logToDebugOut(const LogLevel /* level */, const std::string& messa
   qDebug("%s", message.c_str());
 }
 
-void Console::logToConsole(const LogLevel level, const std::string& message)
+void Console::logToConsole(const std::vector<LoggerCache::Message>& messages)
 {
   ensure(
     m_textView->thread() == QThread::currentThread(),
     "Can only log to console from main thread");
 
-  auto format = QTextCharFormat{};
-  format.setForeground(getForegroundBrush(level, m_textView->palette()));
-  format.setFont(Fonts::fixedWidthFont());
+  // Only the most recent lines remain visible, so there is no need to format the others
+  const auto first = messages.size() > size_t(MaxLines)
+                       ? messages.end() - MaxLines
+                       : messages.begin();
 
   auto cursor = QTextCursor{m_textView->document()};
+  cursor.beginEditBlock();
   cursor.movePosition(QTextCursor::MoveOperation::End);
 
-  cursor.insertText(QString::fromStdString(message), format);
-  cursor.insertText("\n");
+  auto format = QTextCharFormat{};
+  format.setFont(Fonts::fixedWidthFont());
+
+  // Insert runs of messages with the same log level at once
+  for (auto it = first; it != messages.end();)
+  {
+    const auto level = it->level;
+    auto text = QString{};
+    for (; it != messages.end() && it->level == level; ++it)
+    {
+      text += QString::fromStdString(it->str);
+      text += "\n";
+    }
+
+    format.setForeground(getForegroundBrush(level, m_textView->palette()));
+    cursor.insertText(text, format);
+  }
 
+  cursor.endEditBlock();
   m_textView->moveCursor(QTextCursor::MoveOperation::End);
 }
 
 void Console::logCachedMessages()
 {
-  auto lock = QMutexLocker{&m_cacheMutex};
-
-  m_cache.getCachedMessages([this](const auto level, const auto& message) {
-    const auto messageStr = std::string{message};
-    logToDebugOut(level, messageStr);
-    logToConsole(level, messageStr);
-    FileLogger::instance().log(level, message);
-  });
+  for (const auto& message : m_queue.takeMessages())
+  {
+    m_cache.cacheMessage(message.level, message.str);
+  }
+
+  const auto messages = m_cache.takeCachedMessages();
+  if (!messages.empty())
+  {
+    for (const auto& message : messages)
+    {
+      logToDebugOut(message.level, message.str);
+      FileLogger::instance().log(message.level, message.str);
+    }
+    logToConsole(messages);
+  }
 }
 
 } // namespace tb::ui
@@ -19,15 +19,15 @@
 
 #pragma once
 
-#include <QMutex>
-
+#include "LogQueue.h"
 #include "Logger.h"
 #include "LoggerCache.h"
 #include "ui/TabBook.h"
 
 #include <string_view>
+#include <vector>
 
-class QTextEdit;
+class QPlainTextEdit;
 class QTimer;
 class QWidget;
 
@@ -36,11 +36,17 @@ namespace tb::ui
 class Console : public TabBookPage, public Logger
 {
 private:
-  QTextEdit* m_textView = nullptr;
+  static constexpr int MaxLines = 10000;
+
+  QPlainTextEdit* m_textView = nullptr;
   QTimer* m_timer = nullptr;
 
+  /**
+   * Messages can be logged from any thread. They are queued without locking and drained
+   * by the timer on the main thread.
+   */
+  LogQueue m_queue;
   LoggerCache m_cache;
-  QMutex m_cacheMutex;
 
 public:
   explicit Console(QWidget* parent = nullptr);
@@ -48,7 +54,7 @@ public:
 private:
   void doLog(LogLevel level, std::string_view message) override;
   void logToDebugOut(LogLevel level, const std::string& message);
-  void logToConsole(LogLevel level, const std::string& message);
+  void logToConsole(const std::vector<LoggerCache::Message>& messages);
 
   void logCachedMessages();
 };
@@ -24,12 +24,16 @@
 
 #include "Ensure.h"
 #include "mdl/Map.h"
+#include "mdl/WorldNode.h"
 #include "ui/DrawShapeToolExtensions.h"
 #include "ui/ViewConstants.h"
 
 #include "kdl/ranges/to.h"
+#include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/mat_ext.h"
+
 namespace tb::ui
 {
 
@@ -155,9 +159,13 @@ DrawShapeToolExtension::DrawShapeToolExtension(mdl::Map& map)
 DrawShapeToolExtension::~DrawShapeToolExtension() = default;
 
 DrawShapeToolExtensionManager::DrawShapeToolExtensionManager(mdl::Map& map)
-  : m_extensions{createDrawShapeToolExtensions(map)}
+  : m_map{map}
+  , m_extensions{createDrawShapeToolExtensions(map)}
 {
   ensure(!m_extensions.empty(), "extensions must not be empty");
+
+  m_notifierConnection +=
+    m_parameters.parametersDidChangeNotifier.connect([&]() { m_cachedBrushes.reset(); });
 }
 
 const std::vector<DrawShapeToolExtension*> DrawShapeToolExtensionManager::extensions()
@@ -177,6 +185,7 @@ bool DrawShapeToolExtensionManager::setCurrentExtensionIndex(size_t currentExten
   if (currentExtensionIndex != m_currentExtensionIndex)
   {
     m_currentExtensionIndex = currentExtensionIndex;
+    m_cachedBrushes.reset();
     currentExtensionDidChangeNotifier(m_currentExtensionIndex);
     return true;
   }
@@ -196,7 +205,49 @@ std::vector<DrawShapeToolExtensionPage*> DrawShapeToolExtensionManager::createTo
 Result<std::vector<mdl::Brush>> DrawShapeToolExtensionManager::createBrushes(
   const vm::bbox3d& bounds) const
 {
-  return currentExtension().createBrushes(bounds, m_parameters);
+  if (auto brushes = translateCachedBrushes(bounds))
+  {
+    return std::move(*brushes);
+  }
+
+  m_cachedBrushes.reset();
+  return currentExtension().createBrushes(bounds, m_parameters)
+         | kdl::transform([&](auto brushes) {
+             m_cachedBrushes = CachedBrushes{
+               bounds, m_map.world()->mapFormat(), m_map.currentMaterialName(), brushes};
+             return brushes;
+           });
+}
+
+std::optional<std::vector<mdl::Brush>> DrawShapeToolExtensionManager::
+  translateCachedBrushes(const vm::bbox3d& bounds) const
+{
+  if (
+    !m_cachedBrushes || bounds.size() != m_cachedBrushes->bounds.size()
+    || m_map.world()->mapFormat() != m_cachedBrushes->mapFormat
+    || m_map.currentMaterialName() != m_cachedBrushes->materialName)
+  {
+    return std::nullopt;
+  }
+
+  auto brushes = m_cachedBrushes->brushes;
+  if (bounds.min != m_cachedBrushes->bounds.min)
+  {
+    const auto translation =
+      vm::translation_matrix(bounds.min - m_cachedBrushes->bounds.min);
+    for (auto& brush : brushes)
+    {
+      if (!brush.transform(m_map.worldBounds(), translation, false).is_success())
+      {
+        return std::nullopt;
+      }
+    }
+
+    m_cachedBrushes->bounds = bounds;
+    m_cachedBrushes->brushes = brushes;
+  }
+
+  return brushes;
 }
 
 } // namespace tb::ui
@@ -27,13 +27,15 @@
 #include "mdl/BrushBuilder.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace tb::mdl
 {
 class Map;
-}
+enum class MapFormat;
+} // namespace tb::mdl
 
 namespace tb::ui
 {
@@ -125,12 +127,35 @@ public:
   bool setCurrentExtensionIndex(size_t currentExtensionIndex);
 
   std::vector<DrawShapeToolExtensionPage*> createToolPages(QWidget* parent = nullptr);
+
+  /**
+   * Creates the brushes of the current extension for the given bounds.
+   *
+   * The brushes of the previous call are kept, so if only the position of the bounds
+   * changed since then, as it does while the user moves a shape, they are translated
+   * rather than built again.
+   */
   Result<std::vector<mdl::Brush>> createBrushes(const vm::bbox3d& bounds) const;
 
 private:
+  struct CachedBrushes
+  {
+    vm::bbox3d bounds;
+    mdl::MapFormat mapFormat;
+    std::string materialName;
+    std::vector<mdl::Brush> brushes;
+  };
+
+  mdl::Map& m_map;
   ShapeParameters m_parameters;
   std::vector<std::unique_ptr<DrawShapeToolExtension>> m_extensions;
   size_t m_currentExtensionIndex = 0;
+  mutable std::optional<CachedBrushes> m_cachedBrushes;
+
+  NotifierConnection m_notifierConnection;
+
+  std::optional<std::vector<mdl::Brush>> translateCachedBrushes(
+    const vm::bbox3d& bounds) const;
 };
 
 } // namespace tb::ui
@@ -289,7 +289,8 @@ Result<std::vector<mdl::Brush>> DrawShapeToolCylinderExtension::createBrushes(
                parameters.thickness(),
                parameters.circleShape(),
                parameters.axis(),
-               m_map.currentMaterialName())
+               m_map.currentMaterialName(),
+               m_map.taskManager())
            : builder
                .createCylinder(
                  bounds,
@@ -149,7 +149,7 @@ void EntityBrowser::connectObservers()
   m_notifierConnection += map.entityDefinitionsDidChangeNotifier.connect(
     this, &EntityBrowser::entityDefinitionsDidChange);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &EntityBrowser::nodesDidChange);
   m_notifierConnection += map.resourcesWereProcessedNotifier.connect(
     this, &EntityBrowser::resourcesWereProcessed);
 
@@ -160,16 +160,20 @@ void EntityBrowser::connectObservers()
 
 void EntityBrowser::mapWasCreated(mdl::Map&)
 {
+  m_view->clear();
   reload();
 }
 
 void EntityBrowser::mapWasLoaded(mdl::Map&)
 {
+  m_view->clear();
   reload();
 }
 
 void EntityBrowser::modsDidChange()
 {
+  // model files may have changed, so cached model bounds and thumbnails are discarded
+  m_view->clear();
   reload();
 }
 
@@ -189,6 +193,7 @@ void EntityBrowser::preferenceDidChange(const std::filesystem::path& path)
   const auto& map = m_document.map();
   if (map.game()->isGamePathPreference(path))
   {
+    m_view->clear();
     reload();
   }
   else
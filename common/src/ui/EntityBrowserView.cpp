@@ -22,6 +22,9 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "el/VariableStore.h"
+#include "io/File.h"
+#include "io/FileSystem.h"
+#include "io/Reader.h"
 #include "mdl/AssetUtils.h"
 #include "mdl/EntityDefinition.h"
 #include "mdl/EntityDefinitionGroup.h"
@@ -29,6 +32,7 @@
 #include "mdl/EntityDefinitionUtils.h"
 #include "mdl/EntityModel.h"
 #include "mdl/EntityModelManager.h"
+#include "mdl/Game.h"
 #include "mdl/Map.h"
 #include "render/ActiveShader.h"
 #include "render/FontDescriptor.h"
@@ -39,11 +43,13 @@
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
 #include "render/TextureFont.h"
+#include "render/ThumbnailAtlas.h"
 #include "render/Transformation.h"
 #include "render/VertexArray.h"
 #include "ui/MapDocument.h"
 #include "ui/MapFrame.h"
 
+#include "kdl/result.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_utils.h"
 
@@ -52,17 +58,72 @@
 #include "vm/quat.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <string>
 #include <vector>
 
 namespace tb::ui
 {
 
+namespace
+{
+bool matchesFilterText(
+  const mdl::EntityDefinition& definition, const std::string& filterText)
+{
+  return filterText.empty()
+         || kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
+              return kdl::ci::str_contains(definition.name, pattern);
+            });
+}
+
+template <typename F>
+void forEachVisibleCell(CellLayout& layout, const float y, const float height, const F& f)
+{
+  for (const auto& group : layout.groups())
+  {
+    if (group.intersectsY(y, height))
+    {
+      for (const auto& row : group.rows())
+      {
+        if (row.intersectsY(y, height))
+        {
+          for (const auto& cell : row.cells())
+          {
+            f(cell);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns a transformation that places the rotated bounds of the given cell's model or
+ * entity with their minimum at the given offset and scales them by the given factor.
+ */
+vm::mat4x4f cellTransformation(
+  const EntityCellData& cellData, const vm::vec3f& offset, const float scale)
+{
+  const auto& rotatedBounds = cellData.bounds.transform(cellData.transform);
+  const auto rotationOffset =
+    vm::vec3f{0.0f, -rotatedBounds.min.y(), -rotatedBounds.min.z()};
+
+  return vm::translation_matrix(offset) * vm::scaling_matrix(vm::vec3f::fill(scale))
+         * vm::translation_matrix(rotationOffset) * cellData.transform;
+}
+
+} // namespace
+
 EntityBrowserView::EntityBrowserView(
   QScrollBar* scrollBar, GLContextManager& contextManager, MapDocument& document)
   : CellView{contextManager, scrollBar}
   , m_document{document}
   , m_sortOrder{mdl::EntityDefinitionSortOrder::Name}
+  , m_thumbnailAtlas{
+      std::make_unique<render::ThumbnailAtlas>(ThumbnailSize, ThumbnailsPerRow)}
+  , m_slotThumbnails(m_thumbnailAtlas->slotCount())
 {
   const auto hRotation = vm::quatf{vm::vec3f{0, 0, 1}, vm::to_radians(-30.0f)};
   const auto vRotation = vm::quatf{vm::vec3f{0, 1, 0}, vm::to_radians(20.0f)};
@@ -76,6 +137,10 @@ EntityBrowserView::EntityBrowserView(
 EntityBrowserView::~EntityBrowserView()
 {
   clear();
+
+  // deleting the thumbnail atlas deletes its texture and framebuffer
+  makeCurrent();
+  m_thumbnailAtlas.reset();
 }
 
 void EntityBrowserView::setDefaultModelScaleExpression(
@@ -118,8 +183,21 @@ void EntityBrowserView::setFilterText(const std::string& filterText)
 {
   if (filterText != m_filterText)
   {
+    // appending to the filter text can only remove entities from the view; empty groups
+    // are hidden, so grouped layouts must be reloaded
+    const auto narrowsFilter = !m_group && filterText.starts_with(m_filterText);
     m_filterText = filterText;
-    invalidate();
+
+    if (narrowsFilter)
+    {
+      removeCells([&](const auto& cell) {
+        return !matchesFilterText(cellData(cell).entityDefinition, m_filterText);
+      });
+    }
+    else
+    {
+      invalidate();
+    }
     update();
   }
 }
@@ -196,18 +274,6 @@ void EntityBrowserView::addEntitiesToLayout(
   }
 }
 
-namespace
-{
-bool matchesFilterText(
-  const mdl::EntityDefinition& definition, const std::string& filterText)
-{
-  return filterText.empty()
-         || kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
-              return kdl::ci::str_contains(definition.name, pattern);
-            });
-}
-} // namespace
-
 void EntityBrowserView::addEntityToLayout(
   Layout& layout,
   const mdl::EntityDefinition& definition,
@@ -221,7 +287,6 @@ void EntityBrowserView::addEntityToLayout(
     const auto& pointEntityDefinition = *definition.pointEntityDefinition;
 
     auto& map = m_document.map();
-    const auto& entityModelManager = map.entityModelManager();
 
     const auto maxCellWidth = layout.maxCellWidth();
     const auto actualFont =
@@ -237,20 +302,31 @@ void EntityBrowserView::addEntityToLayout(
       el::NullVariableStore{},
       m_defaultScaleModelExpression)};
 
-    auto* modelRenderer = static_cast<render::MaterialRenderer*>(nullptr);
+    auto modelSpecification = std::optional<mdl::ModelSpecification>{};
     auto bounds = vm::bbox3f{};
     auto transform = vm::mat4x4f{};
     auto modelOrientation = mdl::Orientation::Oriented;
+    auto thumbnailKey = std::optional<io::EntityThumbnailCacheKey>{};
 
-    const auto* model = entityModelManager.model(spec.path);
-    const auto* modelData = model ? model->data() : nullptr;
-    const auto* modelFrame = modelData ? modelData->frame(spec.frameIndex) : nullptr;
-    if (modelFrame)
+    auto cachedModelIt = m_cachedModels.find(spec);
+    if (cachedModelIt == m_cachedModels.end())
     {
-      modelRenderer = entityModelManager.renderer(spec);
-      modelOrientation = modelData->orientation();
+      if (auto cachedModel = loadCachedModel(spec, modelScale))
+      {
+        cachedModelIt = m_cachedModels.emplace(spec, std::move(*cachedModel)).first;
+      }
+    }
 
-      bounds = modelFrame->bounds();
+    if (cachedModelIt != m_cachedModels.end())
+    {
+      const auto& cachedModel = cachedModelIt->second;
+
+      modelSpecification = spec;
+      modelOrientation = cachedModel.orientation;
+      thumbnailKey = io::EntityThumbnailCacheKey{
+        spec, modelScale, cachedModel.sourceSize, cachedModel.sourceHash};
+
+      bounds = cachedModel.bounds;
 
       const auto scalingMatrix = vm::scaling_matrix(modelScale);
       const auto center = bounds.center();
@@ -273,12 +349,13 @@ void EntityBrowserView::addEntityToLayout(
     layout.addItem(
       EntityCellData{
         definition,
-        modelRenderer,
+        std::move(modelSpecification),
         modelOrientation,
         actualFont,
         bounds,
         transform,
-        modelScale},
+        modelScale,
+        std::move(thumbnailKey)},
       definition.name,
       rotatedBoundsSize.y(),
       rotatedBoundsSize.z(),
@@ -287,10 +364,63 @@ void EntityBrowserView::addEntityToLayout(
   }
 }
 
-void EntityBrowserView::doClear() {}
+std::optional<EntityBrowserView::CachedModel> EntityBrowserView::loadCachedModel(
+  const mdl::ModelSpecification& spec, const vm::vec3f& modelScale)
+{
+  auto& map = m_document.map();
+  const auto* game = map.game();
+  if (!game)
+  {
+    return std::nullopt;
+  }
+
+  return game->gameFileSystem().openFile(spec.path)
+         | kdl::transform([&](auto file) -> std::optional<CachedModel> {
+             auto reader = file->reader().buffer();
+             const auto key = io::makeEntityThumbnailCacheKey(
+               spec, modelScale, reader.begin(), reader.end());
+
+             // a cached thumbnail records the model bounds, so the model doesn't have to
+             // be loaded to lay out the cell
+             if (const auto* thumbnailCache = m_document.entityThumbnailCache())
+             {
+               if (const auto thumbnail = thumbnailCache->load(key))
+               {
+                 return CachedModel{
+                   thumbnail->bounds, thumbnail->orientation, key.size, key.hash};
+               }
+             }
+
+             const auto* model = map.entityModelManager().model(spec.path);
+             const auto* modelData = model ? model->data() : nullptr;
+             const auto* modelFrame =
+               modelData ? modelData->frame(spec.frameIndex) : nullptr;
+             if (modelFrame)
+             {
+               return CachedModel{
+                 modelFrame->bounds(), modelData->orientation(), key.size, key.hash};
+             }
+             return std::nullopt;
+           })
+         | kdl::value_or(std::optional<CachedModel>{});
+}
+
+void EntityBrowserView::doClear()
+{
+  m_cachedModels.clear();
+
+  m_thumbnails.clear();
+  std::ranges::fill(m_slotThumbnails, std::nullopt);
+  m_uncachedThumbnails.clear();
+  m_thumbnailAtlas->freeSlots();
+}
 
 void EntityBrowserView::doRender(Layout& layout, const float y, const float height)
 {
+  // thumbnails are rendered into an offscreen framebuffer, so this must happen before
+  // the view's transformation is set up
+  prepareThumbnails(layout, y, height);
+
   const auto viewLeft = static_cast<float>(0);
   const auto viewTop = static_cast<float>(size().height());
   const auto viewRight = static_cast<float>(size().width());
@@ -300,10 +430,10 @@ void EntityBrowserView::doRender(Layout& layout, const float y, const float heig
     vm::ortho_matrix(-1024.0f, 1024.0f, viewLeft, viewTop, viewRight, viewBottom);
   const auto view =
     vm::view_matrix(CameraDirection, CameraUp) * vm::translation_matrix(CameraPosition);
-  auto transformation = render::Transformation{projection, view};
+  const auto transformation = render::Transformation{projection, view};
 
   renderBounds(layout, y, height);
-  renderModels(layout, y, height, transformation);
+  renderThumbnails(layout, y, height);
 }
 
 bool EntityBrowserView::shouldRenderFocusIndicator() const
@@ -316,117 +446,251 @@ const Color& EntityBrowserView::getBackgroundColor()
   return pref(Preferences::BrowserBackgroundColor);
 }
 
-void EntityBrowserView::renderBounds(Layout& layout, const float y, const float height)
+void EntityBrowserView::prepareThumbnails(
+  Layout& layout, const float y, const float height)
 {
-  using BoundsVertex = render::GLVertexTypes::P3C4::Vertex;
-  auto vertices = std::vector<BoundsVertex>{};
+  auto& entityModelManager = m_document.map().entityModelManager();
+  entityModelManager.prepare(vboManager());
 
-  for (const auto& group : layout.groups())
-  {
-    if (group.intersectsY(y, height))
+  auto viewport = std::array<GLint, 4>{};
+  glAssert(glGetIntegerv(GL_VIEWPORT, viewport.data()));
+
+  forEachVisibleCell(layout, y, height, [&](const Cell& cell) {
+    const auto& cellData = this->cellData(cell);
+    if (!cellData.thumbnailKey)
     {
-      for (const auto& row : group.rows())
+      return;
+    }
+
+    if (const auto* thumbnail = this->thumbnail(cell))
+    {
+      m_thumbnailAtlas->useSlot(thumbnail->slot);
+    }
+    else if (!loadThumbnail(*cellData.thumbnailKey))
+    {
+      // the model is only loaded if there is no cached thumbnail
+      auto* modelRenderer = this->modelRenderer(cell);
+      if (modelRenderer && entityModelManager.isPrepared(*modelRenderer))
       {
-        if (row.intersectsY(y, height))
-        {
-          for (const auto& cell : row.cells())
-          {
-            const auto& definition = cellData(cell).entityDefinition;
-            const auto& pointEntityDefinition = *definition.pointEntityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
-
-            if (modelRenderer == nullptr)
-            {
-              const auto itemTrans = itemTransformation(cell, y, height);
-              const auto& color = definition.color;
-              vm::bbox3f{pointEntityDefinition.bounds}.for_each_edge(
-                [&](const vm::vec3f& v1, const vm::vec3f& v2) {
-                  vertices.emplace_back(itemTrans * v1, color);
-                  vertices.emplace_back(itemTrans * v2, color);
-                });
-            }
-          }
-        }
+        renderThumbnail(cellData, *modelRenderer);
       }
     }
+  });
+
+  glAssert(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+
+  if (entityModelManager.hasUnpreparedRenderers())
+  {
+    invalidateFrame();
   }
+}
 
-  auto shader = render::ActiveShader{shaderManager(), render::Shaders::VaryingPCShader};
-  auto vertexArray = render::VertexArray::move(std::move(vertices));
+bool EntityBrowserView::loadThumbnail(const io::EntityThumbnailCacheKey& key)
+{
+  const auto* thumbnailCache = m_document.entityThumbnailCache();
+  if (!thumbnailCache || m_uncachedThumbnails.contains(key))
+  {
+    return false;
+  }
 
-  vertexArray.prepare(vboManager());
-  vertexArray.render(render::PrimType::Lines);
+  const auto thumbnail = thumbnailCache->load(key);
+  if (
+    !thumbnail || thumbnail->width == 0 || thumbnail->height == 0
+    || thumbnail->width > size_t(ThumbnailSize)
+    || thumbnail->height > size_t(ThumbnailSize))
+  {
+    // don't look for the thumbnail again until it was rendered
+    m_uncachedThumbnails.insert(key);
+    return false;
+  }
+
+  const auto width = GLsizei(thumbnail->width);
+  const auto height = GLsizei(thumbnail->height);
+  const auto slot = allocateThumbnailSlot(key, float(width), float(height));
+  m_thumbnailAtlas->upload(slot, width, height, thumbnail->pixels.data());
+  return true;
 }
 
-void EntityBrowserView::renderModels(
-  Layout& layout,
-  const float y,
-  const float height,
-  render::Transformation& transformation)
+void EntityBrowserView::renderThumbnail(
+  const EntityCellData& cellData, EntityRenderer& modelRenderer)
 {
+  assert(cellData.thumbnailKey);
+
+  // scale the model so that it fills the thumbnail in its larger dimension
+  const auto thumbnailSize = static_cast<float>(ThumbnailSize);
+  const auto rotatedBoundsSize = cellData.bounds.transform(cellData.transform).size();
+  const auto scale =
+    thumbnailSize / std::max({rotatedBoundsSize.y(), rotatedBoundsSize.z(), 1.0f});
+  const auto width = std::clamp(
+    GLsizei(std::ceil(rotatedBoundsSize.y() * scale)), GLsizei(1), ThumbnailSize);
+  const auto height = std::clamp(
+    GLsizei(std::ceil(rotatedBoundsSize.z() * scale)), GLsizei(1), ThumbnailSize);
+
+  if (!m_thumbnailAtlas->beginRender())
+  {
+    return;
+  }
+
+  glAssert(glViewport(0, 0, ThumbnailSize, ThumbnailSize));
   glAssert(glFrontFace(GL_CW));
 
-  auto& map = m_document.map();
-  auto& entityModelManager = map.entityModelManager();
-  entityModelManager.prepare(vboManager());
+  const auto projection =
+    vm::ortho_matrix(-1024.0f, 1024.0f, 0.0f, thumbnailSize, thumbnailSize, 0.0f);
+  const auto view =
+    vm::view_matrix(CameraDirection, CameraUp) * vm::translation_matrix(CameraPosition);
+  auto transformation = render::Transformation{projection, view};
 
-  auto shader = render::ActiveShader{shaderManager(), render::Shaders::EntityModelShader};
-  shader.set("ApplyTinting", false);
-  shader.set("Brightness", pref(Preferences::Brightness));
-  shader.set("GrayScale", false);
+  {
+    auto shader =
+      render::ActiveShader{shaderManager(), render::Shaders::EntityModelShader};
+    shader.set("ApplyTinting", false);
+    // the brightness is applied when the thumbnail is displayed
+    shader.set("Brightness", 1.0f);
+    shader.set("GrayScale", false);
+
+    shader.set("CameraPosition", CameraPosition);
+    shader.set("CameraDirection", CameraDirection);
+    shader.set("CameraRight", vm::cross(CameraDirection, CameraUp));
+    shader.set("CameraUp", CameraUp);
+    shader.set("ViewMatrix", transformation.viewMatrix());
+    shader.set("Orientation", static_cast<int>(cellData.modelOrientation));
+
+    const auto modelMatrix = cellTransformation(cellData, vm::vec3f{0, 0, 0}, scale);
+    shader.set("ModelMatrix", modelMatrix);
+
+    const auto multMatrix = render::MultiplyModelMatrix{transformation, modelMatrix};
+    auto renderFunc = render::DefaultMaterialRenderFunc{
+      pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
+    modelRenderer.render(renderFunc);
+  }
 
-  shader.set("CameraPosition", CameraPosition);
-  shader.set("CameraDirection", CameraDirection);
-  shader.set("CameraRight", vm::cross(CameraDirection, CameraUp));
-  shader.set("CameraUp", CameraUp);
-  shader.set("ViewMatrix", transformation.viewMatrix());
+  const auto& key = *cellData.thumbnailKey;
+  const auto slot = allocateThumbnailSlot(key, float(width), float(height));
+  auto pixels = m_thumbnailAtlas->endRender(slot, width, height);
 
-  for (const auto& group : layout.groups())
+  if (const auto* thumbnailCache = m_document.entityThumbnailCache())
   {
-    if (group.intersectsY(y, height))
+    thumbnailCache->store(
+      key,
+      io::EntityThumbnail{
+        cellData.bounds,
+        cellData.modelOrientation,
+        size_t(width),
+        size_t(height),
+        std::move(pixels)})
+      | kdl::transform_error(
+        [&](const auto& e) { m_document.map().logger().debug() << e.msg; });
+  }
+  m_uncachedThumbnails.erase(key);
+}
+
+size_t EntityBrowserView::allocateThumbnailSlot(
+  const io::EntityThumbnailCacheKey& key, const float width, const float height)
+{
+  const auto slot = m_thumbnailAtlas->allocateSlot();
+  if (const auto& previousKey = m_slotThumbnails[slot])
+  {
+    m_thumbnails.erase(*previousKey);
+  }
+
+  m_slotThumbnails[slot] = key;
+  m_thumbnails.insert_or_assign(key, Thumbnail{slot, width, height});
+  return slot;
+}
+
+const EntityBrowserView::Thumbnail* EntityBrowserView::thumbnail(const Cell& cell) const
+{
+  const auto& thumbnailKey = cellData(cell).thumbnailKey;
+  if (thumbnailKey)
+  {
+    if (const auto it = m_thumbnails.find(*thumbnailKey); it != m_thumbnails.end())
     {
-      for (const auto& row : group.rows())
-      {
-        if (row.intersectsY(y, height))
-        {
-          for (const auto& cell : row.cells())
-          {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
-            {
-              shader.set(
-                "Orientation", static_cast<int>(cellData(cell).modelOrientation));
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
 
-              const auto itemTrans = itemTransformation(cell, y, height);
-              shader.set("ModelMatrix", itemTrans);
+void EntityBrowserView::renderBounds(Layout& layout, const float y, const float height)
+{
+  using BoundsVertex = render::GLVertexTypes::P3C4::Vertex;
+  auto vertices = std::vector<BoundsVertex>{};
 
-              const auto multMatrix =
-                render::MultiplyModelMatrix{transformation, itemTrans};
+  forEachVisibleCell(layout, y, height, [&](const Cell& cell) {
+    // render the bounds as a placeholder until the thumbnail is available
+    if (!thumbnail(cell))
+    {
+      const auto& definition = cellData(cell).entityDefinition;
+      const auto& pointEntityDefinition = *definition.pointEntityDefinition;
+
+      const auto itemTrans = itemTransformation(cell, y, height);
+      const auto& color = definition.color;
+      vm::bbox3f{pointEntityDefinition.bounds}.for_each_edge(
+        [&](const vm::vec3f& v1, const vm::vec3f& v2) {
+          vertices.emplace_back(itemTrans * v1, color);
+          vertices.emplace_back(itemTrans * v2, color);
+        });
+    }
+  });
 
-              auto renderFunc = render::DefaultMaterialRenderFunc{
-                pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
-              modelRenderer->render(renderFunc);
-            }
-          }
-        }
-      }
+  auto shader = render::ActiveShader{shaderManager(), render::Shaders::VaryingPCShader};
+  auto vertexArray = render::VertexArray::move(std::move(vertices));
+
+  vertexArray.prepare(vboManager());
+  vertexArray.render(render::PrimType::Lines);
+}
+
+void EntityBrowserView::renderThumbnails(
+  Layout& layout, const float y, const float height)
+{
+  using Vertex = render::GLVertexTypes::P3UV2::Vertex;
+  auto vertices = std::vector<Vertex>{};
+
+  forEachVisibleCell(layout, y, height, [&](const Cell& cell) {
+    if (const auto* thumbnail = this->thumbnail(cell))
+    {
+      // the view looks along the negative X axis, see itemTransformation
+      const auto& bounds = cell.itemBounds();
+      const auto left = bounds.left();
+      const auto right = bounds.right();
+      const auto top = height - (bounds.top() - y);
+      const auto bottom = height - (bounds.bottom() - y);
+
+      // the thumbnail's rows start at the bottom
+      const auto [minUV, maxUV] =
+        m_thumbnailAtlas->texCoords(thumbnail->slot, thumbnail->width, thumbnail->height);
+      vertices.push_back(Vertex{{0.0f, left, top}, {minUV.x(), maxUV.y()}});
+      vertices.push_back(Vertex{{0.0f, left, bottom}, minUV});
+      vertices.push_back(Vertex{{0.0f, right, bottom}, {maxUV.x(), minUV.y()}});
+      vertices.push_back(Vertex{{0.0f, right, top}, maxUV});
     }
+  });
+
+  if (!vertices.empty())
+  {
+    glAssert(glFrontFace(GL_CCW));
+
+    auto shader =
+      render::ActiveShader{shaderManager(), render::Shaders::MaterialBrowserShader};
+    shader.set("ApplyTinting", false);
+    shader.set("Material", 0);
+    shader.set("Brightness", pref(Preferences::Brightness));
+
+    auto vertexArray = render::VertexArray::move(std::move(vertices));
+    vertexArray.prepare(vboManager());
+
+    m_thumbnailAtlas->activate();
+    vertexArray.render(render::PrimType::Quads);
+    m_thumbnailAtlas->deactivate();
   }
 }
 
 vm::mat4x4f EntityBrowserView::itemTransformation(
   const Cell& cell, const float y, const float height) const
 {
-  const auto& cellData = this->cellData(cell);
-
   const auto offset =
     vm::vec3f{0.0f, cell.itemBounds().left(), height - (cell.itemBounds().bottom() - y)};
-  const auto scaling = cell.scale();
-  const auto& rotatedBounds = cellData.bounds.transform(cellData.transform);
-  const auto rotationOffset =
-    vm::vec3f{0.0f, -rotatedBounds.min.y(), -rotatedBounds.min.z()};
-
-  return vm::translation_matrix(offset) * vm::scaling_matrix(vm::vec3f::fill(scaling))
-         * vm::translation_matrix(rotationOffset) * cellData.transform;
+  return cellTransformation(cellData(cell), offset, cell.scale());
 }
 
 QString EntityBrowserView::tooltip(const Cell& cell)
@@ -434,6 +698,16 @@ QString EntityBrowserView::tooltip(const Cell& cell)
   return QString::fromStdString(cellData(cell).entityDefinition.name);
 }
 
+EntityBrowserView::EntityRenderer* EntityBrowserView::modelRenderer(
+  const Cell& cell) const
+{
+  // renderers are looked up when they are needed because unused models may be evicted
+  const auto& modelSpecification = cellData(cell).modelSpecification;
+  return modelSpecification
+           ? m_document.map().entityModelManager().renderer(*modelSpecification)
+           : nullptr;
+}
+
 const EntityCellData& EntityBrowserView::cellData(const Cell& cell) const
 {
   return cell.itemAs<EntityCellData>();
@@ -21,6 +21,8 @@
 
 #include "NotifierConnection.h"
 #include "el/Expression.h"
+#include "io/EntityThumbnailCache.h"
+#include "mdl/ModelSpecification.h"
 #include "render/FontDescriptor.h"
 #include "render/GLVertexType.h"
 #include "ui/CellView.h"
@@ -28,8 +30,11 @@
 #include "vm/bbox.h"
 #include "vm/quat.h" // IWYU pragma: keep
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb
@@ -49,7 +54,7 @@ namespace tb::render
 {
 class FontDescriptor;
 class MaterialRenderer;
-class Transformation;
+class ThumbnailAtlas;
 } // namespace tb::render
 
 namespace tb::ui
@@ -60,14 +65,14 @@ using EntityGroupData = std::string;
 
 struct EntityCellData
 {
-  using EntityRenderer = render::MaterialRenderer;
   const mdl::EntityDefinition& entityDefinition;
-  EntityRenderer* modelRenderer;
+  std::optional<mdl::ModelSpecification> modelSpecification;
   mdl::Orientation modelOrientation;
   render::FontDescriptor fontDescriptor;
   vm::bbox3f bounds;
   vm::mat4x4f transform;
   vm::vec3f modelScale;
+  std::optional<io::EntityThumbnailCacheKey> thumbnailKey;
 };
 
 class EntityBrowserView : public CellView
@@ -92,6 +97,33 @@ private:
   mdl::EntityDefinitionSortOrder m_sortOrder;
   std::string m_filterText;
 
+  static constexpr auto ThumbnailSize = 192;
+  static constexpr auto ThumbnailsPerRow = 12;
+
+  struct CachedModel
+  {
+    vm::bbox3f bounds;
+    mdl::Orientation orientation;
+    uint64_t sourceSize = 0;
+    uint64_t sourceHash = 0;
+  };
+
+  // last known model bounds so that reloading the layout doesn't load evicted models
+  std::unordered_map<mdl::ModelSpecification, CachedModel> m_cachedModels;
+
+  struct Thumbnail
+  {
+    size_t slot;
+    float width;
+    float height;
+  };
+
+  // models are rendered once into the atlas, and the cells display the atlas contents
+  std::unique_ptr<render::ThumbnailAtlas> m_thumbnailAtlas;
+  std::unordered_map<io::EntityThumbnailCacheKey, Thumbnail> m_thumbnails;
+  std::vector<std::optional<io::EntityThumbnailCacheKey>> m_slotThumbnails;
+  std::unordered_set<io::EntityThumbnailCacheKey> m_uncachedThumbnails;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -125,19 +157,26 @@ private:
     Layout& layout,
     const mdl::EntityDefinition& definition,
     const render::FontDescriptor& font);
+  std::optional<CachedModel> loadCachedModel(
+    const mdl::ModelSpecification& spec, const vm::vec3f& modelScale);
 
   void doClear() override;
   void doRender(Layout& layout, float y, float height) override;
   bool shouldRenderFocusIndicator() const override;
   const Color& getBackgroundColor() override;
 
-  void renderBounds(Layout& layout, float y, float height);
+  void prepareThumbnails(Layout& layout, float y, float height);
+  bool loadThumbnail(const io::EntityThumbnailCacheKey& key);
+  void renderThumbnail(const EntityCellData& cellData, EntityRenderer& modelRenderer);
+  size_t allocateThumbnailSlot(
+    const io::EntityThumbnailCacheKey& key, float width, float height);
+  const Thumbnail* thumbnail(const Cell& cell) const;
 
-  class MeshFunc;
-  void renderModels(
-    Layout& layout, float y, float height, render::Transformation& transformation);
+  void renderBounds(Layout& layout, float y, float height);
+  void renderThumbnails(Layout& layout, float y, float height);
 
   vm::mat4x4f itemTransformation(const Cell& cell, float y, float height) const;
+  EntityRenderer* modelRenderer(const Cell& cell) const;
 
   QString tooltip(const Cell& cell) override;
 
@@ -62,8 +62,8 @@ void EntityPropertyEditor::connectObservers()
   auto& map = m_document.map();
   m_notifierConnection += map.selectionDidChangeNotifier.connect(
     this, &EntityPropertyEditor::selectionDidChange);
-  m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &EntityPropertyEditor::nodesDidChange);
+  m_notifierConnection += map.nodesDidChangeBatchedNotifier.connect(
+    this, &EntityPropertyEditor::nodesDidChange);
 }
 
 void EntityPropertyEditor::selectionDidChange(const mdl::SelectionChange&)
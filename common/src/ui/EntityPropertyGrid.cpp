@@ -204,21 +204,33 @@ std::vector<int> EntityPropertyGrid::selectedRowsAndCursorRow() const
   return result.release_data();
 }
 
+namespace
+{
+/**
+ * The number of rows that are measured when fitting a column to its contents.
+ */
+constexpr auto ResizeContentsPrecision = 256;
+} // namespace
+
 class EntitySortFilterProxyModel : public QSortFilterProxyModel
 {
 public:
-  explicit EntitySortFilterProxyModel(QObject* parent = nullptr)
+  explicit EntitySortFilterProxyModel(
+    const EntityPropertyModel& source, QObject* parent = nullptr)
     : QSortFilterProxyModel{parent}
+    , m_source{source}
   {
   }
 
 protected:
   bool lessThan(const QModelIndex& left, const QModelIndex& right) const override
   {
-    const auto& source = dynamic_cast<const EntityPropertyModel&>(*sourceModel());
-    return source.lessThan(
+    return m_source.lessThan(
       static_cast<size_t>(left.row()), static_cast<size_t>(right.row()));
   }
+
+private:
+  const EntityPropertyModel& m_source;
 };
 
 void EntityPropertyGrid::createGui(MapDocument& document)
@@ -231,7 +243,7 @@ void EntityPropertyGrid::createGui(MapDocument& document)
   // FIXME: why? this looks unnecessary
   m_model->setParent(m_table);
 
-  m_proxyModel = new EntitySortFilterProxyModel{this};
+  m_proxyModel = new EntitySortFilterProxyModel{*m_model, this};
   m_proxyModel->setSourceModel(m_model);
 
   // NOTE: must be column 0, because EntitySortFilterProxymdl::lessThan ignores the
@@ -242,7 +254,13 @@ void EntityPropertyGrid::createGui(MapDocument& document)
   m_table->setItemDelegate(
     new EntityPropertyItemDelegate{m_table, m_model, m_proxyModel, m_table});
 
-  autoResizeRows(m_table);
+  // Entities can have thousands of properties. Every row shows a single line of text, so
+  // the rows get a fixed height and only the visible rows are ever formatted, and only a
+  // limited number of rows is measured to fit the columns to their contents.
+  m_table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_table->verticalHeader()->setDefaultSectionSize(
+    m_table->verticalHeader()->minimumSectionSize());
+  m_table->horizontalHeader()->setResizeContentsPrecision(ResizeContentsPrecision);
 
   m_table->verticalHeader()->setVisible(false);
   m_table->horizontalHeader()->setSectionResizeMode(
@@ -386,7 +404,7 @@ void EntityPropertyGrid::connectObservers()
   m_notifierConnection +=
     map.mapWasLoadedNotifier.connect(this, &EntityPropertyGrid::mapWasLoaded);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
   m_notifierConnection += map.selectionWillChangeNotifier.connect(
     this, &EntityPropertyGrid::selectionWillChange);
   m_notifierConnection +=
@@ -47,12 +47,16 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/string_utils.h"
 #include "kdl/vector_set.h"
+#include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define MODEL_LOG(x)
@@ -406,6 +410,17 @@ static auto makeKeyToPropertyRowMap(const std::vector<PropertyRow>& rows)
   return result;
 }
 
+static auto makeKeyToRowIndexMap(const std::vector<PropertyRow>& rows)
+{
+  auto result = std::unordered_map<std::string, size_t>{};
+  result.reserve(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    result.emplace(rows[i].key(), i);
+  }
+  return result;
+}
+
 struct KeyDiff
 {
   std::vector<std::string> removed;
@@ -465,6 +480,7 @@ void EntityPropertyModel::setShowDefaultRows(const bool showDefaultRows)
     return;
   }
   m_showDefaultRows = showDefaultRows;
+  m_mergedRevision = std::nullopt;
   updateFromMapDocument();
 }
 
@@ -515,6 +531,10 @@ void EntityPropertyModel::setRows(const std::map<std::string, PropertyRow>& newR
     return;
   }
 
+  // Entities can have thousands of properties, so the rows are looked up by their key
+  // instead of searching for them
+  const auto rowIndexByKey = makeKeyToRowIndexMap(m_rows);
+
   // Handle edited rows
 
   MODEL_LOG(
@@ -522,19 +542,18 @@ void EntityPropertyModel::setRows(const std::map<std::string, PropertyRow>& newR
              << " common keys");
   for (const auto& key : diff.updated)
   {
-    const auto& oldRow = oldRowMap.at(key);
     const auto& newRow = newRowMap.at(key);
-    const auto oldIndex = kdl::index_of(m_rows, oldRow);
+    const auto oldIndex = rowIndexByKey.at(key);
 
     MODEL_LOG(
-      qDebug() << "   updating row " << *oldIndex << "(" << QString::fromStdString(key)
+      qDebug() << "   updating row " << oldIndex << "(" << QString::fromStdString(key)
                << ")");
 
-    m_rows.at(*oldIndex) = newRow;
+    m_rows.at(oldIndex) = newRow;
 
     // Notify Qt
-    const auto topLeft = index(static_cast<int>(*oldIndex), 0);
-    const auto bottomRight = index(static_cast<int>(*oldIndex), NumColumns - 1);
+    const auto topLeft = index(static_cast<int>(oldIndex), 0);
+    const auto bottomRight = index(static_cast<int>(oldIndex), NumColumns - 1);
     emit dataChanged(topLeft, bottomRight);
   }
 
@@ -565,14 +584,25 @@ void EntityPropertyModel::setRows(const std::map<std::string, PropertyRow>& newR
       qDebug() << "EntityPropertyModel::setRows: deleting " << diff.removed.size()
                << " rows");
 
-    for (const auto& key : diff.removed)
+    auto removedIndices = kdl::vec_transform(
+      diff.removed, [&](const auto& key) { return rowIndexByKey.at(key); });
+    std::ranges::sort(removedIndices, std::greater{});
+
+    // remove contiguous ranges of rows back to front so that the remaining indices stay
+    // valid
+    for (auto it = removedIndices.begin(); it != removedIndices.end();)
     {
-      const auto& row = oldRowMap.at(key);
-      const auto index = kdl::index_of(m_rows, row);
-      assert(index);
+      const auto last = *it;
+      auto first = last;
+      for (++it; it != removedIndices.end() && *it == first - 1; ++it)
+      {
+        first = *it;
+      }
 
-      beginRemoveRows(QModelIndex{}, static_cast<int>(*index), static_cast<int>(*index));
-      m_rows.erase(std::next(m_rows.begin(), static_cast<int>(*index)));
+      beginRemoveRows(QModelIndex{}, static_cast<int>(first), static_cast<int>(last));
+      m_rows.erase(
+        std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(first)),
+        std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(last + 1)));
       endRemoveRows();
     }
   }
@@ -721,15 +751,107 @@ static bool computeShouldShowProtectedProperties(
   });
 }
 
+bool EntityPropertyModel::canMergeIncrementally(
+  const std::vector<mdl::EntityNodeBase*>& nodes) const
+{
+  // The rows take their default values and tooltips from the first node, so it must not
+  // change. Merging is not reversible, so no merged node may have been deselected.
+  if (
+    m_mergedRevision != m_document.map().revision() || m_mergedNodes.empty()
+    || nodes.empty() || m_mergedNodes.front() != nodes.front())
+  {
+    return false;
+  }
+
+  const auto selectedNodes = kdl::vector_set<mdl::EntityNodeBase*>(nodes);
+  return kdl::all_of(
+    m_mergedNodes, [&](auto* node) { return selectedNodes.count(node) > 0; });
+}
+
+void EntityPropertyModel::mergeNode(mdl::EntityNodeBase* node)
+{
+  const auto keys = allKeys({node}, m_showDefaultRows, true);
+
+  if (m_mergedNodes.empty())
+  {
+    for (const auto& key : keys)
+    {
+      m_mergedRows[key] = PropertyRow{key, node};
+    }
+  }
+  else
+  {
+    for (auto& [key, row] : m_mergedRows)
+    {
+      row.merge(node);
+    }
+
+    for (const auto& key : keys)
+    {
+      if (!m_mergedRows.contains(key))
+      {
+        // the key is new, so the row must be merged from all nodes
+        auto row = rowForEntityNodes(key, m_mergedNodes);
+        row.merge(node);
+        m_mergedRows[key] = std::move(row);
+      }
+    }
+  }
+
+  m_mergedNodes.push_back(node);
+}
+
+void EntityPropertyModel::mergePendingNodes()
+{
+  const auto count = std::min(m_pendingNodes.size(), MergeBatchSize);
+  for (size_t i = 0; i < count; ++i)
+  {
+    mergeNode(m_pendingNodes[i]);
+  }
+  m_pendingNodes.erase(
+    m_pendingNodes.begin(), std::next(m_pendingNodes.begin(), std::ptrdiff_t(count)));
+
+  setRows(m_mergedRows);
+
+  if (!m_pendingNodes.empty() && !m_mergeScheduled)
+  {
+    m_mergeScheduled = true;
+    QTimer::singleShot(0, this, [&]() {
+      m_mergeScheduled = false;
+      if (m_mergedRevision == m_document.map().revision())
+      {
+        mergePendingNodes();
+      }
+      else
+      {
+        updateFromMapDocument();
+      }
+    });
+  }
+}
+
 void EntityPropertyModel::updateFromMapDocument()
 {
   MODEL_LOG(qDebug() << "updateFromMapDocument");
 
   const auto& map = m_document.map();
   const auto entityNodes = map.selection().allEntities();
-  const auto rowsMap = rowsForEntityNodes(entityNodes, m_showDefaultRows, true);
 
-  setRows(rowsMap);
+  if (canMergeIncrementally(entityNodes))
+  {
+    const auto mergedNodes = kdl::vector_set<mdl::EntityNodeBase*>(m_mergedNodes);
+    m_pendingNodes = kdl::vec_filter(
+      entityNodes, [&](auto* node) { return mergedNodes.count(node) == 0; });
+  }
+  else
+  {
+    m_mergedRows.clear();
+    m_mergedNodes.clear();
+    m_pendingNodes = entityNodes;
+    m_mergedRevision = map.revision();
+  }
+
+  mergePendingNodes();
   m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(entityNodes);
 }
 
@@ -25,6 +25,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -134,6 +135,12 @@ public:
  *
  * The order of m_rows is not significant; it's expected that there is a sort proxy model
  * used on top of this model.
+ *
+ * The rows are merged from the selected entities incrementally. If entities are added to
+ * the selection and the map wasn't modified otherwise, only the added entities are merged
+ * into the existing rows. At most MergeBatchSize entities are merged synchronously, and
+ * the remaining entities are merged in later event loop iterations, so that selecting
+ * many entities doesn't block the UI.
  */
 class EntityPropertyModel : public QAbstractTableModel
 {
@@ -144,12 +151,20 @@ public:
   static const int ColumnValue = 2;
   static const int NumColumns = 3;
 
+  static constexpr size_t MergeBatchSize = 256;
+
 private:
   std::vector<PropertyRow> m_rows;
   bool m_showDefaultRows;
   bool m_shouldShowProtectedProperties;
   MapDocument& m_document;
 
+  std::map<std::string, PropertyRow> m_mergedRows;
+  std::vector<mdl::EntityNodeBase*> m_mergedNodes;
+  std::vector<mdl::EntityNodeBase*> m_pendingNodes;
+  std::optional<size_t> m_mergedRevision;
+  bool m_mergeScheduled = false;
+
 public:
   explicit EntityPropertyModel(MapDocument& document, QObject* parent);
 
@@ -166,6 +181,11 @@ public:
 public: // for autocompletion
   QStringList getCompletions(const QModelIndex& index) const;
 
+private: // incremental row merging
+  bool canMergeIncrementally(const std::vector<mdl::EntityNodeBase*>& nodes) const;
+  void mergeNode(mdl::EntityNodeBase* node);
+  void mergePendingNodes();
+
 private: // autocompletion helpers
   std::vector<std::string> propertyKeys(int row, int count) const;
   std::vector<std::string> getAllPropertyKeys() const;
@@ -569,13 +569,15 @@ void FaceAttribsEditor::connectObservers()
   m_notifierConnection +=
     map.mapWasLoadedNotifier.connect(this, &FaceAttribsEditor::mapWasLoaded);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &FaceAttribsEditor::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &FaceAttribsEditor::nodesDidChange);
   m_notifierConnection += map.brushFacesDidChangeNotifier.connect(
     this, &FaceAttribsEditor::brushFacesDidChange);
   m_notifierConnection +=
     map.selectionDidChangeNotifier.connect(this, &FaceAttribsEditor::selectionDidChange);
   m_notifierConnection += map.materialCollectionsDidChangeNotifier.connect(
     this, &FaceAttribsEditor::materialCollectionsDidChange);
+  m_notifierConnection += map.modsDidChangeNotifier.connect(
+    this, &FaceAttribsEditor::materialCollectionsDidChange);
   m_notifierConnection +=
     map.grid().gridDidChangeNotifier.connect(this, &FaceAttribsEditor::updateIncrements);
 }
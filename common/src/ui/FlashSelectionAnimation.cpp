@@ -19,17 +19,16 @@
 
 #include "FlashSelectionAnimation.h"
 
-#include <QWidget>
-
 #include "Color.h"
 #include "render/MapRenderer.h"
+#include "ui/RenderView.h"
 
 namespace tb::ui
 {
 const Animation::Type FlashSelectionAnimation::AnimationType = Animation::freeType();
 
 FlashSelectionAnimation::FlashSelectionAnimation(
-  render::MapRenderer& renderer, QWidget* view, const double duration)
+  render::MapRenderer& renderer, RenderView* view, const double duration)
   : Animation{AnimationType, Curve::EaseInEaseOut, duration}
   , m_renderer{renderer}
   , m_view{view}
@@ -53,7 +52,7 @@ void FlashSelectionAnimation::doUpdate(const double progress)
     m_renderer.restoreSelectionColors();
   }
 
-  m_view->update();
+  m_view->invalidateFrame();
 }
 
 } // namespace tb::ui
@@ -21,8 +21,6 @@
 
 #include "ui/Animation.h"
 
-class QWidget;
-
 namespace tb::render
 {
 class MapRenderer;
@@ -30,16 +28,19 @@ class MapRenderer;
 
 namespace tb::ui
 {
+class RenderView;
+
 class FlashSelectionAnimation : public Animation
 {
 private:
   static const Type AnimationType;
 
   render::MapRenderer& m_renderer;
-  QWidget* m_view;
+  RenderView* m_view;
 
 public:
-  FlashSelectionAnimation(render::MapRenderer& renderer, QWidget* view, double duration);
+  FlashSelectionAnimation(
+    render::MapRenderer& renderer, RenderView* view, double duration);
 
 private:
   void doUpdate(double progress) override;
@@ -21,9 +21,23 @@
 
 #include <QApplication>
 
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "io/AssimpModelCache.h"
+#include "io/EntityThumbnailCache.h"
+#include "io/MaterialCache.h"
+#include "io/SystemPaths.h"
+#include "mdl/EntityModelManager.h"
+#include "mdl/Map.h"
+#include "mdl/Resource.h"
+#include "ui/GLContextManager.h"
 #include "ui/MapDocument.h"
 #include "ui/MapFrame.h"
 
+// included after glew, see RenderView.cpp
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+
 #include <cassert>
 #include <memory>
 
@@ -32,11 +46,47 @@ namespace tb::ui
 
 FrameManager::FrameManager(const bool singleFrame)
   : m_singleFrame{singleFrame}
+  , m_materialCache{std::make_shared<io::MaterialCache>(
+      io::SystemPaths::userDataDirectory() / "material-cache",
+      pref(Preferences::CompressTextures))}
+  , m_assimpModelCache{std::make_shared<io::AssimpModelCache>(
+      io::SystemPaths::userDataDirectory() / "model-cache")}
+  , m_entityThumbnailCache{std::make_shared<io::EntityThumbnailCache>(
+      io::SystemPaths::userDataDirectory() / "thumbnail-cache")}
+  , m_contextManager{std::make_unique<GLContextManager>()}
 {
   connect(qApp, &QApplication::focusChanged, this, &FrameManager::onFocusChange);
 }
 
-FrameManager::~FrameManager() = default;
+FrameManager::~FrameManager()
+{
+  // All frames and their views are closed by now, so a context of the share group must be
+  // made current while the shared OpenGL resources are released.
+  auto* shareContext = QOpenGLContext::globalShareContext();
+  if (!m_contextManager->initialized() || !shareContext)
+  {
+    return;
+  }
+
+  auto surface = QOffscreenSurface{};
+  surface.setFormat(shareContext->format());
+  surface.create();
+
+  auto context = QOpenGLContext{};
+  context.setFormat(shareContext->format());
+  context.setShareContext(shareContext);
+  if (context.create() && context.makeCurrent(&surface))
+  {
+    m_contextManager.reset();
+    context.doneCurrent();
+  }
+  else
+  {
+    // Releasing the resources without a current context is undefined, so leave them to
+    // be released together with the share group.
+    [[maybe_unused]] auto* contextManager = m_contextManager.release();
+  }
+}
 
 MapFrame* FrameManager::newFrame(kdl::task_manager& taskManager)
 {
@@ -72,6 +122,11 @@ bool FrameManager::allFramesClosed() const
   return m_frames.empty();
 }
 
+GLContextManager& FrameManager::contextManager()
+{
+  return *m_contextManager;
+}
+
 void FrameManager::onFocusChange(QWidget* /* old */, QWidget* now)
 {
   if (now)
@@ -97,6 +152,12 @@ MapFrame* FrameManager::createOrReuseFrame(kdl::task_manager& taskManager)
   if (!m_singleFrame || m_frames.empty())
   {
     auto document = std::make_unique<MapDocument>(taskManager);
+    document->map().setMaterialCache(m_materialCache);
+    document->map().entityModelManager().setAssimpModelCache(m_assimpModelCache);
+    document->setEntityThumbnailCache(m_entityThumbnailCache);
+    document->map().setMaterialLoadMode(
+      pref(Preferences::LazyMaterialLoading) ? mdl::ResourceLoadMode::Lazy
+                                             : mdl::ResourceLoadMode::Eager);
     createFrame(std::move(document));
   }
   return topFrame();
@@ -29,8 +29,16 @@ namespace kdl
 class task_manager;
 }
 
+namespace tb::io
+{
+class AssimpModelCache;
+class EntityThumbnailCache;
+class MaterialCache;
+} // namespace tb::io
+
 namespace tb::ui
 {
+class GLContextManager;
 class MapDocument;
 class MapFrame;
 
@@ -40,6 +48,15 @@ class FrameManager : public QObject
 private:
   bool m_singleFrame;
   std::vector<MapFrame*> m_frames;
+  std::shared_ptr<const io::MaterialCache> m_materialCache;
+  std::shared_ptr<const io::AssimpModelCache> m_assimpModelCache;
+  std::shared_ptr<const io::EntityThumbnailCache> m_entityThumbnailCache;
+
+  /**
+   * All OpenGL contexts of the application are in one share group, so the shader
+   * programs, fonts and VBOs are created once and used by the views of all frames.
+   */
+  std::unique_ptr<GLContextManager> m_contextManager;
 
 public:
   explicit FrameManager(bool singleFrame);
@@ -52,6 +69,8 @@ public:
   MapFrame* topFrame() const;
   bool allFramesClosed() const;
 
+  GLContextManager& contextManager();
+
 private:
   void onFocusChange(QWidget* old, QWidget* now);
   MapFrame* createOrReuseFrame(kdl::task_manager& taskManager);
@@ -20,6 +20,7 @@
 #include "GLContextManager.h"
 
 #include "Exceptions.h"
+#include "io/SystemPaths.h"
 #include "render/FontManager.h"
 #include "render/GL.h"
 #include "render/ShaderManager.h"
@@ -42,9 +43,11 @@ std::string GLContextManager::GLRenderer = "unknown";
 std::string GLContextManager::GLVersion = "unknown";
 
 GLContextManager::GLContextManager()
-  : m_shaderManager{std::make_unique<render::ShaderManager>()}
+  : m_shaderManager{std::make_unique<render::ShaderManager>(
+      io::SystemPaths::userDataDirectory() / "ShaderCache")}
   , m_vboManager{std::make_unique<render::VboManager>(*m_shaderManager)}
-  , m_fontManager{std::make_unique<render::FontManager>()}
+  , m_fontManager{std::make_unique<render::FontManager>(
+      io::SystemPaths::userDataDirectory() / "FontCache")}
 {
 }
 
@@ -95,6 +98,7 @@ bool GLContextManager::initialize()
       MaterialBrowserBorderShader,
       HandleShader,
       ColoredHandleShader,
+      PointHandleShader,
       CompassShader,
       CompassOutlineShader,
       CompassBackgroundShader,
@@ -21,7 +21,6 @@
 
 #include "Ensure.h"
 #include "io/ResourceUtils.h"
-#include "mdl/GameConfig.h"
 #include "mdl/GameFactory.h"
 
 #include <filesystem>
@@ -96,7 +95,7 @@ GameListBox::Info GameListBox::makeGameInfo(const std::string& gameName) const
   {
     iconPath = std::filesystem::path{"DefaultGameIcon.svg"};
   }
-  const auto experimental = gameFactory.gameConfig(gameName).experimental;
+  const auto experimental = gameFactory.experimental(gameName);
 
   return Info{
     gameName,
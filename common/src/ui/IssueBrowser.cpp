@@ -60,6 +60,13 @@ QWidget* IssueBrowser::createTabBarPage(QWidget* parent)
     this,
     &IssueBrowser::showHiddenIssuesChanged);
 
+  m_groupByTypeCheckBox = new QCheckBox{"Group by type"};
+  connect(
+    m_groupByTypeCheckBox,
+    &QCheckBox::checkStateChanged,
+    this,
+    &IssueBrowser::groupByTypeChanged);
+
   m_filterEditor = new FlagsPopupEditor{1, "Filter", false};
   connect(
     m_filterEditor, &FlagsPopupEditor::flagChanged, this, &IssueBrowser::filterChanged);
@@ -67,6 +74,7 @@ QWidget* IssueBrowser::createTabBarPage(QWidget* parent)
   auto* barPageSizer = new QHBoxLayout{};
   barPageSizer->setContentsMargins(0, 0, 0, 0);
   barPageSizer->addWidget(m_showHiddenIssuesCheckBox, 0, Qt::AlignVCenter);
+  barPageSizer->addWidget(m_groupByTypeCheckBox, 0, Qt::AlignVCenter);
   barPageSizer->addWidget(m_filterEditor, 0, Qt::AlignVCenter);
   barPage->setLayout(barPageSizer);
 
@@ -87,7 +95,7 @@ void IssueBrowser::connectObservers()
   m_notifierConnection +=
     map.nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &IssueBrowser::nodesDidChange);
   m_notifierConnection +=
     map.brushFacesDidChangeNotifier.connect(this, &IssueBrowser::brushFacesDidChange);
 }
@@ -163,6 +171,11 @@ void IssueBrowser::showHiddenIssuesChanged()
   m_view->setShowHiddenIssues(m_showHiddenIssuesCheckBox->isChecked());
 }
 
+void IssueBrowser::groupByTypeChanged()
+{
+  m_view->setGroupByType(m_groupByTypeCheckBox->isChecked());
+}
+
 void IssueBrowser::filterChanged(
   const size_t /* index */,
   const int /* value */,
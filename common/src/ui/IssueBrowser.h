@@ -54,6 +54,7 @@ private:
   MapDocument& m_document;
   IssueBrowserView* m_view = nullptr;
   QCheckBox* m_showHiddenIssuesCheckBox = nullptr;
+  QCheckBox* m_groupByTypeCheckBox = nullptr;
   FlagsPopupEditor* m_filterEditor = nullptr;
 
   NotifierConnection m_notifierConnection;
@@ -79,6 +80,7 @@ private:
   void updateFilterFlags();
 
   void showHiddenIssuesChanged();
+  void groupByTypeChanged();
   void filterChanged(size_t index, int value, int setFlag, int mixedFlag);
 };
 
@@ -25,39 +25,48 @@
 #include <QMenu>
 #include <QTableView>
 
-#include "mdl/BrushNode.h"
-#include "mdl/EntityNode.h"
-#include "mdl/GroupNode.h"
+#include "Trace.h"
 #include "mdl/Issue.h"
+#include "mdl/IssueCache.h"
 #include "mdl/IssueQuickFix.h"
-#include "mdl/LayerNode.h"
 #include "mdl/Map.h"
 #include "mdl/Map_Selection.h"
-#include "mdl/PatchNode.h"
 #include "mdl/Transaction.h"
+#include "mdl/Validator.h"
 #include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
-#include "ui/QtUtils.h"
 
-#include "kdl/overload.h"
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <vector>
 
 namespace tb::ui
 {
+namespace
+{
+
+/**
+ * The number of rows that the model exposes to the view at once.
+ */
+constexpr auto FetchRowCount = size_t(1000);
+
+} // namespace
 
 IssueBrowserView::IssueBrowserView(MapDocument& document, QWidget* parent)
   : QWidget{parent}
   , m_document{document}
+  , m_issueCache{std::make_unique<mdl::IssueCache>(m_document.map())}
 {
   createGui();
   bindEvents();
 }
 
+IssueBrowserView::~IssueBrowserView() = default;
+
 void IssueBrowserView::createGui()
 {
   m_tableModel = new IssueBrowserModel{this};
@@ -70,7 +79,10 @@ void IssueBrowserView::createGui()
   m_tableView->horizontalHeader()->setSectionsClickable(false);
   m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
 
-  autoResizeRows(m_tableView);
+  // resizing the rows to their contents would require formatting every row
+  m_tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_tableView->verticalHeader()->setDefaultSectionSize(
+    m_tableView->fontMetrics().height() + 4);
 
   auto* layout = new QHBoxLayout{};
   layout->setContentsMargins(0, 0, 0, 0);
@@ -88,14 +100,20 @@ void IssueBrowserView::setHiddenIssueTypes(const int hiddenIssueTypes)
   if (hiddenIssueTypes != m_hiddenIssueTypes)
   {
     m_hiddenIssueTypes = hiddenIssueTypes;
-    invalidate();
+    updateModel();
   }
 }
 
 void IssueBrowserView::setShowHiddenIssues(const bool show)
 {
   m_showHiddenIssues = show;
-  invalidate();
+  updateModel();
+}
+
+void IssueBrowserView::setGroupByType(const bool groupByType)
+{
+  m_groupByType = groupByType;
+  updateModel();
 }
 
 void IssueBrowserView::reload()
@@ -131,49 +149,59 @@ void IssueBrowserView::updateSelection()
 
 void IssueBrowserView::updateIssues()
 {
-  const auto& map = m_document.map();
-  if (auto* worldNode = map.world())
+  TB_TRACE_SCOPE("IssueBrowserView::updateIssues");
+
+  m_issues = m_issueCache->issues();
+  m_valid = true;
+  updateModel();
+}
+
+/**
+ * Filters and groups the issues without revalidating the map.
+ */
+void IssueBrowserView::updateModel()
+{
+  if (!m_valid)
   {
-    const auto validators = worldNode->registeredValidators();
+    return;
+  }
 
-    auto issues = std::vector<const mdl::Issue*>{};
-    const auto collectIssues = [&](auto* node) {
-      for (auto* issue : node->issues(validators))
-      {
-        if (
-          m_showHiddenIssues
-          || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-        {
-          issues.push_back(issue);
-        }
-      }
-    };
-
-    worldNode->accept(kdl::overload(
-      [&](auto&& thisLambda, mdl::WorldNode* world) {
-        collectIssues(world);
-        world->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::LayerNode* layer) {
-        collectIssues(layer);
-        layer->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::GroupNode* group) {
-        collectIssues(group);
-        group->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::EntityNode* entity) {
-        collectIssues(entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](mdl::BrushNode* brush) { collectIssues(brush); },
-      [&](mdl::PatchNode* patch) { collectIssues(patch); }));
-
-    issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
-      return lhs->seqId() > rhs->seqId();
-    });
+  auto issues = kdl::vec_filter(m_issues, [&](const auto* issue) {
+    return m_showHiddenIssues
+           || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0);
+  });
+
+  if (!m_groupByType)
+  {
     m_tableModel->setIssues(std::move(issues));
+    return;
+  }
+
+  // keep the order of the issues within each group
+  std::ranges::stable_sort(issues, {}, [](const auto* issue) { return issue->type(); });
+
+  const auto validators = m_document.map().world()->registeredValidators();
+  auto groups = std::vector<IssueGroup>{};
+  for (size_t first = 0; first < issues.size();)
+  {
+    const auto type = issues[first]->type();
+    const auto last = size_t(
+      std::find_if(
+        issues.begin() + long(first),
+        issues.end(),
+        [&](const auto* issue) { return issue->type() != type; })
+      - issues.begin());
+
+    const auto validatorIt = std::ranges::find_if(
+      validators, [&](const auto* validator) { return validator->type() == type; });
+    auto description =
+      validatorIt != validators.end() ? (*validatorIt)->description() : std::string{};
+
+    groups.push_back({std::move(description), first, last - first});
+    first = last;
   }
+
+  m_tableModel->setIssueGroups(std::move(issues), std::move(groups));
 }
 
 void IssueBrowserView::applyQuickFix(const mdl::IssueQuickFix& quickFix)
@@ -200,8 +228,10 @@ std::vector<const mdl::Issue*> IssueBrowserView::collectIssues(
   {
     if (index.isValid())
     {
-      const auto row = static_cast<size_t>(index.row());
-      result.insert(m_tableModel->issues().at(row));
+      for (const auto* issue : m_tableModel->issues(index.row()))
+      {
+        result.insert(issue);
+      }
     }
   }
   return result.release_data();
@@ -222,8 +252,10 @@ std::vector<const mdl::IssueQuickFix*> IssueBrowserView::collectQuickFixes(
     {
       continue;
     }
-    const auto* issue = m_tableModel->issues().at(static_cast<size_t>(index.row()));
-    issueTypes &= issue->type();
+    for (const auto* issue : m_tableModel->issues(index.row()))
+    {
+      issueTypes &= issue->type();
+    }
   }
 
   auto& map = m_document.map();
@@ -249,7 +281,7 @@ void IssueBrowserView::setIssueVisibility(const bool show)
     map.setIssueHidden(*issue, !show);
   }
 
-  invalidate();
+  updateModel();
 }
 
 QList<QModelIndex> IssueBrowserView::getSelection() const
@@ -323,9 +355,16 @@ void IssueBrowserView::hideIssues()
   setIssueVisibility(false);
 }
 
+void IssueBrowserView::showEvent(QShowEvent* event)
+{
+  QWidget::showEvent(event);
+  validate();
+}
+
 void IssueBrowserView::invalidate()
 {
   m_valid = false;
+  m_issues.clear();
   m_tableModel->setIssues({});
 
   QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
@@ -333,10 +372,11 @@ void IssueBrowserView::invalidate()
 
 void IssueBrowserView::validate()
 {
-  if (!m_valid)
+  // the issues are only collected while the view is visible so that editing the map
+  // does not cause any work if the issue browser is hidden
+  if (!m_valid && isVisible())
   {
     updateIssues();
-    m_valid = true;
   }
 }
 
@@ -351,17 +391,47 @@ void IssueBrowserModel::setIssues(std::vector<const mdl::Issue*> issues)
 {
   beginResetModel();
   m_issues = std::move(issues);
+  m_groups.clear();
+  m_grouped = false;
+  m_fetchedRowCount = std::min(m_issues.size(), FetchRowCount);
   endResetModel();
 }
 
-const std::vector<const mdl::Issue*>& IssueBrowserModel::issues()
+void IssueBrowserModel::setIssueGroups(
+  std::vector<const mdl::Issue*> issues, std::vector<IssueGroup> groups)
+{
+  beginResetModel();
+  m_issues = std::move(issues);
+  m_groups = std::move(groups);
+  m_grouped = true;
+  m_fetchedRowCount = std::min(m_groups.size(), FetchRowCount);
+  endResetModel();
+}
+
+std::span<const mdl::Issue* const> IssueBrowserModel::issues(const int row) const
+{
+  if (row < 0 || static_cast<size_t>(row) >= m_fetchedRowCount)
+  {
+    return {};
+  }
+
+  const auto index = static_cast<size_t>(row);
+  if (m_grouped)
+  {
+    const auto& group = m_groups[index];
+    return std::span{m_issues}.subspan(group.first, group.count);
+  }
+  return std::span{m_issues}.subspan(index, 1);
+}
+
+size_t IssueBrowserModel::totalRowCount() const
 {
-  return m_issues;
+  return m_grouped ? m_groups.size() : m_issues.size();
 }
 
 int IssueBrowserModel::rowCount(const QModelIndex& parent) const
 {
-  return parent.isValid() ? 0 : static_cast<int>(m_issues.size());
+  return parent.isValid() ? 0 : static_cast<int>(m_fetchedRowCount);
 }
 
 int IssueBrowserModel::columnCount(const QModelIndex& parent) const
@@ -369,17 +439,55 @@ int IssueBrowserModel::columnCount(const QModelIndex& parent) const
   return parent.isValid() ? 0 : 2;
 }
 
+bool IssueBrowserModel::canFetchMore(const QModelIndex& parent) const
+{
+  return !parent.isValid() && m_fetchedRowCount < totalRowCount();
+}
+
+void IssueBrowserModel::fetchMore(const QModelIndex& parent)
+{
+  if (parent.isValid())
+  {
+    return;
+  }
+
+  const auto count = std::min(totalRowCount() - m_fetchedRowCount, FetchRowCount);
+  if (count > 0)
+  {
+    beginInsertRows(
+      QModelIndex{},
+      static_cast<int>(m_fetchedRowCount),
+      static_cast<int>(m_fetchedRowCount + count - 1));
+    m_fetchedRowCount += count;
+    endInsertRows();
+  }
+}
+
 QVariant IssueBrowserModel::data(const QModelIndex& index, const int role) const
 {
   if (
     !index.isValid() || index.row() < 0
-    || index.row() >= static_cast<int>(m_issues.size()) || index.column() < 0
+    || index.row() >= static_cast<int>(m_fetchedRowCount) || index.column() < 0
     || index.column() >= 2)
   {
     return QVariant{};
   }
 
-  const auto* issue = m_issues.at(static_cast<size_t>(index.row()));
+  const auto row = static_cast<size_t>(index.row());
+
+  if (m_grouped)
+  {
+    const auto& group = m_groups[row];
+    if (role == Qt::DisplayRole)
+    {
+      return index.column() == 0
+               ? QVariant::fromValue<size_t>(group.count)
+               : QVariant{QString::fromStdString(group.description)};
+    }
+    return QVariant{};
+  }
+
+  const auto* issue = m_issues[row];
 
   if (role == Qt::DisplayRole)
   {
@@ -421,7 +529,7 @@ QVariant IssueBrowserModel::headerData(
   {
     if (section == 0)
     {
-      return QVariant{tr("Line")};
+      return QVariant{m_grouped ? tr("Count") : tr("Line")};
     }
     if (section == 1)
     {
@@ -24,6 +24,9 @@
 
 #include "mdl/IssueType.h"
 
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 class QWidget;
@@ -34,6 +37,7 @@ namespace tb
 namespace mdl
 {
 class Issue;
+class IssueCache;
 class IssueQuickFix;
 } // namespace mdl
 
@@ -47,10 +51,16 @@ class IssueBrowserView : public QWidget
   Q_OBJECT
 private:
   MapDocument& m_document;
+  std::unique_ptr<mdl::IssueCache> m_issueCache;
 
   int m_hiddenIssueTypes = 0;
   bool m_showHiddenIssues = false;
+  bool m_groupByType = false;
 
+  /**
+   * All issues of the map, including the filtered ones. Only valid if m_valid is true.
+   */
+  std::vector<const mdl::Issue*> m_issues;
   bool m_valid = false;
 
   QTableView* m_tableView = nullptr;
@@ -58,6 +68,7 @@ private:
 
 public:
   explicit IssueBrowserView(MapDocument& document, QWidget* parent = nullptr);
+  ~IssueBrowserView() override;
 
 private:
   void createGui();
@@ -66,11 +77,13 @@ public:
   int hiddenIssueTypes() const;
   void setHiddenIssueTypes(int hiddenIssueTypes);
   void setShowHiddenIssues(bool show);
+  void setGroupByType(bool groupByType);
   void reload();
   void deselectAll();
 
 private:
   void updateIssues();
+  void updateModel();
 
   std::vector<const mdl::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
   std::vector<const mdl::IssueQuickFix*> collectQuickFixes(
@@ -89,6 +102,9 @@ private:
   void hideIssues();
   void applyQuickFix(const mdl::IssueQuickFix& quickFix);
 
+protected:
+  void showEvent(QShowEvent* event) override;
+
 private:
   void invalidate();
 public slots:
@@ -96,24 +112,56 @@ public slots:
 };
 
 /**
- * Trivial QAbstractTableModel subclass, when the issues list changes,
- * it just refreshes the entire list with beginResetModel()/endResetModel().
+ * A range of issues of the same type that is shown as a single row.
+ */
+struct IssueGroup
+{
+  std::string description;
+  size_t first;
+  size_t count;
+};
+
+/**
+ * Table model that shows either one row per issue or one row per group of issues.
+ *
+ * When the issues list changes, the entire list is refreshed with beginResetModel() /
+ * endResetModel(). The rows are exposed to the view in batches as it scrolls down, and
+ * they are only formatted when the view requests their data, so that a large number of
+ * issues doesn't stall the view.
  */
 class IssueBrowserModel : public QAbstractTableModel
 {
   Q_OBJECT
 private:
   std::vector<const mdl::Issue*> m_issues;
+  std::vector<IssueGroup> m_groups;
+  bool m_grouped = false;
+  size_t m_fetchedRowCount = 0;
 
 public:
   explicit IssueBrowserModel(QObject* parent);
 
   void setIssues(std::vector<const mdl::Issue*> issues);
-  const std::vector<const mdl::Issue*>& issues();
+
+  /**
+   * Shows one row per group. The groups refer to ranges of the given issues.
+   */
+  void setIssueGroups(
+    std::vector<const mdl::Issue*> issues, std::vector<IssueGroup> groups);
+
+  /**
+   * Returns the issues shown in the given row.
+   */
+  std::span<const mdl::Issue* const> issues(int row) const;
+
+private:
+  size_t totalRowCount() const;
 
 public: // QAbstractTableModel overrides
   int rowCount(const QModelIndex& parent) const override;
   int columnCount(const QModelIndex& parent) const override;
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
   QVariant data(const QModelIndex& index, int role) const override;
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 };
@@ -22,9 +22,6 @@
 #include "render/Camera.h"
 #include "render/RenderService.h"
 
-#include "kdl/optional_utils.h"
-
-#include "vm/intersection.h"
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
 #include "vm/polygon.h"
@@ -46,37 +43,79 @@ void Lasso::update(const vm::vec3d& point)
   m_cur = point;
 }
 
-bool Lasso::selects(
-  const vm::vec3d& point, const vm::plane3d& plane, const vm::bbox2d& box) const
+std::vector<vm::plane3d> Lasso::volume() const
+{
+  const auto transform = getTransform();
+  const auto inverseTransform = vm::invert(transform);
+  const auto box = getBox(transform);
+
+  const auto position = vm::vec3d{m_camera.position()};
+  const auto direction = vm::vec3d{m_camera.direction()};
+  const auto right = vm::vec3d{m_camera.right()};
+  const auto up = vm::vec3d{m_camera.up()};
+
+  // each plane contains one side of the lasso box and the viewing direction at that side
+  const auto sidePlane =
+    [&](const double x, const double y, const vm::vec3d& side, const vm::vec3d& outside) {
+      const auto point = *inverseTransform * vm::vec3d{x, y, 0.0};
+      const auto viewDirection =
+        m_camera.orthographicProjection() ? direction : point - position;
+      const auto normal = vm::normalize(vm::cross(side, viewDirection));
+      return vm::plane3d{point, vm::dot(normal, outside) < 0.0 ? -normal : normal};
+    };
+
+  return {
+    sidePlane(box.min.x(), box.min.y(), up, -right),
+    sidePlane(box.max.x(), box.max.y(), up, right),
+    sidePlane(box.min.x(), box.min.y(), right, -up),
+    sidePlane(box.max.x(), box.max.y(), right, up),
+  };
+}
+
+std::vector<unsigned char> Lasso::selects(const std::vector<vm::vec3d>& points) const
 {
-  if (const auto projected = project(point, plane))
+  const auto box = getBox(getTransform());
+
+  const auto position = vm::vec3d{m_camera.position()};
+  const auto direction = vm::vec3d{m_camera.direction()};
+  const auto right = vm::vec3d{m_camera.right()};
+  const auto up = vm::vec3d{m_camera.up()};
+
+  // A point is projected onto the lasso plane along the view direction. Instead of
+  // dividing its coordinates in the camera's right / up plane by its depth, the box is
+  // scaled by the depth. The depth is constant for an orthographic camera.
+  const auto orthographic = m_camera.orthographicProjection();
+  const auto depthFactor = orthographic ? 0.0 : 1.0 / m_distance;
+  const auto depthOffset = orthographic ? 1.0 : 0.0;
+
+  auto result = std::vector<unsigned char>(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
   {
-    return box.contains(vm::vec2d{*projected});
+    const auto v = points[i] - position;
+    const auto depth = vm::dot(v, direction) * depthFactor + depthOffset;
+    const auto x = vm::dot(v, right);
+    const auto y = vm::dot(v, up);
+
+    // use non-short-circuiting operators so that the loop can be vectorized
+    result[i] = (depth > 0.0) & (x >= box.min.x() * depth) & (x <= box.max.x() * depth)
+                & (y >= box.min.y() * depth) & (y <= box.max.y() * depth);
   }
-  return false;
+  return result;
 }
 
-bool Lasso::selects(
-  const vm::segment3d& edge, const vm::plane3d& plane, const vm::bbox2d& box) const
+vm::vec3d Lasso::handlePosition(const vm::vec3d& point)
 {
-  return selects(edge.center(), plane, box);
+  return point;
 }
 
-bool Lasso::selects(
-  const vm::polygon3d& polygon, const vm::plane3d& plane, const vm::bbox2d& box) const
+vm::vec3d Lasso::handlePosition(const vm::segment3d& edge)
 {
-  return selects(polygon.center(), plane, box);
+  return edge.center();
 }
 
-std::optional<vm::vec3d> Lasso::project(
-  const vm::vec3d& point, const vm::plane3d& plane) const
+vm::vec3d Lasso::handlePosition(const vm::polygon3d& polygon)
 {
-  const auto ray = vm::ray3d{m_camera.pickRay(vm::vec3f{point})};
-  return vm::intersect_ray_plane(ray, plane)
-         | kdl::optional_transform([&](const auto hitDistance) {
-             const auto hitPoint = vm::point_at_distance(ray, hitDistance);
-             return getTransform() * hitPoint;
-           });
+  return polygon.center();
 }
 
 void Lasso::render(
@@ -102,13 +141,6 @@ void Lasso::render(
   renderService.renderFilledPolygon(polygon);
 }
 
-vm::plane3d Lasso::getPlane() const
-{
-  return vm::plane3d{
-    vm::vec3d{m_camera.defaultPoint(static_cast<float>(m_distance))},
-    vm::vec3d{m_camera.direction()}};
-}
-
 vm::mat4x4d Lasso::getTransform() const
 {
   return vm::mat4x4d{vm::coordinate_system_matrix(
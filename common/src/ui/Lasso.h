@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "kdl/ranges/to.h"
 
 #include "vm/bbox.h"
 #include "vm/plane.h"
@@ -26,6 +27,7 @@
 #include "vm/segment.h"
 
 #include <ranges>
+#include <vector>
 
 namespace tb::render
 {
@@ -50,32 +52,50 @@ public:
 
   void update(const vm::vec3d& point);
 
+  /**
+   * Returns the planes bounding the volume of the points which the lasso selects, i.e.,
+   * the points which project into the lasso box. The normals of the returned planes
+   * point outwards.
+   */
+  std::vector<vm::plane3d> volume() const;
+
   template <std::ranges::range R, typename O>
   void selected(const R& handles, O out) const
   {
-    const auto plane = getPlane();
-    const auto box = getBox(getTransform());
-
-    std::ranges::copy_if(
-      handles, out, [&](const auto& handle) { return selects(handle, plane, box); });
+    const auto positions = handles | std::views::transform([](const auto& handle) {
+                             return handlePosition(handle);
+                           })
+                           | kdl::ranges::to<std::vector>();
+    const auto selection = selects(positions);
+
+    auto i = size_t(0);
+    for (const auto& handle : handles)
+    {
+      if (selection[i++])
+      {
+        out++ = handle;
+      }
+    }
   }
 
 private:
-  bool selects(
-    const vm::vec3d& point, const vm::plane3d& plane, const vm::bbox2d& box) const;
-  bool selects(
-    const vm::segment3d& edge, const vm::plane3d& plane, const vm::bbox2d& box) const;
-  bool selects(
-    const vm::polygon3d& polygon, const vm::plane3d& plane, const vm::bbox2d& box) const;
-  std::optional<vm::vec3d> project(
-    const vm::vec3d& point, const vm::plane3d& plane) const;
+  /**
+   * Tests all of the given points against the lasso box in one pass. A point is selected
+   * if it projects into the lasso box.
+   *
+   * @return a vector containing 1 for every selected point and 0 for every other point
+   */
+  std::vector<unsigned char> selects(const std::vector<vm::vec3d>& points) const;
+
+  static vm::vec3d handlePosition(const vm::vec3d& point);
+  static vm::vec3d handlePosition(const vm::segment3d& edge);
+  static vm::vec3d handlePosition(const vm::polygon3d& polygon);
 
 public:
   void render(
     render::RenderContext& renderContext, render::RenderBatch& renderBatch) const;
 
 private:
-  vm::plane3d getPlane() const;
   vm::mat4x4d getTransform() const;
   vm::bbox2d getBox(const vm::mat4x4d& transform) const;
 };
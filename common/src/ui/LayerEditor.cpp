@@ -86,6 +86,8 @@ void LayerEditor::onLayerRightClick(mdl::LayerNode* layerNode)
     tr("Move selection to layer"), this, &LayerEditor::onMoveSelectedNodesToLayer);
   auto* selectAllInLayerAction = popupMenu.addAction(
     tr("Select all in layer"), this, &LayerEditor::onSelectAllInLayer);
+  auto* loadLayerAction = popupMenu.addAction(
+    tr("Load layer"), this, [this, layerNode]() { loadLayer(layerNode); });
   popupMenu.addSeparator();
   auto* toggleLayerVisibleAction = popupMenu.addAction(
     layerNode->hidden() ? tr("Show layer") : tr("Hide layer"), this, [this, layerNode]() {
@@ -120,6 +122,7 @@ void LayerEditor::onLayerRightClick(mdl::LayerNode* layerNode)
   makeActiveAction->setEnabled(canSetCurrentLayer(layerNode));
   moveSelectionToLayerAction->setEnabled(canMoveSelectedNodesToLayer());
   selectAllInLayerAction->setEnabled(canSelectAllInLayer());
+  loadLayerAction->setEnabled(canLoadLayer(layerNode));
   toggleLayerVisibleAction->setEnabled(canToggleLayerVisible());
   isolateLayerAction->setEnabled(canIsolateLayers(map, {layerNode}));
   toggleLayerOmitFromExportAction->setCheckable(true);
@@ -186,6 +189,11 @@ void LayerEditor::isolateLayer(mdl::LayerNode* layer)
   isolateLayers(m_document.map(), std::vector<mdl::LayerNode*>{layer});
 }
 
+void LayerEditor::loadLayer(mdl::LayerNode* layer)
+{
+  mdl::loadLayer(m_document.map(), layer);
+}
+
 void LayerEditor::onMoveSelectedNodesToLayer()
 {
   auto* layerNode = m_layerList->selectedLayer();
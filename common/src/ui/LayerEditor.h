@@ -67,6 +67,8 @@ private:
 
   void isolateLayer(mdl::LayerNode* layer);
 
+  void loadLayer(mdl::LayerNode* layer);
+
   void onSelectAllInLayer();
   bool canSelectAllInLayer() const;
 
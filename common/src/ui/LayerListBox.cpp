@@ -124,9 +124,11 @@ void LayerListBoxWidget::updateLayerItem()
     makeUnemphasized(m_nameText);
   }
 
-  const auto info = tr("%1 %2")
-                      .arg(m_layer->childCount())
-                      .arg(m_layer->childCount() == 1 ? "object" : "objects");
+  const auto info = m_layer->layer().unloadedContent()
+                      ? tr("not loaded")
+                      : tr("%1 %2")
+                          .arg(m_layer->childCount())
+                          .arg(m_layer->childCount() == 1 ? "object" : "objects");
   m_infoText->setText(info);
 
   // Update buttons
@@ -224,7 +226,7 @@ void LayerListBox::connectObservers()
   m_notifierConnection +=
     map.nodesWereRemovedNotifier.connect(this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
     map.nodeVisibilityDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
@@ -20,9 +20,12 @@
 #include "ui/MapDocument.h"
 
 #include "io/DiskIO.h"
+#include "io/EntityThumbnailCache.h"
+#include "io/File.h"
 #include "io/LoadMaterialCollections.h"
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
+#include "io/Reader.h"
 #include "io/WorldReader.h"
 #include "mdl/CommandProcessor.h"
 #include "mdl/EntityDefinitionManager.h"
@@ -101,16 +104,32 @@ mdl::PointTrace* MapDocument::pointTrace()
   return m_pointFile ? &m_pointFile->trace : nullptr;
 }
 
-const std::vector<vm::polygon3f>* MapDocument::portals() const
+const std::vector<mdl::Portal>* MapDocument::portals() const
 {
   return m_portalFile ? &m_portalFile->portals : nullptr;
 }
 
+const mdl::PortalGraph* MapDocument::portalGraph() const
+{
+  return m_portalFile ? &m_portalFile->graph : nullptr;
+}
+
 void MapDocument::setViewEffectsService(ViewEffectsService* viewEffectsService)
 {
   m_viewEffectsService = viewEffectsService;
 }
 
+const io::EntityThumbnailCache* MapDocument::entityThumbnailCache() const
+{
+  return m_entityThumbnailCache.get();
+}
+
+void MapDocument::setEntityThumbnailCache(
+  std::shared_ptr<const io::EntityThumbnailCache> entityThumbnailCache)
+{
+  m_entityThumbnailCache = std::move(entityThumbnailCache);
+}
+
 void MapDocument::createTagActions()
 {
   const auto& actionManager = ActionManager::instance();
@@ -140,14 +159,15 @@ void MapDocument::loadPointFile(std::filesystem::path path)
     unloadPointFile();
   }
 
-  io::Disk::withInputStream(path, [&](auto& stream) {
-    return mdl::loadPointFile(stream) | kdl::transform([&](auto trace) {
-             info() << "Loaded point file " << path;
-             m_pointFile = PointFile{std::move(trace), std::move(path)};
-             pointFileWasLoadedNotifier();
-           });
+  io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
+    auto reader = file->reader().buffer();
+    return mdl::loadPointFile(reader.stringView());
+  }) | kdl::transform([&](auto trace) {
+    info() << "Loaded point file " << path;
+    m_pointFile = PointFile{std::move(trace), std::move(path)};
+    pointFileWasLoadedNotifier();
   }) | kdl::transform_error([&](auto e) {
-    error() << "Couldn't load portal file " << path << ": " << e.msg;
+    error() << "Couldn't load point file " << path << ": " << e.msg;
     m_pointFile = {};
   });
 }
@@ -193,12 +213,14 @@ void MapDocument::loadPortalFile(std::filesystem::path path)
     unloadPortalFile();
   }
 
-  io::Disk::withInputStream(path, [&](auto& stream) {
-    return mdl::loadPortalFile(stream) | kdl::transform([&](auto portalFile) {
-             info() << "Loaded portal file " << path;
-             m_portalFile = {std::move(portalFile), std::move(path)};
-             portalFileWasLoadedNotifier();
-           });
+  io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
+    auto reader = file->reader().buffer();
+    return mdl::loadPortalFile(reader.stringView(), m_map->taskManager());
+  }) | kdl::transform([&](auto portals) {
+    info() << "Loaded portal file " << path;
+    auto graph = mdl::PortalGraph{portals};
+    m_portalFile = {std::move(portals), std::move(graph), std::move(path)};
+    portalFileWasLoadedNotifier();
   }) | kdl::transform_error([&](auto e) {
     error() << "Couldn't load portal file " << path << ": " << e.msg;
     m_portalFile = std::nullopt;
@@ -22,11 +22,12 @@
 #include "Notifier.h"
 #include "NotifierConnection.h"
 #include "mdl/PointTrace.h"
+#include "mdl/PortalFile.h"
+#include "mdl/PortalGraph.h"
 #include "ui/Actions.h"
 #include "ui/CachingLogger.h"
 
 #include "vm/bbox.h"
-#include "vm/polygon.h"
 
 #include <filesystem>
 #include <memory>
@@ -44,6 +45,11 @@ namespace tb
 class Color;
 } // namespace tb
 
+namespace tb::io
+{
+class EntityThumbnailCache;
+} // namespace tb::io
+
 namespace tb::mdl
 {
 enum class MapFormat;
@@ -67,7 +73,8 @@ struct PointFile
 
 struct PortalFile
 {
-  std::vector<vm::polygon3f> portals;
+  std::vector<mdl::Portal> portals;
+  mdl::PortalGraph graph;
   std::filesystem::path path;
 };
 
@@ -93,6 +100,7 @@ private:
   std::vector<Action> m_entityDefinitionActions;
 
   ViewEffectsService* m_viewEffectsService = nullptr;
+  std::shared_ptr<const io::EntityThumbnailCache> m_entityThumbnailCache;
 
   NotifierConnection m_notifierConnection;
 
@@ -108,6 +116,10 @@ public: // accessors and such
 
   void setViewEffectsService(ViewEffectsService* viewEffectsService);
 
+  const io::EntityThumbnailCache* entityThumbnailCache() const;
+  void setEntityThumbnailCache(
+    std::shared_ptr<const io::EntityThumbnailCache> entityThumbnailCache);
+
 public: // tag and entity definition actions
   template <typename ActionVisitor>
   void visitTagActions(const ActionVisitor& visitor) const
@@ -145,7 +157,8 @@ public: // point file management
   void unloadPointFile();
 
 public: // portal file management
-  const std::vector<vm::polygon3f>* portals() const;
+  const std::vector<mdl::Portal>* portals() const;
+  const mdl::PortalGraph* portalGraph() const;
   void loadPortalFile(std::filesystem::path path);
   bool isPortalFileLoaded() const;
   bool canReloadPortalFile() const;
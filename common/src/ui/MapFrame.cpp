@@ -23,11 +23,13 @@
 #include <QChildEvent>
 #include <QClipboard>
 #include <QComboBox>
+#include <QEventLoop>
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QLabel>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QProgressDialog>
 #include <QPushButton>
 #include <QStatusBar>
 #include <QString>
@@ -40,14 +42,18 @@
 
 #include "Console.h"
 #include "Exceptions.h"
+#include "MemoryReport.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "TrenchBroomApp.h"
+#include "io/DiskIO.h"
 #include "io/ExportOptions.h"
 #include "io/PathQt.h"
 #include "mdl/Autosaver.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
+#include "mdl/CommandLog.h"
+#include "mdl/CommandProfiler.h"
 #include "mdl/EditorContext.h"
 #include "mdl/Entity.h"
 #include "mdl/EntityNode.h"
@@ -59,6 +65,7 @@
 #include "mdl/LayerNode.h"
 #include "mdl/Map.h"
 #include "mdl/MapFormat.h"
+#include "mdl/MapLoader.h"
 #include "mdl/Map_Assets.h"
 #include "mdl/Map_Brushes.h"
 #include "mdl/Map_CopyPaste.h"
@@ -74,10 +81,14 @@
 #include "mdl/PatchNode.h"
 #include "mdl/Resource.h"
 #include "mdl/WorldNode.h"
+#include "render/RenderProfiler.h"
+#include "render/VboManager.h"
 #include "ui/ActionBuilder.h"
 #include "ui/Actions.h"
+#include "ui/AssetFileWatcher.h"
 #include "ui/ChoosePathTypeDialog.h"
 #include "ui/ClipTool.h"
+#include "ui/ClipboardData.h"
 #include "ui/ColorButton.h"
 #include "ui/CompilationDialog.h"
 #include "ui/EdgeTool.h"
@@ -105,6 +116,7 @@
 
 #include "kdl/const_overload.h"
 #include "kdl/overload.h"
+#include "kdl/path_utils.h"
 #include "kdl/ranges/to.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
@@ -115,6 +127,7 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <iterator>
@@ -129,10 +142,16 @@ MapFrame::MapFrame(FrameManager& frameManager, std::unique_ptr<MapDocument> docu
   : m_frameManager{frameManager}
   , m_document{std::move(document)}
   , m_lastInputTime{std::chrono::system_clock::now()}
-  , m_autosaver{std::make_unique<mdl::Autosaver>(m_document->map())}
+  , m_autosaver{std::make_unique<mdl::Autosaver>(
+      m_document->map(),
+      std::chrono::milliseconds{10 * 60 * 1000},
+      50,
+      mdl::AutosaveMode::Background,
+      static_cast<size_t>(std::max(0, pref(Preferences::AutosaveJournalEntries))),
+      pref(Preferences::CompressAutosaves))}
   , m_autosaveTimer{new QTimer{this}}
   , m_processResourcesTimer{new QTimer{this}}
-  , m_contextManager{std::make_unique<GLContextManager>()}
+  , m_contextManager{frameManager.contextManager()}
   , m_updateTitleSignalDelayer{new SignalDelayer{this}}
   , m_updateActionStateSignalDelayer{new SignalDelayer{this}}
   , m_updateStatusBarSignalDelayer{new SignalDelayer{this}}
@@ -160,6 +179,9 @@ MapFrame::MapFrame(FrameManager& frameManager, std::unique_ptr<MapDocument> docu
   m_autosaveTimer->start(1000);
   m_processResourcesTimer->start(20);
 
+  // owned by this frame and deleted with its other children before the document
+  new AssetFileWatcher{m_document->map(), this};
+
   connectObservers();
   bindEvents();
 
@@ -193,21 +215,27 @@ MapFrame::~MapFrame()
   removeRecentDocumentsMenu();
 
   // The order of deletion here is important because both the document and the children
-  // need the context manager (and its embedded VBO) to clean up their resources.
+  // need an OpenGL context to clean up their resources.
 
   // Destroy the children first because they might still access document resources.
   // The children must be deleted in reverse order!
   const auto children = this->children();
   qDeleteAll(std::rbegin(children), std::rend(children));
 
-  // let's trigger a final autosave before releasing the document
+  // let's trigger a final autosave before releasing the document, and wait for it to
+  // finish so that it doesn't outlive the document
+  m_autosaver->waitForPendingAutosave();
   m_autosaver->triggerAutosave();
+  m_autosaver->waitForPendingAutosave();
+
+  // the document was closed normally, so there are no changes to recover
+  if (auto& map = m_document->map(); map.persistent())
+  {
+    mdl::deleteAutosaveJournal(map.path()) | kdl::transform_error([](auto) {});
+  }
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
-
-  // FIXME: m_contextManager is deleted via smart pointer; it may release openGL resources
-  // in its destructor
 }
 
 void MapFrame::positionOnScreen(QWidget* reference)
@@ -383,12 +411,12 @@ void MapFrame::createGui()
   m_infoPanel = new InfoPanel{document()};
   m_console = m_infoPanel->console();
 
-  m_mapView = new SwitchableMapViewContainer{document(), *m_contextManager};
+  m_mapView = new SwitchableMapViewContainer{document(), m_contextManager};
   m_currentMapView = m_mapView->firstMapViewBase();
   ensure(
     m_currentMapView, "SwitchableMapViewContainer should have constructed a MapViewBase");
 
-  m_inspector = new Inspector{document(), *m_contextManager};
+  m_inspector = new Inspector{document(), m_contextManager};
 
   m_mapView->connectTopWidgets(m_inspector);
 
@@ -945,30 +973,139 @@ Result<bool> MapFrame::newDocument(
          | kdl::transform([]() { return true; });
 }
 
+namespace
+{
+
+/**
+ * Shows a progress dialog and processes events until the given loader has finished.
+ * Returns false if the user cancelled loading.
+ */
+bool waitForMapLoader(mdl::MapLoader& loader, QWidget* parent)
+{
+  constexpr auto ProgressSteps = 1000;
+
+  auto dialog = QProgressDialog{
+    QObject::tr("Loading %1...").arg(io::pathAsQString(loader.path().filename())),
+    QObject::tr("Cancel"),
+    0,
+    ProgressSteps,
+    parent};
+  dialog.setWindowModality(Qt::WindowModal);
+  dialog.setMinimumDuration(500);
+
+  auto eventLoop = QEventLoop{};
+  auto timer = QTimer{};
+  QObject::connect(&timer, &QTimer::timeout, [&]() {
+    if (loader.finished())
+    {
+      eventLoop.quit();
+    }
+    else
+    {
+      dialog.setValue(int(loader.progress() * (ProgressSteps - 1)));
+    }
+  });
+  QObject::connect(&dialog, &QProgressDialog::canceled, [&]() { loader.cancel(); });
+
+  timer.start(20);
+  if (!loader.finished())
+  {
+    eventLoop.exec();
+  }
+
+  return !loader.cancelled();
+}
+
+} // namespace
+
 Result<bool> MapFrame::openDocument(
   std::unique_ptr<mdl::Game> game,
   const mdl::MapFormat mapFormat,
   const std::filesystem::path& path)
 {
-  if (!confirmOrDiscardChanges() || !closeCompileDialog())
+  if (m_loadingDocument || !confirmOrDiscardChanges() || !closeCompileDialog())
   {
     return false;
   }
 
   auto& map = m_document->map();
   const auto startTime = std::chrono::high_resolution_clock::now();
-  return map.load(mapFormat, MapDocument::DefaultWorldBounds, std::move(game), path)
-         | kdl::transform([&]() {
-             const auto endTime = std::chrono::high_resolution_clock::now();
 
-             logger().info() << "Loaded " << path << " in "
-                             << std::chrono::duration_cast<std::chrono::milliseconds>(
-                                  endTime - startTime)
-                                  .count()
-                             << "ms";
+  // parse the map in the background so that the UI remains responsive
+  auto loader = mdl::MapLoader{
+    mapFormat,
+    MapDocument::DefaultWorldBounds,
+    std::move(game),
+    path,
+    map.taskManager(),
+    logger()};
 
-             return true;
-           });
+  // a new frame has nothing to show until the world was loaded
+  const auto hideWhileLoading = map.world() == nullptr && isVisible();
+  if (hideWhileLoading)
+  {
+    hide();
+  }
+
+  // closeEvent refuses to close the frame while loading, but the frame may still be
+  // deleted while the nested event loop runs
+  const auto self = QPointer<MapFrame>{this};
+  m_loadingDocument = true;
+  const auto loaded = waitForMapLoader(loader, hideWhileLoading ? nullptr : this);
+  if (!self)
+  {
+    return false;
+  }
+  m_loadingDocument = false;
+
+  if (!loaded)
+  {
+    if (hideWhileLoading)
+    {
+      // loading a new frame was cancelled, so there is nothing to show
+      close();
+    }
+    return false;
+  }
+
+  if (hideWhileLoading)
+  {
+    show();
+  }
+
+  return map.load(loader) | kdl::transform([&]() {
+           const auto endTime = std::chrono::high_resolution_clock::now();
+
+           logger().info() << "Loaded " << path << " in "
+                           << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                endTime - startTime)
+                                .count()
+                           << "ms";
+
+           recoverAutosave();
+           return true;
+         });
+}
+
+void MapFrame::recoverAutosave()
+{
+  auto& map = m_document->map();
+  if (auto recovery = mdl::findAutosaveRecovery(map.path()))
+  {
+    if (confirmRecoverAutosave(recovery->snapshotPath))
+    {
+      map.recoverAutosave(recovery->snapshotPath, recovery->journal)
+        | kdl::transform_error([&](auto e) {
+            logger().error() << "Failed to recover autosaved changes: " << e.msg;
+          });
+    }
+    else
+    {
+      mdl::deleteAutosaveJournal(map.path()) | kdl::transform_error([&](auto e) {
+        logger().error() << "Failed to delete autosave journal: " << e.msg;
+      });
+    }
+  }
 }
 
 bool MapFrame::saveDocument()
@@ -1055,6 +1192,17 @@ void MapFrame::revertDocument()
   }
 }
 
+void MapFrame::reloadDocumentChanges()
+{
+  auto& map = m_document->map();
+  if (map.persistent() && confirmReloadDocumentChanges())
+  {
+    map.reloadChanges() | kdl::transform_error([&](auto e) {
+      logger().error() << "Failed to reload changes: " << e.msg;
+    });
+  }
+}
+
 bool MapFrame::exportDocumentAsObj()
 {
   if (!m_objExportDialog)
@@ -1111,6 +1259,121 @@ bool MapFrame::exportDocument(const io::ExportOptions& options)
          | kdl::value();
 }
 
+bool MapFrame::exportRenderProfile()
+{
+  const auto& profiler = currentMapViewBase()->renderProfiler();
+  if (profiler.frames().empty())
+  {
+    QMessageBox::information(
+      this, "", tr("No render profile has been recorded for the current map view."));
+    return false;
+  }
+
+  const auto newFileName = QFileDialog::getSaveFileName(
+    this, tr("Export Render Profile"), "", "CSV files (*.csv)");
+  if (newFileName.isEmpty())
+  {
+    return false;
+  }
+
+  const auto exportPath = io::pathFromQString(newFileName);
+  return io::Disk::withOutputStream(
+           exportPath, [&](auto& stream) { stream << render::toCsv(profiler.frames()); })
+         | kdl::transform([&]() {
+             logger().info() << "Exported render profile to " << exportPath;
+             return true;
+           })
+         | kdl::transform_error([&](auto e) {
+             logger().error() << "Could not export render profile: " + e.msg;
+             QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+             return false;
+           })
+         | kdl::value();
+}
+
+bool MapFrame::exportMemoryReport()
+{
+  auto report = MemoryReport{};
+  m_document->map().addToMemoryReport(report);
+  m_mapView->addToMemoryReport(report);
+
+  const auto& vboManager = m_contextManager.vboManager();
+  // the VBO manager is shared by all frames
+  report.add(
+    "VBOs (all windows)", vboManager.currentVboSize(), vboManager.currentVboCount());
+
+  logger().info() << "Memory report:\n" << toString(report);
+
+  const auto newFileName = QFileDialog::getSaveFileName(
+    this, tr("Export Memory Report"), "", "JSON files (*.json)");
+  if (newFileName.isEmpty())
+  {
+    return false;
+  }
+
+  const auto exportPath = io::pathFromQString(newFileName);
+  return io::Disk::withOutputStream(
+           exportPath, [&](auto& stream) { stream << toJson(report); })
+         | kdl::transform([&]() {
+             logger().info() << "Exported memory report to " << exportPath;
+             return true;
+           })
+         | kdl::transform_error([&](auto e) {
+             logger().error() << "Could not export memory report: " + e.msg;
+             QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+             return false;
+           })
+         | kdl::value();
+}
+
+bool MapFrame::isRecordingCommandLog() const
+{
+  return m_commandLogRecorder != nullptr;
+}
+
+void MapFrame::toggleRecordCommandLog()
+{
+  auto& map = m_document->map();
+
+  if (m_commandLogRecorder)
+  {
+    const auto steps = m_commandLogRecorder->steps();
+    const auto stepCount = m_commandLogRecorder->stepCount();
+    m_commandLogRecorder.reset();
+
+    const auto snapshotFilename =
+      kdl::path_replace_extension(m_commandLogPath, ".map").filename();
+    io::Disk::withOutputStream(
+      m_commandLogPath,
+      [&](auto& stream) {
+        stream << mdl::makeCommandLogHeader(snapshotFilename) << steps;
+      })
+      | kdl::transform([&]() {
+          logger().info() << "Recorded " << stepCount << " steps to " << m_commandLogPath;
+        })
+      | kdl::transform_error([&](auto e) {
+          logger().error() << "Could not write command log: " + e.msg;
+          QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+        });
+    return;
+  }
+
+  const auto newFileName = QFileDialog::getSaveFileName(
+    this, tr("Record Command Log"), "", "Command logs (*.log)");
+  if (newFileName.isEmpty())
+  {
+    return;
+  }
+
+  // the map is written to a snapshot next to the log, against which the log is replayed
+  m_commandLogPath = io::pathFromQString(newFileName);
+  map.saveTo(kdl::path_replace_extension(m_commandLogPath, ".map"));
+
+  m_commandLogRecorder = std::make_unique<mdl::CommandLogRecorder>(map);
+  m_commandLogRecorder->start();
+  logger().info() << "Recording command log to " << m_commandLogPath;
+}
+
 /**
  * Returns whether the window should close.
  */
@@ -1165,6 +1428,64 @@ bool MapFrame::confirmRevertDocument()
   return messageBox.clickedButton() == revertButton;
 }
 
+/**
+ * Returns whether the changes should be reloaded.
+ */
+bool MapFrame::confirmReloadDocumentChanges()
+{
+  const auto& map = m_document->map();
+  if (!map.modified())
+  {
+    return true;
+  }
+
+  auto messageBox = QMessageBox{this};
+  messageBox.setWindowTitle("TrenchBroom");
+  messageBox.setIcon(QMessageBox::Question);
+  messageBox.setText(tr("Reload changes to %1 from %2?")
+                       .arg(io::pathAsQString(map.filename()))
+                       .arg(io::pathAsQString(map.path())));
+  messageBox.setInformativeText(
+    tr("This will discard all unsaved changes to objects that differ from the file on "
+       "disk. The reload can be undone."));
+
+  auto* reloadButton = messageBox.addButton(tr("Reload"), QMessageBox::DestructiveRole);
+  auto* cancelButton = messageBox.addButton(QMessageBox::Cancel);
+  messageBox.setDefaultButton(cancelButton);
+
+  messageBox.exec();
+
+  return messageBox.clickedButton() == reloadButton;
+}
+
+/**
+ * Returns whether the autosaved changes in the given snapshot and its journal should be
+ * recovered.
+ */
+bool MapFrame::confirmRecoverAutosave(const std::filesystem::path& snapshotPath)
+{
+  const auto& map = m_document->map();
+
+  auto messageBox = QMessageBox{this};
+  messageBox.setWindowTitle("TrenchBroom");
+  messageBox.setIcon(QMessageBox::Question);
+  messageBox.setText(
+    tr("Recover unsaved changes to %1?").arg(io::pathAsQString(map.filename())));
+  messageBox.setInformativeText(
+    tr("The autosave at %1 contains changes that were not saved to the map file, e.g. "
+       "because TrenchBroom was not closed normally. If you don't recover them, the "
+       "autosave backups are kept.")
+      .arg(io::pathAsQString(snapshotPath)));
+
+  auto* recoverButton = messageBox.addButton(tr("Recover"), QMessageBox::AcceptRole);
+  messageBox.addButton(tr("Don't Recover"), QMessageBox::RejectRole);
+  messageBox.setDefaultButton(recoverButton);
+
+  messageBox.exec();
+
+  return messageBox.clickedButton() == recoverButton;
+}
+
 void MapFrame::loadPointFile()
 {
   const auto& map = m_document->map();
@@ -1334,11 +1655,17 @@ void MapFrame::copyToClipboard()
 {
   auto& map = m_document->map();
   const auto& selection = map.selection();
-  const auto str = selection.hasNodes()        ? serializeSelectedNodes(map)
-                   : selection.hasBrushFaces() ? serializeSelectedBrushFaces(map)
-                                               : std::string{};
-
   auto* clipboard = QApplication::clipboard();
+
+  if (selection.hasNodes())
+  {
+    // the text form of the nodes is only created if another application requests it
+    clipboard->setMimeData(new ClipboardData{copySelectedNodes(map), map.encoding()});
+    return;
+  }
+
+  const auto str =
+    selection.hasBrushFaces() ? serializeSelectedBrushFaces(map) : std::string{};
   clipboard->setText(mapStringToUnicode(map.encoding(), str));
 }
 
@@ -1408,7 +1735,16 @@ void MapFrame::pasteAtOriginalPosition()
 
 mdl::PasteType MapFrame::paste()
 {
+  auto& map = m_document->map();
   auto* clipboard = QApplication::clipboard();
+
+  // nodes copied in this application can be pasted without parsing them
+  const auto* clipboardData = qobject_cast<const ClipboardData*>(clipboard->mimeData());
+  if (clipboardData && clipboardData->encoding() == map.encoding())
+  {
+    return mdl::paste(map, clipboardData->copiedNodes());
+  }
+
   const auto qtext = clipboard->text();
 
   if (qtext.isEmpty())
@@ -1417,7 +1753,6 @@ mdl::PasteType MapFrame::paste()
     return mdl::PasteType::Failed;
   }
 
-  auto& map = m_document->map();
   return mdl::paste(map, mapStringFromUnicode(map.encoding(), qtext));
 }
 
@@ -1681,7 +2016,7 @@ bool MapFrame::canRenameSelectedGroups() const
 
 void MapFrame::replaceMaterial()
 {
-  auto dialog = ReplaceMaterialDialog{document(), *m_contextManager, this};
+  auto dialog = ReplaceMaterialDialog{document(), m_contextManager, this};
   dialog.exec();
 }
 
@@ -2277,6 +2612,11 @@ void MapFrame::debugPrintVertices()
   }
 }
 
+void MapFrame::debugPrintCommandProfile()
+{
+  logger().info() << mdl::toReport(m_document->map().commandProfiles());
+}
+
 void MapFrame::debugCreateBrush()
 {
   auto ok = false;
@@ -2519,7 +2859,12 @@ void MapFrame::changeEvent(QEvent*)
 
 void MapFrame::closeEvent(QCloseEvent* event)
 {
-  if (!closeCompileDialog())
+  if (m_loadingDocument)
+  {
+    // cancel loading with the progress dialog first
+    event->ignore();
+  }
+  else if (!closeCompileDialog())
   {
     event->ignore();
   }
@@ -52,6 +52,7 @@ class Logger;
 namespace tb::mdl
 {
 class Autosaver;
+class CommandLogRecorder;
 class Game;
 class GroupNode;
 class LayerNode;
@@ -92,12 +93,15 @@ private:
   QTimer* m_autosaveTimer = nullptr;
   QTimer* m_processResourcesTimer = nullptr;
 
+  std::unique_ptr<mdl::CommandLogRecorder> m_commandLogRecorder;
+  std::filesystem::path m_commandLogPath;
+
   QToolBar* m_toolBar = nullptr;
 
   QSplitter* m_hSplitter = nullptr;
   QSplitter* m_vSplitter = nullptr;
 
-  std::unique_ptr<GLContextManager> m_contextManager;
+  GLContextManager& m_contextManager;
   SwitchableMapViewContainer* m_mapView = nullptr;
   /**
    * Last focused MapViewBase. It's a QPointer to handle changing from e.g. a 2-pane map
@@ -114,6 +118,12 @@ private:
   QPointer<QDialog> m_compilationDialog;
   QPointer<ObjExportDialog> m_objExportDialog;
 
+  /**
+   * Set while a map is loaded in a nested event loop. The frame must neither be closed
+   * nor load another map until loading has finished.
+   */
+  bool m_loadingDocument = false;
+
   NotifierConnection m_notifierConnection;
 
 private: // shortcuts
@@ -207,13 +217,22 @@ public:
   bool saveDocument();
   bool saveDocumentAs();
   void revertDocument();
+  void reloadDocumentChanges();
   bool exportDocumentAsObj();
   bool exportDocumentAsMap();
   bool exportDocument(const io::ExportOptions& options);
+  bool exportRenderProfile();
+  bool exportMemoryReport();
+  bool isRecordingCommandLog() const;
+  void toggleRecordCommandLog();
 
 private:
+  void recoverAutosave();
+
   bool confirmOrDiscardChanges();
   bool confirmRevertDocument();
+  bool confirmReloadDocumentChanges();
+  bool confirmRecoverAutosave(const std::filesystem::path& snapshotPath);
 
 public:
   void loadPointFile();
@@ -401,6 +420,7 @@ public:
   void revealMaterial(const mdl::Material* material);
 
   void debugPrintVertices();
+  void debugPrintCommandProfile();
   void debugCreateBrush();
   void debugCreateCube();
   void debugClipBrush();
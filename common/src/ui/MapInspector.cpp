@@ -323,7 +323,7 @@ void MapPropertiesEditor::connectObservers()
   m_notifierConnection +=
     map.mapWasLoadedNotifier.connect(this, &MapPropertiesEditor::mapWasLoaded);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &MapPropertiesEditor::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &MapPropertiesEditor::nodesDidChange);
 }
 
 void MapPropertiesEditor::mapWasCreated(mdl::Map&)
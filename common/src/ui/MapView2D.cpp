@@ -150,7 +150,7 @@ void MapView2D::connectObservers()
 
 void MapView2D::cameraDidChange(const render::Camera*)
 {
-  update();
+  invalidateFrame();
 }
 
 PickRequest MapView2D::pickRequest(const float x, const float y) const
@@ -375,7 +375,13 @@ render::RenderMode MapView2D::renderMode()
 void MapView2D::renderGrid(render::RenderContext&, render::RenderBatch& renderBatch)
 {
   const auto& map = m_document.map();
-  renderBatch.addOneShot(new render::GridRenderer(*m_camera, map.worldBounds()));
+  if (!m_gridRenderer)
+  {
+    m_gridRenderer =
+      std::make_unique<render::GridRenderer>(*m_camera, map.worldBounds());
+  }
+  m_gridRenderer->setWorldBounds(map.worldBounds());
+  renderBatch.add(m_gridRenderer.get());
 }
 
 void MapView2D::renderMap(
@@ -386,7 +392,7 @@ void MapView2D::renderMap(
   renderer.render(renderContext, renderBatch);
 
   const auto& map = m_document.map();
-  if (const auto& bounds = map.selectionBounds();
+  if (const auto bounds = transformedSelectionBounds(renderContext);
       bounds && renderContext.showSelectionGuide())
   {
     auto boundsRenderer = render::SelectionBoundsRenderer{*bounds};
@@ -31,6 +31,7 @@ class PickResult;
 
 namespace tb::render
 {
+class GridRenderer;
 class MapRenderer;
 class OrthographicCamera;
 class RenderBatch;
@@ -54,6 +55,7 @@ public:
 
 private:
   std::unique_ptr<render::OrthographicCamera> m_camera;
+  std::unique_ptr<render::GridRenderer> m_gridRenderer;
 
   NotifierConnection m_notifierConnection;
 
@@ -37,6 +37,7 @@
 #include "render/BoundsGuideRenderer.h"
 #include "render/Compass3D.h"
 #include "render/MapRenderer.h"
+#include "render/OcclusionCuller.h"
 #include "render/PerspectiveCamera.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
@@ -80,6 +81,7 @@ MapView3D::MapView3D(
   : MapViewBase{document, toolBox, renderer, contextManager}
   , m_camera{std::make_unique<render::PerspectiveCamera>()}
   , m_flyModeHelper{std::make_unique<FlyModeHelper>(*m_camera)}
+  , m_occlusionCuller{std::make_unique<render::OcclusionCuller>()}
 {
   bindEvents();
   connectObservers();
@@ -136,10 +138,13 @@ void MapView3D::connectObservers()
 
 void MapView3D::cameraDidChange(const render::Camera* /* camera */)
 {
+  // fly mode changes the camera in preRender, which counts as motion, too
+  m_lastCameraChange = std::chrono::steady_clock::now();
+
   if (!m_ignoreCameraChangeEvents)
   {
     // Don't refresh if the camera was changed in preRender!
-    update();
+    invalidateFrame();
   }
 }
 
@@ -148,7 +153,7 @@ void MapView3D::preferenceDidChange(const std::filesystem::path& path)
   if (path == Preferences::CameraFov.path())
   {
     m_camera->setFov(pref(Preferences::CameraFov));
-    update();
+    invalidateFrame();
   }
 }
 
@@ -196,7 +201,7 @@ void MapView3D::updateFlyMode()
 {
   if (m_flyModeHelper->anyKeyDown())
   {
-    update();
+    invalidateFrame();
   }
 }
 
@@ -240,11 +245,12 @@ vm::vec3d MapView3D::pasteObjectsDelta(
   {
     const auto pickRay =
       vm::ray3d{m_camera->pickRay(float(clientCoords.x()), float(clientCoords.y()))};
-    auto pickResult = mdl::PickResult::byDistance();
+    const auto filter = type(mdl::BrushNode::BrushHitType);
+    auto pickResult = mdl::PickResult::byDistance(filter, 1);
 
     mdl::pick(map, pickRay, pickResult);
 
-    const auto& hit = pickResult.first(type(mdl::BrushNode::BrushHitType));
+    const auto& hit = pickResult.first(filter);
     if (const auto faceHandle = mdl::hitToFaceHandle(hit))
     {
       const auto& face = faceHandle->face();
@@ -537,15 +543,58 @@ render::RenderMode MapView3D::renderMode()
   return render::RenderMode::Render3D;
 }
 
+void MapView3D::updateRenderQuality(render::RenderContext& renderContext)
+{
+  using namespace std::chrono_literals;
+
+  // the camera counts as moving for a short while after it changed, so that the quality
+  // doesn't flicker between the events of a mouse drag
+  static constexpr auto MotionTimeout = 150ms;
+
+  const auto now = std::chrono::steady_clock::now();
+  const auto frameTime = now - m_lastFrame;
+  const auto moving = now - m_lastCameraChange < MotionTimeout;
+  const auto frameTimeTarget =
+    std::chrono::milliseconds{pref(Preferences::MotionFrameTimeTarget)};
+
+  if (!moving || frameTimeTarget == 0ms)
+  {
+    m_reducedQuality = false;
+  }
+  else if (m_lastFrameMoving && frameTime > frameTimeTarget)
+  {
+    // the time since the last frame is only meaningful if the camera moved then, too
+    m_reducedQuality = true;
+  }
+
+  m_lastFrame = now;
+  m_lastFrameMoving = moving;
+
+  if (m_reducedQuality)
+  {
+    renderContext.setReducedQuality(true);
+    renderContext.setShowEntityClassnames(false);
+
+    // keep rendering until the camera stops so that a full quality frame follows
+    invalidateFrame();
+  }
+}
+
 void MapView3D::renderMap(
   render::MapRenderer& renderer,
   render::RenderContext& renderContext,
   render::RenderBatch& renderBatch)
 {
+  updateRenderQuality(renderContext);
+
+  // indoor maps have a lot of overdraw, so skip what's hidden behind walls
+  m_occlusionCuller->beginFrame(*m_camera);
+  renderContext.setOcclusionCuller(m_occlusionCuller.get());
+
   renderer.render(renderContext, renderBatch);
 
   const auto& map = m_document.map();
-  if (const auto& bounds = map.selectionBounds();
+  if (const auto bounds = transformedSelectionBounds(renderContext);
       bounds && renderContext.showSelectionGuide())
   {
     auto boundsRenderer = render::SelectionBoundsRenderer{*bounds};
@@ -22,6 +22,7 @@
 #include "NotifierConnection.h"
 #include "ui/MapViewBase.h"
 
+#include <chrono>
 #include <filesystem>
 #include <vector>
 
@@ -29,8 +30,9 @@ class QKeyEvent;
 
 namespace tb::render
 {
+class OcclusionCuller;
 class PerspectiveCamera;
-}
+} // namespace tb::render
 
 namespace tb::ui
 {
@@ -42,8 +44,18 @@ class MapView3D : public MapViewBase
 private:
   std::unique_ptr<render::PerspectiveCamera> m_camera;
   std::unique_ptr<FlyModeHelper> m_flyModeHelper;
+  std::unique_ptr<render::OcclusionCuller> m_occlusionCuller;
   bool m_ignoreCameraChangeEvents = false;
 
+  /**
+   * While the camera moves and frames take longer than the frame time target, the view
+   * is rendered at reduced quality, see updateRenderQuality.
+   */
+  std::chrono::steady_clock::time_point m_lastCameraChange;
+  std::chrono::steady_clock::time_point m_lastFrame;
+  bool m_lastFrameMoving = false;
+  bool m_reducedQuality = false;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -120,6 +132,7 @@ private: // implement MapViewBase interface
   void preRender() override;
   render::RenderMode renderMode() override;
 
+  void updateRenderQuality(render::RenderContext& renderContext);
   void renderMap(
     render::MapRenderer& renderer,
     render::RenderContext& renderContext,
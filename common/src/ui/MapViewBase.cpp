@@ -22,6 +22,7 @@
 #include <QDebug>
 #include <QMenu>
 #include <QMimeData>
+#include <QOpenGLContext>
 #include <QShortcut>
 #include <QString>
 #include <QtGlobal>
@@ -37,6 +38,7 @@
 #include "mdl/EntityDefinitionGroup.h"
 #include "mdl/EntityDefinitionManager.h"
 #include "mdl/EntityDefinitionUtils.h"
+#include "mdl/EntityModelManager.h"
 #include "mdl/EntityNode.h"
 #include "mdl/EntityProperties.h"
 #include "mdl/Game.h"
@@ -59,15 +61,21 @@
 #include "mdl/PointTrace.h"
 #include "mdl/Transaction.h"
 #include "mdl/WorldNode.h"
+#include "render/AttrString.h"
 #include "render/Camera.h"
 #include "render/Compass.h"
+#include "render/FloatDepthFramebuffer.h"
 #include "render/FontDescriptor.h"
 #include "render/FontManager.h"
 #include "render/MapRenderer.h"
+#include "render/OcclusionCuller.h"
+#include "render/PortalRenderer.h"
 #include "render/PrimitiveRenderer.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
+#include "render/RenderProfiler.h"
 #include "render/RenderService.h"
+#include "render/RenderUtils.h"
 #include "ui/Actions.h"
 #include "ui/Animation.h"
 #include "ui/EnableDisableTagCallback.h"
@@ -88,7 +96,10 @@
 #include "vm/polygon.h"
 #include "vm/util.h"
 
+#include <fmt/format.h>
+
 #include <algorithm>
+#include <cmath>
 #include <ranges>
 #include <vector>
 
@@ -106,6 +117,7 @@ MapViewBase::MapViewBase(
   , m_toolBox{toolBox}
   , m_renderer{renderer}
   , m_animationManager{std::make_unique<AnimationManager>(this)}
+  , m_renderProfiler{std::make_unique<render::RenderProfiler>()}
   , m_updateActionStatesSignalDelayer{new SignalDelayer{this}}
 {
   setToolBox(toolBox);
@@ -137,6 +149,11 @@ void MapViewBase::setIsCurrent(const bool isCurrent)
   m_isCurrent = isCurrent;
 }
 
+const render::RenderProfiler& MapViewBase::renderProfiler() const
+{
+  return *m_renderProfiler;
+}
+
 void MapViewBase::bindEvents()
 {
   connect(
@@ -154,7 +171,7 @@ void MapViewBase::connectObservers()
   m_notifierConnection +=
     map.nodesWereRemovedNotifier.connect(this, &MapViewBase::nodesDidChange);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &MapViewBase::nodesDidChange);
   m_notifierConnection +=
     map.nodeVisibilityDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
   m_notifierConnection +=
@@ -209,34 +226,35 @@ void MapViewBase::createActionsAndUpdatePicking()
 {
   createActions();
   updateActionStates();
+  discardCachedPickResult();
   updatePickResult();
 }
 
 void MapViewBase::nodesDidChange(const std::vector<mdl::Node*>&)
 {
-  updatePickResult();
-  update();
+  invalidatePickResult();
+  invalidateFrame();
 }
 
 void MapViewBase::toolChanged(Tool&)
 {
   updatePickResult();
   updateActionStates();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::commandDone(mdl::Command&)
 {
   updateActionStatesDelayed();
-  updatePickResult();
-  update();
+  invalidatePickResult();
+  invalidateFrame();
 }
 
 void MapViewBase::commandUndone(mdl::UndoableCommand&)
 {
   updateActionStatesDelayed();
-  updatePickResult();
-  update();
+  invalidatePickResult();
+  invalidateFrame();
 }
 
 void MapViewBase::selectionDidChange(const mdl::SelectionChange&)
@@ -246,40 +264,44 @@ void MapViewBase::selectionDidChange(const mdl::SelectionChange&)
 
 void MapViewBase::materialCollectionsDidChange()
 {
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::entityDefinitionsDidChange()
 {
+  discardCachedPickResult();
   createActions();
   updateActionStates();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::modsDidChange()
 {
-  update();
+  discardCachedPickResult();
+  invalidateFrame();
 }
 
 void MapViewBase::editorContextDidChange()
 {
-  update();
+  discardCachedPickResult();
+  invalidateFrame();
 }
 
 void MapViewBase::gridDidChange()
 {
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::pointFileDidChange()
 {
-  update();
+  invalidatePointFileRenderer();
+  invalidateFrame();
 }
 
 void MapViewBase::portalFileDidChange()
 {
   invalidatePortalFileRenderer();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::preferenceDidChange(const std::filesystem::path& path)
@@ -288,27 +310,37 @@ void MapViewBase::preferenceDidChange(const std::filesystem::path& path)
   {
     fontManager().clearCache();
   }
+  else if (path == Preferences::PointFileColor.path())
+  {
+    invalidatePointFileRenderer();
+  }
+  else if (
+    path == Preferences::PortalFileFillColor.path()
+    || path == Preferences::PortalFileBorderColor.path())
+  {
+    invalidatePortalFileRenderer();
+  }
 
   updateActionBindings();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::mapWasCreated(mdl::Map&)
 {
   createActionsAndUpdatePicking();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::mapWasLoaded(mdl::Map&)
 {
   createActionsAndUpdatePicking();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::mapWasCleared(mdl::Map&)
 {
   createActionsAndUpdatePicking();
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::createActions()
@@ -399,7 +431,7 @@ void MapViewBase::moveRotationCenter(const vm::direction direction)
   const auto& grid = map.grid();
   const auto delta = moveDirection(direction) * double(grid.actualSize());
   m_toolBox.moveRotationCenter(delta);
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::moveVertices(const vm::direction direction)
@@ -911,14 +943,14 @@ void MapViewBase::focusInEvent(QFocusEvent* event)
                         // (needed because of QOpenGLWindow; see comment in
                         // createAndRegisterShortcut)
   updateModifierKeys();
-  update();
+  invalidateFrame();
   RenderView::focusInEvent(event);
 }
 
 void MapViewBase::focusOutEvent(QFocusEvent* event)
 {
   clearModifierKeys();
-  update();
+  invalidateFrame();
   RenderView::focusOutEvent(event);
 }
 
@@ -970,7 +1002,7 @@ bool MapViewBase::cancelMouseDrag()
 
 void MapViewBase::refreshViews()
 {
-  update();
+  invalidateFrame();
 }
 
 void MapViewBase::initializeGL()
@@ -987,6 +1019,12 @@ void MapViewBase::initializeGL()
   }
 }
 
+bool MapViewBase::doSkipUnchangedFrames() const
+{
+  // all changes that affect a map view invalidate the frame explicitly
+  return true;
+}
+
 bool MapViewBase::shouldRenderFocusIndicator() const
 {
   return true;
@@ -994,45 +1032,84 @@ bool MapViewBase::shouldRenderFocusIndicator() const
 
 void MapViewBase::renderContents()
 {
+  // pick requests caused by map changes are coalesced into one pick per frame
+  validatePickResult();
+  discardCachedPickResult();
+
   preRender();
 
-  const auto& fontPath = pref(Preferences::RendererFontPath());
-  const auto fontSize = static_cast<size_t>(pref(Preferences::RendererFontSize));
+  // these preferences are read on every frame
+  static auto fontPathPref = CachedPref{Preferences::RendererFontPath()};
+  static auto fontSizePref = CachedPref{Preferences::RendererFontSize};
+  static auto textureMinFilterPref = CachedPref{Preferences::TextureMinFilter};
+  static auto textureMagFilterPref = CachedPref{Preferences::TextureMagFilter};
+  static auto faceRenderModePref = CachedPref{Preferences::FaceRenderMode};
+  static auto showEdgesPref = CachedPref{Preferences::ShowEdges};
+  static auto shadeFacesPref = CachedPref{Preferences::ShadeFaces};
+  static auto showPointEntitiesPref = CachedPref{Preferences::ShowPointEntities};
+  static auto showPointEntityModelsPref = CachedPref{Preferences::ShowPointEntityModels};
+  static auto showEntityClassnamesPref = CachedPref{Preferences::ShowEntityClassnames};
+  static auto showGroupBoundsPref = CachedPref{Preferences::ShowGroupBounds};
+  static auto showBrushEntityBoundsPref = CachedPref{Preferences::ShowBrushEntityBounds};
+  static auto showPointEntityBoundsPref = CachedPref{Preferences::ShowPointEntityBounds};
+  static auto showFogPref = CachedPref{Preferences::ShowFog};
+  static auto cullWithPortalFilePref = CachedPref{Preferences::CullWithPortalFile};
+  static auto showSoftMapBoundsPref = CachedPref{Preferences::ShowSoftMapBounds};
+  static auto profileRenderingPref = CachedPref{Preferences::ProfileRendering};
+
+  const auto& fontPath = fontPathPref();
+  const auto fontSize = static_cast<size_t>(fontSizePref());
   const auto fontDescriptor = render::FontDescriptor{fontPath, fontSize};
 
   const auto& map = m_document.map();
   const auto& grid = map.grid();
 
+  const auto reverseDepth = beginReverseDepth();
+
   auto renderContext =
     render::RenderContext{renderMode(), camera(), fontManager(), shaderManager()};
-  renderContext.setFilterMode(
-    pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+  renderContext.setFilterMode(textureMinFilterPref(), textureMagFilterPref());
   renderContext.setShowMaterials(
-    pref(Preferences::FaceRenderMode) == Preferences::faceRenderModeTextured());
-  renderContext.setShowFaces(
-    pref(Preferences::FaceRenderMode) != Preferences::faceRenderModeSkip());
-  renderContext.setShowEdges(pref(Preferences::ShowEdges));
-  renderContext.setShadeFaces(pref(Preferences::ShadeFaces));
-  renderContext.setShowPointEntities(pref(Preferences::ShowPointEntities));
-  renderContext.setShowPointEntityModels(pref(Preferences::ShowPointEntityModels));
-  renderContext.setShowEntityClassnames(pref(Preferences::ShowEntityClassnames));
-  renderContext.setShowGroupBounds(pref(Preferences::ShowGroupBounds));
-  renderContext.setShowBrushEntityBounds(pref(Preferences::ShowBrushEntityBounds));
-  renderContext.setShowPointEntityBounds(pref(Preferences::ShowPointEntityBounds));
-  renderContext.setShowFog(pref(Preferences::ShowFog));
+    faceRenderModePref() == Preferences::faceRenderModeTextured());
+  renderContext.setShowFaces(faceRenderModePref() != Preferences::faceRenderModeSkip());
+  renderContext.setShowEdges(showEdgesPref());
+  renderContext.setShadeFaces(shadeFacesPref());
+  renderContext.setShowPointEntities(showPointEntitiesPref());
+  renderContext.setShowPointEntityModels(showPointEntityModelsPref());
+  renderContext.setShowEntityClassnames(showEntityClassnamesPref());
+  renderContext.setShowGroupBounds(showGroupBoundsPref());
+  renderContext.setShowBrushEntityBounds(showBrushEntityBoundsPref());
+  renderContext.setShowPointEntityBounds(showPointEntityBoundsPref());
+  renderContext.setShowFog(showFogPref());
+  if (renderContext.render3D() && cullWithPortalFilePref())
+  {
+    renderContext.setPortalGraph(m_document.portalGraph());
+  }
   renderContext.setShowGrid(grid.visible());
   renderContext.setGridSize(grid.actualSize());
   renderContext.setDpiScale(static_cast<float>(window()->devicePixelRatioF()));
   renderContext.setSoftMapBounds(
-    pref(Preferences::ShowSoftMapBounds)
+    showSoftMapBoundsPref()
       ? vm::bbox3f{softMapBounds(map).bounds.value_or(vm::bbox3d{})}
       : vm::bbox3f{});
 
+  m_renderProfiler->setEnabled(profileRenderingPref());
+  m_renderProfiler->beginFrame();
+  renderContext.setProfiler(m_renderProfiler.get());
+
   setupGL(renderContext);
   setRenderOptions(renderContext);
+  if (const auto transformation = m_toolBox.selectionPreviewTransformation())
+  {
+    renderContext.setSelectionTransformation(*transformation);
+  }
 
   auto renderBatch = render::RenderBatch{vboManager()};
 
+  const auto& entityModelManager = map.entityModelManager();
+  const auto preparedModelRendererCount = entityModelManager.preparedRendererCount();
+
+  m_renderProfiler->beginCpuPass("Collect");
   renderGrid(renderContext, renderBatch);
   renderMap(m_renderer, renderContext, renderBatch);
   renderTools(m_toolBox, renderContext, renderBatch);
@@ -1043,19 +1120,84 @@ void MapViewBase::renderContents()
   renderPortalFile(renderContext, renderBatch);
   renderCompass(renderBatch);
   renderFPS(renderContext, renderBatch);
+  m_renderProfiler->endCpuPass();
 
+  m_renderProfiler->beginCpuPass("Render");
   renderBatch.render(renderContext);
+  m_renderProfiler->endCpuPass();
+
+  m_renderProfiler->endFrame();
 
-  if (map.needsResourceProcessing())
+  if (reverseDepth)
   {
-    update();
+    render::glSetReverseDepth(false);
+    m_depthFramebuffer->blitTo(defaultFramebufferObject());
+  }
+
+  // entity models are uploaded over several frames, and once a model is uploaded, its
+  // placeholder must be replaced in the next frame; likewise, the map renderer may not
+  // have applied all changes in this frame
+  if (
+    map.needsResourceProcessing() || entityModelManager.hasUnpreparedRenderers()
+    || entityModelManager.preparedRendererCount() != preparedModelRendererCount
+    || m_renderer.hasPendingUpdates())
+  {
+    invalidateFrame();
+  }
+
+  // objects that were culled although they are visible must be rendered in the next frame
+  if (auto* occlusionCuller = renderContext.occlusionCuller();
+      occlusionCuller && occlusionCuller->endFrame())
+  {
+    invalidateFrame();
   }
 }
 
 void MapViewBase::preRender() {}
 
+bool MapViewBase::beginReverseDepth()
+{
+  if (
+    renderMode() != render::RenderMode::Render3D || !pref(Preferences::ReverseDepth)
+    || !render::reverseDepthSupported())
+  {
+    return false;
+  }
+
+  if (!m_depthFramebuffer)
+  {
+    m_depthFramebuffer = std::make_unique<render::FloatDepthFramebuffer>();
+  }
+
+  // the default framebuffer has a fixed point depth buffer, so the view renders into a
+  // framebuffer with a floating point depth buffer and copies the result
+  const auto dpr = devicePixelRatioF();
+  const auto framebufferWidth = GLsizei(std::round(width() * dpr));
+  const auto framebufferHeight = GLsizei(std::round(height() * dpr));
+  const auto samples = GLsizei(std::max(0, context()->format().samples()));
+  if (!m_depthFramebuffer->bind(framebufferWidth, framebufferHeight, samples))
+  {
+    return false;
+  }
+
+  render::glSetReverseDepth(true);
+  clearBackground();
+  return true;
+}
+
 void MapViewBase::renderGrid(render::RenderContext&, render::RenderBatch&) {}
 
+std::optional<vm::bbox3d> MapViewBase::transformedSelectionBounds(
+  const render::RenderContext& renderContext) const
+{
+  if (const auto& bounds = m_document.map().selectionBounds())
+  {
+    const auto& transformation = renderContext.selectionTransformation();
+    return transformation ? bounds->transform(*transformation) : *bounds;
+  }
+  return std::nullopt;
+}
+
 void MapViewBase::setupGL(render::RenderContext& context)
 {
   const auto& viewport = context.camera().viewport();
@@ -1066,7 +1208,8 @@ void MapViewBase::setupGL(render::RenderContext& context)
   const auto height = static_cast<int>(viewport.height * r);
   glAssert(glViewport(x, y, width, height));
 
-  if (pref(Preferences::EnableMSAA))
+  static auto enableMSAAPref = CachedPref{Preferences::EnableMSAA};
+  if (enableMSAAPref())
   {
     glAssert(glEnable(GL_MULTISAMPLE));
   }
@@ -1095,25 +1238,49 @@ void MapViewBase::renderCoordinateSystem(
 void MapViewBase::renderSoftWorldBounds(render::RenderContext&, render::RenderBatch&) {}
 
 void MapViewBase::renderPointFile(
-  render::RenderContext& renderContext, render::RenderBatch& renderBatch)
+  render::RenderContext&, render::RenderBatch& renderBatch)
 {
-  if (const auto* pointFile = m_document.pointTrace())
+  if (m_document.pointTrace())
   {
-    auto renderService = render::RenderService{renderContext, renderBatch};
-    renderService.setForegroundColor(pref(Preferences::PointFileColor));
-    renderService.renderLineStrip(pointFile->points());
+    if (!m_pointFileRenderer)
+    {
+      validatePointFileRenderer();
+      assert(m_pointFileRenderer);
+    }
+    renderBatch.add(m_pointFileRenderer.get());
   }
 }
 
+void MapViewBase::invalidatePointFileRenderer()
+{
+  m_pointFileRenderer = nullptr;
+}
+
+void MapViewBase::validatePointFileRenderer()
+{
+  assert(m_pointFileRenderer == nullptr);
+  m_pointFileRenderer = std::make_unique<render::PrimitiveRenderer>();
+
+  const auto lineWidth = 1.0f;
+  m_pointFileRenderer->renderLineStrip(
+    pref(Preferences::PointFileColor),
+    lineWidth,
+    render::PrimitiveRendererOcclusionPolicy::Transparent,
+    m_document.pointTrace()->points());
+}
+
 void MapViewBase::renderPortalFile(
   render::RenderContext& renderContext, render::RenderBatch& renderBatch)
 {
-  if (!m_portalFileRenderer)
+  if (m_document.portals())
   {
-    validatePortalFileRenderer(renderContext);
-    assert(m_portalFileRenderer);
+    if (!m_portalFileRenderer)
+    {
+      validatePortalFileRenderer(renderContext);
+      assert(m_portalFileRenderer);
+    }
+    renderBatch.add(m_portalFileRenderer.get());
   }
-  renderBatch.add(m_portalFileRenderer.get());
 }
 
 void MapViewBase::invalidatePortalFileRenderer()
@@ -1124,26 +1291,15 @@ void MapViewBase::invalidatePortalFileRenderer()
 void MapViewBase::validatePortalFileRenderer(render::RenderContext&)
 {
   assert(m_portalFileRenderer == nullptr);
-  m_portalFileRenderer = std::make_unique<render::PrimitiveRenderer>();
 
-  if (const auto* portals = m_document.portals())
-  {
-    for (const auto& portal : *portals)
-    {
-      m_portalFileRenderer->renderFilledPolygon(
-        pref(Preferences::PortalFileFillColor),
-        render::PrimitiveRendererOcclusionPolicy::Hide,
-        render::PrimitiveRendererCullingPolicy::ShowBackfaces,
-        portal.vertices());
-
-      const auto lineWidth = 4.0f;
-      m_portalFileRenderer->renderPolygon(
-        pref(Preferences::PortalFileBorderColor),
-        lineWidth,
-        render::PrimitiveRendererOcclusionPolicy::Hide,
-        portal.vertices());
-    }
-  }
+  const auto chunkSize = 1024.0f;
+  const auto lineWidth = 4.0f;
+  m_portalFileRenderer = std::make_unique<render::PortalRenderer>(
+    *m_document.portals(),
+    chunkSize,
+    pref(Preferences::PortalFileFillColor),
+    pref(Preferences::PortalFileBorderColor),
+    lineWidth);
 }
 
 void MapViewBase::renderCompass(render::RenderBatch& renderBatch)
@@ -1157,10 +1313,40 @@ void MapViewBase::renderCompass(render::RenderBatch& renderBatch)
 void MapViewBase::renderFPS(
   render::RenderContext& renderContext, render::RenderBatch& renderBatch)
 {
-  if (pref(Preferences::ShowFPS))
+  if (pref(Preferences::ShowFPS) || m_renderProfiler->enabled())
   {
+    auto str = render::AttrString{};
+    if (pref(Preferences::ShowFPS))
+    {
+      str.appendLeftJustified(m_currentFPS);
+    }
+    if (m_renderProfiler->enabled())
+    {
+      const auto average = render::averageFrameProfile(m_renderProfiler->frames());
+      for (const auto& pass : average.cpuPasses)
+      {
+        str.appendLeftJustified(fmt::format("CPU {}: {:.2f} ms", pass.label, pass.msecs));
+      }
+      for (const auto& pass : average.gpuPasses)
+      {
+        str.appendLeftJustified(fmt::format("GPU {}: {:.2f} ms", pass.label, pass.msecs));
+      }
+
+      const auto& stateChanges = average.stateChanges;
+      str.appendLeftJustified(fmt::format(
+        "Programs: {}, textures: {}, buffers: {}, vertex arrays: {}",
+        stateChanges.programChanges,
+        stateChanges.textureBinds,
+        stateChanges.bufferBinds,
+        stateChanges.vertexArrayBinds));
+      str.appendLeftJustified(fmt::format(
+        "Draw calls: {}, uploaded: {} KiB",
+        stateChanges.drawCalls,
+        stateChanges.uploadedBytes / 1024u));
+    }
+
     auto renderService = render::RenderService{renderContext, renderBatch};
-    renderService.renderHeadsUp(m_currentFPS);
+    renderService.renderHeadsUp(str);
   }
 }
 
@@ -1198,6 +1384,7 @@ void MapViewBase::doShowPopupMenu()
 
 void MapViewBase::showPopupMenuLater()
 {
+  validatePickResult();
   beforePopupMenu();
 
   auto& map = m_document.map();
@@ -26,7 +26,10 @@
 #include "ui/RenderView.h"
 #include "ui/ToolBoxConnector.h"
 
+#include "vm/bbox.h"
+
 #include <filesystem>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -53,10 +56,13 @@ namespace tb::render
 {
 class Camera;
 class Compass;
+class FloatDepthFramebuffer;
 class MapRenderer;
+class PortalRenderer;
 class PrimitiveRenderer;
 class RenderBatch;
 class RenderContext;
+class RenderProfiler;
 enum class RenderMode;
 } // namespace tb::render
 
@@ -87,7 +93,10 @@ protected:
 
 private:
   std::unique_ptr<render::Compass> m_compass;
-  std::unique_ptr<render::PrimitiveRenderer> m_portalFileRenderer;
+  std::unique_ptr<render::PrimitiveRenderer> m_pointFileRenderer;
+  std::unique_ptr<render::PortalRenderer> m_portalFileRenderer;
+  std::unique_ptr<render::RenderProfiler> m_renderProfiler;
+  std::unique_ptr<render::FloatDepthFramebuffer> m_depthFramebuffer;
 
   /**
    * Tracks whether this map view has most recently gotten the focus. This is tracked and
@@ -132,6 +141,8 @@ public:
 
   virtual render::Camera& camera() = 0;
 
+  const render::RenderProfiler& renderProfiler() const;
+
 private:
   void bindEvents();
   void connectObservers();
@@ -308,6 +319,15 @@ public: // implement MapView interface
 
 protected: // RenderView overrides
   void initializeGL() override;
+  bool doSkipUnchangedFrames() const override;
+
+protected:
+  /**
+   * Returns the selection bounds transformed by the selection transformation of the
+   * given render context, if any.
+   */
+  std::optional<vm::bbox3d> transformedSelectionBounds(
+    const render::RenderContext& renderContext) const;
 
 private: // implement RenderView interface
   bool shouldRenderFocusIndicator() const override;
@@ -316,6 +336,12 @@ private: // implement RenderView interface
   virtual void preRender();
   virtual render::RenderMode renderMode() = 0;
 
+  /**
+   * Binds the floating point depth framebuffer and enables reverse depth if this is a 3D
+   * view and the user enabled reverse depth. Returns whether reverse depth was enabled.
+   */
+  bool beginReverseDepth();
+
   virtual void renderGrid(
     render::RenderContext& renderContext, render::RenderBatch& renderBatch);
   virtual void renderMap(
@@ -334,6 +360,8 @@ private: // implement RenderView interface
     render::RenderContext& renderContext, render::RenderBatch& renderBatch);
   void renderPointFile(
     render::RenderContext& renderContext, render::RenderBatch& renderBatch);
+  void invalidatePointFileRenderer();
+  void validatePointFileRenderer();
 
   void renderPortalFile(
     render::RenderContext& renderContext, render::RenderBatch& renderBatch);
@@ -255,6 +255,23 @@ void MapViewToolBox::moveVertices(const vm::vec3d& delta)
   }
 }
 
+std::optional<vm::mat4x4d> MapViewToolBox::selectionPreviewTransformation() const
+{
+  if (auto transformation = m_moveObjectsTool->previewTransformation())
+  {
+    return transformation;
+  }
+  if (auto transformation = m_rotateTool->previewTransformation())
+  {
+    return transformation;
+  }
+  if (auto transformation = m_scaleTool->previewTransformation())
+  {
+    return transformation;
+  }
+  return m_shearTool->previewTransformation();
+}
+
 void MapViewToolBox::createTools(QStackedLayout* bookCtrl)
 {
   m_clipTool = std::make_unique<ClipTool>(m_map);
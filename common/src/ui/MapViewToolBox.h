@@ -22,9 +22,11 @@
 #include "NotifierConnection.h"
 #include "ui/ToolBox.h"
 
+#include "vm/mat.h"
 #include "vm/vec.h"
 
 #include <memory>
+#include <optional>
 
 class QStackedLayout;
 
@@ -125,6 +127,13 @@ public: // tools
 
   void moveVertices(const vm::vec3d& delta);
 
+  /**
+   * Returns the transformation of the selection that a tool is currently previewing, if
+   * any. Tools that transform the selection by dragging only render the transformed
+   * selection during the drag and apply the transformation when the drag ends.
+   */
+  std::optional<vm::mat4x4d> selectionPreviewTransformation() const;
+
 private: // Tool related methods
   void createTools(QStackedLayout* bookCtrl);
 
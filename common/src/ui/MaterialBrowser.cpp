@@ -193,11 +193,14 @@ void MaterialBrowser::connectObservers()
   m_notifierConnection +=
     map.nodesWereRemovedNotifier.connect(this, &MaterialBrowser::nodesWereRemoved);
   m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &MaterialBrowser::nodesDidChange);
+    map.nodesDidChangeBatchedNotifier.connect(this, &MaterialBrowser::nodesDidChange);
   m_notifierConnection +=
     map.brushFacesDidChangeNotifier.connect(this, &MaterialBrowser::brushFacesDidChange);
   m_notifierConnection += map.materialCollectionsDidChangeNotifier.connect(
     this, &MaterialBrowser::materialCollectionsDidChange);
+  // changing the mods reloads the materials they provide
+  m_notifierConnection += map.modsDidChangeNotifier.connect(
+    this, &MaterialBrowser::materialCollectionsDidChange);
   m_notifierConnection += map.currentMaterialNameDidChangeNotifier.connect(
     this, &MaterialBrowser::currentMaterialNameDidChange);
 
@@ -49,11 +49,28 @@
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 namespace tb::ui
 {
+namespace
+{
+
+// The number of recently displayed material textures that are kept loaded. Textures of
+// materials that were displayed less recently are evicted unless they are in use.
+constexpr auto MaxCachedTextures = size_t(1024);
+
+bool matchesFilterText(
+  const mdl::Material& material, const std::vector<std::string>& patterns)
+{
+  return kdl::all_of(patterns, [&](const auto& pattern) {
+    return kdl::ci::str_contains(material.name(), pattern);
+  });
+}
+
+} // namespace
 
 MaterialBrowserView::MaterialBrowserView(
   QScrollBar* scrollBar, GLContextManager& contextManager, MapDocument& document)
@@ -65,6 +82,10 @@ MaterialBrowserView::MaterialBrowserView(
     this, &MaterialBrowserView::reloadMaterials);
   m_notifierConnection += map.resourcesWereProcessedNotifier.connect(
     this, &MaterialBrowserView::resourcesWereProcessed);
+  m_notifierConnection += map.materialCollectionsWillChangeNotifier.connect(
+    this, &MaterialBrowserView::clearTextureCache);
+  m_notifierConnection += map.mapWillBeClearedNotifier.connect(
+    [&](auto&) { clearTextureCache(); });
 }
 
 MaterialBrowserView::~MaterialBrowserView()
@@ -103,8 +124,22 @@ void MaterialBrowserView::setFilterText(const std::string& filterText)
 {
   if (filterText != m_filterText)
   {
+    // appending to the filter text can only remove materials from the view
+    const auto narrowsFilter = filterText.starts_with(m_filterText);
     m_filterText = filterText;
-    reloadMaterials();
+
+    if (narrowsFilter)
+    {
+      const auto patterns = kdl::str_split(m_filterText, " ");
+      removeCells([&](const auto& cell) {
+        return !matchesFilterText(cellData(cell), patterns);
+      });
+      update();
+    }
+    else
+    {
+      reloadMaterials();
+    }
   }
 }
 
@@ -141,6 +176,13 @@ void MaterialBrowserView::reloadMaterials()
   update();
 }
 
+void MaterialBrowserView::clearTextureCache()
+{
+  m_recentMaterials.clear();
+  m_recentMaterialIndex.clear();
+  m_textureSizes.clear();
+}
+
 void MaterialBrowserView::doInitLayout(Layout& layout)
 {
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
@@ -196,8 +238,17 @@ void MaterialBrowserView::addMaterialToLayout(
   const auto titleHeight = fontManager().font(font).measure(materialName).y();
 
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
-  const auto* texture = material.texture();
-  const auto textureSize = texture ? texture->sizef() : vm::vec2f{64, 64};
+  auto textureSize = vm::vec2f{64, 64};
+  if (const auto* texture = material.texture())
+  {
+    textureSize = texture->sizef();
+    m_textureSizes[&material] = textureSize;
+  }
+  else if (const auto iSize = m_textureSizes.find(&material);
+           iSize != m_textureSizes.end())
+  {
+    textureSize = iSize->second;
+  }
   const auto scaledTextureSize = vm::round(scaleFactor * textureSize);
 
   layout.addItem(
@@ -256,10 +307,9 @@ std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
   }
   if (!m_filterText.empty())
   {
+    const auto patterns = kdl::str_split(m_filterText, " ");
     materials = kdl::vec_erase_if(std::move(materials), [&](const auto* material) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(material->name(), pattern);
-      });
+      return !matchesFilterText(*material, patterns);
     });
   }
   return materials;
@@ -300,8 +350,10 @@ void MaterialBrowserView::doRender(Layout& layout, const float y, const float he
     vm::view_matrix(vm::vec3f{0, 0, -1}, vm::vec3f{0, 1, 0})
       * vm::translation_matrix(vm::vec3f{0.0f, 0.0f, 0.1f})};
 
+  prefetchTextures(layout, y, height);
   renderBounds(layout, y, height);
   renderMaterials(layout, y, height);
+  evictTextures();
 }
 
 bool MaterialBrowserView::shouldRenderFocusIndicator() const
@@ -415,6 +467,64 @@ void MaterialBrowserView::renderMaterials(
   }
 }
 
+void MaterialBrowserView::prefetchTextures(
+  Layout& layout, const float y, const float height)
+{
+  // request the textures of the cells within one page above and below the visible area
+  // so that they are likely loaded when the user scrolls there
+  const auto prefetchY = std::max(0.0f, y - height);
+  const auto prefetchHeight = y - prefetchY + 2.0f * height;
+
+  for (const auto& group : layout.groups())
+  {
+    if (group.intersectsY(prefetchY, prefetchHeight))
+    {
+      for (const auto& row : group.rows())
+      {
+        if (row.intersectsY(prefetchY, prefetchHeight))
+        {
+          for (const auto& cell : row.cells())
+          {
+            const auto& material = cellData(cell);
+            material.requestTexture();
+            touchMaterial(material);
+          }
+        }
+      }
+    }
+  }
+}
+
+void MaterialBrowserView::touchMaterial(const mdl::Material& material)
+{
+  if (const auto iRecent = m_recentMaterialIndex.find(&material);
+      iRecent != m_recentMaterialIndex.end())
+  {
+    m_recentMaterials.splice(m_recentMaterials.begin(), m_recentMaterials, iRecent->second);
+  }
+  else
+  {
+    m_recentMaterials.push_front(&material);
+    m_recentMaterialIndex.emplace(&material, m_recentMaterials.begin());
+  }
+}
+
+void MaterialBrowserView::evictTextures()
+{
+  while (m_recentMaterials.size() > MaxCachedTextures)
+  {
+    const auto* material = m_recentMaterials.back();
+    m_recentMaterials.pop_back();
+    m_recentMaterialIndex.erase(material);
+
+    // textures of materials used in the map are needed for rendering the map, too
+    if (material->usageCount() == 0)
+    {
+      material->evictTexture();
+    }
+  }
+}
+
 void MaterialBrowserView::doLeftClick(Layout& layout, const float x, const float y)
 {
   if (const auto* cell = layout.cellAt(x, y))
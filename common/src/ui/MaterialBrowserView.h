@@ -23,7 +23,11 @@
 #include "render/FontDescriptor.h"
 #include "ui/CellView.h"
 
+#include "vm/vec.h"
+
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class QScrollBar;
@@ -60,6 +64,14 @@ private:
 
   const mdl::Material* m_selectedMaterial = nullptr;
 
+  // recently displayed materials, most recent first, used to evict offscreen textures
+  std::list<const mdl::Material*> m_recentMaterials;
+  std::unordered_map<const mdl::Material*, std::list<const mdl::Material*>::iterator>
+    m_recentMaterialIndex;
+
+  // last known texture sizes so that the layout doesn't change when textures are evicted
+  std::unordered_map<const mdl::Material*, vm::vec2f> m_textureSizes;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -81,6 +93,7 @@ private:
   void resourcesWereProcessed(const std::vector<mdl::ResourceId>& resources);
 
   void reloadMaterials();
+  void clearTextureCache();
 
   void doInitLayout(Layout& layout) override;
   void doReloadLayout(Layout& layout) override;
@@ -111,6 +124,10 @@ private:
   const Color& materialColor(const mdl::Material& material) const;
   void renderMaterials(Layout& layout, float y, float height);
 
+  void prefetchTextures(Layout& layout, float y, float height);
+  void touchMaterial(const mdl::Material& material);
+  void evictTextures();
+
   void doLeftClick(Layout& layout, float x, float y) override;
   QString tooltip(const Cell& cell) override;
   void doContextMenu(Layout& layout, float x, float y, QContextMenuEvent* event) override;
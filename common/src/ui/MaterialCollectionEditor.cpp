@@ -230,8 +230,8 @@ void MaterialCollectionEditor::connectObservers()
     map.mapWasCreatedNotifier.connect(this, &MaterialCollectionEditor::mapWasCreated);
   m_notifierConnection +=
     map.mapWasLoadedNotifier.connect(this, &MaterialCollectionEditor::mapWasLoaded);
-  m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &MaterialCollectionEditor::nodesDidChange);
+  m_notifierConnection += map.nodesDidChangeBatchedNotifier.connect(
+    this, &MaterialCollectionEditor::nodesDidChange);
   m_notifierConnection += map.materialCollectionsDidChangeNotifier.connect(
     this, &MaterialCollectionEditor::materialCollectionsDidChange);
   m_notifierConnection +=
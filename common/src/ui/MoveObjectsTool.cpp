@@ -27,8 +27,10 @@
 #include "ui/InputState.h"
 
 #include "vm/bbox.h"
+#include "vm/mat_ext.h"
 
 #include <cassert>
+#include <utility>
 
 namespace tb::ui
 {
@@ -44,6 +46,11 @@ const mdl::Grid& MoveObjectsTool::grid() const
   return m_map.grid();
 }
 
+std::optional<vm::mat4x4d> MoveObjectsTool::previewTransformation() const
+{
+  return m_delta ? std::optional{vm::translation_matrix(*m_delta)} : std::nullopt;
+}
+
 bool MoveObjectsTool::startMove(const InputState& inputState)
 {
   if (!m_map.selection().brushFaces.empty())
@@ -55,12 +62,15 @@ bool MoveObjectsTool::startMove(const InputState& inputState)
     duplicateObjects(inputState) ? "Duplicate Objects" : "Move Objects",
     mdl::TransactionScope::LongRunning);
   m_duplicateObjects = duplicateObjects(inputState);
+  m_delta = vm::vec3d{0, 0, 0};
   return true;
 }
 
 MoveObjectsTool::MoveResult MoveObjectsTool::move(
   const InputState&, const vm::vec3d& delta)
 {
+  assert(m_delta);
+
   const auto& worldBounds = m_map.worldBounds();
   const auto bounds = m_map.selectionBounds();
   if (!bounds)
@@ -68,7 +78,8 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
     return MoveResult::Cancel;
   }
 
-  if (!worldBounds.contains(bounds->translate(delta)))
+  const auto totalDelta = *m_delta + delta;
+  if (!worldBounds.contains(bounds->translate(totalDelta)))
   {
     return MoveResult::Deny;
   }
@@ -79,17 +90,34 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
     duplicateSelectedNodes(m_map);
   }
 
-  return translateSelection(m_map, delta) ? MoveResult::Continue : MoveResult::Deny;
+  // the selection is only translated when the move ends
+  m_delta = totalDelta;
+  refreshViews();
+
+  return MoveResult::Continue;
 }
 
 void MoveObjectsTool::endMove(const InputState&)
 {
-  m_map.commitTransaction();
+  const auto delta = std::exchange(m_delta, std::nullopt);
+  if (
+    delta && !vm::is_zero(*delta, vm::Cd::almost_zero())
+    && !translateSelection(m_map, *delta))
+  {
+    m_map.cancelTransaction();
+  }
+  else
+  {
+    m_map.commitTransaction();
+  }
+  refreshViews();
 }
 
 void MoveObjectsTool::cancelMove()
 {
+  m_delta = std::nullopt;
   m_map.cancelTransaction();
+  refreshViews();
 }
 
 bool MoveObjectsTool::duplicateObjects(const InputState& inputState) const
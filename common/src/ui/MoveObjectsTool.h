@@ -21,8 +21,11 @@
 
 #include "ui/Tool.h"
 
+#include "vm/mat.h"
 #include "vm/vec.h"
 
+#include <optional>
+
 namespace tb::mdl
 {
 class Grid;
@@ -46,6 +49,7 @@ public:
 private:
   mdl::Map& m_map;
   bool m_duplicateObjects = false;
+  std::optional<vm::vec3d> m_delta;
 
 public:
   explicit MoveObjectsTool(mdl::Map& map);
@@ -53,6 +57,13 @@ public:
 public:
   const mdl::Grid& grid() const;
 
+  /**
+   * Returns the translation of the selection while a move is in progress. The selection
+   * is only rendered at its new position until the move ends, when the translation is
+   * applied to the map.
+   */
+  std::optional<vm::mat4x4d> previewTransformation() const;
+
   bool startMove(const InputState& inputState);
   MoveResult move(const InputState& inputState, const vm::vec3d& delta);
   void endMove(const InputState& inputState);
@@ -114,22 +114,31 @@ RenderView::RenderView(GLContextManager& contextManager, QWidget* parent)
 
   fpsCounter->start(1000);
 
+  // keep the previous frame in case a repaint is skipped
+  setUpdateBehavior(QOpenGLWidget::PartialUpdate);
+
   setMouseTracking(true); // request mouse move events even when no button is held down
   setFocusPolicy(Qt::StrongFocus); // accept focus by clicking or tab
 }
 
 RenderView::~RenderView() = default;
 
+void RenderView::invalidateFrame()
+{
+  m_frameInvalid = true;
+  update();
+}
+
 void RenderView::keyPressEvent(QKeyEvent* event)
 {
   m_eventRecorder.recordEvent(*event);
-  update();
+  invalidateFrame();
 }
 
 void RenderView::keyReleaseEvent(QKeyEvent* event)
 {
   m_eventRecorder.recordEvent(*event);
-  update();
+  invalidateFrame();
 }
 
 static auto mouseEventWithFullPrecisionLocalPos(
@@ -154,31 +163,31 @@ static auto mouseEventWithFullPrecisionLocalPos(
 void RenderView::mouseDoubleClickEvent(QMouseEvent* event)
 {
   m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
-  update();
+  invalidateFrame();
 }
 
 void RenderView::mouseMoveEvent(QMouseEvent* event)
 {
   m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
-  update();
+  invalidateFrame();
 }
 
 void RenderView::mousePressEvent(QMouseEvent* event)
 {
   m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
-  update();
+  invalidateFrame();
 }
 
 void RenderView::mouseReleaseEvent(QMouseEvent* event)
 {
   m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
-  update();
+  invalidateFrame();
 }
 
 void RenderView::wheelEvent(QWheelEvent* event)
 {
   m_eventRecorder.recordEvent(*event);
-  update();
+  invalidateFrame();
 }
 
 bool RenderView::event(QEvent* event)
@@ -189,7 +198,7 @@ bool RenderView::event(QEvent* event)
   {
     const auto gestureEvent = static_cast<QNativeGestureEvent*>(event);
     m_eventRecorder.recordEvent(*gestureEvent);
-    update();
+    invalidateFrame();
     return true;
   }
 
@@ -251,11 +260,14 @@ bool RenderView::multisample() const
 
 void RenderView::initializeGL()
 {
+  m_frameInvalid = true;
   doInitializeGL();
 }
 
 void RenderView::resizeGL(int w, int h)
 {
+  m_frameInvalid = true;
+
   // These are in points, not pixels
   updateViewport(0, 0, w, h);
 }
@@ -263,9 +275,18 @@ void RenderView::resizeGL(int w, int h)
 void RenderView::render()
 {
   processInput();
+
+  if (!m_frameInvalid && doSkipUnchangedFrames())
+  {
+    return;
+  }
+  m_frameInvalid = false;
+
   clearBackground();
   renderContents();
   renderFocusIndicator();
+
+  vboManager().finishFrame();
 }
 
 void RenderView::processInput()
@@ -344,6 +365,11 @@ bool RenderView::doInitializeGL()
   return m_glContext->initialize();
 }
 
+bool RenderView::doSkipUnchangedFrames() const
+{
+  return false;
+}
+
 void RenderView::updateViewport(
   const int /* x */, const int /* y */, const int /* width */, const int /* height */)
 {
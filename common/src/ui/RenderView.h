@@ -52,6 +52,9 @@ private:
   GLContextManager* m_glContext;
   InputEventRecorder m_eventRecorder;
 
+  // whether anything that affects the rendered image changed since the last frame
+  bool m_frameInvalid = true;
+
 private: // FPS counter
   // stats since the last counter update
   int m_framesRendered = 0;
@@ -69,6 +72,12 @@ protected:
 public:
   ~RenderView() override;
 
+  /**
+   * Marks the contents of this view as changed and schedules a repaint. Views that skip
+   * unchanged frames only render a new frame after this was called.
+   */
+  void invalidateFrame();
+
 protected: // QWindow overrides
   void keyPressEvent(QKeyEvent* event) override;
   void keyReleaseEvent(QKeyEvent* event) override;
@@ -95,13 +104,21 @@ protected: // QOpenGLWidget overrides
 private:
   void render();
   void processInput();
-  void clearBackground();
   void renderFocusIndicator();
 
 protected:
+  void clearBackground();
+
   // called by initializeGL by default
   virtual bool doInitializeGL();
 
+  /**
+   * Whether repaints are skipped unless the frame was invalidated, e.g. when Qt repaints
+   * the widget or when a notification that doesn't affect this view was received. The
+   * previous frame remains visible in that case.
+   */
+  virtual bool doSkipUnchangedFrames() const;
+
 private:
   virtual const Color& getBackgroundColor();
   virtual void updateViewport(int x, int y, int width, int height);
@@ -30,10 +30,10 @@
 #include "mdl/Map_Brushes.h"
 #include "mdl/Map_Selection.h"
 #include "mdl/Material.h"
-#include "mdl/NodeQueries.h"
+#include "mdl/MaterialIndex.h"
 #include "mdl/PushSelection.h"
 #include "mdl/Transaction.h"
-#include "mdl/WorldNode.h" // IWYU pragma: keep
+#include "mdl/WorldNode.h"
 #include "ui/BorderLine.h"
 #include "ui/MapDocument.h"
 #include "ui/MaterialBrowser.h"
@@ -121,7 +121,7 @@ std::vector<mdl::BrushFaceHandle> ReplaceMaterialDialog::getApplicableFaces() co
   auto faces = map.selection().allBrushFaces();
   if (faces.empty())
   {
-    faces = mdl::collectBrushFaces({map.world()});
+    faces = map.world()->materialIndex().findBrushFaces(subject->name());
   }
 
   return faces | std::views::filter([&](const auto& handle) {
@@ -29,6 +29,10 @@
 #include "ui/RotateHandle.h"
 #include "ui/RotateToolPage.h"
 
+#include "vm/mat_ext.h"
+
+#include <utility>
+
 namespace tb::ui
 {
 
@@ -108,13 +112,24 @@ void RotateTool::beginRotation()
 
 void RotateTool::commitRotation()
 {
-  m_map.commitTransaction();
+  if (const auto rotation = std::exchange(m_rotation, std::nullopt);
+      rotation && !transformSelection(m_map, "Rotate Objects", *rotation))
+  {
+    m_map.cancelTransaction();
+  }
+  else
+  {
+    m_map.commitTransaction();
+  }
+  refreshViews();
   rotationCenterWasUsedNotifier(rotationCenter());
 }
 
 void RotateTool::cancelRotation()
 {
+  m_rotation = std::nullopt;
   m_map.cancelTransaction();
+  refreshViews();
 }
 
 double RotateTool::snapRotationAngle(const double angle) const
@@ -125,8 +140,14 @@ double RotateTool::snapRotationAngle(const double angle) const
 void RotateTool::applyRotation(
   const vm::vec3d& center, const vm::vec3d& axis, const double angle)
 {
-  m_map.rollbackTransaction();
-  rotateSelection(m_map, center, axis, angle);
+  m_rotation = vm::translation_matrix(center) * vm::rotation_matrix(axis, angle)
+               * vm::translation_matrix(-center);
+  refreshViews();
+}
+
+const std::optional<vm::mat4x4d>& RotateTool::previewTransformation() const
+{
+  return m_rotation;
 }
 
 mdl::Hit RotateTool::pick2D(const vm::ray3d& pickRay, const render::Camera& camera)
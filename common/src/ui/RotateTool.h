@@ -22,8 +22,11 @@
 #include "ui/RotateHandle.h"
 #include "ui/Tool.h"
 
+#include "vm/mat.h"
 #include "vm/scalar.h"
 
+#include <optional>
+
 namespace tb::mdl
 {
 class Grid;
@@ -46,6 +49,7 @@ private:
   mdl::Map& m_map;
   RotateHandle m_handle;
   double m_angle = vm::to_radians(15.0);
+  std::optional<vm::mat4x4d> m_rotation;
 
 public:
   Notifier<vm::vec3d> rotationCenterDidChangeNotifier;
@@ -75,8 +79,18 @@ public:
   void cancelRotation();
 
   double snapRotationAngle(double angle) const;
+
+  /**
+   * Sets the rotation of the selection for the current drag. The selection is only
+   * rendered rotated until the rotation is committed, when it is applied to the map.
+   */
   void applyRotation(const vm::vec3d& center, const vm::vec3d& axis, double angle);
 
+  /**
+   * Returns the rotation of the selection while a rotation is in progress.
+   */
+  const std::optional<vm::mat4x4d>& previewTransformation() const;
+
   mdl::Hit pick2D(const vm::ray3d& pickRay, const render::Camera& camera);
   mdl::Hit pick3D(const vm::ray3d& pickRay, const render::Camera& camera);
 
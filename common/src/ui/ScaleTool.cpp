@@ -37,6 +37,7 @@
 
 #include "vm/bbox.h"
 #include "vm/distance.h"
+#include "vm/mat_ext.h"
 #include "vm/polygon.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
@@ -781,11 +782,23 @@ void ScaleTool::pick3D(
 
 vm::bbox3d ScaleTool::bounds() const
 {
+  if (m_resizing && m_bboxDuringDrag)
+  {
+    return *m_bboxDuringDrag;
+  }
+
   const auto& bounds = m_map.selectionBounds();
   ensure(bounds, "selection bounds are available");
   return *bounds;
 }
 
+std::optional<vm::mat4x4d> ScaleTool::previewTransformation() const
+{
+  return m_resizing && m_bboxDuringDrag
+           ? std::optional{vm::scale_bbox_matrix(m_bboxAtDragStart, *m_bboxDuringDrag)}
+           : std::nullopt;
+}
+
 std::vector<vm::polygon3f> ScaleTool::polygonsHighlightedByDrag() const
 {
   auto sides = std::vector<BBoxSide>{};
@@ -1020,6 +1033,7 @@ void ScaleTool::startScaleWithHit(const mdl::Hit& hit)
   m_bboxAtDragStart = bounds();
   m_dragStartHit = hit;
   m_dragCumulativeDelta = vm::vec3d{0, 0, 0};
+  m_bboxDuringDrag = std::nullopt;
 
   m_map.startTransaction("Scale Objects", mdl::TransactionScope::LongRunning);
   m_resizing = true;
@@ -1038,15 +1052,19 @@ void ScaleTool::scaleByDelta(const vm::vec3d& delta)
     m_proportionalAxes,
     m_anchorPos);
 
+  // the selection is only scaled when the scale is committed
   if (!newBox.is_empty())
   {
-    scaleSelection(m_map, bounds(), newBox);
+    m_bboxDuringDrag = newBox;
+    refreshViews();
   }
 }
 
 void ScaleTool::commitScale()
 {
-  if (vm::is_zero(m_dragCumulativeDelta, vm::Cd::almost_zero()))
+  if (
+    vm::is_zero(m_dragCumulativeDelta, vm::Cd::almost_zero()) || !m_bboxDuringDrag
+    || !scaleSelection(m_map, m_bboxAtDragStart, *m_bboxDuringDrag))
   {
     m_map.cancelTransaction();
   }
@@ -1055,12 +1073,16 @@ void ScaleTool::commitScale()
     m_map.commitTransaction();
   }
   m_resizing = false;
+  m_bboxDuringDrag = std::nullopt;
+  refreshViews();
 }
 
 void ScaleTool::cancelScale()
 {
   m_map.cancelTransaction();
   m_resizing = false;
+  m_bboxDuringDrag = std::nullopt;
+  refreshViews();
 }
 
 QWidget* ScaleTool::doCreatePage(QWidget* parent)
@@ -28,12 +28,14 @@
 
 #include "vm/bbox.h"
 #include "vm/line.h"
+#include "vm/mat.h"
 #include "vm/polygon.h"
 #include "vm/ray.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
 
 #include <bitset>
+#include <optional>
 #include <vector>
 
 namespace tb::mdl
@@ -236,6 +238,7 @@ private:
   vm::bbox3d m_bboxAtDragStart;
   mdl::Hit m_dragStartHit = mdl::Hit::NoHit;
   vm::vec3d m_dragCumulativeDelta;
+  std::optional<vm::bbox3d> m_bboxDuringDrag;
   ProportionalAxes m_proportionalAxes = ProportionalAxes::None();
 
 public:
@@ -263,8 +266,18 @@ public:
     mdl::PickResult& pickResult) const;
 
 public:
+  /**
+   * Returns the bounds of the selection, or the scaled bounds while a scale is in
+   * progress.
+   */
   vm::bbox3d bounds() const;
 
+  /**
+   * Returns the scale of the selection while a scale is in progress. The selection is
+   * only rendered scaled until the scale is committed, when it is applied to the map.
+   */
+  std::optional<vm::mat4x4d> previewTransformation() const;
+
 public:
   std::vector<vm::polygon3f> polygonsHighlightedByDrag() const;
 
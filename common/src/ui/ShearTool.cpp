@@ -32,6 +32,7 @@
 #include "ui/ScaleTool.h"
 
 #include "vm/intersection.h"
+#include "vm/mat_ext.h"
 
 namespace tb::ui
 {
@@ -181,9 +182,18 @@ void ShearTool::commitShear()
   }
   else
   {
-    m_map.commitTransaction();
+    const auto side = m_dragStartHit.target<BBoxSide>();
+    if (shearSelection(m_map, m_bboxAtDragStart, side.normal, m_dragCumulativeDelta))
+    {
+      m_map.commitTransaction();
+    }
+    else
+    {
+      m_map.cancelTransaction();
+    }
   }
   m_resizing = false;
+  refreshViews();
 }
 
 void ShearTool::cancelShear()
@@ -192,19 +202,16 @@ void ShearTool::cancelShear()
 
   m_map.cancelTransaction();
   m_resizing = false;
+  refreshViews();
 }
 
 void ShearTool::shearByDelta(const vm::vec3d& delta)
 {
   ensure(m_resizing, "must be resizing already");
 
+  // the selection is only sheared when the shear is committed
   m_dragCumulativeDelta = m_dragCumulativeDelta + delta;
-
-  if (!vm::is_zero(delta, vm::Cd::almost_zero()))
-  {
-    const auto side = m_dragStartHit.target<BBoxSide>();
-    shearSelection(m_map, bounds(), side.normal, delta);
-  }
+  refreshViews();
 }
 
 const mdl::Hit& ShearTool::dragStartHit() const
@@ -224,6 +231,13 @@ vm::mat4x4d ShearTool::bboxShearMatrix() const
   return vm::shear_bbox_matrix(m_bboxAtDragStart, side.normal, m_dragCumulativeDelta);
 }
 
+std::optional<vm::mat4x4d> ShearTool::previewTransformation() const
+{
+  return m_resizing && !vm::is_zero(m_dragCumulativeDelta, vm::Cd::almost_zero())
+           ? std::optional{bboxShearMatrix()}
+           : std::nullopt;
+}
+
 std::optional<vm::polygon3f> ShearTool::shearHandle() const
 {
   // happens if you cmd+drag on an edge or corner
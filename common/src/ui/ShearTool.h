@@ -97,6 +97,13 @@ public:
   const mdl::Hit& dragStartHit() const;
 
   vm::mat4x4d bboxShearMatrix() const;
+
+  /**
+   * Returns the shear of the selection while a shear is in progress. The selection is
+   * only rendered sheared until the shear is committed, when it is applied to the map.
+   */
+  std::optional<vm::mat4x4d> previewTransformation() const;
+
   std::optional<vm::polygon3f> shearHandle() const;
 
   void updatePickedSide(const mdl::PickResult& pickResult);
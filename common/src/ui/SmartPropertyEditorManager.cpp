@@ -152,8 +152,8 @@ void SmartPropertyEditorManager::connectObservers()
   auto& map = m_document.map();
   m_notifierConnection += map.selectionDidChangeNotifier.connect(
     this, &SmartPropertyEditorManager::selectionDidChange);
-  m_notifierConnection +=
-    map.nodesDidChangeNotifier.connect(this, &SmartPropertyEditorManager::nodesDidChange);
+  m_notifierConnection += map.nodesDidChangeBatchedNotifier.connect(
+    this, &SmartPropertyEditorManager::nodesDidChange);
 }
 
 void SmartPropertyEditorManager::selectionDidChange(const mdl::SelectionChange&)
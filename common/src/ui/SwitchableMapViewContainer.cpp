@@ -21,6 +21,7 @@
 
 #include <QGridLayout>
 
+#include "MemoryReport.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "mdl/Map.h"
@@ -344,6 +345,11 @@ void SwitchableMapViewContainer::toggleMaximizeCurrentView()
   m_mapView->toggleMaximizeCurrentView();
 }
 
+void SwitchableMapViewContainer::addToMemoryReport(MemoryReport& report) const
+{
+  m_mapRenderer->addToMemoryReport(report);
+}
+
 void SwitchableMapViewContainer::connectObservers()
 {
   m_notifierConnection +=
@@ -25,6 +25,11 @@
 #include "NotifierConnection.h"
 #include "ui/MapView.h"
 
+namespace tb
+{
+class MemoryReport;
+}
+
 namespace tb::render
 {
 class MapRenderer;
@@ -120,6 +125,8 @@ public:
   bool currentViewMaximized() const;
   void toggleMaximizeCurrentView();
 
+  void addToMemoryReport(MemoryReport& report) const;
+
 private:
   void connectObservers();
   void refreshViews(Tool& tool);
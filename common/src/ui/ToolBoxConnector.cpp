@@ -27,6 +27,8 @@
 #include "ui/ToolChain.h"
 #include "ui/ToolController.h"
 
+#include "vm/ray.h"
+
 #include <string>
 
 namespace tb::ui
@@ -34,6 +36,8 @@ namespace tb::ui
 namespace
 {
 
+constexpr auto PickRayEpsilon = 0.0001;
+
 auto getScrollSource(const ScrollEvent& event)
 {
   switch (event.source)
@@ -70,11 +74,46 @@ void ToolBoxConnector::updatePickResult()
   ensure(m_toolBox, "toolBox is set");
 
   m_inputState.setPickRequest(pickRequest(m_inputState.mouseX(), m_inputState.mouseY()));
-  auto pickResult = pick(m_inputState.pickRay());
+  m_pickResultInvalid = false;
+
+  // Picking the map is expensive, so reuse the last result if the ray didn't change. The
+  // tools must pick again because their state may have changed in the meantime.
+  const auto& pickRay = m_inputState.pickRay();
+  if (
+    !m_cachedPickResult || !m_cachedPickRay
+    || !vm::is_equal(*m_cachedPickRay, pickRay, PickRayEpsilon))
+  {
+    m_cachedPickRay = pickRay;
+    m_cachedPickResult = pick(pickRay);
+  }
+
+  auto pickResult = *m_cachedPickResult;
   m_toolBox->pick(*m_toolChain, m_inputState, pickResult);
   m_inputState.setPickResult(std::move(pickResult));
 }
 
+void ToolBoxConnector::invalidatePickResult()
+{
+  // the current hits may refer to nodes that were just removed
+  m_inputState.setPickResult(mdl::PickResult{});
+  discardCachedPickResult();
+  m_pickResultInvalid = true;
+}
+
+void ToolBoxConnector::validatePickResult()
+{
+  if (m_pickResultInvalid)
+  {
+    updatePickResult();
+  }
+}
+
+void ToolBoxConnector::discardCachedPickResult()
+{
+  m_cachedPickRay = std::nullopt;
+  m_cachedPickResult = std::nullopt;
+}
+
 void ToolBoxConnector::setToolBox(ToolBox& toolBox)
 {
   assert(!m_toolBox);
@@ -216,6 +255,7 @@ void ToolBoxConnector::showPopupMenu()
 
 void ToolBoxConnector::processEvent(const KeyEvent&)
 {
+  validatePickResult();
   updateModifierKeys();
 }
 
@@ -254,6 +294,7 @@ void ToolBoxConnector::processEvent(const MouseEvent& event)
 
 void ToolBoxConnector::processEvent(const ScrollEvent& event)
 {
+  validatePickResult();
   updateModifierKeys();
   const auto scrollSource = getScrollSource(event);
   if (event.axis == ScrollEvent::Axis::Horizontal)
@@ -271,6 +312,7 @@ void ToolBoxConnector::processEvent(const ScrollEvent& event)
 
 void ToolBoxConnector::processEvent(const GestureEvent& event)
 {
+  validatePickResult();
   switch (event.type)
   {
   case GestureEvent::Type::Start:
@@ -299,6 +341,7 @@ void ToolBoxConnector::processEvent(const CancelEvent&)
 
 void ToolBoxConnector::processMouseButtonDown(const MouseEvent& event)
 {
+  validatePickResult();
   updateModifierKeys();
   m_inputState.mouseDown(mouseButton(event));
   m_toolBox->mouseDown(*m_toolChain, m_inputState);
@@ -309,6 +352,7 @@ void ToolBoxConnector::processMouseButtonDown(const MouseEvent& event)
 
 void ToolBoxConnector::processMouseButtonUp(const MouseEvent& event)
 {
+  validatePickResult();
   updateModifierKeys();
   m_toolBox->mouseUp(*m_toolChain, m_inputState);
   m_inputState.mouseUp(mouseButton(event));
@@ -319,6 +363,7 @@ void ToolBoxConnector::processMouseButtonUp(const MouseEvent& event)
 
 void ToolBoxConnector::processMouseClick(const MouseEvent& event)
 {
+  validatePickResult();
   const auto handled = m_toolBox->mouseClick(*m_toolChain, m_inputState);
   if (event.button == MouseEvent::Button::Right && !handled)
   {
@@ -332,6 +377,7 @@ void ToolBoxConnector::processMouseClick(const MouseEvent& event)
 
 void ToolBoxConnector::processMouseDoubleClick(const MouseEvent& event)
 {
+  validatePickResult();
   updateModifierKeys();
   m_inputState.mouseDown(mouseButton(event));
   m_toolBox->mouseDoubleClick(*m_toolChain, m_inputState);
@@ -61,6 +61,10 @@ private:
 
   std::optional<vm::vec2f> m_lastGesturePanPos;
 
+  bool m_pickResultInvalid = false;
+  std::optional<vm::ray3d> m_cachedPickRay;
+  std::optional<mdl::PickResult> m_cachedPickResult;
+
 public:
   ToolBoxConnector();
   ~ToolBoxConnector() override;
@@ -71,6 +75,25 @@ public:
 
   void updatePickResult();
 
+  /**
+   * Clears the pick result and requests that it be updated when validatePickResult is
+   * called next. Call this when the map changed in a way that may affect picking; several
+   * invalidations are coalesced into a single pick.
+   */
+  void invalidatePickResult();
+
+  /**
+   * Updates the pick result if it was invalidated since the last update.
+   */
+  void validatePickResult();
+
+protected:
+  /**
+   * Discards the cached pick result of the map so that the next update picks the map
+   * again even if the pick ray didn't change.
+   */
+  void discardCachedPickResult();
+
 protected:
   void setToolBox(ToolBox& toolBox);
   void addToolController(std::unique_ptr<ToolController> toolController);
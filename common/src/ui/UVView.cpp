@@ -29,6 +29,7 @@
 #include "mdl/Texture.h"
 #include "render/ActiveShader.h"
 #include "render/Camera.h"
+#include "render/ColorFramebuffer.h"
 #include "render/EdgeRenderer.h"
 #include "render/FaceRenderer.h"
 #include "render/GLVertexType.h"
@@ -48,6 +49,7 @@
 #include "ui/UVScaleTool.h"
 #include "ui/UVShearTool.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <vector>
@@ -156,9 +158,17 @@ UVView::UVView(MapDocument& document, GLContextManager& contextManager)
   connectObservers();
 }
 
+UVView::~UVView()
+{
+  // deleting the material layer deletes its framebuffer
+  makeCurrent();
+  m_materialLayer.reset();
+}
+
 void UVView::setSubDivisions(const vm::vec2i& subDivisions)
 {
   m_helper.setSubDivisions(subDivisions);
+  invalidateMaterialLayer();
   update();
 }
 
@@ -194,6 +204,8 @@ void UVView::connectObservers()
     map.selectionDidChangeNotifier.connect(this, &UVView::selectionDidChange);
   m_notifierConnection +=
     map.grid().gridDidChangeNotifier.connect(this, &UVView::gridDidChange);
+  m_notifierConnection += map.materialCollectionsDidChangeNotifier.connect(
+    this, &UVView::materialCollectionsDidChange);
 
   auto& prefs = PreferenceManager::instance();
   m_notifierConnection +=
@@ -205,6 +217,8 @@ void UVView::connectObservers()
 
 void UVView::selectionDidChange(const mdl::SelectionChange&)
 {
+  discardCachedPickResult();
+
   const auto& map = m_document.map();
   const auto faces = map.selection().brushFaces;
   if (faces.size() != 1)
@@ -215,6 +229,7 @@ void UVView::selectionDidChange(const mdl::SelectionChange&)
   {
     m_helper.setFaceHandle(faces.back());
   }
+  invalidateMaterialLayer();
 
   if (m_helper.valid())
   {
@@ -230,18 +245,24 @@ void UVView::selectionDidChange(const mdl::SelectionChange&)
 
 void UVView::mapWasCleared(mdl::Map&)
 {
+  discardCachedPickResult();
   m_helper.setFaceHandle(std::nullopt);
   m_toolBox.disable();
+  invalidateMaterialLayer();
   update();
 }
 
 void UVView::nodesDidChange(const std::vector<mdl::Node*>&)
 {
+  discardCachedPickResult();
+  invalidateMaterialLayer();
   update();
 }
 
 void UVView::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>&)
 {
+  discardCachedPickResult();
+  invalidateMaterialLayer();
   update();
 }
 
@@ -252,14 +273,27 @@ void UVView::gridDidChange()
 
 void UVView::preferenceDidChange(const std::filesystem::path&)
 {
+  invalidateMaterialLayer();
+  update();
+}
+
+void UVView::materialCollectionsDidChange()
+{
+  invalidateMaterialLayer();
   update();
 }
 
 void UVView::cameraDidChange(const render::Camera*)
 {
+  invalidateMaterialLayer();
   update();
 }
 
+void UVView::invalidateMaterialLayer()
+{
+  m_materialLayerValid = false;
+}
+
 void UVView::updateViewport(int x, int y, int width, int height)
 {
   if (m_camera.setViewport({x, y, width, height}))
@@ -270,6 +304,8 @@ void UVView::updateViewport(int x, int y, int width, int height)
 
 void UVView::renderContents()
 {
+  discardCachedPickResult();
+
   if (m_helper.valid())
   {
     auto renderContext = render::RenderContext{
@@ -326,12 +362,49 @@ void UVView::setupGL(render::RenderContext& renderContext)
   glAssert(glDisable(GL_DEPTH_TEST));
 }
 
-void UVView::renderMaterial(render::RenderContext&, render::RenderBatch& renderBatch)
+void UVView::renderMaterial(
+  render::RenderContext& renderContext, render::RenderBatch& renderBatch)
 {
-  if (getTexture(m_helper.face()->material()))
+  const auto* texture = getTexture(m_helper.face()->material());
+  if (!texture)
+  {
+    return;
+  }
+
+  // The material layer only changes with the face, the camera and the preferences, but
+  // resampling a large texture for every mouse event from the UV tools is expensive. It
+  // is rendered into an offscreen framebuffer once and copied in every frame, and only
+  // the face outline, the UV axes and the tool handles are rendered again.
+  if (!m_materialLayer)
+  {
+    m_materialLayer = std::make_unique<render::ColorFramebuffer>();
+  }
+
+  const auto& viewport = renderContext.camera().viewport();
+  const auto r = devicePixelRatioF();
+  const auto width = GLsizei(viewport.width * r);
+  const auto height = GLsizei(viewport.height * r);
+  const auto samples = GLsizei(std::max(0, context()->format().samples()));
+
+  if (!m_materialLayerValid || !m_materialLayer->matches(width, height, samples))
   {
-    renderBatch.addOneShot(new RenderMaterial{m_helper});
+    if (!m_materialLayer->bind(width, height, samples))
+    {
+      renderBatch.addOneShot(new RenderMaterial{m_helper});
+      return;
+    }
+
+    clearBackground();
+
+    auto materialBatch = render::RenderBatch{vboManager()};
+    materialBatch.addOneShot(new RenderMaterial{m_helper});
+    materialBatch.render(renderContext);
+
+    // a texture that isn't uploaded yet renders nothing, so it must be rendered again
+    m_materialLayerValid = texture->isReady();
   }
+
+  m_materialLayer->blitTo(defaultFramebufferObject());
 }
 
 void UVView::renderFace(render::RenderContext&, render::RenderBatch& renderBatch)
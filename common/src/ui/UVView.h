@@ -29,6 +29,7 @@
 #include "ui/UVViewHelper.h"
 
 #include <filesystem>
+#include <memory>
 #include <vector>
 
 class QWidget;
@@ -45,6 +46,7 @@ struct SelectionChange;
 namespace tb::render
 {
 class ActiveShader;
+class ColorFramebuffer;
 class RenderBatch;
 class RenderContext;
 } // namespace tb::render
@@ -78,10 +80,14 @@ private:
 
   ToolBox m_toolBox;
 
+  std::unique_ptr<render::ColorFramebuffer> m_materialLayer;
+  bool m_materialLayerValid = false;
+
   NotifierConnection m_notifierConnection;
 
 public:
   UVView(MapDocument& document, GLContextManager& contextManager);
+  ~UVView() override;
 
   void setSubDivisions(const vm::vec2i& subDivisions);
 
@@ -99,6 +105,9 @@ private:
   void gridDidChange();
   void cameraDidChange(const render::Camera* camera);
   void preferenceDidChange(const std::filesystem::path& path);
+  void materialCollectionsDidChange();
+
+  void invalidateMaterialLayer();
 
   void updateViewport(int x, int y, int width, int height) override;
   void renderContents() override;
@@ -189,7 +189,8 @@ public: // Handle selection
   void select(const Lasso& lasso, const bool modifySelection)
   {
     auto selectedHandles = std::vector<H>{};
-    lasso.selected(handleManager().allHandles(), std::back_inserter(selectedHandles));
+    lasso.selected(
+      handleManager().findHandles(lasso.volume()), std::back_inserter(selectedHandles));
 
     if (!modifySelection)
     {
@@ -471,6 +471,9 @@ QWidget* ViewEditor::createRendererPanel(QWidget* parent)
   m_shadeFacesCheckBox = new QCheckBox{tr("Shade faces")};
   m_showFogCheckBox = new QCheckBox{tr("Use fog")};
   m_showEdgesCheckBox = new QCheckBox{tr("Show edges")};
+  m_cullWithPortalFileCheckBox = new QCheckBox{tr("Cull with portal file")};
+  m_cullWithPortalFileCheckBox->setToolTip(
+    tr("Only render what can be seen through the portals of the loaded portal file"));
 
 
   const auto EntityLinkModes = std::vector<std::tuple<QString, QString>>{
@@ -504,6 +507,11 @@ QWidget* ViewEditor::createRendererPanel(QWidget* parent)
     m_showFogCheckBox, &QAbstractButton::clicked, this, &ViewEditor::showFogChanged);
   connect(
     m_showEdgesCheckBox, &QAbstractButton::clicked, this, &ViewEditor::showEdgesChanged);
+  connect(
+    m_cullWithPortalFileCheckBox,
+    &QAbstractButton::clicked,
+    this,
+    &ViewEditor::cullWithPortalFileChanged);
 
   connect(
     m_renderModeRadioGroup,
@@ -539,6 +547,7 @@ QWidget* ViewEditor::createRendererPanel(QWidget* parent)
   layout->addWidget(m_shadeFacesCheckBox);
   layout->addWidget(m_showFogCheckBox);
   layout->addWidget(m_showEdgesCheckBox);
+  layout->addWidget(m_cullWithPortalFileCheckBox);
 
   for (auto* button : m_entityLinkRadioGroup->buttons())
   {
@@ -596,6 +605,7 @@ void ViewEditor::refreshRendererPanel()
   m_shadeFacesCheckBox->setChecked(pref(Preferences::ShadeFaces));
   m_showFogCheckBox->setChecked(pref(Preferences::ShowFog));
   m_showEdgesCheckBox->setChecked(pref(Preferences::ShowEdges));
+  m_cullWithPortalFileCheckBox->setChecked(pref(Preferences::CullWithPortalFile));
   checkButtonInGroup(m_entityLinkRadioGroup, pref(Preferences::EntityLinkMode), true);
   m_showSoftBoundsCheckBox->setChecked(pref(Preferences::ShowSoftMapBounds));
 }
@@ -686,6 +696,11 @@ void ViewEditor::showEdgesChanged(const bool checked)
   setPref(Preferences::ShowEdges, checked);
 }
 
+void ViewEditor::cullWithPortalFileChanged(const bool checked)
+{
+  setPref(Preferences::CullWithPortalFile, checked);
+}
+
 void ViewEditor::entityLinkModeChanged(const int id)
 {
   switch (id)
@@ -723,6 +738,7 @@ void ViewEditor::restoreDefaultsClicked()
   prefs.resetToDefault(Preferences::ShowFog);
   prefs.resetToDefault(Preferences::ShowEdges);
   prefs.resetToDefault(Preferences::ShowSoftMapBounds);
+  prefs.resetToDefault(Preferences::CullWithPortalFile);
   prefs.resetToDefault(Preferences::ShowPointEntities);
   prefs.resetToDefault(Preferences::ShowBrushes);
   prefs.resetToDefault(Preferences::EntityLinkMode);
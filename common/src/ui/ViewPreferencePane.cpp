@@ -155,6 +155,12 @@ QWidget* ViewPreferencePane::createViewPreferences()
   m_enableMsaa = new QCheckBox{};
   m_enableMsaa->setToolTip("Enable multisampling");
 
+  m_reverseDepth = new QCheckBox{};
+  m_reverseDepth->setToolTip(
+    "Render the 3D view with a floating point depth buffer and reversed depth values. "
+    "This reduces flickering of distant surfaces in large maps, but requires OpenGL "
+    "4.5 or the ARB_clip_control extension.");
+
   m_materialBrowserIconSizeCombo = new QComboBox{};
   m_materialBrowserIconSizeCombo->addItem("25%");
   m_materialBrowserIconSizeCombo->addItem("50%");
@@ -196,6 +202,7 @@ QWidget* ViewPreferencePane::createViewPreferences()
   layout->addRow("Show axes", m_showAxes);
   layout->addRow("Filter mode", m_filterModeCombo);
   layout->addRow("Enable multisampling", m_enableMsaa);
+  layout->addRow("Reverse depth", m_reverseDepth);
 
   layout->addSection("Material Browser");
   layout->addRow("Icon size", m_materialBrowserIconSizeCombo);
@@ -243,6 +250,11 @@ void ViewPreferencePane::bindEvents()
     &QCheckBox::checkStateChanged,
     this,
     &ViewPreferencePane::enableMsaaChanged);
+  connect(
+    m_reverseDepth,
+    &QCheckBox::checkStateChanged,
+    this,
+    &ViewPreferencePane::reverseDepthChanged);
   connect(
     m_themeCombo,
     QOverload<int>::of(&QComboBox::activated),
@@ -280,6 +292,7 @@ void ViewPreferencePane::doResetToDefaults()
   prefs.resetToDefault(Preferences::CameraFov);
   prefs.resetToDefault(Preferences::ShowAxes);
   prefs.resetToDefault(Preferences::EnableMSAA);
+  prefs.resetToDefault(Preferences::ReverseDepth);
   prefs.resetToDefault(Preferences::TextureMinFilter);
   prefs.resetToDefault(Preferences::TextureMagFilter);
   prefs.resetToDefault(Preferences::Theme);
@@ -303,6 +316,7 @@ void ViewPreferencePane::updateControls()
 
   m_showAxes->setChecked(pref(Preferences::ShowAxes));
   m_enableMsaa->setChecked(pref(Preferences::EnableMSAA));
+  m_reverseDepth->setChecked(pref(Preferences::ReverseDepth));
   m_themeCombo->setCurrentIndex(findThemeIndex(pref(Preferences::Theme)));
 
   const auto materialBrowserIconSize = pref(Preferences::MaterialBrowserIconSize);
@@ -405,6 +419,13 @@ void ViewPreferencePane::enableMsaaChanged(const int state)
   prefs.set(Preferences::EnableMSAA, value);
 }
 
+void ViewPreferencePane::reverseDepthChanged(const int state)
+{
+  const auto value = state == Qt::Checked;
+  auto& prefs = PreferenceManager::instance();
+  prefs.set(Preferences::ReverseDepth, value);
+}
+
 void ViewPreferencePane::filterModeChanged(const int value)
 {
   const auto index = static_cast<size_t>(value);
@@ -21,7 +21,9 @@
 #include "el/EvaluationContext.h"
 #include "el/Types.h"
 #include "el/Value.h"
+#include "el/VariableStore.h"
 
+#include <memory>
 #include <string>
 
 #include <catch2/catch_test_macros.hpp>
@@ -137,4 +139,28 @@ TEST_CASE("ELTest.serializeValues")
   CHECK(Value(16.0).asString() == std::string("16"));
 }
 
+TEST_CASE("ELTest.variableTable")
+{
+  const auto map = Value{MapType{{"key", Value{"value"}}}};
+  auto variables = VariableTable{{{"map", map}}};
+
+  const auto clone = std::unique_ptr<VariableStore>{variables.clone()};
+  CHECK(std::hash<Value>{}(clone->value("map")) == std::hash<Value>{}(map));
+
+  SECTION("Setting a variable does not affect copies")
+  {
+    variables.set("other", Value{1.0});
+    CHECK(variables.value("other") == Value{1.0});
+    CHECK(clone->value("other") == Value::Undefined);
+    CHECK(clone->size() == 1);
+  }
+
+  SECTION("Setting a variable in a copy does not affect the original")
+  {
+    clone->set("map", Value{"overwritten"});
+    CHECK(clone->value("map") == Value{"overwritten"});
+    CHECK(variables.value("map") == map);
+  }
+}
+
 } // namespace tb::el
@@ -20,7 +20,9 @@
 
 #include "Logger.h"
 #include "io/AssimpLoader.h"
+#include "io/AssimpModelCache.h"
 #include "io/DiskFileSystem.h"
+#include "io/TestEnvironment.h"
 #include "mdl/EntityModel.h"
 
 #include "vm/approx.h"
@@ -95,6 +97,37 @@ TEST_CASE("AssimpLoader")
 
     CHECK(vm::approx(modelData.value().bounds(0)) == vm::bbox3f{{0, 0, 0}, {2, 1, 3}});
   }
+
+  SECTION("cache")
+  {
+    const auto modelPath = GENERATE(values<std::filesystem::path>({
+      "obj/cuboid.obj",
+      "gltf/cuboid.gltf",
+    }));
+
+    CAPTURE(modelPath);
+
+    const auto basePath =
+      std::filesystem::current_path() / "fixture/test/io/assimp/alignment";
+    auto fs = std::make_shared<DiskFileSystem>(basePath);
+
+    auto env = TestEnvironment{};
+    const auto cache = std::make_shared<AssimpModelCache>(env.dir() / "cache");
+
+    auto importedData = AssimpLoader{modelPath, *fs, cache}.load(logger);
+    REQUIRE(importedData.is_success());
+    CHECK(env.directoryContents("cache").size() == 1);
+
+    auto cachedData = AssimpLoader{modelPath, *fs, cache}.load(logger);
+    REQUIRE(cachedData.is_success());
+
+    REQUIRE(cachedData.value().frameCount() == importedData.value().frameCount());
+    REQUIRE(cachedData.value().surfaceCount() == importedData.value().surfaceCount());
+    CHECK(
+      cachedData.value().surface(0).skinCount()
+      == importedData.value().surface(0).skinCount());
+    CHECK(cachedData.value().bounds(0) == importedData.value().bounds(0));
+  }
 }
 
 } // namespace tb::io
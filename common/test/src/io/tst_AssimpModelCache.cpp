@@ -0,0 +1,214 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/AssimpModelCache.h"
+#include "io/DiskFileSystem.h"
+#include "io/DiskIO.h"
+#include "io/TestEnvironment.h"
+#include "render/PrimType.h"
+
+#include "kdl/result.h"
+
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+AssimpModelSource makeSource(
+  const std::filesystem::path& path, const std::string& contents)
+{
+  return makeAssimpModelSource(path, contents.data(), contents.data() + contents.size());
+}
+
+AssimpModelInfo makeModelInfo()
+{
+  auto vertices = std::vector<mdl::EntityModelVertex>{
+    mdl::EntityModelVertex{vm::vec3f{0, 0, 0}, vm::vec2f{0, 0}},
+    mdl::EntityModelVertex{vm::vec3f{1, 0, 0}, vm::vec2f{1, 0}},
+    mdl::EntityModelVertex{vm::vec3f{0, 1, 0}, vm::vec2f{0, 1}},
+  };
+
+  return AssimpModelInfo{
+    {
+      AssimpSurfaceInfo{
+        "surface",
+        {
+          AssimpTextureFile{"models/skin.png"},
+          AssimpEmbeddedTexture{1, 1, {'\x01', '\x02', '\x03', '\x04'}},
+          AssimpFallbackTexture{},
+        }},
+    },
+    {
+      AssimpFrameInfo{
+        "frame",
+        vm::bbox3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 1, 0}},
+        {AssimpMeshInfo{
+          0,
+          std::move(vertices),
+          render::IndexRangeMap{render::PrimType::Triangles, 0, 3}}}},
+    }};
+}
+
+auto primitives(const render::IndexRangeMap& indices)
+{
+  auto result = std::vector<std::tuple<render::PrimType, size_t, size_t>>{};
+  indices.forEachPrimitive([&](const auto primType, const auto index, const auto count) {
+    result.emplace_back(primType, index, count);
+  });
+  return result;
+}
+
+void checkModelInfosEqual(const AssimpModelInfo& actual, const AssimpModelInfo& expected)
+{
+  REQUIRE(actual.surfaces.size() == expected.surfaces.size());
+  for (size_t i = 0; i < actual.surfaces.size(); ++i)
+  {
+    const auto& actualSurface = actual.surfaces[i];
+    const auto& expectedSurface = expected.surfaces[i];
+    CHECK(actualSurface.name == expectedSurface.name);
+    REQUIRE(actualSurface.textures.size() == expectedSurface.textures.size());
+    for (size_t j = 0; j < actualSurface.textures.size(); ++j)
+    {
+      const auto& actualTexture = actualSurface.textures[j];
+      const auto& expectedTexture = expectedSurface.textures[j];
+      REQUIRE(actualTexture.index() == expectedTexture.index());
+      if (const auto* file = std::get_if<AssimpTextureFile>(&actualTexture))
+      {
+        CHECK(file->path == std::get<AssimpTextureFile>(expectedTexture).path);
+      }
+      else if (const auto* embedded = std::get_if<AssimpEmbeddedTexture>(&actualTexture))
+      {
+        const auto& expectedEmbedded = std::get<AssimpEmbeddedTexture>(expectedTexture);
+        CHECK(embedded->width == expectedEmbedded.width);
+        CHECK(embedded->height == expectedEmbedded.height);
+        CHECK(embedded->data == expectedEmbedded.data);
+      }
+    }
+  }
+
+  REQUIRE(actual.frames.size() == expected.frames.size());
+  for (size_t i = 0; i < actual.frames.size(); ++i)
+  {
+    const auto& actualFrame = actual.frames[i];
+    const auto& expectedFrame = expected.frames[i];
+    CHECK(actualFrame.name == expectedFrame.name);
+    CHECK(actualFrame.bounds == expectedFrame.bounds);
+    REQUIRE(actualFrame.meshes.size() == expectedFrame.meshes.size());
+    for (size_t j = 0; j < actualFrame.meshes.size(); ++j)
+    {
+      const auto& actualMesh = actualFrame.meshes[j];
+      const auto& expectedMesh = expectedFrame.meshes[j];
+      CHECK(actualMesh.surfaceIndex == expectedMesh.surfaceIndex);
+      REQUIRE(actualMesh.vertices.size() == expectedMesh.vertices.size());
+      for (size_t k = 0; k < actualMesh.vertices.size(); ++k)
+      {
+        CHECK(actualMesh.vertices[k].attr == expectedMesh.vertices[k].attr);
+        CHECK(actualMesh.vertices[k].rest.attr == expectedMesh.vertices[k].rest.attr);
+      }
+      CHECK(primitives(actualMesh.indices) == primitives(expectedMesh.indices));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("AssimpModelCache")
+{
+  const auto modelContents = std::string{"some model file contents"};
+  const auto materialContents = std::string{"some material file contents"};
+
+  auto env = TestEnvironment{[&](auto& testEnv) {
+    testEnv.createDirectory("models");
+    testEnv.createFile("models/test.obj", modelContents);
+    testEnv.createFile("models/test.mtl", materialContents);
+  }};
+
+  const auto fs = DiskFileSystem{env.dir()};
+  const auto cache = AssimpModelCache{env.dir() / "cache"};
+
+  const auto sources = std::vector<AssimpModelSource>{
+    makeSource("models/test.obj", modelContents),
+    makeSource("models/test.mtl", materialContents),
+  };
+  const auto modelInfo = makeModelInfo();
+
+  SECTION("makeAssimpModelSource")
+  {
+    CHECK(sources[0].path == "models/test.obj");
+    CHECK(sources[0].size == modelContents.size());
+    CHECK(sources[0].hash != sources[1].hash);
+  }
+
+  SECTION("load returns nothing if there is no entry")
+  {
+    CHECK(!cache.load("models/test.obj", fs).has_value());
+  }
+
+  SECTION("load returns stored model")
+  {
+    CHECK(cache.store("models/test.obj", sources, modelInfo).is_success());
+
+    const auto cachedModelInfo = cache.load("models/test.obj", fs);
+    REQUIRE(cachedModelInfo.has_value());
+    checkModelInfosEqual(*cachedModelInfo, modelInfo);
+
+    CHECK(!cache.load("models/other.obj", fs).has_value());
+  }
+
+  SECTION("load returns nothing if a source has changed")
+  {
+    CHECK(cache.store("models/test.obj", sources, modelInfo).is_success());
+
+    env.createFile("models/test.mtl", "changed material file contents");
+    CHECK(!cache.load("models/test.obj", fs).has_value());
+  }
+
+  SECTION("load returns nothing if a source was removed")
+  {
+    CHECK(cache.store("models/test.obj", sources, modelInfo).is_success());
+
+    std::filesystem::remove(env.dir() / "models/test.mtl");
+    CHECK(!cache.load("models/test.obj", fs).has_value());
+  }
+
+  SECTION("load returns nothing if the entry is corrupt")
+  {
+    CHECK(cache.store("models/test.obj", sources, modelInfo).is_success());
+
+    const auto entries = env.directoryContents("cache");
+    REQUIRE(entries.size() == 1);
+
+    Disk::withOutputStream(
+      env.dir() / entries.front(),
+      std::ios::out | std::ios::binary | std::ios::trunc,
+      [](auto& stream) { stream << "TBAM garbage"; })
+      | kdl::transform_error([](auto e) { FAIL(e.msg); });
+
+    CHECK(!cache.load("models/test.obj", fs).has_value());
+  }
+}
+
+} // namespace tb::io
@@ -29,6 +29,9 @@
 
 #include "kdl/result.h"
 
+#include "vm/bbox.h"
+#include "vm/ray.h"
+
 #include <catch2/catch_test_macros.hpp>
 
 namespace tb::io
@@ -58,6 +61,17 @@ TEST_CASE("BspLoaderTest.loadValidHlBsp")
   const auto& surface = surfaces.front();
   CHECK(surface.skinCount() == 3u);
   CHECK(surface.frameCount() == 1u);
+
+  // the sub-model mesh is built from the shared BSP geometry when first intersected
+  const auto* frame = bspData.value().frame(0);
+  REQUIRE(frame != nullptr);
+  REQUIRE(!frame->bounds().is_empty());
+
+  const auto center = frame->bounds().center();
+  const auto ray = vm::ray3f{
+    center + vm::vec3f{0, 0, frame->bounds().size().z() + 16.0f},
+    vm::vec3f{0, 0, -1}};
+  CHECK(frame->intersect(ray) != std::nullopt);
 }
 
 TEST_CASE("BspLoaderTest.loadInvalidBsp")
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/CacheUtils.h"
+#include "io/TestEnvironment.h"
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+
+TEST_CASE("fnv1a")
+{
+  const auto a = std::string{"a"};
+  const auto ab = std::string{"ab"};
+
+  CHECK(fnv1a(a.data(), a.data()) == FnvOffsetBasis);
+  CHECK(fnv1a(a.data(), a.data() + a.size()) == 0xaf63dc4c8601ec8cull);
+
+  const auto hash = fnv1a(a.data(), a.data() + a.size());
+  CHECK(fnv1a('b', hash) == fnv1a(ab.data(), ab.data() + ab.size()));
+}
+
+TEST_CASE("writeCacheEntry")
+{
+  auto env = TestEnvironment{};
+
+  SECTION("writes the entry and creates the directory")
+  {
+    CHECK(writeCacheEntry(env.dir() / "cache" / "entry", [](auto& stream) {
+            stream << "contents";
+          }).is_success());
+
+    CHECK(
+      env.directoryContents("cache")
+      == std::vector<std::filesystem::path>{"cache/entry"});
+    CHECK(env.loadFile("cache/entry") == "contents");
+  }
+
+  SECTION("replaces an existing entry")
+  {
+    env.createDirectory("cache");
+    env.createFile("cache/entry", "old contents");
+
+    CHECK(writeCacheEntry(env.dir() / "cache" / "entry", [](auto& stream) {
+            stream << "new contents";
+          }).is_success());
+
+    CHECK(env.loadFile("cache/entry") == "new contents");
+  }
+
+  SECTION("removes the temporary file if writing fails")
+  {
+    CHECK(writeCacheEntry(env.dir() / "cache" / "entry", [](auto& stream) {
+            stream.setstate(std::ios::failbit);
+          }).is_error());
+
+    CHECK(env.directoryContents("cache").empty());
+  }
+}
+
+} // namespace tb::io
@@ -377,6 +377,76 @@ TEST_CASE("CompilationConfigParser")
       }});
   }
 
+  SECTION("parseConcurrentTasksWithCpuBudget")
+  {
+    const auto config = R"(
+{
+  'version': 1,
+  'profiles': [{
+      'name' : 'A profile',
+      'workdir' : '',
+      'tasks' : [{
+        'type' : 'tool',
+        'tool' : 'tyrvis.exe',
+        'parameters': 'this and that',
+        'cpuBudget': 4
+      }, {
+        'type' : 'tool',
+        'tool' : 'tyrlight.exe',
+        'parameters': 'this and that',
+        'concurrent': true,
+        'cpuBudget': 2
+      }, {
+        'type' : 'copy',
+        'source' : 'the source',
+        'target' : 'the target',
+        'concurrent': true
+      }]
+    }]
+})";
+
+    auto parser = CompilationConfigParser{config};
+    CHECK(
+      parser.parse()
+      == mdl::CompilationConfig{{
+        {"A profile",
+         "",
+         {
+           mdl::CompilationRunTool{true, "tyrvis.exe", "this and that", false, false, 4},
+           mdl::CompilationRunTool{true, "tyrlight.exe", "this and that", false, true, 2},
+           mdl::CompilationCopyFiles{true, "the source", "the target", true},
+         }},
+      }});
+  }
+
+  SECTION("parseSelectionOnlyExportTask")
+  {
+    const auto config = R"(
+{
+  'version': 1,
+  'profiles': [{
+      'name' : 'A profile',
+      'workdir' : '',
+      'tasks' : [{
+        'type' : 'export',
+        'target' : 'the target',
+        'selectionOnly': true
+      }]
+    }]
+})";
+
+    auto parser = CompilationConfigParser{config};
+    CHECK(
+      parser.parse()
+      == mdl::CompilationConfig{{
+        {"A profile",
+         "",
+         {
+           mdl::CompilationExportMap{true, "the target", false, true},
+         }},
+      }});
+  }
+
   SECTION("parseOneProfileWithNameAndFourTasks")
   {
     const auto config = R"(
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/CompressedMapFile.h"
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+
+TEST_CASE("CompressedMapFile")
+{
+  const auto contents = std::string{R"(// Game: Test
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+}
+)"};
+
+  SECTION("Compressed contents can be decompressed")
+  {
+    const auto compressed = compressMapFile(contents);
+    REQUIRE(compressed.is_success());
+    CHECK(isCompressedMapFile(compressed.value()));
+    CHECK(decompressMapFile(compressed.value()) == contents);
+  }
+
+  SECTION("Empty contents")
+  {
+    const auto compressed = compressMapFile("");
+    REQUIRE(compressed.is_success());
+    CHECK(decompressMapFile(compressed.value()) == std::string{});
+  }
+
+  SECTION("Uncompressed contents are not recognized")
+  {
+    CHECK_FALSE(isCompressedMapFile(contents));
+    CHECK_FALSE(isCompressedMapFile(""));
+    CHECK(decompressMapFile(contents).is_error());
+  }
+
+  SECTION("Truncated contents are rejected")
+  {
+    const auto compressed = compressMapFile(contents).value();
+    CHECK(decompressMapFile(compressed.substr(0, 8)).is_error());
+    CHECK(decompressMapFile(compressed.substr(0, compressed.size() - 4)).is_error());
+  }
+}
+
+} // namespace tb::io
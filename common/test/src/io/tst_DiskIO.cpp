@@ -30,7 +30,10 @@
 #include <fmt/std.h>
 
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_vector.hpp>
@@ -231,6 +234,56 @@ TEST_CASE("DiskIO")
 
     file = Disk::openFile(env.dir() / "linkedTest2.map");
     CHECK(file.is_success());
+
+    file = Disk::openFile(env.dir() / "test.txt");
+    REQUIRE(file.is_success());
+    CHECK(file.value()->size() == 12);
+
+    // readers read at explicit offsets, so they can be used from several threads
+    auto contents = std::vector<std::future<std::string>>{};
+    for (size_t i = 0; i < 8; ++i)
+    {
+      contents.push_back(std::async(std::launch::async, [&, i]() {
+        const auto offset = i % 2 == 0 ? size_t(0) : size_t(5);
+        return FileView{file.value(), offset, 12 - offset}.reader().readString(
+          12 - offset);
+      }));
+    }
+    for (size_t i = 0; i < contents.size(); ++i)
+    {
+      CHECK(contents[i].get() == (i % 2 == 0 ? "some content" : "content"));
+    }
+  }
+
+  SECTION("mapFile")
+  {
+    CHECK(
+      Disk::mapFile("asdf/bleh")
+      == Result<std::shared_ptr<MappedFile>>{Error{fmt::format(
+        "Failed to map {}: path does not denote a file",
+        std::filesystem::path{"asdf/bleh"})}});
+    CHECK(
+      Disk::mapFile(env.dir() / "does/not/exist")
+      == Result<std::shared_ptr<MappedFile>>{Error{fmt::format(
+        "Failed to map {}: path does not denote a file",
+        env.dir() / "does/not/exist")}});
+
+    auto file = Disk::mapFile(env.dir() / "test.txt");
+    REQUIRE(file.is_success());
+    CHECK(file.value()->size() == 12);
+    CHECK(file.value()->reader().readString(12) == "some content");
+
+    auto view = std::make_shared<FileView>(file.value(), 5, 7);
+    CHECK(view->reader().readString(7) == "content");
+
+    file = Disk::mapFile(env.dir() / "linkedTest2.map");
+    CHECK(file.is_success());
+
+    env.createFile("empty.txt", "");
+    file = Disk::mapFile(env.dir() / "empty.txt");
+    REQUIRE(file.is_success());
+    CHECK(file.value()->size() == 0);
+    CHECK(file.value()->reader().size() == 0);
   }
 
   SECTION("withStream")
@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "io/DiskIO.h"
+#include "io/EntityThumbnailCache.h"
+#include "io/TestEnvironment.h"
+#include "mdl/EntityModel.h"
+
+#include "kdl/result.h"
+
+#include <filesystem>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+EntityThumbnailCacheKey makeKey(
+  const mdl::ModelSpecification& modelSpecification,
+  const vm::vec3f& modelScale,
+  const std::string& contents)
+{
+  return makeEntityThumbnailCacheKey(
+    modelSpecification, modelScale, contents.data(), contents.data() + contents.size());
+}
+
+void checkThumbnailsEqual(const EntityThumbnail& actual, const EntityThumbnail& expected)
+{
+  CHECK(actual.bounds == expected.bounds);
+  CHECK(actual.orientation == expected.orientation);
+  CHECK(actual.width == expected.width);
+  CHECK(actual.height == expected.height);
+  CHECK(actual.pixels == expected.pixels);
+}
+
+} // namespace
+
+TEST_CASE("EntityThumbnailCache")
+{
+  const auto modelContents = std::string{"some model file contents"};
+
+  auto env = TestEnvironment{};
+  const auto cache = EntityThumbnailCache{env.dir() / "cache"};
+
+  const auto spec = mdl::ModelSpecification{"models/test.mdl", 1, 2};
+  const auto key = makeKey(spec, vm::vec3f{1, 1, 1}, modelContents);
+
+  const auto thumbnail = EntityThumbnail{
+    vm::bbox3f{vm::vec3f{-8, -8, 0}, vm::vec3f{8, 8, 32}},
+    mdl::Orientation::ViewPlaneParallelUpright,
+    2,
+    1,
+    {1, 2, 3, 4, 5, 6, 7, 8},
+  };
+
+  SECTION("makeEntityThumbnailCacheKey")
+  {
+    CHECK(key.modelSpecification == spec);
+    CHECK(key.modelScale == vm::vec3f{1, 1, 1});
+    CHECK(key.size == modelContents.size());
+    CHECK(key.hash != makeKey(spec, vm::vec3f{1, 1, 1}, "other contents").hash);
+  }
+
+  SECTION("load returns nothing if there is no entry")
+  {
+    CHECK(!cache.load(key).has_value());
+  }
+
+  SECTION("load returns stored thumbnail")
+  {
+    CHECK(cache.store(key, thumbnail).is_success());
+
+    const auto cachedThumbnail = cache.load(key);
+    REQUIRE(cachedThumbnail.has_value());
+    checkThumbnailsEqual(*cachedThumbnail, thumbnail);
+  }
+
+  SECTION("load returns nothing if the key differs")
+  {
+    CHECK(cache.store(key, thumbnail).is_success());
+
+    CHECK(!cache.load(makeKey(spec, vm::vec3f{1, 1, 1}, "changed model file contents"))
+             .has_value());
+    CHECK(!cache.load(makeKey(spec, vm::vec3f{2, 2, 2}, modelContents)).has_value());
+    CHECK(!cache
+             .load(makeKey({"models/test.mdl", 1, 0}, vm::vec3f{1, 1, 1}, modelContents))
+             .has_value());
+  }
+
+  SECTION("load returns nothing if the entry is corrupt")
+  {
+    CHECK(cache.store(key, thumbnail).is_success());
+
+    const auto entries = env.directoryContents("cache");
+    REQUIRE(entries.size() == 1);
+
+    Disk::withOutputStream(
+      env.dir() / entries.front(),
+      std::ios::out | std::ios::binary | std::ios::trunc,
+      [](auto& stream) { stream << "TBET garbage"; })
+      | kdl::transform_error([](auto e) { FAIL(e.msg); });
+
+    CHECK(!cache.load(key).has_value());
+  }
+}
+
+} // namespace tb::io
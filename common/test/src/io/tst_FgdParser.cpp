@@ -19,6 +19,7 @@
 
 #include "el/ELTestUtils.h"
 #include "io/DiskIO.h"
+#include "io/EntityDefinitionCache.h"
 #include "io/FgdParser.h"
 #include "io/Reader.h"
 #include "io/TestParserStatus.h"
@@ -27,6 +28,8 @@
 #include "mdl/EntityDefinitionTestUtils.h"
 #include "mdl/PropertyDefinition.h"
 
+#include "kdl/task_manager.h"
+
 #include <algorithm>
 #include <filesystem>
 #include <string>
@@ -1013,6 +1016,31 @@ model({"path"
       defs.value(), [](const auto& def) { return def.name == "worldspawn"; }));
   }
 
+  SECTION("parseNestedIncludeWithCache")
+  {
+    const auto path =
+      std::filesystem::current_path() / "fixture/test/io/Fgd/parseNestedInclude/host.fgd";
+    auto file = Disk::openFile(path) | kdl::value();
+    auto reader = file->reader().buffer();
+
+    auto taskManager = kdl::task_manager{};
+    auto cache = EntityDefinitionCache{};
+
+    auto parser = FgdParser{
+      reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, path, taskManager, cache};
+    auto status = TestParserStatus{};
+    const auto defs = parser.parseDefinitions(status);
+    REQUIRE(defs.is_success());
+    CHECK(defs.value().size() == 3u);
+
+    const auto hostKey = makeEntityDefinitionFileKey(path, reader.stringView());
+    CHECK(cache.fgdFileContents(hostKey) != nullptr);
+
+    auto cachedParser = FgdParser{
+      reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, path, taskManager, cache};
+    CHECK(cachedParser.parseDefinitions(status) == defs);
+  }
+
   SECTION("parseStringContinuations")
   {
     const auto file = R"(
@@ -24,6 +24,7 @@
 #include "io/VirtualFileSystem.h"
 #include "io/WadFileSystem.h"
 #include "mdl/GameConfig.h"
+#include "mdl/Material.h"
 #include "mdl/MaterialCollection.h"
 #include "mdl/Resource.h"
 #include "mdl/Texture.h"
@@ -439,4 +440,97 @@ TEST_CASE("loadMaterialCollections")
   }
 }
 
+TEST_CASE("reloadMaterialCollections")
+{
+  auto fs = VirtualFileSystem{};
+  auto logger = NullLogger{};
+
+  const auto workDir = std::filesystem::current_path();
+
+  auto taskManager = kdl::task_manager{};
+
+  const auto wadPath = workDir / "fixture/test/io/Wad/cr8_czg.wad";
+  fs.mount("", std::make_unique<DiskFileSystem>(workDir)); // to find the palette
+  fs.mount("textures", openFS<WadFileSystem>(wadPath));
+
+  const auto materialConfig = mdl::MaterialConfig{
+    "textures",
+    {".D"},
+    "fixture/test/palette.lmp",
+    "wad",
+    "",
+    {},
+  };
+
+  const auto findMaterial = [](const auto& collections, const auto& name) {
+    const mdl::Material* result = nullptr;
+    for (const auto& collection : collections)
+    {
+      for (const auto& material : collection.materials())
+      {
+        if (material.name() == name)
+        {
+          result = &material;
+        }
+      }
+    }
+    REQUIRE(result);
+    return result;
+  };
+
+  auto collections =
+    loadMaterialCollections(fs, materialConfig, createResource, taskManager, logger)
+    | kdl::value();
+
+  const auto coffinResourceId =
+    findMaterial(collections, "coffin1")->textureResource().id();
+  const auto cr8ResourceId =
+    findMaterial(collections, "cr8_czg_1")->textureResource().id();
+
+  SECTION("Reuses the materials whose files did not change")
+  {
+    const auto additionalWadPath = workDir / "fixture/test/io/Wad/cr8_a_excerpt.wad";
+    const auto id = fs.mount("textures", openFS<WadFileSystem>(additionalWadPath));
+    const auto changedPaths = fs.findMountedFiles(id) | kdl::value();
+
+    collections = reloadMaterialCollections(
+                    std::move(collections),
+                    changedPaths,
+                    fs,
+                    materialConfig,
+                    createResource,
+                    taskManager,
+                    logger)
+                  | kdl::value();
+
+    CHECK(
+      kdl::vec_transform(collections, [](const auto& c) { return c.path(); })
+      == std::vector<std::filesystem::path>{"cr8_a_excerpt.wad", "cr8_czg.wad"});
+    CHECK(collections[0].materials().size() == 2);
+    CHECK(collections[1].materials().size() == 20);
+
+    CHECK(
+      findMaterial(collections, "coffin1")->textureResource().id() == coffinResourceId);
+    CHECK(
+      findMaterial(collections, "cr8_czg_1")->textureResource().id() != cr8ResourceId);
+    CHECK(findMaterial(collections, "cr8_czg_1")->texture()->height() == 128);
+  }
+
+  SECTION("Reloads all materials if the palette changed")
+  {
+    collections = reloadMaterialCollections(
+                    std::move(collections),
+                    {materialConfig.palette},
+                    fs,
+                    materialConfig,
+                    createResource,
+                    taskManager,
+                    logger)
+                  | kdl::value();
+
+    CHECK(
+      findMaterial(collections, "coffin1")->textureResource().id() != coffinResourceId);
+  }
+}
+
 } // namespace tb::io
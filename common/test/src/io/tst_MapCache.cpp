@@ -0,0 +1,207 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/MapCache.h"
+#include "io/NodeWriter.h"
+#include "io/TestEnvironment.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/task_manager.h"
+
+#include <filesystem>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+std::string readAndWriteMap(
+  const std::string& data,
+  const mdl::MapFormat mapFormat,
+  const std::optional<std::filesystem::path>& cachePath,
+  kdl::task_manager& taskManager)
+{
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, mapFormat, {}};
+  auto worldResult = reader.read(WorldBounds, status, taskManager, cachePath);
+  REQUIRE(worldResult.is_success());
+
+  auto str = std::stringstream{};
+  auto writer = NodeWriter{*worldResult.value(), str};
+  writer.writeMap(taskManager);
+  return str.str();
+}
+
+Result<std::vector<MapReader::ObjectInfo>> readCache(
+  const std::filesystem::path& cachePath,
+  const std::string& data,
+  const mdl::MapFormat mapFormat)
+{
+  return Disk::mapFile(cachePath) | kdl::and_then([&](const auto& file) {
+           return readMapCache(file->reader(), data, mapFormat);
+         });
+}
+
+} // namespace
+
+TEST_CASE("MapCache")
+{
+  auto taskManager = kdl::task_manager{};
+  auto env = TestEnvironment{};
+
+  using T = std::tuple<mdl::MapFormat, std::string>;
+
+  // clang-format off
+  const auto
+  [mapFormat,                 data] = GENERATE(values<T>({
+  {mdl::MapFormat::Standard,  R"(
+{
+"classname" "worldspawn"
+"message" "cached"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) rock 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) rock 16 8 45 0.5 2
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) rock 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) rock 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) rock 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) rock 0 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Layer"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group"
+"_tb_id" "2"
+"_tb_layer" "1"
+"_tb_linked_group_id" "link"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) wood 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) wood 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) wood 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) wood 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) wood 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) wood 0 0 0 1 1
+}
+}
+{
+"classname" "light"
+"origin" "0 0 0"
+"_tb_group" "2"
+}
+)"},
+  {mdl::MapFormat::Valve,     R"(
+{
+"classname" "worldspawn"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 30 0.5 2
+}
+}
+)"},
+  {mdl::MapFormat::Quake3,    R"(
+{
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 5 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+( (128 -64 4 0.6 0 ) (128 0 4 0.6 -0.25 ) (128 64 4 0.6 -0.5 ) )
+( (192 -64 4 0.8 0 ) (192 0 4 0.8 -0.25 ) (192 64 4 0.8 -0.5 ) )
+)
+}
+}
+}
+)"},
+  }));
+  // clang-format on
+
+  CAPTURE(mapFormat);
+
+  const auto cachePath = env.dir() / mapCachePath("test.map");
+  const auto expected = readAndWriteMap(data, mapFormat, std::nullopt, taskManager);
+
+  SECTION("Reading a map without a cache path doesn't write a cache")
+  {
+    CHECK_FALSE(env.fileExists(cachePath));
+  }
+
+  SECTION("Reading a map writes a cache")
+  {
+    CHECK(readAndWriteMap(data, mapFormat, cachePath, taskManager) == expected);
+    CHECK(env.fileExists(cachePath));
+    CHECK(readCache(cachePath, data, mapFormat).is_success());
+
+    SECTION("Reading the map again reads the cache")
+    {
+      CHECK(readAndWriteMap(data, mapFormat, cachePath, taskManager) == expected);
+    }
+
+    SECTION("The cache is rejected if the source was changed")
+    {
+      const auto changedData = data + "\n";
+      CHECK(readCache(cachePath, changedData, mapFormat).is_error());
+      CHECK(readAndWriteMap(changedData, mapFormat, cachePath, taskManager) == expected);
+      CHECK(readCache(cachePath, changedData, mapFormat).is_success());
+    }
+
+    SECTION("The cache is rejected if the map format was changed")
+    {
+      CHECK(readCache(cachePath, data, mdl::MapFormat::Unknown).is_error());
+    }
+  }
+
+  SECTION("A malformed cache is rejected")
+  {
+    env.createFile(cachePath, "TBMC");
+    CHECK(readCache(cachePath, data, mapFormat).is_error());
+    CHECK(readAndWriteMap(data, mapFormat, cachePath, taskManager) == expected);
+  }
+}
+
+} // namespace tb::io
@@ -17,6 +17,7 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "io/CompressedMapFile.h"
 #include "io/MapHeader.h"
 #include "io/TestEnvironment.h"
 
@@ -55,6 +56,13 @@ TEST_CASE("readMapHeader")
 ( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1 0 0 0
 }
 })") == std::pair{"Quake"s, mdl::MapFormat::Quake2});
+
+  CHECK(
+    detectGame(compressMapFile(R"(// Game: Quake
+// Format: Quake2
+)")
+                 .value())
+    == std::pair{"Quake"s, mdl::MapFormat::Quake2});
 }
 
 TEST_CASE("writeMapHeader")
@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/DiskIO.h"
+#include "io/MaterialCache.h"
+#include "io/TestEnvironment.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+
+#include "kdl/result.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+mdl::Texture makeTexture()
+{
+  auto mip0 = mdl::TextureBuffer{4 * 2 * 2};
+  auto mip1 = mdl::TextureBuffer{4 * 1 * 1};
+  for (size_t i = 0; i < mip0.size(); ++i)
+  {
+    mip0.data()[i] = static_cast<unsigned char>(i);
+  }
+  std::memset(mip1.data(), 0xAB, mip1.size());
+
+  auto buffers = mdl::TextureBufferList{};
+  buffers.push_back(std::move(mip0));
+  buffers.push_back(std::move(mip1));
+
+  return mdl::Texture{
+    2,
+    2,
+    Color{0.25f, 0.5f, 0.75f, 1.0f},
+    GL_RGBA,
+    mdl::TextureMask::On,
+    mdl::Q2EmbeddedDefaults{1, 2, 3},
+    std::move(buffers)};
+}
+
+void checkTexturesEqual(const mdl::Texture& actual, const mdl::Texture& expected)
+{
+  CHECK(actual.width() == expected.width());
+  CHECK(actual.height() == expected.height());
+  CHECK(actual.averageColor() == expected.averageColor());
+  CHECK(actual.format() == expected.format());
+  CHECK(actual.mask() == expected.mask());
+  CHECK(actual.embeddedDefaults() == expected.embeddedDefaults());
+
+  const auto& actualBuffers = actual.buffersIfLoaded();
+  const auto& expectedBuffers = expected.buffersIfLoaded();
+  REQUIRE(actualBuffers.size() == expectedBuffers.size());
+  for (size_t i = 0; i < actualBuffers.size(); ++i)
+  {
+    REQUIRE(actualBuffers[i].size() == expectedBuffers[i].size());
+    CHECK(
+      std::memcmp(
+        actualBuffers[i].data(), expectedBuffers[i].data(), actualBuffers[i].size())
+      == 0);
+  }
+}
+
+} // namespace
+
+TEST_CASE("MaterialCache")
+{
+  auto env = TestEnvironment{};
+  const auto cache = MaterialCache{env.dir() / "cache"};
+
+  const auto contents = std::string{"some texture file contents"};
+  const auto key = makeMaterialCacheKey(
+    "textures/test.png", contents.data(), contents.data() + contents.size());
+
+  SECTION("makeMaterialCacheKey")
+  {
+    CHECK(key.sourcePath == "textures/test.png");
+    CHECK(key.size == contents.size());
+
+    const auto otherContents = std::string{"other texture file contents"};
+    const auto otherKey = makeMaterialCacheKey(
+      "textures/test.png",
+      otherContents.data(),
+      otherContents.data() + otherContents.size());
+    CHECK(otherKey.hash != key.hash);
+  }
+
+  SECTION("load returns nothing if there is no entry")
+  {
+    CHECK(!cache.load(key).has_value());
+  }
+
+  SECTION("load returns stored texture")
+  {
+    const auto texture = makeTexture();
+    CHECK(cache.store(key, texture).is_success());
+
+    const auto cachedTexture = cache.load(key);
+    REQUIRE(cachedTexture.has_value());
+    checkTexturesEqual(*cachedTexture, texture);
+  }
+
+  SECTION("load returns nothing if the key doesn't match")
+  {
+    CHECK(cache.store(key, makeTexture()).is_success());
+
+    auto otherKey = key;
+    otherKey.hash += 1;
+    CHECK(!cache.load(otherKey).has_value());
+
+    otherKey = key;
+    otherKey.sourcePath = "textures/other.png";
+    CHECK(!cache.load(otherKey).has_value());
+  }
+
+  SECTION("load returns nothing if the entry is corrupt")
+  {
+    CHECK(cache.store(key, makeTexture()).is_success());
+
+    const auto entries = env.directoryContents("cache");
+    REQUIRE(entries.size() == 1);
+
+    Disk::withOutputStream(
+      env.dir() / entries.front(),
+      std::ios::out | std::ios::binary | std::ios::trunc,
+      [](auto& stream) { stream << "TBMC garbage"; })
+      | kdl::transform_error([](auto e) { FAIL(e.msg); });
+
+    CHECK(!cache.load(key).has_value());
+  }
+}
+
+} // namespace tb::io
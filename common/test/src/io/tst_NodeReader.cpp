@@ -20,10 +20,14 @@
 #include "io/NodeReader.h"
 #include "io/TestParserStatus.h"
 #include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
 #include "mdl/GroupNode.h"
+#include "mdl/Layer.h"
 #include "mdl/ParaxialUVCoordSystem.h"
 
+#include "kdl/result.h"
 #include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -116,6 +120,44 @@ TEST_CASE("NodeReader")
       != nullptr);
   }
 
+  SECTION("readUnloadedLayer")
+  {
+    const auto unloadedContent = UnloadedLayerContent{
+      {R"({
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty 0 0 0 1 1
+})"},
+      {R"({
+"classname" "light"
+"_tb_layer" "7"
+})"},
+      std::nullopt,
+    };
+
+    auto nodes = io::NodeReader::readUnloadedLayer(
+                   unloadedContent,
+                   7,
+                   MapFormat::Standard,
+                   worldBounds,
+                   {},
+                   status,
+                   taskManager)
+                 | kdl::value();
+    REQUIRE(nodes.size() == 2u);
+
+    CHECK(dynamic_cast<BrushNode*>(nodes.at(0)) != nullptr);
+
+    auto* entityNode = dynamic_cast<EntityNode*>(nodes.at(1));
+    REQUIRE(entityNode != nullptr);
+    CHECK(entityNode->entity().classname() == "light");
+
+    kdl::vec_clear_and_delete(nodes);
+  }
+
   SECTION("readScientificNotation")
   {
     // https://github.com/TrenchBroom/TrenchBroom/issues/4270
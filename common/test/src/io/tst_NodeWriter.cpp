@@ -301,6 +301,44 @@ TEST_CASE("NodeWriter")
     CHECK(actual == expected);
   }
 
+  SECTION("writeMapWithManyBrushesKeepsNodeOrder")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+
+    auto builder = mdl::BrushBuilder{map.mapFormat(), worldBounds};
+    const auto brushCount = size_t(500);
+    for (size_t i = 0; i < brushCount; ++i)
+    {
+      map.defaultLayer()->addChild(new mdl::BrushNode{
+        builder.createCube(64.0, fmt::format("material{}", i)) | kdl::value()});
+    }
+
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.writeMap(taskManager);
+
+    const auto actual = str.str();
+    auto pos = size_t(0);
+    for (size_t i = 0; i < brushCount; ++i)
+    {
+      const auto header = fmt::format("// brush {}\n{{\n", i);
+      pos = actual.find(header, pos);
+      REQUIRE(pos != std::string::npos);
+
+      pos += header.size();
+      const auto firstFace = actual.substr(pos, actual.find('\n', pos) - pos);
+      CHECK(firstFace.find(fmt::format(" material{} ", i)) != std::string::npos);
+    }
+
+    const auto& brushNodes = map.defaultLayer()->children();
+    for (size_t i = 0; i < brushCount; ++i)
+    {
+      CHECK(brushNodes[i]->lineNumber() == 5 + i * 9);
+    }
+  }
+
   SECTION("writeWorldspawnWithBrushInCustomLayer")
   {
     const auto worldBounds = vm::bbox3d{8192.0};
@@ -350,6 +388,52 @@ TEST_CASE("NodeWriter")
     CHECK(actual == expected);
   }
 
+  SECTION("writeUnloadedLayer")
+  {
+    auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+
+    auto layer = mdl::Layer{"Unloaded Layer"};
+    layer.setSortIndex(0);
+    layer.setUnloadedContent(mdl::UnloadedLayerContent{
+      {"{\n( 0 0 0 ) ( 0 1 0 ) ( 1 0 0 ) none 0 0 0 1 1\n}"},
+      {"{\n\"classname\" \"light\"\n\"_tb_layer\" \"3\"\n}"},
+      std::nullopt});
+
+    auto* layerNode = new mdl::LayerNode{std::move(layer)};
+    layerNode->setPersistentId(3);
+    map.addChild(layerNode);
+
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.writeMap(taskManager);
+
+    const auto actual = str.str();
+    const auto expected =
+      R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Unloaded Layer"
+"_tb_id" "3"
+"_tb_layer_sort_index" "0"
+// brush 0
+{
+( 0 0 0 ) ( 0 1 0 ) ( 1 0 0 ) none 0 0 0 1 1
+}
+}
+// entity 2
+{
+"classname" "light"
+"_tb_layer" "3"
+}
+)";
+    CHECK(actual == expected);
+  }
+
   SECTION("writeWorldspawnWithCustomLayerWithSortIndex")
   {
     auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
@@ -899,6 +983,31 @@ TEST_CASE("NodeWriter")
     }
   }
 
+  SECTION("writeNodesWritesWorldspawnWhenExporting")
+  {
+    auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+
+    auto* entityNode = new mdl::EntityNode{mdl::Entity{{{"classname", "light"}}}};
+    map.defaultLayer()->addChild(entityNode);
+
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.setExporting(true);
+    writer.writeNodes({entityNode}, taskManager);
+
+    const auto actual = str.str();
+    const auto expected = R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+"classname" "light"
+}
+)";
+    CHECK(actual == expected);
+  }
+
   SECTION("writeNodesWithLinkedGroup")
   {
     const auto worldBounds = vm::bbox3d{8192.0};
@@ -66,6 +66,33 @@ TEST_CASE("ReadDdsTextureTest.testLoadDds")
   assertTexture("dds_bc1.dds", 128, 128, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
   assertTexture("dds_bc2.dds", 128, 128, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT);
   assertTexture("dds_bc3.dds", 128, 128, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+  assertTexture("dds_bc4.dds", 8, 8, GL_COMPRESSED_RED_RGTC1);
+  assertTexture("dds_bc5.dds", 8, 8, GL_COMPRESSED_RG_RGTC2);
+  assertTexture("dds_bc7.dds", 8, 8, GL_COMPRESSED_RGBA_BPTC_UNORM);
+}
+
+TEST_CASE("ReadDdsTextureTest.testMipSizes")
+{
+  SECTION("power of two")
+  {
+    const auto texture = loadTexture("dds_bc7.dds");
+    const auto& buffers = texture.buffersIfLoaded();
+    REQUIRE(buffers.size() == 4);
+    CHECK(buffers[0].size() == 4 * 16);
+    CHECK(buffers[1].size() == 16);
+    CHECK(buffers[2].size() == 16);
+    CHECK(buffers[3].size() == 16);
+  }
+
+  SECTION("partial blocks are padded")
+  {
+    const auto texture = loadTexture("dds_bc7_npot.dds");
+    const auto& buffers = texture.buffersIfLoaded();
+    REQUIRE(buffers.size() == 3);
+    CHECK(buffers[0].size() == 4 * 16);
+    CHECK(buffers[1].size() == 16);
+    CHECK(buffers[2].size() == 16);
+  }
 }
 
 } // namespace tb::io
@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/StandardMapParser.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+auto chunkStrings(const std::vector<EntityChunk>& chunks)
+{
+  auto result = std::vector<std::string_view>{};
+  for (const auto& chunk : chunks)
+  {
+    result.push_back(chunk.str);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("splitEntityChunks")
+{
+  SECTION("Empty string")
+  {
+    CHECK(splitEntityChunks("", 0).empty());
+  }
+
+  SECTION("Single entity")
+  {
+    const auto str = std::string_view{R"({
+"classname" "worldspawn"
+})"};
+
+    const auto chunks = splitEntityChunks(str, 0);
+    REQUIRE(chunks.size() == 1);
+    CHECK(chunks[0].str == str);
+    CHECK(chunks[0].startLine == 1);
+    CHECK(chunks[0].startColumn == 1);
+  }
+
+  SECTION("Multiple entities")
+  {
+    const auto str = std::string_view{R"({
+"classname" "worldspawn"
+{
+( 0 0 0 ) ( 0 1 0 ) ( 1 0 0 ) tex 0 0 0 1 1
+}
+}
+{ "classname" "light" }
+// comment
+{
+"classname" "info_player_start"
+})"};
+
+    const auto chunks = splitEntityChunks(str, 0);
+    CHECK(
+      chunkStrings(chunks)
+      == std::vector<std::string_view>{
+        R"({
+"classname" "worldspawn"
+{
+( 0 0 0 ) ( 0 1 0 ) ( 1 0 0 ) tex 0 0 0 1 1
+}
+})",
+        R"(
+{ "classname" "light" })",
+        R"(
+// comment
+{
+"classname" "info_player_start"
+})",
+      });
+
+    REQUIRE(chunks.size() == 3);
+    CHECK(chunks[1].startLine == 6);
+    CHECK(chunks[1].startColumn == 2);
+    CHECK(chunks[2].startLine == 7);
+    CHECK(chunks[2].startColumn == 24);
+  }
+
+  SECTION("Minimum chunk size")
+  {
+    const auto str = std::string_view{R"({ "classname" "worldspawn" }
+{ "classname" "light" }
+{ "classname" "light" })"};
+
+    CHECK(splitEntityChunks(str, str.size()).size() == 1);
+    CHECK(
+      chunkStrings(splitEntityChunks(str, 30))
+      == std::vector<std::string_view>{
+        R"({ "classname" "worldspawn" }
+{ "classname" "light" })",
+        R"(
+{ "classname" "light" })",
+      });
+  }
+
+  SECTION("Braces in strings and comments")
+  {
+    const auto str = std::string_view{R"({
+"message" "}{ \"x\" {"
+// }
+; {
+}
+{ "classname" "light" })"};
+
+    CHECK(
+      chunkStrings(splitEntityChunks(str, 0))
+      == std::vector<std::string_view>{
+        R"({
+"message" "}{ \"x\" {"
+// }
+; {
+})",
+        R"(
+{ "classname" "light" })",
+      });
+  }
+
+  SECTION("Curly brace in material name")
+  {
+    const auto str = std::string_view{R"({
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) {blood 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex} 0 0 0 1 1
+}
+}
+{ "classname" "light" })"};
+
+    CHECK(splitEntityChunks(str, 0).size() == 2);
+  }
+
+  SECTION("Unbalanced braces")
+  {
+    CHECK(splitEntityChunks("{ \"classname\" \"light\"", 0).empty());
+    CHECK(splitEntityChunks("{ \"classname\" \"light\" } }", 0).empty());
+    CHECK(splitEntityChunks("{ \"classname\" \"light", 0).empty());
+  }
+
+  SECTION("Unexpected tokens between entities")
+  {
+    CHECK(splitEntityChunks("{ \"classname\" \"light\" } asdf { }", 0).empty());
+  }
+}
+
+} // namespace tb::io
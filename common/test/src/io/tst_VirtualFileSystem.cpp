@@ -17,11 +17,14 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "TestUtils.h"
 #include "io/File.h"
 #include "io/FileSystemMetadata.h"
+#include "io/IdPakFileSystem.h"
 #include "io/TestFileSystem.h"
 #include "io/TraversalMode.h"
 #include "io/VirtualFileSystem.h"
+#include "io/WadFileSystem.h"
 
 #include "kdl/result.h"
 
@@ -409,7 +412,7 @@ TEST_CASE("VirtualFileSystem")
     };
 
 
-    vfs.mount(
+    const auto fooId = vfs.mount(
       "foo",
       std::make_unique<TestFileSystem>(
         Entry{DirectoryEntry{
@@ -423,7 +426,7 @@ TEST_CASE("VirtualFileSystem")
           }}},
         md_fs1,
         "/fs1"));
-    vfs.mount(
+    const auto barId = vfs.mount(
       "bar",
       std::make_unique<TestFileSystem>(
         Entry{DirectoryEntry{
@@ -465,6 +468,18 @@ TEST_CASE("VirtualFileSystem")
       CHECK_THAT(vfs.metadata("bar/foo", "key2"), MatchesPointer(md_fs2.at("key2")));
     }
 
+    SECTION("findMountedFiles")
+    {
+      CHECK(
+        vfs.findMountedFiles(fooId)
+        == Result<std::vector<std::filesystem::path>>{
+          std::vector<std::filesystem::path>{"foo/bar/baz"}});
+      CHECK(
+        vfs.findMountedFiles(barId)
+        == Result<std::vector<std::filesystem::path>>{
+          std::vector<std::filesystem::path>{"bar/foo"}});
+    }
+
     SECTION("find")
     {
       CHECK(
@@ -774,6 +789,81 @@ TEST_CASE("VirtualFileSystem")
       CHECK(vfs.openFile("foo/bar/g") == Result<std::shared_ptr<File>>{fs2_foo_bar_g});
     }
   }
+
+  SECTION("with indexed image file systems")
+  {
+    const auto fsTestPath = std::filesystem::current_path() / "fixture/test/io/";
+    const auto pakPath = fsTestPath / "Pak/idpak.pak";
+    const auto wadPath = fsTestPath / "Wad/cr8_czg.wad";
+
+    auto pics_tag1_pcx = makeObjectFile(1);
+    auto md = std::unordered_map<std::string, FileSystemMetadata>{};
+
+    vfs.mount("", openFS<IdPakFileSystem>(pakPath));
+    const auto testFsId = vfs.mount(
+      "",
+      std::make_unique<TestFileSystem>(
+        Entry{DirectoryEntry{
+          "",
+          {
+            DirectoryEntry{
+              "pics",
+              {
+                FileEntry{"tag1.pcx", pics_tag1_pcx}, // overrides file in pak
+              }},
+          }}},
+        md));
+    const auto wadId = vfs.mount("textures", openFS<WadFileSystem>(wadPath));
+
+    SECTION("pathInfo")
+    {
+      CHECK(vfs.pathInfo("pics") == PathInfo::Directory);
+      CHECK(vfs.pathInfo("PICS/TAG2.PCX") == PathInfo::File);
+      CHECK(vfs.pathInfo("textures") == PathInfo::Directory);
+      CHECK(vfs.pathInfo("textures/e1u1/brlava.wal") == PathInfo::File);
+      CHECK(vfs.pathInfo("textures/cr8_czg_1.D") == PathInfo::File);
+      CHECK(vfs.pathInfo("textures/SPEEDM_1.D") == PathInfo::File);
+      CHECK(vfs.pathInfo("textures/does_not_exist") == PathInfo::Unknown);
+    }
+
+    SECTION("metadata")
+    {
+      CHECK_THAT(
+        vfs.metadata("pics/tag2.pcx", FileSystemMetadataKeys::ImageFilePath),
+        MatchesPointer(FileSystemMetadata{pakPath}));
+      CHECK(
+        vfs.metadata("pics/tag1.pcx", FileSystemMetadataKeys::ImageFilePath) == nullptr);
+      CHECK_THAT(
+        vfs.metadata("textures/cr8_czg_1.D", FileSystemMetadataKeys::ImageFilePath),
+        MatchesPointer(FileSystemMetadata{wadPath}));
+    }
+
+    SECTION("openFile")
+    {
+      CHECK(
+        vfs.openFile("pics/tag1.pcx") == Result<std::shared_ptr<File>>{pics_tag1_pcx});
+      CHECK(vfs.openFile("pics/tag2.pcx").is_success());
+      CHECK(vfs.openFile("textures/cr8_czg_1.D").is_success());
+    }
+
+    SECTION("unmount")
+    {
+      REQUIRE(vfs.unmount(testFsId));
+      CHECK(vfs.pathInfo("pics/tag1.pcx") == PathInfo::File);
+      CHECK(
+        vfs.openFile("pics/tag1.pcx") != Result<std::shared_ptr<File>>{pics_tag1_pcx});
+      CHECK_THAT(
+        vfs.metadata("pics/tag1.pcx", FileSystemMetadataKeys::ImageFilePath),
+        MatchesPointer(FileSystemMetadata{pakPath}));
+
+      REQUIRE(vfs.unmount(wadId));
+      CHECK(vfs.pathInfo("textures/cr8_czg_1.D") == PathInfo::Unknown);
+      CHECK(vfs.pathInfo("textures/e1u1/brlava.wal") == PathInfo::File);
+
+      vfs.unmountAll();
+      CHECK(vfs.pathInfo("pics/tag2.pcx") == PathInfo::Unknown);
+    }
+  }
 }
 
 } // namespace tb::io
@@ -416,6 +416,35 @@ TEST_CASE("WorldReader")
     checkBrushUVCoordSystem(brush, true);
   }
 
+  SECTION("Standard brush converted to Valve220")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+})";
+
+    auto reader =
+      WorldReader{data, mdl::MapFormat::Standard, mdl::MapFormat::Valve, {}};
+
+    auto worldResult = reader.read(worldBounds, status, taskManager);
+    REQUIRE(worldResult.is_success());
+
+    const auto& world = worldResult.value();
+    CHECK(world->mapFormat() == mdl::MapFormat::Valve);
+    auto* defaultLayer = world->children().front();
+    REQUIRE(defaultLayer->childCount() == 1u);
+    auto* brush = static_cast<mdl::BrushNode*>(defaultLayer->children().front());
+    checkBrushUVCoordSystem(brush, true);
+  }
+
   SECTION("Quake 2 brush format")
   {
     const auto data = R"(
@@ -1134,6 +1163,220 @@ TEST_CASE("WorldReader")
     CHECK(groupNode2->persistentId() == 22u);
   }
 
+  SECTION("Layers that are not loaded keep their source text")
+  {
+    const auto brush = R"({
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+})"s;
+    const auto group = R"({
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group"
+"_tb_id" "5"
+"_tb_layer" "2"
+})"s;
+    const auto entity = fmt::format(
+      R"({{
+"classname" "func_door"
+"_tb_group" "5"
+{}
+}})",
+      brush);
+
+    const auto data = fmt::format(
+      R"(
+{{
+"classname" "worldspawn"
+{0}
+}}
+{{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Loaded"
+"_tb_id" "1"
+{0}
+}}
+{{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Unloaded"
+"_tb_id" "2"
+{0}
+}}
+{1}
+{2}
+{{
+"classname" "light"
+"_tb_layer" "1"
+}}
+)",
+      brush,
+      group,
+      entity);
+
+    auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+    auto worldResult =
+      reader.read(worldBounds, status, taskManager, std::nullopt, {{"Loaded"}});
+    REQUIRE(worldResult.is_success());
+
+    const auto& world = worldResult.value();
+    REQUIRE(world->childCount() == 3u);
+
+    auto* defaultLayerNode = world->defaultLayer();
+    auto* loadedLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(1));
+    auto* unloadedLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(2));
+    REQUIRE(loadedLayerNode != nullptr);
+    REQUIRE(unloadedLayerNode != nullptr);
+
+    CHECK(defaultLayerNode->childCount() == 1u);
+    CHECK(loadedLayerNode->childCount() == 2u);
+    CHECK(loadedLayerNode->layer().unloadedContent() == std::nullopt);
+
+    CHECK(unloadedLayerNode->name() == "Unloaded");
+    CHECK(unloadedLayerNode->persistentId() == 2u);
+    CHECK(!unloadedLayerNode->hasChildren());
+    CHECK(
+      unloadedLayerNode->layer().unloadedContent()
+      == mdl::UnloadedLayerContent{{brush}, {group, entity}, 5u});
+
+    // the persistent IDs of the unloaded groups are not reused
+    auto* groupNode = new mdl::GroupNode{mdl::Group{"New Group"}};
+    defaultLayerNode->addChild(groupNode);
+    CHECK(groupNode->persistentId() == 6u);
+  }
+
+  SECTION("Hidden layers are not loaded unless requested")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Visible"
+"_tb_id" "1"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Hidden"
+"_tb_id" "2"
+"_tb_layer_hidden" "1"
+}
+{
+"classname" "light"
+"_tb_layer" "1"
+}
+{
+"classname" "light"
+"_tb_layer" "2"
+}
+)";
+
+    const auto loadHiddenLayers = GENERATE(true, false);
+    CAPTURE(loadHiddenLayers);
+
+    auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+    auto worldResult = reader.read(
+      worldBounds, status, taskManager, std::nullopt, std::nullopt, loadHiddenLayers);
+    REQUIRE(worldResult.is_success());
+
+    const auto& world = worldResult.value();
+    REQUIRE(world->childCount() == 3u);
+
+    auto* visibleLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(1));
+    auto* hiddenLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(2));
+    REQUIRE(visibleLayerNode != nullptr);
+    REQUIRE(hiddenLayerNode != nullptr);
+
+    CHECK(visibleLayerNode->childCount() == 1u);
+    CHECK(hiddenLayerNode->hidden());
+    CHECK(hiddenLayerNode->childCount() == (loadHiddenLayers ? 1u : 0u));
+    CHECK(hiddenLayerNode->layer().unloadedContent().has_value() == !loadHiddenLayers);
+  }
+
+  SECTION("Hidden layers with groups linked to other layers are loaded")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Linked"
+"_tb_id" "1"
+"_tb_layer_hidden" "1"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Unlinked"
+"_tb_id" "2"
+"_tb_layer_hidden" "1"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 1"
+"_tb_id" "3"
+"_tb_linked_group_id" "abcd"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 2"
+"_tb_id" "4"
+"_tb_layer" "1"
+"_tb_linked_group_id" "abcd"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 3"
+"_tb_id" "5"
+"_tb_layer" "2"
+"_tb_linked_group_id" "xyz"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 4"
+"_tb_id" "6"
+"_tb_layer" "2"
+"_tb_linked_group_id" "xyz"
+}
+)";
+
+    auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+    auto worldResult =
+      reader.read(worldBounds, status, taskManager, std::nullopt, std::nullopt, false);
+    REQUIRE(worldResult.is_success());
+
+    const auto& world = worldResult.value();
+    REQUIRE(world->childCount() == 3u);
+
+    auto* linkedLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(1));
+    auto* unlinkedLayerNode = dynamic_cast<mdl::LayerNode*>(world->children().at(2));
+    REQUIRE(linkedLayerNode != nullptr);
+    REQUIRE(unlinkedLayerNode != nullptr);
+
+    CHECK(world->defaultLayer()->childCount() == 1u);
+    CHECK(linkedLayerNode->childCount() == 1u);
+    CHECK(linkedLayerNode->layer().unloadedContent() == std::nullopt);
+    CHECK(!unlinkedLayerNode->hasChildren());
+    CHECK(unlinkedLayerNode->layer().unloadedContent().has_value());
+  }
+
   SECTION("Brush primitive")
   {
     const auto data = R"(
@@ -2057,6 +2300,88 @@ TEST_CASE("WorldReader (Regression)", "[regression]")
     auto* brush = static_cast<mdl::BrushNode*>(defaultLayer->children().front());
     checkBrushUVCoordSystem(brush, false);
   }
+
+  SECTION("Large map is parsed in chunks")
+  {
+    const auto brush = R"({
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) {blood 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex1 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex2 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex5 0 0 0 1 1
+}
+)";
+
+    // 12 lines per entity
+    const auto entityCount = size_t(4000);
+    const auto makeMap = [&](const std::string_view worldspawnProperties) {
+      auto data = fmt::format("{{\n{}}}\n", worldspawnProperties);
+      for (size_t i = 0; i < entityCount; ++i)
+      {
+        data += fmt::format(
+          "{{\n\"classname\" \"func_detail\"\n\"key\" \"{0}\"\n{1}}}\n", i, brush);
+      }
+      return data;
+    };
+
+    SECTION("Valid map")
+    {
+      const auto data = makeMap("\"classname\" \"worldspawn\"\n");
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      auto worldResult = reader.read(worldBounds, status, taskManager);
+      REQUIRE(worldResult.is_success());
+
+      const auto& world = worldResult.value();
+      REQUIRE(world != nullptr);
+
+      const auto& entityNodes = world->defaultLayer()->children();
+      REQUIRE(entityNodes.size() == entityCount);
+
+      for (size_t i = 0; i < entityCount; ++i)
+      {
+        auto* entityNode = dynamic_cast<mdl::EntityNode*>(entityNodes[i]);
+        REQUIRE(entityNode != nullptr);
+        CHECK(*entityNode->entity().property("key") == fmt::format("{}", i));
+        CHECK(entityNode->lineNumber() == 4 + i * 12);
+        REQUIRE(entityNode->childCount() == 1u);
+        CHECK(entityNode->children().front()->lineNumber() == 7 + i * 12);
+      }
+    }
+
+    SECTION("Parser messages are reported in file order")
+    {
+      auto data = makeMap(R"("classname" "worldspawn"
+"first" "a"
+"first" "b"
+)");
+      data += R"({
+"classname" "light"
+"last" "a"
+"last" "b"
+}
+)";
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      auto worldResult = reader.read(worldBounds, status, taskManager);
+      REQUIRE(worldResult.is_success());
+
+      const auto& warnings = status.messages(LogLevel::Warn);
+      REQUIRE(warnings.size() == 2u);
+      CHECK(warnings[0].find("'first'") != std::string::npos);
+      CHECK(warnings[1].find("'last'") != std::string::npos);
+    }
+
+    SECTION("Parse errors are reported")
+    {
+      auto data = makeMap("\"classname\" \"worldspawn\"\n");
+      data += "{ ( 0 0 0 ) }";
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      CHECK(reader.read(worldBounds, status, taskManager).is_error());
+    }
+  }
 }
 
 } // namespace tb::io
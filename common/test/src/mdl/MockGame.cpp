@@ -32,6 +32,8 @@
 #include "mdl/MaterialManager.h"
 #include "mdl/WorldNode.h" // IWYU pragma: keep
 
+#include "kdl/vector_utils.h"
+
 #include <memory>
 #include <vector>
 
@@ -95,9 +97,10 @@ SoftMapBounds MockGame::extractSoftMapBounds(const Entity&) const
   return {SoftMapBoundsType::Game, vm::bbox3d()};
 }
 
-void MockGame::setAdditionalSearchPaths(
+std::vector<std::filesystem::path> MockGame::setAdditionalSearchPaths(
   const std::vector<std::filesystem::path>& /* searchPaths */, Logger& /* logger */)
 {
+  return {};
 }
 
 Game::PathErrors MockGame::checkAdditionalSearchPaths(
@@ -106,7 +109,7 @@ Game::PathErrors MockGame::checkAdditionalSearchPaths(
   return {};
 }
 
-void MockGame::reloadWads(
+std::vector<std::filesystem::path> MockGame::reloadWads(
   const std::filesystem::path&,
   const std::vector<std::filesystem::path>& wadPaths,
   Logger&)
@@ -114,11 +117,16 @@ void MockGame::reloadWads(
   m_fs->unmountAll();
   m_fs->mount("", std::make_unique<io::DiskFileSystem>(std::filesystem::current_path()));
 
+  auto changedPaths = std::vector<std::filesystem::path>{};
   for (const auto& wadPath : wadPaths)
   {
     const auto absoluteWadPath = std::filesystem::current_path() / wadPath;
-    m_fs->mount("textures", io::openFS<io::WadFileSystem>(absoluteWadPath));
+    const auto id =
+      m_fs->mount("textures", io::openFS<io::WadFileSystem>(absoluteWadPath));
+    changedPaths = kdl::vec_concat(
+      std::move(changedPaths), m_fs->findMountedFiles(id).value_or({}));
   }
+  return changedPaths;
 }
 
 bool MockGame::isEntityDefinitionFile(const std::filesystem::path& /* path */) const
@@ -160,7 +168,9 @@ std::string MockGame::defaultMod() const
 }
 
 Result<std::vector<EntityDefinition>> MockGame::loadEntityDefinitions(
-  io::ParserStatus& /* status */, const std::filesystem::path& /* path */) const
+  io::ParserStatus& /* status */,
+  const std::filesystem::path& /* path */,
+  kdl::task_manager& /* taskManager */) const
 {
   return std::vector<EntityDefinition>{};
 }
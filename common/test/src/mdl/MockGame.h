@@ -67,12 +67,12 @@ public:
   std::filesystem::path gamePath() const override;
   void setGamePath(const std::filesystem::path& gamePath, Logger& logger) override;
   SoftMapBounds extractSoftMapBounds(const Entity& entity) const override;
-  void setAdditionalSearchPaths(
+  std::vector<std::filesystem::path> setAdditionalSearchPaths(
     const std::vector<std::filesystem::path>& searchPaths, Logger& logger) override;
   PathErrors checkAdditionalSearchPaths(
     const std::vector<std::filesystem::path>& searchPaths) const override;
 
-  void reloadWads(
+  std::vector<std::filesystem::path> reloadWads(
     const std::filesystem::path& documentPath,
     const std::vector<std::filesystem::path>& wadPaths,
     Logger& logger) override;
@@ -90,7 +90,9 @@ public:
   std::string defaultMod() const override;
 
   Result<std::vector<EntityDefinition>> loadEntityDefinitions(
-    io::ParserStatus& status, const std::filesystem::path& path) const override;
+    io::ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager) const override;
 
   void setSmartTags(std::vector<SmartTag> smartTags);
   void setDefaultFaceAttributes(const BrushFaceAttributes& newDefaults);
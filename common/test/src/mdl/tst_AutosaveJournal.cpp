@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapFixture.h"
+#include "TestFactory.h"
+#include "io/TestEnvironment.h"
+#include "mdl/AutosaveJournal.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Entities.h"
+#include "mdl/Map_Layers.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::vector<std::string> describeNodes(const Map& map)
+{
+  auto result = std::vector<std::string>{};
+  for (const auto* layerNode : map.world()->allLayers())
+  {
+    for (const auto* node : layerNode->children())
+    {
+      node->accept(kdl::overload(
+        [](const WorldNode*) {},
+        [](const LayerNode*) {},
+        [](const GroupNode*) {},
+        [&](const EntityNode* entityNode) {
+          result.push_back("entity " + entityNode->entity().classname());
+        },
+        [&](const BrushNode* brushNode) {
+          result.push_back(
+            "brush " + brushNode->brush().face(0).attributes().materialName());
+        },
+        [](const PatchNode*) {}));
+    }
+  }
+  return kdl::vec_sort(std::move(result));
+}
+
+} // namespace
+
+TEST_CASE("AutosaveJournal")
+{
+  auto env = io::TestEnvironment{};
+
+  auto fixture = MapFixture{};
+  auto& map = fixture.map();
+  fixture.create();
+
+  auto journal = AutosaveJournal{map};
+  CHECK_FALSE(journal.hasSnapshot());
+
+  auto* entityNode = new EntityNode{Entity{{{"classname", "light"}}}};
+  auto* brushNode = createBrushNode(map, "first");
+  addNodes(map, {{parentForNodes(map), {entityNode, brushNode}}});
+
+  const auto snapshotPath = env.dir() / "snapshot.map";
+  map.saveTo(snapshotPath);
+  journal.recordSnapshot();
+
+  CHECK(journal.hasSnapshot());
+  CHECK(journal.entryCount() == 0);
+
+  const auto loadSnapshot = [&](MapFixture& recoveredFixture) -> Map& {
+    recoveredFixture.load(snapshotPath, {.mapFormat = MapFormat::Standard});
+    return recoveredFixture.map();
+  };
+
+  SECTION("An unchanged map yields an empty entry")
+  {
+    CHECK(journal.createEntry() == "entry\nremove\nend\n");
+    CHECK(journal.entryCount() == 1);
+  }
+
+  SECTION("Changing a layer discards the snapshot")
+  {
+    renameLayer(map, map.world()->defaultLayer(), "new name");
+    CHECK_FALSE(journal.hasSnapshot());
+  }
+
+  SECTION("Recording a new snapshot resets the entry count")
+  {
+    journal.createEntry();
+    REQUIRE(journal.entryCount() == 1);
+
+    journal.recordSnapshot();
+    CHECK(journal.entryCount() == 0);
+  }
+
+  SECTION("Applying an entry restores the changes")
+  {
+    selectNodes(map, {entityNode});
+    setEntityProperty(map, "classname", "info_player_start");
+    deselectAll(map);
+
+    removeNodes(map, {brushNode});
+    addNodes(map, {{parentForNodes(map), {createBrushNode(map, "second")}}});
+
+    const auto journalStr = makeAutosaveJournalHeader("snapshot.map")
+                            + journal.createEntry();
+    CHECK(
+      readAutosaveJournalSnapshotFilename(journalStr)
+      == Result<std::filesystem::path>{"snapshot.map"});
+
+    auto recoveredFixture = MapFixture{};
+    auto& recoveredMap = loadSnapshot(recoveredFixture);
+    REQUIRE(
+      describeNodes(recoveredMap)
+      == std::vector<std::string>{"brush first", "entity light"});
+
+    CHECK(applyAutosaveJournal(recoveredMap, journalStr).is_success());
+    CHECK(describeNodes(recoveredMap) == describeNodes(map));
+  }
+
+  SECTION("Entries are cumulative")
+  {
+    removeNodes(map, {brushNode});
+    const auto firstEntry = journal.createEntry();
+
+    addNodes(map, {{parentForNodes(map), {createBrushNode(map, "second")}}});
+    const auto secondEntry = journal.createEntry();
+
+    const auto journalStr =
+      makeAutosaveJournalHeader("snapshot.map") + firstEntry + secondEntry;
+
+    auto recoveredFixture = MapFixture{};
+    auto& recoveredMap = loadSnapshot(recoveredFixture);
+
+    CHECK(applyAutosaveJournal(recoveredMap, journalStr).is_success());
+    CHECK(
+      describeNodes(recoveredMap)
+      == std::vector<std::string>{"brush second", "entity light"});
+  }
+
+  SECTION("Incomplete entries are ignored")
+  {
+    removeNodes(map, {brushNode});
+    const auto firstEntry = journal.createEntry();
+
+    addNodes(map, {{parentForNodes(map), {createBrushNode(map, "second")}}});
+    const auto secondEntry = journal.createEntry();
+
+    const auto journalStr = makeAutosaveJournalHeader("snapshot.map") + firstEntry
+                            + secondEntry.substr(0, secondEntry.size() / 2);
+
+    auto recoveredFixture = MapFixture{};
+    auto& recoveredMap = loadSnapshot(recoveredFixture);
+
+    CHECK(applyAutosaveJournal(recoveredMap, journalStr).is_success());
+    CHECK(describeNodes(recoveredMap) == std::vector<std::string>{"entity light"});
+  }
+
+  SECTION("A journal without a header is rejected")
+  {
+    CHECK(applyAutosaveJournal(map, "entry\nremove\nend\n").is_error());
+  }
+}
+
+} // namespace tb::mdl
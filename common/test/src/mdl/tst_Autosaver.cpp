@@ -21,15 +21,20 @@
 
 #include "MapFixture.h"
 #include "TestFactory.h"
+#include "io/CompressedMapFile.h"
 #include "io/DiskFileSystem.h"
 #include "io/TestEnvironment.h"
+#include "io/TestParserStatus.h"
 #include "mdl/Autosaver.h"
 #include "mdl/BrushNode.h" // IWYU pragma: keep
 #include "mdl/EditorContext.h"
 #include "mdl/EntityNode.h"
+#include "mdl/Game.h"
 #include "mdl/LayerNode.h" // IWYU pragma: keep
 #include "mdl/Map.h"
+#include "mdl/MapLoader.h"
 #include "mdl/Map_Nodes.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/vector_utils.h"
 
@@ -40,6 +45,7 @@
 #include <thread>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 namespace tb::mdl
 {
@@ -200,6 +206,164 @@ TEST_CASE("Autosaver")
     CHECK(env.fileExists("autosave/test.2.map"));
   }
 
+  SECTION("Background autosave")
+  {
+    map.saveAs(env.dir() / "test.map");
+    REQUIRE(env.fileExists("test.map"));
+
+    auto autosaver = Autosaver{map, 0s, 50, AutosaveMode::Background};
+
+    // modify the map
+    addNodes(map, {{map.editorContext().currentLayer(), {new EntityNode{{}}}}});
+
+    autosaver.triggerAutosave();
+
+    SECTION("The backup is written")
+    {
+      autosaver.waitForPendingAutosave();
+
+      CHECK(env.loadFile("autosave/test.1.map") == R"(// Game: Test
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+}
+)");
+    }
+
+    SECTION("Changes made after triggering the autosave are not included")
+    {
+      addNodes(map, {{map.editorContext().currentLayer(), {new EntityNode{{}}}}});
+      autosaver.waitForPendingAutosave();
+
+      CHECK(env.loadFile("autosave/test.1.map") == R"(// Game: Test
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+}
+)");
+
+      autosaver.triggerAutosave();
+      autosaver.waitForPendingAutosave();
+
+      CHECK(env.fileExists("autosave/test.2.map"));
+    }
+  }
+
+  SECTION("Compressed autosave")
+  {
+    map.saveAs(env.dir() / "test.map");
+    REQUIRE(env.fileExists("test.map"));
+
+    const auto mode = GENERATE(AutosaveMode::Blocking, AutosaveMode::Background);
+
+    auto autosaver = Autosaver{map, 0s, 50, mode, 0, true};
+
+    // modify the map
+    addNodes(map, {{map.editorContext().currentLayer(), {new EntityNode{{}}}}});
+
+    autosaver.triggerAutosave();
+    autosaver.waitForPendingAutosave();
+
+    const auto backup = env.loadFile("autosave/test.1.map");
+    CHECK(io::isCompressedMapFile(backup));
+    CHECK(io::decompressMapFile(backup) == R"(// Game: Test
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+}
+)");
+
+    auto parserStatus = io::TestParserStatus{};
+    const auto worldNode = readMapFile(
+      map.game()->config(),
+      MapFormat::Standard,
+      map.worldBounds(),
+      env.dir() / "autosave/test.1.map",
+      std::nullopt,
+      parserStatus,
+      map.taskManager());
+    REQUIRE(worldNode.is_success());
+    CHECK(worldNode.value()->defaultLayer()->childCount() == 1);
+  }
+
+  SECTION("Journal recovery")
+  {
+    map.saveAs(env.dir() / "test.map");
+    REQUIRE(env.fileExists("test.map"));
+
+    CHECK(findAutosaveRecovery(env.dir() / "test.map") == std::nullopt);
+
+    const auto mode = GENERATE(AutosaveMode::Blocking, AutosaveMode::Background);
+
+    auto autosaver = Autosaver{map, 0s, 50, mode, 5};
+
+    // make sure that the journal is newer than the map file
+    std::this_thread::sleep_for(100ms);
+
+    // the first autosave creates a backup and starts the journal
+    addNodes(map, {{map.editorContext().currentLayer(), {new EntityNode{{}}}}});
+    autosaver.triggerAutosave();
+    autosaver.waitForPendingAutosave();
+
+    REQUIRE(env.fileExists("autosave/test.1.map"));
+    REQUIRE(env.fileExists("autosave/test.journal"));
+
+    // the second autosave appends an entry to the journal
+    addNodes(map, {{map.editorContext().currentLayer(), {new EntityNode{{}}}}});
+    autosaver.triggerAutosave();
+    autosaver.waitForPendingAutosave();
+
+    CHECK_FALSE(env.fileExists("autosave/test.2.map"));
+
+    const auto recovery = findAutosaveRecovery(env.dir() / "test.map");
+    REQUIRE(recovery);
+    CHECK(recovery->snapshotPath == env.dir() / "autosave/test.1.map");
+
+    SECTION("Recovering restores the autosaved changes")
+    {
+      auto recoveredFixture = MapFixture{};
+      recoveredFixture.load(env.dir() / "test.map", {.mapFormat = MapFormat::Standard});
+
+      auto& recoveredMap = recoveredFixture.map();
+      REQUIRE(recoveredMap.world()->defaultLayer()->childCount() == 0);
+
+      CHECK(recoveredMap.recoverAutosave(recovery->snapshotPath, recovery->journal)
+              .is_success());
+      CHECK(recoveredMap.path() == env.dir() / "test.map");
+      CHECK(recoveredMap.modified());
+      CHECK(recoveredMap.world()->defaultLayer()->childCount() == 2);
+    }
+
+    SECTION("Saving the map makes the journal obsolete")
+    {
+      std::this_thread::sleep_for(100ms);
+      map.save();
+
+      CHECK(findAutosaveRecovery(env.dir() / "test.map") == std::nullopt);
+    }
+
+    SECTION("Deleting the journal keeps the backups")
+    {
+      CHECK(deleteAutosaveJournal(env.dir() / "test.map").is_success());
+
+      CHECK_FALSE(env.fileExists("autosave/test.journal"));
+      CHECK(env.fileExists("autosave/test.1.map"));
+      CHECK(findAutosaveRecovery(env.dir() / "test.map") == std::nullopt);
+    }
+  }
+
   SECTION("Cleanup")
   {
     constexpr auto maxBackups = 3u;
@@ -334,6 +334,100 @@ TEST_CASE("Brush")
           })
           .is_error());
     }
+
+    SECTION("With geometry")
+    {
+      const auto worldBounds = vm::bbox3d{4096.0};
+
+      const auto brushBuilder = BrushBuilder{MapFormat::Standard, worldBounds};
+      const auto brush =
+        brushBuilder.createIcoSphere(vm::bbox3d{64.0}, 1, "material") | kdl::value();
+
+      const auto& geometry = brush.compactGeometry();
+      auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+      for (size_t i = 0; i < geometry.faceCount(); ++i)
+      {
+        const auto indices = geometry.faceVertexIndices(i);
+        faceVertexIndices.emplace_back(indices.begin(), indices.end());
+      }
+
+      SECTION("Geometry matches faces")
+      {
+        const auto created =
+          Brush::create(
+            worldBounds, brush.faces(), geometry.positions(), faceVertexIndices)
+          | kdl::value();
+
+        CHECK(created == brush);
+        CHECK(created.fullySpecified());
+        CHECK(created.closed());
+        CHECK(created.bounds() == brush.bounds());
+        CHECK(created.edgeCount() == brush.edgeCount());
+
+        // the vertices are created in the given order
+        CHECK(created.vertexPositions() == geometry.positions());
+
+        for (size_t i = 0; i < brush.faceCount(); ++i)
+        {
+          CHECK(created.face(i).vertexPositions() == brush.face(i).vertexPositions());
+        }
+      }
+
+      SECTION("Geometry doesn't match faces")
+      {
+        const auto other =
+          brushBuilder.createIcoSphere(vm::bbox3d{128.0}, 1, "material") | kdl::value();
+
+        const auto created =
+          Brush::create(
+            worldBounds, other.faces(), geometry.positions(), faceVertexIndices)
+          | kdl::value();
+
+        CHECK(created.fullySpecified());
+        CHECK(created.bounds() == other.bounds());
+        CHECK_THAT(
+          created.vertexPositions(),
+          Catch::Matchers::UnorderedEquals(other.vertexPositions()));
+      }
+
+      SECTION("Geometry exceeds world bounds")
+      {
+        CHECK(Brush::create(
+                vm::bbox3d{32.0}, brush.faces(), geometry.positions(), faceVertexIndices)
+                .is_error());
+      }
+    }
+  }
+
+  SECTION("copy")
+  {
+    const auto worldBounds = vm::bbox3d{4096.0};
+
+    const auto brushBuilder = BrushBuilder{MapFormat::Valve, worldBounds};
+    const auto brush = brushBuilder.createCube(64.0, "material") | kdl::value();
+
+    auto copy = brush;
+    REQUIRE(copy == brush);
+
+    // copies share the geometry until they change it
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      CHECK(copy.face(i).geometry() == brush.face(i).geometry());
+    }
+
+    auto attributes = copy.face(0).attributes();
+    attributes.setXOffset(16.0f);
+    copy.face(0).setAttributes(attributes);
+    CHECK(copy.face(0).geometry() == brush.face(0).geometry());
+
+    REQUIRE(copy.expand(worldBounds, 16.0, false).is_success());
+    CHECK(copy.bounds() == vm::bbox3d{48.0});
+    CHECK(brush.bounds() == vm::bbox3d{32.0});
+    CHECK(brush.vertexCount() == 8u);
+    for (const auto* vertex : brush.vertices())
+    {
+      CHECK(vm::abs(vertex->position()) == vm::vec3d{32, 32, 32});
+    }
   }
 
   SECTION("cloneFaceAttributesFrom")
@@ -520,6 +614,98 @@ TEST_CASE("Brush")
     }
   }
 
+  SECTION("transform")
+  {
+    const auto worldBounds = vm::bbox3d{4096.0};
+
+    const auto brushBuilder = BrushBuilder{MapFormat::Valve, worldBounds};
+    const auto brush =
+      brushBuilder.createCuboid(vm::bbox3d{{-16, -32, 0}, {16, 32, 48}}, "material")
+      | kdl::value();
+    const auto originalVertexPositions = brush.vertexPositions();
+
+    // translations and axis aligned rotations transform the geometry directly, the other
+    // transformations rebuild it from the transformed faces
+    const auto transformation = GENERATE(
+      vm::translation_matrix(vm::vec3d{16, 8, -32}),
+      vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0)),
+      vm::translation_matrix(vm::vec3d{8, 0, 0})
+        * vm::rotation_matrix(vm::vec3d{1, 0, 0}, vm::to_radians(180.0)),
+      vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(45.0)),
+      vm::scaling_matrix(vm::vec3d{-1, 1, 1}));
+
+    auto transformed = brush;
+    REQUIRE(transformed.transform(worldBounds, transformation, true).is_success());
+
+    auto transformedFaces = brush.faces();
+    for (auto& face : transformedFaces)
+    {
+      REQUIRE(face.transform(transformation, true).is_success());
+    }
+    const auto expected =
+      Brush::create(worldBounds, std::move(transformedFaces)) | kdl::value();
+
+    CHECK(transformed == expected);
+    CHECK(transformed.bounds() == expected.bounds());
+    CHECK_THAT(
+      transformed.vertexPositions(),
+      Catch::Matchers::UnorderedEquals(expected.vertexPositions()));
+
+    for (size_t i = 0; i < expected.faceCount(); ++i)
+    {
+      CHECK_THAT(
+        transformed.face(i).vertexPositions(),
+        Catch::Matchers::UnorderedEquals(expected.face(i).vertexPositions()));
+    }
+
+    // the geometry of the original brush is not modified
+    CHECK(brush.vertexPositions() == originalVertexPositions);
+  }
+
+  SECTION("transform with expected result")
+  {
+    const auto worldBounds = vm::bbox3d{4096.0};
+
+    const auto brushBuilder = BrushBuilder{MapFormat::Valve, worldBounds};
+    const auto brush = brushBuilder.createCube(64.0, "material") | kdl::value();
+
+    // the rotation changes the order of the faces
+    const auto transformation =
+      vm::translation_matrix(vm::vec3d{16, 0, 0})
+      * vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0));
+
+    auto expected = brush;
+    REQUIRE(expected.transform(worldBounds, transformation, true).is_success());
+
+    SECTION("Shares the geometry of the expected brush if the result matches")
+    {
+      auto transformed = brush;
+      REQUIRE(
+        transformed.transform(worldBounds, transformation, true, expected).is_success());
+      CHECK(transformed == expected);
+
+      for (size_t i = 0; i < expected.faceCount(); ++i)
+      {
+        CHECK(transformed.face(i).geometry() == expected.face(i).geometry());
+      }
+    }
+
+    SECTION("Builds new geometry if the result doesn't match")
+    {
+      const auto otherTransformation = vm::translation_matrix(vm::vec3d{32, 0, 0});
+
+      auto other = brush;
+      REQUIRE(other.transform(worldBounds, otherTransformation, true).is_success());
+
+      auto transformed = brush;
+      REQUIRE(
+        transformed.transform(worldBounds, transformation, true, other).is_success());
+      CHECK(transformed == expected);
+      CHECK(transformed.face(0).geometry() != other.face(0).geometry());
+      CHECK(transformed.face(0).geometry() != expected.face(0).geometry());
+    }
+  }
+
   SECTION("transformVertices")
   {
     SECTION("Move vertex onto adjacent vertex and back")
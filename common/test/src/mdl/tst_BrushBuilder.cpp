@@ -25,6 +25,7 @@
 
 #include "kdl/ranges/to.h"
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
 
 #include <string>
 
@@ -242,13 +243,15 @@ TEST_CASE("BrushBuilder")
 
   SECTION("createHollowCylinder")
   {
+    auto taskManager = kdl::task_manager{};
     auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
     const auto cylinder = builder.createHollowCylinder(
       vm::bbox3d{{-32, -32, -32}, {32, 32, 32}},
       8.0,
       EdgeAlignedCircle{8},
       vm::axis::z,
-      "someName");
+      "someName",
+      taskManager);
 
     CHECK(cylinder.is_success());
     CHECK(cylinder.value().size() == 8);
@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushFaceAttributes.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("BrushFaceAttributes")
+{
+  SECTION("Copies share their data until modified")
+  {
+    auto original = BrushFaceAttributes{"material"};
+    original.setXOffset(8.0f);
+
+    auto copy = original;
+    CHECK(copy.sharesData(original));
+    CHECK(copy == original);
+
+    CHECK(copy.setRotation(45.0f));
+    CHECK(!copy.sharesData(original));
+    CHECK(copy != original);
+
+    CHECK(original.rotation() == 0.0f);
+    CHECK(original.xOffset() == 8.0f);
+    CHECK(copy.rotation() == 45.0f);
+    CHECK(copy.xOffset() == 8.0f);
+  }
+
+  SECTION("Setting an unchanged value keeps the data shared")
+  {
+    const auto original = BrushFaceAttributes{"material"};
+
+    auto copy = original;
+    CHECK(!copy.setMaterialName("material"));
+    CHECK(copy.sharesData(original));
+  }
+
+  SECTION("Equal interned attributes share their data")
+  {
+    auto attributes1 = BrushFaceAttributes{"material"};
+    attributes1.setSurfaceContents(4);
+
+    auto attributes2 = BrushFaceAttributes{"material"};
+    attributes2.setSurfaceContents(4);
+
+    auto attributes3 = BrushFaceAttributes{"other"};
+
+    REQUIRE(!attributes1.sharesData(attributes2));
+    CHECK(attributes1 == attributes2);
+
+    attributes1.intern();
+    attributes2.intern();
+    attributes3.intern();
+
+    CHECK(attributes1.sharesData(attributes2));
+    CHECK(!attributes1.sharesData(attributes3));
+
+    SECTION("Modifying interned attributes does not affect the others")
+    {
+      CHECK(attributes1.setSurfaceContents(8));
+      CHECK(!attributes1.sharesData(attributes2));
+      CHECK(attributes2.surfaceContents() == 4);
+    }
+  }
+}
+
+} // namespace tb::mdl
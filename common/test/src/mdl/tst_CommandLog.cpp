@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MapFixture.h"
+#include "TestFactory.h"
+#include "io/TestEnvironment.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/CommandLog.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Entities.h"
+#include "mdl/Map_Geometry.h"
+#include "mdl/Map_Layers.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::vector<std::string> describeNodes(const Map& map)
+{
+  auto result = std::vector<std::string>{};
+  for (const auto* layerNode : map.world()->allLayers())
+  {
+    for (const auto* node : layerNode->children())
+    {
+      node->accept(kdl::overload(
+        [](const WorldNode*) {},
+        [](const LayerNode*) {},
+        [](const GroupNode*) {},
+        [&](const EntityNode* entityNode) {
+          result.push_back("entity " + entityNode->entity().classname());
+        },
+        [&](const BrushNode* brushNode) {
+          result.push_back(fmt::format(
+            "brush {} at {}",
+            brushNode->brush().face(0).attributes().materialName(),
+            brushNode->logicalBounds().min.x()));
+        },
+        [](const PatchNode*) {}));
+    }
+  }
+  return kdl::vec_sort(std::move(result));
+}
+
+} // namespace
+
+TEST_CASE("CommandLog")
+{
+  auto env = io::TestEnvironment{};
+
+  auto fixture = MapFixture{};
+  auto& map = fixture.map();
+  fixture.create();
+
+  auto* entityNode = new EntityNode{Entity{{{"classname", "light"}}}};
+  auto* brushNode = createBrushNode(map, "first");
+  addNodes(map, {{parentForNodes(map), {entityNode, brushNode}}});
+
+  const auto snapshotPath = env.dir() / "snapshot.map";
+  map.saveTo(snapshotPath);
+
+  auto recorder = CommandLogRecorder{map};
+  CHECK_FALSE(recorder.recording());
+
+  recorder.start();
+  CHECK(recorder.recording());
+  CHECK(recorder.stepCount() == 0);
+
+  const auto replay = [&](const std::string& steps) {
+    const auto log = makeCommandLogHeader("snapshot.map") + steps;
+    CHECK(
+      readCommandLogSnapshotFilename(log)
+      == Result<std::filesystem::path>{"snapshot.map"});
+
+    auto replayFixture = MapFixture{};
+    replayFixture.load(snapshotPath, {.mapFormat = MapFormat::Standard});
+    auto& replayMap = replayFixture.map();
+    REQUIRE(
+      describeNodes(replayMap)
+      == std::vector<std::string>{"brush first at -16", "entity light"});
+
+    const auto profiles = replayCommandLog(replayMap, log) | kdl::value();
+    CHECK(profiles.size() == recorder.stepCount());
+    CHECK(describeNodes(replayMap) == describeNodes(map));
+    return kdl::vec_transform(profiles, [](const auto& profile) {
+      return std::tuple{profile.commandName, profile.operation};
+    });
+  };
+
+  SECTION("Steps that do not change any nodes are not recorded")
+  {
+    selectNodes(map, {brushNode});
+    deselectAll(map);
+
+    CHECK(recorder.stepCount() == 0);
+    CHECK(recorder.steps().empty());
+  }
+
+  SECTION("Replaying a log repeats the recorded steps")
+  {
+    selectNodes(map, {entityNode});
+    setEntityProperty(map, "classname", "info_player_start");
+    deselectAll(map);
+
+    selectNodes(map, {brushNode});
+    translateSelection(map, {32, 0, 0});
+    deselectAll(map);
+
+    removeNodes(map, {brushNode});
+    addNodes(map, {{parentForNodes(map), {createBrushNode(map, "second")}}});
+    map.undoCommand();
+    addNodes(map, {{parentForNodes(map), {createBrushNode(map, "third")}}});
+
+    CHECK(recorder.stepCount() == 6);
+    CHECK(
+      replay(recorder.steps())
+      == std::vector<std::tuple<std::string, CommandOperation>>{
+        {"Set Property", CommandOperation::Do},
+        {"Translate Objects", CommandOperation::Do},
+        {"Remove Objects", CommandOperation::Do},
+        {"Add Objects", CommandOperation::Do},
+        {"Add Objects", CommandOperation::Undo},
+        {"Add Objects", CommandOperation::Do},
+      });
+  }
+
+  SECTION("Nodes added during recording can be changed and removed")
+  {
+    auto* newBrushNode = createBrushNode(map, "second");
+    addNodes(map, {{parentForNodes(map), {newBrushNode}}});
+
+    selectNodes(map, {newBrushNode});
+    translateSelection(map, {64, 0, 0});
+    deselectAll(map);
+
+    removeNodes(map, {brushNode});
+
+    CHECK(recorder.stepCount() == 3);
+    replay(recorder.steps());
+  }
+
+  SECTION("Changing a layer stops recording")
+  {
+    renameLayer(map, map.world()->defaultLayer(), "new name");
+    CHECK_FALSE(recorder.recording());
+    CHECK(recorder.stepCount() == 0);
+  }
+
+  SECTION("A log without a header is rejected")
+  {
+    CHECK(replayCommandLog(map, "step do Translate Objects\nremove\nend\n").is_error());
+  }
+
+  SECTION("A log that refers to an unknown node is rejected")
+  {
+    const auto log = makeCommandLogHeader("snapshot.map")
+                     + "step do Remove Objects\nremove 17\nend\n";
+    CHECK(replayCommandLog(map, log).is_error());
+  }
+}
+
+} // namespace tb::mdl
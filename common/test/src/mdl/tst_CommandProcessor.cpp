@@ -20,10 +20,21 @@
 #include "Macros.h"
 #include "MapFixture.h"
 #include "NotifierConnection.h"
+#include "mdl/AddRemoveNodesCommand.h"
 #include "mdl/CommandProcessor.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
 #include "mdl/Map.h"
+#include "mdl/Map_Groups.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/NodeContents.h"
+#include "mdl/SwapNodeContentsCommand.h"
 #include "mdl/TransactionScope.h"
 #include "mdl/UndoableCommand.h"
+#include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
 
 #include "kdl/vector_utils.h"
@@ -245,6 +256,31 @@ public:
   }
 };
 
+class SizedCommand : public UndoableCommand
+{
+private:
+  size_t m_memoryUsage;
+
+public:
+  SizedCommand(std::string name, const size_t memoryUsage)
+    : UndoableCommand{std::move(name), false}
+    , m_memoryUsage{memoryUsage}
+  {
+  }
+
+  size_t memoryUsage() const override { return m_memoryUsage; }
+
+  std::unique_ptr<CommandResult> doPerformDo(Map&) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+
+  std::unique_ptr<CommandResult> doPerformUndo(Map&) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+};
+
 } // namespace
 
 TEST_CASE("CommandProcessor")
@@ -805,6 +841,195 @@ TEST_CASE("CommandProcessor")
 
     commandProcessor.undo();
   }
+
+  SECTION("compactTransactionCommands")
+  {
+    auto* entityNode1 = new EntityNode{Entity{{{"key", "a"}}}};
+    auto* entityNode2 = new EntityNode{Entity{{{"key", "b"}}}};
+    commandProcessor.executeAndStore(AddRemoveNodesCommand::add(
+      map.world()->defaultLayer(), {entityNode1, entityNode2}));
+
+    const auto setValue = [](EntityNode* entityNode, std::string value) {
+      auto entity = entityNode->entity();
+      entity.addOrUpdateProperty("key", std::move(value));
+      return std::make_unique<SwapNodeContentsCommand>(
+        "set value",
+        std::vector<std::pair<Node*, NodeContents>>{
+          {entityNode, NodeContents{std::move(entity)}}});
+    };
+
+    const auto valueOf = [](const EntityNode* entityNode) {
+      return *entityNode->entity().property("key");
+    };
+
+    commandProcessor.startTransaction("transaction", TransactionScope::Oneshot);
+    commandProcessor.executeAndStore(setValue(entityNode1, "c"));
+    commandProcessor.executeAndStore(setValue(entityNode2, "d"));
+    commandProcessor.executeAndStore(setValue(entityNode1, "e"));
+
+    commandProcessor.startTransaction("nested transaction", TransactionScope::Oneshot);
+    commandProcessor.executeAndStore(setValue(entityNode2, "f"));
+    commandProcessor.commitTransaction();
+
+    const auto memoryUsageBeforeCommit = commandProcessor.memoryUsage();
+    commandProcessor.commitTransaction();
+    const auto transactionMemoryUsage =
+      commandProcessor.memoryUsage() - memoryUsageBeforeCommit;
+
+    REQUIRE(valueOf(entityNode1) == "e");
+    REQUIRE(valueOf(entityNode2) == "f");
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK(valueOf(entityNode1) == "a");
+    CHECK(valueOf(entityNode2) == "b");
+
+    CHECK(commandProcessor.redo()->success());
+    CHECK(valueOf(entityNode1) == "e");
+    CHECK(valueOf(entityNode2) == "f");
+
+    // one snapshot per node
+    const auto compactedCommand = setValue(entityNode1, "g");
+    CHECK(transactionMemoryUsage < 3 * compactedCommand->memoryUsage());
+  }
+
+  SECTION("compactTransactionCommands with linked group updates")
+  {
+    const auto createLinkedGroup = [&](std::string value) {
+      auto* entityNode = new EntityNode{Entity{{{"key", std::move(value)}}}};
+      addNodes(map, {{parentForNodes(map), {entityNode}}});
+
+      deselectAll(map);
+      selectNodes(map, {entityNode});
+      auto* groupNode = groupSelectedNodes(map, "group");
+
+      deselectAll(map);
+      selectNodes(map, {groupNode});
+      auto* linkedGroupNode = createLinkedDuplicate(map);
+      deselectAll(map);
+
+      return std::pair{groupNode, linkedGroupNode};
+    };
+
+    const auto setValue = [&](GroupNode* groupNode, std::string value) {
+      auto* entityNode = dynamic_cast<EntityNode*>(groupNode->children().front());
+      auto entity = entityNode->entity();
+      entity.addOrUpdateProperty("key", std::move(value));
+      updateNodeContents(
+        map, "set value", {{entityNode, NodeContents{std::move(entity)}}}, {groupNode});
+    };
+
+    const auto valueOf = [](const GroupNode* groupNode) {
+      const auto* entityNode =
+        dynamic_cast<const EntityNode*>(groupNode->children().front());
+      return *entityNode->entity().property("key");
+    };
+
+    auto [groupNode1, linkedGroupNode1] = createLinkedGroup("a");
+    auto [groupNode2, linkedGroupNode2] = createLinkedGroup("b");
+
+    map.startTransaction("transaction", TransactionScope::Oneshot);
+    setValue(groupNode1, "c");
+    setValue(groupNode2, "d");
+    map.commitTransaction();
+
+    REQUIRE(valueOf(groupNode1) == "c");
+    REQUIRE(valueOf(linkedGroupNode1) == "c");
+    REQUIRE(valueOf(groupNode2) == "d");
+    REQUIRE(valueOf(linkedGroupNode2) == "d");
+
+    map.undoCommand();
+    CHECK(valueOf(groupNode1) == "a");
+    CHECK(valueOf(linkedGroupNode1) == "a");
+    CHECK(valueOf(groupNode2) == "b");
+    CHECK(valueOf(linkedGroupNode2) == "b");
+
+    map.redoCommand();
+    CHECK(valueOf(groupNode1) == "c");
+    CHECK(valueOf(linkedGroupNode1) == "c");
+    CHECK(valueOf(groupNode2) == "d");
+    CHECK(valueOf(linkedGroupNode2) == "d");
+  }
+
+  SECTION("memoryBudget")
+  {
+    commandProcessor.setIsCollationEnabled(false);
+    commandProcessor.setMemoryBudget(250);
+
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 1", 100));
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 2", 100));
+    CHECK(commandProcessor.memoryUsage() == 200);
+
+    SECTION("Drops the oldest commands when the budget is exceeded")
+    {
+      commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 100));
+      CHECK(commandProcessor.memoryUsage() == 200);
+
+      CHECK(commandProcessor.undo()->success());
+      CHECK(commandProcessor.memoryUsage() == 100);
+      CHECK(commandProcessor.undo()->success());
+      CHECK(commandProcessor.memoryUsage() == 0);
+      CHECK_FALSE(commandProcessor.canUndo());
+      CHECK(commandProcessor.redoCommandName() == "command 2");
+
+      CHECK(commandProcessor.redo()->success());
+      CHECK(commandProcessor.memoryUsage() == 100);
+    }
+
+    SECTION("Keeps the most recent command even if it exceeds the budget")
+    {
+      commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 300));
+      CHECK(commandProcessor.memoryUsage() == 300);
+      CHECK(commandProcessor.undoCommandName() == "command 3");
+
+      CHECK(commandProcessor.undo()->success());
+      CHECK_FALSE(commandProcessor.canUndo());
+    }
+
+    SECTION("Lowering the budget drops commands")
+    {
+      commandProcessor.setMemoryBudget(150);
+      CHECK(commandProcessor.memoryUsage() == 100);
+      CHECK(commandProcessor.undoCommandName() == "command 2");
+    }
+
+    SECTION("Removing the budget keeps all commands")
+    {
+      commandProcessor.setMemoryBudget(std::nullopt);
+      commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 100));
+      CHECK(commandProcessor.memoryUsage() == 300);
+    }
+  }
+
+  SECTION("commandProfiles")
+  {
+    CHECK(commandProcessor.commandProfiles().empty());
+
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 1", 100));
+    commandProcessor.undo();
+    commandProcessor.redo();
+
+    const auto& profiles = commandProcessor.commandProfiles();
+    REQUIRE(profiles.size() == 3);
+    CHECK(profiles[0].commandName == "command 1");
+    CHECK(profiles[0].operation == CommandOperation::Do);
+    CHECK(profiles[0].nodesTouched == 0);
+    CHECK(profiles[0].memoryDelta == 0);
+    CHECK(profiles[1].operation == CommandOperation::Undo);
+    CHECK(profiles[2].operation == CommandOperation::Redo);
+
+    SECTION("Counts the touched nodes")
+    {
+      auto* entityNode = new EntityNode{Entity{}};
+      auto* layerNode = map.world()->defaultLayer();
+
+      commandProcessor.executeAndStore(
+        AddRemoveNodesCommand::add(layerNode, {entityNode}));
+      CHECK(profiles.back().nodesTouched == 3);
+
+      commandProcessor.undo();
+      CHECK(profiles.back().nodesTouched == 3);
+    }
+  }
 }
 
 } // namespace tb::mdl
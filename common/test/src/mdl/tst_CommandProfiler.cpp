@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mdl/CommandProfiler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("toReport")
+{
+  CHECK(
+    toReport({})
+    == "Profile of the last 0 commands\n"
+       "  do: 0 commands, 0.00 ms, 0 nodes\n"
+       "  undo: 0 commands, 0.00 ms, 0 nodes\n"
+       "  redo: 0 commands, 0.00 ms, 0 nodes\n");
+
+  const auto profiles = std::deque<CommandProfile>{
+    {"Move Objects", CommandOperation::Do, 12.5, 4, 256},
+    {"Move Objects", CommandOperation::Undo, 2.0, 4, 0},
+    {"Move Objects", CommandOperation::Redo, 3.0, 4, 0},
+    {"Create Brush", CommandOperation::Do, 1.25, 1, -16},
+  };
+
+  CHECK(
+    toReport(profiles, 2)
+    == "Profile of the last 4 commands\n"
+       "  do: 2 commands, 13.75 ms, 5 nodes\n"
+       "  undo: 1 commands, 2.00 ms, 4 nodes\n"
+       "  redo: 1 commands, 3.00 ms, 4 nodes\n"
+       "Slowest commands\n"
+       "  'Move Objects' (do) took 12.50 ms, touched 4 nodes, memory delta 256 bytes\n"
+       "  'Move Objects' (redo) took 3.00 ms, touched 4 nodes, memory delta 0 bytes\n");
+}
+
+TEST_CASE("CommandProfiler")
+{
+  auto profiler = CommandProfiler{2};
+  CHECK(profiler.profiles().empty());
+
+  profiler.addProfile({"Command 1", CommandOperation::Do, 1.0});
+  profiler.addProfile({"Command 2", CommandOperation::Do, 2.0});
+  profiler.addProfile({"Command 2", CommandOperation::Undo, 3.0});
+
+  CHECK(
+    profiler.profiles()
+    == std::deque<CommandProfile>{
+      {"Command 2", CommandOperation::Do, 2.0},
+      {"Command 2", CommandOperation::Undo, 3.0},
+    });
+
+  profiler.clear();
+  CHECK(profiler.profiles().empty());
+}
+
+} // namespace tb::mdl
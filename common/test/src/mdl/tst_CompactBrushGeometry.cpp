@@ -0,0 +1,205 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/CompactBrushGeometry.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+
+#include "vm/approx.h"
+#include "vm/mat_ext.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("CompactBrushGeometry")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  auto brush = builder.createCube(64.0, "material") | kdl::value();
+
+  SECTION("Matches the brush geometry")
+  {
+    const auto& geometry = brush.compactGeometry();
+
+    CHECK(geometry.bounds() == brush.bounds());
+    CHECK(geometry.vertexCount() == brush.vertexCount());
+    CHECK(geometry.faceCount() == brush.faceCount());
+    CHECK(geometry.edges().size() == brush.edgeCount());
+    REQUIRE(geometry.facePlanes().size() == brush.faceCount());
+
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      const auto& face = brush.face(i);
+      CHECK(geometry.facePlanes()[i] == face.boundary());
+
+      const auto indices = geometry.faceVertexIndices(i);
+      REQUIRE(indices.size() == face.vertexCount());
+
+      const auto expectedPositions = face.vertexPositions();
+      for (size_t j = 0; j < indices.size(); ++j)
+      {
+        CHECK(geometry.position(indices[j]) == expectedPositions[j]);
+      }
+    }
+
+    for (const auto& edge : geometry.edges())
+    {
+      const auto position1 = geometry.position(edge.vertexIndex1);
+      const auto position2 = geometry.position(edge.vertexIndex2);
+      CHECK(brush.hasEdge(vm::segment3d{position1, position2}));
+
+      const auto face1Indices = geometry.faceVertexIndices(edge.faceIndex1);
+      const auto face2Indices = geometry.faceVertexIndices(edge.faceIndex2);
+      for (const auto index : {edge.vertexIndex1, edge.vertexIndex2})
+      {
+        CHECK(std::ranges::find(face1Indices, index) != face1Indices.end());
+        CHECK(std::ranges::find(face2Indices, index) != face2Indices.end());
+      }
+    }
+  }
+
+  SECTION("Intersects faces with rays")
+  {
+    const auto& geometry = brush.compactGeometry();
+    const auto topFaceIndex = *brush.findFace(vm::vec3d{0, 0, 1});
+
+    const auto downRay = vm::ray3d{vm::vec3d{0, 0, 64}, vm::vec3d{0, 0, -1}};
+    const auto hit = geometry.intersectWithRay(downRay);
+    REQUIRE(hit);
+
+    const auto [distance, faceIndex] = *hit;
+    CHECK(distance == vm::approx{32.0});
+    CHECK(faceIndex == topFaceIndex);
+
+    const auto missingRay = vm::ray3d{vm::vec3d{64, 0, 64}, vm::vec3d{0, 0, -1}};
+    CHECK(geometry.intersectWithRay(missingRay) == std::nullopt);
+
+    // only the backs of the faces are visible from inside the brush
+    const auto upRay = vm::ray3d{vm::vec3d{0, 0, 0}, vm::vec3d{0, 0, 1}};
+    CHECK(geometry.intersectWithRay(upRay) == std::nullopt);
+  }
+
+  SECTION("Is shared between copies and updated when the geometry changes")
+  {
+    const auto copy = brush;
+    CHECK(&copy.compactGeometry() == &brush.compactGeometry());
+
+    const auto transform = vm::translation_matrix(vm::vec3d{16, 0, 0});
+    REQUIRE(brush.transform(worldBounds, transform, false).is_success());
+    CHECK(&copy.compactGeometry() != &brush.compactGeometry());
+    CHECK(brush.compactGeometry().bounds() == brush.bounds());
+    CHECK(copy.compactGeometry().bounds() == copy.bounds());
+  }
+
+  SECTION("Shares its shape with translated copies")
+  {
+    auto translated = brush;
+    const auto transform = vm::translation_matrix(vm::vec3d{128, -64, 32});
+    REQUIRE(translated.transform(worldBounds, transform, false).is_success());
+
+    const auto& geometry = brush.compactGeometry();
+    const auto& translatedGeometry = translated.compactGeometry();
+
+    CHECK(translatedGeometry.sharesShape(geometry));
+    CHECK(translatedGeometry.offset() == geometry.offset() + vm::vec3d{128, -64, 32});
+    CHECK(translatedGeometry.bounds() == translated.bounds());
+    CHECK_THAT(
+      translatedGeometry.positions(),
+      Catch::Matchers::UnorderedEquals(translated.vertexPositions()));
+
+    const auto downRay = vm::ray3d{vm::vec3d{128, -64, 128}, vm::vec3d{0, 0, -1}};
+    const auto hit = translatedGeometry.intersectWithRay(downRay);
+    REQUIRE(hit);
+    CHECK(std::get<0>(*hit) == vm::approx{64.0});
+
+    CHECK(geometry.intersectWithRay(downRay) == std::nullopt);
+  }
+
+  SECTION("Shares its shape with rotated copies")
+  {
+    const auto cuboid =
+      builder.createCuboid(vm::bbox3d{{0, 0, 0}, {64, 32, 16}}, "material")
+      | kdl::value();
+
+    auto rotated = cuboid;
+    const auto transform =
+      vm::translation_matrix(vm::vec3d{128, -64, 32})
+      * vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0));
+    REQUIRE(rotated.transform(worldBounds, transform, false).is_success());
+
+    const auto& geometry = cuboid.compactGeometry();
+    const auto& rotatedGeometry = rotated.compactGeometry();
+
+    CHECK(rotatedGeometry.sharesShape(geometry));
+    CHECK(rotatedGeometry.bounds() == rotated.bounds());
+    CHECK_THAT(
+      rotatedGeometry.positions(),
+      Catch::Matchers::UnorderedEquals(rotated.vertexPositions()));
+    REQUIRE(rotatedGeometry.facePlanes().size() == rotated.faceCount());
+
+    for (size_t i = 0; i < rotated.faceCount(); ++i)
+    {
+      const auto& face = rotated.face(i);
+      CHECK(rotatedGeometry.facePlanes()[i] == face.boundary());
+
+      auto positions = std::vector<vm::vec3d>{};
+      for (const auto index : rotatedGeometry.faceVertexIndices(i))
+      {
+        positions.push_back(rotatedGeometry.position(index));
+      }
+      CHECK_THAT(positions, Catch::Matchers::UnorderedEquals(face.vertexPositions()));
+    }
+
+    for (const auto& edge : rotatedGeometry.edges())
+    {
+      const auto face1Indices = rotatedGeometry.faceVertexIndices(edge.faceIndex1);
+      const auto face2Indices = rotatedGeometry.faceVertexIndices(edge.faceIndex2);
+      for (const auto index : {edge.vertexIndex1, edge.vertexIndex2})
+      {
+        CHECK(std::ranges::find(face1Indices, index) != face1Indices.end());
+        CHECK(std::ranges::find(face2Indices, index) != face2Indices.end());
+      }
+    }
+
+    const auto downRay = vm::ray3d{vm::vec3d{112, -32, 128}, vm::vec3d{0, 0, -1}};
+    const auto hit = rotatedGeometry.intersectWithRay(downRay);
+    REQUIRE(hit);
+    CHECK(std::get<0>(*hit) == vm::approx{80.0});
+    CHECK(std::get<1>(*hit) == *rotated.findFace(vm::vec3d{0, 0, 1}));
+  }
+
+  SECTION("Doesn't share its shape with differently shaped brushes")
+  {
+    const auto other = builder.createCuboid(vm::vec3d{64, 64, 32}, "material")
+                       | kdl::value();
+    CHECK(!other.compactGeometry().sharesShape(brush.compactGeometry()));
+  }
+}
+
+} // namespace tb::mdl
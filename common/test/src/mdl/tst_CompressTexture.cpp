@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/CompressTexture.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+
+#include <cstring>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+Texture makeTexture(
+  const size_t width,
+  const size_t height,
+  const GLenum format,
+  const unsigned char r,
+  const unsigned char g,
+  const unsigned char b,
+  const unsigned char a,
+  const TextureMask mask = TextureMask::Off)
+{
+  const auto bytesPerPixel = bytesPerPixelForFormat(format);
+  auto buffer = TextureBuffer{bytesPerPixel * width * height};
+  for (size_t i = 0; i < width * height; ++i)
+  {
+    auto* p = buffer.data() + i * bytesPerPixel;
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+    if (bytesPerPixel == 4)
+    {
+      p[3] = a;
+    }
+  }
+
+  return Texture{
+    width, height, Color{}, format, mask, NoEmbeddedDefaults{}, std::move(buffer)};
+}
+
+} // namespace
+
+TEST_CASE("compressTexture")
+{
+  SECTION("Opaque textures are compressed using DXT1")
+  {
+    const auto texture =
+      compressTexture(makeTexture(8, 8, GL_RGBA, 0xFF, 0x00, 0x00, 0xFF));
+    CHECK(texture.format() == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+
+    const auto& buffers = texture.buffersIfLoaded();
+    REQUIRE(buffers.size() == 4);
+    CHECK(buffers[0].size() == 4 * 8);
+    CHECK(buffers[1].size() == 8);
+    CHECK(buffers[2].size() == 8);
+    CHECK(buffers[3].size() == 8);
+
+    // pure red is exactly representable as RGB565, and all indices select color0
+    const unsigned char expected[] = {0x00, 0xF8, 0x00, 0xF8, 0, 0, 0, 0};
+    CHECK(std::memcmp(buffers[0].data(), expected, sizeof(expected)) == 0);
+  }
+
+  SECTION("Transparent textures are compressed using DXT5")
+  {
+    const auto texture =
+      compressTexture(makeTexture(4, 4, GL_RGBA, 0x00, 0x00, 0xFF, 0x80));
+    CHECK(texture.format() == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+
+    const auto& buffers = texture.buffersIfLoaded();
+    REQUIRE(buffers.size() == 3);
+    CHECK(buffers[0].size() == 16);
+
+    // alpha endpoints and indices, then blue as RGB565 with all indices selecting color0
+    const unsigned char expected[] = {
+      0x80, 0x80, 0, 0, 0, 0, 0, 0, 0x1F, 0x00, 0x1F, 0x00, 0, 0, 0, 0};
+    CHECK(std::memcmp(buffers[0].data(), expected, sizeof(expected)) == 0);
+  }
+
+  SECTION("BGR textures are converted")
+  {
+    const auto texture = compressTexture(makeTexture(4, 4, GL_BGR, 0xFF, 0x00, 0x00, 0));
+    CHECK(texture.format() == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+
+    // BGR 0xFF, 0x00, 0x00 is blue
+    const auto& buffers = texture.buffersIfLoaded();
+    const unsigned char expected[] = {0x1F, 0x00, 0x1F, 0x00};
+    CHECK(std::memcmp(buffers[0].data(), expected, sizeof(expected)) == 0);
+  }
+
+  SECTION("Partial blocks are padded")
+  {
+    const auto texture =
+      compressTexture(makeTexture(6, 3, GL_RGBA, 0xFF, 0xFF, 0xFF, 0xFF));
+    const auto& buffers = texture.buffersIfLoaded();
+    REQUIRE(buffers.size() == 3);
+    CHECK(buffers[0].size() == 2 * 8);
+    CHECK(buffers[1].size() == 8);
+    CHECK(buffers[2].size() == 8);
+  }
+
+  SECTION("Masked textures are not compressed")
+  {
+    const auto texture = compressTexture(
+      makeTexture(4, 4, GL_RGBA, 0xFF, 0xFF, 0xFF, 0xFF, TextureMask::On));
+    CHECK(texture.format() == GL_RGBA);
+    CHECK(texture.buffersIfLoaded().size() == 1);
+  }
+}
+
+} // namespace tb::mdl
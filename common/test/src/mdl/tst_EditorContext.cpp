@@ -1204,4 +1204,46 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
   }
 }
 
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cache")
+{
+  auto [groupNode, brushNode] = createGroupedBrush();
+
+  REQUIRE(context.visible(*groupNode));
+  REQUIRE(context.visible(*brushNode));
+  REQUIRE(context.editable(*brushNode));
+
+  SECTION("Cached state is kept until the cache is invalidated")
+  {
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+    groupNode->setLockState(LockState::Locked);
+
+    CHECK(context.visible(*groupNode));
+    CHECK(context.visible(*brushNode));
+    CHECK(context.editable(*brushNode));
+
+    context.invalidateCache();
+
+    CHECK_FALSE(context.visible(*groupNode));
+    CHECK_FALSE(context.visible(*brushNode));
+    CHECK_FALSE(context.editable(*brushNode));
+  }
+
+  SECTION("Changing the hidden tags invalidates the cache")
+  {
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+    context.setHiddenTags(1);
+
+    CHECK_FALSE(context.visible(*groupNode));
+    CHECK_FALSE(context.visible(*brushNode));
+  }
+
+  SECTION("Resetting clears the cache")
+  {
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+    context.reset();
+
+    CHECK_FALSE(context.visible(*brushNode));
+  }
+}
+
 } // namespace tb::mdl
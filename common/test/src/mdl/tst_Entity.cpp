@@ -209,6 +209,12 @@ TEST_CASE("EntityTest")
 
     entity.addOrUpdateProperty(EntityPropertyKeys::Spawnflags, "1");
     CHECK(entity.modelSpecification() == ModelSpecification{"maps/b_shell1.bsp", 0, 0});
+
+    entity.removeProperty(EntityPropertyKeys::Spawnflags);
+    CHECK(entity.modelSpecification() == ModelSpecification{"maps/b_shell0.bsp", 0, 0});
+
+    entity.setDefinition(nullptr);
+    CHECK(entity.modelSpecification() == ModelSpecification{});
   }
 
   SECTION("decalSpecification")
@@ -152,6 +152,93 @@ TEST_CASE("EntityModel")
     CHECK(renderer1 != nullptr);
     CHECK(renderer2 != nullptr);
   }
+
+  SECTION("buildSimplifiedRenderer")
+  {
+    auto modelData = EntityModelData{PitchType::Normal, Orientation::Oriented};
+    auto& frame = modelData.addFrame("test", vm::bbox3f{0, 64});
+
+    auto& surface = modelData.addSurface("surface", 1);
+
+    auto materials = std::vector<Material>{};
+    materials.push_back(makeDummyMaterial("skin"));
+    surface.setSkins(std::move(materials));
+
+    // a flat grid of 16 * 16 quads with an edge length of 4
+    auto size = render::IndexRangeMap::Size{};
+    size.inc(render::PrimType::Triangles, 16 * 16 * 2);
+
+    auto builder = render::IndexRangeMapBuilder<EntityModelVertex::Type>{
+      16 * 16 * 6, size};
+    for (size_t x = 0; x < 16; ++x)
+    {
+      for (size_t y = 0; y < 16; ++y)
+      {
+        const auto vertex = [&](const size_t i, const size_t j) {
+          return EntityModelVertex{
+            vm::vec3f{float(4 * (x + i)), float(4 * (y + j)), 0}, vm::vec2f{}};
+        };
+        builder.addTriangle(vertex(0, 0), vertex(1, 0), vertex(1, 1));
+        builder.addTriangle(vertex(0, 0), vertex(1, 1), vertex(0, 1));
+      }
+    }
+    surface.addMesh(frame, builder.vertices(), builder.indices());
+
+    // merging the vertices on a grid of the same size does not remove any triangles
+    CHECK(modelData.buildSimplifiedRenderer(0, 0, 16) == nullptr);
+    CHECK(modelData.buildSimplifiedRenderer(0, 0, 2) != nullptr);
+  }
+
+  SECTION("buildSimplifiedRenderer with degenerate mesh")
+  {
+    auto modelData = EntityModelData{PitchType::Normal, Orientation::Oriented};
+    auto& frame = modelData.addFrame("test", vm::bbox3f{0, 8});
+
+    auto& surface = modelData.addSurface("surface", 1);
+
+    auto materials = std::vector<Material>{};
+    materials.push_back(makeDummyMaterial("skin"));
+    surface.setSkins(std::move(materials));
+
+    auto builder = makeDummyBuilder();
+    surface.addMesh(frame, builder.vertices(), builder.indices());
+
+    CHECK(modelData.buildRenderer(0, 0) != nullptr);
+    CHECK(modelData.buildSimplifiedRenderer(0, 0, 2) == nullptr);
+  }
+
+  SECTION("addDeferredMesh")
+  {
+    auto modelData = EntityModelData{PitchType::Normal, Orientation::Oriented};
+    auto& frame = modelData.addFrame("test", vm::bbox3f{0, 8});
+
+    auto& surface = modelData.addSurface("surface", 1);
+
+    auto materials = std::vector<Material>{};
+    materials.push_back(makeDummyMaterial("skin"));
+    surface.setSkins(std::move(materials));
+
+    auto loadCount = 0;
+    surface.addDeferredMesh(frame, [&](auto& indices) {
+      ++loadCount;
+
+      auto builder = makeDummyBuilder();
+      indices = std::move(builder.indices());
+      return std::move(builder.vertices());
+    });
+
+    CHECK(loadCount == 0);
+    CHECK(modelData.memorySize() == 4);
+
+    CHECK(modelData.buildRenderer(0, 0) != nullptr);
+    CHECK(loadCount == 1);
+    CHECK(modelData.memorySize() == 3 * sizeof(EntityModelVertex) + 4);
+
+    const auto ray = vm::ray3f{vm::vec3f{0, 0, 1}, vm::vec3f{0, 0, -1}};
+    CHECK(frame.intersect(ray) == std::nullopt);
+    CHECK(modelData.buildRenderer(0, 0) != nullptr);
+    CHECK(loadCount == 1);
+  }
 }
 
 
@@ -21,6 +21,7 @@
 #include "mdl/EntityNodeBase.h"
 #include "mdl/EntityNodeIndex.h"
 
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -154,6 +155,71 @@ TEST_CASE("EntityNodeIndex")
       Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1}));
   }
 
+  SECTION("findEntityNodes appends to the given vector")
+  {
+    auto entity1 = EntityNode{Entity{{{"target", "somevalue"}}}};
+    auto entity2 = EntityNode{Entity{{
+      {"target1", "somevalue"},
+      {"target2", "somevalue"},
+    }}};
+
+    index.addEntityNode(&entity1);
+    index.addEntityNode(&entity2);
+
+    auto result = std::vector<EntityNodeBase*>{&entity2};
+    index.findEntityNodes(EntityNodeIndexQuery::numbered("target"), "somevalue", result);
+
+    REQUIRE(result.size() == 3u);
+    CHECK(result[0] == &entity2);
+    CHECK_THAT(
+      std::vector<EntityNodeBase*>(std::next(result.begin()), result.end()),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1, &entity2}));
+  }
+
+  SECTION("findEntityNodesWithKey")
+  {
+    auto entity1 = EntityNode{Entity{{{"target", "somevalue"}}}};
+    auto entity2 = EntityNode{Entity{{
+      {"target1", "somevalue"},
+      {"target12", "somevalue"},
+    }}};
+    auto entity3 = EntityNode{Entity{{{"targetname", "somevalue"}}}};
+
+    index.addEntityNode(&entity1);
+    index.addEntityNode(&entity2);
+    index.addEntityNode(&entity3);
+
+    const auto findWithKey = [&](const auto& keyQuery) {
+      auto result = std::vector<EntityNodeBase*>{};
+      index.findEntityNodesWithKey(keyQuery, result);
+      return result;
+    };
+
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::exact("target")),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1}));
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::prefix("target")),
+      Catch::Matchers::UnorderedEquals(
+        std::vector<EntityNodeBase*>{&entity1, &entity2, &entity3}));
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::numbered("target")),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1, &entity2}));
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::numbered("target1")),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity2}));
+
+    index.removeProperty(&entity2, "target1", "somevalue");
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::numbered("target")),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1, &entity2}));
+
+    index.removeProperty(&entity2, "target12", "somevalue");
+    CHECK_THAT(
+      findWithKey(EntityNodeIndexQuery::numbered("target")),
+      Catch::Matchers::UnorderedEquals(std::vector<EntityNodeBase*>{&entity1}));
+  }
+
   SECTION("addRemoveFloatProperty")
   {
     auto entity1 = EntityNode{Entity{{{"delay", "3.5"}}}};
@@ -204,6 +204,18 @@ TEST_CASE("GameFactory")
     CHECK(env.fileExists(userPath / "Migrate3" / "GameEngineProfiles.cfg"));
   }
 
+  SECTION("gameConfig loads profiles on first access")
+  {
+    REQUIRE(gameFactory.initialize({{env.dir() / gamesPath}, env.dir() / userPath})
+              .is_success());
+
+    CHECK(!gameFactory.experimental("Migrate 1"));
+    CHECK(env.directoryExists(userPath / "Migrate 1"));
+
+    CHECK(gameFactory.gameConfig("Migrate 1").compilationConfig.profiles.size() == 1);
+    CHECK(!env.directoryExists(userPath / "Migrate 1"));
+  }
+
   SECTION("saveCompilationConfig")
   {
     REQUIRE(gameFactory.initialize({{env.dir() / gamesPath}, env.dir() / userPath})
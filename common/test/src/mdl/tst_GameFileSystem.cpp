@@ -19,7 +19,9 @@
 
 #include "Logger.h"
 #include "TestUtils.h"
+#include "io/FileSystem.h"
 #include "io/PathInfo.h"
+#include "mdl/GameAssetCache.h"
 #include "mdl/GameConfig.h"
 #include "mdl/GameFileSystem.h"
 
@@ -115,6 +117,71 @@ TEST_CASE("GameFileSystem")
     CHECK(io::readTextFile(fs, "mod1_pak0_2.txt") == "mod1_pak1_2");
   }
 
+  SECTION("Mounts only changed additional search paths")
+  {
+    fs.initialize(config, fixturePath, {}, logger);
+
+    CHECK(fs.setAdditionalSearchPaths(config, fixturePath, {}, logger).empty());
+
+    CHECK(
+      fs.setAdditionalSearchPaths(config, fixturePath, {fixturePath / "mod1"}, logger)
+      == std::vector<std::filesystem::path>{
+        "id1_pak0_2.txt",
+        "id1_pak0_loose_file.txt",
+        "mod1_pak0_1.txt",
+        "mod1_pak0_2.txt",
+        "pak0.pak",
+        "pak1.PAK",
+      });
+    CHECK(io::readTextFile(fs, "id1_pak0_loose_file.txt") == "mod1");
+    CHECK(io::readTextFile(fs, "mod1_pak0_2.txt") == "mod1_pak1_2");
+
+    CHECK(
+      fs.setAdditionalSearchPaths(config, fixturePath, {fixturePath / "mod1"}, logger)
+        .empty());
+
+    CHECK(
+      fs.setAdditionalSearchPaths(config, fixturePath, {}, logger).size() == 6);
+    CHECK(io::readTextFile(fs, "id1_pak0_loose_file.txt") == "pak0");
+    CHECK(fs.pathInfo("mod1_pak0_1.txt") == io::PathInfo::Unknown);
+  }
+
+  SECTION("Mounts only changed wads")
+  {
+    const auto wadFixturePath = std::filesystem::current_path() / "fixture/test/io/Wad";
+
+    fs.initialize(config, fixturePath, {}, logger);
+
+    const auto changedPaths =
+      fs.reloadWads("textures", {wadFixturePath}, {"cr8_czg.wad"}, logger);
+    CHECK(changedPaths.size() == 21);
+    CHECK(fs.pathInfo("textures/coffin1.D") == io::PathInfo::File);
+
+    CHECK(fs.reloadWads("textures", {wadFixturePath}, {"cr8_czg.wad"}, logger).empty());
+
+    CHECK(
+      fs.reloadWads(
+        "textures", {wadFixturePath}, {"cr8_czg.wad", "cr8_a_excerpt.wad"}, logger)
+      == std::vector<std::filesystem::path>{"textures/added.D", "textures/cr8_czg_1.D"});
+
+    SECTION("Wads are kept when additional search paths change")
+    {
+      fs.setAdditionalSearchPaths(config, fixturePath, {fixturePath / "mod1"}, logger);
+
+      CHECK(fs.pathInfo("textures/coffin1.D") == io::PathInfo::File);
+      CHECK(fs.pathInfo("textures/added.D") == io::PathInfo::File);
+    }
+
+    SECTION("Wads that were removed are unmounted")
+    {
+      CHECK(
+        fs.reloadWads("textures", {wadFixturePath}, {"cr8_a_excerpt.wad"}, logger).size()
+        == 22);
+      CHECK(fs.pathInfo("textures/coffin1.D") == io::PathInfo::Unknown);
+      CHECK(fs.pathInfo("textures/added.D") == io::PathInfo::File);
+    }
+  }
+
   SECTION("Game path is case insensitive")
   {
 
@@ -146,6 +213,34 @@ TEST_CASE("GameFileSystem")
     CHECK(fs.pathInfo("id1_pak0_loose_file.txt") == io::PathInfo::File);
     CHECK(fs.pathInfo("mod1_pak0_1.txt") == io::PathInfo::Unknown);
   }
+
+  SECTION("Shares packages with other game file systems")
+  {
+    auto assetCache = std::make_shared<GameAssetCache>();
+    const auto pakPath = fixturePath / "id1" / "pak0.pak";
+
+    auto createCount = 0;
+    const auto createFileSystem = [&]() -> Result<std::unique_ptr<io::FileSystem>> {
+      ++createCount;
+      return Error{"should not be called"};
+    };
+
+    {
+      auto fs1 = GameFileSystem{assetCache};
+      fs1.initialize(config, fixturePath, {}, logger);
+
+      auto fs2 = GameFileSystem{assetCache};
+      fs2.initialize(config, fixturePath, {}, logger);
+
+      CHECK(io::readTextFile(fs2, "id1_pak0_1.txt") == "id1_pak0_1");
+      CHECK(assetCache->packageFileSystem(pakPath, createFileSystem).is_success());
+      CHECK(createCount == 0);
+    }
+
+    // the package is released when no game file system mounts it anymore
+    CHECK(assetCache->packageFileSystem(pakPath, createFileSystem).is_error());
+    CHECK(createCount == 1);
+  }
 }
 
 } // namespace tb::mdl
@@ -0,0 +1,195 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapFixture.h"
+#include "TestFactory.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Issue.h"
+#include "mdl/IssueCache.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Entities.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/mat_ext.h"
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+void collectIssues(
+  Node& node,
+  const std::vector<const Validator*>& validators,
+  std::vector<const Issue*>& result)
+{
+  result = kdl::vec_concat(std::move(result), node.issues(validators));
+  for (auto* child : node.children())
+  {
+    collectIssues(*child, validators, result);
+  }
+}
+
+/**
+ * Collects the issues of all nodes without using the cache.
+ */
+std::vector<const Issue*> collectAllIssues(Map& map)
+{
+  auto result = std::vector<const Issue*>{};
+  collectIssues(*map.world(), map.world()->registeredValidators(), result);
+
+  return kdl::vec_sort(std::move(result), [](const auto* lhs, const auto* rhs) {
+    return lhs->seqId() > rhs->seqId();
+  });
+}
+
+size_t countIssues(const std::vector<const Issue*>& issues, const Node* node)
+{
+  return size_t(std::ranges::count_if(
+    issues, [&](const auto* issue) { return &issue->node() == node; }));
+}
+
+} // namespace
+
+TEST_CASE("IssueCache")
+{
+  auto fixture = MapFixture{};
+  auto& map = fixture.map();
+  fixture.create();
+
+  auto issueCache = IssueCache{map};
+  REQUIRE(issueCache.issues() == collectAllIssues(map));
+
+  SECTION("Revalidates changed nodes")
+  {
+    auto* entityNode = new EntityNode{Entity{}};
+    addNodes(map, {{parentForNodes(map), {entityNode}}});
+
+    auto issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    const auto issueCount = countIssues(issues, entityNode);
+    CHECK(issueCount > 0);
+
+    selectNodes(map, {entityNode});
+    setEntityProperty(map, "classname", "info_player_start");
+
+    issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, entityNode) < issueCount);
+
+    map.undoCommand();
+
+    issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, entityNode) == issueCount);
+  }
+
+  SECTION("Forgets removed nodes")
+  {
+    auto* entityNode = new EntityNode{Entity{}};
+    addNodes(map, {{parentForNodes(map), {entityNode}}});
+    REQUIRE(countIssues(issueCache.issues(), entityNode) > 0);
+
+    removeNodes(map, {entityNode});
+
+    auto issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, entityNode) == 0);
+
+    map.undoCommand();
+
+    issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, entityNode) > 0);
+  }
+
+  SECTION("Revalidates linked entities")
+  {
+    auto* sourceNode =
+      new EntityNode{Entity{{{"classname", "trigger"}, {"target", "door"}}}};
+    addNodes(map, {{parentForNodes(map), {sourceNode}}});
+
+    auto issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    const auto issueCount = countIssues(issues, sourceNode);
+
+    // the source node is not changed, but its link target is no longer missing
+    auto* targetNode =
+      new EntityNode{Entity{{{"classname", "func_door"}, {"targetname", "door"}}}};
+    addNodes(map, {{parentForNodes(map), {targetNode}}});
+
+    issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, sourceNode) == issueCount - 1);
+
+    selectNodes(map, {targetNode});
+    setEntityProperty(map, "targetname", "other_door");
+
+    issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+    CHECK(countIssues(issues, sourceNode) == issueCount);
+  }
+
+  SECTION("Validates many brushes concurrently")
+  {
+    // enough brushes to be validated in several chunks
+    auto brushNodes = std::vector<Node*>{};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      brushNodes.push_back(createBrushNode(map, "material", [&](auto& brush) {
+        // move the brush off the grid so that it has non integer vertices
+        brush
+          .transform(
+            map.worldBounds(),
+            vm::translation_matrix(
+              vm::vec3d{double(i % 32) * 128.0 + 0.5, double(i / 32) * 128.0, 0}),
+            false)
+          | kdl::transform_error([](const auto&) { FAIL(); });
+      }));
+    }
+    addNodes(map, {{parentForNodes(map), brushNodes}});
+
+    const auto issues = issueCache.issues();
+    CHECK(issues == collectAllIssues(map));
+
+    // the issues are numbered in the order of the nodes, most recent first
+    const auto issueNodes =
+      kdl::vec_transform(issues, [](const auto* issue) { return &issue->node(); });
+    CHECK(std::ranges::equal(
+      issueNodes | std::views::filter([&](const auto* node) {
+        return std::ranges::find(brushNodes, node) != brushNodes.end();
+      }),
+      brushNodes | std::views::reverse));
+  }
+}
+
+} // namespace tb::mdl
@@ -718,6 +718,7 @@ TEST_CASE("updateLinkedGroups")
 
 TEST_CASE("initializeLinkIds")
 {
+  auto taskManager = kdl::task_manager{};
   auto brushBuilder = BrushBuilder{MapFormat::Quake3, vm::bbox3d{8192.0}};
 
   auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
@@ -782,7 +783,7 @@ TEST_CASE("initializeLinkIds")
 
     SECTION("With two groups")
     {
-      CHECK(initializeLinkIds({&worldNode}).empty());
+      CHECK(initializeLinkIds({&worldNode}, taskManager).empty());
 
       CHECK_THAT(
         worldNode,
@@ -817,7 +818,7 @@ TEST_CASE("initializeLinkIds")
       setLinkId(*linkedOuterGroupNode2, "outerGroupLinkId");
       setLinkId(*linkedInnerGroupNode2, "innerGroupLinkId");
 
-      CHECK(initializeLinkIds({&worldNode}).empty());
+      CHECK(initializeLinkIds({&worldNode}, taskManager).empty());
 
       CHECK_THAT(
         worldNode,
@@ -837,7 +838,7 @@ TEST_CASE("initializeLinkIds")
     {
       setLinkId(*linkedInnerGroupNode, "someOtherId");
 
-      CHECK(initializeLinkIds({&worldNode}).empty());
+      CHECK(initializeLinkIds({&worldNode}, taskManager).empty());
 
       CHECK_THAT(
         worldNode,
@@ -884,7 +885,7 @@ TEST_CASE("initializeLinkIds")
           {topLevelLinkedInnerPatchNode},
         }));
 
-      CHECK(initializeLinkIds({&worldNode}).empty());
+      CHECK(initializeLinkIds({&worldNode}, taskManager).empty());
 
       CHECK_THAT(
         worldNode,
@@ -906,7 +907,7 @@ TEST_CASE("initializeLinkIds")
     SECTION("One outer group node has no children")
     {
       CHECK(
-        initializeLinkIds({&worldNode})
+        initializeLinkIds({&worldNode}, taskManager)
         == std::vector{Error{"Inconsistent linked group structure"}});
 
       CHECK_THAT(
@@ -929,7 +930,7 @@ TEST_CASE("initializeLinkIds")
       linkedOuterGroupNode->addChildren({linkedOuterEntityNode, linkedOuterBrushNode});
 
       CHECK(
-        initializeLinkIds({&worldNode})
+        initializeLinkIds({&worldNode}, taskManager)
         == std::vector{Error{"Inconsistent linked group structure"}});
 
       CHECK_THAT(
@@ -956,7 +957,7 @@ TEST_CASE("initializeLinkIds")
       linkedInnerGroupNode->addChildren({linkedInnerPatchNode});
 
       CHECK_THAT(
-        initializeLinkIds({&worldNode}),
+        initializeLinkIds({&worldNode}, taskManager),
         Catch::Matchers::UnorderedEquals(std::vector{
           Error{"Inconsistent linked group structure"},
           Error{"Inconsistent linked group structure"}}));
@@ -987,7 +988,7 @@ TEST_CASE("initializeLinkIds")
         {linkedOuterEntityNode, linkedInnerGroupNode, linkedOuterBrushNode});
 
       CHECK(
-        initializeLinkIds({&worldNode})
+        initializeLinkIds({&worldNode}, taskManager)
         == std::vector{Error{"Inconsistent linked group structure"}});
 
       CHECK_THAT(
@@ -1014,7 +1015,7 @@ TEST_CASE("initializeLinkIds")
         {linkedOuterEntityNode, linkedOuterBrushNode, linkedInnerGroupNode});
 
       CHECK_THAT(
-        initializeLinkIds({&worldNode}),
+        initializeLinkIds({&worldNode}, taskManager),
         Catch::Matchers::UnorderedEquals(std::vector{
           Error{"Inconsistent linked group structure"},
           Error{"Inconsistent linked group structure"}}));
@@ -18,6 +18,7 @@
  */
 
 #include "Exceptions.h"
+#include "Logger.h"
 #include "MapFixture.h"
 #include "MockGame.h"
 #include "TestFactory.h"
@@ -34,6 +35,7 @@
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/Map.h"
+#include "mdl/MapLoader.h"
 #include "mdl/Map_Brushes.h"
 #include "mdl/Map_CopyPaste.h"
 #include "mdl/Map_Entities.h"
@@ -46,6 +48,7 @@
 #include "mdl/PasteType.h"
 #include "mdl/TagMatcher.h"
 #include "mdl/TextureResource.h"
+#include "mdl/Transaction.h"
 #include "mdl/TransactionScope.h"
 #include "mdl/WorldNode.h"
 
@@ -138,6 +141,45 @@ TEST_CASE("Map")
           std::runtime_error);
       }
     }
+
+    SECTION("MapLoader")
+    {
+      fixture.create();
+      auto* originalWorld = map.world();
+
+      auto gameConfig = MockGameConfig{};
+      gameConfig.fileFormats = std::vector<MapFormatConfig>{{"Valve", {}}};
+
+      auto game = std::make_unique<MockGame>();
+      game->config() = gameConfig;
+
+      auto logger = NullLogger{};
+      auto loader = MapLoader{
+        MapFormat::Unknown,
+        vm::bbox3d{8192.0},
+        std::move(game),
+        std::filesystem::current_path()
+          / "fixture/test/ui/MapDocumentTest/valveFormatMapWithoutFormatTag.map",
+        map.taskManager(),
+        logger};
+
+      SECTION("Replaces the world with the loaded world")
+      {
+        REQUIRE(map.load(loader).is_success());
+        CHECK(loader.finished());
+        CHECK(loader.progress() == 1.0);
+        CHECK(map.world() != originalWorld);
+        CHECK(map.world()->mapFormat() == mdl::MapFormat::Valve);
+        CHECK(map.world()->defaultLayer()->childCount() == 1);
+      }
+
+      SECTION("Keeps the current world if loading was cancelled")
+      {
+        loader.cancel();
+        CHECK(map.load(loader).is_error());
+        CHECK(map.world() == originalWorld);
+      }
+    }
   }
 
   SECTION("saveAs")
@@ -192,6 +234,44 @@ TEST_CASE("Map")
         {.mapFormat = MapFormat::Standard, .game = LoadGameFixture{"Quake"}});
       CHECK(map.world()->customLayers().empty());
     }
+
+    SECTION("export region")
+    {
+      const auto newDocumentPath = std::filesystem::path{"test.map"};
+
+      {
+        fixture.create({.game = LoadGameFixture{"Quake"}});
+
+        auto* brushNodeInRegion = createBrushNode(map);
+        auto* brushNodeOutsideRegion = createBrushNode(map);
+        auto* entityNodeInRegion = new EntityNode{Entity{{{"origin", "8 8 8"}}}};
+        auto* entityNodeOutsideRegion = new EntityNode{Entity{{{"origin", "512 0 0"}}}};
+
+        addNodes(
+          map,
+          {{parentForNodes(map),
+            {brushNodeInRegion,
+             brushNodeOutsideRegion,
+             entityNodeInRegion,
+             entityNodeOutsideRegion}}});
+
+        selectNodes(map, {brushNodeOutsideRegion});
+        REQUIRE(translateSelection(map, vm::vec3d{512, 0, 0}));
+
+        auto stream = std::ostringstream{};
+        map.exportRegionTo(stream, brushNodeInRegion->logicalBounds());
+        env.createFile(newDocumentPath, stream.str());
+      }
+
+      fixture.load(
+        env.dir() / newDocumentPath,
+        {.mapFormat = MapFormat::Standard, .game = LoadGameFixture{"Quake"}});
+
+      const auto* defaultLayer = map.world()->defaultLayer();
+      REQUIRE(defaultLayer->childCount() == 2);
+      CHECK(dynamic_cast<const BrushNode*>(defaultLayer->children()[0]));
+      CHECK(dynamic_cast<const EntityNode*>(defaultLayer->children()[1]));
+    }
   }
 
   SECTION("selection")
@@ -1227,6 +1307,63 @@ TEST_CASE("Map")
     }
   }
 
+  SECTION("nodesDidChangeBatchedNotifier")
+  {
+    fixture.create();
+
+    auto* entityNode1 = new EntityNode{Entity{}};
+    auto* entityNode2 = new EntityNode{Entity{}};
+    addNodes(map, {{parentForNodes(map), {entityNode1, entityNode2}}});
+
+    auto notifiedNodes = std::vector<std::vector<Node*>>{};
+    auto connection = map.nodesDidChangeBatchedNotifier.connect(
+      [&](const auto& nodes) { notifiedNodes.push_back(nodes); });
+
+    SECTION("Notifies immediately outside of transactions")
+    {
+      selectNodes(map, {entityNode1});
+      setEntityProperty(map, "key", "value");
+      CHECK(notifiedNodes.size() > 1);
+    }
+
+    SECTION("Notifies once with all changed nodes when a transaction is committed")
+    {
+      auto transaction = Transaction{map};
+
+      selectNodes(map, {entityNode1});
+      setEntityProperty(map, "key", "value");
+      setEntityProperty(map, "other", "value");
+
+      deselectAll(map);
+      selectNodes(map, {entityNode2});
+      setEntityProperty(map, "key", "value");
+      CHECK(notifiedNodes.empty());
+
+      transaction.commit();
+      REQUIRE(notifiedNodes.size() == 1);
+
+      const auto& nodes = notifiedNodes.front();
+      CHECK(nodes == kdl::vec_sort_and_remove_duplicates(nodes));
+      CHECK(kdl::vec_contains(nodes, entityNode1));
+      CHECK(kdl::vec_contains(nodes, entityNode2));
+      CHECK(kdl::vec_contains(nodes, map.world()));
+    }
+
+    SECTION("Omits nodes that were removed during the transaction")
+    {
+      auto transaction = Transaction{map};
+
+      selectNodes(map, {entityNode1});
+      setEntityProperty(map, "key", "value");
+      removeSelectedNodes(map);
+
+      transaction.commit();
+      REQUIRE(notifiedNodes.size() == 1);
+      CHECK(!kdl::vec_contains(notifiedNodes.front(), entityNode1));
+      CHECK(kdl::vec_contains(notifiedNodes.front(), parentForNodes(map)));
+    }
+  }
+
   SECTION("canRepeatCommands")
   {
     fixture.create();
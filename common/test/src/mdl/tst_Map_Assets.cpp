@@ -24,6 +24,8 @@
 #include "mdl/LayerNode.h"
 #include "mdl/Map.h"
 #include "mdl/Map_Assets.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialManager.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/vector_utils.h"
@@ -70,6 +72,35 @@ TEST_CASE("Map_Assets")
     REQUIRE(
       kdl::none_of(faces, [](const auto* face) { return face->material() == nullptr; }));
   }
+
+  SECTION("reloadChangedMaterials")
+  {
+    fixture.load(
+      "fixture/test/ui/MapDocumentTest/reloadMaterialCollectionsQ2.map",
+      {.mapFormat = MapFormat::Quake2, .game = LoadGameFixture{"Quake2"}});
+
+    const auto* brushNode =
+      dynamic_cast<const BrushNode*>(map.world()->defaultLayer()->children().front());
+    REQUIRE(brushNode);
+
+    const auto& face = brushNode->brush().faces().front();
+    const auto* material = face.material();
+    REQUIRE(material);
+
+    const auto* otherMaterial = map.materialManager().material("lavatest");
+    REQUIRE(otherMaterial);
+    REQUIRE(otherMaterial != material);
+
+    const auto textureResourceId = material->textureResource().id();
+    const auto otherTextureResourceId = otherMaterial->textureResource().id();
+
+    map.reloadChangedMaterials({material->relativePath()});
+
+    // the material remains in place, but its texture is reloaded
+    CHECK(face.material() == material);
+    CHECK(material->textureResource().id() != textureResourceId);
+    CHECK(otherMaterial->textureResource().id() == otherTextureResourceId);
+  }
 }
 
 } // namespace tb::mdl
@@ -197,6 +197,57 @@ TEST_CASE("Map_Brushes")
       }
     }
 
+    SECTION("Changing faces of many brushes")
+    {
+      auto brushNodes = std::vector<Node*>{};
+      for (size_t i = 0; i < 32; ++i)
+      {
+        brushNodes.push_back(createBrushNode(map, "original"));
+      }
+      addNodes(map, {{parentForNodes(map), brushNodes}});
+
+      deselectAll(map);
+      selectBrushFaces(
+        map,
+        {{static_cast<BrushNode*>(brushNodes[0]), 0u},
+         {static_cast<BrushNode*>(brushNodes[0]), 1u},
+         {static_cast<BrushNode*>(brushNodes[31]), 2u}});
+
+      auto setMaterial = ChangeBrushFaceAttributesRequest{};
+      setMaterial.setMaterialName("material");
+      setBrushFaceAttributes(map, setMaterial);
+
+      const auto materialName = [&](const size_t brushIndex, const size_t faceIndex) {
+        return static_cast<BrushNode*>(brushNodes[brushIndex])
+          ->brush()
+          .face(faceIndex)
+          .attributes()
+          .materialName();
+      };
+
+      CHECK(materialName(0, 0) == "material");
+      CHECK(materialName(0, 1) == "material");
+      CHECK(materialName(0, 2) == "original");
+      CHECK(materialName(1, 0) == "original");
+      CHECK(materialName(31, 2) == "material");
+
+      deselectAll(map);
+      selectNodes(map, brushNodes);
+      setBrushFaceAttributes(map, setMaterial);
+
+      for (auto* node : brushNodes)
+      {
+        for (const auto& face : static_cast<BrushNode*>(node)->brush().faces())
+        {
+          CHECK(face.attributes().materialName() == "material");
+        }
+      }
+
+      map.undoCommand();
+      CHECK(materialName(0, 2) == "original");
+      CHECK(materialName(31, 2) == "material");
+    }
+
     SECTION("Quake 2 format")
     {
       const int WaterFlag = 32;
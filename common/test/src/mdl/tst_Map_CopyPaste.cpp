@@ -22,9 +22,11 @@
 #include "TestUtils.h"
 #include "mdl/BrushBuilder.h"
 #include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
 #include "mdl/EntityNode.h"
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
 #include "mdl/Map.h"
 #include "mdl/Map_CopyPaste.h"
 #include "mdl/Map_Geometry.h"
@@ -35,6 +37,8 @@
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 
+#include <algorithm>
+
 #include <catch2/catch_test_macros.hpp>
 
 namespace tb::mdl
@@ -584,6 +588,79 @@ common/caulk
       }
     }
   }
+
+  SECTION("paste copied nodes")
+  {
+    auto* brushNode = createBrushNode(map);
+    auto* entityBrushNode = createBrushNode(map);
+    auto* entityNode = new EntityNode{Entity{{{"classname", "func_door"}}}};
+    entityNode->addChild(entityBrushNode);
+    addNodes(map, {{parentForNodes(map), {brushNode, entityNode}}});
+
+    selectNodes(map, {brushNode, entityBrushNode});
+    const auto copiedNodes = copySelectedNodes(map);
+
+    const auto& defaultLayerNode = *map.world()->defaultLayer();
+    REQUIRE(defaultLayerNode.childCount() == 2u);
+
+    SECTION("Copied nodes have the same text form as the selected nodes")
+    {
+      CHECK(
+        serializeCopiedNodes(copiedNodes, map.taskManager())
+        == serializeSelectedNodes(map));
+    }
+
+    SECTION("Paste copied nodes")
+    {
+      deselectAll(map);
+
+      CHECK(paste(map, copiedNodes) == PasteType::Node);
+      CHECK(defaultLayerNode.childCount() == 4u);
+      const auto& pastedBrushNodes = map.selection().brushes;
+      REQUIRE(pastedBrushNodes.size() == 2u);
+
+      const auto isInLayer = [&](const auto* node) {
+        return node->parent() == &defaultLayerNode;
+      };
+      const auto* pastedBrushNode = *std::ranges::find_if(pastedBrushNodes, isInLayer);
+      CHECK(pastedBrushNode->brush() == brushNode->brush());
+      CHECK(pastedBrushNode->linkId() != brushNode->linkId());
+
+      const auto* pastedEntityBrushNode =
+        *std::ranges::find_if_not(pastedBrushNodes, isInLayer);
+      CHECK(pastedEntityBrushNode->brush() == entityBrushNode->brush());
+      CHECK(pastedEntityBrushNode->linkId() != entityBrushNode->linkId());
+
+      const auto* pastedEntityNode =
+        dynamic_cast<const EntityNode*>(pastedEntityBrushNode->parent());
+      REQUIRE(pastedEntityNode != nullptr);
+      CHECK(pastedEntityNode != entityNode);
+      CHECK(pastedEntityNode->entity().classname() == "func_door");
+    }
+
+    SECTION("Paste copied nodes twice")
+    {
+      CHECK(paste(map, copiedNodes) == PasteType::Node);
+      const auto firstBrushNodes = map.selection().brushes;
+
+      CHECK(paste(map, copiedNodes) == PasteType::Node);
+      const auto secondBrushNodes = map.selection().brushes;
+
+      CHECK(defaultLayerNode.childCount() == 6u);
+      REQUIRE(firstBrushNodes.size() == 2u);
+      REQUIRE(secondBrushNodes.size() == 2u);
+      CHECK(firstBrushNodes[0]->linkId() != secondBrushNodes[0]->linkId());
+    }
+
+    SECTION("Paste copied nodes into a map with a different format")
+    {
+      fixture.create({.mapFormat = MapFormat::Valve});
+
+      CHECK(paste(map, copiedNodes) == PasteType::Node);
+      CHECK(map.world()->defaultLayer()->childCount() == 2u);
+      CHECK(map.selection().brushes.size() == 2u);
+    }
+  }
 }
 
 } // namespace tb::mdl
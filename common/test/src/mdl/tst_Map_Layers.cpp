@@ -18,6 +18,8 @@
  */
 
 #include "MapFixture.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "TestFactory.h"
 #include "TestUtils.h"
 #include "mdl/BrushNode.h"
@@ -379,6 +381,39 @@ TEST_CASE("Map_Layers")
       }
     }
   }
+
+  SECTION("loadLayer")
+  {
+    const auto setPref = TemporarilySetPref{Preferences::LoadHiddenLayers, false};
+    fixture.load(
+      "fixture/test/mdl/Map_Layers/hiddenLayer.map",
+      {.mapFormat = MapFormat::Standard});
+
+    const auto customLayers = map.world()->customLayersUserSorted();
+    REQUIRE(customLayers.size() == 2);
+
+    auto* visibleLayerNode = customLayers[0];
+    auto* hiddenLayerNode = customLayers[1];
+    REQUIRE(hiddenLayerNode->hidden());
+
+    CHECK_FALSE(canLoadLayer(visibleLayerNode));
+    CHECK(visibleLayerNode->childCount() == 1);
+
+    REQUIRE(canLoadLayer(hiddenLayerNode));
+    CHECK(!hiddenLayerNode->hasChildren());
+
+    loadLayer(map, hiddenLayerNode);
+
+    CHECK_FALSE(canLoadLayer(hiddenLayerNode));
+    CHECK(hiddenLayerNode->childCount() == 2);
+    CHECK(hiddenLayerNode->layer().unloadedContent() == std::nullopt);
+    CHECK(map.modified());
+
+    map.undoCommand();
+
+    CHECK(canLoadLayer(hiddenLayerNode));
+    CHECK(!hiddenLayerNode->hasChildren());
+  }
 }
 
 } // namespace tb::mdl
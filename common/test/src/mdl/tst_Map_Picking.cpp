@@ -77,6 +77,26 @@ TEST_CASE("Map_Picking")
       CHECK(pickResult.all().empty());
     }
 
+    SECTION("Bounded pick result")
+    {
+      auto* brushNode1 = new BrushNode{
+        builder.createCuboid(vm::bbox3d{{0, 0, 0}, {64, 64, 64}}, "material")
+        | kdl::value()};
+      auto* brushNode2 = new BrushNode{
+        builder.createCuboid(vm::bbox3d{{128, 0, 0}, {192, 64, 64}}, "material")
+        | kdl::value()};
+      addNodes(map, {{parentForNodes(map), {brushNode2, brushNode1}}});
+
+      auto pickResult =
+        PickResult::byDistance(HitFilters::type(BrushNode::BrushHitType), 1);
+      pick(map, vm::ray3d{{-32, 32, 32}, {1, 0, 0}}, pickResult);
+
+      const auto hits = pickResult.all();
+      REQUIRE(hits.size() == 1u);
+      CHECK(hitToNode(hits.front()) == brushNode1);
+      CHECK(hits.front().distance() == vm::approx{32.0});
+    }
+
     SECTION("Single entity")
     {
       auto* entityNode1 = new EntityNode{Entity{}};
@@ -0,0 +1,210 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MapFixture.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Map_Reload.h"
+#include "mdl/Map_Selection.h"
+#include "mdl/Selection.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::string brush(const int x, const std::string& materialName)
+{
+  return fmt::format(
+    R"({{
+( {0} 0 0 ) ( {0} 1 0 ) ( {0} 0 1 ) {1} 0 0 0 1 1
+( {0} 0 0 ) ( {0} 0 1 ) ( {2} 0 0 ) {1} 0 0 0 1 1
+( {0} 0 0 ) ( {2} 0 0 ) ( {0} 1 0 ) {1} 0 0 0 1 1
+( {3} 16 16 ) ( {3} 16 17 ) ( {3} 17 16 ) {1} 0 0 0 1 1
+( {3} 16 16 ) ( {4} 16 16 ) ( {3} 16 17 ) {1} 0 0 0 1 1
+( {3} 16 16 ) ( {3} 17 16 ) ( {4} 16 16 ) {1} 0 0 0 1 1
+}}
+)",
+    x,
+    materialName,
+    x + 1,
+    x + 16,
+    x + 17);
+}
+
+std::string entity(const std::string& properties, const std::string& brushes = "")
+{
+  return fmt::format("{{\n{}\n{}}}\n", properties, brushes);
+}
+
+std::unique_ptr<WorldNode> readWorld(Map& map, const std::string& str)
+{
+  auto status = io::TestParserStatus{};
+  auto reader = io::WorldReader{str, MapFormat::Standard, {}};
+  return reader.read(map.worldBounds(), status, map.taskManager()) | kdl::value();
+}
+
+bool applyChangedNodes(Map& map, const std::string& str)
+{
+  auto worldNode = readWorld(map, str);
+  return mdl::applyChangedNodes(map, *worldNode);
+}
+
+const std::string& materialName(const Node* node)
+{
+  return static_cast<const BrushNode*>(node)->brush().face(0).attributes().materialName();
+}
+
+} // namespace
+
+TEST_CASE("Map_Reload")
+{
+  auto fixture = MapFixture{};
+  auto& map = fixture.map();
+  fixture.create();
+
+  const auto worldspawn = std::string{R"("classname" "worldspawn")"};
+  const auto light = std::string{R"("classname" "light"
+"origin" "0 0 0")"};
+  const auto door = std::string{R"("classname" "func_door")"};
+
+  REQUIRE(applyChangedNodes(
+    map,
+    entity(worldspawn, brush(0, "a") + brush(32, "b")) + entity(light)
+      + entity(door, brush(64, "c") + brush(96, "d"))));
+
+  auto* defaultLayerNode = map.world()->defaultLayer();
+  REQUIRE(defaultLayerNode->childCount() == 4);
+
+  const auto originalNodes = defaultLayerNode->children();
+  auto* brushNodeA = originalNodes[0];
+  auto* brushNodeB = originalNodes[1];
+  auto* lightNode = originalNodes[2];
+  auto* doorNode = originalNodes[3];
+  REQUIRE(doorNode->childCount() == 2);
+  auto* brushNodeC = doorNode->children()[0];
+  auto* brushNodeD = doorNode->children()[1];
+
+  SECTION("Unchanged file")
+  {
+    CHECK_FALSE(applyChangedNodes(
+      map,
+      entity(worldspawn, brush(0, "a") + brush(32, "b")) + entity(light)
+        + entity(door, brush(64, "c") + brush(96, "d"))));
+    CHECK(defaultLayerNode->children() == originalNodes);
+  }
+
+  SECTION("Changed brushes and point entities are updated")
+  {
+    REQUIRE(applyChangedNodes(
+      map,
+      entity(worldspawn, brush(0, "a") + brush(32, "x")) + entity(light + R"(
+"light" "300")")
+        + entity(door, brush(64, "c") + brush(96, "y"))));
+
+    CHECK(defaultLayerNode->children() == originalNodes);
+    CHECK(materialName(brushNodeA) == "a");
+    CHECK(materialName(brushNodeB) == "x");
+    CHECK(static_cast<EntityNode*>(lightNode)->entity().property("light"));
+    CHECK(doorNode->children() == std::vector<Node*>{brushNodeC, brushNodeD});
+    CHECK(materialName(brushNodeD) == "y");
+
+    map.undoCommand();
+    CHECK(materialName(brushNodeB) == "b");
+    CHECK_FALSE(static_cast<EntityNode*>(lightNode)->entity().property("light"));
+    CHECK(materialName(brushNodeD) == "d");
+  }
+
+  SECTION("Nodes are added and removed")
+  {
+    REQUIRE(applyChangedNodes(
+      map,
+      entity(worldspawn, brush(0, "a") + brush(32, "b") + brush(128, "e"))
+        + entity(door, brush(64, "c") + brush(96, "d"))));
+
+    REQUIRE(defaultLayerNode->childCount() == 4);
+    CHECK(defaultLayerNode->children()[0] == brushNodeA);
+    CHECK(defaultLayerNode->children()[1] == brushNodeB);
+    CHECK(defaultLayerNode->children()[2] == doorNode);
+    CHECK(materialName(defaultLayerNode->children()[3]) == "e");
+
+    map.undoCommand();
+    CHECK(defaultLayerNode->childCount() == 4);
+    CHECK(kdl::vec_contains(defaultLayerNode->children(), lightNode));
+  }
+
+  SECTION("Brush entities with changed properties are replaced")
+  {
+    REQUIRE(applyChangedNodes(
+      map,
+      entity(worldspawn, brush(0, "a") + brush(32, "b")) + entity(light)
+        + entity(R"("classname" "func_wall")", brush(64, "c") + brush(96, "d"))));
+
+    REQUIRE(defaultLayerNode->childCount() == 4);
+    CHECK_FALSE(kdl::vec_contains(defaultLayerNode->children(), doorNode));
+  }
+
+  SECTION("Only changed nodes are deselected")
+  {
+    selectNodes(map, {brushNodeA, brushNodeB, lightNode});
+
+    REQUIRE(applyChangedNodes(
+      map,
+      entity(worldspawn, brush(0, "a") + brush(32, "x"))
+        + entity(door, brush(64, "c") + brush(96, "d"))));
+
+    CHECK(map.selection().nodes == std::vector<Node*>{brushNodeA});
+  }
+
+  SECTION("Layers and the world entity are updated")
+  {
+    REQUIRE(applyChangedNodes(
+      map,
+      entity(worldspawn + R"(
+"message" "hello")", brush(0, "a") + brush(32, "b"))
+        + entity(light) + entity(door, brush(64, "c") + brush(96, "d"))
+        + entity(
+          R"("classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Layer 1"
+"_tb_id" "1")",
+          brush(256, "f"))));
+
+    CHECK(defaultLayerNode->children() == originalNodes);
+    CHECK(map.world()->entity().property("message"));
+    REQUIRE(map.world()->customLayers().size() == 1);
+    CHECK(map.world()->customLayers().front()->name() == "Layer 1");
+    CHECK(map.world()->customLayers().front()->childCount() == 1);
+  }
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/MaterialIndex.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto worldBounds = vm::bbox3d{8192.0};
+constexpr auto mapFormat = MapFormat::Quake3;
+
+Brush makeBrush(const std::string& materialName, const std::string& topMaterialName)
+{
+  auto brush =
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, materialName) | kdl::value();
+
+  auto& topFace = brush.face(*brush.findFace(vm::vec3d{0, 0, 1}));
+  auto attributes = topFace.attributes();
+  attributes.setMaterialName(topMaterialName);
+  topFace.setAttributes(attributes);
+
+  return brush;
+}
+
+} // namespace
+
+TEST_CASE("MaterialIndex")
+{
+  auto brushNode1 = BrushNode{makeBrush("some_material", "other_material")};
+  auto brushNode2 = BrushNode{makeBrush("other_material", "other_material")};
+
+  auto index = MaterialIndex{};
+  index.addBrushNode(&brushNode1);
+  index.addBrushNode(&brushNode2);
+
+  SECTION("findBrushNodes")
+  {
+    CHECK_THAT(
+      index.findBrushNodes("some_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{&brushNode1}));
+    CHECK_THAT(
+      index.findBrushNodes("other_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{&brushNode1, &brushNode2}));
+    CHECK(index.findBrushNodes("missing_material").empty());
+  }
+
+  SECTION("Material names are case insensitive")
+  {
+    CHECK_THAT(
+      index.findBrushNodes("SOME_Material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{&brushNode1}));
+    CHECK(index.faceCount("Other_Material") == 7u);
+  }
+
+  SECTION("findBrushFaces")
+  {
+    const auto topFaceIndex = *brushNode1.brush().findFace(vm::vec3d{0, 0, 1});
+    CHECK(index.findBrushFaces("other_material").size() == 7u);
+    CHECK_THAT(
+      index.findBrushFaces("other_material"),
+      Catch::Matchers::VectorContains(BrushFaceHandle{&brushNode1, topFaceIndex}));
+    CHECK(index.findBrushFaces("some_material").size() == 5u);
+  }
+
+  SECTION("removeBrushNode")
+  {
+    index.removeBrushNode(&brushNode1);
+
+    CHECK(index.findBrushNodes("some_material").empty());
+    CHECK(index.faceCount("some_material") == 0u);
+    CHECK_THAT(
+      index.findBrushNodes("other_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{&brushNode2}));
+    CHECK(index.faceCount("other_material") == 6u);
+  }
+}
+
+TEST_CASE("WorldNode.materialIndex")
+{
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  const auto& index = worldNode.materialIndex();
+
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* brushNode1 = new BrushNode{makeBrush("some_material", "other_material")};
+  auto* brushNode2 = new BrushNode{makeBrush("other_material", "other_material")};
+
+  worldNode.defaultLayer()->addChild(brushNode1);
+  entityNode->addChild(brushNode2);
+  worldNode.defaultLayer()->addChild(entityNode);
+
+  CHECK_THAT(
+    index.findBrushNodes("other_material"),
+    Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{brushNode1, brushNode2}));
+
+  SECTION("Updates the index when a brush changes")
+  {
+    brushNode1->setBrush(makeBrush("new_material", "new_material"));
+
+    CHECK(index.findBrushNodes("some_material").empty());
+    CHECK_THAT(
+      index.findBrushNodes("new_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{brushNode1}));
+    CHECK_THAT(
+      index.findBrushNodes("other_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{brushNode2}));
+  }
+
+  SECTION("Updates the index when a brush is removed")
+  {
+    worldNode.defaultLayer()->removeChild(entityNode);
+    delete entityNode;
+
+    CHECK_THAT(
+      index.findBrushNodes("other_material"),
+      Catch::Matchers::UnorderedEquals(std::vector<BrushNode*>{brushNode1}));
+    CHECK(index.faceCount("other_material") == 1u);
+  }
+}
+
+} // namespace tb::mdl
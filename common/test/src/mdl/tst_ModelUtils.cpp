@@ -38,6 +38,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
 
 #include "vm/bbox.h"
 #include "vm/mat_ext.h"
@@ -256,6 +257,50 @@ TEST_CASE("ModelUtils.collectTouchingNodes")
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
 
+TEST_CASE("ModelUtils.collectTouchingNodes.world")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto taskManager = kdl::task_manager{};
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+
+  auto* groupNode = new GroupNode{Group{"outer"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+  auto* distantBrushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+  transformNode(
+    *distantBrushNode, vm::translation_matrix(vm::vec3d{1024, 0, 0}), worldBounds);
+
+  groupNode->addChild(new EntityNode{Entity{}});
+  worldNode.defaultLayer()->addChildren(
+    {groupNode, entityNode, brushNode, distantBrushNode});
+
+  auto touchesAll = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(24.0, "material") | kdl::value()};
+  auto touchesNothing = BrushNode{touchesAll.brush()};
+  transformNode(
+    touchesNothing, vm::translation_matrix(vm::vec3d{256, 0, 0}), worldBounds);
+
+  CHECK_THAT(
+    collectTouchingNodes(worldNode, {&touchesAll}, taskManager),
+    Catch::Matchers::Equals(std::vector<Node*>{groupNode, entityNode, brushNode}));
+
+  CHECK_THAT(
+    collectTouchingNodes(worldNode, {&touchesNothing}, taskManager),
+    Catch::Matchers::Equals(std::vector<Node*>{}));
+
+  CHECK_THAT(
+    collectTouchingNodes(worldNode, {brushNode}, taskManager),
+    Catch::Matchers::Equals(std::vector<Node*>{groupNode, entityNode}));
+
+  CHECK_THAT(
+    collectTouchingNodes(worldNode, {&touchesAll}, taskManager),
+    Catch::Matchers::Equals(collectTouchingNodes({&worldNode}, {&touchesAll})));
+}
+
 TEST_CASE("ModelUtils.collectContainedNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
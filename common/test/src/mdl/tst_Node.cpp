@@ -37,8 +37,10 @@
 
 #include "kdl/overload.h"
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -92,6 +94,12 @@ private:
   mutable std::vector<ExpectedCall> m_expectedCalls;
 
 public:
+  // mock nodes are never passed to visitNodes, so their kind doesn't matter
+  MockNode()
+    : Node{NodeKind::Group}
+  {
+  }
+
   /**
    * Sets an expectation that the given member function will be called. Some of the
    * variant cases include a value to return when that function is called, or checks to
@@ -191,6 +199,12 @@ private: // implement Node interface
 
 class TestNode : public Node
 {
+public:
+  TestNode()
+    : Node{NodeKind::Group}
+  {
+  }
+
 private: // implement Node interface
   Node* doClone(const vm::bbox3d& /* worldBounds */) const override
   {
@@ -794,6 +808,57 @@ TEST_CASE("NodeTest.visitChildren")
   }
 }
 
+TEST_CASE("NodeTest.cloneRecursively")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  auto taskManager = kdl::task_manager{};
+
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "material") | kdl::value()};
+  auto* entityBrushNode =
+    new BrushNode{builder.createCube(32.0, "material") | kdl::value()};
+  auto* entityNode = new EntityNode{Entity{{{"classname", "func_door"}}}};
+  entityNode->addChild(entityBrushNode);
+
+  auto groupNode = GroupNode{Group{"group"}};
+  groupNode.addChildren({brushNode, entityNode});
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+  worldNode.defaultLayer()->addChild(new EntityNode{Entity{}});
+
+  const auto clones =
+    Node::cloneRecursively(worldBounds, {&groupNode, &worldNode}, taskManager);
+  REQUIRE(clones.size() == 2u);
+
+  auto groupClone = std::unique_ptr<Node>{clones[0]};
+  auto worldClone = std::unique_ptr<Node>{clones[1]};
+
+  const auto* groupNodeClone = dynamic_cast<GroupNode*>(groupClone.get());
+  REQUIRE(groupNodeClone != nullptr);
+  CHECK(groupNodeClone->group() == groupNode.group());
+  REQUIRE(groupNodeClone->childCount() == 2u);
+
+  const auto* brushNodeClone = dynamic_cast<BrushNode*>(groupNodeClone->children()[0]);
+  REQUIRE(brushNodeClone != nullptr);
+  CHECK(brushNodeClone != brushNode);
+  CHECK(brushNodeClone->brush() == brushNode->brush());
+
+  const auto* entityNodeClone = dynamic_cast<EntityNode*>(groupNodeClone->children()[1]);
+  REQUIRE(entityNodeClone != nullptr);
+  CHECK(entityNodeClone->entity() == entityNode->entity());
+  REQUIRE(entityNodeClone->childCount() == 1u);
+
+  const auto* entityBrushNodeClone =
+    dynamic_cast<BrushNode*>(entityNodeClone->children().front());
+  REQUIRE(entityBrushNodeClone != nullptr);
+  CHECK(entityBrushNodeClone->brush() == entityBrushNode->brush());
+
+  const auto* worldNodeClone = dynamic_cast<WorldNode*>(worldClone.get());
+  REQUIRE(worldNodeClone != nullptr);
+  CHECK(worldNodeClone->childCount() == 1u);
+  CHECK(worldNodeClone->defaultLayer()->childCount() == 1u);
+}
+
 TEST_CASE("NodeTest.pathFrom")
 {
   auto rootNode = TestNode{};
@@ -31,8 +31,11 @@
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 
+#include "kdl/overload.h"
 #include "kdl/result.h"
 
+#include <utility>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_vector.hpp>
 
@@ -195,6 +198,56 @@ TEST_CASE("NodeQueries")
       Catch::Matchers::UnorderedEquals(
         std::vector<Node*>{outerGroupNode, innerGroupNode}));
   }
+
+  SECTION("visitNodes")
+  {
+    CHECK(worldNode.kind() == NodeKind::World);
+    CHECK(layerNode->kind() == NodeKind::Layer);
+    CHECK(outerGroupNode->kind() == NodeKind::Group);
+    CHECK(entityNode->kind() == NodeKind::Entity);
+    CHECK(brushNode->kind() == NodeKind::Brush);
+    CHECK(patchNode->kind() == NodeKind::Patch);
+
+    auto visited = std::vector<Node*>{};
+    const auto visit = [&](Node* node) { visited.push_back(node); };
+
+    SECTION("Visits nodes of the given types in pre-order")
+    {
+      visitNodes<GroupNode, BrushNode, PatchNode>(worldNode, visit);
+      CHECK(
+        visited
+        == std::vector<Node*>{outerGroupNode, innerGroupNode, brushNode, patchNode});
+    }
+
+    SECTION("Visits the given nodes themselves")
+    {
+      visitNodes<GroupNode, EntityNode>(
+        std::vector<Node*>{entityNode, outerGroupNode}, visit);
+      CHECK(
+        visited
+        == std::vector<Node*>{entityNode, outerGroupNode, innerGroupNode, entityNode});
+    }
+
+    SECTION("Passes nodes with their concrete types")
+    {
+      visitNodes<LayerNode, EntityNode>(
+        worldNode,
+        kdl::overload(
+          [&](LayerNode* node) { visited.push_back(node); },
+          [&](EntityNode* node) { visited.push_back(node); }));
+      CHECK(
+        visited == std::vector<Node*>{worldNode.defaultLayer(), layerNode, entityNode});
+    }
+
+    SECTION("Passes const nodes for const roots")
+    {
+      auto visitedConst = std::vector<const Node*>{};
+      visitNodes<BrushNode>(
+        std::as_const(worldNode),
+        [&](const BrushNode* node) { visitedConst.push_back(node); });
+      CHECK(visitedConst == std::vector<const Node*>{brushNode});
+    }
+  }
 }
 
 TEST_CASE("collectBrushFaces")
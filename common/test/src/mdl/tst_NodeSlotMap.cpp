@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/NodeSlotMap.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace tb::mdl
+{
+
+TEST_CASE("Node.denseId")
+{
+  auto node1 = std::make_unique<EntityNode>(Entity{});
+  auto node2 = std::make_unique<EntityNode>(Entity{});
+  CHECK(node1->denseId() != node2->denseId());
+
+  const auto id = node2->denseId();
+  node2.reset();
+
+  // ids of destroyed nodes are recycled
+  auto node3 = std::make_unique<EntityNode>(Entity{});
+  CHECK(node3->denseId() == id);
+}
+
+TEST_CASE("NodeSlotMap")
+{
+  auto node1 = EntityNode{Entity{}};
+  auto node2 = EntityNode{Entity{}};
+  auto node3 = EntityNode{Entity{}};
+
+  auto map = NodeSlotMap<const EntityNode, int>{};
+  CHECK(map.empty());
+
+  SECTION("try_emplace")
+  {
+    CHECK(map.try_emplace(&node1, 1).second);
+    CHECK(map.try_emplace(&node2, 2).second);
+
+    const auto [it, inserted] = map.try_emplace(&node1, 3);
+    CHECK_FALSE(inserted);
+    CHECK(it->first == &node1);
+    CHECK(it->second == 1);
+
+    CHECK(map.size() == 2);
+    CHECK(map.contains(&node1));
+    CHECK(map.contains(&node2));
+    CHECK_FALSE(map.contains(&node3));
+    CHECK(map.find(&node3) == map.end());
+  }
+
+  SECTION("operator[] and at")
+  {
+    map[&node1] = 1;
+    map[&node2] += 2;
+
+    CHECK(map.at(&node1) == 1);
+    CHECK(map.at(&node2) == 2);
+    CHECK_THROWS_AS(map.at(&node3), std::out_of_range);
+  }
+
+  SECTION("erase")
+  {
+    map.insert({&node1, 1});
+    map.insert({&node2, 2});
+    map.insert({&node3, 3});
+
+    CHECK(map.erase(&node1) == 1u);
+    CHECK(map.erase(&node1) == 0u);
+    CHECK(map.size() == 2);
+    CHECK_FALSE(map.contains(&node1));
+
+    // erasing moves the last entry, which must still be found
+    CHECK(map.at(&node2) == 2);
+    CHECK(map.at(&node3) == 3);
+
+    map.erase(map.find(&node3));
+    CHECK(map.size() == 1);
+    CHECK(map.at(&node2) == 2);
+
+    auto entries = std::vector<std::pair<const EntityNode*, int>>{};
+    for (const auto& [node, value] : map)
+    {
+      entries.emplace_back(node, value);
+    }
+    CHECK(entries == std::vector<std::pair<const EntityNode*, int>>{{&node2, 2}});
+  }
+
+}
+
+TEST_CASE("NodeSlotSet")
+{
+  auto node1 = EntityNode{Entity{}};
+  auto node2 = EntityNode{Entity{}};
+
+  auto set = NodeSlotSet<const EntityNode>{};
+  CHECK(set.insert(&node1).second);
+  CHECK(set.insert(&node2).second);
+  CHECK_FALSE(set.insert(&node1).second);
+
+  CHECK_THAT(
+    std::vector<const EntityNode*>(set.begin(), set.end()),
+    Catch::Matchers::UnorderedEquals(std::vector<const EntityNode*>{&node1, &node2}));
+
+  CHECK(set.erase(&node1) == 1u);
+  CHECK_FALSE(set.contains(&node1));
+  CHECK(set.contains(&node2));
+}
+
+} // namespace tb::mdl
@@ -19,7 +19,9 @@
 
 #include "Result.h"
 #include "io/DiskIO.h"
+#include "io/Reader.h"
 #include "mdl/Palette.h"
+#include "mdl/TextureBuffer.h"
 
 #include "kdl/result.h"
 
@@ -81,6 +83,47 @@ TEST_CASE("makePalette")
   CHECK(makePalette(data, colorFormat) == expectedPalette);
 }
 
+TEST_CASE("Palette.indexedToRgba")
+{
+  // index 0 is red, index 1 is green, index 255 is blue
+  auto rgbData = std::vector<unsigned char>(3 * 256, 0);
+  rgbData[0] = 0xFF;
+  rgbData[4] = 0xFF;
+  rgbData[3 * 255 + 2] = 0xFF;
+
+  const auto palette = makePalette(rgbData, PaletteColorFormat::Rgb) | kdl::value();
+
+  const auto indices = std::vector<char>{0, 1, 1, char(255)};
+  auto reader = io::Reader::from(indices.data(), indices.data() + indices.size());
+
+  using T = std::tuple<PaletteTransparency, bool, unsigned char>;
+  const auto [transparency, expectedHasTransparency, expectedAlpha] =
+    GENERATE(values<T>({
+      {PaletteTransparency::Opaque, false, 0xFF},
+      {PaletteTransparency::Index255Transparent, true, 0x00},
+    }));
+
+  CAPTURE(transparency);
+
+  auto rgbaImage = TextureBuffer{4 * indices.size()};
+  auto averageColor = Color{};
+  CHECK(
+    palette.indexedToRgba(reader, indices.size(), rgbaImage, transparency, averageColor)
+    == expectedHasTransparency);
+  CHECK(reader.position() == indices.size());
+
+  const auto* rgba = rgbaImage.data();
+  CHECK(
+    std::vector<unsigned char>(rgba, rgba + rgbaImage.size())
+    == std::vector<unsigned char>{
+      0xFF, 0x00, 0x00, 0xFF, // red
+      0x00, 0xFF, 0x00, 0xFF, // green
+      0x00, 0xFF, 0x00, 0xFF, // green
+      0x00, 0x00, 0xFF, expectedAlpha, // blue
+    });
+  CHECK(averageColor == Color{0.25f, 0.5f, 0.25f, 1.0f});
+}
+
 TEST_CASE("loadPalette")
 {
   using T = std::tuple<std::string, std::vector<unsigned char>>;
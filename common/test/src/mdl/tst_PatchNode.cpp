@@ -161,6 +161,34 @@ TEST_CASE("PatchNode.makePatchGrid")
     == kdl::vec_transform(expectedPoints, [](const auto& p) { return vm::approx{p}; }));
 }
 
+TEST_CASE("PatchNode.computeGridError")
+{
+  using CP = BezierPatch::Point;
+
+  // clang-format off
+  const auto flatPatch = BezierPatch{3, 3, {
+    CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 0.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0},
+  }, "material"};
+
+  const auto hillPatch = BezierPatch{3, 3, {
+    CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 4.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0},
+  }, "material"};
+  // clang-format on
+
+  CHECK(computeGridError(flatPatch) == 0.0);
+  CHECK(computeGridError(hillPatch) == 4.0);
+
+  const auto patchNode = PatchNode{hillPatch};
+  CHECK(patchNode.gridError(0) == 4.0);
+  CHECK(patchNode.gridError(1) == 1.0);
+  CHECK(patchNode.grid(1) == makePatchGrid(hillPatch, 1));
+  CHECK(patchNode.grid(PatchNode::DefaultSubdivisionsPerSurface) == patchNode.grid());
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
   using P = BezierPatch::Point;
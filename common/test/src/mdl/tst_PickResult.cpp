@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Hit.h"
+#include "mdl/HitFilter.h"
+#include "mdl/PickResult.h"
+
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("PickResult")
+{
+  const auto type1 = HitType::freeType();
+  const auto type2 = HitType::freeType();
+
+  const auto hit = [](const auto type, const double distance, const double error = 0.0) {
+    return Hit{type, distance, vm::vec3d{distance, 0, 0}, distance, error};
+  };
+
+  const auto distances = [](const auto& pickResult) {
+    auto result = std::vector<double>{};
+    for (const auto& h : pickResult.all())
+    {
+      result.push_back(h.distance());
+    }
+    return result;
+  };
+
+  SECTION("Unbounded pick results keep all hits")
+  {
+    auto pickResult = PickResult::byDistance();
+    CHECK_FALSE(pickResult.bounded());
+
+    pickResult.addHit(hit(type1, 3.0));
+    pickResult.addHit(hit(type2, 1.0));
+    pickResult.addHit(hit(type1, 2.0));
+
+    CHECK(distances(pickResult) == std::vector<double>{1.0, 2.0, 3.0});
+    CHECK(pickResult.maxDistance() == std::numeric_limits<double>::infinity());
+  }
+
+  SECTION("Bounded pick results")
+  {
+    auto pickResult = PickResult::byDistance(HitFilters::type(type1), 2);
+    CHECK(pickResult.bounded());
+
+    SECTION("Discard hits that don't match the filter")
+    {
+      pickResult.addHit(hit(type2, 1.0));
+      pickResult.addHit(hit(type1, 2.0));
+
+      CHECK(distances(pickResult) == std::vector<double>{2.0});
+    }
+
+    SECTION("Keep only the closest hits")
+    {
+      pickResult.addHit(hit(type1, 4.0));
+      CHECK(pickResult.maxDistance() == std::numeric_limits<double>::infinity());
+
+      pickResult.addHit(hit(type1, 3.0));
+      CHECK(distances(pickResult) == std::vector<double>{3.0, 4.0});
+      CHECK(pickResult.maxDistance() >= 4.0);
+      CHECK(pickResult.maxDistance() < 4.1);
+
+      pickResult.addHit(hit(type1, 1.0));
+      CHECK(distances(pickResult) == std::vector<double>{1.0, 3.0});
+      CHECK(pickResult.maxDistance() < 3.1);
+
+      pickResult.addHit(hit(type1, 5.0));
+      CHECK(distances(pickResult) == std::vector<double>{1.0, 3.0});
+    }
+
+    SECTION("Keep hits at the same distance as the farthest kept hit")
+    {
+      pickResult.addHit(hit(type1, 1.0));
+      pickResult.addHit(hit(type1, 2.0, 1.0));
+      pickResult.addHit(hit(type1, 2.0, 0.5));
+      pickResult.addHit(hit(type1, 3.0));
+
+      CHECK(distances(pickResult) == std::vector<double>{1.0, 2.0, 2.0});
+    }
+
+    SECTION("Clearing resets the maximum distance")
+    {
+      pickResult.addHit(hit(type1, 1.0));
+      pickResult.addHit(hit(type1, 2.0));
+      pickResult.clear();
+
+      CHECK(pickResult.empty());
+      CHECK(pickResult.maxDistance() == std::numeric_limits<double>::infinity());
+    }
+  }
+
+  SECTION("first")
+  {
+    auto pickResult = PickResult::byDistance(HitFilters::type(type1), 1);
+    pickResult.addHit(hit(type1, 2.0, 1.0));
+    pickResult.addHit(hit(type1, 2.0, 0.5));
+    pickResult.addHit(hit(type1, 1.0, 2.0));
+    pickResult.addHit(hit(type1, 1.0, 0.5));
+
+    const auto& first = pickResult.first(HitFilters::type(type1));
+    CHECK(first.distance() == 1.0);
+    CHECK(first.error() == 0.5);
+  }
+}
+
+} // namespace tb::mdl
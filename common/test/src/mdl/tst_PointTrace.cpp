@@ -21,7 +21,7 @@
 
 #include "vm/vec.h"
 
-#include <sstream>
+#include <string>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -115,8 +115,7 @@ TEST_CASE("loadPointFile")
   }));
   // clang-format on
 
-  auto stream = std::istringstream{file};
-  CHECK(loadPointFile(stream) == expectedTrace);
+  CHECK(loadPointFile(file) == expectedTrace);
 }
 
 } // namespace tb::mdl
@@ -370,6 +370,62 @@ TEST_CASE("Polyhedron")
        {p2, p6, p8, p4}}));
   }
 
+  SECTION("constructCubeFromManyPoints")
+  {
+    // a grid of points on the surface and in the interior of a cube
+    auto points = std::vector<vm::vec3d>{};
+    for (int x = -8; x <= 8; x += 4)
+    {
+      for (int y = -8; y <= 8; y += 4)
+      {
+        for (int z = -8; z <= 8; z += 4)
+        {
+          points.emplace_back(double(x), double(y), double(z));
+        }
+      }
+    }
+
+    const auto p = Polyhedron3d{points};
+
+    CHECK(p.closed());
+    CHECK(p.vertexCount() == 8u);
+    CHECK(p.edgeCount() == 12u);
+    CHECK(p.faceCount() == 6u);
+    CHECK(
+      p
+      == Polyhedron3d{
+        vm::vec3d{-8, -8, -8},
+        vm::vec3d{-8, -8, +8},
+        vm::vec3d{-8, +8, -8},
+        vm::vec3d{-8, +8, +8},
+        vm::vec3d{+8, -8, -8},
+        vm::vec3d{+8, -8, +8},
+        vm::vec3d{+8, +8, -8},
+        vm::vec3d{+8, +8, +8},
+      });
+  }
+
+  SECTION("addPoints")
+  {
+    const auto p1 = vm::vec3d{-8, -8, -8};
+    const auto p2 = vm::vec3d{-8, -8, +8};
+    const auto p3 = vm::vec3d{-8, +8, -8};
+    const auto p4 = vm::vec3d{-8, +8, +8};
+    const auto p5 = vm::vec3d{+8, -8, -8};
+    const auto p6 = vm::vec3d{+8, -8, +8};
+    const auto p7 = vm::vec3d{+8, +8, -8};
+    const auto p8 = vm::vec3d{+8, +8, +8};
+
+    auto p = Polyhedron3d{p1, p2, p3, p4};
+    REQUIRE(p.polygon());
+
+    p.addPoints({p5, p6, p7, p8});
+    CHECK(p == Polyhedron3d{p1, p2, p3, p4, p5, p6, p7, p8});
+
+    p.addPoints({vm::vec3d{0, 0, 0}, p8});
+    CHECK(p == Polyhedron3d{p1, p2, p3, p4, p5, p6, p7, p8});
+  }
+
   SECTION("copy")
   {
     const auto p1 = vm::vec3d{0, 0, 8};
@@ -1385,6 +1441,60 @@ TEST_CASE("Polyhedron")
   }
 }
 
+TEST_CASE("Polyhedron (single precision)")
+{
+  using Polyhedron3f =
+    Polyhedron<float, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
+
+  SECTION("constructCube")
+  {
+    const auto p = Polyhedron3f{vm::bbox3f{{-8, -8, -8}, {8, 8, 8}}};
+
+    CHECK(p.polyhedron());
+    CHECK(p.vertexCount() == 8u);
+    CHECK(p.edgeCount() == 12u);
+    CHECK(p.faceCount() == 6u);
+    CHECK(p.bounds() == vm::bbox3f{{-8, -8, -8}, {8, 8, 8}});
+  }
+
+  SECTION("constructFarFromOrigin")
+  {
+    // the extra point lies on the top face within the float epsilon
+    const auto p = Polyhedron3f{
+      {8000, 8000, 8000},
+      {8064, 8000, 8000},
+      {8000, 8064, 8000},
+      {8064, 8064, 8000},
+      {8000, 8000, 8064},
+      {8064, 8000, 8064},
+      {8000, 8064, 8064},
+      {8064, 8064, 8064},
+      {8032, 8032, 8064.001f},
+    };
+
+    CHECK(p.polyhedron());
+    CHECK(p.faceCount() == 6u);
+  }
+
+  SECTION("clip")
+  {
+    auto p = Polyhedron3f{vm::bbox3f{{-64, -64, -64}, {64, 64, 64}}};
+
+    CHECK(p.clip({vm::vec3f{0, 0, 0}, vm::vec3f{0, 0, 1}}).success());
+    CHECK(p.bounds() == vm::bbox3f{{-64, -64, -64}, {64, 64, 0}});
+    CHECK(p.clip({vm::vec3f{0, 0, 64}, vm::vec3f{0, 0, 1}}).unchanged());
+    CHECK(p.clip({vm::vec3f{0, 0, -64}, vm::vec3f{0, 0, 1}}).empty());
+  }
+
+  SECTION("intersects")
+  {
+    const auto cube = Polyhedron3f{vm::bbox3f{{-1, -1, -1}, {1, 1, 1}}};
+
+    CHECK(cube.intersects(Polyhedron3f{vm::bbox3f{{0, 0, 0}, {2, 2, 2}}}));
+    CHECK_FALSE(cube.intersects(Polyhedron3f{vm::bbox3f{{2, 2, 2}, {3, 3, 3}}}));
+  }
+}
+
 TEST_CASE("Polyhedron (Regression)", "[regression]")
 {
   SECTION("convexHullWithFailingPoints")
@@ -18,80 +18,137 @@
  */
 
 #include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/Reader.h"
 #include "mdl/PortalFile.h"
 
+#include "kdl/task_manager.h"
+
 #include "vm/polygon.h"
 
 #include <filesystem>
+#include <string>
 
 #include <catch2/catch_test_macros.hpp>
 
 namespace tb::mdl
 {
+namespace
+{
+
+Result<std::vector<Portal>> loadFixture(const std::filesystem::path& path)
+{
+  auto taskManager = kdl::task_manager{};
+  return io::Disk::mapFile(path) | kdl::and_then([&](auto file) {
+           auto reader = file->reader().buffer();
+           return loadPortalFile(reader.stringView(), taskManager);
+         });
+}
+
+std::string makePortalFile(const size_t portalCount, const size_t invalidPortal)
+{
+  auto str = "PRT1\n" + std::to_string(portalCount + 1) + "\n"
+             + std::to_string(portalCount) + "\n";
+  for (size_t i = 0; i < portalCount; ++i)
+  {
+    const auto x = std::to_string(i * 16);
+    const auto leaf2 = i != invalidPortal ? std::to_string(i + 1) : std::string{};
+    str += "3 " + std::to_string(i) + " " + leaf2 + " (" + x + " 0 0 ) (" + x
+           + " 16 0 ) (" + x + " 0 16 )\n";
+  }
+  return str;
+}
+
+} // namespace
 
 TEST_CASE("PortalFileTest.parseInvalidPRT1")
 {
   const auto path = "fixture/test/mdl/PortalFile/portaltest_prt1_invalid.prt";
-  CHECK(io::Disk::withInputStream(path, [](auto& stream) {
-          return loadPortalFile(stream);
-        }).is_error());
+  CHECK(loadFixture(path).is_error());
 }
 
-static const std::vector<vm::polygon3f> ExpectedPortals{
-  {{-96, -32, 80}, {-96, 160, 80}, {0, 160, 80}, {0, -32, 80}},
-  {{208, -64, 80}, {64, -64, 80}, {64, 160, 80}, {208, 160, 80}},
-  {{64, 80, 48},
-   {64, 80, 16},
-   {64, 64, 0},
-   {64, 32, 0},
-   {64, 16, 16},
-   {64, 16, 48},
-   {64, 32, 64},
-   {64, 64, 64}},
-  {{0, 80, 48},
-   {0, 80, 16},
-   {0, 64, 0},
-   {0, 32, 0},
-   {0, 16, 16},
-   {0, 16, 48},
-   {0, 32, 64},
-   {0, 64, 64}},
-  {{-64, -32, 0}, {-32, -32, 0}, {-48, -32, 64}}};
+static const std::vector<Portal> ExpectedPortals{
+  {{{-96, -32, 80}, {-96, 160, 80}, {0, 160, 80}, {0, -32, 80}}, 1, 4},
+  {{{208, -64, 80}, {64, -64, 80}, {64, 160, 80}, {208, 160, 80}}, 1, 2},
+  {{{64, 80, 48},
+    {64, 80, 16},
+    {64, 64, 0},
+    {64, 32, 0},
+    {64, 16, 16},
+    {64, 16, 48},
+    {64, 32, 64},
+    {64, 64, 64}},
+   2,
+   3},
+  {{{0, 80, 48},
+    {0, 80, 16},
+    {0, 64, 0},
+    {0, 32, 0},
+    {0, 16, 16},
+    {0, 16, 48},
+    {0, 32, 64},
+    {0, 64, 64}},
+   3,
+   4},
+  {{{-64, -32, 0}, {-32, -32, 0}, {-48, -32, 64}}, 4, 5}};
 
 TEST_CASE("PortalFileTest.parsePRT1")
 {
   const auto path = "fixture/test/mdl/PortalFile/portaltest_prt1.prt";
-  CHECK(
-    (io::Disk::withInputStream(path, [](auto& stream) { return loadPortalFile(stream); })
-     | kdl::value())
-    == ExpectedPortals);
+  CHECK((loadFixture(path) | kdl::value()) == ExpectedPortals);
 }
 
 TEST_CASE("PortalFileTest.parsePRT1Q3")
 {
   const auto path = "fixture/test/mdl/PortalFile/portaltest_prt1q3.prt";
-  CHECK(
-    (io::Disk::withInputStream(path, [](auto& stream) { return loadPortalFile(stream); })
-     | kdl::value())
-    == ExpectedPortals);
+  CHECK((loadFixture(path) | kdl::value()) == ExpectedPortals);
 }
 
 TEST_CASE("PortalFileTest.parsePRT1AM")
 {
   const auto path = "fixture/test/mdl/PortalFile/portaltest_prt1am.prt";
-  CHECK(
-    (io::Disk::withInputStream(path, [](auto& stream) { return loadPortalFile(stream); })
-     | kdl::value())
-    == ExpectedPortals);
+  CHECK((loadFixture(path) | kdl::value()) == ExpectedPortals);
 }
 
 TEST_CASE("PortalFileTest.parsePRT2")
 {
   const auto path = "fixture/test/mdl/PortalFile/portaltest_prt2.prt";
-  CHECK(
-    (io::Disk::withInputStream(path, [](auto& stream) { return loadPortalFile(stream); })
-     | kdl::value())
-    == ExpectedPortals);
+  CHECK((loadFixture(path) | kdl::value()) == ExpectedPortals);
+}
+
+TEST_CASE("PortalFileTest.parseChunks")
+{
+  auto taskManager = kdl::task_manager{};
+  const auto portalCount = size_t(10000);
+
+  SECTION("Portals are returned in file order")
+  {
+    const auto portals =
+      loadPortalFile(makePortalFile(portalCount, portalCount), taskManager)
+      | kdl::value();
+
+    REQUIRE(portals.size() == portalCount);
+    for (size_t i = 0; i < portalCount; ++i)
+    {
+      CHECK(portals[i].leaf1 == i);
+      CHECK(portals[i].leaf2 == i + 1);
+      CHECK(portals[i].polygon.vertices().size() == 3u);
+    }
+    CHECK(portals.back().polygon.vertices().front().x() == float((portalCount - 1) * 16));
+  }
+
+  SECTION("An invalid portal in a later chunk is an error")
+  {
+    CHECK(loadPortalFile(makePortalFile(portalCount, portalCount - 1), taskManager)
+            .is_error());
+  }
+
+  SECTION("Missing portals are an error")
+  {
+    auto str = makePortalFile(portalCount, portalCount);
+    str = str.substr(0, str.rfind('\n', str.size() - 2) + 1);
+    CHECK(loadPortalFile(str, taskManager).is_error());
+  }
 }
 
 } // namespace tb::mdl
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/PortalFile.h"
+#include "mdl/PortalGraph.h"
+
+#include "vm/plane.h"
+#include "vm/polygon.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+bool isVisible(
+  const std::vector<std::vector<vm::plane3d>>& volumes, const vm::vec3d& point)
+{
+  return std::ranges::any_of(volumes, [&](const auto& volume) {
+    return std::ranges::all_of(
+      volume, [&](const auto& plane) { return plane.point_distance(point) <= 0.0; });
+  });
+}
+
+} // namespace
+
+TEST_CASE("PortalGraph")
+{
+  /*
+   * A corridor along the X axis with three leaves that are connected by small openings in
+   * their walls, and a fourth leaf next to the last leaf of the corridor:
+   *
+   *          +-----+
+   *          |  3  |
+   * +---+---+--...-+
+   * | 0 . 1 .  2   |
+   * +---+---+------+
+   * 0  100 200    300
+   */
+  const auto portals = std::vector<Portal>{
+    {vm::polygon3f{{100, 40, 40}, {100, 60, 40}, {100, 60, 60}, {100, 40, 60}}, 0, 1},
+    {vm::polygon3f{{200, 40, 40}, {200, 40, 60}, {200, 60, 60}, {200, 60, 40}}, 1, 2},
+    {vm::polygon3f{{200, 100, 0}, {300, 100, 0}, {300, 100, 100}, {200, 100, 100}}, 2, 3},
+  };
+  const auto graph = PortalGraph{portals};
+
+  const auto inLeaf0 = vm::vec3d{50, 50, 50};
+  const auto inLeaf1 = vm::vec3d{150, 50, 50};
+  const auto inLeaf2 = vm::vec3d{250, 50, 50};
+  const auto inLeaf3 = vm::vec3d{250, 150, 50};
+
+  SECTION("Looking through the corridor")
+  {
+    const auto volumes =
+      graph.visibleVolumes(PortalView{inLeaf0, {1, 0, 0}, {0, -1, 0}, {0, 0, 1}, {}});
+    REQUIRE(volumes != std::nullopt);
+    CHECK(volumes->size() == 3u);
+
+    CHECK(isVisible(*volumes, inLeaf0));
+    CHECK(isVisible(*volumes, inLeaf1));
+    CHECK(isVisible(*volumes, inLeaf2));
+
+    // the opening to leaf 3 cannot be seen through the openings of the corridor
+    CHECK_FALSE(isVisible(*volumes, inLeaf3));
+  }
+
+  SECTION("Looking away from the corridor")
+  {
+    const auto volumes =
+      graph.visibleVolumes(PortalView{inLeaf0, {-1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {}});
+    REQUIRE(volumes != std::nullopt);
+    CHECK(volumes->size() == 1u);
+
+    CHECK(isVisible(*volumes, {25, 50, 50}));
+    CHECK_FALSE(isVisible(*volumes, inLeaf1));
+  }
+
+  SECTION("Looking into the side leaf")
+  {
+    const auto position = vm::vec3d{250, 80, 50};
+    const auto volumes =
+      graph.visibleVolumes(PortalView{position, {0, 1, 0}, {1, 0, 0}, {0, 0, 1}, {}});
+    REQUIRE(volumes != std::nullopt);
+    CHECK(volumes->size() == 2u);
+
+    CHECK(isVisible(*volumes, inLeaf3));
+    CHECK_FALSE(isVisible(*volumes, inLeaf0));
+  }
+
+  SECTION("Empty graph")
+  {
+    CHECK(
+      PortalGraph{{}}.visibleVolumes(PortalView{
+        inLeaf0, {1, 0, 0}, {0, -1, 0}, {0, 0, 1}, {}})
+      == std::nullopt);
+  }
+}
+
+} // namespace tb::mdl
@@ -745,6 +745,92 @@ TEST_CASE("Resource")
       CHECK(resource.needsProcessing());
     }
   }
+
+  SECTION("Lazy loading")
+  {
+    auto resource = ResourceT{
+      [&]() { return Result<MockResource>{MockResource{}}; }, ResourceLoadMode::Lazy};
+
+    CHECK(!resource.isLoadRequested());
+    CHECK(!resource.needsProcessing());
+
+    CHECK(!resource.process(taskRunner, processContext));
+    CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource.state()));
+    CHECK(mockTaskRunner.tasks.empty());
+
+    resource.requestLoading();
+    CHECK(resource.isLoadRequested());
+    CHECK(resource.needsProcessing());
+
+    CHECK(resource.process(taskRunner, processContext));
+    CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource.state()));
+    CHECK(mockTaskRunner.tasks.size() == 1);
+  }
+
+  SECTION("Eviction")
+  {
+    auto mockDropCall = std::optional<bool>{};
+    auto loader = [&]() {
+      return Result<MockResource>{MockResource{
+        [](auto) {},
+        [&](const auto i_glContextAvailable) { mockDropCall = i_glContextAvailable; },
+      }};
+    };
+
+    SECTION("Lazy resources are evicted")
+    {
+      auto resource = ResourceT{loader, ResourceLoadMode::Lazy};
+      resource.requestLoading();
+      setResourceState<ResourceReady<MockResource>>(
+        resource, mockTaskRunner, processContext);
+      REQUIRE(!resource.needsProcessing());
+
+      resource.requestEviction();
+      CHECK(resource.isEvictionRequested());
+      CHECK(!resource.isLoadRequested());
+      CHECK(resource.needsProcessing());
+
+      CHECK(resource.process(taskRunner, processContext));
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource.state()));
+      CHECK(mockDropCall == glContextAvailable);
+      CHECK(!resource.isEvictionRequested());
+      CHECK(!resource.needsProcessing());
+
+      // the resource can be loaded again
+      resource.requestLoading();
+      CHECK(resource.process(taskRunner, processContext));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource.state()));
+    }
+
+    SECTION("Requesting loading cancels eviction")
+    {
+      auto resource = ResourceT{loader, ResourceLoadMode::Lazy};
+      resource.requestLoading();
+      setResourceState<ResourceReady<MockResource>>(
+        resource, mockTaskRunner, processContext);
+
+      resource.requestEviction();
+      resource.requestLoading();
+      CHECK(!resource.isEvictionRequested());
+      CHECK(!resource.needsProcessing());
+
+      CHECK(!resource.process(taskRunner, processContext));
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource.state()));
+      CHECK(mockDropCall == std::nullopt);
+    }
+
+    SECTION("Eager resources are not evicted")
+    {
+      auto resource = ResourceT{loader};
+      setResourceState<ResourceReady<MockResource>>(
+        resource, mockTaskRunner, processContext);
+
+      resource.requestEviction();
+      CHECK(!resource.isEvictionRequested());
+      CHECK(!resource.needsProcessing());
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource.state()));
+    }
+  }
 }
 
 } // namespace tb::mdl
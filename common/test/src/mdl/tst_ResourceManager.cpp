@@ -230,6 +230,89 @@ TEST_CASE("ResourceManager")
       }
     }
 
+    SECTION("maximum number of pending resources")
+    {
+      auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
+      auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
+      auto resource3 = std::make_shared<ResourceT>(mockResourceLoader);
+      resourceManager.addResource(resource1);
+      resourceManager.addResource(resource2);
+      resourceManager.addResource(resource3);
+
+      resourceManager.process(taskRunner, processContext, std::nullopt, 2);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource3->state()));
+
+      mockTaskRunner.resolveNextPromise();
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext, std::nullopt, 2);
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource3->state()));
+
+      resourceManager.process(taskRunner, processContext, std::nullopt, 2);
+      REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource2->state()));
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource3->state()));
+    }
+
+    SECTION("upload timeout")
+    {
+      using namespace std::chrono_literals;
+
+      auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
+      auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
+      resourceManager.addResource(resource1);
+      resourceManager.addResource(resource2);
+
+      resourceManager.process(taskRunner, processContext, 0ms);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource2->state()));
+
+      mockTaskRunner.resolveNextPromise();
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext, 0ms);
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      REQUIRE(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+
+      CHECK(resourceManager.process(taskRunner, processContext, 0ms).empty());
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource2->state()));
+
+      resourceManager.process(taskRunner, processContext);
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceReady<MockResource>>(resource2->state()));
+    }
+
+    SECTION("lazy resources")
+    {
+      auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
+      auto resource2 =
+        std::make_shared<ResourceT>(mockResourceLoader, ResourceLoadMode::Lazy);
+      resourceManager.addResource(resource1);
+      resourceManager.addResource(resource2);
+
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource2->state()));
+
+      mockTaskRunner.resolveNextPromise();
+      resourceManager.process(taskRunner, processContext);
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource2->state()));
+      CHECK(!resourceManager.needsProcessing());
+
+      resource2->requestLoading();
+      CHECK(resourceManager.needsProcessing());
+
+      CHECK(
+        resourceManager.process(taskRunner, processContext)
+        == std::vector{resource2->id()});
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource2->state()));
+    }
+
     SECTION("dropping resources")
     {
       auto mockDropCalls = std::array{std::optional<bool>{}, std::optional<bool>{}};
@@ -31,6 +31,7 @@
 #include "mdl/LayerNode.h"
 #include "mdl/PatchNode.h"
 #include "mdl/Selection.h"
+#include "mdl/SelectionChange.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
@@ -384,6 +385,64 @@ TEST_CASE("Selection")
       }
     }
   }
+
+  SECTION("updateSelection")
+  {
+    SECTION("selecting nodes keeps tree order")
+    {
+      entityNode.select();
+      auto selection = updateSelection(
+        Selection{}, SelectionChange{{&entityNode}, {}, {}, {}}, worldNode);
+      CHECK(selection == computeSelection(worldNode));
+
+      brushNode.select();
+      selection = updateSelection(
+        std::move(selection), SelectionChange{{&brushNode}, {}, {}, {}}, worldNode);
+      CHECK(selection == makeSelection({&brushNode, &entityNode}));
+      CHECK(selection.allEntities() == computeSelection(worldNode).allEntities());
+    }
+
+    SECTION("deselecting nodes")
+    {
+      outerGroupNode.select();
+      entityNode.select();
+      entityBrushNode.select();
+
+      auto selection = computeSelection(worldNode);
+
+      entityNode.deselect();
+      entityBrushNode.deselect();
+      selection = updateSelection(
+        std::move(selection),
+        SelectionChange{{}, {&entityNode, &entityBrushNode}, {}, {}},
+        worldNode);
+      CHECK(selection == makeSelection({&outerGroupNode}));
+      CHECK(selection.allBrushes() == std::vector<BrushNode*>{&brushNode});
+    }
+
+    SECTION("selecting and deselecting faces")
+    {
+      brushNode.selectFace(1);
+      auto selection = updateSelection(
+        Selection{},
+        SelectionChange{{}, {}, {BrushFaceHandle{&brushNode, 1}}, {}},
+        worldNode);
+
+      entityBrushNode.selectFace(0);
+      selection = updateSelection(
+        std::move(selection),
+        SelectionChange{{}, {}, {BrushFaceHandle{&entityBrushNode, 0}}, {}},
+        worldNode);
+      CHECK(selection == computeSelection(worldNode));
+
+      brushNode.deselectFace(1);
+      selection = updateSelection(
+        std::move(selection),
+        SelectionChange{{}, {}, {}, {BrushFaceHandle{&brushNode, 1}}},
+        worldNode);
+      CHECK(selection == makeSelection({BrushFaceHandle{&entityBrushNode, 0}}));
+    }
+  }
 }
 
 } // namespace tb::mdl
@@ -17,15 +17,21 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "mdl/Brush.h"
 #include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Tag.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
 
+#include "vm/mat_ext.h"
+
 #include <catch2/catch_test_macros.hpp>
 
 namespace tb::mdl
@@ -65,4 +71,95 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
 
+TEST_CASE("TaggingTest.updateFaceTags")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"trigger", {}, std::make_unique<MaterialNameTagMatcher>("trigger")},
+  });
+  const auto& tag = tagManager.smartTag("trigger");
+
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  auto brushNode = BrushNode{builder.createCube(64.0, "trigger") | kdl::value()};
+  brushNode.initializeTags(tagManager);
+
+  REQUIRE(brushNode.brush().face(0).hasTag(tag));
+
+  SECTION("Tags are kept when the face is copied")
+  {
+    const auto transform = vm::translation_matrix(vm::vec3d{16, 0, 0});
+    auto brush = brushNode.brush();
+    REQUIRE(brush.transform(worldBounds, transform, false).is_success());
+    brushNode.setBrush(std::move(brush));
+    brushNode.updateTags(tagManager);
+
+    CHECK(brushNode.brush().face(0).hasTag(tag));
+  }
+
+  SECTION("Tags are updated when the material name changes")
+  {
+    auto brush = brushNode.brush();
+    auto& face = brush.face(0);
+    auto attributes = face.attributes();
+    attributes.setMaterialName("wall");
+    face.setAttributes(attributes);
+    brushNode.setBrush(std::move(brush));
+    brushNode.updateTags(tagManager);
+
+    CHECK_FALSE(brushNode.brush().face(0).hasTag(tag));
+    CHECK(brushNode.brush().face(1).hasTag(tag));
+  }
+
+  SECTION("Tags are updated when the tags are cleared")
+  {
+    brushNode.clearTags();
+    CHECK_FALSE(brushNode.brush().face(0).hasTag(tag));
+
+    brushNode.updateTags(tagManager);
+    CHECK(brushNode.brush().face(0).hasTag(tag));
+  }
+}
+
+TEST_CASE("TaggingTest.materialTagCache")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"trigger", {}, std::make_unique<MaterialNameTagMatcher>("trigger")},
+    SmartTag{"detail", {}, std::make_unique<ContentFlagsTagMatcher>(1)},
+  });
+  const auto& triggerTag = tagManager.smartTag("trigger");
+  const auto& detailTag = tagManager.smartTag("detail");
+
+  CHECK(triggerTag.dependsOnlyOnMaterial());
+  CHECK_FALSE(detailTag.dependsOnlyOnMaterial());
+
+  auto builder = BrushBuilder{MapFormat::Quake2, worldBounds};
+  auto brush =
+    builder.createCube(64.0, "trigger", "trigger", "wall", "wall", "trigger", "wall")
+    | kdl::value();
+
+  auto& face = brush.face(0);
+  auto attributes = face.attributes();
+  attributes.setSurfaceContents(1);
+  face.setAttributes(attributes);
+
+  auto brushNode = BrushNode{std::move(brush)};
+
+  tagManager.setMaterialTagCacheEnabled(true);
+  brushNode.initializeTags(tagManager);
+  tagManager.setMaterialTagCacheEnabled(false);
+
+  for (const auto& brushFace : brushNode.brush().faces())
+  {
+    CHECK(
+      brushFace.hasTag(triggerTag)
+      == (brushFace.attributes().materialName() == "trigger"));
+    CHECK(brushFace.hasTag(detailTag) == (brushFace.attributes().surfaceContents() == 1));
+  }
+}
+
 } // namespace tb::mdl
@@ -173,6 +173,49 @@ TEST_CASE("Validation")
     // The fix should have deleted the property
     CHECK(!entityNode->entity().hasProperty(""));
   }
+
+  SECTION("Quick fix for many issues")
+  {
+    auto* entityNode1 = createPointEntity(map, pointEntityDefinition, vm::vec3d{0, 0, 0});
+    auto* entityNode2 = createPointEntity(map, pointEntityDefinition, vm::vec3d{0, 0, 0});
+
+    selectNodes(map, {entityNode1, entityNode2});
+    setEntityProperty(map, "a", "");
+    setEntityProperty(map, "b", "");
+    deselectAll(map);
+    setEntityProperty(map, "a", "");
+
+    auto emptyPropertyValueValidator = std::make_unique<EmptyPropertyValueValidator>();
+    auto validators = std::vector<const Validator*>{emptyPropertyValueValidator.get()};
+
+    auto issues = map.world()->issues(validators);
+    issues = kdl::vec_concat(std::move(issues), entityNode1->issues(validators));
+    issues = kdl::vec_concat(std::move(issues), entityNode2->issues(validators));
+    issues = kdl::vec_filter(std::move(issues), [](const auto* issue) {
+      const auto& key = static_cast<const EntityPropertyIssue*>(issue)->propertyKey();
+      return key == "a" || key == "b";
+    });
+    REQUIRE(issues.size() == 5);
+
+    auto fixes = map.world()->quickFixes(issues.front()->type());
+    REQUIRE(fixes.size() == 1);
+
+    fixes.front()->apply(map, issues);
+
+    CHECK(!map.world()->entity().hasProperty("a"));
+    CHECK(!entityNode1->entity().hasProperty("a"));
+    CHECK(!entityNode1->entity().hasProperty("b"));
+    CHECK(!entityNode2->entity().hasProperty("a"));
+    CHECK(!entityNode2->entity().hasProperty("b"));
+
+    // all issues are fixed by a single command
+    map.undoCommand();
+    CHECK(map.world()->entity().hasProperty("a"));
+    CHECK(entityNode1->entity().hasProperty("a"));
+    CHECK(entityNode1->entity().hasProperty("b"));
+    CHECK(entityNode2->entity().hasProperty("a"));
+    CHECK(entityNode2->entity().hasProperty("b"));
+  }
 }
 
 } // namespace tb::mdl
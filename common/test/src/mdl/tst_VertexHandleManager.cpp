@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/PickResult.h"
+#include "mdl/VertexHandleManager.h"
+#include "render/OrthographicCamera.h"
+#include "render/PerspectiveCamera.h"
+
+#include "vm/vec_io.h" // IWYU pragma: keep
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("VertexHandleManager")
+{
+  auto manager = VertexHandleManager{};
+
+  SECTION("pick")
+  {
+    const auto camera = render::PerspectiveCamera{
+      90.0f,
+      1.0f,
+      8192.0f,
+      render::Camera::Viewport{0, 0, 800, 600},
+      vm::vec3f{0, 0, 0},
+      vm::vec3f{1, 0, 0},
+      vm::vec3f{0, 0, 1}};
+
+    for (const auto x : {-64.0, 64.0, 512.0, 4096.0})
+    {
+      manager.add(vm::vec3d{x, 0, 0});
+      manager.add(vm::vec3d{x, 256, 0});
+    }
+
+    const auto pickRay = vm::ray3d{camera.pickRay(400, 300)};
+
+    auto pickResult = PickResult{};
+    manager.pick(pickRay, camera, pickResult);
+
+    const auto hits = pickResult.all();
+    REQUIRE(hits.size() == 3u);
+    CHECK(hits[0].target<vm::vec3d>() == vm::vec3d{64, 0, 0});
+    CHECK(hits[1].target<vm::vec3d>() == vm::vec3d{512, 0, 0});
+    CHECK(hits[2].target<vm::vec3d>() == vm::vec3d{4096, 0, 0});
+
+    SECTION("removed handles are not picked")
+    {
+      manager.remove(vm::vec3d{512, 0, 0});
+
+      pickResult = PickResult{};
+      manager.pick(pickRay, camera, pickResult);
+      CHECK(pickResult.all().size() == 2u);
+    }
+
+    SECTION("cleared handles are not picked")
+    {
+      manager.clear();
+
+      pickResult = PickResult{};
+      manager.pick(pickRay, camera, pickResult);
+      CHECK(pickResult.all().empty());
+    }
+  }
+
+  SECTION("findHandles")
+  {
+    manager.add(vm::vec3d{0, 0, 0});
+    manager.add(vm::vec3d{1024, 1024, 1024});
+
+    const auto planes = std::vector<vm::plane3d>{
+      {vm::vec3d{32, 0, 0}, vm::vec3d{1, 0, 0}},
+      {vm::vec3d{-32, 0, 0}, vm::vec3d{-1, 0, 0}},
+      {vm::vec3d{0, 32, 0}, vm::vec3d{0, 1, 0}},
+      {vm::vec3d{0, -32, 0}, vm::vec3d{0, -1, 0}},
+    };
+
+    CHECK(manager.findHandles(planes) == std::vector<vm::vec3d>{{0, 0, 0}});
+  }
+
+  SECTION("select")
+  {
+    manager.add(vm::vec3d{0, 0, 0});
+    manager.add(vm::vec3d{1024, 0, 0});
+
+    manager.select(vm::vec3d{0, 0, 0.0000001});
+    CHECK(manager.selectedHandles() == std::vector<vm::vec3d>{{0, 0, 0}});
+  }
+}
+
+} // namespace tb::mdl
@@ -245,6 +245,39 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
       Catch::Matchers::UnorderedEquals(
         std::vector<Node*>{entityNode, brushNode, patchNode}));
   }
+
+  SECTION("Deferred updates are applied once all deferrals have ended")
+  {
+    groupNode->addChildren({entityNode, brushNode, patchNode});
+    worldNode.defaultLayer()->addChild(groupNode);
+
+    worldNode.deferNodeTreeUpdates();
+    worldNode.deferNodeTreeUpdates();
+
+    transformNode(
+      *entityNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+    transformNode(
+      *brushNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+
+    // removing a node discards its deferred update
+    groupNode->removeChild(brushNode);
+
+    worldNode.applyDeferredNodeTreeUpdates();
+    CHECK_THAT(
+      nodeTree.find_containers(vm::vec3d{0, 0, 0}),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{entityNode, patchNode}));
+
+    worldNode.applyDeferredNodeTreeUpdates();
+    CHECK_FALSE(nodeTree.contains(brushNode));
+    CHECK_THAT(
+      nodeTree.find_containers(vm::vec3d{0, 0, 0}),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{patchNode}));
+    CHECK_THAT(
+      nodeTree.find_containers(vm::vec3d{384, 384, 384}),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{entityNode}));
+
+    delete brushNode;
+  }
 }
 
 TEST_CASE("WorldNodeTest.rebuildNodeTree")
@@ -276,6 +276,86 @@ TEST_CASE("AllocationTrackerTest.expandWithUsedSpaceAtEnd")
   }
 }
 
+TEST_CASE("AllocationTrackerTest.allocatedSize")
+{
+  AllocationTracker t(400);
+  CHECK(t.allocatedSize() == 0u);
+
+  auto* block1 = t.allocate(100);
+  auto* block2 = t.allocate(50);
+  CHECK(t.allocatedSize() == 150u);
+
+  t.free(block1);
+  CHECK(t.allocatedSize() == 50u);
+
+  t.free(block2);
+  CHECK(t.allocatedSize() == 0u);
+}
+
+TEST_CASE("AllocationTrackerTest.compact")
+{
+  AllocationTracker t(500);
+
+  AllocationTracker::Block* blocks[5];
+  for (auto*& block : blocks)
+  {
+    block = t.allocate(100);
+  }
+
+  t.free(blocks[0]);
+  t.free(blocks[2]);
+  t.free(blocks[4]);
+
+  SECTION("shrink to fit")
+  {
+    CHECK(
+      t.compact(200)
+      == std::vector<AllocationTracker::Move>{{100, 0, 100}, {300, 100, 100}});
+    CHECK(t.capacity() == 200u);
+    CHECK(t.allocatedSize() == 200u);
+    CHECK(
+      t.usedBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}}));
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{}));
+    CHECK(t.largestPossibleAllocation() == 0u);
+
+    // the blocks remain valid
+    CHECK(blocks[1]->pos == 0u);
+    CHECK(blocks[3]->pos == 100u);
+
+    t.free(blocks[1]);
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}}));
+  }
+
+  SECTION("keep free space at the end")
+  {
+    CHECK(
+      t.compact(300)
+      == std::vector<AllocationTracker::Move>{{100, 0, 100}, {300, 100, 100}});
+    CHECK(t.capacity() == 300u);
+    CHECK(
+      t.usedBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}}));
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{200, 100}}));
+
+    auto* newBlock = t.allocate(100);
+    REQUIRE(newBlock != nullptr);
+    CHECK(newBlock->pos == 200u);
+  }
+
+  SECTION("no allocations")
+  {
+    t.free(blocks[1]);
+    t.free(blocks[3]);
+
+    CHECK(t.compact(0) == std::vector<AllocationTracker::Move>{});
+    CHECK(t.capacity() == 0u);
+    CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{}));
+    CHECK_FALSE(t.hasAllocations());
+
+    t.expand(100);
+    CHECK(t.allocate(100) != nullptr);
+  }
+}
+
 static constexpr size_t NumBrushes = 64'000;
 
 // between 12 and 140, inclusive.
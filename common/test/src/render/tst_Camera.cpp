@@ -19,6 +19,8 @@
 
 #include "render/PerspectiveCamera.h"
 
+#include <algorithm>
+
 #include <catch2/catch_test_macros.hpp>
 
 namespace tb::render
@@ -70,4 +72,37 @@ TEST_CASE("CameraTest.testYawWhenPitchedDown")
   CHECK_FALSE(vm::is_nan(c.up()));
 }
 
+TEST_CASE("CameraTest.viewVolumePlanes")
+{
+  const auto c = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    100.0f,
+    Camera::Viewport{0, 0, 100, 100},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+
+  const auto planes = c.viewVolumePlanes();
+  CHECK(planes.size() == 6u);
+
+  const auto isInside = [&](const vm::vec3f& point) {
+    return std::ranges::all_of(
+      planes, [&](const auto& plane) { return plane.point_distance(point) < 0.0f; });
+  };
+
+  CHECK(isInside(vm::vec3f{10, 0, 0}));
+  CHECK(isInside(vm::vec3f{10, 5, 5}));
+
+  // behind the camera
+  CHECK_FALSE(isInside(vm::vec3f{-10, 0, 0}));
+
+  // beyond the far plane
+  CHECK_FALSE(isInside(vm::vec3f{200, 0, 0}));
+
+  // outside of the field of view
+  CHECK_FALSE(isInside(vm::vec3f{10, 0, 50}));
+  CHECK_FALSE(isInside(vm::vec3f{10, -50, 0}));
+}
+
 } // namespace tb::render
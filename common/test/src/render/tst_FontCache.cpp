@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/Reader.h"
+#include "render/FontCache.h"
+
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+Result<FontAtlas> readCache(const std::string& data, const FontCacheKey& key)
+{
+  return readFontCache(io::Reader::from(data.data(), data.data() + data.size()), key);
+}
+
+} // namespace
+
+TEST_CASE("FontCache")
+{
+  const auto fontData = std::string{"some font file contents"};
+  const auto key = makeFontCacheKey(fontData, 32, ' ', 3);
+  const auto atlas = FontAtlas{
+    24,
+    8,
+    36,
+    32,
+    {16, std::nullopt, 12},
+    2,
+    {'a', 'b', '\0', 'd'},
+  };
+
+  auto stream = std::stringstream{};
+  writeFontCache(stream, key, atlas);
+  const auto data = stream.str();
+
+  SECTION("makeFontCacheKey")
+  {
+    CHECK(key.fontDataSize == fontData.size());
+    const auto otherKey = makeFontCacheKey("other contents", 32, ' ', 3);
+    CHECK(key.fontDataHash != otherKey.fontDataHash);
+    CHECK(key.fontSize == 32);
+    CHECK(key.firstChar == ' ');
+    CHECK(key.charCount == 3);
+  }
+
+  SECTION("fontCachePath")
+  {
+    const auto path = fontCachePath("some/dir", key);
+    CHECK(path.parent_path() == std::filesystem::path{"some/dir"});
+    CHECK(path.extension() == ".tbfont");
+    CHECK(path == fontCachePath("some/dir", key));
+    CHECK(path != fontCachePath("some/dir", makeFontCacheKey(fontData, 16, ' ', 3)));
+  }
+
+  SECTION("Reads a cache written for the same key")
+  {
+    CHECK(readCache(data, key) == atlas);
+  }
+
+  SECTION("Rejects a cache written for a different key")
+  {
+    CHECK(readCache(data, makeFontCacheKey("other contents", 32, ' ', 3)).is_error());
+    CHECK(readCache(data, makeFontCacheKey(fontData, 16, ' ', 3)).is_error());
+  }
+
+  SECTION("Rejects a truncated cache")
+  {
+    CHECK(readCache(data.substr(0, data.size() - 1), key).is_error());
+    CHECK(readCache("", key).is_error());
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/RenderProfiler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+
+TEST_CASE("averageFrameProfile")
+{
+  CHECK(averageFrameProfile({}).cpuPasses.empty());
+
+  const auto frames = std::deque<FrameProfile>{
+    {0, {{"Map", 2.0}}, {{"Faces", 1.0}, {"Edges", 0.5}}, {4, 10, 20, 6, 30, 512}},
+    {1, {{"Map", 4.0}}, {{"Faces", 3.0}, {"Text", 1.0}}, {2, 6, 10, 4, 10, 0}},
+  };
+
+  const auto average = averageFrameProfile(frames);
+  CHECK(average.frameIndex == 1);
+  REQUIRE(average.cpuPasses.size() == 1);
+  CHECK(average.cpuPasses[0].label == "Map");
+  CHECK(average.cpuPasses[0].msecs == 3.0);
+  REQUIRE(average.gpuPasses.size() == 3);
+  CHECK(average.gpuPasses[0].label == "Faces");
+  CHECK(average.gpuPasses[0].msecs == 2.0);
+  CHECK(average.gpuPasses[1].label == "Edges");
+  CHECK(average.gpuPasses[1].msecs == 0.25);
+  CHECK(average.gpuPasses[2].label == "Text");
+  CHECK(average.gpuPasses[2].msecs == 0.5);
+  CHECK(average.stateChanges == StateChangeCounts{3, 8, 15, 5, 20, 256});
+}
+
+TEST_CASE("toCsv")
+{
+  const auto frames = std::deque<FrameProfile>{
+    {7, {{"Map", 2.0}}, {{"Faces", 1.0}}, {1, 2, 3, 4, 5, 64}},
+    {8, {{"Map", 4.5}}, {{"Text", 0.125}}, {5, 6, 7, 8, 9, 0}},
+  };
+
+  CHECK(
+    toCsv(frames)
+    == "Frame,CPU Map (ms),GPU Faces (ms),GPU Text (ms),"
+       "Program changes,Texture binds,Buffer binds,Vertex array binds,Draw calls,"
+       "Uploaded bytes\n"
+       "7,2.000,1.000,0.000,1,2,3,4,5,64\n"
+       "8,4.500,0.000,0.125,5,6,7,8,9,0\n");
+}
+
+TEST_CASE("RenderProfiler")
+{
+  auto profiler = RenderProfiler{2};
+
+  SECTION("Does nothing unless enabled")
+  {
+    profiler.beginFrame();
+    profiler.beginCpuPass("Map");
+    profiler.endCpuPass();
+    profiler.endFrame();
+
+    CHECK(profiler.frames().empty());
+  }
+
+  SECTION("Records CPU passes")
+  {
+    profiler.setEnabled(true);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      profiler.beginFrame();
+      profiler.beginCpuPass("Map");
+      profiler.endCpuPass();
+      profiler.beginCpuPass("Batch");
+      profiler.endCpuPass();
+      profiler.beginCpuPass("Map");
+      profiler.endCpuPass();
+      profiler.endFrame();
+    }
+
+    // only the most recent frames are kept
+    REQUIRE(profiler.frames().size() == 2);
+    CHECK(profiler.frames()[0].frameIndex == 1);
+    CHECK(profiler.frames()[1].frameIndex == 2);
+
+    const auto& frame = profiler.frames().back();
+    REQUIRE(frame.cpuPasses.size() == 2);
+    CHECK(frame.cpuPasses[0].label == "Map");
+    CHECK(frame.cpuPasses[0].msecs >= 0.0);
+    CHECK(frame.cpuPasses[1].label == "Batch");
+    CHECK(frame.gpuPasses.empty());
+
+    profiler.clear();
+    CHECK(profiler.frames().empty());
+  }
+
+  SECTION("Records state changes")
+  {
+    profiler.setEnabled(true);
+
+    currentStateChangeCounts().programChanges = 7;
+
+    profiler.beginFrame();
+    currentStateChangeCounts().programChanges += 2;
+    currentStateChangeCounts().bufferBinds += 3;
+    currentStateChangeCounts().drawCalls += 4;
+    profiler.endFrame();
+
+    REQUIRE(profiler.frames().size() == 1);
+    CHECK(profiler.frames().back().stateChanges == StateChangeCounts{2, 0, 3, 0, 4, 0});
+  }
+}
+
+} // namespace tb::render
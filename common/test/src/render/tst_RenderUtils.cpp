@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/OrthographicCamera.h"
+#include "render/RenderUtils.h"
+
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+float depth(const vm::mat4x4f& projection, const float distance)
+{
+  const auto clip = projection * vm::vec4f{0, 0, -distance, 1};
+  return clip.z() / clip.w();
+}
+
+} // namespace
+
+TEST_CASE("reverseDepthProjection")
+{
+  const auto projection = vm::perspective_matrix(90.0f, 1.0f, 8192.0f, 1024, 768);
+  const auto reversed = reverseDepthProjection(projection);
+
+  CHECK(depth(projection, 1.0f) == vm::approx{-1.0f});
+  CHECK(depth(projection, 8192.0f) == vm::approx{1.0f});
+
+  CHECK(depth(reversed, 1.0f) == vm::approx{1.0f});
+  CHECK(depth(reversed, 8192.0f) == vm::approx{0.0f});
+  CHECK(depth(reversed, 64.0f) > depth(reversed, 128.0f));
+
+  // x, y and w are unchanged
+  const auto point = vm::vec4f{12, -34, -56, 1};
+  const auto expected = projection * point;
+  const auto actual = reversed * point;
+  CHECK(actual.x() == expected.x());
+  CHECK(actual.y() == expected.y());
+  CHECK(actual.w() == expected.w());
+}
+
+TEST_CASE("projectedSize")
+{
+  const auto bounds = vm::bbox3d{{-8, -4, -2}, {8, 4, 2}};
+
+  const auto topCamera = OrthographicCamera{
+    1.0f, 8192.0f, Camera::Viewport{0, 0, 512, 512}, {0, 0, 1024}, {0, 0, -1}, {0, 1, 0}};
+  CHECK(projectedSize(bounds, topCamera) == 16.0);
+
+  const auto sideCamera = OrthographicCamera{
+    1.0f, 8192.0f, Camera::Viewport{0, 0, 512, 512}, {1024, 0, 0}, {-1, 0, 0}, {0, 0, 1}};
+  CHECK(projectedSize(bounds, sideCamera) == 8.0);
+}
+
+} // namespace tb::render
@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/Reader.h"
+#include "render/ShaderCache.h"
+#include "render/ShaderProgram.h"
+
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+Result<ShaderProgramBinary> readCache(
+  const std::string& data, const std::string& driver, const std::string& sources)
+{
+  return readShaderCache(
+    io::Reader::from(data.data(), data.data() + data.size()), driver, sources);
+}
+
+} // namespace
+
+TEST_CASE("ShaderCache")
+{
+  const auto driver = std::string{"Vendor Renderer 4.6"};
+  const auto sources = std::string{"void main() { gl_FragColor = vec4(1.0); }"};
+  const auto binary = ShaderProgramBinary{0x1234, {'a', 'b', 'c', '\0', 'd'}};
+
+  auto stream = std::stringstream{};
+  writeShaderCache(stream, driver, sources, binary);
+  const auto data = stream.str();
+
+  SECTION("shaderCachePath")
+  {
+    CHECK(
+      shaderCachePath("some/dir", "Program")
+      == std::filesystem::path{"some/dir/Program.tbshader"});
+  }
+
+  SECTION("Reads a cache written by the same driver from the same sources")
+  {
+    CHECK(readCache(data, driver, sources) == binary);
+  }
+
+  SECTION("Rejects a cache written by a different driver")
+  {
+    CHECK(readCache(data, "Vendor Renderer 4.5", sources).is_error());
+  }
+
+  SECTION("Rejects a cache written from different sources")
+  {
+    CHECK(readCache(data, driver, sources + " ").is_error());
+  }
+
+  SECTION("Rejects a truncated cache")
+  {
+    CHECK(readCache(data.substr(0, data.size() - 1), driver, sources).is_error());
+    CHECK(readCache("", driver, sources).is_error());
+  }
+}
+
+} // namespace tb::render
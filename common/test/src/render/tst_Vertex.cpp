@@ -37,6 +37,13 @@ struct TestVertex
   vm::vec4f color;
 };
 
+struct TestPackedNormalVertex
+{
+  vm::vec3f pos;
+  vm::vec<GLbyte, 4> normal;
+  vm::vec2f uv;
+};
+
 } // namespace
 
 TEST_CASE("VertexTest.memoryLayoutSingleVertex")
@@ -77,4 +84,30 @@ TEST_CASE("VertexTest.memoryLayoutVertexList")
   REQUIRE(std::memcmp(expected.data(), actual.data(), sizeof(TestVertex) * 3) == 0);
 }
 
+TEST_CASE("VertexTest.memoryLayoutPackedNormal")
+{
+  using Vertex = GLVertexTypes::P3NBT2::Vertex;
+
+  const auto pos = vm::vec3f(1.0f, 2.0f, 3.0f);
+  const auto normal = GLVertexAttributeTypes::NB::pack(vm::vec3f{0.0f, 0.0f, 1.0f});
+  const auto uv = vm::vec2f(4.0f, 5.0f);
+
+  const auto expected = TestPackedNormalVertex{pos, normal, uv};
+  const auto actual = Vertex(pos, normal, uv);
+
+  REQUIRE(sizeof(Vertex) == sizeof(TestPackedNormalVertex));
+  REQUIRE(sizeof(Vertex) == 24);
+  REQUIRE(std::memcmp(&expected, &actual, sizeof(expected)) == 0);
+}
+
+TEST_CASE("VertexTest.packNormal")
+{
+  using NB = GLVertexAttributeTypes::NB;
+
+  CHECK(NB::pack(vm::vec3f{0, 0, 1}) == vm::vec<GLbyte, 4>{0, 0, 127, 0});
+  CHECK(NB::pack(vm::vec3f{-1, 0, 0}) == vm::vec<GLbyte, 4>{-127, 0, 0, 0});
+  CHECK(
+    NB::pack(vm::normalize(vm::vec3f{1, 1, 0})) == vm::vec<GLbyte, 4>{90, 90, 0, 0});
+}
+
 } // namespace tb::render
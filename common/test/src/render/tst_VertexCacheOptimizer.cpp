@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/VertexCacheOptimizer.h"
+
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+using Triangle = std::array<GLuint, 3>;
+
+std::vector<Triangle> canonicalTriangles(const std::vector<GLuint>& indices)
+{
+  auto result = std::vector<Triangle>{};
+  for (size_t i = 0; i < indices.size(); i += 3)
+  {
+    // rotate the smallest index to the front, which preserves the winding
+    auto triangle = Triangle{indices[i], indices[i + 1], indices[i + 2]};
+    std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+    result.push_back(triangle);
+  }
+  return kdl::vec_sort(std::move(result));
+}
+
+size_t countCacheMisses(const std::vector<GLuint>& indices, const size_t cacheSize)
+{
+  // simulates a FIFO vertex cache
+  auto cache = std::deque<GLuint>{};
+  auto misses = size_t(0);
+  for (const auto index : indices)
+  {
+    if (std::ranges::find(cache, index) == cache.end())
+    {
+      ++misses;
+      cache.push_back(index);
+      if (cache.size() > cacheSize)
+      {
+        cache.pop_front();
+      }
+    }
+  }
+  return misses;
+}
+
+std::vector<GLuint> makeGrid(const GLuint baseIndex, const GLuint size)
+{
+  auto result = std::vector<GLuint>{};
+  for (GLuint row = 0; row < size; ++row)
+  {
+    for (GLuint col = 0; col < size; ++col)
+    {
+      const auto i0 = baseIndex + row * (size + 1) + col;
+      const auto i1 = i0 + 1;
+      const auto i2 = i1 + size + 1;
+      const auto i3 = i0 + size + 1;
+      result.insert(result.end(), {i0, i1, i2, i2, i3, i0});
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("optimizeVertexCache")
+{
+  SECTION("Empty and single triangle")
+  {
+    CHECK(optimizeVertexCache({}) == std::vector<GLuint>{});
+    CHECK(optimizeVertexCache({3, 4, 5}) == std::vector<GLuint>{3, 4, 5});
+  }
+
+  SECTION("Keeps the triangles and their winding")
+  {
+    const auto indices = makeGrid(100, 16);
+    const auto optimized = optimizeVertexCache(indices);
+
+    CHECK(optimized.size() == indices.size());
+    CHECK(canonicalTriangles(optimized) == canonicalTriangles(indices));
+  }
+
+  SECTION("Keeps degenerate triangles")
+  {
+    const auto indices = std::vector<GLuint>{0, 1, 2, 2, 2, 3, 1, 2, 3};
+    CHECK(
+      canonicalTriangles(optimizeVertexCache(indices)) == canonicalTriangles(indices));
+  }
+
+  SECTION("Reduces cache misses")
+  {
+    // a row major grid whose rows are longer than the cache
+    const auto indices = makeGrid(0, 64);
+    const auto optimized = optimizeVertexCache(indices);
+
+    CHECK(countCacheMisses(optimized, 16) < countCacheMisses(indices, 16));
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogQueue.h"
+#include "Logger.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace tb
+{
+namespace
+{
+
+auto takeMessages(LogQueue& queue)
+{
+  auto result = std::vector<std::tuple<LogLevel, std::string>>{};
+  for (auto& message : queue.takeMessages())
+  {
+    result.emplace_back(message.level, std::move(message.str));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("LogQueue")
+{
+  using T = std::vector<std::tuple<LogLevel, std::string>>;
+
+  auto queue = LogQueue{};
+
+  SECTION("Returns messages in order")
+  {
+    CHECK(queue.empty());
+
+    queue.push(LogLevel::Info, "a");
+    queue.push(LogLevel::Warn, "b");
+    queue.push(LogLevel::Info, "c");
+
+    CHECK_FALSE(queue.empty());
+    CHECK(
+      takeMessages(queue)
+      == T{
+        {LogLevel::Info, "a"},
+        {LogLevel::Warn, "b"},
+        {LogLevel::Info, "c"},
+      });
+
+    CHECK(queue.empty());
+    CHECK(takeMessages(queue) == T{});
+  }
+
+  SECTION("Waiting returns false once the queue is closed and empty")
+  {
+    queue.push(LogLevel::Info, "a");
+    queue.close();
+
+    CHECK(queue.waitForMessages());
+    CHECK(takeMessages(queue) == T{{LogLevel::Info, "a"}});
+    CHECK_FALSE(queue.waitForMessages());
+  }
+
+  SECTION("Messages from multiple threads are delivered to a waiting consumer")
+  {
+    constexpr auto ThreadCount = 4;
+    constexpr auto MessageCount = 1000;
+
+    auto received = std::vector<std::vector<int>>(ThreadCount);
+    auto consumer = std::thread{[&]() {
+      while (queue.waitForMessages())
+      {
+        for (const auto& message : queue.takeMessages())
+        {
+          const auto separator = message.str.find(':');
+          const auto thread = std::stoi(message.str.substr(0, separator));
+          const auto index = std::stoi(message.str.substr(separator + 1));
+          received[size_t(thread)].push_back(index);
+        }
+      }
+    }};
+
+    auto producers = std::vector<std::thread>{};
+    for (int thread = 0; thread < ThreadCount; ++thread)
+    {
+      producers.emplace_back([&, thread]() {
+        for (int index = 0; index < MessageCount; ++index)
+        {
+          queue.push(
+            LogLevel::Info, std::to_string(thread) + ":" + std::to_string(index));
+        }
+      });
+    }
+
+    for (auto& producer : producers)
+    {
+      producer.join();
+    }
+    queue.close();
+    consumer.join();
+
+    auto expected = std::vector<int>{};
+    for (int index = 0; index < MessageCount; ++index)
+    {
+      expected.push_back(index);
+    }
+
+    for (const auto& messages : received)
+    {
+      CHECK(messages == expected);
+    }
+  }
+}
+
+} // namespace tb
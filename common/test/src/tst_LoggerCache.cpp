@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "LoggerCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tb::ui
+{
+namespace
+{
+
+auto getMessages(LoggerCache& cache)
+{
+  auto result = std::vector<std::tuple<LogLevel, std::string>>{};
+  cache.getCachedMessages([&](const auto level, const auto& message) {
+    result.emplace_back(level, message);
+  });
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("LoggerCache")
+{
+  using T = std::vector<std::tuple<LogLevel, std::string>>;
+
+  SECTION("Returns messages in order")
+  {
+    auto cache = LoggerCache{};
+    cache.cacheMessage(LogLevel::Info, "a");
+    cache.cacheMessage(LogLevel::Warn, "b");
+    cache.cacheMessage(LogLevel::Info, "a");
+
+    CHECK(
+      getMessages(cache)
+      == T{
+        {LogLevel::Info, "a"},
+        {LogLevel::Warn, "b"},
+        {LogLevel::Info, "a"},
+      });
+    CHECK(getMessages(cache).empty());
+  }
+
+  SECTION("Collapses repeated messages")
+  {
+    auto cache = LoggerCache{};
+    cache.cacheMessage(LogLevel::Warn, "a");
+    cache.cacheMessage(LogLevel::Warn, "a");
+    cache.cacheMessage(LogLevel::Warn, "a");
+    cache.cacheMessage(LogLevel::Error, "a");
+
+    CHECK(
+      getMessages(cache)
+      == T{
+        {LogLevel::Warn, "a (repeated 3 times)"},
+        {LogLevel::Error, "a"},
+      });
+  }
+
+  SECTION("Discards the oldest messages")
+  {
+    auto cache = LoggerCache{2};
+    cache.cacheMessage(LogLevel::Info, "a");
+    cache.cacheMessage(LogLevel::Info, "a");
+    cache.cacheMessage(LogLevel::Info, "b");
+    cache.cacheMessage(LogLevel::Info, "c");
+    cache.cacheMessage(LogLevel::Info, "d");
+
+    CHECK(
+      getMessages(cache)
+      == T{
+        {LogLevel::Warn, "3 earlier log messages were discarded"},
+        {LogLevel::Info, "c"},
+        {LogLevel::Info, "d"},
+      });
+  }
+}
+
+} // namespace tb::ui
@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MemoryReport.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb
+{
+
+TEST_CASE("MemoryReport")
+{
+  auto report = MemoryReport{};
+  CHECK(report.entries().empty());
+  CHECK(toJson(report) == "[]\n");
+
+  report.add("Nodes", 1024, 4);
+  report.add("Textures", 512, 1);
+  report.add("Nodes", 2048, 8);
+
+  CHECK(
+    report.entries()
+    == std::vector<MemoryReportEntry>{
+      {"Nodes", 3072, 12},
+      {"Textures", 512, 1},
+    });
+
+  CHECK(
+    toString(report)
+    == "Nodes        3.0 KiB        12\n"
+       "Textures       512 B         1\n");
+
+  report.add(R"(Models "quoted")", 4 * 1024 * 1024, 2);
+
+  CHECK(
+    toJson(report)
+    == R"([
+  {"name": "Nodes", "bytes": 3072, "count": 12},
+  {"name": "Textures", "bytes": 512, "count": 1},
+  {"name": "Models \"quoted\"", "bytes": 4194304, "count": 2}
+]
+)");
+}
+
+} // namespace tb
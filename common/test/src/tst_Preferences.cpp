@@ -304,4 +304,28 @@ TEST_CASE("Preferences")
   }
 }
 
+TEST_CASE("CachedPref")
+{
+  auto preference = Preference<int>{"CachedPref/test", 1};
+  auto cachedPref = CachedPref{preference};
+
+  CHECK(cachedPref() == 1);
+
+  const auto generation = PreferenceManager::generation();
+
+  SECTION("Setting a preference to its current value keeps the generation")
+  {
+    PreferenceManager::instance().set(preference, 1);
+    CHECK(PreferenceManager::generation() == generation);
+    CHECK(cachedPref() == 1);
+  }
+
+  SECTION("Setting a preference updates the cached value")
+  {
+    PreferenceManager::instance().set(preference, 2);
+    CHECK(PreferenceManager::generation() != generation);
+    CHECK(cachedPref() == 2);
+  }
+}
+
 } // namespace tb
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb
+{
+
+TEST_CASE("Tracer")
+{
+  auto tracer = Tracer{2};
+
+  SECTION("Records scopes")
+  {
+    {
+      const auto scope = TraceScope{"outer", tracer};
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    const auto events = tracer.events();
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].name == "outer");
+    CHECK(events[0].startMicros >= 0);
+    CHECK(events[0].durationMicros >= 1000);
+  }
+
+  SECTION("Records the calling thread")
+  {
+    {
+      const auto scope = TraceScope{"main", tracer};
+    }
+    std::thread{[&]() { const auto scope = TraceScope{"worker", tracer}; }}.join();
+
+    const auto events = tracer.events();
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].threadId != events[1].threadId);
+  }
+
+  SECTION("Drops events beyond the maximum count")
+  {
+    const auto now = Tracer::Clock::now();
+    tracer.record("a", now, now);
+    tracer.record("b", now, now);
+    tracer.record("c", now, now);
+
+    CHECK(tracer.events().size() == 2);
+
+    tracer.clear();
+    CHECK(tracer.events().empty());
+  }
+}
+
+TEST_CASE("toChromeTraceJson")
+{
+  CHECK(toChromeTraceJson({}) == R"({"traceEvents":[
+],"displayTimeUnit":"ms"}
+)");
+
+  CHECK(
+    toChromeTraceJson({
+      {"a", 1, 10, 5},
+      {R"(b "quoted")", 2, 20, 0},
+    })
+    == R"({"traceEvents":[
+{"name":"a","ph":"X","pid":1,"tid":1,"ts":10,"dur":5},
+{"name":"b \"quoted\"","ph":"X","pid":1,"tid":2,"ts":20,"dur":0}
+],"displayTimeUnit":"ms"}
+)");
+}
+
+} // namespace tb
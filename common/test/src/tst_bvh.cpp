@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bvh.h"
+
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/intersection.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb
+{
+namespace
+{
+
+using bvh_type = bvh<float, size_t>;
+
+std::optional<float> find_closest_brute_force(
+  const std::vector<vm::bbox3f>& boxes, const vm::ray3f& ray)
+{
+  auto closest = std::optional<float>{};
+  for (const auto& box : boxes)
+  {
+    closest = vm::safe_min(closest, vm::intersect_ray_bbox(ray, box));
+  }
+  return closest;
+}
+
+bvh_type make_bvh(const std::vector<vm::bbox3f>& boxes)
+{
+  auto values = std::vector<std::pair<vm::bbox3f, size_t>>{};
+  for (size_t i = 0; i < boxes.size(); ++i)
+  {
+    values.emplace_back(boxes[i], i);
+  }
+  return bvh_type{std::move(values)};
+}
+
+} // namespace
+
+TEST_CASE("bvh")
+{
+  SECTION("empty")
+  {
+    const auto tree = bvh_type{};
+    CHECK(tree.empty());
+    CHECK(
+      tree.find_closest(
+        vm::ray3f{{0, 0, 0}, {1, 0, 0}}, [](const auto) { return std::optional{1.0f}; })
+      == std::nullopt);
+  }
+
+  SECTION("find_closest")
+  {
+    auto rng = std::mt19937{42};
+    auto position = std::uniform_real_distribution<float>{-256.0f, 256.0f};
+    auto extent = std::uniform_real_distribution<float>{0.5f, 16.0f};
+
+    auto boxes = std::vector<vm::bbox3f>{};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      const auto min = vm::vec3f{position(rng), position(rng), position(rng)};
+      boxes.emplace_back(min, min + vm::vec3f{extent(rng), extent(rng), extent(rng)});
+    }
+
+    // large and coinciding boxes
+    boxes.emplace_back(vm::vec3f{-512, -4, -4}, vm::vec3f{512, 4, 4});
+    for (size_t i = 0; i < 20; ++i)
+    {
+      boxes.emplace_back(vm::vec3f{300, 300, 300}, vm::vec3f{301, 301, 301});
+    }
+
+    const auto tree = make_bvh(boxes);
+    REQUIRE(tree.size() == boxes.size());
+
+    auto direction = std::uniform_real_distribution<float>{-1.0f, 1.0f};
+    for (size_t i = 0; i < 500; ++i)
+    {
+      const auto origin = vm::vec3f{position(rng), position(rng), position(rng)} * 2.0f;
+      const auto ray = vm::ray3f{
+        origin, vm::normalize(vm::vec3f{direction(rng), direction(rng), direction(rng)})};
+
+      const auto expected = find_closest_brute_force(boxes, ray);
+      const auto actual = tree.find_closest(
+        ray, [&](const size_t j) { return vm::intersect_ray_bbox(ray, boxes[j]); });
+
+      REQUIRE(actual.has_value() == expected.has_value());
+      if (expected)
+      {
+        CHECK(*actual == vm::approx{*expected});
+      }
+    }
+
+    // axis aligned rays
+    const auto ray = vm::ray3f{{400, 300.5f, 300.5f}, {-1, 0, 0}};
+    CHECK(
+      tree.find_closest(
+        ray, [&](const size_t j) { return vm::intersect_ray_bbox(ray, boxes[j]); })
+      == find_closest_brute_force(boxes, ray));
+  }
+}
+
+} // namespace tb
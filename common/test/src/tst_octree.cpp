@@ -130,6 +130,16 @@ TEST_CASE("node_address")
     CHECK(get_parent({-2, 0, -2, 1}) == node_address{-4, 0, -4, 2});
   }
 
+  SECTION("get_ancestor")
+  {
+    CHECK(get_ancestor({1, 2, 3, 0}, 0) == node_address{1, 2, 3, 0});
+    CHECK(get_ancestor({1, 2, 3, 0}, 2) == node_address{0, 0, 0, 2});
+    CHECK(get_ancestor({4, 4, 4, 2}, 2) == node_address{4, 4, 4, 2});
+    CHECK(get_ancestor({4, 4, 4, 2}, 3) == node_address{0, 0, 0, 3});
+    CHECK(get_ancestor({-1, -1, -1, 0}, 1) == node_address{-2, -2, -2, 1});
+    CHECK(get_ancestor({-4, 2, -2, 1}, 3) == node_address{-8, 0, -8, 3});
+  }
+
   SECTION("get_quadrant")
   {
     CHECK(get_quadrant({-4, -4, -4, 3}, {-1, -1, -1, 1}) == std::nullopt);
@@ -212,6 +222,21 @@ TEST_CASE("node_address")
     CHECK(get_root({-3, 9, 0, 0}) == node_address{-16, -16, -16, 5});
   }
 
+  SECTION("get_morton_code")
+  {
+    CHECK(get_morton_code({0, 0, 0, 0}) == uint64_t(7) << 45);
+    CHECK(get_morton_code({1, 0, 0, 0}) == (uint64_t(7) << 45 | 1));
+    CHECK(get_morton_code({0, 1, 0, 0}) == (uint64_t(7) << 45 | 2));
+    CHECK(get_morton_code({0, 0, 1, 0}) == (uint64_t(7) << 45 | 4));
+    CHECK(get_morton_code({2, 0, 0, 1}) == (uint64_t(7) << 45 | 8));
+
+    // sorting by Morton code groups addresses by quadrant
+    CHECK(get_morton_code({-1, 0, 0, 0}) < get_morton_code({0, 0, 0, 0}));
+    CHECK(get_morton_code({0, -1, 0, 0}) > get_morton_code({0, 0, -1, 0}));
+    CHECK(get_morton_code({1, 1, 1, 0}) < get_morton_code({2, 0, 0, 0}));
+    CHECK(get_morton_code({-4, -4, -4, 2}) < get_morton_code({-1, -1, -1, 0}));
+  }
+
   SECTION("get_container")
   {
     CHECK(get_container({{2, 2, 2}, {6, 6, 6}}, 32.0) == node_address{0, 0, 0, 0});
@@ -552,6 +577,70 @@ TEST_CASE("octree.insert_duplicate")
   CHECK_FALSE(tree.empty());
 }
 
+TEST_CASE("octree.build")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("building an empty tree")
+  {
+    tree.insert(vm::bbox3d{{0, 0, 0}, {2, 1, 1}}, 1);
+    tree.build({});
+
+    CHECK(tree == octree<double, int>{32.0});
+  }
+
+  SECTION("building a tree with root nodes only")
+  {
+    tree.build({
+      {vm::bbox3d{{-2, 0, 0}, {5, 3, 6}}, 1},
+      {vm::bbox3d{{-33, -32, -32}, {32, 32, 32}}, 2},
+    });
+
+    // the data in a node is ordered by Morton code
+    CHECK(tree == octree<double, int>{32.0, leaf_node{{-2, -2, -2, 2}, {2, 1}}});
+  }
+
+  SECTION("building a tree with nested nodes")
+  {
+    tree.build({
+      {vm::bbox3d{{1, 1, 1}, {2, 2, 2}}, 1},
+      {vm::bbox3d{{3, 3, 3}, {4, 4, 4}}, 2},
+      {vm::bbox3d{{16, 16, 16}, {48, 48, 48}}, 3},
+    });
+
+    auto expected = octree<double, int>{32.0};
+    expected.insert(vm::bbox3d{{16, 16, 16}, {48, 48, 48}}, 3);
+    expected.insert(vm::bbox3d{{1, 1, 1}, {2, 2, 2}}, 1);
+    expected.insert(vm::bbox3d{{3, 3, 3}, {4, 4, 4}}, 2);
+
+    CHECK(tree == expected);
+
+    SECTION("the tree can be modified after building it")
+    {
+      tree.insert(vm::bbox3d{{-40, 1, 1}, {-39, 2, 2}}, 4);
+      CHECK(tree.find_containers({-39.5, 1.5, 1.5}) == std::vector<int>{4});
+
+      CHECK(tree.remove(1));
+      CHECK(tree.remove(3));
+      CHECK(tree.remove(2));
+      CHECK(tree.remove(4));
+      CHECK(tree.empty());
+    }
+  }
+
+  SECTION("building a tree with duplicate data")
+  {
+    CHECK_THROWS_AS(
+      tree.build({
+        {vm::bbox3d{{0, 0, 0}, {2, 1, 1}}, 1},
+        {vm::bbox3d{{4, 4, 4}, {5, 5, 5}}, 1},
+      }),
+      NodeTreeException);
+
+    CHECK(tree.empty());
+  }
+}
+
 TEST_CASE("octree.contains")
 {
   auto tree = octree<double, int>{32.0};
@@ -610,6 +699,13 @@ TEST_CASE("octree.find_intersectors-ray")
     // the leaf that contains the data is hit by the ray
     CHECK(
       tree.find_intersectors(vm::ray3d{{48, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+
+    // the ray runs along the boundary of the leaf that contains the data
+    CHECK(
+      tree.find_intersectors(vm::ray3d{{32, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+
+    // the ray runs parallel to the leaf that contains the data
+    CHECK(tree.find_intersectors(vm::ray3d{{31, 48, 0}, {0, 0, 1}}).empty());
   }
 }
 
@@ -717,4 +813,82 @@ TEST_CASE("octree.find_containers")
     CHECK(tree.find_containers({64, 64, 64}) == std::vector<int>{1});
   }
 }
+
+TEST_CASE("octree.find_uncontained")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_uncontained({{0, 0, 0}, {32, 32, 32}}).empty());
+  }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // the leaf that contains the data is contained in the bbox
+    CHECK(tree.find_uncontained({{0, 0, 0}, {64, 64, 64}}).empty());
+
+    // the leaf that contains the data touches the boundary of the bbox
+    CHECK(tree.find_uncontained({{32, 32, 32}, {64, 64, 64}}).empty());
+
+    // the leaf that contains the data is partially outside of the bbox
+    CHECK(tree.find_uncontained({{0, 0, 0}, {48, 64, 64}}) == std::vector<int>{1});
+
+    // the leaf that contains the data is entirely outside of the bbox
+    CHECK(tree.find_uncontained({{-64, -64, -64}, {0, 0, 0}}) == std::vector<int>{1});
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+
+    CHECK(tree.find_uncontained({{0, 0, 0}, {64, 64, 64}}) == std::vector<int>{2});
+    CHECK(tree.find_uncontained({{-64, -64, -64}, {64, 64, 64}}).empty());
+  }
+}
+
+TEST_CASE("octree.find_in_convex_volume")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_in_convex_volume({vm::plane3d{0.0, {1, 0, 0}}}).empty());
+  }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // no planes bound the entire space
+    CHECK(tree.find_in_convex_volume({}) == std::vector<int>{1});
+
+    // the leaf that contains the data is entirely above the plane
+    CHECK(tree.find_in_convex_volume({vm::plane3d{16.0, {1, 0, 0}}}).empty());
+
+    // the leaf that contains the data is partially below the plane
+    CHECK(
+      tree.find_in_convex_volume({vm::plane3d{{40, 0, 0}, {-1, 0, 0}}})
+      == std::vector<int>{1});
+
+    // the leaf that contains the data is below one plane, but above the other
+    CHECK(tree
+            .find_in_convex_volume({
+              vm::plane3d{{0, 0, 16}, {0, 0, 1}},
+              vm::plane3d{{0, 0, 0}, {0, 0, -1}},
+            })
+            .empty());
+
+    // the leaf that contains the data intersects the volume
+    CHECK(
+      tree.find_in_convex_volume({
+        vm::plane3d{{0, 0, 48}, {0, 0, 1}},
+        vm::plane3d{{0, 0, 40}, {0, 0, -1}},
+      })
+      == std::vector<int>{1});
+  }
+}
 } // namespace tb
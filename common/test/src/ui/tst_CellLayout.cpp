@@ -0,0 +1,179 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ui/CellLayout.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::ui
+{
+namespace
+{
+
+struct TestItem
+{
+  int id;
+  float width;
+  float height;
+};
+
+CellLayout makeLayout()
+{
+  auto layout = CellLayout{};
+  layout.setOuterMargin(5.0f);
+  layout.setGroupMargin(5.0f);
+  layout.setRowMargin(15.0f);
+  layout.setCellMargin(10.0f);
+  layout.setTitleMargin(2.0f);
+  layout.setCellWidth(64.0f, 64.0f);
+  layout.setCellHeight(64.0f, 128.0f);
+  layout.setWidth(300.0f);
+  return layout;
+}
+
+void addItems(CellLayout& layout, const std::vector<TestItem>& items)
+{
+  for (const auto& item : items)
+  {
+    layout.addItem(
+      item.id, std::to_string(item.id), item.width, item.height, 40.0f, 12.0f);
+  }
+}
+
+using CellSummary = std::tuple<int, float, float, float, float>;
+
+std::vector<std::vector<CellSummary>> summarize(CellLayout& layout)
+{
+  auto result = std::vector<std::vector<CellSummary>>{};
+  for (const auto& group : layout.groups())
+  {
+    auto& groupSummary = result.emplace_back();
+    for (const auto& row : group.rows())
+    {
+      for (const auto& cell : row.cells())
+      {
+        const auto& bounds = cell.cellBounds();
+        groupSummary.emplace_back(
+          cell.itemAs<int>(), bounds.x, bounds.y, bounds.width, bounds.height);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("CellLayout")
+{
+  const auto items = std::vector<TestItem>{
+    {0, 64.0f, 64.0f},
+    {1, 32.0f, 128.0f},
+    {2, 64.0f, 32.0f},
+    {3, 128.0f, 128.0f},
+    {4, 64.0f, 64.0f},
+    {5, 16.0f, 16.0f},
+    {6, 64.0f, 100.0f},
+    {7, 64.0f, 64.0f},
+    {8, 64.0f, 64.0f},
+    {9, 64.0f, 32.0f},
+  };
+
+  const auto isOdd = [](const LayoutCell& cell) { return cell.itemAs<int>() % 2 == 1; };
+  const auto isLarge = [](const LayoutCell& cell) { return cell.itemAs<int>() >= 7; };
+
+  SECTION("removeItems")
+  {
+    SECTION("Removing items from the middle")
+    {
+      auto expected = makeLayout();
+      addItems(expected, {items[0], items[2], items[4], items[6], items[8]});
+
+      auto layout = makeLayout();
+      addItems(layout, items);
+      layout.removeItems(isOdd);
+
+      CHECK(summarize(layout) == summarize(expected));
+      CHECK(layout.height() == expected.height());
+    }
+
+    SECTION("Removing items from the end")
+    {
+      auto expected = makeLayout();
+      addItems(
+        expected, {items[0], items[1], items[2], items[3], items[4], items[5], items[6]});
+
+      auto layout = makeLayout();
+      addItems(layout, items);
+      layout.removeItems(isLarge);
+
+      CHECK(summarize(layout) == summarize(expected));
+      CHECK(layout.height() == expected.height());
+    }
+
+    SECTION("Removing items from groups")
+    {
+      auto expected = makeLayout();
+      expected.addGroup("a", 12.0f);
+      addItems(expected, {items[0], items[2], items[4]});
+      expected.addGroup("b", 12.0f);
+      addItems(expected, {items[6], items[8]});
+
+      auto layout = makeLayout();
+      layout.addGroup("a", 12.0f);
+      addItems(layout, {items[0], items[1], items[2], items[3], items[4]});
+      layout.addGroup("b", 12.0f);
+      addItems(layout, {items[5], items[6], items[7], items[8], items[9]});
+      layout.removeItems(isOdd);
+
+      CHECK(summarize(layout) == summarize(expected));
+      CHECK(layout.groups()[1].titleBounds().y == expected.groups()[1].titleBounds().y);
+      CHECK(layout.height() == expected.height());
+    }
+
+    SECTION("Removing no items doesn't change the layout")
+    {
+      auto layout = makeLayout();
+      addItems(layout, items);
+      const auto before = summarize(layout);
+
+      layout.removeItems([](const auto&) { return false; });
+      CHECK(summarize(layout) == before);
+    }
+  }
+
+  SECTION("Changing the width lays out the items again")
+  {
+    auto expected = makeLayout();
+    expected.setWidth(500.0f);
+    addItems(expected, items);
+
+    auto layout = makeLayout();
+    addItems(layout, items);
+    REQUIRE(summarize(layout) != summarize(expected));
+
+    layout.setWidth(500.0f);
+    CHECK(summarize(layout) == summarize(expected));
+  }
+}
+
+} // namespace tb::ui
@@ -19,11 +19,14 @@
  */
 
 #include "MapFixture.h"
+#include "TestFactory.h"
 #include "TestUtils.h"
 #include "mdl/BrushNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/Map.h"
 #include "mdl/Map_CopyPaste.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
 #include "mdl/PasteType.h"
 #include "mdl/WorldNode.h"
 #include "ui/ClipTool.h"
@@ -93,6 +96,43 @@ TEST_CASE("ClipTool")
     CHECK(clippedBrushNode2->linkId() != originalLinkId);
     CHECK(clippedBrushNode1->linkId() != clippedBrushNode2->linkId());
   }
+
+  SECTION("Clipping uses the latest clip points")
+  {
+    auto* brushNode = createBrushNode(map);
+    addNodes(map, {{parentForNodes(map), {brushNode}}});
+    selectNodes(map, {brushNode});
+
+    auto tool = ClipTool{map};
+    REQUIRE(tool.activate());
+
+    tool.addPoint(vm::vec3d{0, 16, 16}, {});
+    tool.addPoint(vm::vec3d{0, -16, 16}, {});
+    tool.addPoint(vm::vec3d{8, -16, 0}, {});
+    REQUIRE(tool.canClip());
+
+    REQUIRE(tool.removeLastPoint());
+    tool.addPoint(vm::vec3d{0, -16, 0}, {});
+    REQUIRE(tool.canClip());
+
+    tool.toggleSide();
+    tool.performClip();
+
+    const auto* defaultLayer = map.world()->defaultLayer();
+    REQUIRE(defaultLayer->childCount() == 2);
+
+    const auto* clippedBrushNode1 =
+      dynamic_cast<const mdl::BrushNode*>(defaultLayer->children().front());
+    const auto* clippedBrushNode2 =
+      dynamic_cast<const mdl::BrushNode*>(defaultLayer->children().back());
+
+    REQUIRE(clippedBrushNode1);
+    REQUIRE(clippedBrushNode2);
+
+    // the brush was split at x = 0
+    CHECK(clippedBrushNode1->logicalBounds().size() == vm::vec3d{16, 32, 32});
+    CHECK(clippedBrushNode2->logicalBounds().size() == vm::vec3d{16, 32, 32});
+  }
 }
 
 } // namespace tb::ui
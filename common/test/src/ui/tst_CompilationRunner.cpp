@@ -32,6 +32,7 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 #include "mdl/Map.h"
 #include "mdl/Map_Nodes.h"
 #include "ui/CompilationContext.h"
+#include "ui/CompilationExportCache.h"
 #include "ui/CompilationRunner.h"
 #include "ui/CompilationVariables.h"
 #include "ui/TextOutputAdapter.h"
@@ -317,11 +318,53 @@ TEST_CASE("CompilationExportMapTaskRunner")
     auto task = mdl::CompilationExportMap{true, exportPath};
 
     auto runner = CompilationExportMapTaskRunner{context, task};
+    auto endSpy = QSignalSpy{&runner, SIGNAL(end())};
+    REQUIRE(endSpy.isValid());
+
     REQUIRE_NOTHROW(runner.execute());
+    REQUIRE(endSpy.wait());
 
     CHECK(testEnvironment.fileExists("exported.map"));
   }
 
+  SECTION("skip export of unmodified map")
+  {
+    auto exportCache = CompilationExportCache{};
+    auto cachingContext =
+      CompilationContext{map, variables, outputAdapter, false, &exportCache};
+
+    auto task = mdl::CompilationExportMap{true, "${WORK_DIR_PATH}/exported.map"};
+
+    const auto exportMap = [&]() {
+      auto runner = CompilationExportMapTaskRunner{cachingContext, task};
+      auto endSpy = QSignalSpy{&runner, SIGNAL(end())};
+      REQUIRE(endSpy.isValid());
+
+      runner.execute();
+
+      // a skipped export ends immediately
+      const auto skipped = endSpy.count() == 1;
+      if (!skipped)
+      {
+        REQUIRE(endSpy.wait());
+      }
+      return skipped;
+    };
+
+    CHECK_FALSE(exportMap());
+    CHECK(testEnvironment.fileExists("exported.map"));
+    CHECK(exportMap());
+
+    auto node = new mdl::EntityNode{mdl::Entity{}};
+    addNodes(map, {{parentForNodes(map), {node}}});
+
+    CHECK_FALSE(exportMap());
+    CHECK(exportMap());
+
+    std::filesystem::remove(testEnvironment.dir() / "exported.map");
+    CHECK_FALSE(exportMap());
+  }
+
   SECTION("variable interpolation error")
   {
     auto node = new mdl::EntityNode{mdl::Entity{}};
@@ -544,6 +587,45 @@ TEST_CASE("CompilationRunner")
     CHECK_FALSE(testEnvironment.fileExists(should_not_exist));
   }
 
+  SECTION("runConcurrentTasks")
+  {
+    const auto sourcePath = "source.map";
+    const auto concurrentPath = "concurrent";
+    const auto sequentialPath = "sequential";
+
+    testEnvironment.createFile(sourcePath, "{}");
+
+    const auto source = (testEnvironment.dir() / sourcePath).string();
+    auto compilationProfile = mdl::CompilationProfile{
+      "name",
+      testEnvironment.dir().string(),
+      {
+        mdl::CompilationRunTool{true, CMD_TOOL_PATH, "--exit 0", false},
+        mdl::CompilationCopyFiles{
+          true, source, (testEnvironment.dir() / concurrentPath).string(), true},
+        mdl::CompilationCopyFiles{
+          true, source, (testEnvironment.dir() / sequentialPath).string()},
+      }};
+
+    auto runner = CompilationRunner{
+      CompilationContext{map, variables, outputAdapter, false}, compilationProfile};
+
+    auto compilationEndedSpy = QSignalSpy{&runner, SIGNAL(compilationEnded())};
+    REQUIRE(compilationEndedSpy.isValid());
+
+    runner.execute();
+
+    // the concurrent task doesn't wait for the tool, but the next task does
+    CHECK(runner.running());
+    CHECK(testEnvironment.fileExists(std::filesystem::path{concurrentPath} / sourcePath));
+    CHECK_FALSE(
+      testEnvironment.fileExists(std::filesystem::path{sequentialPath} / sourcePath));
+
+    REQUIRE(compilationEndedSpy.wait());
+    CHECK_FALSE(runner.running());
+    CHECK(testEnvironment.fileExists(std::filesystem::path{sequentialPath} / sourcePath));
+  }
+
   SECTION("interpolateToolsVariables")
   {
     using namespace std::string_literals;
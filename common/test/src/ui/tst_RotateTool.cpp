@@ -86,6 +86,40 @@ TEST_CASE("RotateTool")
       CHECK(tool.rotationCenter() == map.grid().snap(map.selectionBounds()->center()));
     }
   }
+
+  SECTION("applyRotation")
+  {
+    auto entity = mdl::Entity{};
+    entity.setOrigin(vm::vec3d{16, 0, 0});
+
+    auto* entityNode = new mdl::EntityNode{std::move(entity)};
+    addNodes(map, {{parentForNodes(map), {entityNode}}});
+    selectNodes(map, {entityNode});
+
+    tool.beginRotation();
+    tool.applyRotation(vm::vec3d{0, 0, 0}, vm::vec3d{0, 0, 1}, vm::to_radians(90.0));
+
+    // the rotation is only previewed while dragging
+    CHECK(tool.previewTransformation() != std::nullopt);
+    CHECK(entityNode->entity().origin() == vm::vec3d{16, 0, 0});
+
+    SECTION("Committing applies the rotation")
+    {
+      tool.commitRotation();
+
+      CHECK(tool.previewTransformation() == std::nullopt);
+      CHECK(vm::is_equal(
+        entityNode->entity().origin(), vm::vec3d{0, 16, 0}, vm::Cd::almost_zero()));
+    }
+
+    SECTION("Cancelling discards the rotation")
+    {
+      tool.cancelRotation();
+
+      CHECK(tool.previewTransformation() == std::nullopt);
+      CHECK(entityNode->entity().origin() == vm::vec3d{16, 0, 0});
+    }
+  }
 }
 
 
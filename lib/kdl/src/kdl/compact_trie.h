@@ -22,12 +22,16 @@
 
 #include "kdl/string_compare.h"
 
+#include <algorithm>
 #include <cassert>
-#include <set>
+#include <cstddef>
+#include <iterator>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace kdl
@@ -68,7 +72,6 @@ template <typename V>
 class compact_trie
 {
 private:
-  struct node_cmp;
   class node;
 
   /**
@@ -225,54 +228,40 @@ private:
   };
 
   /**
-   * A trie node. Children are stored in a set ordered by `node_cmp`. Each node can store
-   * a given value multiple times.
+   * A trie node. Each node can store a given value multiple times.
    *
-   * A trie node has only const methods and therefore appears to be immutable, but this is
-   * not the case. All of its members are actually declared as mutable and may be modified
-   * by the `insert` or `remove` member functions. The reason for this peculiar design
-   * choice is that trie nodes are stored by value in a `std::set`, and `std::set` does
-   * not allow its contents to be modified, since that might affect the position of the
-   * value in the set.
-   *
-   * But in this particular case, the position of a node in the containing set depends
-   * only on the node's key, and the node's key is changed only in ways that does not
-   * affect its position. The key can only become shorter or longer, that is, key "abc"
-   * might be changed to "ab" or "abcd", and neither of these changes affects how the key
-   * compares to other keys due to the order introduce by `node_cmp`, which consideres two
-   * keys equivalent if they share a non-empty prefix.
-   *
-   * This implies that the following two conditions hold for a node with key "abc":
-   * - There is no sibling node with a key that is a prefix of "abc".
-   * - There is no sibling node with a key that that has "abc" as a prefix.
-   *
-   * Therefore, shortening or extending a node's key does not affect its position in the
-   * containing set, and we can update a node's key without violating any invariants of
-   * the containing set.
+   * No two siblings share a non-empty prefix, so the first characters of the children's
+   * keys are unique. The children are stored by value in a vector that is sorted by these
+   * first characters, so that a node's children occupy a single allocation. The first
+   * characters are also stored contiguously in a string so that a child can be found by
+   * a single memchr, which the standard library implements with vector instructions.
    */
   class node
   {
   private:
-    friend struct node_cmp;
     friend class match_state;
 
     using value_container = std::unordered_map<V, std::size_t>;
-    using node_set = std::set<node, node_cmp>;
 
     /**
      * The partical key of this node.
      */
-    mutable std::string m_key;
+    std::string m_key;
 
     /**
      * Maps a value to the number of times it was stored in this node.
      */
-    mutable value_container m_values;
+    value_container m_values;
+
+    /**
+     * The children of this node, sorted by the first characters of their keys.
+     */
+    std::vector<node> m_children;
 
     /**
-     * The children of this node.
+     * The first character of the key of each child, in the same order as m_children.
      */
-    mutable node_set m_children;
+    std::string m_child_chars;
 
   public:
     /**
@@ -295,7 +284,7 @@ private:
      * @param key the key to insert
      * @param value the value to insert
      */
-    void insert(const std::string_view key, const V& value) const
+    void insert(const std::string_view key, const V& value)
     {
       // clang-format off
       /*
@@ -332,8 +321,7 @@ private:
           // case 0, 1: m_key is a prefix of key, find or create a child that has a common
           // prefix with the remainder of key and insert there
           const auto remainder = key.substr(mismatch);
-          const auto& child = *m_children.insert(node(std::string(remainder))).first;
-          child.insert(remainder, value);
+          find_or_insert_child(remainder).insert(remainder, value);
         }
         else
         { // mismatch == m_key.size()
@@ -361,7 +349,7 @@ private:
      * @param value the value to remove
      * @return true if the given key and value were removed from this node's subtree
      */
-    bool remove(const std::string_view key, const V& value) const
+    bool remove(const std::string_view key, const V& value)
     {
       bool result = false;
 
@@ -373,13 +361,15 @@ private:
         {
           // m_key is a true prefix of key, continue at the corresponding child node
           const auto remainder = key.substr(mismatch);
-          const auto it = m_children.find(remainder);
-          assert(it != std::end(m_children));
+          const auto i = m_child_chars.find(remainder.front());
+          assert(i != std::string::npos);
 
-          result = it->remove(remainder, value);
-          if (!it->m_key.empty() && it->m_values.empty() && it->m_children.empty())
+          auto& child = m_children[i];
+          result = child.remove(remainder, value);
+          if (child.m_values.empty() && child.m_children.empty())
           {
-            m_children.erase(it);
+            m_children.erase(std::next(m_children.begin(), std::ptrdiff_t(i)));
+            m_child_chars.erase(i, 1u);
           }
         }
         else
@@ -497,12 +487,11 @@ private:
           else
           {
             // the key is consumed, so continue matching at the children
-            for (const auto& c : {"*", "?", "%", "\\"})
+            for (const auto c : {'*', '?', '%', '\\'})
             {
-              const auto it = m_children.find(c);
-              if (it != std::end(m_children))
+              if (const auto* child = find_child(c))
               {
-                it->find_matches(pattern, p_i, this, match_state, out);
+                child->find_matches(pattern, p_i, this, match_state, out);
               }
             }
           }
@@ -573,12 +562,9 @@ private:
             else
             {
               // the key is consumed, so continue matching at the children
-              for (auto it = m_children.lower_bound("0"),
-                        end = m_children.upper_bound("9");
-                   it != end;
-                   ++it)
+              for (const auto& child : children_in_range('0', '9'))
               {
-                it->find_matches(pattern, p_i, this, match_state, out);
+                child.find_matches(pattern, p_i, this, match_state, out);
               }
             }
           }
@@ -596,12 +582,9 @@ private:
             else
             {
               // the key is consumed, so continue matching at the children
-              for (auto it = m_children.lower_bound("0"),
-                        end = m_children.upper_bound("9");
-                   it != end;
-                   ++it)
+              for (const auto& child : children_in_range('0', '9'))
               {
-                it->find_matches(pattern, p_i, this, match_state, out);
+                child.find_matches(pattern, p_i, this, match_state, out);
               }
             }
           }
@@ -619,11 +602,9 @@ private:
           else
           {
             // the key is consumed, so continue matching at the children
-            for (auto [it, end] = m_children.equal_range(pattern.substr(p_i, 1u));
-                 it != end;
-                 ++it)
+            if (const auto* child = find_child(pattern[p_i]))
             {
-              it->find_matches(pattern, p_i, this, match_state, out);
+              child->find_matches(pattern, p_i, this, match_state, out);
             }
           }
         }
@@ -653,9 +634,9 @@ private:
     }
 
   private:
-    void insert_value(const V& value) const { m_values[value]++; }
+    void insert_value(const V& value) { m_values[value]++; }
 
-    bool remove_value(const V& value) const
+    bool remove_value(const V& value)
     {
       auto it = m_values.find(value);
       if (it == std::end(m_values))
@@ -685,25 +666,20 @@ private:
      *
      * @param index the index at which to split the node's key
      */
-    void split_node(const std::size_t index) const
+    void split_node(const std::size_t index)
     {
       assert(m_key.length() > 1u);
-
-      auto new_key = m_key.substr(0u, index);
-      auto remainder = m_key.substr(index);
-
-      assert(!new_key.empty());
-      assert(!remainder.empty());
+      assert(index > 0u && index < m_key.length());
 
       using std::swap;
-      node_set new_children;
-      swap(new_children, m_children);
-
-      const node& new_child = *m_children.insert(node(std::move(remainder))).first;
-      swap(new_child.m_children, new_children);
+      auto new_child = node{m_key.substr(index)};
+      swap(new_child.m_children, m_children);
+      swap(new_child.m_child_chars, m_child_chars);
       swap(new_child.m_values, m_values);
 
-      m_key = std::move(new_key);
+      m_key.resize(index);
+      m_child_chars.push_back(new_child.m_key.front());
+      m_children.push_back(std::move(new_child));
     }
 
     /**
@@ -713,22 +689,59 @@ private:
      *
      * Precondition: This node has only one child, and this node has no values of its own.
      */
-    void merge_node() const
+    void merge_node()
     {
       assert(m_children.size() == 1u);
       assert(m_values.empty());
 
-      using std::swap;
-      auto old_children = node_set{};
-      swap(old_children, m_children);
-
-      const auto& child = *std::begin(old_children);
-      swap(m_children, child.m_children);
-      swap(m_values, child.m_values);
+      auto child = std::move(m_children.front());
+      m_children = std::move(child.m_children);
+      m_child_chars = std::move(child.m_child_chars);
+      m_values = std::move(child.m_values);
 
       m_key += child.m_key;
     }
 
+    /**
+     * Returns the child whose key starts with the given character or null if there is no
+     * such child.
+     */
+    const node* find_child(const char c) const
+    {
+      const auto i = m_child_chars.find(c);
+      return i != std::string::npos ? &m_children[i] : nullptr;
+    }
+
+    /**
+     * Returns the child whose key starts with the first character of the given key. If
+     * there is no such child, a new child with the given key is inserted.
+     */
+    node& find_or_insert_child(const std::string_view key)
+    {
+      assert(!key.empty());
+
+      const auto it = std::ranges::lower_bound(m_child_chars, key[0]);
+      const auto i = std::distance(m_child_chars.begin(), it);
+      if (it == m_child_chars.end() || *it != key[0])
+      {
+        m_child_chars.insert(it, key[0]);
+        m_children.insert(std::next(m_children.begin(), i), node{std::string{key}});
+      }
+      return m_children[std::size_t(i)];
+    }
+
+    /**
+     * Returns the children whose keys start with a character in the given closed range.
+     */
+    std::span<const node> children_in_range(const char first, const char last) const
+    {
+      const auto begin = std::ranges::lower_bound(m_child_chars, first);
+      const auto end = std::upper_bound(begin, m_child_chars.end(), last);
+      return std::span<const node>{m_children}.subspan(
+        std::size_t(std::distance(m_child_chars.begin(), begin)),
+        std::size_t(std::distance(begin, end)));
+    }
+
     template <typename O>
     void get_values(O out) const
     {
@@ -752,45 +765,6 @@ private:
     }
   };
 
-  /**
-   * Compares nodes against each other or nodes against strings.
-   *
-   * Two nodes are compared by their keys.
-   * A node is compared to a string by comparing its key to the string.
-   *
-   * Two strings are compared by their first character only, soif two nodes share a
-   * non-empty prefix, they are considered equivalent. Therefore, the keys "ab" and "abc"
-   * are equivalent. Conversely, the keys "ab" and "bc" are not equivalent because they do
-   * not share a prefix, more specifically, "ab" is considered less than "bc".
-   *
-   * Precondition: the strings to copmare are not empty.
-   */
-  struct node_cmp
-  {
-    using is_transparent = void;
-
-    bool operator()(const node& lhs, const node& rhs) const
-    {
-      return compare(lhs.m_key, rhs.m_key);
-    }
-
-    bool operator()(const std::string_view lhs, const node& rhs) const
-    {
-      return compare(lhs, rhs.m_key);
-    }
-
-    bool operator()(const node& lhs, const std::string_view rhs) const
-    {
-      return compare(lhs.m_key, rhs);
-    }
-
-    bool compare(const std::string_view lhs, const std::string_view& rhs) const
-    {
-      assert(!lhs.empty() && !rhs.empty());
-      return lhs[0] < rhs[0];
-    }
-  };
-
 private:
   node m_root = node{""};
 
@@ -808,6 +782,22 @@ public:
    */
   void insert(const std::string_view key, const V& value) { m_root.insert(key, value); }
 
+  /**
+   * Inserts the given key / value pairs. The pairs are inserted in the order of their
+   * keys, so that consecutive insertions descend along the same paths and new children
+   * are appended to the children of their parents instead of being inserted in between.
+   *
+   * @param key_value_pairs the keys and values to insert
+   */
+  void insert(std::vector<std::pair<std::string_view, V>> key_value_pairs)
+  {
+    std::ranges::sort(key_value_pairs, {}, [](const auto& p) { return p.first; });
+    for (const auto& [key, value] : key_value_pairs)
+    {
+      m_root.insert(key, value);
+    }
+  }
+
   /**
    * Removes the given value using the given key.
    *
@@ -19,32 +19,201 @@
 
 #include "kdl/dynamic_bitset.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace kdl
 {
+namespace
+{
+
+std::size_t word_count(const std::size_t bitCount, const std::size_t wordBits)
+{
+  return (bitCount + wordBits - 1) / wordBits;
+}
+
+} // namespace
+
+dynamic_bitset::reference::reference(word_type& word, const std::size_t bit)
+  : m_word{word}
+  , m_mask{word_type(1) << bit}
+{
+}
+
+dynamic_bitset::reference& dynamic_bitset::reference::operator=(const bool value)
+{
+  if (value)
+  {
+    m_word |= m_mask;
+  }
+  else
+  {
+    m_word &= ~m_mask;
+  }
+  return *this;
+}
+
+dynamic_bitset::reference& dynamic_bitset::reference::operator=(
+  const reference& other)
+{
+  return *this = bool(other);
+}
+
+dynamic_bitset::reference::operator bool() const
+{
+  return (m_word & m_mask) != 0;
+}
 
 dynamic_bitset::dynamic_bitset(const std::size_t initialSize)
-  : m_bits(initialSize, false)
+  : m_words(word_count(initialSize, word_bits), 0)
 {
 }
 
+std::size_t dynamic_bitset::size() const
+{
+  return m_words.size() * word_bits;
+}
+
 bool dynamic_bitset::operator[](const std::size_t index) const
 {
-  return index < m_bits.size() ? m_bits[index] : false;
+  const auto wordIndex = index / word_bits;
+  return wordIndex < m_words.size()
+         && (m_words[wordIndex] & (word_type(1) << (index % word_bits))) != 0;
+}
+
+dynamic_bitset::reference dynamic_bitset::operator[](const std::size_t index)
+{
+  const auto wordIndex = index / word_bits;
+  if (wordIndex >= m_words.size())
+  {
+    m_words.resize(wordIndex + 1, 0);
+  }
+  return reference{m_words[wordIndex], index % word_bits};
 }
 
-std::vector<bool>::reference dynamic_bitset::dynamic_bitset::operator[](
-  const std::size_t index)
+std::size_t dynamic_bitset::count() const
 {
-  if (index >= m_bits.size())
+  auto result = std::size_t(0);
+  for (const auto word : m_words)
   {
-    m_bits.insert(std::end(m_bits), index - m_bits.size() + 1, false);
+    result += std::size_t(std::popcount(word));
   }
-  return m_bits[index];
+  return result;
+}
+
+bool dynamic_bitset::any() const
+{
+  return std::ranges::any_of(m_words, [](const auto word) { return word != 0; });
+}
+
+bool dynamic_bitset::none() const
+{
+  return !any();
+}
+
+std::size_t dynamic_bitset::find_first() const
+{
+  return find_from(0);
+}
+
+std::size_t dynamic_bitset::find_next(const std::size_t index) const
+{
+  return index < npos ? find_from(index + 1) : npos;
 }
 
 void dynamic_bitset::reset()
 {
-  m_bits = std::vector<bool>(64, false);
+  m_words.assign(word_count(64, word_bits), 0);
+}
+
+dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& other)
+{
+  const auto common = std::min(m_words.size(), other.m_words.size());
+  for (std::size_t i = 0; i < common; ++i)
+  {
+    m_words[i] &= other.m_words[i];
+  }
+  std::fill(std::next(m_words.begin(), long(common)), m_words.end(), 0);
+  return *this;
+}
+
+dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& other)
+{
+  if (m_words.size() < other.m_words.size())
+  {
+    m_words.resize(other.m_words.size(), 0);
+  }
+  for (std::size_t i = 0; i < other.m_words.size(); ++i)
+  {
+    m_words[i] |= other.m_words[i];
+  }
+  return *this;
+}
+
+dynamic_bitset& dynamic_bitset::operator-=(const dynamic_bitset& other)
+{
+  const auto common = std::min(m_words.size(), other.m_words.size());
+  for (std::size_t i = 0; i < common; ++i)
+  {
+    m_words[i] &= ~other.m_words[i];
+  }
+  return *this;
+}
+
+bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+{
+  const auto& shorter = lhs.m_words.size() < rhs.m_words.size() ? lhs : rhs;
+  const auto& longer = lhs.m_words.size() < rhs.m_words.size() ? rhs : lhs;
+  const auto common = shorter.m_words.size();
+
+  return std::equal(
+           shorter.m_words.begin(),
+           shorter.m_words.end(),
+           longer.m_words.begin())
+         && std::all_of(
+           std::next(longer.m_words.begin(), long(common)),
+           longer.m_words.end(),
+           [](const auto word) { return word == 0; });
+}
+
+dynamic_bitset operator&(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+  lhs &= rhs;
+  return lhs;
+}
+
+dynamic_bitset operator|(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+  lhs |= rhs;
+  return lhs;
+}
+
+dynamic_bitset operator-(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+  lhs -= rhs;
+  return lhs;
+}
+
+std::size_t dynamic_bitset::find_from(const std::size_t index) const
+{
+  auto wordIndex = index / word_bits;
+  if (wordIndex >= m_words.size())
+  {
+    return npos;
+  }
+
+  // mask off the bits before the given index in the first word
+  auto word = m_words[wordIndex] & (~word_type(0) << (index % word_bits));
+  while (word == 0)
+  {
+    if (++wordIndex == m_words.size())
+    {
+      return npos;
+    }
+    word = m_words[wordIndex];
+  }
+
+  return wordIndex * word_bits + std::size_t(std::countr_zero(word));
 }
 
 } // namespace kdl
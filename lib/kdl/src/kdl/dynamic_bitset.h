@@ -20,24 +20,100 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace kdl
 {
 
+/**
+ * A bit set that grows on demand. Bits that lie beyond the current size are considered
+ * unset.
+ *
+ * The bits are stored in 64 bit words so that the bulk operations (intersection, union,
+ * difference, counting and searching) process 64 bits at a time.
+ */
 class dynamic_bitset
 {
 private:
-  std::vector<bool> m_bits;
+  using word_type = std::uint64_t;
+  static constexpr std::size_t word_bits = std::numeric_limits<word_type>::digits;
+
+  std::vector<word_type> m_words;
 
 public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  class reference
+  {
+  private:
+    word_type& m_word;
+    word_type m_mask;
+
+  public:
+    reference(word_type& word, std::size_t bit);
+
+    reference& operator=(bool value);
+    reference& operator=(const reference& other);
+
+    operator bool() const;
+  };
+
   explicit dynamic_bitset(std::size_t initialSize = 64);
 
+  /**
+   * Returns the number of bits that can be accessed without growing this bit set.
+   */
+  std::size_t size() const;
+
   bool operator[](std::size_t index) const;
 
-  std::vector<bool>::reference operator[](std::size_t index);
+  /**
+   * Returns a reference to the bit at the given index, growing this bit set if necessary.
+   */
+  reference operator[](std::size_t index);
+
+  /**
+   * Returns the number of set bits.
+   */
+  std::size_t count() const;
+
+  bool any() const;
+  bool none() const;
+
+  /**
+   * Returns the index of the first set bit or npos if no bit is set.
+   */
+  std::size_t find_first() const;
+
+  /**
+   * Returns the index of the first set bit after the given index or npos if there is no
+   * such bit.
+   */
+  std::size_t find_next(std::size_t index) const;
 
   void reset();
+
+  dynamic_bitset& operator&=(const dynamic_bitset& other);
+  dynamic_bitset& operator|=(const dynamic_bitset& other);
+
+  /**
+   * Unsets every bit that is set in the given bit set.
+   */
+  dynamic_bitset& operator-=(const dynamic_bitset& other);
+
+  /**
+   * Two bit sets are equal if they have the same set bits, regardless of their sizes.
+   */
+  friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+
+  friend dynamic_bitset operator&(dynamic_bitset lhs, const dynamic_bitset& rhs);
+  friend dynamic_bitset operator|(dynamic_bitset lhs, const dynamic_bitset& rhs);
+  friend dynamic_bitset operator-(dynamic_bitset lhs, const dynamic_bitset& rhs);
+
+private:
+  std::size_t find_from(std::size_t index) const;
 };
 
 } // namespace kdl
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace kdl
+{
+
+/**
+ * A thread safe pool of shared immutable values. Interning a value returns the pooled
+ * value that is equal to it, so equal interned values share their storage and can be
+ * compared for equality by comparing pointers.
+ *
+ * The pool only refers to its values weakly. A value is removed from the pool when the
+ * last reference to it is destroyed, which may happen after the pool itself has been
+ * destroyed.
+ */
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class intern_pool
+{
+private:
+  struct state
+  {
+    std::mutex mutex;
+    std::unordered_multimap<std::size_t, std::weak_ptr<const T>> values;
+  };
+
+  std::shared_ptr<state> m_state = std::make_shared<state>();
+
+public:
+  /**
+   * Returns the pooled value that is equal to the given value. If the pool does not
+   * contain such a value, the result of calling make_value is added to the pool and
+   * returned. The result of make_value must be equal to the given value.
+   */
+  template <typename F>
+  std::shared_ptr<const T> intern(const T& value, const F& make_value)
+  {
+    const auto hash = Hash{}(value);
+
+    // values that are locked while searching must be released after the mutex since
+    // releasing the last reference to a value locks the mutex
+    auto candidates = std::vector<std::shared_ptr<const T>>{};
+
+    const auto lock = std::lock_guard{m_state->mutex};
+    for (auto [it, end] = m_state->values.equal_range(hash); it != end; ++it)
+    {
+      const auto& candidate = candidates.emplace_back(it->second.lock());
+      if (candidate && Equal{}(*candidate, value))
+      {
+        return candidate;
+      }
+    }
+
+    auto result = std::shared_ptr<const T>{
+      new T{make_value()}, [s = m_state, hash](const T* releasedValue) {
+        {
+          const auto releaseLock = std::lock_guard{s->mutex};
+
+          // removes the released value, but also any other expired values with the
+          // same hash, whose deleters will then find nothing to remove
+          const auto [first, last] = s->values.equal_range(hash);
+          for (auto it = first; it != last;)
+          {
+            it = it->second.expired() ? s->values.erase(it) : std::next(it);
+          }
+        }
+        delete releasedValue;
+      }};
+    m_state->values.emplace(hash, result);
+    return result;
+  }
+
+  /**
+   * Returns the pooled value that is equal to the given value, adding a copy of the given
+   * value to the pool if it does not contain such a value.
+   */
+  std::shared_ptr<const T> intern(const T& value)
+  {
+    return intern(value, [&]() { return value; });
+  }
+
+  /**
+   * Returns the number of values in this pool, including values that have been released
+   * but not yet removed.
+   */
+  std::size_t size() const
+  {
+    const auto lock = std::lock_guard{m_state->mutex};
+    return m_state->values.size();
+  }
+};
+
+} // namespace kdl
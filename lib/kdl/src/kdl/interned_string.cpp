@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/interned_string.h"
+
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace kdl
+{
+namespace
+{
+
+struct string_pool
+{
+  std::mutex mutex;
+
+  // the keys refer to the strings managed by the values
+  std::unordered_map<std::string_view, std::weak_ptr<const std::string>> strings;
+};
+
+/**
+ * The pool is intentionally leaked so that interned strings with static storage duration
+ * can still be destroyed during program exit.
+ */
+string_pool& pool()
+{
+  static auto* pool = new string_pool{};
+  return *pool;
+}
+
+void release(const std::string* str)
+{
+  {
+    auto& p = pool();
+    const auto lock = std::lock_guard{p.mutex};
+
+    // another thread may have replaced the expired entry already
+    if (const auto it = p.strings.find(*str);
+        it != p.strings.end() && it->first.data() == str->data())
+    {
+      p.strings.erase(it);
+    }
+  }
+  delete str;
+}
+
+std::shared_ptr<const std::string> intern(const std::string_view str)
+{
+  auto& p = pool();
+  const auto lock = std::lock_guard{p.mutex};
+
+  if (const auto it = p.strings.find(str); it != p.strings.end())
+  {
+    if (auto result = it->second.lock())
+    {
+      return result;
+    }
+    p.strings.erase(it);
+  }
+
+  auto result = std::shared_ptr<const std::string>{new std::string{str}, release};
+  p.strings.emplace(std::string_view{*result}, result);
+  return result;
+}
+
+} // namespace
+
+interned_string::interned_string()
+  : m_str{[]() {
+    static const auto empty = intern("");
+    return empty;
+  }()}
+{
+}
+
+interned_string::interned_string(const std::string_view str)
+  : m_str{intern(str)}
+{
+}
+
+const std::string& interned_string::str() const
+{
+  return *m_str;
+}
+
+bool interned_string::empty() const
+{
+  return m_str->empty();
+}
+
+bool operator==(const interned_string& lhs, const interned_string& rhs)
+{
+  return lhs.m_str == rhs.m_str;
+}
+
+std::strong_ordering operator<=>(const interned_string& lhs, const interned_string& rhs)
+{
+  return lhs.m_str == rhs.m_str ? std::strong_ordering::equal
+                                : *lhs.m_str <=> *rhs.m_str;
+}
+
+std::ostream& operator<<(std::ostream& lhs, const interned_string& rhs)
+{
+  return lhs << *rhs.m_str;
+}
+
+} // namespace kdl
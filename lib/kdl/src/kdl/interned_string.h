@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <compare>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace kdl
+{
+
+/**
+ * An immutable string that shares its storage with all other interned strings that are
+ * alive at the same time and have the same contents.
+ *
+ * Since equal strings share their storage, interned strings are compared for equality by
+ * comparing pointers. Copying an interned string does not copy its contents.
+ *
+ * Interned strings are kept in a global, thread safe pool and are removed from it when
+ * the last interned string referring to them is destroyed.
+ */
+class interned_string
+{
+private:
+  std::shared_ptr<const std::string> m_str;
+
+public:
+  /**
+   * Creates an empty interned string.
+   */
+  interned_string();
+
+  explicit interned_string(std::string_view str);
+
+  const std::string& str() const;
+
+  bool empty() const;
+
+  friend bool operator==(const interned_string& lhs, const interned_string& rhs);
+  friend std::strong_ordering operator<=>(
+    const interned_string& lhs, const interned_string& rhs);
+
+  friend std::ostream& operator<<(std::ostream& lhs, const interned_string& rhs);
+};
+
+} // namespace kdl
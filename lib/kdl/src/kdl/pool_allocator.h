@@ -0,0 +1,256 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl
+{
+
+/**
+ * A pool of fixed size memory blocks.
+ *
+ * Blocks are carved out of large slabs, so that allocating many small objects of the
+ * same size does not require a heap allocation per object, and objects allocated close
+ * in time end up close in memory.
+ *
+ * Each thread keeps a cache of free blocks which it allocates from and returns blocks to
+ * without synchronization. If a thread's cache runs empty, it takes a batch of free blocks
+ * from the shared pool or allocates a new slab. If a thread's cache grows too large, e.g.
+ * because it frees objects that were allocated by other threads, half of the cached blocks
+ * are returned to the shared pool. A thread returns all of its cached blocks to the shared
+ * pool when it exits.
+ *
+ * Slabs are never released, so the memory used by the pool does not shrink. The shared
+ * pool is intentionally leaked so that objects with static storage duration can still be
+ * freed during program exit.
+ *
+ * @tparam Size the size of a block
+ * @tparam Align the alignment of a block
+ */
+template <std::size_t Size, std::size_t Align>
+class block_pool
+{
+private:
+  union block
+  {
+    block* next;
+    alignas(Align) std::byte storage[Size];
+  };
+
+  static constexpr std::size_t SlabSize = 64 * 1024;
+  static constexpr std::size_t BlocksPerSlab =
+    std::max(std::size_t(32), SlabSize / sizeof(block));
+  static constexpr std::size_t MaxCachedBlocks = 2 * BlocksPerSlab;
+
+  struct free_list
+  {
+    block* head = nullptr;
+    std::size_t count = 0;
+
+    void push(block* b)
+    {
+      b->next = head;
+      head = b;
+      ++count;
+    }
+
+    block* pop()
+    {
+      auto* b = head;
+      head = b->next;
+      --count;
+      return b;
+    }
+
+    /**
+     * Moves up to the given number of blocks from this list to the given list.
+     */
+    void splice_to(free_list& other, const std::size_t n)
+    {
+      for (std::size_t i = 0; i < n && head; ++i)
+      {
+        other.push(pop());
+      }
+    }
+  };
+
+  struct shared_pool
+  {
+    std::mutex mutex;
+    free_list free_blocks;
+    std::vector<std::unique_ptr<block[]>> slabs;
+  };
+
+  struct thread_cache
+  {
+    free_list free_blocks;
+    bool exited = false;
+  };
+
+  /**
+   * Returns the calling thread's cached blocks to the shared pool when the thread exits.
+   * After that, blocks freed by the thread are returned to the shared pool directly.
+   */
+  struct thread_cache_guard
+  {
+    thread_cache_guard() = default;
+
+    thread_cache_guard(const thread_cache_guard&) = delete;
+    thread_cache_guard& operator=(const thread_cache_guard&) = delete;
+
+    ~thread_cache_guard()
+    {
+      auto& threadCache = cache();
+
+      auto& pool = shared();
+      const auto lock = std::lock_guard{pool.mutex};
+      threadCache.free_blocks.splice_to(pool.free_blocks, threadCache.free_blocks.count);
+      threadCache.exited = true;
+    }
+  };
+
+  static shared_pool& shared()
+  {
+    static auto* pool = new shared_pool{};
+    return *pool;
+  }
+
+  /**
+   * The cache is trivially destructible so that it remains usable after the guard
+   * has been destroyed.
+   */
+  static thread_cache& cache()
+  {
+    thread_local auto threadCache = thread_cache{};
+    return threadCache;
+  }
+
+  static void register_guard()
+  {
+    thread_local auto guard = thread_cache_guard{};
+    static_cast<void>(guard);
+  }
+
+  static void refill(free_list& free_blocks)
+  {
+    auto& pool = shared();
+    const auto lock = std::lock_guard{pool.mutex};
+
+    if (pool.free_blocks.count > 0)
+    {
+      pool.free_blocks.splice_to(free_blocks, BlocksPerSlab);
+      return;
+    }
+
+    auto slab = std::unique_ptr<block[]>{new block[BlocksPerSlab]};
+
+    // push in reverse order so that blocks are handed out in address order
+    for (std::size_t i = BlocksPerSlab; i > 0; --i)
+    {
+      free_blocks.push(&slab[i - 1]);
+    }
+    pool.slabs.push_back(std::move(slab));
+  }
+
+public:
+  /**
+   * Returns a block of `Size` bytes aligned to `Align`.
+   */
+  static void* allocate()
+  {
+    auto& threadCache = cache();
+    if (threadCache.free_blocks.count == 0)
+    {
+      if (threadCache.exited)
+      {
+        return ::operator new(sizeof(block), std::align_val_t{alignof(block)});
+      }
+      register_guard();
+      refill(threadCache.free_blocks);
+    }
+    return threadCache.free_blocks.pop()->storage;
+  }
+
+  /**
+   * Returns the given block to the pool. The block must have been obtained by calling
+   * allocate on this pool, but it may have been obtained by a different thread.
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    auto& threadCache = cache();
+    if (threadCache.exited)
+    {
+      auto& pool = shared();
+      const auto lock = std::lock_guard{pool.mutex};
+      pool.free_blocks.push(static_cast<block*>(ptr));
+      return;
+    }
+
+    auto& free_blocks = threadCache.free_blocks;
+    free_blocks.push(static_cast<block*>(ptr));
+    if (free_blocks.count > MaxCachedBlocks)
+    {
+      auto& pool = shared();
+      const auto lock = std::lock_guard{pool.mutex};
+      free_blocks.splice_to(pool.free_blocks, MaxCachedBlocks / 2);
+    }
+  }
+};
+
+/**
+ * Mixin that allocates objects of type T from a block_pool when they are created with
+ * new.
+ *
+ * Derive T from pool_allocated<T> to use it. Objects of types derived from T whose size
+ * differs from that of T are allocated with the global operator new.
+ *
+ * @tparam T the type of the objects to allocate
+ */
+template <typename T>
+class pool_allocated
+{
+public:
+  static void* operator new(const std::size_t size)
+  {
+    return size == sizeof(T) ? block_pool<sizeof(T), alignof(T)>::allocate()
+                             : ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, const std::size_t size) noexcept
+  {
+    if (size == sizeof(T))
+    {
+      block_pool<sizeof(T), alignof(T)>::deallocate(ptr);
+    }
+    else
+    {
+      ::operator delete(ptr);
+    }
+  }
+};
+
+} // namespace kdl
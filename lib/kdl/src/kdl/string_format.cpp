@@ -206,12 +206,15 @@ std::string str_escape_if_necessary(
 std::string str_unescape(
   const std::string_view str, const std::string_view chars, const char esc)
 {
-  if (str.empty())
+  // most strings don't contain any escape characters
+  if (str.find(esc) == std::string_view::npos)
   {
-    return "";
+    return std::string{str};
   }
 
-  auto buffer = std::stringstream{};
+  auto result = std::string{};
+  result.reserve(str.size());
+
   auto escaped = false;
   for (const auto c : str)
   {
@@ -219,7 +222,7 @@ std::string str_unescape(
     {
       if (escaped)
       {
-        buffer << c;
+        result.push_back(c);
       }
       escaped = !escaped;
     }
@@ -227,19 +230,19 @@ std::string str_unescape(
     {
       if (escaped && chars.find_first_of(c) == std::string::npos)
       {
-        buffer << '\\';
+        result.push_back('\\');
       }
-      buffer << c;
+      result.push_back(c);
       escaped = false;
     }
   }
 
   if (escaped)
   {
-    buffer << '\\';
+    result.push_back('\\');
   }
 
-  return buffer.str();
+  return result;
 }
 
 bool str_is_blank(const std::string_view str, const std::string_view whitespace)
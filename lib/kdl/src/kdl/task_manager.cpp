@@ -20,60 +20,255 @@
 
 #include "kdl/task_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <functional>
-#include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <ranges>
+#include <optional>
 #include <thread>
 #include <vector>
 
 namespace kdl
 {
+namespace
+{
 
-std::function<void()> task_manager::make_worker_func()
+struct worker_context
 {
-  return [&] {
-    while (true)
-    {
-      auto lock = std::unique_lock{m_pending_tasks_mutex};
-      m_pending_tasks_cv.wait(
-        lock, [&] { return !m_running || !m_pending_tasks.empty(); });
+  const task_manager* manager = nullptr;
+  std::size_t worker_index = 0;
+};
+
+thread_local auto current_worker = worker_context{};
+
+struct chunk_state
+{
+  std::size_t chunk_count;
+  std::function<void(std::size_t)> run_chunk;
+
+  std::atomic<std::size_t> next_chunk = 0;
+  std::atomic<std::size_t> finished_chunk_count = 0;
 
-      if (!m_running)
+  std::mutex mutex;
+  std::condition_variable finished_cv;
+  std::exception_ptr exception;
+
+  chunk_state(const std::size_t chunk_count_, std::function<void(std::size_t)> run_chunk_)
+    : chunk_count{chunk_count_}
+    , run_chunk{std::move(run_chunk_)}
+  {
+  }
+};
+
+void claim_and_run_chunks(chunk_state& state)
+{
+  for (auto chunk = state.next_chunk++; chunk < state.chunk_count;
+       chunk = state.next_chunk++)
+  {
+    try
+    {
+      state.run_chunk(chunk);
+    }
+    catch (...)
+    {
+      auto lock = std::lock_guard{state.mutex};
+      if (!state.exception)
       {
-        break;
+        state.exception = std::current_exception();
       }
+    }
 
-      if (!m_pending_tasks.empty())
-      {
-        auto task = std::move(m_pending_tasks.front());
-        m_pending_tasks.pop();
-        lock.unlock();
+    if (++state.finished_chunk_count == state.chunk_count)
+    {
+      auto lock = std::lock_guard{state.mutex};
+      state.finished_cv.notify_all();
+    }
+  }
+}
 
-        task();
-      }
+} // namespace
+
+void task_manager::run_worker(const std::size_t worker_index)
+{
+  current_worker = worker_context{this, worker_index};
+
+  while (m_running)
+  {
+    if (auto task = pop_task(worker_index))
+    {
+      (*task)();
+      continue;
+    }
+
+    auto lock = std::unique_lock{m_idle_mutex};
+    ++m_idle_worker_count;
+    m_idle_cv.wait(lock, [&] { return !m_running || m_pending_task_count > 0; });
+    --m_idle_worker_count;
+  }
+}
+
+std::optional<task_manager::pending_task> task_manager::pop_task(
+  const std::size_t worker_index)
+{
+  // take the newest task from our own queue, it's most likely to be cache hot
+  {
+    auto& queue = *m_queues[worker_index];
+    auto lock = std::lock_guard{queue.mutex};
+    if (!queue.tasks.empty())
+    {
+      auto task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --m_pending_task_count;
+      return task;
+    }
+  }
+
+  // steal the oldest task from another queue
+  for (std::size_t i = 1; i < m_queues.size(); ++i)
+  {
+    auto& queue = *m_queues[(worker_index + i) % m_queues.size()];
+    auto lock = std::lock_guard{queue.mutex};
+    if (!queue.tasks.empty())
+    {
+      auto task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --m_pending_task_count;
+      return task;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::size_t task_manager::queue_index_for_submission()
+{
+  return current_worker.manager == this ? current_worker.worker_index
+                                        : m_next_queue++ % m_queues.size();
+}
+
+void task_manager::push_task(pending_task task)
+{
+  // count the task before it becomes visible so that the counter never underflows
+  ++m_pending_task_count;
+
+  auto& queue = *m_queues[queue_index_for_submission()];
+  {
+    auto lock = std::lock_guard{queue.mutex};
+    queue.tasks.push_back(std::move(task));
+  }
+
+  notify_workers(1);
+}
+
+void task_manager::push_tasks(std::vector<pending_task> tasks)
+{
+  if (tasks.empty())
+  {
+    return;
+  }
+
+  const auto task_count = tasks.size();
+  m_pending_task_count += task_count;
+
+  // distribute the tasks over the queues in contiguous blocks
+  const auto first_queue = queue_index_for_submission();
+  const auto block_size = (task_count + m_queues.size() - 1) / m_queues.size();
+  for (std::size_t i = 0, first = 0; first < task_count; ++i, first += block_size)
+  {
+    const auto last = std::min(first + block_size, task_count);
+    auto& queue = *m_queues[(first_queue + i) % m_queues.size()];
+
+    auto lock = std::lock_guard{queue.mutex};
+    std::move(
+      tasks.begin() + static_cast<std::ptrdiff_t>(first),
+      tasks.begin() + static_cast<std::ptrdiff_t>(last),
+      std::back_inserter(queue.tasks));
+  }
+
+  notify_workers(task_count);
+}
+
+void task_manager::notify_workers(const std::size_t task_count)
+{
+  // The pending task count was incremented before this check, and an idle worker
+  // increments the idle worker count before checking the pending task count, so either
+  // the worker sees the new tasks or we see the idle worker.
+  if (m_idle_worker_count > 0)
+  {
+    auto lock = std::lock_guard{m_idle_mutex};
+    if (task_count == 1)
+    {
+      m_idle_cv.notify_one();
     }
-  };
+    else
+    {
+      m_idle_cv.notify_all();
+    }
+  }
+}
+
+std::size_t task_manager::default_chunk_size(const std::size_t count) const
+{
+  // give every thread several chunks so that uneven chunks can be balanced
+  const auto chunk_count = (m_workers.size() + 1) * 4;
+  return std::max((count + chunk_count - 1) / chunk_count, std::size_t(1));
+}
+
+void task_manager::run_chunks(
+  const std::size_t chunk_count, std::function<void(std::size_t)> run_chunk)
+{
+  auto state = std::make_shared<chunk_state>(chunk_count, std::move(run_chunk));
+
+  // The calling thread claims chunks too, so we need at most chunk_count - 1 helpers. A
+  // helper that starts late finds no chunks left and returns without touching run_chunk.
+  const auto helper_count = std::min(m_workers.size(), chunk_count - 1);
+  if (helper_count > 0)
+  {
+    auto helpers = std::vector<pending_task>{};
+    helpers.reserve(helper_count);
+    for (std::size_t i = 0; i < helper_count; ++i)
+    {
+      helpers.emplace_back([state] { claim_and_run_chunks(*state); });
+    }
+    push_tasks(std::move(helpers));
+  }
+
+  claim_and_run_chunks(*state);
+
+  auto lock = std::unique_lock{state->mutex};
+  state->finished_cv.wait(
+    lock, [&] { return state->finished_chunk_count == state->chunk_count; });
+
+  if (state->exception)
+  {
+    std::rethrow_exception(state->exception);
+  }
 }
 
 task_manager::task_manager(const std::size_t max_concurrent_tasks)
 {
   for (size_t i = 0; i < max_concurrent_tasks; ++i)
   {
-    m_workers.emplace_back(make_worker_func());
+    m_queues.push_back(std::make_unique<worker_queue>());
+  }
+
+  for (size_t i = 0; i < max_concurrent_tasks; ++i)
+  {
+    m_workers.emplace_back([&, i] { run_worker(i); });
   }
 }
 
 task_manager::~task_manager()
 {
   {
-    auto lock = std::lock_guard{m_pending_tasks_mutex};
+    auto lock = std::lock_guard{m_idle_mutex};
     m_running = false;
   }
 
-  m_pending_tasks_cv.notify_all();
+  m_idle_cv.notify_all();
   for (auto& worker : m_workers)
   {
     worker.join();
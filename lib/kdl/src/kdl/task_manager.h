@@ -22,31 +22,84 @@
 
 #include "kdl/ranges/to.h"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <ranges>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace kdl
 {
 
+/**
+ * Runs tasks on a pool of worker threads.
+ *
+ * Every worker owns a task queue. Tasks submitted by a worker are pushed to that worker's
+ * queue, and tasks submitted by other threads are distributed over the queues in a
+ * round-robin fashion. A worker takes the most recently added task from its own queue,
+ * and if its queue is empty, it steals the oldest task from another worker's queue. Idle
+ * workers sleep until new tasks are submitted.
+ *
+ * Use parallel_for and run_tasks_and_wait to run many small tasks, since these submit at
+ * most one task per worker and let the workers claim chunks of work on their own.
+ */
 class task_manager
 {
 private:
   using pending_task = std::function<void()>;
 
+  struct worker_queue
+  {
+    std::mutex mutex;
+    std::deque<pending_task> tasks;
+  };
+
+  std::vector<std::unique_ptr<worker_queue>> m_queues;
   std::vector<std::thread> m_workers;
 
-  std::mutex m_pending_tasks_mutex;
-  std::condition_variable m_pending_tasks_cv;
-  std::queue<pending_task> m_pending_tasks;
-  bool m_running = true;
+  std::atomic<std::size_t> m_pending_task_count = 0;
+  std::atomic<std::size_t> m_next_queue = 0;
+  std::atomic<std::size_t> m_idle_worker_count = 0;
+  std::atomic<bool> m_running = true;
+
+  std::mutex m_idle_mutex;
+  std::condition_variable m_idle_cv;
+
+  void run_worker(std::size_t worker_index);
+  std::optional<pending_task> pop_task(std::size_t worker_index);
+
+  std::size_t queue_index_for_submission();
+  void push_task(pending_task task);
+  void push_tasks(std::vector<pending_task> tasks);
+  void notify_workers(std::size_t task_count);
 
-  std::function<void()> make_worker_func();
+  std::size_t default_chunk_size(std::size_t count) const;
+  void run_chunks(std::size_t chunk_count, std::function<void(std::size_t)> run_chunk);
+
+  template <typename task_result>
+  static pending_task make_pending_task(
+    std::function<task_result()> task, std::shared_ptr<std::promise<task_result>> promise)
+  {
+    return [task_ = std::move(task), promise_ = std::move(promise)]() {
+      try
+      {
+        promise_->set_value(task_());
+      }
+      catch (...)
+      {
+        promise_->set_exception(std::current_exception());
+      }
+    };
+  }
 
 public:
   explicit task_manager(
@@ -67,33 +120,94 @@ public:
     auto promise = std::make_shared<std::promise<task_result>>();
     auto future = promise->get_future();
 
-    {
-      auto lock = std::lock_guard{m_pending_tasks_mutex};
-      m_pending_tasks.push([&, task_ = std::move(task), promise_ = std::move(promise)]() {
-        promise_->set_value(task_());
-      });
-    }
-    m_pending_tasks_cv.notify_one();
-
+    push_task(make_pending_task(std::move(task), std::move(promise)));
     return future;
   }
 
   template <std::ranges::range range>
   auto run_tasks(range tasks)
   {
-    return tasks | std::views::transform([&](auto&& task) {
-             return run_task(std::forward<decltype(task)>(task));
-           })
-           | kdl::ranges::to<std::vector>();
+    using task_type = std::ranges::range_value_t<range>;
+    using task_result = std::invoke_result_t<task_type&>;
+
+    auto futures = std::vector<std::future<task_result>>{};
+
+    if (m_workers.empty())
+    {
+      for (auto&& task : tasks)
+      {
+        futures.push_back(run_task(std::function<task_result()>{task}));
+      }
+      return futures;
+    }
+
+    auto pending_tasks = std::vector<pending_task>{};
+    for (auto&& task : tasks)
+    {
+      auto promise = std::make_shared<std::promise<task_result>>();
+      futures.push_back(promise->get_future());
+      pending_tasks.push_back(make_pending_task(
+        std::function<task_result()>{std::forward<decltype(task)>(task)},
+        std::move(promise)));
+    }
+
+    push_tasks(std::move(pending_tasks));
+    return futures;
   }
 
   template <std::ranges::range range>
   auto run_tasks_and_wait(range&& tasks)
   {
-    auto futures = run_tasks(std::forward<range>(tasks));
-    return futures | std::views::transform([](auto& future) { return future.get(); })
+    auto tasks_ = std::forward<range>(tasks) | kdl::ranges::to<std::vector>();
+
+    using task_type = std::ranges::range_value_t<decltype(tasks_)>;
+    using task_result = std::invoke_result_t<task_type&>;
+
+    auto results = std::vector<std::optional<task_result>>(tasks_.size());
+    parallel_for(
+      tasks_.size(), [&](const std::size_t i) { results[i].emplace(tasks_[i]()); });
+
+    return results | std::views::transform([](auto& result) {
+             return std::move(*result);
+           })
            | kdl::ranges::to<std::vector>();
   }
+
+  /**
+   * Calls f for every index in [0, count) and waits until all calls have returned.
+   *
+   * The indices are split into chunks of the given size, and the workers and the calling
+   * thread claim chunks until none are left. If chunk_size is 0, a chunk size is chosen
+   * so that every worker gets several chunks.
+   *
+   * If any call to f throws an exception, the remaining chunks are still processed and
+   * the first exception is rethrown once all calls have returned.
+   *
+   * This function may be called from within a task.
+   */
+  template <typename F>
+  void parallel_for(const std::size_t count, F&& f, std::size_t chunk_size = 0)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+
+    if (chunk_size == 0)
+    {
+      chunk_size = default_chunk_size(count);
+    }
+
+    const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+    run_chunks(chunk_count, [&, count, chunk_size](const std::size_t chunk) {
+      const auto first = chunk * chunk_size;
+      const auto last = std::min(first + chunk_size, count);
+      for (auto i = first; i < last; ++i)
+      {
+        f(i);
+      }
+    });
+  }
 };
 
 } // namespace kdl
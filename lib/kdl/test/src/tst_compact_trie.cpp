@@ -80,6 +80,29 @@ TEST_CASE("compact_trie_test.insert")
   assertMatches(index, "*", {"value", "value", "value2", "value3", "value4", "value4"});
 }
 
+TEST_CASE("compact_trie_test.insert_bulk")
+{
+  test_index index;
+  index.insert({
+    {"test", "value4"},
+    {"key22", "value2"},
+    {"key", "value"},
+    {"k1", "value3"},
+    {"key2", "value"},
+    {"key", "value"},
+  });
+
+  assertMatches(index, "key", {"value", "value"});
+  assertMatches(index, "key%*", {"value", "value", "value", "value2"});
+  assertMatches(index, "k%", {"value3"});
+  assertMatches(index, "test", {"value4"});
+  assertMatches(index, "*", {"value", "value", "value", "value2", "value3", "value4"});
+
+  auto keys = std::vector<std::string>{};
+  index.get_keys(std::back_inserter(keys));
+  CHECK(keys == std::vector<std::string>{"k1", "key", "key2", "key22", "test"});
+}
+
 TEST_CASE("compact_trie_test.remove")
 {
   test_index index;
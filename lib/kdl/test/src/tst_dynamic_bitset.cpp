@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/dynamic_bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+
+namespace kdl
+{
+
+TEST_CASE("dynamic_bitset")
+{
+  SECTION("operator[]")
+  {
+    auto b = dynamic_bitset{};
+    CHECK(b.size() == 64);
+    CHECK_FALSE(std::as_const(b)[0]);
+    CHECK_FALSE(std::as_const(b)[200]);
+
+    b[3] = true;
+    b[200] = true;
+    CHECK(b.size() == 256);
+    CHECK(std::as_const(b)[3]);
+    CHECK(std::as_const(b)[200]);
+    CHECK_FALSE(std::as_const(b)[4]);
+
+    b[3] = false;
+    CHECK_FALSE(std::as_const(b)[3]);
+
+    b[5] = b[200];
+    CHECK(std::as_const(b)[5]);
+  }
+
+  SECTION("reset")
+  {
+    auto b = dynamic_bitset{};
+    b[1] = true;
+    b[300] = true;
+    b.reset();
+
+    CHECK(b.size() == 64);
+    CHECK(b.none());
+  }
+
+  SECTION("count, any, none")
+  {
+    auto b = dynamic_bitset{};
+    CHECK(b.count() == 0);
+    CHECK_FALSE(b.any());
+    CHECK(b.none());
+
+    b[0] = true;
+    b[63] = true;
+    b[64] = true;
+    b[1000] = true;
+    CHECK(b.count() == 4);
+    CHECK(b.any());
+    CHECK_FALSE(b.none());
+  }
+
+  SECTION("find_first, find_next")
+  {
+    auto b = dynamic_bitset{};
+    CHECK(b.find_first() == dynamic_bitset::npos);
+
+    b[2] = true;
+    b[63] = true;
+    b[64] = true;
+    b[500] = true;
+
+    CHECK(b.find_first() == 2);
+    CHECK(b.find_next(2) == 63);
+    CHECK(b.find_next(63) == 64);
+    CHECK(b.find_next(64) == 500);
+    CHECK(b.find_next(500) == dynamic_bitset::npos);
+    CHECK(b.find_next(10000) == dynamic_bitset::npos);
+    CHECK(b.find_next(dynamic_bitset::npos) == dynamic_bitset::npos);
+  }
+
+  SECTION("set operations")
+  {
+    auto lhs = dynamic_bitset{};
+    lhs[1] = true;
+    lhs[2] = true;
+    lhs[100] = true;
+
+    auto rhs = dynamic_bitset{};
+    rhs[2] = true;
+    rhs[3] = true;
+    rhs[300] = true;
+
+    auto expectedIntersection = dynamic_bitset{};
+    expectedIntersection[2] = true;
+    CHECK((lhs & rhs) == expectedIntersection);
+    CHECK((rhs & lhs) == expectedIntersection);
+
+    auto expectedUnion = dynamic_bitset{};
+    expectedUnion[1] = true;
+    expectedUnion[2] = true;
+    expectedUnion[3] = true;
+    expectedUnion[100] = true;
+    expectedUnion[300] = true;
+    CHECK((lhs | rhs) == expectedUnion);
+    CHECK((rhs | lhs) == expectedUnion);
+
+    auto expectedDifference = dynamic_bitset{};
+    expectedDifference[1] = true;
+    expectedDifference[100] = true;
+    CHECK((lhs - rhs) == expectedDifference);
+  }
+
+  SECTION("operator==")
+  {
+    auto lhs = dynamic_bitset{};
+    auto rhs = dynamic_bitset{1000};
+    CHECK(lhs == rhs);
+
+    lhs[10] = true;
+    CHECK(lhs != rhs);
+
+    rhs[10] = true;
+    CHECK(lhs == rhs);
+
+    rhs[900] = true;
+    CHECK(lhs != rhs);
+  }
+}
+
+} // namespace kdl
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "kdl/intern_pool.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace kdl
+{
+
+TEST_CASE("intern_pool")
+{
+  auto pool = intern_pool<std::string>{};
+
+  SECTION("equal values share their storage")
+  {
+    const auto s1 = pool.intern("classname");
+    const auto s2 = pool.intern(std::string{"class"} + "name");
+    const auto s3 = pool.intern("origin");
+
+    CHECK(*s1 == "classname");
+    CHECK(s1 == s2);
+    CHECK(s1 != s3);
+    CHECK(pool.size() == 2);
+  }
+
+  SECTION("make_value is only called for new values")
+  {
+    auto calls = 0;
+    const auto makeValue = [&]() {
+      ++calls;
+      return std::string{"classname"};
+    };
+
+    const auto s1 = pool.intern("classname", makeValue);
+    const auto s2 = pool.intern("classname", makeValue);
+
+    CHECK(s1 == s2);
+    CHECK(calls == 1);
+  }
+
+  SECTION("values are removed from the pool when they are no longer used")
+  {
+    auto s = std::optional{pool.intern("some unique string")};
+    REQUIRE(pool.size() == 1);
+
+    s.reset();
+    CHECK(pool.size() == 0);
+  }
+
+  SECTION("values outlive the pool")
+  {
+    auto otherPool = std::optional{intern_pool<std::string>{}};
+    const auto s = otherPool->intern("classname");
+
+    otherPool.reset();
+    CHECK(*s == "classname");
+  }
+
+  SECTION("concurrent interning")
+  {
+    constexpr auto ThreadCount = 4;
+    constexpr auto ValueCount = 1000;
+
+    auto results = std::vector<std::vector<std::shared_ptr<const std::string>>>(
+      ThreadCount);
+    auto threads = std::vector<std::thread>{};
+    for (size_t t = 0; t < ThreadCount; ++t)
+    {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < ValueCount; ++i)
+        {
+          // create and release values to exercise removal from the pool, too
+          const auto temp = pool.intern(std::to_string(i + ValueCount));
+          results[t].push_back(pool.intern(std::to_string(i)));
+        }
+      });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (size_t t = 1; t < ThreadCount; ++t)
+    {
+      CHECK(results[t] == results[0]);
+    }
+    CHECK(pool.size() == ValueCount);
+  }
+}
+
+} // namespace kdl
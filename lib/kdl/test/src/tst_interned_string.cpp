@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/interned_string.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace kdl
+{
+
+TEST_CASE("interned_string")
+{
+  SECTION("default constructor")
+  {
+    CHECK(interned_string{}.empty());
+    CHECK(interned_string{}.str() == "");
+    CHECK(interned_string{} == interned_string{""});
+  }
+
+  SECTION("equal strings share their storage")
+  {
+    const auto s1 = interned_string{"classname"};
+    const auto s2 = interned_string{std::string{"class"} + "name"};
+    const auto s3 = interned_string{"origin"};
+
+    CHECK(s1.str() == "classname");
+    CHECK(&s1.str() == &s2.str());
+    CHECK(s1 == s2);
+    CHECK(s1 != s3);
+  }
+
+  SECTION("strings are removed from the pool when they are no longer used")
+  {
+    auto s = std::optional<interned_string>{interned_string{"some unique string"}};
+    s.reset();
+
+    const auto t = interned_string{"some unique string"};
+    CHECK(t.str() == "some unique string");
+    CHECK(t == interned_string{"some unique string"});
+  }
+
+  SECTION("ordering")
+  {
+    CHECK(interned_string{"a"} < interned_string{"b"});
+    CHECK(interned_string{"b"} > interned_string{"a"});
+    CHECK(interned_string{"a"} <= interned_string{"a"});
+  }
+
+  SECTION("concurrent interning")
+  {
+    constexpr auto ThreadCount = 4;
+    constexpr auto StringCount = 1000;
+
+    auto results = std::vector<std::vector<interned_string>>(ThreadCount);
+    auto threads = std::vector<std::thread>{};
+    for (size_t t = 0; t < ThreadCount; ++t)
+    {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < StringCount; ++i)
+        {
+          // create and destroy strings to exercise removal from the pool, too
+          const auto temp = interned_string{std::to_string(i + StringCount)};
+          results[t].emplace_back(std::to_string(i));
+        }
+      });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (size_t t = 1; t < ThreadCount; ++t)
+    {
+      CHECK(results[t] == results[0]);
+    }
+  }
+}
+
+} // namespace kdl
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/pool_allocator.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace kdl
+{
+namespace
+{
+
+struct pooled : public pool_allocated<pooled>
+{
+  double x;
+  int i;
+
+  explicit pooled(const int i_)
+    : x{double(i_)}
+    , i{i_}
+  {
+  }
+};
+
+struct derived_pooled : public pooled
+{
+  double y[4];
+
+  derived_pooled()
+    : pooled{7}
+  {
+  }
+};
+
+struct alignas(32) aligned_pooled : public pool_allocated<aligned_pooled>
+{
+  char c;
+};
+
+} // namespace
+
+TEST_CASE("pool_allocator")
+{
+  SECTION("allocates distinct objects")
+  {
+    auto objects = std::vector<pooled*>{};
+    for (int i = 0; i < 10000; ++i)
+    {
+      objects.push_back(new pooled{i});
+    }
+
+    for (int i = 0; i < 10000; ++i)
+    {
+      CHECK(objects[size_t(i)]->i == i);
+      CHECK(objects[size_t(i)]->x == double(i));
+    }
+
+    for (auto* object : objects)
+    {
+      delete object;
+    }
+  }
+
+  SECTION("respects alignment")
+  {
+    auto objects = std::vector<aligned_pooled*>{};
+    for (int i = 0; i < 100; ++i)
+    {
+      auto* object = new aligned_pooled{};
+      CHECK(reinterpret_cast<std::uintptr_t>(object) % 32 == 0);
+      objects.push_back(object);
+    }
+
+    for (auto* object : objects)
+    {
+      delete object;
+    }
+  }
+
+  SECTION("allocates derived types with a different size")
+  {
+    auto* object = new derived_pooled{};
+    CHECK(object->i == 7);
+    delete object;
+  }
+
+  SECTION("frees objects allocated by another thread")
+  {
+    auto objects = std::vector<pooled*>{};
+    auto thread = std::thread{[&]() {
+      for (int i = 0; i < 10000; ++i)
+      {
+        objects.push_back(new pooled{i});
+      }
+    }};
+    thread.join();
+
+    for (int i = 0; i < 10000; ++i)
+    {
+      CHECK(objects[size_t(i)]->i == i);
+    }
+
+    for (auto* object : objects)
+    {
+      delete object;
+    }
+  }
+}
+
+} // namespace kdl
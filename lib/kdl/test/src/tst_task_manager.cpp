@@ -22,8 +22,12 @@
 #include "kdl/ranges/to.h"
 #include "kdl/task_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -125,6 +129,82 @@ TEST_CASE("task_manager")
     CHECK(task_ran2);
     CHECK(task_ran3);
   }
+
+  SECTION("run_task propagates exceptions")
+  {
+    if (max_concurrent_tasks > 0)
+    {
+      auto future = tm.run_task(std::function<int()>{[]() -> int {
+        throw std::runtime_error{"asdf"};
+      }});
+      CHECK_THROWS_AS(future.get(), std::runtime_error);
+    }
+  }
+
+  SECTION("run_task from within a task")
+  {
+    auto future = tm.run_task(std::function<std::future<int>()>{[&]() {
+      return tm.run_task(std::function<int()>{[]() { return 7; }});
+    }});
+    CHECK(future.get().get() == 7);
+  }
+
+  SECTION("parallel_for")
+  {
+    const auto count = GENERATE(0u, 1u, 7u, 1000u);
+    const auto chunk_size = GENERATE(0u, 1u, 3u, 2000u);
+    CAPTURE(count, chunk_size);
+
+    auto calls = std::vector<std::atomic<int>>(count);
+    tm.parallel_for(
+      count, [&](const std::size_t i) { ++calls[i]; }, chunk_size);
+
+    CHECK(std::ranges::all_of(calls, [](const auto& c) { return c == 1; }));
+  }
+
+  SECTION("parallel_for rethrows the first exception")
+  {
+    auto calls = std::atomic<int>{0};
+    CHECK_THROWS_AS(
+      tm.parallel_for(
+        100,
+        [&](const std::size_t i) {
+          ++calls;
+          if (i == 42)
+          {
+            throw std::runtime_error{"asdf"};
+          }
+        },
+        1),
+      std::runtime_error);
+
+    // the remaining chunks are still processed
+    CHECK(calls == 100);
+  }
+
+  SECTION("nested parallel_for")
+  {
+    auto calls = std::vector<std::atomic<int>>(100 * 100);
+    tm.parallel_for(100, [&](const std::size_t i) {
+      tm.parallel_for(100, [&](const std::size_t j) { ++calls[i * 100 + j]; });
+    });
+
+    CHECK(std::ranges::all_of(calls, [](const auto& c) { return c == 1; }));
+  }
+
+  SECTION("run_tasks_and_wait with many tasks")
+  {
+    auto tasks = std::views::iota(0, 10000) | std::views::transform([](const int i) {
+                   return std::function{[i]() { return i * 2; }};
+                 });
+
+    const auto results = tm.run_tasks_and_wait(tasks);
+    REQUIRE(results.size() == 10000u);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      CHECK(results[i] == int(i) * 2);
+    }
+  }
 }
 
 TEST_CASE("task_manager stress test")
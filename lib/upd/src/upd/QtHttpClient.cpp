@@ -25,9 +25,15 @@
 #include <QNetworkRequest>
 #include <QStandardPaths>
 #include <QTemporaryFile>
+#include <QTimer>
 #include <QUrl>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <vector>
 
 
 namespace upd
@@ -85,27 +91,60 @@ public:
   }
 };
 
-class QtHttpDownload : public QtHttpOperation
+/**
+ * Downloads a file in several chunks in parallel if the server supports range requests.
+ * A chunk that fails is requested again from where it stopped, so a flaky connection
+ * doesn't restart the entire download. If the server doesn't support range requests,
+ * the file is downloaded in a single request that restarts from the beginning on
+ * failure.
+ */
+class QtHttpDownload : public HttpOperation
 {
 private:
+  static constexpr auto MaxChunkCount = qint64(4);
+  static constexpr auto MinChunkSize = qint64(1024 * 1024);
+  static constexpr auto MaxRetries = 5;
+  static constexpr auto RetryDelay = std::chrono::seconds{2};
+
+  struct Chunk
+  {
+    qint64 begin = 0;
+    // exclusive, or -1 if the size of the file is unknown
+    qint64 end = -1;
+    qint64 received = 0;
+    int retries = 0;
+    bool complete = false;
+    QNetworkReply* reply = nullptr;
+  };
+
+  QNetworkAccessManager& m_networkManager;
+  QUrl m_url;
   HttpClient::DownloadCallback m_downloadCallback;
   HttpClient::ErrorCallback m_errorCallback;
-  std::optional<float> m_progress;
+
+  QNetworkReply* m_headReply = nullptr;
+  std::vector<Chunk> m_chunks;
+  qint64 m_size = -1;
+  bool m_ranged = false;
+  bool m_done = false;
 
   QTemporaryFile m_file;
 
 public:
   explicit QtHttpDownload(
-    QNetworkReply* reply,
+    QNetworkAccessManager& networkManager,
+    QUrl url,
     HttpClient::DownloadCallback downloadCallback,
     HttpClient::ErrorCallback errorCallback)
-    : QtHttpOperation{reply}
+    : HttpOperation{&networkManager}
+    , m_networkManager{networkManager}
+    , m_url{std::move(url)}
     , m_downloadCallback{std::move(downloadCallback)}
     , m_errorCallback{std::move(errorCallback)}
   {
     const auto tempDirectory =
       QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    const auto fileInfo = QFileInfo{reply->url().fileName()};
+    const auto fileInfo = QFileInfo{m_url.fileName()};
     const auto baseName = fileInfo.baseName();
     const auto extension = fileInfo.suffix();
 
@@ -113,35 +152,232 @@ public:
       QString{"%1/%2-XXXXXX.%3"}.arg(tempDirectory).arg(baseName).arg(extension));
     m_file.open();
 
-    connect(m_reply, &QNetworkReply::finished, [this] {
-      m_reply->deleteLater();
+    // find out the size of the file and whether the server accepts range requests
+    m_headReply = m_networkManager.head(QNetworkRequest{m_url});
+    connect(m_headReply, &QNetworkReply::finished, this, [this] { headFinished(); });
+  }
+
+  void cancel() override
+  {
+    if (!m_done)
+    {
+      m_done = true;
+      abortReplies();
       m_file.close();
+      deleteLater();
+    }
+  }
 
-      if (m_reply->error() == QNetworkReply::NoError)
-      {
-        m_file.setAutoRemove(false);
-        m_downloadCallback(m_file);
-      }
-      else if (m_reply->error() != QNetworkReply::OperationCanceledError)
+  std::optional<float> progress() const override
+  {
+    if (m_size <= 0)
+    {
+      return std::nullopt;
+    }
+
+    auto received = qint64(0);
+    for (const auto& chunk : m_chunks)
+    {
+      received += chunk.received;
+    }
+    return static_cast<float>(received) / static_cast<float>(m_size);
+  }
+
+private:
+  void headFinished()
+  {
+    auto* reply = std::exchange(m_headReply, nullptr);
+    reply->deleteLater();
+
+    if (m_done)
+    {
+      return;
+    }
+
+    // if the HEAD request fails, fall back to downloading the file in a single request
+    if (reply->error() == QNetworkReply::NoError)
+    {
+      const auto contentLength = reply->header(QNetworkRequest::ContentLengthHeader);
+      m_size = contentLength.isValid() ? contentLength.toLongLong() : -1;
+      m_ranged = m_size > 0 && reply->rawHeader("Accept-Ranges").contains("bytes");
+    }
+
+    const auto chunkCount =
+      m_ranged ? std::clamp(m_size / MinChunkSize, qint64(1), MaxChunkCount) : qint64(1);
+    for (qint64 i = 0; i < chunkCount; ++i)
+    {
+      m_chunks.push_back(
+        m_ranged ? Chunk{m_size * i / chunkCount, m_size * (i + 1) / chunkCount}
+                 : Chunk{});
+    }
+
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+      startChunk(i);
+    }
+  }
+
+  void startChunk(const size_t i)
+  {
+    auto& chunk = m_chunks[i];
+
+    auto request = QNetworkRequest{m_url};
+    if (m_ranged)
+    {
+      request.setRawHeader(
+        "Range",
+        QString{"bytes=%1-%2"}
+          .arg(chunk.begin + chunk.received)
+          .arg(chunk.end - 1)
+          .toLatin1());
+    }
+    else
+    {
+      // the download can only be restarted from the beginning
+      chunk.received = 0;
+      m_file.resize(0);
+    }
+
+    chunk.reply = m_networkManager.get(request);
+    connect(chunk.reply, &QNetworkReply::readyRead, this, [this, i] {
+      if (!m_done && !writeAvailableData(i))
       {
-        m_errorCallback(formatError(*m_reply));
+        fail(QString{"Could not write to %1"}.arg(m_file.fileName()));
       }
     });
+    connect(chunk.reply, &QNetworkReply::finished, this, [this, i] { chunkFinished(i); });
     connect(
-      m_reply,
+      chunk.reply,
       &QNetworkReply::downloadProgress,
-      [this](const qint64 bytesReceived, const qint64 bytesTotal) {
-        m_progress = static_cast<float>(bytesReceived) / static_cast<float>(bytesTotal);
+      this,
+      [this](const qint64, const qint64 bytesTotal) {
+        if (!m_ranged && bytesTotal > 0)
+        {
+          m_size = bytesTotal;
+        }
       });
-    connect(m_reply, &QNetworkReply::readyRead, [this] {
-      if (m_file.write(m_reply->readAll()) == -1)
+  }
+
+  bool writeAvailableData(const size_t i)
+  {
+    auto& chunk = m_chunks[i];
+
+    const auto status = statusCode(*chunk.reply);
+    if (status != 200 && status != 206)
+    {
+      // the body of an error response is not part of the file
+      return true;
+    }
+    if (m_ranged && status != 206)
+    {
+      // the server ignored the range, writing the data would corrupt the file
+      return false;
+    }
+
+    const auto data = chunk.reply->readAll();
+    if (
+      !m_file.seek(chunk.begin + chunk.received) || m_file.write(data) != data.size())
+    {
+      return false;
+    }
+
+    chunk.received += data.size();
+    return true;
+  }
+
+  void chunkFinished(const size_t i)
+  {
+    auto& chunk = m_chunks[i];
+    chunk.reply->deleteLater();
+
+    if (m_done)
+    {
+      chunk.reply = nullptr;
+      return;
+    }
+
+    // write the data that arrived after the last readyRead signal
+    const auto written = writeAvailableData(i);
+    const auto error = chunk.reply->error();
+    const auto status = statusCode(*chunk.reply);
+    const auto errorMessage =
+      error != QNetworkReply::NoError
+        ? formatError(*chunk.reply)
+        : QString{"Download of %1 ended prematurely"}.arg(m_url.toString());
+    chunk.reply = nullptr;
+
+    if (!written)
+    {
+      fail(QString{"Could not write to %1"}.arg(m_file.fileName()));
+      return;
+    }
+
+    if (
+      error == QNetworkReply::NoError
+      && (!m_ranged || chunk.received == chunk.end - chunk.begin))
+    {
+      chunk.complete = true;
+      if (std::ranges::all_of(m_chunks, [](const auto& c) { return c.complete; }))
+      {
+        succeed();
+      }
+      return;
+    }
+
+    // client errors such as a missing file won't go away by retrying
+    if (chunk.retries == MaxRetries || (status >= 400 && status < 500))
+    {
+      fail(errorMessage);
+      return;
+    }
+
+    // wait a little longer with every attempt
+    ++chunk.retries;
+    QTimer::singleShot(RetryDelay * chunk.retries, this, [this, i] {
+      if (!m_done)
       {
-        m_reply->abort();
+        startChunk(i);
       }
     });
   }
 
-  std::optional<float> progress() const override { return m_progress; }
+  void succeed()
+  {
+    m_done = true;
+    m_file.close();
+    m_file.setAutoRemove(false);
+    m_downloadCallback(m_file);
+    deleteLater();
+  }
+
+  void fail(const QString& error)
+  {
+    m_done = true;
+    abortReplies();
+    m_file.close();
+    m_errorCallback(error);
+    deleteLater();
+  }
+
+  void abortReplies()
+  {
+    if (m_headReply)
+    {
+      m_headReply->abort();
+    }
+    for (auto& chunk : m_chunks)
+    {
+      if (chunk.reply)
+      {
+        chunk.reply->abort();
+      }
+    }
+  }
+
+  static int statusCode(const QNetworkReply& reply)
+  {
+    return reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  }
 };
 
 } // namespace
@@ -165,9 +401,7 @@ HttpOperation* QtHttpClient::download(
   const QUrl& url, DownloadCallback downloadCallback, ErrorCallback errorCallback) const
 {
   return new QtHttpDownload{
-    m_networkManager.get(QNetworkRequest{url}),
-    std::move(downloadCallback),
-    std::move(errorCallback)};
+    m_networkManager, url, std::move(downloadCallback), std::move(errorCallback)};
 }
 
 } // namespace upd
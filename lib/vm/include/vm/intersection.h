@@ -30,7 +30,11 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include <cassert>
 #include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
 
 namespace vm
 {
@@ -377,6 +381,122 @@ std::optional<T> intersect_ray_polygon(
   return std::nullopt;
 }
 
+/**
+ * Computes the points of intersection between the given ray and the given planes, and
+ * returns the distance to the closest one along with the index of its plane.
+ *
+ * Only the planes whose given side faces the ray origin are considered: if s is
+ * side::front, then only planes whose normals point against the ray direction are
+ * considered, and if s is side::back, only planes whose normals point along the ray
+ * direction are considered.
+ *
+ * @tparam T the component type
+ * @param r the ray
+ * @param planes the planes, stored contiguously
+ * @param s the side of the planes to consider
+ * @return the distance to the closest intersection point and the index of the
+ * intersected plane, or nullopt if the ray does not intersect any of the given planes
+ */
+template <typename T>
+constexpr std::optional<std::tuple<T, std::size_t>> intersect_ray_planes(
+  const ray<T, 3>& r,
+  const std::type_identity_t<std::span<const plane<T, 3>>> planes,
+  const side s = side::both)
+{
+  auto result = std::optional<std::tuple<T, std::size_t>>{};
+  for (std::size_t i = 0u; i < planes.size(); ++i)
+  {
+    const auto& p = planes[i];
+    const auto d = dot(r.direction, p.normal);
+    if (
+      is_zero(d, constants<T>::almost_zero()) || (s == side::front && d > T(0))
+      || (s == side::back && d < T(0)))
+    {
+      continue;
+    }
+
+    const auto distance = dot(p.anchor() - r.origin, p.normal) / d;
+    if (
+      distance >= -constants<T>::almost_zero()
+      && (!result || distance < std::get<0>(*result)))
+    {
+      result = {distance, i};
+    }
+  }
+  return result;
+}
+
+/**
+ * Computes the points of intersection between the given ray and the given polygons, and
+ * returns the distance to the closest one along with the index of its polygon.
+ *
+ * The polygons are given as an indexed face set: polygon i lies on planes[i], and its
+ * vertices are positions[indices[j]] for j in [offsets[i], offsets[i+1]). Thus, offsets
+ * must contain one more element than planes.
+ *
+ * Every polygon is first intersected with its plane, and the more expensive containment
+ * test is only performed for polygons that are closer than the closest hit found so far.
+ *
+ * Only the polygons whose given side faces the ray origin are considered, see
+ * intersect_ray_planes.
+ *
+ * @tparam T the component type
+ * @tparam O a random access range of offsets
+ * @tparam I a random access range of vertex indices
+ * @param r the ray
+ * @param planes the plane of each polygon
+ * @param positions the vertex positions
+ * @param offsets the offset of the first vertex index of each polygon, followed by the
+ * total number of vertex indices
+ * @param indices the vertex indices of all polygons
+ * @param s the side of the polygons to consider
+ * @return the distance to the closest intersection point and the index of the
+ * intersected polygon, or nullopt if the ray does not intersect any of the given polygons
+ */
+template <typename T, typename O, typename I>
+constexpr std::optional<std::tuple<T, std::size_t>> intersect_ray_polygons(
+  const ray<T, 3>& r,
+  const std::type_identity_t<std::span<const plane<T, 3>>> planes,
+  const std::type_identity_t<std::span<const vec<T, 3>>> positions,
+  const O& offsets,
+  const I& indices,
+  const side s = side::both)
+{
+  assert(offsets.size() == planes.size() + 1u);
+
+  auto result = std::optional<std::tuple<T, std::size_t>>{};
+  for (std::size_t i = 0u; i < planes.size(); ++i)
+  {
+    const auto& p = planes[i];
+    const auto d = dot(r.direction, p.normal);
+    if (
+      is_zero(d, constants<T>::almost_zero()) || (s == side::front && d > T(0))
+      || (s == side::back && d < T(0)))
+    {
+      continue;
+    }
+
+    const auto distance = dot(p.anchor() - r.origin, p.normal) / d;
+    if (
+      distance < -constants<T>::almost_zero()
+      || (result && distance >= std::get<0>(*result)))
+    {
+      continue;
+    }
+
+    const auto point = point_at_distance(r, distance);
+    const auto first = std::begin(indices) + std::ptrdiff_t(offsets[i]);
+    const auto last = std::begin(indices) + std::ptrdiff_t(offsets[i + 1u]);
+    if (polygon_contains_point(point, p.normal, first, last, [&](const auto index) {
+          return positions[std::size_t(index)];
+        }))
+    {
+      result = {distance, i};
+    }
+  }
+  return result;
+}
+
 /**
  * Computes the point of intersection between the given ray and the given bounding box,
  * and returns the distance on the given ray from the ray's origin to that point.
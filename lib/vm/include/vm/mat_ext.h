@@ -29,10 +29,68 @@
 
 #include <array>
 #include <optional>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace vm
 {
+/**
+ * Transforms the given points in place by the given matrix using homogeneous coordinates.
+ *
+ * For every point p, the result is identical to computing m * p. The matrix is inspected
+ * only once: if it is an affine transformation, the homogeneous coordinate of every
+ * transformed point is 1, so it is neither computed nor divided by. Since the iterations
+ * don't depend on each other, the compiler can vectorize the loop.
+ *
+ * @tparam T the component type
+ * @tparam S the number of rows and columns of the matrix
+ * @param m the matrix
+ * @param points the points to transform
+ */
+template <typename T, std::size_t S>
+constexpr void transform_points(
+  const mat<T, S, S>& m, const std::type_identity_t<std::span<vec<T, S - 1>>> points)
+{
+  auto affine = m[S - 1][S - 1] == static_cast<T>(1.0);
+  for (std::size_t c = 0u; c < S - 1u; ++c)
+  {
+    affine = affine && m[c][S - 1] == static_cast<T>(0.0);
+  }
+
+  for (auto& point : points)
+  {
+    // accumulate in the same order as operator*(const mat&, const vec&) to get identical
+    // results
+    auto result = vec<T, S - 1>{};
+    for (std::size_t r = 0u; r < S - 1u; ++r)
+    {
+      for (std::size_t c = 0u; c < S - 1u; ++c)
+      {
+        result[r] += m[c][r] * point[c];
+      }
+      result[r] += m[S - 1][r] * static_cast<T>(1.0);
+    }
+
+    if (!affine)
+    {
+      auto w = static_cast<T>(0.0);
+      for (std::size_t c = 0u; c < S - 1u; ++c)
+      {
+        w += m[c][S - 1] * point[c];
+      }
+      w += m[S - 1][S - 1] * static_cast<T>(1.0);
+
+      for (std::size_t r = 0u; r < S - 1u; ++r)
+      {
+        result[r] = result[r] / w;
+      }
+    }
+
+    point = result;
+  }
+}
+
 /**
  * Multiplies the given list of vectors with the given matrix.
  *
@@ -93,12 +151,8 @@ template <typename T, std::size_t R, std::size_t C>
 std::vector<vec<T, C - 1>> operator*(
   const mat<T, R, C>& lhs, const std::vector<vec<T, C - 1>>& rhs)
 {
-  std::vector<vec<T, C - 1>> result;
-  result.reserve(rhs.size());
-  for (const auto& v : rhs)
-  {
-    result.push_back(lhs * v);
-  }
+  auto result = rhs;
+  transform_points(lhs, result);
   return result;
 }
 
@@ -29,6 +29,16 @@
 
 namespace vm
 {
+TEST_CASE("evaluate_quadratic_bezier_curve")
+{
+  const auto points =
+    std::array<vec3d, 3>{vec3d{0, 0, 0}, vec3d{1, 2, 0}, vec3d{2, 0, 0}};
+
+  CHECK(evaluate_quadratic_bezier_curve(points, 0.0) == vec3d{0, 0, 0});
+  CHECK(evaluate_quadratic_bezier_curve(points, 0.5) == vec3d{1, 1, 0});
+  CHECK(evaluate_quadratic_bezier_curve(points, 1.0) == vec3d{2, 0, 0});
+}
+
 TEST_CASE("evaluate_quadratic_bezier_surface")
 {
   using T = std::tuple<std::array<vec3d, 9>, double, double, vec3d>;
@@ -29,6 +29,8 @@
 #include "vm/vec_io.h" // IWYU pragma: keep
 
 #include <array>
+#include <span>
+#include <tuple>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -295,6 +297,74 @@ TEST_CASE("intersection.intersect_ray_square")
     == approx(+1.0));
 }
 
+TEST_CASE("intersection.intersect_ray_planes")
+{
+  const auto planes = std::array<plane3d, 3>{
+    plane3d(vec3d(0, 0, 3), vec3d{0, 0, 1}),
+    plane3d(vec3d(0, 0, 1), vec3d{0, 0, -1}),
+    plane3d(vec3d(0, 0, 2), vec3d{1, 0, 0})};
+
+  const auto ray = ray3d(vec3d{0, 0, 0}, vec3d{0, 0, 1});
+  CHECK(intersect_ray_planes(ray, planes) == std::tuple{1.0, size_t(1)});
+  CHECK(intersect_ray_planes(ray, planes, side::front) == std::tuple{1.0, size_t(1)});
+  CHECK(intersect_ray_planes(ray, planes, side::back) == std::tuple{3.0, size_t(0)});
+
+  CHECK(
+    intersect_ray_planes(ray3d(vec3d{0, 0, 4}, vec3d{0, 0, 1}), planes) == std::nullopt);
+  CHECK(intersect_ray_planes(ray, std::span<const plane3d>{}) == std::nullopt);
+}
+
+TEST_CASE("intersection.intersect_ray_polygons")
+{
+  /*
+   Three unit squares: the first one is centered on the z axis at z = 3, the second one is
+   centered on the z axis at z = 1, and the third one is centered at x = 4 at z = 2.
+   */
+
+  const auto positions = std::array<vec3d, 12>{
+    vec3d(-1, -1, 3),
+    vec3d(-1, +1, 3),
+    vec3d(+1, +1, 3),
+    vec3d(+1, -1, 3),
+    vec3d(-1, -1, 1),
+    vec3d(+1, -1, 1),
+    vec3d(+1, +1, 1),
+    vec3d(-1, +1, 1),
+    vec3d(3, -1, 2),
+    vec3d(3, +1, 2),
+    vec3d(5, +1, 2),
+    vec3d(5, -1, 2),
+  };
+  const auto planes = std::array<plane3d, 3>{
+    plane3d(vec3d(0, 0, 3), vec3d{0, 0, 1}),
+    plane3d(vec3d(0, 0, 1), vec3d{0, 0, -1}),
+    plane3d(vec3d(4, 0, 2), vec3d{0, 0, -1})};
+  const auto offsets = std::array<size_t, 4>{0, 4, 8, 12};
+  const auto indices = std::array<size_t, 12>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+  const auto intersect = [&](const auto& ray, const auto s) {
+    return intersect_ray_polygons(ray, planes, positions, offsets, indices, s);
+  };
+
+  const auto upRay = ray3d(vec3d{0, 0, 0}, vec3d{0, 0, 1});
+  CHECK(intersect(upRay, side::both) == std::tuple{1.0, size_t(1)});
+  CHECK(intersect(upRay, side::front) == std::tuple{1.0, size_t(1)});
+  CHECK(intersect(upRay, side::back) == std::tuple{3.0, size_t(0)});
+
+  const auto downRay = ray3d(vec3d{0, 0, 4}, vec3d{0, 0, -1});
+  CHECK(intersect(downRay, side::both) == std::tuple{1.0, size_t(0)});
+  CHECK(intersect(downRay, side::front) == std::tuple{1.0, size_t(0)});
+  CHECK(intersect(downRay, side::back) == std::tuple{3.0, size_t(1)});
+
+  // hits the plane of the first two polygons, but only the third polygon
+  CHECK(
+    intersect(ray3d(vec3d{4, 0, 0}, vec3d{0, 0, 1}), side::both)
+    == std::tuple{2.0, size_t(2)});
+
+  CHECK(intersect(ray3d(vec3d{8, 0, 0}, vec3d{0, 0, 1}), side::both) == std::nullopt);
+  CHECK(intersect(ray3d(vec3d{0, 0, 4}, vec3d{0, 0, 1}), side::both) == std::nullopt);
+}
+
 TEST_CASE("intersection.intersect_ray_bbox")
 {
   constexpr auto bounds = bbox3f(vec3f(-12.0f, -3.0f, 4.0f), vec3f(8.0f, 9.0f, 8.0f));
@@ -112,6 +112,41 @@ TEST_CASE("mat_ext")
     CER_CHECK(o[2] == approx(r[2]));
   }
 
+  SECTION("transform_points")
+  {
+    const auto points = std::vector<vec3d>{
+      vec3d(1.0, 2.0, 3.0),
+      vec3d(-2.5, 0.1, 4.0),
+      vec3d(3.0 / 23.0, 2.0 / 23.0, 7.0 / 23.0),
+      vec3d(0.0, 0.0, 0.0)};
+
+    const auto affine = translation_matrix(vec3d(100.0, -13.0, 0.3))
+                        * rotation_matrix(vec3d{0, 0, 1}, to_radians(33.0))
+                        * scaling_matrix(vec3d(2.0, 0.5, 1.5));
+    const auto projective =
+      mat4x4d(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+
+    for (const auto& m : {affine, projective})
+    {
+      auto transformed = points;
+      transform_points(m, transformed);
+
+      REQUIRE(transformed.size() == points.size());
+      for (size_t i = 0; i < points.size(); ++i)
+      {
+        // must be identical, not just approximately equal
+        CHECK(transformed[i] == m * points[i]);
+      }
+
+      CHECK(m * points == transformed);
+    }
+
+    const auto array = std::array<vec3f, 2>{vec3f(1, 2, 3), vec3f(4, 5, 6)};
+    auto transformedArray = array;
+    transform_points(mat4x4f::identity(), transformedArray);
+    CHECK(transformedArray == array);
+  }
+
   SECTION("operator_multiply_vectors_left")
   {
     const auto v =
@@ -0,0 +1,269 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QCommandLineParser>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QTextStream>
+
+#include "MapBatch.h"
+#include "PreferenceManager.h"
+#include "Result.h"
+#include "io/PathQt.h"
+#include "io/SystemPaths.h"
+#include "mdl/GameFactory.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/task_manager.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace tb::batch
+{
+namespace
+{
+
+QJsonArray toJson(const std::vector<std::string>& strings)
+{
+  auto result = QJsonArray{};
+  for (const auto& str : strings)
+  {
+    result.append(QString::fromStdString(str));
+  }
+  return result;
+}
+
+QJsonObject toJson(const MapReport& report)
+{
+  auto issues = QJsonArray{};
+  for (const auto& issue : report.issues)
+  {
+    issues.append(QJsonObject{
+      {"validator", QString::fromStdString(issue.validator)},
+      {"description", QString::fromStdString(issue.description)},
+      {"line", qint64(issue.lineNumber)},
+    });
+  }
+
+  auto outputs = QJsonArray{};
+  for (const auto& output : report.outputs)
+  {
+    outputs.append(io::pathAsQString(output));
+  }
+
+  return QJsonObject{
+    {"path", io::pathAsQString(report.path)},
+    {"game", report.gameName ? QString::fromStdString(*report.gameName) : QJsonValue{}},
+    {"format", QString::fromStdString(mdl::formatName(report.mapFormat))},
+    {"issues", issues},
+    {"outputs", outputs},
+    {"warnings", toJson(report.warnings)},
+    {"errors", toJson(report.errors)},
+    {"durationMs", qint64(report.duration.count())},
+  };
+}
+
+QByteArray toJson(const std::vector<MapReport>& reports)
+{
+  auto maps = QJsonArray{};
+  for (const auto& report : reports)
+  {
+    maps.append(toJson(report));
+  }
+  return QJsonDocument{QJsonObject{{"maps", maps}}}.toJson(QJsonDocument::Indented);
+}
+
+bool initializeGameFactory(QTextStream& err)
+{
+  const auto gamePathConfig = mdl::GamePathConfig{
+    io::SystemPaths::findResourceDirectories("games"),
+    io::SystemPaths::userDataDirectory() / "games",
+  };
+  auto& gameFactory = mdl::GameFactory::instance();
+  return gameFactory.initialize(gamePathConfig) | kdl::transform([&](auto errors) {
+           for (const auto& error : errors)
+           {
+             err << QString::fromStdString(error) << "\n";
+           }
+           return true;
+         })
+         | kdl::transform_error([&](auto e) {
+             err << "Could not initialize game factory: "
+                 << QString::fromStdString(e.msg) << "\n";
+             return false;
+           })
+         | kdl::value();
+}
+
+} // namespace
+} // namespace tb::batch
+
+int main(int argc, char* argv[])
+{
+  using namespace tb;
+
+  QSettings::setDefaultFormat(QSettings::IniFormat);
+
+  // no windows are shown, so don't require a display
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+  {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  PreferenceManager::createInstance<AppPreferenceManager>();
+
+  auto app = QGuiApplication{argc, argv};
+  app.setApplicationName("TrenchBroom");
+  // Needs to be "" otherwise Qt adds this to the paths returned by QStandardPaths
+  app.setOrganizationName("");
+  app.setOrganizationDomain("io.github.trenchbroom");
+
+  auto parser = QCommandLineParser{};
+  parser.setApplicationDescription(
+    "Validates, reformats, converts and exports map files without opening them in the "
+    "editor. Prints a JSON report of the processed maps.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("maps", "The map files to process.", "maps...");
+
+  const auto gameOption = QCommandLineOption{
+    "game", "The game to use for maps that don't specify a known game.", "name"};
+  const auto validateOption =
+    QCommandLineOption{"validate", "Report the issues found by the validators."};
+  const auto reformatOption =
+    QCommandLineOption{"reformat", "Write the maps in their current format."};
+  const auto convertOption =
+    QCommandLineOption{"convert", "Write the maps in the given format.", "format"};
+  const auto exportObjOption =
+    QCommandLineOption{"export-obj", "Export the maps as OBJ and MTL files."};
+  const auto outputOption = QCommandLineOption{
+    "output", "The directory to write the processed maps and exported files to.", "dir"};
+  const auto reportOption = QCommandLineOption{
+    "report", "Write the report to the given file instead of stdout.", "file"};
+  const auto jobsOption =
+    QCommandLineOption{"jobs", "The number of threads to use.", "count"};
+  const auto strictOption =
+    QCommandLineOption{"strict", "Exit with an error status if any issues were found."};
+
+  parser.addOptions({
+    gameOption,
+    validateOption,
+    reformatOption,
+    convertOption,
+    exportObjOption,
+    outputOption,
+    reportOption,
+    jobsOption,
+    strictOption,
+  });
+  parser.process(app);
+
+  auto err = QTextStream{stderr};
+
+  auto options = batch::BatchOptions{};
+  if (parser.isSet(gameOption))
+  {
+    options.gameName = parser.value(gameOption).toStdString();
+  }
+  options.validate = parser.isSet(validateOption);
+  options.reformat = parser.isSet(reformatOption);
+  if (parser.isSet(convertOption))
+  {
+    const auto mapFormat = mdl::formatFromName(parser.value(convertOption).toStdString());
+    if (mapFormat == mdl::MapFormat::Unknown)
+    {
+      err << "Unknown map format: " << parser.value(convertOption) << "\n";
+      return 1;
+    }
+    options.convertFormat = mapFormat;
+  }
+  options.exportObj = parser.isSet(exportObjOption);
+  if (parser.isSet(outputOption))
+  {
+    options.outputDir = io::pathFromQString(parser.value(outputOption));
+  }
+
+  if (options.reformat && options.convertFormat)
+  {
+    err << "--reformat and --convert cannot be used together\n";
+    return 1;
+  }
+  if (options.convertFormat && !options.outputDir)
+  {
+    err << "--convert requires --output\n";
+    return 1;
+  }
+
+  auto jobs = size_t(std::max(std::thread::hardware_concurrency(), 1u));
+  if (parser.isSet(jobsOption))
+  {
+    auto ok = false;
+    jobs = parser.value(jobsOption).toULong(&ok);
+    if (!ok || jobs == 0)
+    {
+      err << "Invalid number of jobs: " << parser.value(jobsOption) << "\n";
+      return 1;
+    }
+  }
+
+  auto paths = std::vector<std::filesystem::path>{};
+  for (const auto& arg : parser.positionalArguments())
+  {
+    paths.push_back(io::pathFromQString(arg));
+  }
+  if (paths.empty())
+  {
+    parser.showHelp(1);
+  }
+
+  if (!batch::initializeGameFactory(err))
+  {
+    return 1;
+  }
+
+  auto taskManager = kdl::task_manager{jobs};
+  const auto reports = batch::processMaps(paths, options, taskManager);
+  PreferenceManager::destroyInstance();
+
+  const auto json = batch::toJson(reports);
+
+  if (parser.isSet(reportOption))
+  {
+    auto file = QFile{parser.value(reportOption)};
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+    {
+      err << "Could not write report to " << parser.value(reportOption) << "\n";
+      return 1;
+    }
+  }
+  else
+  {
+    auto out = QTextStream{stdout};
+    out << json;
+  }
+
+  const auto failed = std::ranges::any_of(
+    reports, [](const auto& report) { return !report.errors.empty(); });
+  const auto hasIssues = std::ranges::any_of(
+    reports, [](const auto& report) { return !report.issues.empty(); });
+  return failed ? 1 : parser.isSet(strictOption) && hasIssues ? 2 : 0;
+}
@@ -0,0 +1,294 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MapBatch.h"
+
+#include "Logger.h"
+#include "Result.h"
+#include "io/DiskIO.h"
+#include "io/ExportOptions.h"
+#include "io/MapHeader.h"
+#include "io/NodeWriter.h"
+#include "io/SimpleParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/Game.h"
+#include "mdl/GameConfig.h"
+#include "mdl/GameFactory.h"
+#include "mdl/Issue.h"
+#include "mdl/IssueCache.h"
+#include "mdl/Map.h"
+#include "mdl/Resource.h"
+#include "mdl/Validator.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/path_utils.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace tb::batch
+{
+namespace
+{
+
+/**
+ * Records the warnings and errors that are logged while a map is processed in its report.
+ */
+class ReportLogger : public Logger
+{
+private:
+  MapReport& m_report;
+
+public:
+  explicit ReportLogger(MapReport& report)
+    : m_report{report}
+  {
+  }
+
+private:
+  void doLog(const LogLevel level, const std::string_view message) override
+  {
+    switch (level)
+    {
+    case LogLevel::Warn:
+      m_report.warnings.emplace_back(message);
+      break;
+    case LogLevel::Error:
+      m_report.errors.emplace_back(message);
+      break;
+    case LogLevel::Debug:
+    case LogLevel::Info:
+      break;
+    }
+  }
+};
+
+/**
+ * Creates the games for the processed maps. The game factory is not thread safe, and it
+ * only shares the asset cache of a game while an instance of that game is alive, so the
+ * first instance of every game is kept until all maps have been processed.
+ */
+class GameSource
+{
+private:
+  std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<mdl::Game>> m_games;
+
+public:
+  std::unique_ptr<mdl::Game> createGame(const std::string& gameName, Logger& logger)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+
+    auto& gameFactory = mdl::GameFactory::instance();
+    if (!m_games.contains(gameName))
+    {
+      m_games[gameName] = gameFactory.createGame(gameName, logger);
+    }
+    return gameFactory.createGame(gameName, logger);
+  }
+};
+
+std::filesystem::path outputPath(
+  const std::filesystem::path& path,
+  const BatchOptions& options,
+  const std::string& extension)
+{
+  const auto dir = options.outputDir.value_or(path.parent_path());
+  return kdl::path_replace_extension(dir / path.filename(), extension);
+}
+
+Result<std::tuple<std::string, mdl::MapFormat>> detectGameAndFormat(
+  const std::filesystem::path& path, const BatchOptions& options)
+{
+  return io::Disk::withInputStream(path, io::readMapHeader)
+         | kdl::and_then([&](auto gameNameAndMapFormat) {
+             auto [gameName, mapFormat] = std::move(gameNameAndMapFormat);
+
+             const auto& gameList = mdl::GameFactory::instance().gameList();
+             if (!gameName || !kdl::vec_contains(gameList, *gameName))
+             {
+               gameName = options.gameName;
+             }
+
+             if (!gameName)
+             {
+               return Result<std::tuple<std::string, mdl::MapFormat>>{
+                 Error{"Could not detect game, use --game to specify it"}};
+             }
+
+             return Result<std::tuple<std::string, mdl::MapFormat>>{
+               std::tuple{std::move(*gameName), mapFormat}};
+           });
+}
+
+void validate(mdl::Map& map, MapReport& report)
+{
+  const auto validators = map.world()->registeredValidators();
+  const auto validatorName = [&](const auto issueType) {
+    const auto i = std::ranges::find_if(
+      validators, [&](const auto* validator) { return validator->type() == issueType; });
+    return i != validators.end() ? (*i)->description() : std::string{};
+  };
+
+  auto issueCache = mdl::IssueCache{map};
+  for (const auto* issue : issueCache.issues())
+  {
+    if (!issue->hidden())
+    {
+      report.issues.push_back(IssueReport{
+        validatorName(issue->type()), issue->description(), issue->lineNumber()});
+    }
+  }
+
+  std::ranges::sort(report.issues, {}, &IssueReport::lineNumber);
+}
+
+Result<void> reformat(mdl::Map& map, const BatchOptions& options, MapReport& report)
+{
+  const auto path = outputPath(report.path, options, ".map");
+  return io::Disk::withOutputStream(path, [&](auto& stream) { map.saveTo(stream); })
+         | kdl::transform([&]() { report.outputs.push_back(path); });
+}
+
+Result<void> convert(
+  mdl::Map& map,
+  const mdl::MapFormat targetMapFormat,
+  const BatchOptions& options,
+  kdl::task_manager& taskManager,
+  MapReport& report)
+{
+  // read the map as it was loaded again, converting the brushes to the target format
+  auto source = std::stringstream{};
+  map.saveTo(source);
+  const auto str = source.str();
+
+  auto parserStatus = io::SimpleParserStatus{map.logger()};
+  auto worldReader = io::WorldReader{
+    str, report.mapFormat, targetMapFormat, map.world()->entityPropertyConfig()};
+
+  return worldReader.read(map.worldBounds(), parserStatus, taskManager)
+         | kdl::and_then([&](auto worldNode) {
+             auto entity = worldNode->entity();
+             if (
+               targetMapFormat == mdl::MapFormat::Valve
+               || targetMapFormat == mdl::MapFormat::Quake2_Valve
+               || targetMapFormat == mdl::MapFormat::Quake3_Valve)
+             {
+               entity.addOrUpdateProperty(mdl::EntityPropertyKeys::ValveVersion, "220");
+             }
+             else
+             {
+               entity.removeProperty(mdl::EntityPropertyKeys::ValveVersion);
+             }
+             worldNode->setEntity(std::move(entity));
+
+             const auto path = outputPath(report.path, options, ".map");
+             return io::Disk::withOutputStream(path, [&](auto& stream) {
+                      io::writeMapHeader(
+                        stream, map.game()->config().name, targetMapFormat);
+
+                      auto writer = io::NodeWriter{*worldNode, stream};
+                      writer.writeMap(taskManager);
+                    })
+                    | kdl::transform([&]() { report.outputs.push_back(path); });
+           });
+}
+
+Result<void> exportObj(mdl::Map& map, const BatchOptions& options, MapReport& report)
+{
+  const auto path = outputPath(report.path, options, ".obj");
+  return map.exportAs(io::ObjExportOptions{path, io::ObjMtlPathMode::RelativeToGamePath})
+         | kdl::transform([&]() {
+             report.outputs.push_back(path);
+             report.outputs.push_back(kdl::path_replace_extension(path, ".mtl"));
+           });
+}
+
+MapReport processMap(
+  const std::filesystem::path& path,
+  const BatchOptions& options,
+  GameSource& gameSource,
+  kdl::task_manager& taskManager)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+
+  auto report = MapReport{path};
+  auto logger = ReportLogger{report};
+
+  {
+    auto map = mdl::Map{taskManager, logger};
+    map.setMaterialLoadMode(mdl::ResourceLoadMode::Lazy);
+
+    detectGameAndFormat(path, options) | kdl::and_then([&](auto gameNameAndMapFormat) {
+      const auto& [gameName, mapFormat] = gameNameAndMapFormat;
+      report.gameName = gameName;
+
+      auto game = gameSource.createGame(gameName, logger);
+      return map.load(mapFormat, mdl::Map::DefaultWorldBounds, std::move(game), path);
+    }) | kdl::and_then([&]() {
+      report.mapFormat = map.world()->mapFormat();
+      if (options.validate)
+      {
+        validate(map, report);
+      }
+      return options.reformat ? reformat(map, options, report) : Result<void>{};
+    }) | kdl::and_then([&]() {
+      return options.convertFormat
+               ? convert(map, *options.convertFormat, options, taskManager, report)
+               : Result<void>{};
+    }) | kdl::and_then([&]() {
+      return options.exportObj ? exportObj(map, options, report) : Result<void>{};
+    }) | kdl::transform_error([&](const auto& e) { report.errors.push_back(e.msg); });
+  }
+
+  report.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - startTime);
+  return report;
+}
+
+} // namespace
+
+std::vector<MapReport> processMaps(
+  const std::vector<std::filesystem::path>& paths,
+  const BatchOptions& options,
+  kdl::task_manager& taskManager)
+{
+  auto gameSource = GameSource{};
+  auto reports = std::vector<MapReport>(paths.size());
+
+  // every map is a task of its own since loading times vary a lot between maps
+  taskManager.parallel_for(
+    paths.size(),
+    [&](const size_t i) {
+      reports[i] = processMap(paths[i], options, gameSource, taskManager);
+    },
+    1);
+
+  return reports;
+}
+
+} // namespace tb::batch
@@ -0,0 +1,87 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "mdl/MapFormat.h"
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::batch
+{
+
+struct BatchOptions
+{
+  /**
+   * The game to use for maps whose header doesn't name a known game.
+   */
+  std::optional<std::string> gameName;
+
+  bool validate = false;
+  bool reformat = false;
+  std::optional<mdl::MapFormat> convertFormat;
+  bool exportObj = false;
+
+  /**
+   * The directory to write the processed maps and exported files to. If not given, the
+   * files are written next to the input maps and reformatted maps are overwritten.
+   */
+  std::optional<std::filesystem::path> outputDir;
+};
+
+struct IssueReport
+{
+  std::string validator;
+  std::string description;
+  size_t lineNumber = 0;
+};
+
+struct MapReport
+{
+  std::filesystem::path path;
+  std::optional<std::string> gameName = std::nullopt;
+  mdl::MapFormat mapFormat = mdl::MapFormat::Unknown;
+  std::vector<IssueReport> issues = {};
+  std::vector<std::filesystem::path> outputs = {};
+  std::vector<std::string> warnings = {};
+  std::vector<std::string> errors = {};
+  std::chrono::milliseconds duration = std::chrono::milliseconds{0};
+};
+
+/**
+ * Processes the given maps concurrently on the given task manager. Every map is loaded
+ * into its own mdl::Map, but all maps of the same game share the game's asset cache.
+ *
+ * Failures are recorded in the report of the affected map and don't stop the other maps
+ * from being processed. The reports are returned in the order of the given paths.
+ */
+std::vector<MapReport> processMaps(
+  const std::vector<std::filesystem::path>& paths,
+  const BatchOptions& options,
+  kdl::task_manager& taskManager);
+
+} // namespace tb::batch